@@ -179,12 +179,12 @@ install_jemalloc()
 
 install_base_ubuntu()
 {
-    sudo apt install -y build-essential nasm autoconf libtool zlib1g-dev tclsh cmake curl pkg-config bc
+    sudo apt install -y build-essential nasm autoconf libtool zlib1g-dev tclsh cmake curl pkg-config bc systemtap-sdt-dev
 }
 
 install_base_fedora()
 {
-    sudo yum install -y gcc-c++ make nasm autoconf libtool zlib-devel tcl cmake bc
+    sudo yum install -y gcc-c++ make nasm autoconf libtool zlib-devel tcl cmake bc systemtap-sdt-devel
 }
 
 install_base_centos()
@@ -193,7 +193,7 @@ install_base_centos()
     sudo curl -so /etc/yum.repos.d/nasm.repo https://www.nasm.us/nasm.repo
     # centos-release-scl should be installed before installing devtoolset-7
     sudo yum install -y centos-release-scl
-    sudo yum install -y bc gcc-c++ cmake nasm autoconf libtool glibc-static tcl bzip2 zlib-devel devtoolset-7
+    sudo yum install -y bc gcc-c++ cmake nasm autoconf libtool glibc-static tcl bzip2 zlib-devel systemtap-sdt-devel devtoolset-7
     source scl_source enable devtoolset-7
 }
 
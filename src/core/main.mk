@@ -38,9 +38,11 @@ BUILD_TARGET_LIST :=
 # File list to delete
 BUILD_FILES_TO_CLEAN :=
 
-.PHONY: all help release
+.PHONY: all help release benchmark
 all: directories_to_prepare build_target_list
 release: all
+# Builds OvenMediaEngineBenchmark and OvenMediaEngineLoad too (See projects/benchmark/AMS.mk, projects/load_generator/AMS.mk)
+benchmark: all
 help:
 	@echo ""
 	@echo " $(ANSI_GREEN)* AMS Help Page$(ANSI_RESET)"
@@ -50,6 +52,8 @@ help:
 	@echo "   Commands:"
 	@echo "       $(ANSI_YELLOW)help$(ANSI_RESET): show this page"
 	@echo "       $(ANSI_YELLOW)release$(ANSI_RESET): make project to release"
+	@echo "       $(ANSI_YELLOW)benchmark$(ANSI_RESET): make project to release with the benchmarks (bin/RELEASE/OvenMediaEngineBenchmark)"
+	@echo "                  and the load generator (bin/RELEASE/OvenMediaEngineLoad)"
 	@echo ""
 
 # clean할 때 target이 삭제될 수 있도록 함
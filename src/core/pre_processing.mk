@@ -2,6 +2,9 @@ ifneq (,$(findstring install, $(MAKECMDGOALS)))
     BUILD_METHOD := RELEASE
 else ifneq (,$(findstring release, $(MAKECMDGOALS)))
     BUILD_METHOD := RELEASE
+else ifneq (,$(findstring benchmark, $(MAKECMDGOALS)))
+    # The benchmarks are meaningful only with the optimization of the release build
+    BUILD_METHOD := RELEASE
 else
     BUILD_METHOD := DEBUG
 endif
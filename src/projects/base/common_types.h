@@ -29,6 +29,9 @@ enum class StreamSourceType : int8_t
 	Rtmp,
 	Rtsp,
 	RtspPull,
+	Webrtc,
+	Srt,
+	Replay,
 	Transcoder,
 };
 
@@ -45,6 +48,9 @@ enum class ProviderType : int8_t
 	Rtsp,
 	RtspPull,
 	Ovt,
+	Webrtc,
+	Srt,
+	Replay,
 };
 
 enum class PublisherType : int8_t
@@ -56,6 +62,7 @@ enum class PublisherType : int8_t
 	Dash,
 	LlDash,
 	Ovt,
+	Record,
 	NumberOfPublishers,
 };
 
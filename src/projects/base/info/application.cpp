@@ -10,6 +10,8 @@
 #include "application_private.h"
 #include "host.h"
 
+#include <algorithm>
+
 namespace info
 {
 	Application::Application(const info::Host &host_info, application_id_t app_id, const ov::String &name, cfg::Application app_config, bool is_dynamic_app)
@@ -30,6 +32,20 @@ namespace info
 		_host_info = std::make_shared<info::Host>(host_info);
 	}
 
+	int Application::GetSchedulingWeight() const
+	{
+		auto weight = static_cast<int64_t>(_host_info->GetScheduling().GetWeight()) * _app_config.GetScheduling().GetWeight() / 100;
+
+		return static_cast<int>(std::clamp<int64_t>(weight, 1, std::numeric_limits<int>::max()));
+	}
+
+	int Application::GetMaxWorkerThreads() const
+	{
+		auto max_worker_threads = _app_config.GetScheduling().GetMaxWorkerThreads();
+
+		return (max_worker_threads > 0) ? max_worker_threads : _host_info->GetScheduling().GetMaxWorkerThreads();
+	}
+
 	const Application &Application::GetInvalidApplication()
 	{
 		static Application application(Host(cfg::VirtualHost()), InvalidApplicationId, "?InvalidApp?", false);
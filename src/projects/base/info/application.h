@@ -103,6 +103,11 @@ namespace info
 			return _app_config;
 		}
 
+		// The share of the shared worker pool/transcode budget (See <Scheduling>)
+		int GetSchedulingWeight() const;
+		// 0: unlimited
+		int GetMaxWorkerThreads() const;
+
 		bool IsDynamicApp() const
 		{
 			return _is_dynamic_app;
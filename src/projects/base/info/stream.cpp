@@ -44,6 +44,7 @@ namespace info
 		_created_time = stream._created_time;
 		_app_info = stream._app_info;
 		_origin_stream = stream._origin_stream;
+		_group_name = stream._group_name;
 
 		for (auto &track : stream._tracks)
 		{
@@ -95,6 +96,21 @@ namespace info
 		return _origin_stream;
 	}
 
+	int Stream::GetNumaNode() const
+	{
+		return ov::Numa::GetNodeOf((_origin_stream != nullptr) ? _origin_stream->GetId() : GetId());
+	}
+
+	const ov::String &Stream::GetGroupName() const
+	{
+		return _group_name;
+	}
+
+	void Stream::SetGroupName(const ov::String &group_name)
+	{
+		_group_name = group_name;
+	}
+
 	const std::chrono::system_clock::time_point& Stream::GetCreatedTime() const
 	{
 		return _created_time;
@@ -113,11 +129,33 @@ namespace info
 
 	bool Stream::AddTrack(std::shared_ptr<MediaTrack> track)
 	{
-		return _tracks.insert(std::make_pair(track->GetId(), track)).second;
+		int32_t id = track->GetId();
+
+		if (_tracks.insert(std::make_pair(id, track)).second == false)
+		{
+			return false;
+		}
+
+		if ((id >= 0) && (id < MaxIndexedTrackId))
+		{
+			if (static_cast<size_t>(id) >= _track_table.size())
+			{
+				_track_table.resize(id + 1);
+			}
+
+			_track_table[id] = track;
+		}
+
+		return true;
 	}
 
 	const std::shared_ptr<MediaTrack> Stream::GetTrack(int32_t id) const
 	{
+		if ((id >= 0) && (id < MaxIndexedTrackId))
+		{
+			return (static_cast<size_t>(id) < _track_table.size()) ? _track_table[id] : nullptr;
+		}
+
 		auto item = _tracks.find(id);
 		if (item == _tracks.end())
 		{
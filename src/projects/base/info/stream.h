@@ -10,6 +10,10 @@ namespace info
 	constexpr stream_id_t MinStreamId = std::numeric_limits<stream_id_t>::min();
 	constexpr stream_id_t MaxStreamId = (InvalidStreamId - static_cast<stream_id_t>(1));
 
+	// The tracks whose ID is less than this are also kept in a table indexed by the ID (See Stream::GetTrack()).
+	// The providers and the transcoder allocate the track IDs from 0, so every track fits in practice.
+	constexpr int32_t MaxIndexedTrackId = 256;
+
 	class Application;
 
 	//TODO: It should be changed class name to Stream
@@ -32,6 +36,14 @@ namespace info
 		void SetOriginStream(const std::shared_ptr<Stream> &stream);
 		const std::shared_ptr<Stream> GetOriginStream() const;
 
+		// The NUMA node that the threads of the stream run on (-1 if it is not used, See ov::Numa)
+		// The transcoded streams are on the node of the input stream.
+		int GetNumaNode() const;
+
+		// The name of the stream group (the renditions of an ABR stream), empty if the stream is not grouped
+		const ov::String &GetGroupName() const;
+		void SetGroupName(const ov::String &group_name);
+
 		const std::chrono::system_clock::time_point &GetCreatedTime() const;
 		uint32_t GetUptimeSec();
 		StreamSourceType GetSourceType() const;
@@ -54,6 +66,9 @@ namespace info
 		
 		// MediaTrack ID 값을 Key로 활용함
 		std::map<int32_t, std::shared_ptr<MediaTrack>> _tracks;
+		// _tracks indexed by the track ID, so GetTrack() called for every packet is an array access
+		// (the tracks are added while the stream is created, and not changed after that)
+		std::vector<std::shared_ptr<MediaTrack>> _track_table;
 
 	private:
 		std::chrono::system_clock::time_point _created_time;
@@ -65,5 +80,7 @@ namespace info
 		// If the Source Type of this stream is LiveTranscoder,
 		// the original stream coming from the Provider can be recognized with _origin_stream.
 		std::shared_ptr<Stream> 	_origin_stream = nullptr;
+
+		ov::String					_group_name;
 	};
 }  // namespace info
\ No newline at end of file
@@ -11,12 +11,18 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <map>
 
 #include <base/common_types.h>
 #include "media_type.h"
 
+namespace mon
+{
+	class PacketTrace;
+}
+
 enum class MediaPacketFlag : uint8_t
 {
 	NoFlag,
@@ -32,7 +38,8 @@ public:
 		  _pts(pts),
 		  _dts(dts),
 		  _duration(duration),
-		  _flag(flag)
+		  _flag(flag),
+		  _created_time(std::chrono::steady_clock::now())
 	{
 		if (data != nullptr)
 		{
@@ -72,8 +79,22 @@ public:
 		return _data;
 	}
 
-	std::shared_ptr<ov::Data> &GetData() noexcept
+	// It doesn't separate the payload from the clones (unlike the non-const GetData())
+	size_t GetDataLength() const noexcept
 	{
+		return (_data != nullptr) ? _data->GetLength() : 0;
+	}
+
+	// The payload may be shared with the clones of this packet (See ClonePacket()),
+	// so the packet gets its own ov::Data instance before returning the writable payload.
+	// (ov::Data copies the bitstream only when it is actually modified)
+	std::shared_ptr<ov::Data> &GetData()
+	{
+		if (_data.use_count() > 1)
+		{
+			_data = _data->Clone();
+		}
+
 		return _data;
 	}
 
@@ -137,20 +158,59 @@ public:
 		return &_frag_hdr;
 	}
 
-	std::shared_ptr<MediaPacket> ClonePacket()
+	// The temporal layer of the video frame (0: the base layer, See <Encode><Video><TemporalLayers>)
+	uint8_t GetTemporalLayer() const noexcept
+	{
+		return _temporal_layer;
+	}
+
+	// layer_sync: the frame refers only the base layer, so the upper layer can be resumed from this frame
+	void SetTemporalLayer(uint8_t temporal_layer, bool layer_sync)
+	{
+		_temporal_layer = temporal_layer;
+		_is_layer_sync = layer_sync;
+	}
+
+	bool IsLayerSync() const noexcept
 	{
-		auto packet = std::make_shared<MediaPacket>(
-			GetMediaType(),
-			GetTrackId(),
-			GetData(),
-			GetPts(),
-			GetDts(),
-			GetDuration(),
-			GetFlag());
+		return _is_layer_sync;
+	}
+
+	// When the packet was created (by the provider or the encoder)
+	const std::chrono::steady_clock::time_point &GetCreatedTime() const noexcept
+	{
+		return _created_time;
+	}
+
+	// When the packet was queued to the MediaRouter stream
+	const std::chrono::steady_clock::time_point &GetRoutedTime() const noexcept
+	{
+		return _routed_time;
+	}
 
-		packet->_frag_hdr = _frag_hdr;
+	void SetRoutedTime(const std::chrono::steady_clock::time_point &routed_time)
+	{
+		_routed_time = routed_time;
+	}
 
-		return packet;
+	// nullptr if the packet is not sampled by mon::PacketTracer (the clones share the trace)
+	const std::shared_ptr<mon::PacketTrace> &GetTrace() const noexcept
+	{
+		return _trace;
+	}
+
+	void SetTrace(const std::shared_ptr<mon::PacketTrace> &trace)
+	{
+		_trace = trace;
+	}
+
+	// Creates a packet that shares the payload with this packet
+	//
+	// The metadata (pts, track id, flag, ...) of the clone can be changed independently,
+	// and the payload is separated when either packet calls the non-const GetData().
+	std::shared_ptr<MediaPacket> ClonePacket() const
+	{
+		return std::make_shared<MediaPacket>(*this);
 	}
 
 protected:
@@ -163,6 +223,12 @@ protected:
 	int64_t _dts = -1LL;
 	int64_t _duration = -1LL;
 	MediaPacketFlag _flag = MediaPacketFlag::NoFlag;
+	uint8_t _temporal_layer = 0;
+	bool _is_layer_sync = false;
+
+	std::chrono::steady_clock::time_point _created_time;
+	std::chrono::steady_clock::time_point _routed_time;
+	std::shared_ptr<mon::PacketTrace> _trace;
 
 	FragmentationHeader _frag_hdr;
 };
@@ -215,6 +281,27 @@ public:
 		}
 	}
 
+	// Refers the data instead of copying it.
+	// The owner of the data must be kept alive by SetNativeFrame() while this frame (or a clone of it) exists.
+	void SetBufferReference(const uint8_t *data, int32_t data_size, int32_t plane = 0)
+	{
+		if ((data == nullptr) || (data_size <= 0))
+		{
+			ClearBuffer(plane);
+			return;
+		}
+
+		// ov::Data copies the data when it is modified (e.g. GetWritableBuffer())
+		_data_buffer[plane] = std::make_shared<ov::Data>(data, data_size, true);
+	}
+
+	// Uses the storage (such as a buffer of TranscodeFramePool) as the plane without copying.
+	// The storage returns to its pool when the last clone of the plane is released.
+	void SetBufferStorage(ov::DataBufferPtr storage, size_t length, int32_t plane = 0)
+	{
+		_data_buffer[plane] = std::make_shared<ov::Data>(std::move(storage), length);
+	}
+
 	void AppendBuffer(const uint8_t *data, int32_t data_size, int32_t plane = 0)
 	{
 		auto plane_data = AllocPlainData(plane);
@@ -482,6 +569,25 @@ public:
 		return _flags;
 	}
 
+	// A frame of the codec library (e.g. AVFrame) that owns the planes.
+	// The stages pass the frame to the codec library by reference instead of copying the planes.
+	// (The frames in the device memory (CUDA/QSV/VA-API surfaces) have only the native frame)
+	void SetNativeFrame(std::shared_ptr<void> native_frame)
+	{
+		_native_frame = std::move(native_frame);
+	}
+
+	template <typename T>
+	T *GetNativeFrameAs() const
+	{
+		return static_cast<T *>(_native_frame.get());
+	}
+
+	bool HasNativeFrame() const
+	{
+		return (_native_frame != nullptr);
+	}
+
 	// This function should only be called before filtering (_track_id 0, 1)
 	std::shared_ptr<MediaFrame> CloneFrame()
 	{
@@ -497,9 +603,18 @@ public:
 
 			for (int i = 0; i < 3; ++i)
 			{
+				auto plane_data = GetPlainData(i);
+
 				frame->SetStride(GetStride(i), i);
-				frame->SetPlainData(GetPlainData(i)->Clone(), i);
+
+				if (plane_data != nullptr)
+				{
+					frame->SetPlainData(plane_data->Clone(), i);
+				}
 			}
+
+			// The planes are immutable after decoding, so the clones can share them
+			frame->_native_frame = _native_frame;
 		}
 		else if (_track_id == (int32_t)common::MediaType::Audio)
 		{
@@ -589,4 +704,6 @@ private:
 	int32_t _sample_rate = 0;
 
 	int32_t _flags = 0;  // Key, non-Key
+
+	std::shared_ptr<void> _native_frame;
 };
@@ -0,0 +1,150 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/info/stream.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <atomic>
+
+#include "media_buffer.h"
+
+#define MEDIA_QUEUE_DEFAULT_MAX_BYTES (64 * 1024 * 1024)
+
+// The backpressure settings of the queues that hold the media packets (See <Performance><Backpressure> of Server.xml)
+//
+// When a consumer falls behind, its queue drops the packets by the policy instead of growing without limit
+class MediaQueuePolicy
+{
+public:
+	static void Configure(bool is_enabled, size_t max_bytes, ov::QueueOverflowPolicy policy)
+	{
+		_is_enabled = is_enabled;
+		_max_bytes = max_bytes;
+		_policy = policy;
+	}
+
+	// Returns false if the name is unknown
+	static bool ParsePolicy(const ov::String &name, ov::QueueOverflowPolicy *policy)
+	{
+		auto lower_name = name.LowerCaseString();
+
+		if (lower_name == "dropnonreference")
+		{
+			*policy = ov::QueueOverflowPolicy::DropNonReference;
+		}
+		else if (lower_name == "droptokeyframe")
+		{
+			*policy = ov::QueueOverflowPolicy::DropToKey;
+		}
+		else if (lower_name == "disconnect")
+		{
+			*policy = ov::QueueOverflowPolicy::Disconnect;
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	static bool IsEnabled()
+	{
+		return _is_enabled;
+	}
+
+	static size_t GetMaxBytes()
+	{
+		return _max_bytes;
+	}
+
+	// The media queues cannot disconnect the consumer, so they drop the packets to the next key frame instead
+	static ov::QueueOverflowPolicy GetPolicy()
+	{
+		return (_policy == ov::QueueOverflowPolicy::Disconnect) ? ov::QueueOverflowPolicy::DropToKey : _policy.load();
+	}
+
+	static ov::QueueOverflowPolicy GetConfiguredPolicy()
+	{
+		return _policy;
+	}
+
+	// The const GetData() doesn't separate the payload shared with the others
+	static size_t GetPacketBytes(const MediaPacket &packet)
+	{
+		return packet.GetData()->GetLength();
+	}
+
+	// group: The packets depend only on the packets of the same group (track)
+	static ov::QueueItemClass Classify(const MediaPacket &packet, common::MediaCodecId codec_id, uint64_t group)
+	{
+		ov::QueueItemClass item_class;
+
+		item_class.group = group;
+
+		if (packet.GetMediaType() != common::MediaType::Video)
+		{
+			item_class.priority = ov::QueueItemPriority::Independent;
+		}
+		else if (packet.GetFlag() == MediaPacketFlag::Key)
+		{
+			item_class.priority = ov::QueueItemPriority::Key;
+		}
+		else if ((codec_id == common::MediaCodecId::H264) && IsH264NonReferenceFrame(packet))
+		{
+			item_class.priority = ov::QueueItemPriority::Droppable;
+		}
+		else
+		{
+			item_class.priority = ov::QueueItemPriority::Dependent;
+		}
+
+		return item_class;
+	}
+
+	static ov::QueueItemClass Classify(const MediaPacket &packet, const info::Stream &stream, uint64_t group)
+	{
+		auto track = stream.GetTrack(packet.GetTrackId());
+
+		return Classify(packet, (track != nullptr) ? track->GetCodecId() : common::MediaCodecId::None, group);
+	}
+
+private:
+	// nal_ref_idc of the first slice is 0 (Annex-B only, the other formats are regarded as reference frames)
+	static bool IsH264NonReferenceFrame(const MediaPacket &packet)
+	{
+		auto data = packet.GetData();
+		auto bitstream = data->GetDataAs<uint8_t>();
+		auto length = data->GetLength();
+
+		for (size_t offset = 0; (offset + 3) < length; offset++)
+		{
+			if ((bitstream[offset] != 0x00) || (bitstream[offset + 1] != 0x00) || (bitstream[offset + 2] != 0x01))
+			{
+				continue;
+			}
+
+			auto nal_header = bitstream[offset + 3];
+			auto nal_type = nal_header & 0x1F;
+
+			if ((nal_type == 1) || (nal_type == 5))
+			{
+				return ((nal_header >> 5) & 0x03) == 0;
+			}
+
+			offset += 3;
+		}
+
+		return false;
+	}
+
+	inline static std::atomic<bool> _is_enabled{true};
+	inline static std::atomic<size_t> _max_bytes{MEDIA_QUEUE_DEFAULT_MAX_BYTES};
+	inline static std::atomic<ov::QueueOverflowPolicy> _policy{ov::QueueOverflowPolicy::DropNonReference};
+};
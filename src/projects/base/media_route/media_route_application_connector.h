@@ -62,6 +62,20 @@ public:
 		return ConnectorType::Provider;
 	}
 
+	// Called when an observer requests a key frame of the stream created by this connector.
+	// Returns false if the stream is not created by this connector, or the key frame cannot be requested.
+	virtual bool OnKeyFrameRequested(const std::shared_ptr<info::Stream> &stream)
+	{
+		return false;
+	}
+
+	// Called when an observer reports the packet loss (0~100) of the players of the stream created by this connector.
+	// Returns false if the stream is not created by this connector.
+	virtual bool OnPacketLossReported(const std::shared_ptr<info::Stream> &stream, int32_t packet_loss_percentage)
+	{
+		return false;
+	}
+
 public:
 	// @see: media_router_application.cpp / MediaRouteApplication::RegisterConnectorApp
 	inline void SetMediaRouterApplication(const std::shared_ptr<MediaRouteApplicationInterface> &route_application)
@@ -21,5 +21,14 @@ public:
 	virtual bool OnCreateStream(const std::shared_ptr<MediaRouteApplicationConnector> &application, const std::shared_ptr<info::Stream> &stream) = 0;
 	virtual bool OnDeleteStream(const std::shared_ptr<MediaRouteApplicationConnector> &application, const std::shared_ptr<info::Stream> &stream) = 0;
 	virtual bool OnReceiveBuffer(const std::shared_ptr<MediaRouteApplicationConnector> &application, const std::shared_ptr<info::Stream> &stream, const std::shared_ptr<MediaPacket> &packet) = 0;
+
+	// An observer requests a key frame of the stream to the connector that created the stream
+	virtual bool OnKeyFrameRequested(const std::shared_ptr<MediaRouteApplicationObserver> &application, const std::shared_ptr<info::Stream> &stream) = 0;
+
+	// An observer reports the packet loss (0~100) of the players of the stream to the connector that created the stream
+	virtual bool OnPacketLossReported(const std::shared_ptr<MediaRouteApplicationObserver> &application, const std::shared_ptr<info::Stream> &stream, int32_t packet_loss_percentage) = 0;
+
+	// An observer gets the packets of the outgoing stream since the last key frame (GOP cache) to send them to a new session
+	virtual bool OnGopCacheRequested(const std::shared_ptr<MediaRouteApplicationObserver> &application, const std::shared_ptr<info::Stream> &stream, std::vector<std::shared_ptr<MediaPacket>> *packets) = 0;
 };
 
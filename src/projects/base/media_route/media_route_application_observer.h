@@ -30,6 +30,14 @@ public:
 	virtual bool OnCreateStream(const std::shared_ptr<info::Stream> &info) = 0;
 	virtual bool OnDeleteStream(const std::shared_ptr<info::Stream> &info) = 0;
 
+	// Called for each track of the outgoing stream after OnCreateStream().
+	// Return false if the observer doesn't use the packets of the track (e.g. the codec is not supported),
+	// then the router doesn't deliver them to the observer at all.
+	virtual bool IsTrackSubscribed(const std::shared_ptr<info::Stream> &stream, const std::shared_ptr<MediaTrack> &track)
+	{
+		return true;
+	}
+
 	// Delivery encoded video frame
 	virtual bool OnSendVideoFrame(const std::shared_ptr<info::Stream> &stream,
 									const std::shared_ptr<MediaPacket> &media_packet) = 0;
@@ -49,5 +57,56 @@ public:
 	{
 		return ObserverType::Publisher;
 	}
+
+	// Requests a key frame of the stream to the creator of the stream (Transcoder or Provider)
+	inline bool RequestKeyFrame(const std::shared_ptr<info::Stream> &stream)
+	{
+		auto route_application = _media_route_application.lock();
+
+		if(route_application == nullptr)
+		{
+			return false;
+		}
+
+		return route_application->OnKeyFrameRequested(this->GetSharedPtr(), stream);
+	}
+
+	// Reports the packet loss of the players of the stream to the creator of the stream, so the encoders can protect the packets
+	// (e.g. the in-band FEC of OPUS)
+	inline bool ReportPacketLoss(const std::shared_ptr<info::Stream> &stream, int32_t packet_loss_percentage)
+	{
+		auto route_application = _media_route_application.lock();
+
+		if(route_application == nullptr)
+		{
+			return false;
+		}
+
+		return route_application->OnPacketLossReported(this->GetSharedPtr(), stream, packet_loss_percentage);
+	}
+
+	// Gets the packets of the stream since the last key frame (See MediaRouteStream::GetGopCache())
+	inline bool GetGopCache(const std::shared_ptr<info::Stream> &stream, std::vector<std::shared_ptr<MediaPacket>> *packets)
+	{
+		auto route_application = _media_route_application.lock();
+
+		if(route_application == nullptr)
+		{
+			return false;
+		}
+
+		return route_application->OnGopCacheRequested(this->GetSharedPtr(), stream, packets);
+	}
+
+public:
+	// @see: media_router_application.cpp / MediaRouteApplication::RegisterObserverApp
+	inline void SetMediaRouterApplication(const std::shared_ptr<MediaRouteApplicationInterface> &route_application)
+	{
+		_media_route_application = route_application;
+	}
+
+private:
+	// The route application holds the observer, so the observer must not hold a strong reference of it
+	std::weak_ptr<MediaRouteApplicationInterface> _media_route_application;
 };
 
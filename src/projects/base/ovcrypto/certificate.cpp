@@ -346,7 +346,13 @@ bool Certificate::ComputeDigest(const ov::String &algorithm)
 	}
 
 	uint8_t digest[EVP_MAX_MD_SIZE];
-	X509_digest(GetX509(), md, digest, &n);
+
+	if(X509_digest(GetX509(), md, digest, &n) != 1)
+	{
+		return false;
+	}
+
+	_digest.Clear();
 	_digest.Append(digest, n);
 	_digest_algorithm = algorithm;
 	return true;
@@ -365,7 +371,7 @@ EVP_PKEY *Certificate::GetPkey()
 //TODO(getroot): Algorithm을 enum값으로 변경
 ov::String Certificate::GetFingerprint(const ov::String &algorithm)
 {
-	if(_digest.GetLength() <= 0)
+	if((_digest.GetLength() <= 0) || (_digest_algorithm != algorithm))
 	{
 		if(!ComputeDigest(algorithm))
 		{
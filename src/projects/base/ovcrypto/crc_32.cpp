@@ -8,55 +8,256 @@
 //==============================================================================
 #include "crc_32.h"
 
+#include <string.h>
+
+#if defined(__x86_64__)
+#	include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#	include <arm_acle.h>
+#endif
+
 namespace ov
 {
-	static unsigned long crc_table[256];
-	static int crc_table_computed = false;
-
-	static void MakeCrcTable()
+	// The tables for slice-by-8 (the table[0] is the classic byte-at-a-time table of RFC1952)
+	struct CrcTable
 	{
-		unsigned long c;
+		uint32_t table[8][256];
 
-		int n, k;
-		for(n = 0; n < 256; n++)
+		constexpr CrcTable()
+			: table()
 		{
-			c = (unsigned long)n;
-			for(k = 0; k < 8; k++)
+			for (uint32_t n = 0; n < 256; n++)
 			{
-				if(c & 1)
+				uint32_t c = n;
+
+				for (int k = 0; k < 8; k++)
 				{
-					c = 0xEDB88320L ^ (c >> 1L);
+					c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
 				}
-				else
+
+				table[0][n] = c;
+			}
+
+			for (uint32_t n = 0; n < 256; n++)
+			{
+				for (int slice = 1; slice < 8; slice++)
 				{
-					c = c >> 1;
+					table[slice][n] = (table[slice - 1][n] >> 8) ^ table[0][table[slice - 1][n] & 0xFF];
 				}
 			}
-			crc_table[n] = c;
 		}
+	};
+
+	// Computed at the compile time, so there is no lazy initialization (which was not thread-safe)
+	static constexpr CrcTable crc_table;
+
+	// The crc here is the internal state (the initial/final XORs are done by the caller)
+	static uint32_t UpdateCrcSlice8(uint32_t crc, const uint8_t *buffer, size_t length)
+	{
+		const auto &table = crc_table.table;
+
+		while (length >= 8)
+		{
+			uint32_t low;
+			uint32_t high;
+
+			::memcpy(&low, buffer, sizeof(low));
+			::memcpy(&high, buffer + 4, sizeof(high));
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			low = __builtin_bswap32(low);
+			high = __builtin_bswap32(high);
+#endif
+
+			low ^= crc;
+
+			crc = table[7][low & 0xFF] ^
+				  table[6][(low >> 8) & 0xFF] ^
+				  table[5][(low >> 16) & 0xFF] ^
+				  table[4][low >> 24] ^
+				  table[3][high & 0xFF] ^
+				  table[2][(high >> 8) & 0xFF] ^
+				  table[1][(high >> 16) & 0xFF] ^
+				  table[0][high >> 24];
+
+			buffer += 8;
+			length -= 8;
+		}
+
+		while (length > 0)
+		{
+			crc = table[0][(crc ^ *buffer) & 0xFF] ^ (crc >> 8);
+
+			buffer++;
+			length--;
+		}
+
+		return crc;
+	}
+
+#if defined(__x86_64__)
+	// Folds 64 bytes at a time using the carry-less multiplication
+	// ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction", Intel, 2009).
+	// length must be a multiple of 16, and at least 64.
+	__attribute__((target("sse4.1,pclmul"))) static uint32_t UpdateCrcPclmul(uint32_t crc, const uint8_t *buffer, size_t length)
+	{
+		// The constants of the bit-reflected domain for 0xEDB88320
+		alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+		alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+		alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+		alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+		__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+		x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x00));
+		x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x10));
+		x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x20));
+		x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x30));
+
+		x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+
+		x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+
+		buffer += 64;
+		length -= 64;
+
+		// Fold 4 x 128 bits in parallel
+		while (length >= 64)
+		{
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+			x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+			x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+			x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+			x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+			y5 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x00));
+			y6 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x10));
+			y7 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x20));
+			y8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer + 0x30));
+
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+			x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+			x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+			x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+			buffer += 64;
+			length -= 64;
+		}
+
+		// Fold into 128 bits
+		x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+		// Fold the remaining blocks of 16 bytes
+		while (length >= 16)
+		{
+			x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buffer));
+
+			x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+			x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+			x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+			buffer += 16;
+			length -= 16;
+		}
+
+		// Fold 128 bits to 64 bits
+		x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+		x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+		x1 = _mm_srli_si128(x1, 8);
+		x1 = _mm_xor_si128(x1, x2);
+
+		x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+
+		x2 = _mm_srli_si128(x1, 4);
+		x1 = _mm_and_si128(x1, x3);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
+
+		// Barrett reduction to 32 bits
+		x0 = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+
+		x2 = _mm_and_si128(x1, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+		x2 = _mm_and_si128(x2, x3);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x1 = _mm_xor_si128(x1, x2);
 
-		crc_table_computed = true;
+		return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
 	}
 
-	static unsigned long UpdateCrc(unsigned long initial, const unsigned char *buf, ssize_t len)
+	static bool IsPclmulSupported()
 	{
-		unsigned long c = initial ^0xFFFFFFFFL;
-		ssize_t n;
+		static const bool supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
 
-		if(crc_table_computed == false)
+		return supported;
+	}
+#endif  // defined(__x86_64__)
+
+	static uint32_t UpdateCrc(uint32_t initial, const uint8_t *buffer, size_t length)
+	{
+		uint32_t crc = initial ^ 0xFFFFFFFFU;
+
+#if defined(__x86_64__)
+		if ((length >= 64) && IsPclmulSupported())
 		{
-			MakeCrcTable();
+			auto folded_length = length & ~static_cast<size_t>(15);
+
+			crc = UpdateCrcPclmul(crc, buffer, folded_length);
+
+			buffer += folded_length;
+			length -= folded_length;
 		}
-		for(n = 0; n < len; n++)
+#elif defined(__ARM_FEATURE_CRC32)
+		// ARMv8 has the CRC32 instructions for the same polynomial
+		while (length >= 8)
 		{
-			c = crc_table[(c ^ buf[n]) & 0xFF] ^ (c >> 8);
+			uint64_t value;
+			::memcpy(&value, buffer, sizeof(value));
+
+			crc = __crc32d(crc, value);
+
+			buffer += 8;
+			length -= 8;
 		}
-		return c ^ 0xFFFFFFFFL;
+
+		while (length > 0)
+		{
+			crc = __crc32b(crc, *buffer);
+
+			buffer++;
+			length--;
+		}
+#endif
+
+		crc = UpdateCrcSlice8(crc, buffer, length);
+
+		return crc ^ 0xFFFFFFFFU;
 	}
 
 	uint32_t Crc32::Update(uint32_t initial, const void *buffer, ssize_t length)
 	{
-		return static_cast<uint32_t>(UpdateCrc(initial, static_cast<const uint8_t *>(buffer), length));
+		if ((buffer == nullptr) || (length <= 0))
+		{
+			return initial;
+		}
+
+		return UpdateCrc(initial, static_cast<const uint8_t *>(buffer), static_cast<size_t>(length));
 	}
 
 	uint32_t Crc32::Update(uint32_t initial, const ov::Data *data)
@@ -15,6 +15,9 @@
 namespace ov
 {
 	// RFC1952 - 8. Appendix: Sample CRC Code 부분을 참고하여 구현
+	//
+	// Uses PCLMULQDQ (x86-64, detected at runtime) or the CRC32 instructions (ARMv8, if enabled by the compiler),
+	// and slice-by-8 for the rest
 	class Crc32
 	{
 	public:
@@ -12,6 +12,7 @@
 #include <openssl/sha.h>
 #include <openssl/md5.h>
 #include <openssl/ossl_typ.h>
+#include <openssl/crypto.h>
 #include <openssl/evp.h>
 
 #include <base/ovlibrary/ovlibrary.h>
@@ -202,84 +203,10 @@ namespace ov
 
 	bool MessageDigest::ComputeHmac(CryptoAlgorithm algorithm, const void *key, size_t key_length, const void *input, size_t input_length, void *output, size_t output_length)
 	{
-		MessageDigest digest;
-
-		if(digest.Create(algorithm) == false)
-		{
-			return false;
-		}
-
-		// 현재 코드에서는 SHA-256 이하만 처리 가능
-		constexpr unsigned int block_length = 64;
-		const unsigned int digest_size = digest.Size();
-
-		// padding을 위해, 키를 임시 버퍼에 복사함
-		uint8_t new_key[block_length] = { 0 };
-
-		if(key_length > block_length)
-		{
-			// key 길이가 block 길이보다 크면 hash 한 뒤 그 결과를 key로 사용함
-			if(digest.Update(key, key_length) && digest.Finish(new_key, OV_COUNTOF(new_key)))
-			{
-				// key hash 성공
-
-				// 아래에서 재사용 할 수 있게 초기화 함
-				digest.Reset();
-			}
-			else
-			{
-				// key hash 도중 오류 발생
-				digest.Destroy();
-				return false;
-			}
-		}
-		else
-		{
-			// key 길이가 block 길이보다 작으면 그냥 복사
-			::memcpy(new_key, key, key_length);
-		}
-
-		// salt를 위해 위에서 계산한 key로 부터 패딩 계산
-
-		// input padding
-		uint8_t input_pad[block_length] = { 0 };
-		// output padding
-		uint8_t output_pad[block_length] = { 0 };
-
-		for(unsigned int index = 0; index < block_length; index++)
-		{
-			input_pad[index] = 0x36 ^ new_key[index];
-			output_pad[index] = 0x5C ^ new_key[index];
-		}
-
-		// padding 데이터 및 입력 데이터를 hash
-#if defined(__clang__)
-		uint8_t inner[digest_size];
-		memset(&inner, 0, digest_size);
-#else
-		uint8_t inner[digest_size] = { 0 };
-#endif
-		bool result = true;
-
-		// inner hash
-		// digest input padding
-		result = result && digest.Update(input_pad, OV_COUNTOF(input_pad));
-		// digest input
-		result = result && digest.Update(input, input_length);
-		result = result && digest.Finish(inner, digest_size);
+		Hmac hmac;
 
-		result = result && digest.Reset();
-
-		// outer hash
-		// digest output padding
-		result = result && digest.Update(output_pad, OV_COUNTOF(output_pad));
-		// digest inner hash
-		result = result && digest.Update(inner, digest_size);
-		result = result && digest.Finish(output, output_length);
-
-		digest.Destroy();
-
-		return result;
+		return hmac.Create(algorithm, key, key_length) &&
+			   hmac.Compute(input, input_length, output, output_length);
 	}
 
 	std::shared_ptr<ov::Data> MessageDigest::ComputeHmac(CryptoAlgorithm algorithm, const std::shared_ptr<const ov::Data> &key, const std::shared_ptr<const ov::Data> &input)
@@ -335,4 +262,164 @@ namespace ov
 	{
 		return ComputeDigest(algorithm, input->GetData(), input->GetLength());
 	}
+
+	static const EVP_MD *GetEvpMd(CryptoAlgorithm algorithm)
+	{
+		switch(algorithm)
+		{
+			case CryptoAlgorithm::Md5:
+				return EVP_md5();
+
+			case CryptoAlgorithm::Sha1:
+				return EVP_sha1();
+
+			case CryptoAlgorithm::Sha224:
+				return EVP_sha224();
+
+			case CryptoAlgorithm::Sha256:
+				return EVP_sha256();
+
+			case CryptoAlgorithm::Sha384:
+				return EVP_sha384();
+
+			case CryptoAlgorithm::Sha512:
+				return EVP_sha512();
+
+			default:
+				return nullptr;
+		}
+	}
+
+	Hmac::~Hmac()
+	{
+		Destroy();
+	}
+
+	bool Hmac::Create(CryptoAlgorithm algorithm, const void *key, size_t key_length)
+	{
+		Destroy();
+
+		const EVP_MD *md = GetEvpMd(algorithm);
+
+		if(md == nullptr)
+		{
+			logtw("Could not create Hmac for algorithm: %d", algorithm);
+			return false;
+		}
+
+		// RFC 2104 HMAC: H(K XOR opad, H(K XOR ipad, text))
+		const auto block_length = static_cast<size_t>(EVP_MD_block_size(md));
+		uint8_t new_key[EVP_MAX_MD_SIZE > 128 ? EVP_MAX_MD_SIZE : 128] = { 0 };
+
+		if(key_length > block_length)
+		{
+			// key 길이가 block 길이보다 크면 hash 한 뒤 그 결과를 key로 사용함
+			unsigned int hashed_length = 0;
+
+			if(EVP_Digest(key, key_length, new_key, &hashed_length, md, nullptr) != 1)
+			{
+				return false;
+			}
+		}
+		else if(key_length > 0)
+		{
+			::memcpy(new_key, key, key_length);
+		}
+
+		uint8_t input_pad[128];
+		uint8_t output_pad[128];
+
+		for(size_t index = 0; index < block_length; index++)
+		{
+			input_pad[index] = 0x36 ^ new_key[index];
+			output_pad[index] = 0x5C ^ new_key[index];
+		}
+
+		auto inner_context = EVP_MD_CTX_new();
+		auto outer_context = EVP_MD_CTX_new();
+
+		bool result = (inner_context != nullptr) && (outer_context != nullptr) &&
+					  (EVP_DigestInit_ex(inner_context, md, nullptr) == 1) &&
+					  (EVP_DigestUpdate(inner_context, input_pad, block_length) == 1) &&
+					  (EVP_DigestInit_ex(outer_context, md, nullptr) == 1) &&
+					  (EVP_DigestUpdate(outer_context, output_pad, block_length) == 1);
+
+		::OPENSSL_cleanse(new_key, sizeof(new_key));
+		::OPENSSL_cleanse(input_pad, sizeof(input_pad));
+		::OPENSSL_cleanse(output_pad, sizeof(output_pad));
+
+		if(result == false)
+		{
+			EVP_MD_CTX_free(inner_context);
+			EVP_MD_CTX_free(outer_context);
+			return false;
+		}
+
+		_algorithm = algorithm;
+		_inner_context = inner_context;
+		_outer_context = outer_context;
+
+		return true;
+	}
+
+	void Hmac::Destroy()
+	{
+		if(_inner_context != nullptr)
+		{
+			EVP_MD_CTX_free(static_cast<EVP_MD_CTX *>(_inner_context));
+			_inner_context = nullptr;
+		}
+
+		if(_outer_context != nullptr)
+		{
+			EVP_MD_CTX_free(static_cast<EVP_MD_CTX *>(_outer_context));
+			_outer_context = nullptr;
+		}
+
+		_algorithm = CryptoAlgorithm::Unknown;
+	}
+
+	// The working context of each thread (EVP_MD_CTX_copy_ex() reuses its memory if the digest is the same)
+	struct HmacWorkingContext
+	{
+		~HmacWorkingContext()
+		{
+			EVP_MD_CTX_free(context);
+		}
+
+		EVP_MD_CTX *context = EVP_MD_CTX_new();
+	};
+
+	bool Hmac::Compute(const void *input, size_t input_length, void *output, size_t output_length) const
+	{
+		if((_inner_context == nullptr) || (output_length < Size()))
+		{
+			OV_ASSERT2(_inner_context != nullptr);
+			return false;
+		}
+
+		static thread_local HmacWorkingContext working_context;
+		auto context = working_context.context;
+
+		if(context == nullptr)
+		{
+			return false;
+		}
+
+		uint8_t inner[EVP_MAX_MD_SIZE];
+		unsigned int inner_length = 0;
+		unsigned int final_length = 0;
+
+		bool result =
+			// inner hash
+			(EVP_MD_CTX_copy_ex(context, static_cast<const EVP_MD_CTX *>(_inner_context)) == 1) &&
+			(EVP_DigestUpdate(context, input, input_length) == 1) &&
+			(EVP_DigestFinal_ex(context, inner, &inner_length) == 1) &&
+			// outer hash
+			(EVP_MD_CTX_copy_ex(context, static_cast<const EVP_MD_CTX *>(_outer_context)) == 1) &&
+			(EVP_DigestUpdate(context, inner, inner_length) == 1) &&
+			(EVP_DigestFinal_ex(context, static_cast<unsigned char *>(output), &final_length) == 1);
+
+		return result && (final_length == Size());
+	}
 }
@@ -56,4 +56,41 @@ namespace ov
 		// 실제로는 EVP_MD_CTX * 타입. openssl을 외부로 부터 감추기 위해 void *로 선언함
 		void *_context;
 	};
+
+	// HMAC with a key that is used many times (such as the ICE password of a session)
+	//
+	// The padded key blocks are digested once in Create(), and Compute() resumes from the copies of them,
+	// so no context is allocated and only the input is digested for each message.
+	class Hmac
+	{
+	public:
+		Hmac() = default;
+		~Hmac();
+
+		Hmac(const Hmac &) = delete;
+		Hmac &operator=(const Hmac &) = delete;
+
+		bool Create(CryptoAlgorithm algorithm, const void *key, size_t key_length);
+		bool Create(CryptoAlgorithm algorithm, const ov::String &key)
+		{
+			return Create(algorithm, key.CStr(), key.GetLength());
+		}
+
+		void Destroy();
+
+		unsigned int Size() const noexcept
+		{
+			return MessageDigest::Size(_algorithm);
+		}
+
+		// Can be called from multiple threads at the same time
+		bool Compute(const void *input, size_t input_length, void *output, size_t output_length) const;
+
+	protected:
+		CryptoAlgorithm _algorithm = CryptoAlgorithm::Unknown;
+
+		// EVP_MD_CTX * that digested (key XOR ipad) and (key XOR opad)
+		void *_inner_context = nullptr;
+		void *_outer_context = nullptr;
+	};
 }
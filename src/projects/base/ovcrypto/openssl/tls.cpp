@@ -8,6 +8,15 @@
 //==============================================================================
 #include "tls.h"
 
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <openssl/hmac.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#	include <openssl/core_names.h>
+#	include <openssl/evp.h>
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+
 #include <utility>
 
 #include "./openssl_manager.h"
@@ -16,6 +25,8 @@
 #define OV_TLS_BIO_METHOD_NAME "ov::Tls"
 
 #define MAX_TLS_WRITE_SIZE (16 * 1024)
+// ContentType of the TLS record (RFC 5246, 6.2.1)
+#define TLS_RECORD_TYPE_CHANGE_CIPHER_SPEC 20
 #define DO_CALLBACK_IF_AVAILBLE(return_type, default_value, object, callback_name, ...) \
 	Tls::DoCallback<return_type, default_value, decltype(&TlsCallback::callback_name), &TlsCallback::callback_name>(object, ##__VA_ARGS__)
 
@@ -87,6 +98,38 @@ namespace ov
 		return result;
 	};
 
+	bool Tls::Initialize(const std::shared_ptr<TlsContext> &context, TlsCallback callback)
+	{
+		OV_ASSERT2(_ssl_ctx == nullptr);
+
+		if ((context == nullptr) || (context->GetSslContext() == nullptr))
+		{
+			logte("Invalid TLS context");
+			return false;
+		}
+
+		bool result = true;
+
+		_callback = std::move(callback);
+
+		// _ssl_ctx releases the reference when it is destroyed
+		::SSL_CTX_up_ref(context->GetSslContext());
+		_ssl_ctx = context->GetSslContext();
+		_context = context;
+
+		// Create BIO
+		result = result && PrepareBio();
+		// Create SSL (TlsContext finds this instance from the app data of SSL)
+		result = result && PrepareSsl(this);
+
+		if (result == false)
+		{
+			_callback = TlsCallback();
+		}
+
+		return result;
+	}
+
 	bool Tls::Uninitialize()
 	{
 		if (_ssl != nullptr)
@@ -97,6 +140,7 @@ namespace ov
 		_bio = nullptr;
 		_ssl = nullptr;
 		_ssl_ctx = nullptr;
+		_context = nullptr;
 
 		return true;
 	}
@@ -253,6 +297,13 @@ namespace ov
 
 		if (written_bytes > 0)
 		{
+			auto tls = static_cast<Tls *>(BIO_get_data(b));
+
+			if (tls != nullptr)
+			{
+				tls->CountWrittenRecords(reinterpret_cast<const uint8_t *>(in), static_cast<size_t>(written_bytes));
+			}
+
 			return static_cast<int>(written_bytes);
 		}
 		else if (written_bytes == 0)
@@ -370,6 +421,74 @@ namespace ov
 		return error;
 	}
 
+	int Tls::ReadEarlyData(void *buffer, size_t length, size_t *read_bytes, bool *is_finished)
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		size_t bytes = 0;
+		int result = ::SSL_read_early_data(_ssl, buffer, length, &bytes);
+
+		*read_bytes = 0;
+		*is_finished = false;
+
+		switch (result)
+		{
+			case SSL_READ_EARLY_DATA_SUCCESS:
+				*read_bytes = bytes;
+				return SSL_ERROR_NONE;
+
+			case SSL_READ_EARLY_DATA_FINISH:
+				// The early data is rejected or finished (the end of early data message is received)
+				*is_finished = true;
+				return SSL_ERROR_NONE;
+
+			default:
+				break;
+		}
+
+		int error = GetError(result);
+
+		if ((error != SSL_ERROR_WANT_READ) && (error != SSL_ERROR_WANT_WRITE))
+		{
+			logte("An error occurred while reading the early data: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+		}
+
+		return error;
+	}
+
+	int Tls::WriteEarlyData(const void *data, size_t length, size_t *written_bytes)
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		size_t write_size = 0;
+
+		while (write_size < length)
+		{
+			size_t bytes = 0;
+
+			if (::SSL_write_early_data(_ssl, static_cast<const char *>(data) + write_size, length - write_size, &bytes) != 1)
+			{
+				return GetError(0);
+			}
+
+			write_size += bytes;
+		}
+
+		if (written_bytes != nullptr)
+		{
+			*written_bytes += write_size;
+		}
+
+		return SSL_ERROR_NONE;
+	}
+
+	bool Tls::IsEarlyDataEnabled() const
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		return (::SSL_get_max_early_data(_ssl) > 0);
+	}
+
 	int Tls::Read(void *buffer, size_t length, size_t *read_bytes)
 	{
 		OV_ASSERT2(_ssl != nullptr);
@@ -513,6 +632,24 @@ namespace ov
 		::SSL_CTX_set_verify(_ssl_ctx, mode, nullptr);
 	}
 
+	bool Tls::IsSessionReused() const
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		return (::SSL_session_reused(_ssl) == 1);
+	}
+
+	bool Tls::VerifyCertificate(X509_STORE_CTX *store_context)
+	{
+		if (_callback.verify_callback == nullptr)
+		{
+			// Use default
+			return (::X509_verify_cert(store_context) == 1);
+		}
+
+		return _callback.verify_callback(this, store_context);
+	}
+
 	std::shared_ptr<Certificate> Tls::GetPeerCertificate() const
 	{
 		OV_ASSERT2(_ssl != nullptr);
@@ -590,6 +727,20 @@ namespace ov
 		return srtp_protection_profile->id;
 	}
 
+	bool Tls::SetSrtpProfiles(const ov::String &profiles)
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		// SSL_set_tlsext_use_srtp() returns 1 on error, 0 on success
+		if (::SSL_set_tlsext_use_srtp(_ssl, profiles.CStr()) != 0)
+		{
+			logte("Could not set SRTP profiles: %s", profiles.CStr());
+			return false;
+		}
+
+		return true;
+	}
+
 	bool Tls::GetKeySaltLen(unsigned long crypto_suite, size_t *key_len, size_t *salt_len) const
 	{
 		switch (crypto_suite)
@@ -598,6 +749,10 @@ namespace ov
 			case SRTP_AES128_CM_SHA1_80:
 				// SRTP_AES128_CM_HMAC_SHA1_32 and SRTP_AES128_CM_HMAC_SHA1_80 are defined
 				// in RFC 5764 to use a 128 bits key and 112 bits salt for the cipher.
+			case SRTP_NULL_SHA1_32:
+			case SRTP_NULL_SHA1_80:
+				// The NULL cipher profiles don't encrypt, but the session keys of HMAC are derived
+				// from the master key/salt of the same size (as libsrtp expects)
 				*key_len = 16L;
 				*salt_len = 14L;
 				break;
@@ -622,4 +777,377 @@ namespace ov
 
 		return true;
 	}
+
+	// HMAC of the TLS 1.2 PRF (EVP_MAC on OpenSSL 3, where the HMAC_* API is deprecated)
+	class Tls12PrfHmac
+	{
+	public:
+		Tls12PrfHmac(const EVP_MD *md, const void *secret, size_t secret_length)
+			: _md(md),
+			  _secret(secret),
+			  _secret_length(secret_length)
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			_mac = ::EVP_MAC_fetch(nullptr, OSSL_MAC_NAME_HMAC, nullptr);
+			_context = (_mac != nullptr) ? ::EVP_MAC_CTX_new(_mac) : nullptr;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+			_context = ::HMAC_CTX_new();
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		}
+
+		~Tls12PrfHmac()
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			::EVP_MAC_CTX_free(_context);
+			::EVP_MAC_free(_mac);
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+			::HMAC_CTX_free(_context);
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		}
+
+		bool IsValid() const
+		{
+			return _context != nullptr;
+		}
+
+		bool Init()
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			OSSL_PARAM params[] = {
+				::OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>(::EVP_MD_get0_name(_md)), 0),
+				::OSSL_PARAM_construct_end()};
+
+			return ::EVP_MAC_init(_context, static_cast<const uint8_t *>(_secret), _secret_length, params) == 1;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+			return ::HMAC_Init_ex(_context, _secret, static_cast<int>(_secret_length), _md, nullptr) == 1;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		}
+
+		bool Update(const void *data, size_t length)
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			return ::EVP_MAC_update(_context, static_cast<const uint8_t *>(data), length) == 1;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+			return ::HMAC_Update(_context, static_cast<const uint8_t *>(data), length) == 1;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		}
+
+		// output must have EVP_MAX_MD_SIZE bytes
+		bool Final(uint8_t *output, size_t *output_length)
+		{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			return ::EVP_MAC_final(_context, output, output_length, EVP_MAX_MD_SIZE) == 1;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+			unsigned int length = 0;
+			bool result = (::HMAC_Final(_context, output, &length) == 1);
+
+			*output_length = length;
+
+			return result;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		}
+
+	private:
+		const EVP_MD *_md;
+		const void *_secret;
+		size_t _secret_length;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		EVP_MAC *_mac = nullptr;
+		EVP_MAC_CTX *_context = nullptr;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		HMAC_CTX *_context = nullptr;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+	};
+
+	bool Tls::Tls12Prf(const EVP_MD *md, const void *secret, size_t secret_length, const char *label,
+					   const void *seed1, size_t seed1_length, const void *seed2, size_t seed2_length,
+					   uint8_t *output, size_t output_length)
+	{
+		// PRF(secret, label, seed) = P_<hash>(secret, label + seed)
+		//
+		// P_hash(secret, seed) = HMAC_hash(secret, A(1) + seed) + HMAC_hash(secret, A(2) + seed) + ...
+		// A(0) = seed, A(i) = HMAC_hash(secret, A(i-1))
+		Tls12PrfHmac hmac(md, secret, secret_length);
+
+		if (hmac.IsValid() == false)
+		{
+			return false;
+		}
+
+		auto label_length = ::strlen(label);
+		uint8_t a[EVP_MAX_MD_SIZE];
+		size_t a_length = 0;
+		uint8_t block[EVP_MAX_MD_SIZE];
+		size_t block_length = 0;
+
+		// A(1)
+		bool result = hmac.Init() &&
+					  hmac.Update(label, label_length) &&
+					  hmac.Update(seed1, seed1_length) &&
+					  hmac.Update(seed2, seed2_length) &&
+					  hmac.Final(a, &a_length);
+
+		while (result && (output_length > 0))
+		{
+			result = hmac.Init() &&
+					 hmac.Update(a, a_length) &&
+					 hmac.Update(label, label_length) &&
+					 hmac.Update(seed1, seed1_length) &&
+					 hmac.Update(seed2, seed2_length) &&
+					 hmac.Final(block, &block_length);
+
+			if (result)
+			{
+				auto copy_length = std::min(output_length, block_length);
+
+				::memcpy(output, block, copy_length);
+				output += copy_length;
+				output_length -= copy_length;
+
+				// A(i + 1)
+				result = hmac.Init() &&
+						 hmac.Update(a, a_length) &&
+						 hmac.Final(a, &a_length);
+			}
+		}
+
+		::OPENSSL_cleanse(a, sizeof(a));
+		::OPENSSL_cleanse(block, sizeof(block));
+
+		return result;
+	}
+
+	void Tls::CountWrittenRecords(const uint8_t *data, size_t length)
+	{
+		// The records are parsed across the writes, since OpenSSL may write a record in pieces if the BIO accepts a part of it
+		while (length > 0)
+		{
+			if (_write_record_remained > 0)
+			{
+				auto skip_length = std::min(length, _write_record_remained);
+
+				data += skip_length;
+				length -= skip_length;
+				_write_record_remained -= skip_length;
+
+				continue;
+			}
+
+			auto copy_length = std::min(length, sizeof(_write_record_header) - _write_record_header_length);
+
+			::memcpy(_write_record_header + _write_record_header_length, data, copy_length);
+			data += copy_length;
+			length -= copy_length;
+			_write_record_header_length += copy_length;
+
+			if (_write_record_header_length < sizeof(_write_record_header))
+			{
+				break;
+			}
+
+			// ContentType(1) + ProtocolVersion(2) + length(2)
+			_write_record_header_length = 0;
+			_write_record_remained = (static_cast<size_t>(_write_record_header[3]) << 8) | _write_record_header[4];
+
+			if (_write_record_header[0] == TLS_RECORD_TYPE_CHANGE_CIPHER_SPEC)
+			{
+				// The records after ChangeCipherSpec are protected with the new keys, from the sequence number 0
+				_is_write_cipher_active = true;
+				_write_record_sequence = 0;
+			}
+			else if (_is_write_cipher_active)
+			{
+				_write_record_sequence++;
+			}
+		}
+	}
+
+	bool Tls::EnableKernelTlsTx(int socket_fd)
+	{
+		OV_ASSERT2(_ssl != nullptr);
+
+		if (::SSL_version(_ssl) != TLS1_2_VERSION)
+		{
+			// The traffic secrets of TLS 1.3 cannot be obtained from the session
+			logtd("kTLS is not supported for %s", ::SSL_get_version(_ssl));
+			return false;
+		}
+
+		if ((_is_write_cipher_active == false) || (_write_record_header_length > 0) || (_write_record_remained > 0))
+		{
+			// The kernel must continue from the boundary of a record that is protected with the keys of the session
+			logtd("kTLS cannot be enabled in the middle of a record");
+			return false;
+		}
+
+		auto cipher = ::SSL_get_current_cipher(_ssl);
+
+		if (cipher == nullptr)
+		{
+			return false;
+		}
+
+		int cipher_nid = ::SSL_CIPHER_get_cipher_nid(cipher);
+		size_t key_length = 0;
+		size_t iv_length = 0;
+
+		switch (cipher_nid)
+		{
+			case NID_aes_128_gcm:
+				key_length = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+				iv_length = TLS_CIPHER_AES_GCM_128_SALT_SIZE;
+				break;
+
+			case NID_aes_256_gcm:
+				key_length = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+				iv_length = TLS_CIPHER_AES_GCM_256_SALT_SIZE;
+				break;
+
+#if defined(TLS_CIPHER_CHACHA20_POLY1305) && defined(NID_chacha20_poly1305)
+			case NID_chacha20_poly1305:
+				key_length = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+				iv_length = TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE;
+				break;
+#endif	// defined(TLS_CIPHER_CHACHA20_POLY1305) && defined(NID_chacha20_poly1305)
+
+			default:
+				logtd("kTLS is not supported for the cipher: %s", ::SSL_CIPHER_get_name(cipher));
+				return false;
+		}
+
+		// The PRF of the AEAD cipher suites of TLS 1.2 uses SHA-384 if the cipher suite ends with it, SHA-256 otherwise
+		const EVP_MD *md = ov::String(::SSL_CIPHER_get_name(cipher)).HasSuffix("SHA384") ? ::EVP_sha384() : ::EVP_sha256();
+
+		auto session = ::SSL_get_session(_ssl);
+		uint8_t master_key[SSL_MAX_MASTER_KEY_LENGTH];
+		uint8_t client_random[SSL3_RANDOM_SIZE];
+		uint8_t server_random[SSL3_RANDOM_SIZE];
+
+		size_t master_key_length = (session != nullptr) ? ::SSL_SESSION_get_master_key(session, master_key, sizeof(master_key)) : 0;
+
+		if ((master_key_length == 0) ||
+			(::SSL_get_client_random(_ssl, client_random, sizeof(client_random)) != sizeof(client_random)) ||
+			(::SSL_get_server_random(_ssl, server_random, sizeof(server_random)) != sizeof(server_random)))
+		{
+			logtd("Could not obtain the secrets of the session");
+			return false;
+		}
+
+		// key_block = client_write_key + server_write_key + client_write_IV + server_write_IV (AEAD ciphers have no MAC keys)
+		// (The largest key is 32 bytes, and the largest IV is 12 bytes)
+		uint8_t key_block[(32 + 12) * 2];
+		size_t key_block_length = (key_length + iv_length) * 2;
+
+		bool result = Tls12Prf(md, master_key, master_key_length, "key expansion",
+							   server_random, sizeof(server_random), client_random, sizeof(client_random),
+							   key_block, key_block_length);
+
+		::OPENSSL_cleanse(master_key, sizeof(master_key));
+
+		if (result == false)
+		{
+			logtd("Could not derive the keys of the session");
+			return false;
+		}
+
+		const uint8_t *server_write_key = key_block + key_length;
+		const uint8_t *server_write_iv = key_block + (key_length * 2) + iv_length;
+
+		// The sequence number of the next record, counted from the records that OpenSSL has written with the keys
+		uint8_t record_sequence[8];
+
+		for (size_t index = 0; index < sizeof(record_sequence); index++)
+		{
+			record_sequence[index] = static_cast<uint8_t>(_write_record_sequence >> (8 * (sizeof(record_sequence) - 1 - index)));
+		}
+
+		union
+		{
+			struct tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+			struct tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#if defined(TLS_CIPHER_CHACHA20_POLY1305)
+			struct tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif	// defined(TLS_CIPHER_CHACHA20_POLY1305)
+		} crypto_info;
+		socklen_t crypto_info_length = 0;
+
+		::memset(&crypto_info, 0, sizeof(crypto_info));
+
+		switch (cipher_nid)
+		{
+			case NID_aes_128_gcm:
+			{
+				auto &info = crypto_info.aes_gcm_128;
+
+				info.info.version = TLS_1_2_VERSION;
+				info.info.cipher_type = TLS_CIPHER_AES_GCM_128;
+				::memcpy(info.key, server_write_key, key_length);
+				::memcpy(info.salt, server_write_iv, iv_length);
+				// The explicit nonce is the sequence number (same as OpenSSL)
+				::memcpy(info.iv, record_sequence, sizeof(info.iv));
+				::memcpy(info.rec_seq, record_sequence, sizeof(info.rec_seq));
+				crypto_info_length = sizeof(info);
+				break;
+			}
+
+			case NID_aes_256_gcm:
+			{
+				auto &info = crypto_info.aes_gcm_256;
+
+				info.info.version = TLS_1_2_VERSION;
+				info.info.cipher_type = TLS_CIPHER_AES_GCM_256;
+				::memcpy(info.key, server_write_key, key_length);
+				::memcpy(info.salt, server_write_iv, iv_length);
+				::memcpy(info.iv, record_sequence, sizeof(info.iv));
+				::memcpy(info.rec_seq, record_sequence, sizeof(info.rec_seq));
+				crypto_info_length = sizeof(info);
+				break;
+			}
+
+#if defined(TLS_CIPHER_CHACHA20_POLY1305) && defined(NID_chacha20_poly1305)
+			case NID_chacha20_poly1305:
+			{
+				auto &info = crypto_info.chacha20_poly1305;
+
+				info.info.version = TLS_1_2_VERSION;
+				info.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+				::memcpy(info.key, server_write_key, key_length);
+				// The nonce is derived from the IV and the sequence number
+				::memcpy(info.iv, server_write_iv, iv_length);
+				::memcpy(info.rec_seq, record_sequence, sizeof(info.rec_seq));
+				crypto_info_length = sizeof(info);
+				break;
+			}
+#endif	// defined(TLS_CIPHER_CHACHA20_POLY1305) && defined(NID_chacha20_poly1305)
+		}
+
+		::OPENSSL_cleanse(key_block, sizeof(key_block));
+
+		if (::setsockopt(socket_fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0)
+		{
+			// The kernel doesn't have the tls module
+			logtd("Could not enable kTLS for the socket #%d: %s", socket_fd, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			::OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+			return false;
+		}
+
+		result = (::setsockopt(socket_fd, SOL_TLS, TLS_TX, &crypto_info, crypto_info_length) == 0);
+
+		if (result == false)
+		{
+			logtd("Could not install the keys to the socket #%d: %s", socket_fd, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		}
+		else
+		{
+#if defined(SSL_OP_NO_RENEGOTIATION)
+			// OpenSSL cannot write the handshake records anymore since the kernel has the sequence number
+			::SSL_set_options(_ssl, SSL_OP_NO_RENEGOTIATION);
+#endif	// defined(SSL_OP_NO_RENEGOTIATION)
+		}
+
+		::OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+
+		return result;
+	}
 };	// namespace ov
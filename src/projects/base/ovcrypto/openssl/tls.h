@@ -12,6 +12,7 @@
 #include "../base_64.h"
 #include "../message_digest.h"
 #include "../certificate.h"
+#include "./tls_context.h"
 
 #include <cstdint>
 #include <functional>
@@ -121,11 +122,22 @@ namespace ov
 
 		// method: DTLS_server_method(), TLS_server_method()
 		bool Initialize(const SSL_METHOD *method, const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<Certificate> &chain_certificate, const ov::String &cipher_list, TlsCallback callback);
+		// Uses the SSL_CTX which is already prepared (create_callback of the callback is not called)
+		bool Initialize(const std::shared_ptr<TlsContext> &context, TlsCallback callback);
 		bool Uninitialize();
 
 		// @return Returns SSL_ERROR_NONE on success
 		int Accept();
 
+		// Reads the early data of TLS 1.3 (0-RTT) instead of Accept() when the context allows it (See TlsContext::EnableEarlyData())
+		// is_finished: true if there is no more early data (including the client that doesn't send it), then Accept() completes the handshake
+		// @return Returns SSL_ERROR_NONE on success
+		int ReadEarlyData(void *buffer, size_t length, size_t *read_bytes, bool *is_finished);
+		// Writes the data before the handshake is completed (0.5-RTT), only while the early data is being read
+		// @return Returns SSL_ERROR_NONE on success
+		int WriteEarlyData(const void *data, size_t length, size_t *written_bytes);
+		bool IsEarlyDataEnabled() const;
+
 		// @return Returns SSL_ERROR_NONE on success
 		int Read(void *buffer, size_t length, size_t *read_bytes);
 
@@ -145,14 +157,29 @@ namespace ov
 
 		void SetVerify(int flags);
 
+		// Whether the session is resumed from the session cache/ticket (valid after the handshake)
+		bool IsSessionReused() const;
+
+		// Called by TlsContext to verify the peer certificate with verify_callback
+		bool VerifyCertificate(X509_STORE_CTX *store_context);
+
 		std::shared_ptr<Certificate> GetPeerCertificate() const;
 		bool ExportKeyingMaterial(unsigned long crypto_suite, const ov::String &label, std::shared_ptr<ov::Data> &server_key, std::shared_ptr<ov::Data> &client_key);
 
 		// APIs related to SRTP
 		unsigned long GetSelectedSrtpProfileId();
+		// Overrides the SRTP protection profiles of SSL_CTX for this session (e.g. "SRTP_AES128_CM_SHA1_80:SRTP_AES128_CM_SHA1_32")
+		bool SetSrtpProfiles(const ov::String &profiles);
 
 		bool GetKeySaltLen(unsigned long crypto_suite, size_t *key_len, size_t *salt_len) const;
 
+		// Installs the write keys of the session into the socket, so the kernel encrypts the data written to the socket (kTLS).
+		// Must be called right after the handshake is completed, before any application data is written.
+		//
+		// Only TLS 1.2 with AES-GCM or ChaCha20-Poly1305 is supported.
+		// Returns false if the session or the kernel doesn't support it, then the data must be encrypted by Write() as before.
+		bool EnableKernelTlsTx(int socket_fd);
+
 	protected:
 		static BIO_METHOD *PrepareBioMethod();
 
@@ -162,6 +189,14 @@ namespace ov
 
 		int GetError(int code);
 
+		// Follows the records written to the BIO, to know the sequence number that kTLS continues from
+		void CountWrittenRecords(const uint8_t *data, size_t length);
+
+		// TLS 1.2 PRF (RFC 5246, 5)
+		static bool Tls12Prf(const EVP_MD *md, const void *secret, size_t secret_length, const char *label,
+							 const void *seed1, size_t seed1_length, const void *seed2, size_t seed2_length,
+							 uint8_t *output, size_t output_length);
+
 		template <typename Treturn, Treturn default_value, class Tmember, Tmember member, typename... Targuments>
 		static Treturn DoCallback(void *obj, Targuments... args)
 		{
@@ -195,7 +230,17 @@ namespace ov
 		TlsUniquePtr<SSL, void, ::SSL_free> _ssl = nullptr;
 		TlsUniquePtr<SSL_CTX, void, ::SSL_CTX_free> _ssl_ctx = nullptr;
 		TlsUniquePtr<BIO, int, ::BIO_free> _bio = nullptr;
+		// Keeps the shared context alive while _ssl_ctx refers it
+		std::shared_ptr<TlsContext> _context;
 
 		TlsCallback _callback;
+
+		// The records written to the BIO (See CountWrittenRecords())
+		uint8_t _write_record_header[5];
+		size_t _write_record_header_length = 0;
+		size_t _write_record_remained = 0;
+		// Whether the server has sent ChangeCipherSpec, and the sequence number of the next record protected with the keys
+		bool _is_write_cipher_active = false;
+		uint64_t _write_record_sequence = 0;
 	};
 }  // namespace ov
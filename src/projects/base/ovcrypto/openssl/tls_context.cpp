@@ -0,0 +1,188 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "tls_context.h"
+
+#include "./tls.h"
+#include "./tls_ticket_keys.h"
+
+#define OV_LOG_TAG "OpenSSL"
+
+namespace ov
+{
+	std::shared_ptr<TlsContext> TlsContext::Create(const SSL_METHOD *method,
+												   const std::shared_ptr<Certificate> &certificate,
+												   const std::shared_ptr<Certificate> &chain_certificate,
+												   const ov::String &cipher_list,
+												   const std::function<bool(SSL_CTX *context)> &create_callback)
+	{
+		if (certificate == nullptr)
+		{
+			logte("Invalid TLS certificate");
+			return nullptr;
+		}
+
+		SSL_CTX *ssl_ctx = ::SSL_CTX_new(method);
+
+		if (ssl_ctx == nullptr)
+		{
+			logte("Cannot create SSL context");
+			return nullptr;
+		}
+
+		// ssl_ctx will be freed by the destructor
+		auto context = std::shared_ptr<TlsContext>(new TlsContext(ssl_ctx));
+
+		if (::SSL_CTX_use_certificate(ssl_ctx, certificate->GetX509()) != 1)
+		{
+			logte("Cannot use certficate: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return nullptr;
+		}
+
+		if ((chain_certificate != nullptr) && (::SSL_CTX_add1_chain_cert(ssl_ctx, chain_certificate->GetX509()) != 1))
+		{
+			logte("Cannot use chain certificate: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return nullptr;
+		}
+
+		if (::SSL_CTX_use_PrivateKey(ssl_ctx, certificate->GetPkey()) != 1)
+		{
+			logte("Cannot use private key: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return nullptr;
+		}
+
+		// The verification is delegated to the Tls of each SSL
+		::SSL_CTX_set_cert_verify_callback(ssl_ctx, VerifyCertificate, nullptr);
+
+		::SSL_CTX_set_cipher_list(ssl_ctx, cipher_list.CStr());
+
+		if ((create_callback != nullptr) && (create_callback(ssl_ctx) == false))
+		{
+			logte("An error occurred inside create callback");
+			return nullptr;
+		}
+
+		return context;
+	}
+
+	TlsContext::TlsContext(SSL_CTX *context)
+		: _ssl_ctx(context)
+	{
+	}
+
+	TlsContext::~TlsContext()
+	{
+		if (_ssl_ctx != nullptr)
+		{
+			::SSL_CTX_free(_ssl_ctx);
+			_ssl_ctx = nullptr;
+		}
+	}
+
+	bool TlsContext::EnableSessionCache(const ov::String &session_id_context, long cache_size, long timeout)
+	{
+		if (::SSL_CTX_set_session_id_context(_ssl_ctx, reinterpret_cast<const unsigned char *>(session_id_context.CStr()), session_id_context.GetLength()) != 1)
+		{
+			logte("Cannot set session id context: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return false;
+		}
+
+		// Both the session IDs (server-side cache) and the session tickets (RFC 5077, enabled by default) are accepted
+		::SSL_CTX_set_session_cache_mode(_ssl_ctx, SSL_SESS_CACHE_SERVER);
+		::SSL_CTX_sess_set_cache_size(_ssl_ctx, cache_size);
+		::SSL_CTX_set_timeout(_ssl_ctx, timeout);
+
+		return true;
+	}
+
+	bool TlsContext::EnableSessionTickets()
+	{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		if (::SSL_CTX_set_tlsext_ticket_key_evp_cb(_ssl_ctx, &TlsTicketKeys::OnTicketKey) != 1)
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		if (::SSL_CTX_set_tlsext_ticket_key_cb(_ssl_ctx, &TlsTicketKeys::OnTicketKey) != 1)
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		{
+			logte("Cannot set the ticket key callback: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TlsContext::EnableEarlyData(uint32_t max_early_data)
+	{
+		if ((::SSL_CTX_get_session_cache_mode(_ssl_ctx) & SSL_SESS_CACHE_SERVER) == 0)
+		{
+			logte("The early data cannot be protected from the replay without the session cache");
+			return false;
+		}
+
+		if ((::SSL_CTX_set_max_early_data(_ssl_ctx, max_early_data) != 1) ||
+			(::SSL_CTX_set_recv_max_early_data(_ssl_ctx, max_early_data) != 1))
+		{
+			logte("Cannot set the maximum size of the early data: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	void TlsContext::SetAlpnProtocols(const std::vector<ov::String> &protocols)
+	{
+		_alpn_protocols.Clear();
+
+		for (const auto &protocol : protocols)
+		{
+			auto length = static_cast<uint8_t>(protocol.GetLength());
+
+			_alpn_protocols.Append(&length, sizeof(length));
+			_alpn_protocols.Append(protocol.CStr(), length);
+		}
+
+		if (_alpn_protocols.IsEmpty() == false)
+		{
+			::SSL_CTX_set_alpn_select_cb(_ssl_ctx, &TlsContext::OnAlpnSelect, this);
+		}
+	}
+
+	int TlsContext::OnAlpnSelect(SSL *ssl, const unsigned char **out, unsigned char *out_length, const unsigned char *in, unsigned int in_length, void *arg)
+	{
+		auto &protocols = static_cast<TlsContext *>(arg)->_alpn_protocols;
+
+		// The first protocol of the server that the client supports is selected
+		if (::SSL_select_next_proto(const_cast<unsigned char **>(out), out_length,
+									protocols.GetDataAs<unsigned char>(), static_cast<unsigned int>(protocols.GetLength()),
+									in, in_length) != OPENSSL_NPN_NEGOTIATED)
+		{
+			// Continue the handshake without ALPN
+			return SSL_TLSEXT_ERR_NOACK;
+		}
+
+		return SSL_TLSEXT_ERR_OK;
+	}
+
+	SSL_CTX *TlsContext::GetSslContext()
+	{
+		return _ssl_ctx;
+	}
+
+	int TlsContext::VerifyCertificate(X509_STORE_CTX *store_context, void *arg)
+	{
+		auto ssl = static_cast<SSL *>(::X509_STORE_CTX_get_ex_data(store_context, ::SSL_get_ex_data_X509_STORE_CTX_idx()));
+		auto tls = (ssl != nullptr) ? static_cast<Tls *>(SSL_get_app_data(ssl)) : nullptr;
+
+		if (tls == nullptr)
+		{
+			// Use default
+			return ::X509_verify_cert(store_context);
+		}
+
+		return tls->VerifyCertificate(store_context) ? 1 : 0;
+	}
+}  // namespace ov
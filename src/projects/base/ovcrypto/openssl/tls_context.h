@@ -0,0 +1,71 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "../certificate.h"
+
+#include <functional>
+
+#include <openssl/ssl.h>
+
+#include <base/ovlibrary/ovlibrary.h>
+
+namespace ov
+{
+	// SSL_CTX that is shared by many Tls instances (e.g. all DTLS sessions of an application).
+	//
+	// Preparing SSL_CTX (loading the certificate/private key, parsing the cipher list, ...) is done once instead of every handshake,
+	// and the sessions can be resumed with the session cache/tickets of the context.
+	class TlsContext
+	{
+	public:
+		// method: DTLS_server_method(), TLS_server_method()
+		// create_callback: Setting up TLS extensions, etc
+		static std::shared_ptr<TlsContext> Create(const SSL_METHOD *method,
+												  const std::shared_ptr<Certificate> &certificate,
+												  const std::shared_ptr<Certificate> &chain_certificate,
+												  const ov::String &cipher_list,
+												  const std::function<bool(SSL_CTX *context)> &create_callback);
+
+		~TlsContext();
+
+		// session_id_context: the sessions are resumed only in the contexts of the same ID
+		// cache_size: the maximum number of the sessions in the server-side cache
+		// timeout: seconds
+		bool EnableSessionCache(const ov::String &session_id_context, long cache_size, long timeout);
+
+		// Encrypts the session tickets with the keys of TlsTicketKeys::GetShared() instead of the random key of this context,
+		// so the tickets survive the restart of the context (and can be shared with the other nodes)
+		bool EnableSessionTickets();
+
+		// TLS 1.3 0-RTT: the resumed clients can send up to max_early_data bytes of the requests with the ClientHello.
+		// To reject the replayed early data, OpenSSL keeps the TLS 1.3 sessions in the session cache (the tickets become stateful),
+		// so EnableSessionCache() must be called, and the sessions of TLS 1.3 are resumed only by this process.
+		bool EnableEarlyData(uint32_t max_early_data);
+
+		// protocols: The protocols that the server supports in order of preference (e.g. "h2", "http/1.1")
+		void SetAlpnProtocols(const std::vector<ov::String> &protocols);
+
+		SSL_CTX *GetSslContext();
+
+	protected:
+		explicit TlsContext(SSL_CTX *context);
+
+		// Calls the verify_callback of the Tls which owns the SSL of store_context
+		static int VerifyCertificate(X509_STORE_CTX *store_context, void *arg);
+
+		// SSL_CTX_set_alpn_select_cb() callback
+		static int OnAlpnSelect(SSL *ssl, const unsigned char **out, unsigned char *out_length, const unsigned char *in, unsigned int in_length, void *arg);
+
+		SSL_CTX *_ssl_ctx = nullptr;
+
+		// The protocols of ALPN in wire format (length-prefixed)
+		Data _alpn_protocols;
+	};
+}  // namespace ov
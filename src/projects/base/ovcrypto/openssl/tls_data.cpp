@@ -10,37 +10,44 @@
 
 #define OV_LOG_TAG "OpenSSL"
 
+// The maximum plaintext of a record (RFC 8446 - 5.1. Record Layer)
+#define TLS_DATA_MAX_RECORD_SIZE (16UL * 1024UL)
+
 namespace ov
 {
-	TlsData::TlsData(Method method, const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<Certificate> &chain_certificate, const ov::String &cipher_list)
+	std::atomic<bool> TlsData::_kernel_tls_enabled{false};
+
+	void TlsData::SetKernelTlsEnabled(bool enabled)
+	{
+		_kernel_tls_enabled = enabled;
+	}
+
+	bool TlsData::IsKernelTlsEnabled()
 	{
-		ov::TlsCallback callback =
+		return _kernel_tls_enabled;
+	}
+
+	TlsData::TlsData(Method method, const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<Certificate> &chain_certificate, const ov::String &cipher_list,
+					 const std::vector<ov::String> &alpn_protocols)
+	{
+		for (const auto &protocol : alpn_protocols)
+		{
+			auto length = static_cast<uint8_t>(protocol.GetLength());
+
+			_alpn_protocols.Append(&length, sizeof(length));
+			_alpn_protocols.Append(protocol.CStr(), length);
+		}
+
+		ov::TlsCallback callback = MakeCallback();
+
+		callback.create_callback = [this](ov::Tls *tls, SSL_CTX *context) -> bool {
+			if (_alpn_protocols.IsEmpty() == false)
 			{
-				.create_callback = [](ov::Tls *tls, SSL_CTX *context) -> bool {
-					return true;
-				},
-
-				.read_callback = std::bind(&TlsData::OnTlsRead, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-				.write_callback = std::bind(&TlsData::OnTlsWrite, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
-				.destroy_callback = nullptr,
-				.ctrl_callback = [](ov::Tls *tls, int cmd, long num, void *arg) -> long {
-					logtd("[TLS] Ctrl: %d, %ld, %p", cmd, num, arg);
-
-					switch (cmd)
-					{
-						case BIO_CTRL_RESET:
-						case BIO_CTRL_WPENDING:
-						case BIO_CTRL_PENDING:
-							return 0;
-
-						case BIO_CTRL_FLUSH:
-							return 1;
-
-						default:
-							return 0;
-					}
-				},
-				.verify_callback = nullptr};
+				::SSL_CTX_set_alpn_select_cb(context, &TlsData::OnAlpnSelect, this);
+			}
+
+			return true;
+		};
 
 		const SSL_METHOD *tls_method = nullptr;
 
@@ -63,6 +70,67 @@ namespace ov
 		_state = State::WaitingForAccept;
 	}
 
+	TlsData::TlsData(const std::shared_ptr<TlsContext> &context)
+	{
+		// ALPN is negotiated by the context
+		if (_tls.Initialize(context, MakeCallback()) == false)
+		{
+			logte("Could not initialize TLS: %s", ov::Error::CreateErrorFromOpenSsl()->ToString().CStr());
+		}
+		else
+		{
+			_is_reading_early_data = _tls.IsEarlyDataEnabled();
+		}
+
+		_state = State::WaitingForAccept;
+	}
+
+	TlsCallback TlsData::MakeCallback()
+	{
+		return {
+			.create_callback = nullptr,
+			.read_callback = std::bind(&TlsData::OnTlsRead, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+			.write_callback = std::bind(&TlsData::OnTlsWrite, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+			.destroy_callback = nullptr,
+			.ctrl_callback = [](ov::Tls *tls, int cmd, long num, void *arg) -> long {
+				logtd("[TLS] Ctrl: %d, %ld, %p", cmd, num, arg);
+
+				switch (cmd)
+				{
+					case BIO_CTRL_RESET:
+					case BIO_CTRL_WPENDING:
+					case BIO_CTRL_PENDING:
+						return 0;
+
+					case BIO_CTRL_FLUSH:
+						return 1;
+
+					default:
+						return 0;
+				}
+			},
+			.verify_callback = nullptr};
+	}
+
+	int TlsData::OnAlpnSelect(SSL *ssl, const unsigned char **out, unsigned char *out_length, const unsigned char *in, unsigned int in_length, void *arg)
+	{
+		auto tls_data = static_cast<TlsData *>(arg);
+		auto &protocols = tls_data->_alpn_protocols;
+
+		// The first protocol of the server that the client supports is selected
+		if (::SSL_select_next_proto(const_cast<unsigned char **>(out), out_length,
+									protocols.GetDataAs<unsigned char>(), static_cast<unsigned int>(protocols.GetLength()),
+									in, in_length) != OPENSSL_NPN_NEGOTIATED)
+		{
+			// Continue the handshake without ALPN
+			return SSL_TLSEXT_ERR_NOACK;
+		}
+
+		logtd("ALPN protocol is selected: %.*s", static_cast<int>(*out_length), *out);
+
+		return SSL_TLSEXT_ERR_OK;
+	}
+
 	TlsData::~TlsData()
 	{
 		_tls.Uninitialize();
@@ -92,8 +160,23 @@ namespace ov
 			}
 		}
 
-		if (_state == State::WaitingForAccept)
+		std::shared_ptr<Data> early_data;
+
+		if ((_state == State::WaitingForAccept) && _is_reading_early_data)
+		{
+			// The response to the early data can be written by another thread until the handshake is completed
+			std::lock_guard<std::mutex> lock_guard(_data_mutex);
+
+			if (ReadEarlyData(&early_data) == false)
+			{
+				return false;
+			}
+		}
+
+		if ((_state == State::WaitingForAccept) && (_is_reading_early_data == false))
 		{
+			std::lock_guard<std::mutex> lock_guard(_data_mutex);
+
 			logtd("Trying to accept TLS...");
 
 			int result = _tls.Accept();
@@ -124,22 +207,93 @@ namespace ov
 
 			logtd("Decrypted data\n%s", decrypted->Dump().CStr());
 
+			if ((early_data != nullptr) && (decrypted != nullptr))
+			{
+				early_data->Append(decrypted);
+				decrypted = std::move(early_data);
+			}
+
 			*plain_data = decrypted;
 		}
+		else if (early_data != nullptr)
+		{
+			*plain_data = std::move(early_data);
+		}
 
 		// Need more data to accept the request
 		return true;
 	}
 
+	bool TlsData::ReadEarlyData(std::shared_ptr<Data> *early_data)
+	{
+		uint8_t buffer[TLS_DATA_MAX_RECORD_SIZE];
+
+		while (true)
+		{
+			size_t read_bytes = 0;
+			bool is_finished = false;
+
+			// The handshake messages of the server are written by OnTlsWrite() meanwhile
+			int result = _tls.ReadEarlyData(buffer, sizeof(buffer), &read_bytes, &is_finished);
+
+			if (result == SSL_ERROR_WANT_READ)
+			{
+				return true;
+			}
+
+			if (result != SSL_ERROR_NONE)
+			{
+				return false;
+			}
+
+			if (is_finished)
+			{
+				_is_reading_early_data = false;
+				return true;
+			}
+
+			if (*early_data == nullptr)
+			{
+				*early_data = std::make_shared<Data>();
+				_is_early_data_received = true;
+
+				logtd("Early data is received");
+			}
+
+			(*early_data)->Append(buffer, read_bytes);
+		}
+	}
+
 	bool TlsData::Encrypt(const std::shared_ptr<const ov::Data> &plain_data, std::shared_ptr<const ov::Data> *cipher_data)
 	{
+		if (IsEarlyData())
+		{
+			std::lock_guard<std::mutex> lock_guard(_data_mutex);
+
+			if (_state == State::WaitingForAccept)
+			{
+				// The response to the early data is sent before the handshake is completed (0.5-RTT),
+				// the records are written by OnTlsWrite() in the order of the handshake messages
+				*cipher_data = nullptr;
+
+				return (_tls.WriteEarlyData(plain_data->GetData(), plain_data->GetLength(), nullptr) == SSL_ERROR_NONE);
+			}
+		}
+
 		if (_state != State::Accepted)
 		{
 			// Before encrypting data, key exchange must be done first
-			logtd("Invalid state: %d", _state);
+			logtd("Invalid state: %d", static_cast<int>(_state.load()));
 			return false;
 		}
 
+		if (_is_offloaded_to_kernel)
+		{
+			// The kernel encrypts the data
+			*cipher_data = plain_data;
+			return true;
+		}
+
 		logtd("Trying to encrypt the data for TLS\n%s", plain_data->Dump(32).CStr());
 
 		size_t written_bytes = 0;
@@ -154,6 +308,117 @@ namespace ov
 		return false;
 	}
 
+	bool TlsData::Encrypt(const DataChain &plain_chain, std::shared_ptr<const Data> *cipher_data)
+	{
+		if (plain_chain.GetSliceCount() == 1)
+		{
+			return Encrypt(plain_chain.GetSlices()[0], cipher_data);
+		}
+
+		if (IsEarlyData())
+		{
+			return Encrypt(plain_chain.Flatten(), cipher_data);
+		}
+
+		if (_state != State::Accepted)
+		{
+			// Before encrypting data, key exchange must be done first
+			logtd("Invalid state: %d", static_cast<int>(_state.load()));
+			return false;
+		}
+
+		if (_is_offloaded_to_kernel)
+		{
+			// The kernel encrypts the data (the callers should send the chain to the socket directly instead)
+			*cipher_data = plain_chain.Flatten();
+			return true;
+		}
+
+		uint8_t record[TLS_DATA_MAX_RECORD_SIZE];
+		size_t record_length = 0;
+		size_t written_bytes = 0;
+
+		auto flush_record = [&]() -> bool {
+			bool result = (record_length == 0) || (_tls.Write(record, record_length, &written_bytes) == SSL_ERROR_NONE);
+			record_length = 0;
+			return result;
+		};
+
+		for (const auto &slice : plain_chain)
+		{
+			auto data = slice->GetDataAs<uint8_t>();
+			auto remained = slice->GetLength();
+
+			if ((record_length == 0) && (remained >= TLS_DATA_MAX_RECORD_SIZE))
+			{
+				// The full records are encrypted from the slice without copying
+				auto length = remained - (remained % TLS_DATA_MAX_RECORD_SIZE);
+
+				if (_tls.Write(data, length, &written_bytes) != SSL_ERROR_NONE)
+				{
+					return false;
+				}
+
+				data += length;
+				remained -= length;
+			}
+
+			while (remained > 0)
+			{
+				auto length = std::min(remained, TLS_DATA_MAX_RECORD_SIZE - record_length);
+
+				::memcpy(record + record_length, data, length);
+				record_length += length;
+				data += length;
+				remained -= length;
+
+				if ((record_length == TLS_DATA_MAX_RECORD_SIZE) && (flush_record() == false))
+				{
+					return false;
+				}
+			}
+		}
+
+		if (flush_record() == false)
+		{
+			return false;
+		}
+
+		*cipher_data = std::move(_plain_data);
+
+		return true;
+	}
+
+	bool TlsData::OffloadToKernel(int socket_fd)
+	{
+		if ((_kernel_tls_enabled == false) || (_state != State::Accepted))
+		{
+			return false;
+		}
+
+		if (_is_kernel_tls_tried)
+		{
+			return _is_offloaded_to_kernel;
+		}
+
+		_is_kernel_tls_tried = true;
+
+		if ((_plain_data != nullptr) && (_plain_data->IsEmpty() == false))
+		{
+			// Some records are already encrypted with the sequence numbers of OpenSSL
+			return false;
+		}
+
+		_is_offloaded_to_kernel = _tls.EnableKernelTlsTx(socket_fd);
+
+		if (_is_offloaded_to_kernel)
+		{
+			logtd("The encryption of the socket #%d is offloaded to the kernel", socket_fd);
+		}
+
+		return _is_offloaded_to_kernel;
+	}
+
 	ssize_t TlsData::OnTlsRead(ov::Tls *tls, void *buffer, size_t length)
 	{
 		if (_cipher_data == nullptr)
@@ -186,6 +451,11 @@ namespace ov
 			OV_ASSERT2(false);
 			return -1LL;
 		}
+		else if (_is_offloaded_to_kernel)
+		{
+			// The records written by OpenSSL (such as alerts) cannot be sent since the kernel has the sequence number
+			logtw("%zu bytes are written by TLS after the encryption is offloaded to the kernel, they are discarded", length);
+		}
 		else
 		{
 			if (_plain_data == nullptr)
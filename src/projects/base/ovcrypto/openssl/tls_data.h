@@ -10,6 +10,8 @@
 
 #include "./tls.h"
 
+#include <atomic>
+
 namespace ov
 {
 	class TlsData
@@ -32,14 +34,32 @@ namespace ov
 			Accepted
 		};
 
-		TlsData(Method method, const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<Certificate> &chain_certificate, const String &cipher_list);
+		// alpn_protocols: The protocols that the server supports in order of preference (e.g. "h2", "http/1.1")
+		TlsData(Method method, const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<Certificate> &chain_certificate, const String &cipher_list,
+				const std::vector<String> &alpn_protocols = {});
+		// Uses the SSL_CTX which is shared by the connections (the certificate is loaded once, and the sessions can be resumed)
+		explicit TlsData(const std::shared_ptr<TlsContext> &context);
 		~TlsData();
 
+		// Can be called by another thread while the handshake is in progress
 		State GetState() const
 		{
 			return _state;
 		}
 
+		// Whether the session is resumed from the session cache/ticket (valid after the handshake)
+		bool IsSessionReused() const
+		{
+			return _tls.IsSessionReused();
+		}
+
+		// Whether the data is decrypted from the early data of TLS 1.3 (0-RTT) and the handshake is not completed yet.
+		// The early data can be replayed by an attacker, so only the safe requests must be processed (RFC 8470)
+		bool IsEarlyData() const
+		{
+			return (_state == State::WaitingForAccept) && _is_early_data_received;
+		}
+
 		// This callback is called when TLS negotiation is in progress
 		void SetWriteCallback(WriteCallback write_callback)
 		{
@@ -50,11 +70,28 @@ namespace ov
 		bool Decrypt(const std::shared_ptr<const Data> &cipher_data, std::shared_ptr<const Data> *plain_data);
 		// cipher_data can be null even if successful (It indicates accepting a new client)
 		bool Encrypt(const std::shared_ptr<const Data> &plain_data, std::shared_ptr<const Data> *cipher_data);
+		// Encrypts the slices as the records of the maximum size (the small slices are gathered into a record,
+		// not a record per slice, and the chain is not flattened)
+		bool Encrypt(const DataChain &plain_chain, std::shared_ptr<const Data> *cipher_data);
 
 		size_t GetDataLength() const;
 		std::shared_ptr<const Data> GetData() const;
 
+		// Whether to hand over the encryption to the kernel (kTLS) after the handshake
+		static void SetKernelTlsEnabled(bool enabled);
+		static bool IsKernelTlsEnabled();
+
+		// Installs the write keys into the socket if kTLS is enabled (it is tried only once after the handshake)
+		// Then Encrypt() returns the plain data as is, and the data can be written to the socket directly (such as sendfile())
+		bool OffloadToKernel(int socket_fd);
+		bool IsOffloadedToKernel() const
+		{
+			return _is_offloaded_to_kernel;
+		}
+
 	protected:
+		TlsCallback MakeCallback();
+
 		//--------------------------------------------------------------------
 		// Called by TLS module
 		//--------------------------------------------------------------------
@@ -63,7 +100,24 @@ namespace ov
 		// Tls::Write() -> SSL_write() -> Tls::TlsWrite() -> BIO_get_data()::write_callback -> TlsData::OnTlsWrite()
 		ssize_t OnTlsWrite(Tls *tls, const void *data, size_t length);
 
-		State _state = State::Invalid;
+		// Appends the early data to *early_data until the client finishes it
+		bool ReadEarlyData(std::shared_ptr<Data> *early_data);
+
+		// SSL_CTX_set_alpn_select_cb() callback
+		static int OnAlpnSelect(SSL *ssl, const unsigned char **out, unsigned char *out_length, const unsigned char *in, unsigned int in_length, void *arg);
+
+		std::atomic<State> _state{State::Invalid};
+
+		// Set if the context accepts the early data, and reset when the client finishes it
+		bool _is_reading_early_data = false;
+		std::atomic<bool> _is_early_data_received{false};
+
+		static std::atomic<bool> _kernel_tls_enabled;
+		bool _is_kernel_tls_tried = false;
+		bool _is_offloaded_to_kernel = false;
+
+		// The protocols of ALPN in wire format (length-prefixed)
+		Data _alpn_protocols;
 
 		Tls _tls;
 		std::mutex _data_mutex;
@@ -0,0 +1,192 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "tls_ticket_keys.h"
+
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#	include <openssl/core_names.h>
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+#include <fstream>
+
+#define OV_LOG_TAG "OpenSSL"
+
+namespace ov
+{
+	TlsTicketKeys *TlsTicketKeys::GetShared()
+	{
+		static TlsTicketKeys ticket_keys;
+
+		return &ticket_keys;
+	}
+
+	void TlsTicketKeys::SetRotationInterval(int rotation_interval)
+	{
+		std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+		_rotation_interval = std::max(rotation_interval, 1) * 1000LL;
+	}
+
+	bool TlsTicketKeys::LoadKeyFile(const ov::String &path)
+	{
+		std::ifstream file(path.CStr(), std::ios::binary);
+
+		if (file.is_open() == false)
+		{
+			logte("Could not open the ticket key file: %s", path.CStr());
+			return false;
+		}
+
+		std::deque<Key> keys;
+		uint8_t buffer[TLS_TICKET_KEY_FILE_KEY_SIZE];
+
+		while (file.read(reinterpret_cast<char *>(buffer), sizeof(buffer)))
+		{
+			Key key;
+
+			::memcpy(key.name, buffer, sizeof(key.name));
+			::memcpy(key.hmac_key, buffer + sizeof(key.name), sizeof(key.hmac_key));
+			::memcpy(key.aes_key, buffer + sizeof(key.name) + sizeof(key.hmac_key), sizeof(key.aes_key));
+
+			keys.push_back(key);
+		}
+
+		if (keys.empty() || (file.gcount() != 0))
+		{
+			logte("The size of the ticket key file must be a multiple of %d bytes: %s", TLS_TICKET_KEY_FILE_KEY_SIZE, path.CStr());
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+		_keys = std::move(keys);
+		_rotation_interval = 0LL;
+
+		logti("%zu ticket key(s) are loaded from %s", _keys.size(), path.CStr());
+
+		return true;
+	}
+
+	bool TlsTicketKeys::RotateIfNeeded()
+	{
+		if (_rotation_interval == 0LL)
+		{
+			return (_keys.empty() == false);
+		}
+
+		auto current_time = ov::Clock::CoarseNowMs();
+
+		if ((_keys.empty() == false) && ((current_time - _keys.front().created_time) < _rotation_interval))
+		{
+			return true;
+		}
+
+		Key key;
+
+		if ((::RAND_bytes(key.name, sizeof(key.name)) != 1) ||
+			(::RAND_bytes(key.hmac_key, sizeof(key.hmac_key)) != 1) ||
+			(::RAND_bytes(key.aes_key, sizeof(key.aes_key)) != 1))
+		{
+			logte("Could not generate a ticket key");
+			return (_keys.empty() == false);
+		}
+
+		key.created_time = current_time;
+
+		_keys.push_front(key);
+
+		// The tickets encrypted with the previous key are accepted for one more interval
+		while (_keys.size() > 2)
+		{
+			_keys.pop_back();
+		}
+
+		logtd("A new ticket key is generated");
+
+		return true;
+	}
+
+	int TlsTicketKeys::OnTicketKey(SSL *ssl, unsigned char key_name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context, int encrypt)
+	{
+		auto ticket_keys = GetShared();
+
+		return (encrypt == 1)
+				   ? ticket_keys->EncryptTicket(key_name, iv, cipher_context, mac_context)
+				   : ticket_keys->DecryptTicket(key_name, iv, cipher_context, mac_context);
+	}
+
+	bool TlsTicketKeys::InitMac(TlsTicketMacContext *mac_context, const Key &key)
+	{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+		OSSL_PARAM params[] = {
+			::OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<uint8_t *>(key.hmac_key), sizeof(key.hmac_key)),
+			::OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>("SHA256"), 0),
+			::OSSL_PARAM_construct_end()};
+
+		return ::EVP_MAC_CTX_set_params(mac_context, params) == 1;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+		return ::HMAC_Init_ex(mac_context, key.hmac_key, sizeof(key.hmac_key), ::EVP_sha256(), nullptr) == 1;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+	}
+
+	int TlsTicketKeys::EncryptTicket(unsigned char key_name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context)
+	{
+		std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+		if (RotateIfNeeded() == false)
+		{
+			// Don't issue a ticket
+			return 0;
+		}
+
+		auto &key = _keys.front();
+
+		if (::RAND_bytes(iv, EVP_CIPHER_iv_length(::EVP_aes_256_cbc())) != 1)
+		{
+			return -1;
+		}
+
+		::memcpy(key_name, key.name, sizeof(key.name));
+
+		if ((::EVP_EncryptInit_ex(cipher_context, ::EVP_aes_256_cbc(), nullptr, key.aes_key, iv) != 1) ||
+			(InitMac(mac_context, key) == false))
+		{
+			return -1;
+		}
+
+		return 1;
+	}
+
+	int TlsTicketKeys::DecryptTicket(const unsigned char key_name[16], const unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context)
+	{
+		std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+		for (size_t index = 0; index < _keys.size(); index++)
+		{
+			auto &key = _keys[index];
+
+			if (::memcmp(key_name, key.name, sizeof(key.name)) != 0)
+			{
+				continue;
+			}
+
+			if ((InitMac(mac_context, key) == false) ||
+				(::EVP_DecryptInit_ex(cipher_context, ::EVP_aes_256_cbc(), nullptr, key.aes_key, iv) != 1))
+			{
+				return -1;
+			}
+
+			// 2: The ticket is valid, but a new ticket is issued with the current key
+			return (index == 0) ? 1 : 2;
+		}
+
+		// Unknown key (expired, or issued by another node): a full handshake is done
+		return 0;
+	}
+}  // namespace ov
@@ -0,0 +1,79 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <deque>
+#include <mutex>
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#if OPENSSL_VERSION_NUMBER < 0x30000000L
+#	include <openssl/hmac.h>
+#endif	// OPENSSL_VERSION_NUMBER < 0x30000000L
+
+#include <base/ovlibrary/ovlibrary.h>
+
+// The size of a key in the ticket key file (name + HMAC-SHA256 key + AES-256-CBC key)
+#define TLS_TICKET_KEY_FILE_KEY_SIZE 80
+
+namespace ov
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	// The HMAC_* API is deprecated since OpenSSL 3.0 (See SSL_CTX_set_tlsext_ticket_key_evp_cb())
+	using TlsTicketMacContext = EVP_MAC_CTX;
+#else	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+	using TlsTicketMacContext = HMAC_CTX;
+#endif	// OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+	// The keys that encrypt the session tickets (RFC 5077)
+	//
+	// By default, a new key is generated for every rotation interval, and the previous key is still accepted for one more interval.
+	// The nodes behind a load balancer can resume the sessions of each other if they load the same key file.
+	class TlsTicketKeys
+	{
+	public:
+		// rotation_interval: seconds
+		void SetRotationInterval(int rotation_interval);
+
+		// Loads the keys of TLS_TICKET_KEY_FILE_KEY_SIZE bytes from the file, the first key encrypts the new tickets
+		// (The keys are not rotated anymore)
+		bool LoadKeyFile(const ov::String &path);
+
+		// The callback of SSL_CTX_set_tlsext_ticket_key_evp_cb() (SSL_CTX_set_tlsext_ticket_key_cb() before OpenSSL 3.0)
+		static int OnTicketKey(SSL *ssl, unsigned char key_name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context, int encrypt);
+
+		static TlsTicketKeys *GetShared();
+
+	protected:
+		struct Key
+		{
+			uint8_t name[16];
+			uint8_t hmac_key[32];
+			uint8_t aes_key[32];
+
+			int64_t created_time = 0LL;
+		};
+
+		// Generates a new key if the current key is expired (must be called with _key_mutex)
+		bool RotateIfNeeded();
+
+		// Sets the HMAC-SHA256 key to the MAC context of the ticket
+		static bool InitMac(TlsTicketMacContext *mac_context, const Key &key);
+
+		int EncryptTicket(unsigned char key_name[16], unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context);
+		int DecryptTicket(const unsigned char key_name[16], const unsigned char *iv, EVP_CIPHER_CTX *cipher_context, TlsTicketMacContext *mac_context);
+
+		std::mutex _key_mutex;
+		// The first key encrypts the new tickets, the others only decrypt the tickets
+		std::deque<Key> _keys;
+
+		// 0 if the keys are loaded from the file
+		int64_t _rotation_interval = 3600LL * 1000LL;
+	};
+}  // namespace ov
@@ -15,4 +15,6 @@
 
 #include "./openssl/openssl_manager.h"
 #include "./openssl/tls.h"
-#include "./openssl/tls_data.h"
\ No newline at end of file
+#include "./openssl/tls_context.h"
+#include "./openssl/tls_data.h"
+#include "./openssl/tls_ticket_keys.h"
\ No newline at end of file
@@ -2,18 +2,24 @@
 
 #include <utility>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <algorithm>
 
+#include "assert.h"
+
+// Reads the bits from MSB (the bitstreams of codecs such as H.264 SPS, AAC AudioSpecificConfig, ADTS)
+//
+// The bytes are loaded into a 64-bit cache register, so a read of up to 57 bits is a shift and a mask
+// instead of a loop over the bits, and the exp-Golomb codes are decoded by counting the leading zeros.
 class BitReader
 {
 
 public:
     BitReader(const uint8_t *buffer, size_t capacity) : buffer_(buffer),
         position_(buffer),
-        capacity_(capacity),
-        bit_offset_(0),
-        mask_(0x80)
+        capacity_(capacity)
     {
     }
 
@@ -26,23 +32,21 @@ public:
             return false;
         }
         value = 0;
-        if (bits == 0) return 0;
-        if (static_cast<size_t>((bits + 7) / 8) > static_cast<size_t>(capacity_ - (position_ - buffer_))) return false;
-        while (bits)
+        if (bits == 0) return true;
+        if (bits > BitsRemained()) return false;
+
+        uint64_t result = 0;
+
+        // The cache holds at least 57 bits after Refill() unless the end of the buffer is reached,
+        // so a read of more than 56 bits is done in two steps
+        if (bits > 56)
         {
-            const uint8_t bits_from_this_byte = std::min(bits > 8 ? 8 : bits % 8, 8 - bit_offset_);
-            const uint8_t mask_offset = 8 - bits_from_this_byte - bit_offset_;
-            const uint8_t mask = ((1 << bits_from_this_byte ) - 1) << mask_offset;
-            value <<= bits_from_this_byte;
-            value |=  (*position_ & mask) >> mask_offset;
-            bits -= bits_from_this_byte;
-            bit_offset_ += bits_from_this_byte;
-            if (bit_offset_ == 8)
-            {
-                ++position_;
-                bit_offset_ = 0;
-            }
+            result = TakeBits(bits - 32) << 32;
+            bits = 32;
         }
+
+        result |= TakeBits(bits);
+        value = static_cast<T>(result);
         return true;
     }
 
@@ -59,34 +63,139 @@ public:
 
     bool ReadBit(uint8_t &value)
     {
-        if (static_cast<size_t>(position_ - buffer_) == capacity_) return false;
-        value = *position_ & (1  << (7 - bit_offset_)) ? 1 : 0;
-        if (bit_offset_ == 7)
+        if (BitsRemained() == 0) return false;
+        value = static_cast<uint8_t>(TakeBits(1));
+        return true;
+    }
+
+    // ue(v) - 9.1 Parsing process for Exp-Golomb codes (ISO/IEC 14496-10)
+    bool ReadUE(uint32_t &value)
+    {
+        Refill();
+
+        // The leading zero bits and the following 1 are in the cache
+        // (up to 31 leading zeros are allowed for 32-bit values)
+        int leading_zeros = (cache_ == 0) ? 64 : __builtin_clzll(cache_);
+
+        if ((leading_zeros > 31) || (leading_zeros >= cache_bits_))
         {
-            ++position_;
-            bit_offset_ = 0;
+            return false;
+        }
+
+        const int code_bits = leading_zeros * 2 + 1;
+
+        if (code_bits <= cache_bits_)
+        {
+            value = static_cast<uint32_t>(TakeBits(code_bits) - 1);
+            return true;
+        }
+
+        // Longer than the cached bits
+        uint64_t info = 0;
+        TakeBits(leading_zeros + 1);
+        if (ReadBits(static_cast<uint8_t>(leading_zeros), info) == false)
+        {
+            return false;
+        }
+        value = static_cast<uint32_t>(((1ULL << leading_zeros) | info) - 1);
+        return true;
+    }
+
+    // se(v) - 9.1.1 Mapping process for signed Exp-Golomb codes
+    bool ReadSE(int32_t &value)
+    {
+        uint32_t code_num;
+        if (ReadUE(code_num) == false)
+        {
+            return false;
+        }
+        // 1 => 1, 2 => -1, 3 => 2, 4 => -2, ...
+        value = (code_num & 1) ? static_cast<int32_t>((code_num + 1) / 2) : -static_cast<int32_t>(code_num / 2);
+        return true;
+    }
+
+    bool SkipBits(size_t bits)
+    {
+        if (bits > BitsRemained()) return false;
+
+        // Drop the cached bits, and then move the position for the rest
+        const size_t from_cache = std::min(bits, static_cast<size_t>(cache_bits_));
+        if (from_cache > 0)
+        {
+            TakeBits(static_cast<int>(from_cache));
+            bits -= from_cache;
         }
-        else
+        position_ += bits / 8;
+        bits %= 8;
+        if (bits > 0)
         {
-            ++bit_offset_;
+            TakeBits(static_cast<int>(bits));
         }
         return true;
     }
 
     size_t BytesConsumed() const
     {
-        return position_ - buffer_;
+        return BitsConsumed() / 8;
     }
 
     size_t BitsConsumed() const
     {
-        return (position_ - buffer_) * 8 + bit_offset_;
+        return (position_ - buffer_) * 8 - cache_bits_;
+    }
+
+    size_t BitsRemained() const
+    {
+        return capacity_ * 8 - BitsConsumed();
     }
 
 private:
+    // Loads the bytes into the cache (left-aligned) until it holds more than 56 bits
+    void Refill()
+    {
+        const uint8_t *end = buffer_ + capacity_;
+
+        if ((cache_bits_ <= 0) && ((end - position_) >= 8))
+        {
+            // Load 8 bytes at once
+            uint64_t value;
+            ::memcpy(&value, position_, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            value = __builtin_bswap64(value);
+#endif
+            cache_ = value;
+            cache_bits_ = 64;
+            position_ += 8;
+            return;
+        }
+
+        while ((cache_bits_ <= 56) && (position_ < end))
+        {
+            cache_ |= static_cast<uint64_t>(*position_) << (56 - cache_bits_);
+            cache_bits_ += 8;
+            ++position_;
+        }
+    }
+
+    // bits must be 1 ~ 57 (or up to the cached bits), and the caller checked BitsRemained()
+    uint64_t TakeBits(int bits)
+    {
+        if (cache_bits_ < bits)
+        {
+            Refill();
+        }
+
+        const uint64_t value = cache_ >> (64 - bits);
+        cache_ = (bits == 64) ? 0 : (cache_ << bits);
+        cache_bits_ -= bits;
+        return value;
+    }
+
     const uint8_t *const buffer_;
+    // The next byte to load into the cache
     const uint8_t* position_;
     const size_t capacity_;
-    int bit_offset_;
-    uint8_t mask_;
+    // The bits that are loaded but not consumed yet, from MSB
+    uint64_t cache_ = 0;
+    int cache_bits_ = 0;
 };
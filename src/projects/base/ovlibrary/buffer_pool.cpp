@@ -0,0 +1,82 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "buffer_pool.h"
+
+namespace ov
+{
+	std::shared_ptr<BufferPool> BufferPool::Create(size_t buffer_size, size_t max_free_count)
+	{
+		return std::shared_ptr<BufferPool>(new BufferPool(buffer_size, max_free_count));
+	}
+
+	BufferPool::BufferPool(size_t buffer_size, size_t max_free_count)
+		: _buffer_size(buffer_size),
+		  _max_free_count(max_free_count)
+	{
+		_free_list.reserve(max_free_count);
+	}
+
+	BufferPool::~BufferPool()
+	{
+		for (auto buffer : _free_list)
+		{
+			DataBuffer::Free(buffer);
+		}
+	}
+
+	DataBufferPtr BufferPool::Allocate()
+	{
+		DataBuffer *buffer = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_free_list.empty() == false)
+			{
+				buffer = _free_list.back();
+				_free_list.pop_back();
+			}
+		}
+
+		if (buffer == nullptr)
+		{
+			buffer = DataBuffer::Allocate(_buffer_size);
+		}
+		else
+		{
+			buffer->Account();
+		}
+
+		buffer->SetRecycler(shared_from_this());
+
+		return DataBufferPtr(buffer);
+	}
+
+	size_t BufferPool::GetFreeCount() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _free_list.size();
+	}
+
+	void BufferPool::Recycle(DataBuffer *buffer)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_free_list.size() < _max_free_count)
+			{
+				_free_list.push_back(buffer);
+				return;
+			}
+		}
+
+		DataBuffer::Free(buffer);
+	}
+}  // namespace ov
@@ -0,0 +1,55 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "./data_buffer.h"
+
+namespace ov
+{
+	// A free list of fixed-size buffers that can be used as the storage of ov::Data
+	//
+	// The buffers allocated from the pool return to the free list when the last reference is released
+	// (the pool is kept alive by the buffers in use),
+	// so the hot path (such as receiving datagrams) doesn't need to call malloc()/free() for each packet.
+	class BufferPool : public DataBufferRecycler, public std::enable_shared_from_this<BufferPool>
+	{
+	public:
+		// max_free_count: The maximum number of buffers kept in the free list (the remains are freed)
+		static std::shared_ptr<BufferPool> Create(size_t buffer_size, size_t max_free_count);
+
+		~BufferPool() override;
+
+		// Returns a buffer with the capacity of GetBufferSize() (the bytes are not initialized)
+		DataBufferPtr Allocate();
+
+		size_t GetBufferSize() const
+		{
+			return _buffer_size;
+		}
+
+		size_t GetFreeCount() const;
+
+	protected:
+		BufferPool(size_t buffer_size, size_t max_free_count);
+
+		// Keeps the buffer in the free list, or frees it if the free list is full
+		void Recycle(DataBuffer *buffer) override;
+
+		const size_t _buffer_size;
+		const size_t _max_free_count;
+
+		mutable std::mutex _mutex;
+		std::vector<DataBuffer *> _free_list;
+	};
+}  // namespace ov
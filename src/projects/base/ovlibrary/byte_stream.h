@@ -15,11 +15,15 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <type_traits>
 
+// Returns 0 if there is not enough data (the offset is not changed)
 #define OV_DECLARE_READ_FUNCTION(type, name, func) \
 	inline type name() noexcept                    \
 	{                                              \
-		return func(*Read<type>());                \
+		type value = 0;                            \
+		Read<type>(&value);                        \
+		return func(value);                        \
 	}
 
 #define OV_DECLARE_WRITE_FUNCTION(type, name, func) \
@@ -73,7 +77,24 @@ namespace ov
 			{
 				if (buffer != nullptr)
 				{
-					::memcpy(buffer, CurrentBuffer<T>(), sizeof(T) * peek_count);
+					if constexpr (std::is_trivially_copy_assignable_v<T>)
+					{
+						::memcpy(buffer, CurrentBuffer<T>(), sizeof(T) * peek_count);
+					}
+					else
+					{
+						static_assert(std::is_same_v<T, uint24_t>, "T must be trivially copyable");
+
+						// uint24_t is not assignable, so it is built from the bytes in host order
+						auto source = CurrentBuffer<uint8_t>();
+
+						for (size_t index = 0; index < peek_count; index++, source += sizeof(T))
+						{
+							buffer[index].data = OV_SELECT_BY_ENDIAN(
+								source[0] | (source[1] << 8) | (source[2] << 16),
+								(source[0] << 16) | (source[1] << 8) | source[2]);
+						}
+					}
 				}
 			}
 
@@ -180,6 +201,33 @@ namespace ov
 			return buffer;
 		}
 
+		/// Big endian 데이터들을 한 번의 bounds check로 읽음. 데이터가 부족하면 아무것도 읽지 않음
+		/// 사용 방법)
+		/// uint16_t type;
+		/// uint24_t length = 0;
+		/// uint32_t cookie;
+		/// if (stream.ReadBE(type, length, cookie)) { ... }
+		///
+		/// @return 데이터가 충분하여 모두 읽었는지 여부
+		template <typename... T>
+		inline bool ReadBE(T &...values) noexcept
+		{
+			constexpr size_t total_bytes = (sizeof(T) + ... + 0);
+
+			if (Remained() < total_bytes)
+			{
+				return false;
+			}
+
+			const uint8_t *buffer = CurrentBuffer<uint8_t>();
+
+			(ReadBEValue(buffer, values), ...);
+
+			_offset += total_bytes;
+
+			return true;
+		}
+
 		// byte order를 고려하여 읽을 수 있는 유틸리티 함수
 		// 사용 방법)
 		// uint8_t b = stream.Read8();
@@ -548,6 +596,30 @@ namespace ov
 		bool PopOffset() noexcept;
 
 	protected:
+		// The bytes are combined from MSB, so it does not need an aligned address (the compiler emits a bswap)
+		template <typename T>
+		static inline void ReadBEValue(const uint8_t *&buffer, T &value) noexcept
+		{
+			uint64_t result = 0;
+
+			for (size_t index = 0; index < sizeof(T); index++)
+			{
+				result = (result << 8) | buffer[index];
+			}
+
+			if constexpr (std::is_same_v<T, uint24_t>)
+			{
+				// uint24_t is not assignable
+				value.data = static_cast<uint32_t>(result);
+			}
+			else
+			{
+				value = static_cast<T>(result);
+			}
+
+			buffer += sizeof(T);
+		}
+
 		/// 현재 버퍼 위치를 T 타입으로 얻어옴
 		///
 		/// @tparam T 데이터 타입
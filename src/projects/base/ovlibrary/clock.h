@@ -32,6 +32,74 @@ namespace ov
 			return result;
 		}
 
+		// The clocks for the deadlines/elapsed times
+		//
+		// - They are monotonic (CLOCK_MONOTONIC, the same as std::chrono::steady_clock), so the timeouts do not misfire
+		//   when NTP steps the wall clock. Only the differences between the values are meaningful.
+		// - Use the wall clock (std::chrono::system_clock, time()) only for the values shown to the users.
+
+		// Monotonic time in milliseconds
+		static inline int64_t NowMs() noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Monotonic time in microseconds
+		static inline int64_t NowUs() noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Monotonic time in milliseconds with the resolution of a kernel tick (1~4ms).
+		// CLOCK_MONOTONIC_COARSE is read from the vDSO without reading the hardware clock source,
+		// which is a syscall on some VMs (such as the Xen/HPET clock sources).
+		static inline int64_t CoarseNowMs() noexcept
+		{
+			struct timespec now;
+			::clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+
+			return static_cast<int64_t>(now.tv_sec) * 1000 + (now.tv_nsec / 1000000);
+		}
+
+		// The wall clock with the resolution of a kernel tick, for the statistics updated per packet
+		static inline std::chrono::system_clock::time_point CoarseSystemNow() noexcept
+		{
+			struct timespec now;
+			::clock_gettime(CLOCK_REALTIME_COARSE, &now);
+
+			return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+				std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec)));
+		}
+
+		// The monotonic time (ms) of the current iteration of the event loop of this thread
+		//
+		// The event loops (such as ov::Socket::EpollWait()) call UpdateCachedNow() per iteration, so the packets
+		// handled in an iteration share a value instead of reading the clock for each packet.
+		// In the threads that have no event loop, it is the same as CoarseNowMs().
+		static inline int64_t CachedNowMs() noexcept
+		{
+			auto &cache = GetCache();
+
+			return cache.is_updated_by_loop ? cache.now_ms : CoarseNowMs();
+		}
+
+		// Seconds of CachedNowMs()
+		static inline int64_t CachedNowSec() noexcept
+		{
+			return CachedNowMs() / 1000;
+		}
+
+		// Called by the event loops per iteration
+		static inline int64_t UpdateCachedNow() noexcept
+		{
+			auto &cache = GetCache();
+
+			cache.now_ms = CoarseNowMs();
+			cache.is_updated_by_loop = true;
+
+			return cache.now_ms;
+		}
+
 		#define GETTIMEOFDAY_TO_NTP_OFFSET 2208988800 //  Number of seconds between 1-Jan-1900 and 1-Jan-1970
 		static void	GetNtpTime(uint32_t &msw, uint32_t &lsw)
 		{
@@ -41,5 +109,18 @@ namespace ov
 			msw = (uint32_t)(now.tv_sec) + GETTIMEOFDAY_TO_NTP_OFFSET;
 			lsw = (uint32_t)((double)(now.tv_nsec/1000)*(double)(((uint64_t)1)<<32)*1.0e-6);
 		}
+
+	private:
+		struct Cache
+		{
+			int64_t now_ms = 0;
+			bool is_updated_by_loop = false;
+		};
+
+		static inline Cache &GetCache() noexcept
+		{
+			thread_local Cache cache;
+			return cache;
+		}
 	};
 }
\ No newline at end of file
@@ -111,6 +111,12 @@ namespace ov
 					return "Rtsp";
 				case StreamSourceType::RtspPull:
 					return "RtspPull";
+				case StreamSourceType::Webrtc:
+					return "Webrtc";
+				case StreamSourceType::Srt:
+					return "Srt";
+				case StreamSourceType::Replay:
+					return "Replay";
 				case StreamSourceType::Transcoder:
 					return "Transcoder";
 				default:
@@ -130,6 +136,12 @@ namespace ov
 					return "RTSP Pull";
 				case ProviderType::Ovt:
 					return "OVT";
+				case ProviderType::Webrtc:
+					return "WebRTC";
+				case ProviderType::Srt:
+					return "SRT";
+				case ProviderType::Replay:
+					return "Replay";
 				case ProviderType::Unknown:
 				default:
 					return "Unknown";
@@ -152,6 +164,8 @@ namespace ov
 					return "LLDASH";
 				case PublisherType::Ovt:
 					return "Ovt";
+				case PublisherType::Record:
+					return "Record";
 				case PublisherType::Unknown:
 				default:
 					return "Unknown";
@@ -8,20 +8,35 @@
 //==============================================================================
 #include "data.h"
 #include "./assert.h"
+#include "./data_pool.h"
 #include "./dump_utilities.h"
 
 #include <cstdint>
 
 namespace ov
 {
+	// Returns a storage that can hold capacity bytes (the bytes are not initialized)
+	static DataBufferPtr AllocateStorage(size_t capacity)
+	{
+		if ((capacity > 0) && DataPool::IsEnabled())
+		{
+			return DataPool::Allocate(capacity);
+		}
+
+		return DataBufferPtr(DataBuffer::Allocate(capacity));
+	}
+
 	Data::Data()
 		: Data(0)
 	{
 	}
 
-	Data::Data(size_t capacity)
+	Data::Data(size_t capacity, size_t headroom)
 	{
-		Reserve(capacity);
+		if ((capacity > 0) || (headroom > 0))
+		{
+			Reallocate(headroom, capacity);
+		}
 	}
 
 	Data::Data(const void *data, size_t length, bool reference_only)
@@ -46,21 +61,56 @@ namespace ov
 		}
 	}
 
+	Data::Data(const void *data, size_t length, const std::shared_ptr<const void> &owner)
+		: _reference_data(data),
+		  _reference_owner(owner),
+		  _length(length)
+	{
+		OV_ASSERT2((data != nullptr) && (length > 0));
+	}
+
+	Data::Data(const void *data, size_t length, const std::shared_ptr<const void> &owner, int file_descriptor, off_t file_offset)
+		: _reference_data(data),
+		  _reference_owner(owner),
+		  _file_descriptor(file_descriptor),
+		  _file_offset(file_offset),
+		  _length(length)
+	{
+		OV_ASSERT2((data != nullptr) && (length > 0));
+		OV_ASSERT2(file_descriptor >= 0);
+	}
+
+	Data::Data(DataBufferPtr storage, size_t length)
+		: _allocated_data(std::move(storage)),
+		  _length(length)
+	{
+		OV_ASSERT2(_allocated_data != nullptr);
+		OV_ASSERT2(_allocated_data->GetCapacity() >= length);
+	}
+
 	Data::Data(const Data &data)
 	{
 		_reference_data = data._reference_data;
+		_reference_owner = data._reference_owner;
+		_file_descriptor = data._file_descriptor;
+		_file_offset = data._file_offset;
+		_offset = data._offset;
+		_length = data._length;
+
 		if (data._allocated_data != nullptr)
 		{
-			_allocated_data = std::make_shared<std::vector<uint8_t>>();
-			Append(&data);
+			_allocated_data = data._allocated_data;
+			// Copy the bytes now, not to share the storage with data
+			Reallocate(0, _length);
 		}
-		_offset = data._offset;
-		_length = data._length;
 	}
 
 	Data::Data(Data &&data) noexcept
 	{
 		std::swap(_reference_data, data._reference_data);
+		std::swap(_reference_owner, data._reference_owner);
+		std::swap(_file_descriptor, data._file_descriptor);
+		std::swap(_file_offset, data._file_offset);
 		std::swap(_allocated_data, data._allocated_data);
 		std::swap(_offset, data._offset);
 		std::swap(_length, data._length);
@@ -104,6 +154,9 @@ namespace ov
 		{
 			// Refer _reference_data
 			instance->_reference_data = _reference_data;
+			instance->_reference_owner = _reference_owner;
+			instance->_file_descriptor = _file_descriptor;
+			instance->_file_offset = _file_offset;
 		}
 		else
 		{
@@ -152,6 +205,9 @@ namespace ov
 
 		// ov::Data supports COW (Copy-on-write), so we just assign the variables of data to member variables.
 		_reference_data = data._reference_data;
+		_reference_owner = data._reference_owner;
+		_file_descriptor = data._file_descriptor;
+		_file_offset = data._file_offset;
 		_allocated_data = data._allocated_data;
 		_offset = data._offset;
 		_length = data._length;
@@ -204,80 +260,70 @@ namespace ov
 		return (GetLength() == 0);
 	}
 
+	bool Data::HasOwnStorage() const
+	{
+		return (_reference_data == nullptr) && (_allocated_data != nullptr) && (_allocated_data->IsShared() == false);
+	}
+
 	bool Data::Detach()
 	{
-		if (_reference_data != nullptr)
+		if (HasOwnStorage())
 		{
-			// Copy from original data
-			const void *original_data = _reference_data;
-			off_t offset = _offset;
-			size_t length = _length;
+			// Nobody references _allocated_data. So do not need to copy the data
+			return true;
+		}
 
-			_reference_data = nullptr;
-			_offset = 0;
-			_length = 0;
+		// Copy from the original data (_reference_data, or _allocated_data shared with the others)
+		return Reallocate(0, _length);
+	}
 
-			return Reserve(length) && Append(static_cast<const uint8_t *>(original_data) + offset, length);
-		}
+	bool Data::Reallocate(size_t headroom, size_t capacity)
+	{
+		OV_ASSERT2(capacity >= _length);
 
-		if (_allocated_data == nullptr)
-		{
-			OV_ASSERT2(false);
-			return false;
-		}
+		auto storage = AllocateStorage(headroom + capacity);
 
-		if (_allocated_data.use_count() == 1)
+		if (_length > 0)
 		{
-			// Nobody references _allocated_data. So do not need to copy the data
-			if(_allocated_data->size() == GetLength())
-			{
-				return true;
-			}
-
-			// Need to shrink the vector size
+			// _reference_owner/_allocated_data keep the old data alive until it is copied
+			::memcpy(storage->GetBytes() + headroom, GetData(), _length);
 		}
 
-		// Copy data from <_offset> to <_offset + length>
-		auto old_data = _allocated_data;
-		auto old_offset = _offset;
-		auto begin = old_data->begin() + _offset;
-		auto end = begin + _length;
-
-		// Reset the offset
-		_offset = 0L;
-
-		_allocated_data = std::make_shared<std::vector<uint8_t>>(begin, end);
-		_allocated_data->reserve(old_data->capacity() - old_offset);
+		_reference_data = nullptr;
+		_reference_owner = nullptr;
+		_file_descriptor = -1;
+		_file_offset = 0;
+		_allocated_data = std::move(storage);
+		_offset = headroom;
 
-		return (_allocated_data != nullptr);
+		return true;
 	}
 
 	bool Data::Reserve(size_t capacity)
 	{
-		if ((_reference_data != nullptr) || (_allocated_data != nullptr))
+		if (HasOwnStorage() == false)
 		{
-			if (Detach() == false)
-			{
-				// Could not copy data from _reference_data
-				OV_ASSERT2(false);
-				return false;
-			}
+			// Copy the data once with the capacity
+			return Reallocate(0, std::max(capacity, _length));
 		}
-		else
+
+		if (GetCapacity() < capacity)
 		{
-			_allocated_data = std::make_shared<std::vector<uint8_t>>();
+			// Keep the headroom
+			return Reallocate(_offset, capacity);
 		}
 
-		_allocated_data->reserve(capacity);
-
 		return true;
 	}
 
 	bool Data::Clear() noexcept
 	{
-		// Reallocate the buffer (this method is faster than Detach() & clear());
+		// Release the storage (this method is faster than Detach() & clear(), and the storage is allocated when it is needed)
 		_reference_data = nullptr;
-		_allocated_data = std::make_shared<std::vector<uint8_t>>();
+		_reference_owner = nullptr;
+		_file_descriptor = -1;
+		_file_offset = 0;
+		_allocated_data = nullptr;
 		_offset = 0;
 		_length = 0;
 
@@ -308,14 +354,43 @@ namespace ov
 			}
 		}
 
-		if (Detach() == false)
+		if (length == 0)
 		{
-			return false;
+			return true;
+		}
+
+		auto required_capacity = _length + length;
+
+		if (HasOwnStorage() == false)
+		{
+			// Copy the data once with the capacity
+			if (Reallocate(0, required_capacity) == false)
+			{
+				return false;
+			}
+		}
+
+		if ((offset == 0) && (static_cast<size_t>(_offset) >= length))
+		{
+			// Use the headroom
+			_offset -= length;
 		}
+		else
+		{
+			if (GetCapacity() < required_capacity)
+			{
+				// Grow geometrically like std::vector (the headroom is kept)
+				if (Reallocate(_offset, std::max(required_capacity, GetCapacity() * 2)) == false)
+				{
+					return false;
+				}
+			}
 
-		auto source = static_cast<const uint8_t *>(data);
+			auto position = _allocated_data->GetBytes() + _offset + offset;
+			::memmove(position + length, position, _length - offset);
+		}
 
-		_allocated_data->insert(_allocated_data->begin() + (_offset + offset), source, source + length);
+		::memcpy(_allocated_data->GetBytes() + _offset + offset, data, length);
 		_length += length;
 
 		return true;
@@ -346,23 +421,37 @@ namespace ov
 		return Append(data.get());
 	}
 
+	bool Data::Prepend(const void *data, size_t length)
+	{
+		return Insert(data, 0, length);
+	}
+
 	bool Data::Erase(off_t offset, size_t length)
 	{
-		if (Detach() == false)
+		if ((offset < 0) || ((offset + length) > _length))
 		{
+			OV_ASSERT(false, "Invalid offset: %jd, length: %zu (current length: %zu)", offset, length, _length);
 			return false;
 		}
 
-		if ((offset < 0) || (offset + length >= _length))
+		if ((offset == 0) || ((offset + length) == _length))
 		{
-			OV_ASSERT(false, "Invalid offset: %jd, length: %zu (current length: %zu)", offset, length, _length);
+			// Erasing the front/back does not modify the bytes, so the storage can be shared
+			_offset += (offset == 0) ? length : 0;
+		}
+		else
+		{
+			if (Detach() == false)
+			{
+				return false;
+			}
+
+			auto position = _allocated_data->GetBytes() + _offset + offset;
+			::memmove(position, position + length, _length - offset - length);
 		}
 
-		_allocated_data->erase(_allocated_data->begin() + offset, _allocated_data->begin() + length);
 		_length -= length;
 
-		OV_ASSERT2(_length = _allocated_data->size());
-
 		return true;
 	}
 
@@ -11,11 +11,12 @@
 #include "./string.h"
 #include "./assert.h"
 #include "./memory_utilities.h"
-#include "./data.h"
+#include "./data_buffer.h"
 
 #include <memory>
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
 
 namespace ov
 {
@@ -28,7 +29,8 @@ namespace ov
 		/// Constructs a instance with the capacity (preallocated)
 		///
 		/// @param capacity
-		explicit Data(size_t capacity);
+		/// @param headroom bytes reserved before the data, so the headers can be prepended without moving the data (such as RTP/SRTP/OVT)
+		explicit Data(size_t capacity, size_t headroom = 0);
 
 		/// Constructs a instance from another data
 		///
@@ -41,6 +43,37 @@ namespace ov
 		/// If reference_only is false, it will not be affected if the data changes because it allocates a new memory and copies it there.
 		Data(const void *data, size_t length, bool reference_only = false);
 
+		/// Constructs a instance that references the memory kept alive by the owner (without copying)
+		///
+		/// @param data data to reference
+		/// @param length length of data
+		/// @param owner an object that owns the memory (such as a mapping of a file), it is released with the last reference
+		///
+		/// @remarks
+		/// The memory must not be changed while it is referenced. If the data is modified, it is copied first (like the copy-on-write).
+		Data(const void *data, size_t length, const std::shared_ptr<const void> &owner);
+
+		/// Constructs a instance that references the mapping of a file (without copying)
+		///
+		/// @param data the mapping of the file to reference
+		/// @param length length of data
+		/// @param owner an object that owns the mapping and keeps the file descriptor open
+		/// @param file_descriptor the file that has the same contents as data
+		/// @param file_offset the offset of data in the file
+		///
+		/// @remarks
+		/// The sockets can send the data from the file without copying it to the user space (such as sendfile())
+		Data(const void *data, size_t length, const std::shared_ptr<const void> &owner, int file_descriptor, off_t file_offset);
+
+		/// Constructs a instance that uses the storage as is (without copying)
+		///
+		/// @param storage the storage to use (such as a buffer from ov::BufferPool)
+		/// @param length length of the data in the storage (must be less than or equal to storage->GetCapacity())
+		///
+		/// @remarks
+		/// The storage is managed by copy-on-write method like Clone()/Subdata().
+		Data(DataBufferPtr storage, size_t length);
+
 		// Copy constructor
 		Data(const Data &data);
 
@@ -57,7 +90,12 @@ namespace ov
 		/// @return read-only pointer
 		inline const void *GetData() const
 		{
-			return (_reference_data != nullptr) ? _reference_data : _allocated_data->data() + _offset;
+			if (_reference_data != nullptr)
+			{
+				return static_cast<const uint8_t *>(_reference_data) + _offset;
+			}
+
+			return (_allocated_data != nullptr) ? (_allocated_data->GetBytes() + _offset) : nullptr;
 		}
 
 		template<typename T>
@@ -84,6 +122,20 @@ namespace ov
 			return data[index];
 		}
 
+		/// Get the file that has the same contents as this data
+		///
+		/// @return the file descriptor, or -1 if the data is not backed by a file (or it is modified)
+		inline int GetFileDescriptor() const
+		{
+			return (_reference_data != nullptr) ? _file_descriptor : -1;
+		}
+
+		/// Get the offset of this data in the file
+		inline off_t GetFileOffset() const
+		{
+			return _file_offset + _offset;
+		}
+
 		/// Get the writable pointer
 		///
 		/// @return writable pointer
@@ -91,7 +143,7 @@ namespace ov
 		{
 			if(Detach())
 			{
-				return _allocated_data->data() + _offset;
+				return _allocated_data->GetBytes() + _offset;
 			}
 
 			return nullptr;
@@ -114,15 +166,34 @@ namespace ov
 		// For debugging
 		inline size_t GetAllocatedDataSize() const
 		{
-			return (_allocated_data != nullptr) ? _allocated_data->size() : 0ULL;
+			return (_allocated_data != nullptr) ? _allocated_data->GetCapacity() : 0ULL;
 		}
 
+		/// Changes the length of the data. The bytes after the current length are filled with 0.
 		inline bool SetLength(size_t length)
+		{
+			auto old_length = _length;
+
+			if (SetLengthUninitialized(length) == false)
+			{
+				return false;
+			}
+
+			if (length > old_length)
+			{
+				::memset(_allocated_data->GetBytes() + _offset + old_length, 0, length - old_length);
+			}
+
+			return true;
+		}
+
+		/// Changes the length of the data without initializing the bytes after the current length
+		/// (for the buffers that are overwritten right after, such as the buffer of recv())
+		inline bool SetLengthUninitialized(size_t length)
 		{
 			// Detach() will called in Reserve()
 			if(Reserve(length))
 			{
-				_allocated_data->resize(length);
 				_length = length;
 				return true;
 			}
@@ -145,7 +216,13 @@ namespace ov
 		/// @return 할당되어 있는 메모리 크기
 		inline size_t GetCapacity() const noexcept
 		{
-			return (_allocated_data != nullptr) ? _allocated_data->capacity() : 0;
+			return (_allocated_data != nullptr) ? (_allocated_data->GetCapacity() - _offset) : 0;
+		}
+
+		/// The bytes before the data that can be used by Prepend() without moving the data
+		inline size_t GetHeadroom() const noexcept
+		{
+			return HasOwnStorage() ? _offset : 0;
 		}
 
 		/// 버퍼에 있는 데이터 모두 삭제
@@ -164,6 +241,9 @@ namespace ov
 		bool Append(const std::shared_ptr<Data> &data);
 		bool Append(const std::shared_ptr<const Data> &data);
 
+		/// Inserts the data at the beginning. Uses the headroom if there is enough, so the data is not moved.
+		bool Prepend(const void *data, size_t length);
+
 		bool Erase(off_t offset, size_t length);
 
 		/// this 데이터의 일부 영역만 참조하는 Data instance 생성
@@ -206,24 +286,36 @@ namespace ov
 	protected:
 		std::shared_ptr<const Data> SubdataInternal(off_t offset, size_t length) const;
 
+		/// Whether the storage can be modified without copying (not referenced, and not shared with the others)
+		bool HasOwnStorage() const;
+
 		/// Called to separate from the origin data
 		///
 		/// @return true on success, false on failure
 		bool Detach();
 
-		const void *_reference_data = nullptr;
+		/// Copies the data to a new storage (the data that is referenced or shared is detached)
+		///
+		/// @param headroom bytes reserved before the data in the new storage
+		/// @param capacity capacity of the new storage after the headroom (must be greater than or equal to GetLength())
+		///
+		/// @return true on success, false on failure
+		bool Reallocate(size_t headroom, size_t capacity);
 
-		// Allocated data. If this data is subdata, _current_data and _data can be different.
-		std::shared_ptr<std::vector<uint8_t>> _allocated_data = nullptr;
-		// Offset from _allocated_data
+		const void *_reference_data = nullptr;
+		// Keeps _reference_data alive (nullptr if the lifetime of _reference_data is managed by the caller)
+		std::shared_ptr<const void> _reference_owner = nullptr;
+		// The file that _reference_data is mapped from (-1 if there is no file), kept open by _reference_owner
+		int _file_descriptor = -1;
+		// Offset of _reference_data in the file
+		off_t _file_offset = 0;
+
+		// Allocated data. It is shared by the subdata/clones until one of them is modified (copy-on-write).
+		DataBufferPtr _allocated_data = nullptr;
+		// Offset from _allocated_data (the headroom if this data is not a subdata)
 		off_t _offset = 0;
 
-		// Length of data
-		// _length =
-		// if(_allocated_data != nullptr)
-		//     _allocated_data->size() - _offset
-		// else
-		//     <length of _reference_data>
+		// Length of data (the bytes of _allocated_data after <_offset + _length> are not initialized)
 		size_t _length = 0;
 	};
 
@@ -0,0 +1,126 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "data_buffer.h"
+
+#include <sys/mman.h>
+
+#include <new>
+
+#include "./platform.h"
+
+// The size of the transparent huge page of x86-64/ARM64
+#define DATA_BUFFER_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+namespace ov
+{
+	static_assert((sizeof(DataBuffer) % alignof(std::max_align_t)) == 0, "The bytes after the header must be aligned");
+
+	static std::atomic<bool> _is_huge_pages_enabled{false};
+
+	void DataBuffer::SetHugePagesEnabled(bool enabled)
+	{
+		_is_huge_pages_enabled = enabled;
+	}
+
+	DataBuffer *DataBuffer::Allocate(size_t capacity)
+	{
+		auto size = sizeof(DataBuffer) + capacity;
+
+		if ((capacity >= DATA_BUFFER_HUGE_PAGE_SIZE) && _is_huge_pages_enabled.load(std::memory_order_relaxed))
+		{
+			// Rounded up to the huge pages, so the last page is not shared with the other allocations
+			size = ((size + DATA_BUFFER_HUGE_PAGE_SIZE - 1) / DATA_BUFFER_HUGE_PAGE_SIZE) * DATA_BUFFER_HUGE_PAGE_SIZE;
+
+			auto memory = ::operator new(size, std::align_val_t(DATA_BUFFER_HUGE_PAGE_SIZE));
+
+#if IS_LINUX
+			// It is only an advice, the small pages are used if the kernel doesn't have the huge pages
+			::madvise(memory, size, MADV_HUGEPAGE);
+#endif
+
+			auto buffer = new (memory) DataBuffer(capacity, true);
+			buffer->Account();
+
+			return buffer;
+		}
+
+		// Throws std::bad_alloc like std::vector
+		auto memory = ::operator new(size);
+
+		auto buffer = new (memory) DataBuffer(capacity, false);
+		buffer->Account();
+
+		return buffer;
+	}
+
+	void DataBuffer::Free(DataBuffer *buffer)
+	{
+		buffer->Unaccount();
+
+		bool is_huge_page_aligned = buffer->_is_huge_page_aligned;
+
+		buffer->~DataBuffer();
+
+		if (is_huge_page_aligned)
+		{
+			::operator delete(buffer, std::align_val_t(DATA_BUFFER_HUGE_PAGE_SIZE));
+			return;
+		}
+
+		::operator delete(buffer);
+	}
+
+	void DataBuffer::Release() noexcept
+	{
+		if (_ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		if (_recycler != nullptr)
+		{
+			// Keep the recycler alive until Recycle() returns
+			auto recycler = std::move(_recycler);
+			_recycler = nullptr;
+
+			Unaccount();
+			recycler->Recycle(this);
+			return;
+		}
+
+		Free(this);
+	}
+
+	void DataBuffer::Account() noexcept
+	{
+		if (MemoryAccounting::IsEnabled() == false)
+		{
+			return;
+		}
+
+		_memory_category = MemoryAccounting::GetCurrentCategory();
+		_memory_account = MemoryAccounting::GetCurrentAccount();
+		_is_accounted = true;
+
+		MemoryAccounting::OnAllocated(_memory_category, _memory_account, _capacity);
+	}
+
+	void DataBuffer::Unaccount() noexcept
+	{
+		if (_is_accounted == false)
+		{
+			return;
+		}
+
+		MemoryAccounting::OnFreed(_memory_category, _memory_account, _capacity);
+
+		_is_accounted = false;
+		_memory_account = nullptr;
+	}
+}  // namespace ov
@@ -0,0 +1,197 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "./memory_accounting.h"
+
+namespace ov
+{
+	class DataBuffer;
+
+	// Takes the buffers back when their last reference is released (such as ov::DataPool, ov::BufferPool)
+	class DataBufferRecycler
+	{
+	public:
+		virtual ~DataBufferRecycler() = default;
+
+		// The buffer must be kept in a free list, or freed by DataBuffer::Free()
+		virtual void Recycle(DataBuffer *buffer) = 0;
+	};
+
+	// The storage of ov::Data
+	//
+	// - The header and the bytes are allocated at once (std::shared_ptr<std::vector<uint8_t>> needs 3 allocations)
+	// - The bytes are not initialized (std::vector zero-fills them, even if they are overwritten by recv() right after)
+	// - The reference count is intrusive, so DataBufferPtr is as small as a raw pointer
+	class alignas(16) DataBuffer
+	{
+	public:
+		// The reference count of the new buffer is 0 (DataBufferPtr takes the first reference)
+		static DataBuffer *Allocate(size_t capacity);
+		static void Free(DataBuffer *buffer);
+
+		// The buffers of DATA_BUFFER_HUGE_PAGE_SIZE or larger are aligned to the huge pages, and the kernel is advised to back them with
+		// the transparent huge pages (<Performance><NUMA><HugePages>), so the frames don't need many TLB entries
+		static void SetHugePagesEnabled(bool enabled);
+
+		inline uint8_t *GetBytes() noexcept
+		{
+			return reinterpret_cast<uint8_t *>(this + 1);
+		}
+
+		inline const uint8_t *GetBytes() const noexcept
+		{
+			return reinterpret_cast<const uint8_t *>(this + 1);
+		}
+
+		inline size_t GetCapacity() const noexcept
+		{
+			return _capacity;
+		}
+
+		// The recycler is called instead of Free() when the last reference is released.
+		// It is cleared before Recycle() is called, so the buffers in the free list do not keep the recycler alive.
+		void SetRecycler(const std::shared_ptr<DataBufferRecycler> &recycler)
+		{
+			_recycler = recycler;
+		}
+
+		inline void AddRef() noexcept
+		{
+			_ref_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Release() noexcept;
+
+		// Tags the buffer with the MemoryScope of the current thread (See ov::MemoryAccounting)
+		// It is called by Allocate(), and by the pools when a buffer is taken from the free list
+		void Account() noexcept;
+		// The buffers in the free lists of the pools are not counted
+		void Unaccount() noexcept;
+
+		// Whether another DataBufferPtr refers this buffer (the bytes must be copied before they are modified)
+		inline bool IsShared() const noexcept
+		{
+			return _ref_count.load(std::memory_order_acquire) > 1;
+		}
+
+	protected:
+		DataBuffer(size_t capacity, bool is_huge_page_aligned)
+			: _capacity(capacity),
+			  _is_huge_page_aligned(is_huge_page_aligned)
+		{
+		}
+
+		std::atomic<uint32_t> _ref_count{0};
+		// The tag of Account() (they fit in the padding, so the header is not enlarged)
+		bool _is_accounted = false;
+		MemoryCategory _memory_category = MemoryCategory::Unknown;
+		const size_t _capacity;
+		// Allocated with the alignment of the huge page (it must be freed with the same alignment)
+		const bool _is_huge_page_aligned;
+		MemoryAccount *_memory_account = nullptr;
+		std::shared_ptr<DataBufferRecycler> _recycler;
+	};
+
+	// A reference of DataBuffer (like std::shared_ptr<DataBuffer>)
+	class DataBufferPtr
+	{
+	public:
+		DataBufferPtr() = default;
+
+		DataBufferPtr(std::nullptr_t)
+		{
+		}
+
+		explicit DataBufferPtr(DataBuffer *buffer)
+			: _buffer(buffer)
+		{
+			if (_buffer != nullptr)
+			{
+				_buffer->AddRef();
+			}
+		}
+
+		DataBufferPtr(const DataBufferPtr &other)
+			: DataBufferPtr(other._buffer)
+		{
+		}
+
+		DataBufferPtr(DataBufferPtr &&other) noexcept
+			: _buffer(other._buffer)
+		{
+			other._buffer = nullptr;
+		}
+
+		~DataBufferPtr()
+		{
+			Reset();
+		}
+
+		DataBufferPtr &operator=(const DataBufferPtr &other)
+		{
+			DataBufferPtr(other).Swap(*this);
+			return *this;
+		}
+
+		DataBufferPtr &operator=(DataBufferPtr &&other) noexcept
+		{
+			DataBufferPtr(std::move(other)).Swap(*this);
+			return *this;
+		}
+
+		DataBufferPtr &operator=(std::nullptr_t)
+		{
+			Reset();
+			return *this;
+		}
+
+		void Reset()
+		{
+			if (_buffer != nullptr)
+			{
+				_buffer->Release();
+				_buffer = nullptr;
+			}
+		}
+
+		void Swap(DataBufferPtr &other) noexcept
+		{
+			std::swap(_buffer, other._buffer);
+		}
+
+		inline DataBuffer *Get() const noexcept
+		{
+			return _buffer;
+		}
+
+		inline DataBuffer *operator->() const noexcept
+		{
+			return _buffer;
+		}
+
+		inline bool operator==(std::nullptr_t) const noexcept
+		{
+			return _buffer == nullptr;
+		}
+
+		inline bool operator!=(std::nullptr_t) const noexcept
+		{
+			return _buffer != nullptr;
+		}
+
+	protected:
+		DataBuffer *_buffer = nullptr;
+	};
+}  // namespace ov
@@ -0,0 +1,101 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "data_chain.h"
+
+#include <algorithm>
+
+namespace ov
+{
+	DataChain::DataChain(std::initializer_list<std::shared_ptr<const Data>> slices)
+	{
+		_slices.reserve(slices.size());
+
+		for (const auto &slice : slices)
+		{
+			Append(slice);
+		}
+	}
+
+	DataChain::DataChain(std::vector<std::shared_ptr<const Data>> slices)
+		: _slices(std::move(slices))
+	{
+		_slices.erase(std::remove_if(_slices.begin(), _slices.end(), [](const std::shared_ptr<const Data> &slice) -> bool {
+						  return (slice == nullptr) || slice->IsEmpty();
+					  }),
+					  _slices.end());
+
+		for (const auto &slice : _slices)
+		{
+			_length += slice->GetLength();
+		}
+	}
+
+	void DataChain::Append(const std::shared_ptr<const Data> &slice)
+	{
+		if ((slice == nullptr) || slice->IsEmpty())
+		{
+			return;
+		}
+
+		_slices.push_back(slice);
+		_length += slice->GetLength();
+	}
+
+	void DataChain::Append(const DataChain &chain)
+	{
+		_slices.insert(_slices.end(), chain._slices.begin(), chain._slices.end());
+		_length += chain._length;
+	}
+
+	void DataChain::Append(const void *data, size_t length)
+	{
+		if ((data == nullptr) || (length == 0))
+		{
+			return;
+		}
+
+		Append(std::make_shared<const Data>(data, length));
+	}
+
+	void DataChain::Prepend(const std::shared_ptr<const Data> &slice)
+	{
+		if ((slice == nullptr) || slice->IsEmpty())
+		{
+			return;
+		}
+
+		_slices.insert(_slices.begin(), slice);
+		_length += slice->GetLength();
+	}
+
+	void DataChain::Clear()
+	{
+		_slices.clear();
+		_length = 0;
+	}
+
+	bool DataChain::HasFileSlice() const
+	{
+		return std::any_of(_slices.begin(), _slices.end(), [](const std::shared_ptr<const Data> &slice) -> bool {
+			return slice->GetFileDescriptor() >= 0;
+		});
+	}
+
+	std::shared_ptr<Data> DataChain::Flatten() const
+	{
+		auto data = std::make_shared<Data>(_length);
+
+		for (const auto &slice : _slices)
+		{
+			data->Append(slice);
+		}
+
+		return data;
+	}
+}  // namespace ov
@@ -0,0 +1,82 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "./data.h"
+
+namespace ov
+{
+	// A sequence of slices that is sent as one stream of bytes (scatter-gather)
+	//
+	// The slices are referenced, not copied, so a header can be sent in front of a payload that is shared by
+	// other packets/sessions without concatenating them (sockets send the slices with one sendmsg()).
+	// Only Flatten() copies the bytes, for the APIs that need a contiguous buffer.
+	class DataChain
+	{
+	public:
+		DataChain() = default;
+		DataChain(std::initializer_list<std::shared_ptr<const Data>> slices);
+		explicit DataChain(std::vector<std::shared_ptr<const Data>> slices);
+
+		// The empty slices (and nullptr) are ignored
+		void Append(const std::shared_ptr<const Data> &slice);
+		void Append(const DataChain &chain);
+		// Copies the bytes into a new slice (for the small headers made on the stack)
+		void Append(const void *data, size_t length);
+
+		void Prepend(const std::shared_ptr<const Data> &slice);
+
+		void Clear();
+
+		// The number of bytes of all slices
+		inline size_t GetLength() const noexcept
+		{
+			return _length;
+		}
+
+		inline bool IsEmpty() const noexcept
+		{
+			return _length == 0;
+		}
+
+		inline size_t GetSliceCount() const noexcept
+		{
+			return _slices.size();
+		}
+
+		inline const std::shared_ptr<const Data> *GetSlices() const noexcept
+		{
+			return _slices.data();
+		}
+
+		inline std::vector<std::shared_ptr<const Data>>::const_iterator begin() const noexcept
+		{
+			return _slices.begin();
+		}
+
+		inline std::vector<std::shared_ptr<const Data>>::const_iterator end() const noexcept
+		{
+			return _slices.end();
+		}
+
+		// Whether a slice is backed by a file (it can be sent using sendfile())
+		bool HasFileSlice() const;
+
+		// Copies the slices into a contiguous data
+		std::shared_ptr<Data> Flatten() const;
+
+	protected:
+		std::vector<std::shared_ptr<const Data>> _slices;
+		size_t _length = 0;
+	};
+}  // namespace ov
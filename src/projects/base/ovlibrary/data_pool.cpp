@@ -0,0 +1,370 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "data_pool.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "./log.h"
+
+#define OV_LOG_TAG "DataPool"
+
+#define DATA_POOL_DEFAULT_MAX_FREE_BYTES_PER_CLASS (4 * 1024 * 1024)
+
+namespace ov
+{
+	static constexpr size_t SizeClassCount = static_cast<size_t>(DataPool::SizeClass::Count);
+
+	static constexpr size_t ClassSizeList[SizeClassCount] = {
+		256,
+		1536,
+		16 * 1024,
+		256 * 1024,
+		4 * 1024 * 1024};
+
+	std::atomic<bool> DataPool::_enabled{false};
+
+	static std::atomic<size_t> _max_free_bytes_per_class{DATA_POOL_DEFAULT_MAX_FREE_BYTES_PER_CLASS};
+	static std::atomic<uint64_t> _oversize_count{0};
+
+	class DataPool::ThreadCache : public DataBufferRecycler, public std::enable_shared_from_this<ThreadCache>
+	{
+	public:
+		struct FreeList
+		{
+			// Accessed only by the owner thread
+			std::vector<DataBuffer *> local_list;
+
+			// Buffers returned by other threads
+			std::mutex remote_mutex;
+			std::vector<DataBuffer *> remote_list;
+			std::atomic<size_t> remote_count{0};
+
+			std::atomic<uint64_t> hit_count{0};
+			std::atomic<uint64_t> miss_count{0};
+			std::atomic<uint64_t> remote_return_count{0};
+			std::atomic<uint64_t> discard_count{0};
+			std::atomic<int64_t> in_use_count{0};
+			std::atomic<int64_t> free_count{0};
+		};
+
+		~ThreadCache()
+		{
+			Release();
+		}
+
+		DataBuffer *Allocate(size_t index)
+		{
+			auto &free_list = _free_lists[index];
+
+			if (free_list.local_list.empty() && (free_list.remote_count.load(std::memory_order_relaxed) > 0))
+			{
+				// Collect the buffers returned by other threads at once
+				std::lock_guard<std::mutex> lock(free_list.remote_mutex);
+
+				std::swap(free_list.local_list, free_list.remote_list);
+				free_list.remote_count.store(0, std::memory_order_relaxed);
+			}
+
+			DataBuffer *buffer = nullptr;
+
+			if (free_list.local_list.empty() == false)
+			{
+				buffer = free_list.local_list.back();
+				free_list.local_list.pop_back();
+				buffer->Account();
+
+				free_list.hit_count.fetch_add(1, std::memory_order_relaxed);
+				free_list.free_count.fetch_sub(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				buffer = DataBuffer::Allocate(ClassSizeList[index]);
+
+				free_list.miss_count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			free_list.in_use_count.fetch_add(1, std::memory_order_relaxed);
+
+			return buffer;
+		}
+
+		// Called when the last reference of a buffer allocated by this cache is released (by any thread)
+		void Recycle(DataBuffer *buffer) override;
+
+		void Return(size_t index, DataBuffer *buffer, bool is_owner_thread)
+		{
+			auto &free_list = _free_lists[index];
+			auto max_free_count = std::max<size_t>(_max_free_bytes_per_class.load(std::memory_order_relaxed) / ClassSizeList[index], 1);
+
+			free_list.in_use_count.fetch_sub(1, std::memory_order_relaxed);
+
+			if (is_owner_thread)
+			{
+				if (free_list.local_list.size() < max_free_count)
+				{
+					free_list.local_list.push_back(buffer);
+					free_list.free_count.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(free_list.remote_mutex);
+
+				// _is_alive must be checked while holding the lock to avoid racing with Release()
+				if (_is_alive && (free_list.remote_list.size() < max_free_count))
+				{
+					free_list.remote_list.push_back(buffer);
+					free_list.remote_count.store(free_list.remote_list.size(), std::memory_order_relaxed);
+					free_list.remote_return_count.fetch_add(1, std::memory_order_relaxed);
+					free_list.free_count.fetch_add(1, std::memory_order_relaxed);
+					return;
+				}
+			}
+
+			// The free list is full
+			free_list.discard_count.fetch_add(1, std::memory_order_relaxed);
+			DataBuffer::Free(buffer);
+		}
+
+		// Called when the owner thread exits
+		void Release()
+		{
+			for (auto &free_list : _free_lists)
+			{
+				std::vector<DataBuffer *> remote_list;
+
+				{
+					std::lock_guard<std::mutex> lock(free_list.remote_mutex);
+
+					_is_alive = false;
+					std::swap(remote_list, free_list.remote_list);
+					free_list.remote_count.store(0, std::memory_order_relaxed);
+				}
+
+				for (auto buffer : free_list.local_list)
+				{
+					DataBuffer::Free(buffer);
+				}
+
+				for (auto buffer : remote_list)
+				{
+					DataBuffer::Free(buffer);
+				}
+
+				free_list.free_count.fetch_sub(free_list.local_list.size() + remote_list.size(), std::memory_order_relaxed);
+				free_list.local_list.clear();
+			}
+		}
+
+		void CollectStatistics(std::vector<Statistics> *statistics_list) const
+		{
+			for (size_t index = 0; index < SizeClassCount; index++)
+			{
+				auto &free_list = _free_lists[index];
+				auto &statistics = statistics_list->at(index);
+
+				statistics.hit_count += free_list.hit_count.load(std::memory_order_relaxed);
+				statistics.miss_count += free_list.miss_count.load(std::memory_order_relaxed);
+				statistics.remote_return_count += free_list.remote_return_count.load(std::memory_order_relaxed);
+				statistics.discard_count += free_list.discard_count.load(std::memory_order_relaxed);
+				statistics.in_use_count += free_list.in_use_count.load(std::memory_order_relaxed);
+				statistics.free_count += free_list.free_count.load(std::memory_order_relaxed);
+			}
+		}
+
+	protected:
+		FreeList _free_lists[SizeClassCount];
+
+		// Protected by remote_mutex of each free list
+		bool _is_alive = true;
+	};
+
+	// All thread caches (including the caches of the exited threads that still have buffers in use)
+	static std::mutex _cache_list_mutex;
+	static std::vector<std::shared_ptr<DataPool::ThreadCache>> _cache_list;
+	// Statistics of the caches removed from _cache_list
+	static std::vector<DataPool::Statistics> _retired_statistics_list(SizeClassCount);
+
+	static thread_local DataPool::ThreadCache *_current_cache = nullptr;
+	static thread_local bool _is_thread_exiting = false;
+
+	void DataPool::ThreadCache::Recycle(DataBuffer *buffer)
+	{
+		// The capacity of the buffer is the size of its class
+		auto class_size = std::lower_bound(std::begin(ClassSizeList), std::end(ClassSizeList), buffer->GetCapacity());
+
+		Return(std::distance(std::begin(ClassSizeList), class_size), buffer, this == _current_cache);
+	}
+
+	// Must be called while holding _cache_list_mutex
+	static void RemoveRetiredCaches()
+	{
+		auto item = _cache_list.begin();
+
+		while (item != _cache_list.end())
+		{
+			// If only _cache_list refers the cache, the owner thread was exited and no buffer is in use
+			if (item->use_count() == 1)
+			{
+				(*item)->CollectStatistics(&_retired_statistics_list);
+				item = _cache_list.erase(item);
+			}
+			else
+			{
+				++item;
+			}
+		}
+	}
+
+	struct ThreadCacheHolder
+	{
+		~ThreadCacheHolder()
+		{
+			_is_thread_exiting = true;
+			_current_cache = nullptr;
+
+			if (cache != nullptr)
+			{
+				cache->Release();
+			}
+		}
+
+		std::shared_ptr<DataPool::ThreadCache> cache;
+	};
+
+	static DataPool::ThreadCache *GetThreadCache()
+	{
+		if ((_current_cache != nullptr) || _is_thread_exiting)
+		{
+			return _current_cache;
+		}
+
+		static thread_local ThreadCacheHolder holder;
+
+		holder.cache = std::make_shared<DataPool::ThreadCache>();
+
+		{
+			std::lock_guard<std::mutex> lock(_cache_list_mutex);
+
+			RemoveRetiredCaches();
+			_cache_list.push_back(holder.cache);
+		}
+
+		_current_cache = holder.cache.get();
+
+		return _current_cache;
+	}
+
+	void DataPool::SetEnabled(bool enabled)
+	{
+		_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void DataPool::SetMaxFreeBytesPerClass(size_t max_free_bytes)
+	{
+		_max_free_bytes_per_class.store(max_free_bytes, std::memory_order_relaxed);
+	}
+
+	size_t DataPool::GetMaxFreeBytesPerClass()
+	{
+		return _max_free_bytes_per_class.load(std::memory_order_relaxed);
+	}
+
+	DataBufferPtr DataPool::Allocate(size_t capacity)
+	{
+		auto class_size = std::lower_bound(std::begin(ClassSizeList), std::end(ClassSizeList), capacity);
+		auto cache = (class_size != std::end(ClassSizeList)) ? GetThreadCache() : nullptr;
+
+		if (cache == nullptr)
+		{
+			if (class_size == std::end(ClassSizeList))
+			{
+				_oversize_count.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			return DataBufferPtr(DataBuffer::Allocate(capacity));
+		}
+
+		auto buffer = cache->Allocate(std::distance(std::begin(ClassSizeList), class_size));
+
+		// The buffer keeps the cache alive until it is returned
+		buffer->SetRecycler(cache->shared_from_this());
+
+		return DataBufferPtr(buffer);
+	}
+
+	size_t DataPool::GetClassSize(SizeClass size_class)
+	{
+		auto index = static_cast<size_t>(size_class);
+
+		return (index < SizeClassCount) ? ClassSizeList[index] : 0;
+	}
+
+	uint64_t DataPool::GetOversizeCount()
+	{
+		return _oversize_count.load(std::memory_order_relaxed);
+	}
+
+	std::vector<DataPool::Statistics> DataPool::GetStatistics()
+	{
+		std::lock_guard<std::mutex> lock(_cache_list_mutex);
+
+		RemoveRetiredCaches();
+
+		auto statistics_list = _retired_statistics_list;
+
+		for (size_t index = 0; index < SizeClassCount; index++)
+		{
+			statistics_list[index].buffer_size = ClassSizeList[index];
+		}
+
+		for (auto &cache : _cache_list)
+		{
+			cache->CollectStatistics(&statistics_list);
+		}
+
+		return statistics_list;
+	}
+
+	String DataPool::ToString()
+	{
+		String description;
+		int64_t total_footprint = 0;
+
+		description.Format("DataPool (%s, max free bytes per class: %zu, oversize: %llu)",
+						   IsEnabled() ? "enabled" : "disabled",
+						   GetMaxFreeBytesPerClass(),
+						   static_cast<unsigned long long>(GetOversizeCount()));
+
+		for (auto &statistics : GetStatistics())
+		{
+			auto total_count = statistics.hit_count + statistics.miss_count;
+
+			description.AppendFormat(
+				"\n  - %8zu bytes: hit: %llu, miss: %llu (%.2f%% hit), remote return: %llu, discard: %llu, in use: %lld, free: %lld, footprint: %lld bytes",
+				statistics.buffer_size,
+				static_cast<unsigned long long>(statistics.hit_count),
+				static_cast<unsigned long long>(statistics.miss_count),
+				(total_count > 0) ? (statistics.hit_count * 100.0 / total_count) : 0.0,
+				static_cast<unsigned long long>(statistics.remote_return_count),
+				static_cast<unsigned long long>(statistics.discard_count),
+				static_cast<long long>(statistics.in_use_count),
+				static_cast<long long>(statistics.free_count),
+				static_cast<long long>(statistics.GetFootprint()));
+
+			total_footprint += statistics.GetFootprint();
+		}
+
+		description.AppendFormat("\n  Total footprint: %lld bytes", static_cast<long long>(total_footprint));
+
+		return description;
+	}
+}  // namespace ov
@@ -0,0 +1,96 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "./data_buffer.h"
+#include "./string.h"
+
+namespace ov
+{
+	// Size-class pooled allocator for the storage of ov::Data
+	//
+	// - Each thread has its own free lists, so the allocation doesn't take any lock in most cases
+	// - A buffer released by another thread is returned to the free list of the thread that allocated it
+	//   (the owner collects them when its own free list is empty)
+	// - The storage larger than the largest class is allocated from the heap as before
+	class DataPool
+	{
+	public:
+		enum class SizeClass : int
+		{
+			Tiny,	 // 256 B
+			Mtu,	 // 1.5 KB
+			Small,	 // 16 KB
+			Medium,	 // 256 KB
+			Large,	 // 4 MB
+
+			Count
+		};
+
+		struct Statistics
+		{
+			// The capacity of the buffers in this class
+			size_t buffer_size = 0;
+
+			// Allocations served from the free lists
+			uint64_t hit_count = 0;
+			// Allocations that needed malloc()
+			uint64_t miss_count = 0;
+			// Buffers returned by another thread
+			uint64_t remote_return_count = 0;
+			// Buffers freed because the free list was full
+			uint64_t discard_count = 0;
+
+			// The number of buffers in use
+			int64_t in_use_count = 0;
+			// The number of buffers in the free lists
+			int64_t free_count = 0;
+
+			// Bytes held by the pool (in use + free)
+			int64_t GetFootprint() const
+			{
+				return (in_use_count + free_count) * static_cast<int64_t>(buffer_size);
+			}
+		};
+
+		// The pool is disabled by default (ov::Data allocates the storage from the heap)
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled()
+		{
+			return _enabled.load(std::memory_order_relaxed);
+		}
+
+		// The maximum bytes of free buffers kept per size class per thread
+		static void SetMaxFreeBytesPerClass(size_t max_free_bytes);
+		static size_t GetMaxFreeBytesPerClass();
+
+		// Returns a buffer whose capacity is at least capacity (the bytes are not initialized)
+		static DataBufferPtr Allocate(size_t capacity);
+
+		static size_t GetClassSize(SizeClass size_class);
+
+		// Allocations larger than the largest class
+		static uint64_t GetOversizeCount();
+
+		// Statistics of each size class (aggregated over all threads)
+		static std::vector<Statistics> GetStatistics();
+		static String ToString();
+
+		// Per-thread free lists (defined in data_pool.cpp)
+		class ThreadCache;
+
+	protected:
+		static std::atomic<bool> _enabled;
+	};
+}  // namespace ov
@@ -9,6 +9,7 @@
 #include "./delay_queue.h"
 #include "./log.h"
 #include "./ovlibrary_private.h"
+#include "./thread_registry.h"
 
 #include <unistd.h>
 #include <thread>
@@ -89,14 +90,20 @@ namespace ov
 
 	void DelayQueue::DispatchThreadProc()
 	{
+		ThreadMetrics thread_metrics("DelayQueue", ThreadClass::Background);
+
 		while (_stop == false)
 		{
+			thread_metrics.CountLoop();
+
 			if (_queue.empty())
 			{
 				// queue에 아무 것도 없음. 새로운 항목이 Push될 때까지 대기
 				logtd("Queue is empty. Waiting for new item...");
 
+				thread_metrics.BeginIdle();
 				_event.Wait();
+				thread_metrics.EndIdle();
 
 				logtd("An item is pushed. Processing...");
 			}
@@ -105,7 +112,11 @@ namespace ov
 				// queue에 들어 있는 첫 번째 항목 처리
 				auto first_item = _queue.top();
 
-				if (_event.Wait(first_item.time_point) == false)
+				thread_metrics.BeginIdle();
+				bool is_pushed = _event.Wait(first_item.time_point);
+				thread_metrics.EndIdle();
+
+				if (is_pushed == false)
 				{
 					// first_item.time_point 만큼 대기 할 때까지, 다른 항목이 Push() 되지 않았음
 					DelayQueueAction action = first_item.function(first_item.parameter);
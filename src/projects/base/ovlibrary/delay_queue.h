@@ -56,7 +56,8 @@ namespace ov
 
 			int after;
 
-			std::chrono::time_point<std::chrono::system_clock> time_point;
+			// Monotonic, so the items are not delayed/hurried when the wall clock is changed
+			std::chrono::time_point<std::chrono::steady_clock> time_point;
 
 			// after의 단위는 ms
 			DelayQueueItem(int64_t index, DelayQueueFunction function, void *parameter, int after)
@@ -72,7 +73,7 @@ namespace ov
 
 			void RecalculateTimePoint()
 			{
-				time_point = std::chrono::system_clock::now() + std::chrono::milliseconds(after);
+				time_point = std::chrono::steady_clock::now() + std::chrono::milliseconds(after);
 			}
 
 			bool operator <(const DelayQueueItem &item) const
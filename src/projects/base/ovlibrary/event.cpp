@@ -8,61 +8,141 @@
 //==============================================================================
 #include "event.h"
 
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "./assert.h"
+#include "./memory_utilities.h"
+
 namespace ov
 {
 	Event::Event(bool manual_reset)
-		: _manual_reset(manual_reset),
+		: _manual_reset(manual_reset)
+	{
+		_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
-		  _event(false)
+		OV_ASSERT(_fd >= 0, "Could not create an eventfd: %d", errno);
+	}
+
+	Event::~Event()
 	{
+		if (_fd >= 0)
+		{
+			::close(_fd);
+		}
 	}
 
 	bool Event::SetEvent()
 	{
-		std::lock_guard<std::mutex> lock(_mutex);
+		uint64_t value = 1;
 
-		_event = true;
-		_condition.notify_all();
+		// The counter is only tested for non-zero, so setting the event several times is the same as once
+		while (::write(_fd, &value, sizeof(value)) < 0)
+		{
+			if (errno != EINTR)
+			{
+				return false;
+			}
+		}
 
 		return true;
 	}
 
 	bool Event::Reset()
 	{
-		std::lock_guard<std::mutex> lock(_mutex);
-
-		_event = false;
+		Consume();
 
 		return true;
 	}
 
+	bool Event::Consume()
+	{
+		uint64_t value;
+
+		while (true)
+		{
+			if (::read(_fd, &value, sizeof(value)) == sizeof(value))
+			{
+				return true;
+			}
+
+			if (errno != EINTR)
+			{
+				// EAGAIN: the event is not set
+				return false;
+			}
+		}
+	}
+
 	bool Event::Wait(int timeout)
 	{
 		if(timeout != Infinite)
 		{
-			return Wait(std::chrono::system_clock::now() + std::chrono::milliseconds(timeout));
+			return Wait(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout));
 		}
 
-		return Wait(std::chrono::time_point<std::chrono::system_clock>::max());
+		return Wait(std::chrono::time_point<std::chrono::steady_clock>::max());
 	}
 
-	bool Event::Wait(std::chrono::time_point<std::chrono::system_clock> time_point)
+	bool Event::Wait(std::chrono::time_point<std::chrono::steady_clock> time_point)
 	{
-		std::unique_lock<std::mutex> lock(_mutex);
+		const bool is_infinite = (time_point == std::chrono::time_point<std::chrono::steady_clock>::max());
 
 		// event가 활성화 될 때까지 대기
-		_condition.wait_until(lock, time_point, [&]
+		while (true)
 		{
-			return _event;
-		});
+			int timeout_ms = -1;
 
-		bool result = _event;
+			if (is_infinite == false)
+			{
+				auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(time_point - std::chrono::steady_clock::now()).count();
+				// Rounds up, so it does not return before the deadline
+				timeout_ms = static_cast<int>(std::clamp<int64_t>(remaining + 1, 0, INT32_MAX));
+			}
 
-		if(_manual_reset == false)
-		{
-			_event = false;
-		}
+			pollfd poll_fd{_fd, POLLIN, 0};
+			int result = ::poll(&poll_fd, 1, timeout_ms);
+
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
 
-		return result;
+				return false;
+			}
+
+			if (result == 0)
+			{
+				// timed out
+				return false;
+			}
+
+			if (OV_CHECK_FLAG(poll_fd.revents, POLLNVAL))
+			{
+				return false;
+			}
+
+			if (_manual_reset)
+			{
+				return true;
+			}
+
+			// Another waiter may take the event first (auto reset), then waits again until the deadline
+			if (Consume())
+			{
+				return true;
+			}
+
+			if ((is_infinite == false) && (std::chrono::steady_clock::now() >= time_point))
+			{
+				return false;
+			}
+		}
 	}
 }
@@ -10,15 +10,22 @@
 
 #include "./ovdata_structure.h"
 
-#include <mutex>
-#include <condition_variable>
+#include <chrono>
 
 namespace ov
 {
+	// An event on an eventfd
+	//
+	// The fd is readable while the event is set, so it can be registered in an epoll set (EPOLLIN) with the sockets.
+	// A reactor thread calls Wait(0) when the fd is ready (it resets the event unless manual_reset).
 	class Event
 	{
 	public:
 		explicit Event(bool manual_reset = false);
+		~Event();
+
+		Event(const Event &) = delete;
+		Event &operator=(const Event &) = delete;
 
 		// 이벤트 설정
 		bool SetEvent();
@@ -27,14 +34,21 @@ namespace ov
 
 		// timeout in milliseconds
 		bool Wait(int timeout = Infinite);
-		bool Wait(std::chrono::time_point<std::chrono::system_clock> time_point);
+		// The deadline is monotonic (not affected by the changes of the wall clock)
+		bool Wait(std::chrono::time_point<std::chrono::steady_clock> time_point);
+
+		// For epoll (EPOLLIN, level-triggered). Do not read the fd directly, use Wait(0) instead.
+		int GetNativeHandle() const
+		{
+			return _fd;
+		}
 
 	protected:
+		// Takes the event (the counter of the eventfd is reset to 0)
+		bool Consume();
+
 		bool _manual_reset;
 
-		std::mutex _mutex;
-		std::condition_variable _condition;
-		bool _event;
+		int _fd = -1;
 	};
 }
-
@@ -0,0 +1,421 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "./executor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#include "./assert.h"
+#include "./log.h"
+#include "./platform.h"
+#include "./thread_registry.h"
+
+#define OV_LOG_TAG "Executor"
+
+// The number of tasks that a strand runs at once before yielding the thread to the other strands
+#define STRAND_MAX_TASKS_PER_RUN 64
+
+namespace ov
+{
+	// The strand whose task is running on this thread
+	static thread_local const Strand *_current_strand = nullptr;
+
+	Executor::Group::Group(const char *name, int weight, int max_threads)
+		: _name(name),
+		  _weight(std::max(weight, 1)),
+		  _max_threads(std::max(max_threads, 0))
+	{
+	}
+
+	Executor::Executor()
+		: _default_group(std::make_shared<Group>("Default", 100, 0))
+	{
+	}
+
+	Executor::~Executor()
+	{
+		Stop();
+	}
+
+	bool Executor::Start(const char *name, int thread_count, ThreadClass thread_class)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		if (_is_running)
+		{
+			return false;
+		}
+
+		if (thread_count <= 0)
+		{
+			thread_count = std::max(Platform::GetProcessorCount(), 1);
+		}
+
+		_name = name;
+		_thread_class = thread_class;
+		_is_running = true;
+
+		try
+		{
+			for (int index = 0; index < thread_count; index++)
+			{
+				_threads.emplace_back(&Executor::WorkerThread, this);
+			}
+		}
+		catch (const std::system_error &e)
+		{
+			logte("Could not create the threads of %s (%d/%d are created)", _name.CStr(), static_cast<int>(_threads.size()), thread_count);
+
+			if (_threads.empty())
+			{
+				_is_running = false;
+				return false;
+			}
+		}
+
+		logti("%s is started with %zu threads", _name.CStr(), _threads.size());
+
+		return true;
+	}
+
+	void Executor::Stop()
+	{
+		std::vector<std::thread> threads;
+		std::deque<Task> tasks;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_is_running == false)
+			{
+				return;
+			}
+
+			_is_running = false;
+
+			threads.swap(_threads);
+
+			for (auto &group : _active_groups)
+			{
+				std::move(group->_tasks.begin(), group->_tasks.end(), std::back_inserter(tasks));
+				group->_tasks.clear();
+				group->_is_active = false;
+			}
+
+			_active_groups.clear();
+		}
+
+		_condition.notify_all();
+
+		for (auto &thread : threads)
+		{
+			if (thread.joinable())
+			{
+				thread.join();
+			}
+		}
+
+		// The tasks are destroyed outside the lock (they may hold the last reference of the strands)
+		tasks.clear();
+
+		logti("%s is stopped", _name.CStr());
+	}
+
+	bool Executor::IsRunning() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _is_running;
+	}
+
+	int Executor::GetThreadCount() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return static_cast<int>(_threads.size());
+	}
+
+	bool Executor::Post(Task task)
+	{
+		return Post(nullptr, std::move(task));
+	}
+
+	bool Executor::Post(const std::shared_ptr<Group> &group, Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_is_running == false)
+			{
+				return false;
+			}
+
+			auto &target_group = (group != nullptr) ? group : _default_group;
+
+			target_group->_tasks.push_back(std::move(task));
+
+			if (target_group->_is_active == false)
+			{
+				target_group->_is_active = true;
+				target_group->_virtual_time = std::max(target_group->_virtual_time, _virtual_time);
+
+				_active_groups.push_back(target_group);
+			}
+		}
+
+		_condition.notify_one();
+
+		return true;
+	}
+
+	std::shared_ptr<Executor::Group> Executor::GetGroup(const char *name, int weight, int max_threads)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto item = _groups.find(name);
+
+		if (item != _groups.end())
+		{
+			auto group = item->second.lock();
+
+			if (group != nullptr)
+			{
+				return group;
+			}
+		}
+
+		// Remove the groups that are gone
+		for (auto it = _groups.begin(); it != _groups.end();)
+		{
+			it = it->second.expired() ? _groups.erase(it) : std::next(it);
+		}
+
+		auto group = std::make_shared<Group>(name, weight, max_threads);
+		_groups[name] = group;
+
+		return group;
+	}
+
+	Executor *Executor::GetShared()
+	{
+		static Executor executor;
+
+		return &executor;
+	}
+
+	void Executor::WorkerThread()
+	{
+		ThreadMetrics thread_metrics(_name.CStr(), _thread_class);
+
+		while (true)
+		{
+			std::shared_ptr<Group> group;
+			Task task;
+
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+
+				thread_metrics.BeginIdle();
+				_condition.wait(lock, [this, &group]() -> bool {
+					if (_is_running == false)
+					{
+						return true;
+					}
+
+					group = GetNextGroup();
+					return (group != nullptr);
+				});
+				thread_metrics.EndIdle();
+
+				if (_is_running == false)
+				{
+					break;
+				}
+
+				task = std::move(group->_tasks.front());
+				group->_tasks.pop_front();
+				group->_running_count++;
+
+				_virtual_time = group->_virtual_time;
+
+				if (group->_tasks.empty())
+				{
+					group->_is_active = false;
+					_active_groups.erase(std::find(_active_groups.begin(), _active_groups.end(), group));
+				}
+			}
+
+			thread_metrics.CountLoop();
+
+			auto start_time = std::chrono::steady_clock::now();
+
+			task();
+			// The task is destroyed outside the lock (it may hold the last reference of a strand)
+			task = nullptr;
+
+			auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+			bool is_throttled = false;
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				group->_running_count--;
+				group->_virtual_time += static_cast<uint64_t>(std::max<int64_t>(elapsed_us, 1)) * 100 / group->_weight;
+
+				is_throttled = (group->_max_threads > 0) && (group->_tasks.empty() == false);
+			}
+
+			if (is_throttled)
+			{
+				// The pending tasks of the group can run now
+				_condition.notify_one();
+			}
+		}
+	}
+
+	std::shared_ptr<Executor::Group> Executor::GetNextGroup() const
+	{
+		std::shared_ptr<Group> next_group;
+
+		for (auto &group : _active_groups)
+		{
+			if ((group->_max_threads > 0) && (group->_running_count >= group->_max_threads))
+			{
+				continue;
+			}
+
+			if ((next_group == nullptr) || (group->_virtual_time < next_group->_virtual_time))
+			{
+				next_group = group;
+			}
+		}
+
+		return next_group;
+	}
+
+	Strand::Strand(Executor *executor, std::shared_ptr<Executor::Group> group)
+		: _executor(executor),
+		  _group(std::move(group))
+	{
+	}
+
+	bool Strand::Post(Executor::Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_is_stopped)
+			{
+				return false;
+			}
+
+			_tasks.push_back(std::move(task));
+
+			if (_is_scheduled)
+			{
+				// Run() will pick it up
+				return true;
+			}
+
+			_is_scheduled = true;
+		}
+
+		auto self = shared_from_this();
+
+		if (_executor->Post(_group, [self]() { self->Run(); }) == false)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_is_scheduled = false;
+			_tasks.clear();
+
+			return false;
+		}
+
+		return true;
+	}
+
+	void Strand::Stop()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+
+		OV_ASSERT2(IsCurrent() == false);
+
+		_is_stopped = true;
+		_tasks.clear();
+
+		_condition.wait(lock, [this]() -> bool {
+			return _is_running == false;
+		});
+	}
+
+	bool Strand::IsCurrent() const
+	{
+		return _current_strand == this;
+	}
+
+	void Strand::Run()
+	{
+		for (int count = 0; count < STRAND_MAX_TASKS_PER_RUN; count++)
+		{
+			Executor::Task task;
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				if (_is_stopped || _tasks.empty())
+				{
+					_is_scheduled = false;
+					return;
+				}
+
+				task = std::move(_tasks.front());
+				_tasks.pop_front();
+
+				_is_running = true;
+			}
+
+			auto previous_strand = _current_strand;
+			_current_strand = this;
+
+			task();
+
+			_current_strand = previous_strand;
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_is_running = false;
+			}
+
+			_condition.notify_all();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			if (_is_stopped || _tasks.empty())
+			{
+				_is_scheduled = false;
+				return;
+			}
+		}
+
+		// There are more tasks, continue after the tasks of the other strands
+		auto self = shared_from_this();
+
+		if (_executor->Post(_group, [self]() { self->Run(); }) == false)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_is_scheduled = false;
+			_tasks.clear();
+		}
+	}
+}  // namespace ov
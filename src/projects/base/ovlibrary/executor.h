@@ -0,0 +1,165 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "./string.h"
+#include "./thread_class.h"
+
+namespace ov
+{
+	// A fixed-size pool of threads that runs the posted tasks
+	//
+	// The modules that used to own a thread per application/stream (which mostly sleep) post their work here instead,
+	// so the number of threads follows the number of processors, not the number of applications x streams x publishers.
+	// The tasks that must not run concurrently are posted through an ov::Strand.
+	//
+	// The tasks can be posted to a Group (an application of a virtual host, for example), and the threads are shared by
+	// the groups in proportion to their weights (weighted fair queueing by the time that the tasks of a group run),
+	// so a busy group can't starve the others. The tasks without a group belong to a group of weight 100.
+	class Executor
+	{
+	public:
+		using Task = std::function<void()>;
+
+		class Group
+		{
+		public:
+			// weight: the share of the threads relative to the other groups (the default group is 100)
+			// max_threads: the number of threads that run the tasks of the group at once (0: unlimited)
+			Group(const char *name, int weight, int max_threads);
+
+			const String &GetName() const
+			{
+				return _name;
+			}
+
+			int GetWeight() const
+			{
+				return _weight;
+			}
+
+			int GetMaxThreads() const
+			{
+				return _max_threads;
+			}
+
+		protected:
+			friend class Executor;
+
+			String _name;
+			int _weight;
+			int _max_threads;
+
+			// The followings are guarded by the mutex of the executor
+			std::deque<Task> _tasks;
+			int _running_count = 0;
+			// The running time of the tasks (us) / weight, the group with the smallest one runs next
+			uint64_t _virtual_time = 0;
+			// Whether the group is in _active_groups
+			bool _is_active = false;
+		};
+
+		Executor();
+		~Executor();
+
+		Executor(const Executor &executor) = delete;
+		Executor &operator=(const Executor &executor) = delete;
+
+		// thread_count: 0 means the number of processors
+		bool Start(const char *name, int thread_count, ThreadClass thread_class);
+		// The tasks that are not started yet are discarded
+		void Stop();
+
+		bool IsRunning() const;
+		int GetThreadCount() const;
+
+		// Returns false if the executor is not running
+		bool Post(Task task);
+		// group: nullptr means the default group
+		bool Post(const std::shared_ptr<Group> &group, Task task);
+
+		// Returns the group of the name, it is created if there is no group of the name that is alive
+		// (The modules of an application share the group, so the weight is applied to the application, not to each module)
+		std::shared_ptr<Group> GetGroup(const char *name, int weight, int max_threads);
+
+		// The executor that is shared by the modules (See <Performance><WorkerPool> of Server.xml)
+		static Executor *GetShared();
+
+	protected:
+		void WorkerThread();
+
+		// Returns the group whose task runs next (Must be called while holding _mutex)
+		std::shared_ptr<Group> GetNextGroup() const;
+
+		String _name;
+		ThreadClass _thread_class = ThreadClass::Background;
+
+		mutable std::mutex _mutex;
+		std::condition_variable _condition;
+		std::shared_ptr<Group> _default_group;
+		std::map<String, std::weak_ptr<Group>> _groups;
+		// The groups that have pending tasks
+		std::vector<std::shared_ptr<Group>> _active_groups;
+		// The virtual time of the last group that was run, a group that becomes active starts from here
+		// (A group that was idle does not get the time it did not use)
+		uint64_t _virtual_time = 0;
+		bool _is_running = false;
+
+		std::vector<std::thread> _threads;
+	};
+
+	// Runs the tasks posted to it one by one in order on an ov::Executor (a serial queue on top of the pool)
+	//
+	// A strand holds no thread, so an idle strand costs only its memory.
+	// Create with std::make_shared<ov::Strand>(executor), the pending tasks keep the strand alive.
+	class Strand : public std::enable_shared_from_this<Strand>
+	{
+	public:
+		// group: The group of the executor that the tasks are posted to (nullptr means the default group)
+		explicit Strand(Executor *executor, std::shared_ptr<Executor::Group> group = nullptr);
+
+		Strand(const Strand &strand) = delete;
+		Strand &operator=(const Strand &strand) = delete;
+
+		// Returns false if the strand is stopped or the executor is not running
+		bool Post(Executor::Task task);
+
+		// Discards the pending tasks and waits for the running task.
+		// Must not be called by a task of this strand.
+		void Stop();
+
+		// Whether the calling thread is running a task of this strand
+		bool IsCurrent() const;
+
+	protected:
+		// Runs the pending tasks on the executor, and posts itself again if there are more (so other strands are not starved)
+		void Run();
+
+		Executor *_executor;
+		std::shared_ptr<Executor::Group> _group;
+
+		mutable std::mutex _mutex;
+		std::condition_variable _condition;
+		std::deque<Executor::Task> _tasks;
+		// Whether Run() is posted to the executor or running
+		bool _is_scheduled = false;
+		// Whether a task is running (Stop() waits for it)
+		bool _is_running = false;
+		bool _is_stopped = false;
+	};
+}  // namespace ov
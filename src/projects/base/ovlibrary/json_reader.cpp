@@ -0,0 +1,626 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "./json_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ov
+{
+	JsonReader::JsonReader(const char *json, size_t length, Handler *handler)
+		: _begin(json),
+		  _end(json + length),
+		  _current(json),
+		  _handler(handler)
+	{
+	}
+
+	std::shared_ptr<Error> JsonReader::Parse(const void *json, size_t length, Handler *handler)
+	{
+		if ((json == nullptr) || (handler == nullptr))
+		{
+			return Error::CreateError("JSON", "Invalid parameters");
+		}
+
+		JsonReader reader(static_cast<const char *>(json), length, handler);
+
+		bool result = reader.ParseValue(0);
+
+		if (result)
+		{
+			reader.SkipWhitespaces();
+
+			if (reader._current != reader._end)
+			{
+				result = reader.SetError("Unexpected data after the value");
+			}
+		}
+
+		if (result)
+		{
+			return nullptr;
+		}
+
+		if (reader._is_stopped_by_handler)
+		{
+			return Error::CreateError("JSON", "Stopped by the handler at offset %zu", static_cast<size_t>(reader._current - reader._begin));
+		}
+
+		return Error::CreateError("JSON", "%s at offset %zu", reader._error_message, static_cast<size_t>(reader._current - reader._begin));
+	}
+
+	std::shared_ptr<Error> JsonReader::Parse(const std::shared_ptr<const Data> &json, Handler *handler)
+	{
+		if (json == nullptr)
+		{
+			return Error::CreateError("JSON", "Invalid parameters");
+		}
+
+		return Parse(json->GetData(), json->GetLength(), handler);
+	}
+
+	bool JsonReader::SetError(const char *message)
+	{
+		_error_message = message;
+		return false;
+	}
+
+	void JsonReader::SkipWhitespaces()
+	{
+		while (_current < _end)
+		{
+			switch (*_current)
+			{
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+					_current++;
+					break;
+
+				default:
+					return;
+			}
+		}
+	}
+
+#define OV_JSON_CALL_HANDLER(call)            \
+	if ((_handler->call) == false)            \
+	{                                         \
+		_is_stopped_by_handler = true;        \
+		return false;                         \
+	}
+
+	bool JsonReader::ParseValue(int depth)
+	{
+		SkipWhitespaces();
+
+		if (_current >= _end)
+		{
+			return SetError("Unexpected end of data");
+		}
+
+		switch (*_current)
+		{
+			case '{':
+				return ParseObject(depth + 1);
+
+			case '[':
+				return ParseArray(depth + 1);
+
+			case '"': {
+				std::string_view value;
+
+				if (ParseString(&value) == false)
+				{
+					return false;
+				}
+
+				OV_JSON_CALL_HANDLER(OnString(value));
+				return true;
+			}
+
+			case 't':
+				if (ParseLiteral("true") == false)
+				{
+					return false;
+				}
+
+				OV_JSON_CALL_HANDLER(OnBool(true));
+				return true;
+
+			case 'f':
+				if (ParseLiteral("false") == false)
+				{
+					return false;
+				}
+
+				OV_JSON_CALL_HANDLER(OnBool(false));
+				return true;
+
+			case 'n':
+				if (ParseLiteral("null") == false)
+				{
+					return false;
+				}
+
+				OV_JSON_CALL_HANDLER(OnNull());
+				return true;
+
+			default:
+				return ParseNumber();
+		}
+	}
+
+	bool JsonReader::ParseObject(int depth)
+	{
+		if (depth > MaxDepth)
+		{
+			return SetError("Too deep nesting");
+		}
+
+		// Skip '{'
+		_current++;
+		OV_JSON_CALL_HANDLER(OnBeginObject());
+
+		SkipWhitespaces();
+
+		if ((_current < _end) && (*_current == '}'))
+		{
+			_current++;
+			OV_JSON_CALL_HANDLER(OnEndObject());
+			return true;
+		}
+
+		while (true)
+		{
+			SkipWhitespaces();
+
+			if ((_current >= _end) || (*_current != '"'))
+			{
+				return SetError("A key is expected");
+			}
+
+			std::string_view key;
+
+			if (ParseString(&key) == false)
+			{
+				return false;
+			}
+
+			OV_JSON_CALL_HANDLER(OnKey(key));
+
+			SkipWhitespaces();
+
+			if ((_current >= _end) || (*_current != ':'))
+			{
+				return SetError("':' is expected");
+			}
+
+			_current++;
+
+			if (ParseValue(depth) == false)
+			{
+				return false;
+			}
+
+			SkipWhitespaces();
+
+			if (_current >= _end)
+			{
+				return SetError("Unexpected end of data");
+			}
+
+			if (*_current == ',')
+			{
+				_current++;
+				continue;
+			}
+
+			if (*_current == '}')
+			{
+				_current++;
+				OV_JSON_CALL_HANDLER(OnEndObject());
+				return true;
+			}
+
+			return SetError("',' or '}' is expected");
+		}
+	}
+
+	bool JsonReader::ParseArray(int depth)
+	{
+		if (depth > MaxDepth)
+		{
+			return SetError("Too deep nesting");
+		}
+
+		// Skip '['
+		_current++;
+		OV_JSON_CALL_HANDLER(OnBeginArray());
+
+		SkipWhitespaces();
+
+		if ((_current < _end) && (*_current == ']'))
+		{
+			_current++;
+			OV_JSON_CALL_HANDLER(OnEndArray());
+			return true;
+		}
+
+		while (true)
+		{
+			if (ParseValue(depth) == false)
+			{
+				return false;
+			}
+
+			SkipWhitespaces();
+
+			if (_current >= _end)
+			{
+				return SetError("Unexpected end of data");
+			}
+
+			if (*_current == ',')
+			{
+				_current++;
+				continue;
+			}
+
+			if (*_current == ']')
+			{
+				_current++;
+				OV_JSON_CALL_HANDLER(OnEndArray());
+				return true;
+			}
+
+			return SetError("',' or ']' is expected");
+		}
+	}
+
+	bool JsonReader::ParseLiteral(std::string_view literal)
+	{
+		if ((static_cast<size_t>(_end - _current) < literal.size()) ||
+			(::memcmp(_current, literal.data(), literal.size()) != 0))
+		{
+			return SetError("Invalid literal");
+		}
+
+		_current += literal.size();
+
+		return true;
+	}
+
+	// number = [ minus ] int [ frac ] [ exp ] (RFC 8259)
+	bool JsonReader::ParseNumber()
+	{
+		const char *start = _current;
+		bool is_negative = false;
+
+		if (*_current == '-')
+		{
+			is_negative = true;
+			_current++;
+		}
+
+		if ((_current >= _end) || (*_current < '0') || (*_current > '9'))
+		{
+			return SetError("Invalid value");
+		}
+
+		// The integer part is accumulated while the digits are validated
+		uint64_t integer = 0;
+		bool is_overflowed = false;
+
+		if (*_current == '0')
+		{
+			_current++;
+		}
+		else
+		{
+			while ((_current < _end) && (*_current >= '0') && (*_current <= '9'))
+			{
+				const uint64_t digit = *_current - '0';
+
+				if (integer > ((UINT64_MAX - digit) / 10))
+				{
+					is_overflowed = true;
+				}
+
+				integer = integer * 10 + digit;
+				_current++;
+			}
+		}
+
+		bool is_integer = true;
+
+		if ((_current < _end) && (*_current == '.'))
+		{
+			is_integer = false;
+			_current++;
+
+			const char *digits = _current;
+
+			while ((_current < _end) && (*_current >= '0') && (*_current <= '9'))
+			{
+				_current++;
+			}
+
+			if (_current == digits)
+			{
+				return SetError("Invalid fraction");
+			}
+		}
+
+		if ((_current < _end) && ((*_current == 'e') || (*_current == 'E')))
+		{
+			is_integer = false;
+			_current++;
+
+			if ((_current < _end) && ((*_current == '+') || (*_current == '-')))
+			{
+				_current++;
+			}
+
+			const char *digits = _current;
+
+			while ((_current < _end) && (*_current >= '0') && (*_current <= '9'))
+			{
+				_current++;
+			}
+
+			if (_current == digits)
+			{
+				return SetError("Invalid exponent");
+			}
+		}
+
+		if (is_integer && (is_overflowed == false))
+		{
+			if (is_negative == false)
+			{
+				OV_JSON_CALL_HANDLER(OnUInt64(integer));
+				return true;
+			}
+
+			if (integer <= (static_cast<uint64_t>(INT64_MAX) + 1))
+			{
+				OV_JSON_CALL_HANDLER(OnInt64(static_cast<int64_t>(0 - integer)));
+				return true;
+			}
+		}
+
+		// strtod() needs a null-terminated string
+		const size_t length = _current - start;
+		char buffer[64];
+		double value;
+
+		if (length < sizeof(buffer))
+		{
+			::memcpy(buffer, start, length);
+			buffer[length] = '\0';
+			value = ::strtod(buffer, nullptr);
+		}
+		else
+		{
+			value = ::strtod(std::string(start, length).c_str(), nullptr);
+		}
+
+		OV_JSON_CALL_HANDLER(OnDouble(value));
+		return true;
+	}
+
+	bool JsonReader::ParseHex4(uint32_t *value)
+	{
+		if ((_end - _current) < 4)
+		{
+			return SetError("Invalid unicode escape");
+		}
+
+		uint32_t result = 0;
+
+		for (int index = 0; index < 4; index++)
+		{
+			const char c = *_current++;
+			result <<= 4;
+
+			if ((c >= '0') && (c <= '9'))
+			{
+				result |= c - '0';
+			}
+			else if ((c >= 'a') && (c <= 'f'))
+			{
+				result |= c - 'a' + 10;
+			}
+			else if ((c >= 'A') && (c <= 'F'))
+			{
+				result |= c - 'A' + 10;
+			}
+			else
+			{
+				return SetError("Invalid unicode escape");
+			}
+		}
+
+		*value = result;
+
+		return true;
+	}
+
+	// _current points the next of "\u"
+	bool JsonReader::ParseUnicodeEscape(uint32_t *code_point)
+	{
+		uint32_t high;
+
+		if (ParseHex4(&high) == false)
+		{
+			return false;
+		}
+
+		if ((high < 0xD800) || (high > 0xDFFF))
+		{
+			*code_point = high;
+			return true;
+		}
+
+		// A surrogate pair (\uD83D\uDE00)
+		if ((high > 0xDBFF) || ((_end - _current) < 2) || (_current[0] != '\\') || (_current[1] != 'u'))
+		{
+			return SetError("Invalid surrogate pair");
+		}
+
+		_current += 2;
+
+		uint32_t low;
+
+		if (ParseHex4(&low) == false)
+		{
+			return false;
+		}
+
+		if ((low < 0xDC00) || (low > 0xDFFF))
+		{
+			return SetError("Invalid surrogate pair");
+		}
+
+		*code_point = 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+
+		return true;
+	}
+
+	bool JsonReader::ParseString(std::string_view *value)
+	{
+		// Skip '"'
+		_current++;
+
+		const char *start = _current;
+
+		// Most strings have no escape sequence, so they are passed to the handler without copying
+		while ((_current < _end) && (*_current != '"') && (*_current != '\\'))
+		{
+			if (static_cast<uint8_t>(*_current) < 0x20)
+			{
+				return SetError("Control character in a string");
+			}
+
+			_current++;
+		}
+
+		if (_current >= _end)
+		{
+			return SetError("Unterminated string");
+		}
+
+		if (*_current == '"')
+		{
+			*value = std::string_view(start, _current - start);
+			_current++;
+			return true;
+		}
+
+		_string_buffer.assign(start, _current - start);
+
+		while (_current < _end)
+		{
+			const char c = *_current++;
+
+			if (c == '"')
+			{
+				*value = _string_buffer;
+				return true;
+			}
+
+			if (static_cast<uint8_t>(c) < 0x20)
+			{
+				return SetError("Control character in a string");
+			}
+
+			if (c != '\\')
+			{
+				_string_buffer.push_back(c);
+				continue;
+			}
+
+			if (_current >= _end)
+			{
+				break;
+			}
+
+			switch (*_current++)
+			{
+				case '"':
+					_string_buffer.push_back('"');
+					break;
+				case '\\':
+					_string_buffer.push_back('\\');
+					break;
+				case '/':
+					_string_buffer.push_back('/');
+					break;
+				case 'b':
+					_string_buffer.push_back('\b');
+					break;
+				case 'f':
+					_string_buffer.push_back('\f');
+					break;
+				case 'n':
+					_string_buffer.push_back('\n');
+					break;
+				case 'r':
+					_string_buffer.push_back('\r');
+					break;
+				case 't':
+					_string_buffer.push_back('\t');
+					break;
+
+				case 'u': {
+					uint32_t code_point;
+
+					if (ParseUnicodeEscape(&code_point) == false)
+					{
+						return false;
+					}
+
+					// Encode to UTF-8
+					if (code_point < 0x80)
+					{
+						_string_buffer.push_back(static_cast<char>(code_point));
+					}
+					else if (code_point < 0x800)
+					{
+						_string_buffer.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+						_string_buffer.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+					}
+					else if (code_point < 0x10000)
+					{
+						_string_buffer.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+						_string_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+						_string_buffer.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+					}
+					else
+					{
+						_string_buffer.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+						_string_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+						_string_buffer.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+						_string_buffer.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+					}
+
+					break;
+				}
+
+				default:
+					_current--;
+					return SetError("Invalid escape sequence");
+			}
+		}
+
+		return SetError("Unterminated string");
+	}
+}  // namespace ov
@@ -0,0 +1,83 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "./data.h"
+#include "./error.h"
+
+namespace ov
+{
+	// Parses a JSON text and calls the handler for each token (SAX style)
+	//
+	// Unlike ov::Json::Parse(), no ::Json::Value tree is built, so the handler keeps only the values it needs.
+	// The string_views passed to the handler are valid only during the call.
+	class JsonReader
+	{
+	public:
+		class Handler
+		{
+		public:
+			virtual ~Handler() = default;
+
+			// Return false to stop the parsing (JsonReader::Parse() returns an error)
+			virtual bool OnBeginObject() = 0;
+			virtual bool OnKey(std::string_view key) = 0;
+			virtual bool OnEndObject() = 0;
+			virtual bool OnBeginArray() = 0;
+			virtual bool OnEndArray() = 0;
+
+			virtual bool OnString(std::string_view value) = 0;
+			virtual bool OnBool(bool value) = 0;
+			virtual bool OnNull() = 0;
+
+			// Non-negative integers
+			virtual bool OnUInt64(uint64_t value) = 0;
+			// Negative integers
+			virtual bool OnInt64(int64_t value) = 0;
+			// The numbers with a fraction/exponent, or the integers out of the range of int64/uint64
+			virtual bool OnDouble(double value) = 0;
+		};
+
+		// The nesting is limited to prevent a stack overflow by a malicious input
+		static constexpr int MaxDepth = 64;
+
+		static std::shared_ptr<Error> Parse(const void *json, size_t length, Handler *handler);
+		static std::shared_ptr<Error> Parse(const std::shared_ptr<const Data> &json, Handler *handler);
+
+	protected:
+		JsonReader(const char *json, size_t length, Handler *handler);
+
+		bool ParseValue(int depth);
+		bool ParseObject(int depth);
+		bool ParseArray(int depth);
+		bool ParseNumber();
+		bool ParseLiteral(std::string_view literal);
+		// Decodes the escape sequences into _string_buffer if needed
+		bool ParseString(std::string_view *value);
+		bool ParseUnicodeEscape(uint32_t *code_point);
+		bool ParseHex4(uint32_t *value);
+
+		void SkipWhitespaces();
+
+		bool SetError(const char *message);
+
+		const char *const _begin;
+		const char *const _end;
+		const char *_current;
+		Handler *_handler;
+
+		std::string _string_buffer;
+
+		const char *_error_message = nullptr;
+		bool _is_stopped_by_handler = false;
+	};
+}  // namespace ov
@@ -0,0 +1,225 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "./json_writer.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace ov
+{
+	JsonWriter::JsonWriter(size_t capacity)
+	{
+		_buffer.SetCapacity(capacity);
+	}
+
+	void JsonWriter::PrepareValue()
+	{
+		if (_needs_comma)
+		{
+			_buffer.Append(',');
+		}
+
+		_needs_comma = true;
+	}
+
+	JsonWriter &JsonWriter::BeginObject()
+	{
+		PrepareValue();
+		_buffer.Append('{');
+		_needs_comma = false;
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::EndObject()
+	{
+		_buffer.Append('}');
+		_needs_comma = true;
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::BeginArray()
+	{
+		PrepareValue();
+		_buffer.Append('[');
+		_needs_comma = false;
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::EndArray()
+	{
+		_buffer.Append(']');
+		_needs_comma = true;
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Key(std::string_view key)
+	{
+		PrepareValue();
+		WriteEscapedString(key);
+		_buffer.Append(':');
+
+		// The value follows the key without ','
+		_needs_comma = false;
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Value(std::string_view value)
+	{
+		PrepareValue();
+		WriteEscapedString(value);
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Value(const char *value)
+	{
+		return (value != nullptr) ? Value(std::string_view(value)) : Null();
+	}
+
+	JsonWriter &JsonWriter::Value(const ov::String &value)
+	{
+		return Value(value.ToStringView());
+	}
+
+	JsonWriter &JsonWriter::Value(bool value)
+	{
+		PrepareValue();
+		_buffer.Append(value ? "true" : "false");
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Value(double value)
+	{
+		if (std::isfinite(value) == false)
+		{
+			// JSON cannot represent NaN/Infinity
+			return Null();
+		}
+
+		PrepareValue();
+
+		// The same precision as jsoncpp
+		char buffer[32];
+		_buffer.Append(buffer, String::FormatTo(buffer, "%.17g", value));
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Null()
+	{
+		PrepareValue();
+		_buffer.Append("null");
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::WriteInt64(int64_t value)
+	{
+		PrepareValue();
+
+		char buffer[24];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		_buffer.Append(buffer, result.ptr - buffer);
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::WriteUInt64(uint64_t value)
+	{
+		PrepareValue();
+
+		char buffer[24];
+		auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		_buffer.Append(buffer, result.ptr - buffer);
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Raw(const void *json, size_t length)
+	{
+		if ((json == nullptr) || (length == 0))
+		{
+			return Null();
+		}
+
+		PrepareValue();
+		_buffer.Append(static_cast<const char *>(json), length);
+
+		return *this;
+	}
+
+	JsonWriter &JsonWriter::Raw(const std::shared_ptr<const Data> &json)
+	{
+		return (json != nullptr) ? Raw(json->GetData(), json->GetLength()) : Null();
+	}
+
+	void JsonWriter::WriteEscapedString(std::string_view value)
+	{
+		static constexpr char HEX[] = "0123456789abcdef";
+
+		_buffer.Append('"');
+
+		// Appends the runs of the characters that do not need to be escaped at once
+		const char *run_start = value.data();
+		const char *end = value.data() + value.size();
+
+		for (const char *current = run_start; current < end; current++)
+		{
+			const auto c = static_cast<uint8_t>(*current);
+
+			if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			{
+				// UTF-8 bytes are written as is
+				continue;
+			}
+
+			_buffer.Append(run_start, current - run_start);
+			run_start = current + 1;
+
+			switch (c)
+			{
+				case '"':
+					_buffer.Append("\\\"", 2);
+					break;
+				case '\\':
+					_buffer.Append("\\\\", 2);
+					break;
+				case '\b':
+					_buffer.Append("\\b", 2);
+					break;
+				case '\f':
+					_buffer.Append("\\f", 2);
+					break;
+				case '\n':
+					_buffer.Append("\\n", 2);
+					break;
+				case '\r':
+					_buffer.Append("\\r", 2);
+					break;
+				case '\t':
+					_buffer.Append("\\t", 2);
+					break;
+				default: {
+					const char escaped[] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F]};
+					_buffer.Append(escaped, sizeof(escaped));
+					break;
+				}
+			}
+		}
+
+		_buffer.Append(run_start, end - run_start);
+		_buffer.Append('"');
+	}
+}  // namespace ov
@@ -0,0 +1,98 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include "./data.h"
+#include "./string.h"
+
+namespace ov
+{
+	// Writes a compact JSON text directly into a buffer (without building a ::Json::Value tree)
+	//
+	// Usage)
+	// ov::JsonWriter writer;
+	//
+	// writer.BeginObject()
+	// 	.Member("id", 1)
+	// 	.Key("candidates").BeginArray()
+	// 	.Value("candidate:0 1 UDP 50 192.168.0.183 10000 typ host")
+	// 	.EndArray()
+	// 	.Key("stream").Raw(cached_stream_json)
+	// 	.EndObject();
+	//
+	// The writer does not validate the structure (a key must be followed by a value, and Begin*() must be paired with End*()).
+	class JsonWriter
+	{
+	public:
+		JsonWriter() = default;
+		explicit JsonWriter(size_t capacity);
+
+		JsonWriter &BeginObject();
+		JsonWriter &EndObject();
+		JsonWriter &BeginArray();
+		JsonWriter &EndArray();
+
+		JsonWriter &Key(std::string_view key);
+
+		JsonWriter &Value(std::string_view value);
+		JsonWriter &Value(const char *value);
+		JsonWriter &Value(const ov::String &value);
+		JsonWriter &Value(bool value);
+		JsonWriter &Value(double value);
+		JsonWriter &Null();
+
+		template <typename T, std::enable_if_t<std::is_integral_v<T> && (std::is_same_v<T, bool> == false), int> = 0>
+		JsonWriter &Value(T value)
+		{
+			if constexpr (std::is_signed_v<T>)
+			{
+				return WriteInt64(value);
+			}
+			else
+			{
+				return WriteUInt64(value);
+			}
+		}
+
+		template <typename T>
+		JsonWriter &Member(std::string_view key, const T &value)
+		{
+			Key(key);
+			return Value(value);
+		}
+
+		// Inserts a JSON text that is already serialized (such as the stream description that is built once for a stream)
+		JsonWriter &Raw(const void *json, size_t length);
+		JsonWriter &Raw(const std::shared_ptr<const Data> &json);
+
+		const ov::String &GetString() const
+		{
+			return _buffer;
+		}
+
+		std::shared_ptr<Data> ToData() const
+		{
+			return _buffer.ToData(false);
+		}
+
+	protected:
+		void PrepareValue();
+
+		JsonWriter &WriteInt64(int64_t value);
+		JsonWriter &WriteUInt64(uint64_t value);
+		void WriteEscapedString(std::string_view value);
+
+		ov::String _buffer;
+		// Whether a ',' is needed before the next key/value
+		bool _needs_comma = false;
+	};
+}  // namespace ov
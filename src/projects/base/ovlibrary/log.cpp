@@ -16,21 +16,35 @@ static ov::LogInternal g_stat2_log_internal(OV_STAT2_LOG_FILE);
 static ov::LogInternal g_stat3_log_internal(OV_STAT3_LOG_FILE);
 static ov::LogInternal g_stat4_log_internal(OV_STAT4_LOG_FILE);
 
+// Starts from 1, so the call sites that have not been checked (state: 0) don't match
+unsigned int ov_log_generation = 1;
+
+// Makes the call sites check the settings again
+static void InvalidateCallSites()
+{
+	__atomic_add_fetch(&ov_log_generation, 1, __ATOMIC_RELEASE);
+}
+
 // log level 지정
 void ov_log_set_level(OVLogLevel level)
 {
 	g_log_internal.SetLogLevel(level);
+	InvalidateCallSites();
 }
 
 void ov_log_reset_enable()
 {
 	g_log_internal.ResetEnable();
+	InvalidateCallSites();
 }
 
 // tag는 정규식 사용 가능, 정규식에 대해서는 http://www.cplusplus.com/reference/regex/ECMAScript 참고
 bool ov_log_set_enable(const char *tag_regex, OVLogLevel level, bool is_enabled)
 {
-	return g_log_internal.SetEnable(tag_regex, level, is_enabled);
+	bool result = g_log_internal.SetEnable(tag_regex, level, is_enabled);
+	InvalidateCallSites();
+
+	return result;
 }
 
 bool ov_log_get_enabled(const char *tag, OVLogLevel level)
@@ -48,6 +62,27 @@ void ov_log_internal(OVLogLevel level, const char *tag, const char *file, int li
 	va_end(arg_list);
 }
 
+bool ov_log_update_call_site(OVLogCallSite *site, const char *tag, OVLogLevel level)
+{
+	// The generation is loaded before checking, so if the settings are changed during the check, the site is checked again next time
+	auto generation = __atomic_load_n(&ov_log_generation, __ATOMIC_ACQUIRE);
+	bool is_enabled = g_log_internal.IsLevelEnabled(tag, level);
+
+	__atomic_store_n(&(site->state), (generation << 1) | (is_enabled ? 1U : 0U), __ATOMIC_RELAXED);
+
+	return is_enabled;
+}
+
+void ov_log_write(OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, ...)
+{
+	va_list arg_list;
+	va_start(arg_list, format);
+
+	g_log_internal.Write(true, level, tag, file, line, method, format, arg_list);
+
+	va_end(arg_list);
+}
+
 void ov_log_set_path(const char *log_path)
 {
     g_log_internal.SetLogPath(log_path);
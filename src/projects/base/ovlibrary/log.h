@@ -59,22 +59,61 @@ typedef enum StatLogType
 	STAT_LOG_HLS_EDGE_VIEWERS
 } StatLogType;
 
+/// The result of the level/tag check of a log call site.
+/// It is cached until the settings are changed, so a disabled log costs an atomic load, and its arguments (such as Dump()) are not evaluated.
+typedef struct OVLogCallSite
+{
+	// (generation of the settings << 1) | is_enabled (0: not checked yet)
+	unsigned int state;
+} OVLogCallSite;
+
+/// Incremented whenever the settings (ov_log_set_level(), ov_log_set_enable(), ...) are changed
+extern unsigned int ov_log_generation;
+
+bool ov_log_update_call_site(OVLogCallSite *site, const char *tag, OVLogLevel level);
+
+static inline bool ov_log_is_enabled_at(OVLogCallSite *site, const char *tag, OVLogLevel level)
+{
+	unsigned int state = __atomic_load_n(&(site->state), __ATOMIC_RELAXED);
+
+	if ((state >> 1) == __atomic_load_n(&ov_log_generation, __ATOMIC_RELAXED))
+	{
+		return (state & 1) != 0;
+	}
+
+	return ov_log_update_call_site(site, tag, level);
+}
+
+// The tag must be the same for the call site (a literal or OV_LOG_TAG)
+//
+// The macro is a single statement (do/while), so "if (x) logtw(...); else ..." keeps its own else
+#ifdef __cplusplus
+#	define OV_LOG_AT_CALL_SITE(level, tag, format, ...)                                                       \
+		do                                                                                                    \
+		{                                                                                                     \
+			static OVLogCallSite ov_log_call_site = {0};                                                      \
+                                                                                                              \
+			if (ov_log_is_enabled_at(&ov_log_call_site, tag, level))                                          \
+			{                                                                                                 \
+				ov_log_write(level, tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ##__VA_ARGS__);     \
+			}                                                                                                 \
+		} while (false) // NOLINT
+#else // __cplusplus
+#	define OV_LOG_AT_CALL_SITE(level, tag, format, ...) ov_log_internal(level, tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
+#endif // __cplusplus
+
 #if DEBUG
-#	define logd(tag, format, ...)                     ov_log_internal(OVLogLevelDebug,          tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
-#	define logp(tag, format, ...)                       \
-		while (ov_log_get_enabled(tag, OVLogLevelDebug)) \
-		{                                                \
-			logd(tag, format, ##__VA_ARGS__);            \
-			break;                                       \
-		}
+#	define logd(tag, format, ...)                     OV_LOG_AT_CALL_SITE(OVLogLevelDebug,          tag, format, ## __VA_ARGS__) // NOLINT
+// The arguments of the packet logs are not evaluated when they are disabled (same as the other logs)
+#	define logp                                       logd
 #else
 #	define logd(...)                                  do {} while(false)
 #	define logp                                       logd
 #endif // DEBUG
-#define logi(tag, format, ...)                        ov_log_internal(OVLogLevelInformation,    tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
-#define logw(tag, format, ...)                        ov_log_internal(OVLogLevelWarning,        tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
-#define loge(tag, format, ...)                        ov_log_internal(OVLogLevelError,          tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
-#define logc(tag, format, ...)                        ov_log_internal(OVLogLevelCritical,       tag, __FILE__, __LINE__, __PRETTY_FUNCTION__, format, ## __VA_ARGS__) // NOLINT
+#define logi(tag, format, ...)                        OV_LOG_AT_CALL_SITE(OVLogLevelInformation,    tag, format, ## __VA_ARGS__) // NOLINT
+#define logw(tag, format, ...)                        OV_LOG_AT_CALL_SITE(OVLogLevelWarning,        tag, format, ## __VA_ARGS__) // NOLINT
+#define loge(tag, format, ...)                        OV_LOG_AT_CALL_SITE(OVLogLevelError,          tag, format, ## __VA_ARGS__) // NOLINT
+#define logc(tag, format, ...)                        OV_LOG_AT_CALL_SITE(OVLogLevelCritical,       tag, format, ## __VA_ARGS__) // NOLINT
 
 #define logtd(format, ...)                            logd(OV_LOG_TAG, format, ## __VA_ARGS__) // NOLINT
 #define logtp(format, ...)                            logp(OV_LOG_TAG ".Packet", format, ## __VA_ARGS__) // NOLINT
@@ -112,6 +151,8 @@ bool ov_log_set_enable(const char *tag_regex, OVLogLevel level, bool is_enabled)
 bool ov_log_get_enabled(const char *tag, OVLogLevel level);
 
 void ov_log_internal(OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, ...);
+// ov_log_internal() without checking the level/tag (the caller has checked it with ov_log_is_enabled_at())
+void ov_log_write(OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, ...);
 void ov_log_set_path(const char *log_path);
 
 void ov_stat_log_internal(StatLogType type, OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, ...);
@@ -179,6 +179,26 @@ namespace ov
 			return;
 		}
 
+		Write(show_format, level, tag, file, line, method, format, arg_list);
+	}
+
+	bool LogInternal::IsLevelEnabled(const char *tag, OVLogLevel level)
+	{
+		if (level < _level)
+		{
+			return false;
+		}
+
+		return IsEnabled((tag == nullptr) ? "" : tag, level);
+	}
+
+	void LogInternal::Write(bool show_format, OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, va_list &arg_list)
+	{
+		if (tag == nullptr)
+		{
+			tag = "";
+		}
+
 		// ::vprintf(format, arg_list);
 		// ::printf("\n");
 		// return;
@@ -323,7 +343,8 @@ namespace ov
 			}
 		}
 
-		_log_file.Write(log.CStr());
+		// The critical logs (such as the log before a crash) must not be lost in the queue
+		_log_file.Write(log.CStr(), level >= OVLogLevelCritical);
 	}
 
 	void LogInternal::SetLogPath(const char *log_path)
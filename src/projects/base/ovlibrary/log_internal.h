@@ -44,6 +44,8 @@ namespace ov
 		void SetLogLevel(OVLogLevel level);
 		void ResetEnable();
 		bool IsEnabled(const char *tag, OVLogLevel level);
+		// Both the level of SetLogLevel() and the rules of SetEnable()
+		bool IsLevelEnabled(const char *tag, OVLogLevel level);
 
 		/// @param tag_regex pattern of a tag
 		/// @param level Log level to display for tag
@@ -64,6 +66,8 @@ namespace ov
 		int64_t GetThreadId();
 
 		void Log(bool show_format, OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, va_list &arg_list);
+		// Log() without checking the level/tag (the caller has checked it with IsLevelEnabled())
+		void Write(bool show_format, OVLogLevel level, const char *tag, const char *file, int line, const char *method, const char *format, va_list &arg_list);
 
 		void SetLogPath(const char *log_path);
 
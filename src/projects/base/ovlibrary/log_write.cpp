@@ -7,17 +7,29 @@
 //
 //==============================================================================
 
-#include <iostream>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
 #include <iomanip>
+#include <iostream>
 #include <memory>
 #include <sstream>
-#include <sys/stat.h>
 
 #include "log_write.h"
+#include "thread_registry.h"
 
 namespace ov
 {
     bool LogWrite::_start_service = false;
+    std::atomic<bool> LogWrite::_is_async(false);
 
     LogWrite::LogWrite(std::string log_file_name) :
         _last_day(0),
@@ -35,17 +47,51 @@ namespace ov
         _log_file = _log_path + std::string("/") + log_file_name;
     }
 
+    LogWrite::~LogWrite()
+    {
+        if (_writer_thread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock_guard(_queue_mutex);
+                _stop_writer = true;
+            }
+
+            _queue_condition.notify_one();
+            _writer_thread.join();
+        }
+
+        std::lock_guard<std::mutex> lock_guard(_file_mutex);
+
+        Flush();
+
+        if (_log_fd >= 0)
+        {
+            ::close(_log_fd);
+            _log_fd = -1;
+        }
+    }
+
     void LogWrite::SetLogPath(const char* log_path)
     {
+        std::lock_guard<std::mutex> lock_guard(_file_mutex);
+
         _log_path = log_path;
         _log_file = log_path + std::string("/") + _log_file_name;
+
+        // Opens the file of the new path
+        if (_log_fd >= 0)
+        {
+            ::close(_log_fd);
+            _log_fd = -1;
+        }
     }
 
     void LogWrite::Initialize()
     {
         if (_start_service)
         {
-            SetLogPath(OV_LOG_DIR_SVC);
+            _log_path = OV_LOG_DIR_SVC;
+            _log_file = _log_path + std::string("/") + _log_file_name;
 
             // Change default log path to /var once for running service
             _start_service = false;
@@ -56,24 +102,153 @@ namespace ov
             return;
         }
 
-        std::lock_guard<std::mutex> lock_guard(_log_stream_mutex);
-        _log_stream.close();
-        _log_stream.clear();
-        _log_stream.open(_log_file, std::ofstream::out | std::ofstream::app);
+        if (_log_fd >= 0)
+        {
+            ::close(_log_fd);
+        }
+
+        _log_fd = ::open(_log_file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
     }
 
     void LogWrite::Initialize(bool start_service)
     {
         _start_service = start_service;
+
+        // The daemon has been forked, so the writer threads will not be lost
+        _is_async = true;
+    }
+
+    void LogWrite::StartWriter()
+    {
+        std::call_once(_writer_flag, [this]() {
+            try
+            {
+                _writer_thread = std::thread(&LogWrite::WriterThread, this);
+
+                _is_writer_running = true;
+            }
+            catch (const std::system_error &e)
+            {
+                // Writes synchronously
+                _is_async = false;
+            }
+        });
+    }
+
+    void LogWrite::Write(const char *log, bool is_urgent)
+    {
+        if (_is_async)
+        {
+            StartWriter();
+        }
+
+        if (is_urgent || (_is_writer_running == false))
+        {
+            std::lock_guard<std::mutex> lock_guard(_file_mutex);
+
+            Flush(log);
+
+            return;
+        }
+
+        bool was_empty = false;
+
+        {
+            std::lock_guard<std::mutex> lock_guard(_queue_mutex);
+
+            size_t length = ::strlen(log) + 1;
+
+            if ((_queued_bytes + length) > OV_LOG_MAX_QUEUED_BYTES)
+            {
+                _dropped_count++;
+                return;
+            }
+
+            was_empty = _queue.empty();
+
+            _queue.emplace_back(log);
+            _queue.back().push_back('\n');
+            _queued_bytes += length;
+        }
+
+        // The writer is woken up once for a batch of the logs
+        if (was_empty)
+        {
+            _queue_condition.notify_one();
+        }
+    }
+
+    void LogWrite::WriterThread()
+    {
+        ThreadMetrics thread_metrics("LogWriter", ThreadClass::Background);
+
+        std::unique_lock<std::mutex> lock(_queue_mutex);
+
+        while (_stop_writer == false)
+        {
+            _queue_condition.wait_for(lock, std::chrono::milliseconds(OV_LOG_FILE_CHECK_INTERVAL_MSEC), [this]() -> bool {
+                return _stop_writer || (_queue.empty() == false) || (_dropped_count > 0);
+            });
+
+            lock.unlock();
+
+            {
+                std::lock_guard<std::mutex> lock_guard(_file_mutex);
+                Flush();
+            }
+
+            lock.lock();
+        }
+    }
+
+    void LogWrite::Flush(const char *log)
+    {
+        std::vector<std::string> lines;
+        uint64_t dropped_count = 0;
+
+        {
+            std::lock_guard<std::mutex> lock_guard(_queue_mutex);
+
+            lines.swap(_queue);
+            _queued_bytes = 0;
+
+            dropped_count = _dropped_count;
+            _dropped_count = 0;
+        }
+
+        if (dropped_count > 0)
+        {
+            lines.emplace_back("[LogWrite] " + std::to_string(dropped_count) + " log(s) were dropped because the writer could not keep up\n");
+        }
+
+        if (log != nullptr)
+        {
+            lines.emplace_back(log);
+            lines.back().push_back('\n');
+        }
+
+        CheckFile();
+
+        if (lines.empty())
+        {
+            return;
+        }
+
+        if ((WriteLines(lines) == false) && (_log_fd >= 0))
+        {
+            // The file will be reopened
+            ::close(_log_fd);
+            _log_fd = -1;
+        }
     }
 
-    void LogWrite::Write(const char *log)
+    void LogWrite::CheckFile()
     {
         std::time_t time = std::time(nullptr);
         std::tm localTime {};
         ::localtime_r(&time, &localTime);
 
-        // At the end of the day, change file name to back it up 
+        // At the end of the day, change file name to back it up
         // ovenmediaengine.log.YYmmDD
         if (_last_day != localTime.tm_mday)
         {
@@ -82,18 +257,109 @@ namespace ov
                 std::ostringstream logfile;
                 logfile << _log_file << "." << std::put_time(&localTime, "%Y%m%d");
                 ::rename(_log_file.c_str(), logfile.str().c_str());
+
+                if (_log_fd >= 0)
+                {
+                    ::close(_log_fd);
+                    _log_fd = -1;
+                }
             }
             _last_day = localTime.tm_mday;
         }
 
-        struct stat file_stat {};
-        if (!_log_stream.is_open() || _log_stream.fail() || ::stat(_log_file.c_str(), &file_stat) != 0)
+        // The file may be removed or rotated by the others (it was checked for every log before)
+        auto now = std::chrono::steady_clock::now();
+
+        if ((_log_fd >= 0) && ((now - _last_check_time) >= std::chrono::milliseconds(OV_LOG_FILE_CHECK_INTERVAL_MSEC)))
+        {
+            _last_check_time = now;
+
+            struct stat file_stat {};
+            if (::stat(_log_file.c_str(), &file_stat) != 0)
+            {
+                ::close(_log_fd);
+                _log_fd = -1;
+            }
+        }
+
+        if (_log_fd < 0)
         {
             Initialize();
+            _last_check_time = now;
+        }
+    }
+
+    bool LogWrite::WriteLines(const std::vector<std::string> &lines)
+    {
+        if (_log_fd < 0)
+        {
+            return false;
+        }
+
+        std::vector<struct iovec> iov_list;
+        iov_list.reserve(std::min<size_t>(lines.size(), IOV_MAX));
+
+        size_t index = 0;
+
+        while (index < lines.size())
+        {
+            iov_list.clear();
+
+            while ((index < lines.size()) && (iov_list.size() < IOV_MAX))
+            {
+                auto &line = lines[index++];
+
+                iov_list.push_back({const_cast<char *>(line.data()), line.size()});
+            }
+
+            auto written = ::writev(_log_fd, iov_list.data(), static_cast<int>(iov_list.size()));
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    index -= iov_list.size();
+                    continue;
+                }
+
+                return false;
+            }
+
+            // Writes the rest of a partial write
+            size_t offset = static_cast<size_t>(written);
+
+            for (auto &iov : iov_list)
+            {
+                if (offset >= iov.iov_len)
+                {
+                    offset -= iov.iov_len;
+                    continue;
+                }
+
+                auto data = static_cast<const char *>(iov.iov_base) + offset;
+                auto remained = iov.iov_len - offset;
+                offset = 0;
+
+                while (remained > 0)
+                {
+                    auto result = ::write(_log_fd, data, remained);
+
+                    if (result < 0)
+                    {
+                        if (errno == EINTR)
+                        {
+                            continue;
+                        }
+
+                        return false;
+                    }
+
+                    data += result;
+                    remained -= result;
+                }
+            }
         }
 
-        std::lock_guard<std::mutex> lock_guard(_log_stream_mutex);
-        _log_stream << log << std::endl;
-        _log_stream.flush();
+        return true;
     }
-}
\ No newline at end of file
+}
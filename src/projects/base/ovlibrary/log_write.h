@@ -8,8 +8,13 @@
 //==============================================================================
 #pragma once
 
-#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #define OV_LOG_DIR              "logs"
 #define OV_LOG_DIR_SVC          "/var/log/ovenmediaengine"
@@ -21,29 +26,64 @@
 #define OV_STAT3_LOG_FILE       "hls_rtsp_reqeuest.log"
 #define OV_STAT4_LOG_FILE       "hls_rtsp_viewers.log"
 
+// If the writer cannot keep up, the logs over this size are dropped (and the count of them is written instead)
+#define OV_LOG_MAX_QUEUED_BYTES         (8 * 1024 * 1024)
+// How often the writer checks whether the file has been removed/rotated
+#define OV_LOG_FILE_CHECK_INTERVAL_MSEC 1000
+
 namespace ov
 {
+    // The logs are queued by the caller and written by a writer thread in batches (writev),
+    // so the threads that log don't wait for the disk.
+    //
+    // The writer thread is started after Initialize(start_service) (after the daemon is forked),
+    // the logs before it are written synchronously.
     class LogWrite
     {
     public:
         LogWrite(std::string log_file_name);
-        virtual ~LogWrite() = default;
-        void Write(const char* log);
+        virtual ~LogWrite();
+
+        // is_urgent: The log and the queued logs are written before returning (e.g. the logs before a crash)
+        void Write(const char* log, bool is_urgent = false);
         void SetLogPath(const char* log_path);
 
         static void Initialize(bool start_service);
 
     private:
         void Initialize();
+        void StartWriter();
+        void WriterThread();
+
+        // Writes the queued logs (and the log), _file_mutex must be locked
+        void Flush(const char *log = nullptr);
+        // Rotates/reopens the file if needed, _file_mutex must be locked
+        void CheckFile();
+        bool WriteLines(const std::vector<std::string> &lines);
+
+        // The logs to write (Write() -> writer thread)
+        std::mutex _queue_mutex;
+        std::condition_variable _queue_condition;
+        std::vector<std::string> _queue;
+        size_t _queued_bytes = 0;
+        uint64_t _dropped_count = 0;
+
+        std::once_flag _writer_flag;
+        std::thread _writer_thread;
+        std::atomic<bool> _is_writer_running{false};
+        bool _stop_writer = false;
 
-        std::mutex _log_stream_mutex;
-        std::ofstream _log_stream;
+        // The file (it is locked before _queue_mutex to keep the order of the logs)
+        std::mutex _file_mutex;
+        int _log_fd = -1;
         int _last_day;
+        std::chrono::steady_clock::time_point _last_check_time;
         std::string _log_path;
         std::string _log_file_name;
         std::string _log_file;
 
         static bool _start_service;
+        static std::atomic<bool> _is_async;
     };
 }
 
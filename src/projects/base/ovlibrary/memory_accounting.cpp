@@ -0,0 +1,175 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "memory_accounting.h"
+
+namespace ov
+{
+	std::atomic<bool> MemoryAccounting::_enabled{false};
+
+	// The counters of the categories are updated by all threads, so each is on its own cache line
+	struct alignas(64) CategoryCounter
+	{
+		std::atomic<int64_t> bytes{0};
+	};
+
+	static CategoryCounter _category_counters[static_cast<size_t>(MemoryCategory::Count)];
+
+	static thread_local MemoryCategory _current_category = MemoryCategory::Unknown;
+	static thread_local MemoryAccount *_current_account = nullptr;
+
+	static std::mutex _account_map_mutex;
+	// key: <vhost_app_name>/<stream_name>
+	static std::map<String, std::shared_ptr<MemoryAccount>> _account_map;
+
+	int64_t MemoryAccount::GetTotalBytes() const noexcept
+	{
+		int64_t total_bytes = 0;
+
+		for (const auto &bytes : _bytes)
+		{
+			total_bytes += bytes.load(std::memory_order_relaxed);
+		}
+
+		return total_bytes;
+	}
+
+	MemoryScope::MemoryScope(MemoryCategory category, const std::shared_ptr<MemoryAccount> &account)
+		: _previous_category(_current_category),
+		  _previous_account(_current_account)
+	{
+		_current_category = category;
+		_current_account = account.get();
+	}
+
+	MemoryScope::~MemoryScope()
+	{
+		_current_category = _previous_category;
+		_current_account = _previous_account;
+	}
+
+	void MemoryAccounting::SetEnabled(bool enabled)
+	{
+		_enabled = enabled;
+	}
+
+	const char *MemoryAccounting::StringFromCategory(MemoryCategory category)
+	{
+		switch (category)
+		{
+			case MemoryCategory::Unknown:
+				return "unknown";
+			case MemoryCategory::Socket:
+				return "socket";
+			case MemoryCategory::Ingest:
+				return "ingest";
+			case MemoryCategory::MediaRouter:
+				return "mediarouter";
+			case MemoryCategory::Transcode:
+				return "transcode";
+			case MemoryCategory::Segment:
+				return "segment";
+			case MemoryCategory::Publisher:
+				return "publisher";
+			case MemoryCategory::Count:
+				break;
+		}
+
+		return "unknown";
+	}
+
+	std::shared_ptr<MemoryAccount> MemoryAccounting::GetAccount(const String &vhost_app_name, const String &stream_name)
+	{
+		if (IsEnabled() == false)
+		{
+			return nullptr;
+		}
+
+		auto name = String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr());
+
+		std::lock_guard<std::mutex> lock_guard(_account_map_mutex);
+
+		auto &account = _account_map[name];
+
+		if (account == nullptr)
+		{
+			account = std::make_shared<MemoryAccount>(name);
+		}
+
+		return account;
+	}
+
+	MemoryCategory MemoryAccounting::GetCurrentCategory()
+	{
+		return _current_category;
+	}
+
+	MemoryAccount *MemoryAccounting::GetCurrentAccount()
+	{
+		return _current_account;
+	}
+
+	void MemoryAccounting::OnAllocated(MemoryCategory category, MemoryAccount *account, size_t bytes) noexcept
+	{
+		_category_counters[static_cast<size_t>(category)].bytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+
+		if (account != nullptr)
+		{
+			account->Add(category, static_cast<int64_t>(bytes));
+		}
+	}
+
+	void MemoryAccounting::OnFreed(MemoryCategory category, MemoryAccount *account, size_t bytes) noexcept
+	{
+		_category_counters[static_cast<size_t>(category)].bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+
+		if (account != nullptr)
+		{
+			account->Add(category, -static_cast<int64_t>(bytes));
+		}
+	}
+
+	int64_t MemoryAccounting::GetBytes(MemoryCategory category)
+	{
+		return _category_counters[static_cast<size_t>(category)].bytes.load(std::memory_order_relaxed);
+	}
+
+	std::vector<MemoryAccounting::AccountSnapshot> MemoryAccounting::GetAccountSnapshots()
+	{
+		std::vector<AccountSnapshot> snapshots;
+
+		std::lock_guard<std::mutex> lock_guard(_account_map_mutex);
+
+		for (auto item = _account_map.begin(); item != _account_map.end();)
+		{
+			auto &account = item->second;
+
+			// Nobody tags the new buffers with the account (the stream is deleted), and its buffers are all freed,
+			// so the buffers don't refer to it anymore
+			if ((account.use_count() == 1) && (account->GetTotalBytes() == 0))
+			{
+				item = _account_map.erase(item);
+				continue;
+			}
+
+			AccountSnapshot snapshot;
+			snapshot.name = account->GetName();
+
+			for (size_t index = 0; index < static_cast<size_t>(MemoryCategory::Count); index++)
+			{
+				snapshot.bytes[index] = account->GetBytes(static_cast<MemoryCategory>(index));
+			}
+
+			snapshots.push_back(std::move(snapshot));
+
+			++item;
+		}
+
+		return snapshots;
+	}
+}  // namespace ov
@@ -0,0 +1,137 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "./string.h"
+
+namespace ov
+{
+	// Where the storage of ov::Data (DataBuffer) is allocated
+	enum class MemoryCategory : uint8_t
+	{
+		// Not in any MemoryScope
+		Unknown,
+		// The data received by the sockets (PhysicalPort)
+		Socket,
+		// The providers (the reassembly of RTMP chunks, RTP, MPEG-TS, ...)
+		Ingest,
+		// The queues and the bitstream conversions of the MediaRouter
+		MediaRouter,
+		// The frames and the packets of the transcoder
+		Transcode,
+		// The segments of HLS/DASH/LL-DASH (the history of the playlists)
+		Segment,
+		// The packets of the publishers and the send queues of the sessions
+		Publisher,
+
+		Count
+	};
+
+	// The live bytes of a stream ("<vhost_app_name>/<stream_name>") by the category
+	// (The provider, the MediaRouter, the transcoder and the publishers of a stream share an account)
+	class MemoryAccount
+	{
+	public:
+		explicit MemoryAccount(const String &name)
+			: _name(name)
+		{
+		}
+
+		const String &GetName() const
+		{
+			return _name;
+		}
+
+		inline void Add(MemoryCategory category, int64_t bytes) noexcept
+		{
+			_bytes[static_cast<size_t>(category)].fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		int64_t GetBytes(MemoryCategory category) const noexcept
+		{
+			return _bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+		}
+
+		int64_t GetTotalBytes() const noexcept;
+
+	private:
+		const String _name;
+		std::atomic<int64_t> _bytes[static_cast<size_t>(MemoryCategory::Count)] = {};
+	};
+
+	// Tags the buffers allocated by the thread in the scope (the previous tag is restored at the end of the scope)
+	//
+	// Usage:
+	//     ov::MemoryScope memory_scope(ov::MemoryCategory::Transcode, _memory_account);
+	//
+	// The account must be kept by the caller while the scope is alive
+	class MemoryScope
+	{
+	public:
+		MemoryScope(MemoryCategory category, const std::shared_ptr<MemoryAccount> &account = nullptr);
+		~MemoryScope();
+
+		MemoryScope(const MemoryScope &scope) = delete;
+		MemoryScope &operator=(const MemoryScope &scope) = delete;
+
+	private:
+		MemoryCategory _previous_category;
+		MemoryAccount *_previous_account;
+	};
+
+	// Accounts the live bytes of ov::Data by the category and by the stream (<Performance><MemoryAccounting>)
+	//
+	// A DataBuffer is tagged with the MemoryScope of the thread that allocated it, and the tag is kept until the buffer
+	// is freed (or returned to a pool), whichever thread holds it after that. So the bytes show where the memory was allocated
+	// (such as the segment history or the transcoded frames), and a growing category/stream points at the leak.
+	// The buffers in the free lists of the pools are not counted (See DataPool::GetStatistics()).
+	class MemoryAccounting
+	{
+	public:
+		struct AccountSnapshot
+		{
+			String name;
+			int64_t bytes[static_cast<size_t>(MemoryCategory::Count)] = {};
+		};
+
+		// It must be enabled before the threads start (the buffers allocated before are not counted)
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled()
+		{
+			return _enabled.load(std::memory_order_relaxed);
+		}
+
+		static const char *StringFromCategory(MemoryCategory category);
+
+		// Returns the account of the stream (nullptr if it is disabled)
+		static std::shared_ptr<MemoryAccount> GetAccount(const String &vhost_app_name, const String &stream_name);
+
+		// The tag of the buffers allocated by this thread
+		static MemoryCategory GetCurrentCategory();
+		static MemoryAccount *GetCurrentAccount();
+
+		// Called by DataBuffer
+		static void OnAllocated(MemoryCategory category, MemoryAccount *account, size_t bytes) noexcept;
+		static void OnFreed(MemoryCategory category, MemoryAccount *account, size_t bytes) noexcept;
+
+		static int64_t GetBytes(MemoryCategory category);
+		// The accounts that have live bytes (the accounts of the deleted streams are removed when their bytes are freed)
+		static std::vector<AccountSnapshot> GetAccountSnapshots();
+
+	private:
+		static std::atomic<bool> _enabled;
+	};
+}  // namespace ov
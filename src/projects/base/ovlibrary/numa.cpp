@@ -0,0 +1,174 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "numa.h"
+
+#include <dirent.h>
+#include <pthread.h>
+
+#include <algorithm>
+#include <fstream>
+
+#include "./platform.h"
+
+#if IS_LINUX
+#	include <sched.h>
+#endif
+
+#define NUMA_SYSFS_NODE_PATH "/sys/devices/system/node"
+
+namespace ov
+{
+	std::atomic<bool> Numa::_enabled{false};
+
+	// The processors of the nodes, it is read once
+	static const std::vector<std::vector<int>> &GetTopology()
+	{
+		static const std::vector<std::vector<int>> topology = []() {
+			std::vector<std::pair<int, std::vector<int>>> nodes;
+
+			auto directory = ::opendir(NUMA_SYSFS_NODE_PATH);
+
+			if (directory != nullptr)
+			{
+				struct dirent *entry;
+
+				while ((entry = ::readdir(directory)) != nullptr)
+				{
+					int node = 0;
+
+					if (::sscanf(entry->d_name, "node%d", &node) != 1)
+					{
+						continue;
+					}
+
+					std::ifstream file(std::string(NUMA_SYSFS_NODE_PATH "/") + entry->d_name + "/cpulist");
+					std::string cpu_list;
+
+					if (std::getline(file, cpu_list))
+					{
+						auto processors = Platform::ParseProcessorList(cpu_list);
+
+						// The nodes that have only memory (such as CXL/PMEM) are not used
+						if (processors.empty() == false)
+						{
+							nodes.emplace_back(node, std::move(processors));
+						}
+					}
+				}
+
+				::closedir(directory);
+			}
+
+			std::sort(nodes.begin(), nodes.end(), [](const auto &node1, const auto &node2) {
+				return node1.first < node2.first;
+			});
+
+			std::vector<std::vector<int>> result;
+
+			for (auto &node : nodes)
+			{
+				result.push_back(std::move(node.second));
+			}
+
+			return result;
+		}();
+
+		return topology;
+	}
+
+	void Numa::SetEnabled(bool enabled)
+	{
+		_enabled = enabled;
+	}
+
+	int Numa::GetNodeCount()
+	{
+		return std::max(static_cast<int>(GetTopology().size()), 1);
+	}
+
+	const std::vector<int> &Numa::GetProcessors(int node)
+	{
+		static const std::vector<int> empty;
+		auto &topology = GetTopology();
+
+		if ((node < 0) || (node >= static_cast<int>(topology.size())))
+		{
+			return empty;
+		}
+
+		return topology[node];
+	}
+
+	int Numa::GetNodeOf(uint32_t key)
+	{
+		auto node_count = GetNodeCount();
+
+		if ((IsEnabled() == false) || (node_count < 2))
+		{
+			return -1;
+		}
+
+		return static_cast<int>(key % static_cast<uint32_t>(node_count));
+	}
+
+	bool Numa::BindThread(int node)
+	{
+#if IS_LINUX
+		auto &processors = GetProcessors(node);
+
+		if (processors.empty())
+		{
+			return false;
+		}
+
+		// The processors of the node that the thread is already allowed to run on (See ov::ThreadClasses),
+		// or all the processors of the node if there is none
+		cpu_set_t current_cpu_set;
+		bool has_current_cpu_set = (::pthread_getaffinity_np(::pthread_self(), sizeof(current_cpu_set), &current_cpu_set) == 0);
+
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+
+		for (auto processor : processors)
+		{
+			if ((has_current_cpu_set == false) || CPU_ISSET(processor, &current_cpu_set))
+			{
+				CPU_SET(processor, &cpu_set);
+			}
+		}
+
+		if (CPU_COUNT(&cpu_set) == 0)
+		{
+			for (auto processor : processors)
+			{
+				CPU_SET(processor, &cpu_set);
+			}
+		}
+
+		return (::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set) == 0);
+#else
+		return false;
+#endif
+	}
+
+	String Numa::ToString()
+	{
+		String description;
+		auto &topology = GetTopology();
+
+		description.AppendFormat("%zu nodes", topology.size());
+
+		for (size_t node = 0; node < topology.size(); node++)
+		{
+			description.AppendFormat(", node%zu: %zu processors", node, topology[node].size());
+		}
+
+		return description;
+	}
+}  // namespace ov
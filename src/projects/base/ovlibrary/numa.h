@@ -0,0 +1,53 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "./string.h"
+
+namespace ov
+{
+	// The NUMA topology of the host (<Performance><NUMA>)
+	//
+	// When it is enabled, the ingest, transcode and delivery threads of a stream are bound to the processors of a node
+	// that is chosen by the ID of the stream. The buffers that the threads allocate are local to the node,
+	// because ov::DataPool keeps the free lists per thread and the kernel places a page on the node that touches it first.
+	//
+	// The topology is read from /sys/devices/system/node (Linux only), so libnuma is not needed.
+	class Numa
+	{
+	public:
+		// The threads are not bound to the nodes by default
+		static void SetEnabled(bool enabled);
+		static bool IsEnabled()
+		{
+			return _enabled.load(std::memory_order_relaxed);
+		}
+
+		// The number of the nodes that have processors (1 if the host is not NUMA or the topology is unknown)
+		static int GetNodeCount();
+		// The processors of the node (empty if the node doesn't exist)
+		static const std::vector<int> &GetProcessors(int node);
+
+		// The node of the key (such as the ID of a stream), -1 if it is disabled or there is only one node
+		static int GetNodeOf(uint32_t key);
+
+		// Binds the calling thread to the processors of the node (Linux only)
+		// (If the thread is already bound to some processors of the node by its thread class, it stays on them)
+		static bool BindThread(int node);
+
+		static String ToString();
+
+	protected:
+		static std::atomic<bool> _enabled;
+	};
+}  // namespace ov
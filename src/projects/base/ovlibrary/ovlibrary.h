@@ -11,25 +11,39 @@
 #include "./ovdata_structure.h"
 
 #include "./assert.h"
+#include "./buffer_pool.h"
 #include "./byte_ordering.h"
 #include "./byte_stream.h"
 #include "./data.h"
+#include "./data_buffer.h"
+#include "./data_chain.h"
+#include "./data_pool.h"
 #include "./delay_queue.h"
 #include "./dump_utilities.h"
 #include "./enable_shared_from_this.h"
 #include "./error.h"
+#include "./executor.h"
 #include "./json.h"
+#include "./json_reader.h"
+#include "./json_writer.h"
 #include "./log.h"
+#include "./memory_accounting.h"
 #include "./memory_utilities.h"
+#include "./numa.h"
 #include "./path_manager.h"
 #include "./pcm_utilities.h"
 #include "./platform.h"
 #include "./queue.h"
 #include "./random.h"
+#include "./ring_queue.h"
 #include "./semaphore.h"
+#include "./sharded_hash_map.h"
 #include "./singleton.h"
 #include "./stack_trace.h"
 #include "./stop_watch.h"
 #include "./string.h"
+#include "./thread_class.h"
+#include "./thread_registry.h"
+#include "./timer_wheel.h"
 #include "./url.h"
 #include "./clock.h"
@@ -8,3 +8,539 @@
 //==============================================================================
 #include "pcm_utilities.h"
 
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define OV_PCM_X86 1
+#	include <immintrin.h>
+#elif defined(__aarch64__)
+#	define OV_PCM_NEON 1
+#	include <arm_neon.h>
+#endif
+
+namespace ov
+{
+	// The kernels process the blocks of the vector width, and leave the remaining samples to the scalar kernels
+	struct PcmKernels
+	{
+		const char *name;
+
+		void (*interleave_s16)(int16_t *destination, const int16_t *left, const int16_t *right, int samples);
+		void (*interleave_flt)(float *destination, const float *left, const float *right, int samples);
+		void (*deinterleave_s16)(int16_t *left, int16_t *right, const int16_t *source, int samples);
+		void (*deinterleave_flt)(float *left, float *right, const float *source, int samples);
+		void (*s16_to_flt)(float *destination, const int16_t *source, int count);
+		void (*flt_to_s16)(int16_t *destination, const float *source, int count);
+	};
+
+	//--------------------------------------------------------------------
+	// Scalar
+	//--------------------------------------------------------------------
+	template <typename T>
+	static inline void InterleaveScalar(T *destination, const T *left, const T *right, int offset, int samples)
+	{
+		for (int sample = offset; sample < samples; ++sample)
+		{
+			destination[sample * 2] = left[sample];
+			destination[sample * 2 + 1] = right[sample];
+		}
+	}
+
+	template <typename T>
+	static inline void DeinterleaveScalar(T *left, T *right, const T *source, int offset, int samples)
+	{
+		for (int sample = offset; sample < samples; ++sample)
+		{
+			left[sample] = source[sample * 2];
+			right[sample] = source[sample * 2 + 1];
+		}
+	}
+
+	static inline void S16ToFloatScalar(float *destination, const int16_t *source, int offset, int count)
+	{
+		for (int index = offset; index < count; ++index)
+		{
+			destination[index] = source[index] * (1.0f / 32768.0f);
+		}
+	}
+
+	static inline void FloatToS16Scalar(int16_t *destination, const float *source, int offset, int count)
+	{
+		for (int index = offset; index < count; ++index)
+		{
+			// Round to nearest like cvtps2dq/vcvtn (std::lrint() uses the current rounding mode)
+			auto value = std::lrint(source[index] * 32768.0f);
+
+			destination[index] = static_cast<int16_t>(std::clamp<long>(value, INT16_MIN, INT16_MAX));
+		}
+	}
+
+	static void InterleaveS16C(int16_t *destination, const int16_t *left, const int16_t *right, int samples)
+	{
+		InterleaveScalar(destination, left, right, 0, samples);
+	}
+
+	static void InterleaveFltC(float *destination, const float *left, const float *right, int samples)
+	{
+		InterleaveScalar(destination, left, right, 0, samples);
+	}
+
+	static void DeinterleaveS16C(int16_t *left, int16_t *right, const int16_t *source, int samples)
+	{
+		DeinterleaveScalar(left, right, source, 0, samples);
+	}
+
+	static void DeinterleaveFltC(float *left, float *right, const float *source, int samples)
+	{
+		DeinterleaveScalar(left, right, source, 0, samples);
+	}
+
+	static void S16ToFloatC(float *destination, const int16_t *source, int count)
+	{
+		S16ToFloatScalar(destination, source, 0, count);
+	}
+
+	static void FloatToS16C(int16_t *destination, const float *source, int count)
+	{
+		FloatToS16Scalar(destination, source, 0, count);
+	}
+
+#if OV_PCM_X86
+	//--------------------------------------------------------------------
+	// SSE2 (always available on x86_64)
+	//--------------------------------------------------------------------
+	__attribute__((target("sse2"))) static void InterleaveS16Sse2(int16_t *destination, const int16_t *left, const int16_t *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			auto l = _mm_loadu_si128(reinterpret_cast<const __m128i *>(left + sample));
+			auto r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(right + sample));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + sample * 2), _mm_unpacklo_epi16(l, r));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + sample * 2 + 8), _mm_unpackhi_epi16(l, r));
+		}
+
+		InterleaveScalar(destination, left, right, sample, samples);
+	}
+
+	__attribute__((target("sse2"))) static void InterleaveFltSse2(float *destination, const float *left, const float *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 4 <= samples; sample += 4)
+		{
+			auto l = _mm_loadu_ps(left + sample);
+			auto r = _mm_loadu_ps(right + sample);
+
+			_mm_storeu_ps(destination + sample * 2, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(destination + sample * 2 + 4, _mm_unpackhi_ps(l, r));
+		}
+
+		InterleaveScalar(destination, left, right, sample, samples);
+	}
+
+	__attribute__((target("sse2"))) static void DeinterleaveS16Sse2(int16_t *left, int16_t *right, const int16_t *source, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			auto v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + sample * 2));
+			auto v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + sample * 2 + 8));
+
+			// L0 R0 L1 R1 L2 R2 L3 R3 => L0 L1 L2 L3 R0 R1 R2 R3
+			v0 = _mm_shufflelo_epi16(v0, _MM_SHUFFLE(3, 1, 2, 0));
+			v0 = _mm_shufflehi_epi16(v0, _MM_SHUFFLE(3, 1, 2, 0));
+			v0 = _mm_shuffle_epi32(v0, _MM_SHUFFLE(3, 1, 2, 0));
+			v1 = _mm_shufflelo_epi16(v1, _MM_SHUFFLE(3, 1, 2, 0));
+			v1 = _mm_shufflehi_epi16(v1, _MM_SHUFFLE(3, 1, 2, 0));
+			v1 = _mm_shuffle_epi32(v1, _MM_SHUFFLE(3, 1, 2, 0));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(left + sample), _mm_unpacklo_epi64(v0, v1));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(right + sample), _mm_unpackhi_epi64(v0, v1));
+		}
+
+		DeinterleaveScalar(left, right, source, sample, samples);
+	}
+
+	__attribute__((target("sse2"))) static void DeinterleaveFltSse2(float *left, float *right, const float *source, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 4 <= samples; sample += 4)
+		{
+			auto v0 = _mm_loadu_ps(source + sample * 2);
+			auto v1 = _mm_loadu_ps(source + sample * 2 + 4);
+
+			_mm_storeu_ps(left + sample, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(right + sample, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+
+		DeinterleaveScalar(left, right, source, sample, samples);
+	}
+
+	__attribute__((target("sse2"))) static void S16ToFloatSse2(float *destination, const int16_t *source, int count)
+	{
+		const auto scale = _mm_set1_ps(1.0f / 32768.0f);
+		int index = 0;
+
+		for (; index + 8 <= count; index += 8)
+		{
+			auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index));
+			// Sign extension: put the sample in the upper 16 bits, then shift it down arithmetically
+			auto lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			auto hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+			_mm_storeu_ps(destination + index, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(destination + index + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+
+		S16ToFloatScalar(destination, source, index, count);
+	}
+
+	__attribute__((target("sse2"))) static void FloatToS16Sse2(int16_t *destination, const float *source, int count)
+	{
+		const auto scale = _mm_set1_ps(32768.0f);
+		int index = 0;
+
+		for (; index + 8 <= count; index += 8)
+		{
+			auto lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + index), scale));
+			auto hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(source + index + 4), scale));
+
+			// packssdw saturates to [-32768, 32767]
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(destination + index), _mm_packs_epi32(lo, hi));
+		}
+
+		FloatToS16Scalar(destination, source, index, count);
+	}
+
+	//--------------------------------------------------------------------
+	// AVX2
+	//--------------------------------------------------------------------
+	__attribute__((target("avx2"))) static void InterleaveS16Avx2(int16_t *destination, const int16_t *left, const int16_t *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 16 <= samples; sample += 16)
+		{
+			auto l = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(left + sample));
+			auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(right + sample));
+
+			// unpack works per 128-bit lane: lo = [0..3 | 8..11], hi = [4..7 | 12..15]
+			auto lo = _mm256_unpacklo_epi16(l, r);
+			auto hi = _mm256_unpackhi_epi16(l, r);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + sample * 2), _mm256_permute2x128_si256(lo, hi, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + sample * 2 + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+		}
+
+		InterleaveS16Sse2(destination + sample * 2, left + sample, right + sample, samples - sample);
+	}
+
+	__attribute__((target("avx2"))) static void InterleaveFltAvx2(float *destination, const float *left, const float *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			auto l = _mm256_loadu_ps(left + sample);
+			auto r = _mm256_loadu_ps(right + sample);
+
+			auto lo = _mm256_unpacklo_ps(l, r);
+			auto hi = _mm256_unpackhi_ps(l, r);
+
+			_mm256_storeu_ps(destination + sample * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+			_mm256_storeu_ps(destination + sample * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+		}
+
+		InterleaveFltSse2(destination + sample * 2, left + sample, right + sample, samples - sample);
+	}
+
+	__attribute__((target("avx2"))) static void DeinterleaveFltAvx2(float *left, float *right, const float *source, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			auto v0 = _mm256_loadu_ps(source + sample * 2);
+			auto v1 = _mm256_loadu_ps(source + sample * 2 + 8);
+
+			// [L0 L1 L4 L5 | L2 L3 L6 L7] => L0 L1 L2 L3 L4 L5 L6 L7
+			auto l = _mm256_castps_si256(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+			auto r = _mm256_castps_si256(_mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+
+			_mm256_storeu_ps(left + sample, _mm256_castsi256_ps(_mm256_permute4x64_epi64(l, _MM_SHUFFLE(3, 1, 2, 0))));
+			_mm256_storeu_ps(right + sample, _mm256_castsi256_ps(_mm256_permute4x64_epi64(r, _MM_SHUFFLE(3, 1, 2, 0))));
+		}
+
+		DeinterleaveFltSse2(left + sample, right + sample, source + sample * 2, samples - sample);
+	}
+
+	__attribute__((target("avx2"))) static void S16ToFloatAvx2(float *destination, const int16_t *source, int count)
+	{
+		const auto scale = _mm256_set1_ps(1.0f / 32768.0f);
+		int index = 0;
+
+		for (; index + 16 <= count; index += 16)
+		{
+			auto lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index)));
+			auto hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source + index + 8)));
+
+			_mm256_storeu_ps(destination + index, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+			_mm256_storeu_ps(destination + index + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+		}
+
+		S16ToFloatSse2(destination + index, source + index, count - index);
+	}
+
+	__attribute__((target("avx2"))) static void FloatToS16Avx2(int16_t *destination, const float *source, int count)
+	{
+		const auto scale = _mm256_set1_ps(32768.0f);
+		int index = 0;
+
+		for (; index + 16 <= count; index += 16)
+		{
+			auto lo = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(source + index), scale));
+			auto hi = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(source + index + 8), scale));
+
+			// packs works per 128-bit lane: [0..3 8..11 | 4..7 12..15]
+			auto packed = _mm256_packs_epi32(lo, hi);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + index), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+		}
+
+		FloatToS16Sse2(destination + index, source + index, count - index);
+	}
+#endif  // OV_PCM_X86
+
+#if OV_PCM_NEON
+	//--------------------------------------------------------------------
+	// NEON
+	//--------------------------------------------------------------------
+	static void InterleaveS16Neon(int16_t *destination, const int16_t *left, const int16_t *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			int16x8x2_t v = {{vld1q_s16(left + sample), vld1q_s16(right + sample)}};
+
+			vst2q_s16(destination + sample * 2, v);
+		}
+
+		InterleaveScalar(destination, left, right, sample, samples);
+	}
+
+	static void InterleaveFltNeon(float *destination, const float *left, const float *right, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 4 <= samples; sample += 4)
+		{
+			float32x4x2_t v = {{vld1q_f32(left + sample), vld1q_f32(right + sample)}};
+
+			vst2q_f32(destination + sample * 2, v);
+		}
+
+		InterleaveScalar(destination, left, right, sample, samples);
+	}
+
+	static void DeinterleaveS16Neon(int16_t *left, int16_t *right, const int16_t *source, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 8 <= samples; sample += 8)
+		{
+			auto v = vld2q_s16(source + sample * 2);
+
+			vst1q_s16(left + sample, v.val[0]);
+			vst1q_s16(right + sample, v.val[1]);
+		}
+
+		DeinterleaveScalar(left, right, source, sample, samples);
+	}
+
+	static void DeinterleaveFltNeon(float *left, float *right, const float *source, int samples)
+	{
+		int sample = 0;
+
+		for (; sample + 4 <= samples; sample += 4)
+		{
+			auto v = vld2q_f32(source + sample * 2);
+
+			vst1q_f32(left + sample, v.val[0]);
+			vst1q_f32(right + sample, v.val[1]);
+		}
+
+		DeinterleaveScalar(left, right, source, sample, samples);
+	}
+
+	static void S16ToFloatNeon(float *destination, const int16_t *source, int count)
+	{
+		int index = 0;
+
+		for (; index + 8 <= count; index += 8)
+		{
+			auto v = vld1q_s16(source + index);
+
+			vst1q_f32(destination + index, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), 1.0f / 32768.0f));
+			vst1q_f32(destination + index + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), 1.0f / 32768.0f));
+		}
+
+		S16ToFloatScalar(destination, source, index, count);
+	}
+
+	static void FloatToS16Neon(int16_t *destination, const float *source, int count)
+	{
+		int index = 0;
+
+		for (; index + 8 <= count; index += 8)
+		{
+			auto lo = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(source + index), 32768.0f));
+			auto hi = vcvtnq_s32_f32(vmulq_n_f32(vld1q_f32(source + index + 4), 32768.0f));
+
+			// vqmovn saturates to [-32768, 32767]
+			vst1q_s16(destination + index, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+		}
+
+		FloatToS16Scalar(destination, source, index, count);
+	}
+#endif  // OV_PCM_NEON
+
+	static PcmKernels SelectKernels()
+	{
+#if OV_PCM_X86
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+		{
+			// The AVX2 kernel of S16 deinterleaving has no gain over SSE2 (the shuffles are per lane)
+			return {"avx2", InterleaveS16Avx2, InterleaveFltAvx2, DeinterleaveS16Sse2, DeinterleaveFltAvx2, S16ToFloatAvx2, FloatToS16Avx2};
+		}
+
+		if (__builtin_cpu_supports("sse2"))
+		{
+			return {"sse2", InterleaveS16Sse2, InterleaveFltSse2, DeinterleaveS16Sse2, DeinterleaveFltSse2, S16ToFloatSse2, FloatToS16Sse2};
+		}
+#elif OV_PCM_NEON
+		return {"neon", InterleaveS16Neon, InterleaveFltNeon, DeinterleaveS16Neon, DeinterleaveFltNeon, S16ToFloatNeon, FloatToS16Neon};
+#endif
+
+		return {"scalar", InterleaveS16C, InterleaveFltC, DeinterleaveS16C, DeinterleaveFltC, S16ToFloatC, FloatToS16C};
+	}
+
+	static const PcmKernels &GetKernels()
+	{
+		// Selected once (thread-safe initialization of the static local)
+		static const PcmKernels kernels = SelectKernels();
+
+		return kernels;
+	}
+
+	template<>
+	bool Interleave<int16_t>(void *destination, const void *source, int channels, int samples)
+	{
+		if (channels != 2)
+		{
+			const int16_t *src = static_cast<const int16_t *>(source);
+
+			for (int channel = 0; channel < channels; ++channel)
+			{
+				int16_t *dst = static_cast<int16_t *>(destination) + channel;
+
+				for (int sample = 0; sample < samples; ++sample)
+				{
+					*dst = *src++;
+					dst += channels;
+				}
+			}
+
+			return true;
+		}
+
+		auto left = static_cast<const int16_t *>(source);
+
+		GetKernels().interleave_s16(static_cast<int16_t *>(destination), left, left + samples, samples);
+
+		return true;
+	}
+
+	template<>
+	bool Interleave<float>(void *destination, const void *source, int channels, int samples)
+	{
+		if (channels != 2)
+		{
+			const float *src = static_cast<const float *>(source);
+
+			for (int channel = 0; channel < channels; ++channel)
+			{
+				float *dst = static_cast<float *>(destination) + channel;
+
+				for (int sample = 0; sample < samples; ++sample)
+				{
+					*dst = *src++;
+					dst += channels;
+				}
+			}
+
+			return true;
+		}
+
+		auto left = static_cast<const float *>(source);
+
+		GetKernels().interleave_flt(static_cast<float *>(destination), left, left + samples, samples);
+
+		return true;
+	}
+
+	template<>
+	bool Interleave<int16_t>(void *destination, const void *left, const void *right, int samples)
+	{
+		GetKernels().interleave_s16(static_cast<int16_t *>(destination), static_cast<const int16_t *>(left), static_cast<const int16_t *>(right), samples);
+
+		return true;
+	}
+
+	template<>
+	bool Interleave<float>(void *destination, const void *left, const void *right, int samples)
+	{
+		GetKernels().interleave_flt(static_cast<float *>(destination), static_cast<const float *>(left), static_cast<const float *>(right), samples);
+
+		return true;
+	}
+
+	template<>
+	bool Deinterleave<int16_t>(void *left, void *right, const void *source, int samples)
+	{
+		GetKernels().deinterleave_s16(static_cast<int16_t *>(left), static_cast<int16_t *>(right), static_cast<const int16_t *>(source), samples);
+
+		return true;
+	}
+
+	template<>
+	bool Deinterleave<float>(void *left, void *right, const void *source, int samples)
+	{
+		GetKernels().deinterleave_flt(static_cast<float *>(left), static_cast<float *>(right), static_cast<const float *>(source), samples);
+
+		return true;
+	}
+
+	void ConvertS16ToFloat(float *destination, const int16_t *source, int count)
+	{
+		GetKernels().s16_to_flt(destination, source, count);
+	}
+
+	void ConvertFloatToS16(int16_t *destination, const float *source, int count)
+	{
+		GetKernels().flt_to_s16(destination, source, count);
+	}
+
+	const char *GetPcmKernelName()
+	{
+		return GetKernels().name;
+	}
+}  // namespace ov
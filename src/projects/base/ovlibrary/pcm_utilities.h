@@ -8,6 +8,8 @@
 //==============================================================================
 #pragma once
 
+#include <cstdint>
+
 namespace ov
 {
 // Interleave data of source and store it in destination
@@ -67,4 +69,43 @@ namespace ov
 
 		return true;
 	}
-}
\ No newline at end of file
+
+	// Split the interleaved left & right channel data (the reverse of Interleave())
+	template<typename T>
+	bool Deinterleave(void *left, void *right, const void *source, int samples)
+	{
+		const T *src = static_cast<const T *>(source);
+		T *l = static_cast<T *>(left);
+		T *r = static_cast<T *>(right);
+
+		for(int sample = 0; sample < samples; ++sample)
+		{
+			*l++ = *src++;
+			*r++ = *src++;
+		}
+
+		return true;
+	}
+
+	// int16_t/float are processed by the SIMD kernels (defined in pcm_utilities.cpp)
+	template<>
+	bool Interleave<int16_t>(void *destination, const void *source, int channels, int samples);
+	template<>
+	bool Interleave<float>(void *destination, const void *source, int channels, int samples);
+	template<>
+	bool Interleave<int16_t>(void *destination, const void *left, const void *right, int samples);
+	template<>
+	bool Interleave<float>(void *destination, const void *left, const void *right, int samples);
+	template<>
+	bool Deinterleave<int16_t>(void *left, void *right, const void *source, int samples);
+	template<>
+	bool Deinterleave<float>(void *left, void *right, const void *source, int samples);
+
+	// S16 <-> FLT ([-1.0, 1.0)) conversion of count samples
+	// (The float samples out of the range are saturated)
+	void ConvertS16ToFloat(float *destination, const int16_t *source, int count);
+	void ConvertFloatToS16(int16_t *destination, const float *source, int count);
+
+	// The kernel selected for this CPU ("avx2", "sse2", "neon" or "scalar")
+	const char *GetPcmKernelName();
+}
@@ -12,6 +12,9 @@
 #include <sys/syscall.h>
 #include <zconf.h>
 #include <pthread.h>
+#if IS_LINUX
+#	include <sched.h>
+#endif
 
 namespace ov
 {
@@ -37,4 +40,62 @@ namespace ov
 		return 0ULL;
 #endif
 	}
-}
\ No newline at end of file
+
+	int Platform::GetProcessorCount()
+	{
+		long count = ::sysconf(_SC_NPROCESSORS_ONLN);
+
+		return (count > 0) ? static_cast<int>(count) : 1;
+	}
+
+	bool Platform::SetThreadAffinity(int processor_index)
+	{
+#if IS_LINUX
+		cpu_set_t cpu_set;
+
+		CPU_ZERO(&cpu_set);
+		CPU_SET(processor_index % GetProcessorCount(), &cpu_set);
+
+		return (::pthread_setaffinity_np(::pthread_self(), sizeof(cpu_set), &cpu_set) == 0);
+#else
+		return false;
+#endif
+	}
+
+	std::vector<int> Platform::ParseProcessorList(const std::string &processor_list)
+	{
+		std::vector<int> processors;
+		size_t offset = 0;
+
+		while (offset < processor_list.size())
+		{
+			auto end = processor_list.find(',', offset);
+			if (end == std::string::npos)
+			{
+				end = processor_list.size();
+			}
+
+			auto range = processor_list.substr(offset, end - offset);
+			auto dash = range.find('-');
+
+			try
+			{
+				int first = std::stoi(range.substr(0, dash));
+				int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+
+				for (int processor = first; processor <= last; processor++)
+				{
+					processors.push_back(processor);
+				}
+			}
+			catch (const std::exception &)
+			{
+				// Ignores the broken range
+			}
+
+			offset = end + 1;
+		}
+
+		return processors;
+	}
+}
@@ -7,6 +7,7 @@
 //
 //==============================================================================
 #include <string>
+#include <vector>
 
 #define IS_WINDOWS                              0
 #define IS_UNIX                                 0
@@ -102,5 +103,13 @@ namespace ov
 		static std::string GetName();
 		static uint64_t GetProcessId();
 		static uint64_t GetThreadId();
+
+		// The number of online processors
+		static int GetProcessorCount();
+		// Pins the calling thread to the processor (Linux only)
+		static bool SetThreadAffinity(int processor_index);
+
+		// Parses the cpulist format of Linux (such as "0-7,16-23"), the broken ranges are ignored
+		static std::vector<int> ParseProcessorList(const std::string &processor_list);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+// USDT (statically defined tracing) probes of the pipeline stages
+//
+// A probe is a single nop in the code and a note in the ELF (.note.stapsdt), so it costs nothing until a tracer
+// (bpftrace, perf, SystemTap) attaches to it. The probes are compiled out if <sys/sdt.h> (systemtap-sdt-dev) is not
+// installed, or OV_DISABLE_PROBES is defined. The arguments must be integers or pointers, and cheap to evaluate
+// (they are evaluated even if no tracer is attached).
+//
+// The probes of the provider "ovenmediaengine"
+// 	port_receive      (socket_id, size)                                        PhysicalPort receives the data
+// 	router_push       (stream_id, track_id, pts, size, is_outgoing)             MediaRouteStream::Push()
+// 	router_pop        (stream_id, track_id, pts, size, is_outgoing)             MediaRouteStream::Pop()
+// 	decoder_in        (stream_id, track_id, pts, size)                          A packet is sent to the decoder
+// 	decoder_out       (stream_id, track_id, pts, size)                          A frame is received from the decoder
+// 	encoder_in        (stream_id, track_id, pts, size)                          A frame is sent to the encoder
+// 	encoder_out       (stream_id, track_id, pts, size)                          A packet is received from the encoder
+// 	segment_close     (app_name, stream_name, media_type, timestamp, duration, size)
+// 	                                                                           A segment of HLS/DASH/LL-DASH is closed
+// 	worker_send       (stream_id, packet_type, size, session_count, created_ns)  StreamWorker sends a packet to the sessions
+// 	srtp_protect      (payload_type, sequence_number, size)                     SrtpAdapter::ProtectRtp()
+// 	http_response     (status_code, sent_bytes)                                 HttpResponse::SendResponse()
+//
+// The strings are const char * (str() of bpftrace), and created_ns is the CLOCK_MONOTONIC time (nsecs of bpftrace)
+// For example, the distribution of the decoding latency (usec):
+// 	bpftrace -e 'usdt:/usr/bin/OvenMediaEngine:ovenmediaengine:decoder_in { @t[arg0, arg1, arg2] = nsecs; }
+// 	             usdt:/usr/bin/OvenMediaEngine:ovenmediaengine:decoder_out /@t[arg0, arg1, arg2]/ {
+// 	                 @usec = hist((nsecs - @t[arg0, arg1, arg2]) / 1000); delete(@t[arg0, arg1, arg2]); }'
+
+#if !defined(OV_DISABLE_PROBES) && defined(__linux__) && defined(__has_include)
+#	if __has_include(<sys/sdt.h>)
+#		include <sys/sdt.h>
+#		define OV_PROBES_AVAILABLE 1
+#	endif
+#endif
+
+#if defined(OV_PROBES_AVAILABLE)
+#	define OV_PROBE2(name, a1, a2) DTRACE_PROBE2(ovenmediaengine, name, a1, a2)
+#	define OV_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(ovenmediaengine, name, a1, a2, a3)
+#	define OV_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(ovenmediaengine, name, a1, a2, a3, a4)
+#	define OV_PROBE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(ovenmediaengine, name, a1, a2, a3, a4, a5)
+#	define OV_PROBE6(name, a1, a2, a3, a4, a5, a6) DTRACE_PROBE6(ovenmediaengine, name, a1, a2, a3, a4, a5, a6)
+#else
+// The arguments are not evaluated
+#	define OV_PROBE2(name, a1, a2)
+#	define OV_PROBE3(name, a1, a2, a3)
+#	define OV_PROBE4(name, a1, a2, a3, a4)
+#	define OV_PROBE5(name, a1, a2, a3, a4, a5)
+#	define OV_PROBE6(name, a1, a2, a3, a4, a5, a6)
+#endif
@@ -8,9 +8,13 @@
 //==============================================================================
 #pragma once
 
+#include <cinttypes>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <optional>
-#include <queue>
+#include <set>
 #include <shared_mutex>
 
 #include "./dump_utilities.h"
@@ -21,8 +25,97 @@
 
 namespace ov
 {
+	// What the queue does when an item exceeds the limit (See Queue::SetLimit())
+	enum class QueueOverflowPolicy : uint8_t
+	{
+		// Drops the Droppable items first (oldest first), and then drops like DropToKey
+		DropNonReference,
+		// Drops the oldest items with the items that depend on them, so the consumer restarts from a Key item
+		DropToKey,
+		// Rejects the new item (Enqueue() returns false), and the producer is expected to disconnect the consumer
+		Disconnect
+	};
+
+	enum class QueueItemPriority : uint8_t
+	{
+		// Nothing depends on the item (non-reference frame)
+		Droppable,
+		// The item depends on the previous items of the group (inter frame)
+		Dependent,
+		// The item doesn't depend on the others, and nothing depends on it (audio frame, network data)
+		Independent,
+		// The following Dependent items of the group depend on it (key frame)
+		Key
+	};
+
+	struct QueueItemClass
+	{
+		QueueItemPriority priority = QueueItemPriority::Independent;
+		// The items depend only on the items of the same group (track)
+		uint64_t group = 0;
+	};
+
+	// The status of a queue that is exported as metrics (See QueueRegistry)
+	class QueueMetricsInterface
+	{
+	public:
+		virtual ~QueueMetricsInterface() = default;
+
+		virtual String GetAlias() const = 0;
+		virtual size_t Size() const = 0;
+		virtual size_t GetBytes() const = 0;
+		virtual uint64_t GetDroppedCount() const = 0;
+	};
+
+	// All queues register themselves, so the depths of them can be exported without knowing the owners
+	class QueueRegistry
+	{
+	public:
+		static void Register(const QueueMetricsInterface *queue)
+		{
+			auto &registry = GetRegistry();
+			auto lock_guard = std::lock_guard(registry.mutex);
+
+			registry.queues.insert(queue);
+		}
+
+		static void Unregister(const QueueMetricsInterface *queue)
+		{
+			auto &registry = GetRegistry();
+			auto lock_guard = std::lock_guard(registry.mutex);
+
+			registry.queues.erase(queue);
+		}
+
+		// The queues are not destroyed while the callback is called
+		static void ForEach(const std::function<void(const QueueMetricsInterface &queue)> &callback)
+		{
+			auto &registry = GetRegistry();
+			auto lock_guard = std::lock_guard(registry.mutex);
+
+			for (auto queue : registry.queues)
+			{
+				callback(*queue);
+			}
+		}
+
+	private:
+		struct Registry
+		{
+			std::mutex mutex;
+			std::set<const QueueMetricsInterface *> queues;
+		};
+
+		static Registry &GetRegistry()
+		{
+			// Never destroyed, because the static queues may be destroyed after it
+			static auto registry = new Registry();
+			return *registry;
+		}
+	};
+
 	template <typename T>
-	class Queue
+	class Queue : public QueueMetricsInterface
 	{
 	public:
 		Queue()
@@ -37,18 +130,23 @@ namespace ov
 			SetAlias(alias);
 
 			_last_log_time.Start();
+			_last_drop_log_time.Start();
+
+			QueueRegistry::Register(this);
 
 			auto shared_lock = std::shared_lock(_name_mutex);
 			logd("ov.Queue", "[%p] %s is created with threshold: %zu, interval: %d", this, _queue_name.CStr(), threshold, log_interval_in_msec);
 		}
 
-		~Queue()
+		~Queue() override
 		{
+			QueueRegistry::Unregister(this);
+
 			auto shared_lock = std::shared_lock(_name_mutex);
 			logd("ov.Queue", "[%p] %s is destroyed", this, _queue_name.CStr());
 		}
 
-		String GetAlias() const
+		String GetAlias() const override
 		{
 			auto shared_lock = std::shared_lock(_name_mutex);
 			return _queue_name;
@@ -70,26 +168,94 @@ namespace ov
 			logd("ov.Queue", "[%p] The alias is changed to %s", this, _queue_name.CStr());
 		}
 
-		void Enqueue(const T &item)
+		// Bounds the memory of the queue (0: unlimited)
+		//
+		// size_of: The bytes of an item (nullptr: the byte limit is not used)
+		// class_of: The priority/group of an item, it is used by the drop policies (nullptr: all items are Independent)
+		// Must be called before the first item is enqueued
+		void SetLimit(size_t max_count, size_t max_bytes, QueueOverflowPolicy policy,
+					  std::function<size_t(const T &item)> size_of = nullptr,
+					  std::function<QueueItemClass(const T &item)> class_of = nullptr)
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			_max_count = max_count;
+			_max_bytes = (size_of != nullptr) ? max_bytes : 0;
+			_policy = policy;
+			_size_of = size_of;
+			_class_of = class_of;
+		}
+
+		// Called for each item that the queue drops by the limit (under the lock of the queue)
+		void SetDropCallback(std::function<void(const T &item, size_t bytes)> callback)
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			_drop_callback = callback;
+		}
+
+		// Returns false if the item is dropped by the limit
+		bool Enqueue(const T &item)
+		{
+			T copied_item = item;
+
+			return Enqueue(std::move(copied_item));
+		}
+
+		bool Enqueue(T &&item)
 		{
 			auto lock_guard = std::lock_guard(_mutex);
 
-			_queue.push(item);
+			size_t item_bytes = GetItemBytes(item);
+
+			if (MakeRoom(item, item_bytes) == false)
+			{
+				return false;
+			}
+
+			_bytes += item_bytes;
+			_queue.push_back(std::move(item));
 
 			CheckThreshold();
 
 			_condition.notify_all();
+
+			return true;
 		}
 
-		void Enqueue(T &&item)
+		// Waits until the number of items is less than max_size before enqueuing (for backpressure)
+		//
+		// Timeout in milliseconds
+		// Returns false if timed out or stopped
+		bool EnqueueWait(T &&item, size_t max_size, int timeout = Infinite)
 		{
-			auto lock_guard = std::lock_guard(_mutex);
+			auto unique_lock = std::unique_lock(_mutex);
+
+			// The deadline must not be affected by the changes of the wall clock
+			std::chrono::steady_clock::time_point expire =
+				(timeout == Infinite) ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+			_waiting_producer_count++;
+
+			auto result = _condition.wait_until(unique_lock, expire, [this, max_size]() -> bool {
+				return (_queue.size() < max_size) || _stop;
+			});
+
+			_waiting_producer_count--;
+
+			if ((result == false) || _stop)
+			{
+				return false;
+			}
 
-			_queue.push(std::move(item));
+			_bytes += GetItemBytes(item);
+			_queue.push_back(std::move(item));
 
 			CheckThreshold();
 
 			_condition.notify_all();
+
+			return true;
 		}
 
 		// Timeout in milliseconds
@@ -99,8 +265,8 @@ namespace ov
 
 			if (_stop == false)
 			{
-				std::chrono::system_clock::time_point expire =
-					(timeout == Infinite) ? std::chrono::system_clock::time_point::max() : std::chrono::system_clock::now() + std::chrono::milliseconds(timeout);
+				std::chrono::steady_clock::time_point expire =
+					(timeout == Infinite) ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
 
 				auto result = _condition.wait_until(unique_lock, expire, [this]() -> bool {
 					return ((_queue.empty() == false) || _stop);
@@ -111,7 +277,14 @@ namespace ov
 					if (_stop == false)
 					{
 						T value = std::move(_queue.front());
-						_queue.pop();
+						_queue.pop_front();
+						_bytes -= GetItemBytes(value);
+
+						if (_waiting_producer_count > 0)
+						{
+							// Wake up the producers waiting in EnqueueWait()
+							_condition.notify_all();
+						}
 
 						return std::move(value);
 					}
@@ -140,21 +313,58 @@ namespace ov
 			return _queue.empty();
 		}
 
+		// Returns a copy of the item that Dequeue() returns next without removing it (empty if the queue is empty)
+		std::optional<T> Peek() const
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			if (_queue.empty())
+			{
+				return {};
+			}
+
+			return _queue.front();
+		}
+
 		void Clear()
 		{
 			auto lock_guard = std::lock_guard(_mutex);
 
 			// empty the queue
 			_queue = {};
+			_bytes = 0;
+			_waiting_groups.clear();
 		}
 
-		size_t Size() const
+		size_t Size() const override
 		{
 			auto lock_guard = std::lock_guard(_mutex);
 
 			return _queue.size();
 		}
 
+		// The bytes of the items in the queue (0 if the byte limit is not used)
+		size_t GetBytes() const override
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			return _bytes;
+		}
+
+		uint64_t GetDroppedCount() const override
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			return _dropped_count;
+		}
+
+		uint64_t GetDroppedBytes() const
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			return _dropped_bytes;
+		}
+
 		bool IsStopped() const
 		{
 			return _stop;
@@ -181,19 +391,193 @@ namespace ov
 			}
 		}
 
+		inline size_t GetItemBytes(const T &item) const
+		{
+			return (_max_bytes > 0) ? _size_of(item) : 0;
+		}
+
+		inline QueueItemClass GetItemClass(const T &item) const
+		{
+			return (_class_of != nullptr) ? _class_of(item) : QueueItemClass();
+		}
+
+		inline bool IsOverLimit(size_t item_bytes) const
+		{
+			return ((_max_count > 0) && ((_queue.size() + 1) > _max_count)) ||
+				   ((_max_bytes > 0) && ((_bytes + item_bytes) > _max_bytes));
+		}
+
+		inline void OnDropped(const T &item, size_t bytes)
+		{
+			_dropped_count++;
+			_dropped_bytes += bytes;
+
+			if (_drop_callback != nullptr)
+			{
+				_drop_callback(item, bytes);
+			}
+
+			if (_last_drop_log_time.IsElapsed(_log_interval) && _last_drop_log_time.Update())
+			{
+				auto shared_lock = std::shared_lock(_name_mutex);
+				logw("ov.Queue", "[%p] %s has dropped %" PRIu64 " items (%" PRIu64 " bytes) so far by the limit: queue: %zu/%zu, bytes: %zu/%zu",
+					 this, _queue_name.CStr(), _dropped_count, _dropped_bytes, _queue.size(), _max_count, _bytes, _max_bytes);
+			}
+		}
+
+		// Removes the item at the position, and returns the position of the next item
+		typename std::deque<T>::iterator DropItem(typename std::deque<T>::iterator position)
+		{
+			size_t item_bytes = GetItemBytes(*position);
+
+			_bytes -= item_bytes;
+			OnDropped(*position, item_bytes);
+
+			return _queue.erase(position);
+		}
+
+		// Drops the Dependent/Droppable items of the group until the next Key item of the group
+		void DropDependentItems(uint64_t group)
+		{
+			auto position = _queue.begin();
+
+			while (position != _queue.end())
+			{
+				auto item_class = GetItemClass(*position);
+
+				if (item_class.group == group)
+				{
+					if (item_class.priority == QueueItemPriority::Key)
+					{
+						return;
+					}
+
+					if (item_class.priority != QueueItemPriority::Independent)
+					{
+						position = DropItem(position);
+						continue;
+					}
+				}
+
+				++position;
+			}
+
+			// The next items of the group are dropped until a Key item is enqueued
+			_waiting_groups.insert(group);
+		}
+
+		// Returns false if the new item must be dropped
+		bool MakeRoom(const T &item, size_t item_bytes)
+		{
+			if ((_max_count == 0) && (_max_bytes == 0))
+			{
+				return true;
+			}
+
+			auto item_class = GetItemClass(item);
+
+			if ((_waiting_groups.empty() == false) && (_waiting_groups.find(item_class.group) != _waiting_groups.end()))
+			{
+				if (item_class.priority == QueueItemPriority::Key)
+				{
+					_waiting_groups.erase(item_class.group);
+				}
+				else if (item_class.priority != QueueItemPriority::Independent)
+				{
+					// The item cannot be decoded without the dropped items
+					OnDropped(item, item_bytes);
+					return false;
+				}
+			}
+
+			if (IsOverLimit(item_bytes) == false)
+			{
+				return true;
+			}
+
+			if (_policy == QueueOverflowPolicy::Disconnect)
+			{
+				OnDropped(item, item_bytes);
+				return false;
+			}
+
+			if (_policy == QueueOverflowPolicy::DropNonReference)
+			{
+				auto position = _queue.begin();
+
+				while ((position != _queue.end()) && IsOverLimit(item_bytes))
+				{
+					if (GetItemClass(*position).priority == QueueItemPriority::Droppable)
+					{
+						position = DropItem(position);
+					}
+					else
+					{
+						++position;
+					}
+				}
+			}
+
+			// DropToKey
+			while ((_queue.empty() == false) && IsOverLimit(item_bytes))
+			{
+				auto front_class = GetItemClass(_queue.front());
+
+				DropItem(_queue.begin());
+
+				if ((front_class.priority == QueueItemPriority::Key) || (front_class.priority == QueueItemPriority::Dependent))
+				{
+					DropDependentItems(front_class.group);
+				}
+			}
+
+			if (item_class.priority == QueueItemPriority::Key)
+			{
+				_waiting_groups.erase(item_class.group);
+			}
+			else if ((item_class.priority != QueueItemPriority::Independent) && (_waiting_groups.find(item_class.group) != _waiting_groups.end()))
+			{
+				// The items that the new item depends on have been dropped
+				OnDropped(item, item_bytes);
+				return false;
+			}
+
+			// If the item alone exceeds the limit, it is enqueued anyway (the queue is empty)
+			return true;
+		}
+
 	private:
 		StopWatch _last_log_time;
+		StopWatch _last_drop_log_time;
 
-		std::shared_mutex _name_mutex;
+		mutable std::shared_mutex _name_mutex;
 		String _queue_name;
 
 		size_t _threshold = 0;
 		int _log_interval = 0;
 
-		std::queue<T> _queue;
+		std::deque<T> _queue;
 		mutable std::mutex _mutex;
+
+		// Limits (See SetLimit())
+		size_t _max_count = 0;
+		size_t _max_bytes = 0;
+		QueueOverflowPolicy _policy = QueueOverflowPolicy::DropToKey;
+		std::function<size_t(const T &item)> _size_of;
+		std::function<QueueItemClass(const T &item)> _class_of;
+		std::function<void(const T &item, size_t bytes)> _drop_callback;
+
+		size_t _bytes = 0;
+		// The groups whose Dependent items are dropped until the next Key item
+		std::set<uint64_t> _waiting_groups;
+
+		uint64_t _dropped_count = 0;
+		uint64_t _dropped_bytes = 0;
 		std::condition_variable _condition;
 		bool _stop = false;
+
+		// The number of producers waiting in EnqueueWait()
+		size_t _waiting_producer_count = 0;
 	};
 
 }  // namespace ov
\ No newline at end of file
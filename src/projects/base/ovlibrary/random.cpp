@@ -9,16 +9,153 @@
 
 #include "random.h"
 
+#include <errno.h>
 #include <algorithm>
+#include <string.h>
 
-ov::String ov::Random::GenerateString(uint32_t size)
+#if defined(__linux__)
+#	include <sys/random.h>
+#endif
+
+// The number of bytes taken from the kernel at once
+#define OV_RANDOM_POOL_SIZE 512
+
+namespace ov
 {
-	std::string str("0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz");
+	static void FillFromKernel(uint8_t *buffer, size_t length)
+	{
+#if defined(__linux__)
+		while (length > 0)
+		{
+			auto result = ::getrandom(buffer, length, 0);
+
+			if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				// Not supported by the kernel (ENOSYS) - fall back to std::random_device
+				break;
+			}
+
+			buffer += result;
+			length -= static_cast<size_t>(result);
+		}
+#endif
+
+		if (length > 0)
+		{
+			std::random_device random_device;
+
+			while (length > 0)
+			{
+				auto value = random_device();
+				auto copy_length = std::min(length, sizeof(value));
+
+				::memcpy(buffer, &value, copy_length);
+
+				buffer += copy_length;
+				length -= copy_length;
+			}
+		}
+	}
+
+	struct RandomPool
+	{
+		uint8_t bytes[OV_RANDOM_POOL_SIZE];
+		// The bytes from this offset are not used yet (the pool is empty at first)
+		size_t offset = OV_RANDOM_POOL_SIZE;
+
+		void Take(uint8_t *buffer, size_t length)
+		{
+			while (length > 0)
+			{
+				if (offset == OV_RANDOM_POOL_SIZE)
+				{
+					FillFromKernel(bytes, sizeof(bytes));
+					offset = 0;
+				}
+
+				auto copy_length = std::min(length, OV_RANDOM_POOL_SIZE - offset);
+
+				::memcpy(buffer, bytes + offset, copy_length);
+
+				// Do not keep the bytes that are given out
+				::memset(bytes + offset, 0, copy_length);
+
+				offset += copy_length;
+				buffer += copy_length;
+				length -= copy_length;
+			}
+		}
+	};
+
+	static thread_local RandomPool _random_pool;
+
+	void Random::Fill(void *buffer, size_t length)
+	{
+		if ((buffer == nullptr) || (length == 0))
+		{
+			return;
+		}
+
+		if (length >= OV_RANDOM_POOL_SIZE)
+		{
+			// It is not worth buffering
+			FillFromKernel(static_cast<uint8_t *>(buffer), length);
+			return;
+		}
+
+		_random_pool.Take(static_cast<uint8_t *>(buffer), length);
+	}
+
+	uint64_t Random::GenerateUInt64()
+	{
+		uint64_t value;
+
+		Fill(&value, sizeof(value));
+
+		return value;
+	}
+
+	ov::String Random::GenerateString(uint32_t length)
+	{
+		static constexpr char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+		static constexpr size_t charset_length = sizeof(charset) - 1;
+		// The bytes greater than or equal to this are discarded to make the characters uniformly distributed
+		static constexpr size_t limit = 256 - (256 % charset_length);
+
+		ov::String random_string;
+
+		if (length == 0)
+		{
+			return random_string;
+		}
+
+		random_string.SetLength(length);
+		auto buffer = random_string.GetBuffer();
+
+		uint8_t bytes[64];
+		size_t byte_index = sizeof(bytes);
+
+		for (uint32_t index = 0; index < length;)
+		{
+			if (byte_index == sizeof(bytes))
+			{
+				Fill(bytes, sizeof(bytes));
+				byte_index = 0;
+			}
+
+			auto value = bytes[byte_index++];
 
-	std::random_device rd;
-	std::mt19937 generator(rd());
-	std::shuffle(str.begin(), str.end(), generator);
-	ov::String random_str = str.substr(0, size).c_str();
+			if (value < limit)
+			{
+				buffer[index++] = charset[value % charset_length];
+			}
+		}
 
-	return random_str;
-}
\ No newline at end of file
+		return random_string;
+	}
+}  // namespace ov
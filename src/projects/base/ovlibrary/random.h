@@ -9,19 +9,50 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <random>
 
 #include "./string.h"
 
 namespace ov
 {
+	// The random numbers are taken from a per-thread pool that is refilled by getrandom() in batches,
+	// so no std::random_device (a syscall or a file open) is constructed for each call.
+	// The values come from the kernel CSPRNG, so they can be used for ICE credentials and STUN transaction ids.
 	class Random
 	{
 	public:
+		// Satisfies UniformRandomBitGenerator to be used with the distributions of <random>
+		struct Generator
+		{
+			using result_type = uint64_t;
+
+			static constexpr result_type min()
+			{
+				return 0;
+			}
+
+			static constexpr result_type max()
+			{
+				return std::numeric_limits<result_type>::max();
+			}
+
+			result_type operator()()
+			{
+				return GenerateUInt64();
+			}
+		};
+
 		Random() = default;
 		virtual ~Random() = default;
 
+		// Fills the buffer with the random bytes
+		static void Fill(void *buffer, size_t length);
+
+		static uint64_t GenerateUInt64();
+
 		template<typename T>
 		static T GenerateRandom()
 		{
@@ -37,11 +68,9 @@ namespace ov
 		template<typename T>
 		static T GenerateRandom(T min, T max)
 		{
-			//TODO(getroot): 성능상 문제가 생기면 변수를 멤버 변수로 만들어서 사용한다.
-			std::random_device rd;
-			std::mt19937 mt(rd());
+			Generator generator;
 			std::uniform_int_distribution<T> dist(min, max);
-			return dist(mt);
+			return dist(generator);
 		}
 
 		static uint32_t GenerateUInt32(uint32_t min = 1, uint32_t max = UINT32_MAX)
@@ -54,6 +83,7 @@ namespace ov
 			return GenerateRandom<int32_t>(min, max);
 		}
 
+		// Generates a string of [0-9A-Za-z]
 		static ov::String GenerateString(uint32_t length);
 	};
-}
\ No newline at end of file
+}  // namespace ov
\ No newline at end of file
@@ -0,0 +1,364 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+#include "./dump_utilities.h"
+#include "./log.h"
+#include "./ovdata_structure.h"
+#include "./string.h"
+
+namespace ov
+{
+	enum class RingQueueType
+	{
+		// Single producer, single consumer
+		Spsc,
+		// Multiple producers, single consumer
+		Mpsc
+	};
+
+	// A bounded lock-free alternative to ov::Queue for the media hot paths
+	//
+	// - Enqueue() never takes a lock, and returns false if the queue is full
+	// - Only one thread may call Dequeue()/DequeueBatch()/Clear()
+	// - Producers wake the consumer up only if the consumer is sleeping
+	template <typename T, RingQueueType type = RingQueueType::Mpsc>
+	class RingQueue
+	{
+	public:
+		RingQueue()
+			: RingQueue(nullptr)
+		{
+		}
+
+		// capacity is rounded up to the power of 2
+		RingQueue(const char *alias, size_t capacity = 1024, int log_interval_in_msec = 5000)
+			: _log_interval(log_interval_in_msec)
+		{
+			size_t actual_capacity = 2;
+
+			while (actual_capacity < capacity)
+			{
+				actual_capacity <<= 1;
+			}
+
+			_mask = actual_capacity - 1;
+			_cells = std::vector<Cell>(actual_capacity);
+
+			for (size_t index = 0; index < actual_capacity; index++)
+			{
+				_cells[index].sequence.store(index, std::memory_order_relaxed);
+			}
+
+			SetAlias(alias);
+
+			auto shared_lock = std::shared_lock(_name_mutex);
+			logd("ov.RingQueue", "[%p] %s is created with capacity: %zu, interval: %d", this, _queue_name.CStr(), actual_capacity, log_interval_in_msec);
+		}
+
+		~RingQueue()
+		{
+			auto shared_lock = std::shared_lock(_name_mutex);
+			logd("ov.RingQueue", "[%p] %s is destroyed", this, _queue_name.CStr());
+		}
+
+		String GetAlias() const
+		{
+			auto shared_lock = std::shared_lock(_name_mutex);
+			return _queue_name;
+		}
+
+		void SetAlias(const char *alias)
+		{
+			auto lock_guard = std::lock_guard(_name_mutex);
+
+			if ((alias != nullptr) && (alias[0] != '\0'))
+			{
+				_queue_name = alias;
+			}
+			else
+			{
+				_queue_name.Format("RingQueue<%s>", Demangle(typeid(T).name()).CStr());
+			}
+		}
+
+		bool Enqueue(const T &item)
+		{
+			return EnqueueInternal(item);
+		}
+
+		bool Enqueue(T &&item)
+		{
+			return EnqueueInternal(std::move(item));
+		}
+
+		// Timeout in milliseconds
+		std::optional<T> Dequeue(int timeout = Infinite)
+		{
+			std::optional<T> value;
+
+			if (WaitForItem(timeout))
+			{
+				value = Pop();
+			}
+
+			return value;
+		}
+
+		// Dequeues up to max_count items at once
+		//
+		// @return the number of items appended to items
+		size_t DequeueBatch(std::vector<T> *items, size_t max_count, int timeout = Infinite)
+		{
+			size_t count = 0;
+
+			if (WaitForItem(timeout))
+			{
+				while (count < max_count)
+				{
+					auto value = Pop();
+
+					if (value.has_value() == false)
+					{
+						break;
+					}
+
+					items->push_back(std::move(value.value()));
+					count++;
+				}
+			}
+
+			return count;
+		}
+
+		bool IsEmpty() const
+		{
+			return Size() == 0;
+		}
+
+		// Approximate number of items (producers may be enqueuing at the same time)
+		size_t Size() const
+		{
+			auto enqueue_position = _enqueue_position.load(std::memory_order_acquire);
+			auto dequeue_position = _dequeue_position.load(std::memory_order_acquire);
+
+			return (enqueue_position > dequeue_position) ? (enqueue_position - dequeue_position) : 0;
+		}
+
+		size_t GetCapacity() const
+		{
+			return _mask + 1;
+		}
+
+		// The number of items rejected because the queue was full
+		uint64_t GetDroppedCount() const
+		{
+			return _dropped_count.load(std::memory_order_relaxed);
+		}
+
+		// Must be called from the consumer thread
+		void Clear()
+		{
+			while (Pop().has_value())
+			{
+			}
+		}
+
+		bool IsStopped() const
+		{
+			return _stop;
+		}
+
+		void Stop()
+		{
+			auto lock_guard = std::lock_guard(_mutex);
+
+			_stop = true;
+			_condition.notify_all();
+		}
+
+	protected:
+		struct Cell
+		{
+			std::atomic<size_t> sequence{0};
+			std::optional<T> value;
+		};
+
+		template <typename Titem>
+		bool EnqueueInternal(Titem &&item)
+		{
+			Cell *cell = nullptr;
+			size_t position = _enqueue_position.load(std::memory_order_relaxed);
+
+			while (true)
+			{
+				cell = &(_cells[position & _mask]);
+
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+				if (difference == 0)
+				{
+					if constexpr (type == RingQueueType::Spsc)
+					{
+						_enqueue_position.store(position + 1, std::memory_order_relaxed);
+						break;
+					}
+					else
+					{
+						if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						{
+							break;
+						}
+					}
+				}
+				else if (difference < 0)
+				{
+					// The queue is full
+					OnFull();
+					return false;
+				}
+				else
+				{
+					// Another producer took the cell
+					position = _enqueue_position.load(std::memory_order_relaxed);
+				}
+			}
+
+			cell->value.emplace(std::forward<Titem>(item));
+			cell->sequence.store(position + 1, std::memory_order_seq_cst);
+
+			// Pairs with the store to _is_consumer_waiting in WaitForItem()
+			if (_is_consumer_waiting.load(std::memory_order_seq_cst))
+			{
+				auto lock_guard = std::lock_guard(_mutex);
+				_condition.notify_one();
+			}
+
+			return true;
+		}
+
+		bool HasItem() const
+		{
+			size_t position = _dequeue_position.load(std::memory_order_relaxed);
+			size_t sequence = _cells[position & _mask].sequence.load(std::memory_order_seq_cst);
+
+			return (sequence == (position + 1));
+		}
+
+		std::optional<T> Pop()
+		{
+			std::optional<T> value;
+
+			size_t position = _dequeue_position.load(std::memory_order_relaxed);
+			Cell &cell = _cells[position & _mask];
+
+			if (cell.sequence.load(std::memory_order_acquire) != (position + 1))
+			{
+				// Empty
+				return value;
+			}
+
+			value = std::move(cell.value);
+			cell.value.reset();
+
+			// Make the cell available for the producers of the next round
+			cell.sequence.store(position + _mask + 1, std::memory_order_release);
+			_dequeue_position.store(position + 1, std::memory_order_release);
+
+			return value;
+		}
+
+		// Returns true if an item is available
+		bool WaitForItem(int timeout)
+		{
+			if (_stop)
+			{
+				return false;
+			}
+
+			if (HasItem())
+			{
+				return true;
+			}
+
+			if (timeout == 0)
+			{
+				return false;
+			}
+
+			auto unique_lock = std::unique_lock(_mutex);
+
+			_is_consumer_waiting.store(true, std::memory_order_seq_cst);
+
+			auto predicate = [this]() -> bool {
+				return HasItem() || _stop;
+			};
+
+			bool result;
+
+			if (timeout == Infinite)
+			{
+				_condition.wait(unique_lock, predicate);
+				result = true;
+			}
+			else
+			{
+				result = _condition.wait_for(unique_lock, std::chrono::milliseconds(timeout), predicate);
+			}
+
+			_is_consumer_waiting.store(false, std::memory_order_relaxed);
+
+			return result && (_stop == false);
+		}
+
+		void OnFull()
+		{
+			_dropped_count.fetch_add(1, std::memory_order_relaxed);
+
+			auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			auto last_log_time = _last_log_time.load(std::memory_order_relaxed);
+
+			if (((now - last_log_time) >= _log_interval) && _last_log_time.compare_exchange_strong(last_log_time, now))
+			{
+				auto shared_lock = std::shared_lock(_name_mutex);
+				logw("ov.RingQueue", "[%p] %s is full: capacity: %zu, dropped: %llu", this, _queue_name.CStr(), GetCapacity(), static_cast<unsigned long long>(GetDroppedCount()));
+			}
+		}
+
+	private:
+		mutable std::shared_mutex _name_mutex;
+		String _queue_name;
+
+		int _log_interval = 0;
+		std::atomic<int64_t> _last_log_time{0};
+		std::atomic<uint64_t> _dropped_count{0};
+
+		std::vector<Cell> _cells;
+		size_t _mask = 0;
+
+		// Producers and the consumer update these positions, so keep them on different cache lines
+		alignas(64) std::atomic<size_t> _enqueue_position{0};
+		alignas(64) std::atomic<size_t> _dequeue_position{0};
+
+		alignas(64) std::atomic<bool> _is_consumer_waiting{false};
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		volatile bool _stop = false;
+	};
+}  // namespace ov
@@ -8,43 +8,79 @@
 //==============================================================================
 #include "./semaphore.h"
 #include "./assert.h"
+#include "./memory_utilities.h"
 
-#include <chrono>
+#include <errno.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace ov
 {
-	void Semaphore::Notify()
+	Semaphore::Semaphore()
 	{
-		std::unique_lock<decltype(_mutex)> lock(_mutex);
+		// Non-blocking, so TryWait() of a reactor never blocks (Wait() polls the fd)
+		_fd = ::eventfd(0, EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC);
 
-		++_count;
+		OV_ASSERT(_fd >= 0, "Could not create an eventfd: %d", errno);
+	}
 
-		_condition.notify_one();
+	Semaphore::~Semaphore()
+	{
+		if (_fd >= 0)
+		{
+			::close(_fd);
+		}
 	}
 
-	void Semaphore::Wait()
+	void Semaphore::Notify()
 	{
-		std::unique_lock<decltype(_mutex)> lock(_mutex);
+		uint64_t value = 1;
 
-		while(_count <= 0)
+		while (::write(_fd, &value, sizeof(value)) < 0)
 		{
-			_condition.wait(lock);
+			if (errno != EINTR)
+			{
+				OV_ASSERT(false, "Could not notify the semaphore: %d", errno);
+				break;
+			}
 		}
+	}
 
-		OV_ASSERT2(_count > 0);
-		
-		--_count;
+	void Semaphore::Wait()
+	{
+		while (TryWait() == false)
+		{
+			pollfd poll_fd{_fd, POLLIN, 0};
+
+			// Another waiter may take the count first, so TryWait() is called again after the fd is ready
+			int result = ::poll(&poll_fd, 1, -1);
+
+			if (((result < 0) && (errno != EINTR)) || ((result > 0) && OV_CHECK_FLAG(poll_fd.revents, POLLNVAL)))
+			{
+				OV_ASSERT(false, "Could not wait for the semaphore: %d", errno);
+				return;
+			}
+		}
 	}
 
 	bool Semaphore::TryWait()
 	{
-		std::unique_lock<decltype(_mutex)> lock(_mutex);
+		uint64_t value;
 
-		if(_count > 0)
+		while (true)
 		{
-			--_count;
-			return true;
+			// With EFD_SEMAPHORE, read() decrements the count by 1
+			if (::read(_fd, &value, sizeof(value)) == sizeof(value))
+			{
+				return true;
+			}
+
+			if (errno != EINTR)
+			{
+				// EAGAIN: the count is 0
+				return false;
+			}
 		}
-		return false;
 	}
-}
\ No newline at end of file
+}
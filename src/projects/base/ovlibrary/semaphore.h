@@ -12,18 +12,32 @@
 
 namespace ov
 {
+	// A counting semaphore on an eventfd (EFD_SEMAPHORE)
+	//
+	// The fd is readable while the count is greater than 0, so it can be registered in an epoll set (EPOLLIN)
+	// with the sockets, and a reactor thread takes the counts with TryWait() when the fd is ready.
 	class Semaphore
 	{
 	public:
+		Semaphore();
+		~Semaphore();
+
+		Semaphore(const Semaphore &) = delete;
+		Semaphore &operator=(const Semaphore &) = delete;
+
 		void Notify();
 
 		void Wait();
 
 		bool TryWait();
 
+		// For epoll (EPOLLIN, level-triggered). Do not read the fd directly, use TryWait() instead.
+		int GetNativeHandle() const
+		{
+			return _fd;
+		}
+
 	private:
-		std::mutex _mutex;
-		std::condition_variable _condition;
-		unsigned long _count = 0;
+		int _fd = -1;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,120 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace ov
+{
+	// A hash map that is split into the shards, each of which has its own reader-writer lock.
+	// It is designed for the read-mostly tables that are looked up for every packet:
+	// the lookups of the different keys don't contend with each other (except when they are in the same shard),
+	// and the lookups of the same shard don't block each other.
+	template <typename Tkey, typename Tvalue, typename Thash = std::hash<Tkey>, size_t Tshard_count = 16>
+	class ShardedHashMap
+	{
+	public:
+		// Returns false if there is no item of the key
+		bool Find(const Tkey &key, Tvalue *value) const
+		{
+			auto &shard = GetShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			auto item = shard.map.find(key);
+
+			if (item == shard.map.end())
+			{
+				return false;
+			}
+
+			*value = item->second;
+
+			return true;
+		}
+
+		bool Contains(const Tkey &key) const
+		{
+			auto &shard = GetShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.find(key) != shard.map.end();
+		}
+
+		void Set(const Tkey &key, const Tvalue &value)
+		{
+			auto &shard = GetShard(key);
+			std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+			shard.map[key] = value;
+		}
+
+		// Returns false if the key already exists (the value is not changed)
+		bool Insert(const Tkey &key, const Tvalue &value)
+		{
+			auto &shard = GetShard(key);
+			std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.emplace(key, value).second;
+		}
+
+		bool Erase(const Tkey &key)
+		{
+			auto &shard = GetShard(key);
+			std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+			return shard.map.erase(key) > 0;
+		}
+
+		void Clear()
+		{
+			for (auto &shard : _shards)
+			{
+				std::lock_guard<std::shared_mutex> lock(shard.mutex);
+				shard.map.clear();
+			}
+		}
+
+		size_t GetSize() const
+		{
+			size_t size = 0;
+
+			for (auto &shard : _shards)
+			{
+				std::shared_lock<std::shared_mutex> lock(shard.mutex);
+				size += shard.map.size();
+			}
+
+			return size;
+		}
+
+	protected:
+		struct Shard
+		{
+			mutable std::shared_mutex mutex;
+			std::unordered_map<Tkey, Tvalue, Thash> map;
+		};
+
+		Shard &GetShard(const Tkey &key)
+		{
+			return _shards[_hasher(key) % Tshard_count];
+		}
+
+		const Shard &GetShard(const Tkey &key) const
+		{
+			return _shards[_hasher(key) % Tshard_count];
+		}
+
+		Thash _hasher;
+		std::array<Shard, Tshard_count> _shards;
+	};
+}  // namespace ov
@@ -338,6 +338,45 @@ namespace ov
 		return std::move(log);
 	}
 
+	String StackTrace::GetSymbolName(void *address)
+	{
+		char **symbol_list = ::backtrace_symbols(&address, 1);
+
+		if (symbol_list == nullptr)
+		{
+			return String::FormatString("%p", address);
+		}
+
+		String name;
+		ParseResult parse_result;
+
+		if (ParseLinuxStyleLine(symbol_list[0], &parse_result) || ParseMacOsStyleLine(symbol_list[0], &parse_result))
+		{
+			if (parse_result.demangled_function_name != nullptr)
+			{
+				name = parse_result.demangled_function_name;
+				::free(parse_result.demangled_function_name);
+			}
+			else if ((parse_result.function_name != nullptr) && (parse_result.function_name[0] != '\0'))
+			{
+				name = parse_result.function_name;
+			}
+			else
+			{
+				// Linux style line without the symbol: "module(+0x1234) [0x...]"
+				name.Format("%s+%s", parse_result.module_name, (parse_result.offset != nullptr) ? parse_result.offset : "0x0");
+			}
+		}
+		else
+		{
+			name = symbol_list[0];
+		}
+
+		::free(symbol_list);
+
+		return name;
+	}
+
 	void StackTrace::WriteStackTrace(std::ofstream &stream)
 	{
 		stream << GetStackTraceInternal(3);
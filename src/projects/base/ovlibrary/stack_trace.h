@@ -23,6 +23,10 @@ namespace ov
 		static String GetStackTrace(int line_count = -1);
 		static void WriteStackTrace(std::ofstream &stream);
 
+		// The (demangled) function name of the address, or "<module>+<offset>" if the symbol is not exported
+		// (Release builds don't export the symbols, the offset can be resolved with addr2line)
+		static String GetSymbolName(void *address);
+
 	private:
 		struct ParseResult
 		{
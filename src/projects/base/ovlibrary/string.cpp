@@ -38,6 +38,13 @@ namespace ov
 		  _length(string._length),
 		  _capacity(string._capacity)
 	{
+		if (string.IsInline())
+		{
+			// The inline buffer cannot be stolen
+			::memcpy(_inline_buffer, string._inline_buffer, sizeof(_inline_buffer));
+			_buffer = _inline_buffer;
+		}
+
 		string._buffer = nullptr;
 
 		string._length = 0;
@@ -87,7 +94,36 @@ namespace ov
 			_buffer[0] = '\0';
 		}
 
-		Append(buffer._buffer);
+		Append(buffer._buffer, buffer._length);
+
+		return *this;
+	}
+
+	String &String::operator =(String &&buffer) noexcept
+	{
+		if(this == &buffer)
+		{
+			return *this;
+		}
+
+		Release();
+
+		if (buffer.IsInline())
+		{
+			::memcpy(_inline_buffer, buffer._inline_buffer, sizeof(_inline_buffer));
+			_buffer = _inline_buffer;
+		}
+		else
+		{
+			_buffer = buffer._buffer;
+		}
+
+		_length = buffer._length;
+		_capacity = buffer._capacity;
+
+		buffer._buffer = nullptr;
+		buffer._length = 0;
+		buffer._capacity = 0;
 
 		return *this;
 	}
@@ -257,34 +293,46 @@ namespace ov
 
 	size_t String::AppendVFormat(const char *format, va_list list)
 	{
-		va_list list_for_count;
+		if ((_buffer == nullptr) && (Alloc(0) == false))
+		{
+			return 0;
+		}
 
-		va_copy(list_for_count, list);
+		va_list list_for_retry;
+
+		// vsnprintf로 길이를 얻어오면 list가 가장 마지막 파라미터를 가리키게 되므로
+		// 현재 상태를 미리 백업함
+		va_copy(list_for_retry, list);
 
-		int result = ::vsnprintf(nullptr, 0, format, &(list_for_count[0]));
+		// Try to format into the remaining space first, so the format is parsed only once in most cases
+		int result = ::vsnprintf(_buffer + _length, _capacity - _length + 1, format, list);
 
-		if(result < 0)
+		if (result < 0)
 		{
+			_buffer[_length] = '\0';
+			va_end(list_for_retry);
 			return 0L;
 		}
 
 		size_t length = static_cast<size_t>(result);
 
-		if(Alloc(_length + length) == false)
+		if ((_length + length) > _capacity)
 		{
-			return 0;
-		}
+			// The string is truncated, so format it again after allocating enough memory
+			if (Alloc(_length + length) == false)
+			{
+				_buffer[_length] = '\0';
+				va_end(list_for_retry);
+				return 0;
+			}
 
-		if(_buffer != nullptr)
-		{
-			::vsnprintf(_buffer + _length, length + 1, format, list);
-			_length += length;
+			::vsnprintf(_buffer + _length, length + 1, format, list_for_retry);
 		}
 
-		if(_buffer != nullptr)
-		{
-			_buffer[_length] = '\0';
-		}
+		va_end(list_for_retry);
+
+		_length += length;
+		_buffer[_length] = '\0';
 
 		return length;
 	}
@@ -295,7 +343,7 @@ namespace ov
 
 		va_start(list, format);
 
-		VFormat(format, &(list[0]));
+		VFormat(format, list);
 
 		va_end(list);
 
@@ -304,30 +352,13 @@ namespace ov
 
 	size_t String::VFormat(const char *format, va_list list)
 	{
-		va_list list_for_count;
-
-		// vsnprintf로 길이를 얻어오면 list가 가장 마지막 파라미터를 가리키게 되므로
-		// 현재 상태를 미리 백업함
-		va_copy(list_for_count, list);
-
-		int result = ::vsnprintf(nullptr, 0, format, list);
-
-		if(result <= 0L)
-		{
-			return 0L;
-		}
-
-		size_t length = static_cast<size_t>(result);
-
-		if(Alloc(length))
+		if (_buffer != nullptr)
 		{
-			va_copy(list, &(list_for_count[0]));
-
-			::vsnprintf(_buffer, length + 1, format, list);
-			_length = length;
+			_length = 0;
+			_buffer[0] = '\0';
 		}
 
-		return _length;
+		return AppendVFormat(format, list);
 	}
 
 	String String::FormatString(const char *format, ...)
@@ -337,13 +368,24 @@ namespace ov
 
 		va_start(list, format);
 
-		buffer.VFormat(format, &(list[0]));
+		buffer.VFormat(format, list);
 
 		va_end(list);
 
 		return buffer;
 	}
 
+	size_t String::FormatTo(char *buffer, size_t buffer_length, const char *format, ...)
+	{
+		va_list list;
+
+		va_start(list, format);
+		int result = ::vsnprintf(buffer, buffer_length, format, list);
+		va_end(list);
+
+		return (result > 0) ? static_cast<size_t>(result) : 0;
+	}
+
 	off_t String::IndexOf(char c, off_t start_position) const noexcept
 	{
 		if(start_position < 0)
@@ -760,18 +802,8 @@ namespace ov
 			return true;
 		}
 
-		// 위에서 두 값을 비교하기 때문에 여기서 둘 다 nullptr 경우는 없음
-		if((str._buffer == nullptr) || (_buffer == nullptr))
-		{
-			return false;
-		}
-
-		if(::strcmp(_buffer, str._buffer) == 0)
-		{
-			return true;
-		}
-
-		return false;
+		// CStr() returns "" if nothing is allocated, so the empty strings are equal regardless of the storage
+		return ::strcmp(CStr(), str.CStr()) == 0;
 	}
 
 	bool String::operator ==(const char *buffer) const
@@ -786,75 +818,17 @@ namespace ov
 			return false;
 		}
 
-		if(_buffer == nullptr)
-		{
-			if(buffer[0] == '\0')
-			{
-				return true;
-			}
-
-			return false;
-		}
-
-		if(::strcmp(_buffer, buffer) == 0)
-		{
-			return true;
-		}
-
-		return false;
+		return ::strcmp(CStr(), buffer) == 0;
 	}
 
 	bool String::operator <(const String &string) const
 	{
-		if(_buffer == nullptr)
-		{
-			if(string._buffer != nullptr)
-			{
-				// _buffer == nullptr && string != nullptr
-				return true;
-			}
-
-			// _buffer == nullptr && string == nullptr
-			return false;
-		}
-
-		if(string._buffer == nullptr)
-		{
-			// _buffer != nullptr && string == nullptr
-			return false;
-		}
-
-		// _buffer != nullptr && string != nullptr
-		if(::strcmp(_buffer, string._buffer) < 0)
-		{
-			return true;
-		}
-
-		return false;
+		return ::strcmp(CStr(), string.CStr()) < 0;
 	}
 
 	bool String::operator >(const String &string) const
 	{
-		if(_buffer == nullptr)
-		{
-			// _buffer == nullptr && string != nullptr
-			// _buffer == nullptr && string == nullptr
-			return false;
-		}
-
-		if(string._buffer == nullptr)
-		{
-			// _buffer != nullptr && string == null
-			return true;
-		}
-
-		// _buffer != nullptr && string != nullptr
-		if(::strcmp(_buffer, string._buffer) > 0)
-		{
-			return true;
-		}
-
-		return false;
+		return ::strcmp(CStr(), string.CStr()) > 0;
 	}
 
 	size_t String::GetCapacity() const noexcept
@@ -916,6 +890,30 @@ namespace ov
 
 	bool String::Alloc(size_t length, bool alloc_exactly) noexcept
 	{
+		if(length <= OV_STRING_INLINE_CAPACITY)
+		{
+			// 짧은 문자열은 heap 할당 없이 inline buffer에 저장함
+			if(IsInline() == false)
+			{
+				size_t new_length = std::min(_length, length);
+
+				if(new_length > 0L)
+				{
+					::memcpy(_inline_buffer, _buffer, sizeof(char) * new_length);
+				}
+
+				::memset(_inline_buffer + new_length, 0, sizeof(_inline_buffer) - new_length);
+
+				Release();
+
+				_buffer = _inline_buffer;
+				_capacity = OV_STRING_INLINE_CAPACITY;
+				_length = new_length;
+			}
+
+			return true;
+		}
+
 		if(
 			// 기존에 할당된 버퍼가 충분 하지 않거나
 			(_capacity < length) ||
@@ -956,17 +954,17 @@ namespace ov
 				return false;
 			}
 
-			::memset(buffer, 0, sizeof(char) * (allocated_length + 1L));
-
 			// 기존에 데이터가 있다면 복사
-			if(_length > 0L)
+			size_t new_length = std::min(allocated_length, _length);
+
+			if(new_length > 0L)
 			{
-				::memcpy(buffer, _buffer, sizeof(char) * std::min(allocated_length, _length));
+				::memcpy(buffer, _buffer, sizeof(char) * new_length);
 			}
 
-			// 기존 버퍼 해제
-			size_t old_length = _length;
+			::memset(buffer + new_length, 0, sizeof(char) * (allocated_length + 1L - new_length));
 
+			// 기존 버퍼 해제
 			Release();
 
 			_capacity = allocated_length;
@@ -975,7 +973,7 @@ namespace ov
 			_buffer = buffer;
 
 			// Release()에 의해 길이 정보가 초기화 되었으므로 다시 대입해줌
-			_length = old_length;
+			_length = new_length;
 		}
 
 		return true;
@@ -983,7 +981,14 @@ namespace ov
 
 	bool String::Release() noexcept
 	{
-		OV_SAFE_FREE(_buffer);
+		if(IsInline())
+		{
+			_buffer = nullptr;
+		}
+		else
+		{
+			OV_SAFE_FREE(_buffer);
+		}
 
 		_capacity = 0L;
 		_length = 0L;
@@ -16,8 +16,14 @@
 #include <cstring>
 #include <memory>
 #include <map>
+#include <string_view>
+#include <functional>
 #include <vector>
 
+// The strings up to this length are stored in the String itself without heap allocation
+// (sizeof(ov::String) is 64 bytes, a cache line)
+#define OV_STRING_INLINE_CAPACITY 39
+
 namespace ov
 {
 	class Data;
@@ -44,6 +50,7 @@ namespace ov
 
 		// 문자열 조작 API
 		String &operator =(const String &buffer) noexcept;
+		String &operator =(String &&buffer) noexcept;
 		String &operator =(const char *buffer) noexcept;
 		const String &operator +=(const char *buffer) noexcept;
 		String operator +(const String &other) noexcept;
@@ -64,6 +71,21 @@ namespace ov
 
 		static String FormatString(const char *format, ...);
 
+		// Formats into the buffer of the caller (such as a stack buffer) without allocation.
+		// Returns the length of the formatted string, and the result is truncated if it is greater than or equal to buffer_length
+		static size_t FormatTo(char *buffer, size_t buffer_length, const char *format, ...);
+		template <size_t N>
+		static size_t FormatTo(char (&buffer)[N], const char *format, ...)
+		{
+			va_list list;
+
+			va_start(list, format);
+			int result = ::vsnprintf(buffer, N, format, list);
+			va_end(list);
+
+			return (result > 0) ? static_cast<size_t>(result) : 0;
+		}
+
 		off_t IndexOf(char c, off_t start_position = 0) const noexcept;
 		off_t IndexOf(const char *str, off_t start_position = 0) const noexcept;
 		// start_position 부터 시작해서 0번째 글자까지 탐색함. -1일 경우 문자열 길이로 대체
@@ -128,11 +150,23 @@ namespace ov
 
 		std::shared_ptr<Data> ToData(bool include_null_char = true) const;
 
+		// A non-owning view, which is valid until the string is modified or destroyed
+		inline std::string_view ToStringView() const noexcept
+		{
+			return std::string_view(CStr(), _length);
+		}
+
 	protected:
 		bool Alloc(size_t length, bool alloc_exactly = false) noexcept;
 		bool Release() noexcept;
 
+		inline bool IsInline() const noexcept
+		{
+			return _buffer == _inline_buffer;
+		}
+
 	private:
+		// Points _inline_buffer or the heap memory (nullptr if nothing is allocated)
 		char *_buffer = nullptr;
 
 		// 실제 데이터가 있는 길이
@@ -140,6 +174,8 @@ namespace ov
 
 		// 거의 지수 형태로 증가함
 		size_t _capacity = 0;
+
+		char _inline_buffer[OV_STRING_INLINE_CAPACITY + 1];
 	};
 
 	struct CaseInsensitiveComparator
@@ -150,3 +186,15 @@ namespace ov
 		}
 	};
 }
+
+namespace std
+{
+	template <>
+	struct hash<ov::String>
+	{
+		size_t operator()(const ov::String &str) const noexcept
+		{
+			return hash<string_view>()(str.ToStringView());
+		}
+	};
+}  // namespace std
@@ -0,0 +1,257 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "thread_class.h"
+
+#include <strings.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+
+#include "./platform.h"
+#include "./thread_registry.h"
+
+#if IS_LINUX
+#	include <sched.h>
+#endif
+
+#define THREAD_CLASS_ISOLATED_CPU_PATH "/sys/devices/system/cpu/isolated"
+
+namespace ov
+{
+	struct ThreadClassesData
+	{
+		std::mutex mutex;
+		std::array<ThreadPolicy, static_cast<size_t>(ThreadClass::Count)> policies;
+		// The policy uses the processors that are isolated from the scheduler
+		std::array<bool, static_cast<size_t>(ThreadClass::Count)> is_isolated{};
+		// The processor to pin the next thread of the class to (if it is isolated)
+		std::array<size_t, static_cast<size_t>(ThreadClass::Count)> next_processor_index{};
+#if IS_LINUX
+		// The processors that the process is allowed to run on (the threads of the classes without processors run on them)
+		cpu_set_t initial_cpu_set;
+		bool has_initial_cpu_set = false;
+#endif
+
+		// Nothing is applied until a policy is set
+		std::atomic<bool> is_configured{false};
+	};
+
+	static ThreadClassesData &GetThreadClassesData()
+	{
+		// Never destroyed, because the threads may be terminated after the static objects are destroyed
+		static auto data = new ThreadClassesData();
+		return *data;
+	}
+
+	// The processors that are excluded from the scheduler by isolcpus, it is read once
+	static const std::vector<int> &GetIsolatedProcessors()
+	{
+		static const std::vector<int> processors = []() {
+			std::ifstream file(THREAD_CLASS_ISOLATED_CPU_PATH);
+			std::string processor_list;
+
+			if (std::getline(file, processor_list))
+			{
+				return Platform::ParseProcessorList(processor_list);
+			}
+
+			return std::vector<int>();
+		}();
+
+		return processors;
+	}
+
+	const char *ThreadClasses::StringFromThreadClass(ThreadClass thread_class)
+	{
+		switch (thread_class)
+		{
+			case ThreadClass::NetworkIo:
+				return "NetworkIO";
+			case ThreadClass::Media:
+				return "Media";
+			case ThreadClass::Encode:
+				return "Encode";
+			case ThreadClass::Background:
+				return "Background";
+			case ThreadClass::Count:
+				break;
+		}
+
+		return "Unknown";
+	}
+
+	const char *ThreadClasses::StringFromScheduler(ThreadPolicy::Scheduler scheduler)
+	{
+		switch (scheduler)
+		{
+			case ThreadPolicy::Scheduler::Other:
+				return "Other";
+			case ThreadPolicy::Scheduler::Fifo:
+				return "FIFO";
+			case ThreadPolicy::Scheduler::RoundRobin:
+				return "RR";
+		}
+
+		return "Unknown";
+	}
+
+	bool ThreadClasses::ParseScheduler(const char *name, ThreadPolicy::Scheduler *scheduler)
+	{
+		if (::strcasecmp(name, "other") == 0)
+		{
+			*scheduler = ThreadPolicy::Scheduler::Other;
+		}
+		else if (::strcasecmp(name, "fifo") == 0)
+		{
+			*scheduler = ThreadPolicy::Scheduler::Fifo;
+		}
+		else if (::strcasecmp(name, "rr") == 0)
+		{
+			*scheduler = ThreadPolicy::Scheduler::RoundRobin;
+		}
+		else
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ThreadClasses::SetPolicy(ThreadClass thread_class, const ThreadPolicy &policy)
+	{
+		auto &data = GetThreadClassesData();
+		auto index = static_cast<size_t>(thread_class);
+
+		if (index >= data.policies.size())
+		{
+			return false;
+		}
+
+		{
+			auto lock_guard = std::lock_guard(data.mutex);
+
+			auto &isolated_processors = GetIsolatedProcessors();
+
+#if IS_LINUX
+			if (data.has_initial_cpu_set == false)
+			{
+				data.has_initial_cpu_set = (::sched_getaffinity(0, sizeof(data.initial_cpu_set), &data.initial_cpu_set) == 0);
+			}
+#endif
+
+			data.policies[index] = policy;
+			data.is_isolated[index] = std::any_of(policy.processors.begin(), policy.processors.end(), [&](int processor) {
+				return std::find(isolated_processors.begin(), isolated_processors.end(), processor) != isolated_processors.end();
+			});
+			data.next_processor_index[index] = 0;
+		}
+
+		data.is_configured = true;
+
+		bool result = true;
+
+		ThreadRegistry::ForEach([&](const ThreadMetrics &thread_metrics) {
+			if (thread_metrics.GetThreadClass() == thread_class)
+			{
+				result = Apply(thread_class, thread_metrics.GetThreadId()) && result;
+			}
+		});
+
+		return result;
+	}
+
+	bool ThreadClasses::Apply(ThreadClass thread_class, pid_t thread_id)
+	{
+#if IS_LINUX
+		auto &data = GetThreadClassesData();
+		auto index = static_cast<size_t>(thread_class);
+
+		if ((data.is_configured == false) || (index >= data.policies.size()))
+		{
+			return true;
+		}
+
+		ThreadPolicy policy;
+		int pinned_processor = -1;
+		cpu_set_t cpu_set;
+		bool has_cpu_set = false;
+
+		{
+			auto lock_guard = std::lock_guard(data.mutex);
+
+			policy = data.policies[index];
+
+			if (data.has_initial_cpu_set)
+			{
+				cpu_set = data.initial_cpu_set;
+				has_cpu_set = true;
+			}
+
+			if (data.is_isolated[index] && (policy.processors.empty() == false))
+			{
+				pinned_processor = policy.processors[data.next_processor_index[index] % policy.processors.size()];
+				data.next_processor_index[index]++;
+			}
+		}
+
+		// The policy is applied even if it is the default, because a thread inherits the policy of the thread that created it
+		bool result = true;
+
+		if (policy.processors.empty() == false)
+		{
+			has_cpu_set = true;
+			CPU_ZERO(&cpu_set);
+
+			if (pinned_processor >= 0)
+			{
+				CPU_SET(pinned_processor, &cpu_set);
+			}
+			else
+			{
+				for (auto processor : policy.processors)
+				{
+					CPU_SET(processor, &cpu_set);
+				}
+			}
+		}
+
+		if (has_cpu_set)
+		{
+			result = (::sched_setaffinity(thread_id, sizeof(cpu_set), &cpu_set) == 0) && result;
+		}
+
+		struct sched_param param
+		{
+		};
+
+		switch (policy.scheduler)
+		{
+			case ThreadPolicy::Scheduler::Other:
+				result = (::sched_setscheduler(thread_id, SCHED_OTHER, &param) == 0) && result;
+				// The nice value is per thread on Linux
+				result = (::setpriority(PRIO_PROCESS, static_cast<id_t>(thread_id), policy.nice) == 0) && result;
+				break;
+
+			case ThreadPolicy::Scheduler::Fifo:
+			case ThreadPolicy::Scheduler::RoundRobin:
+				param.sched_priority = std::clamp(policy.priority, 1, 99);
+				result = (::sched_setscheduler(thread_id, (policy.scheduler == ThreadPolicy::Scheduler::Fifo) ? SCHED_FIFO : SCHED_RR, &param) == 0) && result;
+				break;
+		}
+
+		return result;
+#else
+		return true;
+#endif
+	}
+}  // namespace ov
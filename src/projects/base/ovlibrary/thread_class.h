@@ -0,0 +1,83 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace ov
+{
+	// The kind of work that a thread does, the threads of a class share the scheduling policy (See ov::ThreadClasses)
+	enum class ThreadClass : uint8_t
+	{
+		// Sends and receives the packets (socket workers, DTLS, RTP pacing, OVT connections)
+		NetworkIo,
+		// Moves the media between the modules (providers, MediaRouter, decoders/filters, publishers)
+		Media,
+		// Encodes the media
+		Encode,
+		// Everything that is not time-critical (logging, timers, DelayQueue, subscriptions, collectors)
+		Background,
+
+		Count
+	};
+
+	struct ThreadPolicy
+	{
+		enum class Scheduler : uint8_t
+		{
+			// SCHED_OTHER
+			Other,
+			// SCHED_FIFO
+			Fifo,
+			// SCHED_RR
+			RoundRobin
+		};
+
+		// The processors that the threads run on (empty: all the processors)
+		std::vector<int> processors;
+		Scheduler scheduler = Scheduler::Other;
+		// The real-time priority (1~99) of Scheduler::Fifo/RoundRobin
+		int priority = 0;
+		// The nice value (-20~19) of Scheduler::Other
+		int nice = 0;
+
+		bool IsDefault() const
+		{
+			return processors.empty() && (scheduler == Scheduler::Other) && (nice == 0);
+		}
+	};
+
+	// The scheduling policies of the thread classes (<Performance><ThreadClasses>)
+	//
+	// A thread gets the policy of its class when it creates its ov::ThreadMetrics, so the background work
+	// doesn't preempt the packet delivery and the transcoding. If the processors of a class are isolated from
+	// the scheduler (isolcpus), the kernel doesn't move the threads between them, so each thread of the class
+	// is pinned to one of them in turn instead of being allowed to run on all of them.
+	//
+	// Real-time schedulers and negative nice values need CAP_SYS_NICE (or RLIMIT_RTPRIO/RLIMIT_NICE).
+	class ThreadClasses
+	{
+	public:
+		static const char *StringFromThreadClass(ThreadClass thread_class);
+		static const char *StringFromScheduler(ThreadPolicy::Scheduler scheduler);
+		// other, fifo or rr (case-insensitive)
+		static bool ParseScheduler(const char *name, ThreadPolicy::Scheduler *scheduler);
+
+		// Also applied to the threads of the class that are running. Once a policy is set, the threads of all the classes
+		// get the policy of their class (the default policy if it is not set), not the one inherited from the thread that created them.
+		// Returns false if the policy could not be applied to some of them
+		static bool SetPolicy(ThreadClass thread_class, const ThreadPolicy &policy);
+
+		// Applies the policy of the class to the thread (thread_id: the ID of the thread in the kernel, See ThreadMetrics::GetThreadId())
+		static bool Apply(ThreadClass thread_class, pid_t thread_id);
+	};
+}  // namespace ov
@@ -0,0 +1,108 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "thread_registry.h"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace ov
+{
+	struct ThreadRegistryData
+	{
+		std::mutex mutex;
+		std::set<const ThreadMetrics *> threads;
+	};
+
+	static ThreadRegistryData &GetThreadRegistryData()
+	{
+		// Never destroyed, because the threads may be terminated after the static objects are destroyed
+		static auto data = new ThreadRegistryData();
+		return *data;
+	}
+
+	ThreadMetrics::ThreadMetrics(const char *name, ThreadClass thread_class)
+		: _name(name),
+		  _thread_class(thread_class)
+	{
+		// The name of a thread is limited to 16 bytes including the null terminator
+		char thread_name[16]{};
+		::strncpy(thread_name, name, sizeof(thread_name) - 1);
+		::pthread_setname_np(::pthread_self(), thread_name);
+
+		_thread_id = static_cast<pid_t>(::syscall(SYS_gettid));
+		_is_cpu_clock_available = (::pthread_getcpuclockid(::pthread_self(), &_cpu_clock_id) == 0);
+		_start_usec = GetNowUsec();
+
+		ThreadClasses::Apply(_thread_class, _thread_id);
+
+		ThreadRegistry::Register(this);
+	}
+
+	ThreadMetrics::~ThreadMetrics()
+	{
+		ThreadRegistry::Unregister(this);
+	}
+
+	int64_t ThreadMetrics::GetCpuTimeUsec() const
+	{
+		struct timespec cpu_time
+		{
+		};
+
+		if ((_is_cpu_clock_available == false) || (::clock_gettime(_cpu_clock_id, &cpu_time) != 0))
+		{
+			return 0;
+		}
+
+		return (static_cast<int64_t>(cpu_time.tv_sec) * 1000000LL) + (cpu_time.tv_nsec / 1000LL);
+	}
+
+	int64_t ThreadMetrics::GetIdleTimeUsec() const
+	{
+		auto idle_usec = _idle_usec.load(std::memory_order_relaxed);
+		auto idle_start_usec = _idle_start_usec.load(std::memory_order_relaxed);
+
+		if (idle_start_usec > 0)
+		{
+			idle_usec += std::max<int64_t>(GetNowUsec() - idle_start_usec, 0);
+		}
+
+		return idle_usec;
+	}
+
+	void ThreadRegistry::Register(const ThreadMetrics *thread_metrics)
+	{
+		auto &data = GetThreadRegistryData();
+		auto lock_guard = std::lock_guard(data.mutex);
+
+		data.threads.insert(thread_metrics);
+	}
+
+	void ThreadRegistry::Unregister(const ThreadMetrics *thread_metrics)
+	{
+		auto &data = GetThreadRegistryData();
+		auto lock_guard = std::lock_guard(data.mutex);
+
+		data.threads.erase(thread_metrics);
+	}
+
+	void ThreadRegistry::ForEach(const std::function<void(const ThreadMetrics &thread_metrics)> &callback)
+	{
+		auto &data = GetThreadRegistryData();
+		auto lock_guard = std::lock_guard(data.mutex);
+
+		for (auto thread_metrics : data.threads)
+		{
+			callback(*thread_metrics);
+		}
+	}
+}  // namespace ov
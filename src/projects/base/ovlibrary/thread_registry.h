@@ -0,0 +1,126 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <sys/types.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+
+#include "./string.h"
+#include "./thread_class.h"
+
+namespace ov
+{
+	// The statistics of a worker thread, it is registered to ThreadRegistry while the thread is running
+	//
+	// Usage (in the thread function):
+	//     ov::ThreadMetrics thread_metrics("StreamWorker", ov::ThreadClass::Media);
+	//
+	//     while (running)
+	//     {
+	//         thread_metrics.BeginIdle();
+	//         auto item = queue.Dequeue();
+	//         thread_metrics.EndIdle();
+	//
+	//         thread_metrics.CountLoop();
+	//         ...
+	//     }
+	class ThreadMetrics
+	{
+	public:
+		// Must be created by the thread itself, the name is also set as the name of the thread
+		// (Only the first 15 characters are shown by top -H or ps -T)
+		// thread_class: The scheduling policy of the class is applied to the thread (See ov::ThreadClasses)
+		ThreadMetrics(const char *name, ThreadClass thread_class);
+		~ThreadMetrics();
+
+		void CountLoop()
+		{
+			_loop_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// The time between BeginIdle() and EndIdle() is counted as idle (waiting for the queue/event)
+		void BeginIdle()
+		{
+			_idle_start_usec.store(GetNowUsec(), std::memory_order_relaxed);
+		}
+
+		void EndIdle()
+		{
+			auto idle_start_usec = _idle_start_usec.exchange(0, std::memory_order_relaxed);
+
+			if (idle_start_usec > 0)
+			{
+				_idle_usec.fetch_add(GetNowUsec() - idle_start_usec, std::memory_order_relaxed);
+			}
+		}
+
+		const String &GetName() const
+		{
+			return _name;
+		}
+
+		pid_t GetThreadId() const
+		{
+			return _thread_id;
+		}
+
+		ThreadClass GetThreadClass() const
+		{
+			return _thread_class;
+		}
+
+		// The CPU time consumed by the thread (CLOCK_THREAD_CPUTIME_ID of the thread)
+		int64_t GetCpuTimeUsec() const;
+		uint64_t GetLoopCount() const
+		{
+			return _loop_count.load(std::memory_order_relaxed);
+		}
+		// Including the current idle time if the thread is idle now
+		int64_t GetIdleTimeUsec() const;
+		int64_t GetUptimeUsec() const
+		{
+			return GetNowUsec() - _start_usec;
+		}
+
+	private:
+		static int64_t GetNowUsec()
+		{
+			return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		String _name;
+		ThreadClass _thread_class;
+		pid_t _thread_id = 0;
+		clockid_t _cpu_clock_id;
+		bool _is_cpu_clock_available = false;
+
+		int64_t _start_usec = 0;
+
+		std::atomic<uint64_t> _loop_count{0};
+		// 0 if the thread is not idle
+		std::atomic<int64_t> _idle_start_usec{0};
+		std::atomic<int64_t> _idle_usec{0};
+	};
+
+	// All running ThreadMetrics, so the statistics of the threads can be exported without knowing the owners
+	class ThreadRegistry
+	{
+	public:
+		static void Register(const ThreadMetrics *thread_metrics);
+		static void Unregister(const ThreadMetrics *thread_metrics);
+
+		// The threads are not terminated while the callback is called
+		static void ForEach(const std::function<void(const ThreadMetrics &thread_metrics)> &callback);
+	};
+}  // namespace ov
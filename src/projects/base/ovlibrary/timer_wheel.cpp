@@ -0,0 +1,277 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "./timer_wheel.h"
+#include "./log.h"
+#include "./ovlibrary_private.h"
+#include "./thread_registry.h"
+
+namespace ov
+{
+	TimerWheel::TimerWheel(int tick_ms)
+		: _tick_ms(std::max(tick_ms, 1)),
+		  _start_time(std::chrono::steady_clock::now())
+	{
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+		Stop();
+	}
+
+	int64_t TimerWheel::GetElapsedTicks() const
+	{
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _start_time).count();
+
+		return elapsed / _tick_ms;
+	}
+
+	TimerHandle TimerWheel::Push(const DelayQueueFunction &func, void *parameter, int after)
+	{
+		auto timer = std::make_shared<Timer>();
+
+		timer->function = func;
+		timer->parameter = parameter;
+		// Round up, and at least 1 tick
+		timer->interval_ticks = std::max((static_cast<int64_t>(after) + _tick_ms - 1) / _tick_ms, static_cast<int64_t>(1));
+
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		timer->handle = ++_last_handle;
+		timer->expire_tick = _current_tick + timer->interval_ticks;
+
+		_timers[timer->handle] = timer;
+		Schedule(timer);
+
+		return timer->handle;
+	}
+
+	TimerHandle TimerWheel::Push(const DelayQueueFunction &func, int after)
+	{
+		return Push(func, nullptr, after);
+	}
+
+	bool TimerWheel::Cancel(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto item = _timers.find(handle);
+
+		if (item == _timers.end())
+		{
+			return false;
+		}
+
+		auto &timer = item->second;
+
+		// If the timer is running, it is not repeated
+		timer->is_cancelled = true;
+		Unschedule(timer);
+
+		_timers.erase(item);
+
+		return true;
+	}
+
+	ssize_t TimerWheel::GetCount() const
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _timers.size();
+	}
+
+	void TimerWheel::Schedule(const std::shared_ptr<Timer> &timer)
+	{
+		constexpr int64_t max_delta = (1LL << (OV_TIMER_WHEEL_LEVEL_COUNT * OV_TIMER_WHEEL_SLOT_BITS)) - 1;
+
+		auto delta = timer->expire_tick - _current_tick;
+		int64_t slot_index_tick = timer->expire_tick;
+
+		if (delta < 0)
+		{
+			// Already expired: it is expired at the next tick
+			delta = 1;
+			slot_index_tick = _current_tick + 1;
+		}
+		else if (delta > max_delta)
+		{
+			// Too far: put it on the farthest slot, it will be scheduled again when the slot is cascaded
+			delta = max_delta;
+			slot_index_tick = _current_tick + max_delta;
+		}
+
+		// The timers of the current tick (delta == 0) are put on the slot that Advance() is about to process
+		int level = 0;
+
+		while ((level < (OV_TIMER_WHEEL_LEVEL_COUNT - 1)) && (delta >= (1LL << ((level + 1) * OV_TIMER_WHEEL_SLOT_BITS))))
+		{
+			level++;
+		}
+
+		auto slot_index = (slot_index_tick >> (level * OV_TIMER_WHEEL_SLOT_BITS)) & (OV_TIMER_WHEEL_SLOT_COUNT - 1);
+		auto &slot = _slots[level][slot_index];
+
+		timer->slot = &slot;
+		timer->position = slot.insert(slot.end(), timer);
+		timer->is_scheduled = true;
+	}
+
+	void TimerWheel::Unschedule(const std::shared_ptr<Timer> &timer)
+	{
+		if (timer->is_scheduled)
+		{
+			timer->slot->erase(timer->position);
+			timer->slot = nullptr;
+			timer->is_scheduled = false;
+		}
+	}
+
+	void TimerWheel::Cascade(int level)
+	{
+		auto slot_index = (_current_tick >> (level * OV_TIMER_WHEEL_SLOT_BITS)) & (OV_TIMER_WHEEL_SLOT_COUNT - 1);
+
+		// Move the timers to the lower levels
+		Slot slot;
+		slot.swap(_slots[level][slot_index]);
+
+		for (auto &timer : slot)
+		{
+			timer->is_scheduled = false;
+			Schedule(timer);
+		}
+	}
+
+	void TimerWheel::Advance(std::vector<std::shared_ptr<Timer>> *expired_timers)
+	{
+		_current_tick++;
+
+		// When a level wraps around, the next slot of the upper level is spread to the lower levels
+		for (int level = 1; level < OV_TIMER_WHEEL_LEVEL_COUNT; level++)
+		{
+			auto mask = (1LL << (level * OV_TIMER_WHEEL_SLOT_BITS)) - 1;
+
+			if ((_current_tick & mask) != 0)
+			{
+				break;
+			}
+
+			Cascade(level);
+		}
+
+		auto &slot = _slots[0][_current_tick & (OV_TIMER_WHEEL_SLOT_COUNT - 1)];
+
+		while (slot.empty() == false)
+		{
+			auto timer = slot.front();
+
+			slot.pop_front();
+			timer->is_scheduled = false;
+
+			if (timer->expire_tick > _current_tick)
+			{
+				// Not yet (the timers that were too far to be placed exactly)
+				Schedule(timer);
+				continue;
+			}
+
+			expired_timers->push_back(timer);
+		}
+	}
+
+	bool TimerWheel::Start()
+	{
+		if (_stop == false)
+		{
+			// 이미 실행 중
+			return false;
+		}
+
+		_stop = false;
+		_thread = std::thread(std::bind(&TimerWheel::DispatchThreadProc, this));
+
+		return true;
+	}
+
+	bool TimerWheel::Stop()
+	{
+		if (_stop)
+		{
+			// 이미 중지됨
+			return false;
+		}
+
+		_stop = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+
+		return true;
+	}
+
+	void TimerWheel::DispatchThreadProc()
+	{
+		ThreadMetrics thread_metrics("TimerWheel", ThreadClass::Background);
+
+		std::vector<std::shared_ptr<Timer>> expired_timers;
+		std::vector<DelayQueueAction> actions;
+
+		while (_stop == false)
+		{
+			auto elapsed_ticks = GetElapsedTicks();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				// If the thread was delayed, all missed ticks are processed at once
+				while (_current_tick < elapsed_ticks)
+				{
+					Advance(&expired_timers);
+				}
+			}
+
+			if (expired_timers.empty() == false)
+			{
+				actions.clear();
+
+				for (auto &timer : expired_timers)
+				{
+					// The timer might be cancelled by the previous callback
+					actions.push_back(timer->is_cancelled ? DelayQueueAction::Stop : timer->function(timer->parameter));
+				}
+
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				for (size_t index = 0; index < expired_timers.size(); index++)
+				{
+					auto &timer = expired_timers[index];
+
+					if (timer->is_cancelled)
+					{
+						continue;
+					}
+
+					if (actions[index] == DelayQueueAction::Repeat)
+					{
+						timer->expire_tick = _current_tick + timer->interval_ticks;
+						Schedule(timer);
+					}
+					else
+					{
+						_timers.erase(timer->handle);
+					}
+				}
+
+				expired_timers.clear();
+			}
+
+			std::this_thread::sleep_until(_start_time + std::chrono::milliseconds((elapsed_ticks + 1) * _tick_ms));
+		}
+	}
+}  // namespace ov
@@ -0,0 +1,106 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "delay_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// The number of the slots of each level (must be the power of 2)
+#define OV_TIMER_WHEEL_SLOT_BITS 6
+#define OV_TIMER_WHEEL_SLOT_COUNT (1 << OV_TIMER_WHEEL_SLOT_BITS)
+// 4 levels of 64 slots can hold the timers up to 64^4 ticks (46 hours with 10ms tick), the longer timers are cascaded again
+#define OV_TIMER_WHEEL_LEVEL_COUNT 4
+
+namespace ov
+{
+	// 0 is not a valid handle
+	typedef uint64_t TimerHandle;
+
+	// Hierarchical timer wheel (Varghese & Lauck): O(1) insert/cancel, and the timers of the same tick are expired together.
+	// The callbacks are called by the dispatch thread without the lock, so they can push or cancel timers.
+	//
+	// It has the same callback interface as DelayQueue, and the timers can be cancelled with the handle returned by Push().
+	class TimerWheel
+	{
+	public:
+		// tick_ms: resolution of the timers
+		explicit TimerWheel(int tick_ms = 10);
+		virtual ~TimerWheel();
+
+		// after의 단위는 ms
+		// If the function returns DelayQueueAction::Repeat, it is called again after the same interval
+		TimerHandle Push(const DelayQueueFunction &func, void *parameter, int after);
+		TimerHandle Push(const DelayQueueFunction &func, int after);
+
+		// Returns false if the timer is already expired (and not repeated) or cancelled
+		bool Cancel(TimerHandle handle);
+
+		ssize_t GetCount() const;
+
+		bool Start();
+		bool Stop();
+
+	protected:
+		struct Timer;
+		typedef std::list<std::shared_ptr<Timer>> Slot;
+
+		struct Timer
+		{
+			TimerHandle handle = 0;
+
+			DelayQueueFunction function;
+			void *parameter = nullptr;
+			int64_t interval_ticks = 0;
+
+			int64_t expire_tick = 0;
+
+			// Position in the wheel (valid only if is_scheduled is true)
+			bool is_scheduled = false;
+			Slot *slot = nullptr;
+			Slot::iterator position;
+
+			// Read by the dispatch thread without the lock while the callbacks are called
+			std::atomic<bool> is_cancelled{false};
+		};
+
+		int64_t GetElapsedTicks() const;
+
+		// Called with the lock
+		void Schedule(const std::shared_ptr<Timer> &timer);
+		void Unschedule(const std::shared_ptr<Timer> &timer);
+		void Cascade(int level);
+		void Advance(std::vector<std::shared_ptr<Timer>> *expired_timers);
+
+		void DispatchThreadProc();
+
+		int _tick_ms;
+		std::chrono::steady_clock::time_point _start_time;
+
+		mutable std::mutex _mutex;
+
+		// The last processed tick
+		int64_t _current_tick = 0;
+		Slot _slots[OV_TIMER_WHEEL_LEVEL_COUNT][OV_TIMER_WHEEL_SLOT_COUNT];
+
+		TimerHandle _last_handle = 0;
+		// Scheduled (or running) timers
+		std::unordered_map<TimerHandle, std::shared_ptr<Timer>> _timers;
+
+		std::thread _thread;
+		volatile bool _stop = true;
+	};
+}  // namespace ov
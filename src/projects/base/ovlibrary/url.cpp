@@ -8,7 +8,10 @@
 //==============================================================================
 #include "url.h"
 #include <base/ovlibrary/converter.h>
-#include <regex>
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
 
 namespace ov
 {
@@ -102,35 +105,80 @@ namespace ov
 			result_index++;
 		}
 
+		result_string.SetLength(result_index);
+
 		return result_string;
 	}
 
 	std::shared_ptr<const Url> Url::Parse(const std::string &url, bool make_query_map)
 	{
 		auto object = std::make_shared<Url>();
-		std::smatch matches;
 
 		object->_source = url.c_str();
 
 		// <scheme>://<domain>[:<port>][/<path/to/resource>][?<query string>]
-		// Group 1: <scheme>
-		// Group 2: <domain>
-		// Group 3: :<port>
-		// Group 4: <port>
-		// Group 5: /<path>
-		// Group 6: <path>
-		// Group 7: ?<query string>
-		// Group 8: <query string>
-		if (std::regex_search(url, matches, std::regex(R"((.+?)://([^:/]+)(:([0-9]+))?(/([^\?]+)?)?(\?([^\?]+)?(.+)?)?)")) == false)
+		//
+		// This was parsed with std::regex, which is compiled for every call and allocates for every group,
+		// so the components are sliced from the string_view instead (the rules are the same as the regex:
+		// (.+?)://([^:/]+)(:([0-9]+))?(/([^\?]+)?)?(\?([^\?]+)?(.+)?)?)
+		std::string_view rest(url);
+
+		auto scheme_end = rest.find("://");
+
+		if ((scheme_end == std::string_view::npos) || (scheme_end == 0))
 		{
 			return nullptr;
 		}
 
-		object->_scheme = std::string(matches[1]).c_str();
-		object->_domain = std::string(matches[2]).c_str();
-		object->_port = ov::Converter::ToUInt32(std::string(matches[4]).c_str());
-		object->_path = std::string(matches[5]).c_str();
-		object->_query_string = std::string(matches[8]).c_str();
+		auto scheme = rest.substr(0, scheme_end);
+		rest.remove_prefix(scheme_end + 3);
+
+		auto domain_end = std::min(rest.find_first_of(":/"), rest.size());
+
+		if (domain_end == 0)
+		{
+			return nullptr;
+		}
+
+		auto domain = rest.substr(0, domain_end);
+		rest.remove_prefix(domain_end);
+
+		std::string_view port;
+		std::string_view path;
+		std::string_view query_string;
+
+		if ((rest.size() >= 2) && (rest[0] == ':') && ::isdigit(rest[1]))
+		{
+			size_t port_end = 1;
+
+			while ((port_end < rest.size()) && ::isdigit(rest[port_end]))
+			{
+				port_end++;
+			}
+
+			port = rest.substr(1, port_end - 1);
+			rest.remove_prefix(port_end);
+		}
+
+		if ((rest.empty() == false) && (rest[0] == '/'))
+		{
+			auto path_end = std::min(rest.find('?'), rest.size());
+
+			path = rest.substr(0, path_end);
+			rest.remove_prefix(path_end);
+		}
+
+		if ((rest.empty() == false) && (rest[0] == '?'))
+		{
+			rest.remove_prefix(1);
+			query_string = rest.substr(0, std::min(rest.find('?'), rest.size()));
+		}
+
+		object->_scheme = ov::String(scheme.data(), scheme.size());
+		object->_domain = ov::String(domain.data(), domain.size());
+		object->_port = ov::Converter::ToUInt32(ov::String(port.data(), port.size()));
+		object->_path = ov::String(path.data(), path.size());
+		object->_query_string = ov::String(query_string.data(), query_string.size());
 
 		// split <path> to /<app>/<stream>/<file> (4 tokens)
 		auto tokens = object->_path.Split("/");
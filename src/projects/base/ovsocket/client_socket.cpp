@@ -7,205 +7,479 @@
 //
 //==============================================================================
 #include "client_socket.h"
-#include "server_socket.h"
 
+#include <netinet/tcp.h>
+
+#include "server_socket.h"
 #include "socket_private.h"
 
 // If no packet is sent during this time, the connection is disconnected
 #define CLIENT_SOCKET_SEND_TIMEOUT (60 * 1000)
 
+// Default watermarks of the send queue
+#define CLIENT_SOCKET_SEND_QUEUE_LOW_WATERMARK (2 * 1024 * 1024)
+#define CLIENT_SOCKET_SEND_QUEUE_HIGH_WATERMARK (8 * 1024 * 1024)
+
 namespace ov
 {
 	ClientSocket::ClientSocket(ServerSocket *server_socket, SocketWrapper socket, const SocketAddress &remote_address)
 		: Socket(socket, remote_address),
 
-		  _server_socket(server_socket)
+		  _server_socket(server_socket),
+
+		  _low_watermark(CLIENT_SOCKET_SEND_QUEUE_LOW_WATERMARK),
+		  _high_watermark(CLIENT_SOCKET_SEND_QUEUE_HIGH_WATERMARK),
+		  _last_sent_time(std::chrono::steady_clock::now())
 	{
 		OV_ASSERT2(_server_socket != nullptr);
 
 		_local_address = (server_socket != nullptr) ? server_socket->GetLocalAddress() : nullptr;
 
-		// TODO(dimiden): (ClientSocketBlocking) Currently, 1 thread is created per socket, so blocking mode is used until implementing code that handles EAGAIN
-		// MakeNonBlocking();
+		// The data that cannot be sent immediately is queued and sent when EPOLLOUT is raised
+		MakeNonBlocking();
+	}
 
-		ov::String queue_name;
+	ClientSocket::~ClientSocket()
+	{
+	}
 
-		queue_name.Format("ClientSocket #%d %s", socket.GetSocket(), remote_address.ToString().CStr());
+	ssize_t ClientSocket::Send(const std::shared_ptr<const Data> &data)
+	{
+		return SendSlices(&data, 1);
+	}
 
-		if (server_socket != nullptr)
+	ssize_t ClientSocket::Send(const DataChain &chain)
+	{
+		if (chain.IsEmpty())
 		{
-			queue_name.AppendFormat(" (of #%d)", server_socket->GetSocket().GetSocket());
+			return 0LL;
 		}
 
-		_dispatch_queue.SetAlias(queue_name);
+		return SendSlices(chain.GetSlices(), chain.GetSliceCount());
 	}
 
-	ClientSocket::~ClientSocket()
+	ssize_t ClientSocket::SendSlices(const std::shared_ptr<const Data> *data_list, size_t count)
 	{
-		OV_ASSERT(_is_thread_running, "The thread must not be running");
+		size_t length = 0;
+
+		for (size_t index = 0; index < count; index++)
+		{
+			if (data_list[index] == nullptr)
+			{
+				OV_ASSERT2(data_list[index] != nullptr);
+				return -1LL;
+			}
+
+			length += data_list[index]->GetLength();
+		}
 
-		if (_is_thread_running)
+		if (GetType() != SocketType::Tcp)
 		{
-			StopDispatchThread(true);
+			// SRT socket sends the data in the library's own buffer
+			ssize_t total_sent = 0LL;
+
+			for (size_t index = 0; index < count; index++)
+			{
+				auto sent = SendInternal(data_list[index]->GetData(), data_list[index]->GetLength());
+
+				if (sent < 0)
+				{
+					return sent;
+				}
+
+				total_sent += sent;
+			}
+
+			return total_sent;
 		}
+
+		SocketConnectionState disconnect_state = SocketConnectionState::Connected;
+		std::shared_ptr<Error> error;
+
+		{
+			std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+			if (_is_close_requested || (GetState() != SocketState::Connected))
+			{
+				return -1LL;
+			}
+
+			size_t sent_bytes = 0;
+
+			if (_send_queue.empty())
+			{
+				// Nothing is waiting, so try to send the data directly
+				ssize_t result = SendDataList(data_list, count);
+
+				if (result < 0)
+				{
+					logtw("[%p] [#%d] Could not send data", this, _socket.GetSocket());
+					disconnect_state = SocketConnectionState::Error;
+					error = Error::CreateError("Socket", "Could not send data to %s", ToString().CStr());
+				}
+				else
+				{
+					_last_sent_time = std::chrono::steady_clock::now();
+					sent_bytes = static_cast<size_t>(result);
+				}
+			}
+
+			if ((disconnect_state == SocketConnectionState::Connected) && (sent_bytes < length))
+			{
+				auto remained = length - sent_bytes;
+
+				if ((_is_writable == false) || ((_send_queue_size + remained) > _high_watermark))
+				{
+					if (_is_writable)
+					{
+						logtw("[%p] [#%d] The send queue exceeds the high watermark: %zu + %zu > %zu bytes", this, _socket.GetSocket(), _send_queue_size, remained, _high_watermark);
+						_is_writable = false;
+					}
+
+					if (_send_queue_policy == SendQueuePolicy::Disconnect)
+					{
+						disconnect_state = SocketConnectionState::Error;
+						error = Error::CreateError("Socket", "The send queue of %s is full (%zu bytes)", ToString().CStr(), _send_queue_size);
+					}
+					else if (sent_bytes == 0)
+					{
+						// Drop the data (Partially sent data cannot be dropped, or the stream will be corrupted)
+						logtd("[%p] [#%d] %zu bytes are dropped", this, _socket.GetSocket(), length);
+						return 0LL;
+					}
+				}
+
+				if (disconnect_state == SocketConnectionState::Connected)
+				{
+					auto now = std::chrono::steady_clock::now();
+
+					// Queue the buffers that are not sent (the first one might be sent partially)
+					for (size_t index = 0; index < count; index++)
+					{
+						auto &data = data_list[index];
+						auto data_length = data->GetLength();
+
+						if (sent_bytes >= data_length)
+						{
+							sent_bytes -= data_length;
+							continue;
+						}
+
+						_send_queue.push_back({(sent_bytes == 0) ? data : data->Subdata(sent_bytes), now});
+						sent_bytes = 0;
+					}
+
+					_send_queue_size += remained;
+
+					UpdateOutputEvent(true);
+				}
+			}
+		}
+
+		if (disconnect_state != SocketConnectionState::Connected)
+		{
+			// Must be called without holding _send_queue_mutex since the callback may send some data
+			_server_socket->DisconnectClient(GetSharedPtrAs<ClientSocket>(), disconnect_state, error);
+			return -1LL;
+		}
+
+		return length;
 	}
 
-	bool ClientSocket::StartDispatchThread()
+	ssize_t ClientSocket::SendDataList(const std::shared_ptr<const Data> *data_list, size_t count)
 	{
-		if (_is_thread_running)
+		size_t total_sent = 0;
+		size_t index = 0;
+
+		while (index < count)
 		{
-			// Thread is already running
-			OV_ASSERT2(_is_thread_running == false);
-			return false;
-		}
+			auto &data = data_list[index];
+			auto length = data->GetLength();
+			ssize_t sent;
 
-		_is_thread_running = true;
-		_force_stop = false;
+			if (data->GetFileDescriptor() >= 0)
+			{
+				sent = SendFileInternal(data->GetFileDescriptor(), data->GetFileOffset(), length);
+				index++;
+			}
+			else
+			{
+				// Gather the memory buffers until the next file
+				size_t memory_count = 1;
+
+				while (((index + memory_count) < count) && (data_list[index + memory_count]->GetFileDescriptor() < 0))
+				{
+					memory_count++;
+				}
 
-		_send_thread = std::thread(std::bind(&ClientSocket::DispatchThreadStub, this, GetSharedPtrAs<ClientSocket>()));
-		_send_thread.detach();
+				length = 0;
 
-		return true;
+				for (size_t memory_index = index; memory_index < (index + memory_count); memory_index++)
+				{
+					length += data_list[memory_index]->GetLength();
+				}
+
+				sent = SendMemoryList(data_list + index, memory_count);
+				index += memory_count;
+			}
+
+			if (sent < 0)
+			{
+				return sent;
+			}
+
+			total_sent += sent;
+
+			if (static_cast<size_t>(sent) < length)
+			{
+				// The socket buffer is full
+				break;
+			}
+		}
+
+		return total_sent;
 	}
 
-	bool ClientSocket::StopDispatchThread(bool stop_immediately)
+	ssize_t ClientSocket::SendMemoryList(const std::shared_ptr<const Data> *data_list, size_t count)
 	{
-		if (_is_thread_running == false)
+		if (count == 1)
 		{
-			// Thread is not running
-			OV_ASSERT2(_is_thread_running);
-			return false;
+			return SendInternal(data_list[0]->GetData(), data_list[0]->GetLength());
 		}
 
-		// Enqueue close command
-		_dispatch_queue.Enqueue(DispatchCommand::Type::Close);
+		// Gather the buffers into one sendmsg() call
+		struct iovec stack_buffers[8];
+		std::vector<struct iovec> heap_buffers;
+		struct iovec *buffers = stack_buffers;
 
-		if (stop_immediately)
+		if (count > OV_COUNTOF(stack_buffers))
 		{
-			// Signal stop command
-			_force_stop = true;
-			_dispatch_queue.Stop();
+			heap_buffers.resize(count);
+			buffers = heap_buffers.data();
 		}
 
-		return true;
+		for (size_t index = 0; index < count; index++)
+		{
+			buffers[index].iov_base = const_cast<void *>(data_list[index]->GetData());
+			buffers[index].iov_len = data_list[index]->GetLength();
+		}
+
+		return SendInternal(buffers, count);
 	}
 
-	bool ClientSocket::SendAsync(const ClientSocket::DispatchCommand &send_item)
+	ssize_t ClientSocket::Send(const void *data, size_t length)
 	{
-		// An item is dequeued successfully
-		auto data = send_item.data->GetDataAs<uint8_t>();
-		auto remained = send_item.data->GetLength();
-		size_t total_sent_bytes = 0ULL;
+		// TODO(dimiden): Consider sending a copy and storing it as a deep copy only if it fails to send
+		return Send(std::make_shared<const ov::Data>(data, length));
+	}
 
-		while (_force_stop == false)
+	ssize_t ClientSocket::Send(const ov::String &string, bool include_null_char)
+	{
+		return Send(string.ToData(include_null_char));
+	}
+
+	bool ClientSocket::FlushSendQueue()
+	{
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		while (_send_queue.empty() == false)
 		{
-			// Wait for transmission up to CLIENT_SOCKET_SEND_TIMEOUT
-			// TODO(dimiden): (ClientSocketBlocking) Temporarily comment while processing as blocking
-			// if (send_item.IsExpired(CLIENT_SOCKET_SEND_TIMEOUT))
-			// {
-			// 	logtw("[%p] [#%d] Expired (%zu bytes sent)", this, _socket.GetSocket(), total_sent_bytes);
-			// 	return false;
-			// }
+			auto &data = _send_queue.front().data;
+			auto remained = data->GetLength() - _send_queue_offset;
 
-			auto sent_bytes = SendInternal(data, remained);
+			auto sent_bytes = (data->GetFileDescriptor() >= 0)
+								  ? SendFileInternal(data->GetFileDescriptor(), data->GetFileOffset() + _send_queue_offset, remained)
+								  : SendInternal(data->GetDataAs<uint8_t>() + _send_queue_offset, remained);
 
 			if (sent_bytes < 0)
 			{
-				// An error occurred
-				logtw("[%p] [#%d] Could not send data (%zu bytes sent)", this, _socket.GetSocket(), total_sent_bytes);
+				logtw("[%p] [#%d] Could not send data (%zu bytes are in the queue)", this, _socket.GetSocket(), _send_queue_size);
 				return false;
 			}
 
-			OV_ASSERT2(static_cast<ssize_t>(remained) >= sent_bytes);
+			if (sent_bytes > 0)
+			{
+				_last_sent_time = std::chrono::steady_clock::now();
+			}
 
-			remained -= sent_bytes;
-			data += sent_bytes;
-			total_sent_bytes += sent_bytes;
+			_send_queue_offset += sent_bytes;
+			_send_queue_size -= sent_bytes;
 
-			if (remained == 0)
+			if (static_cast<size_t>(sent_bytes) < remained)
 			{
-				// All data are sent
+				// The socket buffer is full - wait for the next EPOLLOUT
 				break;
 			}
+
+			_send_queue.pop_front();
+			_send_queue_offset = 0;
+		}
+
+		if ((_is_writable == false) && (_send_queue_size <= _low_watermark))
+		{
+			logtd("[%p] [#%d] The send queue is drained below the low watermark: %zu bytes", this, _socket.GetSocket(), _send_queue_size);
+			_is_writable = true;
+		}
+
+		if (_send_queue.empty())
+		{
+			UpdateOutputEvent(false);
 		}
 
 		return true;
 	}
 
-	void ClientSocket::DispatchThreadStub(std::shared_ptr<ClientSocket> client_socket)
+	bool ClientSocket::HasPendingData() const
 	{
-		client_socket->DispatchThread();
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		return (_send_queue.empty() == false);
 	}
 
-	void ClientSocket::DispatchThread()
+	bool ClientSocket::RequestCloseAfterFlush()
 	{
-		bool stop = false;
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		_is_close_requested = true;
+
+		return (_send_queue.empty() == false);
+	}
 
-		while (stop == false)
+	bool ClientSocket::IsSendQueueExpired() const
+	{
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		if (_send_queue.empty())
 		{
-			auto item = _dispatch_queue.Dequeue();
+			return false;
+		}
 
-			if (item.has_value() == false)
-			{
-				if (_force_stop)
-				{
-					break;
-				}
+		auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _last_sent_time);
 
-				// Timed out
-				continue;
-			}
+		return (delta.count() >= CLIENT_SOCKET_SEND_TIMEOUT);
+	}
+
+	bool ClientSocket::UpdateOutputEvent(bool wait_for_output)
+	{
+		if (_is_waiting_for_output == wait_for_output)
+		{
+			return true;
+		}
 
-			auto &send_item = item.value();
+		if (_server_socket->ModifyEpoll(this, static_cast<void *>(this), wait_for_output))
+		{
+			_is_waiting_for_output = wait_for_output;
+			return true;
+		}
 
-			switch (send_item.type)
-			{
-				case DispatchCommand::Type::Unknown:
-					OV_ASSERT2(false);
-					break;
+		return false;
+	}
 
-				case DispatchCommand::Type::SendData:
-					if (SendAsync(send_item) == false)
-					{
-						// Item is expired / Could not send data
+	bool ClientSocket::IsWritable() const
+	{
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
 
-						// Disconnect the client
-						stop = true;
-					}
+		return _is_writable;
+	}
 
-					break;
+	void ClientSocket::SetSendQueueWatermarks(size_t low_watermark, size_t high_watermark)
+	{
+		OV_ASSERT2(low_watermark <= high_watermark);
 
-				case DispatchCommand::Type::Close:
-					logtd("[%p] [#%d] Trying to close the socket", this, _socket.GetSocket());
-					stop = true;
-					break;
-			}
-		}
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
 
-		[[maybe_unused]] auto sock = _socket.GetSocket();
+		_low_watermark = std::min(low_watermark, high_watermark);
+		_high_watermark = high_watermark;
+	}
 
-		Socket::CloseInternal();
+	size_t ClientSocket::GetSendQueueLowWatermark() const
+	{
+		return _low_watermark;
+	}
 
-		logtd("[%p] [#%d] Thread is stopped, queue: %zu", this, sock, _dispatch_queue.Size());
+	size_t ClientSocket::GetSendQueueHighWatermark() const
+	{
+		return _high_watermark;
 	}
 
-	ssize_t ClientSocket::Send(const std::shared_ptr<const Data> &data)
+	void ClientSocket::SetSendQueuePolicy(SendQueuePolicy policy)
 	{
-		logtd("[%p] [#%d] Trying to enqueue data: %zu...", this, _socket.GetSocket(), data->GetLength());
-		_dispatch_queue.Enqueue(data);
-		logtd("[%p] [#%d] Enqueued", this, _socket.GetSocket());
-		return data->GetLength();
+		_send_queue_policy = policy;
 	}
 
-	ssize_t ClientSocket::Send(const void *data, size_t length)
+	SendQueuePolicy ClientSocket::GetSendQueuePolicy() const
 	{
-		// TODO(dimiden): Consider sending a copy and storing it as a deep copy only if it fails to send
-		return Send(std::make_shared<const ov::Data>(data, length));
+		return _send_queue_policy;
 	}
 
-	ssize_t ClientSocket::Send(const ov::String &string, bool include_null_char)
+	size_t ClientSocket::GetSendQueueSize() const
 	{
-		return Send(string.ToData(include_null_char));
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		return _send_queue_size;
+	}
+
+	int64_t ClientSocket::GetSendQueueDelay() const
+	{
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		if (_send_queue.empty())
+		{
+			return 0LL;
+		}
+
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _send_queue.front().queued_time).count();
+	}
+
+	bool ClientSocket::SetLowLatencyOptions(const TcpLowLatencyOptions &options)
+	{
+		if ((options.enabled == false) || (GetType() != SocketType::Tcp))
+		{
+			return false;
+		}
+
+		bool result = true;
+
+		if (options.not_sent_low_watermark > 0)
+		{
+#if defined(TCP_NOTSENT_LOWAT)
+			// EPOLLOUT is raised when the unsent bytes of the socket buffer are below this, then FlushSendQueue() fills it again
+			result = SetSockOpt<int>(IPPROTO_TCP, TCP_NOTSENT_LOWAT, options.not_sent_low_watermark) && result;
+#else   // defined(TCP_NOTSENT_LOWAT)
+			logtw("[%p] [#%d] TCP_NOTSENT_LOWAT is not supported on this platform", this, _socket.GetSocket());
+#endif  // defined(TCP_NOTSENT_LOWAT)
+		}
+
+		if (options.max_pacing_rate > 0)
+		{
+#if defined(SO_MAX_PACING_RATE)
+			// The kernel paces the packets (the fq qdisc, or TCP internal pacing since Linux 4.13) instead of sending them in bursts
+			result = SetSockOpt<uint64_t>(SO_MAX_PACING_RATE, static_cast<uint64_t>(options.max_pacing_rate)) && result;
+#else   // defined(SO_MAX_PACING_RATE)
+			logtw("[%p] [#%d] SO_MAX_PACING_RATE is not supported on this platform", this, _socket.GetSocket());
+#endif  // defined(SO_MAX_PACING_RATE)
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_send_queue_mutex);
+			_max_queue_delay = std::max(options.max_queue_delay, 0);
+		}
+
+		return result;
+	}
+
+	bool ClientSocket::IsSendQueueLate() const
+	{
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		if ((_max_queue_delay == 0) || _send_queue.empty())
+		{
+			return false;
+		}
+
+		auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _send_queue.front().queued_time);
+
+		return (delay.count() > _max_queue_delay);
 	}
 
 	bool ClientSocket::Close()
@@ -213,8 +487,7 @@ namespace ov
 		if (GetState() != SocketState::Closed)
 		{
 			// 1) ServerSocket::DisconnectClient();
-			// 2) ClientSocket::CloseInternal();
-			// 3) ClientSocket::StopSendThread();
+			// 2) ClientSocket::CloseInternal(); (after the send queue is flushed)
 			return _server_socket->DisconnectClient(this->GetSharedPtrAs<ClientSocket>(), SocketConnectionState::Disconnect);
 		}
 
@@ -223,8 +496,19 @@ namespace ov
 
 	bool ClientSocket::CloseInternal()
 	{
-		// Socket::CloseInternal() will be called in SendThread() later
-		return StopDispatchThread(false);
+		std::lock_guard<std::mutex> lock(_send_queue_mutex);
+
+		if (_send_queue.empty() == false)
+		{
+			logtd("[%p] [#%d] %zu bytes are discarded", this, _socket.GetSocket(), _send_queue_size);
+		}
+
+		_send_queue.clear();
+		_send_queue_offset = 0;
+		_send_queue_size = 0;
+		_is_waiting_for_output = false;
+
+		return Socket::CloseInternal();
 	}
 
 	String ClientSocket::ToString() const
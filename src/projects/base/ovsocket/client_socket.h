@@ -8,11 +8,26 @@
 //==============================================================================
 #pragma once
 
+#include <deque>
+#include <mutex>
+
 #include "socket.h"
 
 namespace ov
 {
+	// What to do when the data to send exceeds the high watermark of the send queue
+	enum class SendQueuePolicy
+	{
+		// Disconnect the client (default)
+		Disconnect,
+		// Drop the data until the send queue is drained below the low watermark
+		Drop
+	};
+
 	// 일반적으로 사용되는 소켓 (server에서 생성한 client socket)
+	//
+	// Send() never blocks: the data that cannot be written to the kernel is kept in a bounded send queue,
+	// and the queue is drained by the ServerSocket when EPOLLOUT is raised
 	class ClientSocket : public Socket
 	{
 	public:
@@ -25,6 +40,9 @@ namespace ov
 		// 데이터 송신
 		ssize_t Send(const std::shared_ptr<const Data> &data) override;
 		ssize_t Send(const void *data, size_t length) override;
+		// Sends the slices with a single sendmsg() call if possible (the slices backed by a file are sent using sendfile()),
+		// and queues the slices that are not sent without copying them
+		ssize_t Send(const DataChain &chain) override;
 
 		ssize_t Send(const ov::String &string, bool include_null_char = false);
 
@@ -47,61 +65,83 @@ namespace ov
 
 		using Socket::GetState;
 
+		// The ServerSocket that accepted this client
+		ServerSocket *GetServerSocket() const
+		{
+			return _server_socket;
+		}
+
+		// Returns false after the send queue exceeds the high watermark, until it is drained below the low watermark
+		bool IsWritable() const;
+
+		void SetSendQueueWatermarks(size_t low_watermark, size_t high_watermark);
+		size_t GetSendQueueLowWatermark() const;
+		size_t GetSendQueueHighWatermark() const;
+
+		void SetSendQueuePolicy(SendQueuePolicy policy);
+		SendQueuePolicy GetSendQueuePolicy() const;
+
+		// The number of bytes waiting in the send queue
+		size_t GetSendQueueSize() const;
+		// How long the oldest data of the send queue has been waiting (in milliseconds, 0 if the queue is empty)
+		int64_t GetSendQueueDelay() const;
+
+		// Sets TCP_NOTSENT_LOWAT/SO_MAX_PACING_RATE of the socket (it is called by ServerSocket when the client is accepted)
+		bool SetLowLatencyOptions(const TcpLowLatencyOptions &options);
+		// Whether the data of the send queue has waited longer than max_queue_delay of TcpLowLatencyOptions
+		// The sender of a droppable stream (such as CMAF chunks) can skip the data instead of queueing it
+		bool IsSendQueueLate() const;
+
 		String ToString() const override;
 
 	protected:
-		struct DispatchCommand
-		{
-			enum class Type
-			{
-				Unknown,
-				SendData,
-				Close
-			};
-
-			DispatchCommand(const std::shared_ptr<const ov::Data> &data)
-				: type(Type::SendData),
-				  data(data),
-				  enqueued_time(std::chrono::system_clock::now())
-			{
-			}
-
-			DispatchCommand(Type type)
-				: type(type),
-				  enqueued_time(std::chrono::system_clock::now())
-			{
-			}
-
-			bool IsExpired(int millisecond_time) const
-			{
-				auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - enqueued_time);
-
-				return (delta.count() >= millisecond_time);
-			}
-
-			Type type = Type::Unknown;
-			std::shared_ptr<const ov::Data> data;
-			std::chrono::time_point<std::chrono::system_clock> enqueued_time;
-		};
+		// Called by ServerSocket when EPOLLOUT is raised
+		//
+		// @return false if an error occurred
+		bool FlushSendQueue();
+		bool HasPendingData() const;
+		// If there is pending data, marks the socket as closing and returns true (no more data can be sent)
+		// Otherwise, returns false and the socket can be closed immediately
+		bool RequestCloseAfterFlush();
+		// The send queue has not made progress during CLIENT_SOCKET_SEND_TIMEOUT
+		bool IsSendQueueExpired() const;
 
-		bool StartDispatchThread();
-		bool StopDispatchThread(bool stop_immediately);
+		bool CloseInternal() override;
 
-		bool SendAsync(const ClientSocket::DispatchCommand &send_item);
-		void DispatchThreadStub(std::shared_ptr<ClientSocket> client_socket);
-		void DispatchThread();
+		// Must be called while holding _send_queue_mutex
+		bool UpdateOutputEvent(bool wait_for_output);
 
-		bool CloseInternal() override;
+		// Sends the slices and queues the remains
+		ssize_t SendSlices(const std::shared_ptr<const Data> *data_list, size_t count);
+
+		// Sends the buffers without blocking, the buffers backed by a file are sent using sendfile()
+		// (Returns the number of bytes sent before the socket buffer is full)
+		ssize_t SendDataList(const std::shared_ptr<const Data> *data_list, size_t count);
+		ssize_t SendMemoryList(const std::shared_ptr<const Data> *data_list, size_t count);
 
 		ServerSocket *_server_socket = nullptr;
 
-		// TODO(dimiden): If the receiver does not read the data, EAGAIN may occur continuously.
-		//                At this time, it can be blocked, so it creates a thread and processes it.
-		//                I know it's inefficient to use one thread per Socket, and I'll create a send pool later.
-		std::thread _send_thread;
-		ov::Queue<DispatchCommand> _dispatch_queue{nullptr, 100};
-		bool _is_thread_running = false;
+		struct SendQueueItem
+		{
+			std::shared_ptr<const Data> data;
+			std::chrono::time_point<std::chrono::steady_clock> queued_time;
+		};
 
-		std::shared_ptr<ClientSocket> _instance;
+		mutable std::mutex _send_queue_mutex;
+		std::deque<SendQueueItem> _send_queue;
+		// The number of bytes already sent from _send_queue.front()
+		size_t _send_queue_offset = 0;
+		size_t _send_queue_size = 0;
+
+		size_t _low_watermark;
+		size_t _high_watermark;
+		SendQueuePolicy _send_queue_policy = SendQueuePolicy::Disconnect;
+		// In milliseconds (0: never late)
+		int _max_queue_delay = 0;
+
+		bool _is_writable = true;
+		bool _is_close_requested = false;
+		bool _is_waiting_for_output = false;
+		std::chrono::time_point<std::chrono::steady_clock> _last_sent_time;
 	};
 }  // namespace ov
@@ -0,0 +1,97 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "datagram_batch.h"
+#include "socket_private.h"
+
+#include <algorithm>
+
+namespace ov
+{
+	static thread_local DatagramBatch *_current_batch = nullptr;
+
+	DatagramBatch::DatagramBatch(size_t max_pending_count)
+		: _max_pending_count(max_pending_count)
+	{
+		_previous_batch = _current_batch;
+		_current_batch = this;
+	}
+
+	DatagramBatch::~DatagramBatch()
+	{
+		Flush();
+
+		_current_batch = _previous_batch;
+	}
+
+	DatagramBatch *DatagramBatch::GetCurrent()
+	{
+		return _current_batch;
+	}
+
+	bool DatagramBatch::Add(const std::shared_ptr<Socket> &socket, const SocketAddress &address, const std::shared_ptr<const Data> &data)
+	{
+		if ((socket == nullptr) || (data == nullptr))
+		{
+			OV_ASSERT2(false);
+			return false;
+		}
+
+		auto &pending = _pending_map[socket->GetId()];
+
+		if (pending.socket == nullptr)
+		{
+			pending.socket = socket;
+		}
+
+		pending.datagrams.push_back({address, data});
+		_pending_count++;
+
+		if ((_max_pending_count > 0) && (_pending_count >= _max_pending_count))
+		{
+			Flush();
+		}
+
+		return true;
+	}
+
+	size_t DatagramBatch::Flush()
+	{
+		size_t sent_count = 0;
+
+		for (auto &item : _pending_map)
+		{
+			auto &pending = item.second;
+			auto &datagrams = pending.datagrams;
+
+			if (datagrams.empty())
+			{
+				continue;
+			}
+
+			// Group the datagrams by the destination so they can be coalesced using GSO.
+			// stable_sort() keeps the order of the datagrams to the same destination.
+			std::stable_sort(datagrams.begin(), datagrams.end(), [](const OutgoingDatagram &lhs, const OutgoingDatagram &rhs) -> bool {
+				return lhs.address < rhs.address;
+			});
+
+			auto result = pending.socket->SendTo(datagrams.data(), datagrams.size());
+
+			if (result > 0)
+			{
+				sent_count += result;
+			}
+
+			datagrams.clear();
+		}
+
+		_pending_count = 0;
+
+		return sent_count;
+	}
+}  // namespace ov
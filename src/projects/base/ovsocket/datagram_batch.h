@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "socket.h"
+
+namespace ov
+{
+	// Collects outgoing datagrams of the current thread and sends them together with sendmmsg().
+	//
+	// While an instance is alive, it is registered as the batch of the thread that created it,
+	// so lower layers can find it using GetCurrent() without passing it through every call.
+	// The datagrams are sent when Flush() is called or the instance is destroyed.
+	class DatagramBatch
+	{
+	public:
+		explicit DatagramBatch(size_t max_pending_count = 1024);
+		~DatagramBatch();
+
+		DatagramBatch(const DatagramBatch &batch) = delete;
+		DatagramBatch &operator=(const DatagramBatch &batch) = delete;
+
+		// Returns the batch of the calling thread (nullptr if there is no batch)
+		static DatagramBatch *GetCurrent();
+
+		// The data must not be modified until the batch is flushed
+		bool Add(const std::shared_ptr<Socket> &socket, const SocketAddress &address, const std::shared_ptr<const Data> &data);
+
+		// @return the number of datagrams sent
+		size_t Flush();
+
+		size_t GetPendingCount() const
+		{
+			return _pending_count;
+		}
+
+	protected:
+		struct PendingDatagrams
+		{
+			std::shared_ptr<Socket> socket;
+			std::vector<OutgoingDatagram> datagrams;
+		};
+
+		size_t _max_pending_count = 0;
+		size_t _pending_count = 0;
+
+		// key: socket id
+		std::map<int, PendingDatagrams> _pending_map;
+
+		DatagramBatch *_previous_batch = nullptr;
+	};
+}  // namespace ov
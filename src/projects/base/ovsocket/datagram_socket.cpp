@@ -11,14 +11,21 @@
 #include "client_socket.h"
 #include "socket_private.h"
 
+#include <netinet/udp.h>
+
+#if !defined(__APPLE__) && !defined(UDP_GRO)
+// Older libc headers don't have UDP_GRO (linux/udp.h, since 5.0)
+#	define UDP_GRO 104
+#endif
+
 namespace ov
 {
-	bool DatagramSocket::Prepare(int port)
+	bool DatagramSocket::Prepare(int port, bool reuse_port)
 	{
-		return Prepare(SocketAddress(port));
+		return Prepare(SocketAddress(port), reuse_port);
 	}
 
-	bool DatagramSocket::Prepare(const SocketAddress &address)
+	bool DatagramSocket::Prepare(const SocketAddress &address, bool reuse_port)
 	{
 		CHECK_STATE(== SocketState::Closed, false);
 
@@ -29,6 +36,7 @@ namespace ov
 				PrepareEpoll() &&
 				AddToEpoll(this, static_cast<void *>(this)) &&
 				SetSockOpt<int>(SO_REUSEADDR, 1) &&
+				((reuse_port == false) || SetSockOpt<int>(SO_REUSEPORT, 1)) &&
 				Bind(address)
 			) == false)
 		{
@@ -40,6 +48,25 @@ namespace ov
 		return true;
 	}
 
+	bool DatagramSocket::Inherit(int native_handle, const SocketAddress &address)
+	{
+		CHECK_STATE(== SocketState::Closed, false);
+
+		if(
+			(
+				Attach(SocketType::Udp, native_handle, address) &&
+				MakeNonBlocking() &&
+				PrepareEpoll() &&
+				AddToEpoll(this, static_cast<void *>(this))
+			) == false)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
 	bool DatagramSocket::DispatchEvent(const DatagramCallback& data_callback, int timeout)
 	{
 		CHECK_STATE2(>= SocketState::Created, <= SocketState::Bound, false);
@@ -77,33 +104,7 @@ namespace ov
 				{
 					logtd("Trying to read UDP packets...");
 
-					while(true)
-					{
-						std::shared_ptr<Data> data = std::make_shared<ov::Data>(UdpBufferSize);
-
-						// socket에서 이벤트 발생
-						std::shared_ptr<SocketAddress> remote;
-						std::shared_ptr<ov::Error> error = RecvFrom(data, &remote);
-
-						if(data->GetLength() > 0L)
-						{
-							data_callback(this->GetSharedPtrAs<DatagramSocket>(), *(remote.get()), data);
-						}
-
-						if(error != nullptr)
-						{
-							logtw("[#%d] An error occurred: %s", GetSocket(), error->ToString().CStr());
-							break;
-						}
-						else
-						{
-							if(data->GetLength() == 0L)
-							{
-								// 다음 데이터를 기다려야 함
-								break;
-							}
-						}
-					}
+					DispatchRecv(data_callback);
 
 					logtd("All UDP data are processed");
 				}
@@ -128,6 +129,194 @@ namespace ov
 		return true;
 	}
 
+	void DatagramSocket::SetReceiveBatchSize(int batch_size)
+	{
+		OV_ASSERT2(_buffer_pool == nullptr);
+
+		_receive_batch_size = std::max(batch_size, 1);
+	}
+
+	bool DatagramSocket::SetUdpGro(bool enable)
+	{
+		OV_ASSERT2(_buffer_pool == nullptr);
+
+#if defined(__APPLE__)
+		if (enable)
+		{
+			logtw("[#%d] UDP_GRO is not supported on this platform", GetSocket().GetSocket());
+			return false;
+		}
+#else
+		if (SetSockOpt<int>(IPPROTO_UDP, UDP_GRO, enable ? 1 : 0) == false)
+		{
+			logtw("[#%d] Could not %s UDP_GRO", GetSocket().GetSocket(), enable ? "enable" : "disable");
+			return false;
+		}
+#endif  // defined(__APPLE__)
+
+		_is_udp_gro_enabled = enable;
+
+		return true;
+	}
+
+	void DatagramSocket::PrepareReceiveBuffers()
+	{
+		if (_buffer_pool != nullptr)
+		{
+			return;
+		}
+
+		_buffer_pool = BufferPool::Create(_is_udp_gro_enabled ? UdpGroBufferSize : UdpBufferSize, MaxFreeReceiveBufferCount);
+
+#if !defined(__APPLE__)
+		_receive_slots.resize(_receive_batch_size);
+		_receive_messages.resize(_receive_batch_size);
+#endif  // !defined(__APPLE__)
+	}
+
+	void DatagramSocket::DispatchRecv(const DatagramCallback &data_callback)
+	{
+		PrepareReceiveBuffers();
+
+#if !defined(__APPLE__)
+		DispatchRecvMultiple(data_callback);
+#else
+		while (true)
+		{
+			auto buffer = _buffer_pool->Allocate();
+
+			sockaddr_in remote = {0};
+			socklen_t remote_length = sizeof(remote);
+
+			ssize_t read_bytes = ::recvfrom(_socket.GetSocket(), buffer->GetBytes(), buffer->GetCapacity(), MSG_DONTWAIT, (sockaddr *)&remote, &remote_length);
+
+			if (read_bytes < 0L)
+			{
+				auto error = Error::CreateErrorFromErrno();
+
+				if (error->GetCode() != EAGAIN)
+				{
+					logtw("[#%d] An error occurred: %s", GetSocket().GetSocket(), error->ToString().CStr());
+				}
+
+				// 다음 데이터를 기다려야 함
+				break;
+			}
+
+			data_callback(this->GetSharedPtrAs<DatagramSocket>(), SocketAddress(remote), std::make_shared<Data>(std::move(buffer), static_cast<size_t>(read_bytes)));
+		}
+#endif  // !defined(__APPLE__)
+	}
+
+#if !defined(__APPLE__)
+	void DatagramSocket::DispatchRecvMultiple(const DatagramCallback &data_callback)
+	{
+		auto socket = this->GetSharedPtrAs<DatagramSocket>();
+
+		while (true)
+		{
+			// Fill the empty slots (the buffers of the previous call are owned by the callee)
+			for (int index = 0; index < _receive_batch_size; index++)
+			{
+				auto &slot = _receive_slots[index];
+				auto &message = _receive_messages[index];
+
+				if (slot.buffer == nullptr)
+				{
+					slot.buffer = _buffer_pool->Allocate();
+				}
+
+				slot.iov.iov_base = slot.buffer->GetBytes();
+				slot.iov.iov_len = slot.buffer->GetCapacity();
+
+				message = {};
+				message.msg_hdr.msg_name = &slot.address;
+				message.msg_hdr.msg_namelen = sizeof(slot.address);
+				message.msg_hdr.msg_iov = &slot.iov;
+				message.msg_hdr.msg_iovlen = 1;
+
+				if (_is_udp_gro_enabled)
+				{
+					message.msg_hdr.msg_control = slot.control;
+					message.msg_hdr.msg_controllen = sizeof(slot.control);
+				}
+			}
+
+			int count = ::recvmmsg(_socket.GetSocket(), _receive_messages.data(), _receive_batch_size, MSG_DONTWAIT, nullptr);
+
+			if (count < 0)
+			{
+				auto error = Error::CreateErrorFromErrno();
+
+				switch (error->GetCode())
+				{
+					case EINTR:
+						continue;
+
+					case EAGAIN:
+						// 다음 데이터를 기다려야 함
+						break;
+
+					default:
+						logtw("[#%d] An error occurred: %s", GetSocket().GetSocket(), error->ToString().CStr());
+						break;
+				}
+
+				break;
+			}
+
+			for (int index = 0; index < count; index++)
+			{
+				auto &slot = _receive_slots[index];
+				auto &message = _receive_messages[index];
+				size_t length = message.msg_len;
+
+				if (OV_CHECK_FLAG(message.msg_hdr.msg_flags, MSG_TRUNC))
+				{
+					logtw("[#%d] A datagram is truncated to %zu bytes", GetSocket().GetSocket(), length);
+				}
+
+				int segment_size = 0;
+
+				if (_is_udp_gro_enabled)
+				{
+					for (auto cmsg = CMSG_FIRSTHDR(&message.msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message.msg_hdr, cmsg))
+					{
+						if ((cmsg->cmsg_level == IPPROTO_UDP) && (cmsg->cmsg_type == UDP_GRO))
+						{
+							::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+							break;
+						}
+					}
+				}
+
+				SocketAddress remote(slot.address);
+				auto data = std::make_shared<Data>(std::move(slot.buffer), length);
+				slot.buffer = nullptr;
+
+				if ((segment_size > 0) && (static_cast<size_t>(segment_size) < length))
+				{
+					// Split the coalesced datagram (the segments share the buffer)
+					for (size_t offset = 0; offset < length; offset += segment_size)
+					{
+						data_callback(socket, remote, data->Subdata(offset, std::min(static_cast<size_t>(segment_size), length - offset)));
+					}
+				}
+				else if (length > 0)
+				{
+					data_callback(socket, remote, data);
+				}
+			}
+
+			if (count < _receive_batch_size)
+			{
+				// The socket buffer is drained
+				break;
+			}
+		}
+	}
+#endif  // !defined(__APPLE__)
+
 	String DatagramSocket::ToString() const
 	{
 		return Socket::ToString("DatagramSocket");
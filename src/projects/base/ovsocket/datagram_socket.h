@@ -20,12 +20,23 @@ namespace ov
 		~DatagramSocket() override = default;
 
 		// 특정 port로 bind
-		bool Prepare(int port);
+		// If reuse_port is true, SO_REUSEPORT is set so that several sockets can receive datagrams of the same address
+		bool Prepare(int port, bool reuse_port = false);
 		// address에 해당하는 주소로 bind
-		bool Prepare(const SocketAddress &address);
+		bool Prepare(const SocketAddress &address, bool reuse_port = false);
+
+		// Receives the datagrams of the socket that is already bound to address (such as the one inherited from the previous process)
+		bool Inherit(int native_handle, const SocketAddress &address);
 
 		bool DispatchEvent(const DatagramCallback& data_callback, int timeout = Infinite);
 
+		// The maximum number of datagrams received by one recvmmsg() call (must be called before DispatchEvent())
+		void SetReceiveBatchSize(int batch_size);
+		// Lets the kernel coalesce the datagrams of the same flow (UDP_GRO, Linux 5.0+)
+		// The coalesced datagrams are split into the original datagrams without copying before calling DatagramCallback
+		// (must be called before DispatchEvent())
+		bool SetUdpGro(bool enable);
+
 		using Socket::Connect;
 		using Socket::GetState;
 		using Socket::Recv;
@@ -37,5 +48,31 @@ namespace ov
 		String ToString() const override;
 
 	protected:
+		// Reads all datagrams in the socket buffer
+		void DispatchRecv(const DatagramCallback &data_callback);
+#if !defined(__APPLE__)
+		void DispatchRecvMultiple(const DatagramCallback &data_callback);
+#endif  // !defined(__APPLE__)
+		void PrepareReceiveBuffers();
+
+		int _receive_batch_size = DefaultReceiveBatchSize;
+		bool _is_udp_gro_enabled = false;
+
+		// Receive buffers are recycled through the pool once the callee releases the data
+		std::shared_ptr<BufferPool> _buffer_pool;
+
+#if !defined(__APPLE__)
+		struct ReceiveSlot
+		{
+			DataBufferPtr buffer;
+			sockaddr_in address;
+			iovec iov;
+			// For UDP_GRO
+			uint8_t control[CMSG_SPACE(sizeof(int))];
+		};
+
+		std::vector<ReceiveSlot> _receive_slots;
+		std::vector<mmsghdr> _receive_messages;
+#endif  // !defined(__APPLE__)
 	};
 }
@@ -0,0 +1,303 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "io_uring.h"
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include "socket_private.h"
+
+#if OV_IO_URING_AVAILABLE
+#	include <linux/io_uring.h>
+#	include <sys/mman.h>
+#	include <sys/socket.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+
+#	include <algorithm>
+#	include <cerrno>
+#	include <cstring>
+#endif  // OV_IO_URING_AVAILABLE
+
+namespace ov
+{
+	IoUring::~IoUring()
+	{
+		Destroy();
+	}
+
+#if OV_IO_URING_AVAILABLE
+	static int IoUringSetup(unsigned int entries, io_uring_params *params)
+	{
+		return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+	}
+
+	static int IoUringEnter(int ring_fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+	{
+		return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+	}
+
+	bool IoUring::IsSupported()
+	{
+		static const bool is_supported = []() -> bool {
+			io_uring_params params {};
+			int ring_fd = IoUringSetup(1, &params);
+
+			if (ring_fd < 0)
+			{
+				// ENOSYS (old kernel), EPERM (disabled by sysctl/seccomp), ...
+				return false;
+			}
+
+			::close(ring_fd);
+
+			// IORING_OP_RECV needs 5.6, IORING_FEAT_FAST_POLL is added in 5.7
+			return OV_CHECK_FLAG(params.features, IORING_FEAT_SINGLE_MMAP) &&
+				   OV_CHECK_FLAG(params.features, IORING_FEAT_NODROP) &&
+				   OV_CHECK_FLAG(params.features, IORING_FEAT_FAST_POLL);
+		}();
+
+		return is_supported;
+	}
+
+	bool IoUring::Create(unsigned int entries)
+	{
+		if (IsCreated())
+		{
+			return false;
+		}
+
+		io_uring_params params {};
+		_ring_fd = IoUringSetup(entries, &params);
+
+		if (_ring_fd < 0)
+		{
+			logte("Could not create io_uring: %s", ::strerror(errno));
+			return false;
+		}
+
+		_sq_ring_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned int));
+		_cq_ring_size = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+
+		if (OV_CHECK_FLAG(params.features, IORING_FEAT_SINGLE_MMAP))
+		{
+			_sq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+		}
+
+		_sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+
+		if (_sq_ring == MAP_FAILED)
+		{
+			_sq_ring = nullptr;
+			Destroy();
+			return false;
+		}
+
+		if (OV_CHECK_FLAG(params.features, IORING_FEAT_SINGLE_MMAP))
+		{
+			_cq_ring = _sq_ring;
+			_cq_ring_size = 0;
+		}
+		else
+		{
+			_cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+
+			if (_cq_ring == MAP_FAILED)
+			{
+				_cq_ring = nullptr;
+				Destroy();
+				return false;
+			}
+		}
+
+		_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		_sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+
+		if (_sqes == MAP_FAILED)
+		{
+			_sqes = nullptr;
+			Destroy();
+			return false;
+		}
+
+		auto sq_ring = static_cast<uint8_t *>(_sq_ring);
+		_sq_head = reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.head);
+		_sq_tail = reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.tail);
+		_sq_mask = *reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.ring_mask);
+		_sq_entries = params.sq_entries;
+		_sq_array = reinterpret_cast<unsigned int *>(sq_ring + params.sq_off.array);
+
+		auto cq_ring = static_cast<uint8_t *>(_cq_ring);
+		_cq_head = reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.head);
+		_cq_tail = reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.tail);
+		_cq_mask = *reinterpret_cast<unsigned int *>(cq_ring + params.cq_off.ring_mask);
+		_cqes = cq_ring + params.cq_off.cqes;
+
+		_pending_count = 0;
+
+		return true;
+	}
+
+	void IoUring::Destroy()
+	{
+		if (_sqes != nullptr)
+		{
+			::munmap(_sqes, _sqes_size);
+			_sqes = nullptr;
+		}
+
+		if ((_cq_ring != nullptr) && (_cq_ring != _sq_ring))
+		{
+			::munmap(_cq_ring, _cq_ring_size);
+		}
+		_cq_ring = nullptr;
+
+		if (_sq_ring != nullptr)
+		{
+			::munmap(_sq_ring, _sq_ring_size);
+			_sq_ring = nullptr;
+		}
+
+		if (_ring_fd >= 0)
+		{
+			::close(_ring_fd);
+			_ring_fd = -1;
+		}
+
+		_pending_count = 0;
+	}
+
+	unsigned int IoUring::GetFreeCount() const
+	{
+		if (IsCreated() == false)
+		{
+			return 0;
+		}
+
+		// This thread is the only producer, so the tail doesn't need to be loaded atomically
+		auto head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+
+		return _sq_entries - (*_sq_tail - head);
+	}
+
+	bool IoUring::PrepareRecv(int fd, void *buffer, size_t length, uint64_t user_data)
+	{
+		if (GetFreeCount() == 0)
+		{
+			return false;
+		}
+
+		auto tail = *_sq_tail;
+		auto index = tail & _sq_mask;
+		auto sqe = static_cast<io_uring_sqe *>(_sqes) + index;
+
+		::memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = IORING_OP_RECV;
+		sqe->fd = fd;
+		sqe->addr = reinterpret_cast<uint64_t>(buffer);
+		sqe->len = static_cast<uint32_t>(length);
+		// Completes with -EAGAIN instead of waiting for the data
+		sqe->msg_flags = MSG_DONTWAIT;
+		sqe->user_data = user_data;
+
+		_sq_array[index] = index;
+
+		// The kernel must see the entry before the new tail
+		__atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+		_pending_count++;
+
+		return true;
+	}
+
+	int IoUring::Submit(unsigned int wait_count)
+	{
+		if (IsCreated() == false)
+		{
+			return -1;
+		}
+
+		while (true)
+		{
+			int result = IoUringEnter(_ring_fd, _pending_count, wait_count, (wait_count > 0) ? IORING_ENTER_GETEVENTS : 0);
+
+			if (result >= 0)
+			{
+				_pending_count -= std::min(_pending_count, static_cast<unsigned int>(result));
+				return result;
+			}
+
+			if (errno != EINTR)
+			{
+				logte("Could not submit to io_uring: %s", ::strerror(errno));
+				return -1;
+			}
+		}
+	}
+
+	size_t IoUring::ForEachCompletion(const CompletionHandler &handler)
+	{
+		if (IsCreated() == false)
+		{
+			return 0;
+		}
+
+		size_t count = 0;
+		auto head = *_cq_head;
+		auto tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+
+		while (head != tail)
+		{
+			auto cqe = static_cast<io_uring_cqe *>(_cqes) + (head & _cq_mask);
+
+			handler(cqe->user_data, cqe->res);
+
+			head++;
+			count++;
+		}
+
+		// Returns the entries to the kernel
+		__atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+		return count;
+	}
+#else   // OV_IO_URING_AVAILABLE
+	bool IoUring::IsSupported()
+	{
+		return false;
+	}
+
+	bool IoUring::Create(unsigned int entries)
+	{
+		return false;
+	}
+
+	void IoUring::Destroy()
+	{
+	}
+
+	unsigned int IoUring::GetFreeCount() const
+	{
+		return 0;
+	}
+
+	bool IoUring::PrepareRecv(int fd, void *buffer, size_t length, uint64_t user_data)
+	{
+		return false;
+	}
+
+	int IoUring::Submit(unsigned int wait_count)
+	{
+		return -1;
+	}
+
+	size_t IoUring::ForEachCompletion(const CompletionHandler &handler)
+	{
+		return 0;
+	}
+#endif  // OV_IO_URING_AVAILABLE
+}  // namespace ov
@@ -0,0 +1,89 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#if defined(__linux__) && defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		define OV_IO_URING_AVAILABLE 1
+#	endif
+#endif
+
+namespace ov
+{
+	// A minimal io_uring (Linux 5.7+) that submits the operations of an event loop tick with a single io_uring_enter().
+	//
+	// It talks to the kernel with the raw system calls (liburing is not required).
+	// It is not thread-safe, each event loop thread owns its ring.
+	// On the other platforms (or the kernels without io_uring), IsSupported() returns false and Create() fails.
+	class IoUring
+	{
+	public:
+		IoUring() = default;
+		~IoUring();
+
+		IoUring(const IoUring &ring) = delete;
+		IoUring &operator=(const IoUring &ring) = delete;
+
+		// Whether the kernel supports the features used by this class (checked once)
+		static bool IsSupported();
+
+		bool Create(unsigned int entries);
+		void Destroy();
+
+		bool IsCreated() const
+		{
+			return _ring_fd >= 0;
+		}
+
+		// The number of the operations that can be prepared before Submit()
+		unsigned int GetFreeCount() const;
+
+		// Prepares recv(fd, buffer, length, MSG_DONTWAIT), returns false if the submission queue is full
+		bool PrepareRecv(int fd, void *buffer, size_t length, uint64_t user_data);
+
+		// Submits the prepared operations, and waits until wait_count operations are completed
+		// @return the number of the submitted operations (-1 on error)
+		int Submit(unsigned int wait_count);
+
+		// result: the return value of the operation (-errno on error)
+		using CompletionHandler = std::function<void(uint64_t user_data, int32_t result)>;
+		// @return the number of the completions handled
+		size_t ForEachCompletion(const CompletionHandler &handler);
+
+	protected:
+		int _ring_fd = -1;
+
+		// Submission queue
+		void *_sq_ring = nullptr;
+		size_t _sq_ring_size = 0;
+		unsigned int *_sq_head = nullptr;
+		unsigned int *_sq_tail = nullptr;
+		unsigned int _sq_mask = 0;
+		unsigned int _sq_entries = 0;
+		unsigned int *_sq_array = nullptr;
+		// struct io_uring_sqe *
+		void *_sqes = nullptr;
+		size_t _sqes_size = 0;
+		// The operations prepared after the last Submit()
+		unsigned int _pending_count = 0;
+
+		// Completion queue (it shares the mapping of the submission queue if IORING_FEAT_SINGLE_MMAP)
+		void *_cq_ring = nullptr;
+		size_t _cq_ring_size = 0;
+		unsigned int *_cq_head = nullptr;
+		unsigned int *_cq_tail = nullptr;
+		unsigned int _cq_mask = 0;
+		// struct io_uring_cqe *
+		void *_cqes = nullptr;
+	};
+}  // namespace ov
@@ -17,4 +17,6 @@
 #include "client_socket.h"
 
 // UDP socket
-#include "datagram_socket.h"
\ No newline at end of file
+#include "datagram_socket.h"
+#include "datagram_batch.h"
+#include "io_uring.h"
\ No newline at end of file
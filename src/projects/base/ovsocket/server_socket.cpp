@@ -13,8 +13,62 @@
 #include "client_socket.h"
 #include "socket_private.h"
 
+// The number of the receives that are submitted to io_uring at once
+#define SERVER_SOCKET_IO_URING_ENTRIES 256
+
 namespace ov
 {
+	std::atomic<bool> ServerSocket::_io_uring_enabled{false};
+
+	TcpAcceptOptions ServerSocket::_accept_options;
+	std::atomic<uint64_t> ServerSocket::_accepted_count{0};
+	std::atomic<uint64_t> ServerSocket::_accept_error_count{0};
+	std::atomic<uint64_t> ServerSocket::_accept_batch_full_count{0};
+
+	void ServerSocket::SetAcceptOptions(const TcpAcceptOptions &options)
+	{
+		_accept_options = options;
+		_accept_options.batch_size = std::max(_accept_options.batch_size, 1);
+	}
+
+	const TcpAcceptOptions &ServerSocket::GetAcceptOptions()
+	{
+		return _accept_options;
+	}
+
+	TcpAcceptStatistics ServerSocket::GetAcceptStatistics()
+	{
+		TcpAcceptStatistics statistics;
+
+		statistics.accepted_count = _accepted_count;
+		statistics.error_count = _accept_error_count;
+		statistics.batch_full_count = _accept_batch_full_count;
+
+		return statistics;
+	}
+
+	bool ServerSocket::SetDeferAccept(int seconds)
+	{
+		if (GetType() != SocketType::Tcp)
+		{
+			return false;
+		}
+
+		return SetSockOpt<int>(IPPROTO_TCP, TCP_DEFER_ACCEPT, std::max(seconds, 0));
+	}
+
+	bool ServerSocket::SetIoUringEnabled(bool enabled)
+	{
+		_io_uring_enabled = enabled && IoUring::IsSupported();
+
+		return _io_uring_enabled == enabled;
+	}
+
+	bool ServerSocket::IsIoUringEnabled()
+	{
+		return _io_uring_enabled;
+	}
+
 	ServerSocket::~ServerSocket()
 	{
 	}
@@ -23,16 +77,18 @@ namespace ov
 							   uint16_t port,
 							   int send_buffer_size,
 							   int recv_buffer_size,
-							   int backlog)
+							   int backlog,
+							   bool reuse_port)
 	{
-		return Prepare(type, SocketAddress(port), send_buffer_size, recv_buffer_size, backlog);
+		return Prepare(type, SocketAddress(port), send_buffer_size, recv_buffer_size, backlog, reuse_port);
 	}
 
 	bool ServerSocket::Prepare(SocketType type,
 							   const SocketAddress &address,
 							   int send_buffer_size,
 							   int recv_buffer_size,
-							   int backlog)
+							   int backlog,
+							   bool reuse_port)
 	{
 		CHECK_STATE(== SocketState::Closed, false);
 
@@ -42,7 +98,7 @@ namespace ov
 				MakeNonBlocking() &&
 				PrepareEpoll() &&
 				AddToEpoll(this, static_cast<void *>(this)) &&
-				SetSocketOptions(type, send_buffer_size, recv_buffer_size) &&
+				SetSocketOptions(type, send_buffer_size, recv_buffer_size, reuse_port) &&
 				Bind(address) &&
 				Listen(backlog)) == false)
 		{
@@ -55,6 +111,34 @@ namespace ov
 		return true;
 	}
 
+	bool ServerSocket::Inherit(int native_handle, const SocketAddress &address)
+	{
+		CHECK_STATE(== SocketState::Closed, false);
+
+		if (
+			(
+				Attach(SocketType::Tcp, native_handle, address) &&
+				MakeNonBlocking() &&
+				PrepareEpoll() &&
+				AddToEpoll(this, static_cast<void *>(this))) == false)
+		{
+			Close();
+			return false;
+		}
+
+		SetState(SocketState::Listening);
+
+		return true;
+	}
+
+	bool ServerSocket::StopAccepting()
+	{
+		CHECK_STATE(== SocketState::Listening, false);
+
+		// The pending connections in the backlog are accepted by the new process
+		return RemoveFromEpoll(this);
+	}
+
 	bool ServerSocket::DispatchEvent(ClientConnectionCallback connection_callback, ClientDataCallback data_callback, int timeout)
 	{
 		CHECK_STATE(== SocketState::Listening, false);
@@ -84,6 +168,10 @@ namespace ov
 				// A new client is connected to this socket
 				DispatchAccept();
 			}
+			else if (AddToBatchReceive(key, event))
+			{
+				// The data is received with the others at once after the loop
+			}
 			else
 			{
 				// An event raised by the client
@@ -91,6 +179,10 @@ namespace ov
 			}
 		}
 
+		DispatchBatchReceive();
+
+		CloseExpiredClosingClients();
+
 		// Garbage collection
 		{
 			std::lock_guard<std::shared_mutex> lock(_client_list_mutex);
@@ -107,21 +199,33 @@ namespace ov
 
 		if (client_socket.IsValid() == false)
 		{
+			if ((GetType() == SocketType::Tcp) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+			{
+				// Such as EMFILE, the connection stays in the backlog
+				_accept_error_count++;
+			}
+
 			return nullptr;
 		}
 
+		_accepted_count++;
+
 		std::shared_ptr<ClientSocket> client = std::make_shared<ClientSocket>(this, client_socket, address);
 
 		if (client != nullptr)
 		{
 			logtd("[%p] [#%d] New client is connected: %s", this, _socket.GetSocket(), client->ToString().CStr());
 
-			client->StartDispatchThread();
-
 			_client_list_mutex.lock();
 			_client_list[client.get()] = client;
+			auto low_latency_options = _low_latency_options;
 			_client_list_mutex.unlock();
 
+			if (low_latency_options.enabled)
+			{
+				client->SetLowLatencyOptions(low_latency_options);
+			}
+
 			AddToEpoll(client.get(), static_cast<void *>(client.get()));
 
 			return client;
@@ -130,12 +234,34 @@ namespace ov
 		return nullptr;
 	}
 
+	void ServerSocket::SetLowLatencyOptions(const TcpLowLatencyOptions &options)
+	{
+		std::lock_guard<std::shared_mutex> lock(_client_list_mutex);
+
+		_low_latency_options = options;
+	}
+
+	TcpLowLatencyOptions ServerSocket::GetLowLatencyOptions() const
+	{
+		std::shared_lock<std::shared_mutex> lock(_client_list_mutex);
+
+		return _low_latency_options;
+	}
+
 	void ServerSocket::DispatchAccept()
 	{
-		std::shared_ptr<ClientSocket> client = nullptr;
+		// The listening socket is level-triggered, so the connections over the batch are accepted in the next event loop
+		// after the events of the established clients are handled (a burst of the connections doesn't stall them)
+		int batch_size = _accept_options.batch_size;
 
-		while (true)
+		for (int count = 0;; count++)
 		{
+			if (count >= batch_size)
+			{
+				_accept_batch_full_count++;
+				break;
+			}
+
 			std::shared_ptr<ClientSocket> client = Accept();
 
 			if (client == nullptr)
@@ -187,6 +313,17 @@ namespace ov
 
 			if (item == _client_list.end())
 			{
+				auto closing_item = _closing_client_list.find(key);
+
+				if (closing_item != _closing_client_list.end())
+				{
+					client = closing_item->second;
+					lock.unlock();
+
+					DispatchClosingClientEvents(client, event);
+					return;
+				}
+
 				// If the client deleted from another thread as soon as the event occurs at epoll(), it enters here
 				logtd("[%p] [#%d] Could not find a client: %p", this, _socket.GetSocket(), key);
 				return;
@@ -195,6 +332,29 @@ namespace ov
 			client = item->second;
 		}
 
+		if (OV_CHECK_FLAG(epoll_events, EPOLLOUT) && (OV_CHECK_FLAG(epoll_events, EPOLLERR) == false))
+		{
+			// The socket buffer has free space - send the queued data
+			if (client->FlushSendQueue() == false)
+			{
+				auto error = Error::CreateError("Socket", "Could not send the queued data to client #%d", client->GetSocket().GetSocket());
+				logtd("[%p] [#%d] %s", this, _socket.GetSocket(), error->ToString().CStr());
+				DisconnectClient(client, SocketConnectionState::Error, error);
+				return;
+			}
+
+			if (OV_CHECK_FLAG(epoll_events, EPOLLIN) == false)
+			{
+				// Only EPOLLOUT is raised; HUP events are handled below
+				epoll_events &= ~EPOLLOUT;
+
+				if ((OV_CHECK_FLAG(epoll_events, EPOLLHUP) == false) && (OV_CHECK_FLAG(epoll_events, EPOLLRDHUP) == false))
+				{
+					return;
+				}
+			}
+		}
+
 		if (OV_CHECK_FLAG(epoll_events, EPOLLERR) || (!OV_CHECK_FLAG(epoll_events, EPOLLIN)))
 		{
 			// An error occurred while communiting with the client
@@ -219,75 +379,301 @@ namespace ov
 		else
 		{
 			// Data is available that sent by the client
+			logtd("[%p] [#%d] The data received from client #%d", this, _socket.GetSocket(), client->GetSocket().GetSocket());
+
+			ReceiveClientData(client);
+		}
+	}
+
+	void ServerSocket::ReceiveClientData(const std::shared_ptr<ClientSocket> &client)
+	{
+		while (client->GetState() == SocketState::Connected)
+		{
+			// The callback can hand over the data to another thread (such as PhysicalPortWorker),
+			// so the buffer must not be reused for the next read
 			auto data = std::make_shared<Data>(TcpBufferSize);
 
-			logtd("[%p] [#%d] The data received from client #%d", this, _socket.GetSocket(), client->GetSocket().GetSocket());
+			auto error = client->Recv(data);
 
-			while (client->GetState() == SocketState::Connected)
+			if (data->GetLength() > 0L)
 			{
-				data->SetLength(0);
+				HandleClientData(client, data);
+			}
 
-				auto error = client->Recv(data);
+			if (client->GetState() == SocketState::Error)
+			{
+				logtd("[%p] [#%d] An error occurred on client %s", this, _socket.GetSocket(), client->ToString().CStr());
+				DisconnectClient(client, SocketConnectionState::Error, error);
+				break;
+			}
+
+			if (error != nullptr)
+			{
+				logtd("[%p] [#%d] Client %s is disconnected", this, _socket.GetSocket(), client->ToString().CStr());
+				DisconnectClient(client, SocketConnectionState::Disconnected, nullptr);
+				break;
+			}
+
+			if (data->GetLength() == 0L)
+			{
+				// Waiting for next data
+				break;
+			}
+		}
+	}
+
+	void ServerSocket::HandleClientData(const std::shared_ptr<ClientSocket> &client, const std::shared_ptr<Data> &data)
+	{
+		auto new_state = _data_callback(client, data);
+
+		switch (new_state)
+		{
+			case SocketConnectionState::Connected:
+				break;
+
+			case SocketConnectionState::Disconnect:
+				logtd("[%p] [#%d] The data callback requested to disconnect the client #%d",
+					  this, _socket.GetSocket(), client->GetSocket().GetSocket());
+				DisconnectClient(client, new_state);
+				break;
+
+			case SocketConnectionState::Disconnected:
+				logtd("[%p] [#%d] Invalid socket state for client #%d",
+					  this, _socket.GetSocket(), client->GetSocket().GetSocket());
+				OV_ASSERT2(false);
+				DisconnectClient(client, new_state);
+				break;
 
-				if (data->GetLength() > 0L)
+			case SocketConnectionState::Error: {
+				auto error = Error::CreateError("Connection", "The connection callback requested to disconnect the client #%d",
+												_socket.GetSocket(), client->GetSocket().GetSocket());
+				logtd("[%p] [#%d] %s", this, _socket.GetSocket(), error->ToString().CStr());
+				DisconnectClient(client, new_state, error);
+				break;
+			}
+		}
+	}
+
+	bool ServerSocket::AddToBatchReceive(const void *key, const epoll_event *event)
+	{
+		if ((_io_uring_enabled == false) || (_use_io_uring == false) || (GetType() != SocketType::Tcp))
+		{
+			return false;
+		}
+
+		// Only the plain "data is available" events are batched, the others (EPOLLOUT, HUP, ERR) need DispatchEvents()
+		if (event->events != EPOLLIN)
+		{
+			return false;
+		}
+
+		std::shared_lock<std::shared_mutex> lock(_client_list_mutex);
+		auto item = _client_list.find(key);
+
+		if (item == _client_list.end())
+		{
+			// DispatchEvents() handles the closing clients
+			return false;
+		}
+
+		_batch_receive_list.push_back({item->second, nullptr, -EAGAIN});
+
+		return true;
+	}
+
+	void ServerSocket::DispatchBatchReceive()
+	{
+		if (_batch_receive_list.empty())
+		{
+			return;
+		}
+
+		if ((_io_uring.IsCreated() == false) && (_io_uring.Create(SERVER_SOCKET_IO_URING_ENTRIES) == false))
+		{
+			logtw("[%p] [#%d] Could not create io_uring, the data is received one by one", this, _socket.GetSocket());
+			_use_io_uring = false;
+		}
+
+		size_t offset = 0;
+
+		while (offset < _batch_receive_list.size())
+		{
+			size_t prepared_count = 0;
+
+			if (_use_io_uring)
+			{
+				for (size_t index = offset; index < _batch_receive_list.size(); index++)
 				{
-					auto new_state = _data_callback(client->GetSharedPtrAs<ClientSocket>(), data);
-					switch (new_state)
+					auto &item = _batch_receive_list[index];
+
+					item.data = std::make_shared<Data>(TcpBufferSize);
+					// The bytes are overwritten by the kernel, so they don't need to be initialized
+					item.data->SetLengthUninitialized(item.data->GetCapacity());
+					item.result = -EAGAIN;
+
+					if (_io_uring.PrepareRecv(item.client->GetSocket().GetSocket(), item.data->GetWritableData(), item.data->GetLength(), index) == false)
 					{
-						case SocketConnectionState::Connected:
-							break;
-
-						case SocketConnectionState::Disconnect:
-							logtd("[%p] [#%d] The data callback requested to disconnect the client #%d",
-								  this, _socket.GetSocket(), client->GetSocket().GetSocket());
-							DisconnectClient(client, new_state);
-							break;
-
-						case SocketConnectionState::Disconnected:
-							logtd("[%p] [#%d] Invalid socket state for client #%d",
-								  this, _socket.GetSocket(), client->GetSocket().GetSocket());
-							OV_ASSERT2(false);
-							DisconnectClient(client, new_state);
-							break;
-
-						case SocketConnectionState::Error: {
-							auto error = Error::CreateError("Connection", "The connection callback requested to disconnect the client #%d",
-															_socket.GetSocket(), client->GetSocket().GetSocket());
-							logtd("[%p] [#%d] %s", this, _socket.GetSocket(), error->ToString().CStr());
-							DisconnectClient(client, new_state, error);
-							break;
-						}
+						break;
 					}
+
+					prepared_count++;
 				}
 
-				if (client->GetState() == SocketState::Error)
+				// The receives are done with MSG_DONTWAIT, so they are completed without waiting for the data
+				if ((prepared_count > 0) && (_io_uring.Submit(prepared_count) < 0))
 				{
-					logtd("[%p] [#%d] An error occurred on client %s", this, _socket.GetSocket(), client->ToString().CStr());
-					DisconnectClient(client, SocketConnectionState::Error, error);
-					break;
+					_use_io_uring = false;
+				}
+				else
+				{
+					_io_uring.ForEachCompletion([this](uint64_t user_data, int32_t result) {
+						if (user_data < _batch_receive_list.size())
+						{
+							_batch_receive_list[user_data].result = result;
+						}
+					});
 				}
+			}
+
+			if (_use_io_uring == false)
+			{
+				// Could not use io_uring, fall back to recv()
+				for (size_t index = offset; index < _batch_receive_list.size(); index++)
+				{
+					ReceiveClientData(_batch_receive_list[index].client);
+				}
+
+				break;
+			}
 
-				if (error != nullptr)
+			for (size_t index = offset; index < (offset + prepared_count); index++)
+			{
+				auto &item = _batch_receive_list[index];
+				auto &client = item.client;
+
+				if (item.result > 0)
+				{
+					item.data->SetLength(item.result);
+
+					HandleClientData(client, item.data);
+
+					if (static_cast<size_t>(item.result) == item.data->GetCapacity())
+					{
+						// There may be more data, read the rest of it as DispatchEvents() does
+						ReceiveClientData(client);
+					}
+				}
+				else if (item.result == 0)
 				{
 					logtd("[%p] [#%d] Client %s is disconnected", this, _socket.GetSocket(), client->ToString().CStr());
 					DisconnectClient(client, SocketConnectionState::Disconnected, nullptr);
+				}
+				else if (item.result != -EAGAIN)
+				{
+					// Let recv() handle the error (and log it)
+					ReceiveClientData(client);
+				}
+			}
+
+			offset += prepared_count;
+		}
+
+		_batch_receive_list.clear();
+	}
+
+	void ServerSocket::DispatchClosingClientEvents(const std::shared_ptr<ClientSocket> &client, const epoll_event *event)
+	{
+		uint32_t epoll_events = event->events;
+		bool close = OV_CHECK_FLAG(epoll_events, EPOLLERR) || OV_CHECK_FLAG(epoll_events, EPOLLHUP) || OV_CHECK_FLAG(epoll_events, EPOLLRDHUP);
+
+		if ((close == false) && OV_CHECK_FLAG(epoll_events, EPOLLIN))
+		{
+			// Nobody handles the data any more, so discard it
+			auto data = std::make_shared<Data>(TcpBufferSize);
+
+			while (true)
+			{
+				data->SetLength(0);
+
+				auto error = client->Recv(data);
+
+				if ((error != nullptr) || (client->GetState() == SocketState::Error))
+				{
+					close = true;
 					break;
 				}
 
-				// TODO(dimiden): (ClientSocketBlocking) Temporarily comment while processing as blocking
-				// if (data->GetLength() == 0L)
+				if (data->GetLength() == 0L)
 				{
-					// Waiting for next data
 					break;
 				}
 			}
 		}
+
+		if ((close == false) && OV_CHECK_FLAG(epoll_events, EPOLLOUT))
+		{
+			close = (client->FlushSendQueue() == false) || (client->HasPendingData() == false);
+		}
+
+		if (close)
+		{
+			CloseClosingClient(client);
+		}
+	}
+
+	void ServerSocket::CloseClosingClient(const std::shared_ptr<ClientSocket> &client)
+	{
+		{
+			std::lock_guard<std::shared_mutex> lock(_client_list_mutex);
+
+			if (_closing_client_list.erase(client.get()) == 0)
+			{
+				// Already closed
+				return;
+			}
+
+			// Keep the instance until DispatchEvent() is completed
+			_disconnected_client_list[client.get()] = client;
+		}
+
+		logtd("[%p] [#%d] Closing the client %s (%zu bytes remained)", this, _socket.GetSocket(), client->ToString().CStr(), client->GetSendQueueSize());
+
+		RemoveFromEpoll(client.get());
+
+		if (client->GetState() != SocketState::Closed)
+		{
+			client->CloseInternal();
+		}
+	}
+
+	void ServerSocket::CloseExpiredClosingClients()
+	{
+		std::vector<std::shared_ptr<ClientSocket>> expired_clients;
+
+		{
+			std::shared_lock<std::shared_mutex> lock(_client_list_mutex);
+
+			for (const auto &item : _closing_client_list)
+			{
+				if (item.second->IsSendQueueExpired())
+				{
+					expired_clients.push_back(item.second);
+				}
+			}
+		}
+
+		for (const auto &client : expired_clients)
+		{
+			logtw("[%p] [#%d] Could not send the remaining data to %s in time", this, _socket.GetSocket(), client->ToString().CStr());
+			CloseClosingClient(client);
+		}
 	}
 
 	bool ServerSocket::Close()
 	{
 		_client_list_mutex.lock();
 		auto client_list = std::move(_client_list);
+		auto closing_client_list = std::move(_closing_client_list);
 		_client_list_mutex.unlock();
 
 		for (const auto &client : client_list)
@@ -295,6 +681,11 @@ namespace ov
 			client.second->Close();
 		}
 
+		for (const auto &client : closing_client_list)
+		{
+			client.second->CloseInternal();
+		}
+
 		return Socket::Close();
 	}
 
@@ -339,6 +730,17 @@ namespace ov
 				_connection_callback(client_socket->GetSharedPtrAs<ClientSocket>(), state, error);
 			}
 
+			if ((client_socket->GetState() == SocketState::Connected) && client_socket->RequestCloseAfterFlush())
+			{
+				// Keep the socket in epoll until the queued data is sent (or CLIENT_SOCKET_SEND_TIMEOUT elapses)
+				logtd("[%p] [#%d] The client %s will be closed after %zu bytes are sent", this, _socket.GetSocket(), client_socket->ToString().CStr(), client_socket->GetSendQueueSize());
+
+				std::lock_guard<std::shared_mutex> lock(_client_list_mutex);
+				_closing_client_list[client_socket.get()] = client_socket;
+
+				return true;
+			}
+
 			if (RemoveFromEpoll(client_socket.get()))
 			{
 				if (client_socket->GetState() != SocketState::Closed)
@@ -366,7 +768,7 @@ namespace ov
 		return false;
 	}
 
-	bool ServerSocket::SetSocketOptions(SocketType type, int send_buffer_size, int recv_buffer_size)
+	bool ServerSocket::SetSocketOptions(SocketType type, int send_buffer_size, int recv_buffer_size, bool reuse_port)
 	{
 		// SRT socket is already non-block mode
 		bool result = true;
@@ -374,6 +776,18 @@ namespace ov
 		if (type == SocketType::Tcp)
 		{
 			result &= SetSockOpt<int>(SO_REUSEADDR, 1);
+
+			if (reuse_port)
+			{
+				// The kernel distributes the incoming connections among the sockets bound to the same address
+				result &= SetSockOpt<int>(SO_REUSEPORT, 1);
+			}
+
+			if ((_accept_options.fast_open_queue > 0) && (SetSockOpt<int>(IPPROTO_TCP, TCP_FASTOPEN, _accept_options.fast_open_queue) == false))
+			{
+				// The connections are accepted without TFO
+				logtw("[%p] [#%d] Could not enable TCP_FASTOPEN", this, _socket.GetSocket());
+			}
 			// result &= SetSockOpt<int>(IPPROTO_TCP, TCP_NODELAY, 1);
 
 			int current_send_buffer_size;
@@ -8,9 +8,11 @@
 //==============================================================================
 #pragma once
 
+#include "io_uring.h"
 #include "socket.h"
 #include "socket_address.h"
 #include "socket_datastructure.h"
+#include <atomic>
 #include <shared_mutex>
 
 namespace ov
@@ -23,18 +25,28 @@ namespace ov
 		~ServerSocket() override;
 
 		// 특정 port로 bind. backlog 지정 시, 해당 크기만큼 backlog 지정
+		// If reuse_port is true, SO_REUSEPORT is set so that several sockets can listen to the same address (TCP only)
 		bool Prepare(SocketType type,
 					 uint16_t port,
 					 int send_buffer_size,
 					 int recv_buffer_size,
-					 int backlog = SOMAXCONN);
+					 int backlog = SOMAXCONN,
+					 bool reuse_port = false);
 
 		// address에 해당하는 주소로 bind
 		bool Prepare(SocketType type,
 					 const SocketAddress &address,
 					 int send_buffer_size,
 					 int recv_buffer_size,
-					 int backlog = SOMAXCONN);
+					 int backlog = SOMAXCONN,
+					 bool reuse_port = false);
+
+		// Listens to the socket that is already listening to address (such as the one inherited from the previous process)
+		bool Inherit(int native_handle, const SocketAddress &address);
+
+		// Stops accepting the new clients, the connected clients are served until they are disconnected
+		// (The socket is not closed, because the new process shares it)
+		bool StopAccepting();
 
 		virtual bool DispatchEvent(ClientConnectionCallback connection_callback, ClientDataCallback data_callback, int timeout = Infinite);
 
@@ -50,19 +62,72 @@ namespace ov
 		virtual bool DisconnectClient(std::shared_ptr<ClientSocket> client_socket, SocketConnectionState state, const std::shared_ptr<Error> &error = nullptr);
 		virtual bool DisconnectClient(ClientSocket *client_socket, SocketConnectionState state, const std::shared_ptr<Error> &error = nullptr);
 
+		// Whether to receive the data of the clients that become readable in a DispatchEvent() with a single io_uring_enter() (Linux 5.7+)
+		// Returns false if io_uring is requested but not supported by the kernel (then recv() is used)
+		static bool SetIoUringEnabled(bool enabled);
+		static bool IsIoUringEnabled();
+
+		// The options are applied to the clients accepted after this call
+		void SetLowLatencyOptions(const TcpLowLatencyOptions &options);
+		TcpLowLatencyOptions GetLowLatencyOptions() const;
+
+		// The options are applied to the sockets prepared after this call (must be called before the ports are created)
+		// The defer_accept is applied by SetDeferAccept() of the HTTP ports
+		static void SetAcceptOptions(const TcpAcceptOptions &options);
+		static const TcpAcceptOptions &GetAcceptOptions();
+		static TcpAcceptStatistics GetAcceptStatistics();
+
+		// TCP_DEFER_ACCEPT (in seconds, 0: disabled)
+		bool SetDeferAccept(int seconds);
+
 	protected:
-		virtual bool SetSocketOptions(SocketType type, int send_buffer_size, int recv_buffer_size);
+		struct BatchReceiveItem
+		{
+			std::shared_ptr<ClientSocket> client;
+			std::shared_ptr<Data> data;
+			// The result of recv() (-errno on error)
+			int32_t result;
+		};
+
+		virtual bool SetSocketOptions(SocketType type, int send_buffer_size, int recv_buffer_size, bool reuse_port);
 
 		void DispatchAccept();
 		void DispatchEvents(const void *key, const epoll_event *event);
+		// Reads the data until EAGAIN, and hands it over to the data callback
+		void ReceiveClientData(const std::shared_ptr<ClientSocket> &client);
+		void HandleClientData(const std::shared_ptr<ClientSocket> &client, const std::shared_ptr<Data> &data);
+		// Returns false if the event is not for a batch (then it must be dispatched by DispatchEvents())
+		bool AddToBatchReceive(const void *key, const epoll_event *event);
+		void DispatchBatchReceive();
+		// Handles the events of the client that is waiting for the send queue to be flushed before closing
+		void DispatchClosingClientEvents(const std::shared_ptr<ClientSocket> &client, const epoll_event *event);
+		void CloseClosingClient(const std::shared_ptr<ClientSocket> &client);
+		void CloseExpiredClosingClients();
 
-		std::shared_mutex _client_list_mutex;
+		mutable std::shared_mutex _client_list_mutex;
 		std::map<const void *, std::shared_ptr<ClientSocket>> _client_list;
 		// To keep ClientSocket pointer while DispatchEvent() is running
 		// (In DispatchEvent(), the client_socket is not referenced as shared_ptr)
 		std::map<const void *, std::shared_ptr<ClientSocket>> _disconnected_client_list;
+		// The clients that are disconnected, but still have the data to send
+		std::map<const void *, std::shared_ptr<ClientSocket>> _closing_client_list;
 
 		ClientConnectionCallback _connection_callback = nullptr;
 		ClientDataCallback _data_callback = nullptr;
+
+		// Protected by _client_list_mutex
+		TcpLowLatencyOptions _low_latency_options;
+
+		static TcpAcceptOptions _accept_options;
+		static std::atomic<uint64_t> _accepted_count;
+		static std::atomic<uint64_t> _accept_error_count;
+		static std::atomic<uint64_t> _accept_batch_full_count;
+
+		static std::atomic<bool> _io_uring_enabled;
+		// The ring is used only by the thread that calls DispatchEvent(), it is created at the first batch
+		IoUring _io_uring;
+		// Becomes false if the ring could not be created/submitted, then recv() is used
+		bool _use_io_uring = true;
+		std::vector<BatchReceiveItem> _batch_receive_list;
 	};
 }  // namespace ov
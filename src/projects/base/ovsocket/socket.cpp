@@ -10,9 +10,13 @@
 #include "socket_private.h"
 
 #include <arpa/inet.h>
+#include <netinet/udp.h>
+#include <poll.h>
 #include <sys/fcntl.h>
 #include <unistd.h>
 #include <algorithm>
+#include <climits>
+#include <vector>
 
 #include <base/ovlibrary/ovlibrary.h>
 #include <errno.h>
@@ -25,6 +29,15 @@
 #	include <linux/sockios.h>
 #endif
 #include <sys/ioctl.h>
+#include <sys/sendfile.h>
+
+#if !defined(__APPLE__) && !defined(UDP_SEGMENT)
+// Older libc headers don't have UDP_SEGMENT (linux/udp.h, since 4.18)
+#	define UDP_SEGMENT 103
+#endif
+
+// Maximum time to wait for a blocking Send() to make progress
+#define SOCKET_SEND_WAIT_TIMEOUT (60 * 1000)
 
 #define USE_STATS_COUNTER 0
 #define USE_FILE_DUMP 0
@@ -40,9 +53,10 @@ class Epoll
 {
 	struct epoll_data_t
 	{
-		uint32_t _events; /* original event mask from epoll_event */
-		void *_ptr;		  /* original ptr from epoll_event */
-		int _filter;	  /* computed filter */
+		uint32_t _events;			  /* original event mask from epoll_event */
+		void *_ptr;					  /* original ptr from epoll_event */
+		int _filter;				  /* computed filter */
+		bool _write_filter = false;	  /* EVFILT_WRITE is added by EPOLL_CTL_MOD */
 
 		epoll_data_t(uint32_t events, void *ptr, int filter)
 			: _events(events),
@@ -122,6 +136,32 @@ public:
 					epoll_data = &_epoll_data[epfd].emplace(std::piecewise_construct, std::forward_as_tuple(fd), std::forward_as_tuple(events, event->data.ptr, ke.filter)).first->second;
 				}
 				break;
+			case EPOLL_CTL_MOD:
+				// Only toggling EPOLLOUT of the socket that was added with EPOLLIN is supported
+				if (event == nullptr)
+				{
+					return EINVAL;
+				}
+				{
+					std::lock_guard<decltype(_mutex)> lock(_mutex);
+					auto &epoll_fd_data = _epoll_data[epfd];
+					const auto it = epoll_fd_data.find(fd);
+					if ((it == epoll_fd_data.end()) || (it->second._filter != EVFILT_READ))
+					{
+						logte("socket %d has not been added to epoll %d with EPOLLIN", fd, epfd);
+						return EINVAL;
+					}
+					const bool write_filter = (event->events & EPOLLOUT);
+					if (it->second._write_filter == write_filter)
+					{
+						return 0;
+					}
+					it->second._write_filter = write_filter;
+					ke.filter = EVFILT_WRITE;
+					ke.flags = write_filter ? EV_ADD : EV_DELETE;
+					epoll_data = &it->second;
+				}
+				break;
 			case EPOLL_CTL_DEL:
 				ke.flags = EV_DELETE;
 				{
@@ -130,6 +170,14 @@ public:
 					const auto it = epoll_fd_data.find(fd);
 					if (it != epoll_fd_data.end())
 					{
+						if (it->second._write_filter)
+						{
+							struct kevent write_ke
+							{
+							};
+							EV_SET(&write_ke, fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+							kevent(epfd, &write_ke, 1, nullptr, 0, nullptr);
+						}
 						ke.filter = it->second._filter;
 						epoll_fd_data.erase(fd);
 					}
@@ -567,6 +615,32 @@ namespace ov
 		return true;
 	}
 
+	bool Socket::Attach(SocketType type, int native_handle, const SocketAddress &address)
+	{
+		CHECK_STATE(== SocketState::Closed, false);
+
+		if (_socket.IsValid())
+		{
+			logte("SocketBase is already created: %d", _socket.GetSocket());
+			return false;
+		}
+
+		if (((type != SocketType::Tcp) && (type != SocketType::Udp)) || (native_handle == InvalidSocket))
+		{
+			logte("Could not attach the socket %d (type: %d)", native_handle, type);
+			return false;
+		}
+
+		_socket.SetSocket(type, native_handle);
+		_local_address = std::make_shared<SocketAddress>(address);
+
+		logtd("[%p] [#%d] Attached to %s", this, _socket.GetSocket(), address.ToString().CStr());
+
+		SetState(SocketState::Bound);
+
+		return true;
+	}
+
 	bool Socket::Listen(int backlog)
 	{
 		CHECK_STATE(== SocketState::Bound, false);
@@ -621,7 +695,12 @@ namespace ov
 				sockaddr_in client_addr{};
 				socklen_t client_length = sizeof(client_addr);
 
+#if defined(__APPLE__)
 				socket_t client_socket = ::accept(_socket.GetSocket(), reinterpret_cast<sockaddr *>(&client_addr), &client_length);
+#else   // defined(__APPLE__)
+				// The client is created non-blocking, and is not inherited by the child processes (such as the scripts of the hooks)
+				socket_t client_socket = ::accept4(_socket.GetSocket(), reinterpret_cast<sockaddr *>(&client_addr), &client_length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#endif  // defined(__APPLE__)
 
 				if (client_socket != InvalidSocket)
 				{
@@ -884,6 +963,9 @@ namespace ov
 
 				int count = ::epoll_wait(_epoll, _epoll_events, EpollMaxEvents, timeout);
 
+				// The events of this iteration are handled with the same "now"
+				Clock::UpdateCachedNow();
+
 				if (count == -1)
 				{
 					// epoll_wait 호출 도중 오류 발생
@@ -935,6 +1017,8 @@ namespace ov
 
 				int result = ::srt_epoll_wait(_srt_epoll, read_list, &count, nullptr, nullptr, timeout, nullptr, nullptr, nullptr, nullptr);
 
+				Clock::UpdateCachedNow();
+
 				if (result > 0)
 				{
 					if (count == 0)
@@ -1036,6 +1120,52 @@ namespace ov
 		return &(_epoll_events[index]);
 	}
 
+	bool Socket::ModifyEpoll(Socket *socket, void *parameter, bool wait_for_output)
+	{
+		CHECK_STATE(== SocketState::Listening, false);
+
+		switch (GetType())
+		{
+			case SocketType::Tcp:
+			case SocketType::Udp:
+			{
+				if (_epoll == InvalidSocket)
+				{
+					logte("[%p] [#%d] Invalid epoll descriptor: %d", this, _socket.GetSocket(), _epoll);
+					OV_ASSERT2(_epoll != InvalidSocket);
+					return false;
+				}
+
+				epoll_event event{};
+
+				event.data.ptr = parameter;
+				event.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP | (wait_for_output ? EPOLLOUT : 0);
+
+				logtd("[%p] [#%d] Trying to %s EPOLLOUT of socket #%d...", this, _socket.GetSocket(), wait_for_output ? "enable" : "disable", socket->_socket.GetSocket());
+
+				int result = ::epoll_ctl(_epoll, EPOLL_CTL_MOD, socket->_socket.GetSocket(), &event);
+
+				if (result != -1)
+				{
+					return true;
+				}
+
+				logte("[%p] [#%d] Could not modify epoll for descriptor %d (error: %s)", this, _socket.GetSocket(), socket->_socket.GetSocket(), Error::CreateErrorFromErrno()->ToString().CStr());
+				break;
+			}
+
+			case SocketType::Srt:
+				// SRT sockets are sent by srt_sendmsg2() which doesn't need EPOLLOUT
+				OV_ASSERT2(false);
+				break;
+
+			default:
+				break;
+		}
+
+		return false;
+	}
+
 	bool Socket::RemoveFromEpoll(Socket *socket)
 	{
 		CHECK_STATE(== SocketState::Listening, false);
@@ -1159,6 +1289,40 @@ namespace ov
 		return true;
 	}
 
+	bool Socket::GetSockOpt(SRT_SOCKOPT option, void *value, int *value_length) const
+	{
+		CHECK_STATE(!= SocketState::Closed, false);
+
+		int result = ::srt_getsockflag(_socket.GetSocket(), option, value, value_length);
+
+		if (result == SRT_ERROR)
+		{
+			logtw("[%p] [#%d] Could not get option: %d (result: %s)", this, _socket.GetSocket(), option, srt_getlasterror_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	ov::String Socket::GetStreamId() const
+	{
+		if (GetType() != SocketType::Srt)
+		{
+			return "";
+		}
+
+		// The stream id is up to 512 characters
+		char stream_id[513];
+		int stream_id_length = sizeof(stream_id) - 1;
+
+		if (GetSockOpt(SRTO_STREAMID, stream_id, &stream_id_length) == false)
+		{
+			return "";
+		}
+
+		return ov::String(stream_id, stream_id_length);
+	}
+
 	SocketState Socket::GetState() const
 	{
 		return _state;
@@ -1209,10 +1373,9 @@ namespace ov
 
 					if (sent < 0L)
 					{
-						if (errno == EAGAIN)
+						if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
 						{
-							// Suppress 'Resource temporarily available' error
-							::usleep(100);
+							// The socket buffer is full - the caller decides whether to wait for EPOLLOUT or to queue the remains
 							return total_sent;
 						}
 						else if (errno == EBADF)
@@ -1293,9 +1456,214 @@ namespace ov
 		return total_sent;
 	}
 
+	ssize_t Socket::SendInternal(const struct iovec *buffers, size_t count)
+	{
+		if (GetType() != SocketType::Tcp)
+		{
+			// Send the buffers one by one
+			size_t total_sent = 0L;
+
+			for (size_t index = 0; index < count; index++)
+			{
+				auto sent = SendInternal(buffers[index].iov_base, buffers[index].iov_len);
+
+				if (sent < 0L)
+				{
+					return sent;
+				}
+
+				total_sent += sent;
+
+				if (static_cast<size_t>(sent) < buffers[index].iov_len)
+				{
+					break;
+				}
+			}
+
+			return total_sent;
+		}
+
+		// sendmsg() may send the buffers partially, so the remains are tracked with a copy of the vectors
+		std::vector<struct iovec> remained_buffers(buffers, buffers + count);
+		size_t index = 0;
+		size_t total_sent = 0L;
+
+		logtd("[%p] [#%d] Trying to send %zu buffers...", this, _socket.GetSocket(), count);
+
+		while ((index < count) && (_force_stop == false))
+		{
+			if (remained_buffers[index].iov_len == 0)
+			{
+				index++;
+				continue;
+			}
+
+			int sock = _socket.GetSocket();
+			msghdr message{};
+
+			message.msg_iov = remained_buffers.data() + index;
+			message.msg_iovlen = std::min(count - index, static_cast<size_t>(IOV_MAX));
+
+			ssize_t sent = ::sendmsg(sock, &message, MSG_NOSIGNAL | (_is_nonblock ? MSG_DONTWAIT : 0));
+
+			if (sent < 0L)
+			{
+				if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				{
+					return total_sent;
+				}
+				else if ((errno != EBADF) && (errno != EPIPE))
+				{
+					logtw("[%p] [#%d] Could not send data: %zd (%s)", this, sock, sent, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+				}
+
+				return sent;
+			}
+
+			total_sent += sent;
+
+			// Skip the buffers that are sent
+			size_t remained = sent;
+
+			while ((index < count) && (remained >= remained_buffers[index].iov_len))
+			{
+				remained -= remained_buffers[index].iov_len;
+				index++;
+			}
+
+			if (remained > 0)
+			{
+				auto &buffer = remained_buffers[index];
+
+				buffer.iov_base = static_cast<uint8_t *>(buffer.iov_base) + remained;
+				buffer.iov_len -= remained;
+			}
+		}
+
+		logtd("[%p] [#%d] %zu bytes sent", this, _socket.GetSocket(), total_sent);
+
+		return total_sent;
+	}
+
+	ssize_t Socket::SendFileInternal(int file_descriptor, off_t offset, size_t length)
+	{
+		if (GetType() != SocketType::Tcp)
+		{
+			OV_ASSERT(false, "sendfile() is supported only for TCP sockets");
+			return -1L;
+		}
+
+		logtd("[%p] [#%d] Trying to send %zu bytes from the file #%d (offset: %jd)...", this, _socket.GetSocket(), length, file_descriptor, static_cast<intmax_t>(offset));
+
+		size_t remained = length;
+		size_t total_sent = 0L;
+
+		while ((remained > 0L) && (_force_stop == false))
+		{
+			int sock = _socket.GetSocket();
+			// sendfile() updates the offset
+			ssize_t sent = ::sendfile(sock, file_descriptor, &offset, remained);
+
+			if (sent < 0L)
+			{
+				if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				{
+					return total_sent;
+				}
+				else if ((errno != EBADF) && (errno != EPIPE))
+				{
+					logtw("[%p] [#%d] Could not send the file: %zd (%s)", this, sock, sent, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+				}
+
+				return sent;
+			}
+
+			if (sent == 0L)
+			{
+				// The file is shorter than expected
+				logtw("[%p] [#%d] Could not send the file: unexpected end of file (%zu bytes remained)", this, sock, remained);
+				return -1L;
+			}
+
+			remained -= sent;
+			total_sent += sent;
+		}
+
+		logtd("[%p] [#%d] %zu bytes sent from the file", this, _socket.GetSocket(), total_sent);
+
+		return total_sent;
+	}
+
+	bool Socket::WaitForWritable(int timeout)
+	{
+		switch (GetType())
+		{
+			case SocketType::Udp:
+			case SocketType::Tcp:
+			{
+				pollfd fd{};
+
+				fd.fd = _socket.GetSocket();
+				fd.events = POLLOUT;
+
+				int result = ::poll(&fd, 1, timeout);
+
+				if (result > 0)
+				{
+					return OV_CHECK_FLAG(fd.revents, POLLOUT);
+				}
+
+				if (result == 0)
+				{
+					logtw("[%p] [#%d] Timed out while waiting for the socket to become writable", this, _socket.GetSocket());
+				}
+				else
+				{
+					logtw("[%p] [#%d] Could not wait for the socket to become writable: %s", this, _socket.GetSocket(), Error::CreateErrorFromErrno()->ToString().CStr());
+				}
+
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		return false;
+	}
+
 	ssize_t Socket::Send(const void *data, size_t length)
 	{
-		return SendInternal(data, length);
+		auto data_to_send = static_cast<const uint8_t *>(data);
+		size_t remained = length;
+		size_t total_sent = 0L;
+
+		while (true)
+		{
+			ssize_t sent = SendInternal(data_to_send, remained);
+
+			if (sent < 0L)
+			{
+				return (total_sent > 0) ? total_sent : sent;
+			}
+
+			remained -= sent;
+			total_sent += sent;
+			data_to_send += sent;
+
+			if ((remained == 0) || (GetType() != SocketType::Tcp) || (_is_nonblock == false) || (_force_stop))
+			{
+				break;
+			}
+
+			// The socket that doesn't have a dispatcher waits for the kernel to free the buffer, instead of busy-waiting
+			if (WaitForWritable(SOCKET_SEND_WAIT_TIMEOUT) == false)
+			{
+				break;
+			}
+		}
+
+		return total_sent;
 	}
 
 	ssize_t Socket::Send(const std::shared_ptr<const Data> &data)
@@ -1310,6 +1678,74 @@ namespace ov
 		return Send(data->GetData(), data->GetLength());
 	}
 
+	ssize_t Socket::Send(const DataChain &chain)
+	{
+		if (chain.IsEmpty())
+		{
+			return 0LL;
+		}
+
+		if (GetType() != SocketType::Tcp)
+		{
+			// Each send() of UDP/SRT is a message, so the slices are sent as one message
+			return (chain.GetSliceCount() == 1) ? Send(chain.GetSlices()[0]) : Send(chain.Flatten());
+		}
+
+		std::vector<struct iovec> buffers(chain.GetSliceCount());
+		size_t count = buffers.size();
+
+		for (size_t index = 0; index < count; index++)
+		{
+			auto &slice = chain.GetSlices()[index];
+
+			buffers[index].iov_base = const_cast<void *>(slice->GetData());
+			buffers[index].iov_len = slice->GetLength();
+		}
+
+		size_t index = 0;
+		size_t total_sent = 0L;
+
+		while (true)
+		{
+			ssize_t sent = SendInternal(buffers.data() + index, count - index);
+
+			if (sent < 0L)
+			{
+				return (total_sent > 0) ? total_sent : sent;
+			}
+
+			total_sent += sent;
+
+			// Skip the buffers that are sent
+			size_t remained = sent;
+
+			while ((index < count) && (remained >= buffers[index].iov_len))
+			{
+				remained -= buffers[index].iov_len;
+				index++;
+			}
+
+			if (remained > 0)
+			{
+				buffers[index].iov_base = static_cast<uint8_t *>(buffers[index].iov_base) + remained;
+				buffers[index].iov_len -= remained;
+			}
+
+			if ((index == count) || (_is_nonblock == false) || (_force_stop))
+			{
+				break;
+			}
+
+			// The socket that doesn't have a dispatcher waits for the kernel to free the buffer, instead of busy-waiting
+			if (WaitForWritable(SOCKET_SEND_WAIT_TIMEOUT) == false)
+			{
+				break;
+			}
+		}
+
+		return total_sent;
+	}
+
 	ssize_t Socket::SendTo(const ov::SocketAddress &address, const void *data, size_t length)
 	{
 		//OV_ASSERT2(_socket.IsValid());
@@ -1370,6 +1806,162 @@ namespace ov
 		return SendTo(address, data->GetData(), data->GetLength());
 	}
 
+	ssize_t Socket::SendTo(const OutgoingDatagram *datagrams, size_t count)
+	{
+		OV_ASSERT2(datagrams != nullptr);
+
+		if (count == 0)
+		{
+			return 0;
+		}
+
+#if defined(__APPLE__)
+		constexpr bool use_sendmmsg = false;
+#else
+		bool use_sendmmsg = (GetType() == SocketType::Udp);
+#endif
+
+		if (use_sendmmsg == false)
+		{
+			ssize_t sent_count = 0;
+
+			for (size_t index = 0; index < count; index++)
+			{
+				if (SendTo(datagrams[index].address, datagrams[index].data) >= 0)
+				{
+					sent_count++;
+				}
+			}
+
+			return (sent_count > 0) ? sent_count : -1;
+		}
+
+#if !defined(__APPLE__)
+		logtd("[%p] [#%d] Trying to send %zu datagrams...", this, _socket.GetSocket(), count);
+
+		// Control message buffer for UDP_SEGMENT
+		union GsoControl
+		{
+			char buffer[CMSG_SPACE(sizeof(uint16_t))];
+			cmsghdr align;
+		};
+
+		mmsghdr messages[MaxSendMessageCount];
+		iovec iovecs[MaxSendMessageCount * MaxUdpGsoSegmentCount];
+		GsoControl controls[MaxSendMessageCount];
+		// The number of datagrams contained in each message
+		size_t datagram_counts[MaxSendMessageCount];
+
+		size_t sent_count = 0;
+
+		while ((sent_count < count) && (_force_stop == false))
+		{
+			bool use_gso = _is_udp_gso_available;
+			int message_count = 0;
+			size_t iovec_index = 0;
+			size_t index = sent_count;
+
+			::memset(messages, 0, sizeof(messages));
+
+			while ((index < count) && (message_count < MaxSendMessageCount))
+			{
+				const auto &first = datagrams[index];
+				size_t segment_size = first.data->GetLength();
+				size_t total_size = segment_size;
+				size_t segment_count = 1;
+
+				auto &message = messages[message_count].msg_hdr;
+				message.msg_name = const_cast<sockaddr *>(first.address.Address());
+				message.msg_namelen = first.address.AddressLength();
+				message.msg_iov = &(iovecs[iovec_index]);
+
+				iovecs[iovec_index].iov_base = const_cast<void *>(first.data->GetData());
+				iovecs[iovec_index].iov_len = segment_size;
+				iovec_index++;
+				index++;
+
+				if (use_gso)
+				{
+					// Every segment except the last one must have the same size
+					size_t last_size = segment_size;
+
+					while ((index < count) &&
+						   (segment_count < MaxUdpGsoSegmentCount) &&
+						   (last_size == segment_size) &&
+						   (datagrams[index].address == first.address))
+					{
+						auto next_size = datagrams[index].data->GetLength();
+
+						if ((next_size > segment_size) || ((total_size + next_size) > UINT16_MAX))
+						{
+							break;
+						}
+
+						iovecs[iovec_index].iov_base = const_cast<void *>(datagrams[index].data->GetData());
+						iovecs[iovec_index].iov_len = next_size;
+						iovec_index++;
+						index++;
+
+						total_size += next_size;
+						segment_count++;
+						last_size = next_size;
+					}
+				}
+
+				message.msg_iovlen = segment_count;
+
+				if (segment_count > 1)
+				{
+					message.msg_control = controls[message_count].buffer;
+					message.msg_controllen = sizeof(controls[message_count].buffer);
+
+					auto control_message = CMSG_FIRSTHDR(&message);
+					control_message->cmsg_level = SOL_UDP;
+					control_message->cmsg_type = UDP_SEGMENT;
+					control_message->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+					*(reinterpret_cast<uint16_t *>(CMSG_DATA(control_message))) = static_cast<uint16_t>(segment_size);
+				}
+
+				datagram_counts[message_count] = segment_count;
+				message_count++;
+			}
+
+			int result = ::sendmmsg(_socket.GetSocket(), messages, message_count, MSG_NOSIGNAL | (_is_nonblock ? MSG_DONTWAIT : 0));
+
+			if (result < 0)
+			{
+				if (errno == EAGAIN)
+				{
+					// The send buffer is full. The rest is dropped like a datagram lost on the network,
+					// instead of spinning on sendmmsg() or blocking the caller until the buffer is freed
+					logtd("[%p] [#%d] The send buffer is full, %zu/%zu datagrams are not sent", this, _socket.GetSocket(), count - sent_count, count);
+					break;
+				}
+
+				if (use_gso && ((errno == EIO) || (errno == EINVAL) || (errno == ENOPROTOOPT)))
+				{
+					// GSO is not supported by the kernel or the device
+					logtw("[%p] [#%d] UDP GSO is not available, fall back to sendmmsg() without GSO: %s", this, _socket.GetSocket(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+					_is_udp_gso_available = false;
+					continue;
+				}
+
+				logtw("[%p] [#%d] Could not send datagrams: %s", this, _socket.GetSocket(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+				break;
+			}
+
+			for (int message_index = 0; message_index < result; message_index++)
+			{
+				sent_count += datagram_counts[message_index];
+			}
+		}
+
+		logtd("[%p] [#%d] %zu/%zu datagrams sent", this, _socket.GetSocket(), sent_count, count);
+
+		return (sent_count > 0) ? static_cast<ssize_t>(sent_count) : -1;
+#endif  // !defined(__APPLE__)
+	}
+
 	std::shared_ptr<ov::Error> Socket::Recv(std::shared_ptr<Data> &data)
 	{
 		OV_ASSERT2(data != nullptr);
@@ -1377,7 +1969,8 @@ namespace ov
 
 		size_t read_bytes;
 
-		data->SetLength(data->GetCapacity());
+		// The bytes are overwritten by recv(), so they don't need to be initialized
+		data->SetLengthUninitialized(data->GetCapacity());
 
 		auto error = Recv(data->GetWritableData(), data->GetLength(), &read_bytes);
 
@@ -1527,7 +2120,7 @@ namespace ov
 				socklen_t remote_length = sizeof(remote);
 
 				logtd("[%p] [#%d] Trying to read from the socket...", this, _socket.GetSocket());
-				data->SetLength(data->GetCapacity());
+				data->SetLengthUninitialized(data->GetCapacity());
 
 				ssize_t read_bytes = ::recvfrom(_socket.GetSocket(), data->GetWritableData(), (size_t)data->GetLength(), (_is_nonblock ? MSG_DONTWAIT : 0), (sockaddr *)&remote, &remote_length);
 
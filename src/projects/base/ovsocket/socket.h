@@ -60,6 +60,7 @@ int epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
 #include <sys/epoll.h>
 #endif
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <functional>
 #include <map>
@@ -83,6 +84,11 @@ namespace ov
 
 	constexpr const int MaxSrtPacketSize = 1316;
 
+	// Maximum number of messages passed to a single sendmmsg() call
+	constexpr const int MaxSendMessageCount = 64;
+	// Maximum number of segments in a UDP GSO message (UDP_MAX_SEGMENTS in the kernel)
+	constexpr const int MaxUdpGsoSegmentCount = 64;
+
 	enum class SocketType : char
 	{
 		Unknown,
@@ -217,6 +223,13 @@ namespace ov
 		} _socket{InvalidSocket};
 	};
 
+	// A datagram that is sent by Socket::SendTo(datagrams, count)
+	struct OutgoingDatagram
+	{
+		SocketAddress address;
+		std::shared_ptr<const Data> data;
+	};
+
 	class Socket : public EnableSharedFromThis<Socket>
 	{
 	public:
@@ -231,6 +244,8 @@ namespace ov
 		virtual bool MakeNonBlocking();
 
 		virtual bool Bind(const SocketAddress &address);
+		// Takes the ownership of a TCP/UDP socket that is already bound to address (such as the one inherited from the previous process)
+		virtual bool Attach(SocketType type, int native_handle, const SocketAddress &address);
 		virtual bool Listen(int backlog = SOMAXCONN);
 		virtual SocketWrapper Accept(SocketAddress *client);
 		virtual std::shared_ptr<ov::Error> Connect(const SocketAddress &endpoint, int timeout = Infinite);
@@ -241,6 +256,8 @@ namespace ov
 		virtual bool AddToEpoll(Socket *socket, void *parameter);
 		virtual int EpollWait(int timeout = Infinite);
 		virtual const epoll_event *EpollEvents(int index);
+		// Enables/disables EPOLLOUT for the socket that was added using AddToEpoll()
+		virtual bool ModifyEpoll(Socket *socket, void *parameter, bool wait_for_output);
 		virtual bool RemoveFromEpoll(Socket *socket);
 
 		std::shared_ptr<SocketAddress> GetLocalAddress() const;
@@ -278,6 +295,11 @@ namespace ov
 		}
 
 		virtual bool SetSockOpt(SRT_SOCKOPT option, const void *value, int value_length);
+		// value_length: [in] the size of the value, [out] the length of the option
+		virtual bool GetSockOpt(SRT_SOCKOPT option, void *value, int *value_length) const;
+
+		// The SRTO_STREAMID which is sent by the caller (SRT only)
+		ov::String GetStreamId() const;
 
 		// 현재 소켓의 접속 상태
 		SocketState GetState() const;
@@ -297,13 +319,36 @@ namespace ov
 		// 소켓 타입
 		SocketType GetType() const;
 
+		// The context of the upper layer that is attached to the socket (such as HttpClient),
+		// so the layer doesn't need to look it up for each received data
+		void SetUserData(const std::shared_ptr<void> &user_data)
+		{
+			std::atomic_store(&_user_data, user_data);
+		}
+
+		template <typename T>
+		std::shared_ptr<T> GetUserDataAs() const
+		{
+			return std::static_pointer_cast<T>(std::atomic_load(&_user_data));
+		}
+
 		// 데이터 송신
 		virtual ssize_t Send(const void *data, size_t length);
 		virtual ssize_t Send(const std::shared_ptr<const Data> &data);
+		// Sends the slices as one stream of bytes without concatenating them (sendmsg() with the slices for TCP,
+		// and a message for the datagram-oriented sockets)
+		virtual ssize_t Send(const DataChain &chain);
 
 		virtual ssize_t SendTo(const ov::SocketAddress &address, const void *data, size_t length);
 		virtual ssize_t SendTo(const ov::SocketAddress &address, const std::shared_ptr<const Data> &data);
 
+		// Sends the datagrams using as few sendmmsg() calls as possible (UDP only).
+		// Consecutive datagrams to the same address are coalesced with UDP GSO if the kernel supports it.
+		// If the send buffer is full (EAGAIN), the remaining datagrams are not sent.
+		//
+		// @return the number of datagrams sent, -1 if nothing could be sent
+		virtual ssize_t SendTo(const OutgoingDatagram *datagrams, size_t count);
+
 		// 데이터 수신
 		// 최대 ByteData의 capacity만큼 데이터를 기록
 		// false가 반환되면 error를 체크해야 함
@@ -325,7 +370,17 @@ namespace ov
 		static String StringFromEpollEvent(const epoll_event *event);
 		static String StringFromEpollEvent(const epoll_event &event);
 
+		// Sends the data as much as possible without blocking
+		// (If the socket is non-blocking, returns the number of bytes sent before EAGAIN occurs)
 		ssize_t SendInternal(const void *data, size_t length);
+		// Sends the buffers with as few sendmsg() calls as possible (TCP only)
+		// (If the socket is non-blocking, returns the number of bytes sent before EAGAIN occurs)
+		ssize_t SendInternal(const struct iovec *buffers, size_t count);
+		// Sends the contents of the file using sendfile() without copying it to the user space (TCP only)
+		// (If the socket is non-blocking, returns the number of bytes sent before EAGAIN occurs)
+		ssize_t SendFileInternal(int file_descriptor, off_t offset, size_t length);
+		// Waits until the socket becomes writable (TCP/UDP only)
+		bool WaitForWritable(int timeout);
 		std::shared_ptr<ov::Error> RecvInternal(void *data, size_t length, size_t *received_length);
 		
 		virtual String ToString(const char *class_name) const;
@@ -341,6 +396,9 @@ namespace ov
 
 		bool _is_nonblock = false;
 
+		// Becomes false when the kernel (or the NIC) rejects UDP_SEGMENT
+		bool _is_udp_gso_available = true;
+
 		// Related to epoll
 		// for normal socket
 		socket_t _epoll = InvalidSocket;
@@ -351,5 +409,8 @@ namespace ov
 		int _last_epoll_event_count = 0;
 
 		volatile bool _force_stop = false;
+
+		// Accessed with std::atomic_load()/std::atomic_store()
+		std::shared_ptr<void> _user_data;
 	};
 }  // namespace ov
@@ -446,6 +446,42 @@ namespace ov
 		return &(_address_ipv6->sin6_addr);
 	}
 
+	size_t SocketAddress::GetHash() const noexcept
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+
+		auto update = [&hash](const void *data, size_t length) {
+			auto bytes = static_cast<const uint8_t *>(data);
+
+			for(size_t index = 0; index < length; index++)
+			{
+				hash ^= bytes[index];
+				hash *= 1099511628211ULL;
+			}
+		};
+
+		update(&(_address_storage.ss_family), sizeof(_address_storage.ss_family));
+
+		switch(_address_storage.ss_family)
+		{
+			case AF_INET:
+				update(&(_address_ipv4->sin_port), sizeof(_address_ipv4->sin_port));
+				update(&(_address_ipv4->sin_addr), sizeof(_address_ipv4->sin_addr));
+				break;
+
+			case AF_INET6:
+				update(&(_address_ipv6->sin6_port), sizeof(_address_ipv6->sin6_port));
+				update(&(_address_ipv6->sin6_addr), sizeof(_address_ipv6->sin6_addr));
+				break;
+
+			default:
+				break;
+		}
+
+		return static_cast<size_t>(hash);
+	}
+
 	socklen_t SocketAddress::AddressLength() const noexcept
 	{
 		switch(_address_storage.ss_family)
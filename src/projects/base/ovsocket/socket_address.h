@@ -102,6 +102,9 @@ namespace ov
 
 		socklen_t AddressLength() const noexcept;
 
+		// Hash of the family, IP address and port (for unordered containers)
+		size_t GetHash() const noexcept;
+
 		void UpdateIPAddress();
 
 		ov::String ToString() const noexcept;
@@ -115,4 +118,16 @@ namespace ov
 		ov::String _hostname;
 		ov::String _ip_address;
 	};
-}
\ No newline at end of file
+}
+
+namespace std
+{
+	template <>
+	struct hash<ov::SocketAddress>
+	{
+		size_t operator()(const ov::SocketAddress &address) const noexcept
+		{
+			return address.GetHash();
+		}
+	};
+}  // namespace std
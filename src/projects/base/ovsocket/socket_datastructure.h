@@ -50,6 +50,51 @@ namespace ov
 
 	typedef std::function<void(const std::shared_ptr<ov::DatagramSocket> &client, const SocketAddress &remote_address, const std::shared_ptr<Data> &data)> DatagramCallback;
 
+	// The options that bound the time the data of a TCP client waits before it is sent, instead of the buffer size
+	// (See ServerSocket::SetLowLatencyOptions())
+	struct TcpLowLatencyOptions
+	{
+		bool enabled = false;
+		// TCP_NOTSENT_LOWAT: The unsent bytes that can be in the socket buffer (0: kernel default)
+		// The rest waits in the send queue of the ClientSocket, where the sender can still drop it
+		int not_sent_low_watermark = 0;
+		// SO_MAX_PACING_RATE: in bytes per second (0: not paced)
+		int64_t max_pacing_rate = 0;
+		// The data queued for longer than this (in milliseconds) is considered as late (0: never late)
+		int max_queue_delay = 0;
+	};
+
+	// The options of the listening TCP sockets to absorb the bursts of the connections (See ServerSocket::SetAcceptOptions())
+	struct TcpAcceptOptions
+	{
+		// The backlog of listen() (capped by net.core.somaxconn)
+		int backlog = 4096;
+		// The connections that are accepted per event, the events of the clients are handled before the rest are accepted
+		int batch_size = 64;
+		// TCP_DEFER_ACCEPT of the HTTP ports: in seconds (0: disabled)
+		// The connection is accepted when the request arrives, so the connections without the request don't occupy the workers
+		int defer_accept = 0;
+		// TCP_FASTOPEN: the length of the queue of the pending TFO connections (0: disabled)
+		// The repeat clients send the request in the SYN (net.ipv4.tcp_fastopen must include 2)
+		int fast_open_queue = 0;
+	};
+
+	// The accepts of all the server sockets
+	struct TcpAcceptStatistics
+	{
+		uint64_t accepted_count = 0;
+		uint64_t error_count = 0;
+		// The times the batch was full (the rest were accepted in the next event loop)
+		uint64_t batch_full_count = 0;
+	};
+
 	const ssize_t TcpBufferSize = 4096;
 	const ssize_t UdpBufferSize = 4096;
+	// The size of receive buffer if UDP_GRO is enabled (A coalesced datagram can be up to 64KB)
+	const ssize_t UdpGroBufferSize = 65535;
+
+	// The number of datagrams that can be received at once using recvmmsg()
+	const int DefaultReceiveBatchSize = 32;
+	// The maximum number of idle receive buffers per DatagramSocket
+	const size_t MaxFreeReceiveBufferCount = 1024;
 }  // namespace ov
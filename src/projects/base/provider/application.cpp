@@ -117,13 +117,9 @@ namespace pvd
 
 	bool StreamMotor::AddStream(const std::shared_ptr<Stream> &stream)
 	{
-		std::unique_lock<std::shared_mutex> lock(_streams_map_guard);
-		_streams[stream->GetId()] = stream;
-		lock.unlock();
-
 		stream->Play();
 
-		if(!AddStreamToEpoll(stream))
+		if(!AttachStream(stream))
 		{
 			DelStream(stream);
 			return false;
@@ -136,36 +132,172 @@ namespace pvd
 
 	bool StreamMotor::DelStream(const std::shared_ptr<Stream> &stream)
 	{
+		if(!DetachStream(stream))
+		{
+			// may be already deleted
+			return false;
+		}
+
+		logti("%s/%s(%u) stream has deleted from %u StreamMotor", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId(), GetId());
+
+		stream->Stop();
+
+		return true;
+	}
+
+	bool StreamMotor::AttachStream(const std::shared_ptr<Stream> &stream)
+	{
+		std::lock_guard<std::mutex> process_lock(_process_lock);
+
+		std::unique_lock<std::shared_mutex> lock(_streams_map_guard);
+		_streams[stream->GetId()] = stream;
+		lock.unlock();
+
+		auto &load_info = _stream_loads[stream->GetId()];
+		auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(stream));
+		if(stream_metrics != nullptr)
+		{
+			load_info.last_total_bytes_in = stream_metrics->GetTotalBytesIn();
+		}
+
+		return AddStreamToEpoll(stream);
+	}
+
+	bool StreamMotor::DetachStream(const std::shared_ptr<Stream> &stream)
+	{
+		// Wait until the stream is processed if WorkerThread is processing it
+		std::lock_guard<std::mutex> process_lock(_process_lock);
+
 		std::unique_lock<std::shared_mutex> lock(_streams_map_guard);
 		if(_streams.find(stream->GetId()) == _streams.end())
 		{
-			// may be already deleted
 			return false;
 		}
 		_streams.erase(stream->GetId());
 		lock.unlock();
 
-		logti("%s/%s(%u) stream has deleted from %u StreamMotor", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId(), GetId());
+		_stream_loads.erase(stream->GetId());
 
 		DelStreamFromEpoll(stream);
-		stream->Stop();
 
 		return true;
 	}
 
+	void StreamMotor::UpdateLoad()
+	{
+		std::lock_guard<std::mutex> process_lock(_process_lock);
+
+		auto current = std::chrono::steady_clock::now();
+		double elapsed_sec = std::chrono::duration_cast<std::chrono::milliseconds>(current - _last_load_update_time).count() / 1000.0;
+		_last_load_update_time = current;
+
+		if(elapsed_sec <= 0.0)
+		{
+			return;
+		}
+
+		std::shared_lock<std::shared_mutex> lock(_streams_map_guard);
+		for(auto &x : _stream_loads)
+		{
+			auto &load_info = x.second;
+			auto item = _streams.find(x.first);
+
+			if(item != _streams.end())
+			{
+				auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(item->second));
+				if(stream_metrics != nullptr)
+				{
+					auto total_bytes_in = stream_metrics->GetTotalBytesIn();
+					if(total_bytes_in >= load_info.last_total_bytes_in)
+					{
+						load_info.load.bytes_per_second = (total_bytes_in - load_info.last_total_bytes_in) / elapsed_sec;
+					}
+					load_info.last_total_bytes_in = total_bytes_in;
+				}
+			}
+
+			load_info.load.packets_per_second = load_info.packet_count / elapsed_sec;
+			load_info.packet_count = 0;
+		}
+		lock.unlock();
+
+		std::lock_guard<std::mutex> latency_lock(_loop_latency_lock);
+		_last_average_loop_latency_usec = (_loop_count > 0) ? (_loop_total_usec / _loop_count) : 0;
+		_last_max_loop_latency_usec = _loop_max_usec;
+		_loop_count = 0;
+		_loop_total_usec = 0;
+		_loop_max_usec = 0;
+	}
+
+	StreamMotorLoad StreamMotor::GetLoad()
+	{
+		std::lock_guard<std::mutex> process_lock(_process_lock);
+		StreamMotorLoad motor_load;
+
+		for(const auto &x : _stream_loads)
+		{
+			motor_load.bytes_per_second += x.second.load.bytes_per_second;
+			motor_load.packets_per_second += x.second.load.packets_per_second;
+		}
+
+		return motor_load;
+	}
+
+	std::map<uint32_t, StreamMotorLoad> StreamMotor::GetStreamLoads()
+	{
+		std::lock_guard<std::mutex> process_lock(_process_lock);
+		std::map<uint32_t, StreamMotorLoad> stream_loads;
+
+		for(const auto &x : _stream_loads)
+		{
+			stream_loads[x.first] = x.second.load;
+		}
+
+		return stream_loads;
+	}
+
+	uint64_t StreamMotor::GetAverageLoopLatencyUsec()
+	{
+		std::lock_guard<std::mutex> latency_lock(_loop_latency_lock);
+		return _last_average_loop_latency_usec;
+	}
+
+	uint64_t StreamMotor::GetMaxLoopLatencyUsec()
+	{
+		std::lock_guard<std::mutex> latency_lock(_loop_latency_lock);
+		return _last_max_loop_latency_usec;
+	}
+
 	void StreamMotor::WorkerThread()
 	{
+		ov::ThreadMetrics thread_metrics("StreamMotor", ov::ThreadClass::Media);
+
+		auto numa_node = ov::Numa::GetNodeOf(_id);
+		if(numa_node >= 0)
+		{
+			ov::Numa::BindThread(numa_node);
+		}
+
 		while(true)
 		{
 			struct epoll_event epoll_events[MAX_EPOLL_EVENTS];
 
+			thread_metrics.BeginIdle();
 			int event_count = epoll_wait(_epoll_fd, epoll_events, MAX_EPOLL_EVENTS, EPOLL_TIMEOUT_MSEC);
+			thread_metrics.EndIdle();
+			ov::Clock::UpdateCachedNow();
 
 			if(_stop_thread_flag)
 			{
 				break;
 			}
 
+			if((event_count < 0) && (errno == EINTR))
+			{
+				// Interrupted by a signal (e.g. SIGPROF of the profiler)
+				continue;
+			}
+
 			if(event_count < 0)
 			{
 				// error
@@ -173,11 +305,18 @@ namespace pvd
 				return ;
 			}
 
+			thread_metrics.CountLoop();
+
+			auto loop_start = std::chrono::steady_clock::now();
+
 			for(int i=0; i<event_count; i++)
 			{
 				auto stream_id = epoll_events[i].data.u32;
 				auto events = epoll_events[i].events;
 
+				// The stream may be detached by another thread while it is processed
+				std::lock_guard<std::mutex> process_lock(_process_lock);
+
 				std::shared_lock<std::shared_mutex> stream_lock(_streams_map_guard);
 				auto it = _streams.find(stream_id);
 				if(it == _streams.end())
@@ -192,10 +331,12 @@ namespace pvd
 				{
 					if(stream->GetState() == Stream::State::PLAYING)
 					{
+						ov::MemoryScope memory_scope(ov::MemoryCategory::Ingest, stream->GetMemoryAccount());
+
 						auto result = stream->ProcessMediaPacket();
 						if(result == Stream::ProcessMediaResult::PROCESS_MEDIA_SUCCESS)
 						{
-							
+							_stream_loads[stream_id].packet_count++;
 						}
 						else if(result == Stream::ProcessMediaResult::PROCESS_MEDIA_TRY_AGAIN)
 						{
@@ -222,6 +363,16 @@ namespace pvd
 				}
 				
 			}
+
+			if(event_count > 0)
+			{
+				uint64_t loop_usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - loop_start).count();
+
+				std::lock_guard<std::mutex> latency_lock(_loop_latency_lock);
+				_loop_count++;
+				_loop_total_usec += loop_usec;
+				_loop_max_usec = std::max(_loop_max_usec, loop_usec);
+			}
 		}
 	}
 
@@ -305,7 +456,15 @@ namespace pvd
 			{
 				auto stream = x.second;
 			
-				if(stream->GetState() == Stream::State::STOPPED || stream->GetState() == Stream::State::ERROR)
+				if(stream->GetState() == Stream::State::ERROR)
+				{
+					// The connection to the origin is broken, try the other origins before the viewers are dropped
+					if(FailoverStream(stream) == false)
+					{
+						DeleteStream(stream);
+					}
+				}
+				else if(stream->GetState() == Stream::State::STOPPED)
 				{
 					DeleteStream(stream);
 				}
@@ -326,6 +485,17 @@ namespace pvd
 									stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId(), elapsed_time_from_last_recv);
 						}
 
+						// The origin is alive but doesn't send anything
+						if((elapsed_time_from_last_recv > MAX_PULL_STREAM_PACKET_GAP_SEC) && (stream->GetState() == Stream::State::PLAYING))
+						{
+							if(FailoverStream(stream) == false)
+							{
+								DeleteStream(stream);
+							}
+
+							continue;
+						}
+
 						if(elapsed_time_from_last_sent > MAX_UNUSED_STREAM_AVAILABLE_TIME_SEC)
 						{
 							logtw("%s/%s(%u) stream will be deleted becasue it hasn't been used for %u seconds", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId(), MAX_UNUSED_STREAM_AVAILABLE_TIME_SEC);
@@ -335,10 +505,50 @@ namespace pvd
 				}
 			}
 
+			// Streams are moved between motors by the load measured during the last period
+			std::unique_lock<std::shared_mutex> motor_lock(_streams_guard);
+			BalanceStreamMotorsInternal();
+			motor_lock.unlock();
+
 			sleep(3);
 		}
 	}
 
+	bool Application::FailoverStream(const std::shared_ptr<Stream> &stream)
+	{
+		std::shared_ptr<StreamMotor> motor;
+
+		{
+			std::shared_lock<std::shared_mutex> lock(_streams_guard);
+			motor = GetStreamMotorInternal(stream);
+		}
+
+		if(motor == nullptr)
+		{
+			return false;
+		}
+
+		// Waits until the motor finishes processing the stream, and the motor doesn't process it during the failover
+		motor->DetachStream(stream);
+
+		if(stream->Failover() == false)
+		{
+			logte("%s/%s(%u) Could not fail over to another origin", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId());
+			return false;
+		}
+
+		// The descriptor of the new connection is added to the epoll
+		if(motor->AttachStream(stream) == false)
+		{
+			motor->DetachStream(stream);
+			return false;
+		}
+
+		logti("%s/%s(%u) stream has failed over to another origin", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId());
+
+		return true;
+	}
+
 	info::stream_id_t Application::IssueUniqueStreamId()
 	{
 		return _last_issued_stream_id++;
@@ -372,11 +582,222 @@ namespace pvd
 		return nullptr;
 	}
 
-	uint32_t Application::GetStreamMotorId(const std::shared_ptr<Stream> &stream)
+	uint32_t Application::GetStreamMotorCount()
 	{
-		uint32_t hash = stream->GetId() % MAX_STREAM_MOTOR_COUNT;
+		for(const auto &cfg_provider : GetConfig().GetProviders().GetProviderList())
+		{
+			if(cfg_provider->GetType() == _provider->GetProviderType())
+			{
+				if(cfg_provider->GetStreamMotorCount() > 0)
+				{
+					return cfg_provider->GetStreamMotorCount();
+				}
+
+				break;
+			}
+		}
 
-		return hash;
+		return DEFAULT_STREAM_MOTOR_COUNT;
+	}
+
+	std::shared_ptr<StreamMotor> Application::GetIdleStreamMotorInternal(int numa_node)
+	{
+		auto motor_count = GetStreamMotorCount();
+
+		// An empty motor is always the least loaded one (the motor on the node of the stream first)
+		if(_stream_motors.size() < motor_count)
+		{
+			for(int pass = 0; pass < 2; pass++)
+			{
+				for(uint32_t motor_id = 0; motor_id < motor_count; motor_id++)
+				{
+					if((pass == 0) && (ov::Numa::GetNodeOf(motor_id) != numa_node))
+					{
+						continue;
+					}
+
+					if(_stream_motors.find(motor_id) == _stream_motors.end())
+					{
+						return CreateStreamMotorInternal(motor_id);
+					}
+				}
+			}
+		}
+
+		// The motors on the other nodes are used only if there is no motor on the node of the stream
+		bool has_same_node_motor = false;
+		for(const auto &x : _stream_motors)
+		{
+			if(ov::Numa::GetNodeOf(x.first) == numa_node)
+			{
+				has_same_node_motor = true;
+				break;
+			}
+		}
+
+		std::shared_ptr<StreamMotor> idle_motor = nullptr;
+		StreamMotorLoad idle_load;
+
+		for(const auto &x : _stream_motors)
+		{
+			auto motor = x.second;
+
+			if(has_same_node_motor && (ov::Numa::GetNodeOf(x.first) != numa_node))
+			{
+				continue;
+			}
+
+			auto load = motor->GetLoad();
+			bool is_less_loaded;
+
+			if(idle_motor == nullptr)
+			{
+				is_less_loaded = true;
+			}
+			// Compare bytes/sec first, and then packets/sec and the number of streams if they are almost the same
+			else if(std::abs(load.bytes_per_second - idle_load.bytes_per_second) > STREAM_MOTOR_LOAD_TOLERANCE)
+			{
+				is_less_loaded = (load.bytes_per_second < idle_load.bytes_per_second);
+			}
+			else if(load.packets_per_second != idle_load.packets_per_second)
+			{
+				is_less_loaded = (load.packets_per_second < idle_load.packets_per_second);
+			}
+			else
+			{
+				is_less_loaded = (motor->GetStreamCount() < idle_motor->GetStreamCount());
+			}
+
+			if(is_less_loaded)
+			{
+				idle_motor = motor;
+				idle_load = load;
+			}
+		}
+
+		return idle_motor;
+	}
+
+	void Application::BalanceStreamMotorsInternal()
+	{
+		std::shared_ptr<StreamMotor> busiest_motor = nullptr;
+		std::shared_ptr<StreamMotor> idlest_motor = nullptr;
+		StreamMotorLoad busiest_load;
+		StreamMotorLoad idlest_load;
+
+		for(const auto &x : _stream_motors)
+		{
+			auto motor = x.second;
+
+			motor->UpdateLoad();
+			auto load = motor->GetLoad();
+
+			logtd("%s application - StreamMotor(%u) streams(%u) %.0f bytes/sec %.0f packets/sec loop latency avg(%llu) max(%llu) usec",
+				  GetName().CStr(), motor->GetId(), motor->GetStreamCount(), load.bytes_per_second, load.packets_per_second,
+				  static_cast<unsigned long long>(motor->GetAverageLoopLatencyUsec()), static_cast<unsigned long long>(motor->GetMaxLoopLatencyUsec()));
+
+			if((busiest_motor == nullptr) || (load.bytes_per_second > busiest_load.bytes_per_second))
+			{
+				busiest_motor = motor;
+				busiest_load = load;
+			}
+		}
+
+		if(busiest_motor == nullptr)
+		{
+			return;
+		}
+
+		// The streams are moved between the motors on the same NUMA node, not to access the memory of the other node
+		auto numa_node = ov::Numa::GetNodeOf(busiest_motor->GetId());
+
+		for(const auto &x : _stream_motors)
+		{
+			auto motor = x.second;
+			auto load = motor->GetLoad();
+
+			if(ov::Numa::GetNodeOf(motor->GetId()) != numa_node)
+			{
+				continue;
+			}
+
+			if((idlest_motor == nullptr) || (load.bytes_per_second < idlest_load.bytes_per_second))
+			{
+				idlest_motor = motor;
+				idlest_load = load;
+			}
+		}
+
+		if((idlest_motor == nullptr) || (busiest_motor == idlest_motor) || (busiest_motor->GetStreamCount() < 2))
+		{
+			return;
+		}
+
+		double difference = busiest_load.bytes_per_second - idlest_load.bytes_per_second;
+		if(difference <= STREAM_MOTOR_LOAD_TOLERANCE)
+		{
+			return;
+		}
+
+		// Moving a stream whose load is closest to the half of the difference balances the two motors the most.
+		// Only one stream is moved at a time not to make the motors oscillate.
+		uint32_t target_stream_id = 0;
+		double target_bytes_per_second = 0.0;
+		double target_distance = 0.0;
+		bool found = false;
+
+		for(const auto &x : busiest_motor->GetStreamLoads())
+		{
+			auto bytes_per_second = x.second.bytes_per_second;
+
+			if((bytes_per_second <= 0.0) || (bytes_per_second >= difference))
+			{
+				// Moving it doesn't reduce the difference
+				continue;
+			}
+
+			auto distance = std::abs((difference / 2.0) - bytes_per_second);
+			if((found == false) || (distance < target_distance))
+			{
+				target_stream_id = x.first;
+				target_bytes_per_second = bytes_per_second;
+				target_distance = distance;
+				found = true;
+			}
+		}
+
+		if(found == false)
+		{
+			return;
+		}
+
+		auto item = _streams.find(target_stream_id);
+		if(item == _streams.end())
+		{
+			return;
+		}
+
+		auto stream = item->second;
+
+		if(busiest_motor->DetachStream(stream) == false)
+		{
+			return;
+		}
+
+		if(idlest_motor->AttachStream(stream) == false)
+		{
+			logte("%s/%s(%u) stream could not be moved to %u StreamMotor", GetName().CStr(), stream->GetName().CStr(), stream->GetId(), idlest_motor->GetId());
+
+			// it will be deleted from WhiteElephantCollector
+			_stream_motor_map.erase(stream->GetId());
+			stream->Stop();
+			return;
+		}
+
+		_stream_motor_map[stream->GetId()] = idlest_motor;
+
+		logti("%s/%s(%u) stream has moved from %u to %u StreamMotor (%.0f bytes/sec)",
+			  GetName().CStr(), stream->GetName().CStr(), stream->GetId(), busiest_motor->GetId(), idlest_motor->GetId(), target_bytes_per_second);
 	}
 
 	// For push providers
@@ -399,6 +820,15 @@ namespace pvd
 
 		NotifyStreamCreated(stream);
 
+		// The media router gives the id of the stream of the same name that it still has (a reconnected ingest, See <ReconnectGracePeriod>),
+		// so the stream is found by the new id
+		if (stream->GetId() != stream_id)
+		{
+			streams_lock.lock();
+			_streams.erase(stream_id);
+			_streams[stream->GetId()] = stream;
+		}
+
 		return stream;
 	}
 
@@ -407,17 +837,16 @@ namespace pvd
 		return CreateStream(IssueUniqueStreamId(), stream_name, tracks);
 	}
 
-	std::shared_ptr<StreamMotor> Application::CreateStreamMotorInternal(const std::shared_ptr<Stream> &stream)
+	std::shared_ptr<StreamMotor> Application::CreateStreamMotorInternal(uint32_t motor_id)
 	{
 		if(_provider->GetProviderStreamDirection() == ProviderStreamDirection::Pull)
 		{
-			auto motor_id = GetStreamMotorId(stream);
 			auto motor = std::make_shared<StreamMotor>(motor_id);
 
 			_stream_motors.emplace(motor_id, motor);
 			motor->Start();
 
-			logti("%s application has created %u stream motor", stream->GetApplicationInfo().GetName().CStr(), motor_id);
+			logti("%s application has created %u stream motor", GetName().CStr(), motor_id);
 
 			return motor;
 		}
@@ -437,11 +866,12 @@ namespace pvd
 			}
 			
 			motor->DelStream(stream);
+			_stream_motor_map.erase(stream->GetId());
 
 			if(motor->GetStreamCount() == 0)
 			{
 				motor->Stop();
-				auto motor_id = GetStreamMotorId(stream);
+				auto motor_id = motor->GetId();
 				_stream_motors.erase(motor_id);
 
 				logti("%s application has deleted %u stream motor", stream->GetApplicationInfo().GetName().CStr(), motor_id);
@@ -463,16 +893,13 @@ namespace pvd
 		std::unique_lock<std::shared_mutex> streams_lock(_streams_guard);
 		
 		_streams[stream->GetId()] = stream;
-		auto motor = GetStreamMotorInternal(stream);
+		auto motor = GetIdleStreamMotorInternal(stream->GetNumaNode());
 		if(motor == nullptr)
 		{
-			motor = CreateStreamMotorInternal(stream);
-			if(motor == nullptr)
-			{
-				logtc("Cannot create StreamMotor : %s/%s(%u)", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId());
-				return nullptr;
-			}
+			logtc("Cannot create StreamMotor : %s/%s(%u)", stream->GetApplicationInfo().GetName().CStr(), stream->GetName().CStr(), stream->GetId());
+			return nullptr;
 		}
+		_stream_motor_map[stream->GetId()] = motor;
 
 		streams_lock.unlock();
 
@@ -516,9 +943,8 @@ namespace pvd
 		std::shared_ptr<StreamMotor> motor = nullptr;;
 		if(_provider->GetProviderStreamDirection() == ProviderStreamDirection::Pull)
 		{
-			auto motor_id = GetStreamMotorId(stream);
-			auto it = _stream_motors.find(motor_id);
-			if(it == _stream_motors.end())
+			auto it = _stream_motor_map.find(stream->GetId());
+			if(it == _stream_motor_map.end())
 			{
 				logtd("Could not find stream motor : %s/%s(%u)", GetName().CStr(), stream->GetName().CStr(), stream->GetId());
 				return nullptr;
@@ -560,6 +986,7 @@ namespace pvd
 		}
 
 		_stream_motors.clear();
+		_stream_motor_map.clear();
 
 		return true;
 	}
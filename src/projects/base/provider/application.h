@@ -18,13 +18,23 @@
 
 #include <shared_mutex>
 
-//TODO(Dimiden): It has to be moved to configuration
-#define MAX_STREAM_MOTOR_COUNT					10
+// Used when <StreamMotorCount> of the provider is not configured
+#define DEFAULT_STREAM_MOTOR_COUNT				10
+// Motors whose received bytes/sec differ less than this are regarded as equally loaded
+#define STREAM_MOTOR_LOAD_TOLERANCE				(256 * 1024)
 #define MAX_UNUSED_STREAM_AVAILABLE_TIME_SEC	60
+// If packets of a pull stream do NOT arrive for this period, the origin is regarded as stalled and the stream fails over
+#define MAX_PULL_STREAM_PACKET_GAP_SEC			10
 #define MAX_EPOLL_EVENTS						1024
 #define EPOLL_TIMEOUT_MSEC						100
 namespace pvd
 {
+	struct StreamMotorLoad
+	{
+		double bytes_per_second = 0.0;
+		double packets_per_second = 0.0;
+	};
+
 	// StreamMotor is a thread for pull provider stream that calls the stream's ProcessMedia function periodically
 	class StreamMotor
 	{
@@ -40,7 +50,27 @@ namespace pvd
 		bool AddStream(const std::shared_ptr<Stream> &stream);
 		bool DelStream(const std::shared_ptr<Stream> &stream);
 
+		// Moves a playing stream between motors without stopping it
+		bool DetachStream(const std::shared_ptr<Stream> &stream);
+		bool AttachStream(const std::shared_ptr<Stream> &stream);
+
+		// Calculates the load of each stream since the last call
+		void UpdateLoad();
+		StreamMotorLoad GetLoad();
+		std::map<uint32_t, StreamMotorLoad> GetStreamLoads();
+
+		// The time taken to process the events of an epoll_wait(), it is reset when UpdateLoad() is called
+		uint64_t GetAverageLoopLatencyUsec();
+		uint64_t GetMaxLoopLatencyUsec();
+
 	private:
+		struct StreamLoadInfo
+		{
+			uint64_t last_total_bytes_in = 0;
+			uint64_t packet_count = 0;
+			StreamMotorLoad load;
+		};
+
 		bool AddStreamToEpoll(const std::shared_ptr<Stream> &stream);
 		bool DelStreamFromEpoll(const std::shared_ptr<Stream> &stream);
 
@@ -54,6 +84,19 @@ namespace pvd
 		std::thread _thread;
 		std::shared_mutex _streams_map_guard;
 		std::map<uint32_t, std::shared_ptr<Stream>> _streams;
+
+		// Held while a stream is processed, so a detached stream is never processed by two motors at the same time
+		std::mutex _process_lock;
+		// Protected by _process_lock
+		std::map<uint32_t, StreamLoadInfo> _stream_loads;
+		std::chrono::steady_clock::time_point _last_load_update_time = std::chrono::steady_clock::now();
+
+		std::mutex _loop_latency_lock;
+		uint64_t _loop_count = 0;
+		uint64_t _loop_total_usec = 0;
+		uint64_t _loop_max_usec = 0;
+		uint64_t _last_average_loop_latency_usec = 0;
+		uint64_t _last_max_loop_latency_usec = 0;
 	};
 
 	class Provider;
@@ -98,7 +141,7 @@ namespace pvd
 
 	private:
 
-		std::shared_ptr<StreamMotor> CreateStreamMotorInternal(const std::shared_ptr<Stream> &stream);
+		std::shared_ptr<StreamMotor> CreateStreamMotorInternal(uint32_t motor_id);
 		bool DeleteStreamMotorInternal(const std::shared_ptr<Stream> &stream);
 		bool DeleteStreamInternal(const std::shared_ptr<Stream> &stream);
 		std::shared_ptr<StreamMotor> GetStreamMotorInternal(const std::shared_ptr<Stream> &stream);
@@ -106,7 +149,15 @@ namespace pvd
 		bool NotifyStreamCreated(std::shared_ptr<Stream> stream);
 		bool NotifyStreamDeleted(std::shared_ptr<Stream> stream);
 
-		uint32_t GetStreamMotorId(const std::shared_ptr<Stream> &stream);
+		uint32_t GetStreamMotorCount();
+		// Returns the least loaded motor, a new motor is created if the pool is not full
+		// numa_node: The NUMA node of the stream, the motors of the node are preferred (-1: any node)
+		std::shared_ptr<StreamMotor> GetIdleStreamMotorInternal(int numa_node);
+		// Moves a stream from the most loaded motor to the least loaded one
+		void BalanceStreamMotorsInternal();
+
+		// Reconnects the stream to another origin while it is detached from the motor
+		bool FailoverStream(const std::shared_ptr<Stream> &stream);
 
 		// Remove unused streams
 		void WhiteElephantStreamCollector();
@@ -118,7 +169,10 @@ namespace pvd
 		
 		std::shared_mutex 							_streams_guard;
 		std::map<uint32_t, std::shared_ptr<Stream>> _streams;
+		// key: motor id
 		std::map<uint32_t, std::shared_ptr<StreamMotor>> _stream_motors;
+		// key: stream id
+		std::map<uint32_t, std::shared_ptr<StreamMotor>> _stream_motor_map;
 
 		ApplicationState		_state = ApplicationState::Idle;
 		std::atomic<info::stream_id_t>	_last_issued_stream_id { 0 };
@@ -38,6 +38,16 @@ namespace pvd
 
 	}
 
+	const std::shared_ptr<ov::MemoryAccount> &Stream::GetMemoryAccount()
+	{
+		if ((_memory_account == nullptr) && (GetName().IsEmpty() == false))
+		{
+			_memory_account = ov::MemoryAccounting::GetAccount(GetApplicationInfo().GetName(), GetName());
+		}
+
+		return _memory_account;
+	}
+
 	bool Stream::Start() 
 	{
 		logti("%s has started [%s(%u)] stream", _application->GetApplicationTypeName(), GetName().CStr(), GetId());
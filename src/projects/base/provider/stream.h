@@ -71,6 +71,19 @@ namespace pvd
 			return ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
 		}
 
+		// If this stream belongs to the Pull provider, 
+		// this function is called by the application when the connection to the origin is broken (or stalled).
+		// The stream connects to another origin and keeps playing with the same tracks, so it is not deleted.
+		// The stream is detached from the StreamMotor while this function is called.
+		virtual bool Failover()
+		{
+			return false;
+		}
+
+		// The account of the buffers allocated while the packets of the stream are processed (See ov::MemoryAccounting)
+		// It is created when it is called first after the stream is named, so it must be called by a thread at a time (the StreamMotor)
+		const std::shared_ptr<ov::MemoryAccount> &GetMemoryAccount();
+
 	protected:
 		Stream(const std::shared_ptr<pvd::Application> &application, StreamSourceType source_type);
 		Stream(const std::shared_ptr<pvd::Application> &application, info::stream_id_t stream_id, StreamSourceType source_type);
@@ -81,5 +94,8 @@ namespace pvd
 		State 	_state = State::IDLE;
 
 		std::shared_ptr<pvd::Application> _application;
+
+	private:
+		std::shared_ptr<ov::MemoryAccount> _memory_account;
 	};
 }
\ No newline at end of file
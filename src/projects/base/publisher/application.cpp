@@ -3,8 +3,39 @@
 #include "publisher_private.h"
 #include <algorithm>
 
+#include <base/media_route/media_queue_policy.h>
+#include <monitoring/monitoring.h>
+#include <monitoring/packet_tracer.h>
+
 namespace pub
 {
+	// The packets of all streams of the application are in the same queue, so a group is a track of a stream
+	template <typename T>
+	static void SetMediaQueueLimit(ov::Queue<std::shared_ptr<T>> &queue)
+	{
+		if (MediaQueuePolicy::IsEnabled() == false)
+		{
+			return;
+		}
+
+		queue.SetLimit(0, MediaQueuePolicy::GetMaxBytes(), MediaQueuePolicy::GetPolicy(),
+			[](const std::shared_ptr<T> &data) -> size_t {
+				return MediaQueuePolicy::GetPacketBytes(*data->_media_packet);
+			},
+			[](const std::shared_ptr<T> &data) -> ov::QueueItemClass {
+				uint64_t group = (static_cast<uint64_t>(data->_stream->GetId()) << 32) | static_cast<uint32_t>(data->_media_packet->GetTrackId());
+				return MediaQueuePolicy::Classify(*data->_media_packet, *data->_stream, group);
+			});
+
+		queue.SetDropCallback([](const std::shared_ptr<T> &data, size_t bytes) {
+			auto stream_metrics = StreamMetrics(*data->_stream);
+			if (stream_metrics != nullptr)
+			{
+				stream_metrics->OnQueuePacketDropped(bytes);
+			}
+		});
+	}
+
 	Application::Application(const std::shared_ptr<Publisher> &publisher, const info::Application &application_info)
 		: info::Application(application_info),
 		_video_stream_queue(nullptr, 100),
@@ -13,6 +44,12 @@ namespace pub
 	{
 		_publisher = publisher;
 		_stop_thread_flag = false;
+
+		_executor_group = ov::Executor::GetShared()->GetGroup(GetName().CStr(), GetSchedulingWeight(), GetMaxWorkerThreads());
+
+		// A publisher that cannot keep up drops the packets instead of holding them without limit
+		SetMediaQueueLimit(_video_stream_queue);
+		SetMediaQueueLimit(_audio_stream_queue);
 	}
 
 	Application::~Application()
@@ -35,11 +72,30 @@ namespace pub
 		return _app_type_name.CStr();
 	}
 
+	const char* Application::GetPublisherName() const
+	{
+		if(_publisher == nullptr)
+		{
+			return "";
+		}
+
+		return _publisher->GetPublisherName();
+	}
+
+	PublisherType Application::GetPublisherType() const
+	{
+		if(_publisher == nullptr)
+		{
+			return PublisherType::Unknown;
+		}
+
+		return _publisher->GetPublisherType();
+	}
+
 	bool Application::Start()
 	{
-		// Thread 생성
+		// The thread is started by StartWorkerThread()
 		_stop_thread_flag = false;
-		_worker_thread = std::thread(&Application::WorkerThread, this);
 
 		ov::String queue_name;
 
@@ -63,12 +119,23 @@ namespace pub
 		{
 			return true;
 		}
-		_stop_thread_flag = true;
-		_queue_event.Notify();
-
-		if (_worker_thread.joinable())
 		{
-			_worker_thread.join();
+			std::lock_guard<std::mutex> lock(_worker_thread_mutex);
+
+			_stop_thread_flag = true;
+
+			if (_strand != nullptr)
+			{
+				// Waits for the running Drain()
+				_strand->Stop();
+			}
+
+			_queue_event.Notify();
+
+			if (_worker_thread.joinable())
+			{
+				_worker_thread.join();
+			}
 		}
 
 		// release remaining streams
@@ -79,6 +146,57 @@ namespace pub
 		return true;
 	}
 
+	bool Application::IsDirectDispatchEnabled() const
+	{
+		return _direct_dispatch;
+	}
+
+	const std::shared_ptr<ov::Executor::Group> &Application::GetExecutorGroup() const
+	{
+		return _executor_group;
+	}
+
+	void Application::SetDirectDispatch(bool enabled)
+	{
+		_direct_dispatch = enabled;
+	}
+
+	bool Application::StartWorkerThread()
+	{
+		std::lock_guard<std::mutex> lock(_worker_thread_mutex);
+
+		if (_worker_thread.joinable() || (_strand != nullptr))
+		{
+			return true;
+		}
+
+		if (_stop_thread_flag)
+		{
+			return false;
+		}
+
+		auto executor = ov::Executor::GetShared();
+
+		if (executor->IsRunning())
+		{
+			// The queues are processed by the shared worker pool instead of a thread of this application
+			_strand = std::make_shared<ov::Strand>(executor, _executor_group);
+			return true;
+		}
+
+		try
+		{
+			_worker_thread = std::thread(&Application::WorkerThread, this);
+		}
+		catch (const std::system_error &e)
+		{
+			logte("Could not start the worker thread of %s [%s]", GetApplicationTypeName(), GetName().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
 	bool Application::DeleteAllStreams()
 	{
 		std::unique_lock<std::shared_mutex> lock(_stream_map_mutex);
@@ -90,6 +208,7 @@ namespace pub
 		}
 
 		_streams.clear();
+		_stream_name_map.clear();
 
 		return true;
 	}
@@ -98,6 +217,11 @@ namespace pub
 	// Stream이 생성되었을 때 호출된다.
 	bool Application::OnCreateStream(const std::shared_ptr<info::Stream> &info)
 	{
+		if (StartWorkerThread() == false)
+		{
+			return false;
+		}
+
 		// Stream을 자식을 통해 생성해서 연결한다.
 		auto worker_count = GetConfig().GetThreadCount();
 		auto stream = CreateStream(info, worker_count);
@@ -110,6 +234,7 @@ namespace pub
 
 		std::lock_guard<std::shared_mutex> lock(_stream_map_mutex);
 		_streams[info->GetId()] = stream;
+		_stream_name_map[info->GetName()] = stream;
 
 		return true;
 	}
@@ -137,19 +262,56 @@ namespace pub
 
 		lock.lock();
 		_streams.erase(info->GetId());
+
+		// Another stream with the same name may have been created in the meantime
+		auto name_it = _stream_name_map.find(info->GetName());
+		if ((name_it != _stream_name_map.end()) && (name_it->second == stream))
+		{
+			_stream_name_map.erase(name_it);
+		}
+
 		stream->Stop();
 
 		return true;
 	}
 
+	std::shared_ptr<mon::PacketTrace> Application::ForkTrace(const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		auto &trace = media_packet->GetTrace();
+
+		if (trace == nullptr)
+		{
+			return nullptr;
+		}
+
+		auto publisher_trace = trace->Fork(GetPublisherName());
+		publisher_trace->Mark(mon::PacketTraceStage::PublisherQueued);
+
+		return publisher_trace;
+	}
+
 	bool Application::OnSendVideoFrame(const std::shared_ptr<info::Stream> &stream,
 									   const std::shared_ptr<MediaPacket> &media_packet)
 	{
+		_last_video_ts_ms = media_packet->GetPts() * stream->GetTrack(media_packet->GetTrackId())->GetTimeBase().GetExpr() * 1000;
+
+		if (_direct_dispatch)
+		{
+			auto publisher_stream = GetStream(stream->GetId());
+			if (publisher_stream == nullptr)
+			{
+				return false;
+			}
+
+			publisher_stream->DispatchVideoFrame(media_packet, ForkTrace(media_packet));
+			return true;
+		}
+
 		auto data = std::make_shared<Application::VideoStreamData>(stream, media_packet);
+		data->_trace = ForkTrace(media_packet);
 		_video_stream_queue.Enqueue(std::move(data));
-		_last_video_ts_ms = media_packet->GetPts() * stream->GetTrack(media_packet->GetTrackId())->GetTimeBase().GetExpr() * 1000;
 
-		_queue_event.Notify();
+		Notify();
 
 		return true;
 	}
@@ -157,12 +319,26 @@ namespace pub
 	bool Application::OnSendAudioFrame(const std::shared_ptr<info::Stream> &stream,
 									   const std::shared_ptr<MediaPacket> &media_packet)
 	{
+		_last_audio_ts_ms = media_packet->GetPts() * stream->GetTrack(media_packet->GetTrackId())->GetTimeBase().GetExpr() * 1000;
+
+		if (_direct_dispatch)
+		{
+			auto publisher_stream = GetStream(stream->GetId());
+			if (publisher_stream == nullptr)
+			{
+				return false;
+			}
+
+			publisher_stream->DispatchAudioFrame(media_packet, ForkTrace(media_packet));
+			return true;
+		}
+
 		auto data = std::make_shared<Application::AudioStreamData>(stream, media_packet);
+		data->_trace = ForkTrace(media_packet);
 
 		_audio_stream_queue.Enqueue(std::move(data));
-		_last_audio_ts_ms = media_packet->GetPts() * stream->GetTrack(media_packet->GetTrackId())->GetTimeBase().GetExpr() * 1000;
 
-		_queue_event.Notify();
+		Notify();
 
 		return true;
 	}
@@ -173,7 +349,7 @@ namespace pub
 		auto packet = std::make_shared<Application::IncomingPacket>(session_info, data);
 		_incoming_packet_queue.Enqueue(std::move(packet));
 
-		_queue_event.Notify();
+		Notify();
 
 		return true;
 	}
@@ -192,17 +368,39 @@ namespace pub
 
 	std::shared_ptr<Stream> Application::GetStream(ov::String stream_name)
 	{
+		std::shared_lock<std::shared_mutex> lock(_stream_map_mutex);
+		auto it = _stream_name_map.find(stream_name);
+		if (it == _stream_name_map.end())
+		{
+			return nullptr;
+		}
+
+		return it->second;
+	}
+
+	bool Application::IsTrackSubscribed(const std::shared_ptr<info::Stream> &info, const std::shared_ptr<MediaTrack> &track)
+	{
+		auto stream = GetStream(info->GetId());
+		if (stream == nullptr)
+		{
+			// The stream could not be created, so nothing will be used
+			return false;
+		}
+
+		return stream->IsTrackSubscribed(track);
+	}
+
+	std::vector<std::shared_ptr<Stream>> Application::GetStreamList()
+	{
+		std::vector<std::shared_ptr<Stream>> stream_list;
+
 		std::shared_lock<std::shared_mutex> lock(_stream_map_mutex);
 		for (auto const &x : _streams)
 		{
-			auto stream = x.second;
-			if (stream->GetName() == stream_name)
-			{
-				return stream;
-			}
+			stream_list.push_back(x.second);
 		}
 
-		return nullptr;
+		return stream_list;
 	}
 
 	std::shared_ptr<Application::VideoStreamData> Application::PopVideoStreamData()
@@ -255,11 +453,14 @@ namespace pub
 
 	void Application::WorkerThread()
 	{
+		ov::ThreadMetrics thread_metrics("PubAppWorker", ov::ThreadClass::Media);
 		ov::StopWatch stat_stop_watch;
 		stat_stop_watch.Start();
 
 		while (!_stop_thread_flag)
 		{
+			thread_metrics.CountLoop();
+
 			if (stat_stop_watch.IsElapsed(5000) && stat_stop_watch.Update())
 			{
 				logts("Stats for publisher queue [%s(%u)]: VQ: %zu, AQ: %zu, Incoming Q: %zu",
@@ -269,31 +470,79 @@ namespace pub
 					  _incoming_packet_queue.Size());
 			}
 
+			thread_metrics.BeginIdle();
 			_queue_event.Wait();
+			thread_metrics.EndIdle();
 
-			// Check video data is available
-			std::shared_ptr<Application::VideoStreamData> video_data = PopVideoStreamData();
+			ProcessQueues();
+		}
+	}
 
-			if ((video_data != nullptr) && (video_data->_stream != nullptr) && (video_data->_media_packet != nullptr))
+	void Application::Notify()
+	{
+		if (_strand != nullptr)
+		{
+			if (_is_drain_scheduled.exchange(true) == false)
 			{
-				SendVideoFrame(video_data->_stream, video_data->_media_packet);
+				_strand->Post([this]() {
+					Drain();
+				});
 			}
 
-			// Check audio data is available
-			std::shared_ptr<Application::AudioStreamData> audio_data = PopAudioStreamData();
+			return;
+		}
 
-			if ((audio_data != nullptr) && (audio_data->_stream != nullptr) && (audio_data->_media_packet != nullptr))
-			{
-				SendAudioFrame(audio_data->_stream, audio_data->_media_packet);
-			}
+		_queue_event.Notify();
+	}
 
-			// Check incoming packet is available
-			std::shared_ptr<IncomingPacket> packet = PopIncomingPacket();
-			if (packet)
+	void Application::Drain()
+	{
+		// The items enqueued after this schedule another Drain()
+		_is_drain_scheduled = false;
+
+		for (int count = 0; count < PUBLISHER_APPLICATION_MAX_DRAIN_COUNT; count++)
+		{
+			if (ProcessQueues() == false)
 			{
-				OnPacketReceived(packet->_session_info, packet->_data);
+				return;
 			}
 		}
+
+		// Continue after the other strands
+		Notify();
+	}
+
+	bool Application::ProcessQueues()
+	{
+		// The audio is sent first, so it doesn't wait for the video frame that is packetized in the same turn
+		// (a large key frame takes much longer than the audio frames)
+		std::shared_ptr<Application::AudioStreamData> audio_data = PopAudioStreamData();
+
+		if ((audio_data != nullptr) && (audio_data->_stream != nullptr) && (audio_data->_media_packet != nullptr))
+		{
+			Stream::SetDeliveringTrace(audio_data->_trace);
+			SendAudioFrame(audio_data->_stream, audio_data->_media_packet);
+			Stream::SetDeliveringTrace(nullptr);
+		}
+
+		// Check video data is available
+		std::shared_ptr<Application::VideoStreamData> video_data = PopVideoStreamData();
+
+		if ((video_data != nullptr) && (video_data->_stream != nullptr) && (video_data->_media_packet != nullptr))
+		{
+			Stream::SetDeliveringTrace(video_data->_trace);
+			SendVideoFrame(video_data->_stream, video_data->_media_packet);
+			Stream::SetDeliveringTrace(nullptr);
+		}
+
+		// Check incoming packet is available
+		std::shared_ptr<IncomingPacket> packet = PopIncomingPacket();
+		if (packet)
+		{
+			OnPacketReceived(packet->_session_info, packet->_data);
+		}
+
+		return (video_data != nullptr) || (audio_data != nullptr) || (packet != nullptr);
 	}
 
 	void Application::SendVideoFrame(const std::shared_ptr<info::Stream> &stream_info, const std::shared_ptr<MediaPacket> &media_packet)
@@ -306,7 +555,7 @@ namespace pub
 			return;
 		}
 
-		stream->SendVideoFrame(media_packet);
+		stream->DeliverVideoFrame(media_packet);
 	}
 
 	void Application::SendAudioFrame(const std::shared_ptr<info::Stream> &stream_info, const std::shared_ptr<MediaPacket> &media_packet)
@@ -319,7 +568,7 @@ namespace pub
 			return;
 		}
 
-		stream->SendAudioFrame(media_packet);
+		stream->DeliverAudioFrame(media_packet);
 	}
 
 	void Application::OnPacketReceived(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data)
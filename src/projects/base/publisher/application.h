@@ -2,15 +2,20 @@
 
 #include <utility>
 #include <shared_mutex>
+#include <unordered_map>
 #include "base/common_types.h"
 #include "base/info/stream.h"
 #include "base/info/session.h"
 #include "base/media_route/media_route_application_observer.h"
+#include "base/ovlibrary/executor.h"
 #include "base/ovlibrary/semaphore.h"
 #include "base/ovlibrary/string.h"
 #include "config/config.h"
 #include "stream.h"
 
+// The number of the items that Application::Drain() processes at once before yielding the thread to the other strands
+#define PUBLISHER_APPLICATION_MAX_DRAIN_COUNT 64
+
 namespace pub
 {
 	enum ApplicationState
@@ -26,10 +31,13 @@ namespace pub
 	{
 	public:
 		const char* GetApplicationTypeName() final;
+		const char* GetPublisherName() const;
+		PublisherType GetPublisherType() const;
 
 		// MediaRouteApplicationObserver Implementation
 		bool OnCreateStream(const std::shared_ptr<info::Stream> &info) override;
 		bool OnDeleteStream(const std::shared_ptr<info::Stream> &info) override;
+		bool IsTrackSubscribed(const std::shared_ptr<info::Stream> &info, const std::shared_ptr<MediaTrack> &track) override;
 
 		// Queue에 데이터를 넣는다.
 		bool OnSendVideoFrame(const std::shared_ptr<info::Stream> &stream,
@@ -44,10 +52,16 @@ namespace pub
 
 		std::shared_ptr<Stream> GetStream(uint32_t stream_id);
 		std::shared_ptr<Stream> GetStream(ov::String stream_name);
+		std::vector<std::shared_ptr<Stream>> GetStreamList();
 
 		virtual bool Start();
 		virtual bool Stop();
 
+		bool IsDirectDispatchEnabled() const;
+
+		// The group of the shared worker pool that the strands of the application and its streams run on
+		const std::shared_ptr<ov::Executor::Group> &GetExecutorGroup() const;
+
 	protected:
 		explicit Application(const std::shared_ptr<Publisher> &publisher, const info::Application &application_info);
 		virtual ~Application();
@@ -62,12 +76,23 @@ namespace pub
 
 		virtual void OnPacketReceived(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data);
 
+		// The frames from the router are dispatched to the strand of each stream (See Stream::DispatchVideoFrame())
+		// instead of going through the queues and the thread of the application, so the streams are processed in parallel.
+		// SendVideoFrame()/SendAudioFrame() of the application are not called in this mode.
+		// Must be called before the streams are created (the child calls it in the constructor)
+		void SetDirectDispatch(bool enabled);
+
 		std::map<uint32_t, std::shared_ptr<Stream>> _streams;
+		// Index of _streams by the name (GetStream(stream_name) is called for every request of the sessions)
+		std::unordered_map<ov::String, std::shared_ptr<Stream>> _stream_name_map;
 
 	private:
 		void WorkerThread();
 		bool DeleteAllStreams();
 
+		// The trace of this publisher if the packet is traced (See mon::PacketTracer)
+		std::shared_ptr<mon::PacketTrace> ForkTrace(const std::shared_ptr<MediaPacket> &media_packet);
+
 		// Stream을 자식을 통해 생성해서 받는다.
 		virtual std::shared_ptr<Stream> CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t thread_count) = 0;
 		virtual bool DeleteStream(const std::shared_ptr<info::Stream> &info) = 0;
@@ -89,6 +114,7 @@ namespace pub
 
 			std::shared_ptr<info::Stream> _stream;
 			std::shared_ptr<MediaPacket> _media_packet;
+			std::shared_ptr<mon::PacketTrace> _trace;
 		};
 		std::shared_ptr<Application::VideoStreamData> PopVideoStreamData();
 
@@ -104,6 +130,7 @@ namespace pub
 
 			std::shared_ptr<info::Stream> _stream;
 			std::shared_ptr<MediaPacket> _media_packet;
+			std::shared_ptr<mon::PacketTrace> _trace;
 		};
 		std::shared_ptr<Application::AudioStreamData> PopAudioStreamData();
 
@@ -124,10 +151,26 @@ namespace pub
 
 		std::shared_mutex 		_stream_map_mutex;
 
+		// The worker thread is started by the first stream, so an application without streams has no thread
+		bool StartWorkerThread();
+		// Wakes the thread up, or schedules Drain() on the strand
+		void Notify();
+		// Processes the queues on the strand (when the shared worker pool is enabled)
+		void Drain();
+		// Processes an item of each queue, returns false if all queues are empty
+		bool ProcessQueues();
+
 		bool _stop_thread_flag;
+		std::mutex _worker_thread_mutex;
 		std::thread _worker_thread;
 		ov::Semaphore _queue_event;
 
+		// Not nullptr if the application runs on the shared worker pool (See ov::Executor::GetShared()) instead of _worker_thread
+		std::shared_ptr<ov::Strand> _strand;
+		std::atomic<bool> _is_drain_scheduled{false};
+		// Shared by the publishers of the application (See <Scheduling>)
+		std::shared_ptr<ov::Executor::Group> _executor_group;
+
 		ov::Queue<std::shared_ptr<VideoStreamData>> _video_stream_queue;
 		ov::Queue<std::shared_ptr<AudioStreamData>> _audio_stream_queue;
 		ov::Queue<std::shared_ptr<IncomingPacket>> _incoming_packet_queue;
@@ -136,5 +179,7 @@ namespace pub
 		int64_t	_last_audio_ts_ms = 0;
 
 		std::shared_ptr<Publisher>		_publisher;
+
+		bool _direct_dispatch = false;
 	};
 }  // namespace pub
\ No newline at end of file
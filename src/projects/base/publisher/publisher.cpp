@@ -33,6 +33,8 @@ namespace pub
 			it = _applications.erase(it);
 		}
 
+		_application_name_map.clear();
+
 		logti("%s has been stopped.", GetPublisherName());
 		return true;
 	}
@@ -88,6 +90,7 @@ namespace pub
 		// Application Map에 보관
 		std::lock_guard<std::shared_mutex> lock(_application_map_mutex);
 		_applications[application->GetId()] = application;
+		_application_name_map[application->GetName()] = application;
 
 		return true;
 	}
@@ -126,6 +129,12 @@ namespace pub
 		_applications[app_info.GetId()]->Stop();
 		_applications.erase(item);
 
+		auto name_item = _application_name_map.find(application->GetName());
+		if ((name_item != _application_name_map.end()) && (name_item->second == application))
+		{
+			_application_name_map.erase(name_item);
+		}
+
 		lock.unlock();
 
 		_router->UnregisterObserverApp(*application.get(), application);
@@ -143,16 +152,13 @@ namespace pub
 	std::shared_ptr<Application> Publisher::GetApplicationByName(ov::String app_name)
 	{
 		std::shared_lock<std::shared_mutex> lock(_application_map_mutex);
-		for (auto const &x : _applications)
+		auto item = _application_name_map.find(app_name);
+		if (item == _application_name_map.end())
 		{
-			auto application = x.second;
-			if (application->GetName() == app_name)
-			{
-				return application;
-			}
+			return nullptr;
 		}
 
-		return nullptr;
+		return item->second;
 	}
 
 	std::shared_ptr<Stream> Publisher::GetStream(ov::String app_name, ov::String stream_name)
@@ -20,6 +20,7 @@
 #include <orchestrator/orchestrator.h>
 
 #include <chrono>
+#include <unordered_map>
 
 namespace pub
 {
@@ -133,6 +134,8 @@ namespace pub
 		virtual bool OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application) = 0;
 
 		std::map<info::application_id_t, std::shared_ptr<Application>> 	_applications;
+		// Index of _applications by the name (GetApplicationByName() is called for every request of the sessions)
+		std::unordered_map<ov::String, std::shared_ptr<Application>>	_application_name_map;
 		std::shared_mutex 		_application_map_mutex;
 
 		const cfg::Server _server_config;
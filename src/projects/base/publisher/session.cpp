@@ -50,11 +50,24 @@ namespace pub
 		return true;
 	}
 
+	bool Session::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+	{
+		auto packet = header->Clone();
+		packet->Append(payload);
+
+		return SendOutgoingData(packet_type, packet);
+	}
+
 	Session::SessionState Session::GetState()
 	{
 		return _state;
 	}
 
+	mon::SessionStats &Session::GetStats()
+	{
+		return _stats;
+	}
+
 	void Session::Terminate(ov::String reason)
 	{
 		_state = SessionState::Error;
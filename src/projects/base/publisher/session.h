@@ -6,6 +6,7 @@
 
 #include "base/common_types.h"
 #include "base/info/session.h"
+#include "monitoring/session_stats.h"
 
 #include <base/ovlibrary/ovlibrary.h>
 
@@ -28,7 +29,11 @@ namespace pub
 		virtual bool Stop();
 
 		// 패킷을 전송한다.
-		virtual bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet) = 0;
+		// packet is shared by all sessions of the stream, so a session must copy it before it changes the data
+		virtual bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet) = 0;
+		// The packet is the header followed by the payload (See Stream::BroadcastPacket(packet_type, header, payload)).
+		// By default, they are concatenated and sent by SendOutgoingData(packet_type, packet)
+		virtual bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
 		// 상위 Layer에서 Packet을 수신받는다.
 		virtual void OnPacketReceived(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data) = 0;
 
@@ -43,11 +48,24 @@ namespace pub
 		SessionState GetState();
 		virtual void Terminate(ov::String reason);
 
+		// The egress statistics, updated by the child (and the session nodes of the child)
+		mon::SessionStats &GetStats();
+
+		// StreamWorker calls this about every second (See StreamWorker::CheckSessions()).
+		// A session that falls behind the stream tries to catch up by itself (e.g. by switching to a lower rendition),
+		// and returns false if it should be disconnected.
+		virtual bool CheckHealth()
+		{
+			return true;
+		}
+
 	private:
 		std::shared_ptr<Application> _application;
 		std::shared_ptr<Stream> _stream;
 		SessionState _state;
 		ov::String _error_reason;
+
+		mon::SessionStats _stats;
 	};
 
 }  // namespace pub
\ No newline at end of file
@@ -11,7 +11,7 @@
 
 namespace pub
 {
-	SessionNode::SessionNode(uint32_t id, SessionNodeType node_type, std::shared_ptr<Session> session)
+	SessionNode::SessionNode(uint32_t id, SessionNodeType node_type, std::shared_ptr<info::Session> session)
 	{
 		_node_id = id;
 		_node_type = node_type;
@@ -24,7 +24,7 @@ namespace pub
 		
 	}
 
-	std::shared_ptr<Session> SessionNode::GetSession()
+	std::shared_ptr<info::Session> SessionNode::GetSession()
 	{
 		return _session;
 	}
@@ -33,7 +33,7 @@ namespace pub
 	class SessionNode : public ov::EnableSharedFromThis<SessionNode>
 	{
 	public:
-		SessionNode(uint32_t id, SessionNodeType node_type, std::shared_ptr<Session> session);
+		SessionNode(uint32_t id, SessionNodeType node_type, std::shared_ptr<info::Session> session);
 		virtual ~SessionNode();
 
 		uint32_t GetId();
@@ -61,7 +61,8 @@ namespace pub
 		virtual bool OnDataReceived(SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data) = 0;
 
 	protected:
-		std::shared_ptr<Session> GetSession();
+		// The session which owns this node (pub::Session for the publishers, the other info::Session for the providers)
+		std::shared_ptr<info::Session> GetSession();
 
 		// 하나만 연결되어 있을 때 사용한다.
 		std::shared_ptr<SessionNode> GetUpperNode();
@@ -78,7 +79,7 @@ namespace pub
 	private:
 		SessionNodeType _node_type;
 		uint32_t _node_id;
-		std::shared_ptr<Session> _session;
+		std::shared_ptr<info::Session> _session;
 		NodeState _state;
 	};
 }  // namespace pub
\ No newline at end of file
@@ -2,15 +2,93 @@
 #include "application.h"
 #include "publisher_private.h"
 
+#include <base/ovlibrary/probe.h>
+#include <base/ovsocket/datagram_batch.h>
+#include <monitoring/monitoring.h>
+#include <monitoring/packet_tracer.h>
+
+#include <algorithm>
+#include <optional>
+
 namespace pub
 {
+	// The trace of the frame that is being packetized by this thread (See Stream::DeliverVideoFrame()),
+	// the packets of the frame carry it to the stream workers
+	static thread_local std::shared_ptr<mon::PacketTrace> _delivering_trace;
+
+	static void SetDeliveringTrace(StreamPacket *stream_packet)
+	{
+		if (_delivering_trace != nullptr)
+		{
+			// The first packet of the frame is packetized
+			_delivering_trace->Mark(mon::PacketTraceStage::Packetized);
+			stream_packet->_trace = _delivering_trace;
+		}
+	}
+
+	StreamPacketRing::StreamPacketRing(size_t capacity)
+	{
+		size_t actual_capacity = 2;
+
+		while (actual_capacity < capacity)
+		{
+			actual_capacity <<= 1;
+		}
+
+		_slots.resize(actual_capacity);
+		_mask = actual_capacity - 1;
+	}
+
+	uint64_t StreamPacketRing::Publish(const std::shared_ptr<StreamPacket> &packet)
+	{
+		std::lock_guard<std::mutex> lock(_publish_mutex);
+
+		auto sequence = _next_sequence.load(std::memory_order_relaxed);
+
+		packet->_ring_sequence = sequence;
+		std::atomic_store(&_slots[sequence & _mask], packet);
+
+		// The readers see the packet after this
+		_next_sequence.store(sequence + 1, std::memory_order_release);
+
+		return sequence;
+	}
+
+	std::shared_ptr<StreamPacket> StreamPacketRing::Get(uint64_t sequence) const
+	{
+		auto packet = std::atomic_load(&_slots[sequence & _mask]);
+
+		if ((packet == nullptr) || (packet->_ring_sequence != sequence))
+		{
+			// Overwritten by a newer packet
+			return nullptr;
+		}
+
+		return packet;
+	}
+
+	uint64_t StreamPacketRing::GetOldestSequence() const
+	{
+		auto next_sequence = GetNextSequence();
+		auto capacity = _mask + 1;
+
+		return (next_sequence > capacity) ? (next_sequence - capacity) : 0;
+	}
+
 	StreamWorker::StreamWorker(const std::shared_ptr<Stream> &parent_stream)
-		: _packet_queue(nullptr, 100)
+		: _packet_queue(nullptr, STREAM_WORKER_QUEUE_CAPACITY)
 	{
 		_stop_thread_flag = true;
 		_parent = parent_stream;
 	}
 
+	StreamWorker::StreamWorker(const std::shared_ptr<Stream> &parent_stream, const std::shared_ptr<StreamPacketRing> &broadcast_ring, int processor_index)
+		: StreamWorker(parent_stream)
+	{
+		_broadcast_ring = broadcast_ring;
+		_processor_index = processor_index;
+	}
+
 	StreamWorker::~StreamWorker()
 	{
 		Stop();
@@ -27,9 +105,28 @@ namespace pub
 
 		queue_name.Format("%s/%s/%s StreamWorker Queue", _parent->GetApplication()->GetApplicationTypeName(), _parent->GetApplication()->GetName().CStr(), _parent->GetName().CStr());
 		_packet_queue.SetAlias(queue_name.CStr());
-		
+
+		_send_queue_latency = _parent->GetSendQueueLatency();
+
+		if (_broadcast_ring != nullptr)
+		{
+			// The packets published before the start are not sent
+			_ring_cursor = _broadcast_ring->GetNextSequence();
+		}
+
 		_stop_thread_flag = false;
-		_worker_thread = std::thread(&StreamWorker::WorkerThread, this);
+
+		auto executor = ov::Executor::GetShared();
+
+		if (executor->IsRunning())
+		{
+			// The packets are processed by the shared worker pool instead of a thread of this worker
+			_strand = std::make_shared<ov::Strand>(executor, _parent->GetApplication()->GetExecutorGroup());
+		}
+		else
+		{
+			_worker_thread = std::thread(&StreamWorker::WorkerThread, this);
+		}
 
 		return true;
 	}
@@ -42,6 +139,13 @@ namespace pub
 		}
 
 		_stop_thread_flag = true;
+
+		if (_strand != nullptr)
+		{
+			// Waits for the running Drain(), and the packets sent after this are discarded
+			_strand->Stop();
+		}
+
 		// Generate Event
 		_queue_event.Notify();
 		if(_worker_thread.joinable())
@@ -49,13 +153,23 @@ namespace pub
 			_worker_thread.join();
 		}
 
-		std::lock_guard<std::shared_mutex> lock(_session_map_mutex);
-		for (auto const &x : _sessions)
 		{
-			auto session = std::static_pointer_cast<Session>(x.second);
-			session->Stop();
+			std::lock_guard<std::shared_mutex> lock(_session_map_mutex);
+			for (auto const &x : _sessions)
+			{
+				auto session = std::static_pointer_cast<Session>(x.second);
+				session->Stop();
+			}
+			_sessions.clear();
+			_session_count = 0;
+			_priming_sessions.clear();
+		}
+
+		auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(_parent));
+		if (stream_metrics != nullptr)
+		{
+			stream_metrics->UpdateWorstSessions(this, {});
 		}
-		_sessions.clear();
 
 		return true;
 	}
@@ -64,6 +178,43 @@ namespace pub
 	{
 		std::lock_guard<std::shared_mutex> lock(_session_map_mutex);
 		_sessions[session->GetId()] = session;
+		_session_count = _sessions.size();
+
+		return true;
+	}
+
+	bool StreamWorker::AddSession(std::shared_ptr<Session> session, const std::vector<std::shared_ptr<StreamPacket>> &priming_packets)
+	{
+		if (priming_packets.empty())
+		{
+			return AddSession(session);
+		}
+
+		std::lock_guard<std::shared_mutex> lock(_session_map_mutex);
+		_sessions[session->GetId()] = session;
+		_session_count = _sessions.size();
+		_priming_sessions.insert(session->GetId());
+
+		// The packets already in the queue are not sent to the session
+		auto stream_packet = std::make_shared<pub::StreamPacket>(0, nullptr);
+		stream_packet->_priming_session = session;
+		stream_packet->_priming_packets = priming_packets;
+
+		if (_broadcast_ring != nullptr)
+		{
+			// The packets already in the ring are not sent to the session
+			stream_packet->_ring_sequence = _broadcast_ring->GetNextSequence();
+		}
+
+		if (_packet_queue.Enqueue(std::move(stream_packet)) == false)
+		{
+			// The session receives the packets of the stream without the priming packets
+			logtw("Could not send the priming packets to the session %u: the queue of the worker is full", session->GetId());
+			_priming_sessions.erase(session->GetId());
+			return true;
+		}
+
+		Notify();
 
 		return true;
 	}
@@ -81,6 +232,8 @@ namespace pub
 		auto session = _sessions[id];
 		// Session에 더이상 패킷을 전달하지 않는 것이 먼저다.
 		_sessions.erase(id);
+		_session_count = _sessions.size();
+		_priming_sessions.erase(id);
 
 		// Session 동작을 중지한다.
 		session->Stop();
@@ -100,58 +253,357 @@ namespace pub
 		return _sessions[id];
 	}
 
-	void StreamWorker::SendPacket(uint32_t type, std::shared_ptr<ov::Data> packet)
+	void StreamWorker::SendPacket(uint32_t type, const std::shared_ptr<const ov::Data> &packet)
 	{
-		auto stream_packet = std::make_shared<pub::StreamWorker::StreamPacket>(type, packet);
-		_packet_queue.Enqueue(std::move(stream_packet));
+		auto stream_packet = std::make_shared<pub::StreamPacket>(type, packet);
+		SetDeliveringTrace(stream_packet.get());
 
-		_queue_event.Notify();
+		if (_packet_queue.Enqueue(std::move(stream_packet)))
+		{
+			Notify();
+		}
 	}
 
-	std::shared_ptr<StreamWorker::StreamPacket> StreamWorker::PopStreamPacket()
+	void StreamWorker::SendPacket(uint32_t type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
 	{
-		if (_packet_queue.IsEmpty())
+		auto stream_packet = std::make_shared<pub::StreamPacket>(type, header, payload);
+		SetDeliveringTrace(stream_packet.get());
+
+		if (_packet_queue.Enqueue(std::move(stream_packet)))
 		{
-			return nullptr;
+			Notify();
+		}
+	}
+
+	void StreamWorker::NotifyBroadcast()
+	{
+		Notify();
+	}
+
+	size_t StreamWorker::GetSessionCount() const
+	{
+		return _session_count;
+	}
+
+	uint32_t StreamWorker::GetLoad() const
+	{
+		return _load_permille;
+	}
+
+	void StreamWorker::Notify()
+	{
+		if (_strand != nullptr)
+		{
+			ScheduleDrain();
+			return;
 		}
 
-		auto data = _packet_queue.Dequeue();
+		_queue_event.Notify();
+	}
+
+	std::shared_ptr<StreamPacket> StreamWorker::PopStreamPacket()
+	{
+		auto data = _packet_queue.Dequeue(0);
 		if(data.has_value())
 		{
-			return data.value();
+			auto &packet = data.value();
+
+			if ((_send_queue_latency != nullptr) && (packet->_priming_session == nullptr))
+			{
+				_send_queue_latency->Record(packet->_created_time);
+			}
+
+			return packet;
 		}
 
 		return nullptr;
 	}
 
+	void StreamWorker::SendToSessions(const std::shared_ptr<StreamPacket> &packet)
+	{
+		std::shared_lock<std::shared_mutex> session_lock(_session_map_mutex);
+
+		OV_PROBE5(worker_send, _parent->GetId(), packet->_type,
+				  packet->_data->GetLength() + ((packet->_payload != nullptr) ? packet->_payload->GetLength() : 0),
+				  _sessions.size(), std::chrono::duration_cast<std::chrono::nanoseconds>(packet->_created_time.time_since_epoch()).count());
+
+		// 모든 Session에 전송한다.
+		for (auto const &x : _sessions)
+		{
+			if ((_priming_sessions.empty() == false) && (_priming_sessions.find(x.first) != _priming_sessions.end()))
+			{
+				// The packet was sent before the session was added
+				continue;
+			}
+
+			auto session = std::static_pointer_cast<Session>(x.second);
+
+			// The payload is shared without copying. Sessions that need to modify the packet (SRTP, OVT session id)
+			// make their own copy when they do it.
+			if (packet->_payload != nullptr)
+			{
+				session->SendOutgoingData(packet->_type, packet->_data, packet->_payload);
+			}
+			else
+			{
+				session->SendOutgoingData(packet->_type, packet->_data);
+			}
+
+			if (packet->_trace != nullptr)
+			{
+				packet->_trace->Mark(mon::PacketTraceStage::SessionSent);
+			}
+		}
+	}
+
+	void StreamWorker::SendPrimingPackets(const std::shared_ptr<StreamPacket> &packet)
+	{
+		auto &session = packet->_priming_session;
+
+		{
+			std::lock_guard<std::shared_mutex> session_lock(_session_map_mutex);
+
+			if (_priming_sessions.erase(session->GetId()) == 0)
+			{
+				// The session has been removed
+				return;
+			}
+		}
+
+		// The next packets of the stream are sent to the session after this, so no other thread sends to it now
+		for (const auto &priming_packet : packet->_priming_packets)
+		{
+			if (priming_packet->_payload != nullptr)
+			{
+				session->SendOutgoingData(priming_packet->_type, priming_packet->_data, priming_packet->_payload);
+			}
+			else
+			{
+				session->SendOutgoingData(priming_packet->_type, priming_packet->_data);
+			}
+		}
+	}
+
+	void StreamWorker::CheckSessions()
+	{
+		auto publisher_type = _parent->GetApplication()->GetPublisherType();
+		std::vector<mon::SessionStatsSnapshot> snapshots;
+		std::vector<std::shared_ptr<Session>> falling_behind_sessions;
+
+		{
+			std::shared_lock<std::shared_mutex> session_lock(_session_map_mutex);
+
+			snapshots.reserve(_sessions.size());
+
+			for (auto const &x : _sessions)
+			{
+				auto &session = x.second;
+
+				if (session->CheckHealth() == false)
+				{
+					falling_behind_sessions.push_back(session);
+				}
+
+				snapshots.emplace_back(session->GetId(), publisher_type, session->GetStats());
+			}
+		}
+
+		auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(_parent));
+		if (stream_metrics != nullptr)
+		{
+			auto count = std::min(snapshots.size(), static_cast<size_t>(WORST_SESSION_COUNT));
+
+			std::partial_sort(snapshots.begin(), snapshots.begin() + count, snapshots.end(), [](const mon::SessionStatsSnapshot &a, const mon::SessionStatsSnapshot &b) {
+				return a.GetScore() > b.GetScore();
+			});
+			snapshots.resize(count);
+
+			stream_metrics->UpdateWorstSessions(this, std::move(snapshots));
+		}
+
+		// Removing a session needs the exclusive lock of the sessions, so it is done after the iteration
+		for (auto &session : falling_behind_sessions)
+		{
+			logtw("Session %u of %s/%s fell behind the stream", session->GetId(), _parent->GetApplication()->GetName().CStr(), _parent->GetName().CStr());
+
+			_parent->OnSessionFallingBehind(session);
+
+			if (stream_metrics != nullptr)
+			{
+				stream_metrics->OnSlowSessionDisconnected();
+			}
+		}
+	}
+
+	void StreamWorker::ProcessBroadcastRing(size_t batch_size)
+	{
+		// Only the priming packets are enqueued in the run-to-completion mode
+		while (true)
+		{
+			auto priming_packet = PopStreamPacket();
+			if (priming_packet == nullptr)
+			{
+				break;
+			}
+
+			// The session receives the priming packets between the packets published before and after it was added
+			SendRingPackets(priming_packet->_ring_sequence, batch_size);
+			SendPrimingPackets(priming_packet);
+		}
+
+		SendRingPackets(_broadcast_ring->GetNextSequence(), batch_size);
+	}
+
+	void StreamWorker::SendRingPackets(uint64_t end_sequence, size_t batch_size)
+	{
+		while ((_ring_cursor < end_sequence) && (_stop_thread_flag == false))
+		{
+			std::optional<ov::DatagramBatch> batch;
+
+			if (batch_size > 0)
+			{
+				batch.emplace();
+			}
+
+			for (size_t count = 0; (_ring_cursor < end_sequence) && ((batch_size == 0) || (count < batch_size)); count++)
+			{
+				auto packet = _broadcast_ring->Get(_ring_cursor);
+
+				if (packet == nullptr)
+				{
+					// This worker could not keep up with the stream, the sessions recover the lost packets (NACK, key frame request)
+					auto oldest_sequence = _broadcast_ring->GetOldestSequence();
+
+					logtw("StreamWorker of %s/%s fell behind the broadcast ring, %" PRIu64 " packets are skipped",
+						  _parent->GetApplication()->GetName().CStr(), _parent->GetName().CStr(), oldest_sequence - _ring_cursor);
+
+					_ring_cursor = oldest_sequence;
+					continue;
+				}
+
+				_ring_cursor++;
+
+				if (_send_queue_latency != nullptr)
+				{
+					_send_queue_latency->Record(packet->_created_time);
+				}
+
+				SendToSessions(packet);
+			}
+		}
+	}
+
 	void StreamWorker::WorkerThread()
 	{
-		std::shared_lock<std::shared_mutex> session_lock(_session_map_mutex, std::defer_lock);
+		ov::ThreadMetrics thread_metrics("StreamWorker", ov::ThreadClass::Media);
+		ov::MemoryScope memory_scope(ov::MemoryCategory::Publisher, _parent->GetMemoryAccount());
+		auto batch_size = _parent->GetEgressBatchSize();
+
+		if ((_processor_index >= 0) && (ov::Platform::SetThreadAffinity(_processor_index) == false))
+		{
+			logtw("Could not set the affinity of the StreamWorker of %s/%s to the processor #%d",
+				  _parent->GetApplication()->GetName().CStr(), _parent->GetName().CStr(), _processor_index);
+		}
+		else if ((_processor_index < 0) && (_parent->GetNumaNode() >= 0))
+		{
+			// Runs on the NUMA node of the stream
+			ov::Numa::BindThread(_parent->GetNumaNode());
+		}
+
 		// Queue Event를 기다린다.
 		while (!_stop_thread_flag)
 		{
 			// Queue에 이벤트가 들어올때까지 무한 대기 한다.
 			// TODO: 향후 App 재시작 등의 기능을 위해 WaitFor(time) 기능을 구현한다.
+			thread_metrics.BeginIdle();
 			_queue_event.Wait();
+			thread_metrics.EndIdle();
+
+			thread_metrics.CountLoop();
+
+			// A packet is enqueued for each Notify()
+			ProcessPackets(batch_size, (batch_size == 0) ? 1 : batch_size);
+		}
+	}
+
+	void StreamWorker::ScheduleDrain()
+	{
+		if (_is_drain_scheduled.exchange(true) == false)
+		{
+			_strand->Post([this]() {
+				Drain();
+			});
+		}
+	}
+
+	void StreamWorker::Drain()
+	{
+		// The packets enqueued after this schedule another Drain()
+		_is_drain_scheduled = false;
+
+		auto batch_size = _parent->GetEgressBatchSize();
+
+		ProcessPackets(batch_size, std::max(batch_size, static_cast<size_t>(DEFAULT_EGRESS_BATCH_SIZE)));
+
+		if (_packet_queue.IsEmpty() == false)
+		{
+			// Continue after the other strands
+			ScheduleDrain();
+		}
+	}
+
+	void StreamWorker::ProcessPackets(size_t batch_size, size_t max_count)
+	{
+		auto now = std::chrono::steady_clock::now();
+		auto elapsed = now - _last_session_check_time;
 
+		if (elapsed >= std::chrono::milliseconds(STREAM_WORKER_SESSION_CHECK_INTERVAL_MS))
+		{
+			_load_permille = static_cast<uint32_t>(std::min<int64_t>(_busy_time * 1000 / elapsed, 1000));
+			_busy_time = std::chrono::steady_clock::duration::zero();
+			_last_session_check_time = now;
+
+			CheckSessions();
+		}
+
+		SendPackets(batch_size, max_count);
+
+		_busy_time += std::chrono::steady_clock::now() - now;
+	}
+
+	void StreamWorker::SendPackets(size_t batch_size, size_t max_count)
+	{
+		if (_broadcast_ring != nullptr)
+		{
+			ProcessBroadcastRing(batch_size);
+			return;
+		}
+
+		// Datagrams that the sessions send while this batch is alive are sent together when it is flushed
+		std::optional<ov::DatagramBatch> batch;
+
+		if (batch_size > 0)
+		{
+			batch.emplace();
+		}
+
+		// Send the packets in the queue (usually the packets of a frame) to all sessions
+		for (size_t count = 0; count < max_count; count++)
+		{
 			// Queue에서 패킷을 꺼낸다.
-			std::shared_ptr<StreamWorker::StreamPacket> packet = PopStreamPacket();
+			std::shared_ptr<StreamPacket> packet = PopStreamPacket();
 			if (packet == nullptr)
 			{
-				continue;
+				break;
 			}
 
-			session_lock.lock();
-			// 모든 Session에 전송한다.
-			for (auto const &x : _sessions)
+			if (packet->_priming_session != nullptr)
 			{
-				auto session = std::static_pointer_cast<Session>(x.second);
-
-				// Session will change data
-				std::shared_ptr<ov::Data> session_data = packet->_data->Clone();
-				session->SendOutgoingData(packet->_type, session_data);
+				SendPrimingPackets(packet);
+				continue;
 			}
-			session_lock.unlock();
+
+			SendToSessions(packet);
 		}
 	}
 
@@ -180,21 +632,37 @@ namespace pub
 			worker_count = MAX_STREAM_WORKER_THREAD_COUNT;
 		}
 
-		_worker_count = worker_count;
-		// Create WorkerThread
-		for (uint32_t i = 0; i < _worker_count; i++)
+		mon::MetricLabels latency_labels = {
+			{"publisher", _application->GetPublisherName()},
+			{"app", _application->GetName()},
+			{"stream", GetName()}};
+
+		auto &latency_metrics = MonitorInstance->GetLatencyMetrics();
+		_packetize_latency = latency_metrics.GetHistogram(mon::LatencyStage::Packetize, latency_labels);
+		_send_queue_latency = latency_metrics.GetHistogram(mon::LatencyStage::SendQueueDelay, latency_labels);
+
+		_memory_account = ov::MemoryAccounting::GetAccount(_application->GetName(), GetName());
+
+		_worker_count = std::max(worker_count, 1U);
+		_stream_workers.clear();
+		_stream_workers.resize(_worker_count);
+		_created_worker_count = 0;
+
+		if (_run_to_completion)
 		{
-			auto stream_worker = std::make_shared<StreamWorker>(GetSharedPtr());
-						
-			if (stream_worker->Start() == false)
-			{
-				logte("Cannot create stream thread (%d)", i);
-				Stop();
+			_broadcast_ring = std::make_shared<StreamPacketRing>();
+			_processor_count = std::max(ov::Platform::GetProcessorCount(), 1);
+		}
 
-				return false;
-			}
+		// The other workers are created by SelectWorker() when they are needed
+		if (CreateWorker(0) == false)
+		{
+			return false;
+		}
 
-			_stream_workers[i] = stream_worker;
+		if (_application->IsDirectDispatchEnabled() && ov::Executor::GetShared()->IsRunning())
+		{
+			_dispatch_strand = std::make_shared<ov::Strand>(ov::Executor::GetShared(), _application->GetExecutorGroup());
 		}
 
 		logti("%s application has started [%s(%u)] stream", _application->GetApplicationTypeName(), GetName().CStr(), GetId());
@@ -212,7 +680,15 @@ namespace pub
 
 		_run_flag = false;
 
-		for (uint32_t i = 0; i < _worker_count; i++)
+		if ((_dispatch_strand != nullptr) && (_dispatch_strand->IsCurrent() == false))
+		{
+			// Waits for the frame being delivered, the pending frames are discarded
+			_dispatch_strand->Stop();
+		}
+
+		auto created_worker_count = _created_worker_count.load();
+
+		for (uint32_t i = 0; i < created_worker_count; i++)
 		{
 			_stream_workers[i]->Stop();
 		}
@@ -230,24 +706,300 @@ namespace pub
 		return true;
 	}
 
+	bool Stream::IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track)
+	{
+		return true;
+	}
+
 	std::shared_ptr<Application> Stream::GetApplication()
 	{
 		return _application;
 	}
 
-	std::shared_ptr<StreamWorker> Stream::GetWorkerByStreamID(session_id_t session_id)
+	size_t Stream::GetEgressBatchSize() const
+	{
+		return _egress_batch_size;
+	}
+
+	const std::shared_ptr<mon::LatencyHistogram> &Stream::GetSendQueueLatency() const
+	{
+		return _send_queue_latency;
+	}
+
+	void Stream::OnSessionFallingBehind(const std::shared_ptr<Session> &session)
+	{
+		RemoveSession(session->GetId());
+	}
+
+	void Stream::SetEgressBatchSize(size_t batch_size)
+	{
+		_egress_batch_size = batch_size;
+	}
+
+	void Stream::SetRunToCompletion(bool enabled)
 	{
-		return _stream_workers[session_id % _worker_count];
+		_run_to_completion = enabled;
+	}
+
+	bool Stream::CreateWorker(uint32_t index)
+	{
+		// The worker #i of all streams runs on the same processor (of the NUMA node of the stream if it is used)
+		int processor_index = static_cast<int>(index % _processor_count);
+		auto numa_node = GetNumaNode();
+
+		if (numa_node >= 0)
+		{
+			auto &processors = ov::Numa::GetProcessors(numa_node);
+			processor_index = processors[index % processors.size()];
+		}
+
+		auto stream_worker = (_broadcast_ring != nullptr)
+								 ? std::make_shared<StreamWorker>(GetSharedPtr(), _broadcast_ring, processor_index)
+								 : std::make_shared<StreamWorker>(GetSharedPtr());
+
+		if (stream_worker->Start() == false)
+		{
+			logte("Cannot create the stream worker #%u of %s/%s", index, _application->GetName().CStr(), GetName().CStr());
+			return false;
+		}
+
+		_stream_workers[index] = stream_worker;
+		_created_worker_count.store(index + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	uint32_t Stream::SelectWorker()
+	{
+		auto created_worker_count = _created_worker_count.load();
+
+		// The workers needed for the sessions including the new one
+		auto worker_count = static_cast<uint32_t>((_sessions.size() + STREAM_WORKER_SESSIONS_PER_WORKER) / STREAM_WORKER_SESSIONS_PER_WORKER);
+		worker_count = std::clamp(worker_count, 1U, _worker_count);
+
+		if ((worker_count < _worker_count) && (worker_count <= created_worker_count))
+		{
+			bool are_all_overloaded = true;
+
+			for (uint32_t index = 0; index < worker_count; index++)
+			{
+				if (_stream_workers[index]->GetLoad() < STREAM_WORKER_OVERLOAD_PERMILLE)
+				{
+					are_all_overloaded = false;
+					break;
+				}
+			}
+
+			if (are_all_overloaded)
+			{
+				worker_count++;
+			}
+		}
+
+		while (created_worker_count < worker_count)
+		{
+			if (CreateWorker(created_worker_count) == false)
+			{
+				break;
+			}
+
+			created_worker_count++;
+
+			logti("%s/%s uses %u stream workers for %zu sessions", _application->GetName().CStr(), GetName().CStr(), created_worker_count, _sessions.size() + 1);
+		}
+
+		worker_count = std::min(worker_count, created_worker_count);
+
+		// The worker that is not overloaded and has the fewest sessions
+		uint32_t selected_index = 0;
+
+		for (uint32_t index = 1; index < worker_count; index++)
+		{
+			auto &worker = _stream_workers[index];
+			auto &selected_worker = _stream_workers[selected_index];
+
+			bool is_overloaded = worker->GetLoad() >= STREAM_WORKER_OVERLOAD_PERMILLE;
+			bool is_selected_overloaded = selected_worker->GetLoad() >= STREAM_WORKER_OVERLOAD_PERMILLE;
+
+			if ((is_overloaded != is_selected_overloaded) ? (is_overloaded == false) : (worker->GetSessionCount() < selected_worker->GetSessionCount()))
+			{
+				selected_index = index;
+			}
+		}
+
+		return selected_index;
+	}
+
+	std::shared_ptr<StreamWorker> Stream::GetWorkerBySessionID(session_id_t session_id)
+	{
+		auto item = _session_worker_indexes.find(session_id);
+		if (item == _session_worker_indexes.end())
+		{
+			return nullptr;
+		}
+
+		return _stream_workers[item->second];
 	}
 
 	bool Stream::AddSession(std::shared_ptr<Session> session)
 	{
+		// No frame is sent to the sessions until the session is added
+		std::lock_guard<std::mutex> delivery_lock(_delivery_mutex);
+
+		std::vector<std::shared_ptr<StreamPacket>> priming_packets;
+		auto gop_cache = GetDeliveredGopCache();
+
+		if ((gop_cache.empty() == false) && (PacketizeGopCache(session, gop_cache, &priming_packets) == false))
+		{
+			priming_packets.clear();
+		}
+
 		std::lock_guard<std::shared_mutex> session_lock(_session_map_mutex);
+
+		if (_run_flag == false)
+		{
+			return false;
+		}
+
+		// 가장 적은 Session을 처리하는 Worker를 찾아서 Session을 넣는다.
+		auto worker_index = SelectWorker();
+
 		// For getting session, all sessions
 		_sessions[session->GetId()] = session;
-		// 가장 적은 Session을 처리하는 Worker를 찾아서 Session을 넣는다.
-		// session id로 hash를 만들어서 분배한다.
-		return GetWorkerByStreamID(session->GetId())->AddSession(session);
+		_session_worker_indexes[session->GetId()] = worker_index;
+
+		return _stream_workers[worker_index]->AddSession(session, priming_packets);
+	}
+
+	std::vector<std::shared_ptr<MediaPacket>> Stream::GetDeliveredGopCache()
+	{
+		std::vector<std::shared_ptr<MediaPacket>> gop_cache;
+		std::vector<std::shared_ptr<MediaPacket>> delivered_gop_cache;
+
+		if ((_last_delivered_video_packet == nullptr) ||
+			(_application->GetGopCache(std::static_pointer_cast<info::Stream>(GetSharedPtr()), &gop_cache) == false))
+		{
+			return delivered_gop_cache;
+		}
+
+		// The cache may have the frames that are not delivered yet (they are in the queue of Application),
+		// they will be sent to the new session with the other sessions.
+		// The video and audio frames are delivered in the order of the cache, but through different queues, so they are found separately.
+		auto last_video = std::find(gop_cache.rbegin(), gop_cache.rend(), _last_delivered_video_packet);
+
+		if (last_video == gop_cache.rend())
+		{
+			// The cache starts from a key frame that is not delivered yet
+			return delivered_gop_cache;
+		}
+
+		auto last_audio = std::find(gop_cache.rbegin(), gop_cache.rend(), _last_delivered_audio_packet);
+
+		size_t video_end = gop_cache.rend() - last_video;
+		size_t audio_end = (last_audio != gop_cache.rend()) ? (gop_cache.rend() - last_audio) : 0;
+
+		delivered_gop_cache.reserve(std::max(video_end, audio_end));
+
+		for (size_t index = 0; index < std::max(video_end, audio_end); index++)
+		{
+			auto &media_packet = gop_cache[index];
+
+			if (index < ((media_packet->GetMediaType() == common::MediaType::Video) ? video_end : audio_end))
+			{
+				delivered_gop_cache.push_back(media_packet);
+			}
+		}
+
+		return delivered_gop_cache;
+	}
+
+	void Stream::SetDeliveringTrace(const std::shared_ptr<mon::PacketTrace> &trace)
+	{
+		_delivering_trace = trace;
+	}
+
+	void Stream::DeliverVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		std::lock_guard<std::mutex> delivery_lock(_delivery_mutex);
+		ov::MemoryScope memory_scope(ov::MemoryCategory::Publisher, _memory_account);
+
+		auto start_time = std::chrono::steady_clock::now();
+
+		SendVideoFrame(media_packet);
+		_last_delivered_video_packet = media_packet;
+
+		if (_delivering_trace != nullptr)
+		{
+			// The publishers that don't use the stream workers (HLS, DASH)
+			_delivering_trace->Mark(mon::PacketTraceStage::Packetized);
+		}
+
+		if (_packetize_latency != nullptr)
+		{
+			_packetize_latency->Record(start_time);
+		}
+	}
+
+	void Stream::DeliverAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		std::lock_guard<std::mutex> delivery_lock(_delivery_mutex);
+		ov::MemoryScope memory_scope(ov::MemoryCategory::Publisher, _memory_account);
+
+		auto start_time = std::chrono::steady_clock::now();
+
+		SendAudioFrame(media_packet);
+		_last_delivered_audio_packet = media_packet;
+
+		if (_delivering_trace != nullptr)
+		{
+			// The publishers that don't use the stream workers (HLS, DASH)
+			_delivering_trace->Mark(mon::PacketTraceStage::Packetized);
+		}
+
+		if (_packetize_latency != nullptr)
+		{
+			_packetize_latency->Record(start_time);
+		}
+	}
+
+	void Stream::DispatchVideoFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace)
+	{
+		DispatchFrame(media_packet, trace, true);
+	}
+
+	void Stream::DispatchAudioFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace)
+	{
+		DispatchFrame(media_packet, trace, false);
+	}
+
+	void Stream::DispatchFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace, bool is_video)
+	{
+		auto deliver = [](Stream *stream, const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace, bool is_video) {
+			SetDeliveringTrace(trace);
+
+			if (is_video)
+			{
+				stream->DeliverVideoFrame(media_packet);
+			}
+			else
+			{
+				stream->DeliverAudioFrame(media_packet);
+			}
+
+			SetDeliveringTrace(nullptr);
+		};
+
+		if (_dispatch_strand == nullptr)
+		{
+			deliver(this, media_packet, trace, is_video);
+			return;
+		}
+
+		auto self = GetSharedPtr();
+
+		_dispatch_strand->Post([self, media_packet, trace, is_video, deliver]() {
+			deliver(self.get(), media_packet, trace, is_video);
+		});
 	}
 
 	bool Stream::RemoveSession(session_id_t id)
@@ -261,13 +1013,24 @@ namespace pub
 
 		_sessions.erase(id);
 
-		return GetWorkerByStreamID(id)->RemoveSession(id);
+		auto worker = GetWorkerBySessionID(id);
+		_session_worker_indexes.erase(id);
+
+		return (worker != nullptr) ? worker->RemoveSession(id) : false;
 	}
 
 	std::shared_ptr<Session> Stream::GetSession(session_id_t id)
 	{
 		std::shared_lock<std::shared_mutex> session_lock(_session_map_mutex);
-		return GetWorkerByStreamID(id)->GetSession(id);
+
+		auto worker = GetWorkerBySessionID(id);
+		if (worker == nullptr)
+		{
+			logte("Cannot find session : %u", id);
+			return nullptr;
+		}
+
+		return worker->GetSession(id);
 	}
 
 	const std::map<session_id_t, std::shared_ptr<Session>> Stream::GetAllSessions()
@@ -282,12 +1045,68 @@ namespace pub
 		return _sessions.size();
 	}
 
-	bool Stream::BroadcastPacket(uint32_t packet_type, std::shared_ptr<ov::Data> packet)
+	bool Stream::BroadcastPacket(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet)
 	{
+		// Freeze the packet once (copy-on-write) so that the packetizer can't change the data that workers are sending
+		std::shared_ptr<const ov::Data> shared_packet = packet->Clone();
+
+		if (_broadcast_ring != nullptr)
+		{
+			return PublishPacket(std::make_shared<StreamPacket>(packet_type, shared_packet));
+		}
+
 		// 모든 StreamWorker에 나눠준다.
-		for (uint32_t i = 0; i < _worker_count; i++)
+		auto created_worker_count = _created_worker_count.load(std::memory_order_acquire);
+
+		for (uint32_t i = 0; i < created_worker_count; i++)
+		{
+			auto &stream_worker = _stream_workers[i];
+
+			// A session added after this receives the packets from the next one
+			if (stream_worker->GetSessionCount() > 0)
+			{
+				stream_worker->SendPacket(packet_type, shared_packet);
+			}
+		}
+
+		return true;
+	}
+
+	bool Stream::BroadcastPacket(uint32_t packet_type, const std::shared_ptr<ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+	{
+		std::shared_ptr<const ov::Data> shared_header = header->Clone();
+
+		if (_broadcast_ring != nullptr)
+		{
+			return PublishPacket(std::make_shared<StreamPacket>(packet_type, shared_header, payload));
+		}
+
+		auto created_worker_count = _created_worker_count.load(std::memory_order_acquire);
+
+		for (uint32_t i = 0; i < created_worker_count; i++)
+		{
+			auto &stream_worker = _stream_workers[i];
+
+			if (stream_worker->GetSessionCount() > 0)
+			{
+				stream_worker->SendPacket(packet_type, shared_header, payload);
+			}
+		}
+
+		return true;
+	}
+
+	bool Stream::PublishPacket(const std::shared_ptr<StreamPacket> &stream_packet)
+	{
+		pub::SetDeliveringTrace(stream_packet.get());
+		_broadcast_ring->Publish(stream_packet);
+
+		// The idle workers also follow the ring, so that a new session doesn't receive the old packets
+		auto created_worker_count = _created_worker_count.load(std::memory_order_acquire);
+
+		for (uint32_t i = 0; i < created_worker_count; i++)
 		{
-			_stream_workers[i]->SendPacket(packet_type, packet);
+			_stream_workers[i]->NotifyBroadcast();
 		}
 
 		return true;
@@ -1,59 +1,174 @@
 #pragma once
 
+#include <atomic>
+#include <set>
 #include <shared_mutex>
 #include "base/common_types.h"
 #include "base/info/stream.h"
 #include "base/media_route/media_buffer.h"
+#include "base/ovlibrary/executor.h"
+#include "monitoring/latency_histogram.h"
 #include "session.h"
 
 #define MIN_STREAM_WORKER_THREAD_COUNT 2
 #define MAX_STREAM_WORKER_THREAD_COUNT 72
+// The number of packets that a StreamWorker sends at once when the egress batch is enabled
+#define DEFAULT_EGRESS_BATCH_SIZE 64
+// StreamWorker checks the health of its sessions in this interval (See Session::CheckHealth())
+#define STREAM_WORKER_SESSION_CHECK_INTERVAL_MS 1000
+// The number of packets kept in the broadcast ring of a stream in the run-to-completion mode (must be a power of 2)
+#define STREAM_BROADCAST_RING_SIZE 4096
+// The number of packets that can wait in the queue of a StreamWorker. The packets are dropped if the queue is full
+#define STREAM_WORKER_QUEUE_CAPACITY 4096
+// A stream starts with a StreamWorker, and adds the workers (up to the worker count of Stream::Start()) as the sessions increase.
+// The number of the sessions that a StreamWorker serves before the stream adds another worker
+#define STREAM_WORKER_SESSIONS_PER_WORKER 500
+// A StreamWorker that spends more than this (per mille) of the time to send the packets is overloaded,
+// then the stream adds another worker for the new sessions even if the workers have fewer sessions than the above
+#define STREAM_WORKER_OVERLOAD_PERMILLE 700
 
 namespace pub
 {
+	class StreamPacket
+	{
+	public:
+		StreamPacket(uint32_t type, const std::shared_ptr<const ov::Data> &data, const std::shared_ptr<const ov::Data> &payload = nullptr)
+		{
+			_type = type;
+			_data = data;
+			_payload = payload;
+			_created_time = std::chrono::steady_clock::now();
+		}
+
+		uint32_t _type;
+		// The payload is shared by all sessions of all workers, so it must not be modified
+		std::shared_ptr<const ov::Data> _data;
+		// If not nullptr, the packet is _data (header) followed by _payload
+		std::shared_ptr<const ov::Data> _payload;
+
+		// To measure the time the packet waits in the queue of StreamWorker
+		std::chrono::steady_clock::time_point _created_time;
+		// The trace of the frame of the packet (See mon::PacketTracer)
+		std::shared_ptr<mon::PacketTrace> _trace;
+
+		// If not nullptr, this is not a packet of the stream, but the priming packets of a new session (See Stream::AddSession())
+		std::shared_ptr<Session> _priming_session;
+		std::vector<std::shared_ptr<StreamPacket>> _priming_packets;
+
+		// The sequence in StreamPacketRing. For the priming packets, the sequence of the first packet that the session receives after them
+		uint64_t _ring_sequence = 0;
+	};
+
+	// The packets of a stream are published once into this ring, and all StreamWorkers read them with their own cursors
+	// (instead of enqueuing a StreamPacket into the queue of each worker)
+	//
+	// - Publish() may be called from multiple threads (RtcStream broadcasts to its renditions)
+	// - Get() doesn't take a lock, and returns nullptr if the packet has been overwritten because the reader fell behind
+	class StreamPacketRing
+	{
+	public:
+		explicit StreamPacketRing(size_t capacity = STREAM_BROADCAST_RING_SIZE);
+
+		// @return the sequence of the packet
+		uint64_t Publish(const std::shared_ptr<StreamPacket> &packet);
+		std::shared_ptr<StreamPacket> Get(uint64_t sequence) const;
+
+		// The sequence of the next packet to be published
+		uint64_t GetNextSequence() const
+		{
+			return _next_sequence.load(std::memory_order_acquire);
+		}
+
+		// The sequence of the oldest packet that is not overwritten yet
+		uint64_t GetOldestSequence() const;
+
+	private:
+		std::vector<std::shared_ptr<StreamPacket>> _slots;
+		uint64_t _mask;
+
+		std::mutex _publish_mutex;
+		std::atomic<uint64_t> _next_sequence{0};
+	};
+
 	class StreamWorker
 	{
 	public:
 		StreamWorker(const std::shared_ptr<Stream> &parent_stream);
+		// Run-to-completion mode: the worker is pinned to the processor, and reads the packets from the broadcast ring of the stream
+		StreamWorker(const std::shared_ptr<Stream> &parent_stream, const std::shared_ptr<StreamPacketRing> &broadcast_ring, int processor_index);
 		~StreamWorker();
 
 		bool Start();
 		bool Stop();
 
 		bool AddSession(std::shared_ptr<Session> session);
+		// The session receives the priming packets first, and then the packets of the stream that are sent after this call
+		bool AddSession(std::shared_ptr<Session> session, const std::vector<std::shared_ptr<StreamPacket>> &priming_packets);
 		bool RemoveSession(session_id_t id);
 		std::shared_ptr<Session> GetSession(session_id_t id);
 
-		void SendPacket(uint32_t type, std::shared_ptr<ov::Data> packet);
+		void SendPacket(uint32_t type, const std::shared_ptr<const ov::Data> &packet);
+		void SendPacket(uint32_t type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
+		// Wakes the worker up after a packet is published into the broadcast ring
+		void NotifyBroadcast();
+
+		// Read without the lock of the sessions (See Stream::SelectWorker())
+		size_t GetSessionCount() const;
+		// The time spent to send the packets in the last interval of CheckSessions() (per mille of the interval)
+		uint32_t GetLoad() const;
 
 	private:
 		void WorkerThread();
+		// Wakes the thread up, or schedules Drain() on the strand
+		void Notify();
+		void ScheduleDrain();
+		// Processes the queue on the strand (when the shared worker pool is enabled)
+		void Drain();
+		// Sends up to max_count packets of the queue (the datagrams are sent together if batch_size > 0), and measures the load
+		void ProcessPackets(size_t batch_size, size_t max_count);
+		void SendPackets(size_t batch_size, size_t max_count);
+		// Sends the packets of the broadcast ring, and the priming packets at their positions in the ring
+		void ProcessBroadcastRing(size_t batch_size);
+		// Sends the packets of the broadcast ring before end_sequence
+		void SendRingPackets(uint64_t end_sequence, size_t batch_size);
 
 		std::map<session_id_t, std::shared_ptr<Session>> _sessions;
+		// The sessions that don't receive the packets of the stream until their priming packets are sent
+		std::set<session_id_t> _priming_sessions;
 		std::shared_mutex _session_map_mutex;
 		ov::Semaphore _queue_event;
 
-		class StreamPacket
-		{
-		public:
-			StreamPacket(uint32_t type, std::shared_ptr<ov::Data> data)
-			{
-				_type = type;
-				_data = data->Clone();
-			}
-
-			uint32_t _type;
-			std::shared_ptr<ov::Data> _data;
-		};
-
 		std::shared_ptr<StreamPacket> PopStreamPacket();
+		void SendToSessions(const std::shared_ptr<StreamPacket> &packet);
+		void SendPrimingPackets(const std::shared_ptr<StreamPacket> &packet);
+		// Reports the worst sessions to the metrics, and hands over the sessions that fell behind to the stream
+		void CheckSessions();
 
-		ov::Queue<std::shared_ptr<StreamPacket>> _packet_queue;
+		// Producers: the threads that send the packets of the stream and AddSession(), Consumer: WorkerThread() or Drain()
+		ov::RingQueue<std::shared_ptr<StreamPacket>, ov::RingQueueType::Mpsc> _packet_queue;
 
 		bool _stop_thread_flag;
 		std::thread _worker_thread;
 
+		// Not nullptr if the worker runs on the shared worker pool (See ov::Executor::GetShared()) instead of _worker_thread
+		std::shared_ptr<ov::Strand> _strand;
+		std::atomic<bool> _is_drain_scheduled{false};
+
 		std::shared_ptr<Stream> _parent;
+		std::shared_ptr<mon::LatencyHistogram> _send_queue_latency;
+
+		// Run-to-completion mode (nullptr: the packets are delivered through _packet_queue)
+		std::shared_ptr<StreamPacketRing> _broadcast_ring;
+		// The sequence of the next packet to read from _broadcast_ring
+		uint64_t _ring_cursor = 0;
+		int _processor_index = -1;
+
+		std::chrono::steady_clock::time_point _last_session_check_time;
+
+		std::atomic<size_t> _session_count{0};
+		// The time spent in SendPackets() since _last_session_check_time (only the worker updates it)
+		std::chrono::steady_clock::duration _busy_time{0};
+		std::atomic<uint32_t> _load_permille{0};
 	};
 
 	class Application;
@@ -68,34 +183,130 @@ namespace pub
 		uint32_t GetSessionCount();
 
 		// A child call this function to delivery packet to all sessions
-		bool BroadcastPacket(uint32_t packet_type, std::shared_ptr<ov::Data> packet);
+		bool BroadcastPacket(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet);
+		// The packet consists of the header and the payload, which are delivered separately so that the sessions can send them without concatenating
+		// (See Session::SendOutgoingData(packet_type, header, payload))
+		bool BroadcastPacket(uint32_t packet_type, const std::shared_ptr<ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
 
 		// Child must implement this function for packetizing and call BroadcastPacket to delivery to all sessions.
 		virtual void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) = 0;
 		virtual void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) = 0;
 
+		// The trace of the frame that is delivered next by the calling thread (See mon::PacketTracer), Application sets it
+		static void SetDeliveringTrace(const std::shared_ptr<mon::PacketTrace> &trace);
+
+		// Application calls these instead of SendVideoFrame()/SendAudioFrame() to know which frames have been sent to the sessions
+		void DeliverVideoFrame(const std::shared_ptr<MediaPacket> &media_packet);
+		void DeliverAudioFrame(const std::shared_ptr<MediaPacket> &media_packet);
+
+		// Direct dispatch (See Application::SetDirectDispatch()): delivers the frame on the strand of this stream,
+		// or on the calling thread if the shared worker pool is not running (the router delivers the frames of a stream by a thread)
+		void DispatchVideoFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace);
+		void DispatchAudioFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace);
+
 		virtual bool Start(uint32_t worker_count);
 		virtual bool Stop();
 
+		// Whether the stream uses the packets of the track, asked by the router after the stream is started.
+		// The packets of the tracks that are not subscribed are not delivered to SendVideoFrame()/SendAudioFrame().
+		virtual bool IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track);
+
 		uint32_t IssueUniqueSessionId();
 
 		std::shared_ptr<Application> GetApplication();
 
+		// 0 means that each packet is sent immediately
+		size_t GetEgressBatchSize() const;
+
+		// Created by Start()
+		const std::shared_ptr<mon::LatencyHistogram> &GetSendQueueLatency() const;
+		// Created by Start(), nullptr if the memory accounting is disabled (See ov::MemoryAccounting)
+		const std::shared_ptr<ov::MemoryAccount> &GetMemoryAccount() const
+		{
+			return _memory_account;
+		}
+
+		// StreamWorker calls this (without the lock of the sessions) when the session fell behind the stream and could not catch up.
+		// By default, the session is removed from the stream.
+		virtual void OnSessionFallingBehind(const std::shared_ptr<Session> &session);
+
 	protected:
 		Stream(const std::shared_ptr<Application> application, const info::Stream &info);
 		virtual ~Stream();
-		
+
+		// When the egress batch is enabled, StreamWorker sends up to batch_size packets to all sessions,
+		// and then the datagrams generated by the sessions are sent together with sendmmsg() (See ov::DatagramBatch)
+		// Must be called before Start()
+		void SetEgressBatchSize(size_t batch_size);
+
+		// In the run-to-completion mode, each StreamWorker is pinned to a processor (the sessions are bound to a processor by their id),
+		// and BroadcastPacket() publishes a packet once into a ring that all workers read, instead of enqueuing it to each worker.
+		// Then a processor runs the whole egress path of its sessions (RTP/RTCP -> SRTP -> DTLS -> ICE -> send) without a handoff.
+		// Must be called before Start()
+		void SetRunToCompletion(bool enabled);
+
+		// A new session receives the packets of the frames since the last key frame (GOP cache of MediaRouter) before the live packets,
+		// so it doesn't have to wait for the next key frame.
+		// The child that supports it packetizes the frames for the session, and returns false if the session cannot be primed.
+		// The frames are shared with the other publishers, so they must not be modified.
+		virtual bool PacketizeGopCache(const std::shared_ptr<Session> &session, const std::vector<std::shared_ptr<MediaPacket>> &media_packets, std::vector<std::shared_ptr<StreamPacket>> *packets)
+		{
+			return false;
+		}
+
+		// The frames of the GOP cache that have been sent to the sessions
+		// (In SendVideoFrame()/SendAudioFrame(), the frames before the frame being sent)
+		std::vector<std::shared_ptr<MediaPacket>> GetDeliveredGopCache();
+
 	private:
-		std::shared_ptr<StreamWorker> GetWorkerByStreamID(session_id_t session_id);
+		void DispatchFrame(const std::shared_ptr<MediaPacket> &media_packet, const std::shared_ptr<mon::PacketTrace> &trace, bool is_video);
+
+		// The worker for a new session (the caller holds the lock of the sessions).
+		// The workers are added as the sessions increase or the workers get overloaded.
+		// The sessions stay on their worker until they leave (moving a live session would reorder its packets),
+		// so when the stream gets colder, the new sessions fill the first workers and the others become idle as their sessions leave.
+		uint32_t SelectWorker();
+		bool CreateWorker(uint32_t index);
+		std::shared_ptr<StreamWorker> GetWorkerBySessionID(session_id_t session_id);
+		// Run-to-completion mode: publishes the packet into the broadcast ring once for all workers
+		bool PublishPacket(const std::shared_ptr<StreamPacket> &stream_packet);
 		std::map<session_id_t, std::shared_ptr<Session>> _sessions;
 		std::shared_mutex _session_map_mutex;
 
-		uint32_t _worker_count;
+		// The maximum number of the workers
+		uint32_t _worker_count = 0;
 		bool _run_flag;
-		
-		std::map<uint32_t, std::shared_ptr<StreamWorker>>	_stream_workers;
+
+		// Has _worker_count slots, the workers are created in order and not removed until Stop().
+		// BroadcastPacket() reads the first _created_worker_count workers without the lock of the sessions.
+		std::vector<std::shared_ptr<StreamWorker>>	_stream_workers;
+		std::atomic<uint32_t> _created_worker_count{0};
+		// Session ID : the index of the worker of the session
+		std::map<session_id_t, uint32_t> _session_worker_indexes;
+		int _processor_count = 0;
 		std::shared_ptr<Application> _application;
 
 		session_id_t _last_issued_session_id;
+
+		size_t _egress_batch_size = 0;
+
+		// Created by Start() in the run-to-completion mode
+		bool _run_to_completion = false;
+		std::shared_ptr<StreamPacketRing> _broadcast_ring;
+
+		// Created by Start() if the application dispatches the frames directly and the shared worker pool is running
+		std::shared_ptr<ov::Strand> _dispatch_strand;
+
+		// Latency histograms (See mon::LatencyMetrics)
+		std::shared_ptr<mon::LatencyHistogram> _packetize_latency;
+		std::shared_ptr<mon::LatencyHistogram> _send_queue_latency;
+
+		std::shared_ptr<ov::MemoryAccount> _memory_account;
+
+		// SendVideoFrame()/SendAudioFrame() and AddSession() are serialized, so a new session receives each frame once
+		// either from the GOP cache or from the stream
+		std::mutex _delivery_mutex;
+		std::shared_ptr<MediaPacket> _last_delivered_video_packet;
+		std::shared_ptr<MediaPacket> _last_delivered_audio_packet;
 	};
 }  // namespace pub
\ No newline at end of file
@@ -0,0 +1,87 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "baseline.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace bench
+{
+	bool Baseline::Load(const ov::String &file_path)
+	{
+		FILE *file = ::fopen(file_path.CStr(), "r");
+
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		char line[1024];
+
+		while (::fgets(line, sizeof(line), file) != nullptr)
+		{
+			auto tokens = ov::String(line).Trim().Split(" ");
+
+			if (tokens.empty() || tokens[0].IsEmpty() || tokens[0].HasPrefix("#"))
+			{
+				continue;
+			}
+
+			if (tokens.size() < 2)
+			{
+				continue;
+			}
+
+			_ns_per_op_map[tokens[0]] = ::strtod(tokens.back().CStr(), nullptr);
+		}
+
+		::fclose(file);
+
+		return true;
+	}
+
+	bool Baseline::Save(const ov::String &file_path) const
+	{
+		FILE *file = ::fopen(file_path.CStr(), "w");
+
+		if (file == nullptr)
+		{
+			return false;
+		}
+
+		::fprintf(file, "# <benchmark> <ns/op> (written by OvenMediaEngineBenchmark -s)\n");
+
+		for (const auto &item : _ns_per_op_map)
+		{
+			::fprintf(file, "%s %.1f\n", item.first.CStr(), item.second);
+		}
+
+		::fclose(file);
+
+		return true;
+	}
+
+	bool Baseline::GetNsPerOp(const ov::String &name, double *ns_per_op) const
+	{
+		auto item = _ns_per_op_map.find(name);
+
+		if (item == _ns_per_op_map.end())
+		{
+			return false;
+		}
+
+		*ns_per_op = item->second;
+
+		return true;
+	}
+
+	void Baseline::SetNsPerOp(const ov::String &name, double ns_per_op)
+	{
+		_ns_per_op_map[name] = ns_per_op;
+	}
+}  // namespace bench
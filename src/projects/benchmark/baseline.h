@@ -0,0 +1,33 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <map>
+
+namespace bench
+{
+	// The ns/op of the benchmarks measured before, to detect the regressions
+	//
+	// Format (a benchmark per line, # is a comment):
+	//     <group>.<name> <ns/op>
+	class Baseline
+	{
+	public:
+		bool Load(const ov::String &file_path);
+		bool Save(const ov::String &file_path) const;
+
+		// Returns false if the benchmark is not in the baseline
+		bool GetNsPerOp(const ov::String &name, double *ns_per_op) const;
+		void SetNsPerOp(const ov::String &name, double ns_per_op);
+
+	private:
+		std::map<ov::String, double> _ns_per_op_map;
+	};
+}  // namespace bench
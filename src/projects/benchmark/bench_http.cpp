@@ -0,0 +1,43 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <http_server/http_request.h>
+
+#include "benchmark.h"
+
+// A request of a HLS player (the Host header is given, so the client socket is not needed)
+static const char *GetPlaylistRequest()
+{
+	return "GET /app/stream/playlist.m3u8?token=abcdefghijklmnopqrstuvwxyz HTTP/1.1\r\n"
+		   "Host: 127.0.0.1:8080\r\n"
+		   "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_4) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/13.1 Safari/605.1.15\r\n"
+		   "Accept: */*\r\n"
+		   "Accept-Language: ko-KR,ko;q=0.9,en-US;q=0.8,en;q=0.7\r\n"
+		   "Accept-Encoding: gzip, deflate\r\n"
+		   "Origin: http://127.0.0.1:8080\r\n"
+		   "Referer: http://127.0.0.1:8080/player.html\r\n"
+		   "Connection: keep-alive\r\n"
+		   "\r\n";
+}
+
+OV_BENCHMARK(http, RequestParse)
+{
+	auto request_data = std::make_shared<ov::Data>(GetPlaylistRequest(), ::strlen(GetPlaylistRequest()));
+
+	state.SetBytesPerIteration(request_data->GetLength());
+
+	while (state.KeepRunning())
+	{
+		HttpRequest request(nullptr, nullptr);
+
+		if ((request.ProcessData(request_data) < 0) || (request.ParseStatus() != HttpStatusCode::OK))
+		{
+			state.SetError("Could not parse the request");
+			return;
+		}
+	}
+}
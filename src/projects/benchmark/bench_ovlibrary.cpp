@@ -0,0 +1,213 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <thread>
+
+#include "benchmark.h"
+
+// A frame of a 2Mbps/30fps video
+#define BENCHMARK_FRAME_SIZE (8 * 1024)
+
+OV_BENCHMARK(ovlibrary, DataAppend)
+{
+	std::vector<uint8_t> chunk(1316, 0x47);
+
+	state.SetBytesPerIteration(chunk.size() * 16);
+
+	while (state.KeepRunning())
+	{
+		ov::Data data;
+
+		for (int index = 0; index < 16; index++)
+		{
+			data.Append(chunk.data(), chunk.size());
+		}
+
+		bench::DoNotOptimize(data.GetLength());
+	}
+}
+
+OV_BENCHMARK(ovlibrary, DataSubdata)
+{
+	ov::Data data(BENCHMARK_FRAME_SIZE);
+	data.SetLength(BENCHMARK_FRAME_SIZE);
+
+	while (state.KeepRunning())
+	{
+		auto subdata = data.Subdata(188, 1316);
+
+		bench::DoNotOptimize(subdata->GetData());
+	}
+}
+
+OV_BENCHMARK(ovlibrary, DataClone)
+{
+	ov::Data data(BENCHMARK_FRAME_SIZE);
+	data.SetLength(BENCHMARK_FRAME_SIZE);
+
+	while (state.KeepRunning())
+	{
+		auto clone = data.Clone();
+
+		bench::DoNotOptimize(clone->GetData());
+	}
+}
+
+// Clone() + writing to the clone (copy-on-write)
+OV_BENCHMARK(ovlibrary, DataCloneAndWrite)
+{
+	ov::Data data(BENCHMARK_FRAME_SIZE);
+	data.SetLength(BENCHMARK_FRAME_SIZE);
+
+	state.SetBytesPerIteration(BENCHMARK_FRAME_SIZE);
+
+	while (state.KeepRunning())
+	{
+		auto clone = data.Clone();
+
+		clone->GetWritableDataAs<uint8_t>()[0] = 0x00;
+		bench::DoNotOptimize(clone->GetData());
+	}
+}
+
+// The offer of the signalling (the SDP and the candidates are the most of the message)
+static void WriteOffer(ov::JsonWriter &writer, const ov::String &sdp)
+{
+	writer.BeginObject()
+		.Member("command", "offer")
+		.Member("id", 1234567)
+		.Member("peer_id", 0)
+		.Key("sdp")
+		.BeginObject()
+		.Member("sdp", sdp)
+		.Member("type", "offer")
+		.EndObject()
+		.Key("candidates")
+		.BeginArray();
+
+	for (int index = 0; index < 4; index++)
+	{
+		writer.BeginObject()
+			.Member("candidate", "candidate:0 1 UDP 50 192.168.0.183 10000 typ host generation 0")
+			.Member("sdpMLineIndex", 0)
+			.EndObject();
+	}
+
+	writer.EndArray()
+		.Member("code", 200)
+		.EndObject();
+}
+
+static ov::String MakeSdp()
+{
+	ov::String sdp;
+
+	for (int index = 0; index < 40; index++)
+	{
+		sdp.AppendFormat("a=rtpmap:%d H264/90000\r\na=fmtp:%d packetization-mode=1;profile-level-id=42e01f\r\n", 96 + index, 96 + index);
+	}
+
+	return sdp;
+}
+
+OV_BENCHMARK(ovlibrary, JsonWriter)
+{
+	auto sdp = MakeSdp();
+
+	while (state.KeepRunning())
+	{
+		ov::JsonWriter writer;
+		WriteOffer(writer, sdp);
+
+		bench::DoNotOptimize(writer.GetString().GetLength());
+	}
+}
+
+// Counts the tokens (the handler of a real message keeps only a few values)
+class TokenCounter : public ov::JsonReader::Handler
+{
+public:
+	bool OnBeginObject() override { return Count(); }
+	bool OnKey(std::string_view key) override { return Count(); }
+	bool OnEndObject() override { return Count(); }
+	bool OnBeginArray() override { return Count(); }
+	bool OnEndArray() override { return Count(); }
+	bool OnString(std::string_view value) override { return Count(); }
+	bool OnBool(bool value) override { return Count(); }
+	bool OnNull() override { return Count(); }
+	bool OnUInt64(uint64_t value) override { return Count(); }
+	bool OnInt64(int64_t value) override { return Count(); }
+	bool OnDouble(double value) override { return Count(); }
+
+	size_t count = 0;
+
+private:
+	bool Count()
+	{
+		count++;
+		return true;
+	}
+};
+
+OV_BENCHMARK(ovlibrary, JsonReader)
+{
+	ov::JsonWriter writer;
+	WriteOffer(writer, MakeSdp());
+	auto json = writer.ToData();
+
+	state.SetBytesPerIteration(json->GetLength());
+
+	while (state.KeepRunning())
+	{
+		TokenCounter counter;
+
+		if (ov::JsonReader::Parse(json, &counter) != nullptr)
+		{
+			state.SetError("Could not parse the JSON");
+			return;
+		}
+
+		bench::DoNotOptimize(counter.count);
+	}
+}
+
+OV_BENCHMARK(ovlibrary, QueueEnqueueDequeue)
+{
+	ov::Queue<std::shared_ptr<ov::Data>> queue("bench.queue");
+	auto data = std::make_shared<ov::Data>(BENCHMARK_FRAME_SIZE);
+
+	while (state.KeepRunning())
+	{
+		queue.Enqueue(data);
+
+		auto item = queue.Dequeue(0);
+		bench::DoNotOptimize(item);
+	}
+}
+
+// A producer thread and a consumer thread
+OV_BENCHMARK(ovlibrary, QueueProducerConsumer)
+{
+	ov::Queue<std::shared_ptr<ov::Data>> queue("bench.queue");
+	auto data = std::make_shared<ov::Data>(BENCHMARK_FRAME_SIZE);
+	auto iterations = state.GetIterations();
+
+	std::thread producer([&queue, &data, iterations]() {
+		for (uint64_t index = 0; index < iterations; index++)
+		{
+			queue.Enqueue(data);
+		}
+	});
+
+	while (state.KeepRunning())
+	{
+		auto item = queue.Dequeue();
+		bench::DoNotOptimize(item);
+	}
+
+	producer.join();
+}
@@ -0,0 +1,111 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <providers/rtmp/chunk/amf_document.h>
+#include <providers/rtmp/chunk/rtmp_chunk_parser.h>
+#include <providers/rtmp/chunk/rtmp_export_chunk.h>
+#include <providers/rtmp/chunk/rtmp_import_chunk.h>
+
+#include "benchmark.h"
+
+// The chunk size of OBS
+#define BENCHMARK_RTMP_CHUNK_SIZE 4096
+
+// A video message (8KB) that is split into the chunks
+static std::shared_ptr<ov::Data> MakeVideoChunks()
+{
+	RtmpExportChunk export_chunk(false, BENCHMARK_RTMP_CHUNK_SIZE);
+
+	auto payload = std::make_shared<std::vector<uint8_t>>(8 * 1024, 0x00);
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_MEDIA, 1000, RTMP_MSGID_VIDEO_MESSAGE, 1, payload->size());
+
+	auto chunks = export_chunk.ExportStreamData(message_header, payload);
+
+	return std::make_shared<ov::Data>(chunks->data(), chunks->size());
+}
+
+OV_BENCHMARK(rtmp, ChunkParser)
+{
+	auto chunks = MakeVideoChunks();
+	std::map<uint32_t, std::shared_ptr<const RtmpChunkHeader>> chunk_map;
+	RtmpChunkParser parser;
+
+	while (state.KeepRunning())
+	{
+		ov::ByteStream stream(chunks.get());
+
+		parser.Reset();
+		bench::DoNotOptimize(parser.Parse(chunk_map, stream));
+	}
+}
+
+OV_BENCHMARK(rtmp, ImportChunk)
+{
+	std::shared_ptr<const ov::Data> chunks = MakeVideoChunks();
+	RtmpImportChunk import_chunk(BENCHMARK_RTMP_CHUNK_SIZE);
+
+	state.SetBytesPerIteration(chunks->GetLength());
+
+	while (state.KeepRunning())
+	{
+		auto current_data = chunks;
+
+		while (current_data->IsEmpty() == false)
+		{
+			bool is_completed = false;
+			auto import_size = import_chunk.Import(current_data, &is_completed);
+
+			if (import_size <= 0)
+			{
+				state.SetError("Could not import the chunk");
+				return;
+			}
+
+			if (is_completed)
+			{
+				bench::DoNotOptimize(import_chunk.GetMessage());
+			}
+
+			current_data = current_data->Subdata(import_size);
+		}
+	}
+}
+
+// The connect command of a RTMP client
+OV_BENCHMARK(rtmp, AmfDocumentDecode)
+{
+	AmfDocument document;
+
+	document.AddProperty("connect");
+	document.AddProperty(1.0);
+
+	auto object = new AmfObject;
+	object->AddProperty("app", "app");
+	object->AddProperty("type", "nonprivate");
+	object->AddProperty("flashVer", "FMLE/3.0 (compatible; FMSc/1.0)");
+	object->AddProperty("swfUrl", "rtmp://127.0.0.1:1935/app");
+	object->AddProperty("tcUrl", "rtmp://127.0.0.1:1935/app");
+	document.AddProperty(object);
+
+	std::vector<uint8_t> encoded(2048);
+	auto encoded_size = document.Encode(encoded.data());
+
+	if (encoded_size <= 0)
+	{
+		state.SetError("Could not encode the document");
+		return;
+	}
+
+	state.SetBytesPerIteration(encoded_size);
+
+	while (state.KeepRunning())
+	{
+		AmfDocument decoded_document;
+
+		bench::DoNotOptimize(decoded_document.Decode(encoded.data(), encoded_size));
+	}
+}
@@ -0,0 +1,176 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <modules/rtp_rtcp/red_rtp_packet.h>
+#include <modules/rtp_rtcp/rtp_packetizer_h264.h>
+#include <modules/rtp_rtcp/rtp_packetizer_vp8.h>
+#include <modules/rtp_rtcp/ulpfec_generator.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_RTP_PAYLOAD_TYPE 100
+#define BENCHMARK_RED_PAYLOAD_TYPE 120
+#define BENCHMARK_ULPFEC_PAYLOAD_TYPE 121
+
+// The same as RtpPacketizer::Packetize()
+#define BENCHMARK_MAX_RTP_PAYLOAD_SIZE (DEFAULT_MAX_PACKET_SIZE - 12 - 100)
+
+// A key frame of H.264 (SPS + PPS + IDR), the start codes are excluded by the fragmentation header
+struct H264Frame
+{
+	H264Frame()
+	{
+		AppendNal(0x67, 20);
+		AppendNal(0x68, 4);
+		AppendNal(0x65, 20000);
+	}
+
+	void AppendNal(uint8_t nal_header, size_t length)
+	{
+		fragmentation.fragmentation_offset.push_back(data.size());
+		fragmentation.fragmentation_length.push_back(length);
+
+		data.push_back(nal_header);
+		data.resize(data.size() + length - 1, 0xAB);
+	}
+
+	std::vector<uint8_t> data;
+	FragmentationHeader fragmentation;
+};
+
+static RtpPacket MakeRtpPacketTemplate()
+{
+	RtpPacket rtp_packet;
+
+	rtp_packet.SetPayloadType(BENCHMARK_RTP_PAYLOAD_TYPE);
+	rtp_packet.SetSsrc(0x12345678);
+	rtp_packet.SetTimestamp(90000);
+
+	return rtp_packet;
+}
+
+static std::vector<std::shared_ptr<RtpPacket>> PacketizeH264Frame(RtpPacketizerH264 &packetizer, RtpPacket &rtp_packet_template, const H264Frame &frame)
+{
+	std::vector<std::shared_ptr<RtpPacket>> rtp_packets;
+	RTPVideoTypeHeader video_header{};
+
+	video_header.h264.packetization_mode = H264PacketizationMode::NonInterleaved;
+
+	auto packet_count = packetizer.SetPayloadData(BENCHMARK_MAX_RTP_PAYLOAD_SIZE, 0, &video_header, FrameType::VideoFrameKey,
+												  frame.data.data(), frame.data.size(), &frame.fragmentation);
+
+	for (size_t index = 0; index < packet_count; index++)
+	{
+		auto rtp_packet = std::make_shared<RtpPacket>(rtp_packet_template);
+
+		if (packetizer.NextPacket(rtp_packet.get()) == false)
+		{
+			break;
+		}
+
+		rtp_packets.push_back(std::move(rtp_packet));
+	}
+
+	return rtp_packets;
+}
+
+OV_BENCHMARK(rtp, PacketizerH264)
+{
+	H264Frame frame;
+	RtpPacketizerH264 packetizer;
+	auto rtp_packet_template = MakeRtpPacketTemplate();
+
+	state.SetBytesPerIteration(frame.data.size());
+
+	while (state.KeepRunning())
+	{
+		auto rtp_packets = PacketizeH264Frame(packetizer, rtp_packet_template, frame);
+
+		if (rtp_packets.empty())
+		{
+			state.SetError("Could not packetize the frame");
+			return;
+		}
+	}
+}
+
+OV_BENCHMARK(rtp, PacketizerVP8)
+{
+	std::vector<uint8_t> frame(20000, 0xAB);
+	RtpPacketizerVp8 packetizer;
+	auto rtp_packet_template = MakeRtpPacketTemplate();
+	RTPVideoTypeHeader video_header{};
+
+	video_header.vp8.InitRTPVideoHeaderVP8();
+
+	state.SetBytesPerIteration(frame.size());
+
+	while (state.KeepRunning())
+	{
+		auto packet_count = packetizer.SetPayloadData(BENCHMARK_MAX_RTP_PAYLOAD_SIZE, 0, &video_header, FrameType::VideoFrameKey,
+													  frame.data(), frame.size(), nullptr);
+
+		if (packet_count == 0)
+		{
+			state.SetError("Could not packetize the frame");
+			return;
+		}
+
+		for (size_t index = 0; index < packet_count; index++)
+		{
+			RtpPacket rtp_packet(rtp_packet_template);
+
+			packetizer.NextPacket(&rtp_packet);
+			bench::DoNotOptimize(rtp_packet.GetData());
+		}
+	}
+}
+
+// The FEC packets of a key frame (ULPFEC_DEFAULT_MEDIA_PACKETS_PER_FEC)
+OV_BENCHMARK(rtp, UlpfecGenerator)
+{
+	H264Frame frame;
+	RtpPacketizerH264 packetizer;
+	auto rtp_packet_template = MakeRtpPacketTemplate();
+	std::vector<std::shared_ptr<RedRtpPacket>> red_packets;
+	size_t total_bytes = 0;
+	uint16_t sequence_number = 0;
+
+	for (auto &rtp_packet : PacketizeH264Frame(packetizer, rtp_packet_template, frame))
+	{
+		rtp_packet->SetSequenceNumber(sequence_number++);
+
+		auto red_packet = std::make_shared<RedRtpPacket>(BENCHMARK_RED_PAYLOAD_TYPE, *rtp_packet);
+		total_bytes += red_packet->GetData()->GetLength();
+
+		red_packets.push_back(std::move(red_packet));
+	}
+
+	UlpfecGenerator ulpfec_generator;
+
+	state.SetBytesPerIteration(total_bytes);
+
+	while (state.KeepRunning())
+	{
+		for (auto &red_packet : red_packets)
+		{
+			ulpfec_generator.AddRtpPacketAndGenerateFec(red_packet);
+
+			while (ulpfec_generator.IsAvailableFecPackets())
+			{
+				RedRtpPacket fec_packet;
+
+				fec_packet.SetPayloadType(BENCHMARK_ULPFEC_PAYLOAD_TYPE);
+				fec_packet.SetUlpfec(true, BENCHMARK_RTP_PAYLOAD_TYPE);
+				fec_packet.PackageAsRed(BENCHMARK_RED_PAYLOAD_TYPE);
+
+				ulpfec_generator.NextPacket(&fec_packet);
+				bench::DoNotOptimize(fec_packet.GetData());
+			}
+		}
+	}
+}
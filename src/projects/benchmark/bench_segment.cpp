@@ -0,0 +1,74 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <publishers/segment/segment_stream/packetizer/m4s_segment_writer.h>
+#include <publishers/segment/segment_stream/packetizer/ts_writer.h>
+
+#include "benchmark.h"
+
+// A segment of 2 seconds (30fps video + 48KHz AAC), 2Mbps
+#define BENCHMARK_VIDEO_FRAME_COUNT 60
+#define BENCHMARK_VIDEO_FRAME_SIZE (8 * 1024)
+#define BENCHMARK_AUDIO_FRAME_COUNT 94
+#define BENCHMARK_AUDIO_FRAME_SIZE 384
+
+OV_BENCHMARK(segment, TsWriter)
+{
+	auto video_frame = std::make_shared<ov::Data>(BENCHMARK_VIDEO_FRAME_SIZE);
+	video_frame->SetLength(BENCHMARK_VIDEO_FRAME_SIZE);
+	auto audio_frame = std::make_shared<ov::Data>(BENCHMARK_AUDIO_FRAME_SIZE);
+	audio_frame->SetLength(BENCHMARK_AUDIO_FRAME_SIZE);
+
+	size_t total_frame_size = (BENCHMARK_VIDEO_FRAME_COUNT * BENCHMARK_VIDEO_FRAME_SIZE) + (BENCHMARK_AUDIO_FRAME_COUNT * BENCHMARK_AUDIO_FRAME_SIZE);
+
+	state.SetBytesPerIteration(total_frame_size);
+
+	while (state.KeepRunning())
+	{
+		// The same as HlsPacketizer::MakeSegment()
+		TsWriter ts_writer(true, true);
+
+		ts_writer.Reserve(BENCHMARK_VIDEO_FRAME_COUNT + BENCHMARK_AUDIO_FRAME_COUNT, total_frame_size);
+
+		for (int index = 0; index < BENCHMARK_VIDEO_FRAME_COUNT; index++)
+		{
+			// 90KHz timebase
+			ts_writer.WriteSample(true, (index == 0), index * 3000LL, 0, video_frame);
+		}
+
+		for (int index = 0; index < BENCHMARK_AUDIO_FRAME_COUNT; index++)
+		{
+			ts_writer.WriteSample(false, true, index * 1920LL, 0, audio_frame);
+		}
+
+		bench::DoNotOptimize(ts_writer.GetDataStream());
+	}
+}
+
+OV_BENCHMARK(segment, M4sSegmentWriter)
+{
+	auto video_frame = std::make_shared<ov::Data>(BENCHMARK_VIDEO_FRAME_SIZE);
+	video_frame->SetLength(BENCHMARK_VIDEO_FRAME_SIZE);
+
+	std::vector<std::shared_ptr<const SampleData>> sample_datas;
+
+	for (int index = 0; index < BENCHMARK_VIDEO_FRAME_COUNT; index++)
+	{
+		// 90KHz timebase, the first frame is a key frame (0x02000000: sample_depends_on = 2)
+		sample_datas.push_back(std::make_shared<SampleData>(3000, (index == 0) ? 0x02000000 : 0x01010000, index * 3000LL, 0, video_frame));
+	}
+
+	state.SetBytesPerIteration(BENCHMARK_VIDEO_FRAME_COUNT * BENCHMARK_VIDEO_FRAME_SIZE);
+
+	while (state.KeepRunning())
+	{
+		// The same as DashPacketizer::WriteVideoSegment()
+		M4sSegmentWriter writer(M4sMediaType::Video, 1, 1, 0);
+
+		bench::DoNotOptimize(writer.AppendSamples(sample_datas));
+	}
+}
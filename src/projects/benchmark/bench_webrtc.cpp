@@ -0,0 +1,137 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <modules/dtls_srtp/srtp_adapter.h>
+#include <modules/ice/stun/attributes/stun_attributes.h>
+#include <modules/ice/stun/stun_message.h>
+#include <openssl/srtp.h>
+
+#include "benchmark.h"
+
+#define BENCHMARK_ICE_PASSWORD "0123456789abcdefghijklmn"
+
+// A binding request of a WebRTC player (the same attributes as IcePort::SendBindingRequest())
+static void MakeBindingRequest(StunMessage *message)
+{
+	uint8_t transaction_id[OV_STUN_TRANSACTION_ID_LENGTH] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B'};
+
+	message->SetClass(StunClass::Request);
+	message->SetMethod(StunMethod::Binding);
+	message->SetTransactionId(transaction_id);
+
+	auto user_name_attribute = std::make_unique<StunUserNameAttribute>();
+	user_name_attribute->SetUserName("abcd:efgh");
+	message->AddAttribute(std::move(user_name_attribute));
+
+	// ICE-CONTROLLING
+	auto unknown_attribute = std::make_unique<StunUnknownAttribute>(0x802A, 8);
+	uint8_t tie_breaker[] = {0x1C, 0xF5, 0x1E, 0xB1, 0xB0, 0xCB, 0xE3, 0x49};
+	unknown_attribute->SetData(tie_breaker, sizeof(tie_breaker));
+	message->AddAttribute(std::move(unknown_attribute));
+
+	// USE-CANDIDATE
+	message->AddAttribute(std::make_unique<StunUnknownAttribute>(0x0025, 0));
+
+	// PRIORITY
+	unknown_attribute = std::make_unique<StunUnknownAttribute>(0x0024, 4);
+	uint8_t priority[] = {0x6E, 0x7F, 0x1E, 0xFF};
+	unknown_attribute->SetData(priority, sizeof(priority));
+	message->AddAttribute(std::move(unknown_attribute));
+}
+
+OV_BENCHMARK(webrtc, StunMessageParse)
+{
+	StunMessage request_message;
+	MakeBindingRequest(&request_message);
+
+	auto serialized = request_message.Serialize(BENCHMARK_ICE_PASSWORD);
+
+	if (serialized == nullptr)
+	{
+		state.SetError("Could not serialize the message");
+		return;
+	}
+
+	while (state.KeepRunning())
+	{
+		ov::ByteStream stream(serialized.get());
+		StunMessage message;
+
+		if (message.Parse(stream) == false)
+		{
+			state.SetError("Could not parse the message");
+			return;
+		}
+	}
+}
+
+// Including MESSAGE-INTEGRITY and FINGERPRINT (the HMAC key is prepared once like IcePort does)
+OV_BENCHMARK(webrtc, StunMessageSerialize)
+{
+	StunMessage request_message;
+	MakeBindingRequest(&request_message);
+
+	ov::Hmac integrity;
+
+	if (integrity.Create(ov::CryptoAlgorithm::Sha1, BENCHMARK_ICE_PASSWORD) == false)
+	{
+		state.SetError("Could not create HMAC");
+		return;
+	}
+
+	while (state.KeepRunning())
+	{
+		bench::DoNotOptimize(request_message.Serialize(integrity));
+	}
+}
+
+// A RTP packet of the maximum size (DEFAULT_MAX_PACKET_SIZE of rtp_rtcp)
+OV_BENCHMARK(webrtc, SrtpProtectRtp)
+{
+	if (::srtp_init() != srtp_err_status_ok)
+	{
+		state.SetError("Could not initialize SRTP");
+		return;
+	}
+
+	// AES128_CM_SHA1_80: 16 bytes of key + 14 bytes of salt
+	auto key = std::make_shared<ov::Data>(30);
+	key->SetLength(30);
+	::memset(key->GetWritableData(), 0x5A, key->GetLength());
+
+	SrtpAdapter srtp_adapter;
+
+	if (srtp_adapter.SetKey(ssrc_any_outbound, SRTP_AES128_CM_SHA1_80, key) == false)
+	{
+		state.SetError("Could not set the key");
+		return;
+	}
+
+	std::vector<uint8_t> rtp_packet(1200, 0xAB);
+	// V=2, PT=100, SSRC=0x12345678
+	rtp_packet[0] = 0x80;
+	rtp_packet[1] = 100;
+	rtp_packet[8] = 0x12;
+	rtp_packet[9] = 0x34;
+	rtp_packet[10] = 0x56;
+	rtp_packet[11] = 0x78;
+
+	state.SetBytesPerIteration(rtp_packet.size());
+
+	while (state.KeepRunning())
+	{
+		// Room for the auth tag
+		auto data = std::make_shared<ov::Data>(rtp_packet.size() + 16);
+		data->Append(rtp_packet.data(), rtp_packet.size());
+
+		if (srtp_adapter.ProtectRtp(data) == false)
+		{
+			state.SetError("Could not protect the packet");
+			return;
+		}
+	}
+}
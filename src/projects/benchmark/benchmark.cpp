@@ -0,0 +1,29 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "benchmark.h"
+
+namespace bench
+{
+	static std::vector<Benchmark> &GetBenchmarkList()
+	{
+		// The benchmarks are registered while the static objects are initialized
+		static std::vector<Benchmark> benchmark_list;
+		return benchmark_list;
+	}
+
+	bool Registry::Register(const char *name, const std::function<void(State &state)> &function)
+	{
+		GetBenchmarkList().push_back({name, function});
+		return true;
+	}
+
+	const std::vector<Benchmark> &Registry::GetList()
+	{
+		return GetBenchmarkList();
+	}
+}  // namespace bench
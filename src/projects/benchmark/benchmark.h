@@ -0,0 +1,131 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Defines a benchmark that is registered to bench::Registry
+//
+// Usage:
+//     OV_BENCHMARK(ovlibrary, DataAppend)
+//     {
+//         (preparation, not measured)
+//
+//         while (state.KeepRunning())
+//         {
+//             (measured)
+//         }
+//     }
+#define OV_BENCHMARK(group, name)                                                                                                   \
+	static void Benchmark_##group##_##name(bench::State &state);                                                                    \
+	static const bool _benchmark_##group##_##name##_registered = bench::Registry::Register(#group "." #name, Benchmark_##group##_##name); \
+	static void Benchmark_##group##_##name(bench::State &state)
+
+namespace bench
+{
+	class State
+	{
+	public:
+		explicit State(uint64_t iterations)
+			: _iterations(iterations),
+			  _remaining(iterations)
+		{
+		}
+
+		// The time is measured from the first call, so the preparation before the loop is not counted
+		bool KeepRunning()
+		{
+			if (_is_started == false)
+			{
+				_is_started = true;
+				_start_time = std::chrono::steady_clock::now();
+			}
+
+			if (_remaining == 0)
+			{
+				_end_time = std::chrono::steady_clock::now();
+				return false;
+			}
+
+			_remaining--;
+			return true;
+		}
+
+		uint64_t GetIterations() const
+		{
+			return _iterations;
+		}
+
+		// The bytes processed by an iteration (to report the throughput)
+		void SetBytesPerIteration(size_t bytes)
+		{
+			_bytes_per_iteration = bytes;
+		}
+
+		size_t GetBytesPerIteration() const
+		{
+			return _bytes_per_iteration;
+		}
+
+		int64_t GetElapsedNsec() const
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(_end_time - _start_time).count();
+		}
+
+		// Marks the benchmark as failed (the result is not reported)
+		void SetError(const char *message)
+		{
+			_error = message;
+		}
+
+		const ov::String &GetError() const
+		{
+			return _error;
+		}
+
+	private:
+		uint64_t _iterations;
+		uint64_t _remaining;
+		bool _is_started = false;
+
+		size_t _bytes_per_iteration = 0;
+		ov::String _error;
+
+		std::chrono::steady_clock::time_point _start_time;
+		std::chrono::steady_clock::time_point _end_time;
+	};
+
+	struct Benchmark
+	{
+		// <group>.<name>
+		ov::String name;
+		std::function<void(State &state)> function;
+	};
+
+	class Registry
+	{
+	public:
+		static bool Register(const char *name, const std::function<void(State &state)> &function);
+
+		static const std::vector<Benchmark> &GetList();
+	};
+
+	// Prevents the compiler from removing the computation of the value
+	template <typename T>
+	inline void DoNotOptimize(const T &value)
+	{
+		asm volatile(""
+					 :
+					 : "r,m"(value)
+					 : "memory");
+	}
+}  // namespace bench
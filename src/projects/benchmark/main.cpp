@@ -0,0 +1,212 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <getopt.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "baseline.h"
+#include "benchmark.h"
+
+struct BenchmarkOption
+{
+	// -f <filter>: runs the benchmarks whose name contains the filter
+	ov::String filter;
+	// -b <file>: compares the results with the baseline
+	ov::String baseline_path;
+	// -s <file>: saves the results as the baseline
+	ov::String save_path;
+	// -t <percent>: a benchmark is regressed if it is slower than the baseline by more than this
+	double tolerance_percent = 15.0;
+	// -m <msec>: the minimum time of a repetition
+	int min_time_msec = 300;
+	// -r <count>: the fastest repetition is taken to reduce the noise
+	int repetitions = 3;
+};
+
+static void PrintUsage(const char *program)
+{
+	::printf("Usage: %s [-f <filter>] [-b <baseline file>] [-s <baseline file to save>] [-t <tolerance %%>] [-m <min time msec>] [-r <repetitions>]\n", program);
+}
+
+static bool TryParseOption(int argc, char *argv[], BenchmarkOption *option)
+{
+	constexpr const char *opt_string = "hf:b:s:t:m:r:";
+
+	while (true)
+	{
+		int name = ::getopt(argc, argv, opt_string);
+
+		switch (name)
+		{
+			case -1:
+				// end of arguments
+				return true;
+
+			case 'f':
+				option->filter = optarg;
+				break;
+
+			case 'b':
+				option->baseline_path = optarg;
+				break;
+
+			case 's':
+				option->save_path = optarg;
+				break;
+
+			case 't':
+				option->tolerance_percent = ::strtod(optarg, nullptr);
+				break;
+
+			case 'm':
+				option->min_time_msec = std::max(::atoi(optarg), 1);
+				break;
+
+			case 'r':
+				option->repetitions = std::max(::atoi(optarg), 1);
+				break;
+
+			default:  // 'h', '?'
+				return false;
+		}
+	}
+}
+
+// Runs the benchmark with enough iterations to take min_time_nsec
+static bool RunBenchmark(const bench::Benchmark &benchmark, int64_t min_time_nsec, double *ns_per_op, size_t *bytes_per_iteration)
+{
+	uint64_t iterations = 1;
+
+	while (true)
+	{
+		bench::State state(iterations);
+
+		benchmark.function(state);
+
+		if (state.GetError().IsEmpty() == false)
+		{
+			::printf("%-40s FAILED (%s)\n", benchmark.name.CStr(), state.GetError().CStr());
+			return false;
+		}
+
+		auto elapsed_nsec = std::max<int64_t>(state.GetElapsedNsec(), 1);
+
+		if ((elapsed_nsec >= min_time_nsec) || (iterations >= 1000000000ULL))
+		{
+			*ns_per_op = static_cast<double>(elapsed_nsec) / iterations;
+			*bytes_per_iteration = state.GetBytesPerIteration();
+			return true;
+		}
+
+		// Predicts the iterations for min_time_nsec (at most 100x at a time, the first runs are too short to predict)
+		auto next_iterations = static_cast<uint64_t>(iterations * (min_time_nsec * 1.2 / elapsed_nsec));
+		iterations = std::clamp<uint64_t>(next_iterations, iterations + 1, iterations * 100);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	BenchmarkOption option;
+
+	if (TryParseOption(argc, argv, &option) == false)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	// The benchmarked code may log for each call
+	ov_log_set_level(OVLogLevelError);
+
+	bench::Baseline baseline;
+
+	if ((option.baseline_path.IsEmpty() == false) && (baseline.Load(option.baseline_path) == false))
+	{
+		::printf("Could not load the baseline: %s\n", option.baseline_path.CStr());
+		return 1;
+	}
+
+	bench::Baseline results;
+	int regressed_count = 0;
+	int failed_count = 0;
+
+	::printf("%-40s %14s %12s %10s\n", "Benchmark", "ns/op", "MB/s", "Baseline");
+
+	for (const auto &benchmark : bench::Registry::GetList())
+	{
+		if ((option.filter.IsEmpty() == false) && (benchmark.name.IndexOf(option.filter.CStr()) < 0))
+		{
+			continue;
+		}
+
+		double best_ns_per_op = 0.0;
+		size_t bytes_per_iteration = 0;
+		bool is_succeeded = true;
+
+		for (int repetition = 0; repetition < option.repetitions; repetition++)
+		{
+			double ns_per_op = 0.0;
+
+			if (RunBenchmark(benchmark, option.min_time_msec * 1000000LL, &ns_per_op, &bytes_per_iteration) == false)
+			{
+				is_succeeded = false;
+				break;
+			}
+
+			best_ns_per_op = (repetition == 0) ? ns_per_op : std::min(best_ns_per_op, ns_per_op);
+		}
+
+		if (is_succeeded == false)
+		{
+			failed_count++;
+			continue;
+		}
+
+		results.SetNsPerOp(benchmark.name, best_ns_per_op);
+
+		ov::String throughput = "-";
+
+		if (bytes_per_iteration > 0)
+		{
+			throughput.Format("%.1f", (bytes_per_iteration * 1000.0) / best_ns_per_op);
+		}
+
+		ov::String comparison = "-";
+		double baseline_ns_per_op = 0.0;
+
+		if (baseline.GetNsPerOp(benchmark.name, &baseline_ns_per_op) && (baseline_ns_per_op > 0.0))
+		{
+			double change_percent = ((best_ns_per_op / baseline_ns_per_op) - 1.0) * 100.0;
+			bool is_regressed = (change_percent > option.tolerance_percent);
+
+			comparison.Format("%+.1f%%%s", change_percent, is_regressed ? " REGRESSED" : "");
+
+			if (is_regressed)
+			{
+				regressed_count++;
+			}
+		}
+
+		::printf("%-40s %14.1f %12s %10s\n", benchmark.name.CStr(), best_ns_per_op, throughput.CStr(), comparison.CStr());
+	}
+
+	if ((option.save_path.IsEmpty() == false) && (results.Save(option.save_path) == false))
+	{
+		::printf("Could not save the baseline: %s\n", option.save_path.CStr());
+		return 1;
+	}
+
+	if ((regressed_count > 0) || (failed_count > 0))
+	{
+		::printf("%d benchmark(s) regressed by more than %.1f%%, %d benchmark(s) failed\n", regressed_count, option.tolerance_percent, failed_count);
+		return 2;
+	}
+
+	return 0;
+}
@@ -46,17 +46,24 @@ namespace cfg
 		ov::String server_config_path = ov::PathManager::Combine(config_path, "Server.xml");
 		logti("Trying to load configurations... (%s)", server_config_path.CStr());
 
-		_server = std::make_shared<cfg::Server>();
-		bool result = _server->Parse(server_config_path, "Server");
+		// The new configuration is parsed aside, and replaces the current one only if it is valid
+		// (the threads that are using the current one keep it until they release it)
+		auto server = std::make_shared<cfg::Server>();
 
-		if (IsValidVersion("Server", ov::Converter::ToInt32(_server->GetVersion())) == false)
+		if (server->Parse(server_config_path, "Server") == false)
 		{
 			return false;
 		}
 
+		if (IsValidVersion("Server", ov::Converter::ToInt32(server->GetVersion())) == false)
+		{
+			return false;
+		}
+
+		std::atomic_store(&_server, server);
 		_config_path = config_path;
 
-		return result;
+		return true;
 	}
 
 	bool ConfigManager::LoadConfigs()
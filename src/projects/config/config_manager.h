@@ -24,9 +24,10 @@ namespace cfg
 
 		bool ReloadConfigs();
 
+		// The configuration is replaced by ReloadConfigs(), so the caller should keep the returned instance while using it
 		std::shared_ptr<Server> GetServer() noexcept
 		{
-			return _server;
+			return std::atomic_load(&_server);
 		}
 
 		//
@@ -17,15 +17,19 @@ namespace cfg
 	{
 		CFG_DECLARE_REF_GETTER_OF(GetProviders, _providers)
 		CFG_DECLARE_REF_GETTER_OF(GetPublishers, _publishers)
+		// GET /metrics (Prometheus), it is disabled if not configured
+		CFG_DECLARE_REF_GETTER_OF(GetMetrics, _metrics)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue("Providers", &_providers);
 			RegisterValue("Publishers", &_publishers);
+			RegisterValue<Optional>("Metrics", &_metrics);
 		}
 
 		BindProviders _providers;
 		BindPublishers _publishers;
+		Port _metrics{"9100/tcp"};
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -8,6 +8,8 @@
 //==============================================================================
 #pragma once
 
+#include "../publishers/webrtc/webrtc_port.h"
+
 namespace cfg
 {
 	struct BindProviders : public Item
@@ -18,6 +20,10 @@ namespace cfg
 		CFG_DECLARE_GETTER_OF(GetRtmpPort, _rtmp.GetPort())
 		CFG_DECLARE_REF_GETTER_OF(GetRtsp, _rtsp)
 		CFG_DECLARE_GETTER_OF(GetRtspPort, _rtsp.GetPort())
+		CFG_DECLARE_REF_GETTER_OF(GetRtspUdp, _rtsp_udp)
+		CFG_DECLARE_REF_GETTER_OF(GetWebrtc, _webrtc)
+		CFG_DECLARE_REF_GETTER_OF(GetSrt, _srt)
+		CFG_DECLARE_GETTER_OF(GetSrtPort, _srt.GetPort())
 
 	protected:
 		void MakeParseList() override
@@ -25,10 +31,19 @@ namespace cfg
 			RegisterValue<Optional>("OVT", &_ovt);
 			RegisterValue<Optional>("RTMP", &_rtmp);
 			RegisterValue<Optional>("RTSP", &_rtsp);
+			RegisterValue<Optional>("RTSPUDP", &_rtsp_udp);
+			RegisterValue<Optional>("WebRTC", &_webrtc);
+			RegisterValue<Optional>("SRT", &_srt);
 		};
 
 		Port _ovt{"9000/tcp"};
 		Port _rtmp{"1935/tcp"};
 		Port _rtsp{"554/tcp"};
+		// The RTP port shared by the UDP tracks of RTSP RECORD (RTCP: the port + 1), a pair of ports is opened per track if it is not set
+		Port _rtsp_udp{"6970/udp"};
+		// The signalling port receives the SDP offers of the publishers (WHIP-style HTTP POST)
+		WebrtcPort _webrtc{"3335/tcp"};
+		// The publishers set the SRT stream id to srt://host/app/stream (URL encoded) or #!::h=host,r=app/stream
+		Port _srt{"9999/srt"};
 	};
 }  // namespace cfg
\ No newline at end of file
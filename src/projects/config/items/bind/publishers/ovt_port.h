@@ -0,0 +1,39 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The port of the OVT publisher, which the edges connect to
+	struct OvtPort : public Port
+	{
+		explicit OvtPort(const char *port)
+			: Port(port)
+		{
+		}
+
+		// The UDP port to send the media packets to the edges that request the datagram mode (0 disables it)
+		CFG_DECLARE_GETTER_OF(GetDatagramPort, _datagram_port)
+		// The UNIX domain socket that hands the shared memory of the streams over to the edges on the same host (empty disables it)
+		CFG_DECLARE_REF_GETTER_OF(GetSharedMemoryPath, _shared_memory_path)
+
+	protected:
+		void MakeParseList() override
+		{
+			Port::MakeParseList();
+
+			RegisterValue<Optional>("DatagramPort", &_datagram_port, nullptr, [this]() -> bool {
+				return (_datagram_port >= 0) && (_datagram_port < 65536);
+			});
+			RegisterValue<Optional>("SharedMemoryPath", &_shared_memory_path);
+		}
+
+		int _datagram_port = 0;
+		ov::String _shared_memory_path;
+	};
+}  // namespace cfg
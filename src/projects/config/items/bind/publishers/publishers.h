@@ -8,6 +8,8 @@
 //==============================================================================
 #pragma once
 
+#include "ovt_port.h"
+#include "segment_port.h"
 #include "webrtc/webrtc_port.h"
 
 namespace cfg
@@ -42,10 +44,10 @@ namespace cfg
 			RegisterValue<Optional>("WebRTC", &_webrtc);
 		};
 
-		Port _ovt{"9000/tcp"};
+		OvtPort _ovt{"9000/tcp"};
 		Port _rtmp{"1935/tcp"};
-		TlsPort _hls{"80/tcp", "443/tcp"};
-		TlsPort _dash{"80/tcp", "443/tcp"};
+		SegmentPort _hls{"80/tcp", "443/tcp"};
+		SegmentPort _dash{"80/tcp", "443/tcp"};
 		WebrtcPort _webrtc{"3333/tcp", "3334/tcp"};
 	};
 }  // namespace cfg
\ No newline at end of file
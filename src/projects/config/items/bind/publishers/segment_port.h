@@ -0,0 +1,43 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The port of the segment publishers (HLS/DASH), which serves the playlists and the segments over HTTP
+	struct SegmentPort : public TlsPort
+	{
+		explicit SegmentPort(const char *port, const char *tls_port)
+			: TlsPort(port, tls_port)
+		{
+		}
+
+		// The idle connections are closed after this time (0 disables the persistent connections)
+		CFG_DECLARE_GETTER_OF(GetKeepAliveTimeout, _keep_alive_timeout)
+		// The connection is closed after this number of requests (0 means unlimited)
+		CFG_DECLARE_GETTER_OF(GetMaxKeepAliveRequests, _max_keep_alive_requests)
+
+	protected:
+		void MakeParseList() override
+		{
+			TlsPort::MakeParseList();
+
+			RegisterValue<Optional>("KeepAliveTimeout", &_keep_alive_timeout, nullptr, [this]() -> bool {
+				return (_keep_alive_timeout >= 0);
+			});
+			RegisterValue<Optional>("MaxKeepAliveRequests", &_max_keep_alive_requests, nullptr, [this]() -> bool {
+				return (_max_keep_alive_requests >= 0);
+			});
+		}
+
+		// In seconds
+		int _keep_alive_timeout = 15;
+		int _max_keep_alive_requests = 1000;
+	};
+}  // namespace cfg
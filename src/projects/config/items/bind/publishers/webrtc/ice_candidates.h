@@ -15,14 +15,21 @@ namespace cfg
 	struct IceCandidates : public Item
 	{
 		CFG_DECLARE_REF_GETTER_OF(GetIceCandidateList, _ice_candidate_list);
+		// The number of SO_REUSEPORT sockets (and the threads that dispatch them) opened for each ICE port
+		CFG_DECLARE_GETTER_OF(GetReactorCount, _reactor_count);
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue<Optional>("IceCandidate", &_ice_candidate_list);
+			RegisterValue<Optional>("ReactorCount", &_reactor_count, nullptr, [this]() -> bool {
+				return (_reactor_count > 0);
+			});
 		}
 
 		std::vector<IceCandidate> _ice_candidate_list{
 			IceCandidate("*:10000-10005/udp")};
+
+		int _reactor_count = 1;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovsocket/socket_datastructure.h>
+
+namespace cfg
+{
+	// The latency-optimized egress of a TCP port (See ov::TcpLowLatencyOptions)
+	struct LowLatency : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetNotSentLowWatermark, _not_sent_low_watermark)
+		CFG_DECLARE_GETTER_OF(GetMaxPacingRate, _max_pacing_rate)
+		CFG_DECLARE_GETTER_OF(GetMaxQueueDelay, _max_queue_delay)
+
+		ov::TcpLowLatencyOptions ToSocketOptions() const
+		{
+			ov::TcpLowLatencyOptions options;
+
+			options.enabled = _enable;
+			options.not_sent_low_watermark = _not_sent_low_watermark;
+			options.max_pacing_rate = static_cast<int64_t>(_max_pacing_rate) * 1000LL / 8LL;
+			options.max_queue_delay = _max_queue_delay;
+
+			return options;
+		}
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("NotSentLowWatermark", &_not_sent_low_watermark, nullptr, [this]() -> bool {
+				return (_not_sent_low_watermark >= 0);
+			});
+			RegisterValue<Optional>("MaxPacingRate", &_max_pacing_rate, nullptr, [this]() -> bool {
+				return (_max_pacing_rate >= 0);
+			});
+			RegisterValue<Optional>("MaxQueueDelay", &_max_queue_delay, nullptr, [this]() -> bool {
+				return (_max_queue_delay >= 0);
+			});
+		}
+
+		bool _enable = false;
+		// In bytes
+		int _not_sent_low_watermark = 16384;
+		// In Kbps (0: not paced)
+		int _max_pacing_rate = 0;
+		// In milliseconds (0: the late data is not dropped)
+		int _max_queue_delay = 500;
+	};
+}  // namespace cfg
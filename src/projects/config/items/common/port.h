@@ -11,6 +11,8 @@
 #include <base/ovsocket/socket.h>
 #include <base/ovlibrary/converter.h>
 
+#include "./low_latency.h"
+
 namespace cfg
 {
 	struct Port : public Item
@@ -22,6 +24,14 @@ namespace cfg
 
 		CFG_DECLARE_VIRTUAL_GETTER_OF(int, GetPort, _port_value)
 		CFG_DECLARE_VIRTUAL_GETTER_OF(ov::SocketType, GetSocketType, _socket_type)
+		// The number of SO_REUSEPORT sockets (and the threads that dispatch them) opened for this port
+		CFG_DECLARE_VIRTUAL_GETTER_OF(int, GetReactorCount, _reactor_count)
+		// The number of threads that deliver the received data of TCP clients to the observers (0: the number of processors)
+		CFG_DECLARE_VIRTUAL_GETTER_OF(int, GetWorkerCount, _worker_count)
+		// If true, each worker thread is pinned to a processor
+		CFG_DECLARE_VIRTUAL_GETTER_OF(bool, GetWorkerAffinity, _worker_affinity)
+		// The latency-optimized egress (TCP only)
+		CFG_DECLARE_REF_GETTER_OF(GetLowLatency, _low_latency)
 
 	protected:
 		void MakeParseList() override
@@ -63,11 +73,28 @@ namespace cfg
 
 				return _socket_type != ov::SocketType::Unknown;
 			});
+
+			RegisterValue<Optional>("ReactorCount", &_reactor_count, nullptr, [this]() -> bool {
+				return (_reactor_count > 0);
+			});
+
+			RegisterValue<Optional>("WorkerCount", &_worker_count, nullptr, [this]() -> bool {
+				return (_worker_count >= 0);
+			});
+			RegisterValue<Optional>("WorkerAffinity", &_worker_affinity);
+			RegisterValue<Optional>("LowLatency", &_low_latency);
 		}
 
 		ov::String _port;
 
 		int _port_value = 0;
 		ov::SocketType _socket_type = ov::SocketType::Unknown;
+
+		int _reactor_count = 1;
+
+		int _worker_count = 16;
+		bool _worker_affinity = false;
+
+		LowLatency _low_latency;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -13,13 +13,17 @@ namespace cfg
 	struct P2P : public Item
 	{
 		CFG_DECLARE_GETTER_OF(GetMaxClientPeersPerHostPeer, _max_client_peers_per_host_peer)
+		// The maximum number of the peers between OME and a peer (1: the clients receive from the host peers only)
+		CFG_DECLARE_GETTER_OF(GetMaxDepth, _max_depth)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue<Optional>("MaxClientPeersPerHostPeer", &_max_client_peers_per_host_peer);
+			RegisterValue<Optional>("MaxDepth", &_max_depth);
 		}
 
 		int _max_client_peers_per_host_peer = 2;
+		int _max_depth = 1;
 	};
 }  // namespace cfg
\ No newline at end of file
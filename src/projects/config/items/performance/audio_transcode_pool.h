@@ -0,0 +1,29 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct AudioTranscodePool : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("ThreadCount", &_thread_count);
+		}
+
+		// The audio-only transcode streams are decoded/resampled/encoded on a pool of threads instead of the threads of their own
+		bool _enable = false;
+		// The number of threads of the pool (0: the number of processors)
+		int _thread_count = 0;
+	};
+}  // namespace cfg
@@ -0,0 +1,41 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The limits of the queues of the media pipeline, so that a slow consumer cannot exhaust the memory of the server
+	struct Backpressure : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetMaxQueueBytes, _max_queue_bytes)
+		CFG_DECLARE_GETTER_OF(GetMaxSocketQueueBytes, _max_socket_queue_bytes)
+		CFG_DECLARE_REF_GETTER_OF(GetPolicy, _policy)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("MaxQueueBytes", &_max_queue_bytes);
+			RegisterValue<Optional>("MaxSocketQueueBytes", &_max_socket_queue_bytes);
+			RegisterValue<Optional>("Policy", &_policy);
+		}
+
+		bool _enable = true;
+		// The bytes of the media packets in each queue (router, transcoder, publisher)
+		int _max_queue_bytes = 64 * 1024 * 1024;
+		// The bytes received from the TCP clients that wait for the worker threads (per worker)
+		int _max_socket_queue_bytes = 64 * 1024 * 1024;
+		// What to do with a queue that exceeds the limit
+		//   - dropnonreference: Drop the non-reference frames first, and then drop to the next key frame
+		//   - droptokeyframe: Drop the oldest frames with the frames that depend on them
+		//   - disconnect: Close the connection that overflows the socket queue (the media queues drop to the next key frame)
+		// The socket queues always close the connection, because the received bytes of TCP cannot be dropped
+		ov::String _policy = "dropnonreference";
+	};
+}  // namespace cfg
@@ -0,0 +1,34 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// Captures the incoming streams to files, they are replayed with replay:// (See MediaCapture)
+	struct Capture : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_REF_GETTER_OF(GetPath, _path)
+		CFG_DECLARE_REF_GETTER_OF(GetStreams, _streams)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("Path", &_path);
+			RegisterValue<Optional>("Streams", &_streams);
+		}
+
+		bool _enable = false;
+		// The directory of the capture files
+		ov::String _path;
+		// <vhost_app_name>/<stream_name> of the streams to capture (the wildcards are allowed)
+		ov::String _streams = "*";
+	};
+}  // namespace cfg
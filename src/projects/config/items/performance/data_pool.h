@@ -0,0 +1,29 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct DataPool : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetMaxFreeBytesPerClass, _max_free_bytes_per_class)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("MaxFreeBytesPerClass", &_max_free_bytes_per_class);
+		}
+
+		bool _enable = false;
+		// The maximum bytes of free buffers kept per size class per thread
+		int _max_free_bytes_per_class = 4 * 1024 * 1024;
+	};
+}  // namespace cfg
@@ -0,0 +1,31 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct HotUpgrade : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetDrainTimeout, _drain_timeout)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("DrainTimeout", &_drain_timeout, nullptr, [this]() -> bool {
+				return (_drain_timeout >= 0);
+			});
+		}
+
+		// SIGUSR2 executes the binary again, and hands the listening sockets over to the new process
+		bool _enable = false;
+		// The old process is terminated when all of its connections are closed, or after this (seconds, 0: waits forever)
+		int _drain_timeout = 600;
+	};
+}  // namespace cfg
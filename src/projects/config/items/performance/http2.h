@@ -0,0 +1,26 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct Http2 : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+		}
+
+		// Multiplexes the requests of a client over a connection (h2 of ALPN for HTTPS, prior knowledge for HTTP)
+		bool _enable = false;
+	};
+}  // namespace cfg
@@ -0,0 +1,26 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct IoUring : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+		}
+
+		// Receives the data of the TCP clients that become readable at the same time with a single io_uring_enter() (Linux 5.7+)
+		bool _enable = false;
+	};
+}  // namespace cfg
@@ -0,0 +1,26 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct KernelTls : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+		}
+
+		// Hands over the encryption of the HTTPS responses to the kernel (kTLS) after the handshake
+		bool _enable = false;
+	};
+}  // namespace cfg
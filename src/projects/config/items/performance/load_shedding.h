@@ -0,0 +1,41 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct LoadShedding : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetMaxCpuUsage, _max_cpu_usage)
+		CFG_DECLARE_GETTER_OF(GetMaxMemoryUsage, _max_memory_usage)
+		CFG_DECLARE_GETTER_OF(GetMaxNetworkMbps, _max_network_mbps)
+		CFG_DECLARE_GETTER_OF(GetMaxSocketBufferUsage, _max_socket_buffer_usage)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("MaxCPUUsage", &_max_cpu_usage);
+			RegisterValue<Optional>("MaxMemoryUsage", &_max_memory_usage);
+			RegisterValue<Optional>("MaxNetworkMbps", &_max_network_mbps);
+			RegisterValue<Optional>("MaxSocketBufferUsage", &_max_socket_buffer_usage);
+		}
+
+		// Rejects the new WebRTC sessions and the new pulls while a threshold is crossed
+		bool _enable = false;
+		// The CPU usage of the host (%, 0 disables)
+		int _max_cpu_usage = 90;
+		// The memory usage of the host except the page cache (%, 0 disables)
+		int _max_memory_usage = 90;
+		// The transmitted bits of all interfaces (Mbps, 0 disables)
+		int _max_network_mbps = 0;
+		// The memory of the TCP/UDP socket buffers relative to tcp_mem/udp_mem (%, 0 disables)
+		int _max_socket_buffer_usage = 90;
+	};
+}  // namespace cfg
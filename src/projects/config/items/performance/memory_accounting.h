@@ -0,0 +1,26 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// Accounts the live bytes of the buffers by subsystem and stream, they are exported to /metrics (See ov::MemoryAccounting)
+	struct MemoryAccounting : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+		}
+
+		bool _enable = false;
+	};
+}  // namespace cfg
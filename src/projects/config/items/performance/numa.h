@@ -0,0 +1,30 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct Numa : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(IsHugePagesEnabled, _huge_pages)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("HugePages", &_huge_pages);
+		}
+
+		// Binds the threads of a stream (ingest, transcode, delivery) to the processors of a NUMA node (See ov::Numa)
+		bool _enable = false;
+		// Backs the large buffers (2 MB or larger) with the transparent huge pages
+		bool _huge_pages = false;
+	};
+}  // namespace cfg
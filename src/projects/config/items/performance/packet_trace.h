@@ -0,0 +1,25 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct PacketTrace : public Item
+	{
+		CFG_DECLARE_GETTER_OF(GetSampleInterval, _sample_interval)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("SampleInterval", &_sample_interval);
+		}
+
+		// Traces 1 of N packets through the pipeline (0: disabled), the traces are served at /traces of the metrics server
+		int _sample_interval = 0;
+	};
+}  // namespace cfg
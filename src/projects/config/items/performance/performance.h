@@ -0,0 +1,103 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "audio_transcode_pool.h"
+#include "backpressure.h"
+#include "capture.h"
+#include "data_pool.h"
+#include "hot_upgrade.h"
+#include "http2.h"
+#include "io_uring.h"
+#include "kernel_tls.h"
+#include "load_shedding.h"
+#include "memory_accounting.h"
+#include "numa.h"
+#include "packet_trace.h"
+#include "profiler.h"
+#include "pull_connection.h"
+#include "tcp_accept.h"
+#include "thread_classes.h"
+#include "tls_session.h"
+#include "transcode_budget.h"
+#include "transcode_degrade.h"
+#include "worker_pool.h"
+
+namespace cfg
+{
+	struct Performance : public Item
+	{
+		CFG_DECLARE_REF_GETTER_OF(GetDataPool, _data_pool)
+		CFG_DECLARE_REF_GETTER_OF(GetTranscodeBudget, _transcode_budget)
+		CFG_DECLARE_REF_GETTER_OF(GetTranscodeDegrade, _transcode_degrade)
+		CFG_DECLARE_REF_GETTER_OF(GetAudioTranscodePool, _audio_transcode_pool)
+		CFG_DECLARE_REF_GETTER_OF(GetKernelTls, _kernel_tls)
+		CFG_DECLARE_REF_GETTER_OF(GetTlsSession, _tls_session)
+		CFG_DECLARE_REF_GETTER_OF(GetHttp2, _http2)
+		CFG_DECLARE_REF_GETTER_OF(GetIoUring, _io_uring)
+		CFG_DECLARE_REF_GETTER_OF(GetBackpressure, _backpressure)
+		CFG_DECLARE_REF_GETTER_OF(GetPacketTrace, _packet_trace)
+		CFG_DECLARE_REF_GETTER_OF(GetProfiler, _profiler)
+		CFG_DECLARE_REF_GETTER_OF(GetLoadShedding, _load_shedding)
+		CFG_DECLARE_REF_GETTER_OF(GetWorkerPool, _worker_pool)
+		CFG_DECLARE_REF_GETTER_OF(GetNuma, _numa)
+		CFG_DECLARE_REF_GETTER_OF(GetThreadClasses, _thread_classes)
+		CFG_DECLARE_REF_GETTER_OF(GetCapture, _capture)
+		CFG_DECLARE_REF_GETTER_OF(GetMemoryAccounting, _memory_accounting)
+		CFG_DECLARE_REF_GETTER_OF(GetTcpAccept, _tcp_accept)
+		CFG_DECLARE_REF_GETTER_OF(GetPullConnection, _pull_connection)
+		CFG_DECLARE_REF_GETTER_OF(GetHotUpgrade, _hot_upgrade)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("DataPool", &_data_pool);
+			RegisterValue<Optional>("TranscodeBudget", &_transcode_budget);
+			RegisterValue<Optional>("TranscodeDegrade", &_transcode_degrade);
+			RegisterValue<Optional>("AudioTranscodePool", &_audio_transcode_pool);
+			RegisterValue<Optional>("KernelTLS", &_kernel_tls);
+			RegisterValue<Optional>("TLSSession", &_tls_session);
+			RegisterValue<Optional>("HTTP2", &_http2);
+			RegisterValue<Optional>("IoUring", &_io_uring);
+			RegisterValue<Optional>("Backpressure", &_backpressure);
+			RegisterValue<Optional>("PacketTrace", &_packet_trace);
+			RegisterValue<Optional>("Profiler", &_profiler);
+			RegisterValue<Optional>("LoadShedding", &_load_shedding);
+			RegisterValue<Optional>("WorkerPool", &_worker_pool);
+			RegisterValue<Optional>("NUMA", &_numa);
+			RegisterValue<Optional>("ThreadClasses", &_thread_classes);
+			RegisterValue<Optional>("Capture", &_capture);
+			RegisterValue<Optional>("MemoryAccounting", &_memory_accounting);
+			RegisterValue<Optional>("TCPAccept", &_tcp_accept);
+			RegisterValue<Optional>("PullConnection", &_pull_connection);
+			RegisterValue<Optional>("HotUpgrade", &_hot_upgrade);
+		}
+
+		DataPool _data_pool;
+		TranscodeBudget _transcode_budget;
+		TranscodeDegrade _transcode_degrade;
+		AudioTranscodePool _audio_transcode_pool;
+		KernelTls _kernel_tls;
+		TlsSession _tls_session;
+		Http2 _http2;
+		IoUring _io_uring;
+		Backpressure _backpressure;
+		PacketTrace _packet_trace;
+		Profiler _profiler;
+		LoadShedding _load_shedding;
+		WorkerPool _worker_pool;
+		Numa _numa;
+		ThreadClasses _thread_classes;
+		Capture _capture;
+		MemoryAccounting _memory_accounting;
+		TcpAccept _tcp_accept;
+		PullConnection _pull_connection;
+		HotUpgrade _hot_upgrade;
+	};
+}  // namespace cfg
@@ -0,0 +1,33 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct Profiler : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetFrequency, _frequency)
+		CFG_DECLARE_GETTER_OF(GetMaxDuration, _max_duration)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("Frequency", &_frequency);
+			RegisterValue<Optional>("MaxDuration", &_max_duration);
+		}
+
+		// Serves the sampled stacks at /profile of the metrics server
+		bool _enable = false;
+		// The samples per second of the CPU time (Hz)
+		int _frequency = 99;
+		// The longest profiling that can be requested (sec)
+		int _max_duration = 60;
+	};
+}  // namespace cfg
@@ -0,0 +1,37 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct PullConnection : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetMaxConcurrency, _max_concurrency)
+		CFG_DECLARE_GETTER_OF(GetMaxWaitTime, _max_wait_time)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("MaxConcurrency", &_max_concurrency, nullptr, [this]() -> bool {
+				return (_max_concurrency > 0);
+			});
+			RegisterValue<Optional>("MaxWaitTime", &_max_wait_time, nullptr, [this]() -> bool {
+				return (_max_wait_time > 0);
+			});
+		}
+
+		// The pull streams connect to the origins through a limited number of slots (See PullConnectionLimiter)
+		bool _enable = false;
+		// The number of the pull streams that connect/handshake at once
+		int _max_concurrency = 64;
+		// How long (ms) a pull waits for a slot (and for the back-off of its origins) before it fails
+		int _max_wait_time = 30000;
+	};
+}  // namespace cfg
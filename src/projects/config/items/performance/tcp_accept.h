@@ -0,0 +1,51 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovsocket/socket_datastructure.h>
+
+namespace cfg
+{
+	// The listening TCP sockets (See ov::TcpAcceptOptions)
+	struct TcpAccept : public Item
+	{
+		CFG_DECLARE_GETTER_OF(GetBacklog, _backlog)
+		CFG_DECLARE_GETTER_OF(GetBatchSize, _batch_size)
+		CFG_DECLARE_GETTER_OF(GetDeferAccept, _defer_accept)
+		CFG_DECLARE_GETTER_OF(GetFastOpenQueue, _fast_open_queue)
+
+		ov::TcpAcceptOptions ToSocketOptions() const
+		{
+			ov::TcpAcceptOptions options;
+
+			options.backlog = _backlog;
+			options.batch_size = _batch_size;
+			options.defer_accept = _defer_accept;
+			options.fast_open_queue = _fast_open_queue;
+
+			return options;
+		}
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Backlog", &_backlog);
+			RegisterValue<Optional>("BatchSize", &_batch_size);
+			RegisterValue<Optional>("DeferAccept", &_defer_accept);
+			RegisterValue<Optional>("FastOpenQueue", &_fast_open_queue);
+		}
+
+		int _backlog = 4096;
+		int _batch_size = 64;
+		// In seconds (HTTP ports only, 0: disabled)
+		int _defer_accept = 0;
+		// 0: disabled
+		int _fast_open_queue = 0;
+	};
+}  // namespace cfg
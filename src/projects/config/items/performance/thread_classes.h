@@ -0,0 +1,69 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The scheduling policy of the threads of a class (See ov::ThreadClasses)
+	struct ThreadClass : public Item
+	{
+		CFG_DECLARE_REF_GETTER_OF(GetCpus, _cpus)
+		CFG_DECLARE_REF_GETTER_OF(GetScheduler, _scheduler)
+		CFG_DECLARE_GETTER_OF(GetPriority, _priority)
+		CFG_DECLARE_GETTER_OF(GetNice, _nice)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("CPUs", &_cpus);
+			RegisterValue<Optional>("Scheduler", &_scheduler);
+			RegisterValue<Optional>("Priority", &_priority);
+			RegisterValue<Optional>("Nice", &_nice);
+		}
+
+		// The processors in the cpulist format (such as "2-5,8"), empty means all the processors
+		ov::String _cpus;
+		//   - other: The normal time-sharing scheduler (the nice value is used)
+		//   - fifo/rr: The real-time schedulers (the priority is used)
+		ov::String _scheduler = "other";
+		// 1~99
+		int _priority = 1;
+		// -20~19
+		int _nice = 0;
+	};
+
+	struct ThreadClasses : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_REF_GETTER_OF(GetNetworkIo, _network_io)
+		CFG_DECLARE_REF_GETTER_OF(GetMedia, _media)
+		CFG_DECLARE_REF_GETTER_OF(GetEncode, _encode)
+		CFG_DECLARE_REF_GETTER_OF(GetBackground, _background)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("NetworkIO", &_network_io);
+			RegisterValue<Optional>("Media", &_media);
+			RegisterValue<Optional>("Encode", &_encode);
+			RegisterValue<Optional>("Background", &_background);
+		}
+
+		bool _enable = false;
+		// Socket workers, DTLS, RTP pacing, OVT connections, TLS handshakes
+		ThreadClass _network_io;
+		// Providers, MediaRouter, decoders/filters, publishers, WorkerPool
+		ThreadClass _media;
+		// Encoders
+		ThreadClass _encode;
+		// Logging, timers, DelayQueue
+		ThreadClass _background;
+	};
+}  // namespace cfg
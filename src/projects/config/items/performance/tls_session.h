@@ -0,0 +1,50 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct TlsSession : public Item
+	{
+		CFG_DECLARE_GETTER_OF(GetSessionCacheSize, _session_cache_size)
+		CFG_DECLARE_GETTER_OF(GetSessionTimeout, _session_timeout)
+		CFG_DECLARE_GETTER_OF(GetTicketKeyRotation, _ticket_key_rotation)
+		CFG_DECLARE_GETTER_OF(GetTicketKeyFile, _ticket_key_file)
+		CFG_DECLARE_GETTER_OF(GetHandshakeThreadCount, _handshake_thread_count)
+		CFG_DECLARE_GETTER_OF(GetMaxEarlyData, _max_early_data)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("SessionCacheSize", &_session_cache_size);
+			RegisterValue<Optional>("SessionTimeout", &_session_timeout);
+			RegisterValue<Optional>("TicketKeyRotation", &_ticket_key_rotation);
+			RegisterValue<Optional>("TicketKeyFile", &_ticket_key_file);
+			RegisterValue<Optional>("HandshakeThreadCount", &_handshake_thread_count);
+			RegisterValue<Optional>("MaxEarlyData", &_max_early_data, nullptr, [this]() -> bool {
+				return _max_early_data >= 0;
+			});
+		}
+
+		// The maximum number of the HTTPS sessions in the server-side cache
+		int _session_cache_size = 20480;
+		// The lifetime of the sessions and the tickets (seconds)
+		int _session_timeout = 3600;
+		// The interval to generate a new ticket key (seconds, the previous key is still accepted for one more interval)
+		int _ticket_key_rotation = 3600;
+		// The file of the ticket keys shared by the nodes (80 bytes per key, the first key encrypts the new tickets)
+		// The keys are not rotated by OME if it is set
+		ov::String _ticket_key_file;
+		// The number of threads for the full handshakes (0: the handshakes are done by the socket workers)
+		int _handshake_thread_count = 0;
+		// The maximum bytes of the requests that the resumed clients send with the ClientHello of TLS 1.3 (0-RTT, 0: disabled)
+		// Only GET/HEAD are processed from the early data, the others are answered with 425 Too Early
+		int _max_early_data = 0;
+	};
+}  // namespace cfg
@@ -0,0 +1,41 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The encoding capacity of the server, shared by all transcode streams
+	struct TranscodeBudget : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetCPUMegaPixelsPerSecond, _cpu_mega_pixels_per_second)
+		CFG_DECLARE_GETTER_OF(GetGPUMegaPixelsPerSecond, _gpu_mega_pixels_per_second)
+		CFG_DECLARE_GETTER_OF(GetPolicy, _policy)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("CPUMegaPixelsPerSecond", &_cpu_mega_pixels_per_second);
+			RegisterValue<Optional>("GPUMegaPixelsPerSecond", &_gpu_mega_pixels_per_second);
+			RegisterValue<Optional>("Policy", &_policy);
+		}
+
+		bool _enable = false;
+		// The sum of width * height * framerate of the software/hardware encoders (0 = unlimited)
+		// (1080p60 is about 124 megapixels per second)
+		float _cpu_mega_pixels_per_second = 0.0f;
+		float _gpu_mega_pixels_per_second = 0.0f;
+		// What to do with a stream that exceeds the budget
+		//   - downgrade: Start the renditions that fit in the budget (bypass only if none fits)
+		//   - queue: Wait until the other streams release the budget
+		//   - reject: Do not start the stream
+		ov::String _policy = "downgrade";
+	};
+}  // namespace cfg
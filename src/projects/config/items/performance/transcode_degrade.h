@@ -0,0 +1,38 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// How a transcode stream degrades itself when it cannot keep up (See TranscodeDegradeLadder)
+	struct TranscodeDegrade : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetHighWatermark, _high_watermark)
+		CFG_DECLARE_GETTER_OF(GetLowWatermark, _low_watermark)
+		CFG_DECLARE_GETTER_OF(GetRecoveryTime, _recovery_time)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("HighWatermark", &_high_watermark);
+			RegisterValue<Optional>("LowWatermark", &_low_watermark);
+			RegisterValue<Optional>("RecoveryTime", &_recovery_time);
+		}
+
+		bool _enable = true;
+		// The depth of the fullest queue of the stages relative to its limit (%) that degrades the stream one more step
+		int _high_watermark = 50;
+		// The depth that restores the stream one step (%)
+		int _low_watermark = 10;
+		// How long the queues must stay under the low watermark before a step is restored (milliseconds)
+		int _recovery_time = 3000;
+	};
+}  // namespace cfg
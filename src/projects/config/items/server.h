@@ -10,6 +10,7 @@
 
 #include "bind/bind.h"
 #include "p2p/p2p.h"
+#include "performance/performance.h"
 #include "virtual_hosts/virtual_hosts.h"
 namespace cfg
 {
@@ -34,6 +35,8 @@ namespace cfg
 
 		CFG_DECLARE_REF_GETTER_OF(GetP2P, _p2p)
 
+		CFG_DECLARE_REF_GETTER_OF(GetPerformance, _performance)
+
 		CFG_DECLARE_REF_GETTER_OF(GetVirtualHostList, _virtual_hosts.GetVirtualHostList())
 
 		// Deprecated - It has a bug
@@ -79,6 +82,8 @@ namespace cfg
 
 			RegisterValue<Optional>("P2P", &_p2p);
 
+			RegisterValue<Optional>("Performance", &_performance);
+
 			RegisterValue<Optional>("VirtualHosts", &_virtual_hosts);
 		}
 
@@ -94,6 +99,8 @@ namespace cfg
 
 		P2P _p2p;
 
+		Performance _performance;
+
 		VirtualHosts _virtual_hosts;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -8,8 +8,10 @@
 //==============================================================================
 #pragma once
 
+#include "../scheduling.h"
 #include "decode/decode.h"
 #include "encodes/encodes.h"
+#include "media_router.h"
 #include "origin.h"
 #include "providers/providers.h"
 #include "publishers/publishers.h"
@@ -32,6 +34,8 @@ namespace cfg
 
 		CFG_DECLARE_REF_GETTER_OF(GetOrigin, _origin)
 		CFG_DECLARE_REF_GETTER_OF(GetDecode, _decode)
+		CFG_DECLARE_REF_GETTER_OF(GetMediaRouter, _media_router)
+		CFG_DECLARE_REF_GETTER_OF(GetScheduling, _scheduling)
 		CFG_DECLARE_REF_GETTER_OF(GetEncodeList, _encodes.GetEncodeList())
 		CFG_DECLARE_REF_GETTER_OF(GetStreamList, _streams.GetStreamList())
 		CFG_DECLARE_REF_GETTER_OF(GetProviders, _providers)
@@ -91,6 +95,8 @@ namespace cfg
 
 			RegisterValue<Optional>("Origin", &_origin);
 			RegisterValue<Optional>("Decode", &_decode);
+			RegisterValue<Optional>("MediaRouter", &_media_router);
+			RegisterValue<Optional>("Scheduling", &_scheduling);
 			RegisterValue<Optional>("Encodes", &_encodes);
 			RegisterValue<Optional>("Streams", &_streams);
 			RegisterValue<Optional>("Providers", &_providers);
@@ -103,6 +109,8 @@ namespace cfg
 
 		Origin _origin;
 		Decode _decode;
+		MediaRouter _media_router;
+		Scheduling _scheduling;
 		Encodes _encodes;
 		Streams _streams;
 		Providers _providers;
@@ -14,10 +14,12 @@ namespace cfg
 {
 	struct Decode : public Item
 	{
+		CFG_DECLARE_REF_GETTER_OF(GetVideo, _video)
+
 	protected:
 		void MakeParseList() override
 		{
-			RegisterValue("Video", &_video);
+			RegisterValue<Optional>("Video", &_video);
 		}
 
 		DecodeVideo _video;
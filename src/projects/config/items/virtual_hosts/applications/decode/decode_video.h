@@ -12,12 +12,28 @@ namespace cfg
 {
 	struct DecodeVideo : public Item
 	{
+		CFG_DECLARE_GETTER_OF(GetHWAcceleration, _hw_acceleration)
+		CFG_DECLARE_GETTER_OF(GetMode, _mode)
+		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count)
+
 	protected:
 		void MakeParseList() override
 		{
-			RegisterValue("HWAcceleration", &_hw_acceleration);
+			RegisterValue<Optional>("HWAcceleration", &_hw_acceleration);
+			RegisterValue<Optional>("Mode", &_mode, nullptr, [this]() -> bool {
+				auto mode = _mode.LowerCaseString();
+
+				return (mode == "auto") || (mode == "lowdelay") || (mode == "throughput");
+			});
+			RegisterValue<Optional>("ThreadCount", &_thread_count);
 		}
 
-		ov::String _hw_acceleration;
+		ov::String _hw_acceleration = "none";
+		// auto: the options of FFmpeg
+		// lowdelay: slice threads, no reordering delay (for WebRTC)
+		// throughput: frame threads (for HLS/DASH)
+		ov::String _mode = "auto";
+		// 0 = decided by the mode
+		int _thread_count = 0;
 	};
 }  // namespace cfg
\ No newline at end of file
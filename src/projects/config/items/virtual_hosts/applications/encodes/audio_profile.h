@@ -18,6 +18,8 @@ namespace cfg
 		CFG_DECLARE_GETTER_OF(GetBitrate, _bitrate)
 		CFG_DECLARE_GETTER_OF(GetSamplerate, _samplerate)
 		CFG_DECLARE_GETTER_OF(GetChannel, _channel)
+		CFG_DECLARE_GETTER_OF(IsInbandFec, _inband_fec)
+		CFG_DECLARE_GETTER_OF(IsDtx, _dtx)
 
 	protected:
 		void MakeParseList() override
@@ -40,6 +42,9 @@ namespace cfg
 				// <Channel> is an option when _bypass is true
 				return _bypass;
 			});
+			// Only OPUS supports them
+			RegisterValue<Optional>("InbandFEC", &_inband_fec);
+			RegisterValue<Optional>("DTX", &_dtx);
 		}
 
 		bool _bypass = false;
@@ -48,5 +53,7 @@ namespace cfg
 		ov::String _bitrate;
 		int _samplerate = 0;
 		int _channel = 0;
+		bool _inband_fec = true;
+		bool _dtx = false;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace cfg
 	struct VideoProfile : public Item
 	{
 		CFG_DECLARE_GETTER_OF(IsBypass, _bypass)
+		CFG_DECLARE_GETTER_OF(IsAutoBypass, _auto_bypass)
 		CFG_DECLARE_GETTER_OF(IsActive, _active)
 		CFG_DECLARE_GETTER_OF(GetHWAcceleration, _hw_acceleration)
 		CFG_DECLARE_GETTER_OF(GetCodec, _codec)
@@ -21,11 +22,21 @@ namespace cfg
 		CFG_DECLARE_GETTER_OF(GetHeight, _height)
 		CFG_DECLARE_GETTER_OF(GetBitrate, _bitrate)
 		CFG_DECLARE_GETTER_OF(GetFramerate, _framerate)
+		CFG_DECLARE_GETTER_OF(GetKeyFrameInterval, _key_frame_interval)
+		CFG_DECLARE_GETTER_OF(GetPreset, _preset)
+		CFG_DECLARE_GETTER_OF(GetTune, _tune)
+		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count)
+		CFG_DECLARE_GETTER_OF(IsSliceThreads, _slice_threads)
+		CFG_DECLARE_GETTER_OF(GetLookahead, _lookahead)
+		CFG_DECLARE_GETTER_OF(GetRateControl, _rate_control)
+		CFG_DECLARE_GETTER_OF(GetScaleQuality, _scale_quality)
+		CFG_DECLARE_GETTER_OF(GetTemporalLayers, _temporal_layers)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue<Optional>("Bypass", &_bypass);
+			RegisterValue<Optional>("AutoBypass", &_auto_bypass);
 
 			RegisterValue<Optional>("Active", &_active);
 			RegisterValue<Optional>("HWAcceleration", &_hw_acceleration);
@@ -50,9 +61,29 @@ namespace cfg
 				// <Framerate> is an option when _bypass is true
 				return _bypass;
 			});
+
+			// Encoder options (ignored when _bypass is true)
+			RegisterValue<Optional>("KeyFrameInterval", &_key_frame_interval);
+			RegisterValue<Optional>("Preset", &_preset);
+			RegisterValue<Optional>("Tune", &_tune);
+			RegisterValue<Optional>("ThreadCount", &_thread_count);
+			RegisterValue<Optional>("SliceThreads", &_slice_threads);
+			RegisterValue<Optional>("Lookahead", &_lookahead);
+			RegisterValue<Optional>("RateControl", &_rate_control);
+			RegisterValue<Optional>("ScaleQuality", &_scale_quality, nullptr, [this]() -> bool {
+				auto scale_quality = _scale_quality.LowerCaseString();
+
+				return (scale_quality == "quality") || (scale_quality == "balanced") || (scale_quality == "speed");
+			});
+			RegisterValue<Optional>("TemporalLayers", &_temporal_layers, nullptr, [this]() -> bool {
+				return (_temporal_layers >= 1) && (_temporal_layers <= 3);
+			});
 		}
 
 		bool _bypass = false;
+		// The input is bypassed instead of being encoded if the browsers can play it over WebRTC as it is
+		// (H.264 Baseline, which has no B-frames), and encoded with the options below otherwise
+		bool _auto_bypass = false;
 		bool _active = true;
 		ov::String _hw_acceleration = "none";
 		ov::String _codec;
@@ -61,5 +92,27 @@ namespace cfg
 		int _height = 0;
 		ov::String _bitrate;
 		float _framerate = 0.0f;
+
+		// The number of frames between keyframes (0 = one keyframe per second)
+		// A keyframe is also forced at each segment boundary if HLS/DASH is enabled
+		int _key_frame_interval = 0;
+		// x264 preset/tune (ultrafast, superfast, veryfast, faster, fast, medium, ...)
+		ov::String _preset = "ultrafast";
+		ov::String _tune = "zerolatency";
+		// 0 = divide the cores of the system by the number of the video encoders
+		int _thread_count = 0;
+		// Slice-based threading has lower latency than frame-based threading, but some decoders of Safari can't decode it
+		bool _slice_threads = false;
+		// The number of frames of the rate control lookahead (each frame adds one frame of latency)
+		//   -1 = use the value of the preset/tune (0 with zerolatency)
+		int _lookahead = -1;
+		// cbr or vbr
+		ov::String _rate_control = "cbr";
+		// The trade-off of the software scaler
+		//   quality = bicubic, balanced = bilinear, speed = fast bilinear (the SIMD fast path of swscale)
+		ov::String _scale_quality = "quality";
+		// The number of the temporal layers of VP8 (1~3)
+		// The WebRTC sessions drop the upper layers (lower framerate) while they are congested, instead of switching the rendition
+		int _temporal_layers = 1;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -0,0 +1,41 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	struct MediaRouter : public Item
+	{
+		// The number of threads that deliver the packets to the transcoder/publishers
+		// (The streams are distributed to the threads by the stream id)
+		CFG_DECLARE_GETTER_OF(GetWorkerCount, _worker_count > 0 ? _worker_count : 1)
+		// How long (ms) the transcoder/publishers keep the stream after its ingest is gone (0: deleted at once),
+		// the stream is resumed if the provider creates a stream of the same name within it
+		CFG_DECLARE_GETTER_OF(GetReconnectGracePeriod, _reconnect_grace_period)
+		// The maximum delay (ms) of the jitter buffer of the incoming streams (0: disabled),
+		// the packets of the bursty ingest are held and released in the pace of the DTS
+		CFG_DECLARE_GETTER_OF(GetJitterBuffer, _jitter_buffer)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("WorkerCount", &_worker_count);
+			RegisterValue<Optional>("ReconnectGracePeriod", &_reconnect_grace_period, nullptr, [this]() -> bool {
+				return (_reconnect_grace_period >= 0);
+			});
+			RegisterValue<Optional>("JitterBuffer", &_jitter_buffer, nullptr, [this]() -> bool {
+				return (_jitter_buffer >= 0);
+			});
+		}
+
+		int _worker_count = 1;
+		int _reconnect_grace_period = 0;
+		int _jitter_buffer = 0;
+	};
+}  // namespace cfg
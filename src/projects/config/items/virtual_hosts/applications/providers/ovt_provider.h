@@ -15,5 +15,38 @@ namespace cfg
 	struct OvtProvider : public Provider
 	{
 		CFG_DECLARE_OVERRIDED_GETTER_OF(ProviderType, GetType, ProviderType::Ovt)
+		CFG_DECLARE_GETTER_OF(IsDatagramEnabled, _datagram)
+		CFG_DECLARE_GETTER_OF(GetRetransmitDeadline, _retransmit_deadline)
+		CFG_DECLARE_GETTER_OF(GetMultiplexConnections, _multiplex_connections)
+		CFG_DECLARE_GETTER_OF(IsSharedMemoryEnabled, _shared_memory)
+
+	protected:
+		void MakeParseList() override
+		{
+			Provider::MakeParseList();
+
+			// Requests the origin to send the media packets over UDP (<Bind><Publishers><OVT><DatagramPort> of the origin),
+			// the lost packets are retransmitted, so a lost packet doesn't stall the other tracks.
+			// If the origin doesn't support it, the packets are received over the connection.
+			RegisterValue<Optional>("Datagram", &_datagram);
+			// How long (in milliseconds) a lost packet is waited for, the frame that has the lost packet is dropped after this
+			// (it must be shorter than the history of the origin, 1000ms)
+			RegisterValue<Optional>("RetransmitDeadline", &_retransmit_deadline, nullptr, [this]() -> bool {
+				return (_retransmit_deadline > 0) && (_retransmit_deadline <= 1000);
+			});
+			// The streams pulled from the same origin share up to this number of connections (0: a connection per stream)
+			RegisterValue<Optional>("MultiplexConnections", &_multiplex_connections, nullptr, [this]() -> bool {
+				return _multiplex_connections >= 0;
+			});
+			// Requests the origin on the same host to share the frames through the shared memory (<Bind><Publishers><OVT><SharedMemoryPath> of the origin),
+			// the frames are not packetized and not sent over the connection.
+			// If the origin doesn't support it, the packets are received over the connection (or UDP if <Datagram> is enabled).
+			RegisterValue<Optional>("SharedMemory", &_shared_memory);
+		}
+
+		bool _datagram = false;
+		int _retransmit_deadline = 300;
+		int _multiplex_connections = 0;
+		bool _shared_memory = false;
 	};
-}
\ No newline at end of file
+}  // namespace cfg
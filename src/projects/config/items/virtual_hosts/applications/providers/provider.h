@@ -14,13 +14,17 @@ namespace cfg
 	{
 		virtual ProviderType GetType() const = 0;
 		CFG_DECLARE_GETTER_OF(GetMaxConnection, _max_connection)
+		CFG_DECLARE_GETTER_OF(GetStreamMotorCount, _stream_motor_count)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue<Optional>("MaxConnection", &_max_connection);
+			RegisterValue<Optional>("StreamMotorCount", &_stream_motor_count);
 		}
 
 		int _max_connection = 0;
+		// The number of threads that receive the streams of a pull provider (0: default)
+		int _stream_motor_count = 0;
 	};
 }  // namespace cfg
\ No newline at end of file
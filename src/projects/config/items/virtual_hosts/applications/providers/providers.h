@@ -9,9 +9,12 @@
 #pragma once
 
 #include "ovt_provider.h"
+#include "replay_provider.h"
 #include "rtmp_provider.h"
 #include "rtsp_provider.h"
 #include "rtsp_pull_provider.h"
+#include "srt_provider.h"
+#include "webrtc_provider.h"
 
 namespace cfg
 {
@@ -23,13 +26,19 @@ namespace cfg
 				&_rtmp_provider,
 				&_rtsp_pull_provider,
 				&_rtsp_provider,
-				&_ovt_provider};
+				&_ovt_provider,
+				&_webrtc_provider,
+				&_srt_provider,
+				&_replay_provider};
 		}
 
 		CFG_DECLARE_REF_GETTER_OF(GetRtmpProvider, _rtmp_provider)
 		CFG_DECLARE_REF_GETTER_OF(GetRtspPullProvider, _rtsp_pull_provider)
 		CFG_DECLARE_REF_GETTER_OF(GetRtspProvider, _rtsp_provider)
 		CFG_DECLARE_REF_GETTER_OF(GetOvtProvider, _ovt_provider)
+		CFG_DECLARE_REF_GETTER_OF(GetWebrtcProvider, _webrtc_provider)
+		CFG_DECLARE_REF_GETTER_OF(GetSrtProvider, _srt_provider)
+		CFG_DECLARE_REF_GETTER_OF(GetReplayProvider, _replay_provider)
 
 	protected:
 		void MakeParseList() override
@@ -38,11 +47,17 @@ namespace cfg
 			RegisterValue<Optional>("RTSPPull", &_rtsp_pull_provider);
 			RegisterValue<Optional>("RTSP", &_rtsp_provider);
 			RegisterValue<Optional>("OVT", &_ovt_provider);
+			RegisterValue<Optional>("WebRTC", &_webrtc_provider);
+			RegisterValue<Optional>("SRT", &_srt_provider);
+			RegisterValue<Optional>("Replay", &_replay_provider);
 		};
 
 		RtmpProvider _rtmp_provider;
 		RtspPullProvider _rtsp_pull_provider;
 		RtspProvider _rtsp_provider;
 		OvtProvider _ovt_provider;
+		WebrtcProvider _webrtc_provider;
+		SrtProvider _srt_provider;
+		ReplayProvider _replay_provider;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -0,0 +1,20 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "provider.h"
+
+namespace cfg
+{
+	// Pulls the streams from the capture files (replay://<any host>/<file name>, See <Server><Performance><Capture>)
+	struct ReplayProvider : public Provider
+	{
+		CFG_DECLARE_OVERRIDED_GETTER_OF(ProviderType, GetType, ProviderType::Replay)
+	};
+}  // namespace cfg
@@ -17,6 +17,9 @@ namespace cfg
 		CFG_DECLARE_OVERRIDED_GETTER_OF(ProviderType, GetType, ProviderType::RtspPull)
 
 		CFG_DECLARE_GETTER_OF(IsBlockDuplicateStreamName, _is_block_duplicate_stream_name)
+		CFG_DECLARE_REF_GETTER_OF(GetTransport, _transport)
+		CFG_DECLARE_GETTER_OF(GetReorderQueueSize, _reorder_queue_size)
+		CFG_DECLARE_GETTER_OF(GetMaxDelay, _max_delay)
 
 	protected:
 		void MakeParseList() override
@@ -24,10 +27,21 @@ namespace cfg
 			Provider::MakeParseList();
 
 			RegisterValue<Optional>("BlockDuplicateStreamName", &_is_block_duplicate_stream_name);
+			RegisterValue<Optional>("Transport", &_transport);
+			RegisterValue<Optional>("ReorderQueueSize", &_reorder_queue_size);
+			RegisterValue<Optional>("MaxDelay", &_max_delay);
 		}
 
 		// true: block(disconnect) new incoming stream
 		// false: don't block new incoming stream
 		bool _is_block_duplicate_stream_name = true;
+
+		// tcp: RTP is interleaved in the RTSP connection
+		// udp: RTP/RTCP is received with UDP, it falls back to tcp if the server refuses it
+		ov::String _transport = "tcp";
+		// The number of RTP packets that are buffered to reorder the UDP packets
+		int _reorder_queue_size = 500;
+		// The maximum time to wait for a missing UDP packet (milliseconds)
+		int _max_delay = 500;
 	};
 }  // namespace cfg
\ No newline at end of file
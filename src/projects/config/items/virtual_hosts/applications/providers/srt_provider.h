@@ -0,0 +1,18 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "provider.h"
+
+namespace cfg
+{
+	struct SrtProvider : public Provider
+	{
+		CFG_DECLARE_OVERRIDED_GETTER_OF(ProviderType, GetType, ProviderType::Srt)
+	};
+}  // namespace cfg
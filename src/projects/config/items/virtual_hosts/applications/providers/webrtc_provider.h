@@ -0,0 +1,18 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "provider.h"
+
+namespace cfg
+{
+	struct WebrtcProvider : public Provider
+	{
+		CFG_DECLARE_OVERRIDED_GETTER_OF(ProviderType, GetType, ProviderType::Webrtc)
+	};
+}  // namespace cfg
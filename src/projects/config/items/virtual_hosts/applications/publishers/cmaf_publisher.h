@@ -9,6 +9,7 @@
 #pragma once
 
 #include "publisher.h"
+#include "thumbnail.h"
 
 namespace cfg
 {
@@ -18,8 +19,10 @@ namespace cfg
 
 		CFG_DECLARE_GETTER_OF(GetSegmentCount, _segment_count)
 		CFG_DECLARE_GETTER_OF(GetSegmentDuration, _segment_duration)
+		CFG_DECLARE_GETTER_OF(GetSegmentStoragePath, _segment_storage_path)
 		CFG_DECLARE_GETTER_OF(GetCrossDomains, _cross_domain.GetUrls())
 		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count > 0 ? _thread_count : 1)
+		CFG_DECLARE_REF_GETTER_OF(GetThumbnail, _thumbnail)
 
 	protected:
 		void MakeParseList() override
@@ -28,13 +31,18 @@ namespace cfg
 
 			RegisterValue<Optional>("SegmentCount", &_segment_count);
 			RegisterValue<Optional>("SegmentDuration", &_segment_duration);
+			RegisterValue<Optional>("SegmentStoragePath", &_segment_storage_path);
 			RegisterValue<Optional>("CrossDomain", &_cross_domain);
 			RegisterValue<Optional>("ThreadCount", &_thread_count);
+			RegisterValue<Optional>("Thumbnail", &_thumbnail);
 		}
 
 		int _segment_count = 3;
 		int _segment_duration = 5;
+		// The closed segments are kept in the files of this directory instead of the memory (empty: memory)
+		ov::String _segment_storage_path;
 		CrossDomain _cross_domain;
 		int _thread_count = 4;
+		Thumbnail _thumbnail;
 	};
 }  // namespace cfg
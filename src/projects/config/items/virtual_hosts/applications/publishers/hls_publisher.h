@@ -8,7 +8,10 @@
 //==============================================================================
 #pragma once
 
+#include "on_demand.h"
 #include "publisher.h"
+#include "segment_encryption.h"
+#include "thumbnail.h"
 
 namespace cfg
 {
@@ -18,8 +21,12 @@ namespace cfg
 
 		CFG_DECLARE_GETTER_OF(GetSegmentCount, _segment_count)
 		CFG_DECLARE_GETTER_OF(GetSegmentDuration, _segment_duration)
+		CFG_DECLARE_GETTER_OF(GetSegmentStoragePath, _segment_storage_path)
 		CFG_DECLARE_GETTER_OF(GetCrossDomains, _cross_domain.GetUrls())
 		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count > 0 ? _thread_count : 1)
+		CFG_DECLARE_REF_GETTER_OF(GetThumbnail, _thumbnail)
+		CFG_DECLARE_REF_GETTER_OF(GetOnDemand, _on_demand)
+		CFG_DECLARE_REF_GETTER_OF(GetEncryption, _encryption)
 
 	protected:
 		void MakeParseList() override
@@ -28,14 +35,23 @@ namespace cfg
 
 			RegisterValue<Optional>("SegmentCount", &_segment_count);
 			RegisterValue<Optional>("SegmentDuration", &_segment_duration);
+			RegisterValue<Optional>("SegmentStoragePath", &_segment_storage_path);
 			RegisterValue<Optional>("CrossDomain", &_cross_domain);
 			RegisterValue<Optional>("ThreadCount", &_thread_count);
+			RegisterValue<Optional>("Thumbnail", &_thumbnail);
+			RegisterValue<Optional>("OnDemand", &_on_demand);
+			RegisterValue<Optional>("Encryption", &_encryption);
 		}
 
 		int _segment_count = 3;
 		int _segment_duration = 4;
+		// The closed segments are kept in the files of this directory instead of the memory (empty: memory)
+		ov::String _segment_storage_path;
 		CrossDomain _cross_domain;
 		int _thread_count = 4;
+		Thumbnail _thumbnail;
+		OnDemand _on_demand;
+		SegmentEncryption _encryption;
 		int _send_buffer_size = 1024 * 1024 * 20;  // 20M
 		int _recv_buffer_size = 0;
 	};
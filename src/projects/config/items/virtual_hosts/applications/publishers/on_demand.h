@@ -0,0 +1,31 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The segments of a stream are packaged only while the players request them (for the HLS/DASH publishers)
+	struct OnDemand : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetIdleTimeout, _idle_timeout)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("IdleTimeout", &_idle_timeout, nullptr, [this]() -> bool {
+				return _idle_timeout > 0;
+			});
+		}
+
+		bool _enable = false;
+		// The packaging is stopped if there is no request of the playlists/segments for this time (in seconds)
+		int _idle_timeout = 60;
+	};
+}  // namespace cfg
@@ -15,5 +15,29 @@ namespace cfg
 	struct OvtPublisher : public Publisher
 	{
 		CFG_DECLARE_OVERRIDED_GETTER_OF(PublisherType, GetType, PublisherType::Ovt)
+		CFG_DECLARE_GETTER_OF(GetMaxPacketSize, _max_packet_size)
+		CFG_DECLARE_GETTER_OF(GetLateFrameDeadline, _late_frame_deadline)
+
+	protected:
+		void MakeParseList() override
+		{
+			Publisher::MakeParseList();
+
+			// The size of the OVT packets including the header (up to 65553).
+			// The larger packets reduce the number of packets per frame, but the edges must be able to receive them,
+			// and it must not be larger than 1316 if the OVT port is SRT.
+			RegisterValue<Optional>("MaxPacketSize", &_max_packet_size, nullptr, [this]() -> bool {
+				return (_max_packet_size > 0) && (_max_packet_size <= 65553);
+			});
+			// When the connection to an edge is congested, the frames are sent in the order of audio > video key frame > video delta frame,
+			// and the delta frames that have waited longer than this (in milliseconds) are skipped until the next key frame.
+			// 0 sends the frames in the order they are produced.
+			RegisterValue<Optional>("LateFrameDeadline", &_late_frame_deadline, nullptr, [this]() -> bool {
+				return _late_frame_deadline >= 0;
+			});
+		}
+
+		int _max_packet_size = 1316;
+		int _late_frame_deadline = 2000;
 	};
 }  // namespace cfg
\ No newline at end of file
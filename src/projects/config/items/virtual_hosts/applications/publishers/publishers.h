@@ -14,6 +14,7 @@
 #include "rtmp_publisher.h"
 #include "webrtc_publisher.h"
 #include "ovt_publisher.h"
+#include "record_publisher.h"
 
 namespace cfg
 {
@@ -27,7 +28,8 @@ namespace cfg
 				&_dash_publisher,
 				&_ll_dash_publisher,
 				&_webrtc_publisher,
-				&_ovt_publisher};
+				&_ovt_publisher,
+				&_record_publisher};
 		}
 
 		CFG_DECLARE_GETTER_OF(GetThreadCount, _thread_count)
@@ -37,6 +39,7 @@ namespace cfg
 		CFG_DECLARE_REF_GETTER_OF(GetLlDashPublisher, _ll_dash_publisher)
 		CFG_DECLARE_REF_GETTER_OF(GetWebrtcPublisher, _webrtc_publisher)
 		CFG_DECLARE_REF_GETTER_OF(GetOvtPublisher, _ovt_publisher)
+		CFG_DECLARE_REF_GETTER_OF(GetRecordPublisher, _record_publisher)
 
 	protected:
 		void MakeParseList() override
@@ -49,6 +52,7 @@ namespace cfg
 			RegisterValue<Optional>("LLDASH", &_ll_dash_publisher);
 			RegisterValue<Optional>("WebRTC", &_webrtc_publisher);
 			RegisterValue<Optional>("OVT", &_ovt_publisher);
+			RegisterValue<Optional>("Record", &_record_publisher);
 		}
 
 		int _thread_count = 4;
@@ -59,5 +63,6 @@ namespace cfg
 		LlDashPublisher _ll_dash_publisher;
 		WebrtcPublisher _webrtc_publisher;
 		OvtPublisher _ovt_publisher;
+		RecordPublisher _record_publisher;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -0,0 +1,49 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "publisher.h"
+
+namespace cfg
+{
+	struct RecordPublisher : public Publisher
+	{
+		CFG_DECLARE_OVERRIDED_GETTER_OF(PublisherType, GetType, PublisherType::Record)
+		CFG_DECLARE_GETTER_OF(GetFilePath, _file_path)
+		CFG_DECLARE_GETTER_OF(GetFileDuration, _file_duration)
+		CFG_DECLARE_GETTER_OF(GetFragmentDuration, _fragment_duration)
+		CFG_DECLARE_GETTER_OF(GetMaxPendingBytes, _max_pending_bytes)
+
+	protected:
+		void MakeParseList() override
+		{
+			Publisher::MakeParseList();
+
+			// The files are written in <FilePath>/<app>/<stream>/
+			RegisterValue("FilePath", &_file_path);
+			// A new file is started at the first key frame after this (in seconds)
+			RegisterValue<Optional>("FileDuration", &_file_duration, nullptr, [this]() -> bool {
+				return _file_duration > 0;
+			});
+			// The frames are written to the file every this (in milliseconds)
+			RegisterValue<Optional>("FragmentDuration", &_fragment_duration, nullptr, [this]() -> bool {
+				return _fragment_duration > 0;
+			});
+			// The fragments that are not written yet are dropped over this (the disk is slower than the streams)
+			RegisterValue<Optional>("MaxPendingBytes", &_max_pending_bytes, nullptr, [this]() -> bool {
+				return _max_pending_bytes > 0;
+			});
+		}
+
+		ov::String _file_path;
+		int _file_duration = 600;
+		int _fragment_duration = 2000;
+		int _max_pending_bytes = 64 * 1024 * 1024;
+	};
+}  // namespace cfg
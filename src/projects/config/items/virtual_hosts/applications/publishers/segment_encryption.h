@@ -0,0 +1,31 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The segments are encrypted with AES-128 once when they are closed, and the keys are served as <app>/<stream>/<prefix>_<index>.key
+	struct SegmentEncryption : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetKeyRotation, _key_rotation)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("KeyRotation", &_key_rotation, nullptr, [this]() -> bool {
+				return _key_rotation >= 0;
+			});
+		}
+
+		bool _enable = false;
+		// The key is changed every this number of segments (0: the key is not changed while the stream is alive)
+		int _key_rotation = 10;
+	};
+}  // namespace cfg
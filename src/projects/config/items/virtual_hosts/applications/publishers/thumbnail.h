@@ -0,0 +1,51 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The thumbnail of the stream served as <app>/<stream>/thumb.<jpg|webp> by the segment publishers
+	struct Thumbnail : public Item
+	{
+		CFG_DECLARE_GETTER_OF(IsEnabled, _enable)
+		CFG_DECLARE_GETTER_OF(GetInterval, _interval)
+		CFG_DECLARE_GETTER_OF(GetWidth, _width)
+		CFG_DECLARE_GETTER_OF(GetFormat, _format)
+		CFG_DECLARE_GETTER_OF(GetQuality, _quality)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Enable", &_enable);
+			RegisterValue<Optional>("Interval", &_interval, nullptr, [this]() -> bool {
+				return _interval > 0;
+			});
+			RegisterValue<Optional>("Width", &_width, nullptr, [this]() -> bool {
+				return _width >= 0;
+			});
+			RegisterValue<Optional>("Format", &_format, nullptr, [this]() -> bool {
+				auto format = _format.LowerCaseString();
+
+				return (format == "jpeg") || (format == "webp");
+			});
+			RegisterValue<Optional>("Quality", &_quality, nullptr, [this]() -> bool {
+				return (_quality >= 1) && (_quality <= 100);
+			});
+		}
+
+		bool _enable = false;
+		// The key frame after this interval (in milliseconds) is captured
+		int _interval = 5000;
+		// The height keeps the aspect ratio (0: the width of the stream)
+		int _width = 320;
+		// jpeg or webp
+		ov::String _format = "jpeg";
+		// 1 ~ 100
+		int _quality = 75;
+	};
+}  // namespace cfg
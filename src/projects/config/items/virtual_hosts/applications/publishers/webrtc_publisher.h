@@ -15,6 +15,17 @@ namespace cfg
 	struct WebrtcPublisher : public Publisher
 	{
 		CFG_DECLARE_OVERRIDED_GETTER_OF(PublisherType, GetType, PublisherType::Webrtc)
+		CFG_DECLARE_GETTER_OF(GetEgressBatchSize, _egress_batch_size)
+		CFG_DECLARE_GETTER_OF(IsRunToCompletionEnabled, _run_to_completion)
+		CFG_DECLARE_GETTER_OF(GetKeyFrameRequestInterval, _key_frame_request_interval)
+		CFG_DECLARE_GETTER_OF(IsRenditionSwitchingEnabled, _rendition_switching)
+		CFG_DECLARE_GETTER_OF(IsPacingEnabled, _pacing)
+		CFG_DECLARE_GETTER_OF(IsSFrameEnabled, _sframe)
+		CFG_DECLARE_GETTER_OF(IsAdaptiveFecEnabled, _adaptive_fec)
+		CFG_DECLARE_GETTER_OF(GetDtlsWorkerCount, _dtls_worker_count)
+		CFG_DECLARE_GETTER_OF(GetSlowConsumerQueueDelay, _slow_consumer_queue_delay)
+		CFG_DECLARE_GETTER_OF(GetSlowConsumerLoss, _slow_consumer_loss)
+		CFG_DECLARE_GETTER_OF(GetSlowConsumerTimeout, _slow_consumer_timeout)
 
 	protected:
 		void MakeParseList() override
@@ -22,8 +33,41 @@ namespace cfg
 			Publisher::MakeParseList();
 
 			RegisterValue<Optional>("Timeout", &_timeout);
+			// The number of RTP packets that are sent to all sessions at once using sendmmsg() (0: disable)
+			RegisterValue<Optional>("EgressBatchSize", &_egress_batch_size);
+			// The stream workers are pinned to the processors, and read the packets from a ring shared by the workers of a stream
+			RegisterValue<Optional>("RunToCompletion", &_run_to_completion);
+			// The PLI/FIR of all sessions of a stream are forwarded to the upstream at most once in this interval (ms)
+			RegisterValue<Optional>("KeyFrameRequestInterval", &_key_frame_request_interval);
+			// A session switches to the other renditions of the same input stream by the estimated bandwidth
+			RegisterValue<Optional>("RenditionSwitching", &_rendition_switching);
+			// The video packets of each session are paced by the target bitrate, to avoid the bursts of key frames
+			RegisterValue<Optional>("Pacing", &_pacing);
+			// The frames are encrypted once per stream with SFrame, and the key is delivered with the offer
+			RegisterValue<Optional>("SFrame", &_sframe);
+			// The protection rate of ULPFEC follows the loss of the sessions receiving RED (otherwise 1 FEC packet per 10 media packets)
+			RegisterValue<Optional>("AdaptiveFEC", &_adaptive_fec);
+			// The DTLS handshakes are processed by these threads instead of the application thread (0: disable)
+			RegisterValue<Optional>("DtlsWorkerCount", &_dtls_worker_count);
+			// A session falls behind if the packets wait longer than this in its pacer (ms)
+			RegisterValue<Optional>("SlowConsumerQueueDelay", &_slow_consumer_queue_delay);
+			// A session falls behind if the reported loss or the dropped datagrams exceed this (%)
+			RegisterValue<Optional>("SlowConsumerLoss", &_slow_consumer_loss);
+			// A session that falls behind is moved to the lower renditions, and disconnected if it cannot catch up in this time (sec, 0: disable)
+			RegisterValue<Optional>("SlowConsumerTimeout", &_slow_consumer_timeout);
 		}
 
 		int _timeout = 0;
+		int _egress_batch_size = 64;
+		bool _run_to_completion = false;
+		int _key_frame_request_interval = 1000;
+		bool _rendition_switching = false;
+		bool _pacing = true;
+		bool _sframe = false;
+		bool _adaptive_fec = true;
+		int _dtls_worker_count = 2;
+		int _slow_consumer_queue_delay = 2000;
+		int _slow_consumer_loss = 30;
+		int _slow_consumer_timeout = 5;
 	};
 }  // namespace cfg
\ No newline at end of file
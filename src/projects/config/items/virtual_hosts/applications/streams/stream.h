@@ -16,15 +16,30 @@ namespace cfg
 	{
 		CFG_DECLARE_REF_GETTER_OF(GetName, _name)
 		CFG_DECLARE_REF_GETTER_OF(GetProfileList, _profiles.GetProfileList())
+		CFG_DECLARE_GETTER_OF(IsOnDemand, _on_demand)
+		CFG_DECLARE_GETTER_OF(GetIdleTimeout, _idle_timeout)
+		CFG_DECLARE_REF_GETTER_OF(GetGroup, _group)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue("Name", &_name);
 			RegisterValue("Profiles", &_profiles);
+			RegisterValue<Optional>("OnDemand", &_on_demand);
+			RegisterValue<Optional>("IdleTimeout", &_idle_timeout);
+			RegisterValue<Optional>("Group", &_group);
 		}
 
 		ov::String _name;
 		StreamProfiles _profiles;
+
+		// Encode the stream only while it has sessions of WebRTC/HLS/DASH
+		// (The sessions of the OVT publisher are not counted, so do not enable it for the origin of the edges)
+		bool _on_demand = false;
+		// Seconds to keep encoding after the last session is disconnected
+		int _idle_timeout = 30;
+		// The streams of the same group are the renditions of an ABR stream (${OriginStreamName} can be used).
+		// They are served in <Group>/master.m3u8 and <Group>/master.mpd (the keyframes of all renditions are aligned to the segment boundaries)
+		ov::String _group;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "pass.h"
+#include "prewarm.h"
 
 namespace cfg
 {
@@ -16,15 +17,30 @@ namespace cfg
 	{
 		CFG_DECLARE_REF_GETTER_OF(GetLocation, _location)
 		CFG_DECLARE_REF_GETTER_OF(GetPass, _pass)
+		CFG_DECLARE_REF_GETTER_OF(GetBalance, _balance)
+		CFG_DECLARE_REF_GETTER_OF(GetPrewarm, _prewarm)
+		CFG_DECLARE_GETTER_OF(IsDirectoryEnabled, _directory)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue("Location", &_location);
 			RegisterValue("Pass", &_pass);
+			RegisterValue<Optional>("Balance", &_balance, nullptr, [this]() -> bool {
+				auto balance = _balance.LowerCaseString();
+
+				return (balance == "order") || (balance == "leastload") || (balance == "hash");
+			});
+			RegisterValue<Optional>("Prewarm", &_prewarm);
+			RegisterValue<Optional>("Directory", &_directory);
 		}
 
 		ov::String _location;
 		Pass _pass;
+		// order (default), leastload, hash
+		ov::String _balance = "order";
+		Prewarm _prewarm;
+		// The streams are pulled from the origin that has them (OVT only, See StreamDirectory)
+		bool _directory = false;
 	};
 }  // namespace cfg
\ No newline at end of file
@@ -0,0 +1,28 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "../domain/names/name.h"
+
+namespace cfg
+{
+	// The streams of the origin are pulled as soon as they are created (OVT only)
+	struct Prewarm : public Item
+	{
+		// The patterns of the stream names ("*" and "?" can be used), all streams are pulled if empty
+		CFG_DECLARE_REF_GETTER_OF(GetStreamNameList, _stream_name_list)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("StreamName", &_stream_name_list);
+		}
+
+		std::vector<Name> _stream_name_list;
+	};
+}  // namespace cfg
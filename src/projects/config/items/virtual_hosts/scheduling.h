@@ -0,0 +1,36 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+namespace cfg
+{
+	// The share of the server that a virtual host/application gets when the server is busy
+	// (The weight of an application is the weight of its host x its weight / 100)
+	struct Scheduling : public Item
+	{
+		// The relative share of the shared worker pool (and the transcode budget), the default is 100
+		CFG_DECLARE_GETTER_OF(GetWeight, _weight)
+		// The maximum number of threads of the shared worker pool that an application uses at once (0: unlimited)
+		// (The value of the host is used by the applications that don't set it)
+		CFG_DECLARE_GETTER_OF(GetMaxWorkerThreads, _max_worker_threads)
+
+	protected:
+		void MakeParseList() override
+		{
+			RegisterValue<Optional>("Weight", &_weight, nullptr, [this]() -> bool {
+				return (_weight > 0);
+			});
+			RegisterValue<Optional>("MaxWorkerThreads", &_max_worker_threads, nullptr, [this]() -> bool {
+				return (_max_worker_threads >= 0);
+			});
+		}
+
+		int _weight = 100;
+		int _max_worker_threads = 0;
+	};
+}  // namespace cfg
@@ -14,15 +14,23 @@ namespace cfg
 	{
 		CFG_DECLARE_REF_GETTER_OF(GetCryptoKey, _crypto_key)
 		CFG_DECLARE_REF_GETTER_OF(GetQueryStringKey, _query_string_key)
+		// DES (default) or HMAC-SHA256
+		CFG_DECLARE_REF_GETTER_OF(GetType, _type)
 
 	protected:
 		void MakeParseList() override
 		{
 			RegisterValue("CryptoKey", &_crypto_key);
 			RegisterValue("QueryStringKey", &_query_string_key);
+			// A typo must not fall back to DES silently
+			RegisterValue<Optional>("Type", &_type, nullptr, [this]() -> bool {
+				auto type = _type.UpperCaseString();
+				return (type == "DES") || (type == "HMAC-SHA256");
+			});
 		}
 
 		ov::String _crypto_key;
 		ov::String _query_string_key;
+		ov::String _type = "DES";
 	};
 }  // namespace cfg
\ No newline at end of file
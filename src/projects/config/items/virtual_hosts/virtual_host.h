@@ -11,6 +11,7 @@
 #include "applications/applications.h"
 #include "domain/domain.h"
 #include "origins/origins.h"
+#include "scheduling.h"
 #include "signed_url/signed_url.h"
 
 namespace cfg
@@ -24,6 +25,8 @@ namespace cfg
 
 		CFG_DECLARE_REF_GETTER_OF(GetSignedUrl, _signed_url)
 
+		CFG_DECLARE_REF_GETTER_OF(GetScheduling, _scheduling)
+
 		CFG_DECLARE_REF_GETTER_OF(GetOrigins, _origins)
 		CFG_DECLARE_REF_GETTER_OF(GetOriginList, _origins.GetOriginList())
 		CFG_DECLARE_REF_GETTER_OF(GetApplicationList, _applications.GetApplicationList())
@@ -37,6 +40,8 @@ namespace cfg
 
 			RegisterValue<Optional>("SignedURL", &_signed_url);
 
+			RegisterValue<Optional>("Scheduling", &_scheduling);
+
 			RegisterValue<CondOptional>("Origins", &_origins, [this]() -> bool {
 				// <Origins> is not optional when the host type is edge
 				// return (_type != HostType::Edge);
@@ -53,6 +58,7 @@ namespace cfg
 
 		Domain _domain;
 		SignedUrl _signed_url;
+		Scheduling _scheduling;
 		Origins _origins;
 		Applications _applications;
 	};
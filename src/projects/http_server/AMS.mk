@@ -4,10 +4,12 @@ include $(DEFAULT_VARIABLES)
 LOCAL_TARGET := http_server
 
 LOCAL_SOURCE_FILES := $(LOCAL_SOURCE_FILES) \
+    $(call get_sub_source_list,http2) \
     $(call get_sub_source_list,interceptors) \
     $(call get_sub_source_list,interceptors/**)
 
 LOCAL_HEADER_FILES := $(LOCAL_HEADER_FILES) \
+    $(call get_sub_header_list,http2) \
     $(call get_sub_header_list,interceptors) \
     $(call get_sub_header_list,interceptors/**)
 
@@ -0,0 +1,1102 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "http2_connection.h"
+#include "http2_response.h"
+
+#include "../http_client.h"
+#include "../http_private.h"
+#include "../http_server.h"
+
+static inline uint32_t ReadUint32(const uint8_t *bytes)
+{
+	return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) | (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+}
+
+static inline void WriteUint32(uint8_t *bytes, uint32_t value)
+{
+	bytes[0] = static_cast<uint8_t>(value >> 24);
+	bytes[1] = static_cast<uint8_t>(value >> 16);
+	bytes[2] = static_cast<uint8_t>(value >> 8);
+	bytes[3] = static_cast<uint8_t>(value);
+}
+
+Http2Connection::Http2Connection(HttpServer *server, const std::shared_ptr<HttpClient> &client)
+	: _server(server),
+	  _client(client),
+	  _input_buffer(std::make_shared<ov::Data>())
+{
+}
+
+bool Http2Connection::Start()
+{
+	// RFC7540 - 3.5. HTTP/2 Connection Preface
+	// The server connection preface consists of a potentially empty SETTINGS frame
+	uint8_t payload[6];
+
+	payload[0] = 0x00;
+	payload[1] = static_cast<uint8_t>(Http2SettingId::MaxConcurrentStreams);
+	WriteUint32(payload + 2, HTTP2_MAX_CONCURRENT_STREAMS);
+
+	std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+	return WriteFrame(Http2FrameType::Settings, 0x00, 0, payload, sizeof(payload));
+}
+
+bool Http2Connection::ProcessData(const std::shared_ptr<const ov::Data> &data)
+{
+	_input_buffer->Append(data);
+
+	auto buffer = _input_buffer->GetDataAs<uint8_t>();
+	size_t remained = _input_buffer->GetLength();
+
+	if (_is_preface_received == false)
+	{
+		auto length = std::min(remained, HTTP2_CONNECTION_PREFACE_LENGTH);
+
+		if (::memcmp(buffer, HTTP2_CONNECTION_PREFACE, length) != 0)
+		{
+			logtw("Invalid HTTP/2 connection preface");
+			return false;
+		}
+
+		if (remained < HTTP2_CONNECTION_PREFACE_LENGTH)
+		{
+			// Need more data
+			return true;
+		}
+
+		_is_preface_received = true;
+
+		buffer += HTTP2_CONNECTION_PREFACE_LENGTH;
+		remained -= HTTP2_CONNECTION_PREFACE_LENGTH;
+	}
+
+	bool result = true;
+
+	while (remained >= HTTP2_FRAME_HEADER_SIZE)
+	{
+		// RFC7540 - 4.1. Frame Format
+		// +-----------------------------------------------+
+		// |                 Length (24)                   |
+		// +---------------+---------------+---------------+
+		// |   Type (8)    |   Flags (8)   |
+		// +-+-------------+---------------+-------------------------------+
+		// |R|                 Stream Identifier (31)                      |
+		// +=+=============================================================+
+		// |                   Frame Payload (0...)                      ...
+		// +---------------------------------------------------------------+
+		Http2FrameHeader header;
+
+		header.length = (static_cast<uint32_t>(buffer[0]) << 16) | (static_cast<uint32_t>(buffer[1]) << 8) | buffer[2];
+		header.type = static_cast<Http2FrameType>(buffer[3]);
+		header.flags = buffer[4];
+		header.stream_id = ReadUint32(buffer + 5) & 0x7FFFFFFF;
+
+		// The server doesn't change SETTINGS_MAX_FRAME_SIZE
+		if (header.length > HTTP2_DEFAULT_MAX_FRAME_SIZE)
+		{
+			logtw("Too large HTTP/2 frame: %u", header.length);
+
+			std::lock_guard<decltype(_mutex)> lock(_mutex);
+			WriteGoAway(Http2ErrorCode::FrameSizeError);
+			result = false;
+			break;
+		}
+
+		if (remained < (HTTP2_FRAME_HEADER_SIZE + header.length))
+		{
+			// Need more data
+			break;
+		}
+
+		logtd("HTTP/2 frame is received - type: %d, flags: 0x%02X, stream: %u, length: %u",
+			  static_cast<int>(header.type), header.flags, header.stream_id, header.length);
+
+		auto error_code = ProcessFrame(header, buffer + HTTP2_FRAME_HEADER_SIZE);
+
+		if (error_code != Http2ErrorCode::NoError)
+		{
+			logtw("An error occurred while processing HTTP/2 frame (type: %d, stream: %u): %d",
+				  static_cast<int>(header.type), header.stream_id, static_cast<int>(error_code));
+
+			std::lock_guard<decltype(_mutex)> lock(_mutex);
+			WriteGoAway(error_code);
+			result = false;
+			break;
+		}
+
+		buffer += (HTTP2_FRAME_HEADER_SIZE + header.length);
+		remained -= (HTTP2_FRAME_HEADER_SIZE + header.length);
+	}
+
+	if (result)
+	{
+		// Keep the remaining data
+		_input_buffer->Erase(0, _input_buffer->GetLength() - remained);
+	}
+
+	return result;
+}
+
+void Http2Connection::Close()
+{
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		_is_closed = true;
+
+		for (auto &item : _stream_map)
+		{
+			closed_streams.push_back(item.second);
+		}
+
+		_stream_map.clear();
+	}
+
+	NotifyClosedStreams(closed_streams);
+}
+
+Http2ErrorCode Http2Connection::ProcessFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if ((_header_block_stream_id != 0) && (header.type != Http2FrameType::Continuation))
+	{
+		// RFC7540 - 6.2. HEADERS
+		// A HEADERS frame without the END_HEADERS flag set MUST be followed by a CONTINUATION frame for the same stream
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	switch (header.type)
+	{
+		case Http2FrameType::Data:
+			return ProcessDataFrame(header, payload);
+
+		case Http2FrameType::Headers:
+			return ProcessHeadersFrame(header, payload);
+
+		case Http2FrameType::Priority:
+			// The streams are not prioritized
+			if (header.stream_id == 0)
+			{
+				return Http2ErrorCode::ProtocolError;
+			}
+
+			return (header.length == 5) ? Http2ErrorCode::NoError : Http2ErrorCode::FrameSizeError;
+
+		case Http2FrameType::RstStream:
+			return ProcessRstStreamFrame(header, payload);
+
+		case Http2FrameType::Settings:
+			return ProcessSettingsFrame(header, payload);
+
+		case Http2FrameType::PushPromise:
+			// A client cannot push
+			return Http2ErrorCode::ProtocolError;
+
+		case Http2FrameType::Ping:
+			return ProcessPingFrame(header, payload);
+
+		case Http2FrameType::GoAway:
+			if (header.stream_id != 0)
+			{
+				return Http2ErrorCode::ProtocolError;
+			}
+
+			// The client doesn't send the new requests, and the server keeps processing the streams that are opened
+			logtd("GOAWAY is received");
+			return Http2ErrorCode::NoError;
+
+		case Http2FrameType::WindowUpdate:
+			return ProcessWindowUpdateFrame(header, payload);
+
+		case Http2FrameType::Continuation:
+			return ProcessContinuationFrame(header, payload);
+	}
+
+	// RFC7540 - 4.1. Frame Format
+	// Implementations MUST ignore and discard any frame that has a type that is unknown
+	return Http2ErrorCode::NoError;
+}
+
+bool Http2Connection::StripPadding(const Http2FrameHeader &header, const uint8_t **payload, size_t *length)
+{
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_PADDED) == false)
+	{
+		return true;
+	}
+
+	if (*length < 1)
+	{
+		return false;
+	}
+
+	size_t pad_length = (*payload)[0];
+
+	if (pad_length >= *length)
+	{
+		return false;
+	}
+
+	*payload += 1;
+	*length -= (1 + pad_length);
+
+	return true;
+}
+
+Http2ErrorCode Http2Connection::ProcessHeadersFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	const uint8_t *fragment = payload;
+	size_t length = header.length;
+
+	// The stream identifiers of the client are odd numbers
+	if ((header.stream_id == 0) || ((header.stream_id % 2) == 0))
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (StripPadding(header, &fragment, &length) == false)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_PRIORITY))
+	{
+		// Stream Dependency (32) + Weight (8)
+		if (length < 5)
+		{
+			return Http2ErrorCode::FrameSizeError;
+		}
+
+		fragment += 5;
+		length -= 5;
+	}
+
+	_header_block_stream_id = header.stream_id;
+	_is_header_block_end_stream = OV_CHECK_FLAG(header.flags, HTTP2_FLAG_END_STREAM);
+	_header_block.Clear();
+	_header_block.Append(fragment, length);
+
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_END_HEADERS))
+	{
+		return ProcessHeaderBlock();
+	}
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessContinuationFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if ((_header_block_stream_id == 0) || (header.stream_id != _header_block_stream_id))
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if ((_header_block.GetLength() + header.length) > HTTP2_MAX_HEADER_BLOCK_SIZE)
+	{
+		logtw("Too large HTTP/2 header block");
+		return Http2ErrorCode::EnhanceYourCalm;
+	}
+
+	_header_block.Append(payload, header.length);
+
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_END_HEADERS))
+	{
+		return ProcessHeaderBlock();
+	}
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessHeaderBlock()
+{
+	auto stream_id = _header_block_stream_id;
+	bool end_stream = _is_header_block_end_stream;
+
+	_header_block_stream_id = 0;
+
+	// The block must be decoded even if the stream is refused to keep the dynamic table synchronized
+	Http2HeaderList headers;
+
+	if (_hpack_decoder.Decode(_header_block.GetDataAs<uint8_t>(), _header_block.GetLength(), &headers) == false)
+	{
+		return Http2ErrorCode::CompressionError;
+	}
+
+	_header_block.Clear();
+
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		auto item = _stream_map.find(stream_id);
+
+		if (item != _stream_map.end())
+		{
+			auto stream = item->second;
+
+			// Trailers
+			if (stream->is_remote_closed)
+			{
+				WriteRstStream(stream_id, Http2ErrorCode::StreamClosed);
+				return Http2ErrorCode::NoError;
+			}
+
+			if (end_stream == false)
+			{
+				return Http2ErrorCode::ProtocolError;
+			}
+
+			stream->is_remote_closed = true;
+			RemoveStreamIfClosed(stream, &closed_streams);
+		}
+		else
+		{
+			if (stream_id <= _last_stream_id)
+			{
+				// The stream is already closed
+				return Http2ErrorCode::StreamClosed;
+			}
+
+			_last_stream_id = stream_id;
+
+			if (_is_closed)
+			{
+				return Http2ErrorCode::NoError;
+			}
+
+			if (_stream_map.size() >= HTTP2_MAX_CONCURRENT_STREAMS)
+			{
+				WriteRstStream(stream_id, Http2ErrorCode::RefusedStream);
+				return Http2ErrorCode::NoError;
+			}
+		}
+	}
+
+	if (closed_streams.empty() == false)
+	{
+		NotifyClosedStreams(closed_streams);
+		return Http2ErrorCode::NoError;
+	}
+
+	OpenStream(stream_id, headers, end_stream);
+
+	return Http2ErrorCode::NoError;
+}
+
+void Http2Connection::OpenStream(uint32_t stream_id, const Http2HeaderList &headers, bool end_stream)
+{
+	auto connection_client = _client.lock();
+
+	if (connection_client == nullptr)
+	{
+		return;
+	}
+
+	auto connection_request = connection_client->GetRequest();
+	auto remote = connection_request->GetRemote();
+
+	auto request = std::make_shared<HttpRequest>(remote, _server->_default_interceptor);
+	auto http2_response = std::make_shared<Http2Response>(remote, GetSharedPtr(), stream_id);
+	std::shared_ptr<HttpResponse> response = http2_response;
+
+	// The URI is made by the scheme of the connection
+	request->SetTlsData(connection_request->GetTlsData());
+	response->SetTlsData(connection_client->GetResponse()->GetTlsData());
+	response->SetHttpVersion("2.0");
+
+	// Set default headers
+	response->SetHeader("Server", "OvenMediaEngine");
+	response->SetHeader("Content-Type", "text/html");
+
+	auto client = std::make_shared<HttpClient>(_server->GetSharedPtr(), request, response);
+
+	auto stream = std::make_shared<Stream>();
+
+	stream->id = stream_id;
+	stream->client = client;
+	stream->is_remote_closed = end_stream;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		if (_is_closed)
+		{
+			return;
+		}
+
+		stream->send_window = _peer_initial_window_size;
+		_stream_map[stream_id] = stream;
+	}
+
+	auto status_code = request->SetHttp2Request(headers);
+
+	if (status_code != HttpStatusCode::OK)
+	{
+		logtw("Invalid HTTP/2 request (stream: %u): %d", stream_id, status_code);
+
+		response->SetStatusCode(status_code);
+		response->Response();
+		response->Close();
+		return;
+	}
+
+	if (HttpServer::IsTooEarly(request))
+	{
+		// Only the stream is answered, the client retries it after the handshake
+		response->SetStatusCode(HttpStatusCode::TooEarly);
+		response->Response();
+		response->Close();
+		return;
+	}
+
+	auto interceptor = _server->FindInterceptor(client);
+
+	if (interceptor == nullptr)
+	{
+		response->SetStatusCode(HttpStatusCode::InternalServerError);
+		response->Response();
+		response->Close();
+		OV_ASSERT2(false);
+		return;
+	}
+
+	logti("Client(%s) is requested uri: [%s] (HTTP/2 stream: %u)", remote->GetRemoteAddress()->ToString().CStr(), request->GetUri().CStr(), stream_id);
+
+	bool need_to_close = (interceptor->OnHttpPrepare(client) == HttpInterceptorResult::Disconnect);
+	need_to_close = need_to_close || (interceptor->OnHttpData(client, std::make_shared<ov::Data>()) == HttpInterceptorResult::Disconnect);
+
+	if (need_to_close)
+	{
+		// Only the stream is closed
+		response->Response();
+		response->Close();
+	}
+}
+
+void Http2Connection::NotifyClosedStreams(const std::vector<std::shared_ptr<Stream>> &streams)
+{
+	for (auto &stream : streams)
+	{
+		auto &client = stream->client;
+		auto interceptor = client->GetRequest()->GetRequestInterceptor();
+
+		if (interceptor != nullptr)
+		{
+			interceptor->OnHttpClosed(client);
+		}
+	}
+}
+
+Http2ErrorCode Http2Connection::ProcessDataFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	const uint8_t *data = payload;
+	size_t length = header.length;
+
+	if (header.stream_id == 0)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (StripPadding(header, &data, &length) == false)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	std::shared_ptr<Stream> stream;
+	bool end_stream = OV_CHECK_FLAG(header.flags, HTTP2_FLAG_END_STREAM);
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		// The received data is consumed immediately, so the windows are restored as they are
+		if (header.length > 0)
+		{
+			WriteWindowUpdate(0, header.length);
+		}
+
+		auto item = _stream_map.find(header.stream_id);
+
+		if (item == _stream_map.end())
+		{
+			if (header.stream_id > _last_stream_id)
+			{
+				// The stream is idle
+				return Http2ErrorCode::ProtocolError;
+			}
+
+			WriteRstStream(header.stream_id, Http2ErrorCode::StreamClosed);
+			return Http2ErrorCode::NoError;
+		}
+
+		stream = item->second;
+
+		if (stream->is_remote_closed)
+		{
+			WriteRstStream(header.stream_id, Http2ErrorCode::StreamClosed);
+			return Http2ErrorCode::NoError;
+		}
+
+		if ((header.length > 0) && (end_stream == false))
+		{
+			WriteWindowUpdate(header.stream_id, header.length);
+		}
+	}
+
+	auto &client = stream->client;
+	auto interceptor = client->GetRequest()->GetRequestInterceptor();
+
+	if ((length > 0) && (interceptor != nullptr))
+	{
+		if (interceptor->OnHttpData(client, std::make_shared<ov::Data>(data, length)) == HttpInterceptorResult::Disconnect)
+		{
+			auto response = client->GetResponse();
+
+			response->Response();
+			response->Close();
+		}
+	}
+
+	if (end_stream)
+	{
+		std::vector<std::shared_ptr<Stream>> closed_streams;
+
+		{
+			std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+			stream->is_remote_closed = true;
+			RemoveStreamIfClosed(stream, &closed_streams);
+		}
+
+		NotifyClosedStreams(closed_streams);
+	}
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessRstStreamFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if (header.stream_id == 0)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (header.length != 4)
+	{
+		return Http2ErrorCode::FrameSizeError;
+	}
+
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		if (header.stream_id > _last_stream_id)
+		{
+			return Http2ErrorCode::ProtocolError;
+		}
+
+		auto item = _stream_map.find(header.stream_id);
+
+		if (item != _stream_map.end())
+		{
+			logtd("The stream %u is reset by the client: %u", header.stream_id, ReadUint32(payload));
+
+			closed_streams.push_back(item->second);
+			_stream_map.erase(item);
+		}
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessSettingsFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if (header.stream_id != 0)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_ACK))
+	{
+		return (header.length == 0) ? Http2ErrorCode::NoError : Http2ErrorCode::FrameSizeError;
+	}
+
+	if ((header.length % 6) != 0)
+	{
+		return Http2ErrorCode::FrameSizeError;
+	}
+
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		for (size_t offset = 0; offset < header.length; offset += 6)
+		{
+			auto id = static_cast<Http2SettingId>((payload[offset] << 8) | payload[offset + 1]);
+			auto value = ReadUint32(payload + offset + 2);
+
+			switch (id)
+			{
+				case Http2SettingId::EnablePush:
+					if (value > 1)
+					{
+						return Http2ErrorCode::ProtocolError;
+					}
+					break;
+
+				case Http2SettingId::InitialWindowSize: {
+					if (value > HTTP2_MAX_WINDOW_SIZE)
+					{
+						return Http2ErrorCode::FlowControlError;
+					}
+
+					// RFC7540 - 6.9.2. Initial Flow-Control Window Size
+					// A SETTINGS frame can alter the initial flow-control window size for all streams
+					auto delta = static_cast<int64_t>(value) - _peer_initial_window_size;
+
+					for (auto &item : _stream_map)
+					{
+						item.second->send_window += delta;
+					}
+
+					_peer_initial_window_size = value;
+					break;
+				}
+
+				case Http2SettingId::MaxFrameSize:
+					if ((value < HTTP2_DEFAULT_MAX_FRAME_SIZE) || (value > HTTP2_MAX_FRAME_SIZE))
+					{
+						return Http2ErrorCode::ProtocolError;
+					}
+
+					_peer_max_frame_size = value;
+					break;
+
+				default:
+					// HeaderTableSize: The encoder doesn't use the dynamic table
+					// MaxConcurrentStreams: The server doesn't push
+					// MaxHeaderListSize: Advisory
+					break;
+			}
+		}
+
+		WriteFrame(Http2FrameType::Settings, HTTP2_FLAG_ACK, 0, nullptr, 0);
+
+		FlushStreams(&closed_streams);
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessPingFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if (header.stream_id != 0)
+	{
+		return Http2ErrorCode::ProtocolError;
+	}
+
+	if (header.length != 8)
+	{
+		return Http2ErrorCode::FrameSizeError;
+	}
+
+	if (OV_CHECK_FLAG(header.flags, HTTP2_FLAG_ACK) == false)
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		WriteFrame(Http2FrameType::Ping, HTTP2_FLAG_ACK, 0, payload, header.length);
+	}
+
+	return Http2ErrorCode::NoError;
+}
+
+Http2ErrorCode Http2Connection::ProcessWindowUpdateFrame(const Http2FrameHeader &header, const uint8_t *payload)
+{
+	if (header.length != 4)
+	{
+		return Http2ErrorCode::FrameSizeError;
+	}
+
+	auto increment = ReadUint32(payload) & 0x7FFFFFFF;
+
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		if (header.stream_id == 0)
+		{
+			if (increment == 0)
+			{
+				return Http2ErrorCode::ProtocolError;
+			}
+
+			_send_window += increment;
+
+			if (_send_window > HTTP2_MAX_WINDOW_SIZE)
+			{
+				return Http2ErrorCode::FlowControlError;
+			}
+
+			FlushStreams(&closed_streams);
+		}
+		else
+		{
+			auto item = _stream_map.find(header.stream_id);
+
+			if (item == _stream_map.end())
+			{
+				// WINDOW_UPDATE can be received for the closed streams
+				return Http2ErrorCode::NoError;
+			}
+
+			auto stream = item->second;
+
+			if ((increment == 0) || ((stream->send_window + increment) > HTTP2_MAX_WINDOW_SIZE))
+			{
+				WriteRstStream(header.stream_id, (increment == 0) ? Http2ErrorCode::ProtocolError : Http2ErrorCode::FlowControlError);
+
+				_stream_map.erase(item);
+				closed_streams.push_back(stream);
+			}
+			else
+			{
+				stream->send_window += increment;
+				FlushStream(stream, &closed_streams);
+			}
+		}
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return Http2ErrorCode::NoError;
+}
+
+bool Http2Connection::SendHeaders(uint32_t stream_id, const Http2HeaderList &headers, const ov::DataChain &data, bool end_stream)
+{
+	ov::Data block;
+
+	Http2HpackEncoder::Encode(headers, &block);
+
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+	bool result = false;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		auto item = _stream_map.find(stream_id);
+
+		if ((item == _stream_map.end()) || item->second->is_local_closed)
+		{
+			return false;
+		}
+
+		auto stream = item->second;
+		bool has_data = QueueData(stream, data, end_stream);
+
+		// HEADERS + CONTINUATION frames are sent with a single write not to be interleaved with the other frames
+		std::vector<std::shared_ptr<const ov::Data>> frames;
+		size_t offset = 0;
+
+		do
+		{
+			auto length = std::min(block.GetLength() - offset, _peer_max_frame_size);
+			bool is_first = (offset == 0);
+			bool is_last = ((offset + length) == block.GetLength());
+
+			uint8_t flags = is_last ? HTTP2_FLAG_END_HEADERS : 0x00;
+
+			if (is_first && end_stream && (has_data == false))
+			{
+				flags |= HTTP2_FLAG_END_STREAM;
+			}
+
+			frames.push_back(MakeFrameHeader(is_first ? Http2FrameType::Headers : Http2FrameType::Continuation, flags, stream_id, length));
+
+			if (length > 0)
+			{
+				frames.push_back(std::make_shared<ov::Data>(block.GetDataAs<uint8_t>() + offset, length));
+			}
+
+			offset += length;
+		} while (offset < block.GetLength());
+
+		if (has_data)
+		{
+			FlushStream(stream, &closed_streams, std::move(frames));
+			result = true;
+		}
+		else
+		{
+			result = WriteFrames(frames);
+
+			if (end_stream)
+			{
+				stream->is_local_closed = true;
+				RemoveStreamIfClosed(stream, &closed_streams);
+			}
+		}
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return result;
+}
+
+bool Http2Connection::SendData(uint32_t stream_id, const ov::DataChain &data, bool end_stream)
+{
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+	bool result = false;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		auto item = _stream_map.find(stream_id);
+
+		if ((item == _stream_map.end()) || item->second->is_local_closed || item->second->is_end_stream_queued)
+		{
+			return false;
+		}
+
+		auto stream = item->second;
+
+		QueueData(stream, data, end_stream);
+		FlushStream(stream, &closed_streams);
+
+		result = true;
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return result;
+}
+
+bool Http2Connection::EndStream(uint32_t stream_id)
+{
+	return SendData(stream_id, ov::DataChain(), true);
+}
+
+bool Http2Connection::ResetStream(uint32_t stream_id, Http2ErrorCode error_code)
+{
+	std::vector<std::shared_ptr<Stream>> closed_streams;
+
+	{
+		std::lock_guard<decltype(_mutex)> lock(_mutex);
+
+		auto item = _stream_map.find(stream_id);
+
+		if (item == _stream_map.end())
+		{
+			return false;
+		}
+
+		WriteRstStream(stream_id, error_code);
+
+		closed_streams.push_back(item->second);
+		_stream_map.erase(item);
+	}
+
+	NotifyClosedStreams(closed_streams);
+
+	return true;
+}
+
+std::shared_ptr<const ov::Data> Http2Connection::MakeFrameHeader(Http2FrameType type, uint8_t flags, uint32_t stream_id, size_t length)
+{
+	uint8_t header[HTTP2_FRAME_HEADER_SIZE];
+
+	header[0] = static_cast<uint8_t>(length >> 16);
+	header[1] = static_cast<uint8_t>(length >> 8);
+	header[2] = static_cast<uint8_t>(length);
+	header[3] = static_cast<uint8_t>(type);
+	header[4] = flags;
+	WriteUint32(header + 5, stream_id & 0x7FFFFFFF);
+
+	return std::make_shared<const ov::Data>(header, sizeof(header));
+}
+
+bool Http2Connection::WriteFrame(Http2FrameType type, uint8_t flags, uint32_t stream_id, const void *payload, size_t length)
+{
+	std::vector<std::shared_ptr<const ov::Data>> frames;
+
+	frames.push_back(MakeFrameHeader(type, flags, stream_id, length));
+
+	if (length > 0)
+	{
+		frames.push_back(std::make_shared<const ov::Data>(payload, length));
+	}
+
+	return WriteFrames(frames);
+}
+
+bool Http2Connection::WriteFrames(const std::vector<std::shared_ptr<const ov::Data>> &frames)
+{
+	auto client = _client.lock();
+
+	if (client == nullptr)
+	{
+		return false;
+	}
+
+	// The response of the connection sends the frames (it encrypts them if TLS is used)
+	return client->GetResponse()->Send(ov::DataChain(frames));
+}
+
+bool Http2Connection::WriteRstStream(uint32_t stream_id, Http2ErrorCode error_code)
+{
+	uint8_t payload[4];
+
+	WriteUint32(payload, static_cast<uint32_t>(error_code));
+
+	return WriteFrame(Http2FrameType::RstStream, 0x00, stream_id, payload, sizeof(payload));
+}
+
+bool Http2Connection::WriteGoAway(Http2ErrorCode error_code)
+{
+	// Last-Stream-ID (32) + Error Code (32)
+	uint8_t payload[8];
+
+	WriteUint32(payload, _last_stream_id);
+	WriteUint32(payload + 4, static_cast<uint32_t>(error_code));
+
+	return WriteFrame(Http2FrameType::GoAway, 0x00, 0, payload, sizeof(payload));
+}
+
+bool Http2Connection::WriteWindowUpdate(uint32_t stream_id, uint32_t increment)
+{
+	uint8_t payload[4];
+
+	WriteUint32(payload, increment & 0x7FFFFFFF);
+
+	return WriteFrame(Http2FrameType::WindowUpdate, 0x00, stream_id, payload, sizeof(payload));
+}
+
+bool Http2Connection::QueueData(const std::shared_ptr<Stream> &stream, const ov::DataChain &data, bool end_stream)
+{
+	// The empty slices are not in the chain
+	stream->pending_data_list.insert(stream->pending_data_list.end(), data.begin(), data.end());
+	stream->is_end_stream_queued = end_stream;
+
+	return (data.IsEmpty() == false);
+}
+
+bool Http2Connection::FlushStream(const std::shared_ptr<Stream> &stream, std::vector<std::shared_ptr<Stream>> *closed_streams,
+								  std::vector<std::shared_ptr<const ov::Data>> frames)
+{
+	// The index of the header of the last DATA frame to set END_STREAM
+	ssize_t last_header_index = -1;
+	size_t last_length = 0;
+
+	while (stream->pending_data_list.empty() == false)
+	{
+		auto window = std::min(stream->send_window, _send_window);
+
+		if (window <= 0)
+		{
+			// Wait for WINDOW_UPDATE
+			break;
+		}
+
+		auto &data = stream->pending_data_list.front();
+		size_t length = std::min(std::min(data->GetLength() - stream->pending_offset, static_cast<size_t>(window)), _peer_max_frame_size);
+
+		last_header_index = frames.size();
+		last_length = length;
+
+		frames.push_back(MakeFrameHeader(Http2FrameType::Data, 0x00, stream->id, length));
+		// The payload refers the data (the file descriptor is kept, so it can be sent using sendfile())
+		frames.push_back(data->Subdata(stream->pending_offset, length));
+
+		stream->send_window -= length;
+		_send_window -= length;
+		stream->pending_offset += length;
+
+		if (stream->pending_offset >= data->GetLength())
+		{
+			stream->pending_data_list.pop_front();
+			stream->pending_offset = 0;
+		}
+	}
+
+	bool end_stream = stream->pending_data_list.empty() && stream->is_end_stream_queued && (stream->is_local_closed == false);
+
+	if (end_stream)
+	{
+		if (last_header_index >= 0)
+		{
+			frames[last_header_index] = MakeFrameHeader(Http2FrameType::Data, HTTP2_FLAG_END_STREAM, stream->id, last_length);
+		}
+		else
+		{
+			frames.push_back(MakeFrameHeader(Http2FrameType::Data, HTTP2_FLAG_END_STREAM, stream->id, 0));
+		}
+	}
+
+	if (frames.empty() == false)
+	{
+		WriteFrames(frames);
+	}
+
+	if (end_stream)
+	{
+		stream->is_local_closed = true;
+		return RemoveStreamIfClosed(stream, closed_streams);
+	}
+
+	return false;
+}
+
+void Http2Connection::FlushStreams(std::vector<std::shared_ptr<Stream>> *closed_streams)
+{
+	// FlushStream() can remove the stream from the map
+	std::vector<std::shared_ptr<Stream>> streams;
+
+	for (auto &item : _stream_map)
+	{
+		if (item.second->pending_data_list.empty() == false)
+		{
+			streams.push_back(item.second);
+		}
+	}
+
+	for (auto &stream : streams)
+	{
+		if (_send_window <= 0)
+		{
+			break;
+		}
+
+		FlushStream(stream, closed_streams);
+	}
+}
+
+bool Http2Connection::RemoveStreamIfClosed(const std::shared_ptr<Stream> &stream, std::vector<std::shared_ptr<Stream>> *closed_streams)
+{
+	if ((stream->is_local_closed == false) || (stream->is_remote_closed == false))
+	{
+		return false;
+	}
+
+	auto item = _stream_map.find(stream->id);
+
+	if ((item != _stream_map.end()) && (item->second == stream))
+	{
+		_stream_map.erase(item);
+		closed_streams->push_back(stream);
+	}
+
+	return true;
+}
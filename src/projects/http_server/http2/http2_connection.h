@@ -0,0 +1,145 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "http2_datastructure.h"
+#include "http2_hpack.h"
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+class HttpServer;
+class HttpClient;
+
+// An HTTP/2 connection that multiplexes the requests over a socket.
+//
+// Each stream has its own HttpClient (HttpRequest + Http2Response), and is routed to the HttpRequestInterceptor like a HTTP/1.1 request,
+// so the interceptors don't need to know the version of HTTP.
+//
+// ProcessData() is called by the thread of the socket, and the responses can be sent by any thread.
+class Http2Connection : public ov::EnableSharedFromThis<Http2Connection>
+{
+public:
+	// client: the client of the connection (the responses of the streams are written using client->GetResponse())
+	Http2Connection(HttpServer *server, const std::shared_ptr<HttpClient> &client);
+	~Http2Connection() override = default;
+
+	// Sends the server connection preface (SETTINGS)
+	bool Start();
+
+	// @return false if an error occurred, then the connection must be closed
+	bool ProcessData(const std::shared_ptr<const ov::Data> &data);
+
+	// Called when the socket is disconnected
+	void Close();
+
+	//--------------------------------------------------------------------
+	// Called by Http2Response
+	//--------------------------------------------------------------------
+	// The names of the headers must be lowercase
+	// The data are sent with the HEADERS frame in a single write (as much as the flow control window allows)
+	bool SendHeaders(uint32_t stream_id, const Http2HeaderList &headers, const ov::DataChain &data, bool end_stream);
+	// The data is sent as much as the flow control window allows, and the rest is sent when the window is updated
+	bool SendData(uint32_t stream_id, const ov::DataChain &data, bool end_stream);
+	// Ends the stream after the pending data is sent
+	bool EndStream(uint32_t stream_id);
+	// Closes the stream immediately (RST_STREAM)
+	bool ResetStream(uint32_t stream_id, Http2ErrorCode error_code);
+
+protected:
+	struct Stream
+	{
+		uint32_t id = 0;
+		std::shared_ptr<HttpClient> client;
+
+		int64_t send_window = HTTP2_DEFAULT_WINDOW_SIZE;
+
+		// The data waiting for the flow control window
+		std::deque<std::shared_ptr<const ov::Data>> pending_data_list;
+		// The number of bytes already sent from pending_data_list.front()
+		size_t pending_offset = 0;
+		bool is_end_stream_queued = false;
+
+		// END_STREAM is sent
+		bool is_local_closed = false;
+		// END_STREAM is received
+		bool is_remote_closed = false;
+	};
+
+	// @return NoError, or the error of the connection
+	Http2ErrorCode ProcessFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessHeadersFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessContinuationFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessHeaderBlock();
+	Http2ErrorCode ProcessDataFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessRstStreamFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessSettingsFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessPingFrame(const Http2FrameHeader &header, const uint8_t *payload);
+	Http2ErrorCode ProcessWindowUpdateFrame(const Http2FrameHeader &header, const uint8_t *payload);
+
+	// Creates the client of the stream, and routes it to the interceptor
+	void OpenStream(uint32_t stream_id, const Http2HeaderList &headers, bool end_stream);
+	// Calls the interceptor with the removed streams
+	void NotifyClosedStreams(const std::vector<std::shared_ptr<Stream>> &streams);
+
+	// Calculates the padding of the payload (PADDED flag)
+	static bool StripPadding(const Http2FrameHeader &header, const uint8_t **payload, size_t *length);
+
+	//--------------------------------------------------------------------
+	// Must be called while holding _mutex
+	//--------------------------------------------------------------------
+	static std::shared_ptr<const ov::Data> MakeFrameHeader(Http2FrameType type, uint8_t flags, uint32_t stream_id, size_t length);
+	bool WriteFrame(Http2FrameType type, uint8_t flags, uint32_t stream_id, const void *payload, size_t length);
+	bool WriteFrames(const std::vector<std::shared_ptr<const ov::Data>> &frames);
+	bool WriteRstStream(uint32_t stream_id, Http2ErrorCode error_code);
+	bool WriteGoAway(Http2ErrorCode error_code);
+	bool WriteWindowUpdate(uint32_t stream_id, uint32_t increment);
+
+	// Sends the pending data of the stream, returns true if the stream is closed (and removed)
+	// frames: The frames to send before the DATA frames (such as HEADERS)
+	bool FlushStream(const std::shared_ptr<Stream> &stream, std::vector<std::shared_ptr<Stream>> *closed_streams,
+					 std::vector<std::shared_ptr<const ov::Data>> frames = {});
+	bool QueueData(const std::shared_ptr<Stream> &stream, const ov::DataChain &data, bool end_stream);
+	void FlushStreams(std::vector<std::shared_ptr<Stream>> *closed_streams);
+	// Removes the stream if both sides are closed
+	bool RemoveStreamIfClosed(const std::shared_ptr<Stream> &stream, std::vector<std::shared_ptr<Stream>> *closed_streams);
+
+	HttpServer *_server;
+	std::weak_ptr<HttpClient> _client;
+
+	//--------------------------------------------------------------------
+	// Used by the thread of the socket
+	//--------------------------------------------------------------------
+	std::shared_ptr<ov::Data> _input_buffer;
+	bool _is_preface_received = false;
+
+	Http2HpackDecoder _hpack_decoder;
+
+	// The header block that is continued by CONTINUATION frames
+	uint32_t _header_block_stream_id = 0;
+	bool _is_header_block_end_stream = false;
+	ov::Data _header_block;
+
+	//--------------------------------------------------------------------
+	// Guarded by _mutex
+	//--------------------------------------------------------------------
+	std::recursive_mutex _mutex;
+
+	std::map<uint32_t, std::shared_ptr<Stream>> _stream_map;
+	uint32_t _last_stream_id = 0;
+	bool _is_closed = false;
+
+	// The settings of the peer
+	int64_t _peer_initial_window_size = HTTP2_DEFAULT_WINDOW_SIZE;
+	size_t _peer_max_frame_size = HTTP2_DEFAULT_MAX_FRAME_SIZE;
+
+	// The flow control window of the connection
+	int64_t _send_window = HTTP2_DEFAULT_WINDOW_SIZE;
+};
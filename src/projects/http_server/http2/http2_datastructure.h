@@ -0,0 +1,90 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <cstdint>
+
+// RFC7540 - Hypertext Transfer Protocol Version 2 (HTTP/2) (https://tools.ietf.org/html/rfc7540)
+
+// RFC7540 - 3.5. HTTP/2 Connection Preface
+#define HTTP2_CONNECTION_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define HTTP2_CONNECTION_PREFACE_LENGTH (sizeof(HTTP2_CONNECTION_PREFACE) - 1)
+
+// RFC7540 - 4.1. Frame Format
+#define HTTP2_FRAME_HEADER_SIZE 9
+
+// RFC7540 - 6.5.2. Defined SETTINGS Parameters
+#define HTTP2_DEFAULT_WINDOW_SIZE 65535
+#define HTTP2_MAX_WINDOW_SIZE 0x7FFFFFFF
+#define HTTP2_DEFAULT_MAX_FRAME_SIZE 16384
+#define HTTP2_MAX_FRAME_SIZE 0xFFFFFF
+
+// The settings of the server
+#define HTTP2_MAX_CONCURRENT_STREAMS 100
+#define HTTP2_MAX_HEADER_BLOCK_SIZE (64 * 1024)
+
+// RFC7540 - 6. Frame Definitions
+enum class Http2FrameType : uint8_t
+{
+	Data = 0x0,
+	Headers = 0x1,
+	Priority = 0x2,
+	RstStream = 0x3,
+	Settings = 0x4,
+	PushPromise = 0x5,
+	Ping = 0x6,
+	GoAway = 0x7,
+	WindowUpdate = 0x8,
+	Continuation = 0x9
+};
+
+// Flags of the frames
+#define HTTP2_FLAG_END_STREAM 0x01
+#define HTTP2_FLAG_ACK 0x01
+#define HTTP2_FLAG_END_HEADERS 0x04
+#define HTTP2_FLAG_PADDED 0x08
+#define HTTP2_FLAG_PRIORITY 0x20
+
+// RFC7540 - 6.5.2. Defined SETTINGS Parameters
+enum class Http2SettingId : uint16_t
+{
+	HeaderTableSize = 0x1,
+	EnablePush = 0x2,
+	MaxConcurrentStreams = 0x3,
+	InitialWindowSize = 0x4,
+	MaxFrameSize = 0x5,
+	MaxHeaderListSize = 0x6
+};
+
+// RFC7540 - 7. Error Codes
+enum class Http2ErrorCode : uint32_t
+{
+	NoError = 0x0,
+	ProtocolError = 0x1,
+	InternalError = 0x2,
+	FlowControlError = 0x3,
+	SettingsTimeout = 0x4,
+	StreamClosed = 0x5,
+	FrameSizeError = 0x6,
+	RefusedStream = 0x7,
+	Cancel = 0x8,
+	CompressionError = 0x9,
+	ConnectError = 0xA,
+	EnhanceYourCalm = 0xB,
+	InadequateSecurity = 0xC,
+	Http11Required = 0xD
+};
+
+struct Http2FrameHeader
+{
+	uint32_t length = 0;
+	Http2FrameType type = Http2FrameType::Data;
+	uint8_t flags = 0;
+	uint32_t stream_id = 0;
+};
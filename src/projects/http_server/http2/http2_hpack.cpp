@@ -0,0 +1,538 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "http2_hpack.h"
+#include "../http_private.h"
+
+// RFC7541 - 4.1. Calculating Table Size
+#define HTTP2_HPACK_ENTRY_OVERHEAD 32
+
+struct StaticTableEntry
+{
+	const char *name;
+	const char *value;
+};
+
+// RFC7541 - Appendix A. Static Table Definition
+static const StaticTableEntry g_static_table[] = {
+	{":authority", ""},
+	{":method", "GET"},
+	{":method", "POST"},
+	{":path", "/"},
+	{":path", "/index.html"},
+	{":scheme", "http"},
+	{":scheme", "https"},
+	{":status", "200"},
+	{":status", "204"},
+	{":status", "206"},
+	{":status", "304"},
+	{":status", "400"},
+	{":status", "404"},
+	{":status", "500"},
+	{"accept-charset", ""},
+	{"accept-encoding", "gzip, deflate"},
+	{"accept-language", ""},
+	{"accept-ranges", ""},
+	{"accept", ""},
+	{"access-control-allow-origin", ""},
+	{"age", ""},
+	{"allow", ""},
+	{"authorization", ""},
+	{"cache-control", ""},
+	{"content-disposition", ""},
+	{"content-encoding", ""},
+	{"content-language", ""},
+	{"content-length", ""},
+	{"content-location", ""},
+	{"content-range", ""},
+	{"content-type", ""},
+	{"cookie", ""},
+	{"date", ""},
+	{"etag", ""},
+	{"expect", ""},
+	{"expires", ""},
+	{"from", ""},
+	{"host", ""},
+	{"if-match", ""},
+	{"if-modified-since", ""},
+	{"if-none-match", ""},
+	{"if-range", ""},
+	{"if-unmodified-since", ""},
+	{"last-modified", ""},
+	{"link", ""},
+	{"location", ""},
+	{"max-forwards", ""},
+	{"proxy-authenticate", ""},
+	{"proxy-authorization", ""},
+	{"range", ""},
+	{"referer", ""},
+	{"refresh", ""},
+	{"retry-after", ""},
+	{"server", ""},
+	{"set-cookie", ""},
+	{"strict-transport-security", ""},
+	{"transfer-encoding", ""},
+	{"user-agent", ""},
+	{"vary", ""},
+	{"via", ""},
+	{"www-authenticate", ""},
+};
+
+#define HTTP2_HPACK_STATIC_TABLE_COUNT OV_COUNTOF(g_static_table)
+
+struct HuffmanCode
+{
+	uint32_t code;
+	uint8_t length;
+};
+
+// RFC7541 - Appendix B. Huffman Code (symbol 0 ~ 255, the EOS is 0x3fffffff with 30 bits)
+static const HuffmanCode g_huffman_codes[256] = {
+	{0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28}, {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+	{0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28}, {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+	{0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28}, {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+	{0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28}, {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+	{0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12}, {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+	{0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11}, {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+	{0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6}, {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+	{0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8}, {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+	{0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7}, {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+	{0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7}, {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+	{0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7}, {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+	{0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13}, {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+	{0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5}, {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+	{0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7}, {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+	{0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5}, {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+	{0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15}, {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+	{0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20}, {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+	{0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23}, {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+	{0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23}, {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+	{0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23}, {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+	{0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22}, {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+	{0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24}, {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+	{0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21}, {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+	{0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22}, {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+	{0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19}, {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+	{0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27}, {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+	{0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27}, {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+	{0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+	{0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21}, {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+	{0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25}, {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+	{0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26}, {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+	{0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27}, {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+};
+
+#define HTTP2_HUFFMAN_EOS 256
+
+// A binary tree of the Huffman codes
+class HuffmanTree
+{
+public:
+	struct Node
+	{
+		// 0 means no child (the root cannot be a child)
+		int16_t children[2] = {0, 0};
+		// -1 if it is not a leaf
+		int16_t symbol = -1;
+	};
+
+	HuffmanTree()
+	{
+		_nodes.reserve(HTTP2_HUFFMAN_EOS * 2);
+		_nodes.emplace_back();
+
+		for (int symbol = 0; symbol < 256; symbol++)
+		{
+			Add(symbol, g_huffman_codes[symbol].code, g_huffman_codes[symbol].length);
+		}
+
+		Add(HTTP2_HUFFMAN_EOS, 0x3fffffff, 30);
+	}
+
+	const Node &GetNode(int16_t index) const
+	{
+		return _nodes[index];
+	}
+
+protected:
+	void Add(int symbol, uint32_t code, int length)
+	{
+		int16_t index = 0;
+
+		for (int bit_index = length - 1; bit_index >= 0; bit_index--)
+		{
+			int bit = (code >> bit_index) & 0x01;
+
+			if (_nodes[index].children[bit] == 0)
+			{
+				_nodes[index].children[bit] = static_cast<int16_t>(_nodes.size());
+				_nodes.emplace_back();
+			}
+
+			index = _nodes[index].children[bit];
+		}
+
+		_nodes[index].symbol = static_cast<int16_t>(symbol);
+	}
+
+	std::vector<Node> _nodes;
+};
+
+namespace Http2Hpack
+{
+	bool DecodeInteger(const uint8_t *&position, const uint8_t *end, int prefix_bits, uint64_t *value)
+	{
+		if (position >= end)
+		{
+			return false;
+		}
+
+		uint64_t max_prefix = (1 << prefix_bits) - 1;
+		uint64_t result = *position & max_prefix;
+
+		position++;
+
+		if (result == max_prefix)
+		{
+			int shift = 0;
+
+			while (true)
+			{
+				if ((position >= end) || (shift > 56))
+				{
+					// Not enough data, or too large
+					return false;
+				}
+
+				uint8_t byte = *position;
+				position++;
+
+				result += static_cast<uint64_t>(byte & 0x7F) << shift;
+				shift += 7;
+
+				if ((byte & 0x80) == 0)
+				{
+					break;
+				}
+			}
+		}
+
+		*value = result;
+
+		return true;
+	}
+
+	void EncodeInteger(uint64_t value, int prefix_bits, uint8_t first_byte_flags, ov::Data *block)
+	{
+		uint64_t max_prefix = (1 << prefix_bits) - 1;
+
+		if (value < max_prefix)
+		{
+			uint8_t byte = static_cast<uint8_t>(first_byte_flags | value);
+			block->Append(&byte, 1);
+			return;
+		}
+
+		uint8_t bytes[16];
+		size_t count = 0;
+
+		bytes[count++] = static_cast<uint8_t>(first_byte_flags | max_prefix);
+		value -= max_prefix;
+
+		while (value >= 0x80)
+		{
+			bytes[count++] = static_cast<uint8_t>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+
+		bytes[count++] = static_cast<uint8_t>(value);
+
+		block->Append(bytes, count);
+	}
+
+	bool DecodeString(const uint8_t *&position, const uint8_t *end, ov::String *string)
+	{
+		if (position >= end)
+		{
+			return false;
+		}
+
+		bool is_huffman = (*position & 0x80) != 0;
+		uint64_t length;
+
+		if ((DecodeInteger(position, end, 7, &length) == false) || (length > static_cast<uint64_t>(end - position)))
+		{
+			return false;
+		}
+
+		bool result = true;
+
+		if (is_huffman)
+		{
+			result = DecodeHuffman(position, length, string);
+		}
+		else
+		{
+			string->Clear();
+			string->Append(reinterpret_cast<const char *>(position), length);
+		}
+
+		position += length;
+
+		return result;
+	}
+
+	bool DecodeHuffman(const uint8_t *data, size_t length, ov::String *string)
+	{
+		static const HuffmanTree tree;
+
+		string->Clear();
+
+		int16_t index = 0;
+		// To validate the padding
+		int bits_after_symbol = 0;
+		bool is_padding_all_ones = true;
+
+		for (size_t offset = 0; offset < length; offset++)
+		{
+			uint8_t byte = data[offset];
+
+			for (int bit_index = 7; bit_index >= 0; bit_index--)
+			{
+				int bit = (byte >> bit_index) & 0x01;
+
+				index = tree.GetNode(index).children[bit];
+
+				if (index == 0)
+				{
+					// Invalid code
+					return false;
+				}
+
+				bits_after_symbol++;
+				is_padding_all_ones = is_padding_all_ones && (bit == 1);
+
+				auto symbol = tree.GetNode(index).symbol;
+
+				if (symbol >= 0)
+				{
+					if (symbol == HTTP2_HUFFMAN_EOS)
+					{
+						// RFC7541 - 5.2. A Huffman-encoded string literal containing the EOS symbol MUST be treated as a decoding error
+						return false;
+					}
+
+					char character = static_cast<char>(symbol);
+					string->Append(&character, 1);
+
+					index = 0;
+					bits_after_symbol = 0;
+					is_padding_all_ones = true;
+				}
+			}
+		}
+
+		// RFC7541 - 5.2. Padding strictly longer than 7 bits MUST be treated as a decoding error, and it must be the most significant bits of the EOS
+		return (bits_after_symbol <= 7) && is_padding_all_ones;
+	}
+}  // namespace Http2Hpack
+
+Http2HpackDecoder::Http2HpackDecoder(size_t max_table_size)
+	: _max_table_size(max_table_size),
+	  _table_size_limit(max_table_size)
+{
+}
+
+bool Http2HpackDecoder::GetEntry(size_t index, ov::String *name, ov::String *value) const
+{
+	if (index == 0)
+	{
+		return false;
+	}
+
+	if (index <= HTTP2_HPACK_STATIC_TABLE_COUNT)
+	{
+		auto &entry = g_static_table[index - 1];
+
+		*name = entry.name;
+		*value = entry.value;
+
+		return true;
+	}
+
+	index -= (HTTP2_HPACK_STATIC_TABLE_COUNT + 1);
+
+	if (index >= _dynamic_table.size())
+	{
+		return false;
+	}
+
+	auto &entry = _dynamic_table[index];
+
+	*name = entry.name;
+	*value = entry.value;
+
+	return true;
+}
+
+void Http2HpackDecoder::AddEntry(const ov::String &name, const ov::String &value)
+{
+	size_t entry_size = name.GetLength() + value.GetLength() + HTTP2_HPACK_ENTRY_OVERHEAD;
+
+	if (entry_size > _table_size_limit)
+	{
+		// RFC7541 - 4.4. An attempt to add an entry larger than the maximum size causes the table to be emptied
+		_dynamic_table.clear();
+		_table_size = 0;
+		return;
+	}
+
+	_dynamic_table.push_front({name, value});
+	_table_size += entry_size;
+
+	Evict();
+}
+
+void Http2HpackDecoder::Evict()
+{
+	while ((_table_size > _table_size_limit) && (_dynamic_table.empty() == false))
+	{
+		auto &entry = _dynamic_table.back();
+
+		_table_size -= (entry.name.GetLength() + entry.value.GetLength() + HTTP2_HPACK_ENTRY_OVERHEAD);
+		_dynamic_table.pop_back();
+	}
+}
+
+bool Http2HpackDecoder::Decode(const uint8_t *block, size_t length, Http2HeaderList *headers)
+{
+	const uint8_t *position = block;
+	const uint8_t *end = block + length;
+
+	while (position < end)
+	{
+		uint8_t byte = *position;
+		uint64_t index;
+		ov::String name;
+		ov::String value;
+
+		if (byte & 0x80)
+		{
+			// RFC7541 - 6.1. Indexed Header Field Representation
+			if ((Http2Hpack::DecodeInteger(position, end, 7, &index) == false) || (GetEntry(index, &name, &value) == false))
+			{
+				logtd("Invalid index of the indexed header field");
+				return false;
+			}
+
+			headers->emplace_back(name, value);
+			continue;
+		}
+
+		if ((byte & 0xE0) == 0x20)
+		{
+			// RFC7541 - 6.3. Dynamic Table Size Update
+			uint64_t table_size;
+
+			if ((Http2Hpack::DecodeInteger(position, end, 5, &table_size) == false) || (table_size > _max_table_size))
+			{
+				logtd("Invalid dynamic table size update");
+				return false;
+			}
+
+			_table_size_limit = table_size;
+			Evict();
+
+			continue;
+		}
+
+		// RFC7541 - 6.2.1. Literal Header Field with Incremental Indexing (01xxxxxx)
+		// RFC7541 - 6.2.2. Literal Header Field without Indexing (0000xxxx)
+		// RFC7541 - 6.2.3. Literal Header Field Never Indexed (0001xxxx)
+		bool need_to_index = ((byte & 0xC0) == 0x40);
+
+		if (Http2Hpack::DecodeInteger(position, end, need_to_index ? 6 : 4, &index) == false)
+		{
+			return false;
+		}
+
+		if (index == 0)
+		{
+			if (Http2Hpack::DecodeString(position, end, &name) == false)
+			{
+				logtd("Invalid name of the literal header field");
+				return false;
+			}
+		}
+		else if (GetEntry(index, &name, &value) == false)
+		{
+			logtd("Invalid index of the literal header field");
+			return false;
+		}
+
+		if (Http2Hpack::DecodeString(position, end, &value) == false)
+		{
+			logtd("Invalid value of the literal header field");
+			return false;
+		}
+
+		if (need_to_index)
+		{
+			AddEntry(name, value);
+		}
+
+		headers->emplace_back(name, value);
+	}
+
+	return true;
+}
+
+void Http2HpackEncoder::Encode(const ov::String &name, const ov::String &value, ov::Data *block)
+{
+	size_t name_index = 0;
+
+	for (size_t index = 0; index < HTTP2_HPACK_STATIC_TABLE_COUNT; index++)
+	{
+		auto &entry = g_static_table[index];
+
+		if (name == entry.name)
+		{
+			if (value == entry.value)
+			{
+				// RFC7541 - 6.1. Indexed Header Field Representation
+				Http2Hpack::EncodeInteger(index + 1, 7, 0x80, block);
+				return;
+			}
+
+			if (name_index == 0)
+			{
+				name_index = index + 1;
+			}
+		}
+	}
+
+	// RFC7541 - 6.2.2. Literal Header Field without Indexing (the strings are not Huffman encoded)
+	Http2Hpack::EncodeInteger(name_index, 4, 0x00, block);
+
+	if (name_index == 0)
+	{
+		Http2Hpack::EncodeInteger(name.GetLength(), 7, 0x00, block);
+		block->Append(name.CStr(), name.GetLength());
+	}
+
+	Http2Hpack::EncodeInteger(value.GetLength(), 7, 0x00, block);
+	block->Append(value.CStr(), value.GetLength());
+}
+
+void Http2HpackEncoder::Encode(const Http2HeaderList &headers, ov::Data *block)
+{
+	for (auto &header : headers)
+	{
+		Encode(header.first, header.second, block);
+	}
+}
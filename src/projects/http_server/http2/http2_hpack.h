@@ -0,0 +1,73 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+// RFC7541 - HPACK: Header Compression for HTTP/2 (https://tools.ietf.org/html/rfc7541)
+
+// The default of SETTINGS_HEADER_TABLE_SIZE
+#define HTTP2_HPACK_DEFAULT_TABLE_SIZE 4096
+
+using Http2HeaderList = std::vector<std::pair<ov::String, ov::String>>;
+
+class Http2HpackDecoder
+{
+public:
+	// max_table_size: SETTINGS_HEADER_TABLE_SIZE advertised to the peer
+	explicit Http2HpackDecoder(size_t max_table_size = HTTP2_HPACK_DEFAULT_TABLE_SIZE);
+
+	// Decodes a header block (the fragments of HEADERS + CONTINUATION must be concatenated)
+	// Returns false if the block is malformed (it is a COMPRESSION_ERROR of the connection)
+	bool Decode(const uint8_t *block, size_t length, Http2HeaderList *headers);
+
+protected:
+	struct Entry
+	{
+		ov::String name;
+		ov::String value;
+	};
+
+	bool GetEntry(size_t index, ov::String *name, ov::String *value) const;
+	void AddEntry(const ov::String &name, const ov::String &value);
+	void Evict();
+
+	size_t _max_table_size;
+	size_t _table_size_limit;
+	size_t _table_size = 0;
+
+	// The newest entry is at the front (index 62)
+	std::deque<Entry> _dynamic_table;
+};
+
+// Encodes the headers without the dynamic table, so the encoder has no state and can be used by several streams at the same time
+class Http2HpackEncoder
+{
+public:
+	// The names must be lowercase
+	static void Encode(const Http2HeaderList &headers, ov::Data *block);
+	static void Encode(const ov::String &name, const ov::String &value, ov::Data *block);
+};
+
+namespace Http2Hpack
+{
+	// RFC7541 - 5.1. Integer Representation
+	bool DecodeInteger(const uint8_t *&position, const uint8_t *end, int prefix_bits, uint64_t *value);
+	void EncodeInteger(uint64_t value, int prefix_bits, uint8_t first_byte_flags, ov::Data *block);
+
+	// RFC7541 - 5.2. String Literal Representation
+	bool DecodeString(const uint8_t *&position, const uint8_t *end, ov::String *string);
+
+	// RFC7541 - Appendix B. Huffman Code
+	bool DecodeHuffman(const uint8_t *data, size_t length, ov::String *string);
+}  // namespace Http2Hpack
@@ -0,0 +1,134 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "http2_response.h"
+#include "http2_connection.h"
+
+#include "../http_private.h"
+
+Http2Response::Http2Response(const std::shared_ptr<ov::ClientSocket> &client_socket, const std::shared_ptr<Http2Connection> &connection, uint32_t stream_id)
+	: HttpResponse(client_socket),
+	  _connection(connection),
+	  _stream_id(stream_id)
+{
+}
+
+bool Http2Response::SendFrames(const ov::DataChain &chain, bool end_stream)
+{
+	auto connection = _connection.lock();
+
+	if (connection == nullptr)
+	{
+		return false;
+	}
+
+	if (_is_header_sent)
+	{
+		return connection->SendData(_stream_id, chain, end_stream);
+	}
+
+	// RFC7540 - 8.1.2.4. Response Pseudo-Header Fields
+	Http2HeaderList headers;
+
+	headers.emplace_back(":status", ov::Converter::ToString(static_cast<int>(_status_code)));
+
+	for (const auto &pair : _response_header)
+	{
+		auto name = pair.first.LowerCaseString();
+
+		// RFC7540 - 8.1.2.2. Connection-Specific Header Fields
+		if ((name == "connection") || (name == "keep-alive") || (name == "proxy-connection") ||
+			(name == "transfer-encoding") || (name == "upgrade") || (name == "content-length"))
+		{
+			continue;
+		}
+
+		headers.emplace_back(name, pair.second);
+	}
+
+	if (_chunked_transfer == false)
+	{
+		headers.emplace_back("content-length", ov::Converter::ToString(_response_data.GetLength()));
+	}
+
+	_is_header_sent = true;
+
+	return connection->SendHeaders(_stream_id, headers, chain, end_stream);
+}
+
+bool Http2Response::Send(const std::shared_ptr<const ov::Data> &data)
+{
+	if (data == nullptr)
+	{
+		OV_ASSERT2(data != nullptr);
+		return false;
+	}
+
+	return Send(ov::DataChain{data});
+}
+
+bool Http2Response::Send(const ov::DataChain &chain)
+{
+	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
+
+	return SendFrames(chain, false);
+}
+
+bool Http2Response::SendChunkedData(const std::shared_ptr<const ov::Data> &chunk_header, const std::shared_ptr<const ov::Data> &data)
+{
+	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
+
+	if ((data == nullptr) || data->IsEmpty())
+	{
+		// The last chunk
+		return SendFrames(ov::DataChain(), true);
+	}
+
+	return SendFrames(ov::DataChain{data}, false);
+}
+
+uint32_t Http2Response::SendResponse()
+{
+	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
+
+	// A response with the content length is completed at once
+	bool end_stream = (_chunked_transfer == false);
+	uint32_t sent_bytes = 0;
+
+	if (SendFrames(_response_data, end_stream))
+	{
+		sent_bytes = _response_data.GetLength();
+	}
+
+	_response_data.Clear();
+
+	return sent_bytes;
+}
+
+bool Http2Response::Close()
+{
+	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
+
+	auto connection = _connection.lock();
+
+	if (connection == nullptr)
+	{
+		return false;
+	}
+
+	if (_is_header_sent == false)
+	{
+		// The response is aborted
+		return connection->ResetStream(_stream_id, Http2ErrorCode::Cancel);
+	}
+
+	// If the stream is already ended, it does nothing
+	connection->EndStream(_stream_id);
+
+	return true;
+}
@@ -0,0 +1,45 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "../http_response.h"
+
+class Http2Connection;
+
+// The response of a HTTP/2 stream
+// - The header is sent as a HEADERS frame, and the data are sent as DATA frames through the connection
+// - Close() ends (or resets) the stream instead of closing the socket
+class Http2Response : public HttpResponse
+{
+public:
+	Http2Response(const std::shared_ptr<ov::ClientSocket> &client_socket, const std::shared_ptr<Http2Connection> &connection, uint32_t stream_id);
+	~Http2Response() override = default;
+
+	uint32_t GetStreamId() const
+	{
+		return _stream_id;
+	}
+
+	bool Send(const std::shared_ptr<const ov::Data> &data) override;
+	bool Send(const ov::DataChain &chain) override;
+
+	// HTTP/2 doesn't use the chunked transfer coding, so the chunk is sent as a DATA frame
+	bool SendChunkedData(const std::shared_ptr<const ov::Data> &chunk_header, const std::shared_ptr<const ov::Data> &data) override;
+
+	bool Close() override;
+
+protected:
+	uint32_t SendResponse() override;
+
+	// Sends the data as DATA frames (HEADERS frame is sent together if it is not sent)
+	bool SendFrames(const ov::DataChain &chain, bool end_stream);
+
+	std::weak_ptr<Http2Connection> _connection;
+	uint32_t _stream_id;
+};
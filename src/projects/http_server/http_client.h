@@ -8,11 +8,13 @@
 //==============================================================================
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include "http_request.h"
 #include "http_response.h"
 
 class HttpServer;
+class Http2Connection;
 
 // HttpClient: Contains HttpRequest & HttpResponse
 // HttpRequest: Contains request informations (Request HTTP Header & Body)
@@ -22,6 +24,7 @@ class HttpClient
 {
 public:
 	friend class HttpServer;
+	friend class HttpsServer;
 
 	HttpClient(const std::shared_ptr<HttpServer> &server, std::shared_ptr<HttpRequest> &http_request, std::shared_ptr<HttpResponse> &http_response);
 	virtual ~HttpClient() = default;
@@ -37,4 +40,14 @@ protected:
 
 	std::shared_ptr<HttpRequest> _request = nullptr;
 	std::shared_ptr<HttpResponse> _response = nullptr;
+
+	// Used by HttpServer
+	bool _is_data_received = false;
+	// If the client uses HTTP/2, the requests are processed by the connection (each stream has its own HttpClient)
+	std::shared_ptr<Http2Connection> _http2_connection = nullptr;
+
+	// Used by HttpsServer to process the data of the client in order while the handshake runs on the handshake executor
+	std::shared_ptr<ov::Strand> _tls_strand = nullptr;
+	// The number of the data posted to _tls_strand that are not processed yet
+	std::atomic<int> _pending_tls_data_count{0};
 };
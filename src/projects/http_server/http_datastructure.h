@@ -115,6 +115,7 @@ inline HttpMethod operator|(HttpMethod lhs, HttpMethod rhs)
 // | 415  | Unsupported Media Type        | Section 6.5.13           |
 // | 416  | Range Not Satisfiable         | Section 4.4 of [RFC7233] |
 // | 417  | Expectation Failed            | Section 6.5.14           |
+// | 425  | Too Early                     | Section 5.2 of [RFC8470] |
 // | 426  | Upgrade Required              | Section 6.5.15           |
 // | 500  | Internal Server Error         | Section 6.6.1            |
 // | 501  | Not Implemented               | Section 6.6.2            |
@@ -159,6 +160,7 @@ enum class HttpStatusCode : uint16_t
 	UnsupportedMediaType = 415,
 	RangeNotSatisfiable = 416,
 	ExpectationFailed = 417,
+	TooEarly = 425,
 	UpgradeRequired = 426,
 	InternalServerError = 500,
 	NotImplemented = 501,
@@ -210,6 +212,7 @@ inline constexpr const char *StringFromHttpStatusCode(HttpStatusCode status_code
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::UnsupportedMediaType, "Unsupported Media Type");
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::RangeNotSatisfiable, "Range Not Satisfiable");
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::ExpectationFailed, "Expectation Failed");
+		HTTP_GET_STATUS_TEXT(HttpStatusCode::TooEarly, "Too Early");
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::UpgradeRequired, "Upgrade Required");
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::InternalServerError, "Internal Server Error");
 		HTTP_GET_STATUS_TEXT(HttpStatusCode::NotImplemented, "Not Implemented");
@@ -10,6 +10,8 @@
 #include "http_client.h"
 #include "http_private.h"
 
+#include <strings.h>
+
 #include <algorithm>
 
 HttpRequest::HttpRequest(const std::shared_ptr<ov::ClientSocket> &client_socket, const std::shared_ptr<HttpRequestInterceptor> &interceptor)
@@ -48,78 +50,154 @@ ssize_t HttpRequest::ProcessData(const std::shared_ptr<const ov::Data> &data)
 		return 0L;
 	}
 
-	const char NewLines[] = "\r\n\r\n";
-	// Exclude null character
-	const int NewLinesLength = OV_COUNTOF(NewLines) - 1;
+	auto buffer = data->GetDataAs<char>();
+	size_t length = data->GetLength();
+	size_t index = 0;
+
+	// Find "\r\n\r\n" in the new data only.
+	// The characters of it found at the end of the previous data are kept in _header_end_state.
+	for (; (index < length) && (_header_end_state < 4); index++)
+	{
+		char character = buffer[index];
+
+		switch (character)
+		{
+			case '\r':
+				_header_end_state = (_header_end_state == 2) ? 3 : 1;
+				break;
 
-	ssize_t used_length = data->GetLength();
+			case '\n':
+				_header_end_state = ((_header_end_state == 1) || (_header_end_state == 3)) ? (_header_end_state + 1) : 0;
+				break;
 
-	// Since the header has not been parsed yet, try to parse the header every time data comes in
-	ssize_t previous_length = _request_string.GetLength();
+			default:
+				// Control characters other than the white spaces are not allowed in the header
+				// (obs-text (0x80 ~ 0xFF) is allowed)
+				if (((static_cast<uint8_t>(character) < 0x20) && (::isspace(character) == false)) || (character == 0x7F))
+				{
+					// Binary data found
+					_parse_status = HttpStatusCode::BadRequest;
+					return -1L;
+				}
+
+				_header_end_state = 0;
+				break;
+		}
+	}
 
 	// ov::String is binary-safe
-	_request_string.Append(data->GetDataAs<char>(), data->GetLength());
-	ssize_t newline_position = _request_string.IndexOf(&(NewLines[0]));
+	_request_string.Append(buffer, index);
+
+	if (_header_end_state < 4)
+	{
+		// Need more data
+		return static_cast<ssize_t>(length);
+	}
 
-	if (newline_position >= 0)
+	// The header is found, and the rest of the data is the body (or the next request)
+	_is_header_found = true;
+	_parse_status = ParseMessage();
+
+	if (_parse_status == HttpStatusCode::OK)
 	{
-		// If the parser find "\r\n\r\n", start parsing
-		_request_string.SetLength(newline_position);
+		// Calculate some informations such as Content length
+		PostProcess();
+
+		return static_cast<ssize_t>(index);
+	}
+
+	// An error occurred during parsing
+	_parse_status = HttpStatusCode::BadRequest;
+
+	return -1L;
+}
+
+HttpStatusCode HttpRequest::SetHttp2Request(const Http2HeaderList &headers)
+{
+	InitParseInfo();
+
+	_is_header_found = true;
+	_http_version = "HTTP/2.0";
+	_parse_status = HttpStatusCode::BadRequest;
+
+	ov::String method;
+	ov::String authority;
+	std::vector<std::pair<ov::String, ov::String>> fields;
+
+	for (const auto &header : headers)
+	{
+		auto &name = header.first;
+		auto &value = header.second;
+
+		// RFC7540 - 8.1.2.3. Request Pseudo-Header Fields
+		if (name.HasPrefix(":"))
+		{
+			if (name == ":method")
+			{
+				method = value;
+			}
+			else if (name == ":path")
+			{
+				_request_target = value;
+			}
+			else if (name == ":authority")
+			{
+				authority = value;
+			}
+			else if (name != ":scheme")
+			{
+				logtw("Unknown pseudo-header field: %s", name.CStr());
+				return _parse_status;
+			}
 
-		// Used length =
-		//             [Length of string after finding "\r\n\r\n"] -
-		//             [Length of string before finding] +
-		//             [Length of string "\r\n\r\n"]
-		used_length = _request_string.GetLength() - previous_length + NewLinesLength;
+			continue;
+		}
 
-		_is_header_found = true;
-		_parse_status = ParseMessage();
+		// The names of HTTP/2 are lowercase, so the duplicated fields can be found by comparing them
+		auto item = std::find_if(fields.begin(), fields.end(), [&name](const auto &field) -> bool {
+			return field.first == name;
+		});
 
-		if (_parse_status == HttpStatusCode::OK)
+		if (item == fields.end())
 		{
-			// Calculate some informations such as Content length
-			PostProcess();
+			fields.emplace_back(name, value);
 		}
 		else
 		{
-			// An error occurred during parsing
-			used_length = -1L;
-			_parse_status = HttpStatusCode::BadRequest;
+			// RFC7540 - 8.1.2.5. Compressing the Cookie Header Field
+			item->second.Append((name == "cookie") ? "; " : ", ");
+			item->second.Append(value);
 		}
 	}
-	else
+
+	if (method.IsEmpty() || _request_target.IsEmpty())
 	{
-		// Need more data
+		logtw("Mandatory pseudo-header fields are missing");
+		return _parse_status;
+	}
 
-		// Check if data consists of non-binary data
-		auto data_to_check = data->GetDataAs<char>();
-		auto remained = data->GetLength();
+	for (const auto &field : fields)
+	{
+		AppendHeader(field.first, field.second);
+	}
 
-		while (remained > 0)
-		{
-			char character = *data_to_check;
+	if ((authority.IsEmpty() == false) && (IsHeaderExists("Host") == false))
+	{
+		// :authority is used instead of Host header
+		AppendHeader("host", authority);
+	}
 
-			// isprint(): 32 <= character <= 126
-			// isspace(): 9 <= character <= 13
-			// reference: https://en.cppreference.com/w/cpp/string/byte/isprint
-			if (::isprint(character) || ::isspace(character))
-			{
-				character++;
-				remained--;
+	_http_version_number = 2.0;
+	_parse_status = ParseMethod(std::string_view(method.CStr(), method.GetLength()));
 
-				continue;
-			}
-			else
-			{
-				// Binary data found
-				used_length = -1;
-				_parse_status = HttpStatusCode::BadRequest;
-				break;
-			}
-		}
+	logtd("Method: [%s], uri: [%s], version: [%s]", method.CStr(), _request_target.CStr(), _http_version.CStr());
+
+	if (_parse_status == HttpStatusCode::OK)
+	{
+		PostProcess();
 	}
 
-	return used_length;
+	return _parse_status;
 }
 
 HttpStatusCode HttpRequest::ParseMessage()
@@ -133,32 +211,38 @@ HttpStatusCode HttpRequest::ParseMessage()
 	// RFC7230 - 3.1. Start Line
 	// start-line     = request-line / status-line
 
-	// Tokenize by "\r\n"
-	std::vector<ov::String> tokens = _request_string.Split("\r\n");
-
-	HttpStatusCode status_code;
+	// _request_string ends with "\r\n\r\n", so every line ends with "\r\n"
+	std::string_view message(_request_string.CStr(), _request_string.GetLength());
 
-	status_code = ParseRequestLine(tokens[0]);
-	tokens.erase(tokens.begin());
+	size_t line_end = message.find("\r\n");
+	HttpStatusCode status_code = ParseRequestLine(message.substr(0, line_end));
+	size_t position = line_end + 2;
 
-	if (status_code == HttpStatusCode::OK)
+	while (status_code == HttpStatusCode::OK)
 	{
-		for (const ov::String &token : tokens)
-		{
-			status_code = ParseHeader(token);
+		line_end = message.find("\r\n", position);
 
-			if (status_code != HttpStatusCode::OK)
-			{
-				break;
-			}
+		if ((line_end == std::string_view::npos) || (line_end == position))
+		{
+			// The empty line at the end of the header
+			break;
 		}
+
+		status_code = ParseHeader(message.substr(position, line_end - position));
+		position = line_end + 2;
 	}
 
-	logtd("Request Headers: %ld:", _request_header.size());
+	logtd("Request Headers: %zu:", _request_headers.size());
 
-	std::for_each(_request_header.begin(), _request_header.end(), [](const auto &pair) -> void {
-		logtd("\t>> %s: %s", pair.first.CStr(), pair.second.CStr());
-	});
+#if DEBUG
+	for (const auto &field : _request_headers)
+	{
+		auto name = GetHeaderName(field);
+		auto value = GetHeaderValue(field);
+
+		logtd("\t>> %.*s: %.*s", static_cast<int>(name.size()), name.data(), static_cast<int>(value.size()), value.data());
+	}
+#endif	// DEBUG
 
 	return status_code;
 }
@@ -169,24 +253,10 @@ HttpStatusCode HttpRequest::ParseMessage()
 		_method = value_if_matches;                 \
 	}
 
-HttpStatusCode HttpRequest::ParseRequestLine(const ov::String &line)
+HttpStatusCode HttpRequest::ParseMethod(const std::string_view &method)
 {
-	// RFC7230 - 3.1.1. Request Line
-	// request-line   = method SP request-target SP HTTP-version CRLF
-	ssize_t first_space_index = line.IndexOf(' ');
-	ssize_t last_space_index = line.IndexOfRev(' ');
-
-	if ((first_space_index < 0) || (last_space_index < 0) || (first_space_index == last_space_index))
-	{
-		logtw("Invalid space index: first: %d, last: %d, line: %s", first_space_index, last_space_index, line.CStr());
-		return HttpStatusCode::BadRequest;
-	}
-
 	_method = HttpMethod::Unknown;
 
-	// RFC7231 - 4. Request Methods
-	ov::String method = line.Left(static_cast<size_t>(first_space_index));
-
 	HTTP_COMPARE_METHOD("GET", HttpMethod::Get);
 	HTTP_COMPARE_METHOD("HEAD", HttpMethod::Head);
 	HTTP_COMPARE_METHOD("POST", HttpMethod::Post);
@@ -198,27 +268,64 @@ HttpStatusCode HttpRequest::ParseRequestLine(const ov::String &line)
 
 	if (_method == HttpMethod::Unknown)
 	{
-		logtw("Unknown method: %s", method.CStr());
+		logtw("Unknown method: %.*s", static_cast<int>(method.size()), method.data());
 		return HttpStatusCode::MethodNotAllowed;
 	}
 
+	return HttpStatusCode::OK;
+}
+
+HttpStatusCode HttpRequest::ParseRequestLine(const std::string_view &line)
+{
+	// RFC7230 - 3.1.1. Request Line
+	// request-line   = method SP request-target SP HTTP-version CRLF
+	size_t first_space_index = line.find(' ');
+	size_t last_space_index = line.rfind(' ');
+
+	if ((first_space_index == std::string_view::npos) || (first_space_index == last_space_index))
+	{
+		logtw("Invalid space index: first: %zd, last: %zd, line: %.*s",
+			  static_cast<ssize_t>(first_space_index), static_cast<ssize_t>(last_space_index),
+			  static_cast<int>(line.size()), line.data());
+		return HttpStatusCode::BadRequest;
+	}
+
+	// RFC7231 - 4. Request Methods
+	auto method = line.substr(0, first_space_index);
+	auto status_code = ParseMethod(method);
+
+	if (status_code != HttpStatusCode::OK)
+	{
+		return status_code;
+	}
+
 	// RFC7230 - 5.3. Request Target
 	// request-target = origin-form
 	//            / absolute-form
 	//            / authority-form
 	//            / asterisk-form
-	_request_target = line.Substring(first_space_index + 1, static_cast<size_t>(last_space_index - first_space_index - 1));
+	auto request_target = line.substr(first_space_index + 1, last_space_index - first_space_index - 1);
+	_request_target = ov::String(request_target.data(), request_target.size());
 
 	// RFC7230 - 2.6. Protocol Versioning
 	// HTTP-version  = HTTP-name "/" DIGIT "." DIGIT
 	// HTTP-name     = %x48.54.54.50 ; "HTTP", case-sensitive
-	_http_version = line.Substring(last_space_index + 1);
+	auto http_version = line.substr(last_space_index + 1);
+	_http_version = ov::String(http_version.data(), http_version.size());
+	ParseHttpVersion();
 
-	logtd("Method: [%s], uri: [%s], version: [%s]", method.CStr(), _request_target.CStr(), _http_version.CStr());
+	logtd("Method: [%.*s], uri: [%s], version: [%s]", static_cast<int>(method.size()), method.data(), _request_target.CStr(), _http_version.CStr());
 	return HttpStatusCode::OK;
 }
 
-HttpStatusCode HttpRequest::ParseHeader(const ov::String &line)
+void HttpRequest::ParseHttpVersion()
+{
+	ssize_t slash_index = _http_version.IndexOf('/');
+
+	_http_version_number = (slash_index >= 0) ? ::strtod(_http_version.CStr() + slash_index + 1, nullptr) : 0.0;
+}
+
+HttpStatusCode HttpRequest::ParseHeader(const std::string_view &line)
 {
 	// RFC7230 - 3.2.  Header Fields
 	// header-field   = field-name ":" OWS field-value OWS
@@ -244,24 +351,70 @@ HttpStatusCode HttpRequest::ParseHeader(const ov::String &line)
 	// the obs-fold rule) unless the message is intended for packaging
 	// within the message/http media type.
 
-	ssize_t colon_index = line.IndexOf(':');
+	size_t colon_index = line.find(':');
 
-	if (colon_index == -1)
+	if (colon_index == std::string_view::npos)
 	{
-		logtw("Invalid header (could not find colon): %s", line.CStr());
+		logtw("Invalid header (could not find colon): %.*s", static_cast<int>(line.size()), line.data());
 		return HttpStatusCode::BadRequest;
 	}
 
-	// Convert all header names to uppercase
-	ov::String field_name = line.Left(static_cast<size_t>(colon_index)).UpperCaseString();
 	// Eliminate OWS(optional white space) to simplify processing
-	ov::String field_value = line.Substring(colon_index + 1).Trim();
+	size_t value_start = colon_index + 1;
+	size_t value_end = line.size();
+
+	while ((value_start < value_end) && ((line[value_start] == ' ') || (line[value_start] == '\t')))
+	{
+		value_start++;
+	}
+
+	while ((value_end > value_start) && ((line[value_end - 1] == ' ') || (line[value_end - 1] == '\t')))
+	{
+		value_end--;
+	}
 
-	_request_header[field_name] = field_value;
+	auto line_offset = static_cast<uint32_t>(line.data() - _request_string.CStr());
+
+	_request_headers.push_back({line_offset, static_cast<uint32_t>(colon_index),
+								line_offset + static_cast<uint32_t>(value_start), static_cast<uint32_t>(value_end - value_start)});
 
 	return HttpStatusCode::OK;
 }
 
+void HttpRequest::AppendHeader(const ov::String &name, const ov::String &value)
+{
+	HeaderField field;
+
+	field.name_offset = static_cast<uint32_t>(_request_string.GetLength());
+	field.name_length = static_cast<uint32_t>(name.GetLength());
+	field.value_offset = field.name_offset + field.name_length + 2;
+	field.value_length = static_cast<uint32_t>(value.GetLength());
+
+	_request_string.Append(name.CStr(), name.GetLength());
+	_request_string.Append(": ");
+	_request_string.Append(value.CStr(), value.GetLength());
+	_request_string.Append("\r\n");
+
+	_request_headers.push_back(field);
+}
+
+const HttpRequest::HeaderField *HttpRequest::FindHeader(const ov::String &key) const noexcept
+{
+	size_t key_length = key.GetLength();
+
+	// The last one is used if the header is duplicated
+	for (auto field = _request_headers.rbegin(); field != _request_headers.rend(); ++field)
+	{
+		if ((field->name_length == key_length) &&
+			(::strncasecmp(_request_string.CStr() + field->name_offset, key.CStr(), key_length) == 0))
+		{
+			return &(*field);
+		}
+	}
+
+	return nullptr;
+}
+
 ov::String HttpRequest::GetHeader(const ov::String &key) const noexcept
 {
 	return GetHeader(key, "");
@@ -269,19 +422,32 @@ ov::String HttpRequest::GetHeader(const ov::String &key) const noexcept
 
 ov::String HttpRequest::GetHeader(const ov::String &key, ov::String default_value) const noexcept
 {
-	auto item = _request_header.find(key.UpperCaseString());
+	auto field = FindHeader(key);
 
-	if (item == _request_header.cend())
+	if (field == nullptr)
 	{
 		return std::move(default_value);
 	}
 
-	return item->second;
+	auto value = GetHeaderValue(*field);
+
+	return ov::String(value.data(), value.size());
+}
+
+bool HttpRequest::IsKeepAliveRequest() const noexcept
+{
+	if (GetHttpVersionAsNumber() >= 2.0)
+	{
+		return false;
+	}
+
+	return (GetHttpVersionAsNumber() > 1.0 && GetHeader("Connection", "keep-alive") == "keep-alive") ||
+		   (GetHttpVersionAsNumber() <= 1.0 && GetHeader("Connection", "close") == "keep-alive");
 }
 
 const bool HttpRequest::IsHeaderExists(const ov::String &key) const noexcept
 {
-	return _request_header.find(key.UpperCaseString()) != _request_header.cend();
+	return FindHeader(key) != nullptr;
 }
 
 void HttpRequest::PostProcess()
@@ -8,6 +8,8 @@
 //==============================================================================
 #pragma once
 #include <base/ovlibrary/converter.h>
+#include <string_view>
+#include "http2/http2_hpack.h"
 #include "http_datastructure.h"
 #include "interceptors/http_request_interceptor.h"
 
@@ -34,6 +36,11 @@ public:
 	/// @return HTTP 파싱에 사용한 데이터 크기. 만약 파싱 도중 오류가 발생하면 -1L을 반환함
 	ssize_t ProcessData(const std::shared_ptr<const ov::Data> &data);
 
+	/// Initializes the request with the headers of a HTTP/2 stream (the pseudo-header fields are included)
+	///
+	/// @return HttpStatusCode::OK if the request is valid (ParseStatus() is also set to the value)
+	HttpStatusCode SetHttp2Request(const Http2HeaderList &headers);
+
 	/// 헤더 파싱 상태 (ProcessData() 안에서 갱신됨)
 	///
 	/// @return HttpStatusCode::PartialContent = 데이터가 더 필요함.
@@ -54,16 +61,10 @@ public:
 		return _http_version;
 	}
 
+	// The version is parsed once with the request line
 	double GetHttpVersionAsNumber() const noexcept
 	{
-		auto tokens = _http_version.Split("/");
-
-		if (tokens.size() != 2)
-		{
-			return 0.0;
-		}
-
-		return ov::Converter::ToDouble(tokens[1]);
+		return _http_version_number;
 	}
 
 	// Full URI (including domain and port)
@@ -93,15 +94,21 @@ public:
 		return _request_body;
 	}
 
-	const std::map<ov::String, ov::String, ov::CaseInsensitiveComparator> &GetRequestHeader() const noexcept
+	size_t GetHeaderCount() const noexcept
 	{
-		return _request_header;
+		return _request_headers.size();
 	}
 
 	ov::String GetHeader(const ov::String &key) const noexcept;
 	ov::String GetHeader(const ov::String &key, ov::String default_value) const noexcept;
 	const bool IsHeaderExists(const ov::String &key) const noexcept;
 
+	// Whether the client wants to send the next request through this connection
+	// - http1.0 Connection default : close
+	// - http1.1 Connection default : keep-alive
+	// - http2 : The requests are sent through the streams, so the response of the stream is always completed by Close()
+	bool IsKeepAliveRequest() const noexcept;
+
 	bool SetRequestInterceptor(const std::shared_ptr<HttpRequestInterceptor> &interceptor) noexcept
 	{
 		_interceptor = interceptor;
@@ -136,12 +143,17 @@ public:
 		_parse_status = HttpStatusCode::PartialContent;
 
 		_is_header_found = false;
+		_header_end_state = 0;
+		// Keep the allocated buffers to reuse them for the next request of the connection
 		_request_string = "";
-		_request_header.clear();
+		_request_headers.clear();
 
 		_method = HttpMethod::Unknown;
 		_request_target = "";
 		_http_version = "";
+		_http_version_number = 0.0;
+
+		_request_body = nullptr;
 	}
 
 protected:
@@ -156,9 +168,37 @@ protected:
 		return _request_body;
 	}
 
+	// A header field of the request
+	// - The name and the value are stored as the ranges of _request_string,
+	//   so the fields are parsed without allocating a string for each of them
+	struct HeaderField
+	{
+		uint32_t name_offset;
+		uint32_t name_length;
+		uint32_t value_offset;
+		uint32_t value_length;
+	};
+
 	HttpStatusCode ParseMessage();
-	HttpStatusCode ParseRequestLine(const ov::String &line);
-	HttpStatusCode ParseHeader(const ov::String &line);
+	HttpStatusCode ParseMethod(const std::string_view &method);
+	HttpStatusCode ParseRequestLine(const std::string_view &line);
+	HttpStatusCode ParseHeader(const std::string_view &line);
+	void ParseHttpVersion();
+
+	// Appends "<name>: <value>\r\n" to _request_string, and adds the field
+	void AppendHeader(const ov::String &name, const ov::String &value);
+	// The headers are searched case-insensitively, and the last one is returned if the name is duplicated
+	const HeaderField *FindHeader(const ov::String &key) const noexcept;
+
+	std::string_view GetHeaderName(const HeaderField &field) const noexcept
+	{
+		return std::string_view(_request_string.CStr() + field.name_offset, field.name_length);
+	}
+
+	std::string_view GetHeaderValue(const HeaderField &field) const noexcept
+	{
+		return std::string_view(_request_string.CStr() + field.value_offset, field.value_length);
+	}
 
 	void PostProcess();
 
@@ -175,12 +215,17 @@ protected:
 	ov::String _request_uri;
 	ov::String _request_target;
 	ov::String _http_version;
+	double _http_version_number = 0.0;
 
 	// request 헤더
 	bool _is_header_found = false;
+	// The number of the characters of "\r\n\r\n" found at the end of _request_string
+	// (kept between ProcessData() calls, so the received data is scanned only once)
+	int _header_end_state = 0;
 	// 헤더 영역을 추출해내기 위해 임시로 사용되는 문자열 버퍼
 	ov::String _request_string;
-	std::map<ov::String, ov::String, ov::CaseInsensitiveComparator> _request_header;
+	// A few headers are sent in a request, so a linear search of a flat table is faster than a map
+	std::vector<HeaderField> _request_headers;
 
 	// 자주 사용하는 헤더 값은 미리 저장해놓음
 	ssize_t _content_length = 0L;
@@ -14,6 +14,7 @@
 #include <memory>
 #include <utility>
 
+#include <base/ovlibrary/probe.h>
 #include <base/ovsocket/ovsocket.h>
 
 HttpResponse::HttpResponse(const std::shared_ptr<ov::ClientSocket> &client_socket)
@@ -76,8 +77,7 @@ bool HttpResponse::AppendData(const std::shared_ptr<const ov::Data> &data)
 
 	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
 
-	_response_data_list.push_back(data);
-	_response_data_size += data->GetLength();
+	_response_data.Append(data);
 
 	return true;
 }
@@ -99,24 +99,18 @@ uint32_t HttpResponse::Response()
 {
 	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
 
-	return SendHeaderIfNeeded() + SendResponse();
+	return SendResponse();
 }
 
-uint32_t HttpResponse::SendHeaderIfNeeded()
+std::shared_ptr<ov::Data> HttpResponse::MakeHeader()
 {
-	if (_is_header_sent)
-	{
-		// The headers are already sent
-		return 0;
-	}
-
 	std::shared_ptr<ov::Data> response = std::make_shared<ov::Data>();
 	ov::ByteStream stream(response.get());
 
 	if (_chunked_transfer == false)
 	{
 		// Calculate the content length
-		SetHeader("Content-Length", ov::Converter::ToString(_response_data_size));
+		SetHeader("Content-Length", ov::Converter::ToString(_response_data.GetLength()));
 	}
 
 	// RFC7230 - 3.1.2.  Status Line
@@ -134,16 +128,7 @@ uint32_t HttpResponse::SendHeaderIfNeeded()
 
 	stream.Append("\r\n", 2);
 
-	if (Send(response))
-	{
-		logtd("Header is sent:\n%s", response->Dump(response->GetLength()).CStr());
-
-		_is_header_sent = true;
-
-		return response->GetLength();
-	}
-
-	return 0;
+	return response;
 }
 
 bool HttpResponse::Send(const void *data, size_t length)
@@ -161,7 +146,7 @@ bool HttpResponse::Send(const std::shared_ptr<const ov::Data> &data)
 
 	std::shared_ptr<const ov::Data> send_data;
 
-	if (_tls_data == nullptr)
+	if ((_tls_data == nullptr) || _tls_data->IsOffloadedToKernel())
 	{
 		send_data = data;
 	}
@@ -182,6 +167,40 @@ bool HttpResponse::Send(const std::shared_ptr<const ov::Data> &data)
 	return (_client_socket->Send(send_data) == static_cast<ssize_t>(send_data->GetLength()));
 }
 
+bool HttpResponse::Send(const ov::DataChain &chain)
+{
+	if ((_tls_data == nullptr) || _tls_data->IsOffloadedToKernel())
+	{
+		// The data backed by a file (such as the segments in the SegmentStorage) are sent using sendfile()
+		// (The kernel encrypts them if kTLS is used)
+		return (_client_socket->Send(chain) == static_cast<ssize_t>(chain.GetLength()));
+	}
+
+	std::shared_ptr<const ov::Data> send_data;
+
+	if (_tls_data->Encrypt(chain, &send_data) == false)
+	{
+		return false;
+	}
+
+	if ((send_data == nullptr) || send_data->IsEmpty())
+	{
+		// There is no data to send
+		return true;
+	}
+
+	return (_client_socket->Send(send_data) == static_cast<ssize_t>(send_data->GetLength()));
+}
+
+std::shared_ptr<const ov::Data> HttpResponse::MakeChunkHeader(size_t length)
+{
+	// 16 hex digits + CRLF
+	char chunk_header[24];
+	auto header_length = ov::String::FormatTo(chunk_header, "%zx\r\n", length);
+
+	return std::make_shared<ov::Data>(chunk_header, header_length);
+}
+
 bool HttpResponse::SendChunkedData(const void *data, size_t length)
 {
 	return SendChunkedData(std::make_shared<ov::Data>(data, length));
@@ -191,58 +210,92 @@ bool HttpResponse::SendChunkedData(const std::shared_ptr<const ov::Data> &data)
 {
 	if ((data == nullptr) || data->IsEmpty())
 	{
-		// Send a empty chunk
-		return Send("0\r\n\r\n", 5);
+		return SendChunkedData(nullptr, nullptr);
 	}
 
-	bool result =
-		// Send the chunk header
-		Send(ov::String::FormatString("%x\r\n", data->GetLength()).ToData(false)) &&
-		// Send the chunk payload
-		Send(data) &&
-		// Send a last data of chunk
-		Send("\r\n", 2);
+	return SendChunkedData(MakeChunkHeader(data->GetLength()), data);
+}
+
+bool HttpResponse::SendChunkedData(const std::shared_ptr<const ov::Data> &chunk_header, const std::shared_ptr<const ov::Data> &data)
+{
+	static const auto last_chunk = std::make_shared<const ov::Data>("0\r\n\r\n", 5);
+	static const auto chunk_trailer = std::make_shared<const ov::Data>("\r\n", 2);
 
-	return result;
+	if ((data == nullptr) || data->IsEmpty())
+	{
+		// Send a empty chunk
+		return Send(last_chunk);
+	}
+
+	// Chunk header + payload + CRLF with a single write
+	return Send(ov::DataChain{chunk_header, data, chunk_trailer});
 }
 
 uint32_t HttpResponse::SendResponse()
 {
-	bool sent = true;
+	static const auto chunk_trailer = std::make_shared<const ov::Data>("\r\n", 2);
 
 	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
 
-	logtd("Trying to send datas...");
+	// The header and the queued data are sent with a single write
+	ov::DataChain chain;
+	size_t header_length = 0;
+
+	if (_is_header_sent == false)
+	{
+		auto header = MakeHeader();
+
+		logtd("Header is sent:\n%s", header->Dump(header->GetLength()).CStr());
+
+		header_length = header->GetLength();
+		chain.Append(header);
+	}
+
+	bool is_chunk = _chunked_transfer && (_response_data.IsEmpty() == false);
+
+	if (is_chunk)
+	{
+		// The queued data are sent as one chunk
+		chain.Append(MakeChunkHeader(_response_data.GetLength()));
+	}
+
+	chain.Append(_response_data);
+
+	if (is_chunk)
+	{
+		chain.Append(chunk_trailer);
+	}
 
 	uint32_t sent_bytes = 0;
-	for (const auto &data : _response_data_list)
+
+	if (chain.IsEmpty() || Send(chain))
 	{
-		if (_chunked_transfer)
-		{
-			sent &= SendChunkedData(data);
-			if (sent == true)
-			{
-				sent_bytes += data->GetLength();
-			}
-		}
-		else
-		{
-			sent &= Send(data);
-			if (sent == true)
-			{
-				sent_bytes += data->GetLength();
-			}
-		}
+		_is_header_sent = true;
+		sent_bytes = header_length + _response_data.GetLength();
 	}
 
-	_response_data_list.clear();
-	_response_data_size = 0ULL;
+	OV_PROBE2(http_response, static_cast<int>(_status_code), sent_bytes);
 
-	logtd("All datas are sent...");
+	_response_data.Clear();
 
 	return sent_bytes;
 }
 
+void HttpResponse::InitResponseInfo()
+{
+	std::lock_guard<decltype(_response_mutex)> lock(_response_mutex);
+
+	_status_code = HttpStatusCode::OK;
+	_reason = StringFromHttpStatusCode(HttpStatusCode::OK);
+
+	_is_header_sent = false;
+	_response_header.clear();
+
+	_response_data.Clear();
+
+	_chunked_transfer = false;
+}
+
 bool HttpResponse::Close()
 {
 	OV_ASSERT2(_client_socket != nullptr);
@@ -57,7 +57,7 @@ public:
 	bool SetHeader(const ov::String &key, const ov::String &value);
 	const ov::String &GetHeader(const ov::String &key);
 
-	// Enqueue the data into the queue (This data will be sent when SendResponse() is called)
+	// Enqueue the data into the queue (This data will be sent when Response() is called)
 	// Can be used for response with content-length
 	bool AppendData(const std::shared_ptr<const ov::Data> &data);
 	bool AppendString(const ov::String &string);
@@ -72,13 +72,23 @@ public:
 	}
 	virtual bool Send(const void *data, size_t length);
 	virtual bool Send(const std::shared_ptr<const ov::Data> &data);
+	// Sends the slices with one socket call (scatter-gather), or as the full-sized TLS records if TLS is used
+	virtual bool Send(const ov::DataChain &chain);
+
+	// Makes "<length in hex>\r\n" of a chunk, which can be shared by the responses that send the same chunk
+	static std::shared_ptr<const ov::Data> MakeChunkHeader(size_t length);
 
 	bool SendChunkedData(const void *data, size_t length);
 	bool SendChunkedData(const std::shared_ptr<const ov::Data> &data);
+	// chunk_header must be made by MakeChunkHeader(data->GetLength())
+	virtual bool SendChunkedData(const std::shared_ptr<const ov::Data> &chunk_header, const std::shared_ptr<const ov::Data> &data);
 
 	uint32_t Response();
 
-	bool Close();
+	virtual bool Close();
+
+	// Prepares to send the next response through the same connection (keep-alive)
+	void InitResponseInfo();
 
 	void SetKeepAlive()
 	{
@@ -97,8 +107,9 @@ public:
 	}
 
 protected:
-	uint32_t SendHeaderIfNeeded();
-	uint32_t SendResponse();
+	std::shared_ptr<ov::Data> MakeHeader();
+	// Sends the header (if not sent) and the queued data
+	virtual uint32_t SendResponse();
 
 	std::shared_ptr<ov::ClientSocket> _client_socket;
 	std::shared_ptr<ov::TlsData> _tls_data;
@@ -114,8 +125,8 @@ protected:
 
 	// FIXME(dimiden): It is supposed to be synchronized whenever a packet is sent, but performance needs to be improved
 	std::recursive_mutex _response_mutex;
-	size_t _response_data_size = 0;
-	std::vector<std::shared_ptr<const ov::Data>> _response_data_list;
+	// The data queued by AppendData() (not copied)
+	ov::DataChain _response_data;
 
 	ov::String _default_value = "";
 
@@ -12,13 +12,15 @@
 
 #include "http_private.h"
 
+static std::atomic<bool> g_is_http2_enabled(false);
+
 HttpServer::~HttpServer()
 {
 	// PhysicalPort should be stopped before release HttpServer
 	OV_ASSERT2(_physical_port == nullptr);
 }
 
-bool HttpServer::Start(const ov::SocketAddress &address)
+bool HttpServer::Start(const ov::SocketAddress &address, int reactor_count, int worker_count, bool worker_affinity)
 {
 	if (_physical_port != nullptr)
 	{
@@ -26,16 +28,34 @@ bool HttpServer::Start(const ov::SocketAddress &address)
 		return false;
 	}
 
-	_physical_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Tcp, address);
+	_physical_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Tcp, address, reactor_count, worker_count, worker_affinity);
 
 	if (_physical_port != nullptr)
 	{
+		// The clients of HTTP send the request first, so the connections are accepted with it
+		int defer_accept = ov::ServerSocket::GetAcceptOptions().defer_accept;
+
+		if ((defer_accept > 0) && (_physical_port->SetDeferAccept(defer_accept) == false))
+		{
+			logtw("Could not set TCP_DEFER_ACCEPT to %s", address.ToString().CStr());
+		}
+
 		return _physical_port->AddObserver(this);
 	}
 
 	return _physical_port != nullptr;
 }
 
+bool HttpServer::SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options)
+{
+	if (_physical_port == nullptr)
+	{
+		return false;
+	}
+
+	return _physical_port->SetLowLatencyOptions(options);
+}
+
 bool HttpServer::Stop()
 {
 	//TODO(Dimiden): Check possibility that _physical_port can be deleted from other http publisher.
@@ -47,13 +67,18 @@ bool HttpServer::Stop()
 	}
 
 	// client들 정리
-	_client_list_mutex.lock();
-	auto client_list = std::move(_client_list);
-	_client_list_mutex.unlock();
-
-	for (auto &client : client_list)
+	for (auto &shard : _client_shards)
 	{
-		client.second->GetResponse()->Close();
+		shard.mutex.lock();
+		auto client_list = std::move(shard.client_list);
+		shard.mutex.unlock();
+
+		for (auto &client : client_list)
+		{
+			// Break the reference cycle (HttpClient -> HttpRequest -> Socket -> HttpClient)
+			client.first->SetUserData(nullptr);
+			client.second->GetResponse()->Close();
+		}
 	}
 
 	_interceptor_list.clear();
@@ -61,6 +86,16 @@ bool HttpServer::Stop()
 	return true;
 }
 
+void HttpServer::SetHttp2Enabled(bool enabled)
+{
+	g_is_http2_enabled = enabled;
+}
+
+bool HttpServer::IsHttp2Enabled()
+{
+	return g_is_http2_enabled;
+}
+
 ssize_t HttpServer::TryParseHeader(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data)
 {
 	auto request = client->GetRequest();
@@ -90,13 +125,28 @@ ssize_t HttpServer::TryParseHeader(const std::shared_ptr<HttpClient> &client, co
 	return processed_length;
 }
 
+HttpServer::ClientShard &HttpServer::GetClientShard(const ov::Socket *remote)
+{
+	// The lower bits of the address are always the same because of the alignment
+	return _client_shards[(reinterpret_cast<uintptr_t>(remote) >> 6) % _client_shards.size()];
+}
+
 std::shared_ptr<HttpClient> HttpServer::FindClient(const std::shared_ptr<ov::Socket> &remote)
 {
-	std::shared_lock<std::shared_mutex> guard(_client_list_mutex);
+	auto client = remote->GetUserDataAs<HttpClient>();
+
+	if ((client != nullptr) && (client->_server.get() == this))
+	{
+		return client;
+	}
 
-	auto item = _client_list.find(remote.get());
+	// The physical port (and the socket) can be shared by several servers
+	auto &shard = GetClientShard(remote.get());
+	std::shared_lock<std::shared_mutex> guard(shard.mutex);
 
-	if (item != _client_list.end())
+	auto item = shard.client_list.find(remote.get());
+
+	if (item != shard.client_list.end())
 	{
 		return item->second;
 	}
@@ -104,22 +154,96 @@ std::shared_ptr<HttpClient> HttpServer::FindClient(const std::shared_ptr<ov::Soc
 	return nullptr;
 }
 
+bool HttpServer::IsTooEarly(const std::shared_ptr<HttpRequest> &request)
+{
+	auto tls_data = request->GetTlsData();
+
+	if ((tls_data == nullptr) || (tls_data->IsEarlyData() == false))
+	{
+		return false;
+	}
+
+	return (request->GetMethod() != HttpMethod::Get) && (request->GetMethod() != HttpMethod::Head);
+}
+
+std::shared_ptr<HttpRequestInterceptor> HttpServer::FindInterceptor(const std::shared_ptr<HttpClient> &client)
+{
+	auto request = client->GetRequest();
+
+	{
+		std::shared_lock<std::shared_mutex> guard(_interceptor_list_mutex);
+
+		for (auto &interceptor : _interceptor_list)
+		{
+			if (interceptor->IsInterceptorForRequest(client))
+			{
+				request->SetRequestInterceptor(interceptor);
+				break;
+			}
+		}
+	}
+
+	return request->GetRequestInterceptor();
+}
+
+bool HttpServer::ProcessHttp2Preface(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data)
+{
+	if (client->_is_data_received || data->IsEmpty())
+	{
+		return false;
+	}
+
+	client->_is_data_received = true;
+
+	if (IsHttp2Enabled() == false)
+	{
+		return false;
+	}
+
+	// The first 3 bytes ("PRI") are enough to distinguish the preface from the HTTP/1.x requests
+	// (The rest of the preface is verified by Http2Connection)
+	if ((data->GetLength() < 3) || (::memcmp(data->GetData(), HTTP2_CONNECTION_PREFACE, 3) != 0))
+	{
+		return false;
+	}
+
+	auto remote = client->GetRequest()->GetRemote();
+
+	logti("Client(%s) uses HTTP/2", remote->GetRemoteAddress()->ToString().CStr());
+
+	client->_http2_connection = std::make_shared<Http2Connection>(this, client);
+
+	if (client->_http2_connection->Start() == false)
+	{
+		logtw("Could not send HTTP/2 SETTINGS to the client(%s)", remote->GetRemoteAddress()->ToString().CStr());
+	}
+
+	return true;
+}
+
 void HttpServer::ProcessData(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data)
 {
 	if (client != nullptr)
 	{
+		if ((client->_http2_connection != nullptr) || ProcessHttp2Preface(client, data))
+		{
+			if (client->_http2_connection->ProcessData(data) == false)
+			{
+				client->GetResponse()->Close();
+			}
+
+			return;
+		}
+
 		std::shared_ptr<HttpRequest> request = client->GetRequest();
 		std::shared_ptr<HttpResponse> response = client->GetResponse();
 
 		bool need_to_disconnect = false;
 
 		// header parse (temp)
-		// - http1.0 Connection default : close
-		// - http1.1 Connection default : keep-alive
 		if (request->ParseStatus() == HttpStatusCode::OK && request->GetRequestInterceptor() != nullptr)
 		{
-			if ((request->GetHttpVersionAsNumber() > 1.0 && request->GetHeader("Connection", "keep-alive") == "keep-alive") ||
-				(request->GetHttpVersionAsNumber() <= 1.0 && request->GetHeader("Connection", "close") == "keep-alive"))
+			if (request->IsKeepAliveRequest())
 			{
 				request->InitParseInfo();
 			}
@@ -150,25 +274,19 @@ void HttpServer::ProcessData(const std::shared_ptr<HttpClient> &client, const st
 
 				if (processed_length >= 0)
 				{
-					if (request->ParseStatus() == HttpStatusCode::OK)
+					if ((request->ParseStatus() == HttpStatusCode::OK) && IsTooEarly(request))
+					{
+						logtd("Client(%s) sent %s in the early data", request->GetRemote()->GetRemoteAddress()->ToString().CStr(), request->GetUri().CStr());
+
+						response->SetStatusCode(HttpStatusCode::TooEarly);
+						need_to_disconnect = true;
+					}
+					else if (request->ParseStatus() == HttpStatusCode::OK)
 					{
 						// Parsing is completed
 
 						// Find interceptor for the request
-						{
-							std::shared_lock<std::shared_mutex> guard(_interceptor_list_mutex);
-
-							for (auto &interceptor : _interceptor_list)
-							{
-								if (interceptor->IsInterceptorForRequest(client))
-								{
-									request->SetRequestInterceptor(interceptor);
-									break;
-								}
-							}
-						}
-
-						auto interceptor = request->GetRequestInterceptor();
+						auto interceptor = FindInterceptor(client);
 
 						if (interceptor == nullptr)
 						{
@@ -242,11 +360,20 @@ std::shared_ptr<HttpClient> HttpServer::ProcessConnect(const std::shared_ptr<ov:
 		response->SetHeader("Content-Type", "text/html");
 	}
 
-	std::lock_guard<std::shared_mutex> guard(_client_list_mutex);
-
 	auto http_client = std::make_shared<HttpClient>(GetSharedPtr(), request, response);
 
-	_client_list[remote.get()] = http_client;
+	{
+		auto &shard = GetClientShard(remote.get());
+		std::lock_guard<std::shared_mutex> guard(shard.mutex);
+
+		shard.client_list[remote.get()] = http_client;
+	}
+
+	// The first server that accepts the socket owns the slot
+	if (remote->GetUserDataAs<HttpClient>() == nullptr)
+	{
+		remote->SetUserData(http_client);
+	}
 
 	return std::move(http_client);
 }
@@ -271,13 +398,29 @@ void HttpServer::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const
 
 void HttpServer::OnDisconnected(const std::shared_ptr<ov::Socket> &remote, PhysicalPortDisconnectReason reason, const std::shared_ptr<const ov::Error> &error)
 {
-	std::lock_guard<std::shared_mutex> guard(_client_list_mutex);
+	std::shared_ptr<HttpClient> client;
+
+	{
+		auto &shard = GetClientShard(remote.get());
+		std::lock_guard<std::shared_mutex> guard(shard.mutex);
 
-	auto client_iterator = _client_list.find(remote.get());
+		auto client_iterator = shard.client_list.find(remote.get());
+
+		if (client_iterator != shard.client_list.end())
+		{
+			client = std::move(client_iterator->second);
+			shard.client_list.erase(client_iterator);
+		}
+	}
 
-	if (client_iterator != _client_list.end())
+	if (client != nullptr)
 	{
-		auto &client = client_iterator->second;
+		if (remote->GetUserDataAs<HttpClient>() == client)
+		{
+			// Break the reference cycle (HttpClient -> HttpRequest -> Socket -> HttpClient)
+			remote->SetUserData(nullptr);
+		}
+
 		auto request = client->GetRequest();
 		auto response = client->GetResponse();
 
@@ -292,6 +435,12 @@ void HttpServer::OnDisconnected(const std::shared_ptr<ov::Socket> &remote, Physi
 				  remote->GetRemoteAddress()->ToString().CStr(), _physical_port->GetAddress().ToString().CStr(), response->GetStatusCode());
 		}
 
+		if (client->_http2_connection != nullptr)
+		{
+			// Close the streams of the connection
+			client->_http2_connection->Close();
+		}
+
 		auto interceptor = request->GetRequestInterceptor();
 
 		if (interceptor != nullptr)
@@ -302,8 +451,6 @@ void HttpServer::OnDisconnected(const std::shared_ptr<ov::Socket> &remote, Physi
 		{
 			logtw("Interceptor does not exists for HTTP client %p", client.get());
 		}
-
-		_client_list.erase(client_iterator);
 	}
 	else
 	{
@@ -354,13 +501,16 @@ bool HttpServer::RemoveInterceptor(const std::shared_ptr<HttpRequestInterceptor>
 
 ov::Socket *HttpServer::FindClient(ClientIterator iterator)
 {
-	std::shared_lock<std::shared_mutex> guard(_client_list_mutex);
-
-	for (auto &client : _client_list)
+	for (auto &shard : _client_shards)
 	{
-		if (iterator(client.second))
+		std::shared_lock<std::shared_mutex> guard(shard.mutex);
+
+		for (auto &client : shard.client_list)
 		{
-			return client.first;
+			if (iterator(client.second))
+			{
+				return client.first;
+			}
 		}
 	}
 
@@ -371,10 +521,11 @@ bool HttpServer::DisconnectIf(ClientIterator iterator)
 {
 	std::vector<std::shared_ptr<HttpClient>> temp_list;
 
+	for (auto &shard : _client_shards)
 	{
-		std::shared_lock<std::shared_mutex> guard(_client_list_mutex);
+		std::shared_lock<std::shared_mutex> guard(shard.mutex);
 
-		for (auto client_iterator : _client_list)
+		for (auto &client_iterator : shard.client_list)
 		{
 			auto &client = client_iterator.second;
 
@@ -382,7 +533,7 @@ bool HttpServer::DisconnectIf(ClientIterator iterator)
 			{
 				temp_list.push_back(client);
 			}
-		};
+		}
 	}
 
 	for (auto client_iterator : temp_list)
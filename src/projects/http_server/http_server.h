@@ -11,25 +11,34 @@
 #include "http_request.h"
 #include "http_response.h"
 #include "http_client.h"
+#include "http2/http2_connection.h"
 #include "interceptors/default/http_default_interceptor.h"
 
 #include <modules/physical_port/physical_port.h>
+#include <array>
 #include <shared_mutex>
 // 참고 자료
 // RFC7230 - Hypertext Transfer Protocol (HTTP/1.1): Message Syntax and Routing (https://tools.ietf.org/html/rfc7230)
 // RFC7231 - Hypertext Transfer Protocol (HTTP/1.1): Semantics and Content (https://tools.ietf.org/html/rfc7231)
 // RFC7232 - Hypertext Transfer Protocol (HTTP/1.1): Conditional Requests (https://tools.ietf.org/html/rfc7232)
 
+// The client list is split into the shards, so the connections/disconnections of the clients rarely wait for each other
+#define HTTP_SERVER_CLIENT_SHARD_COUNT 16
+
 class HttpServer : protected PhysicalPortObserver, public ov::EnableSharedFromThis<HttpServer>
 {
 public:
+	friend class Http2Connection;
+
 	using ClientList = std::map<ov::Socket *, std::shared_ptr<HttpClient>>;
 	using ClientIterator = std::function<bool(const std::shared_ptr<HttpClient> &client)>;
 
 	HttpServer() = default;
 	~HttpServer() override;
 
-	virtual bool Start(const ov::SocketAddress &address);
+	// reactor_count, worker_count, worker_affinity: See PhysicalPort::Create()
+	virtual bool Start(const ov::SocketAddress &address, int reactor_count = 1,
+					   int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT, bool worker_affinity = false);
 	virtual bool Stop();
 
 	bool AddInterceptor(const std::shared_ptr<HttpRequestInterceptor> &interceptor);
@@ -41,14 +50,32 @@ public:
 	// If the iterator returns true, the client will be disconnected
 	bool DisconnectIf(ClientIterator iterator);
 
+	// HTTP/2 is used if the client sends the connection preface (prior knowledge), or negotiates "h2" using ALPN of TLS
+	static void SetHttp2Enabled(bool enabled);
+	static bool IsHttp2Enabled();
+
+	// Bounds the time the responses wait in the send queues of the clients (See ov::TcpLowLatencyOptions)
+	// Must be called after Start()
+	bool SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options);
+
 protected:
 	// @return 파싱이 성공적으로 되었다면 true를, 데이터가 더 필요하거나 오류가 발생하였다면 false이 반환됨
 	ssize_t TryParseHeader(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data);
 
+	// Returns the client attached to the socket (the shard is looked up only if the socket is shared with another server)
 	std::shared_ptr<HttpClient> FindClient(const std::shared_ptr<ov::Socket> &remote);
 
 	std::shared_ptr<HttpClient> ProcessConnect(const std::shared_ptr<ov::Socket> &remote);
 	void ProcessData(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data);
+	// @return true if the client starts HTTP/2 connection
+	bool ProcessHttp2Preface(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data);
+
+	// Whether the request is received in the early data of TLS 1.3 (0-RTT) with an unsafe method.
+	// The early data can be replayed, so it must be answered with 425 Too Early, then the client retries after the handshake (RFC 8470)
+	static bool IsTooEarly(const std::shared_ptr<HttpRequest> &request);
+
+	// Finds the interceptor for the request, and sets it to the request
+	std::shared_ptr<HttpRequestInterceptor> FindInterceptor(const std::shared_ptr<HttpClient> &client);
 
 	//--------------------------------------------------------------------
 	// Implementation of PhysicalPortObserver
@@ -60,8 +87,16 @@ protected:
 	// HttpServer와 연결된 physical port
 	std::shared_ptr<PhysicalPort> _physical_port = nullptr;
 
-	std::shared_mutex _client_list_mutex;
-	ClientList _client_list;
+	struct ClientShard
+	{
+		std::shared_mutex mutex;
+		ClientList client_list;
+	};
+
+	ClientShard &GetClientShard(const ov::Socket *remote);
+
+	// Used to look up the clients for FindClient()/DisconnectIf(), and to close them in Stop()
+	std::array<ClientShard, HTTP_SERVER_CLIENT_SHARD_COUNT> _client_shards;
 
 	std::shared_mutex _interceptor_list_mutex;
 	std::vector<std::shared_ptr<HttpRequestInterceptor>> _interceptor_list;
@@ -18,9 +18,68 @@
 // Backward compatibility
 #define HTTP_BACKWARD_COMPATIBILITY "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305:ECDHE-RSA-AES128-GCM-SHA256:ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES256-GCM-SHA384:ECDHE-ECDSA-AES256-GCM-SHA384:DHE-RSA-AES128-GCM-SHA256:DHE-DSS-AES128-GCM-SHA256:kEDH+AESGCM:ECDHE-RSA-AES128-SHA256:ECDHE-ECDSA-AES128-SHA256:ECDHE-RSA-AES128-SHA:ECDHE-ECDSA-AES128-SHA:ECDHE-RSA-AES256-SHA384:ECDHE-ECDSA-AES256-SHA384:ECDHE-RSA-AES256-SHA:ECDHE-ECDSA-AES256-SHA:DHE-RSA-AES128-SHA256:DHE-RSA-AES128-SHA:DHE-DSS-AES128-SHA256:DHE-RSA-AES256-SHA256:DHE-DSS-AES256-SHA:DHE-RSA-AES256-SHA:ECDHE-RSA-DES-CBC3-SHA:ECDHE-ECDSA-DES-CBC3-SHA:EDH-RSA-DES-CBC3-SHA:AES128-GCM-SHA256:AES256-GCM-SHA384:AES128-SHA256:AES256-SHA256:AES128-SHA:AES256-SHA:AES:DES-CBC3-SHA:HIGH:SEED:!aNULL:!eNULL:!EXPORT:!DES:!RC4:!MD5:!PSK:!RSAPSK:!aDH:!aECDH:!EDH-DSS-DES-CBC3-SHA:!KRB5-DES-CBC3-SHA:!SRP"
 
+// The sessions are resumed only by the contexts of the same ID
+#define HTTPS_SESSION_ID_CONTEXT "OvenMediaEngine"
+
+static std::atomic<long> g_session_cache_size(20480);
+static std::atomic<long> g_session_timeout(3600);
+static std::atomic<uint32_t> g_max_early_data(0);
+
+void HttpsServer::SetSessionCacheOptions(long cache_size, long timeout)
+{
+	g_session_cache_size = cache_size;
+	g_session_timeout = timeout;
+}
+
+void HttpsServer::SetEarlyDataOptions(uint32_t max_early_data)
+{
+	g_max_early_data = max_early_data;
+}
+
+ov::Executor *HttpsServer::GetHandshakeExecutor()
+{
+	static ov::Executor executor;
+
+	return &executor;
+}
+
 void HttpsServer::SetVirtualHostList(std::vector<std::shared_ptr<Orchestrator::VirtualHost>>& vhost_list)
 {
 	_virtual_host_list = vhost_list;
+	_tls_context = nullptr;
+
+	// TODO(Dimiden): OME doesn't support SNI yet, so we will use the first certificate for all requests until SNI development is complete.
+	if (_virtual_host_list.empty() || (_virtual_host_list[0]->host_info.GetCertificate() == nullptr))
+	{
+		return;
+	}
+
+	auto &host_info = _virtual_host_list[0]->host_info;
+	auto context = ov::TlsContext::Create(TLS_server_method(), host_info.GetCertificate(), host_info.GetChainCertificate(), HTTP_INTERMEDIATE_COMPATIBILITY, nullptr);
+
+	if (context == nullptr)
+	{
+		logte("Could not create the TLS context");
+		return;
+	}
+
+	if ((context->EnableSessionCache(HTTPS_SESSION_ID_CONTEXT, g_session_cache_size, g_session_timeout) == false) ||
+		(context->EnableSessionTickets() == false))
+	{
+		logtw("The TLS sessions will not be resumed");
+	}
+	else if ((g_max_early_data > 0) && (context->EnableEarlyData(g_max_early_data) == false))
+	{
+		logtw("The early data of TLS 1.3 will not be accepted");
+	}
+
+	// RFC7540 - 3.3. Starting HTTP/2 for "https" URIs
+	if (IsHttp2Enabled())
+	{
+		context->SetAlpnProtocols({"h2", "http/1.1"});
+	}
+
+	_tls_context = context;
 }
 
 void HttpsServer::OnConnected(const std::shared_ptr<ov::Socket> &remote)
@@ -29,23 +88,13 @@ void HttpsServer::OnConnected(const std::shared_ptr<ov::Socket> &remote)
 
 	if (client != nullptr)
 	{
-		// TODO(Dimiden): OME doesn't support SNI yet, so we will use the first certificate for all requests until SNI development is complete.
 		// When SNI works, you need to put a certificate by domain to TlsData
-		if(_virtual_host_list.size() == 0)
+		if (_tls_context == nullptr)
 		{
 			return;
 		}
 
-		auto vhost_info = _virtual_host_list[0];
-		if(vhost_info->host_info.GetCertificate() == nullptr)
-		{
-			return;
-		}
-
-		auto tls_data = std::make_shared<ov::TlsData>(
-			ov::TlsData::Method::TlsServerMethod,
-			vhost_info->host_info.GetCertificate(), vhost_info->host_info.GetChainCertificate(),
-			HTTP_INTERMEDIATE_COMPATIBILITY);
+		auto tls_data = std::make_shared<ov::TlsData>(_tls_context);
 
 		tls_data->SetWriteCallback([remote](const void *data, size_t length) -> ssize_t {
 			return remote->Send(data, length);
@@ -66,15 +115,69 @@ void HttpsServer::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, cons
 		return;
 	}
 
+	auto tls_data = client->GetRequest()->GetTlsData();
+	auto executor = GetHandshakeExecutor();
+
+	// The data of a client is received by one socket worker at a time, so only the handshake tasks run concurrently with this
+	if ((tls_data != nullptr) && executor->IsRunning() &&
+		((tls_data->GetState() == ov::TlsData::State::WaitingForAccept) || (client->_pending_tls_data_count > 0)))
+	{
+		if (client->_tls_strand == nullptr)
+		{
+			client->_tls_strand = std::make_shared<ov::Strand>(executor);
+		}
+
+		// The data that follows the handshake is also posted until the strand is drained, to keep the order
+		client->_pending_tls_data_count++;
+
+		if (client->_tls_strand->Post([this, remote, client, data]() {
+				ProcessTlsData(remote, client, data);
+				client->_pending_tls_data_count--;
+			}))
+		{
+			return;
+		}
+
+		client->_pending_tls_data_count--;
+	}
+
+	ProcessTlsData(remote, client, data);
+}
+
+void HttpsServer::ProcessTlsData(const std::shared_ptr<ov::Socket> &remote, const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data)
+{
 	auto request = client->GetRequest();
 	auto tls_data = request->GetTlsData();
 
 	if (tls_data != nullptr)
 	{
 		std::shared_ptr<const ov::Data> plain_data;
+		bool is_accepting = (tls_data->GetState() == ov::TlsData::State::WaitingForAccept);
 
 		if (tls_data->Decrypt(data, &plain_data))
 		{
+			if (is_accepting && (tls_data->GetState() == ov::TlsData::State::Accepted))
+			{
+				logtd("Client(%s) is accepted (session reused: %s)",
+					  remote->GetRemoteAddress()->ToString().CStr(), tls_data->IsSessionReused() ? "true" : "false");
+			}
+
+			if (ov::TlsData::IsKernelTlsEnabled() && (tls_data->GetState() == ov::TlsData::State::Accepted))
+			{
+				auto client_socket = std::dynamic_pointer_cast<ov::ClientSocket>(remote);
+
+				// The handshake records in the send queue must be sent before the kernel starts encrypting the data
+				if ((client_socket != nullptr) && (client_socket->GetSendQueueSize() == 0))
+				{
+					tls_data->OffloadToKernel(remote->GetId());
+				}
+			}
+
+			if (tls_data->IsEarlyData())
+			{
+				logtd("Client(%s) sent %zu bytes of the early data", remote->GetRemoteAddress()->ToString().CStr(), (plain_data != nullptr) ? plain_data->GetLength() : 0);
+			}
+
 			if ((plain_data != nullptr) && (plain_data->GetLength() > 0))
 			{
 				// plain_data is HTTP data
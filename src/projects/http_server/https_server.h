@@ -17,6 +17,17 @@ class HttpsServer : public HttpServer
 public:
 	void SetVirtualHostList(std::vector<std::shared_ptr<Orchestrator::VirtualHost>>& vhost_list);
 
+	// cache_size: the maximum number of the sessions in the server-side cache
+	// timeout: the lifetime of the sessions and the tickets (seconds)
+	// (Must be called before SetVirtualHostList())
+	static void SetSessionCacheOptions(long cache_size, long timeout);
+	// max_early_data: the maximum bytes of the early data of TLS 1.3 (0-RTT, 0: disabled)
+	// (Must be called before SetVirtualHostList())
+	static void SetEarlyDataOptions(uint32_t max_early_data);
+
+	// The full handshakes run on this executor if it is running, instead of the socket workers (See <Performance><TLSSession>)
+	static ov::Executor *GetHandshakeExecutor();
+
 protected:
 	//--------------------------------------------------------------------
 	// Implementation of PhysicalPortObserver
@@ -24,6 +35,12 @@ protected:
 	void OnConnected(const std::shared_ptr<ov::Socket> &remote) override;
 	void OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data) override;
 
+	// Decrypts the data (and accepts the TLS connection if needed), then processes the HTTP data
+	void ProcessTlsData(const std::shared_ptr<ov::Socket> &remote, const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Data> &data);
+
 protected:
 	std::vector<std::shared_ptr<Orchestrator::VirtualHost>> 	_virtual_host_list;
+
+	// Shared by all connections of this server, so the certificate is loaded once and the sessions can be resumed
+	std::shared_ptr<ov::TlsContext> _tls_context;
 };
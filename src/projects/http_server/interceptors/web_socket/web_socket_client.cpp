@@ -22,7 +22,7 @@ WebSocketClient::~WebSocketClient()
 {
 }
 
-ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &data, WebSocketFrameOpcode opcode)
+std::shared_ptr<const ov::Data> WebSocketClient::MakeFrameHeader(WebSocketFrameOpcode opcode, size_t length)
 {
 	// RFC6455 - 5.2.  Base Framing Protocol
 	//
@@ -34,8 +34,6 @@ ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &data, WebSo
 		.payload_length = 0,
 		.mask = false};
 
-	size_t length = (data == nullptr) ? 0LL : data->GetLength();
-
 	if (length < 0x7D)
 	{
 		// frame-payload-length    = ( %x00-7D )
@@ -57,31 +55,46 @@ ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &data, WebSo
 		header.payload_length = 127;
 	}
 
-	auto response = _client->GetResponse();
+	// The header and the extended payload length
+	auto frame_header = std::make_shared<ov::Data>(sizeof(header) + sizeof(uint64_t));
 
-	response->Send(&header);
+	frame_header->Append(&header, sizeof(header));
 
 	if (header.payload_length == 126)
 	{
 		auto payload_length = ov::HostToNetwork16(static_cast<uint16_t>(length));
 
-		response->Send(&payload_length);
+		frame_header->Append(&payload_length, sizeof(payload_length));
 	}
 	else if (header.payload_length == 127)
 	{
 		auto payload_length = ov::HostToNetwork64(static_cast<uint64_t>(length));
 
-		response->Send(&payload_length);
+		frame_header->Append(&payload_length, sizeof(payload_length));
 	}
 
+	return frame_header;
+}
+
+ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &frame_header, const std::shared_ptr<const ov::Data> &data)
+{
+	size_t length = (data == nullptr) ? 0LL : data->GetLength();
+	auto response = _client->GetResponse();
+
 	if (length > 0LL)
 	{
 		logtd("Trying to send data\n%s", data->Dump(32).CStr());
 
-		return response->Send(data) ? length : -1LL;
+		// The header and the payload with a single write
+		return response->Send(ov::DataChain{frame_header, data}) ? length : -1LL;
 	}
 
-	return length;
+	return response->Send(frame_header) ? length : -1LL;
+}
+
+ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &data, WebSocketFrameOpcode opcode)
+{
+	return Send(MakeFrameHeader(opcode, (data == nullptr) ? 0LL : data->GetLength()), data);
 }
 
 ssize_t WebSocketClient::Send(const std::shared_ptr<const ov::Data> &data)
@@ -99,6 +112,11 @@ ssize_t WebSocketClient::Send(const Json::Value &value)
 	return Send(ov::Json::Stringify(value));
 }
 
+ssize_t WebSocketClient::Send(const ov::JsonWriter &writer)
+{
+	return Send(writer.GetString());
+}
+
 void WebSocketClient::Close()
 {
 	_client->GetResponse()->Close();
@@ -22,10 +22,16 @@ public:
 	WebSocketClient(const std::shared_ptr<HttpClient> &client);
 	virtual ~WebSocketClient();
 
+	// Makes the header of a frame, which can be shared by the clients that receive the same message (broadcast)
+	static std::shared_ptr<const ov::Data> MakeFrameHeader(WebSocketFrameOpcode opcode, size_t length);
+
+	// frame_header must be made by MakeFrameHeader(opcode, data->GetLength())
+	ssize_t Send(const std::shared_ptr<const ov::Data> &frame_header, const std::shared_ptr<const ov::Data> &data);
 	ssize_t Send(const std::shared_ptr<const ov::Data> &data, WebSocketFrameOpcode opcode);
 	ssize_t Send(const std::shared_ptr<const ov::Data> &data);
 	ssize_t Send(const ov::String &string);
 	ssize_t Send(const Json::Value &value);
+	ssize_t Send(const ov::JsonWriter &writer);
 
 	const std::shared_ptr<HttpClient> &GetClient()
 	{
@@ -11,6 +11,12 @@
 
 #include <algorithm>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#	include <immintrin.h>
+#elif defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
 WebSocketFrame::WebSocketFrame()
 	: _remained_length(0L),
 	  _total_length(0L),
@@ -58,44 +64,47 @@ ssize_t WebSocketFrame::Process(const std::shared_ptr<const ov::Data> &data)
 
 	if(length > 0L)
 	{
-		// 잔여 데이터가 있다면 payload에 추가
-		if(_payload->Append(stream.GetRemainData()->GetData(), length) == false)
+		auto offset = stream.GetOffset();
+
+		if((_header.mask == false) && (_received_length == 0L) && (length == _total_length))
 		{
-			return -1L;
+			// The whole payload is in the data, so it is shared instead of copied
+			_payload = data->Subdata(offset, length);
+		}
+		else
+		{
+			if(_payload_buffer == nullptr)
+			{
+				_payload_buffer = std::make_shared<ov::Data>(_total_length);
+			}
+
+			auto buffer_offset = _payload_buffer->GetLength();
+
+			// 잔여 데이터가 있다면 payload에 추가
+			if(_payload_buffer->Append(data->GetDataAs<uint8_t>() + offset, length) == false)
+			{
+				return -1L;
+			}
+
+			if(_header.mask)
+			{
+				// Unmasks the appended bytes only (the key continues from the bytes received before)
+				auto appended = _payload_buffer->GetWritableDataAs<uint8_t>() + buffer_offset;
+				Unmask(appended, appended, length, _frame_masking_key, _received_length);
+			}
 		}
 	}
 
 	_remained_length -= length;
+	_received_length += length;
 
-	if(_payload->GetLength() == _total_length)
+	if(_received_length == _total_length)
 	{
 		OV_ASSERT2(_remained_length == 0L);
 
-		// masking 처리
-		if(_header.mask)
+		if(_payload == nullptr)
 		{
-			size_t payload_length = _payload->GetLength();
-
-			// 빠른 처리를 위해 8의 배수로 처리함 (mask가 있을 경우, 데이터 할당 시 이미 8의 배수로 할당해놓음)
-
-			// masking은 반드시 4byte여야 함
-			OV_ASSERT2(sizeof(_frame_masking_key) == 4);
-
-			uint64_t mask = static_cast<uint64_t>(_frame_masking_key) << (sizeof(_frame_masking_key) * 8) | static_cast<uint64_t>(_frame_masking_key);
-
-			// 8의 배수로 만듦
-			size_t count = ((payload_length + 7L) / 8L);
-			_payload->SetLength(static_cast<size_t>(count * 8L));
-
-			auto current = _payload->GetWritableDataAs<uint64_t>();
-
-			for(size_t index = 0; index < count; index++)
-			{
-				*current ^= mask;
-				current++;
-			}
-
-			_payload->SetLength(payload_length);
+			_payload = (_payload_buffer != nullptr) ? _payload_buffer : std::make_shared<ov::Data>();
 		}
 
 		logtd("The frame is finished: %s", ToString().CStr());
@@ -104,9 +113,9 @@ ssize_t WebSocketFrame::Process(const std::shared_ptr<const ov::Data> &data)
 		return header_length + length;
 	}
 
-	logtd("Data received: %ld / %ld (remained: %ld)", _payload->GetLength(), _total_length, _remained_length);
+	logtd("Data received: %ld / %ld (remained: %ld)", _received_length, _total_length, _remained_length);
 
-	OV_ASSERT(_payload->GetLength() <= _total_length, "Invalid payload length: payload length (%ld) must less equal than total length (%ld)", _payload->GetLength(), _total_length);
+	OV_ASSERT(_received_length <= _total_length, "Invalid payload length: payload length (%ld) must less equal than total length (%ld)", _received_length, _total_length);
 
 	return header_length + length;
 }
@@ -217,9 +226,10 @@ ssize_t WebSocketFrame::ProcessHeader(ov::ByteStream &stream)
 			_remained_length = _total_length;
 	}
 
-	// masking을 해야한다면, 나중에 속도 최적화를 위해 8의 배수로 masking을 처리하는데, 이 때 버퍼 재할당이 일어나지 않도록 8의 배수로 미리 맞춰놓음
-	ssize_t total_length = _header.mask ? (_total_length / 8L) * 8L : _total_length;
-	_payload = std::make_shared<ov::Data>(total_length);
+	// The payload buffer is allocated when the payload is received (it may not be needed)
+	_payload = nullptr;
+	_payload_buffer = nullptr;
+	_received_length = 0L;
 
 	if(_header.mask)
 	{
@@ -235,6 +245,67 @@ ssize_t WebSocketFrame::ProcessHeader(ov::ByteStream &stream)
 	return stream.GetOffset() - before_offset;
 }
 
+void WebSocketFrame::Unmask(uint8_t *dst, const uint8_t *src, size_t length, uint32_t masking_key, size_t key_offset)
+{
+	uint8_t key[4];
+	::memcpy(key, &masking_key, sizeof(key));
+
+	// The key rotated by key_offset, repeated for the widest register
+	// (the registers are multiples of 4 bytes, so the pattern stays in phase from one block to the next)
+	alignas(32) uint8_t pattern[32];
+
+	for(size_t index = 0; index < sizeof(pattern); index++)
+	{
+		pattern[index] = key[(key_offset + index) % 4];
+	}
+
+	size_t offset = 0;
+
+#if defined(__AVX2__)
+	auto pattern_256 = _mm256_load_si256(reinterpret_cast<const __m256i *>(pattern));
+
+	for(; (offset + 32) <= length; offset += 32)
+	{
+		auto value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), _mm256_xor_si256(value, pattern_256));
+	}
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	auto pattern_128 = _mm_load_si128(reinterpret_cast<const __m128i *>(pattern));
+
+	for(; (offset + 16) <= length; offset += 16)
+	{
+		auto value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + offset));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + offset), _mm_xor_si128(value, pattern_128));
+	}
+#elif defined(__ARM_NEON)
+	auto pattern_128 = vld1q_u8(pattern);
+
+	for(; (offset + 16) <= length; offset += 16)
+	{
+		vst1q_u8(dst + offset, veorq_u8(vld1q_u8(src + offset), pattern_128));
+	}
+#endif
+
+	// The rest (or all of the payload if there is no SIMD) is processed in 8 bytes
+	uint64_t pattern_64;
+	::memcpy(&pattern_64, pattern, sizeof(pattern_64));
+
+	for(; (offset + 8) <= length; offset += 8)
+	{
+		uint64_t value;
+		::memcpy(&value, src + offset, sizeof(value));
+		value ^= pattern_64;
+		::memcpy(dst + offset, &value, sizeof(value));
+	}
+
+	for(; offset < length; offset++)
+	{
+		dst[offset] = src[offset] ^ pattern[offset % 4];
+	}
+}
+
 ov::String WebSocketFrame::ToString() const
 {
 	return ov::String::FormatString(
@@ -31,7 +31,9 @@ public:
 
 		_last_status = WebSocketFrameParseStatus::Prepare;
 
-		_payload->Clear();
+		_payload = nullptr;
+		_payload_buffer = nullptr;
+		_received_length = 0L;
 	}
 
 	const std::shared_ptr<const ov::Data> GetPayload() const noexcept
@@ -39,6 +41,7 @@ public:
 		return _payload;
 	}
 
+	// If the whole payload of an unmasked frame is in the data, the payload refers to the data without copying
 	ssize_t Process(const std::shared_ptr<const ov::Data> &data);
 	WebSocketFrameParseStatus GetStatus() const noexcept;
 
@@ -46,6 +49,10 @@ public:
 
 	ov::String ToString() const;
 
+	// dst[i] = src[i] ^ masking_key[(key_offset + i) % 4] (RFC6455 - 5.3. Client-to-Server Masking)
+	// dst may be the same as src
+	static void Unmask(uint8_t *dst, const uint8_t *src, size_t length, uint32_t masking_key, size_t key_offset);
+
 protected:
 	ssize_t ProcessHeader(ov::ByteStream &stream);
 
@@ -54,9 +61,13 @@ protected:
 
 	uint64_t _remained_length;
 	uint64_t _total_length;
-	uint32_t _frame_masking_key;
+	uint64_t _received_length = 0L;
+	// The bytes in the order of the wire
+	uint32_t _frame_masking_key = 0;
 
 	WebSocketFrameParseStatus _last_status;
 
-	std::shared_ptr<ov::Data> _payload;
+	std::shared_ptr<const ov::Data> _payload;
+	// Accumulates the payload if it is masked or received over several data
+	std::shared_ptr<ov::Data> _payload_buffer;
 };
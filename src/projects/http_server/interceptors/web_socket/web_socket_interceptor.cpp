@@ -28,24 +28,30 @@ WebSocketInterceptor::~WebSocketInterceptor()
 
 ov::DelayQueueAction WebSocketInterceptor::DoPing(void *parameter)
 {
-	{
-		std::shared_lock<std::shared_mutex> lock_guard(_websocket_client_list_mutex);
+	logtd("Trying to ping to WebSocket clients...");
 
-		if (_websocket_client_list.size() > 0)
-		{
-			logtd("Trying to ping to WebSocket clients...");
+	static const auto payload = ov::String("OvenMediaEngine").ToData(false);
 
-			ov::String str("OvenMediaEngine");
-			auto payload = std::move(str.ToData(false));
+	Broadcast(payload, WebSocketFrameOpcode::Ping);
 
-			for (auto client : _websocket_client_list)
-			{
-				client.second->response->Send(payload, WebSocketFrameOpcode::Ping);
-			}
-		}
+	return ov::DelayQueueAction::Repeat;
+}
+
+void WebSocketInterceptor::Broadcast(const std::shared_ptr<const ov::Data> &data, WebSocketFrameOpcode opcode)
+{
+	std::shared_lock<std::shared_mutex> lock_guard(_websocket_client_list_mutex);
+
+	if (_websocket_client_list.empty())
+	{
+		return;
 	}
 
-	return ov::DelayQueueAction::Repeat;
+	auto frame_header = WebSocketClient::MakeFrameHeader(opcode, (data == nullptr) ? 0 : data->GetLength());
+
+	for (auto &client : _websocket_client_list)
+	{
+		client.second->response->Send(frame_header, data);
+	}
 }
 
 bool WebSocketInterceptor::IsInterceptorForRequest(const std::shared_ptr<const HttpClient> &client)
@@ -28,6 +28,9 @@ public:
 	// ws.on('close');
 	void SetCloseHandler(WebSocketCloseHandler handler);
 
+	// Sends the same message to all clients (the frame header is made once and shared)
+	void Broadcast(const std::shared_ptr<const ov::Data> &data, WebSocketFrameOpcode opcode);
+
 protected:
 	ov::DelayQueueAction DoPing(void *parameter);
 
@@ -0,0 +1,76 @@
+# Built only by "make benchmark" with the benchmarks (not a part of the release)
+ifneq (,$(findstring benchmark,$(MAKECMDGOALS)))
+
+LOCAL_PATH := $(call get_local_path)
+include $(DEFAULT_VARIABLES)
+
+# The same libraries as OvenMediaEngine, so the load generator speaks the protocols with the code that is shipped
+LOCAL_STATIC_LIBRARIES := \
+	webrtc_publisher \
+	segment_publishers \
+	segment_stream \
+	ovt_publisher \
+	rtmp_publisher \
+	record_publisher \
+	ovt_provider \
+	rtmp_provider \
+	rtspc_provider \
+	webrtc_provider \
+	srt_provider \
+	replay_provider \
+	transcoder \
+	rtc_signalling \
+	ice \
+	jsoncpp \
+	monitoring \
+	http_server \
+	signed_url \
+	dtls_srtp \
+	rtp_rtcp \
+	sdp \
+	mpegts \
+	h264 \
+	web_console \
+	mediarouter \
+	media_capture \
+	ovt_packetizer \
+	orchestrator \
+	publisher \
+	application \
+	physical_port \
+	socket \
+	ovcrypto \
+	config \
+	ovlibrary \
+	monitoring \
+	jsoncpp \
+	sqlite \
+	aac
+
+LOCAL_PREBUILT_LIBRARIES := \
+	libpugixml.a
+
+LOCAL_LDFLAGS := -lpthread
+
+ifeq ($(shell echo $${OSTYPE}),linux-musl) 
+# For alpine linux
+LOCAL_LDFLAGS += -lexecinfo
+endif
+
+$(call add_pkg_config,srt)
+$(call add_pkg_config,libavformat)
+$(call add_pkg_config,libavfilter)
+$(call add_pkg_config,libavcodec)
+$(call add_pkg_config,libswresample)
+$(call add_pkg_config,libswscale)
+$(call add_pkg_config,libavutil)
+$(call add_pkg_config,openssl)
+$(call add_pkg_config,vpx)
+$(call add_pkg_config,opus)
+$(call add_pkg_config,libsrtp2)
+
+LOCAL_TARGET := OvenMediaEngineLoad
+
+include $(BUILD_EXECUTABLE)
+
+endif
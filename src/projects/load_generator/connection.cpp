@@ -0,0 +1,135 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "connection.h"
+
+#include <poll.h>
+
+#include "load_generator_private.h"
+
+// The interval to check the stop flag while receiving
+#define CONNECTION_STOP_CHECK_INTERVAL_MSEC 500
+
+namespace load
+{
+	Connection::~Connection()
+	{
+		Close();
+	}
+
+	bool Connection::Connect(const ov::String &host, uint16_t port, int timeout_msec)
+	{
+		if (_socket.Create(ov::SocketType::Tcp) == false)
+		{
+			logte("Could not create a socket");
+			return false;
+		}
+
+		auto error = _socket.Connect(ov::SocketAddress(host, port), timeout_msec);
+
+		if (error != nullptr)
+		{
+			logte("Could not connect to %s:%d: %s", host.CStr(), port, error->ToString().CStr());
+			_socket.Close();
+			return false;
+		}
+
+		_is_connected = true;
+
+		return true;
+	}
+
+	void Connection::Close()
+	{
+		if (_is_connected)
+		{
+			_socket.Close();
+			_is_connected = false;
+		}
+	}
+
+	bool Connection::Send(const void *data, size_t length)
+	{
+		if (_is_connected == false)
+		{
+			return false;
+		}
+
+		return _socket.Send(data, length) == static_cast<ssize_t>(length);
+	}
+
+	Connection::RecvResult Connection::Recv(void *data, size_t length, size_t *received_length, int timeout_msec)
+	{
+		*received_length = 0;
+
+		if (_is_connected == false)
+		{
+			return RecvResult::Closed;
+		}
+
+		pollfd poll_fd{};
+
+		poll_fd.fd = _socket.GetId();
+		poll_fd.events = POLLIN;
+
+		auto result = ::poll(&poll_fd, 1, timeout_msec);
+
+		if (result == 0)
+		{
+			return RecvResult::Timeout;
+		}
+		else if ((result < 0) && (errno == EINTR))
+		{
+			return RecvResult::Timeout;
+		}
+		else if (result < 0)
+		{
+			return RecvResult::Closed;
+		}
+
+		// The socket is readable, so no data means that the peer closed the connection
+		auto error = _socket.Recv(data, length, received_length, true);
+
+		if ((error != nullptr) || (*received_length == 0))
+		{
+			return RecvResult::Closed;
+		}
+
+		return RecvResult::Received;
+	}
+
+	bool Connection::RecvExactly(void *data, size_t length, const std::atomic<bool> &stop_flag)
+	{
+		auto buffer = static_cast<uint8_t *>(data);
+		size_t offset = 0;
+
+		while (offset < length)
+		{
+			if (stop_flag)
+			{
+				return false;
+			}
+
+			size_t received_length = 0;
+
+			switch (Recv(buffer + offset, length - offset, &received_length, CONNECTION_STOP_CHECK_INTERVAL_MSEC))
+			{
+				case RecvResult::Received:
+					offset += received_length;
+					break;
+
+				case RecvResult::Timeout:
+					break;
+
+				case RecvResult::Closed:
+					return false;
+			}
+		}
+
+		return true;
+	}
+}  // namespace load
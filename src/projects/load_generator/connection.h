@@ -0,0 +1,47 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/ovsocket/ovsocket.h>
+
+namespace load
+{
+	// A blocking TCP connection of an ingest/viewer (each ingest/viewer has its own thread)
+	class Connection
+	{
+	public:
+		enum class RecvResult
+		{
+			Received,
+			// No data in timeout_msec
+			Timeout,
+			Closed
+		};
+
+		~Connection();
+
+		bool Connect(const ov::String &host, uint16_t port, int timeout_msec);
+		void Close();
+
+		bool Send(const void *data, size_t length);
+		bool Send(const std::shared_ptr<const ov::Data> &data)
+		{
+			return Send(data->GetData(), data->GetLength());
+		}
+
+		// Receives the data that is available (at most length bytes)
+		RecvResult Recv(void *data, size_t length, size_t *received_length, int timeout_msec);
+		// Receives exactly length bytes (false if the connection is closed or stop_flag is set)
+		bool RecvExactly(void *data, size_t length, const std::atomic<bool> &stop_flag);
+
+	private:
+		ov::Socket _socket;
+		bool _is_connected = false;
+	};
+}  // namespace load
@@ -0,0 +1,99 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "flv_file.h"
+
+#include <cstdio>
+
+#include <base/ovlibrary/byte_io.h>
+
+#include "load_generator_private.h"
+
+// "FLV" + version(1) + flags(1) + header size(4)
+#define FLV_HEADER_SIZE 9
+// type(1) + data size(3) + timestamp(3) + timestamp extended(1) + stream id(3)
+#define FLV_TAG_HEADER_SIZE 11
+
+namespace load
+{
+	bool FlvFile::Load(const ov::String &file_path)
+	{
+		FILE *file = ::fopen(file_path.CStr(), "rb");
+
+		if (file == nullptr)
+		{
+			logte("Could not open the file: %s", file_path.CStr());
+			return false;
+		}
+
+		std::vector<uint8_t> content;
+		uint8_t buffer[64 * 1024];
+		size_t read_bytes = 0;
+
+		while ((read_bytes = ::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			content.insert(content.end(), buffer, buffer + read_bytes);
+		}
+
+		::fclose(file);
+
+		if ((content.size() < FLV_HEADER_SIZE) || (::memcmp(content.data(), "FLV", 3) != 0))
+		{
+			logte("Not a FLV file: %s", file_path.CStr());
+			return false;
+		}
+
+		size_t header_size = ByteReader<uint32_t>::ReadBigEndian(&content[5]);
+		// PreviousTagSize0
+		size_t offset = header_size + sizeof(uint32_t);
+		int64_t first_timestamp = -1;
+
+		_tags.clear();
+
+		while ((offset + FLV_TAG_HEADER_SIZE) <= content.size())
+		{
+			const uint8_t *tag_header = &content[offset];
+			size_t data_size = (tag_header[1] << 16) | (tag_header[2] << 8) | tag_header[3];
+			int64_t timestamp = (tag_header[7] << 24) | (tag_header[4] << 16) | (tag_header[5] << 8) | tag_header[6];
+
+			if ((offset + FLV_TAG_HEADER_SIZE + data_size) > content.size())
+			{
+				// The last tag is truncated
+				break;
+			}
+
+			FlvTag tag;
+			auto data = &content[offset + FLV_TAG_HEADER_SIZE];
+
+			// Only audio, video and script data (the filter/encryption bits are not supported)
+			tag.type = tag_header[0] & 0x1F;
+
+			if (first_timestamp < 0)
+			{
+				first_timestamp = timestamp;
+			}
+
+			tag.timestamp = std::max<int64_t>(timestamp - first_timestamp, 0);
+			tag.data = std::make_shared<std::vector<uint8_t>>(data, data + data_size);
+
+			_duration = std::max(_duration, tag.timestamp);
+			_tags.push_back(std::move(tag));
+
+			offset += FLV_TAG_HEADER_SIZE + data_size + sizeof(uint32_t);
+		}
+
+		if (_tags.empty())
+		{
+			logte("There is no tag in the file: %s", file_path.CStr());
+			return false;
+		}
+
+		logti("%zu tags are loaded from %s (%lld ms)", _tags.size(), file_path.CStr(), static_cast<long long>(_duration));
+
+		return true;
+	}
+}  // namespace load
@@ -0,0 +1,44 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+namespace load
+{
+	struct FlvTag
+	{
+		// RTMP_MSGID_AUDIO_MESSAGE, RTMP_MSGID_VIDEO_MESSAGE or RTMP_MSGID_AMF0_DATA_MESSAGE (the same as the type of FLV tag)
+		uint8_t type = 0;
+		// msec
+		int64_t timestamp = 0;
+		std::shared_ptr<std::vector<uint8_t>> data;
+	};
+
+	// The tags of a FLV file that is published by the ingests (the file is loaded into the memory)
+	class FlvFile
+	{
+	public:
+		bool Load(const ov::String &file_path);
+
+		const std::vector<FlvTag> &GetTags() const
+		{
+			return _tags;
+		}
+
+		// The timestamp of the last tag (msec), the ingests loop the file with this offset
+		int64_t GetDuration() const
+		{
+			return _duration;
+		}
+
+	private:
+		std::vector<FlvTag> _tags;
+		int64_t _duration = 0;
+	};
+}  // namespace load
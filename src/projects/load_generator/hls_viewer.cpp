@@ -0,0 +1,308 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "hls_viewer.h"
+
+#include "load_generator_private.h"
+
+#define HLS_VIEWER_CONNECT_TIMEOUT_MSEC 3000
+// The interval to poll the playlist (about a half of the segment duration of OvenMediaEngine)
+#define HLS_VIEWER_PLAYLIST_INTERVAL_MSEC 1000
+#define HLS_VIEWER_RECV_TIMEOUT_MSEC 5000
+// The number of the segments that are remembered to find the new segments
+#define HLS_VIEWER_MAX_DOWNLOADED_SEGMENTS 64
+
+namespace load
+{
+	HlsViewer::HlsViewer(const std::shared_ptr<const ov::Url> &url, Statistics *statistics)
+		: _url(url),
+		  _statistics(statistics)
+	{
+	}
+
+	HlsViewer::~HlsViewer()
+	{
+		Stop();
+	}
+
+	bool HlsViewer::Start()
+	{
+		_thread = std::thread(&HlsViewer::Run, this);
+		pthread_setname_np(_thread.native_handle(), "HlsViewer");
+
+		return true;
+	}
+
+	void HlsViewer::Stop()
+	{
+		_stop_flag = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+
+		_connection.Close();
+
+		if (_is_joined == false)
+		{
+			// Not counted twice (_is_joined is set to true after it is counted)
+			_statistics->join_failures++;
+			_is_joined = true;
+		}
+	}
+
+	bool HlsViewer::Connect()
+	{
+		_connection.Close();
+		_received_data.Clear();
+
+		auto port = (_url->Port() > 0) ? _url->Port() : 80;
+
+		_is_connected = _connection.Connect(_url->Domain(), port, HLS_VIEWER_CONNECT_TIMEOUT_MSEC);
+
+		return _is_connected;
+	}
+
+	void HlsViewer::Run()
+	{
+		_connect_time = std::chrono::steady_clock::now();
+
+		if (Connect() == false)
+		{
+			_statistics->viewer_failures++;
+			return;
+		}
+
+		auto playlist_path = _url->Path();
+		// The segments are relative to the playlist
+		auto base_path = playlist_path.Substring(0, playlist_path.IndexOfRev('/') + 1);
+		std::deque<ov::String> downloaded_segments;
+
+		while (_stop_flag == false)
+		{
+			auto poll_time = std::chrono::steady_clock::now();
+			int status_code = 0;
+			std::shared_ptr<ov::Data> playlist;
+
+			if (Get(playlist_path, &status_code, &playlist) == false)
+			{
+				if (_stop_flag == false)
+				{
+					logte("Could not get the playlist: %s", _url->Source().CStr());
+					_statistics->viewer_failures++;
+				}
+
+				return;
+			}
+
+			if (status_code == 200)
+			{
+				auto lines = ov::String(playlist->GetDataAs<char>(), playlist->GetLength()).Split("\n");
+
+				for (auto &line : lines)
+				{
+					auto segment = line.Trim();
+
+					if (segment.IsEmpty() || segment.HasPrefix("#") || _stop_flag)
+					{
+						continue;
+					}
+
+					if (std::find(downloaded_segments.begin(), downloaded_segments.end(), segment) != downloaded_segments.end())
+					{
+						continue;
+					}
+
+					auto segment_path = segment.HasPrefix("/") ? segment : (base_path + segment);
+					std::shared_ptr<ov::Data> segment_data;
+					auto download_start = std::chrono::steady_clock::now();
+
+					if (Get(segment_path, &status_code, &segment_data) == false)
+					{
+						if (_stop_flag == false)
+						{
+							logte("Could not get the segment: %s", segment_path.CStr());
+							_statistics->viewer_failures++;
+						}
+
+						return;
+					}
+
+					auto now = std::chrono::steady_clock::now();
+
+					if (status_code != 200)
+					{
+						logtw("Could not get the segment: %s (%d)", segment_path.CStr(), status_code);
+						continue;
+					}
+
+					_statistics->segment_time.Add(std::chrono::duration<double, std::milli>(now - download_start).count());
+
+					if (_is_joined == false)
+					{
+						_is_joined = true;
+						_statistics->join_time.Add(std::chrono::duration<double, std::milli>(now - _connect_time).count());
+					}
+
+					downloaded_segments.push_back(segment);
+
+					if (downloaded_segments.size() > HLS_VIEWER_MAX_DOWNLOADED_SEGMENTS)
+					{
+						downloaded_segments.pop_front();
+					}
+				}
+			}
+			else if (status_code != 404)
+			{
+				// 404: The stream is not created yet
+				logtw("Could not get the playlist: %s (%d)", _url->Source().CStr(), status_code);
+			}
+
+			auto next_poll_time = poll_time + std::chrono::milliseconds(HLS_VIEWER_PLAYLIST_INTERVAL_MSEC);
+
+			while ((_stop_flag == false) && (std::chrono::steady_clock::now() < next_poll_time))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
+		}
+	}
+
+	bool HlsViewer::Get(const ov::String &path, int *status_code, std::shared_ptr<ov::Data> *body)
+	{
+		if ((_is_connected == false) && (Connect() == false))
+		{
+			return false;
+		}
+
+		ov::String request;
+
+		request.Format(
+			"GET %s HTTP/1.1\r\n"
+			"Host: %s\r\n"
+			"User-Agent: OvenMediaEngineLoad\r\n"
+			"Connection: keep-alive\r\n"
+			"\r\n",
+			path.CStr(), _url->Domain().CStr());
+
+		if (_connection.Send(request.CStr(), request.GetLength()) == false)
+		{
+			return false;
+		}
+
+		// Status line
+		ov::String line;
+
+		if (ReceiveLine(&line) == false)
+		{
+			return false;
+		}
+
+		auto status_line = line.Split(" ", 3);
+
+		if ((status_line.size() < 2) || (status_line[0].HasPrefix("HTTP/") == false))
+		{
+			logte("Invalid response: %s", line.CStr());
+			return false;
+		}
+
+		*status_code = ::atoi(status_line[1].CStr());
+
+		// Headers
+		size_t content_length = 0;
+		bool is_connection_closed = false;
+
+		while (true)
+		{
+			if (ReceiveLine(&line) == false)
+			{
+				return false;
+			}
+
+			if (line.IsEmpty())
+			{
+				break;
+			}
+
+			auto header = line.Split(":", 2);
+
+			if (header.size() != 2)
+			{
+				continue;
+			}
+
+			auto name = header[0].Trim().LowerCaseString();
+			auto value = header[1].Trim();
+
+			if (name == "content-length")
+			{
+				content_length = ::strtoul(value.CStr(), nullptr, 10);
+			}
+			else if ((name == "connection") && (value.LowerCaseString() == "close"))
+			{
+				is_connection_closed = true;
+			}
+		}
+
+		// Body
+		while (_received_data.GetLength() < content_length)
+		{
+			uint8_t buffer[64 * 1024];
+			size_t received_length = 0;
+
+			if (_stop_flag || (_connection.Recv(buffer, sizeof(buffer), &received_length, HLS_VIEWER_RECV_TIMEOUT_MSEC) != Connection::RecvResult::Received))
+			{
+				return false;
+			}
+
+			_received_data.Append(buffer, received_length);
+			_statistics->viewer_bytes += received_length;
+		}
+
+		*body = _received_data.Subdata(0, content_length)->Clone();
+		_received_data.Erase(0, content_length);
+
+		if (is_connection_closed)
+		{
+			_connection.Close();
+			_is_connected = false;
+		}
+
+		return true;
+	}
+
+	bool HlsViewer::ReceiveLine(ov::String *line)
+	{
+		while (true)
+		{
+			auto data = _received_data.GetDataAs<char>();
+			auto length = _received_data.GetLength();
+			auto end_of_line = static_cast<const char *>(::memchr(data, '\n', length));
+
+			if (end_of_line != nullptr)
+			{
+				size_t line_length = end_of_line - data;
+
+				*line = ov::String(data, line_length).Trim();
+				_received_data.Erase(0, line_length + 1);
+
+				return true;
+			}
+
+			uint8_t buffer[4 * 1024];
+			size_t received_length = 0;
+
+			if (_stop_flag || (_connection.Recv(buffer, sizeof(buffer), &received_length, HLS_VIEWER_RECV_TIMEOUT_MSEC) != Connection::RecvResult::Received))
+			{
+				return false;
+			}
+
+			_received_data.Append(buffer, received_length);
+			_statistics->viewer_bytes += received_length;
+		}
+	}
+}  // namespace load
@@ -0,0 +1,51 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <thread>
+
+#include "connection.h"
+#include "statistics.h"
+
+namespace load
+{
+	// Plays a stream over HLS (polls the playlist and downloads the new segments over a keep-alive connection)
+	class HlsViewer
+	{
+	public:
+		// url: http://<host>[:<port>]/<app>/<stream>/playlist.m3u8
+		HlsViewer(const std::shared_ptr<const ov::Url> &url, Statistics *statistics);
+		~HlsViewer();
+
+		bool Start();
+		void Stop();
+
+	protected:
+		void Run();
+
+		// Sends a GET request and receives the body (only Content-Length is supported, not chunked)
+		bool Get(const ov::String &path, int *status_code, std::shared_ptr<ov::Data> *body);
+		bool ReceiveLine(ov::String *line);
+
+		bool Connect();
+
+		std::shared_ptr<const ov::Url> _url;
+		Statistics *_statistics;
+
+		Connection _connection;
+		bool _is_connected = false;
+		// The data that is received after the last response
+		ov::Data _received_data;
+
+		std::chrono::steady_clock::time_point _connect_time;
+		bool _is_joined = false;
+
+		std::thread _thread;
+		std::atomic<bool> _stop_flag{false};
+	};
+}  // namespace load
@@ -0,0 +1,305 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include <getopt.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "flv_file.h"
+#include "hls_viewer.h"
+#include "ovt_viewer.h"
+#include "rtmp_ingest.h"
+#include "statistics.h"
+
+struct LoadOption
+{
+	// -i <file>: the FLV file to publish (looped)
+	ov::String input_path;
+	// -r <url>: the RTMP URL of the application
+	ov::String rtmp_url = "rtmp://127.0.0.1:1935/app";
+	// -n <count>: the number of the ingests
+	int ingest_count = 1;
+	// -s <prefix>: the streams are named <prefix>_<index>
+	ov::String stream_prefix = "load";
+	// -v <count>: the number of the viewers of each stream
+	int viewer_count = 10;
+	// -o <url>: ovt://<host>:<port> or http://<host>:<port> (HLS)
+	ov::String viewer_url = "ovt://127.0.0.1:9000";
+	// -d <sec>: the duration of the test
+	int duration_sec = 60;
+	// -w <msec>: the delay to start the viewers after the ingests are started
+	int viewer_delay_msec = 3000;
+	// -P <pid>: the pid of OvenMediaEngine to measure the CPU usage
+	pid_t server_pid = 0;
+};
+
+static std::atomic<bool> g_stop_flag{false};
+
+static void PrintUsage(const char *program)
+{
+	::printf("Usage: %s -i <flv file> [-r <rtmp url>] [-n <ingests>] [-s <stream prefix>] [-v <viewers per stream>]\n"
+			 "       [-o <ovt://host:port | http://host:port>] [-d <duration sec>] [-w <viewer delay msec>] [-P <server pid>]\n",
+			 program);
+}
+
+static bool TryParseOption(int argc, char *argv[], LoadOption *option)
+{
+	constexpr const char *opt_string = "hi:r:n:s:v:o:d:w:P:";
+
+	while (true)
+	{
+		int name = ::getopt(argc, argv, opt_string);
+
+		switch (name)
+		{
+			case -1:
+				// end of arguments
+				return option->input_path.IsEmpty() == false;
+
+			case 'i':
+				option->input_path = optarg;
+				break;
+
+			case 'r':
+				option->rtmp_url = optarg;
+				break;
+
+			case 'n':
+				option->ingest_count = std::max(::atoi(optarg), 1);
+				break;
+
+			case 's':
+				option->stream_prefix = optarg;
+				break;
+
+			case 'v':
+				option->viewer_count = std::max(::atoi(optarg), 0);
+				break;
+
+			case 'o':
+				option->viewer_url = optarg;
+				break;
+
+			case 'd':
+				option->duration_sec = std::max(::atoi(optarg), 1);
+				break;
+
+			case 'w':
+				option->viewer_delay_msec = std::max(::atoi(optarg), 0);
+				break;
+
+			case 'P':
+				option->server_pid = ::atoi(optarg);
+				break;
+
+			default:  // 'h', '?'
+				return false;
+		}
+	}
+}
+
+// The CPU time (utime + stime) of the process in seconds (-1 if it cannot be read)
+static double GetProcessCpuTime(pid_t pid)
+{
+	auto file = ::fopen(ov::String::FormatString("/proc/%d/stat", pid).CStr(), "r");
+
+	if (file == nullptr)
+	{
+		return -1.0;
+	}
+
+	char buffer[1024];
+	auto length = ::fread(buffer, 1, sizeof(buffer) - 1, file);
+	::fclose(file);
+
+	buffer[length] = '\0';
+
+	// The process name can have spaces, so the fields are parsed after the last ')'
+	auto fields = ::strrchr(buffer, ')');
+	unsigned long utime = 0;
+	unsigned long stime = 0;
+
+	// state(3) ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt utime(14) stime(15)
+	if ((fields == nullptr) || (::sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2))
+	{
+		return -1.0;
+	}
+
+	return static_cast<double>(utime + stime) / ::sysconf(_SC_CLK_TCK);
+}
+
+static void PrintSamples(const char *name, const load::Samples &samples)
+{
+	if (samples.GetCount() == 0)
+	{
+		::printf("%-16s -\n", name);
+		return;
+	}
+
+	::printf("%-16s count: %zu, avg: %.1f ms, p50: %.1f ms, p95: %.1f ms, p99: %.1f ms, max: %.1f ms\n",
+			 name, samples.GetCount(), samples.GetAverage(),
+			 samples.GetPercentile(50.0), samples.GetPercentile(95.0), samples.GetPercentile(99.0), samples.GetMax());
+}
+
+int main(int argc, char *argv[])
+{
+	LoadOption option;
+
+	if (TryParseOption(argc, argv, &option) == false)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	ov_log_set_level(OVLogLevelInformation);
+
+	::signal(SIGPIPE, SIG_IGN);
+	::signal(SIGINT, [](int signum) { g_stop_flag = true; });
+
+	auto rtmp_url = ov::Url::Parse(option.rtmp_url.CStr());
+	auto viewer_url = ov::Url::Parse(option.viewer_url.CStr());
+
+	if ((rtmp_url == nullptr) || (viewer_url == nullptr))
+	{
+		::printf("Invalid URL: %s, %s\n", option.rtmp_url.CStr(), option.viewer_url.CStr());
+		return 1;
+	}
+
+	bool is_ovt = (viewer_url->Scheme().LowerCaseString() == "ovt");
+
+	if ((is_ovt == false) && (viewer_url->Scheme().LowerCaseString() != "http"))
+	{
+		::printf("Not supported viewer: %s (ovt:// and http:// are supported)\n", option.viewer_url.CStr());
+		return 1;
+	}
+
+	load::FlvFile flv_file;
+
+	if (flv_file.Load(option.input_path) == false)
+	{
+		return 1;
+	}
+
+	load::Statistics statistics;
+	std::vector<std::unique_ptr<load::RtmpIngest>> ingests;
+	std::vector<std::unique_ptr<load::OvtViewer>> ovt_viewers;
+	std::vector<std::unique_ptr<load::HlsViewer>> hls_viewers;
+
+	for (int index = 0; index < option.ingest_count; index++)
+	{
+		auto stream_name = ov::String::FormatString("%s_%d", option.stream_prefix.CStr(), index);
+		auto ingest = std::make_unique<load::RtmpIngest>(rtmp_url, stream_name, flv_file, &statistics);
+
+		ingest->Start();
+		ingests.push_back(std::move(ingest));
+	}
+
+	::printf("%d ingest(s) are started, the viewers will be started after %d ms\n", option.ingest_count, option.viewer_delay_msec);
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(option.viewer_delay_msec));
+
+	auto start_time = std::chrono::steady_clock::now();
+	auto start_cpu_time = (option.server_pid > 0) ? GetProcessCpuTime(option.server_pid) : -1.0;
+
+	for (auto &ingest : ingests)
+	{
+		// <scheme>://<host>:<port>/<app>/<stream>[/playlist.m3u8]
+		auto url_string = ov::String::FormatString("%s://%s:%d/%s/%s%s",
+												   viewer_url->Scheme().CStr(), viewer_url->Domain().CStr(), viewer_url->Port(),
+												   rtmp_url->App().CStr(), ingest->GetStreamName().CStr(),
+												   is_ovt ? "" : "/playlist.m3u8");
+		auto url = ov::Url::Parse(url_string.CStr());
+
+		for (int index = 0; index < option.viewer_count; index++)
+		{
+			if (is_ovt)
+			{
+				auto viewer = std::make_unique<load::OvtViewer>(url, *ingest, &statistics);
+				viewer->Start();
+				ovt_viewers.push_back(std::move(viewer));
+			}
+			else
+			{
+				auto viewer = std::make_unique<load::HlsViewer>(url, &statistics);
+				viewer->Start();
+				hls_viewers.push_back(std::move(viewer));
+			}
+		}
+	}
+
+	int total_viewer_count = option.ingest_count * option.viewer_count;
+
+	::printf("%d viewer(s) are started, running for %d seconds...\n", total_viewer_count, option.duration_sec);
+
+	auto end_time = start_time + std::chrono::seconds(option.duration_sec);
+
+	while ((g_stop_flag == false) && (std::chrono::steady_clock::now() < end_time))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	auto elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	auto end_cpu_time = (option.server_pid > 0) ? GetProcessCpuTime(option.server_pid) : -1.0;
+
+	for (auto &viewer : ovt_viewers)
+	{
+		viewer->Stop();
+	}
+
+	for (auto &viewer : hls_viewers)
+	{
+		viewer->Stop();
+	}
+
+	for (auto &ingest : ingests)
+	{
+		ingest->Stop();
+	}
+
+	::printf("\n");
+	::printf("Ingests          %d (failures: %u), %.1f Mbps\n", option.ingest_count, statistics.ingest_failures.load(),
+			 (statistics.ingest_bytes * 8.0) / (elapsed_sec * 1000000.0));
+	::printf("Viewers          %d x %s (failures: %u, not joined: %u), %.1f Mbps\n", total_viewer_count, is_ovt ? "OVT" : "HLS",
+			 statistics.viewer_failures.load(), statistics.join_failures.load(),
+			 (statistics.viewer_bytes * 8.0) / (elapsed_sec * 1000000.0));
+
+	PrintSamples("Publish time", statistics.publish_time);
+	PrintSamples("Join time", statistics.join_time);
+
+	if (is_ovt)
+	{
+		auto total_packets = statistics.viewer_packets + statistics.lost_packets;
+
+		PrintSamples("Latency", statistics.latency);
+		::printf("%-16s %lu / %lu packets (%.3f%%)\n", "Loss",
+				 static_cast<unsigned long>(statistics.lost_packets.load()), static_cast<unsigned long>(total_packets),
+				 (total_packets > 0) ? (statistics.lost_packets * 100.0 / total_packets) : 0.0);
+	}
+	else
+	{
+		PrintSamples("Segment time", statistics.segment_time);
+	}
+
+	if ((start_cpu_time >= 0.0) && (end_cpu_time >= 0.0))
+	{
+		// 100% = a core
+		auto cpu_percent = ((end_cpu_time - start_cpu_time) / elapsed_sec) * 100.0;
+
+		::printf("%-16s %.1f%% (%.3f%% per viewer)\n", "Server CPU", cpu_percent,
+				 (total_viewer_count > 0) ? (cpu_percent / total_viewer_count) : 0.0);
+	}
+	else if (option.server_pid > 0)
+	{
+		::printf("%-16s Could not read the CPU time of %d\n", "Server CPU", option.server_pid);
+	}
+
+	return ((statistics.ingest_failures > 0) || (statistics.viewer_failures > 0)) ? 2 : 0;
+}
@@ -0,0 +1,305 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_viewer.h"
+
+#include <base/ovlibrary/byte_io.h>
+
+#include "load_generator_private.h"
+
+#define OVT_VIEWER_CONNECT_TIMEOUT_MSEC 3000
+
+namespace load
+{
+	OvtViewer::OvtViewer(const std::shared_ptr<const ov::Url> &url, const RtmpIngest &ingest, Statistics *statistics)
+		: _url(url),
+		  _ingest(ingest),
+		  _statistics(statistics)
+	{
+	}
+
+	OvtViewer::~OvtViewer()
+	{
+		Stop();
+	}
+
+	bool OvtViewer::Start()
+	{
+		_thread = std::thread(&OvtViewer::Run, this);
+		pthread_setname_np(_thread.native_handle(), "OvtViewer");
+
+		return true;
+	}
+
+	void OvtViewer::Stop()
+	{
+		_stop_flag = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+
+		_connection.Close();
+
+		if (_is_joined == false)
+		{
+			// Not counted twice (_is_joined is set to true after it is counted)
+			_statistics->join_failures++;
+			_is_joined = true;
+		}
+	}
+
+	void OvtViewer::Run()
+	{
+		_connect_time = std::chrono::steady_clock::now();
+
+		if (_connection.Connect(_url->Domain(), _url->Port(), OVT_VIEWER_CONNECT_TIMEOUT_MSEC) == false)
+		{
+			_statistics->viewer_failures++;
+			return;
+		}
+
+		uint32_t session_id = 0;
+
+		// DESCRIBE
+		if (SendRequest(OVT_PAYLOAD_TYPE_DESCRIBE, 0, 1) == false)
+		{
+			_statistics->viewer_failures++;
+			return;
+		}
+
+		auto describe_response = ReceiveResponse(1, &session_id);
+
+		if ((describe_response == nullptr) || (describe_response->HasStream() == false))
+		{
+			if (_stop_flag == false)
+			{
+				logte("Could not describe the stream: %s", _url->Source().CStr());
+				_statistics->viewer_failures++;
+			}
+
+			return;
+		}
+
+		for (auto &track : describe_response->GetTracks())
+		{
+			_timebases[track->GetId()] = track->GetTimeBase().GetExpr();
+		}
+
+		// PLAY
+		if ((SendRequest(OVT_PAYLOAD_TYPE_PLAY, 0, 2) == false) || (ReceiveResponse(2, &session_id) == nullptr))
+		{
+			if (_stop_flag == false)
+			{
+				logte("Could not play the stream: %s", _url->Source().CStr());
+				_statistics->viewer_failures++;
+			}
+
+			return;
+		}
+
+		while (_stop_flag == false)
+		{
+			auto packet = ReceivePacket();
+
+			if (packet == nullptr)
+			{
+				if (_stop_flag == false)
+				{
+					logte("The stream is disconnected: %s", _url->Source().CStr());
+					_statistics->viewer_failures++;
+				}
+
+				break;
+			}
+
+			if (packet->PayloadType() == OVT_PAYLOAD_TYPE_MEDIA_PACKET)
+			{
+				OnMediaPacket(packet);
+			}
+		}
+
+		if ((_stop_flag == false) || (session_id == 0))
+		{
+			return;
+		}
+
+		// Stops the session gracefully, so the server doesn't log it as an error
+		SendRequest(OVT_PAYLOAD_TYPE_STOP, session_id, 3);
+	}
+
+	bool OvtViewer::SendRequest(uint8_t payload_type, uint32_t session_id, uint32_t request_id)
+	{
+		auto payload = OvtControlMessage::SerializeRequest(OvtControlMessage::Format::Json, request_id, _url->Source());
+
+		if (payload == nullptr)
+		{
+			return false;
+		}
+
+		OvtPacket packet;
+
+		packet.SetSessionId(session_id);
+		packet.SetPayloadType(payload_type);
+		packet.SetMarker(0);
+		packet.SetTimestampNow();
+		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+
+		return _connection.Send(packet.GetData());
+	}
+
+	std::shared_ptr<OvtPacket> OvtViewer::ReceivePacket()
+	{
+		ov::Data buffer(OVT_MAX_PACKET_SIZE);
+		buffer.SetLength(OVT_FIXED_HEADER_SIZE);
+
+		if (_connection.RecvExactly(buffer.GetWritableData(), OVT_FIXED_HEADER_SIZE, _stop_flag) == false)
+		{
+			return nullptr;
+		}
+
+		auto packet = std::make_shared<OvtPacket>();
+
+		if (packet->LoadHeader(buffer) == false)
+		{
+			logte("Invalid OVT packet: %s", _url->Source().CStr());
+			return nullptr;
+		}
+
+		auto payload_length = packet->PayloadLength();
+		buffer.SetLength(payload_length);
+
+		if ((payload_length > 0) && (_connection.RecvExactly(buffer.GetWritableData(), payload_length, _stop_flag) == false))
+		{
+			return nullptr;
+		}
+
+		if (packet->SetPayload(buffer.GetDataAs<uint8_t>(), payload_length) == false)
+		{
+			return nullptr;
+		}
+
+		_statistics->viewer_bytes += OVT_FIXED_HEADER_SIZE + payload_length;
+
+		return packet;
+	}
+
+	std::shared_ptr<OvtPacket> OvtViewer::ReceiveMessage(std::shared_ptr<ov::Data> *message)
+	{
+		*message = std::make_shared<ov::Data>();
+
+		while (true)
+		{
+			auto packet = ReceivePacket();
+
+			if (packet == nullptr)
+			{
+				return nullptr;
+			}
+
+			if (packet->PayloadType() == OVT_PAYLOAD_TYPE_MEDIA_PACKET)
+			{
+				// Not a response
+				continue;
+			}
+
+			(*message)->Append(packet->Payload(), packet->PayloadLength());
+
+			if (packet->Marker())
+			{
+				return packet;
+			}
+		}
+	}
+
+	std::shared_ptr<OvtControlMessage> OvtViewer::ReceiveResponse(uint32_t request_id, uint32_t *session_id)
+	{
+		std::shared_ptr<ov::Data> message;
+		auto packet = ReceiveMessage(&message);
+
+		if (packet == nullptr)
+		{
+			return nullptr;
+		}
+
+		auto response = OvtControlMessage::Parse(message);
+
+		if ((response == nullptr) || (response->IsValidResponse() == false) || (response->GetId() != request_id))
+		{
+			logte("Invalid response: %s", _url->Source().CStr());
+			return nullptr;
+		}
+
+		if (response->GetCode() != 200)
+		{
+			logte("The server responded with %d (%s): %s", response->GetCode(), response->GetMessage().CStr(), _url->Source().CStr());
+			return nullptr;
+		}
+
+		*session_id = packet->SessionId();
+
+		return response;
+	}
+
+	void OvtViewer::OnMediaPacket(const std::shared_ptr<OvtPacket> &packet)
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		_statistics->viewer_packets++;
+
+		if (_has_last_sequence_number)
+		{
+			uint16_t expected_sequence_number = _last_sequence_number + 1;
+			// The sequence number is 16 bits, so the gap is calculated with the wrap-around
+			uint16_t gap = packet->SequenceNumber() - expected_sequence_number;
+
+			if ((gap > 0) && (gap < 0x8000))
+			{
+				_statistics->lost_packets += gap;
+			}
+		}
+
+		_has_last_sequence_number = true;
+		_last_sequence_number = packet->SequenceNumber();
+
+		bool is_first_packet_of_media = _is_first_packet_of_media;
+		_is_first_packet_of_media = packet->Marker();
+
+		if ((is_first_packet_of_media == false) || (packet->PayloadLength() < MEDIA_PACKET_HEADER_SIZE))
+		{
+			return;
+		}
+
+		if (_is_joined == false)
+		{
+			_is_joined = true;
+			_statistics->join_time.Add(std::chrono::duration<double, std::milli>(now - _connect_time).count());
+		}
+
+		// The header of the media packet (See OvtDepacketizer::AppendPacket())
+		auto track_id = ByteReader<uint32_t>::ReadBigEndian(&packet->Payload()[0]);
+		auto pts = static_cast<int64_t>(ByteReader<uint64_t>::ReadBigEndian(&packet->Payload()[4]));
+
+		auto timebase = _timebases.find(track_id);
+		std::chrono::steady_clock::time_point start_time;
+
+		if ((timebase == _timebases.end()) || (_ingest.GetStartTime(&start_time) == false))
+		{
+			return;
+		}
+
+		// The timestamps of RTMP are passed through if the stream is not transcoded, so the PTS is the time since the ingest started
+		auto sent_time = start_time + std::chrono::microseconds(static_cast<int64_t>(pts * timebase->second * 1000000.0));
+		auto latency = std::chrono::duration<double, std::milli>(now - sent_time).count();
+
+		if (latency >= 0.0)
+		{
+			_statistics->latency.Add(latency);
+		}
+	}
+}  // namespace load
@@ -0,0 +1,63 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <modules/ovt_packetizer/ovt_control_message.h>
+#include <modules/ovt_packetizer/ovt_packet.h>
+
+#include <thread>
+
+#include "connection.h"
+#include "rtmp_ingest.h"
+#include "statistics.h"
+
+namespace load
+{
+	// Plays a stream over OVT (the same as an edge), and measures the join time/loss/latency
+	class OvtViewer
+	{
+	public:
+		// url: ovt://<host>:<port>/<app>/<stream>
+		OvtViewer(const std::shared_ptr<const ov::Url> &url, const RtmpIngest &ingest, Statistics *statistics);
+		~OvtViewer();
+
+		bool Start();
+		void Stop();
+
+	protected:
+		void Run();
+
+		bool SendRequest(uint8_t payload_type, uint32_t session_id, uint32_t request_id);
+		std::shared_ptr<OvtPacket> ReceivePacket();
+		// Receives the control message (that can be split into the packets)
+		std::shared_ptr<OvtPacket> ReceiveMessage(std::shared_ptr<ov::Data> *message);
+		// Returns the response if it is succeeded
+		std::shared_ptr<OvtControlMessage> ReceiveResponse(uint32_t request_id, uint32_t *session_id);
+
+		void OnMediaPacket(const std::shared_ptr<OvtPacket> &packet);
+
+		std::shared_ptr<const ov::Url> _url;
+		const RtmpIngest &_ingest;
+		Statistics *_statistics;
+
+		Connection _connection;
+
+		// track id => timebase (sec)
+		std::map<uint32_t, double> _timebases;
+
+		std::chrono::steady_clock::time_point _connect_time;
+		bool _is_joined = false;
+		bool _has_last_sequence_number = false;
+		uint16_t _last_sequence_number = 0;
+		// A media packet is split into the OVT packets, and the first one has the header of the media packet
+		bool _is_first_packet_of_media = true;
+
+		std::thread _thread;
+		std::atomic<bool> _stop_flag{false};
+	};
+}  // namespace load
@@ -0,0 +1,419 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_ingest.h"
+
+#include <providers/rtmp/chunk/rtmp_define.h>
+#include <providers/rtmp/chunk/rtmp_handshake.h>
+
+#include "load_generator_private.h"
+
+// The chunk size of OBS
+#define RTMP_INGEST_CHUNK_SIZE 4096
+#define RTMP_INGEST_CONNECT_TIMEOUT_MSEC 3000
+#define RTMP_INGEST_COMMAND_TIMEOUT_MSEC 5000
+
+namespace load
+{
+	RtmpIngest::RtmpIngest(const std::shared_ptr<const ov::Url> &url, const ov::String &stream_name, const FlvFile &flv_file, Statistics *statistics)
+		: _url(url),
+		  _stream_name(stream_name),
+		  _flv_file(flv_file),
+		  _statistics(statistics),
+		  // SetChunkSize is sent first, so all messages use RTMP_INGEST_CHUNK_SIZE except SetChunkSize itself
+		  _export_chunk(false, RTMP_INGEST_CHUNK_SIZE),
+		  _import_chunk(RTMP_DEFAULT_CHUNK_SIZE)
+	{
+	}
+
+	RtmpIngest::~RtmpIngest()
+	{
+		Stop();
+	}
+
+	bool RtmpIngest::Start()
+	{
+		_thread = std::thread(&RtmpIngest::Run, this);
+		pthread_setname_np(_thread.native_handle(), "RtmpIngest");
+
+		return true;
+	}
+
+	void RtmpIngest::Stop()
+	{
+		_stop_flag = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+
+		_connection.Close();
+	}
+
+	void RtmpIngest::Run()
+	{
+		auto connect_time = std::chrono::steady_clock::now();
+		auto port = (_url->Port() > 0) ? _url->Port() : 1935;
+
+		if ((_connection.Connect(_url->Domain(), port, RTMP_INGEST_CONNECT_TIMEOUT_MSEC) == false) ||
+			(Handshake() == false) ||
+			(Publish() == false))
+		{
+			if (_stop_flag == false)
+			{
+				logte("Could not publish the stream: %s", _stream_name.CStr());
+				_statistics->ingest_failures++;
+			}
+
+			return;
+		}
+
+		_statistics->publish_time.Add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - connect_time).count());
+
+		logtd("The stream is published: %s", _stream_name.CStr());
+
+		if ((SendTags() == false) && (_stop_flag == false))
+		{
+			logte("The stream is disconnected: %s", _stream_name.CStr());
+			_statistics->ingest_failures++;
+		}
+	}
+
+	bool RtmpIngest::Handshake()
+	{
+		// C0 + C1
+		std::vector<uint8_t> c0_c1(sizeof(uint8_t) + RTMP_HANDSHAKE_PACKET_SIZE);
+
+		c0_c1[0] = RTMP_HANDSHAKE_VERSION;
+		RtmpHandshake::MakeC1(&c0_c1[1]);
+
+		if (_connection.Send(c0_c1.data(), c0_c1.size()) == false)
+		{
+			return false;
+		}
+
+		// S0 + S1 + S2
+		std::vector<uint8_t> s0_s1_s2(sizeof(uint8_t) + (RTMP_HANDSHAKE_PACKET_SIZE * 2));
+
+		if (_connection.RecvExactly(s0_s1_s2.data(), s0_s1_s2.size(), _stop_flag) == false)
+		{
+			return false;
+		}
+
+		if (s0_s1_s2[0] != RTMP_HANDSHAKE_VERSION)
+		{
+			logte("Invalid RTMP version: %d", s0_s1_s2[0]);
+			return false;
+		}
+
+		// C2: the echo of S1
+		return _connection.Send(&s0_s1_s2[1], RTMP_HANDSHAKE_PACKET_SIZE);
+	}
+
+	bool RtmpIngest::Publish()
+	{
+		// SetChunkSize (the chunk size is not changed yet, so it is exported with the default chunk size)
+		{
+			RtmpExportChunk export_chunk(false, RTMP_DEFAULT_CHUNK_SIZE);
+			auto payload = std::make_shared<std::vector<uint8_t>>(sizeof(uint32_t));
+			RtmpMuxUtil::WriteInt32(payload->data(), RTMP_INGEST_CHUNK_SIZE);
+
+			auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_URGENT, 0, RTMP_MSGID_SET_CHUNK_SIZE, 0, payload->size());
+			auto chunks = export_chunk.ExportStreamData(message_header, payload);
+
+			if ((chunks == nullptr) || (_connection.Send(chunks->data(), chunks->size()) == false))
+			{
+				return false;
+			}
+		}
+
+		AmfDocument response;
+		auto tc_url = ov::String::FormatString("rtmp://%s:%d/%s", _url->Domain().CStr(), (_url->Port() > 0) ? _url->Port() : 1935, _url->App().CStr());
+
+		// connect
+		{
+			AmfDocument document;
+			auto object = new AmfObject;
+
+			object->AddProperty("app", _url->App().CStr());
+			object->AddProperty("type", "nonprivate");
+			object->AddProperty("flashVer", "FMLE/3.0 (compatible; OvenMediaEngineLoad)");
+			object->AddProperty("tcUrl", tc_url.CStr());
+
+			document.AddProperty(RTMP_CMD_NAME_CONNECT);
+			document.AddProperty(++_transaction_id);
+			document.AddProperty(object);
+
+			if ((SendCommand(0, document) == false) || (WaitForCommand(RTMP_ACK_NAME_RESULT, &response) == false))
+			{
+				return false;
+			}
+		}
+
+		// createStream
+		{
+			AmfDocument document;
+
+			document.AddProperty(RTMP_CMD_NAME_CREATESTREAM);
+			document.AddProperty(++_transaction_id);
+			document.AddProperty(AmfDataType::Null);
+
+			AmfDocument create_stream_response;
+
+			if ((SendCommand(0, document) == false) || (WaitForCommand(RTMP_ACK_NAME_RESULT, &create_stream_response) == false))
+			{
+				return false;
+			}
+
+			auto stream_id = create_stream_response.GetProperty(3);
+
+			_rtmp_stream_id = ((stream_id != nullptr) && (stream_id->GetType() == AmfDataType::Number)) ? static_cast<uint32_t>(stream_id->GetNumber()) : 1;
+		}
+
+		// publish
+		{
+			AmfDocument document;
+
+			document.AddProperty(RTMP_CMD_NAME_PUBLISH);
+			document.AddProperty(++_transaction_id);
+			document.AddProperty(AmfDataType::Null);
+			document.AddProperty(_stream_name.CStr());
+			document.AddProperty("live");
+
+			AmfDocument on_status;
+
+			if ((SendCommand(_rtmp_stream_id, document) == false) || (WaitForCommand(RTMP_CMD_NAME_ONSTATUS, &on_status) == false))
+			{
+				return false;
+			}
+
+			auto info = on_status.GetProperty(3);
+
+			if ((info == nullptr) || (info->GetType() != AmfDataType::Object))
+			{
+				logte("Invalid onStatus of the stream: %s", _stream_name.CStr());
+				return false;
+			}
+
+			auto index = info->GetObject()->FindName("code");
+			ov::String code = (index >= 0) ? info->GetObject()->GetString(index) : "";
+
+			if (code != "NetStream.Publish.Start")
+			{
+				logte("The stream is rejected: %s (%s)", _stream_name.CStr(), code.CStr());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool RtmpIngest::SendTags()
+	{
+		auto &tags = _flv_file.GetTags();
+		// A frame interval is added when the file is looped, so the timestamps don't overlap
+		int64_t loop_duration = _flv_file.GetDuration() + 33;
+		int64_t loop_offset = 0;
+
+		auto start_time = std::chrono::steady_clock::now();
+		_start_time_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(start_time.time_since_epoch()).count();
+
+		while (_stop_flag == false)
+		{
+			for (auto &tag : tags)
+			{
+				if (_stop_flag)
+				{
+					break;
+				}
+
+				int64_t timestamp = tag.timestamp + loop_offset;
+
+				// Sends the tag in real time
+				std::this_thread::sleep_until(start_time + std::chrono::milliseconds(timestamp));
+
+				uint32_t chunk_stream_id = (tag.type == RTMP_MSGID_AMF0_DATA_MESSAGE) ? RTMP_CHUNK_STREAM_ID_CONTROL : RTMP_CHUNK_STREAM_ID_MEDIA;
+
+				if (SendMessage(chunk_stream_id, tag.type, _rtmp_stream_id, timestamp, tag.data) == false)
+				{
+					return false;
+				}
+
+				_statistics->ingest_bytes += tag.data->size();
+
+				// Acknowledgements, pings, ... are not handled, but must be drained
+				if (ReceiveMessages(0) == false)
+				{
+					return false;
+				}
+			}
+
+			loop_offset += loop_duration;
+		}
+
+		return true;
+	}
+
+	bool RtmpIngest::SendMessage(uint32_t chunk_stream_id, uint8_t type_id, uint32_t stream_id, int64_t timestamp, const std::shared_ptr<std::vector<uint8_t>> &payload)
+	{
+		auto message_header = std::make_shared<RtmpMuxMessageHeader>(chunk_stream_id, static_cast<uint32_t>(timestamp), type_id, stream_id, payload->size());
+		auto data = payload;
+
+		auto chunks = _export_chunk.ExportStreamData(message_header, data);
+
+		if (chunks == nullptr)
+		{
+			return false;
+		}
+
+		return _connection.Send(chunks->data(), chunks->size());
+	}
+
+	bool RtmpIngest::SendCommand(uint32_t stream_id, AmfDocument &document)
+	{
+		auto payload = std::make_shared<std::vector<uint8_t>>(2048);
+		auto payload_size = document.Encode(payload->data());
+
+		if (payload_size <= 0)
+		{
+			return false;
+		}
+
+		payload->resize(payload_size);
+
+		return SendMessage(RTMP_CHUNK_STREAM_ID_CONTROL, RTMP_MSGID_AMF0_COMMAND_MESSAGE, stream_id, 0, payload);
+	}
+
+	bool RtmpIngest::WaitForCommand(const char *name, AmfDocument *document)
+	{
+		auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(RTMP_INGEST_COMMAND_TIMEOUT_MSEC);
+
+		while ((_stop_flag == false) && (std::chrono::steady_clock::now() < timeout))
+		{
+			while (_commands.empty() == false)
+			{
+				auto message = _commands.front();
+				_commands.pop_front();
+
+				AmfDocument command;
+
+				if (command.Decode(message->payload->GetData(), message->payload->GetLength()) == 0)
+				{
+					continue;
+				}
+
+				auto command_name = command.GetProperty(0);
+
+				if ((command_name == nullptr) || (command_name->GetType() != AmfDataType::String))
+				{
+					continue;
+				}
+
+				if (::strcmp(command_name->GetString(), RTMP_ACK_NAME_ERROR) == 0)
+				{
+					logte("The server responded with an error for %s: %s", name, _stream_name.CStr());
+					return false;
+				}
+
+				if (::strcmp(command_name->GetString(), name) == 0)
+				{
+					// AmfDocument cannot be copied, so the payload is decoded again
+					return document->Decode(message->payload->GetData(), message->payload->GetLength()) > 0;
+				}
+			}
+
+			if (ReceiveMessages(100) == false)
+			{
+				return false;
+			}
+		}
+
+		if (_stop_flag == false)
+		{
+			logte("Timed out while waiting for %s: %s", name, _stream_name.CStr());
+		}
+
+		return false;
+	}
+
+	bool RtmpIngest::ReceiveMessages(int timeout_msec)
+	{
+		uint8_t buffer[16 * 1024];
+		size_t received_length = 0;
+
+		switch (_connection.Recv(buffer, sizeof(buffer), &received_length, timeout_msec))
+		{
+			case Connection::RecvResult::Received:
+				break;
+
+			case Connection::RecvResult::Timeout:
+				return true;
+
+			case Connection::RecvResult::Closed:
+				return false;
+		}
+
+		auto data = std::make_shared<ov::Data>();
+
+		if (_remained_data != nullptr)
+		{
+			data->Append(_remained_data);
+		}
+
+		data->Append(buffer, received_length);
+
+		std::shared_ptr<const ov::Data> current_data = data;
+
+		while (current_data->IsEmpty() == false)
+		{
+			bool is_completed = false;
+			auto import_size = _import_chunk.Import(current_data, &is_completed);
+
+			if (import_size == 0)
+			{
+				// Need more data
+				break;
+			}
+			else if (import_size < 0)
+			{
+				logte("Could not parse the data from the server: %s", _stream_name.CStr());
+				return false;
+			}
+
+			while (is_completed)
+			{
+				auto message = _import_chunk.GetMessage();
+
+				if ((message == nullptr) || (message->payload == nullptr))
+				{
+					break;
+				}
+
+				switch (message->header->completed.type_id)
+				{
+					case RTMP_MSGID_SET_CHUNK_SIZE:
+						_import_chunk.SetChunkSize(RtmpMuxUtil::ReadInt32(message->payload->GetData()));
+						break;
+
+					case RTMP_MSGID_AMF0_COMMAND_MESSAGE:
+						_commands.push_back(message);
+						break;
+
+					default:
+						break;
+				}
+			}
+
+			current_data = current_data->Subdata(import_size);
+		}
+
+		_remained_data = current_data->IsEmpty() ? nullptr : current_data->Clone();
+
+		return true;
+	}
+}  // namespace load
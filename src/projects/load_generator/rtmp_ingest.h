@@ -0,0 +1,88 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <providers/rtmp/chunk/amf_document.h>
+#include <providers/rtmp/chunk/rtmp_export_chunk.h>
+#include <providers/rtmp/chunk/rtmp_import_chunk.h>
+
+#include <thread>
+
+#include "connection.h"
+#include "flv_file.h"
+#include "statistics.h"
+
+namespace load
+{
+	// Publishes a FLV file to OvenMediaEngine in real time (the file is looped until Stop() is called)
+	class RtmpIngest
+	{
+	public:
+		// url: rtmp://<host>[:<port>]/<app>
+		RtmpIngest(const std::shared_ptr<const ov::Url> &url, const ov::String &stream_name, const FlvFile &flv_file, Statistics *statistics);
+		~RtmpIngest();
+
+		bool Start();
+		void Stop();
+
+		const ov::String &GetStreamName() const
+		{
+			return _stream_name;
+		}
+
+		// The time when the frame of timestamp 0 is sent (the viewers calculate the latency from this)
+		// Returns false if the stream is not published yet
+		bool GetStartTime(std::chrono::steady_clock::time_point *start_time) const
+		{
+			auto start_time_nsec = _start_time_nsec.load();
+
+			if (start_time_nsec == 0)
+			{
+				return false;
+			}
+
+			*start_time = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(start_time_nsec));
+			return true;
+		}
+
+	protected:
+		void Run();
+
+		bool Handshake();
+		bool Publish();
+		bool SendTags();
+
+		bool SendMessage(uint32_t chunk_stream_id, uint8_t type_id, uint32_t stream_id, int64_t timestamp, const std::shared_ptr<std::vector<uint8_t>> &payload);
+		bool SendCommand(uint32_t stream_id, AmfDocument &document);
+		// Waits for the command (_result/onStatus/...) from the server
+		bool WaitForCommand(const char *name, AmfDocument *document);
+		// Processes the messages from the server (timeout_msec: 0 to process the received data only)
+		bool ReceiveMessages(int timeout_msec);
+
+		std::shared_ptr<const ov::Url> _url;
+		ov::String _stream_name;
+		const FlvFile &_flv_file;
+		Statistics *_statistics;
+
+		Connection _connection;
+		RtmpExportChunk _export_chunk;
+		RtmpImportChunk _import_chunk;
+		std::shared_ptr<const ov::Data> _remained_data;
+		// The commands that are received from the server, but not handled yet
+		std::deque<std::shared_ptr<const RtmpMessage>> _commands;
+
+		double _transaction_id = 0.0;
+		uint32_t _rtmp_stream_id = 0;
+
+		// The viewers read it from their threads
+		std::atomic<int64_t> _start_time_nsec{0};
+
+		std::thread _thread;
+		std::atomic<bool> _stop_flag{false};
+	};
+}  // namespace load
@@ -0,0 +1,77 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "statistics.h"
+
+#include <algorithm>
+
+namespace load
+{
+	void Samples::Add(double value)
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		_count++;
+		_sum += value;
+		_max = (_count == 1) ? value : std::max(_max, value);
+
+		if (_samples.size() < MaxKeptSamples)
+		{
+			_samples.push_back(value);
+			return;
+		}
+
+		// Reservoir sampling, so the percentiles are not biased to the first samples
+		auto index = std::uniform_int_distribution<size_t>(0, _count - 1)(_random);
+
+		if (index < MaxKeptSamples)
+		{
+			_samples[index] = value;
+		}
+	}
+
+	size_t Samples::GetCount() const
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		return _count;
+	}
+
+	double Samples::GetAverage() const
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		return (_count > 0) ? (_sum / _count) : 0.0;
+	}
+
+	double Samples::GetPercentile(double percentile) const
+	{
+		std::vector<double> samples;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_mutex);
+			samples = _samples;
+		}
+
+		if (samples.empty())
+		{
+			return 0.0;
+		}
+
+		auto index = static_cast<size_t>((std::clamp(percentile, 0.0, 100.0) / 100.0) * (samples.size() - 1) + 0.5);
+		std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+		return samples[index];
+	}
+
+	double Samples::GetMax() const
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		return _max;
+	}
+}  // namespace load
@@ -0,0 +1,63 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <random>
+
+namespace load
+{
+	// The samples of a metric (msec) that are collected from all ingests/viewers
+	class Samples
+	{
+	public:
+		void Add(double value);
+
+		size_t GetCount() const;
+		double GetAverage() const;
+		// percentile: 0 ~ 100
+		double GetPercentile(double percentile) const;
+		double GetMax() const;
+
+	private:
+		// The number of the samples that are kept for the percentiles (the older samples are replaced randomly)
+		static constexpr size_t MaxKeptSamples = 100000;
+
+		mutable std::mutex _mutex;
+
+		std::vector<double> _samples;
+		size_t _count = 0;
+		double _sum = 0.0;
+		double _max = 0.0;
+
+		std::mt19937 _random{0x4F564C47};
+	};
+
+	struct Statistics
+	{
+		// Ingest: from the connection to NetStream.Publish.Start
+		Samples publish_time;
+		// Viewer: from the connection to the first media
+		Samples join_time;
+		// Viewer: from the time the ingest sends the frame to the time the viewer receives it (OVT only)
+		Samples latency;
+		// HLS viewer: the time to download a segment
+		Samples segment_time;
+
+		std::atomic<uint64_t> ingest_bytes{0};
+		std::atomic<uint64_t> viewer_bytes{0};
+		std::atomic<uint64_t> viewer_packets{0};
+		std::atomic<uint64_t> lost_packets{0};
+
+		std::atomic<uint32_t> ingest_failures{0};
+		std::atomic<uint32_t> viewer_failures{0};
+		// The viewers that didn't receive any media until the end
+		std::atomic<uint32_t> join_failures{0};
+	};
+}  // namespace load
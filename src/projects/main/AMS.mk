@@ -5,21 +5,29 @@ LOCAL_STATIC_LIBRARIES := \
 	webrtc_publisher \
 	segment_publishers \
 	ovt_publisher \
+	rtmp_publisher \
+	record_publisher \
 	ovt_provider \
 	rtmp_provider \
 	rtspc_provider \
+	webrtc_provider \
+	srt_provider \
+	replay_provider \
 	transcoder \
 	rtc_signalling \
 	ice \
 	jsoncpp \
+	monitoring \
 	http_server \
 	signed_url \
 	dtls_srtp \
 	rtp_rtcp \
 	sdp \
+	mpegts \
 	h264 \
 	web_console \
 	mediarouter \
+	media_capture \
 	ovt_packetizer \
 	orchestrator \
 	publisher \
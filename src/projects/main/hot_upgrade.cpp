@@ -0,0 +1,300 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "./hot_upgrade.h"
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <fcntl.h>
+#include <modules/physical_port/physical_port_manager.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "./main_private.h"
+
+// The descriptor of the channel that is passed to the new process
+#define HOT_UPGRADE_CHANNEL_ENV "OME_UPGRADE_FD"
+// Sent by the new process when the modules are ready
+#define HOT_UPGRADE_READY_MESSAGE 'R'
+
+extern char **environ;
+
+enum class HotUpgradeState
+{
+	Idle,
+	// The new process is executed, and the old process waits for it to be ready
+	WaitingForReady,
+	// The new process accepts the clients, and the old process waits for its clients to be disconnected
+	Draining
+};
+
+static bool g_is_hot_upgrade_enabled = false;
+static int64_t g_drain_timeout_ms = 0;
+
+static ov::String g_executable_path;
+static std::vector<ov::String> g_argument_list;
+
+static HotUpgradeState g_hot_upgrade_state = HotUpgradeState::Idle;
+// Old process: the channel to the new process, New process: the channel to the old process
+static int g_hot_upgrade_channel = -1;
+static pid_t g_new_process_id = -1;
+static int64_t g_drain_start_ms = 0;
+
+bool InitializeHotUpgrade(int argc, char *argv[], const cfg::HotUpgrade &config)
+{
+	g_is_hot_upgrade_enabled = config.IsEnabled();
+	g_drain_timeout_ms = static_cast<int64_t>(config.GetDrainTimeout()) * 1000LL;
+
+	if (g_is_hot_upgrade_enabled == false)
+	{
+		return true;
+	}
+
+	// The binary can be replaced after it is executed, so the path is used instead of /proc/self/exe
+	char path[PATH_MAX]{};
+	auto length = ::readlink("/proc/self/exe", path, sizeof(path) - 1);
+
+	if (length <= 0)
+	{
+		logte("Could not obtain the path of the executable: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		g_is_hot_upgrade_enabled = false;
+		return false;
+	}
+
+	g_executable_path = ov::String(path, length);
+
+	for (int index = 0; index < argc; index++)
+	{
+		g_argument_list.emplace_back(argv[index]);
+	}
+
+	logti("Hot upgrade is enabled (SIGUSR2, executable: %s, drain timeout: %lld ms)", g_executable_path.CStr(), static_cast<long long>(g_drain_timeout_ms));
+
+	return true;
+}
+
+bool ReceiveInheritedPorts()
+{
+	auto channel_env = ::getenv(HOT_UPGRADE_CHANNEL_ENV);
+
+	if (channel_env == nullptr)
+	{
+		return true;
+	}
+
+	int channel = ov::Converter::ToInt32(channel_env);
+	// The next upgrade must not see this
+	::unsetenv(HOT_UPGRADE_CHANNEL_ENV);
+
+	if (channel <= STDERR_FILENO)
+	{
+		logte("Invalid channel of hot upgrade: %s", channel_env);
+		return false;
+	}
+
+	// Don't pass the channel to the processes executed by this process
+	::fcntl(channel, F_SETFD, FD_CLOEXEC);
+
+	g_hot_upgrade_channel = channel;
+
+	logti("Trying to receive the sockets from the previous process...");
+
+	return PhysicalPortManager::Instance()->ReceivePorts(channel);
+}
+
+bool NotifyUpgradeReady()
+{
+	if (g_hot_upgrade_channel < 0)
+	{
+		return true;
+	}
+
+	PhysicalPortManager::Instance()->CloseInheritedHandles();
+
+	char message = HOT_UPGRADE_READY_MESSAGE;
+	bool result = (::send(g_hot_upgrade_channel, &message, sizeof(message), MSG_NOSIGNAL) == sizeof(message));
+
+	if (result == false)
+	{
+		logte("Could not notify the previous process: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+	}
+
+	::close(g_hot_upgrade_channel);
+	g_hot_upgrade_channel = -1;
+
+	return result;
+}
+
+bool StartHotUpgrade()
+{
+	if (g_is_hot_upgrade_enabled == false)
+	{
+		logtw("Hot upgrade is requested, but it is disabled");
+		return false;
+	}
+
+	if (g_hot_upgrade_state != HotUpgradeState::Idle)
+	{
+		logtw("Hot upgrade is already in progress");
+		return false;
+	}
+
+	int channels[2];
+
+	if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, channels) != 0)
+	{
+		logte("Could not create the channel for hot upgrade: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return false;
+	}
+
+	::fcntl(channels[0], F_SETFD, FD_CLOEXEC);
+
+	// The arguments and the environments are prepared before fork(), only async-signal-safe functions can be called in the child
+	std::vector<char *> argument_list;
+
+	for (auto &argument : g_argument_list)
+	{
+		argument_list.push_back(const_cast<char *>(argument.CStr()));
+	}
+
+	argument_list.push_back(nullptr);
+
+	auto channel_env = ov::String::FormatString(HOT_UPGRADE_CHANNEL_ENV "=%d", channels[1]);
+	std::vector<char *> env_list;
+
+	for (auto env = environ; *env != nullptr; env++)
+	{
+		if (::strncmp(*env, HOT_UPGRADE_CHANNEL_ENV "=", sizeof(HOT_UPGRADE_CHANNEL_ENV)) != 0)
+		{
+			env_list.push_back(*env);
+		}
+	}
+
+	env_list.push_back(const_cast<char *>(channel_env.CStr()));
+	env_list.push_back(nullptr);
+
+	int max_descriptor = static_cast<int>(::sysconf(_SC_OPEN_MAX));
+	max_descriptor = (max_descriptor > 0) ? std::min(max_descriptor, 65536) : 1024;
+
+	// libsrt owns the UDP sockets of the SRT ports, so they are released for the new process to bind them
+	PhysicalPortManager::Instance()->ClosePorts(ov::SocketType::Srt);
+
+	logti("Trying to execute the new process for hot upgrade: %s", g_executable_path.CStr());
+
+	auto pid = ::fork();
+
+	if (pid == 0)
+	{
+		// The descriptors of the clients must not be kept by the new process, or the connections are not closed by the old process
+		for (int descriptor = STDERR_FILENO + 1; descriptor < max_descriptor; descriptor++)
+		{
+			if (descriptor != channels[1])
+			{
+				::close(descriptor);
+			}
+		}
+
+		::execve(g_executable_path.CStr(), argument_list.data(), env_list.data());
+		::_exit(1);
+	}
+
+	::close(channels[1]);
+
+	if (pid < 0)
+	{
+		logte("Could not fork the process: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		::close(channels[0]);
+		PhysicalPortManager::Instance()->ReopenPorts(ov::SocketType::Srt);
+		return false;
+	}
+
+	g_new_process_id = pid;
+	g_hot_upgrade_channel = channels[0];
+
+	if (PhysicalPortManager::Instance()->SendPorts(g_hot_upgrade_channel) == false)
+	{
+		// The new process will fail to bind the ports, and the channel is closed
+		logte("Could not send the sockets to the new process (pid: %d)", pid);
+	}
+
+	g_hot_upgrade_state = HotUpgradeState::WaitingForReady;
+
+	return true;
+}
+
+bool ProcessHotUpgrade()
+{
+	if (g_new_process_id > 0)
+	{
+		// If the new process is started as a service, it forks again and the parent exits
+		if (::waitpid(g_new_process_id, nullptr, WNOHANG) == g_new_process_id)
+		{
+			g_new_process_id = -1;
+		}
+	}
+
+	switch (g_hot_upgrade_state)
+	{
+		case HotUpgradeState::Idle:
+			break;
+
+		case HotUpgradeState::WaitingForReady: {
+			pollfd poll_fd{g_hot_upgrade_channel, POLLIN, 0};
+
+			if (::poll(&poll_fd, 1, 0) <= 0)
+			{
+				break;
+			}
+
+			char message = 0;
+			auto read_bytes = ::recv(g_hot_upgrade_channel, &message, sizeof(message), 0);
+
+			::close(g_hot_upgrade_channel);
+			g_hot_upgrade_channel = -1;
+
+			if ((read_bytes != sizeof(message)) || (message != HOT_UPGRADE_READY_MESSAGE))
+			{
+				// The new process is terminated before it is ready, so the old process keeps serving
+				logte("The new process could not be started, hot upgrade is cancelled");
+				PhysicalPortManager::Instance()->ReopenPorts(ov::SocketType::Srt);
+				g_hot_upgrade_state = HotUpgradeState::Idle;
+				break;
+			}
+
+			logti("The new process is ready, stop accepting the new clients...");
+
+			PhysicalPortManager::Instance()->StopAccepting();
+
+			g_drain_start_ms = ov::Clock::NowMs();
+			g_hot_upgrade_state = HotUpgradeState::Draining;
+
+			break;
+		}
+
+		case HotUpgradeState::Draining: {
+			auto client_count = PhysicalPortManager::Instance()->GetClientCount();
+
+			if (client_count == 0)
+			{
+				logti("All clients are disconnected, the old process will be terminated");
+				return true;
+			}
+
+			if ((g_drain_timeout_ms > 0) && ((ov::Clock::NowMs() - g_drain_start_ms) >= g_drain_timeout_ms))
+			{
+				logtw("The old process will be terminated with %d client(s) (drain timeout: %lld ms)", client_count, static_cast<long long>(g_drain_timeout_ms));
+				return true;
+			}
+
+			break;
+		}
+	}
+
+	return false;
+}
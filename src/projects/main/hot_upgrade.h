@@ -0,0 +1,34 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <config/config_manager.h>
+
+// Hot upgrade (See <Performance><HotUpgrade>)
+//
+// 1) SIGUSR2: The binary is executed again with the same arguments, and the listening sockets are sent to the new process
+// 2) The new process listens to the inherited sockets instead of binding the ports, and notifies when the modules are ready
+// 3) The old process stops accepting, and is terminated when all of its TCP clients are disconnected (or after DrainTimeout)
+//
+// - The UDP sockets are handed over too, but the old process stops receiving the datagrams, so the UDP sessions (such as WebRTC)
+//   have to reconnect to the new process
+// - The SRT ports can't be handed over (libsrt owns the UDP socket), so they are closed before the new process is executed,
+//   and opened again if the new process could not be started
+bool InitializeHotUpgrade(int argc, char *argv[], const cfg::HotUpgrade &config);
+
+// The new process receives the sockets from the old process (before the modules are created)
+bool ReceiveInheritedPorts();
+// The new process notifies the old process that the modules are ready (after the modules are created)
+bool NotifyUpgradeReady();
+
+// Executes the new process (called by the main thread when SIGUSR2 is received)
+bool StartHotUpgrade();
+// The main loop calls this periodically
+// @return true if the old process has been drained, and must be terminated
+bool ProcessHotUpgrade();
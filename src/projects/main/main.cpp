@@ -8,18 +8,31 @@
 //==============================================================================
 #include "main.h"
 
+#include <base/media_route/media_queue_policy.h>
 #include <base/ovlibrary/daemon.h>
 #include <base/ovlibrary/log_write.h>
 #include <config/config_manager.h>
+#include <http_server/http_server.h>
+#include <http_server/https_server.h>
 #include <media_router/media_router.h>
+#include <modules/media_capture/media_capture.h>
+#include <modules/physical_port/physical_port_worker.h>
 #include <monitoring/monitoring.h>
+#include <monitoring/metrics_server.h>
+#include <monitoring/packet_tracer.h>
+#include <monitoring/profiler.h>
 #include <orchestrator/orchestrator.h>
 #include <providers/providers.h>
 #include <publishers/publishers.h>
 #include <sys/utsname.h>
+#include <transcode/transcode_degrade_ladder.h>
+#include <transcode/transcode_scheduler.h>
 #include <transcode/transcoder.h>
 #include <web_console/web_console.h>
 
+#include <future>
+
+#include "./hot_upgrade.h"
 #include "./signals.h"
 #include "./third_parties.h"
 #include "./utilities.h"
@@ -42,6 +55,10 @@
 		return 1;                                        \
 	}
 
+// Creates a module in another thread, and INIT_MODULE() waits for it with get()
+#define CREATE_MODULE_ASYNC(create) \
+	std::async(std::launch::async, [&]() { return create; })
+
 #define RELEASE_MODULE(variable, name)                         \
 	logti("Trying to delete a " name " module");               \
                                                                \
@@ -117,6 +134,248 @@ int main(int argc, char *argv[])
 	const bool is_service = parse_option.start_service;
 
 	std::shared_ptr<cfg::Server> server_config = cfg::ConfigManager::Instance()->GetServer();
+
+	auto &data_pool_config = server_config->GetPerformance().GetDataPool();
+	if (data_pool_config.IsEnabled())
+	{
+		ov::DataPool::SetMaxFreeBytesPerClass(data_pool_config.GetMaxFreeBytesPerClass());
+		ov::DataPool::SetEnabled(true);
+
+		logti("DataPool is enabled (max free bytes per class per thread: %d)", data_pool_config.GetMaxFreeBytesPerClass());
+	}
+
+	auto &numa_config = server_config->GetPerformance().GetNuma();
+	if (numa_config.IsEnabled())
+	{
+		ov::Numa::SetEnabled(true);
+
+		logti("NUMA placement is enabled (%s)", ov::Numa::ToString().CStr());
+	}
+
+	if (numa_config.IsHugePagesEnabled())
+	{
+		ov::DataBuffer::SetHugePagesEnabled(true);
+
+		logti("The large buffers are backed by the huge pages");
+	}
+
+	auto &thread_classes_config = server_config->GetPerformance().GetThreadClasses();
+	if (thread_classes_config.IsEnabled())
+	{
+		const std::vector<std::pair<ov::ThreadClass, const cfg::ThreadClass *>> thread_class_configs = {
+			{ov::ThreadClass::NetworkIo, &thread_classes_config.GetNetworkIo()},
+			{ov::ThreadClass::Media, &thread_classes_config.GetMedia()},
+			{ov::ThreadClass::Encode, &thread_classes_config.GetEncode()},
+			{ov::ThreadClass::Background, &thread_classes_config.GetBackground()}};
+
+		for (const auto &item : thread_class_configs)
+		{
+			auto name = ov::ThreadClasses::StringFromThreadClass(item.first);
+			auto &config = *(item.second);
+			ov::ThreadPolicy policy;
+
+			if (ov::ThreadClasses::ParseScheduler(config.GetScheduler().CStr(), &policy.scheduler) == false)
+			{
+				logte("Unknown scheduler of the %s threads: %s (other, fifo or rr)", name, config.GetScheduler().CStr());
+				return 1;
+			}
+
+			policy.processors = ov::Platform::ParseProcessorList(config.GetCpus().CStr());
+			policy.priority = config.GetPriority();
+			policy.nice = config.GetNice();
+
+			if ((config.GetCpus().IsEmpty() == false) && policy.processors.empty())
+			{
+				logte("Invalid CPUs of the %s threads: %s", name, config.GetCpus().CStr());
+				return 1;
+			}
+
+			if (ov::ThreadClasses::SetPolicy(item.first, policy) == false)
+			{
+				// Mostly because the real-time scheduler or the negative nice value is not permitted (CAP_SYS_NICE)
+				logtw("Could not apply the scheduling policy of the %s threads: %s", name, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			}
+
+			logti("%s threads: CPUs(%s) scheduler(%s) priority(%d) nice(%d)",
+				  name, config.GetCpus().IsEmpty() ? "all" : config.GetCpus().CStr(),
+				  ov::ThreadClasses::StringFromScheduler(policy.scheduler), policy.priority, policy.nice);
+		}
+	}
+
+	auto &capture_config = server_config->GetPerformance().GetCapture();
+	if (capture_config.IsEnabled())
+	{
+		if (capture_config.GetPath().IsEmpty())
+		{
+			logte("<Capture><Path> is required to capture the streams");
+			return 1;
+		}
+
+		MediaCapture::Configure(capture_config.GetPath(), capture_config.GetStreams());
+
+		logti("The incoming streams (%s) are captured to %s", capture_config.GetStreams().CStr(), capture_config.GetPath().CStr());
+	}
+	else if (capture_config.GetPath().IsEmpty() == false)
+	{
+		// The files that are captured before can be replayed
+		MediaCapture::Configure(capture_config.GetPath(), "");
+	}
+
+	if (server_config->GetPerformance().GetMemoryAccounting().IsEnabled())
+	{
+		// The buffers that are allocated before this are not accounted
+		ov::MemoryAccounting::SetEnabled(true);
+
+		logti("The memory of the buffers is accounted by subsystem and stream");
+	}
+
+	TranscodeScheduler::GetInstance()->Configure(server_config->GetPerformance().GetTranscodeBudget());
+
+	auto &transcode_degrade_config = server_config->GetPerformance().GetTranscodeDegrade();
+	TranscodeDegradeLadder::Configure(transcode_degrade_config.IsEnabled(),
+									  transcode_degrade_config.GetHighWatermark() / 100.0,
+									  transcode_degrade_config.GetLowWatermark() / 100.0,
+									  std::max(transcode_degrade_config.GetRecoveryTime(), 0));
+
+	if (server_config->GetPerformance().GetKernelTls().IsEnabled())
+	{
+		ov::TlsData::SetKernelTlsEnabled(true);
+
+		logti("kTLS is enabled (TLS 1.2 with AES-GCM/ChaCha20-Poly1305 is offloaded to the kernel if supported)");
+	}
+
+	auto &tls_session_config = server_config->GetPerformance().GetTlsSession();
+	HttpsServer::SetSessionCacheOptions(std::max(tls_session_config.GetSessionCacheSize(), 0), std::max(tls_session_config.GetSessionTimeout(), 1));
+	HttpsServer::SetEarlyDataOptions(static_cast<uint32_t>(tls_session_config.GetMaxEarlyData()));
+
+	if (tls_session_config.GetTicketKeyFile().IsEmpty())
+	{
+		ov::TlsTicketKeys::GetShared()->SetRotationInterval(tls_session_config.GetTicketKeyRotation());
+	}
+	else if (ov::TlsTicketKeys::GetShared()->LoadKeyFile(tls_session_config.GetTicketKeyFile()) == false)
+	{
+		return 1;
+	}
+
+	if ((tls_session_config.GetHandshakeThreadCount() > 0) &&
+		(HttpsServer::GetHandshakeExecutor()->Start("TlsHandshake", tls_session_config.GetHandshakeThreadCount(), ov::ThreadClass::NetworkIo) == false))
+	{
+		logte("Could not start the TLS handshake threads");
+		return 1;
+	}
+
+	if (server_config->GetPerformance().GetHttp2().IsEnabled())
+	{
+		HttpServer::SetHttp2Enabled(true);
+
+		logti("HTTP/2 is enabled");
+	}
+
+	// Before the ports are created
+	ov::ServerSocket::SetAcceptOptions(server_config->GetPerformance().GetTcpAccept().ToSocketOptions());
+
+	if (server_config->GetPerformance().GetIoUring().IsEnabled())
+	{
+		if (ov::ServerSocket::SetIoUringEnabled(true))
+		{
+			logti("io_uring is enabled (the data of the TCP clients is received in a batch per event loop)");
+		}
+		else
+		{
+			logtw("io_uring is not supported by this kernel (5.7+ is required), recv() is used instead");
+		}
+	}
+
+	auto &backpressure_config = server_config->GetPerformance().GetBackpressure();
+	ov::QueueOverflowPolicy overflow_policy;
+
+	if (MediaQueuePolicy::ParsePolicy(backpressure_config.GetPolicy(), &overflow_policy) == false)
+	{
+		logte("Unknown backpressure policy: %s (dropnonreference, droptokeyframe or disconnect)", backpressure_config.GetPolicy().CStr());
+		return 1;
+	}
+
+	if (backpressure_config.IsEnabled())
+	{
+		MediaQueuePolicy::Configure(true, std::max(backpressure_config.GetMaxQueueBytes(), 0), overflow_policy);
+		PhysicalPortWorker::SetMaxQueueBytes(std::max(backpressure_config.GetMaxSocketQueueBytes(), 0));
+
+		logti("Backpressure is enabled (max queue bytes: %d, max socket queue bytes: %d, policy: %s)",
+			  backpressure_config.GetMaxQueueBytes(), backpressure_config.GetMaxSocketQueueBytes(), backpressure_config.GetPolicy().CStr());
+	}
+	else
+	{
+		MediaQueuePolicy::Configure(false, 0, overflow_policy);
+		PhysicalPortWorker::SetMaxQueueBytes(0);
+	}
+
+	auto trace_sample_interval = std::max(server_config->GetPerformance().GetPacketTrace().GetSampleInterval(), 0);
+	mon::PacketTracer::GetInstance()->SetSampleInterval(trace_sample_interval);
+
+	if (trace_sample_interval > 0)
+	{
+		logti("Packet tracing is enabled (1 of %d packets)", trace_sample_interval);
+	}
+
+	auto &profiler_config = server_config->GetPerformance().GetProfiler();
+	mon::Profiler::GetInstance()->SetEnabled(profiler_config.IsEnabled(), profiler_config.GetFrequency(), profiler_config.GetMaxDuration());
+
+	if (profiler_config.IsEnabled())
+	{
+		logti("Profiler is enabled (%d Hz, up to %d seconds)", profiler_config.GetFrequency(), profiler_config.GetMaxDuration());
+	}
+
+	auto &load_shedding_config = server_config->GetPerformance().GetLoadShedding();
+	mon::LoadSheddingLimits load_shedding_limits;
+
+	load_shedding_limits.is_enabled = load_shedding_config.IsEnabled();
+	load_shedding_limits.max_cpu_usage = std::max(load_shedding_config.GetMaxCpuUsage(), 0);
+	load_shedding_limits.max_memory_usage = std::max(load_shedding_config.GetMaxMemoryUsage(), 0);
+	load_shedding_limits.max_network_tx_bps = static_cast<uint64_t>(std::max(load_shedding_config.GetMaxNetworkMbps(), 0)) * 1000000;
+	load_shedding_limits.max_socket_buffer_usage = std::max(load_shedding_config.GetMaxSocketBufferUsage(), 0);
+
+	mon::Monitoring::GetInstance()->GetResourceMetrics().SetLoadSheddingLimits(load_shedding_limits);
+
+	if (load_shedding_limits.is_enabled)
+	{
+		logti("Load shedding is enabled (CPU: %d%%, Memory: %d%%, Network: %d Mbps, Socket buffer: %d%%)",
+			  load_shedding_config.GetMaxCpuUsage(), load_shedding_config.GetMaxMemoryUsage(),
+			  load_shedding_config.GetMaxNetworkMbps(), load_shedding_config.GetMaxSocketBufferUsage());
+	}
+
+	Orchestrator::GetInstance()->GetPullConnectionLimiter().Configure(server_config->GetPerformance().GetPullConnection());
+
+	auto &worker_pool_config = server_config->GetPerformance().GetWorkerPool();
+
+	// Must be started before the applications are created
+	if (worker_pool_config.IsEnabled() && (ov::Executor::GetShared()->Start("WorkerPool", worker_pool_config.GetThreadCount(), ov::ThreadClass::Media) == false))
+	{
+		logte("Could not start the worker pool");
+		return 1;
+	}
+
+	auto &audio_transcode_pool_config = server_config->GetPerformance().GetAudioTranscodePool();
+
+	if (audio_transcode_pool_config.IsEnabled() && (TranscodeStream::GetAudioExecutor()->Start("TcAudio", audio_transcode_pool_config.GetThreadCount(), ov::ThreadClass::Encode) == false))
+	{
+		logte("Could not start the audio transcode pool");
+		return 1;
+	}
+
+	auto &hot_upgrade_config = server_config->GetPerformance().GetHotUpgrade();
+
+	if (hot_upgrade_config.IsEnabled() && ((InitializeHotUpgrade(argc, argv, hot_upgrade_config) == false) || (InitializeUpgradeSignal() == false)))
+	{
+		logtw("Could not initialize the hot upgrade");
+	}
+
+	// If this process is executed by the hot upgrade, the ports are inherited instead of binding them
+	if (ReceiveInheritedPorts() == false)
+	{
+		logte("Could not receive the sockets from the previous process");
+		return 1;
+	}
+
 	auto &hosts = server_config->GetVirtualHostList();
 	std::vector<std::shared_ptr<WebConsoleServer>> web_console_servers;
 
@@ -157,24 +416,62 @@ int main(int argc, char *argv[])
 	// Initialize MediaRouter (MediaRouter must be registered first)
 	INIT_MODULE(media_router, "MediaRouter", MediaRouter::Create());
 
+	// The publishers, the transcoder and the providers don't depend on each other, so they are created (binding the ports,
+	// starting the threads, ...) in parallel, and then registered to the orchestrator in the order below
+	auto webrtc_publisher_future = CREATE_MODULE_ASYNC(WebRtcPublisher::Create(*server_config, media_router));
+	auto ovt_publisher_future = CREATE_MODULE_ASYNC(OvtPublisher::Create(*server_config, media_router));
+	auto rtmp_publisher_future = CREATE_MODULE_ASYNC(RtmpPublisher::Create(*server_config, media_router));
+	auto record_publisher_future = CREATE_MODULE_ASYNC(RecordPublisher::Create(*server_config, media_router));
+	auto transcoder_future = CREATE_MODULE_ASYNC(Transcoder::Create(media_router));
+	auto rtmp_provider_future = CREATE_MODULE_ASYNC(RtmpProvider::Create(*server_config, media_router));
+	auto ovt_provider_future = CREATE_MODULE_ASYNC(pvd::OvtProvider::Create(*server_config, media_router));
+	auto rtspc_provider_future = CREATE_MODULE_ASYNC(pvd::RtspcProvider::Create(*server_config, media_router));
+	auto webrtc_provider_future = CREATE_MODULE_ASYNC(pvd::WebRtcProvider::Create(*server_config, media_router));
+	auto srt_provider_future = CREATE_MODULE_ASYNC(pvd::SrtProvider::Create(*server_config, media_router));
+	auto replay_provider_future = CREATE_MODULE_ASYNC(pvd::ReplayProvider::Create(*server_config, media_router));
+
+	// The segment publishers share http_server_manager, so they are created by this thread one by one
+	auto hls_publisher_instance = HlsPublisher::Create(http_server_manager, *server_config, media_router);
+	auto dash_publisher_instance = DashPublisher::Create(http_server_manager, *server_config, media_router);
+	auto lldash_publisher_instance = CmafPublisher::Create(http_server_manager, *server_config, media_router);
+
 	// Initialize Publishers
-	INIT_MODULE(webrtc_publisher, "WebRTC Publisher", WebRtcPublisher::Create(*server_config, media_router));
-	INIT_MODULE(hls_publisher, "HLS Publisher", HlsPublisher::Create(http_server_manager, *server_config, media_router));
-	INIT_MODULE(dash_publisher, "MPEG-DASH Publisher", DashPublisher::Create(http_server_manager, *server_config, media_router));
-	INIT_MODULE(lldash_publisher, "Low-Latency MPEG-DASH Publisher", CmafPublisher::Create(http_server_manager, *server_config, media_router));
-	INIT_MODULE(ovt_publisher, "OVT Publisher", OvtPublisher::Create(*server_config, media_router));
+	INIT_MODULE(webrtc_publisher, "WebRTC Publisher", webrtc_publisher_future.get());
+	INIT_MODULE(hls_publisher, "HLS Publisher", hls_publisher_instance);
+	INIT_MODULE(dash_publisher, "MPEG-DASH Publisher", dash_publisher_instance);
+	INIT_MODULE(lldash_publisher, "Low-Latency MPEG-DASH Publisher", lldash_publisher_instance);
+	INIT_MODULE(ovt_publisher, "OVT Publisher", ovt_publisher_future.get());
+	INIT_MODULE(rtmp_publisher, "RTMP Publisher", rtmp_publisher_future.get());
+	INIT_MODULE(record_publisher, "Record Publisher", record_publisher_future.get());
 
 	// Initialize Transcoder
-	INIT_MODULE(transcoder, "Transcoder", Transcoder::Create(media_router));
+	INIT_MODULE(transcoder, "Transcoder", transcoder_future.get());
 
 	// Initialize Providers
-	INIT_MODULE(rtmp_provider, "RTMP Provider", RtmpProvider::Create(*server_config, media_router));
-	INIT_MODULE(ovt_provider, "OVT Provider", pvd::OvtProvider::Create(*server_config, media_router));
-	INIT_MODULE(rtspc_provider, "RTSPC Provider", pvd::RtspcProvider::Create(*server_config, media_router));
+	INIT_MODULE(rtmp_provider, "RTMP Provider", rtmp_provider_future.get());
+	INIT_MODULE(ovt_provider, "OVT Provider", ovt_provider_future.get());
+	INIT_MODULE(rtspc_provider, "RTSPC Provider", rtspc_provider_future.get());
+	INIT_MODULE(webrtc_provider, "WebRTC Provider", webrtc_provider_future.get());
+	INIT_MODULE(srt_provider, "SRT Provider", srt_provider_future.get());
+	INIT_MODULE(replay_provider, "Replay Provider", replay_provider_future.get());
 	// PENDING : INIT_MODULE(rtsp_provider, "RTSP Provider", pvd::RtspProvider::Create(*server_config, media_router));
 
 	logti("All modules are initialized successfully");
 
+	mon::MetricsServer metrics_server;
+	auto &metrics_config = server_config->GetBind().GetMetrics();
+
+	if (metrics_config.IsParsed())
+	{
+		auto &ip = server_config->GetIp();
+		auto metrics_address = ov::SocketAddress(ip.IsEmpty() ? nullptr : ip.CStr(), static_cast<uint16_t>(metrics_config.GetPort()));
+
+		if (metrics_server.Start(metrics_address) == false)
+		{
+			logtw("Could not start the metrics server on %s", metrics_address.ToString().CStr());
+		}
+	}
+
 	for (auto &host_info : host_info_list)
 	{
 		auto host_name = host_info.GetName();
@@ -189,16 +486,40 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	// The previous process stops accepting from now on
+	NotifyUpgradeReady();
+
 	if (is_service)
 	{
 		ov::Daemon::SetEvent();
 	}
 
+	int elapsed_seconds = 0;
+
 	while (g_is_terminated == false)
 	{
 		sleep(1);
+
+		ProcessReloadRequest();
+		ProcessUpgradeRequest();
+
+		if (ProcessHotUpgrade())
+		{
+			// All clients are handed over to the new process
+			break;
+		}
+
+		// The rates of the resources are calculated between the calls
+		monitor->GetResourceMetrics().Update();
+
+		if (ov::DataPool::IsEnabled() && ((++elapsed_seconds % 60) == 0))
+		{
+			logtd("%s", ov::DataPool::ToString().CStr());
+		}
 	}
 
+	metrics_server.Stop();
+
 	orchestrator->Release();
 	// Relase all modules
 	monitor->Release();
@@ -206,6 +527,9 @@ int main(int argc, char *argv[])
 	RELEASE_MODULE(rtmp_provider, "RTMP Provider");
 	RELEASE_MODULE(ovt_provider, "OVT Provider");
 	RELEASE_MODULE(rtspc_provider, "RTSPC Provider");
+	RELEASE_MODULE(webrtc_provider, "WebRTC Provider");
+	RELEASE_MODULE(srt_provider, "SRT Provider");
+	RELEASE_MODULE(replay_provider, "Replay Provider");
 	// PENDING : RELEASE_MODULE(rtsp_provider, "RTSP Provider");
 
 	RELEASE_MODULE(transcoder, "Transcoder");
@@ -215,9 +539,16 @@ int main(int argc, char *argv[])
 	RELEASE_MODULE(dash_publisher, "MPEG-DASH Publisher");
 	RELEASE_MODULE(lldash_publisher, "Low-Latency MPEG-DASH Publisher");
 	RELEASE_MODULE(ovt_publisher, "OVT Publisher");
+	RELEASE_MODULE(rtmp_publisher, "RTMP Publisher");
+	RELEASE_MODULE(record_publisher, "Record Publisher");
 
 	RELEASE_MODULE(media_router, "MediaRouter");
 
+	// The applications are stopped, so no more tasks are posted
+	ov::Executor::GetShared()->Stop();
+	TranscodeStream::GetAudioExecutor()->Stop();
+	HttpsServer::GetHandshakeExecutor()->Stop();
+
 	TERMINATE_EXTERNAL_MODULE("SRTP", TerminateSrtp);
 	TERMINATE_EXTERNAL_MODULE("OpenSSL", TerminateOpenSsl);
 	TERMINATE_EXTERNAL_MODULE("SRT", TerminateSrt);
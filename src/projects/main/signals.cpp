@@ -16,10 +16,15 @@
 #include <fstream>
 #include <iostream>
 
+#include "./hot_upgrade.h"
 #include "./main_private.h"
 #include "main.h"
 
 bool g_is_terminated;
+// Set by SIGHUP, and the configuration is reloaded by the main thread (See ProcessReloadRequest())
+static volatile sig_atomic_t g_is_reload_requested = 0;
+// Set by SIGUSR2, and the new process is executed by the main thread (See ProcessUpgradeRequest())
+static volatile sig_atomic_t g_is_upgrade_requested = 0;
 
 #define SIGNAL_CASE(x) \
 	case x:            \
@@ -153,14 +158,28 @@ static void AbortHandler(int signum, siginfo_t *si, void *unused)
 
 static void ReloadHandler(int signum, siginfo_t *si, void *unused)
 {
+	// Parsing the XML and creating/deleting the applications are not async-signal-safe
+	g_is_reload_requested = 1;
+}
+
+bool ProcessReloadRequest()
+{
+	if (g_is_reload_requested == 0)
+	{
+		return false;
+	}
+
+	g_is_reload_requested = 0;
+
 	logti("Trying to reload configuration...");
 
 	auto config_manager = cfg::ConfigManager::Instance();
 
 	if (config_manager->ReloadConfigs() == false)
 	{
+		// The current configuration is kept
 		logte("An error occurred while reload configuration");
-		return;
+		return true;
 	}
 
 	logti("Trying to apply OriginMap to Orchestrator...");
@@ -173,10 +192,41 @@ static void ReloadHandler(int signum, siginfo_t *si, void *unused)
 		host_info_list.emplace_back(host);
 	}
 
-	if (Orchestrator::GetInstance()->ApplyOriginMap(host_info_list) == false)
+	auto orchestrator = Orchestrator::GetInstance();
+
+	if (orchestrator->ApplyOriginMap(host_info_list) == false)
 	{
 		logte("Could not reload OriginMap");
 	}
+
+	logti("Trying to apply the changed applications...");
+
+	if (orchestrator->ApplyApplications(host_info_list) == false)
+	{
+		logte("Could not apply some of the applications");
+	}
+
+	return true;
+}
+
+static void UpgradeHandler(int signum, siginfo_t *si, void *unused)
+{
+	// fork() of a multi-threaded process is not async-signal-safe
+	g_is_upgrade_requested = 1;
+}
+
+bool ProcessUpgradeRequest()
+{
+	if (g_is_upgrade_requested == 0)
+	{
+		return false;
+	}
+
+	g_is_upgrade_requested = 0;
+
+	logti("Trying to upgrade the binary...");
+
+	return StartHotUpgrade();
 }
 
 void TerminateHandler(int signum, siginfo_t *si, void *unused)
@@ -246,6 +296,17 @@ bool InitializeReloadSignal()
 	return result;
 }
 
+// Configure upgrade signal
+bool InitializeUpgradeSignal()
+{
+	auto sa = GetSigAction(UpgradeHandler);
+	bool result = true;
+
+	result = result && (::sigaction(SIGUSR2, &sa, nullptr) == 0);
+
+	return result;
+}
+
 // Configure terminate signal
 bool InitializeTerminateSignal()
 {
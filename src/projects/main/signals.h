@@ -8,4 +8,15 @@
 //==============================================================================
 #pragma once
 
-bool InitializeSignals();
\ No newline at end of file
+bool InitializeSignals();
+
+// Reloads the configuration if SIGHUP has been received, the main loop calls this periodically
+// @return true if the configuration has been reloaded (or failed to reload)
+bool ProcessReloadRequest();
+
+// Installs the handler of SIGUSR2 (See <Performance><HotUpgrade>)
+bool InitializeUpgradeSignal();
+
+// Starts the hot upgrade if SIGUSR2 has been received, the main loop calls this periodically
+// @return true if the hot upgrade has been started
+bool ProcessUpgradeRequest();
@@ -11,6 +11,13 @@ class AvcVideoPacketFragmentizer
 public:
 	bool MakeHeader(const std::shared_ptr<MediaPacket> &packet);
 
+	// Builds the positions of the NAL units (without start code) of the Annex-B bitstream
+	static bool MakeFragmentationHeader(const uint8_t *bitstream, size_t length, FragmentationHeader *fragment_header);
+
+	// Finds the next start code (0x000001 or 0x00000001) from offset
+	// Returns the offset of the start code (or length if not found)
+	static size_t FindStartCode(const uint8_t *bitstream, size_t length, size_t offset, size_t *start_code_size);
+
 	// There is a duplicate code.
 	// 	- @bitstream_to_annexb header
 	enum class AvcNaluType : uint8_t
@@ -9,6 +9,7 @@
 #include "bitstream_to_adts.h"
 
 #include <cstdio>
+#include <cstring>
 
 #include <base/ovlibrary/ovlibrary.h>
 
@@ -40,31 +41,100 @@ BitstreamToADTS::AacProfile BitstreamToADTS::codec_aac_rtmp2ts(AacObjectType obj
 	}
 }
 
-uint32_t BitstreamToADTS::convert_to(const std::shared_ptr<ov::Data> &data)
+void BitstreamToADTS::ParseSequenceHeader(const uint8_t *data, size_t length)
 {
-	if(data->GetLength() == 0)
+	if(length < 4)
 	{
-		return 0;
+		logtw("Invalid aac sequence header. length=%zu", length);
+		return;
 	}
 
-	uint8_t *pbuf = data->GetWritableDataAs<uint8_t>();
+	uint8_t audioObjectType = data[2];
+	aac_sample_rate = data[3];
+
+	aac_channels = (aac_sample_rate >> 3) & 0x0f;
+	aac_sample_rate = ((audioObjectType << 1) & 0x0e) | ((aac_sample_rate >> 7) & 0x01);
+
+	audioObjectType = (audioObjectType >> 3) & 0x1f;
+	aac_object = (AacObjectType)audioObjectType;
+
+	logtd("audio object type = %d, aac_sample_rate = %d, aac_channels = %d", audioObjectType, aac_sample_rate, aac_channels);
+
+	_audio_specific_config.assign(data + 2, data + length);
+
+	////////////////////////////////////////////////////////////
+	// Make ADTS Header (except aac_frame_length)
+	////////////////////////////////////////////////////////////
+	uint8_t *pp = _adts_header;
+
+	// Syncword 12 bslbf
+	*pp++ = 0xff;
+	// 4bits left.
+	// adts_fixed_header(), 1.A.2.2.1 Fixed Header of ADTS
+	// ID 1 bslbf
+	// Layer 2 uimsbf
+	// protection_absent 1 bslbf
+	*pp++ = 0xf1;
+
+	// profile 2 uimsbf
+	// sampling_frequency_index 4 uimsbf
+	// private_bit 1 bslbf
+	// channel_configuration 3 uimsbf
+	// original/copy 1 bslbf
+	// home 1 bslbf
+	AacProfile aac_profile = codec_aac_rtmp2ts(aac_object);
+	*pp++ = ((aac_profile << 6) & 0xc0) | ((aac_sample_rate << 2) & 0x3c) | ((aac_channels >> 2) & 0x01);
+	// 4bits left.
+	// adts_variable_header(), 1.A.2.2.2 Variable Header of ADTS
+	// copyright_identification_bit 1 bslbf
+	// copyright_identification_start 1 bslbf
+	*pp++ = ((aac_channels << 6) & 0xc0);
+
+	// aac_frame_length 13 bslbf (See WriteHeader())
+	*pp++ = 0x00;
+	// adts_buffer_fullness 11 bslbf
+	*pp++ = 0x00;
+
+	// no_raw_data_blocks_in_frame 2 uimsbf
+	*pp++ = 0xfc;
+
+	_has_sequence_header = true;
+
+	logtd("detected aac sequence header\r");
+}
 
-	if(pbuf[0] == 0xff)
+void BitstreamToADTS::WriteHeader(uint8_t *header, size_t raw_length) const
+{
+	uint16_t aac_frame_length = raw_length + AdtsHeaderLength;
+
+	::memcpy(header, _adts_header, AdtsHeaderLength);
+
+	// aac_frame_length 13 bslbf: Length of the frame including headers and error_check in bytes.
+	// use the left 2bits as the 13 and 12 bit,
+	// the aac_frame_length is 13bits, so we move 13-2=11.
+	header[3] |= (aac_frame_length >> 11) & 0x03;
+	header[4] = aac_frame_length >> 3;
+	header[5] = (aac_frame_length << 5) & 0xe0;
+}
+
+std::shared_ptr<ov::Data> BitstreamToADTS::Convert(const std::shared_ptr<const ov::Data> &data)
+{
+	if(data->GetLength() < 2)
 	{
-		logtd("already ADTS type");
-		return data->GetLength();
+		return nullptr;
 	}
 
-	uint8_t sound_format = pbuf[0];
+	const uint8_t *pbuf = data->GetDataAs<uint8_t>();
 
-	[[maybe_unused]] uint8_t sound_type = sound_format & 0x01;
-	[[maybe_unused]] uint8_t sound_size = (sound_format >> 1) & 0x01;
-	[[maybe_unused]] uint8_t sound_rate = (sound_format >> 2) & 0x03;
-	uint8_t audio_codec_id = (sound_format >> 4) & 0x0f;
+	if(pbuf[0] == 0xff)
+	{
+		logtd("already ADTS type");
+		return data->Clone();
+	}
 
+	uint8_t audio_codec_id = (pbuf[0] >> 4) & 0x0f;
 	uint8_t aac_packet_type = pbuf[1];
 
-
 	if(audio_codec_id != AudioCodecIdAAC)
 	{
 		logtw("aac reqired. format=%d", audio_codec_id);
@@ -72,95 +142,27 @@ uint32_t BitstreamToADTS::convert_to(const std::shared_ptr<ov::Data> &data)
 
 	if(aac_packet_type == CodecAudioTypeSequenceHeader)
 	{
-		uint8_t audioObjectType = pbuf[2];
-		aac_sample_rate = pbuf[3];
-
-		aac_channels = (aac_sample_rate >> 3) & 0x0f;
-		aac_sample_rate = ((audioObjectType << 1) & 0x0e) | ((aac_sample_rate >> 7) & 0x01);
-
-		audioObjectType = (audioObjectType >> 3) & 0x1f;
-		aac_object = (AacObjectType)audioObjectType;
-
-#if 1
-		logtd("sound_type:%d, sound_size:%d, sound_rate:%d, audio_codec_id:%d, aac_packet_type:%d",
-	      sound_type, sound_size, sound_rate, audio_codec_id, aac_packet_type);
-#endif
+		ParseSequenceHeader(pbuf, data->GetLength());
+		return nullptr;
+	}
 
-		logtd("audio object type = %d, aac_sample_rate = %d, aac_channels = %d", audioObjectType, aac_sample_rate, aac_channels);
+	if((aac_packet_type != CodecAudioTypeRawData) || (_has_sequence_header == false))
+	{
+		return nullptr;
+	}
 
-		_has_sequence_header = true;
+	// Skip the control byte and AACPacketType
+	size_t raw_length = data->GetLength() - 2;
+	auto frame = std::make_shared<ov::Data>(AdtsHeaderLength + raw_length);
 
-		logtd("detected aac sequence header\r");
+	frame->SetLengthUninitialized(AdtsHeaderLength + raw_length);
 
-		data->Clear();
+	auto buffer = frame->GetWritableDataAs<uint8_t>();
 
-		return 0;
-	}
-	else if(aac_packet_type == CodecAudioTypeRawData)
-	{
-		if(_has_sequence_header == false)
-		{
-			return 0;
-		}
-
-		int16_t aac_fixed_header_length = 2;
-
-		// extract data after [aac_fixed_header_length] bytes
-		// packet->EraseBuffer(0, aac_fixed_header_length);
-		data->Erase(0, aac_fixed_header_length);
-		// pkt->_buf.erase(pkt->_buf.begin(), pkt->_buf.begin()+aac_fixed_header_length);
-
-		int16_t aac_raw_length = data->GetLength();    // 2바이트 헤더를 제외함
-
-		////////////////////////////////////////////////////////////
-		// Append ADTS Header
-		////////////////////////////////////////////////////////////
-		char aac_fixed_header[7];
-		if(true)
-		{
-			char *pp = aac_fixed_header;
-			int16_t aac_frame_length = aac_raw_length + 7;
-
-			// Syncword 12 bslbf
-			*pp++ = 0xff;
-			// 4bits left.
-			// adts_fixed_header(), 1.A.2.2.1 Fixed Header of ADTS
-			// ID 1 bslbf
-			// Layer 2 uimsbf
-			// protection_absent 1 bslbf
-			*pp++ = 0xf1;
-
-			// profile 2 uimsbf
-			// sampling_frequency_index 4 uimsbf
-			// private_bit 1 bslbf
-			// channel_configuration 3 uimsbf
-			// original/copy 1 bslbf
-			// home 1 bslbf
-			AacProfile aac_profile = codec_aac_rtmp2ts(aac_object);
-			*pp++ = ((aac_profile << 6) & 0xc0) | ((aac_sample_rate << 2) & 0x3c) | ((aac_channels >> 2) & 0x01);
-			// 4bits left.
-			// adts_variable_header(), 1.A.2.2.2 Variable Header of ADTS
-			// copyright_identification_bit 1 bslbf
-			// copyright_identification_start 1 bslbf
-			*pp++ = ((aac_channels << 6) & 0xc0) | ((aac_frame_length >> 11) & 0x03);
-
-			// aac_frame_length 13 bslbf: Length of the frame including headers and error_check in bytes.
-			// use the left 2bits as the 13 and 12 bit,
-			// the aac_frame_length is 13bits, so we move 13-2=11.
-			*pp++ = aac_frame_length >> 3;
-			// adts_buffer_fullness 11 bslbf
-			*pp++ = (aac_frame_length << 5) & 0xe0;
-
-			// no_raw_data_blocks_in_frame 2 uimsbf
-			*pp++ = 0xfc;
-		}
-
-		data->Insert(aac_fixed_header, 0, sizeof(aac_fixed_header));
-
-		return data->GetLength();
-	}
+	WriteHeader(buffer, raw_length);
+	::memcpy(buffer + AdtsHeaderLength, pbuf + 2, raw_length);
 
-	return 0;
+	return frame;
 }
 
 // BitstreamSequenceInfoParsing
@@ -12,11 +12,14 @@
 #include "base/media_route/media_buffer.h"
 #include "base/media_route/media_type.h"
 #include <stdint.h>
+#include <vector>
 
 #define AudioCodecIdDisabled 17
 #define AudioCodecIdMP3      2
 #define AudioCodecIdAAC      10
 
+#define AdtsHeaderLength     7
+
 class BitstreamToADTS
 {
 	enum CodecAudioType
@@ -56,7 +59,15 @@ public:
     BitstreamToADTS();
     ~BitstreamToADTS();
 
- 	uint32_t convert_to(const std::shared_ptr<ov::Data> &data);
+	// Makes the ADTS frame from the FLV audio tag with a single copy (data is not modified)
+	// Returns nullptr for the sequence header (it is kept for the next frames), or if the sequence header is not received yet
+	std::shared_ptr<ov::Data> Convert(const std::shared_ptr<const ov::Data> &data);
+
+	// The AudioSpecificConfig of the last sequence header (empty if it is not received yet)
+	const std::vector<uint8_t> &GetAudioSpecificConfig() const
+	{
+		return _audio_specific_config;
+	}
 
  	static bool SequenceHeaderParsing(const uint8_t *data,
 									  int data_size,
@@ -65,10 +76,18 @@ public:
 private:
 	AacProfile 	codec_aac_rtmp2ts(AacObjectType object_type);
 
+	void ParseSequenceHeader(const uint8_t *data, size_t length);
+	// The fixed fields are copied from the header made by ParseSequenceHeader(), and only aac_frame_length is written
+	void WriteHeader(uint8_t *header, size_t raw_length) const;
+
 	bool						_has_sequence_header;
 	
 	AacObjectType 				aac_object;
 	int8_t 						aac_sample_rate;
 	int8_t 						aac_channels;
+
+	// aac_frame_length is 0
+	uint8_t						_adts_header[AdtsHeaderLength];
+	std::vector<uint8_t>		_audio_specific_config;
 };
 
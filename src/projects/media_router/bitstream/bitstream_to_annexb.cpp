@@ -22,7 +22,41 @@ bool BitstreamToAnnexB::IsAnnexB(const uint8_t *buffer) const
 		((buffer[2] == 0x01) || (buffer[2] == 0x00 && buffer[3] == 0x01));
 }
 
-bool BitstreamToAnnexB::ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data)
+void BitstreamToAnnexB::AppendNalUnit(const std::shared_ptr<ov::Data> &data, const void *nal_data, size_t nal_length, FragmentationHeader *fragmentation)
+{
+	data->Append(START_CODE, sizeof(START_CODE));
+
+	if (fragmentation != nullptr)
+	{
+		fragmentation->fragmentation_offset.emplace_back(data->GetLength());
+		fragmentation->fragmentation_length.emplace_back(nal_length);
+	}
+
+	data->Append(nal_data, nal_length);
+}
+
+void BitstreamToAnnexB::AppendParameterSets(const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation)
+{
+	if (_sps != nullptr)
+	{
+		AppendNalUnit(data, _sps->GetData(), _sps->GetLength(), fragmentation);
+	}
+	else
+	{
+		data->Append(START_CODE, sizeof(START_CODE));
+	}
+
+	if (_pps != nullptr)
+	{
+		AppendNalUnit(data, _pps->GetData(), _pps->GetLength(), fragmentation);
+	}
+	else
+	{
+		data->Append(START_CODE, sizeof(START_CODE));
+	}
+}
+
+bool BitstreamToAnnexB::ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation)
 {
 	switch(packet_type)
 	{
@@ -142,11 +176,7 @@ bool BitstreamToAnnexB::ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStrea
 
 			data->Clear();
 
-			data->Append(START_CODE, sizeof(START_CODE));
-			data->Append(_sps.get());
-
-			data->Append(START_CODE, sizeof(START_CODE));
-			data->Append(_pps.get());
+			AppendParameterSets(data, fragmentation);
 
 			return true;
 		}
@@ -155,19 +185,18 @@ bool BitstreamToAnnexB::ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStrea
 		{
 			data->Clear();
 
+			// SPS/PPS + NAL units ([length] is replaced by [start code] of the same size)
+			data->Reserve(sizeof(START_CODE) * 2 + ((_sps != nullptr) ? _sps->GetLength() : 0) + ((_pps != nullptr) ? _pps->GetLength() : 0) + read_stream.Remained());
+
 			// Important! 
 			//  주기적으로 SPS/PPS를 전달하기위한 목적으로 사용된다. 만약, 주기적으로 SPS, PPS가 전달되지 않으면 플레이어에서 재생이 안된다. 
 			//  x264 SW 코덱은 Key Frame에 IDR NAL 패킷만 포함되어 있어서 아래와 같이 SPS, PPS 패킷을 추가해줘야 한다.
 			// TODO(soulk) : NVENC HW 코덱은 Key Frame 에 SPS+PPS+IDR NAL 패킷이 모두 포함되어 있다. 
 			//				 중복으로 SPS/PPS 전송되지 않도록 예외 처리해야 한다.
 
-			data->Append(START_CODE, sizeof(START_CODE));
-			data->Append(_sps.get());
-
-			data->Append(START_CODE, sizeof(START_CODE));
-			data->Append(_pps.get());
+			AppendParameterSets(data, fragmentation);
 
-			return ConvertInterFrame(packet_type, read_stream, data);
+			return ConvertInterFrame(packet_type, read_stream, data, fragmentation);
 		}
 
 		case AvcPacketType::EndOfSeq:
@@ -184,10 +213,14 @@ bool BitstreamToAnnexB::ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStrea
 	return false;
 }
 
-bool BitstreamToAnnexB::ConvertInterFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data)
+bool BitstreamToAnnexB::ConvertInterFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation)
 {
 	// data->Clear();
 
+	// The NAL units are appended from the original buffer directly (without Subdata() for each NAL unit)
+	auto source = read_stream.GetRemainData();
+	auto nal_data = source->GetDataAs<uint8_t>();
+
 	while(read_stream.Remained() > 0)
 	{
 		if(read_stream.IsRemained(4) == false)
@@ -204,19 +237,20 @@ bool BitstreamToAnnexB::ConvertInterFrame(AvcPacketType packet_type, ov::ByteStr
 			return false;
 		}
 
-		auto nal_data = read_stream.GetRemainData()->Subdata(0LL, nal_length);
+		nal_data += 4;
+
+		AppendNalUnit(data, nal_data, nal_length, fragmentation);
 
 		[[maybe_unused]] auto skipped = read_stream.Skip(nal_length);
 		OV_ASSERT2(skipped == nal_length);
 
-		data->Append(START_CODE, sizeof(START_CODE));
-		data->Append(nal_data.get());
+		nal_data += nal_length;
 	}
 
 	return true;
 }
 
-bool BitstreamToAnnexB::Convert(const std::shared_ptr<ov::Data> &data, int64_t &cts)
+bool BitstreamToAnnexB::Convert(const std::shared_ptr<ov::Data> &data, int64_t &cts, FragmentationHeader *fragmentation)
 {
 	auto data_for_read = data->Clone();
 	ov::ByteStream read_stream(data_for_read.get());
@@ -276,11 +310,22 @@ bool BitstreamToAnnexB::Convert(const std::shared_ptr<ov::Data> &data, int64_t &
 	switch(frame_type)
 	{
 		case AvcFrameType::Key:
-			return ConvertKeyFrame(packet_type, read_stream, data);
+			if (fragmentation != nullptr)
+			{
+				fragmentation->Clear();
+			}
+
+			return ConvertKeyFrame(packet_type, read_stream, data, fragmentation);
 
 		case AvcFrameType::Inter:
+			if (fragmentation != nullptr)
+			{
+				fragmentation->Clear();
+			}
+
 			data->Clear();
-			return ConvertInterFrame(packet_type, read_stream, data);
+			data->Reserve(read_stream.Remained());
+			return ConvertInterFrame(packet_type, read_stream, data, fragmentation);
 
 		case AvcFrameType::DisposableInter:
 		case AvcFrameType::GeneratedKey:
@@ -105,7 +105,10 @@ public:
 	//   AnnexB format: ([start code] NALU) | ([start code] NALU) | ...
 	//     [start code] = 0x000001 or 0x00000001
 	//   AVCC format:   ([extra data]) | ([length] NALU) | ([length] NALU) |
-	bool Convert(const std::shared_ptr<ov::Data> &data, int64_t &cts);
+	//
+	// If fragmentation is not nullptr, the positions of the NAL units (without start code) are stored while converting,
+	// so the consumers (AvcVideoPacketFragmentizer, RTP packetizer, ...) don't need to scan the start codes again
+	bool Convert(const std::shared_ptr<ov::Data> &data, int64_t &cts, FragmentationHeader *fragmentation = nullptr);
 
 	static bool ParseSequenceHeader(const uint8_t *data,
 	                                int data_size,
@@ -118,8 +121,12 @@ public:
 private:
 	bool IsAnnexB(const uint8_t *buffer) const;
 
-	bool ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data);
-	bool ConvertInterFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data);
+	bool ConvertKeyFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation);
+	bool ConvertInterFrame(AvcPacketType packet_type, ov::ByteStream read_stream, const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation);
+
+	// Appends [start code] + NAL unit, and records the position of the NAL unit
+	void AppendParameterSets(const std::shared_ptr<ov::Data> &data, FragmentationHeader *fragmentation);
+	static void AppendNalUnit(const std::shared_ptr<ov::Data> &data, const void *nal_data, size_t nal_length, FragmentationHeader *fragmentation);
 
 	std::shared_ptr<const ov::Data> _sps;
 	std::shared_ptr<const ov::Data> _pps;
@@ -27,10 +27,17 @@ std::shared_ptr<MediaRouteApplication> MediaRouteApplication::Create(const info:
 MediaRouteApplication::MediaRouteApplication(const info::Application &application_info)
 	: _application_info(application_info)
 {
-	logti("Created media route application. application id(%u), (%s)"
-		, _application_info.GetId(), _application_info.GetName().CStr());
+	auto worker_count = _application_info.GetConfig().GetMediaRouter().GetWorkerCount();
+	_reconnect_grace_period = _application_info.GetConfig().GetMediaRouter().GetReconnectGracePeriod();
+	_jitter_buffer = _application_info.GetConfig().GetMediaRouter().GetJitterBuffer();
+
+	logti("Created media route application. application id(%u), (%s), workers(%d)"
+		, _application_info.GetId(), _application_info.GetName().CStr(), worker_count);
 
-	_indicator.SetAlias(ov::String::FormatString("%s - Mediarouter Application Indicator", _application_info.GetName().CStr()));
+	for (int index = 0; index < worker_count; index++)
+	{
+		_workers.push_back(std::make_unique<Worker>(index));
+	}
 }
 
 MediaRouteApplication::~MediaRouteApplication()
@@ -41,32 +48,67 @@ MediaRouteApplication::~MediaRouteApplication()
 
 bool MediaRouteApplication::Start()
 {
-	try
+	// The threads are started by StartWorkers()
+	_kill_flag = false;
+
+	if (_reconnect_grace_period > 0)
 	{
-		_kill_flag = false;
+		_hold_timer.Start();
+	}
 
-		_thread = std::thread(&MediaRouteApplication::MessageLooper, this);
+	return true;
+}
+
+bool MediaRouteApplication::StartWorkers()
+{
+	std::lock_guard<std::mutex> lock(_workers_mutex);
+
+	if (_are_workers_started)
+	{
+		return true;
+	}
+
+	if (_kill_flag)
+	{
+		return false;
+	}
+
+	try
+	{
+		for (auto &worker : _workers)
+		{
+			worker->thread = std::thread(&MediaRouteApplication::MessageLooper, this, worker.get());
+		}
 	}
 	catch (const std::system_error &e)
 	{
-		_kill_flag = true;
 		logte("Failed to start media route application thread.");
 		return false;
 	}
 
+	_are_workers_started = true;
+
+	logtd("The workers of the media route application are started: %s (%zu)", _application_info.GetName().CStr(), _workers.size());
+
 	return true;
 }
 
 bool MediaRouteApplication::Stop()
 {
+	std::lock_guard<std::mutex> lock(_workers_mutex);
+
 	_kill_flag = true;
-	
-	_indicator.Stop();
-	_indicator.Clear();
 
-	if(_thread.joinable())
+	_hold_timer.Stop();
+
+	for (auto &worker : _workers)
 	{
-		_thread.join();
+		worker->Stop();
+
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
 	}
 
 	// TODO: Delete All Stream
@@ -133,6 +175,8 @@ bool MediaRouteApplication::RegisterObserverApp(
 
 	std::lock_guard<std::shared_mutex> lock(_observers_lock);
 
+	app_obsrv->SetMediaRouterApplication(GetSharedPtr());
+
 	_observers.push_back(app_obsrv);
 
 	logti("Registered observer. %p app(%s) type(%d)"
@@ -159,6 +203,15 @@ bool MediaRouteApplication::UnregisterObserverApp(
 
 	_observers.erase(position);
 
+	{
+		std::shared_lock<std::shared_mutex> lock_guard(_streams_lock);
+
+		for (const auto &item : _streams_outgoing)
+		{
+			item.second->RemoveUnsubscriptions(app_obsrv.get());
+		}
+	}
+
 	logti("Unregistered observer. %p app(%s) type(%d)"
 		, app_obsrv.get(), _application_info.GetName().CStr(),app_obsrv->GetObserverType());
 
@@ -177,6 +230,11 @@ bool MediaRouteApplication::OnCreateStream(
 		return false;
 	}
 
+	if (StartWorkers() == false)
+	{
+		return false;
+	}
+
 	auto connector_type = app_conn->GetConnectorType();
 
 	// If there is same stream, reuse that
@@ -195,6 +253,11 @@ bool MediaRouteApplication::OnCreateStream(
 				logtw("Reconnected same stream from provider(%s, %d)"
 					, stream_info->GetName().CStr(), stream_info->GetId());
 
+				if (_held_streams.erase(stream_info->GetId()) > 0)
+				{
+					istream->Resume();
+				}
+
 				return true;
 			}
 		}
@@ -210,6 +273,8 @@ bool MediaRouteApplication::OnCreateStream(
 	{
 		std::lock_guard<std::shared_mutex> lock_guard(_streams_lock);
 		new_stream->SetInoutType(false);
+		new_stream->SetJitterBuffer(_jitter_buffer);
+		new_stream->SetCaptureWriter(MediaCapture::CreateWriter(stream_info));
 		_streams_incoming.insert(std::make_pair(stream_info->GetId(), new_stream));		
 	}
 	else if( (connector_type == MediaRouteApplicationConnector::ConnectorType::Transcoder) || 
@@ -234,6 +299,8 @@ bool MediaRouteApplication::OnCreateStream(
 	{
 		std::shared_lock<std::shared_mutex> lock(_observers_lock);
 
+		MediaRouteStream::Unsubscriptions unsubscriptions;
+
 		for (auto observer : _observers)
 		{
 			auto oberver_type = observer->GetObserverType();
@@ -251,23 +318,28 @@ bool MediaRouteApplication::OnCreateStream(
 					observer->OnCreateStream(new_stream->GetStream());
 				}
 			}
-			else if (connector_type == MediaRouteApplicationConnector::ConnectorType::Transcoder)
+			else if ((connector_type == MediaRouteApplicationConnector::ConnectorType::Transcoder) ||
+					 (connector_type == MediaRouteApplicationConnector::ConnectorType::Relay))
 			{
-				// Flow: Transcoder -> MediaRoute -> Publisher
+				// Flow: Transcoder/RelayClient -> MediaRoute -> Publisher
 				if(oberver_type == MediaRouteApplicationObserver::ObserverType::Publisher)
 				{
 					observer->OnCreateStream(new_stream->GetStream());
-				}
-			}
-			else if(connector_type == MediaRouteApplicationConnector::ConnectorType::Relay)
-			{
-				// Flow: RelayClient -> MediaRoute -> Publisher
-				if (oberver_type == MediaRouteApplicationObserver::ObserverType::Publisher)
-				{
-					observer->OnCreateStream(new_stream->GetStream());
+
+					// The packets of the tracks that the publisher doesn't use are not delivered to it
+					for (const auto &track_item : stream_info->GetTracks())
+					{
+						if (observer->IsTrackSubscribed(stream_info, track_item.second) == false)
+						{
+							logtd("%p does not subscribe the track %d of the stream %s", observer.get(), track_item.first, stream_info->GetName().CStr());
+							unsubscriptions.emplace_back(observer.get(), track_item.first);
+						}
+					}
 				}
 			}
 		}
+
+		new_stream->SetUnsubscriptions(std::move(unsubscriptions));
 	}
 
 	return true;
@@ -283,6 +355,82 @@ bool MediaRouteApplication::OnDeleteStream(
 		return false;
 	}
 
+	auto connector_type = app_conn->GetConnectorType();
+
+	if ((connector_type == MediaRouteApplicationConnector::ConnectorType::Provider) && (_reconnect_grace_period > 0) && HoldStream(stream_info))
+	{
+		return true;
+	}
+
+	return DeleteStream(connector_type, stream_info);
+}
+
+bool MediaRouteApplication::HoldStream(const std::shared_ptr<info::Stream> &stream_info)
+{
+	uint64_t hold_id = 0;
+
+	{
+		std::lock_guard<std::shared_mutex> lock_guard(_streams_lock);
+
+		if (_streams_incoming.find(stream_info->GetId()) == _streams_incoming.end())
+		{
+			return false;
+		}
+
+		hold_id = ++_last_hold_id;
+		_held_streams[stream_info->GetId()] = hold_id;
+	}
+
+	logti("The ingest of the stream is gone, it is held for %dms: [%s/%s(%u)]"
+		, _reconnect_grace_period, _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+
+	auto stream_id = stream_info->GetId();
+
+	_hold_timer.Push(
+		[this, stream_id, hold_id](void *parameter) -> ov::DelayQueueAction {
+			ExpireHeldStream(stream_id, hold_id);
+			return ov::DelayQueueAction::Stop;
+		},
+		_reconnect_grace_period);
+
+	return true;
+}
+
+void MediaRouteApplication::ExpireHeldStream(uint32_t stream_id, uint64_t hold_id)
+{
+	std::shared_ptr<info::Stream> stream_info;
+
+	{
+		std::lock_guard<std::shared_mutex> lock_guard(_streams_lock);
+
+		auto held_item = _held_streams.find(stream_id);
+
+		// The stream is resumed (or held again after that)
+		if ((held_item == _held_streams.end()) || (held_item->second != hold_id))
+		{
+			return;
+		}
+
+		_held_streams.erase(held_item);
+
+		auto item = _streams_incoming.find(stream_id);
+
+		if (item == _streams_incoming.end())
+		{
+			return;
+		}
+
+		stream_info = item->second->GetStream();
+	}
+
+	logti("The held stream is not resumed within %dms: [%s/%s(%u)]"
+		, _reconnect_grace_period, _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+
+	DeleteStream(MediaRouteApplicationConnector::ConnectorType::Provider, stream_info);
+}
+
+bool MediaRouteApplication::DeleteStream(MediaRouteApplicationConnector::ConnectorType connector_type, const std::shared_ptr<info::Stream> &stream_info)
+{
 	logti("Trying to delete a stream: [%s/%s(%u)]"
 		, _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
 
@@ -290,9 +438,7 @@ bool MediaRouteApplication::OnDeleteStream(
 	mon::Monitoring::GetInstance()->OnStreamDeleted(*stream_info);
 
 	logtd("Deleted connector. type(%d), app(%s) stream(%s/%u)"
-		, app_conn->GetConnectorType(), _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
-
-	auto connector_type = app_conn->GetConnectorType();
+		, connector_type, _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
 
 	// Notify all observers that stream has been deleted
 	{
@@ -333,24 +479,175 @@ bool MediaRouteApplication::OnDeleteStream(
 		}
 	}
 
+	// The stream may be in the ready list of the worker, the packets left in it are not delivered
+	auto remove_stream = [&stream_info](std::map<uint32_t, std::shared_ptr<MediaRouteStream>> &streams) {
+		auto item = streams.find(stream_info->GetId());
+
+		if (item != streams.end())
+		{
+			item->second->SetRemoved();
+			streams.erase(item);
+		}
+	};
+
 	if(connector_type == MediaRouteApplicationConnector::ConnectorType::Provider)
 	{
 		std::lock_guard<std::shared_mutex> lock_guard(_streams_lock);
-		_streams_incoming.erase(stream_info->GetId());	
+		remove_stream(_streams_incoming);
 	}
 	else if( (connector_type == MediaRouteApplicationConnector::ConnectorType::Transcoder) || 
 			 (connector_type == MediaRouteApplicationConnector::ConnectorType::Relay) )
 	{
 		std::lock_guard<std::shared_mutex> lock_guard(_streams_lock);
-		_streams_outgoing.erase(stream_info->GetId());	
+		remove_stream(_streams_outgoing);
 	}
 	else
 	{
-		logte("Unsupported connector type %d", app_conn->GetConnectorType());
+		logte("Unsupported connector type %d", connector_type);
+
+		return false;
+	}
+
+	return true;
+}
+
+// OnKeyFrameRequested is called from Publisher(outgoing stream) and Transcoder(incoming stream)
+bool MediaRouteApplication::OnKeyFrameRequested(
+	const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+	const std::shared_ptr<info::Stream> &stream_info)
+{
+	if (stream_info == nullptr)
+	{
+		OV_ASSERT2(false);
+		return false;
+	}
+
+	std::shared_ptr<MediaRouteStream> stream;
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_streams_lock);
+
+		auto item = _streams_outgoing.find(stream_info->GetId());
+
+		if (item != _streams_outgoing.end())
+		{
+			stream = item->second;
+		}
+		else
+		{
+			item = _streams_incoming.find(stream_info->GetId());
+
+			if (item != _streams_incoming.end())
+			{
+				stream = item->second;
+			}
+		}
+	}
+
+	if (stream == nullptr)
+	{
+		logtw("Could not find the stream to request a key frame: [%s/%s(%u)]", _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+		return false;
+	}
+
+	// Only the connectors that can create the stream are asked
+	auto connector_type = stream->GetConnectorType();
+
+	std::shared_lock<std::shared_mutex> lock(_connectors_lock);
+
+	for (const auto &connector : _connectors)
+	{
+		if ((connector->GetConnectorType() == connector_type) && connector->OnKeyFrameRequested(stream->GetStream()))
+		{
+			logtd("A key frame is requested: [%s/%s(%u)]", _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// OnPacketLossReported is called from Publisher(outgoing stream) with the receiver reports of the players
+bool MediaRouteApplication::OnPacketLossReported(
+	const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+	const std::shared_ptr<info::Stream> &stream_info,
+	int32_t packet_loss_percentage)
+{
+	if (stream_info == nullptr)
+	{
+		OV_ASSERT2(false);
+		return false;
+	}
+
+	std::shared_ptr<MediaRouteStream> stream;
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_streams_lock);
+
+		auto item = _streams_outgoing.find(stream_info->GetId());
+
+		if (item != _streams_outgoing.end())
+		{
+			stream = item->second;
+		}
+	}
+
+	if (stream == nullptr)
+	{
+		return false;
+	}
+
+	// Only the encoders of the transcoder can use it
+	auto connector_type = stream->GetConnectorType();
 
+	if (connector_type != MediaRouteApplicationConnector::ConnectorType::Transcoder)
+	{
 		return false;
 	}
 
+	std::shared_lock<std::shared_mutex> lock(_connectors_lock);
+
+	for (const auto &connector : _connectors)
+	{
+		if ((connector->GetConnectorType() == connector_type) && connector->OnPacketLossReported(stream->GetStream(), packet_loss_percentage))
+		{
+			logtd("Packet loss is reported: %d%% [%s/%s(%u)]", packet_loss_percentage, _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// OnGopCacheRequested is called from Publisher(outgoing stream) when a session is added
+bool MediaRouteApplication::OnGopCacheRequested(
+	const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+	const std::shared_ptr<info::Stream> &stream_info,
+	std::vector<std::shared_ptr<MediaPacket>> *packets)
+{
+	if (stream_info == nullptr)
+	{
+		OV_ASSERT2(false);
+		return false;
+	}
+
+	std::shared_ptr<MediaRouteStream> stream;
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_streams_lock);
+
+		auto item = _streams_outgoing.find(stream_info->GetId());
+
+		if (item == _streams_outgoing.end())
+		{
+			return false;
+		}
+
+		stream = item->second;
+	}
+
+	*packets = stream->GetGopCache();
+
 	return true;
 }
 
@@ -366,8 +663,6 @@ bool MediaRouteApplication::OnReceiveBuffer(
 		return false;
 	}
 
-	uint8_t indicator = -BufferIndicator::BUFFER_INDICATOR_NONE_STREAM;
-
 	std::shared_ptr<MediaRouteStream> stream = nullptr;
 
 	{
@@ -383,8 +678,6 @@ bool MediaRouteApplication::OnReceiveBuffer(
 
 				return false;
 			}
-			
-			indicator = BufferIndicator::BUFFER_INDICATOR_INCOMING_STREAM;
 
 			stream = stream_bucket->second;
 		}
@@ -399,9 +692,7 @@ bool MediaRouteApplication::OnReceiveBuffer(
 
 				return false;
 			}
-			
-			indicator = BufferIndicator::BUFFER_INDICATOR_OUTGOING_STREAM;
-			
+
 			stream = stream_bucket->second;
 		}
 	}
@@ -415,89 +706,287 @@ bool MediaRouteApplication::OnReceiveBuffer(
 	bool ret = stream->Push(packet);
 	if(ret == true)
 	{
-		_indicator.Enqueue(std::make_shared<BufferIndicator>(indicator,stream_info->GetId()));
+		auto worker = GetWorker(stream_info->GetId());
+
+		worker->enqueued_count++;
+		worker->Schedule(stream);
 	}
 	
 	return ret;
 }
 
+MediaRouteApplication::Worker *MediaRouteApplication::GetWorker(uint32_t stream_id) const
+{
+	return _workers[stream_id % _workers.size()].get();
+}
 
-void MediaRouteApplication::MessageLooper()
+std::vector<MediaRouteApplication::WorkerStatistics> MediaRouteApplication::GetWorkerStatistics() const
 {
-	while (!_kill_flag)
+	std::vector<WorkerStatistics> statistics_list;
+
+	for (auto &worker : _workers)
 	{
-		auto msg = _indicator.Dequeue(10);
-		if (msg.has_value() == false)
-		{
-			// It may be called due to a normal stop signal.
-			continue;
-		}
+		WorkerStatistics statistics;
 
-		auto &indicator = msg.value();
+		statistics.index = worker->index;
+		statistics.queue_size = worker->GetReadyCount();
+		statistics.peak_queue_size = worker->peak_queue_size;
+		statistics.enqueued_count = worker->enqueued_count;
+		statistics.processed_count = worker->processed_count;
 
-		std::shared_ptr<MediaRouteStream> stream = nullptr;
+		statistics_list.push_back(statistics);
+	}
 
-		std::shared_lock<std::shared_mutex> lock(_streams_lock);
-		if(indicator->_inout == BufferIndicator::BUFFER_INDICATOR_INCOMING_STREAM)
+	return statistics_list;
+}
+
+
+void MediaRouteApplication::MessageLooper(Worker *worker)
+{
+	ov::ThreadMetrics thread_metrics("MediaRouter", ov::ThreadClass::Media);
+	ov::StopWatch stat_stop_watch;
+	stat_stop_watch.Start();
+
+	// The streams whose packets are held by the jitter buffer, scheduled again at their release time
+	std::vector<std::shared_ptr<MediaRouteStream>> delayed_streams;
+
+	while (!_kill_flag)
+	{
+		if (stat_stop_watch.IsElapsed(10000) && stat_stop_watch.Update())
 		{
-			auto it = _streams_incoming.find(indicator->_stream_id);
-			stream = (it != _streams_incoming.end()) ? it->second : nullptr;
+			logtd("Worker #%d of %s: ready streams: %zu (peak: %zu), enqueued: %llu, processed: %llu"
+				, worker->index, _application_info.GetName().CStr(), worker->GetReadyCount(), worker->peak_queue_size.load()
+				, static_cast<unsigned long long>(worker->enqueued_count), static_cast<unsigned long long>(worker->processed_count));
+
+			// The statistics of the streams are sampled here instead of being logged by Pop() of each packet
+			std::shared_lock<std::shared_mutex> lock(_streams_lock);
+
+			for (const auto &streams : {&_streams_incoming, &_streams_outgoing})
+			{
+				for (const auto &item : *streams)
+				{
+					if (GetWorker(item.first) == worker)
+					{
+						item.second->ShowStatistics();
+					}
+				}
+			}
 		}
-		else if(indicator->_inout == BufferIndicator::BUFFER_INDICATOR_OUTGOING_STREAM)
+
+		int timeout_msec = 10;
+
+		if (delayed_streams.empty() == false)
 		{
-			auto it = _streams_outgoing.find(indicator->_stream_id);
-			stream = (it != _streams_outgoing.end()) ? it->second : nullptr;
+			auto now_ms = ov::Clock::NowMs();
+
+			for (auto iter = delayed_streams.begin(); iter != delayed_streams.end();)
+			{
+				auto &delayed_stream = *iter;
+				auto release_ms = delayed_stream->GetNextReleaseMs();
+
+				if (delayed_stream->IsRemoved() || (release_ms <= now_ms))
+				{
+					delayed_stream->_is_delayed = false;
+
+					if (delayed_stream->IsRemoved() == false)
+					{
+						worker->Schedule(delayed_stream);
+					}
+
+					iter = delayed_streams.erase(iter);
+					continue;
+				}
+
+				timeout_msec = std::min(timeout_msec, static_cast<int>(release_ms - now_ms));
+				++iter;
+			}
 		}
-		lock.unlock();
+
+		size_t ready_count = 0;
+
+		thread_metrics.BeginIdle();
+		auto stream = worker->TakeReadyList(timeout_msec, &ready_count);
+		thread_metrics.EndIdle();
 
 		if (stream == nullptr)
 		{
-			logtw("Not found stream - strem_id(%u)", indicator->_stream_id);
+			// It may be called due to a normal stop signal.
 			continue;
 		}
 
-		auto stream_info = stream->GetStream();
+		thread_metrics.CountLoop();
 
-		while(auto media_packet = stream->Pop())
+		// Only this thread updates peak_queue_size
+		if (ready_count > worker->peak_queue_size)
 		{
-			// Find Media Track
-			auto media_track = stream_info->GetTrack(media_packet->GetTrackId());
+			worker->peak_queue_size = ready_count;
+		}
 
+		// The observers are not changed often, so a snapshot is used for the batch
+		std::vector<std::shared_ptr<MediaRouteApplicationObserver>> observers;
+		{
 			std::shared_lock<std::shared_mutex> lock(_observers_lock);
+			observers = _observers;
+		}
+
+		// The packet is not used by the router after delivering it, so the last transcoder receives the packet itself
+		// and the others receive clones which share the payload with it
+		auto transcoder_count = std::count_if(observers.begin(), observers.end(), [](const auto &observer) -> bool {
+			return observer->GetObserverType() == MediaRouteApplicationObserver::ObserverType::Transcoder;
+		});
 
-			// Deliver media packet to Publiser(observer) of Transcoder(observer)		
-			for (const auto &observer : _observers)
+		while (stream != nullptr)
+		{
+			auto next_stream = std::move(stream->_next_ready);
+
+			// The packets pushed from now on schedule the stream again
+			stream->Unschedule();
+
+			if (stream->IsRemoved() == false)
 			{
-				auto observer_type = observer->GetObserverType();
+				DeliverPackets(worker, stream, observers, transcoder_count);
 
-				// Provider (from incoming stream) -> MediaRouter -> Transcoder
-				if(indicator->_inout == BufferIndicator::BUFFER_INDICATOR_INCOMING_STREAM)
+				if ((stream->GetNextReleaseMs() > 0) && (stream->_is_delayed == false))
 				{
-					if(observer_type == MediaRouteApplicationObserver::ObserverType::Transcoder)
-					{
-						auto media_buffer_clone = media_packet->ClonePacket();
+					stream->_is_delayed = true;
+					delayed_streams.push_back(stream);
+				}
+			}
 
-						observer->OnSendFrame(stream_info, std::move(media_buffer_clone));
-					}
+			stream = std::move(next_stream);
+		}
+	}
+}
+
+void MediaRouteApplication::DeliverPackets(Worker *worker, const std::shared_ptr<MediaRouteStream> &stream,
+										   const std::vector<std::shared_ptr<MediaRouteApplicationObserver>> &observers, size_t transcoder_count)
+{
+	auto stream_info = stream->GetStream();
+	bool is_outgoing = stream->IsOutgoingStream();
+
+	ov::MemoryScope memory_scope(ov::MemoryCategory::MediaRouter, stream->GetMemoryAccount());
+
+	while(auto media_packet = stream->Pop())
+	{
+		worker->processed_count++;
+
+		auto unsubscriptions = stream->GetUnsubscriptions();
+
+		size_t remained_transcoder_count = transcoder_count;
+
+		// Deliver media packet to Publiser(observer) of Transcoder(observer)
+		for (const auto &observer : observers)
+		{
+			auto observer_type = observer->GetObserverType();
+
+			// Provider (from incoming stream) -> MediaRouter -> Transcoder
+			if(is_outgoing == false)
+			{
+				if(observer_type == MediaRouteApplicationObserver::ObserverType::Transcoder)
+				{
+					remained_transcoder_count--;
+
+					observer->OnSendFrame(stream_info, (remained_transcoder_count > 0) ? media_packet->ClonePacket() : media_packet);
 				}
-				// Transcoder or RelayClient (from outgoing stream) -> MediaRouter -> Publisher
-				else if(indicator->_inout == BufferIndicator::BUFFER_INDICATOR_OUTGOING_STREAM)
+			}
+			// Transcoder or RelayClient (from outgoing stream) -> MediaRouter -> Publisher
+			else
+			{
+				if(observer_type == MediaRouteApplicationObserver::ObserverType::Publisher)
 				{
-					if(observer_type == MediaRouteApplicationObserver::ObserverType::Publisher)
+					if (MediaRouteStream::IsSubscribed(unsubscriptions.get(), observer.get(), media_packet->GetTrackId()) == false)
 					{
-						if (media_packet->GetMediaType() == MediaType::Video)
-						{
-							observer->OnSendVideoFrame(stream_info, media_packet);
-						}
-						else if (media_packet->GetMediaType() == MediaType::Audio)
-						{
-							observer->OnSendAudioFrame(stream_info, media_packet);
-						}
+						continue;
+					}
+
+					if (media_packet->GetMediaType() == MediaType::Video)
+					{
+						observer->OnSendVideoFrame(stream_info, media_packet);
+					}
+					else if (media_packet->GetMediaType() == MediaType::Audio)
+					{
+						observer->OnSendAudioFrame(stream_info, media_packet);
 					}
 				}
 			}
+		}
+	}
+}
+
+void MediaRouteApplication::Worker::Schedule(const std::shared_ptr<MediaRouteStream> &stream)
+{
+	if (stream->Schedule() == false)
+	{
+		// The worker will pop the packet with the others
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_ready_mutex);
+
+		if (_is_stopped)
+		{
+			return;
+		}
 
-			lock.unlock();
+		if (_ready_tail == nullptr)
+		{
+			_ready_head = stream;
+		}
+		else
+		{
+			_ready_tail->_next_ready = stream;
 		}
+
+		_ready_tail = stream.get();
+		_ready_count++;
+	}
+
+	_ready_condition.notify_one();
+}
+
+std::shared_ptr<MediaRouteStream> MediaRouteApplication::Worker::TakeReadyList(int timeout_msec, size_t *count)
+{
+	std::unique_lock<std::mutex> lock(_ready_mutex);
+
+	_ready_condition.wait_for(lock, std::chrono::milliseconds(timeout_msec), [this]() -> bool {
+		return _is_stopped || (_ready_head != nullptr);
+	});
+
+	*count = _ready_count;
+
+	_ready_tail = nullptr;
+	_ready_count = 0;
+
+	return std::move(_ready_head);
+}
+
+size_t MediaRouteApplication::Worker::GetReadyCount() const
+{
+	std::lock_guard<std::mutex> lock(_ready_mutex);
+
+	return _ready_count;
+}
+
+void MediaRouteApplication::Worker::Stop()
+{
+	std::shared_ptr<MediaRouteStream> stream;
+
+	{
+		std::lock_guard<std::mutex> lock(_ready_mutex);
+
+		_is_stopped = true;
+
+		stream = std::move(_ready_head);
+		_ready_tail = nullptr;
+		_ready_count = 0;
+	}
+
+	_ready_condition.notify_all();
+
+	// Unlinks the streams one by one (not recursively by the destructors)
+	while (stream != nullptr)
+	{
+		stream = std::move(stream->_next_ready);
 	}
 }
@@ -8,6 +8,8 @@
 //==============================================================================
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -41,7 +43,6 @@ public:
 	bool Stop();
 
 	volatile bool _kill_flag;
-	std::thread _thread;
 
 public:
 	bool RegisterConnectorApp(
@@ -66,6 +67,23 @@ public:
 		const std::shared_ptr<info::Stream> &stream,
 		const std::shared_ptr<MediaPacket> &packet) override;
 
+	// 키프레임 요청
+	bool OnKeyFrameRequested(
+		const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+		const std::shared_ptr<info::Stream> &stream) override;
+
+	// Packet loss of the players of the outgoing stream
+	bool OnPacketLossReported(
+		const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+		const std::shared_ptr<info::Stream> &stream,
+		int32_t packet_loss_percentage) override;
+
+	// GOP cache of the outgoing stream
+	bool OnGopCacheRequested(
+		const std::shared_ptr<MediaRouteApplicationObserver> &app_obsrv,
+		const std::shared_ptr<info::Stream> &stream,
+		std::vector<std::shared_ptr<MediaPacket>> *packets) override;
+
 public:
 	bool RegisterObserverApp(
 		std::shared_ptr<MediaRouteApplicationObserver> observer);
@@ -97,34 +115,87 @@ public:
 	std::shared_mutex _streams_lock;
 
 public:
-	void MessageLooper();
-
-	// enum StreamBufferIndicator {
-	// 	BUFFER_INDICATOR_NONE_STREAM = 0,
-	// 	BUFFER_INDICATOR_INCOMING_STREAM,
-	// 	BUFFER_INDICATOR_OUTGOING_STREAM
-	// };
-
-	class BufferIndicator
+	class Worker;
+
+	void MessageLooper(Worker *worker);
+	// Pops and delivers the packets of the stream to the observers
+	void DeliverPackets(Worker *worker, const std::shared_ptr<MediaRouteStream> &stream,
+						const std::vector<std::shared_ptr<MediaRouteApplicationObserver>> &observers, size_t transcoder_count);
+
+	// The packets of a stream are always delivered by the same worker to keep the order
+	//
+	// The streams that have packets to pop are linked in the ready list of the worker (through MediaRouteStream::_next_ready),
+	// and a stream is linked once until the worker takes it (See MediaRouteStream::Schedule()), so the worker is notified
+	// per stream instead of per packet. The worker takes the whole list at once, and delivers the packets of the streams in a batch.
+	class Worker
 	{
 	public:
-		enum {
-			BUFFER_INDICATOR_NONE_STREAM = 0,
-			BUFFER_INDICATOR_INCOMING_STREAM,
-			BUFFER_INDICATOR_OUTGOING_STREAM
-		};
-
-		explicit BufferIndicator(uint8_t inout, uint32_t stream_id)
+		explicit Worker(int index)
+			: index(index)
 		{
-			_inout = inout;
-			_stream_id = stream_id;
 		}
 
-		uint8_t _inout;
-		uint32_t _stream_id;
+		const int index;
+
+		// Links the stream to the ready list if it is not scheduled yet
+		void Schedule(const std::shared_ptr<MediaRouteStream> &stream);
+		// Takes the ready list (the first stream, the others are linked from it), waits up to timeout_msec if it is empty
+		std::shared_ptr<MediaRouteStream> TakeReadyList(int timeout_msec, size_t *count);
+		// The streams that are in the ready list
+		size_t GetReadyCount() const;
+
+		void Stop();
+
+		std::thread thread;
+
+		// Metrics
+		std::atomic<uint64_t> enqueued_count{0};
+		std::atomic<uint64_t> processed_count{0};
+		std::atomic<size_t> peak_queue_size{0};
+
+	private:
+		mutable std::mutex _ready_mutex;
+		std::condition_variable _ready_condition;
+		std::shared_ptr<MediaRouteStream> _ready_head;
+		MediaRouteStream *_ready_tail = nullptr;
+		size_t _ready_count = 0;
+		bool _is_stopped = false;
+	};
+
+	struct WorkerStatistics
+	{
+		int index = 0;
+		size_t queue_size = 0;
+		size_t peak_queue_size = 0;
+		uint64_t enqueued_count = 0;
+		uint64_t processed_count = 0;
 	};
 
+	std::vector<WorkerStatistics> GetWorkerStatistics() const;
 
 protected:
-	ov::Queue<std::shared_ptr<BufferIndicator>> _indicator;
+	bool DeleteStream(MediaRouteApplicationConnector::ConnectorType connector_type, const std::shared_ptr<info::Stream> &stream_info);
+
+	// The incoming stream is kept for <ReconnectGracePeriod> after the provider deleted it (See MediaRouteStream::Resume())
+	bool HoldStream(const std::shared_ptr<info::Stream> &stream_info);
+	// Deletes the stream if it is still held by the same HoldStream()
+	void ExpireHeldStream(uint32_t stream_id, uint64_t hold_id);
+
+	Worker *GetWorker(uint32_t stream_id) const;
+	// The threads of the workers are started by the first stream, so an application without streams has no threads
+	bool StartWorkers();
+
+	std::vector<std::unique_ptr<Worker>> _workers;
+	std::mutex _workers_mutex;
+	bool _are_workers_started = false;
+
+	// <MediaRouter><ReconnectGracePeriod> (ms)
+	int _reconnect_grace_period = 0;
+	// <MediaRouter><JitterBuffer> (ms)
+	int _jitter_buffer = 0;
+	// Key: the id of the held stream, value: the hold id (protected by _streams_lock)
+	std::map<uint32_t, uint64_t> _held_streams;
+	uint64_t _last_hold_id = 0;
+	// Expires the held streams (started only if the grace period is set)
+	ov::DelayQueue _hold_timer;
 };
@@ -8,7 +8,13 @@
 //==============================================================================
 #include "media_router_stream.h"
 
+#include <base/media_route/media_queue_policy.h>
 #include <base/ovlibrary/ovlibrary.h>
+#include <base/ovlibrary/probe.h>
+#include <monitoring/monitoring.h>
+#include <monitoring/packet_tracer.h>
+
+#include <algorithm>
 
 #define OV_LOG_TAG "MediaRouter.Stream"
 
@@ -24,31 +30,64 @@ MediaRouteStream::MediaRouteStream(const std::shared_ptr<info::Stream> &stream)
 	_stream = stream;
 	_stream->ShowInfo();
 
-	_stat_start_time = std::chrono::system_clock::now();
+	_stat_start_time_ms = ov::Clock::NowMs();
+
+	_memory_account = ov::MemoryAccounting::GetAccount(_stream->GetApplicationInfo().GetName(), _stream->GetName());
 
-	_stop_watch.Start();
+	const auto &tracks = _stream->GetTracks();
 
+	_track_states = std::make_unique<TrackState[]>(tracks.size());
+
+	for(const auto &iter : tracks)
+	{
+		auto &track_state = _track_states[_track_count++];
+
+		track_state.track_id = iter.first;
+		track_state.track = iter.second;
+	}
+
+	mon::MetricLabels latency_labels = {
+		{"app", _stream->GetApplicationInfo().GetName()},
+		{"stream", _stream->GetName()}};
+
+	auto &latency_metrics = MonitorInstance->GetLatencyMetrics();
+	_ingest_latency = latency_metrics.GetHistogram(mon::LatencyStage::IngestToRouter, latency_labels);
+	_queue_wait_latency = latency_metrics.GetHistogram(mon::LatencyStage::RouterQueueWait, latency_labels);
 
 	// set alias
-	_media_packets.SetAlias(ov::String::FormatString("%s/%s - Mediarouter stream a/v queue", _stream->GetApplicationInfo().GetName().CStr() ,_stream->GetName().CStr()));
+	_video_packets.SetAlias(ov::String::FormatString("%s/%s - Mediarouter stream video queue", _stream->GetApplicationInfo().GetName().CStr() ,_stream->GetName().CStr()));
+	_audio_packets.SetAlias(ov::String::FormatString("%s/%s - Mediarouter stream audio queue", _stream->GetApplicationInfo().GetName().CStr() ,_stream->GetName().CStr()));
+
+	if(MediaQueuePolicy::IsEnabled())
+	{
+		// Each lane has the limit, so the audio is not dropped to make room for the video
+		for(auto lane : {&_video_packets, &_audio_packets})
+		{
+			lane->SetLimit(0, MediaQueuePolicy::GetMaxBytes(), MediaQueuePolicy::GetPolicy(),
+				[](const std::shared_ptr<MediaPacket> &media_packet) -> size_t {
+					return MediaQueuePolicy::GetPacketBytes(*media_packet);
+				},
+				[this](const std::shared_ptr<MediaPacket> &media_packet) -> ov::QueueItemClass {
+					return MediaQueuePolicy::Classify(*media_packet, *_stream, media_packet->GetTrackId());
+				});
+
+			lane->SetDropCallback([this](const std::shared_ptr<MediaPacket> &media_packet, size_t bytes) {
+				auto stream_metrics = StreamMetrics(*_stream);
+				if(stream_metrics != nullptr)
+				{
+					stream_metrics->OnQueuePacketDropped(bytes);
+				}
+			});
+		}
+	}
 }
 
 MediaRouteStream::~MediaRouteStream()
 {
 	logtd("Delete media route stream name(%s) id(%u)", _stream->GetName().CStr(), _stream->GetId());
 
-	_media_packet_stored.clear();
-
-	_media_packets.Clear();
-
-	_stat_recv_pkt_lpts.clear();
-	_stat_recv_pkt_ldts.clear();
-	_stat_recv_pkt_size.clear();
-	_stat_recv_pkt_count.clear();
-	_stat_first_time_diff.clear();
-
-	_pts_correct.clear();
-	_pts_avg_inc.clear();
+	_video_packets.Clear();
+	_audio_packets.Clear();
 }
 
 std::shared_ptr<info::Stream> MediaRouteStream::GetStream()
@@ -72,9 +111,88 @@ MediaRouteApplicationConnector::ConnectorType MediaRouteStream::GetConnectorType
 	return _application_connector_type;
 }
 
+MediaRouteStream::TrackState *MediaRouteStream::GetTrackState(int32_t track_id)
+{
+	// There are only a few tracks, so a linear search is faster than a map
+	for(size_t index = 0; index < _track_count; index++)
+	{
+		if(_track_states[index].track_id == track_id)
+		{
+			return &_track_states[index];
+		}
+	}
+
+	return nullptr;
+}
+
+void MediaRouteStream::SetCaptureWriter(const std::shared_ptr<MediaCaptureWriter> &capture_writer)
+{
+	std::lock_guard<std::mutex> lock_guard(_push_mutex);
+
+	_capture_writer = capture_writer;
+}
+
 bool MediaRouteStream::Push(std::shared_ptr<MediaPacket> media_packet)
 {	
-	auto track_id = media_packet->GetTrackId();
+	// The encoders of the transcoder push the packets of the same stream from their own threads
+	std::lock_guard<std::mutex> lock_guard(_push_mutex);
+
+	auto now = std::chrono::steady_clock::now();
+
+	OV_PROBE5(router_push, _stream->GetId(), media_packet->GetTrackId(), media_packet->GetPts(), media_packet->GetDataLength(), static_cast<int>(_inout_type));
+
+	// The packets of the outgoing stream are created by the encoders, so only the incoming stream is measured
+	if(_inout_type == false)
+	{
+		_ingest_latency->Record(media_packet->GetCreatedTime());
+	}
+
+	// The packet is captured as the provider sent it (before the bitstream is processed)
+	if((_capture_writer != nullptr) && (_capture_writer->Write(media_packet) == false))
+	{
+		_capture_writer = nullptr;
+	}
+
+	// The packets of the bypass tracks are already traced from the provider
+	auto packet_tracer = mon::PacketTracer::GetInstance();
+
+	if((media_packet->GetTrace() == nullptr) && packet_tracer->ShouldSample())
+	{
+		auto trace = packet_tracer->CreateTrace(_stream->GetApplicationInfo().GetName(), _stream->GetName(), media_packet->GetTrackId(), media_packet->GetPts());
+
+		trace->Mark(mon::PacketTraceStage::Created, media_packet->GetCreatedTime());
+		media_packet->SetTrace(trace);
+	}
+
+	auto track_state = GetTrackState(media_packet->GetTrackId());
+
+	if(track_state == nullptr)
+	{
+		// Pop() discards it
+		OnPacketQueued(media_packet, now);
+		GetLane(media_packet).Enqueue(std::move(media_packet));
+		return true;
+	}
+
+	if(_is_resuming && (StartResuming(media_packet) == false))
+	{
+		return false;
+	}
+
+	if(_resume_offset_us != 0)
+	{
+		auto timestamp_offset = _resume_offset_us * track_state->track->GetTimeBase().GetDen() / (1000000LL * track_state->track->GetTimeBase().GetNum());
+
+		media_packet->SetPts(media_packet->GetPts() + timestamp_offset);
+		media_packet->SetDts(media_packet->GetDts() + timestamp_offset);
+	}
+
+	if(track_state->is_pushed)
+	{
+		track_state->push_dts_inc = media_packet->GetDts() - track_state->push_last_dts;
+	}
+	track_state->push_last_dts = media_packet->GetDts();
+	track_state->is_pushed = true;
 
 	// Accumulate Packet duplication
 	//	- 1) If packets stored in temporary storage exist, calculate Duration compared to the current packet's timestamp.
@@ -82,26 +200,28 @@ bool MediaRouteStream::Push(std::shared_ptr<MediaPacket> media_packet)
 	//	- 3) If there is a packet Duration value, insert it into the packet queue.
 	bool is_inserted_queue = false;
 
-	auto iter = _media_packet_stored.find(track_id);
-	if(iter != _media_packet_stored.end())
+	if(track_state->stored_packet != nullptr)
 	{
-		auto media_packet_cache = iter->second;
-		_media_packet_stored.erase(iter);
+		auto media_packet_cache = std::move(track_state->stored_packet);
+		track_state->stored_packet = nullptr;
 
 		int64_t duration = media_packet->GetDts() - media_packet_cache->GetDts();
 		media_packet_cache->SetDuration(duration);
+		// It was waiting for this packet, not for the queue
+		OnPacketQueued(media_packet_cache, now);
 
-		_media_packets.Enqueue(std::move(media_packet_cache));
+		GetLane(media_packet_cache).Enqueue(std::move(media_packet_cache));
 		is_inserted_queue = true;
 	}
 
 	if(media_packet->GetDuration() == -1LL)
 	{
-		_media_packet_stored[track_id] = media_packet;	
+		track_state->stored_packet = std::move(media_packet);
 	}
 	else
 	{
-		_media_packets.Enqueue(std::move(media_packet));
+		OnPacketQueued(media_packet, now);
+		GetLane(media_packet).Enqueue(std::move(media_packet));
 
 		is_inserted_queue = true;
 	}
@@ -109,50 +229,252 @@ bool MediaRouteStream::Push(std::shared_ptr<MediaPacket> media_packet)
 	return is_inserted_queue;
 }
 
+void MediaRouteStream::Resume()
+{
+	std::lock_guard<std::mutex> lock_guard(_push_mutex);
+
+	_is_resuming = true;
+}
+
+bool MediaRouteStream::StartResuming(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	bool has_video = false;
+
+	for(size_t index = 0; index < _track_count; index++)
+	{
+		has_video |= (_track_states[index].track->GetMediaType() == MediaType::Video);
+	}
+
+	// The decoders/segmenters of the held stream can only continue from a key frame (with the new parameter sets)
+	if(has_video && ((media_packet->GetMediaType() != MediaType::Video) || (media_packet->GetFlag() != MediaPacketFlag::Key)))
+	{
+		return false;
+	}
+
+	// The new ingest starts right after the last packet of the old one, and the tracks keep the offset between them of the new ingest
+	int64_t resume_us = 0;
+
+	for(size_t index = 0; index < _track_count; index++)
+	{
+		const auto &track_state = _track_states[index];
+
+		if(track_state.is_pushed)
+		{
+			const auto &time_base = track_state.track->GetTimeBase();
+			int64_t next_dts_us = (track_state.push_last_dts + track_state.push_dts_inc) * 1000000LL * time_base.GetNum() / time_base.GetDen();
+
+			resume_us = std::max(resume_us, next_dts_us);
+		}
+	}
+
+	const auto &time_base = GetTrackState(media_packet->GetTrackId())->track->GetTimeBase();
+	_resume_offset_us = resume_us - (media_packet->GetDts() * 1000000LL * time_base.GetNum() / time_base.GetDen());
+	_is_resuming = false;
+
+	logti("The held stream is resumed: %s/%s, timestamp offset: %lldus",
+		  _stream->GetApplicationInfo().GetName().CStr(), _stream->GetName().CStr(), _resume_offset_us);
+
+	return true;
+}
+
+void MediaRouteStream::OnPacketQueued(const std::shared_ptr<MediaPacket> &media_packet, const std::chrono::steady_clock::time_point &now)
+{
+	media_packet->SetRoutedTime(now);
+
+	auto &trace = media_packet->GetTrace();
+
+	if(trace != nullptr)
+	{
+		trace->Mark(_inout_type ? mon::PacketTraceStage::RouterOut : mon::PacketTraceStage::RouterIn, now);
+	}
+}
+
+
+ov::Queue<std::shared_ptr<MediaPacket>> &MediaRouteStream::GetLane(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	return (media_packet->GetMediaType() == MediaType::Audio) ? _audio_packets : _video_packets;
+}
+
+int64_t MediaRouteStream::GetDtsMs(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	auto track_state = GetTrackState(media_packet->GetTrackId());
+
+	if(track_state == nullptr)
+	{
+		return 0;
+	}
+
+	return static_cast<int64_t>(media_packet->GetDts() * track_state->track->GetTimeBase().GetExpr() * 1000);
+}
+
+ov::Queue<std::shared_ptr<MediaPacket>> *MediaRouteStream::SelectLane()
+{
+	// Only the thread of the application pops the packets, so the heads are not changed by another thread
+	auto audio_packet_ref = _audio_packets.Peek();
+
+	if(audio_packet_ref.has_value() == false)
+	{
+		return _video_packets.IsEmpty() ? nullptr : &_video_packets;
+	}
+
+	auto video_packet_ref = _video_packets.Peek();
+
+	if(video_packet_ref.has_value())
+	{
+		// The video that is waiting is popped first if the audio would get too far ahead of it
+		if((GetDtsMs(audio_packet_ref.value()) - GetDtsMs(video_packet_ref.value())) > MEDIA_ROUTE_AUDIO_MAX_LEAD_MS)
+		{
+			return &_video_packets;
+		}
+	}
+
+	return &_audio_packets;
+}
+
+void MediaRouteStream::SetJitterBuffer(int max_delay_ms)
+{
+	_jitter_max_delay_ms = std::max(max_delay_ms, 0);
+}
+
+bool MediaRouteStream::IsHeldByJitterBuffer(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if(_jitter_has_base == false)
+	{
+		// The first packet is released at once, and becomes the base
+		return false;
+	}
+
+	auto arrival_ms = std::chrono::duration_cast<std::chrono::milliseconds>(media_packet->GetRoutedTime().time_since_epoch()).count();
+	auto dts_ms = GetDtsMs(media_packet);
+	auto base_ms = std::min({_jitter_previous_min_ms, _jitter_current_min_ms, arrival_ms - dts_ms});
+
+	auto release_ms = dts_ms + base_ms + static_cast<int64_t>(_jitter_target_delay_ms);
+	auto now_ms = ov::Clock::NowMs();
+
+	if((now_ms >= release_ms) || ((now_ms - arrival_ms) >= _jitter_max_delay_ms))
+	{
+		return false;
+	}
+
+	_jitter_next_release_ms = release_ms;
+
+	return true;
+}
+
+void MediaRouteStream::UpdateJitterBuffer(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	auto arrival_ms = std::chrono::duration_cast<std::chrono::milliseconds>(media_packet->GetRoutedTime().time_since_epoch()).count();
+	auto transit_ms = arrival_ms - GetDtsMs(media_packet);
+
+	if((_jitter_has_base == false) ||
+	   ((transit_ms - std::min(_jitter_previous_min_ms, _jitter_current_min_ms)) > MEDIA_ROUTE_JITTER_RESET_MS))
+	{
+		_jitter_has_base = true;
+		_jitter_previous_min_ms = transit_ms;
+		_jitter_current_min_ms = transit_ms;
+		_jitter_window_start_ms = arrival_ms;
+
+		return;
+	}
+
+	if((arrival_ms - _jitter_window_start_ms) >= MEDIA_ROUTE_JITTER_BASE_WINDOW_MS)
+	{
+		// The base follows the drift of the clock of the encoder
+		_jitter_previous_min_ms = _jitter_current_min_ms;
+		_jitter_current_min_ms = transit_ms;
+		_jitter_window_start_ms = arrival_ms;
+	}
+	else
+	{
+		_jitter_current_min_ms = std::min(_jitter_current_min_ms, transit_ms);
+	}
+
+	auto delay_ms = static_cast<double>(transit_ms - std::min(_jitter_previous_min_ms, _jitter_current_min_ms));
+
+	if(delay_ms > _jitter_target_delay_ms)
+	{
+		_jitter_target_delay_ms += (delay_ms - _jitter_target_delay_ms) / 4.0;
+	}
+	else
+	{
+		_jitter_target_delay_ms -= (_jitter_target_delay_ms - delay_ms) / 64.0;
+	}
+
+	_jitter_target_delay_ms = std::clamp(_jitter_target_delay_ms, 0.0, static_cast<double>(_jitter_max_delay_ms));
+}
 
 std::shared_ptr<MediaPacket> MediaRouteStream::Pop()
 {
-	if(_media_packets.IsEmpty())
+	_jitter_next_release_ms = 0;
+
+	auto lane = SelectLane();
+
+	if(lane == nullptr)
 	{
 		return nullptr;
 	}
 
-	auto media_packet_ref = _media_packets.Dequeue();
-	if(media_packet_ref.has_value() == false)
+	if(_jitter_max_delay_ms > 0)
+	{
+		auto head_packet_ref = lane->Peek();
+
+		if(head_packet_ref.has_value() && IsHeldByJitterBuffer(head_packet_ref.value()))
+		{
+			// The worker schedules the stream again at GetNextReleaseMs()
+			return nullptr;
+		}
+	}
+
+	auto media_packet = lane->Dequeue(0).value_or(nullptr);
+
+	if(media_packet == nullptr)
 	{
 		return nullptr;
-	}	
+	}
 
-	auto &media_packet = media_packet_ref.value();
+	if(_jitter_max_delay_ms > 0)
+	{
+		UpdateJitterBuffer(media_packet);
+	}
+
+	_queue_wait_latency->Record(media_packet->GetRoutedTime());
+
+	OV_PROBE5(router_pop, _stream->GetId(), media_packet->GetTrackId(), media_packet->GetPts(), media_packet->GetDataLength(), static_cast<int>(_inout_type));
+
+	if(media_packet->GetTrace() != nullptr)
+	{
+		media_packet->GetTrace()->Mark(_inout_type ? mon::PacketTraceStage::RouterOutPopped : mon::PacketTraceStage::RouterInPopped);
+	}
 
 	auto media_type = media_packet->GetMediaType();
-	auto track_id = media_packet->GetTrackId();
-	auto media_track = _stream->GetTrack(track_id);
+	auto track_state = GetTrackState(media_packet->GetTrackId());
 
-	if (media_track == nullptr)
+	if (track_state == nullptr)
 	{
 		logte("Cannot find media track. media_type(%s), track_id(%d)", (media_type == MediaType::Video) ? "video" : "audio", media_packet->GetTrackId());
 		return nullptr;
 	}
 
+	auto &media_track = track_state->track;
+
 	////////////////////////////////////////////////////////////////////////////////////
 	// PTS Correction for Abnormal increase
 	////////////////////////////////////////////////////////////////////////////////////
 	
-	int64_t timestamp_delta = media_packet->GetPts()  - _stat_recv_pkt_lpts[track_id];
+	int64_t timestamp_delta = media_packet->GetPts() - track_state->last_pts;
 	int64_t scaled_timestamp_delta = timestamp_delta * 1000 /  media_track->GetTimeBase().GetDen();
 
 	if (abs( scaled_timestamp_delta ) > PTS_CORRECT_THRESHOLD_US )
 	{
-		_pts_correct[track_id] = media_packet->GetPts() - _stat_recv_pkt_lpts[track_id] - _pts_avg_inc[track_id];
+		track_state->pts_correct = media_packet->GetPts() - track_state->last_pts - track_state->pts_avg_inc;
 
 #if 0
 		logtw("Detected abnormal increased pts. track_id : %d, prv_pts : %lld, cur_pts : %lld, crt_pts : %lld, avg_inc : %lld"
-			, track_id
-			, _stat_recv_pkt_lpts[track_id]
+			, track_state->track_id
+			, track_state->last_pts
 			, media_packet->GetPts()
-			, _pts_correct[track_id]
-			, _pts_avg_inc[track_id]
+			, track_state->pts_correct
+			, track_state->pts_avg_inc
 		);
 #endif
 	}
@@ -160,99 +482,30 @@ std::shared_ptr<MediaPacket> MediaRouteStream::Pop()
 	{
 		// Originally it should be an average value, Use the difference of the last packet.
 		// Use DTS because the PTS value does not increase uniformly.
-		_pts_avg_inc[track_id] = media_packet->GetDts() - _stat_recv_pkt_ldts[track_id];
+		track_state->pts_avg_inc = media_packet->GetDts() - track_state->last_dts;
 	}
-	
+
+	track_state->last_pts = media_packet->GetPts();
+	track_state->last_dts = media_packet->GetDts();
 
 	////////////////////////////////////////////////////////////////////////////////////
-	// Statistics for log
+	// Statistics for log (See ShowStatistics())
 	////////////////////////////////////////////////////////////////////////////////////
-	_stat_recv_pkt_lpts[track_id] = media_packet->GetPts();
-
-	_stat_recv_pkt_ldts[track_id] = media_packet->GetDts();
-	
-	_stat_recv_pkt_size[track_id] += media_packet->GetData()->GetLength();
-	
-	_stat_recv_pkt_count[track_id]++;
-
+	track_state->stat_last_pts.store(track_state->last_pts, std::memory_order_relaxed);
+	track_state->stat_pts_correct.store(track_state->pts_correct, std::memory_order_relaxed);
+	track_state->stat_packet_bytes.fetch_add(media_packet->GetData()->GetLength(), std::memory_order_relaxed);
+	track_state->stat_packet_count.fetch_add(1, std::memory_order_relaxed);
 
 	// 	Diffrence time of received first packet with uptime.
-	if(_stat_first_time_diff[track_id] == 0)
-	{
-		auto curr_time = std::chrono::system_clock::now();
-		int64_t uptime =  std::chrono::duration_cast<std::chrono::milliseconds>(curr_time - _stat_start_time).count();
-
-		int64_t rescaled_last_pts = _stat_recv_pkt_lpts[track_id] * 1000 /_stream-> GetTrack(track_id)->GetTimeBase().GetDen();
-
-		_stat_first_time_diff[track_id] = uptime - rescaled_last_pts;
-	}
-
-	if (_stop_watch.IsElapsed(5000))
+	if(track_state->stat_first_time_diff.load(std::memory_order_relaxed) == 0)
 	{
-		_stop_watch.Update();
+		int64_t uptime = ov::Clock::CachedNowMs() - _stat_start_time_ms;
 
-		auto curr_time = std::chrono::system_clock::now();
+		int64_t rescaled_last_pts = track_state->last_pts * 1000 / media_track->GetTimeBase().GetDen();
 
-		// Uptime
-		int64_t uptime =  std::chrono::duration_cast<std::chrono::milliseconds>(curr_time - _stat_start_time).count();
-
-		ov::String temp_str = "\n";
-		temp_str.AppendFormat(" - Stream of MediaRouter| type: %s, name: %s/%s, uptime: %lldms , queue: %d" 
-			, _inout_type?"Outgoing":"Incoming"
-			,_stream->GetApplicationInfo().GetName().CStr()
-			,_stream->GetName().CStr()
-			,(int64_t)uptime, _media_packets.Size());
-
-		for(const auto &iter : _stream->GetTracks())
-		{
-			auto track_id = iter.first;
-			auto track = iter.second;
-
-			ov::String pts_str = "";
-
-			// 1/1000 초 단위로 PTS 값을 변환
-			int64_t rescaled_last_pts = _stat_recv_pkt_lpts[track_id] * 1000 / track->GetTimeBase().GetDen();
-
-			// 최소 패킷이 들어오는 시간
-			int64_t first_delay = _stat_first_time_diff[track_id];
-
-			int64_t last_delay = uptime-rescaled_last_pts;
-
-			if(_pts_correct[track_id] != 0)
-			{
-				int64_t corrected_pts = _pts_correct[track_id] * 1000 / track->GetTimeBase().GetDen();
-
-				pts_str.AppendFormat("last_pts(%lldms->%lldms), fist_diff(%5lldms), last_diff(%5lldms), delay(%5lldms), crt_pts : %lld"
-					, rescaled_last_pts
-					, rescaled_last_pts - corrected_pts
-					, first_delay
-					, last_delay
-					, first_delay - last_delay
-					, corrected_pts );
-			}
-			else
-			{
-				pts_str.AppendFormat("last_pts(%lldms), fist_diff(%5lldms), last_diff(%5lldms), delay(%5lldms)"
-					, rescaled_last_pts
-					, first_delay
-					, last_delay
-					, first_delay - last_delay
-				);
-			}
-
-			temp_str.AppendFormat("\n\t[%d] track: %s(%d), %s, pkt_cnt: %lld, pkt_siz: %lldB"
-				, track_id
-				, track->GetMediaType()==MediaType::Video?"video":"audio"
-				, track->GetCodecId()
-				, pts_str.CStr()
-				, _stat_recv_pkt_count[track_id]
-				, _stat_recv_pkt_size[track_id]);
-		}
-
-		logtd("%s", temp_str.CStr());
+		track_state->stat_first_time_diff.store(uptime - rescaled_last_pts, std::memory_order_relaxed);
 	}
 
-
 	////////////////////////////////////////////////////////////////////////////////////
 	// Bitstream Processing
 	////////////////////////////////////////////////////////////////////////////////////
@@ -282,8 +535,7 @@ std::shared_ptr<MediaPacket> MediaRouteStream::Pop()
 	{
 		if (media_track->GetCodecId() == MediaCodecId::Aac)
 		{
-			// _bsfa.convert_to(media_packet->GetData());
-			// logtd("%s", media_packet->GetData()->Dump(32).CStr());
+
 		}
 		else if (media_track->GetCodecId() == MediaCodecId::Opus)
 		{
@@ -302,8 +554,199 @@ std::shared_ptr<MediaPacket> MediaRouteStream::Pop()
 	}
 
 	// Set the corrected PTS.
-	media_packet->SetPts( media_packet->GetPts() - _pts_correct[track_id] );
-	media_packet->SetDts( media_packet->GetDts() - _pts_correct[track_id] );
+	media_packet->SetPts( media_packet->GetPts() - track_state->pts_correct );
+	media_packet->SetDts( media_packet->GetDts() - track_state->pts_correct );
+
+	if(_inout_type == true)
+	{
+		UpdateGopCache(media_packet);
+	}
 
 	return media_packet;
 }
+
+void MediaRouteStream::ShowStatistics()
+{
+	// Uptime
+	int64_t uptime = ov::Clock::NowMs() - _stat_start_time_ms;
+
+	ov::String temp_str = "\n";
+	temp_str.AppendFormat(" - Stream of MediaRouter| type: %s, name: %s/%s, uptime: %lldms , queue: %d" 
+		, _inout_type?"Outgoing":"Incoming"
+		,_stream->GetApplicationInfo().GetName().CStr()
+		,_stream->GetName().CStr()
+		,(int64_t)uptime, _video_packets.Size() + _audio_packets.Size());
+
+	for(size_t index = 0; index < _track_count; index++)
+	{
+		const auto &track_state = _track_states[index];
+		const auto &track = track_state.track;
+
+		ov::String pts_str = "";
+
+		// 1/1000 초 단위로 PTS 값을 변환
+		int64_t rescaled_last_pts = track_state.stat_last_pts.load(std::memory_order_relaxed) * 1000 / track->GetTimeBase().GetDen();
+
+		// 최소 패킷이 들어오는 시간
+		int64_t first_delay = track_state.stat_first_time_diff.load(std::memory_order_relaxed);
+
+		int64_t last_delay = uptime-rescaled_last_pts;
+
+		int64_t pts_correct = track_state.stat_pts_correct.load(std::memory_order_relaxed);
+
+		if(pts_correct != 0)
+		{
+			int64_t corrected_pts = pts_correct * 1000 / track->GetTimeBase().GetDen();
+
+			pts_str.AppendFormat("last_pts(%lldms->%lldms), fist_diff(%5lldms), last_diff(%5lldms), delay(%5lldms), crt_pts : %lld"
+				, rescaled_last_pts
+				, rescaled_last_pts - corrected_pts
+				, first_delay
+				, last_delay
+				, first_delay - last_delay
+				, corrected_pts );
+		}
+		else
+		{
+			pts_str.AppendFormat("last_pts(%lldms), fist_diff(%5lldms), last_diff(%5lldms), delay(%5lldms)"
+				, rescaled_last_pts
+				, first_delay
+				, last_delay
+				, first_delay - last_delay
+			);
+		}
+
+		temp_str.AppendFormat("\n\t[%d] track: %s(%d), %s, pkt_cnt: %lld, pkt_siz: %lldB"
+			, track_state.track_id
+			, track->GetMediaType()==MediaType::Video?"video":"audio"
+			, track->GetCodecId()
+			, pts_str.CStr()
+			, track_state.stat_packet_count.load(std::memory_order_relaxed)
+			, track_state.stat_packet_bytes.load(std::memory_order_relaxed));
+	}
+
+	logtd("%s", temp_str.CStr());
+}
+
+// The const GetData() doesn't separate the payload shared with the publishers
+static size_t GetPayloadLength(const MediaPacket &media_packet)
+{
+	return media_packet.GetData()->GetLength();
+}
+
+void MediaRouteStream::UpdateGopCache(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	std::lock_guard<std::mutex> lock_guard(_gop_cache_lock);
+
+	auto sequence = _gop_cache_first_sequence + _gop_cache.size();
+
+	if((media_packet->GetMediaType() == MediaType::Video) && (media_packet->GetFlag() == MediaPacketFlag::Key))
+	{
+		_gop_key_frame_sequences[media_packet->GetTrackId()] = sequence;
+
+		// The cache starts from the oldest one of the last key frames of the video tracks
+		auto first_sequence = sequence;
+
+		for(const auto &item : _gop_key_frame_sequences)
+		{
+			first_sequence = std::min(first_sequence, item.second);
+		}
+
+		while((_gop_cache.empty() == false) && (_gop_cache_first_sequence < first_sequence))
+		{
+			_gop_cache_bytes -= GetPayloadLength(*_gop_cache.front());
+			_gop_cache.pop_front();
+			_gop_cache_first_sequence++;
+		}
+	}
+	else if(_gop_key_frame_sequences.empty())
+	{
+		// The packets before the first key frame cannot be decoded by the new sessions
+		// (Audio-only streams are not cached at all)
+		return;
+	}
+
+	_gop_cache.push_back(media_packet);
+	_gop_cache_bytes += GetPayloadLength(*media_packet);
+
+	if((_gop_cache_bytes > MEDIA_ROUTE_GOP_CACHE_MAX_BYTES) || (_gop_cache.size() > MEDIA_ROUTE_GOP_CACHE_MAX_PACKETS))
+	{
+		logtd("The GOP cache of the stream(%s) exceeds the limit (%zu bytes, %zu packets), it will be filled again from the next key frame",
+			_stream->GetName().CStr(), _gop_cache_bytes, _gop_cache.size());
+
+		ClearGopCache();
+	}
+}
+
+void MediaRouteStream::ClearGopCache()
+{
+	_gop_cache_first_sequence += _gop_cache.size();
+	_gop_cache.clear();
+	_gop_cache_bytes = 0;
+	_gop_key_frame_sequences.clear();
+}
+
+std::vector<std::shared_ptr<MediaPacket>> MediaRouteStream::GetGopCache()
+{
+	std::lock_guard<std::mutex> lock_guard(_gop_cache_lock);
+
+	return std::vector<std::shared_ptr<MediaPacket>>(_gop_cache.begin(), _gop_cache.end());
+}
+
+void MediaRouteStream::SetUnsubscriptions(Unsubscriptions unsubscriptions)
+{
+	std::shared_ptr<const Unsubscriptions> new_unsubscriptions;
+
+	if (unsubscriptions.empty() == false)
+	{
+		new_unsubscriptions = std::make_shared<const Unsubscriptions>(std::move(unsubscriptions));
+	}
+
+	std::atomic_store(&_unsubscriptions, new_unsubscriptions);
+}
+
+void MediaRouteStream::RemoveUnsubscriptions(const MediaRouteApplicationObserver *observer)
+{
+	auto unsubscriptions = GetUnsubscriptions();
+
+	if (unsubscriptions == nullptr)
+	{
+		return;
+	}
+
+	Unsubscriptions new_unsubscriptions;
+
+	for (const auto &item : *unsubscriptions)
+	{
+		if (item.first != observer)
+		{
+			new_unsubscriptions.push_back(item);
+		}
+	}
+
+	SetUnsubscriptions(std::move(new_unsubscriptions));
+}
+
+std::shared_ptr<const MediaRouteStream::Unsubscriptions> MediaRouteStream::GetUnsubscriptions() const
+{
+	return std::atomic_load(&_unsubscriptions);
+}
+
+bool MediaRouteStream::IsSubscribed(const Unsubscriptions *unsubscriptions, const MediaRouteApplicationObserver *observer, int32_t track_id)
+{
+	if (unsubscriptions == nullptr)
+	{
+		return true;
+	}
+
+	// There are a few entries (observers x tracks), so a linear search is enough
+	for (const auto &item : *unsubscriptions)
+	{
+		if ((item.first == observer) && (item.second == track_id))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
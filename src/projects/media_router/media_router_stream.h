@@ -9,14 +9,19 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <queue>
+#include <deque>
 
 #include "base/media_route/media_route_application_connector.h"
+#include "base/media_route/media_route_application_observer.h"
 #include "base/media_route/media_buffer.h"
 #include "base/media_route/media_type.h"
 #include "base/info/stream.h"
+#include "monitoring/latency_histogram.h"
+#include "modules/media_capture/media_capture.h"
 
 #include "bitstream/bitstream_to_annexb.h"
 #include "bitstream/bitstream_to_adts.h"
@@ -24,6 +29,17 @@
 
 #include "bitstream/avc_video_packet_fragmentizer.h"
 
+// If the GOP cache exceeds these limits (too long GOP), it is dropped and filled again from the next key frame
+#define MEDIA_ROUTE_GOP_CACHE_MAX_BYTES (16 * 1024 * 1024)
+#define MEDIA_ROUTE_GOP_CACHE_MAX_PACKETS 4096
+// How far the audio is popped ahead of the video that is waiting in the queue (See MediaRouteStream::Pop())
+// The segment packetizers interleave the frames in the order of Pop(), so the lead is limited (0: in the order of DTS)
+#define MEDIA_ROUTE_AUDIO_MAX_LEAD_MS 100
+// The jitter buffer takes the minimum transit time (arrival - DTS) of the last 1~2 windows as the base of the stream
+#define MEDIA_ROUTE_JITTER_BASE_WINDOW_MS 10000
+// The base is measured again if a packet is delayed more than this from it (a stall of the ingest or a jump of the timestamps)
+#define MEDIA_ROUTE_JITTER_RESET_MS 5000
+
 class MediaRouteStream
 {
 public:
@@ -31,6 +47,10 @@ public:
 	~MediaRouteStream();
 
 	void SetInoutType(bool inout_type);
+	bool IsOutgoingStream() const
+	{
+		return _inout_type;
+	}
 
 	// Query original stream information
 	std::shared_ptr<info::Stream> GetStream();
@@ -38,10 +58,140 @@ public:
 	MediaRouteApplicationConnector::ConnectorType GetConnectorType();
 
 	// Queue interfaces
+	// The audio and the video are queued in separate lanes, and Pop() prefers the audio,
+	// so the audio is not delayed behind a large key frame or a stall of the video (up to MEDIA_ROUTE_AUDIO_MAX_LEAD_MS)
 	bool Push(std::shared_ptr<MediaPacket> media_packet);
 	std::shared_ptr<MediaPacket> Pop();
 
+	// The packets of the outgoing stream since the last key frame (in the order of Pop()),
+	// the publishers send them to the new sessions so that the sessions don't have to wait for the next key frame.
+	// The packets are shared with the publishers without copying, so they must not be modified.
+	std::vector<std::shared_ptr<MediaPacket>> GetGopCache();
+
+	// [observer, track id] pairs whose packets are not delivered (See MediaRouteApplicationObserver::IsTrackSubscribed()),
+	// nullptr if every observer subscribes every track
+	using Unsubscriptions = std::vector<std::pair<const MediaRouteApplicationObserver *, int32_t>>;
+
+	void SetUnsubscriptions(Unsubscriptions unsubscriptions);
+	// Called when the observer is unregistered (so that the address can be reused by another observer)
+	void RemoveUnsubscriptions(const MediaRouteApplicationObserver *observer);
+	std::shared_ptr<const Unsubscriptions> GetUnsubscriptions() const;
+
+	static bool IsSubscribed(const Unsubscriptions *unsubscriptions, const MediaRouteApplicationObserver *observer, int32_t track_id);
+
+	// Logs the statistics of the tracks, it is called by the thread of the application periodically instead of Pop()
+	void ShowStatistics();
+
+	// Holds the packets of the incoming stream to absorb the bursts of the ingest (See <MediaRouter><JitterBuffer>)
+	//
+	// The target delay follows the delay of the packets from the fastest one (rises quickly, falls slowly), up to max_delay_ms,
+	// and Pop() releases a packet when the target delay has passed since its DTS, so the packets of a burst are paced by DTS.
+	// max_delay_ms: 0 = disabled
+	void SetJitterBuffer(int max_delay_ms);
+
+	// When the packet held by the jitter buffer is released (ov::Clock::NowMs()), 0 if Pop() doesn't hold a packet
+	// (Called by the worker after Pop() returns nullptr)
+	int64_t GetNextReleaseMs() const
+	{
+		return _jitter_next_release_ms;
+	}
+
+	// The provider resumed the stream that was held after its ingest was gone (See <MediaRouter><ReconnectGracePeriod>, incoming stream only)
+	// The packets are dropped until a video key frame (if the stream has video), and the timestamps of the new ingest are shifted
+	// so that they continue from the last packets of the old ingest
+	void Resume();
+
+	// The packets pushed by the provider are written to the capture file (See MediaCapture, incoming stream only)
+	void SetCaptureWriter(const std::shared_ptr<MediaCaptureWriter> &capture_writer);
+
+	// nullptr if the memory accounting is disabled (See ov::MemoryAccounting)
+	const std::shared_ptr<ov::MemoryAccount> &GetMemoryAccount() const
+	{
+		return _memory_account;
+	}
+
+	// The stream is in the ready list of its worker once while it has packets to pop (See MediaRouteApplication::Worker)
+	// Returns false if the stream is already scheduled
+	bool Schedule()
+	{
+		return _is_scheduled.exchange(true) == false;
+	}
+
+	// Called by the worker before it pops the packets, so the packets pushed after that schedule the stream again
+	void Unschedule()
+	{
+		_is_scheduled = false;
+	}
+
+	// The stream is deleted from the application, the packets left in the queues are not delivered
+	void SetRemoved()
+	{
+		_is_removed = true;
+	}
+
+	bool IsRemoved() const
+	{
+		return _is_removed;
+	}
+
 private:
+	friend class MediaRouteApplication;
+
+	// The state of a track, the tracks are known when the stream is created, so they are kept in an array instead of maps
+	// (Push()/Pop() run for every packet)
+	struct TrackState
+	{
+		int32_t track_id = 0;
+		std::shared_ptr<MediaTrack> track;
+
+		// The packet waiting for the next packet to calculate its duration (Push() only)
+		std::shared_ptr<MediaPacket> stored_packet;
+		// The last DTS that is pushed and the increase of it (Push() only, to continue the timestamps on Resume())
+		int64_t push_last_dts = 0;
+		int64_t push_dts_inc = 0;
+		bool is_pushed = false;
+
+		// Store the correction values in case of sudden change in PTS.
+		// If the PTS suddenly increases, the filter behaves incorrectly.
+		// (Pop() only)
+		int64_t pts_correct = 0;
+		// Average Pts Incresement
+		int64_t pts_avg_inc = 0;
+		int64_t last_pts = 0;
+		int64_t last_dts = 0;
+
+		// Statistics, updated by Pop() and read by ShowStatistics() (the values don't have to be consistent with each other)
+		std::atomic<int64_t> stat_last_pts{0};
+		std::atomic<int64_t> stat_pts_correct{0};
+		std::atomic<int64_t> stat_packet_bytes{0};
+		std::atomic<int64_t> stat_packet_count{0};
+		// Diffrence time of received first packet with uptime (0: not received yet)
+		std::atomic<int64_t> stat_first_time_diff{0};
+	};
+
+	// Returns nullptr if the track is not in the stream
+	TrackState *GetTrackState(int32_t track_id);
+
+	// Called with the first packets after Resume(), returns false if the packet is dropped
+	bool StartResuming(const std::shared_ptr<MediaPacket> &media_packet);
+
+	// Sets the time the packet is queued, and marks it to the trace if the packet is traced
+	void OnPacketQueued(const std::shared_ptr<MediaPacket> &media_packet, const std::chrono::steady_clock::time_point &now);
+
+	// The lane of the packet (the packets that are not audio go through the video lane)
+	ov::Queue<std::shared_ptr<MediaPacket>> &GetLane(const std::shared_ptr<MediaPacket> &media_packet);
+	// The lane of the packet that Pop() processes next, nullptr if both lanes are empty
+	ov::Queue<std::shared_ptr<MediaPacket>> *SelectLane();
+	// Returns true if the packet is held by the jitter buffer (the packet is not dequeued yet)
+	bool IsHeldByJitterBuffer(const std::shared_ptr<MediaPacket> &media_packet);
+	// Updates the base and the target delay of the jitter buffer with the released packet
+	void UpdateJitterBuffer(const std::shared_ptr<MediaPacket> &media_packet);
+	// The DTS of the packet in milliseconds
+	int64_t GetDtsMs(const std::shared_ptr<MediaPacket> &media_packet);
+
+	void UpdateGopCache(const std::shared_ptr<MediaPacket> &media_packet);
+	void ClearGopCache();
+
 	// false = incoming stream
 	// true = outgoing stream
 	bool	_inout_type;
@@ -49,8 +199,19 @@ private:
 	std::shared_ptr<info::Stream> _stream;
 	MediaRouteApplicationConnector::ConnectorType _application_connector_type;
 
-	std::map<uint8_t, std::shared_ptr<MediaPacket>> _media_packet_stored;
-	ov::Queue<std::shared_ptr<MediaPacket>> _media_packets;
+	std::mutex _push_mutex;
+	ov::Queue<std::shared_ptr<MediaPacket>> _video_packets;
+	ov::Queue<std::shared_ptr<MediaPacket>> _audio_packets;
+
+	// nullptr if the stream is not captured (protected by _push_mutex)
+	std::shared_ptr<MediaCaptureWriter> _capture_writer;
+
+	// See Resume() (protected by _push_mutex)
+	bool _is_resuming = false;
+	// Added to the timestamps of the resumed ingest (microseconds)
+	int64_t _resume_offset_us = 0;
+
+	std::shared_ptr<ov::MemoryAccount> _memory_account;
 
 	////////////////////////////
 	// bitstream filters
@@ -61,23 +222,48 @@ private:
 
 	AvcVideoPacketFragmentizer _avc_video_fragmentizer;
 
-	// Store the correction values in case of sudden change in PTS.
-	// If the PTS suddenly increases, the filter behaves incorrectly.
-	std::map<uint8_t, int64_t> _pts_correct;
-	// Average Pts Incresement
-	std::map<uint8_t, int64_t> _pts_avg_inc;
+	////////////////////////////
+	// GOP cache (outgoing stream only)
+	////////////////////////////
+	std::mutex _gop_cache_lock;
+	std::deque<std::shared_ptr<MediaPacket>> _gop_cache;
+	size_t _gop_cache_bytes = 0;
+	// Each packet of the cache has a sequence number, _gop_cache[0] is _gop_cache_first_sequence
+	uint64_t _gop_cache_first_sequence = 0;
+	// Video track id : the sequence number of the last key frame of the track
+	std::map<int32_t, uint64_t> _gop_key_frame_sequences;
+
+	// Replaced as a whole, so the worker reads it without a lock (See GetUnsubscriptions())
+	std::shared_ptr<const Unsubscriptions> _unsubscriptions;
+
+	std::unique_ptr<TrackState[]> _track_states;
+	size_t _track_count = 0;
 
-	// statistics 
-	ov::StopWatch _stop_watch;
+	std::atomic<bool> _is_scheduled{false};
+	std::atomic<bool> _is_removed{false};
+	// The next stream in the ready list of the worker (protected by the lock of the worker)
+	std::shared_ptr<MediaRouteStream> _next_ready;
+	// The stream is in the delayed list of the worker (See MediaRouteApplication::MessageLooper(), the thread of the worker only)
+	bool _is_delayed = false;
 
-	std::chrono::time_point<std::chrono::system_clock> _last_recv_time;
-	std::chrono::time_point<std::chrono::system_clock> _stat_start_time;
+	////////////////////////////
+	// Jitter buffer (Pop() only)
+	////////////////////////////
+	int _jitter_max_delay_ms = 0;
+	bool _jitter_has_base = false;
+	// The minimum transit time (ms) of the previous/current window
+	int64_t _jitter_previous_min_ms = 0;
+	int64_t _jitter_current_min_ms = 0;
+	int64_t _jitter_window_start_ms = 0;
+	double _jitter_target_delay_ms = 0.0;
+	int64_t _jitter_next_release_ms = 0;
 
-	std::map<uint8_t, int64_t> _stat_recv_pkt_lpts;
-	std::map<uint8_t, int64_t> _stat_recv_pkt_ldts;
-	std::map<uint8_t, int64_t> _stat_recv_pkt_size;
-	std::map<uint8_t, int64_t> _stat_recv_pkt_count;
+	// Latency histograms (See mon::LatencyMetrics)
+	std::shared_ptr<mon::LatencyHistogram> _ingest_latency;
+	std::shared_ptr<mon::LatencyHistogram> _queue_wait_latency;
 
-	std::map<uint8_t, int64_t> _stat_first_time_diff;
+	// statistics
+	// Monotonic time (ms) of the creation (See ov::Clock)
+	int64_t _stat_start_time_ms = 0;
 };
 
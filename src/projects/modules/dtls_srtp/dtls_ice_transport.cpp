@@ -11,7 +11,7 @@
 
 #define OV_LOG_TAG "DTLS.ICE"
 
-DtlsIceTransport::DtlsIceTransport(uint32_t node_id, std::shared_ptr<pub::Session> session, std::shared_ptr<IcePort> ice_port)
+DtlsIceTransport::DtlsIceTransport(uint32_t node_id, std::shared_ptr<info::Session> session, std::shared_ptr<IcePort> ice_port)
 	: SessionNode(node_id, pub::SessionNodeType::Ice, session)
 {
 	_ice_port = ice_port;
@@ -34,11 +34,30 @@ bool DtlsIceTransport::SendData(pub::SessionNodeType from_node, const std::share
 
 	//logtd("DtlsIceTransport Send by ice port : %d", data->GetLength());
 	// ICE_PORT로 최종 전송한다. (Out of session)
-	_ice_port->Send(GetSession(), data);
+	bool is_sent = _ice_port->Send(GetSession(), data);
+
+	if(_stats != nullptr)
+	{
+		// A datagram of the egress batch is counted when it is queued (See ov::DatagramBatch)
+		if(is_sent)
+		{
+			_stats->sent_bytes += data->GetLength();
+			_stats->sent_packets++;
+		}
+		else
+		{
+			_stats->dropped_packets++;
+		}
+	}
 
 	return true;
 }
 
+void DtlsIceTransport::SetSessionStats(mon::SessionStats *stats)
+{
+	_stats = stats;
+}
+
 // 데이터를 lower에서 받는다. upper node로 보낸다.
 bool DtlsIceTransport::OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data)
 {
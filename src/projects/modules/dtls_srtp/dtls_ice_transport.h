@@ -14,10 +14,10 @@
 #include "modules/ice/ice_port.h"
 
 
-class DtlsIceTransport : public pub::SessionNode
+class DtlsIceTransport final : public pub::SessionNode
 {
 public:
-	DtlsIceTransport(uint32_t node_id, std::shared_ptr<pub::Session> session, std::shared_ptr<IcePort> ice_port);
+	DtlsIceTransport(uint32_t node_id, std::shared_ptr<info::Session> session, std::shared_ptr<IcePort> ice_port);
 	virtual ~DtlsIceTransport();
 
 	// Implement SessionNode Interface
@@ -26,6 +26,10 @@ public:
 	// 데이터를 lower에서 받는다. upper node로 보낸다.
 	bool OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data) override;
 
+	// The sent/dropped datagrams are counted to the stats (must outlive this transport, the session owns both)
+	void SetSessionStats(mon::SessionStats *stats);
+
 private:
 	std::shared_ptr<IcePort> _ice_port;
+	mon::SessionStats *_stats = nullptr;
 };
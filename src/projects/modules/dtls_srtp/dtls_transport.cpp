@@ -2,10 +2,11 @@
 
 #include <utility>
 #include <algorithm>
+#include <chrono>
 
 #define OV_LOG_TAG              "DTLS"
 
-DtlsTransport::DtlsTransport(uint32_t id, std::shared_ptr<pub::Session> session)
+DtlsTransport::DtlsTransport(uint32_t id, std::shared_ptr<info::Session> session)
 	: SessionNode(id, pub::SessionNodeType::Dtls, std::move(session))
 {
 	_state = SSL_NONE;
@@ -17,13 +18,80 @@ DtlsTransport::~DtlsTransport()
 	
 }
 
+int64_t DtlsTransport::GetNowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::shared_ptr<ov::TlsContext> DtlsTransport::CreateTlsContext(const std::shared_ptr<Certificate> &certificate)
+{
+	auto context = ov::TlsContext::Create(DTLS_server_method(), certificate, nullptr, DTLS_CIPHER_LIST, [](SSL_CTX *context) -> bool {
+		SSL_CTX_set_verify(context, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+
+		// The profiles of each session are set by SetSrtpProfiles() (they depend on the session)
+		if(SSL_CTX_set_tlsext_use_srtp(context, GetSrtpProfiles(false).CStr()))
+		{
+			logte("SSL_CTX_set_tlsext_use_srtp failed");
+			return false;
+		}
+
+		return true;
+	});
+
+	if(context == nullptr)
+	{
+		return nullptr;
+	}
+
+	if(context->EnableSessionCache(DTLS_SESSION_ID_CONTEXT, DTLS_SESSION_CACHE_SIZE, DTLS_SESSION_CACHE_TIMEOUT) == false)
+	{
+		// The handshakes are not resumed, but it works
+		logtw("Could not enable the session cache of DTLS");
+	}
+
+	return context;
+}
+
+void DtlsTransport::SetTlsContext(const std::shared_ptr<ov::TlsContext> &context)
+{
+	_tls_context = context;
+}
+
+void DtlsTransport::SetHandshakeCompletedCallback(const HandshakeCompletedCallback &callback)
+{
+	_handshake_completed_callback = callback;
+}
+
 bool DtlsTransport::Stop()
 {
 	_tls.Uninitialize();
+	_ice_transport.reset();
 
 	return SessionNode::Stop();
 }
 
+void DtlsTransport::RegisterLowerNode(std::shared_ptr<pub::SessionNode> node)
+{
+	SessionNode::RegisterLowerNode(node);
+
+	if((node != nullptr) && (node->GetNodeType() == pub::SessionNodeType::Ice))
+	{
+		_ice_transport = std::dynamic_pointer_cast<DtlsIceTransport>(node);
+	}
+}
+
+bool DtlsTransport::SendToIce(const std::shared_ptr<ov::Data> &data)
+{
+	if(_ice_transport != nullptr)
+	{
+		return _ice_transport->SendData(GetNodeType(), data);
+	}
+
+	auto node = GetLowerNode(pub::SessionNodeType::Ice);
+
+	return (node != nullptr) && node->SendData(GetNodeType(), data);
+}
+
 // Set Local Certificate
 void DtlsTransport::SetLocalCertificate(const std::shared_ptr<Certificate> &certificate)
 {
@@ -37,6 +105,43 @@ void DtlsTransport::SetPeerFingerprint(ov::String algorithm, ov::String fingerpr
 	_peer_fingerprint_value = fingerprint;
 }
 
+void DtlsTransport::SetNullCipherAllowed(bool allowed)
+{
+	_is_null_cipher_allowed = allowed;
+}
+
+ov::String DtlsTransport::GetSrtpProfiles(bool is_null_cipher_allowed)
+{
+	// libsrtp supports GCM only if it is built with OpenSSL, so it is checked at once
+	static const bool is_gcm_supported = []() -> bool {
+		bool is_supported = SrtpAdapter::IsCryptoSuiteSupported(SRTP_AEAD_AES_128_GCM) && SrtpAdapter::IsCryptoSuiteSupported(SRTP_AEAD_AES_256_GCM);
+
+		logti("AEAD_AES_GCM SRTP crypto suites are %s", is_supported ? "supported" : "not supported (libsrtp is built without OpenSSL)");
+
+		return is_supported;
+	}();
+
+	// The server's order is the preference:
+	// - SRTP_NULL_*: only if the payloads are encrypted end-to-end (Most browsers don't support them)
+	// - SRTP_AEAD_AES_*_GCM: accelerated by AES-NI/ARMv8-CE, and there is no separate HMAC-SHA1 pass
+	// - SRTP_AES128_CM_*: supported by all peers
+	ov::String srtp_profiles;
+
+	if(is_null_cipher_allowed)
+	{
+		srtp_profiles.Append("SRTP_NULL_SHA1_80:SRTP_NULL_SHA1_32:");
+	}
+
+	if(is_gcm_supported)
+	{
+		srtp_profiles.Append("SRTP_AEAD_AES_128_GCM:SRTP_AEAD_AES_256_GCM:");
+	}
+
+	srtp_profiles.Append("SRTP_AES128_CM_SHA1_80:SRTP_AES128_CM_SHA1_32");
+
+	return srtp_profiles;
+}
+
 // Start DTLS
 bool DtlsTransport::StartDTLS()
 {
@@ -52,12 +157,14 @@ bool DtlsTransport::StartDTLS()
 
 	ov::TlsCallback callback =
 		{
-			.create_callback = [](ov::Tls *tls, SSL_CTX *context) -> bool
+			.create_callback = [this](ov::Tls *tls, SSL_CTX *context) -> bool
 			{
 				tls->SetVerify(SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT);
 
+				auto srtp_profiles = GetSrtpProfiles(_is_null_cipher_allowed);
+
 				// SSL_CTX_set_tlsext_use_srtp() returns 1 on error, 0 on success
-				if(SSL_CTX_set_tlsext_use_srtp(context, "SRTP_AES128_CM_SHA1_80:SRTP_AES128_CM_SHA1_32"))
+				if(SSL_CTX_set_tlsext_use_srtp(context, srtp_profiles.CStr()))
 				{
 					logte("SSL_CTX_set_tlsext_use_srtp failed");
 					return false;
@@ -92,7 +199,16 @@ bool DtlsTransport::StartDTLS()
 			}
 		};
 
-	if(_tls.Initialize(DTLS_server_method(), _local_certificate, nullptr, "DEFAULT:!NULL:!aNULL:!SHA256:!SHA384:!aECDH:!AESGCM+AES256:!aPSK", callback) == false)
+	if(_tls_context != nullptr)
+	{
+		// SSL_CTX is prepared once for all sessions
+		if((_tls.Initialize(_tls_context, callback) == false) || (_tls.SetSrtpProfiles(GetSrtpProfiles(_is_null_cipher_allowed)) == false))
+		{
+			_state = SSL_ERROR;
+			return false;
+		}
+	}
+	else if(_tls.Initialize(DTLS_server_method(), _local_certificate, nullptr, DTLS_CIPHER_LIST, callback) == false)
 	{
 		_state = SSL_ERROR;
 		return false;
@@ -114,18 +230,30 @@ bool DtlsTransport::ContinueSSL()
 
 	if(error == SSL_ERROR_NONE)
 	{
-		_state = SSL_CONNECTED;
-
 		_peer_certificate = _tls.GetPeerCertificate();
 
 		if(_peer_certificate == nullptr)
 		{
+			_state = SSL_ERROR;
 			return false;
 		}
 
 		if(VerifyPeerCertificate() == false)
 		{
-			// Peer Certificate 검증 실패
+			// The peer is not the one that sent the SDP, so the session is not connected
+			_state = SSL_ERROR;
+			return false;
+		}
+
+		_state = SSL_CONNECTED;
+
+		if(_handshake_completed_callback != nullptr)
+		{
+			auto latency_ms = (_handshake_start_ms > 0) ? (GetNowMs() - _handshake_start_ms) : 0;
+			auto is_resumed = _tls.IsSessionReused();
+
+			logtd("DTLS handshake is completed in %lld ms (resumed: %s)", latency_ms, is_resumed ? "true" : "false");
+			_handshake_completed_callback(latency_ms, is_resumed);
 		}
 
 		_peer_certificate->Print();
@@ -147,6 +275,7 @@ bool DtlsTransport::MakeSrtpKey()
 	const ov::String label = "EXTRACTOR-dtls_srtp";
 
 	auto crypto_suite = _tls.GetSelectedSrtpProfileId();
+	logtd("SRTP protection profile is selected: %lu", crypto_suite);
 
 	std::shared_ptr<ov::Data> server_key = std::make_shared<ov::Data>();
 	std::shared_ptr<ov::Data> client_key = std::make_shared<ov::Data>();
@@ -167,10 +296,35 @@ bool DtlsTransport::MakeSrtpKey()
 	return true;
 }
 
+// Compares the digest of the peer certificate with the fingerprint of the SDP (RFC 8122)
 bool DtlsTransport::VerifyPeerCertificate()
 {
-	// TODO: PEER CERTIFICATE와 SDP에서 받은 Digest를 비교하여 검증한다.
-	logtd("Accepted peer certificate");
+	_peer_cerificate_verified = false;
+
+	if(_peer_fingerprint_value.IsEmpty())
+	{
+		logte("The peer certificate cannot be verified: the fingerprint is not signalled");
+		return false;
+	}
+
+	// The algorithm is case-insensitive, and the value is upper case hex with colons
+	auto algorithm = _peer_fingerprint_algorithm.LowerCaseString();
+	auto fingerprint = _peer_certificate->GetFingerprint(algorithm);
+
+	if(fingerprint.IsEmpty())
+	{
+		logte("The peer certificate cannot be verified: unsupported fingerprint algorithm (%s)", _peer_fingerprint_algorithm.CStr());
+		return false;
+	}
+
+	if((fingerprint == _peer_fingerprint_value.UpperCaseString()) == false)
+	{
+		logte("The fingerprint of the peer certificate does not match the SDP (%s %s, expected: %s)",
+			  algorithm.CStr(), fingerprint.CStr(), _peer_fingerprint_value.CStr());
+		return false;
+	}
+
+	logtd("Accepted peer certificate (%s %s)", algorithm.CStr(), fingerprint.CStr());
 	_peer_cerificate_verified = true;
 	return true;
 }
@@ -197,13 +351,7 @@ bool DtlsTransport::SendData(pub::SessionNodeType from_node, const std::shared_p
 			// SRTP는 이미 암호화가 되었으므로 ICE로 바로 전송한다.
 			if(from_node == pub::SessionNodeType::Srtp)
 			{
-				auto node = GetLowerNode(pub::SessionNodeType::Ice);
-				if(node == nullptr)
-				{
-					return false;
-				}
-				//logtd("DtlsTransport Send next node : %d", data->GetLength());
-				return node->SendData(GetNodeType(), data);
+				return SendToIce(data);
 			}
 			else
 			{
@@ -263,6 +411,12 @@ bool DtlsTransport::OnDataReceived(pub::SessionNodeType from_node, const std::sh
 				// SSL에 읽어가라고 명령을 내린다.
 				if(_state == SSL_CONNECTING)
 				{
+					if(_handshake_start_ms == 0)
+					{
+						// ClientHello
+						_handshake_start_ms = GetNowMs();
+					}
+
 					// 연결중이면 SSL_accept를 해야 한다.
 					ContinueSSL();
 				}
@@ -294,25 +448,21 @@ bool DtlsTransport::OnDataReceived(pub::SessionNodeType from_node, const std::sh
 				// SRTP, SRTCP,
 			else
 			{
-				// 이 서버는 현재 RTP를 받지 않으므로, RTCP가 유일하다.
-				// DTLS, RTP(RTCP) 이외의 패킷은 비정상 패킷이다.
-				// rtcp에서 검증 처리 있어 주석 처리
-				// if(!IsRtpPacket(data))
-				// {
-				// 	break;
-				// }
+				// SRTP/SRTCP can be received only after the keys are exported
+				if(_state != SSL_CONNECTED)
+				{
+					return false;
+				}
 
 				// pass to srtp
-				// TODO(getroot): 나중에 RTCP 구현 할 것
-				// auto node = GetUpperNode();
+				auto node = GetUpperNode();
 
-                // if(node == nullptr)
-                // {
-                //     return false;
-                // }
-                // node->OnDataReceived(GetNodeType(), data);
+				if(node == nullptr)
+				{
+					return false;
+				}
 
-				return true;
+				return node->OnDataReceived(GetNodeType(), data);
 			}
 			break;
 		case SSL_ERROR:
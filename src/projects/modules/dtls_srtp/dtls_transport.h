@@ -6,36 +6,60 @@
 
 #include "modules/ice/ice_port.h"
 #include "srtp_transport.h"
+#include "dtls_ice_transport.h"
 
 #define DTLS_RECORD_HEADER_LEN                  13
 #define MAX_DTLS_PACKET_LEN                     2048
 #define MIN_RTP_PACKET_LEN                      12
 
-class DtlsTransport : public pub::SessionNode
+#define DTLS_CIPHER_LIST                        "DEFAULT:!NULL:!aNULL:!SHA256:!SHA384:!aECDH:!AESGCM+AES256:!aPSK"
+// The sessions of the reconnecting peers are resumed from the cache of the context
+#define DTLS_SESSION_ID_CONTEXT                 "OvenMediaEngine-DTLS-SRTP"
+#define DTLS_SESSION_CACHE_SIZE                 (32 * 1024)
+#define DTLS_SESSION_CACHE_TIMEOUT              300
+
+class DtlsTransport final : public pub::SessionNode
 {
 public:
 	// Send : Srtp -> this -> Ice
 	// Recv : Ice -> {[Queue] -> Application -> Session} -> this -> Srtp
-	explicit DtlsTransport(uint32_t id, std::shared_ptr<pub::Session> session);
+	explicit DtlsTransport(uint32_t id, std::shared_ptr<info::Session> session);
 	virtual ~DtlsTransport();
 
+	// Creates the context which is shared by the DtlsTransports of the certificate (session cache is enabled)
+	static std::shared_ptr<ov::TlsContext> CreateTlsContext(const std::shared_ptr<Certificate> &certificate);
+
+	// If the context is set, it is used instead of creating SSL_CTX for this session (must be called before StartDTLS())
+	void SetTlsContext(const std::shared_ptr<ov::TlsContext> &context);
+
+	// latency_ms: from the first DTLS packet from the peer to the completion of the handshake
+	// is_resumed: whether the session is resumed
+	typedef std::function<void(int64_t latency_ms, bool is_resumed)> HandshakeCompletedCallback;
+	void SetHandshakeCompletedCallback(const HandshakeCompletedCallback &callback);
+
 	// Set Local Certificate
 	void SetLocalCertificate(const std::shared_ptr<Certificate> &certificate);
 
 	// Set Peer Fingerprint for verification
 	void SetPeerFingerprint(ov::String algorithm, ov::String fingerprint);
 
+	// Prefer the SRTP profiles without the encryption (SRTP_NULL_SHA1_80/32) if the peer supports them.
+	// Used when the payloads are already encrypted end-to-end (SFrame), must be called before StartDTLS()
+	void SetNullCipherAllowed(bool allowed);
+
 	// Start DTLS
 	bool StartDTLS();
 
 	bool Stop() override;
+	// If the lower node is DtlsIceTransport, the packets are sent to it directly (without the lookup of the node and the virtual dispatch)
+	void RegisterLowerNode(std::shared_ptr<pub::SessionNode> node) override;
 	//--------------------------------------------------------------------
 	// Implementation of SessionNode
 	//--------------------------------------------------------------------
 	// Receive data from upper node, and send data to lower node.
-	bool SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data);
+	bool SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data) override;
 	// Receive data from lower node, and send data to upper node.
-	bool OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data);
+	bool OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data) override;
 
 	// IcePort -> Publisher ->[queue] Application {thread}-> Session -> DtlsTransport -> SRTP -> RTP/RTCP
 	// ICE에서는 STUN을 제외한 모든 패킷을 위로 올린다.
@@ -55,6 +79,7 @@ protected:
 	bool VerifyPeerCertificate();
 
 private:
+	bool SendToIce(const std::shared_ptr<ov::Data> &data);
 	bool ContinueSSL();
 	bool IsDtlsPacket(const std::shared_ptr<const ov::Data> data);
 	bool IsRtpPacket(const std::shared_ptr<const ov::Data> data);
@@ -62,6 +87,8 @@ private:
 	std::shared_ptr<const ov::Data> TakeDtlsPacket();
 
 	bool MakeSrtpKey();
+	// The list of the DTLS-SRTP protection profiles in the order of the preference
+	static ov::String GetSrtpProfiles(bool is_null_cipher_allowed);
 
 	enum SSLState
 	{
@@ -73,15 +100,24 @@ private:
 		SSL_CLOSED
 	};
 
-	SSLState _state;
+	static int64_t GetNowMs();
+
+	// SendData() (the stream workers) reads it while the handshake is processed
+	std::atomic<SSLState> _state;
 	bool _peer_cerificate_verified;
 	std::shared_ptr<info::Session> _session_info;
 	std::shared_ptr<IcePort> _ice_port;
 	std::shared_ptr<SrtpTransport> _srtp_transport;
+	std::shared_ptr<DtlsIceTransport> _ice_transport;
 	std::shared_ptr<Certificate> _local_certificate;
 	std::shared_ptr<Certificate> _peer_certificate;
 	ov::String _peer_fingerprint_algorithm;
 	ov::String _peer_fingerprint_value;
+	bool _is_null_cipher_allowed = false;
+
+	std::shared_ptr<ov::TlsContext> _tls_context;
+	HandshakeCompletedCallback _handshake_completed_callback;
+	int64_t _handshake_start_ms = 0;
 
 	// SSL이 가져갈 패킷을 임시로 보관하는 버퍼, 동시에 1개만 저장한다.
 	std::deque<std::shared_ptr<const ov::Data>> _packet_buffer;
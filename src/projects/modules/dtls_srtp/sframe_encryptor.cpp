@@ -0,0 +1,244 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "sframe_encryptor.h"
+
+#include <base/ovcrypto/ovcrypto.h>
+#include <openssl/rand.h>
+
+#define OV_LOG_TAG "SFrame"
+
+#define SFRAME_HMAC_SIZE 32
+
+// HKDF-Extract(salt, ikm) (RFC 5869)
+static bool HkdfExtract(const void *salt, size_t salt_length, const void *ikm, size_t ikm_length, uint8_t prk[SFRAME_HMAC_SIZE])
+{
+	return ov::MessageDigest::ComputeHmac(ov::CryptoAlgorithm::Sha256, salt, salt_length, ikm, ikm_length, prk, SFRAME_HMAC_SIZE);
+}
+
+// HKDF-Expand(prk, info, length) (RFC 5869), length must be less than or equal to the size of HMAC
+static bool HkdfExpand(const uint8_t prk[SFRAME_HMAC_SIZE], const char *info, uint8_t *output, size_t length)
+{
+	uint8_t input[64];
+	auto info_length = ::strlen(info);
+
+	if ((length > SFRAME_HMAC_SIZE) || ((info_length + 1) > sizeof(input)))
+	{
+		return false;
+	}
+
+	// T(1) = HMAC(PRK, info | 0x01)
+	::memcpy(input, info, info_length);
+	input[info_length] = 0x01;
+
+	uint8_t block[SFRAME_HMAC_SIZE];
+
+	if (ov::MessageDigest::ComputeHmac(ov::CryptoAlgorithm::Sha256, prk, SFRAME_HMAC_SIZE, input, info_length + 1, block, sizeof(block)) == false)
+	{
+		return false;
+	}
+
+	::memcpy(output, block, length);
+
+	return true;
+}
+
+// The minimum number of bytes to represent the value (at least 1)
+static size_t GetByteLength(uint64_t value)
+{
+	size_t length = 1;
+
+	while ((length < 8) && ((value >> (length * 8)) != 0))
+	{
+		length++;
+	}
+
+	return length;
+}
+
+std::shared_ptr<ov::Data> SFrameEncryptor::GenerateKey()
+{
+	auto key = std::make_shared<ov::Data>();
+
+	key->SetLength(SFRAME_BASE_KEY_SIZE);
+
+	if (::RAND_bytes(key->GetWritableDataAs<uint8_t>(), SFRAME_BASE_KEY_SIZE) != 1)
+	{
+		logte("Could not generate the key");
+		return nullptr;
+	}
+
+	return key;
+}
+
+SFrameEncryptor::SFrameEncryptor(uint64_t key_id, const std::shared_ptr<const ov::Data> &base_key)
+	: _key_id(key_id),
+	  _base_key(base_key)
+{
+	if (DeriveKeys() == false)
+	{
+		logte("Could not derive the keys of SFrame (key id: %llu)", key_id);
+		return;
+	}
+
+	_cipher_context = ::EVP_CIPHER_CTX_new();
+}
+
+SFrameEncryptor::~SFrameEncryptor()
+{
+	if (_cipher_context != nullptr)
+	{
+		::EVP_CIPHER_CTX_free(_cipher_context);
+		_cipher_context = nullptr;
+	}
+
+	OPENSSL_cleanse(_encryption_key, sizeof(_encryption_key));
+	OPENSSL_cleanse(_authentication_key, sizeof(_authentication_key));
+}
+
+bool SFrameEncryptor::DeriveKeys()
+{
+	if ((_base_key == nullptr) || (_base_key->GetLength() == 0))
+	{
+		return false;
+	}
+
+	// sframe_secret = HKDF-Extract("SFrame10", base_key)
+	// sframe_key = HKDF-Expand(sframe_secret, "key", 16)
+	// sframe_salt = HKDF-Expand(sframe_secret, "salt", 12)
+	uint8_t sframe_secret[SFRAME_HMAC_SIZE];
+	uint8_t sframe_key[SFRAME_ENCRYPTION_KEY_SIZE];
+
+	static const char sframe_label[] = "SFrame10";
+
+	if ((HkdfExtract(sframe_label, sizeof(sframe_label) - 1, _base_key->GetData(), _base_key->GetLength(), sframe_secret) == false) ||
+		(HkdfExpand(sframe_secret, "key", sframe_key, sizeof(sframe_key)) == false) ||
+		(HkdfExpand(sframe_secret, "salt", _salt, sizeof(_salt)) == false))
+	{
+		return false;
+	}
+
+	// AES-CM suites split the key into the encryption key and the authentication key:
+	// aead_secret = HKDF-Extract("SFrame10 AES CM AEAD", sframe_key)
+	// enc_key = HKDF-Expand(aead_secret, "enc", 16)
+	// auth_key = HKDF-Expand(aead_secret, "auth", 32)
+	uint8_t aead_secret[SFRAME_HMAC_SIZE];
+
+	static const char aead_label[] = "SFrame10 AES CM AEAD";
+
+	bool result = HkdfExtract(aead_label, sizeof(aead_label) - 1, sframe_key, sizeof(sframe_key), aead_secret) &&
+				  HkdfExpand(aead_secret, "enc", _encryption_key, sizeof(_encryption_key)) &&
+				  HkdfExpand(aead_secret, "auth", _authentication_key, sizeof(_authentication_key));
+
+	OPENSSL_cleanse(sframe_secret, sizeof(sframe_secret));
+	OPENSSL_cleanse(sframe_key, sizeof(sframe_key));
+	OPENSSL_cleanse(aead_secret, sizeof(aead_secret));
+
+	return result;
+}
+
+bool SFrameEncryptor::IsValid() const
+{
+	return _cipher_context != nullptr;
+}
+
+uint64_t SFrameEncryptor::GetKeyId() const
+{
+	return _key_id;
+}
+
+std::shared_ptr<const ov::Data> SFrameEncryptor::GetBaseKey() const
+{
+	return _base_key;
+}
+
+size_t SFrameEncryptor::WriteHeader(uint64_t counter, uint8_t *buffer) const
+{
+	auto counter_length = GetByteLength(counter);
+	size_t offset = 1;
+
+	// R(1) = 0, LEN(3) = the length of CTR - 1
+	buffer[0] = static_cast<uint8_t>((counter_length - 1) << 4);
+
+	if (_key_id < 8)
+	{
+		// X(1) = 0, K(3) = KID
+		buffer[0] |= static_cast<uint8_t>(_key_id);
+	}
+	else
+	{
+		// X(1) = 1, K(3) = the length of KID - 1
+		auto key_id_length = GetByteLength(_key_id);
+
+		buffer[0] |= static_cast<uint8_t>(0x08 | (key_id_length - 1));
+
+		for (size_t index = 0; index < key_id_length; index++)
+		{
+			buffer[offset++] = static_cast<uint8_t>(_key_id >> ((key_id_length - 1 - index) * 8));
+		}
+	}
+
+	for (size_t index = 0; index < counter_length; index++)
+	{
+		buffer[offset++] = static_cast<uint8_t>(counter >> ((counter_length - 1 - index) * 8));
+	}
+
+	return offset;
+}
+
+std::shared_ptr<ov::Data> SFrameEncryptor::Encrypt(const void *frame, size_t frame_length)
+{
+	if (IsValid() == false)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	auto counter = _counter++;
+
+	auto data = std::make_shared<ov::Data>(SFRAME_MAX_HEADER_SIZE + frame_length + SFRAME_TAG_SIZE);
+	data->SetLength(SFRAME_MAX_HEADER_SIZE + frame_length + SFRAME_TAG_SIZE);
+
+	auto buffer = data->GetWritableDataAs<uint8_t>();
+	auto header_length = WriteHeader(counter, buffer);
+
+	// IV = salt XOR CTR (left-padded to the size of the salt), and the initial counter block of AES-CM is IV | 0^32
+	uint8_t counter_block[16] = {0};
+
+	::memcpy(counter_block, _salt, sizeof(_salt));
+
+	for (size_t index = 0; index < 8; index++)
+	{
+		counter_block[sizeof(_salt) - 1 - index] ^= static_cast<uint8_t>(counter >> (index * 8));
+	}
+
+	int out_length = 0;
+
+	if ((::EVP_EncryptInit_ex(_cipher_context, ::EVP_aes_128_ctr(), nullptr, _encryption_key, counter_block) != 1) ||
+		(::EVP_EncryptUpdate(_cipher_context, buffer + header_length, &out_length, static_cast<const uint8_t *>(frame), static_cast<int>(frame_length)) != 1))
+	{
+		logte("Could not encrypt the frame (length: %zu)", frame_length);
+		return nullptr;
+	}
+
+	// tag = HMAC(auth_key, header | ciphertext)
+	uint8_t hmac[SFRAME_HMAC_SIZE];
+
+	if (ov::MessageDigest::ComputeHmac(ov::CryptoAlgorithm::Sha256, _authentication_key, sizeof(_authentication_key), buffer, header_length + frame_length, hmac, sizeof(hmac)) == false)
+	{
+		logte("Could not compute the tag of the frame (length: %zu)", frame_length);
+		return nullptr;
+	}
+
+	::memcpy(buffer + header_length + frame_length, hmac, SFRAME_TAG_SIZE);
+
+	data->SetLength(header_length + frame_length + SFRAME_TAG_SIZE);
+
+	return data;
+}
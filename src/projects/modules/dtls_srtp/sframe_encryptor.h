@@ -0,0 +1,66 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <openssl/evp.h>
+
+#include <mutex>
+
+#define SFRAME_BASE_KEY_SIZE 16
+#define SFRAME_ENCRYPTION_KEY_SIZE 16
+#define SFRAME_AUTHENTICATION_KEY_SIZE 32
+#define SFRAME_SALT_SIZE 12
+// AES_CM_128_HMAC_SHA256_8
+#define SFRAME_TAG_SIZE 8
+// Config byte + KID (up to 8 bytes) + CTR (up to 8 bytes)
+#define SFRAME_MAX_HEADER_SIZE 17
+
+// Encrypts the media frames end-to-end with SFrame (draft-ietf-sframe-enc-01, AES_CM_128_HMAC_SHA256_8).
+//
+// A frame is encrypted once for all sessions of a stream (unlike SRTP, the key doesn't depend on the session),
+// and the key is delivered to the players with the signalling.
+//
+//  +-+-+-+-+-+-+-+-+---------------+---------------+-----------------+---------+
+//  |R|LEN  |X|  K  |  KID (0-7 B)  |  CTR (1-8 B)  |  Encrypted frame |   Tag   |
+//  +-+-+-+-+-+-+-+-+---------------+---------------+-----------------+---------+
+class SFrameEncryptor
+{
+public:
+	// Generates a new random base key
+	static std::shared_ptr<ov::Data> GenerateKey();
+
+	SFrameEncryptor(uint64_t key_id, const std::shared_ptr<const ov::Data> &base_key);
+	~SFrameEncryptor();
+
+	bool IsValid() const;
+
+	uint64_t GetKeyId() const;
+	std::shared_ptr<const ov::Data> GetBaseKey() const;
+
+	// Returns SFrame header + encrypted frame + tag (nullptr if failed)
+	std::shared_ptr<ov::Data> Encrypt(const void *frame, size_t frame_length);
+
+private:
+	bool DeriveKeys();
+	size_t WriteHeader(uint64_t counter, uint8_t *buffer) const;
+
+	uint64_t _key_id;
+	std::shared_ptr<const ov::Data> _base_key;
+
+	uint8_t _encryption_key[SFRAME_ENCRYPTION_KEY_SIZE];
+	uint8_t _authentication_key[SFRAME_AUTHENTICATION_KEY_SIZE];
+	uint8_t _salt[SFRAME_SALT_SIZE];
+
+	// The video and audio frames are encrypted with the same key, so the counter is shared
+	std::mutex _mutex;
+	uint64_t _counter = 0;
+	EVP_CIPHER_CTX *_cipher_context = nullptr;
+};
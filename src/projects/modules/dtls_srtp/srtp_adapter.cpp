@@ -9,6 +9,7 @@
 
 #include <openssl/srtp.h>
 #include <base/ovlibrary/byte_io.h>
+#include <base/ovlibrary/probe.h>
 #include "srtp_adapter.h"
 
 #define OV_LOG_TAG "SRTP"
@@ -33,26 +34,87 @@ bool SrtpAdapter::Release()
 	return true;
 }
 
-bool SrtpAdapter::SetKey(srtp_ssrc_type_t type, uint64_t crypto_suite, std::shared_ptr<ov::Data> key)
+// Sets the crypto policies of RTP/RTCP for the crypto suite (the ID of the DTLS-SRTP protection profile)
+static bool SetCryptoPolicy(uint64_t crypto_suite, srtp_policy_t *policy)
 {
-	srtp_policy_t policy;
-	memset(&policy, 0, sizeof(policy));
-
 	switch(crypto_suite)
 	{
 		case SRTP_AES128_CM_SHA1_80:
-			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtp);
-			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy.rtcp);
+			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy->rtp);
+			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_80(&policy->rtcp);
 			break;
 		case SRTP_AES128_CM_SHA1_32:
-			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy.rtp);
-			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy.rtcp);
+			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy->rtp);
+			srtp_crypto_policy_set_aes_cm_128_hmac_sha1_32(&policy->rtcp);
+			break;
+		// Authentication only (the payloads are encrypted end-to-end by SFrame)
+		case SRTP_NULL_SHA1_80:
+			srtp_crypto_policy_set_null_cipher_hmac_sha1_80(&policy->rtp);
+			srtp_crypto_policy_set_null_cipher_hmac_sha1_80(&policy->rtcp);
+			break;
+		case SRTP_NULL_SHA1_32:
+			// There is no null_cipher_hmac_sha1_32 policy, RTCP uses 80-bit tag as SRTP_AES128_CM_SHA1_32 does
+			srtp_crypto_policy_set_null_cipher_hmac_sha1_80(&policy->rtp);
+			policy->rtp.auth_tag_len = 4;
+			srtp_crypto_policy_set_null_cipher_hmac_sha1_80(&policy->rtcp);
+			break;
+		// AES-NI/ARMv8-CE accelerated (by OpenSSL), and there is no separate HMAC-SHA1 pass
+		case SRTP_AEAD_AES_128_GCM:
+			srtp_crypto_policy_set_aes_gcm_128_16_auth(&policy->rtp);
+			srtp_crypto_policy_set_aes_gcm_128_16_auth(&policy->rtcp);
+			break;
+		case SRTP_AEAD_AES_256_GCM:
+			srtp_crypto_policy_set_aes_gcm_256_16_auth(&policy->rtp);
+			srtp_crypto_policy_set_aes_gcm_256_16_auth(&policy->rtcp);
 			break;
 		default:
-			logte("Failed to create srtp adapter. Unsupported crypto suite %d", crypto_suite);
 			return false;
 	}
 
+	return true;
+}
+
+bool SrtpAdapter::IsCryptoSuiteSupported(uint64_t crypto_suite)
+{
+	srtp_policy_t policy;
+	memset(&policy, 0, sizeof(policy));
+
+	if(SetCryptoPolicy(crypto_suite, &policy) == false)
+	{
+		return false;
+	}
+
+	// Try to create a session with a dummy key (key + salt, up to 256 bits + 96 bits)
+	uint8_t key[44] = { 0 };
+
+	policy.ssrc.type = ssrc_any_outbound;
+	policy.key = key;
+	policy.window_size = 1024;
+	policy.next = nullptr;
+
+	srtp_t session = nullptr;
+
+	if(srtp_create(&session, &policy) != srtp_err_status_ok)
+	{
+		return false;
+	}
+
+	srtp_dealloc(session);
+
+	return true;
+}
+
+bool SrtpAdapter::SetKey(srtp_ssrc_type_t type, uint64_t crypto_suite, std::shared_ptr<ov::Data> key)
+{
+	srtp_policy_t policy;
+	memset(&policy, 0, sizeof(policy));
+
+	if(SetCryptoPolicy(crypto_suite, &policy) == false)
+	{
+		logte("Failed to create srtp adapter. Unsupported crypto suite %d", crypto_suite);
+		return false;
+	}
+
 	policy.ssrc.type = type;
 	policy.ssrc.value = 0;
 	policy.key = key->GetWritableDataAs<uint8_t>();
@@ -104,6 +166,8 @@ bool SrtpAdapter::ProtectRtp(std::shared_ptr<ov::Data> data)
 	uint8_t red_payload_type = byte_buffer[12];
 	uint16_t seq = ByteReader<uint16_t>::ReadBigEndian(&byte_buffer[2]);
 
+	OV_PROBE3(srtp_protect, payload_type, seq, out_len);
+
 	int err = srtp_protect(_session, buffer, &out_len);
 	if(err != srtp_err_status_ok)
 	{
@@ -144,6 +208,30 @@ bool SrtpAdapter::ProtectRtcp(std::shared_ptr<ov::Data> data)
     return true;
 }
 
+bool SrtpAdapter::UnprotectRtp(const std::shared_ptr<ov::Data> &data)
+{
+    if (!_session)
+    {
+        return false;
+    }
+
+    auto buffer = data->GetWritableData();
+    int out_len = static_cast<int>(data->GetLength());
+
+    int err = srtp_unprotect(_session, buffer, &out_len);
+
+    if (err != srtp_err_status_ok)
+    {
+        // The retransmitted(replayed) packets also fail here
+        logtd("Failed to unprotect SRTP packet, err=%d", err);
+        return false;
+    }
+
+    data->SetLength(out_len);
+
+    return true;
+}
+
 bool SrtpAdapter::UnprotectRtcp(const std::shared_ptr<ov::Data> &data)
 {
     if (!_session)
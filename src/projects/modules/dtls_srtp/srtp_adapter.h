@@ -23,9 +23,13 @@ public:
 
 	bool	SetKey(srtp_ssrc_type_t type, uint64_t crypto_suite, std::shared_ptr<ov::Data> key);
 
+	// AEAD_AES_128_GCM/AEAD_AES_256_GCM are available only when libsrtp is built with OpenSSL
+	static bool	IsCryptoSuiteSupported(uint64_t crypto_suite);
+
 	bool	ProtectRtp(std::shared_ptr<ov::Data> data);
 
     bool	ProtectRtcp(std::shared_ptr<ov::Data> data);
+    bool	UnprotectRtp(const std::shared_ptr<ov::Data> &data);
     bool	UnprotectRtcp(const std::shared_ptr<ov::Data> &data);
 
 private:
@@ -11,7 +11,7 @@
 
 #define OV_LOG_TAG "SRTP"
 
-SrtpTransport::SrtpTransport(uint32_t node_id, std::shared_ptr<pub::Session> session)
+SrtpTransport::SrtpTransport(uint32_t node_id, std::shared_ptr<info::Session> session)
 	: SessionNode(node_id, pub::SessionNodeType::Srtp, session)
 {
 
@@ -33,9 +33,18 @@ bool SrtpTransport::Stop()
 		_recv_session->Release();
 	}
 
+	_dtls_transport.reset();
+
 	return SessionNode::Stop();
 }
 
+void SrtpTransport::RegisterLowerNode(std::shared_ptr<pub::SessionNode> node)
+{
+	SessionNode::RegisterLowerNode(node);
+
+	_dtls_transport = std::dynamic_pointer_cast<DtlsTransport>(node);
+}
+
 // 데이터를 upper(RTP_RTCP)에서 받는다. lower node(DTLS)로 보낸다.
 bool SrtpTransport::SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data)
 {
@@ -71,6 +80,11 @@ bool SrtpTransport::SendData(pub::SessionNodeType from_node, const std::shared_p
 	}
 
 	// DTLS로 보낸다.
+	if(_dtls_transport != nullptr)
+	{
+		return _dtls_transport->SendData(GetNodeType(), data);
+	}
+
 	auto node = GetLowerNode();
 	if(!node)
 	{
@@ -90,25 +104,46 @@ bool SrtpTransport::OnDataReceived(pub::SessionNodeType from_node, const std::sh
 		return false;
 	}
 
-	// TODO(getroot): _recv_session가 생성되기 전에 호출되는 경우가 있음. 확인 필요
-	// auto decode_data = data->Clone();
+	// The packets can arrive before the key is exported by the DTLS handshake
+	if(_recv_session == nullptr)
+	{
+		return false;
+	}
 
-    // if(!_recv_session->UnprotectRtcp(decode_data))
-    // {
-    //     logtd("stcp unprotected fail");
-    //     return false;
-    // }
+	if(data->GetLength() < 2)
+	{
+		return false;
+	}
 
-	// // pass to rtcp
-    // auto node = GetUpperNode();
+	// RTP and RTCP are multiplexed, they are distinguished by the payload type (RFC 5761: 192~223 is RTCP)
+	uint8_t payload_type = data->GetDataAs<uint8_t>()[1];
+	bool is_rtcp = (payload_type >= 192) && (payload_type <= 223);
 
-    // if(node == nullptr)
-    // {
-    //     return false;
-    // }
-    // node->OnDataReceived(GetNodeType(), decode_data);
+	auto decode_data = data->Clone();
 
-	return true;
+	if(is_rtcp)
+	{
+		if(_recv_session->UnprotectRtcp(decode_data) == false)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		if(_recv_session->UnprotectRtp(decode_data) == false)
+		{
+			return false;
+		}
+	}
+
+	auto node = GetUpperNode();
+
+	if(node == nullptr)
+	{
+		return false;
+	}
+
+	return node->OnDataReceived(is_rtcp ? pub::SessionNodeType::Rtcp : pub::SessionNodeType::Rtp, decode_data);
 }
 
 // SRTP 를 초기화 한다.
@@ -13,14 +13,19 @@
 #include "modules/rtp_rtcp/rtp_rtcp.h"
 #include "srtp_adapter.h"
 
-class SrtpTransport : public pub::SessionNode
+class DtlsTransport;
+
+class SrtpTransport final : public pub::SessionNode
 {
 public:
-	SrtpTransport(uint32_t node_id, std::shared_ptr<pub::Session> session);
+	SrtpTransport(uint32_t node_id, std::shared_ptr<info::Session> session);
 	virtual ~SrtpTransport();
 
 	bool Stop() override;
 
+	// If the lower node is DtlsTransport, the packets are sent to it directly (without the lookup of the node and the virtual dispatch)
+	void RegisterLowerNode(std::shared_ptr<pub::SessionNode> node) override;
+
 	// 데이터를 upper에서 받는다. lower node로 보낸다.
 	bool SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data) override;
 
@@ -34,4 +39,6 @@ public:
 private:
 	std::shared_ptr<SrtpAdapter>		_send_session;
 	std::shared_ptr<SrtpAdapter>		_recv_session;
+
+	std::shared_ptr<DtlsTransport>		_dtls_transport;
 };
@@ -1,6 +1,13 @@
 #include "h264_nal_unit_bitstream_parser.h"
 
+#include <string.h>
+
 H264NalUnitBitstreamParser::H264NalUnitBitstreamParser(const uint8_t *bitstream, size_t length)
+	: reader_(MakeReader(bitstream, length))
+{
+}
+
+BitReader H264NalUnitBitstreamParser::MakeReader(const uint8_t *bitstream, size_t length)
 {
     /*
         Parse the bitstream and skip emulation_prevention_three_byte instances along the way
@@ -17,139 +24,67 @@ H264NalUnitBitstreamParser::H264NalUnitBitstreamParser(const uint8_t *bitstream,
                 rbsp_byte[ NumBytesInRBSP++ ] All b(8)
         }
     */
-    for (size_t original_bitstream_offset = 0; original_bitstream_offset < length;)
+    static constexpr uint8_t emulation_prevention_pattern[] = {0x00, 0x00, 0x03};
+
+    auto first_pattern = static_cast<const uint8_t *>(::memmem(bitstream, length, emulation_prevention_pattern, sizeof(emulation_prevention_pattern)));
+
+    if (first_pattern == nullptr)
     {
-        if (original_bitstream_offset < length + 2 && bitstream[original_bitstream_offset] == 0x00 && bitstream[original_bitstream_offset + 1] == 0x00 && bitstream[original_bitstream_offset + 2] == 0x03)
+        // Most of the NAL units do not have it, so the bitstream is read as it is
+        return BitReader(bitstream, length);
+    }
+
+    rbsp_.reserve(length);
+    rbsp_.assign(bitstream, first_pattern);
+
+    for (size_t original_bitstream_offset = first_pattern - bitstream; original_bitstream_offset < length;)
+    {
+        if ((original_bitstream_offset + 2 < length) && (bitstream[original_bitstream_offset] == 0x00) && (bitstream[original_bitstream_offset + 1] == 0x00) && (bitstream[original_bitstream_offset + 2] == 0x03))
         {
-            bitstream_.emplace_back(bitstream[original_bitstream_offset++]);
-            bitstream_.emplace_back(bitstream[original_bitstream_offset++]);
+            rbsp_.push_back(bitstream[original_bitstream_offset++]);
+            rbsp_.push_back(bitstream[original_bitstream_offset++]);
             original_bitstream_offset++;
         }
         else
         {
-            bitstream_.emplace_back(bitstream[original_bitstream_offset++]);
+            rbsp_.push_back(bitstream[original_bitstream_offset++]);
         }
     }
-    total_bits_ = bitstream_.size() * 8;
+
+    return BitReader(rbsp_.data(), rbsp_.size());
 }
 
 bool H264NalUnitBitstreamParser::ReadBit(uint8_t &value)
 {
-    if (bit_offset_ >= total_bits_)
-    {
-        return false;
-    }
-    value = bitstream_[bit_offset_ / 8] & (0x80 >> (bit_offset_ % 8)) ? 1 : 0;
-    bit_offset_ += 1;
-    return true;
+    return reader_.ReadBit(value);
 }
 
 bool H264NalUnitBitstreamParser::ReadU8(uint8_t &value)
 {
-    if(bit_offset_ + 7 >= total_bits_)
-    {
-        return false;
-    }
-    size_t first_byte = bit_offset_ / 8;
-    unsigned char bits_from_first_byte = 8 - bit_offset_ % 8;
-    value = 0;
-    if (bits_from_first_byte == 8)
-    {
-        value = bitstream_[first_byte];
-    }
-    else
-    {
-        unsigned char bits_from_second_byte = 8 - bits_from_first_byte;
-        unsigned char first_bit_mask = 2 * bits_from_first_byte - 1;
-        value |= (bitstream_[first_byte] & first_bit_mask) << (8 - bits_from_first_byte);
-        value |= (bitstream_[first_byte + 1] & ~first_bit_mask) >> (8 - bits_from_second_byte);
-    }
-    bit_offset_ += 8;
-    return true;
+    return reader_.ReadBits(8, value);
 }
 
 bool H264NalUnitBitstreamParser::ReadU16(uint16_t &value)
 {
-    uint8_t high_byte, low_byte;
-    if (ReadU8(high_byte) && ReadU8(low_byte))
-    {
-        value = static_cast<uint16_t>(high_byte) << 8 | low_byte;
-        return true;
-    }
-    return false;
+    return reader_.ReadBits(16, value);
 }
 
 bool H264NalUnitBitstreamParser::ReadU32(uint32_t &value)
 {
-    uint16_t high_part, low_part;
-    if (ReadU16(high_part) && ReadU16(low_part))
-    {
-        value = static_cast<uint32_t>(high_part) << 16 | low_part;
-        return true;
-    }
-    return false;
+    return reader_.ReadBits(32, value);
 }
 
 bool H264NalUnitBitstreamParser::ReadUEV(uint32_t &value)
 {
-    int zero_bit_count = 0;
-    uint8_t bit;
-    while (true)
-    {
-        if (ReadBit(bit) == false)
-        {
-            return false;
-        }
-        if (bit == 0)
-        {
-            zero_bit_count++;
-        }
-        else
-        {
-            break;
-        }
-    }
-    value = 1;
-    while (zero_bit_count--)
-    {
-        value <<= 1;
-        if (ReadBit(bit) == false)
-        {
-            return false;
-        }
-        if (bit)
-        {
-            value += 1;
-        }
-    }
-    value -= 1;
-    return true;
+    return reader_.ReadUE(value);
 }
 
 bool H264NalUnitBitstreamParser::ReadSEV(int32_t &value)
 {
-    uint32_t uev_value;
-    if (ReadUEV(uev_value) == false)
-    {
-        return false;
-    }
-    if (uev_value % 2 == 0)
-    {
-        uev_value = (uev_value + 1) / 2;
-    }
-    else
-    {
-        uev_value /= -2;
-    }
-    return true;
+    return reader_.ReadSE(value);
 }
 
 bool H264NalUnitBitstreamParser::Skip(uint32_t count)
 {
-    if (bit_offset_ + count >= total_bits_)
-    {
-        return false;
-    }
-    bit_offset_ += count;
-    return true;
-}
\ No newline at end of file
+    return reader_.SkipBits(count);
+}
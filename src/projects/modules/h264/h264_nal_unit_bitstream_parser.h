@@ -3,12 +3,18 @@
 #include <cstdint>
 #include <vector>
 
+#include <base/ovlibrary/bit_reader.h>
+
 // Parses the payload of the NAL unit without the starting byte
 class H264NalUnitBitstreamParser
 {
 public:
 	H264NalUnitBitstreamParser(const uint8_t *bitstream, size_t length);
 
+	// reader_ refers bitstream or rbsp_
+	H264NalUnitBitstreamParser(const H264NalUnitBitstreamParser &) = delete;
+	H264NalUnitBitstreamParser &operator=(const H264NalUnitBitstreamParser &) = delete;
+
 	bool ReadBit(uint8_t &value);
 	bool ReadU8(uint8_t &value);
 	bool ReadU16(uint16_t &value);
@@ -18,7 +24,9 @@ public:
 	bool Skip(uint32_t count);
 
 private:
-	std::vector<uint8_t> bitstream_;
-	size_t total_bits_;
-	size_t bit_offset_ = 0;
-};
\ No newline at end of file
+	// Reads the bitstream without emulation_prevention_three_byte (copied into rbsp_ only if there is one)
+	BitReader MakeReader(const uint8_t *bitstream, size_t length);
+
+	std::vector<uint8_t> rbsp_;
+	BitReader reader_;
+};
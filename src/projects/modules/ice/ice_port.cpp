@@ -15,17 +15,14 @@
 #include <algorithm>
 
 #include <base/ovlibrary/ovlibrary.h>
+#include <base/ovlibrary/byte_io.h>
+#include <base/ovcrypto/ovcrypto.h>
 #include <config/config.h>
 #include <modules/rtc_signalling/rtc_ice_candidate.h>
 
 IcePort::IcePort()
+	: _timer(ICE_PORT_TIMER_TICK_MS)
 {
-	_timer.Push(
-		[this](void *paramter) -> ov::DelayQueueAction {
-			CheckTimedoutItem();
-			return ov::DelayQueueAction::Repeat;
-		},
-		1000);
 	_timer.Start();
 }
 
@@ -36,7 +33,7 @@ IcePort::~IcePort()
 	Close();
 }
 
-bool IcePort::Create(std::vector<RtcIceCandidate> ice_candidate_list)
+bool IcePort::Create(std::vector<RtcIceCandidate> ice_candidate_list, int reactor_count)
 {
 	std::lock_guard<std::recursive_mutex> lock_guard(_physical_port_list_mutex);
 
@@ -77,7 +74,7 @@ bool IcePort::Create(std::vector<RtcIceCandidate> ice_candidate_list)
 		address.SetHostname(nullptr);
 
 		// Create an ICE port using candidate information
-		auto physical_port = CreatePhysicalPort(address, socket_type);
+		auto physical_port = CreatePhysicalPort(address, socket_type, reactor_count);
 
 		if (physical_port == nullptr)
 		{
@@ -107,9 +104,9 @@ const std::vector<RtcIceCandidate> &IcePort::GetIceCandidateList() const
 	return _ice_candidate_list;
 }
 
-std::shared_ptr<PhysicalPort> IcePort::CreatePhysicalPort(const ov::SocketAddress &address, ov::SocketType type)
+std::shared_ptr<PhysicalPort> IcePort::CreatePhysicalPort(const ov::SocketAddress &address, ov::SocketType type, int reactor_count)
 {
-	auto physical_port = PhysicalPortManager::Instance()->CreatePort(type, address);
+	auto physical_port = PhysicalPortManager::Instance()->CreatePort(type, address, reactor_count);
 
 	if (physical_port != nullptr)
 	{
@@ -240,13 +237,19 @@ void IcePort::AddSession(const std::shared_ptr<info::Session> &session_info, std
 		info->session_info = session_info;
 		info->offer_sdp = offer_sdp;
 		info->peer_sdp = peer_sdp;
+		info->offer_integrity.Create(ov::CryptoAlgorithm::Sha1, offer_sdp->GetIcePwd());
+		info->peer_integrity.Create(ov::CryptoAlgorithm::Sha1, peer_sdp->GetIcePwd());
+		info->request_user_name = ov::String::FormatString("%s:%s", local_ufrag.CStr(), remote_ufrag.CStr());
 		info->remote = nullptr;
 		info->address = ov::SocketAddress();
 		info->state = IcePortConnectionState::Closed;
+		info->is_lite = offer_sdp->IsIceLite();
 
 		info->UpdateBindingTime();
 
 		_user_mapping_table[local_ufrag] = info;
+
+		ScheduleExpireTimer(info, ICE_PORT_SESSION_TIMEOUT_MS);
 	}
 
 	SetIceState(_user_mapping_table[local_ufrag], IcePortConnectionState::New);
@@ -256,29 +259,22 @@ bool IcePort::RemoveSession(const session_id_t session_id)
 {
 	std::shared_ptr<IcePortInfo> ice_port_info;
 
+	if (_session_table.Find(session_id, &ice_port_info) == false)
 	{
-		std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
+		logtw("Could not find session: %d", session_id);
 
-		auto item = _session_table.find(session_id);
-
-		if (item == _session_table.end())
-		{
-			logtw("Could not find session: %d", session_id);
-
-			return false;
-		}
-
-		ice_port_info = item->second;
-
-		_session_table.erase(item);
-		_ice_port_info.erase(ice_port_info->address);
+		return false;
 	}
 
+	RemoveFromSessionTable(ice_port_info);
+
 	{
 		std::lock_guard<std::mutex> lock_guard(_user_mapping_table_mutex);
 		_user_mapping_table.erase(ice_port_info->offer_sdp->GetIceUfrag());
 	}
 
+	CancelExpireTimer(ice_port_info);
+
 	return true;
 }
 
@@ -304,21 +300,21 @@ bool IcePort::Send(const std::shared_ptr<info::Session> &session_info, const std
 
 	std::shared_ptr<IcePortInfo> ice_port_info;
 
+	if (_session_table.Find(session_info->GetId(), &ice_port_info) == false)
 	{
-		std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
-
-		auto item = _session_table.find(session_info->GetId());
+		// logtw("ClientSocket not found for session #%d", session_info->GetId());
+		return false;
+	}
 
-		if (item == _session_table.end())
-		{
-			// logtw("ClientSocket not found for session #%d", session_info->GetId());
-			return false;
-		}
+	// logtd("Sending data to remote for session #%d", session_info->GetId());
+	auto batch = ov::DatagramBatch::GetCurrent();
 
-		ice_port_info = item->second;
+	if ((batch != nullptr) && (ice_port_info->remote->GetType() == ov::SocketType::Udp))
+	{
+		// The data will be sent with other datagrams when the batch is flushed
+		return batch->Add(ice_port_info->remote, ice_port_info->address, data);
 	}
 
-	// logtd("Sending data to remote for session #%d", session_info->GetId());
 	return ice_port_info->remote->SendTo(ice_port_info->address, data) >= 0;
 }
 
@@ -327,6 +323,39 @@ void IcePort::OnConnected(const std::shared_ptr<ov::Socket> &remote)
 	// TODO: 일단은 UDP만 처리하므로, 비워둠. 나중에 TCP 지원할 때 구현해야 함
 }
 
+bool IcePort::IsStunPacket(const std::shared_ptr<const ov::Data> &data)
+{
+	if (data->GetLength() == 0)
+	{
+		return false;
+	}
+
+	return data->GetDataAs<uint8_t>()[0] <= 3;
+}
+
+void IcePort::AddToSessionTable(const std::shared_ptr<IcePortInfo> &info)
+{
+	if (_session_table.Insert(info->session_info->GetId(), info))
+	{
+		logtd("Add the client to the port list: %s", info->address.ToString().CStr());
+
+		// The address of the session is not changed after this
+		PrepareBindingResponse(info);
+
+		_ice_port_info.Set({info->remote.get(), info->address}, info);
+	}
+	else
+	{
+		// Updated
+	}
+}
+
+void IcePort::RemoveFromSessionTable(const std::shared_ptr<IcePortInfo> &info)
+{
+	_session_table.Erase(info->session_info->GetId());
+	_ice_port_info.Erase({info->remote.get(), info->address});
+}
+
 void IcePort::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
 {
 	// 데이터를 수신했음
@@ -334,6 +363,18 @@ void IcePort::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov
 	// TODO: 지금은 data 안에 하나의 STUN 메시지만 있을 것으로 간주하고 작성되어 있음
 	// TODO: TCP의 경우, 데이터가 많이 들어올 수 있기 때문에 별도 처리 필요
 
+	if (IsStunPacket(data) == false)
+	{
+		// Fast path: SRTP/SRTCP/DTLS of the established sessions don't need to be parsed as STUN
+		OnApplicationDataReceived(remote, address, data);
+		return;
+	}
+
+	if (ProcessBindingRequestInPlace(remote, address, data))
+	{
+		return;
+	}
+
 	ov::ByteStream stream(data.get());
 	StunMessage message;
 
@@ -383,73 +424,86 @@ void IcePort::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov
 	{
 		logtd("Not Stun packet. Passing data to observer...");
 
-		std::shared_ptr<IcePortInfo> ice_port_info;
+		OnApplicationDataReceived(remote, address, data);
+	}
+}
 
-		{
-			std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
+void IcePort::OnApplicationDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+{
+	std::shared_ptr<IcePortInfo> ice_port_info;
+
+	if (_ice_port_info.Find({remote.get(), address}, &ice_port_info) == false)
+	{
+		// 포트 정보가 없음
+		// 이전 단계에서 관련 정보가 저장되어 있어야 함
+		logtd("Could not find client information. Dropping...");
+		return;
+	}
 
-			auto item = _ice_port_info.find(address);
+	// TODO: 이걸 IcePort에서 할 것이 아니라 PhysicalPort에서 하는 것이 좋아보임
 
-			if (item != _ice_port_info.end())
+	// observer들에게 알림
+	for (auto &observer : _observers)
+	{
+		observer->OnDataReceived(*this, ice_port_info->session_info, data);
+	}
+}
+
+void IcePort::ScheduleExpireTimer(const std::shared_ptr<IcePortInfo> &info, int after_ms)
+{
+	std::weak_ptr<IcePortInfo> weak_info = info;
+
+	info->expire_timer = _timer.Push(
+		[this, weak_info](void *parameter) -> ov::DelayQueueAction {
+			auto info = weak_info.lock();
+
+			if (info != nullptr)
 			{
-				ice_port_info = item->second;
+				CheckExpired(info);
 			}
-		}
 
-		if (ice_port_info == nullptr)
-		{
-			// 포트 정보가 없음
-			// 이전 단계에서 관련 정보가 저장되어 있어야 함
-			logtd("Could not find client information. Dropping...");
-			return;
-		}
+			return ov::DelayQueueAction::Stop;
+		},
+		after_ms);
+}
 
-		// TODO: 이걸 IcePort에서 할 것이 아니라 PhysicalPort에서 하는 것이 좋아보임
+void IcePort::CancelExpireTimer(const std::shared_ptr<IcePortInfo> &info)
+{
+	auto handle = info->expire_timer.exchange(0);
 
-		// observer들에게 알림
-		for (auto &observer : _observers)
-		{
-			logtd("Trying to callback OnDataReceived() to %p...", observer.get());
-			observer->OnDataReceived(*this, ice_port_info->session_info, data);
-			logtd("OnDataReceived() is returned (%p)", observer.get());
-		}
+	if (handle != 0)
+	{
+		_timer.Cancel(handle);
 	}
 }
 
-void IcePort::CheckTimedoutItem()
+void IcePort::CheckExpired(const std::shared_ptr<IcePortInfo> &info)
 {
-	std::vector<std::shared_ptr<IcePortInfo>> delete_list;
-
 	{
 		std::lock_guard<std::mutex> lock_guard(_user_mapping_table_mutex);
 
-		for (auto item = _user_mapping_table.begin(); item != _user_mapping_table.end();)
-		{
-			if (item->second->IsExpired())
-			{
-				logtd("Client %s(session id: %d) is expired", item->second->address.ToString().CStr(), item->second->session_info->GetId());
-				SetIceState(item->second, IcePortConnectionState::Disconnected);
-
-				delete_list.push_back(item->second);
+		auto item = _user_mapping_table.find(info->offer_sdp->GetIceUfrag());
 
-				item = _user_mapping_table.erase(item);
-			}
-			else
-			{
-				++item;
-			}
+		if ((item == _user_mapping_table.end()) || (item->second != info))
+		{
+			// Already removed
+			return;
 		}
-	}
 
-	{
-		std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
-
-		for (auto &deleted_ice_port : delete_list)
+		if (info->IsExpired() == false)
 		{
-			_session_table.erase(deleted_ice_port->session_info->GetId());
-			_ice_port_info.erase(deleted_ice_port->address);
+			// STUN messages were received after the timer was scheduled
+			ScheduleExpireTimer(info, static_cast<int>(std::max(info->GetRemainingTimeMSec(), static_cast<int64_t>(ICE_PORT_TIMER_TICK_MS))));
+			return;
 		}
+
+		logtd("Client %s(session id: %d) is expired", info->address.ToString().CStr(), info->session_info->GetId());
+		SetIceState(item->second, IcePortConnectionState::Disconnected);
+
+		_user_mapping_table.erase(item);
 	}
+
+	RemoveFromSessionTable(info);
 }
 
 bool IcePort::ProcessBindingRequest(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const StunMessage &request_message)
@@ -505,12 +559,8 @@ bool IcePort::ProcessBindingRequest(const std::shared_ptr<ov::Socket> &remote, c
 			_user_mapping_table.erase(local_ufrag);
 		}
 
-		{
-			std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
-
-			_ice_port_info.erase(ice_port_info->address);
-			_session_table.erase(ice_port_info->session_info->GetId());
-		}
+		CancelExpireTimer(ice_port_info);
+		RemoveFromSessionTable(ice_port_info);
 
 		return false;
 	}
@@ -524,8 +574,31 @@ bool IcePort::ProcessBindingRequest(const std::shared_ptr<ov::Socket> &remote, c
 		ice_port_info->remote = remote;
 		ice_port_info->address = address;
 	}
+	else if (ice_port_info->is_lite &&
+			 (request_message.GetUnknownAttribute(OV_STUN_ATTRIBUTE_USE_CANDIDATE) != nullptr) &&
+			 ((ice_port_info->remote != remote) || ((ice_port_info->address == address) == false)))
+	{
+		// The controlling peer nominated another pair than the first valid one
+		logtd("Session %d is moved to the nominated pair: %s -> %s", ice_port_info->session_info->GetId(), ice_port_info->address.ToString().CStr(), address.ToString().CStr());
+
+		RemoveFromSessionTable(ice_port_info);
+		ice_port_info->remote = remote;
+		ice_port_info->address = address;
+	}
+
+	if (SendBindingResponse(remote, address, request_message, ice_port_info) == false)
+	{
+		return false;
+	}
 
-	return SendBindingResponse(remote, address, request_message, ice_port_info);
+	if (ice_port_info->is_lite && (ice_port_info->state != IcePortConnectionState::Connected))
+	{
+		// ICE-lite (RFC 8445 2.5): the pair is valid once the request of the peer is authenticated and answered,
+		// so the session is connected by the first request and the DTLS handshake of the peer is accepted at once
+		SetIceState(ice_port_info, IcePortConnectionState::Connected);
+	}
+
+	return true;
 }
 
 bool IcePort::SendBindingResponse(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const StunMessage &request_message, const std::shared_ptr<IcePortInfo> &info)
@@ -546,35 +619,21 @@ bool IcePort::SendBindingResponse(const std::shared_ptr<ov::Socket> &remote, con
 	mapped_attribute->SetParameters(address);
 	response_message.AddAttribute(std::move(attribute));
 
-	// Integrity 계산을 위한 password 생성
-	ov::String key = info->offer_sdp->GetIcePwd();
-
 	// Integrity & Fingerprint attribute는 Serialize()할 때 자동 생성됨
-	std::shared_ptr<ov::Data> serialized = response_message.Serialize(key);
+	std::shared_ptr<ov::Data> serialized = response_message.Serialize(info->offer_integrity);
 
 	logtd("Trying to send STUN binding response to %s\n%s\n%s", address.ToString().CStr(), response_message.ToString().CStr(), serialized->Dump().CStr());
 
 	remote->SendTo(address, serialized);
 
 	// client mapping 정보를 저장해놓음
-	{
-		std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
+	AddToSessionTable(info);
 
-		if (_session_table.find(info->session_info->GetId()) == _session_table.end())
-		{
-			logtd("Add the client to the port list: %s", address.ToString().CStr());
-
-			_ice_port_info[address] = info;
-			_session_table[info->session_info->GetId()] = info;
-		}
-		else
-		{
-			// Updated
-		}
+	if (info->is_lite == false)
+	{
+		SendBindingRequest(remote, address, info);
 	}
 
-	SendBindingRequest(remote, address, info);
-
 	return true;
 }
 
@@ -585,16 +644,9 @@ bool IcePort::SendBindingRequest(const std::shared_ptr<ov::Socket> &remote, cons
 
 	request_message.SetClass(StunClass::Request);
 	request_message.SetMethod(StunMethod::Binding);
-	// logtw("TEST PURPOSE TRANSACTION_ID");
-	// TODO: transaction_id가 겹치지 않게 처리 해야 함
+	// RFC 5389 - 6. The transaction ID is a 96-bit identifier, "uniformly and randomly chosen from the interval 0 .. 2**96-1"
 	uint8_t transaction_id[OV_STUN_TRANSACTION_ID_LENGTH];
-	uint8_t charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-
-	// random 한 transaction id 생성
-	for (int index = 0; index < OV_STUN_TRANSACTION_ID_LENGTH; index++)
-	{
-		transaction_id[index] = charset[rand() % OV_COUNTOF(charset)];
-	}
+	ov::Random::Fill(transaction_id, sizeof(transaction_id));
 	request_message.SetTransactionId(&(transaction_id[0]));
 
 	std::unique_ptr<StunAttribute> attribute;
@@ -634,11 +686,8 @@ bool IcePort::SendBindingRequest(const std::shared_ptr<ov::Socket> &remote, cons
 	unknown_attribute->SetData(&(unknown_data3[0]), 4);
 	request_message.AddAttribute(std::move(attribute));
 
-	// Integrity 계산을 위한 password 생성
-	ov::String key = info->peer_sdp->GetIcePwd();
-
 	// Integrity & Fingerprint attribute는 Serialize()할 때 자동 생성됨
-	std::shared_ptr<ov::Data> serialized = request_message.Serialize(key);
+	std::shared_ptr<ov::Data> serialized = request_message.Serialize(info->peer_integrity);
 
 	logtd("Trying to send STUN binding request to %s\n%s\n%s", address.ToString().CStr(), request_message.ToString().CStr(), serialized->Dump().CStr());
 
@@ -647,28 +696,198 @@ bool IcePort::SendBindingRequest(const std::shared_ptr<ov::Socket> &remote, cons
 	return true;
 }
 
-bool IcePort::ProcessBindingResponse(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const StunMessage &response_message)
+void IcePort::PrepareBindingResponse(const std::shared_ptr<IcePortInfo> &info)
 {
-	// TODO: state가 checking 상태인지 확인
+	auto buffer = info->binding_response;
+	const uint8_t *address = nullptr;
+	size_t address_length = 0;
+	StunAddressFamily family;
 
-	std::shared_ptr<IcePortInfo> ice_port_info;
+	switch (info->address.GetFamily())
+	{
+		case ov::SocketFamily::Inet:
+			address = reinterpret_cast<const uint8_t *>(info->address.AddrInForIPv4());
+			address_length = 4;
+			family = StunAddressFamily::IPv4;
+			break;
+
+		case ov::SocketFamily::Inet6:
+			address = reinterpret_cast<const uint8_t *>(info->address.AddrInForIPv6());
+			address_length = 16;
+			family = StunAddressFamily::IPv6;
+			break;
 
+		default:
+			// Always processed by ProcessBindingRequest()
+			info->binding_response_length = 0;
+			return;
+	}
+
+	size_t length = OV_STUN_HEADER_LENGTH + (4 + 4 + address_length) + (4 + OV_STUN_HASH_LENGTH) + (4 + 4);
+
+	// Header (Binding Success Response)
+	ByteWriter<uint16_t>::WriteBigEndian(&buffer[0], 0x0101);
+	ByteWriter<uint16_t>::WriteBigEndian(&buffer[2], static_cast<uint16_t>(length - OV_STUN_HEADER_LENGTH));
+	ByteWriter<uint32_t>::WriteBigEndian(&buffer[4], OV_STUN_MAGIC_COOKIE);
+	::memset(&buffer[8], 0, OV_STUN_TRANSACTION_ID_LENGTH);
+
+	// XOR-MAPPED-ADDRESS (RFC 5389 - 15.2)
+	auto attribute = &buffer[OV_STUN_HEADER_LENGTH];
+	uint8_t magic_cookie[4];
+	ByteWriter<uint32_t>::WriteBigEndian(magic_cookie, OV_STUN_MAGIC_COOKIE);
+
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[0], static_cast<uint16_t>(StunAttributeType::XorMappedAddress));
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[2], static_cast<uint16_t>(4 + address_length));
+	attribute[4] = 0x00;
+	attribute[5] = static_cast<uint8_t>(family);
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[6], static_cast<uint16_t>(info->address.Port() ^ (OV_STUN_MAGIC_COOKIE >> 16)));
+
+	// The rest of IPv6 address is XORed with the transaction ID of each request
+	for (size_t index = 0; index < address_length; index++)
 	{
-		std::lock_guard<std::mutex> lock_guard(_ice_port_info_mutex);
+		attribute[8 + index] = (index < 4) ? (address[index] ^ magic_cookie[index]) : address[index];
+	}
 
-		auto item = _ice_port_info.find(address);
+	// MESSAGE-INTEGRITY
+	attribute += 4 + 4 + address_length;
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[0], static_cast<uint16_t>(StunAttributeType::MessageIntegrity));
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[2], OV_STUN_HASH_LENGTH);
 
-		if (item == _ice_port_info.end())
-		{
-			// 포트 정보가 없음
-			// 이전 단계에서 관련 정보가 저장되어 있어야 함
+	// FINGERPRINT
+	attribute += 4 + OV_STUN_HASH_LENGTH;
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[0], static_cast<uint16_t>(StunAttributeType::Fingerprint));
+	ByteWriter<uint16_t>::WriteBigEndian(&attribute[2], 4);
+
+	info->binding_response_length = length;
+}
+
+bool IcePort::ProcessBindingRequestInPlace(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+{
+	auto request = data->GetDataAs<uint8_t>();
+	auto request_length = data->GetLength();
+
+	if ((request_length < OV_STUN_HEADER_LENGTH) || (request_length > ICE_PORT_BINDING_REQUEST_MAX_LENGTH) ||
+		(ByteReader<uint16_t>::ReadBigEndian(&request[0]) != static_cast<uint16_t>(StunMethod::Binding)) ||
+		(ByteReader<uint32_t>::ReadBigEndian(&request[4]) != OV_STUN_MAGIC_COOKIE) ||
+		(static_cast<size_t>(ByteReader<uint16_t>::ReadBigEndian(&request[2]) + OV_STUN_HEADER_LENGTH) != request_length))
+	{
+		// Not a binding request
+		return false;
+	}
+
+	std::shared_ptr<IcePortInfo> info;
+
+	if ((_ice_port_info.Find({remote.get(), address}, &info) == false) ||
+		(info->state != IcePortConnectionState::Connected) ||
+		(info->binding_response_length == 0))
+	{
+		// The requests during the negotiation are processed by ProcessBindingRequest()
+		return false;
+	}
+
+	// Finds USERNAME and MESSAGE-INTEGRITY (the attributes after MESSAGE-INTEGRITY are ignored)
+	bool is_user_name_matched = false;
+	size_t integrity_offset = 0;
+	size_t offset = OV_STUN_HEADER_LENGTH;
+
+	while ((offset + 4) <= request_length)
+	{
+		auto type = static_cast<StunAttributeType>(ByteReader<uint16_t>::ReadBigEndian(&request[offset]));
+		size_t length = ByteReader<uint16_t>::ReadBigEndian(&request[offset + 2]);
 
-			// 같은 ufrag에 대해 서로 다른 ICE candidate로 부터 동시에 접속 요청이 왔다면, 첫 번째로 도착한 ICE candidate가 저장됨
-			// 따라서 두 번째 address는 처리하지 않으므로, 없다고 간주
+		if ((offset + 4 + length) > request_length)
+		{
 			return false;
 		}
 
-		ice_port_info = item->second;
+		if (type == StunAttributeType::UserName)
+		{
+			is_user_name_matched = (length == info->request_user_name.GetLength()) &&
+								   (::memcmp(&request[offset + 4], info->request_user_name.CStr(), length) == 0);
+		}
+		else if (type == StunAttributeType::MessageIntegrity)
+		{
+			if (length != OV_STUN_HASH_LENGTH)
+			{
+				return false;
+			}
+
+			integrity_offset = offset;
+			break;
+		}
+
+		// Padded to 4 bytes
+		offset += 4 + ((length + 3) & ~static_cast<size_t>(3));
+	}
+
+	if ((is_user_name_matched == false) || (integrity_offset == 0))
+	{
+		return false;
+	}
+
+	// RFC5389 - 15.4. The length in the header includes MESSAGE-INTEGRITY when the HMAC is computed
+	uint8_t message[ICE_PORT_BINDING_REQUEST_MAX_LENGTH];
+	uint8_t hash[OV_STUN_HASH_LENGTH];
+
+	::memcpy(message, request, integrity_offset);
+	ByteWriter<uint16_t>::WriteBigEndian(&message[2], static_cast<uint16_t>(integrity_offset + 4 + OV_STUN_HASH_LENGTH - OV_STUN_HEADER_LENGTH));
+
+	if ((info->offer_integrity.Compute(message, integrity_offset, hash, OV_STUN_HASH_LENGTH) == false) ||
+		(::memcmp(hash, &request[integrity_offset + 4], OV_STUN_HASH_LENGTH) != 0))
+	{
+		return false;
+	}
+
+	info->UpdateBindingTime();
+
+	// Fills the prepared response
+	uint8_t response[ICE_PORT_BINDING_RESPONSE_MAX_LENGTH];
+	auto response_length = info->binding_response_length;
+
+	::memcpy(response, info->binding_response, response_length);
+	::memcpy(&response[8], &request[8], OV_STUN_TRANSACTION_ID_LENGTH);
+
+	if (info->address.GetFamily() == ov::SocketFamily::Inet6)
+	{
+		// The last 12 bytes of IPv6 address are XORed with the transaction ID
+		for (size_t index = 0; index < OV_STUN_TRANSACTION_ID_LENGTH; index++)
+		{
+			response[OV_STUN_HEADER_LENGTH + 8 + 4 + index] ^= request[8 + index];
+		}
+	}
+
+	size_t fingerprint_offset = response_length - (4 + 4);
+	size_t response_integrity_offset = fingerprint_offset - (4 + OV_STUN_HASH_LENGTH);
+
+	ByteWriter<uint16_t>::WriteBigEndian(&response[2], static_cast<uint16_t>(fingerprint_offset - OV_STUN_HEADER_LENGTH));
+
+	if (info->offer_integrity.Compute(response, response_integrity_offset, &response[response_integrity_offset + 4], OV_STUN_HASH_LENGTH) == false)
+	{
+		return false;
+	}
+
+	ByteWriter<uint16_t>::WriteBigEndian(&response[2], static_cast<uint16_t>(response_length - OV_STUN_HEADER_LENGTH));
+	ByteWriter<uint32_t>::WriteBigEndian(&response[fingerprint_offset + 4], ov::Crc32::Calculate(response, fingerprint_offset) ^ OV_STUN_FINGERPRINT_XOR_VALUE);
+
+	remote->SendTo(address, response, response_length);
+
+	return true;
+}
+
+bool IcePort::ProcessBindingResponse(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const StunMessage &response_message)
+{
+	// TODO: state가 checking 상태인지 확인
+
+	std::shared_ptr<IcePortInfo> ice_port_info;
+
+	if (_ice_port_info.Find({remote.get(), address}, &ice_port_info) == false)
+	{
+		// 포트 정보가 없음
+		// 이전 단계에서 관련 정보가 저장되어 있어야 함
+
+		// 같은 ufrag에 대해 서로 다른 ICE candidate로 부터 동시에 접속 요청이 왔다면, 첫 번째로 도착한 ICE candidate가 저장됨
+		// 따라서 두 번째 address는 처리하지 않으므로, 없다고 간주
+		return false;
 	}
 
 	// SDP의 password로 무결성 검사를 한 뒤
@@ -11,6 +11,7 @@
 #include "ice_port_observer.h"
 #include "modules/ice/stun/stun_message.h"
 
+#include <atomic>
 #include <vector>
 #include <memory>
 
@@ -21,10 +22,42 @@
 
 class RtcIceCandidate;
 
+// The number of the shards of the session tables (the lookups of the different shards don't contend)
+// The session is removed if there is no STUN message during this time
+#define ICE_PORT_SESSION_TIMEOUT_MS (30 * 1000)
+// Resolution of the expire timers
+#define ICE_PORT_TIMER_TICK_MS 100
+// Header (20B) + XOR-MAPPED-ADDRESS of IPv6 (24B) + MESSAGE-INTEGRITY (24B) + FINGERPRINT (8B)
+#define ICE_PORT_BINDING_RESPONSE_MAX_LENGTH 76
+// The binding requests longer than this are not answered in place (they are parsed by StunMessage)
+#define ICE_PORT_BINDING_REQUEST_MAX_LENGTH 548
+
+#define ICE_PORT_TABLE_SHARD_COUNT 32
+
 class IcePort : protected PhysicalPortObserver
 {
 protected:
 	// A data structure to tracking client connection status
+	// The local socket and the remote address identify the 5-tuple of the client
+	struct IcePortTupleKey
+	{
+		const ov::Socket *socket = nullptr;
+		ov::SocketAddress address;
+
+		bool operator==(const IcePortTupleKey &key) const
+		{
+			return (socket == key.socket) && (address == key.address);
+		}
+	};
+
+	struct IcePortTupleKeyHash
+	{
+		size_t operator()(const IcePortTupleKey &key) const noexcept
+		{
+			return std::hash<const ov::Socket *>()(key.socket) ^ (key.address.GetHash() * 31);
+		}
+	};
+
 	struct IcePortInfo
 	{
 		// Session information that connected with the client
@@ -33,21 +66,45 @@ protected:
 		std::shared_ptr<SessionDescription> offer_sdp;
 		std::shared_ptr<SessionDescription> peer_sdp;
 
+		// MESSAGE-INTEGRITY keys (the ICE passwords of offer_sdp/peer_sdp), prepared once for the session
+		ov::Hmac offer_integrity;
+		ov::Hmac peer_integrity;
+
+		// USERNAME of the binding requests from the peer ("<offer ufrag>:<peer ufrag>")
+		ov::String request_user_name;
+		// The binding success response to the address, prepared once it is added to the session table.
+		// Only the transaction ID, MESSAGE-INTEGRITY and FINGERPRINT are filled for each request (See ProcessBindingRequestInPlace())
+		uint8_t binding_response[ICE_PORT_BINDING_RESPONSE_MAX_LENGTH];
+		size_t binding_response_length = 0;
+
 		std::shared_ptr<ov::Socket> remote;
 		ov::SocketAddress address;
 
-		IcePortConnectionState state;
+		// The local SDP has a=ice-lite: OME doesn't send the checks, and the first valid pair is used at once
+		bool is_lite = false;
+
+		std::atomic<IcePortConnectionState> state;
+
+		// Monotonic time in milliseconds (updated for every binding request, so the cached time of the event loop is used)
+		std::atomic<int64_t> expire_time_ms{0};
 
-		std::chrono::time_point<std::chrono::system_clock> expire_time;
+		// Timer that removes the session when it is expired (it is not re-armed for every STUN message,
+		// but checks the expire_time when it fires)
+		std::atomic<ov::TimerHandle> expire_timer{0};
 
 		void UpdateBindingTime()
 		{
-			expire_time = std::chrono::system_clock::now() + std::chrono::milliseconds(30 * 1000);
+			expire_time_ms = ov::Clock::CachedNowMs() + ICE_PORT_SESSION_TIMEOUT_MS;
 		}
 
 		bool IsExpired() const
 		{
-			return (std::chrono::system_clock::now() > expire_time);
+			return (ov::Clock::CachedNowMs() > expire_time_ms);
+		}
+
+		int64_t GetRemainingTimeMSec() const
+		{
+			return expire_time_ms - ov::Clock::CachedNowMs();
 		}
 	};
 
@@ -55,7 +112,7 @@ public:
 	IcePort();
 	~IcePort() override;
 
-	bool Create(std::vector<RtcIceCandidate> ice_candidate_list);
+	bool Create(std::vector<RtcIceCandidate> ice_candidate_list, int reactor_count = 1);
 
 	const std::vector<RtcIceCandidate> &GetIceCandidateList() const;
 
@@ -65,15 +122,15 @@ public:
 	{
 		OV_ASSERT2(session_info != nullptr);
 
-		auto item = _session_table.find(session_info->GetId());
+		std::shared_ptr<IcePortInfo> ice_port_info;
 
-		if(item == _session_table.end())
+		if(_session_table.Find(session_info->GetId(), &ice_port_info) == false)
 		{
 			OV_ASSERT(false, "Invalid session_id: %d", session_info->GetId());
 			return IcePortConnectionState::Failed;
 		}
 
-		return item->second->state;
+		return ice_port_info->state;
 	}
 
 	ov::String GenerateUfrag();
@@ -98,7 +155,7 @@ public:
 	ov::String ToString() const;
 
 protected:
-	std::shared_ptr<PhysicalPort> CreatePhysicalPort(const ov::SocketAddress &address, ov::SocketType type);
+	std::shared_ptr<PhysicalPort> CreatePhysicalPort(const ov::SocketAddress &address, ov::SocketType type, int reactor_count);
 	bool ParseIceCandidate(const ov::String &ice_candidate, std::vector<ov::String> *ip_list, ov::SocketType *socket_type, int *start_port, int *end_port);
 
 	//--------------------------------------------------------------------
@@ -114,7 +171,18 @@ protected:
 	void ResponseError(const std::shared_ptr<ov::Socket> &remote);
 
 private:
-	void CheckTimedoutItem();
+	void ScheduleExpireTimer(const std::shared_ptr<IcePortInfo> &info, int after_ms);
+	void CancelExpireTimer(const std::shared_ptr<IcePortInfo> &info);
+	void CheckExpired(const std::shared_ptr<IcePortInfo> &info);
+
+	// RFC 7983: the first byte of STUN is 0~3 (DTLS: 20~63, RTP/RTCP: 128~191)
+	static bool IsStunPacket(const std::shared_ptr<const ov::Data> &data);
+	// Passes SRTP/DTLS packets of the established session to the observers
+	void OnApplicationDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data);
+
+	// Adds/removes the session to/from the tables of the established sessions
+	void AddToSessionTable(const std::shared_ptr<IcePortInfo> &info);
+	void RemoveFromSessionTable(const std::shared_ptr<IcePortInfo> &info);
 
 	// STUN negotiation order:
 	// (State: New)
@@ -129,6 +197,12 @@ private:
 	bool SendBindingRequest(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<IcePortInfo> &info);
 	bool ProcessBindingResponse(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const StunMessage &response_message);
 
+	// The consent/keepalive binding requests of the connected sessions are validated and answered in place,
+	// without parsing them into StunMessage (no allocation).
+	// Returns false if the request must be processed by ProcessBindingRequest().
+	bool ProcessBindingRequestInPlace(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data);
+	void PrepareBindingResponse(const std::shared_ptr<IcePortInfo> &info);
+
 	std::vector<std::shared_ptr<PhysicalPort>> _physical_port_list;
 	std::recursive_mutex _physical_port_list_mutex;
 
@@ -145,15 +219,16 @@ private:
 	std::mutex _user_mapping_table_mutex;
 
 	// STUN nego가 완료되면 생성되는 mapping table
+	// These are looked up for every incoming/outgoing datagram, so they are hashed and lock-sharded
 
-	// 상대방의 ip:port로 IcePortInfo를 바로 찾을 수 있게 함
-	// key: SocketAddress
+	// 상대방의 5-tuple로 IcePortInfo를 바로 찾을 수 있게 함
+	// key: local socket + remote SocketAddress
 	// value: IcePortInfo
-	std::mutex _ice_port_info_mutex;
-	std::map<ov::SocketAddress, std::shared_ptr<IcePortInfo>> _ice_port_info;
+	ov::ShardedHashMap<IcePortTupleKey, std::shared_ptr<IcePortInfo>, IcePortTupleKeyHash, ICE_PORT_TABLE_SHARD_COUNT> _ice_port_info;
 	// session_id로 IcePortInfo를 바로 찾을 수 있게 함
-	std::map<session_id_t, std::shared_ptr<IcePortInfo>> _session_table;
+	ov::ShardedHashMap<session_id_t, std::shared_ptr<IcePortInfo>, std::hash<session_id_t>, ICE_PORT_TABLE_SHARD_COUNT> _session_table;
 
 	// 마지막으로 STUN 메시지가 온 시점을 기억함
-	ov::DelayQueue _timer;
+	// Each session has its own expire timer, so there is no periodic scan of the whole table
+	ov::TimerWheel _timer;
 };
@@ -30,7 +30,7 @@ std::shared_ptr<IcePort> IcePortManager::CreatePort(const cfg::IceCandidates &ic
 			return nullptr;
 		}
 
-		if(ice_port->Create(std::move(ice_candidate_list)) == false)
+		if(ice_port->Create(std::move(ice_candidate_list), ice_candidates.GetReactorCount()) == false)
 		{
 			// 초기화 도중 오류 발생
 			ice_port->Close();
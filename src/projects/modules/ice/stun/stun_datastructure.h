@@ -78,8 +78,12 @@ enum class StunErrorCode
 
 // TODO: legacy 버전(RFC3489)에서는 길이가 다름. RFC3489는 나중에 추가할 것
 #define OV_STUN_TRANSACTION_ID_LENGTH                           12
+// Type (2B) + Length (2B) + Magic cookie (4B) + Transaction ID (12B)
+#define OV_STUN_HEADER_LENGTH                                   20
 
 #define OV_STUN_FINGERPRINT_XOR_VALUE                           0x5354554E
 #define OV_STUN_MAGIC_COOKIE                                    0x2112A442
 // SHA1 digest 크기와 동일
 #define OV_STUN_HASH_LENGTH                                     20
+// RFC 8445 - 16.1. USE-CANDIDATE (parsed as an unknown attribute)
+#define OV_STUN_ATTRIBUTE_USE_CANDIDATE                         0x0025
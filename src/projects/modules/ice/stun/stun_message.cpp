@@ -96,9 +96,10 @@ bool StunMessage::ParseHeader(ov::ByteStream &stream)
 	//
 	// Figure 2: Format of STUN Message Header
 
-	// The incoming data is in big endian, so we can not use memcpy(), and we have to assign them one by one
+	uint16_t type;
 
-	uint16_t type = stream.ReadBE16();
+	// The length is checked above
+	stream.ReadBE(type, _message_length, _magic_cookie);
 
 	// Validate MSB
 	if((type & 0xC000) != 0)
@@ -111,11 +112,6 @@ bool StunMessage::ParseHeader(ov::ByteStream &stream)
 
 	SetType(type);
 
-	// Message Length
-	_message_length = stream.ReadBE16();
-	// Magic Cookie
-	_magic_cookie = stream.ReadBE32();
-
 	if(_magic_cookie != OV_STUN_MAGIC_COOKIE)
 	{
 		// According to RFC5389, magic cookie values are always fixed
@@ -285,7 +281,7 @@ bool StunMessage::WriteAttributes(ov::ByteStream &stream)
 	return true;
 }
 
-bool StunMessage::WriteMessageIntegrityAttribute(ov::ByteStream &stream, const ov::String &integrity_key)
+bool StunMessage::WriteMessageIntegrityAttribute(ov::ByteStream &stream, const ov::Hmac &integrity)
 {
 	logtd("Trying to write message integrity attribute...");
 
@@ -313,12 +309,10 @@ bool StunMessage::WriteMessageIntegrityAttribute(ov::ByteStream &stream, const o
 
 	bool result = true;
 
-	logtd("Computing hmac: key: %s (current message length: %d)\n%s", integrity_key.CStr(), _message_length, stream.GetData()->Dump().CStr());
+	logtd("Computing hmac: (current message length: %d)\n%s", _message_length, stream.GetData()->Dump().CStr());
 
-	result = result && ov::MessageDigest::ComputeHmac(ov::CryptoAlgorithm::Sha1,
-	                                                  integrity_key.CStr(), integrity_key.GetLength(),
-	                                                  stream.GetData()->GetData(), stream.GetData()->GetLength(),
-	                                                  hash, OV_STUN_HASH_LENGTH);
+	result = result && integrity.Compute(stream.GetData()->GetData(), stream.GetData()->GetLength(),
+										 hash, OV_STUN_HASH_LENGTH);
 	result = result && attribute->SetHash(hash);
 	result = result && attribute->Serialize(stream);
 
@@ -656,6 +650,18 @@ bool StunMessage::AddAttribute(std::unique_ptr<StunAttribute> attribute)
 }
 
 std::shared_ptr<ov::Data> StunMessage::Serialize(const ov::String &integrity_key)
+{
+	ov::Hmac integrity;
+
+	if (integrity.Create(ov::CryptoAlgorithm::Sha1, integrity_key) == false)
+	{
+		return nullptr;
+	}
+
+	return Serialize(integrity);
+}
+
+std::shared_ptr<ov::Data> StunMessage::Serialize(const ov::Hmac &integrity)
 {
 	std::shared_ptr<ov::Data> data = std::make_shared<ov::Data>();
 	ov::ByteStream stream(data.get());
@@ -669,7 +675,7 @@ std::shared_ptr<ov::Data> StunMessage::Serialize(const ov::String &integrity_key
 	result = result && WriteAttributes(stream);
 
 	// Integrity attribute 기록
-	result = result && WriteMessageIntegrityAttribute(stream, integrity_key);
+	result = result && WriteMessageIntegrityAttribute(stream, integrity);
 
 	// Fingerprint attribute 기록
 	result = result && WriteFingerprintAttribute(stream);
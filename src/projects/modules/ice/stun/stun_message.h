@@ -12,6 +12,7 @@
 
 #include <algorithm>
 
+#include <base/ovcrypto/message_digest.h>
 #include <base/ovlibrary/ovlibrary.h>
 #include <base/ovsocket/ovsocket.h>
 
@@ -82,9 +83,25 @@ public:
 		return nullptr;
 	}
 
+	// The attributes that are not parsed (StunAttributeType::UnknownAttributes) are found by the type number
+	const StunAttribute *GetUnknownAttribute(uint16_t type_number) const
+	{
+		for(const auto &attribute : _attributes)
+		{
+			if((attribute->GetType() == StunAttributeType::UnknownAttributes) && (attribute->GetTypeNumber() == type_number))
+			{
+				return attribute.get();
+			}
+		}
+
+		return nullptr;
+	}
+
 	bool AddAttribute(std::unique_ptr<StunAttribute> attribute);
 
 	std::shared_ptr<ov::Data> Serialize(const ov::String &integrity_key);
+	// integrity: HMAC-SHA1 that is created with the key (to reuse it for the messages of a session)
+	std::shared_ptr<ov::Data> Serialize(const ov::Hmac &integrity);
 
 protected:
 	bool ParseHeader(ov::ByteStream &stream);
@@ -95,7 +112,7 @@ protected:
 	bool WriteHeader(ov::ByteStream &stream);
 	bool WriteMessageLength(ov::ByteStream &stream);
 	bool WriteAttributes(ov::ByteStream &stream);
-	bool WriteMessageIntegrityAttribute(ov::ByteStream &stream, const ov::String &integrity_key);
+	bool WriteMessageIntegrityAttribute(ov::ByteStream &stream, const ov::Hmac &integrity);
 	bool WriteFingerprintAttribute(ov::ByteStream &stream);
 
 	// stun 정보
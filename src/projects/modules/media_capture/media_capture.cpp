@@ -0,0 +1,393 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "media_capture.h"
+
+#include <base/info/application.h>
+#include <base/ovlibrary/byte_io.h>
+#include <fnmatch.h>
+#include <modules/ovt_packetizer/ovt_control_message.h>
+#include <modules/ovt_packetizer/ovt_packet.h>
+
+#include <cstring>
+#include <ctime>
+
+#define OV_LOG_TAG "MediaCapture"
+
+// Type (1) + Time (8) + Length (4)
+#define MEDIA_CAPTURE_RECORD_HEADER_SIZE 13
+
+static const uint8_t MEDIA_CAPTURE_MAGIC[8] = {'O', 'M', 'E', 'C', 'A', 'P', 0x00, 0x01};
+
+//====================================================================================================
+// MediaCaptureWriter
+//====================================================================================================
+std::shared_ptr<MediaCaptureWriter> MediaCaptureWriter::Create(const ov::String &file_path, const std::shared_ptr<info::Stream> &stream)
+{
+	auto writer = std::shared_ptr<MediaCaptureWriter>(new MediaCaptureWriter());
+
+	writer->_file = ::fopen(file_path.CStr(), "wb");
+
+	if (writer->_file == nullptr)
+	{
+		logte("Could not create the capture file: %s (%s)", file_path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	writer->_buffer = std::make_unique<char[]>(MEDIA_CAPTURE_WRITE_BUFFER_SIZE);
+	::setvbuf(writer->_file, writer->_buffer.get(), _IOFBF, MEDIA_CAPTURE_WRITE_BUFFER_SIZE);
+
+	if (::fwrite(MEDIA_CAPTURE_MAGIC, sizeof(MEDIA_CAPTURE_MAGIC), 1, writer->_file) != 1)
+	{
+		logte("Could not write the capture file: %s", file_path.CStr());
+		return nullptr;
+	}
+
+	writer->_file_path = file_path;
+	writer->_stream = stream;
+	writer->_start_time = std::chrono::steady_clock::now();
+
+	return writer;
+}
+
+MediaCaptureWriter::~MediaCaptureWriter()
+{
+	Close();
+}
+
+bool MediaCaptureWriter::WriteRecord(MediaCaptureRecordType type, const void *header, size_t header_length, const std::shared_ptr<const ov::Data> &data)
+{
+	auto time_usec = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start_time).count();
+	auto length = header_length + ((data != nullptr) ? data->GetLength() : 0);
+
+	uint8_t record_header[MEDIA_CAPTURE_RECORD_HEADER_SIZE];
+
+	ByteWriter<uint8_t>::WriteBigEndian(&record_header[0], static_cast<uint8_t>(type));
+	ByteWriter<uint64_t>::WriteBigEndian(&record_header[1], static_cast<uint64_t>(time_usec));
+	ByteWriter<uint32_t>::WriteBigEndian(&record_header[9], static_cast<uint32_t>(length));
+
+	bool result = (::fwrite(record_header, sizeof(record_header), 1, _file) == 1);
+
+	if (result && (header_length > 0))
+	{
+		result = (::fwrite(header, header_length, 1, _file) == 1);
+	}
+
+	if (result && (data != nullptr) && (data->GetLength() > 0))
+	{
+		result = (::fwrite(data->GetData(), data->GetLength(), 1, _file) == 1);
+	}
+
+	if (result)
+	{
+		_written_bytes += sizeof(record_header) + length;
+	}
+
+	return result;
+}
+
+bool MediaCaptureWriter::Write(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	if (_file == nullptr)
+	{
+		return false;
+	}
+
+	bool result = true;
+
+	if (_is_stream_written == false)
+	{
+		auto description = OvtControlMessage::SerializeStreamDescription(OvtControlMessage::Format::Binary, _stream->GetApplicationInfo().GetName(), _stream->GetName(), _stream->GetTracks());
+		auto response = OvtControlMessage::SerializeResponse(OvtControlMessage::Format::Binary, 0, 200, "OK", description);
+
+		result = (response != nullptr) && WriteRecord(MediaCaptureRecordType::Stream, nullptr, 0, response);
+		_is_stream_written = true;
+	}
+
+	if (result)
+	{
+		// The same as OvtPacketizer::Packetize()
+		auto data = std::static_pointer_cast<const MediaPacket>(media_packet)->GetData();
+		uint8_t header[MEDIA_PACKET_HEADER_SIZE];
+
+		ByteWriter<uint32_t>::WriteBigEndian(&header[0], media_packet->GetTrackId());
+		ByteWriter<uint64_t>::WriteBigEndian(&header[4], media_packet->GetPts());
+		ByteWriter<uint64_t>::WriteBigEndian(&header[12], media_packet->GetDts());
+		ByteWriter<uint64_t>::WriteBigEndian(&header[20], media_packet->GetDuration());
+		ByteWriter<uint8_t>::WriteBigEndian(&header[28], static_cast<int8_t>(media_packet->GetMediaType()));
+		ByteWriter<uint8_t>::WriteBigEndian(&header[29], static_cast<int8_t>(media_packet->GetFlag()));
+		ByteWriter<uint32_t>::WriteBigEndian(&header[30], data->GetLength());
+
+		result = WriteRecord(MediaCaptureRecordType::MediaPacket, header, sizeof(header), data);
+	}
+
+	if (result == false)
+	{
+		// The file would be broken from here, so the capture is stopped
+		logte("Could not write the capture file, the capture is stopped: %s (%s)", _file_path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+
+		::fclose(_file);
+		_file = nullptr;
+
+		return false;
+	}
+
+	_packet_count++;
+
+	return true;
+}
+
+void MediaCaptureWriter::Close()
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	if (_file == nullptr)
+	{
+		return;
+	}
+
+	::fclose(_file);
+	_file = nullptr;
+
+	logti("The capture of %s/%s is finished: %s (%llu packets, %llu bytes)",
+		  _stream->GetApplicationInfo().GetName().CStr(), _stream->GetName().CStr(), _file_path.CStr(),
+		  static_cast<unsigned long long>(_packet_count), static_cast<unsigned long long>(_written_bytes));
+}
+
+//====================================================================================================
+// MediaCaptureReader
+//====================================================================================================
+std::shared_ptr<MediaCaptureReader> MediaCaptureReader::Open(const ov::String &file_path)
+{
+	auto reader = std::shared_ptr<MediaCaptureReader>(new MediaCaptureReader());
+
+	reader->_file_path = file_path;
+	reader->_file = ::fopen(file_path.CStr(), "rb");
+
+	if (reader->_file == nullptr)
+	{
+		logte("Could not open the capture file: %s (%s)", file_path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	uint8_t magic[sizeof(MEDIA_CAPTURE_MAGIC)];
+
+	if ((::fread(magic, sizeof(magic), 1, reader->_file) != 1) || (::memcmp(magic, MEDIA_CAPTURE_MAGIC, sizeof(magic)) != 0))
+	{
+		logte("Not a capture file: %s", file_path.CStr());
+		return nullptr;
+	}
+
+	// The stream is written before the first packet
+	MediaCaptureRecordType type;
+	int64_t time_usec;
+	std::shared_ptr<ov::Data> value;
+
+	if ((reader->ReadRecord(&type, &time_usec, &value) == false) || (type != MediaCaptureRecordType::Stream))
+	{
+		logte("The capture file has no stream: %s", file_path.CStr());
+		return nullptr;
+	}
+
+	auto message = OvtControlMessage::Parse(value);
+
+	if ((message == nullptr) || (message->HasStream() == false) || message->GetTracks().empty())
+	{
+		logte("The capture file has no track: %s", file_path.CStr());
+		return nullptr;
+	}
+
+	reader->_tracks = message->GetTracks();
+	reader->_first_packet_offset = ::ftell(reader->_file);
+
+	return reader;
+}
+
+MediaCaptureReader::~MediaCaptureReader()
+{
+	if (_file != nullptr)
+	{
+		::fclose(_file);
+		_file = nullptr;
+	}
+}
+
+bool MediaCaptureReader::ReadRecord(MediaCaptureRecordType *type, int64_t *time_usec, std::shared_ptr<ov::Data> *value)
+{
+	uint8_t record_header[MEDIA_CAPTURE_RECORD_HEADER_SIZE];
+
+	if (::fread(record_header, sizeof(record_header), 1, _file) != 1)
+	{
+		return false;
+	}
+
+	*type = static_cast<MediaCaptureRecordType>(ByteReader<uint8_t>::ReadBigEndian(&record_header[0]));
+	*time_usec = static_cast<int64_t>(ByteReader<uint64_t>::ReadBigEndian(&record_header[1]));
+	auto length = ByteReader<uint32_t>::ReadBigEndian(&record_header[9]);
+
+	auto data = std::make_shared<ov::Data>(length);
+	data->SetLengthUninitialized(length);
+
+	if ((length > 0) && (::fread(data->GetWritableData(), length, 1, _file) != 1))
+	{
+		logtw("The capture file is truncated: %s", _file_path.CStr());
+		return false;
+	}
+
+	*value = std::move(data);
+
+	return true;
+}
+
+bool MediaCaptureReader::Read(Record *record)
+{
+	MediaCaptureRecordType type;
+	int64_t time_usec;
+	std::shared_ptr<ov::Data> value;
+
+	while (ReadRecord(&type, &time_usec, &value))
+	{
+		if (type != MediaCaptureRecordType::MediaPacket)
+		{
+			continue;
+		}
+
+		// The same as OvtDepacketizer::AppendPacket()
+		if (value->GetLength() < MEDIA_PACKET_HEADER_SIZE)
+		{
+			logtw("Invalid media packet in the capture file: %s", _file_path.CStr());
+			return false;
+		}
+
+		auto buffer = value->GetDataAs<uint8_t>();
+		auto track_id = ByteReader<uint32_t>::ReadBigEndian(&buffer[0]);
+		auto pts = ByteReader<uint64_t>::ReadBigEndian(&buffer[4]);
+		auto dts = ByteReader<uint64_t>::ReadBigEndian(&buffer[12]);
+		auto duration = ByteReader<uint64_t>::ReadBigEndian(&buffer[20]);
+		auto media_type = static_cast<common::MediaType>(ByteReader<uint8_t>::ReadBigEndian(&buffer[28]));
+		auto media_flag = static_cast<MediaPacketFlag>(ByteReader<uint8_t>::ReadBigEndian(&buffer[29]));
+		auto data_size = ByteReader<uint32_t>::ReadBigEndian(&buffer[30]);
+
+		if (data_size != value->GetLength() - MEDIA_PACKET_HEADER_SIZE)
+		{
+			logtw("Invalid media packet in the capture file: %s", _file_path.CStr());
+			return false;
+		}
+
+		record->time_usec = time_usec;
+		record->media_packet = std::make_shared<MediaPacket>(media_type, track_id, value->Subdata(MEDIA_PACKET_HEADER_SIZE), pts, dts, duration, media_flag);
+
+		return true;
+	}
+
+	return false;
+}
+
+bool MediaCaptureReader::Rewind()
+{
+	return (::fseek(_file, _first_packet_offset, SEEK_SET) == 0);
+}
+
+//====================================================================================================
+// MediaCapture
+//====================================================================================================
+static std::mutex g_media_capture_mutex;
+static ov::String g_media_capture_directory;
+static ov::String g_media_capture_stream_pattern;
+
+void MediaCapture::Configure(const ov::String &directory, const ov::String &stream_pattern)
+{
+	std::lock_guard<std::mutex> lock_guard(g_media_capture_mutex);
+
+	g_media_capture_directory = directory;
+	g_media_capture_stream_pattern = stream_pattern;
+}
+
+bool MediaCapture::IsEnabled()
+{
+	std::lock_guard<std::mutex> lock_guard(g_media_capture_mutex);
+
+	return (g_media_capture_directory.IsEmpty() == false);
+}
+
+ov::String MediaCapture::GetDirectory()
+{
+	std::lock_guard<std::mutex> lock_guard(g_media_capture_mutex);
+
+	return g_media_capture_directory;
+}
+
+std::shared_ptr<MediaCaptureWriter> MediaCapture::CreateWriter(const std::shared_ptr<info::Stream> &stream)
+{
+	ov::String directory;
+	ov::String stream_pattern;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(g_media_capture_mutex);
+
+		directory = g_media_capture_directory;
+		stream_pattern = g_media_capture_stream_pattern;
+	}
+
+	if (directory.IsEmpty() || stream_pattern.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	auto &app_name = stream->GetApplicationInfo().GetName();
+	auto stream_key = ov::String::FormatString("%s/%s", app_name.CStr(), stream->GetName().CStr());
+
+	if (::fnmatch(stream_pattern.CStr(), stream_key.CStr(), 0) != 0)
+	{
+		return nullptr;
+	}
+
+	if (ov::PathManager::MakeDirectory(directory.CStr()) == false)
+	{
+		logte("Could not create the capture directory: %s", directory.CStr());
+		return nullptr;
+	}
+
+	// <vhost_app_name>_<stream_name>_<YYYYmmdd-HHMMSS>.omecap (the characters that are not allowed in the file names are replaced)
+	char time_string[32]{};
+	auto now = ::time(nullptr);
+	struct tm local_time
+	{
+	};
+	::localtime_r(&now, &local_time);
+	::strftime(time_string, sizeof(time_string), "%Y%m%d-%H%M%S", &local_time);
+
+	auto file_name = ov::String::FormatString("%s_%s_%s." MEDIA_CAPTURE_FILE_EXTENSION, app_name.CStr(), stream->GetName().CStr(), time_string)
+						 .Replace("#", "_")
+						 .Replace("/", "_");
+
+	auto writer = MediaCaptureWriter::Create(ov::PathManager::Combine(directory, file_name), stream);
+
+	if (writer != nullptr)
+	{
+		logti("%s is captured to %s", stream_key.CStr(), writer->GetFilePath().CStr());
+	}
+
+	return writer;
+}
+
+bool MediaCapture::ResolveFilePath(const ov::String &file_name, ov::String *file_path)
+{
+	auto directory = GetDirectory();
+
+	if (directory.IsEmpty() || file_name.IsEmpty() || (file_name.IndexOf("..") >= 0))
+	{
+		return false;
+	}
+
+	*file_path = ov::PathManager::Combine(directory, file_name);
+
+	return true;
+}
@@ -0,0 +1,142 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/info/stream.h>
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+#define MEDIA_CAPTURE_FILE_EXTENSION "omecap"
+// The buffer of the capture file, the packets are written from the thread of the provider
+#define MEDIA_CAPTURE_WRITE_BUFFER_SIZE (1024 * 1024)
+
+/***********************************************
+ * Capture File
+ ***********************************************
+ The media packets that a provider sends to the MediaRouter, with the time they are sent,
+ so the ingest can be replayed through the pipeline later (See ReplayProvider).
+
+ 	Magic (8 bytes, "OMECAP" 0x00 0x01) | Record | Record | ...
+
+ 	Record : Type (1 byte) | Time (8 bytes) | Length (4 bytes) | Value (Length bytes)
+ 		The numbers are big endian, and the unknown types are skipped
+ 		Time: The microseconds since the first record of the file
+
+ 		0x01 Stream: The binary DESCRIBE response of OVT (See OvtControlMessage), it has the tracks of the stream
+ 		0x02 MediaPacket: The MediaPacket serialization of OVT (See OvtPacketizer)
+ ***********************************************/
+
+enum class MediaCaptureRecordType : uint8_t
+{
+	Stream = 0x01,
+	MediaPacket = 0x02
+};
+
+// Writes the packets of an incoming stream of the MediaRouter to a capture file
+class MediaCaptureWriter
+{
+public:
+	// Returns nullptr if the file cannot be created
+	static std::shared_ptr<MediaCaptureWriter> Create(const ov::String &file_path, const std::shared_ptr<info::Stream> &stream);
+
+	~MediaCaptureWriter();
+
+	// The tracks of the stream are written before the first packet (the providers may add the tracks after the stream is created)
+	// Returns false if the capture is stopped (such as the disk is full)
+	bool Write(const std::shared_ptr<MediaPacket> &media_packet);
+
+	void Close();
+
+	const ov::String &GetFilePath() const
+	{
+		return _file_path;
+	}
+
+private:
+	MediaCaptureWriter() = default;
+
+	bool WriteRecord(MediaCaptureRecordType type, const void *header, size_t header_length, const std::shared_ptr<const ov::Data> &data);
+
+	std::mutex _mutex;
+
+	ov::String _file_path;
+	FILE *_file = nullptr;
+	std::unique_ptr<char[]> _buffer;
+
+	std::shared_ptr<info::Stream> _stream;
+	bool _is_stream_written = false;
+
+	std::chrono::steady_clock::time_point _start_time;
+
+	uint64_t _packet_count = 0;
+	uint64_t _written_bytes = 0;
+};
+
+// Reads a capture file in order
+class MediaCaptureReader
+{
+public:
+	struct Record
+	{
+		// The microseconds since the first record of the file
+		int64_t time_usec = 0;
+		std::shared_ptr<MediaPacket> media_packet;
+	};
+
+	// Returns nullptr if the file is not a capture file, or it doesn't have the tracks
+	static std::shared_ptr<MediaCaptureReader> Open(const ov::String &file_path);
+
+	~MediaCaptureReader();
+
+	const std::vector<std::shared_ptr<MediaTrack>> &GetTracks() const
+	{
+		return _tracks;
+	}
+
+	// Returns false at the end of the file (or the rest of the file is broken)
+	bool Read(Record *record);
+	// Reads from the first packet again
+	bool Rewind();
+
+private:
+	MediaCaptureReader() = default;
+
+	// Returns false at the end of the file
+	bool ReadRecord(MediaCaptureRecordType *type, int64_t *time_usec, std::shared_ptr<ov::Data> *value);
+
+	ov::String _file_path;
+	FILE *_file = nullptr;
+
+	std::vector<std::shared_ptr<MediaTrack>> _tracks;
+	// The offset of the first record after the stream
+	long _first_packet_offset = 0;
+};
+
+// Decides the streams to capture (<Server><Performance><Capture>)
+class MediaCapture
+{
+public:
+	// directory: Where the capture files are written, and the files are replayed from
+	// stream_pattern: The streams to capture ("<vhost_app_name>/<stream_name>", the wildcards of fnmatch are allowed),
+	// 	no stream is captured if it is empty (the files are only replayed)
+	static void Configure(const ov::String &directory, const ov::String &stream_pattern);
+
+	static bool IsEnabled();
+	static ov::String GetDirectory();
+
+	// Returns nullptr if the stream is not captured
+	static std::shared_ptr<MediaCaptureWriter> CreateWriter(const std::shared_ptr<info::Stream> &stream);
+
+	// Resolves the name of a capture file in the directory (returns false if the name escapes the directory)
+	static bool ResolveFilePath(const ov::String &file_name, ov::String *file_path);
+};
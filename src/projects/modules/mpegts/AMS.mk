@@ -0,0 +1,6 @@
+LOCAL_PATH := $(call get_local_path)
+include $(DEFAULT_VARIABLES)
+
+LOCAL_TARGET := mpegts
+
+include $(BUILD_STATIC_LIBRARY)
@@ -0,0 +1,442 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "mpegts_demuxer.h"
+
+#include "base/ovlibrary/byte_io.h"
+
+#define OV_LOG_TAG "MpegTsDemuxer"
+
+#define MPEGTS_PAT_PID 0x0000
+#define MPEGTS_NULL_PID 0x1FFF
+
+#define MPEGTS_TABLE_ID_PAT 0x00
+#define MPEGTS_TABLE_ID_PMT 0x02
+
+// The timestamps of MPEG-TS are 33 bits
+#define MPEGTS_TIMESTAMP_MASK ((1LL << 33) - 1)
+
+bool MpegTsDemuxer::AppendData(const void *data, size_t length)
+{
+	auto bytes = static_cast<const uint8_t *>(data);
+
+	if (_remainder_length > 0)
+	{
+		size_t to_copy = std::min(MPEGTS_PACKET_SIZE - _remainder_length, length);
+
+		::memcpy(_remainder + _remainder_length, bytes, to_copy);
+		_remainder_length += to_copy;
+		bytes += to_copy;
+		length -= to_copy;
+
+		if (_remainder_length < MPEGTS_PACKET_SIZE)
+		{
+			return true;
+		}
+
+		_remainder_length = 0;
+
+		if (ParsePacket(_remainder) == false)
+		{
+			return false;
+		}
+	}
+
+	while (length >= MPEGTS_PACKET_SIZE)
+	{
+		if (bytes[0] != MPEGTS_SYNC_BYTE)
+		{
+			// Find the next packet
+			auto sync_byte = static_cast<const uint8_t *>(::memchr(bytes, MPEGTS_SYNC_BYTE, length));
+
+			if (sync_byte == nullptr)
+			{
+				logtw("Could not find the sync byte in %zu bytes", length);
+				return false;
+			}
+
+			logtd("%zd bytes are skipped to find the sync byte", sync_byte - bytes);
+
+			length -= (sync_byte - bytes);
+			bytes = sync_byte;
+			continue;
+		}
+
+		if (ParsePacket(bytes) == false)
+		{
+			return false;
+		}
+
+		bytes += MPEGTS_PACKET_SIZE;
+		length -= MPEGTS_PACKET_SIZE;
+	}
+
+	if (length > 0)
+	{
+		::memcpy(_remainder, bytes, length);
+		_remainder_length = length;
+	}
+
+	return true;
+}
+
+bool MpegTsDemuxer::IsAvailablePes() const
+{
+	return _pes_list.empty() == false;
+}
+
+std::shared_ptr<MpegTsPes> MpegTsDemuxer::PopPes()
+{
+	if (_pes_list.empty())
+	{
+		return nullptr;
+	}
+
+	auto pes = std::move(_pes_list.front());
+	_pes_list.pop_front();
+
+	return pes;
+}
+
+bool MpegTsDemuxer::ParsePacket(const uint8_t *packet)
+{
+	if (packet[0] != MPEGTS_SYNC_BYTE)
+	{
+		logtw("Invalid sync byte: 0x%02X", packet[0]);
+		return false;
+	}
+
+	bool transport_error = (packet[1] & 0x80);
+	bool payload_unit_start = (packet[1] & 0x40);
+	uint16_t pid = ((packet[1] & 0x1F) << 8) | packet[2];
+	uint8_t adaptation_field_control = (packet[3] >> 4) & 0x03;
+	uint8_t continuity_counter = packet[3] & 0x0F;
+
+	if (pid == MPEGTS_NULL_PID)
+	{
+		return true;
+	}
+
+	size_t offset = 4;
+	bool discontinuity = false;
+
+	if (adaptation_field_control & 0x02)
+	{
+		size_t adaptation_field_length = packet[4];
+
+		if ((adaptation_field_length > 0) && (adaptation_field_length < (MPEGTS_PACKET_SIZE - 5)))
+		{
+			discontinuity = (packet[5] & 0x80);
+		}
+
+		offset += 1 + adaptation_field_length;
+	}
+
+	if (((adaptation_field_control & 0x01) == 0) || (offset >= MPEGTS_PACKET_SIZE))
+	{
+		// No payload
+		return true;
+	}
+
+	const uint8_t *payload = packet + offset;
+	size_t payload_length = MPEGTS_PACKET_SIZE - offset;
+
+	if (pid == MPEGTS_PAT_PID)
+	{
+		if (payload_unit_start && (transport_error == false))
+		{
+			ParsePat(payload, payload_length);
+		}
+
+		return true;
+	}
+
+	if (pid == _pmt_pid)
+	{
+		if (payload_unit_start && (transport_error == false))
+		{
+			ParsePmt(payload, payload_length);
+		}
+
+		return true;
+	}
+
+	auto item = _es_context_map.find(pid);
+
+	if (item == _es_context_map.end())
+	{
+		// Not an elementary stream of the program
+		return true;
+	}
+
+	auto &context = item->second;
+
+	if ((context.continuity_counter >= 0) && (discontinuity == false))
+	{
+		if (continuity_counter == context.continuity_counter)
+		{
+			// Duplicated
+			return true;
+		}
+
+		if (continuity_counter != ((context.continuity_counter + 1) & 0x0F))
+		{
+			logtd("Continuity error of PID 0x%04X: expected %d, but %d", pid, (context.continuity_counter + 1) & 0x0F, continuity_counter);
+			context.is_corrupted = true;
+		}
+	}
+
+	context.continuity_counter = continuity_counter;
+
+	if (transport_error)
+	{
+		context.is_corrupted = true;
+		return true;
+	}
+
+	if (payload_unit_start)
+	{
+		if (context.has_pes)
+		{
+			CompletePes(context, pid);
+		}
+
+		BeginPes(context, pid, payload, payload_length);
+	}
+	else if (context.has_pes)
+	{
+		AppendPes(context, pid, payload, payload_length);
+	}
+
+	return true;
+}
+
+const uint8_t *MpegTsDemuxer::GetSection(const uint8_t *payload, size_t length, uint8_t table_id, size_t *section_length)
+{
+	size_t pointer_field = payload[0];
+
+	if (1 + pointer_field + 3 > length)
+	{
+		return nullptr;
+	}
+
+	auto section = payload + 1 + pointer_field;
+	length -= 1 + pointer_field;
+
+	if (section[0] != table_id)
+	{
+		return nullptr;
+	}
+
+	*section_length = 3 + (((section[1] & 0x0F) << 8) | section[2]);
+
+	// The sections that span the packets are not supported (PAT/PMT of a single program fits in a packet)
+	if (*section_length > length)
+	{
+		logtw("The section (table id: %d, %zu bytes) doesn't fit in a packet", table_id, *section_length);
+		return nullptr;
+	}
+
+	return section;
+}
+
+void MpegTsDemuxer::ParsePat(const uint8_t *payload, size_t length)
+{
+	size_t section_length;
+	auto section = GetSection(payload, length, MPEGTS_TABLE_ID_PAT, &section_length);
+
+	// header(8) + CRC(4)
+	if ((section == nullptr) || (section_length < 12))
+	{
+		return;
+	}
+
+	for (size_t offset = 8; (offset + 4) <= (section_length - 4); offset += 4)
+	{
+		uint16_t program_number = ByteReader<uint16_t>::ReadBigEndian(section + offset);
+		uint16_t pid = ByteReader<uint16_t>::ReadBigEndian(section + offset + 2) & 0x1FFF;
+
+		// Program 0 is the network PID
+		if (program_number != 0)
+		{
+			if (_pmt_pid != pid)
+			{
+				logtd("PMT PID: 0x%04X (program: %d)", pid, program_number);
+				_pmt_pid = pid;
+			}
+
+			// Only the first program is demuxed
+			return;
+		}
+	}
+}
+
+void MpegTsDemuxer::ParsePmt(const uint8_t *payload, size_t length)
+{
+	size_t section_length;
+	auto section = GetSection(payload, length, MPEGTS_TABLE_ID_PMT, &section_length);
+
+	// header(12) + CRC(4)
+	if ((section == nullptr) || (section_length < 16))
+	{
+		return;
+	}
+
+	size_t program_info_length = ByteReader<uint16_t>::ReadBigEndian(section + 10) & 0x0FFF;
+	size_t end = section_length - 4;
+
+	for (size_t offset = 12 + program_info_length; (offset + 5) <= end;)
+	{
+		uint8_t stream_type = section[offset];
+		uint16_t pid = ByteReader<uint16_t>::ReadBigEndian(section + offset + 1) & 0x1FFF;
+		size_t es_info_length = ByteReader<uint16_t>::ReadBigEndian(section + offset + 3) & 0x0FFF;
+
+		// The PMT is repeated, and the elementary streams are not changed during a stream
+		if (_elementary_streams.find(pid) == _elementary_streams.end())
+		{
+			logtd("Elementary stream: PID 0x%04X, stream type: 0x%02X", pid, stream_type);
+
+			_elementary_streams[pid] = stream_type;
+			_es_context_map[pid].stream_type = stream_type;
+		}
+
+		offset += 5 + es_info_length;
+	}
+
+	_is_pmt_received = true;
+}
+
+static int64_t ReadTimestamp(const uint8_t *data)
+{
+	// '001x' or '0011'/'0001'(4) + TS[32..30](3) + marker(1) + TS[29..15](15) + marker(1) + TS[14..0](15) + marker(1)
+	return ((static_cast<int64_t>(data[0] & 0x0E) << 29) |
+			(static_cast<int64_t>(data[1]) << 22) |
+			(static_cast<int64_t>(data[2] & 0xFE) << 14) |
+			(static_cast<int64_t>(data[3]) << 7) |
+			(static_cast<int64_t>(data[4]) >> 1));
+}
+
+void MpegTsDemuxer::BeginPes(EsContext &context, uint16_t pid, const uint8_t *payload, size_t length)
+{
+	context.has_pes = false;
+	context.is_corrupted = false;
+
+	// packet_start_code_prefix(3) + stream_id(1) + PES_packet_length(2) + flags(2) + PES_header_data_length(1)
+	if ((length < 9) || (payload[0] != 0x00) || (payload[1] != 0x00) || (payload[2] != 0x01))
+	{
+		logtd("Invalid PES header of PID 0x%04X", pid);
+		return;
+	}
+
+	size_t pes_packet_length = ByteReader<uint16_t>::ReadBigEndian(payload + 4);
+	uint8_t pts_dts_flags = (payload[7] >> 6) & 0x03;
+	size_t header_data_length = payload[8];
+	size_t header_length = 9 + header_data_length;
+
+	if (header_length > length)
+	{
+		// The PES header that spans the packets is not supported
+		logtd("The PES header of PID 0x%04X doesn't fit in a packet", pid);
+		return;
+	}
+
+	if ((pts_dts_flags & 0x02) && (header_data_length >= 5))
+	{
+		context.pts = ExtendTimestamp(context, ReadTimestamp(payload + 9));
+		context.dts = context.pts;
+
+		if ((pts_dts_flags == 0x03) && (header_data_length >= 10))
+		{
+			// DTS <= PTS, so it is extended from the PTS
+			context.dts = context.pts - ((ReadTimestamp(payload + 9) - ReadTimestamp(payload + 14)) & MPEGTS_TIMESTAMP_MASK);
+		}
+	}
+	// Otherwise, the timestamps of the previous PES are used
+
+	context.expected_length = (pes_packet_length > 0) ? (pes_packet_length - 3 - header_data_length) : 0;
+	context.data = std::make_shared<ov::Data>(context.capacity);
+	context.has_pes = true;
+
+	AppendPes(context, pid, payload + header_length, length - header_length);
+}
+
+void MpegTsDemuxer::AppendPes(EsContext &context, uint16_t pid, const uint8_t *payload, size_t length)
+{
+	context.data->Append(payload, length);
+
+	if ((context.expected_length > 0) && (context.data->GetLength() >= context.expected_length))
+	{
+		CompletePes(context, pid);
+	}
+}
+
+void MpegTsDemuxer::CompletePes(EsContext &context, uint16_t pid)
+{
+	context.has_pes = false;
+
+	auto data = std::move(context.data);
+
+	if (context.is_corrupted)
+	{
+		logtd("A PES of PID 0x%04X has been dropped due to the packet loss", pid);
+		return;
+	}
+
+	if (context.expected_length > 0)
+	{
+		if (data->GetLength() < context.expected_length)
+		{
+			return;
+		}
+
+		// Stuffing bytes
+		data->SetLength(context.expected_length);
+	}
+
+	if (data->GetLength() == 0)
+	{
+		return;
+	}
+
+	context.capacity = std::max(context.capacity, data->GetLength());
+
+	auto pes = std::make_shared<MpegTsPes>();
+
+	pes->pid = pid;
+	pes->stream_type = context.stream_type;
+	pes->pts = context.pts;
+	pes->dts = context.dts;
+	pes->data = std::move(data);
+
+	_pes_list.push_back(std::move(pes));
+}
+
+int64_t MpegTsDemuxer::ExtendTimestamp(EsContext &context, int64_t raw_timestamp)
+{
+	if (context.is_first_timestamp)
+	{
+		context.is_first_timestamp = false;
+		context.last_raw_timestamp = raw_timestamp;
+		// Starts from the raw timestamp to keep the A/V synchronization between the elementary streams
+		context.last_timestamp = raw_timestamp;
+
+		return raw_timestamp;
+	}
+
+	// The difference is sign-extended from 33 bits, so the timestamp can go back a little (B-frames)
+	int64_t delta = (raw_timestamp - context.last_raw_timestamp) & MPEGTS_TIMESTAMP_MASK;
+
+	if (delta >= (1LL << 32))
+	{
+		delta -= (1LL << 33);
+	}
+
+	context.last_raw_timestamp = raw_timestamp;
+	context.last_timestamp += delta;
+
+	return context.last_timestamp;
+}
@@ -0,0 +1,120 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <deque>
+#include <map>
+
+#define MPEGTS_PACKET_SIZE 188
+#define MPEGTS_SYNC_BYTE 0x47
+// The initial capacity of the PES buffer, it grows to the size of the largest PES
+#define MPEGTS_DEFAULT_PES_CAPACITY (64 * 1024)
+
+// ISO/IEC 13818-1 Table 2-34
+enum class MpegTsStreamType : uint8_t
+{
+	AacAdts = 0x0F,
+	H264 = 0x1B,
+};
+
+// A PES of an elementary stream
+struct MpegTsPes
+{
+	uint16_t pid = 0;
+	uint8_t stream_type = 0;
+
+	// 90kHz, extended to 64 bits (the 33 bits timestamp of MPEG-TS is wrapped around every 26.5 hours)
+	int64_t pts = 0;
+	int64_t dts = 0;
+
+	// The payload of the PES (ES data) without the PES header
+	std::shared_ptr<ov::Data> data;
+};
+
+// Demuxes the MPEG-TS packets (single program) into the PES of each elementary stream.
+//
+// The TS packets are parsed in place, and the payloads are appended to the PES buffer directly,
+// so the PES buffer can be used as the data of a MediaPacket without copying it again.
+// Only a partial TS packet at the end of the data is copied to be completed with the next data.
+//
+// Not thread-safe: the data of a stream must be appended by one thread at a time.
+class MpegTsDemuxer
+{
+public:
+	// Returns false if the data is not MPEG-TS
+	bool AppendData(const void *data, size_t length);
+
+	// Whether the elementary streams of the program are known
+	bool IsPmtReceived() const
+	{
+		return _is_pmt_received;
+	}
+
+	// key: PID, value: stream type
+	const std::map<uint16_t, uint8_t> &GetElementaryStreams() const
+	{
+		return _elementary_streams;
+	}
+
+	bool IsAvailablePes() const;
+	std::shared_ptr<MpegTsPes> PopPes();
+
+private:
+	struct EsContext
+	{
+		uint8_t stream_type = 0;
+
+		// -1: not received yet
+		int continuity_counter = -1;
+
+		// Whether a PES is being assembled
+		bool has_pes = false;
+		bool is_corrupted = false;
+		// 0 if the length is unbounded (usually video), then the PES is completed by the start of the next PES
+		size_t expected_length = 0;
+
+		int64_t pts = 0;
+		int64_t dts = 0;
+		std::shared_ptr<ov::Data> data;
+		size_t capacity = MPEGTS_DEFAULT_PES_CAPACITY;
+
+		// Timestamp extension
+		bool is_first_timestamp = true;
+		int64_t last_raw_timestamp = 0;
+		int64_t last_timestamp = 0;
+	};
+
+	bool ParsePacket(const uint8_t *packet);
+
+	void ParsePat(const uint8_t *payload, size_t length);
+	void ParsePmt(const uint8_t *payload, size_t length);
+
+	void BeginPes(EsContext &context, uint16_t pid, const uint8_t *payload, size_t length);
+	void AppendPes(EsContext &context, uint16_t pid, const uint8_t *payload, size_t length);
+	void CompletePes(EsContext &context, uint16_t pid);
+
+	// Returns a pointer to the section after the pointer field, nullptr if the section doesn't fit in the payload
+	const uint8_t *GetSection(const uint8_t *payload, size_t length, uint8_t table_id, size_t *section_length);
+
+	int64_t ExtendTimestamp(EsContext &context, int64_t raw_timestamp);
+
+	// -1: not received yet
+	int32_t _pmt_pid = -1;
+	bool _is_pmt_received = false;
+
+	std::map<uint16_t, uint8_t> _elementary_streams;
+	std::map<uint16_t, EsContext> _es_context_map;
+
+	// A partial TS packet at the end of the previous data
+	uint8_t _remainder[MPEGTS_PACKET_SIZE];
+	size_t _remainder_length = 0;
+
+	std::deque<std::shared_ptr<MpegTsPes>> _pes_list;
+};
@@ -0,0 +1,1269 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_control_message.h"
+
+#include <base/ovlibrary/byte_io.h>
+
+#include <cstring>
+
+#define OV_LOG_TAG "OvtControlMessage"
+
+enum class MessageTlvType : uint8_t
+{
+	Id = 0x01,
+	Url = 0x02,
+	Code = 0x03,
+	Message = 0x04,
+	Stream = 0x05,
+	Transport = 0x06,
+	DatagramPort = 0x07,
+	DatagramToken = 0x08,
+	Event = 0x09,
+	SharedMemoryPath = 0x0A,
+	SharedMemoryToken = 0x0B
+};
+
+enum class StreamTlvType : uint8_t
+{
+	AppName = 0x01,
+	StreamName = 0x02,
+	Track = 0x03
+};
+
+enum class TrackTlvType : uint8_t
+{
+	Id = 0x01,
+	CodecId = 0x02,
+	MediaType = 0x03,
+	TimebaseNum = 0x04,
+	TimebaseDen = 0x05,
+	Bitrate = 0x06,
+	StartFrameTime = 0x07,
+	LastFrameTime = 0x08,
+	FrameRate = 0x09,
+	Width = 0x0A,
+	Height = 0x0B,
+	SampleRate = 0x0C,
+	SampleFormat = 0x0D,
+	Layout = 0x0E
+};
+
+//--------------------------------------------------------------------
+// TLV helpers
+//--------------------------------------------------------------------
+static bool WriteTlv(ov::ByteStream &stream, uint8_t type, const void *value, size_t length)
+{
+	if (length > UINT16_MAX)
+	{
+		logte("The value is too long to be serialized: type: %d, length: %zu", type, length);
+		return false;
+	}
+
+	return stream.Write8(type) &&
+		   stream.WriteBE16(static_cast<uint16_t>(length)) &&
+		   ((length == 0) || stream.Write(value, length));
+}
+
+template <typename Ttype>
+static bool WriteTlv(ov::ByteStream &stream, Ttype type, const ov::String &value)
+{
+	return WriteTlv(stream, static_cast<uint8_t>(type), value.CStr(), value.GetLength());
+}
+
+template <typename Ttype>
+static bool WriteTlv(ov::ByteStream &stream, Ttype type, const std::shared_ptr<const ov::Data> &value)
+{
+	return WriteTlv(stream, static_cast<uint8_t>(type), value->GetData(), value->GetLength());
+}
+
+template <typename Ttype>
+static bool WriteTlv8(ov::ByteStream &stream, Ttype type, uint8_t value)
+{
+	return WriteTlv(stream, static_cast<uint8_t>(type), &value, sizeof(value));
+}
+
+template <typename Ttype>
+static bool WriteTlv16(ov::ByteStream &stream, Ttype type, uint16_t value)
+{
+	value = ov::HostToBE16(value);
+	return WriteTlv(stream, static_cast<uint8_t>(type), &value, sizeof(value));
+}
+
+template <typename Ttype>
+static bool WriteTlv32(ov::ByteStream &stream, Ttype type, uint32_t value)
+{
+	value = ov::HostToBE32(value);
+	return WriteTlv(stream, static_cast<uint8_t>(type), &value, sizeof(value));
+}
+
+template <typename Ttype>
+static bool WriteTlv64(ov::ByteStream &stream, Ttype type, uint64_t value)
+{
+	value = ov::HostToBE64(value);
+	return WriteTlv(stream, static_cast<uint8_t>(type), &value, sizeof(value));
+}
+
+// Returns false if there is no more TLV or the TLV is truncated (is_truncated is set)
+static bool ReadTlv(ov::ByteStream &stream, const std::shared_ptr<const ov::Data> &data, uint8_t *type, std::shared_ptr<const ov::Data> *value, bool *is_truncated)
+{
+	*is_truncated = false;
+
+	if (stream.Remained() == 0)
+	{
+		return false;
+	}
+
+	if (stream.IsRemained(sizeof(uint8_t) + sizeof(uint16_t)) == false)
+	{
+		*is_truncated = true;
+		return false;
+	}
+
+	*type = stream.Read8();
+	auto length = stream.ReadBE16();
+
+	if (stream.IsRemained(length) == false)
+	{
+		*is_truncated = true;
+		return false;
+	}
+
+	*value = data->Subdata(stream.GetOffset(), length);
+	stream.Skip<uint8_t>(length);
+
+	return true;
+}
+
+static bool ReadValue(const std::shared_ptr<const ov::Data> &value, uint8_t *result)
+{
+	if (value->GetLength() != sizeof(uint8_t))
+	{
+		return false;
+	}
+
+	*result = value->GetDataAs<uint8_t>()[0];
+	return true;
+}
+
+static bool ReadValue(const std::shared_ptr<const ov::Data> &value, uint16_t *result)
+{
+	if (value->GetLength() != sizeof(uint16_t))
+	{
+		return false;
+	}
+
+	*result = ByteReader<uint16_t>::ReadBigEndian(value->GetDataAs<uint8_t>());
+	return true;
+}
+
+static bool ReadValue(const std::shared_ptr<const ov::Data> &value, uint32_t *result)
+{
+	if (value->GetLength() != sizeof(uint32_t))
+	{
+		return false;
+	}
+
+	*result = ByteReader<uint32_t>::ReadBigEndian(value->GetDataAs<uint8_t>());
+	return true;
+}
+
+static bool ReadValue(const std::shared_ptr<const ov::Data> &value, uint64_t *result)
+{
+	if (value->GetLength() != sizeof(uint64_t))
+	{
+		return false;
+	}
+
+	*result = ByteReader<uint64_t>::ReadBigEndian(value->GetDataAs<uint8_t>());
+	return true;
+}
+
+static ov::String ReadString(const std::shared_ptr<const ov::Data> &value)
+{
+	return ov::String(value->GetDataAs<char>(), value->GetLength());
+}
+
+//--------------------------------------------------------------------
+// Parse
+//--------------------------------------------------------------------
+std::shared_ptr<OvtControlMessage> OvtControlMessage::Parse(const std::shared_ptr<const ov::Data> &payload)
+{
+	if ((payload == nullptr) || (payload->GetLength() == 0))
+	{
+		logte("An invalid control message : Empty payload");
+		return nullptr;
+	}
+
+	auto message = std::make_shared<OvtControlMessage>();
+
+	if (payload->GetDataAs<uint8_t>()[0] == OVT_CONTROL_BINARY_MARKER)
+	{
+		message->_format = Format::Binary;
+
+		if (message->ParseBinary(payload) == false)
+		{
+			return nullptr;
+		}
+	}
+	else
+	{
+		message->_format = Format::Json;
+
+		if (message->ParseJson(payload) == false)
+		{
+			return nullptr;
+		}
+	}
+
+	return message;
+}
+
+//--------------------------------------------------------------------
+// JSON handler (the payload is parsed without building a ::Json::Value tree)
+//--------------------------------------------------------------------
+class OvtControlMessage::JsonHandler : public ov::JsonReader::Handler
+{
+public:
+	explicit JsonHandler(OvtControlMessage *message)
+		: _message(message)
+	{
+	}
+
+	bool OnBeginObject() override
+	{
+		if (_scopes.empty())
+		{
+			_scopes.push_back(Scope::Root);
+			return true;
+		}
+
+		auto scope = Scope::Ignored;
+
+		switch (_scopes.back())
+		{
+			case Scope::Root:
+				if (_key == "stream")
+				{
+					scope = Scope::Stream;
+				}
+				break;
+
+			case Scope::Tracks:
+				scope = Scope::Track;
+				_track = TrackValues();
+				break;
+
+			case Scope::Track:
+				if (_key == "videoTrack")
+				{
+					scope = Scope::VideoTrack;
+					_track.has_video_track = true;
+				}
+				else if (_key == "audioTrack")
+				{
+					scope = Scope::AudioTrack;
+					_track.has_audio_track = true;
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		_scopes.push_back(scope);
+
+		return true;
+	}
+
+	bool OnKey(std::string_view key) override
+	{
+		_key = key;
+		return true;
+	}
+
+	bool OnEndObject() override
+	{
+		auto scope = _scopes.back();
+		_scopes.pop_back();
+
+		switch (scope)
+		{
+			case Scope::Root:
+				if (_has_datagram_port && _has_datagram_token)
+				{
+					_message->_datagram_port = _datagram_port;
+					_message->_datagram_token = _datagram_token;
+				}
+				break;
+
+			case Scope::Stream:
+				// "tracks" must be an array even if there is no track (See SerializeStreamDescription())
+				if ((_has_app_name == false) || (_has_stream_name == false) || (_has_tracks == false))
+				{
+					logte("Invalid json payload : stream");
+					return false;
+				}
+
+				_message->_has_stream = true;
+				break;
+
+			case Scope::Track:
+				return AddTrack();
+
+			default:
+				break;
+		}
+
+		return true;
+	}
+
+	bool OnBeginArray() override
+	{
+		if (_scopes.empty())
+		{
+			// The root must be an object
+			return false;
+		}
+
+		auto scope = Scope::Ignored;
+
+		if ((_scopes.back() == Scope::Stream) && (_key == "tracks"))
+		{
+			scope = Scope::Tracks;
+			_has_tracks = true;
+		}
+
+		_scopes.push_back(scope);
+
+		return true;
+	}
+
+	bool OnEndArray() override
+	{
+		_scopes.pop_back();
+		return true;
+	}
+
+	bool OnString(std::string_view value) override
+	{
+		if (_scopes.empty())
+		{
+			return false;
+		}
+
+		switch (_scopes.back())
+		{
+			case Scope::Root:
+				if (_key == "url")
+				{
+					_message->_has_url = true;
+					_message->_url = ov::String(value.data(), value.size());
+				}
+				else if (_key == "message")
+				{
+					_message->_has_message = true;
+					_message->_message = ov::String(value.data(), value.size());
+				}
+				else if (_key == "sharedMemoryPath")
+				{
+					_message->_shared_memory_path = ov::String(value.data(), value.size());
+				}
+				else if (_key == "transport")
+				{
+					if (value == "datagram")
+					{
+						_message->_requested_transport = Transport::Datagram;
+					}
+					else if (value == "sharedMemory")
+					{
+						_message->_requested_transport = Transport::SharedMemory;
+					}
+				}
+				else if (_key == "event")
+				{
+					if (value == "created")
+					{
+						_message->_stream_event = StreamEvent::Created;
+					}
+					else if (value == "deleted")
+					{
+						_message->_stream_event = StreamEvent::Deleted;
+					}
+				}
+				else if (_key == "stream")
+				{
+					logte("Invalid json payload : stream");
+					return false;
+				}
+				break;
+
+			case Scope::Stream:
+				if (_key == "appName")
+				{
+					_has_app_name = true;
+					_message->_app_name = ov::String(value.data(), value.size());
+				}
+				else if (_key == "streamName")
+				{
+					_has_stream_name = true;
+					_message->_stream_name = ov::String(value.data(), value.size());
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		return true;
+	}
+
+	bool OnBool(bool value) override
+	{
+		return _scopes.empty() == false;
+	}
+
+	bool OnNull() override
+	{
+		return _scopes.empty() == false;
+	}
+
+	bool OnUInt64(uint64_t value) override
+	{
+		return OnNumber(Number{true, value, static_cast<double>(value)});
+	}
+
+	bool OnInt64(int64_t value) override
+	{
+		return OnNumber(Number{false, 0, static_cast<double>(value)});
+	}
+
+	bool OnDouble(double value) override
+	{
+		return OnNumber(Number{false, 0, value});
+	}
+
+private:
+	enum class Scope : uint8_t
+	{
+		Root,
+		Stream,
+		Tracks,
+		Track,
+		VideoTrack,
+		AudioTrack,
+		// The unknown objects/arrays
+		Ignored
+	};
+
+	struct Number
+	{
+		// Whether the number is a non-negative integer
+		bool is_uint;
+		uint64_t uint_value;
+		double value;
+
+		bool IsUInt32() const
+		{
+			return is_uint && (uint_value <= UINT32_MAX);
+		}
+
+		uint32_t AsUInt32() const
+		{
+			return IsUInt32() ? static_cast<uint32_t>(uint_value) : 0;
+		}
+	};
+
+	struct TrackValues
+	{
+		bool has_id = false;
+		uint32_t id = 0;
+		bool has_codec_id = false;
+		uint32_t codec_id = 0;
+		bool has_media_type = false;
+		uint32_t media_type = 0;
+		bool has_timebase_num = false;
+		uint32_t timebase_num = 0;
+		bool has_timebase_den = false;
+		uint32_t timebase_den = 0;
+		bool has_bitrate = false;
+		uint32_t bitrate = 0;
+		bool has_start_frame_time = false;
+		uint64_t start_frame_time = 0;
+		bool has_last_frame_time = false;
+		uint64_t last_frame_time = 0;
+
+		bool has_video_track = false;
+		double frame_rate = 0.0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+
+		bool has_audio_track = false;
+		uint32_t sample_rate = 0;
+		int32_t sample_format = 0;
+		uint32_t layout = 0;
+	};
+
+	static void SetUInt32(const Number &number, bool *has_value, uint32_t *value)
+	{
+		*has_value = number.IsUInt32();
+		*value = number.AsUInt32();
+	}
+
+	static void SetUInt64(const Number &number, bool *has_value, uint64_t *value)
+	{
+		*has_value = number.is_uint;
+		*value = number.uint_value;
+	}
+
+	bool OnNumber(const Number &number)
+	{
+		if (_scopes.empty())
+		{
+			return false;
+		}
+
+		switch (_scopes.back())
+		{
+			case Scope::Root:
+				if (_key == "id")
+				{
+					SetUInt32(number, &_message->_has_id, &_message->_id);
+				}
+				else if (_key == "code")
+				{
+					SetUInt32(number, &_message->_has_code, &_message->_code);
+				}
+				else if (_key == "datagramPort")
+				{
+					_has_datagram_port = number.IsUInt32();
+					_datagram_port = static_cast<uint16_t>(number.AsUInt32());
+				}
+				else if (_key == "datagramToken")
+				{
+					SetUInt32(number, &_has_datagram_token, &_datagram_token);
+				}
+				else if (_key == "sharedMemoryToken")
+				{
+					bool has_token = false;
+					SetUInt32(number, &has_token, &_message->_shared_memory_token);
+				}
+				break;
+
+			case Scope::Track:
+				if (_key == "id")
+				{
+					SetUInt32(number, &_track.has_id, &_track.id);
+				}
+				else if (_key == "codecId")
+				{
+					SetUInt32(number, &_track.has_codec_id, &_track.codec_id);
+				}
+				else if (_key == "mediaType")
+				{
+					SetUInt32(number, &_track.has_media_type, &_track.media_type);
+				}
+				else if (_key == "timebase_num")
+				{
+					SetUInt32(number, &_track.has_timebase_num, &_track.timebase_num);
+				}
+				else if (_key == "timebase_den")
+				{
+					SetUInt32(number, &_track.has_timebase_den, &_track.timebase_den);
+				}
+				else if (_key == "bitrate")
+				{
+					SetUInt32(number, &_track.has_bitrate, &_track.bitrate);
+				}
+				else if (_key == "startFrameTime")
+				{
+					SetUInt64(number, &_track.has_start_frame_time, &_track.start_frame_time);
+				}
+				else if (_key == "lastFrameTime")
+				{
+					SetUInt64(number, &_track.has_last_frame_time, &_track.last_frame_time);
+				}
+				break;
+
+			case Scope::VideoTrack:
+				if (_key == "framerate")
+				{
+					_track.frame_rate = number.value;
+				}
+				else if (_key == "width")
+				{
+					_track.width = number.AsUInt32();
+				}
+				else if (_key == "height")
+				{
+					_track.height = number.AsUInt32();
+				}
+				break;
+
+			case Scope::AudioTrack:
+				if (_key == "samplerate")
+				{
+					_track.sample_rate = number.AsUInt32();
+				}
+				else if (_key == "sampleFormat")
+				{
+					_track.sample_format = static_cast<int32_t>(number.value);
+				}
+				else if (_key == "layout")
+				{
+					_track.layout = number.AsUInt32();
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		return true;
+	}
+
+	bool AddTrack()
+	{
+		auto &track = _track;
+		auto index = _message->_tracks.size();
+
+		// Validation
+		if ((track.has_id && track.has_codec_id && track.has_media_type && track.has_timebase_num && track.has_timebase_den &&
+			 track.has_bitrate && track.has_start_frame_time && track.has_last_frame_time) == false)
+		{
+			logte("Invalid json track [%zu]", index);
+			return false;
+		}
+
+		auto new_track = std::make_shared<MediaTrack>();
+
+		new_track->SetId(track.id);
+		new_track->SetCodecId(static_cast<common::MediaCodecId>(track.codec_id));
+		new_track->SetMediaType(static_cast<common::MediaType>(track.media_type));
+		new_track->SetTimeBase(track.timebase_num, track.timebase_den);
+		new_track->SetBitrate(track.bitrate);
+		new_track->SetStartFrameTime(track.start_frame_time);
+		new_track->SetLastFrameTime(track.last_frame_time);
+
+		// video or audio
+		if (new_track->GetMediaType() == common::MediaType::Video)
+		{
+			if (track.has_video_track == false)
+			{
+				logte("Invalid json videoTrack");
+				return false;
+			}
+
+			new_track->SetFrameRate(track.frame_rate);
+			new_track->SetWidth(track.width);
+			new_track->SetHeight(track.height);
+		}
+		else if (new_track->GetMediaType() == common::MediaType::Audio)
+		{
+			if (track.has_audio_track == false)
+			{
+				logte("Invalid json audioTrack");
+				return false;
+			}
+
+			new_track->SetSampleRate(track.sample_rate);
+			new_track->GetSample().SetFormat(static_cast<common::AudioSample::Format>(track.sample_format));
+			new_track->GetChannel().SetLayout(static_cast<common::AudioChannel::Layout>(track.layout));
+		}
+
+		_message->_tracks.push_back(new_track);
+
+		return true;
+	}
+
+	OvtControlMessage *_message;
+
+	std::vector<Scope> _scopes;
+	// The key of the current value (the string_view of OnKey() is not valid after the call)
+	std::string _key;
+
+	bool _has_datagram_port = false;
+	uint16_t _datagram_port = 0;
+	bool _has_datagram_token = false;
+	uint32_t _datagram_token = 0;
+
+	bool _has_app_name = false;
+	bool _has_stream_name = false;
+	bool _has_tracks = false;
+
+	TrackValues _track;
+};
+
+bool OvtControlMessage::ParseJson(const std::shared_ptr<const ov::Data> &payload)
+{
+	JsonHandler handler(this);
+
+	auto error = ov::JsonReader::Parse(payload, &handler);
+
+	if (error != nullptr)
+	{
+		logte("An invalid control message : Json format (%s)", error->ToString().CStr());
+		return false;
+	}
+
+	return true;
+}
+
+bool OvtControlMessage::ParseBinary(const std::shared_ptr<const ov::Data> &payload)
+{
+	ov::ByteStream stream(payload.get());
+
+	// Marker & Version
+	if (stream.IsRemained(2) == false)
+	{
+		logte("An invalid control message : Binary header is truncated");
+		return false;
+	}
+
+	stream.Skip<uint8_t>(1);
+	auto version = stream.Read8();
+
+	if (version != OVT_CONTROL_BINARY_VERSION)
+	{
+		logte("An invalid control message : Unsupported binary version (%d)", version);
+		return false;
+	}
+
+	uint8_t type;
+	std::shared_ptr<const ov::Data> value;
+	bool is_truncated;
+
+	while (ReadTlv(stream, payload, &type, &value, &is_truncated))
+	{
+		switch (static_cast<MessageTlvType>(type))
+		{
+			case MessageTlvType::Id:
+				_has_id = ReadValue(value, &_id);
+				break;
+
+			case MessageTlvType::Url:
+				_has_url = true;
+				_url = ReadString(value);
+				break;
+
+			case MessageTlvType::Code:
+				_has_code = ReadValue(value, &_code);
+				break;
+
+			case MessageTlvType::Message:
+				_has_message = true;
+				_message = ReadString(value);
+				break;
+
+			case MessageTlvType::Stream:
+				if (ParseBinaryStream(value) == false)
+				{
+					return false;
+				}
+				break;
+
+			case MessageTlvType::Transport: {
+				uint8_t transport = 0;
+				if (ReadValue(value, &transport) && (transport <= static_cast<uint8_t>(Transport::SharedMemory)))
+				{
+					_requested_transport = static_cast<Transport>(transport);
+				}
+				break;
+			}
+
+			case MessageTlvType::DatagramPort:
+				ReadValue(value, &_datagram_port);
+				break;
+
+			case MessageTlvType::DatagramToken:
+				ReadValue(value, &_datagram_token);
+				break;
+
+			case MessageTlvType::SharedMemoryPath:
+				_shared_memory_path = ReadString(value);
+				break;
+
+			case MessageTlvType::SharedMemoryToken:
+				ReadValue(value, &_shared_memory_token);
+				break;
+
+			case MessageTlvType::Event: {
+				uint8_t event = 0;
+
+				if (ReadValue(value, &event) && (event >= static_cast<uint8_t>(StreamEvent::Created)) && (event <= static_cast<uint8_t>(StreamEvent::Deleted)))
+				{
+					_stream_event = static_cast<StreamEvent>(event);
+				}
+				break;
+			}
+
+			default:
+				// Ignore the unknown types for compatibility
+				break;
+		}
+	}
+
+	if (is_truncated)
+	{
+		logte("An invalid control message : TLV is truncated");
+		return false;
+	}
+
+	return true;
+}
+
+bool OvtControlMessage::ParseBinaryStream(const std::shared_ptr<const ov::Data> &value)
+{
+	ov::ByteStream stream(value.get());
+
+	uint8_t type;
+	std::shared_ptr<const ov::Data> item_value;
+	bool is_truncated;
+	bool has_app_name = false;
+	bool has_stream_name = false;
+
+	while (ReadTlv(stream, value, &type, &item_value, &is_truncated))
+	{
+		switch (static_cast<StreamTlvType>(type))
+		{
+			case StreamTlvType::AppName:
+				has_app_name = true;
+				_app_name = ReadString(item_value);
+				break;
+
+			case StreamTlvType::StreamName:
+				has_stream_name = true;
+				_stream_name = ReadString(item_value);
+				break;
+
+			case StreamTlvType::Track: {
+				auto track = ParseBinaryTrack(item_value);
+
+				if (track == nullptr)
+				{
+					logte("Invalid binary track [%zu]", _tracks.size());
+					return false;
+				}
+
+				_tracks.push_back(track);
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	if (is_truncated || (has_app_name == false) || (has_stream_name == false))
+	{
+		logte("Invalid binary payload : stream");
+		return false;
+	}
+
+	_has_stream = true;
+
+	return true;
+}
+
+std::shared_ptr<MediaTrack> OvtControlMessage::ParseBinaryTrack(const std::shared_ptr<const ov::Data> &value)
+{
+	ov::ByteStream stream(value.get());
+
+	uint8_t type;
+	std::shared_ptr<const ov::Data> item_value;
+	bool is_truncated;
+
+	uint32_t id = 0, timebase_num = 0, timebase_den = 0, bitrate = 0;
+	uint8_t codec_id = 0, media_type = 0;
+	uint64_t start_frame_time = 0, last_frame_time = 0;
+	bool has_id = false, has_codec_id = false, has_media_type = false, has_timebase_num = false, has_timebase_den = false;
+
+	// The optional values of the video/audio track
+	uint32_t width = 0, height = 0, sample_rate = 0, layout = 0;
+	uint64_t frame_rate_bits = 0;
+	uint8_t sample_format = 0;
+
+	while (ReadTlv(stream, value, &type, &item_value, &is_truncated))
+	{
+		bool result = true;
+
+		switch (static_cast<TrackTlvType>(type))
+		{
+			case TrackTlvType::Id:
+				result = has_id = ReadValue(item_value, &id);
+				break;
+			case TrackTlvType::CodecId:
+				result = has_codec_id = ReadValue(item_value, &codec_id);
+				break;
+			case TrackTlvType::MediaType:
+				result = has_media_type = ReadValue(item_value, &media_type);
+				break;
+			case TrackTlvType::TimebaseNum:
+				result = has_timebase_num = ReadValue(item_value, &timebase_num);
+				break;
+			case TrackTlvType::TimebaseDen:
+				result = has_timebase_den = ReadValue(item_value, &timebase_den);
+				break;
+			case TrackTlvType::Bitrate:
+				result = ReadValue(item_value, &bitrate);
+				break;
+			case TrackTlvType::StartFrameTime:
+				result = ReadValue(item_value, &start_frame_time);
+				break;
+			case TrackTlvType::LastFrameTime:
+				result = ReadValue(item_value, &last_frame_time);
+				break;
+			case TrackTlvType::FrameRate:
+				result = ReadValue(item_value, &frame_rate_bits);
+				break;
+			case TrackTlvType::Width:
+				result = ReadValue(item_value, &width);
+				break;
+			case TrackTlvType::Height:
+				result = ReadValue(item_value, &height);
+				break;
+			case TrackTlvType::SampleRate:
+				result = ReadValue(item_value, &sample_rate);
+				break;
+			case TrackTlvType::SampleFormat:
+				result = ReadValue(item_value, &sample_format);
+				break;
+			case TrackTlvType::Layout:
+				result = ReadValue(item_value, &layout);
+				break;
+			default:
+				break;
+		}
+
+		if (result == false)
+		{
+			logte("Invalid binary track value : type: %d, length: %zu", type, item_value->GetLength());
+			return nullptr;
+		}
+	}
+
+	if (is_truncated || (has_id == false) || (has_codec_id == false) || (has_media_type == false) ||
+		(has_timebase_num == false) || (has_timebase_den == false))
+	{
+		return nullptr;
+	}
+
+	auto new_track = std::make_shared<MediaTrack>();
+
+	new_track->SetId(id);
+	new_track->SetCodecId(static_cast<common::MediaCodecId>(codec_id));
+	new_track->SetMediaType(static_cast<common::MediaType>(media_type));
+	new_track->SetTimeBase(timebase_num, timebase_den);
+	new_track->SetBitrate(bitrate);
+	new_track->SetStartFrameTime(start_frame_time);
+	new_track->SetLastFrameTime(last_frame_time);
+
+	if (new_track->GetMediaType() == common::MediaType::Video)
+	{
+		double frame_rate;
+		::memcpy(&frame_rate, &frame_rate_bits, sizeof(frame_rate));
+
+		new_track->SetFrameRate(frame_rate);
+		new_track->SetWidth(width);
+		new_track->SetHeight(height);
+	}
+	else if (new_track->GetMediaType() == common::MediaType::Audio)
+	{
+		new_track->SetSampleRate(sample_rate);
+		new_track->GetSample().SetFormat(static_cast<common::AudioSample::Format>(static_cast<int8_t>(sample_format)));
+		new_track->GetChannel().SetLayout(static_cast<common::AudioChannel::Layout>(layout));
+	}
+
+	return new_track;
+}
+
+//--------------------------------------------------------------------
+// Serialize
+//--------------------------------------------------------------------
+std::shared_ptr<ov::Data> OvtControlMessage::SerializeRequest(Format format, uint32_t id, const ov::String &url, Transport transport)
+{
+	if (format == Format::Json)
+	{
+		ov::JsonWriter writer;
+
+		writer.BeginObject()
+			.Member("id", id)
+			.Member("url", url);
+
+		if (transport == Transport::Datagram)
+		{
+			writer.Member("transport", "datagram");
+		}
+		else if (transport == Transport::SharedMemory)
+		{
+			writer.Member("transport", "sharedMemory");
+		}
+
+		writer.EndObject();
+
+		return writer.ToData();
+	}
+
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	if (stream.Write8(OVT_CONTROL_BINARY_MARKER) &&
+		stream.Write8(OVT_CONTROL_BINARY_VERSION) &&
+		WriteTlv32(stream, MessageTlvType::Id, id) &&
+		WriteTlv(stream, MessageTlvType::Url, url) &&
+		((transport == Transport::Connection) || WriteTlv8(stream, MessageTlvType::Transport, static_cast<uint8_t>(transport))))
+	{
+		return data;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ov::Data> OvtControlMessage::SerializeResponse(Format format, uint32_t id, uint32_t code, const ov::String &message, const std::shared_ptr<const ov::Data> &stream_description,
+															   uint16_t datagram_port, uint32_t datagram_token)
+{
+	if (format == Format::Json)
+	{
+		ov::JsonWriter writer;
+
+		writer.BeginObject()
+			.Member("id", id)
+			.Member("code", code)
+			.Member("message", message);
+
+		if (datagram_port != 0)
+		{
+			writer.Member("datagramPort", datagram_port)
+				.Member("datagramToken", datagram_token);
+		}
+
+		if (stream_description != nullptr)
+		{
+			// The description was serialized once (See SerializeStreamDescription()), so it is inserted into the object as is
+			writer.Key("stream").Raw(stream_description);
+		}
+
+		writer.EndObject();
+
+		return writer.ToData();
+	}
+
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	if (stream.Write8(OVT_CONTROL_BINARY_MARKER) &&
+		stream.Write8(OVT_CONTROL_BINARY_VERSION) &&
+		WriteTlv32(stream, MessageTlvType::Id, id) &&
+		WriteTlv32(stream, MessageTlvType::Code, code) &&
+		WriteTlv(stream, MessageTlvType::Message, message) &&
+		((datagram_port == 0) || (WriteTlv16(stream, MessageTlvType::DatagramPort, datagram_port) && WriteTlv32(stream, MessageTlvType::DatagramToken, datagram_token))) &&
+		((stream_description == nullptr) || WriteTlv(stream, MessageTlvType::Stream, stream_description)))
+	{
+		return data;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ov::Data> OvtControlMessage::SerializeResponse(Format format, uint32_t id, uint32_t code, const ov::String &message,
+															   const ov::String &shared_memory_path, uint32_t shared_memory_token)
+{
+	if (format == Format::Json)
+	{
+		ov::JsonWriter writer;
+
+		writer.BeginObject()
+			.Member("id", id)
+			.Member("code", code)
+			.Member("message", message)
+			.Member("sharedMemoryPath", shared_memory_path)
+			.Member("sharedMemoryToken", shared_memory_token)
+			.EndObject();
+
+		return writer.ToData();
+	}
+
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	if (stream.Write8(OVT_CONTROL_BINARY_MARKER) &&
+		stream.Write8(OVT_CONTROL_BINARY_VERSION) &&
+		WriteTlv32(stream, MessageTlvType::Id, id) &&
+		WriteTlv32(stream, MessageTlvType::Code, code) &&
+		WriteTlv(stream, MessageTlvType::Message, message) &&
+		WriteTlv(stream, MessageTlvType::SharedMemoryPath, shared_memory_path) &&
+		WriteTlv32(stream, MessageTlvType::SharedMemoryToken, shared_memory_token))
+	{
+		return data;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ov::Data> OvtControlMessage::SerializeNotification(Format format, StreamEvent event, const std::shared_ptr<const ov::Data> &stream_description)
+{
+	if (format == Format::Json)
+	{
+		ov::JsonWriter writer;
+
+		// The same as SerializeResponse()
+		writer.BeginObject()
+			.Member("event", (event == StreamEvent::Created) ? "created" : "deleted")
+			.Key("stream")
+			.Raw(stream_description)
+			.EndObject();
+
+		return writer.ToData();
+	}
+
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	if (stream.Write8(OVT_CONTROL_BINARY_MARKER) &&
+		stream.Write8(OVT_CONTROL_BINARY_VERSION) &&
+		WriteTlv8(stream, MessageTlvType::Event, static_cast<uint8_t>(event)) &&
+		WriteTlv(stream, MessageTlvType::Stream, stream_description))
+	{
+		return data;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ov::Data> OvtControlMessage::SerializeStreamDescription(Format format, const ov::String &app_name, const ov::String &stream_name, const std::map<int32_t, std::shared_ptr<MediaTrack>> &tracks)
+{
+	if (format == Format::Json)
+	{
+		/*
+		"stream" :
+		{
+			"appName" : "app",
+			"streamName" : "stream_720p",
+			"tracks":
+			[
+				{
+					"id" : 3291291,
+					"codecId" : 32198392,
+					"mediaType" : 0 | 1 | 2, # video | audio | data
+					"timebase_num" : 90000,
+					"timebase_den" : 90000,
+					"bitrate" : 5000000,
+					"startFrameTime" : 1293219321,
+					"lastFrameTime" : 1932193921,
+					"videoTrack" :
+					{
+						"framerate" : 29.97,
+						"width" : 1280,
+						"height" : 720
+					},
+					"audioTrack" :
+					{
+						"samplerate" : 44100,
+						"sampleFormat" : "s16",
+						"layout" : "stereo"
+					}
+				}
+			]
+		}
+		*/
+
+		ov::JsonWriter writer;
+
+		writer.BeginObject()
+			.Member("appName", app_name)
+			.Member("streamName", stream_name);
+
+		// "tracks" must be an array even if there is no track (See JsonHandler)
+		writer.Key("tracks").BeginArray();
+
+		for (auto &track_item : tracks)
+		{
+			auto &track = track_item.second;
+
+			writer.BeginObject()
+				.Member("id", track->GetId())
+				.Member("codecId", static_cast<int8_t>(track->GetCodecId()))
+				.Member("mediaType", static_cast<int8_t>(track->GetMediaType()))
+				.Member("timebase_num", track->GetTimeBase().GetNum())
+				.Member("timebase_den", track->GetTimeBase().GetDen())
+				.Member("bitrate", track->GetBitrate())
+				.Member("startFrameTime", track->GetStartFrameTime())
+				.Member("lastFrameTime", track->GetLastFrameTime());
+
+			writer.Key("videoTrack")
+				.BeginObject()
+				.Member("framerate", track->GetFrameRate())
+				.Member("width", track->GetWidth())
+				.Member("height", track->GetHeight())
+				.EndObject();
+
+			writer.Key("audioTrack")
+				.BeginObject()
+				.Member("samplerate", track->GetSampleRate())
+				.Member("sampleFormat", static_cast<int8_t>(track->GetSample().GetFormat()))
+				.Member("layout", static_cast<uint32_t>(track->GetChannel().GetLayout()))
+				.EndObject();
+
+			writer.EndObject();
+		}
+
+		writer.EndArray()
+			.EndObject();
+
+		return writer.ToData();
+	}
+
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	if ((WriteTlv(stream, StreamTlvType::AppName, app_name) && WriteTlv(stream, StreamTlvType::StreamName, stream_name)) == false)
+	{
+		return nullptr;
+	}
+
+	for (auto &track_item : tracks)
+	{
+		auto &track = track_item.second;
+
+		auto track_data = std::make_shared<ov::Data>();
+		ov::ByteStream track_stream(track_data.get());
+
+		bool result =
+			WriteTlv32(track_stream, TrackTlvType::Id, static_cast<uint32_t>(track->GetId())) &&
+			WriteTlv8(track_stream, TrackTlvType::CodecId, static_cast<uint8_t>(track->GetCodecId())) &&
+			WriteTlv8(track_stream, TrackTlvType::MediaType, static_cast<uint8_t>(track->GetMediaType())) &&
+			WriteTlv32(track_stream, TrackTlvType::TimebaseNum, static_cast<uint32_t>(track->GetTimeBase().GetNum())) &&
+			WriteTlv32(track_stream, TrackTlvType::TimebaseDen, static_cast<uint32_t>(track->GetTimeBase().GetDen())) &&
+			WriteTlv32(track_stream, TrackTlvType::Bitrate, static_cast<uint32_t>(track->GetBitrate())) &&
+			WriteTlv64(track_stream, TrackTlvType::StartFrameTime, static_cast<uint64_t>(track->GetStartFrameTime())) &&
+			WriteTlv64(track_stream, TrackTlvType::LastFrameTime, static_cast<uint64_t>(track->GetLastFrameTime()));
+
+		if (result && (track->GetMediaType() == common::MediaType::Video))
+		{
+			double frame_rate = track->GetFrameRate();
+			uint64_t frame_rate_bits;
+			::memcpy(&frame_rate_bits, &frame_rate, sizeof(frame_rate_bits));
+
+			result = WriteTlv64(track_stream, TrackTlvType::FrameRate, frame_rate_bits) &&
+					 WriteTlv32(track_stream, TrackTlvType::Width, static_cast<uint32_t>(track->GetWidth())) &&
+					 WriteTlv32(track_stream, TrackTlvType::Height, static_cast<uint32_t>(track->GetHeight()));
+		}
+		else if (result && (track->GetMediaType() == common::MediaType::Audio))
+		{
+			result = WriteTlv32(track_stream, TrackTlvType::SampleRate, static_cast<uint32_t>(track->GetSampleRate())) &&
+					 WriteTlv8(track_stream, TrackTlvType::SampleFormat, static_cast<uint8_t>(track->GetSample().GetFormat())) &&
+					 WriteTlv32(track_stream, TrackTlvType::Layout, static_cast<uint32_t>(track->GetChannel().GetLayout()));
+		}
+
+		if ((result && WriteTlv(stream, StreamTlvType::Track, track_data)) == false)
+		{
+			return nullptr;
+		}
+	}
+
+	return data;
+}
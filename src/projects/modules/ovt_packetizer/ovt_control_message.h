@@ -0,0 +1,211 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/info/media_track.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <map>
+
+// The first byte of the binary control message (a JSON message never starts with it)
+#define OVT_CONTROL_BINARY_MARKER 0x00
+#define OVT_CONTROL_BINARY_VERSION 0x01
+
+/***********************************************
+ * Control Message (DESCRIBE/PLAY/STOP requests and responses)
+ ***********************************************
+ The payload of the control message is JSON ({"id", "url"} / {"id", "code", "message", "stream"}) or binary.
+ The origin responds in the format of the request, so the edge negotiates the format with the first request (DESCRIBE) of the connection:
+ the edge sends the binary request first, and if the origin doesn't support it (it responds with a JSON error), the edge uses JSON.
+
+ Binary format:
+ 	Marker (1 byte, 0x00) | Version (1 byte, 0x01) | TLV | TLV | ...
+
+ 	TLV : Type (1 byte) | Length (2 bytes, big endian) | Value (Length bytes)
+ 		The numbers are big endian, and the unknown types are ignored
+
+ 	Message
+ 		0x01 Id (uint32), 0x02 Url (string), 0x03 Code (uint32), 0x04 Message (string), 0x05 Stream (TLVs),
+ 		0x06 Transport (uint8, 1: datagram, 2: shared memory), 0x07 DatagramPort (uint16), 0x08 DatagramToken (uint32),
+ 		0x09 Event (uint8, 1: created, 2: deleted), 0x0A SharedMemoryPath (string), 0x0B SharedMemoryToken (uint32)
+ 	Stream
+ 		0x01 AppName (string), 0x02 StreamName (string), 0x03 Track (TLVs, repeated)
+ 	Track
+ 		0x01 Id (uint32), 0x02 CodecId (uint8), 0x03 MediaType (uint8), 0x04 TimebaseNum (uint32), 0x05 TimebaseDen (uint32),
+ 		0x06 Bitrate (uint32), 0x07 StartFrameTime (uint64), 0x08 LastFrameTime (uint64),
+ 		0x09 FrameRate (IEEE 754 double), 0x0A Width (uint32), 0x0B Height (uint32),
+ 		0x0C SampleRate (uint32), 0x0D SampleFormat (int8), 0x0E Layout (uint32)
+ ***********************************************/
+
+class OvtControlMessage
+{
+public:
+	enum class Format : uint8_t
+	{
+		Json,
+		Binary
+	};
+
+	// How the media packets of PLAY are received (See ovt_packet.h)
+	enum class Transport : uint8_t
+	{
+		// Over the connection of the request
+		Connection = 0,
+		// Over UDP
+		Datagram = 1,
+		// Through the shared memory of the origin on the same host (the frames are not packetized)
+		SharedMemory = 2
+	};
+
+	// The event of NOTIFY (See OVT_PAYLOAD_TYPE_NOTIFY)
+	enum class StreamEvent : uint8_t
+	{
+		None = 0,
+		Created = 1,
+		Deleted = 2
+	};
+
+	// Returns nullptr if the payload is not a valid control message
+	static std::shared_ptr<OvtControlMessage> Parse(const std::shared_ptr<const ov::Data> &payload);
+
+	// transport: How the edge wants to receive the media packets (PLAY, See ovt_packet.h)
+	static std::shared_ptr<ov::Data> SerializeRequest(Format format, uint32_t id, const ov::String &url, Transport transport = Transport::Connection);
+	// stream_description: the result of SerializeStreamDescription() in the same format (nullptr if the response has no stream)
+	// datagram_port/datagram_token: The UDP port of the origin and the token of the session (0 if the media packets are sent over the connection)
+	static std::shared_ptr<ov::Data> SerializeResponse(Format format, uint32_t id, uint32_t code, const ov::String &message, const std::shared_ptr<const ov::Data> &stream_description = nullptr,
+													   uint16_t datagram_port = 0, uint32_t datagram_token = 0);
+	// shared_memory_path/shared_memory_token: The socket that hands the shared memory of the stream over, and the token of the session
+	// (empty if the media packets are not sent through the shared memory)
+	static std::shared_ptr<ov::Data> SerializeResponse(Format format, uint32_t id, uint32_t code, const ov::String &message,
+													   const ov::String &shared_memory_path, uint32_t shared_memory_token);
+	// stream_description: the result of SerializeStreamDescription() in the same format (the tracks are not needed)
+	static std::shared_ptr<ov::Data> SerializeNotification(Format format, StreamEvent event, const std::shared_ptr<const ov::Data> &stream_description);
+	// The description is the same for all describe responses of the stream, so it can be serialized once and reused
+	static std::shared_ptr<ov::Data> SerializeStreamDescription(Format format, const ov::String &app_name, const ov::String &stream_name, const std::map<int32_t, std::shared_ptr<MediaTrack>> &tracks);
+
+	Format GetFormat() const
+	{
+		return _format;
+	}
+
+	// A request has id/url, and a response has id/code/message
+	bool IsValidRequest() const
+	{
+		return _has_id && _has_url;
+	}
+
+	bool IsValidResponse() const
+	{
+		return _has_id && _has_code && _has_message;
+	}
+
+	uint32_t GetId() const
+	{
+		return _id;
+	}
+
+	const ov::String &GetUrl() const
+	{
+		return _url;
+	}
+
+	uint32_t GetCode() const
+	{
+		return _code;
+	}
+
+	const ov::String &GetMessage() const
+	{
+		return _message;
+	}
+
+	Transport GetRequestedTransport() const
+	{
+		return _requested_transport;
+	}
+
+	uint16_t GetDatagramPort() const
+	{
+		return _datagram_port;
+	}
+
+	uint32_t GetDatagramToken() const
+	{
+		return _datagram_token;
+	}
+
+	const ov::String &GetSharedMemoryPath() const
+	{
+		return _shared_memory_path;
+	}
+
+	uint32_t GetSharedMemoryToken() const
+	{
+		return _shared_memory_token;
+	}
+
+	StreamEvent GetStreamEvent() const
+	{
+		return _stream_event;
+	}
+
+	bool HasStream() const
+	{
+		return _has_stream;
+	}
+
+	const ov::String &GetAppName() const
+	{
+		return _app_name;
+	}
+
+	const ov::String &GetStreamName() const
+	{
+		return _stream_name;
+	}
+
+	const std::vector<std::shared_ptr<MediaTrack>> &GetTracks() const
+	{
+		return _tracks;
+	}
+
+private:
+	// Fills the members while the JSON payload is parsed (See ov::JsonReader)
+	class JsonHandler;
+
+	bool ParseJson(const std::shared_ptr<const ov::Data> &payload);
+
+	bool ParseBinary(const std::shared_ptr<const ov::Data> &payload);
+	bool ParseBinaryStream(const std::shared_ptr<const ov::Data> &value);
+	std::shared_ptr<MediaTrack> ParseBinaryTrack(const std::shared_ptr<const ov::Data> &value);
+
+	Format _format = Format::Json;
+
+	bool _has_id = false;
+	uint32_t _id = 0;
+	bool _has_url = false;
+	ov::String _url;
+	bool _has_code = false;
+	uint32_t _code = 0;
+	bool _has_message = false;
+	ov::String _message;
+
+	Transport _requested_transport = Transport::Connection;
+	uint16_t _datagram_port = 0;
+	uint32_t _datagram_token = 0;
+	ov::String _shared_memory_path;
+	uint32_t _shared_memory_token = 0;
+
+	StreamEvent _stream_event = StreamEvent::None;
+
+	bool _has_stream = false;
+	ov::String _app_name;
+	ov::String _stream_name;
+	std::vector<std::shared_ptr<MediaTrack>> _tracks;
+};
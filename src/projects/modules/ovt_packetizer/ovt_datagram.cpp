@@ -0,0 +1,290 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_datagram.h"
+
+#include <base/ovlibrary/byte_io.h>
+
+#define OV_LOG_TAG "OvtDatagram"
+
+//--------------------------------------------------------------------
+// OvtRetransmitHistory
+//--------------------------------------------------------------------
+void OvtRetransmitHistory::Add(uint16_t sequence_number, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+{
+	auto now = std::chrono::steady_clock::now();
+	auto expired_time = now - std::chrono::milliseconds(OVT_DATAGRAM_HISTORY_MSEC);
+
+	std::lock_guard<std::mutex> lock_guard(_entries_mutex);
+
+	if ((_entries.empty() == false) && (static_cast<uint16_t>(_entries.back().sequence_number + 1) != sequence_number))
+	{
+		// The packetizer was restarted
+		_entries.clear();
+	}
+
+	while ((_entries.empty() == false) && ((_entries.front().sent_time < expired_time) || (_entries.size() >= 0xFFFF)))
+	{
+		_entries.pop_front();
+	}
+
+	_entries.push_back({sequence_number, header, payload, now});
+}
+
+bool OvtRetransmitHistory::Find(uint16_t sequence_number, std::shared_ptr<const ov::Data> *header, std::shared_ptr<const ov::Data> *payload) const
+{
+	std::lock_guard<std::mutex> lock_guard(_entries_mutex);
+
+	if (_entries.empty())
+	{
+		return false;
+	}
+
+	size_t index = static_cast<uint16_t>(sequence_number - _entries.front().sequence_number);
+
+	if (index >= _entries.size())
+	{
+		return false;
+	}
+
+	auto &entry = _entries[index];
+
+	*header = entry.header;
+	*payload = entry.payload;
+
+	return true;
+}
+
+//--------------------------------------------------------------------
+// OvtReorderBuffer
+//--------------------------------------------------------------------
+OvtReorderBuffer::OvtReorderBuffer(int deadline_msec)
+	: _deadline(deadline_msec)
+{
+}
+
+bool OvtReorderBuffer::Push(const std::shared_ptr<OvtPacket> &packet)
+{
+	auto now = std::chrono::steady_clock::now();
+
+	if (_is_first_packet)
+	{
+		_is_first_packet = false;
+		// Starts from 0x10000 so that the sequence numbers before the first packet are not negative
+		_next_sequence = 0x10000 + packet->SequenceNumber();
+		_highest_sequence = _next_sequence;
+		_packets.emplace(_next_sequence, packet);
+
+		return true;
+	}
+
+	int64_t sequence = _highest_sequence + static_cast<int16_t>(packet->SequenceNumber() - static_cast<uint16_t>(_highest_sequence));
+
+	if (sequence < _next_sequence)
+	{
+		// Already given up or popped
+		return false;
+	}
+
+	if (sequence > _highest_sequence)
+	{
+		if ((sequence - _highest_sequence) > OVT_DATAGRAM_MAX_REORDER_PACKETS)
+		{
+			// Too many packets are lost (or the origin has been restarted), so it starts over from this packet
+			logtw("Too many packets are lost (%lld), skipping to the sequence number %u", static_cast<long long>(sequence - _highest_sequence - 1), packet->SequenceNumber());
+
+			_lost_count += (sequence - _next_sequence) - _packets.size();
+			_packets.clear();
+			_missing_map.clear();
+			_next_sequence = sequence;
+			_highest_sequence = sequence;
+			_is_discontinuous = true;
+			_packets.emplace(sequence, packet);
+
+			return true;
+		}
+
+		for (auto missing = _highest_sequence + 1; missing < sequence; missing++)
+		{
+			_missing_map[missing].detected_time = now;
+		}
+
+		_highest_sequence = sequence;
+	}
+	else
+	{
+		auto item = _missing_map.find(sequence);
+
+		if (item == _missing_map.end())
+		{
+			// Duplicated
+			return false;
+		}
+
+		if (item->second.is_requested)
+		{
+			_recovered_count++;
+		}
+
+		_missing_map.erase(item);
+	}
+
+	_packets.emplace(sequence, packet);
+
+	return true;
+}
+
+void OvtReorderBuffer::GiveUpUntil(int64_t sequence)
+{
+	_lost_count += (sequence - _next_sequence);
+
+	_missing_map.erase(_missing_map.begin(), _missing_map.lower_bound(sequence));
+
+	_next_sequence = sequence;
+	_is_discontinuous = true;
+}
+
+std::shared_ptr<OvtPacket> OvtReorderBuffer::Pop(bool *is_discontinuous)
+{
+	if (_packets.empty())
+	{
+		return nullptr;
+	}
+
+	auto first = _packets.begin();
+
+	if (first->first != _next_sequence)
+	{
+		// The next packet is lost, it is waited until the deadline
+		auto missing = _missing_map.find(_next_sequence);
+
+		bool is_expired = (missing == _missing_map.end()) ||
+						  ((std::chrono::steady_clock::now() - missing->second.detected_time) >= _deadline) ||
+						  (_packets.size() > OVT_DATAGRAM_MAX_REORDER_PACKETS);
+
+		if (is_expired == false)
+		{
+			return nullptr;
+		}
+
+		GiveUpUntil(first->first);
+	}
+
+	auto packet = first->second;
+	_packets.erase(first);
+	_next_sequence++;
+
+	*is_discontinuous = _is_discontinuous;
+	_is_discontinuous = false;
+
+	return packet;
+}
+
+std::vector<uint16_t> OvtReorderBuffer::GetNackList()
+{
+	std::vector<uint16_t> nack_list;
+
+	auto now = std::chrono::steady_clock::now();
+	auto nack_interval = std::chrono::milliseconds(OVT_DATAGRAM_NACK_INTERVAL_MSEC);
+
+	for (auto &item : _missing_map)
+	{
+		auto &missing = item.second;
+
+		if ((now - missing.detected_time) >= _deadline)
+		{
+			// It will be given up
+			continue;
+		}
+
+		if (missing.is_requested && ((now - missing.last_nack_time) < nack_interval))
+		{
+			continue;
+		}
+
+		missing.is_requested = true;
+		missing.last_nack_time = now;
+
+		nack_list.push_back(static_cast<uint16_t>(item.first));
+	}
+
+	return nack_list;
+}
+
+void OvtReorderBuffer::Reset()
+{
+	_is_first_packet = true;
+	_is_discontinuous = false;
+	_packets.clear();
+	_missing_map.clear();
+}
+
+//--------------------------------------------------------------------
+// OvtNack
+//--------------------------------------------------------------------
+std::shared_ptr<ov::Data> OvtNack::Serialize(uint32_t token, const std::vector<uint16_t> &sequence_numbers)
+{
+	auto data = std::make_shared<ov::Data>();
+	ov::ByteStream stream(data.get());
+
+	stream.WriteBE32(token);
+
+	// sequence_numbers are in ascending order (See OvtReorderBuffer::GetNackList())
+	size_t index = 0;
+
+	while (index < sequence_numbers.size())
+	{
+		uint16_t pid = sequence_numbers[index++];
+		uint16_t blp = 0;
+
+		while (index < sequence_numbers.size())
+		{
+			uint16_t distance = sequence_numbers[index] - pid;
+
+			if ((distance == 0) || (distance > 16))
+			{
+				break;
+			}
+
+			blp |= (1 << (distance - 1));
+			index++;
+		}
+
+		stream.WriteBE16(pid);
+		stream.WriteBE16(blp);
+	}
+
+	return data;
+}
+
+bool OvtNack::Parse(const uint8_t *payload, size_t length, uint32_t *token, std::vector<uint16_t> *sequence_numbers)
+{
+	if ((length < sizeof(uint32_t)) || (((length - sizeof(uint32_t)) % (sizeof(uint16_t) * 2)) != 0))
+	{
+		return false;
+	}
+
+	*token = ByteReader<uint32_t>::ReadBigEndian(payload);
+
+	for (size_t offset = sizeof(uint32_t); offset < length; offset += sizeof(uint16_t) * 2)
+	{
+		uint16_t pid = ByteReader<uint16_t>::ReadBigEndian(&payload[offset]);
+		uint16_t blp = ByteReader<uint16_t>::ReadBigEndian(&payload[offset + sizeof(uint16_t)]);
+
+		sequence_numbers->push_back(pid);
+
+		for (int bit = 0; bit < 16; bit++)
+		{
+			if (blp & (1 << bit))
+			{
+				sequence_numbers->push_back(static_cast<uint16_t>(pid + bit + 1));
+			}
+		}
+	}
+
+	return true;
+}
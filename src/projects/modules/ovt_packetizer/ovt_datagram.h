@@ -0,0 +1,120 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include "ovt_packet.h"
+
+// How long the origin keeps the sent packets to retransmit them
+#define OVT_DATAGRAM_HISTORY_MSEC 1000
+// The default time the edge waits for a lost packet before giving up the frame
+#define OVT_DATAGRAM_DEFAULT_DEADLINE_MSEC 300
+// A lost packet is requested again at this interval until the deadline
+#define OVT_DATAGRAM_NACK_INTERVAL_MSEC 40
+// The edge sends BIND at this interval until the first media packet is received, and then as a keep-alive
+#define OVT_DATAGRAM_BIND_INTERVAL_MSEC 100
+#define OVT_DATAGRAM_KEEPALIVE_INTERVAL_MSEC 1000
+// If the gap is larger than this, the edge doesn't wait for the lost packets
+#define OVT_DATAGRAM_MAX_REORDER_PACKETS 4096
+
+// The packets that were sent recently (origin), the edges request the lost packets with NACK
+//
+// The sequence numbers of the packets of a stream are continuous, so a packet is found without a search
+class OvtRetransmitHistory
+{
+public:
+	void Add(uint16_t sequence_number, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
+
+	// Returns false if the packet is not in the history (expired)
+	// payload is nullptr if the payload is in the header (See OvtPacket::GetPayloadData())
+	bool Find(uint16_t sequence_number, std::shared_ptr<const ov::Data> *header, std::shared_ptr<const ov::Data> *payload) const;
+
+private:
+	struct Entry
+	{
+		uint16_t sequence_number;
+		std::shared_ptr<const ov::Data> header;
+		std::shared_ptr<const ov::Data> payload;
+		std::chrono::steady_clock::time_point sent_time;
+	};
+
+	mutable std::mutex _entries_mutex;
+	std::deque<Entry> _entries;
+};
+
+// Reorders the datagrams received by the edge, and finds the lost packets
+//
+// The lost packets are requested (GetNackList()) until the deadline, and after that, they are given up.
+// The packets of the frames that have a lost packet cannot be depacketized, so the caller must discard the partial frame
+// when Pop() reports the discontinuity.
+class OvtReorderBuffer
+{
+public:
+	explicit OvtReorderBuffer(int deadline_msec = OVT_DATAGRAM_DEFAULT_DEADLINE_MSEC);
+
+	// Returns false if the packet is a duplicate or arrived after the deadline
+	bool Push(const std::shared_ptr<OvtPacket> &packet);
+
+	// Returns the next packet in the order of sequence number (nullptr if it hasn't been received)
+	// is_discontinuous: true if the packets before the returned packet are lost
+	std::shared_ptr<OvtPacket> Pop(bool *is_discontinuous);
+
+	// The sequence numbers of the lost packets to be requested now
+	std::vector<uint16_t> GetNackList();
+
+	void Reset();
+
+	uint64_t GetLostCount() const
+	{
+		return _lost_count;
+	}
+
+	uint64_t GetRecoveredCount() const
+	{
+		return _recovered_count;
+	}
+
+private:
+	struct Missing
+	{
+		std::chrono::steady_clock::time_point detected_time;
+		std::chrono::steady_clock::time_point last_nack_time;
+		bool is_requested = false;
+	};
+
+	void GiveUpUntil(int64_t sequence);
+
+	std::chrono::milliseconds _deadline;
+
+	// The sequence numbers are extended to 64 bits to handle the wrap-around
+	bool _is_first_packet = true;
+	int64_t _next_sequence = 0;
+	int64_t _highest_sequence = 0;
+	bool _is_discontinuous = false;
+
+	std::map<int64_t, std::shared_ptr<OvtPacket>> _packets;
+	std::map<int64_t, Missing> _missing_map;
+
+	uint64_t _lost_count = 0;
+	uint64_t _recovered_count = 0;
+};
+
+// NACK payload: Token (4 bytes) | { PID (2 bytes) | BLP (2 bytes) } ...
+// PID is the sequence number of a lost packet, and the bit i of BLP means that PID + i + 1 is also lost (RFC 4585 Generic NACK)
+class OvtNack
+{
+public:
+	static std::shared_ptr<ov::Data> Serialize(uint32_t token, const std::vector<uint16_t> &sequence_numbers);
+	static bool Parse(const uint8_t *payload, size_t length, uint32_t *token, std::vector<uint16_t> *sequence_numbers);
+};
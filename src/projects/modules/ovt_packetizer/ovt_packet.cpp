@@ -148,7 +148,7 @@ const uint8_t* OvtPacket::Payload()
 
 uint32_t OvtPacket::PacketSize()
 {
-	return OVT_DEFAULT_MAX_PACKET_SIZE + PayloadLength();
+	return OVT_FIXED_HEADER_SIZE + PayloadLength();
 }
 
 const uint8_t* OvtPacket::GetBuffer()
@@ -161,6 +161,11 @@ const std::shared_ptr<ov::Data>& OvtPacket::GetData()
 	return _data;
 }
 
+const std::shared_ptr<const ov::Data>& OvtPacket::GetPayloadData()
+{
+	return _payload_data;
+}
+
 void OvtPacket::SetMarker(bool marker_bit)
 {
 	_marker = marker_bit;
@@ -210,24 +215,49 @@ void OvtPacket::SetPayloadLength(size_t payload_length)
 {
 	_payload_length = payload_length;
 	ByteWriter<uint16_t>::WriteBigEndian(&_buffer[16], _payload_length);
+}
 
+bool OvtPacket::SetPayload(const uint8_t *payload, size_t payload_length)
+{
+	if(OVT_FIXED_HEADER_SIZE + payload_length > OVT_MAX_PACKET_SIZE)
+	{
+		OV_ASSERT(false, "Payload must be less than %d (payload : %zu)", OVT_MAX_PACKET_SIZE - OVT_FIXED_HEADER_SIZE, payload_length);
+		return false;
+	}
+
+	// The buffer may be reallocated
 	_data->SetLength(OVT_FIXED_HEADER_SIZE + payload_length);
+	_buffer = _data->GetWritableDataAs<uint8_t>();
+	_payload_data = nullptr;
+
+	SetPayloadLength(payload_length);
+	memcpy(&_buffer[OVT_FIXED_HEADER_SIZE], payload, payload_length);
+
+	_is_packet_available = true;
+
+	return true;
 }
 
-bool OvtPacket::SetPayload(const uint8_t *payload, size_t payload_length)
+bool OvtPacket::SetPayload(const std::shared_ptr<const ov::Data> &payload, const uint8_t *prefix, size_t prefix_length)
 {
-	if(OVT_FIXED_HEADER_SIZE + payload_length > _data->GetCapacity())
+	size_t payload_length = prefix_length + payload->GetLength();
+
+	if(OVT_FIXED_HEADER_SIZE + payload_length > OVT_MAX_PACKET_SIZE)
 	{
-		OV_ASSERT(false, "Data capacity must be greater than %ld (packet : %ld)",
-				_data->GetCapacity(), OVT_FIXED_HEADER_SIZE + payload_length);
+		OV_ASSERT(false, "Payload must be less than %d (payload : %zu)", OVT_MAX_PACKET_SIZE - OVT_FIXED_HEADER_SIZE, payload_length);
 		return false;
 	}
 
+	_data->SetLength(OVT_FIXED_HEADER_SIZE + prefix_length);
+	_buffer = _data->GetWritableDataAs<uint8_t>();
+	_payload_data = payload;
+
 	SetPayloadLength(payload_length);
 
-	// OVT_DEFAULT_MAX_PACKET_SIZE
-	//_data->SetLength(_payload_length);
-	memcpy(&_buffer[OVT_FIXED_HEADER_SIZE], payload, payload_length);
+	if(prefix_length > 0)
+	{
+		memcpy(&_buffer[OVT_FIXED_HEADER_SIZE], prefix, prefix_length);
+	}
 
 	_is_packet_available = true;
 
@@ -154,16 +154,90 @@
 			"message" : "ok" | "app/stream not found" | "Internal Server Error",
 		}
 
+ [3] DATAGRAM (optional)
+ The media packets can be sent over UDP instead of the connection, so a lost packet doesn't stall all tracks on a lossy link.
+ The control messages are still sent over the connection.
+
+ <C->S> PLAY request has "transport" : "datagram"
+ <S->C> PLAY response has "datagramPort" : <UDP port of the origin>, "datagramToken" : <random token of the session>
+ 		(If the origin doesn't support it, the response doesn't have them, and the media packets are sent over the connection)
+
+ <C->S> (UDP) until the first media packet is received, and then periodically as a keep-alive
+ 	PT : DATAGRAM_BIND (14)
+ 	SI : 11992
+ 	Payload : Token (4 bytes)
+ 		The origin sends the media packets (one packet per datagram) to the address of the datagram,
+ 		and it must be from the IP address of the connection.
+
+ <C->S> (UDP)
+ 	PT : NACK (15)
+ 	SI : 11992
+ 	Payload : Token (4 bytes) | { PID (2 bytes) | BLP (2 bytes) } ... (See OvtNack)
+ 		The origin retransmits the requested packets if they are still in the history.
+ 		The edge gives up the lost packets after the deadline, and discards the frames that have them.
+
+ [4] SUBSCRIBE (optional)
+ The edge is notified of the streams of an application, so it can pull them before the first viewer arrives.
+ The connection is used only for the notifications (no DESCRIBE/PLAY).
+
+ <C->S>
+ 	PT : SUBSCRIBE (16)
+ 	SI : 0
+ 	Payload :
+ 		{
+ 			"id": 3921933
+ 			"url": "ovt://host:port/app"
+ 		}
+
+ <S->C>
+ 	PT : SUBSCRIBE (16)
+ 	Payload : { "id", "code", "message" } (the same as the other responses)
+
+ <S->C> for each stream of the app after the response, and whenever a stream is created or deleted
+ 	PT : NOTIFY (17)
+ 	SI : 0
+ 	Payload :
+ 		{
+ 			"event" : "created" | "deleted",
+ 			"stream" : { "appName", "streamName", "tracks" : [] }
+ 		}
+
+ [5] MULTIPLEXING (optional)
+ The edge may pull many streams over a connection (See <Providers><OVT><MultiplexConnections>).
+ Nothing is changed in the protocol: the edge sends DESCRIBE/PLAY/STOP of the streams over the same connection one after another,
+ and the media packets of the streams are interleaved, they are routed to the streams by SI of the PLAY responses.
+ A STOP ends only the session of SI, and all the sessions of the connection are ended when it is closed.
+
+ [6] LATE FRAMES
+ When the connection is congested, the origin sends the whole frames of a session in the order of
+ audio > video key frame > video delta frame (the packets of a frame are always contiguous),
+ and skips the late delta frames (See <Publishers><OVT><LateFrameDeadline>).
+ After a skip, the next frame of the video track is always a key frame, so the edge resumes the track without waiting for the lost ones.
+
+ [7] SHARED MEMORY
+When the edge runs on the same host as the origin (<Providers><OVT><SharedMemory>), it requests PLAY with
+"transport": "sharedMemory" (TLV 0x09 = 2). The origin that listens on <Bind><Publishers><OVT><SharedMemoryPath> grants it
+to the edges connected over the loopback, and responds with the path and a token (TLV 0x0A/0x0B).
+The edge connects to the path with the token, and receives a memfd of the frames of the stream (See OvtSharedMemoryServer).
+The frames are written to it once for all the edges, and they are not sent over the connection of the session.
+The other origins ignore the transport, and the edge receives the packets over the connection.
+
  **********************************************/
 
 
 #define OVT_VERSION							1
 #define OVT_FIXED_HEADER_SIZE				18
 #define OVT_DEFAULT_MAX_PACKET_SIZE			1316
+// The payload length field is 16 bits
+#define OVT_MAX_PACKET_SIZE					(OVT_FIXED_HEADER_SIZE + 0xFFFF)
 
 #define OVT_PAYLOAD_TYPE_DESCRIBE			11
 #define OVT_PAYLOAD_TYPE_PLAY				12
 #define OVT_PAYLOAD_TYPE_STOP				13
+#define OVT_PAYLOAD_TYPE_DATAGRAM_BIND		14
+#define OVT_PAYLOAD_TYPE_NACK				15
+#define OVT_PAYLOAD_TYPE_SUBSCRIBE			16
+#define OVT_PAYLOAD_TYPE_NOTIFY				17
 
 #define OVT_PAYLOAD_TYPE_ERROR				20
 
@@ -204,9 +278,15 @@ public:
 	void 		SetSessionId(uint32_t session_id);
 
 	bool 		SetPayload(const uint8_t *payload, size_t payload_size);
+	// Sets the payload without copying it. GetData() has the header followed by the prefix (copied),
+	// and GetPayloadData() has the rest of the payload, so the packet must be sent as GetData() + GetPayloadData().
+	// Payload() returns the prefix only.
+	bool 		SetPayload(const std::shared_ptr<const ov::Data> &payload, const uint8_t *prefix = nullptr, size_t prefix_size = 0);
 
 	const uint8_t* GetBuffer();
 	const std::shared_ptr<ov::Data>& GetData();
+	// nullptr if the payload is copied into GetData()
+	const std::shared_ptr<const ov::Data>& GetPayloadData();
 
 private:
 	void 		SetPayloadLength(size_t payload_length);
@@ -223,4 +303,5 @@ private:
 
 	uint8_t *					_buffer;
 	std::shared_ptr<ov::Data>	_data;
+	std::shared_ptr<const ov::Data>	_payload_data;
 };
@@ -5,10 +5,16 @@
 #include <base/ovlibrary/byte_io.h>
 #include "ovt_packetizer.h"
 
-OvtPacketizer::OvtPacketizer(const std::shared_ptr<OvtPacketizerInterface> &stream)
+#include <algorithm>
+
+OvtPacketizer::OvtPacketizer(const std::shared_ptr<OvtPacketizerInterface> &stream, size_t max_packet_size)
 {
 	_stream = stream;
 	_sequence_number = 0;
+
+	// The first packet must be able to have the MediaPacket header
+	max_packet_size = std::clamp<size_t>(max_packet_size, OVT_FIXED_HEADER_SIZE + MEDIA_PACKET_HEADER_SIZE + 1, OVT_MAX_PACKET_SIZE);
+	_max_payload_size = max_packet_size - OVT_FIXED_HEADER_SIZE;
 }
 
 OvtPacketizer::~OvtPacketizer()
@@ -50,49 +56,47 @@ bool OvtPacketizer::Packetize(uint64_t timestamp, const std::shared_ptr<MediaPac
 
 	 *********************************************************************/
 
-	ov::Data payload;
-
-	// Header + Data
-	payload.SetLength(MEDIA_PACKET_HEADER_SIZE + media_packet->GetData()->GetLength());
-
-	auto buffer = payload.GetWritableDataAs<uint8_t>();
-
-	ByteWriter<uint32_t>::WriteBigEndian(&buffer[0], media_packet->GetTrackId());
-	ByteWriter<uint64_t>::WriteBigEndian(&buffer[4], media_packet->GetPts());
-	ByteWriter<uint64_t>::WriteBigEndian(&buffer[12], media_packet->GetDts());
-	ByteWriter<uint64_t>::WriteBigEndian(&buffer[20], media_packet->GetDuration());
-	ByteWriter<uint8_t>::WriteBigEndian(&buffer[28], static_cast<int8_t>(media_packet->GetMediaType()));
-	ByteWriter<uint8_t>::WriteBigEndian(&buffer[29], static_cast<int8_t>(media_packet->GetFlag()));
-	ByteWriter<uint32_t>::WriteBigEndian(&buffer[30], media_packet->GetData()->GetLength());
+	uint8_t header[MEDIA_PACKET_HEADER_SIZE];
+	// The payloads of the packets are the slices of the frame (not copied),
+	// and only the MediaPacket header is copied into the first packet
+	auto frame = std::static_pointer_cast<const MediaPacket>(media_packet)->GetData();
 
-	memcpy(&buffer[34], media_packet->GetData()->GetData(), media_packet->GetData()->GetLength());
+	ByteWriter<uint32_t>::WriteBigEndian(&header[0], media_packet->GetTrackId());
+	ByteWriter<uint64_t>::WriteBigEndian(&header[4], media_packet->GetPts());
+	ByteWriter<uint64_t>::WriteBigEndian(&header[12], media_packet->GetDts());
+	ByteWriter<uint64_t>::WriteBigEndian(&header[20], media_packet->GetDuration());
+	ByteWriter<uint8_t>::WriteBigEndian(&header[28], static_cast<int8_t>(media_packet->GetMediaType()));
+	ByteWriter<uint8_t>::WriteBigEndian(&header[29], static_cast<int8_t>(media_packet->GetFlag()));
+	ByteWriter<uint32_t>::WriteBigEndian(&header[30], frame->GetLength());
 
-	size_t max_payload_size = OVT_DEFAULT_MAX_PACKET_SIZE - OVT_FIXED_HEADER_SIZE;
-	size_t remain_payload_len = payload.GetLength();
+	size_t remain_payload_len = MEDIA_PACKET_HEADER_SIZE + frame->GetLength();
 	size_t offset = 0;
+	bool is_first_packet = true;
 
 	while(remain_payload_len != 0)
 	{
 		// Serialize
-		auto packet = std::make_shared<OvtPacket>();;
+		auto packet = std::make_shared<OvtPacket>();
 		// Session ID should be set in Session Level
 		packet->SetSessionId(0);
 		packet->SetPayloadType(OVT_PAYLOAD_TYPE_MEDIA_PACKET);
 		packet->SetMarker(0);
 		packet->SetTimestamp(timestamp);
 
-		if(remain_payload_len > max_payload_size)
-		{
-			packet->SetPayload(&buffer[offset], max_payload_size);
-			offset += max_payload_size;
-			remain_payload_len -= max_payload_size;
-		}
-		else
+		size_t payload_len = std::min(remain_payload_len, _max_payload_size);
+		size_t prefix_len = is_first_packet ? MEDIA_PACKET_HEADER_SIZE : 0;
+		size_t slice_len = payload_len - prefix_len;
+
+		packet->SetPayload(frame->Subdata(offset, slice_len), is_first_packet ? header : nullptr, prefix_len);
+
+		offset += slice_len;
+		remain_payload_len -= payload_len;
+		is_first_packet = false;
+
+		if(remain_payload_len == 0)
 		{
 			// The last packet of group has marker bit.
 			packet->SetMarker(true);
-			packet->SetPayload(&buffer[offset], remain_payload_len);
-			remain_payload_len = 0;
 		}
 
 		packet->SetSequenceNumber(_sequence_number++);
@@ -7,7 +7,8 @@
 class OvtPacketizer
 {
 public:
-	OvtPacketizer(const std::shared_ptr<OvtPacketizerInterface> &stream);
+	// max_packet_size: The size of the OVT packet including the header (up to OVT_MAX_PACKET_SIZE)
+	OvtPacketizer(const std::shared_ptr<OvtPacketizerInterface> &stream, size_t max_packet_size = OVT_DEFAULT_MAX_PACKET_SIZE);
 	~OvtPacketizer();
 
 	// Packetizing the MediaPacket
@@ -17,5 +18,6 @@ public:
 
 private:
 	uint16_t 									_sequence_number;
+	size_t										_max_payload_size;
 	std::shared_ptr<OvtPacketizerInterface> 	_stream;
 };
@@ -0,0 +1,581 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_shared_memory.h"
+
+#include <base/ovlibrary/byte_io.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#define OV_LOG_TAG "OvtSharedMemory"
+
+#define OVT_SHARED_MEMORY_MAGIC 0x4F565453  // "OVTS"
+#define OVT_SHARED_MEMORY_VERSION 1
+// The stop flag is checked at this interval while waiting for the connections
+#define OVT_SHARED_MEMORY_ACCEPT_INTERVAL_MSEC 100
+
+#if !defined(MFD_CLOEXEC)
+#	define MFD_CLOEXEC 0x0001U
+#	define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+#if !defined(F_ADD_SEALS)
+#	define F_ADD_SEALS (1024 + 9)
+#	define F_SEAL_SHRINK 0x0002
+#	define F_SEAL_GROW 0x0004
+#endif
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The atomic variables in the shared memory must be lock-free");
+
+struct OvtSharedMemoryRing::Header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slot_count;
+	uint32_t reserved;
+	uint64_t data_size;
+
+	// The number of the frames written
+	alignas(64) std::atomic<uint64_t> write_sequence;
+	// The data before this position may be overwritten
+	std::atomic<uint64_t> valid_position;
+	// The sequence of the latest video key frame (UINT64_MAX if there is no key frame yet)
+	std::atomic<uint64_t> key_frame_sequence;
+};
+
+struct OvtSharedMemoryRing::Slot
+{
+	// sequence + 1 after the slot is written, 0 while it is being written
+	std::atomic<uint64_t> sequence;
+
+	uint64_t position;
+	uint32_t length;
+	int32_t track_id;
+	int64_t pts;
+	int64_t dts;
+	int64_t duration;
+	uint8_t media_type;
+	uint8_t flag;
+	uint8_t reserved[6];
+};
+
+//====================================================================================================
+// OvtSharedMemoryRing
+//====================================================================================================
+std::shared_ptr<OvtSharedMemoryRing> OvtSharedMemoryRing::Create(const ov::String &name)
+{
+	auto ring = std::shared_ptr<OvtSharedMemoryRing>(new OvtSharedMemoryRing());
+
+	// glibc may not have memfd_create()
+	ring->_file_descriptor = static_cast<int>(::syscall(SYS_memfd_create, name.CStr(), MFD_CLOEXEC | MFD_ALLOW_SEALING));
+
+	if (ring->_file_descriptor == -1)
+	{
+		logte("Could not create the shared memory (%s): %s", name.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	ring->_memory_size = sizeof(Header) + (sizeof(Slot) * OVT_SHARED_MEMORY_SLOT_COUNT) + OVT_SHARED_MEMORY_DATA_SIZE;
+
+	if (::ftruncate(ring->_file_descriptor, ring->_memory_size) != 0)
+	{
+		logte("Could not allocate the shared memory (%s, %zu bytes): %s", name.CStr(), ring->_memory_size, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	// The edges cannot resize the memory that the origin writes to (it would raise SIGBUS in the origin)
+	::fcntl(ring->_file_descriptor, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+
+	if (ring->MapMemory(true) == false)
+	{
+		return nullptr;
+	}
+
+	auto header = ring->_header;
+
+	header->magic = OVT_SHARED_MEMORY_MAGIC;
+	header->version = OVT_SHARED_MEMORY_VERSION;
+	header->slot_count = OVT_SHARED_MEMORY_SLOT_COUNT;
+	header->data_size = OVT_SHARED_MEMORY_DATA_SIZE;
+	header->write_sequence.store(0, std::memory_order_relaxed);
+	header->valid_position.store(0, std::memory_order_relaxed);
+	header->key_frame_sequence.store(UINT64_MAX, std::memory_order_release);
+
+	return ring;
+}
+
+std::shared_ptr<OvtSharedMemoryRing> OvtSharedMemoryRing::Map(int file_descriptor)
+{
+	auto ring = std::shared_ptr<OvtSharedMemoryRing>(new OvtSharedMemoryRing());
+	ring->_file_descriptor = file_descriptor;
+
+	struct stat file_stat;
+
+	if ((::fstat(file_descriptor, &file_stat) != 0) || (static_cast<size_t>(file_stat.st_size) < sizeof(Header)))
+	{
+		logte("Invalid shared memory: could not get the size");
+		return nullptr;
+	}
+
+	ring->_memory_size = file_stat.st_size;
+
+	if (ring->MapMemory(false) == false)
+	{
+		return nullptr;
+	}
+
+	auto header = ring->_header;
+
+	if ((header->magic != OVT_SHARED_MEMORY_MAGIC) || (header->version != OVT_SHARED_MEMORY_VERSION) || (header->slot_count == 0) ||
+		(ring->_memory_size != (sizeof(Header) + (sizeof(Slot) * header->slot_count) + header->data_size)))
+	{
+		logte("Invalid shared memory: magic: %08X, version: %u", header->magic, header->version);
+		return nullptr;
+	}
+
+	return ring;
+}
+
+OvtSharedMemoryRing::~OvtSharedMemoryRing()
+{
+	if (_memory != nullptr)
+	{
+		::munmap(_memory, _memory_size);
+	}
+
+	if (_file_descriptor != -1)
+	{
+		::close(_file_descriptor);
+	}
+}
+
+bool OvtSharedMemoryRing::MapMemory(bool is_writable)
+{
+	// The edges map the memory read-only, so they cannot break the frames of the other edges
+	auto memory = ::mmap(nullptr, _memory_size, is_writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, _file_descriptor, 0);
+
+	if (memory == MAP_FAILED)
+	{
+		logte("Could not map the shared memory (%zu bytes): %s", _memory_size, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return false;
+	}
+
+	_memory = memory;
+	_header = static_cast<Header *>(memory);
+	_slots = reinterpret_cast<Slot *>(static_cast<uint8_t *>(memory) + sizeof(Header));
+	// The header of the edge is validated after it is mapped (See Map())
+	_data = reinterpret_cast<uint8_t *>(_slots + (is_writable ? OVT_SHARED_MEMORY_SLOT_COUNT : _header->slot_count));
+
+	return true;
+}
+
+bool OvtSharedMemoryRing::Write(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	auto data = media_packet->GetData();
+	size_t length = data->GetLength();
+
+	if (length > OVT_SHARED_MEMORY_MAX_FRAME_SIZE)
+	{
+		logtw("The frame is too large to be shared: %zu bytes (track: %d)", length, media_packet->GetTrackId());
+		return false;
+	}
+
+	// A frame is not split at the end of the data
+	uint64_t position = _write_position;
+	auto offset = position % OVT_SHARED_MEMORY_DATA_SIZE;
+
+	if ((offset + length) > OVT_SHARED_MEMORY_DATA_SIZE)
+	{
+		position += OVT_SHARED_MEMORY_DATA_SIZE - offset;
+		offset = 0;
+	}
+
+	uint64_t end_position = position + length;
+	auto sequence = _header->write_sequence.load(std::memory_order_relaxed);
+	auto &slot = _slots[sequence % OVT_SHARED_MEMORY_SLOT_COUNT];
+
+	// The readers find that the frames are overwritten by these before the data is changed
+	if (end_position > OVT_SHARED_MEMORY_DATA_SIZE)
+	{
+		_header->valid_position.store(end_position - OVT_SHARED_MEMORY_DATA_SIZE, std::memory_order_relaxed);
+	}
+
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	::memcpy(_data + offset, data->GetData(), length);
+
+	slot.position = position;
+	slot.length = static_cast<uint32_t>(length);
+	slot.track_id = media_packet->GetTrackId();
+	slot.pts = media_packet->GetPts();
+	slot.dts = media_packet->GetDts();
+	slot.duration = media_packet->GetDuration();
+	slot.media_type = static_cast<uint8_t>(media_packet->GetMediaType());
+	slot.flag = static_cast<uint8_t>(media_packet->GetFlag());
+
+	slot.sequence.store(sequence + 1, std::memory_order_release);
+
+	if ((media_packet->GetMediaType() == common::MediaType::Video) && (media_packet->GetFlag() == MediaPacketFlag::Key))
+	{
+		_header->key_frame_sequence.store(sequence, std::memory_order_release);
+	}
+
+	_header->write_sequence.store(sequence + 1, std::memory_order_release);
+
+	_write_position = end_position;
+
+	return true;
+}
+
+uint64_t OvtSharedMemoryRing::GetStartSequence() const
+{
+	auto write_sequence = _header->write_sequence.load(std::memory_order_acquire);
+	auto key_frame_sequence = _header->key_frame_sequence.load(std::memory_order_acquire);
+
+	if ((key_frame_sequence < write_sequence) && ((write_sequence - key_frame_sequence) < _header->slot_count))
+	{
+		return key_frame_sequence;
+	}
+
+	return write_sequence;
+}
+
+OvtSharedMemoryRing::ReadResult OvtSharedMemoryRing::Read(uint64_t *sequence, std::shared_ptr<MediaPacket> *media_packet) const
+{
+	auto write_sequence = _header->write_sequence.load(std::memory_order_acquire);
+
+	if (*sequence >= write_sequence)
+	{
+		return ReadResult::Empty;
+	}
+
+	auto expected_sequence = *sequence + 1;
+	auto &slot = _slots[*sequence % _header->slot_count];
+
+	if (((write_sequence - *sequence) <= _header->slot_count) && (slot.sequence.load(std::memory_order_acquire) == expected_sequence))
+	{
+		auto position = slot.position;
+		auto length = slot.length;
+		auto offset = position % _header->data_size;
+
+		if ((position >= _header->valid_position.load(std::memory_order_acquire)) && ((offset + length) <= _header->data_size))
+		{
+			auto packet = std::make_shared<MediaPacket>(static_cast<common::MediaType>(slot.media_type), slot.track_id,
+														_data + offset, static_cast<int32_t>(length),
+														slot.pts, slot.dts, slot.duration, static_cast<MediaPacketFlag>(slot.flag));
+
+			// The frame is valid if the writer has not started to overwrite it while it was copied
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if ((slot.sequence.load(std::memory_order_relaxed) == expected_sequence) &&
+				(position >= _header->valid_position.load(std::memory_order_relaxed)))
+			{
+				*sequence = expected_sequence;
+				*media_packet = std::move(packet);
+
+				return ReadResult::Frame;
+			}
+		}
+	}
+
+	*sequence = GetStartSequence();
+
+	return ReadResult::Lost;
+}
+
+//====================================================================================================
+// OvtSharedMemoryServer
+//====================================================================================================
+static bool SendWithDescriptor(int socket, const void *data, size_t length, int file_descriptor)
+{
+	struct iovec buffer = {const_cast<void *>(data), length};
+	struct msghdr message = {};
+
+	message.msg_iov = &buffer;
+	message.msg_iovlen = 1;
+
+	alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+
+	if (file_descriptor != -1)
+	{
+		::memset(control, 0, sizeof(control));
+
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		auto control_message = CMSG_FIRSTHDR(&message);
+		control_message->cmsg_level = SOL_SOCKET;
+		control_message->cmsg_type = SCM_RIGHTS;
+		control_message->cmsg_len = CMSG_LEN(sizeof(int));
+		::memcpy(CMSG_DATA(control_message), &file_descriptor, sizeof(int));
+	}
+
+	return ::sendmsg(socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(length);
+}
+
+// file_descriptor is -1 if no descriptor is received
+static bool ReceiveWithDescriptor(int socket, void *data, size_t length, int *file_descriptor)
+{
+	struct iovec buffer = {data, length};
+	struct msghdr message = {};
+
+	message.msg_iov = &buffer;
+	message.msg_iovlen = 1;
+
+	alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+
+	*file_descriptor = -1;
+
+	if (::recvmsg(socket, &message, MSG_CMSG_CLOEXEC | MSG_WAITALL) != static_cast<ssize_t>(length))
+	{
+		return false;
+	}
+
+	for (auto control_message = CMSG_FIRSTHDR(&message); control_message != nullptr; control_message = CMSG_NXTHDR(&message, control_message))
+	{
+		if ((control_message->cmsg_level == SOL_SOCKET) && (control_message->cmsg_type == SCM_RIGHTS))
+		{
+			::memcpy(file_descriptor, CMSG_DATA(control_message), sizeof(int));
+		}
+	}
+
+	return true;
+}
+
+static bool MakeUnixAddress(const ov::String &path, struct sockaddr_un *address)
+{
+	::memset(address, 0, sizeof(*address));
+	address->sun_family = AF_UNIX;
+
+	if (path.GetLength() >= sizeof(address->sun_path))
+	{
+		logte("The path of the shared memory socket is too long: %s", path.CStr());
+		return false;
+	}
+
+	::strncpy(address->sun_path, path.CStr(), sizeof(address->sun_path) - 1);
+
+	return true;
+}
+
+static void SetTimeout(int socket, int timeout_msec)
+{
+	struct timeval timeout = {timeout_msec / 1000, (timeout_msec % 1000) * 1000};
+
+	::setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	::setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+OvtSharedMemoryServer::~OvtSharedMemoryServer()
+{
+	Stop();
+}
+
+bool OvtSharedMemoryServer::Start(const ov::String &path, OvtSharedMemoryObserver *observer)
+{
+	struct sockaddr_un address;
+
+	if (MakeUnixAddress(path, &address) == false)
+	{
+		return false;
+	}
+
+	_server_socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (_server_socket == -1)
+	{
+		logte("Could not create the shared memory socket: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return false;
+	}
+
+	// The socket file of the previous process is replaced
+	::unlink(path.CStr());
+
+	if ((::bind(_server_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) ||
+		(::listen(_server_socket, SOMAXCONN) != 0))
+	{
+		logte("Could not listen on %s: %s", path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		::close(_server_socket);
+		_server_socket = -1;
+		return false;
+	}
+
+	_path = path;
+	_observer = observer;
+	_stop_thread_flag = false;
+	_thread = std::thread(&OvtSharedMemoryServer::AcceptThread, this);
+
+	return true;
+}
+
+void OvtSharedMemoryServer::Stop()
+{
+	_stop_thread_flag = true;
+
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+
+	if (_server_socket != -1)
+	{
+		::close(_server_socket);
+		_server_socket = -1;
+
+		::unlink(_path.CStr());
+	}
+}
+
+void OvtSharedMemoryServer::AcceptThread()
+{
+	ov::ThreadMetrics thread_metrics("OvtSharedMemory", ov::ThreadClass::NetworkIo);
+
+	while (_stop_thread_flag == false)
+	{
+		struct pollfd poll_fd = {_server_socket, POLLIN, 0};
+
+		thread_metrics.BeginIdle();
+		auto result = ::poll(&poll_fd, 1, OVT_SHARED_MEMORY_ACCEPT_INTERVAL_MSEC);
+		thread_metrics.EndIdle();
+
+		if (result <= 0)
+		{
+			continue;
+		}
+
+		auto connection = ::accept4(_server_socket, nullptr, nullptr, SOCK_CLOEXEC);
+
+		if (connection != -1)
+		{
+			HandleConnection(connection);
+		}
+	}
+}
+
+void OvtSharedMemoryServer::HandleConnection(int connection)
+{
+	// The edges on the same host respond immediately, so they are handled one by one
+	SetTimeout(connection, OVT_SHARED_MEMORY_HANDSHAKE_TIMEOUT_MSEC);
+
+	uint8_t token_buffer[sizeof(uint32_t)];
+	int unused_descriptor = -1;
+
+	if (ReceiveWithDescriptor(connection, token_buffer, sizeof(token_buffer), &unused_descriptor) == false)
+	{
+		logtw("Could not receive the token of the shared memory session");
+		::close(connection);
+		return;
+	}
+
+	if (unused_descriptor != -1)
+	{
+		::close(unused_descriptor);
+	}
+
+	auto token = ByteReader<uint32_t>::ReadBigEndian(token_buffer);
+	auto ring = _observer->OnSharedMemoryRequested(token);
+
+	if (ring == nullptr)
+	{
+		logtw("Unknown shared memory session (token: %u)", token);
+
+		uint8_t status = 1;
+		SendWithDescriptor(connection, &status, sizeof(status), -1);
+		::close(connection);
+		return;
+	}
+
+	uint8_t status = 0;
+
+	if (SendWithDescriptor(connection, &status, sizeof(status), ring->GetFileDescriptor()) == false)
+	{
+		::close(connection);
+		return;
+	}
+
+	// The notifications must not block the writer of the frames, and they are sent after the status
+	::fcntl(connection, F_SETFL, ::fcntl(connection, F_GETFL) | O_NONBLOCK);
+
+	if (_observer->OnSharedMemoryAttached(token, connection) == false)
+	{
+		::close(connection);
+	}
+}
+
+std::shared_ptr<OvtSharedMemoryRing> OvtSharedMemoryServer::Attach(const ov::String &path, uint32_t token, int *connection)
+{
+	struct sockaddr_un address;
+
+	if (MakeUnixAddress(path, &address) == false)
+	{
+		return nullptr;
+	}
+
+	auto client_socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+	if (client_socket == -1)
+	{
+		logte("Could not create the shared memory socket: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	SetTimeout(client_socket, OVT_SHARED_MEMORY_HANDSHAKE_TIMEOUT_MSEC);
+
+	uint8_t token_buffer[sizeof(uint32_t)];
+	ByteWriter<uint32_t>::WriteBigEndian(token_buffer, token);
+
+	uint8_t status = 1;
+	int file_descriptor = -1;
+
+	// The origin on another host cannot be connected
+	if ((::connect(client_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0) ||
+		(SendWithDescriptor(client_socket, token_buffer, sizeof(token_buffer), -1) == false) ||
+		(ReceiveWithDescriptor(client_socket, &status, sizeof(status), &file_descriptor) == false) ||
+		(status != 0) || (file_descriptor == -1))
+	{
+		logte("Could not receive the shared memory from %s (status: %d): %s", path.CStr(), status, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+
+		if (file_descriptor != -1)
+		{
+			::close(file_descriptor);
+		}
+
+		::close(client_socket);
+		return nullptr;
+	}
+
+	auto ring = OvtSharedMemoryRing::Map(file_descriptor);
+
+	if (ring == nullptr)
+	{
+		::close(client_socket);
+		return nullptr;
+	}
+
+	::fcntl(client_socket, F_SETFL, ::fcntl(client_socket, F_GETFL) | O_NONBLOCK);
+	*connection = client_socket;
+
+	return ring;
+}
+
+void OvtSharedMemoryServer::Notify(int connection)
+{
+	// If the buffer is full, the edge has not read the previous notifications yet, so it is not needed
+	uint8_t notification = 0;
+	[[maybe_unused]] auto result = ::send(connection, &notification, sizeof(notification), MSG_DONTWAIT | MSG_NOSIGNAL);
+}
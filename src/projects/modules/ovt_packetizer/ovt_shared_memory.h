@@ -0,0 +1,128 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <atomic>
+#include <thread>
+
+// The frames of a stream that the ring keeps (the edge that falls behind more than this loses the frames)
+#define OVT_SHARED_MEMORY_SLOT_COUNT 4096
+// The size of the frame data of a ring
+#define OVT_SHARED_MEMORY_DATA_SIZE (64 * 1024 * 1024)
+// A frame must not be larger than this part of the data
+#define OVT_SHARED_MEMORY_MAX_FRAME_SIZE (OVT_SHARED_MEMORY_DATA_SIZE / 4)
+// How long the origin/edge waits for the other while the shared memory is handed over
+#define OVT_SHARED_MEMORY_HANDSHAKE_TIMEOUT_MSEC 1000
+
+// The frames of a stream that are shared with the edges on the same host (See Transport::SharedMemory of OvtControlMessage)
+//
+// The origin writes each frame once into a memfd, and the edges map it read-only, so the frames are not packetized
+// and are not sent over the connection. There is a writer (the origin), and the readers don't block it:
+// a reader detects the frames that are overwritten while they are read by the sequence of the slot, and resumes from the latest key frame.
+// (The slots are not reference counted by the readers, because a reader that dies while holding a slot would stall the writer.)
+class OvtSharedMemoryRing
+{
+public:
+	enum class ReadResult : uint8_t
+	{
+		// A frame is read
+		Frame,
+		// No more frames
+		Empty,
+		// The frames are overwritten before they are read, the reader resumes from the latest key frame
+		Lost
+	};
+
+	// (Origin) Creates a ring in a memfd
+	static std::shared_ptr<OvtSharedMemoryRing> Create(const ov::String &name);
+	// (Edge) Maps the ring received from the origin, the ring owns the descriptor
+	static std::shared_ptr<OvtSharedMemoryRing> Map(int file_descriptor);
+
+	~OvtSharedMemoryRing();
+
+	int GetFileDescriptor() const
+	{
+		return _file_descriptor;
+	}
+
+	// (Origin) Called with the frames of the stream in order (there must be one writer)
+	bool Write(const std::shared_ptr<MediaPacket> &media_packet);
+
+	// (Edge) The sequence to start reading from (the latest video key frame if it is in the ring)
+	uint64_t GetStartSequence() const;
+	// (Edge) Reads the frame of the sequence, and the sequence is advanced (or moved to the start sequence if the frames are lost)
+	ReadResult Read(uint64_t *sequence, std::shared_ptr<MediaPacket> *media_packet) const;
+
+private:
+	struct Header;
+	struct Slot;
+
+	OvtSharedMemoryRing() = default;
+
+	bool MapMemory(bool is_writable);
+
+	int _file_descriptor = -1;
+	void *_memory = nullptr;
+	size_t _memory_size = 0;
+
+	Header *_header = nullptr;
+	Slot *_slots = nullptr;
+	uint8_t *_data = nullptr;
+
+	// (Origin) The position of the next frame in the data, it only increases (the offset in the data is position % size)
+	uint64_t _write_position = 0;
+};
+
+class OvtSharedMemoryObserver
+{
+public:
+	// Returns the ring of the session of the token (nullptr if the token is not valid)
+	virtual std::shared_ptr<OvtSharedMemoryRing> OnSharedMemoryRequested(uint32_t token) = 0;
+	// Called after the ring is handed over, the connection is owned by the observer if it returns true
+	virtual bool OnSharedMemoryAttached(uint32_t token, int connection) = 0;
+};
+
+// (Origin) Hands the rings over to the edges on the same host through a UNIX domain socket (<Bind><Publishers><OVT><SharedMemoryPath>)
+//
+// The edge sends the token of the session (4 bytes, big endian), and the origin responds with a status (1 byte, 0: OK)
+// and the descriptor of the ring (SCM_RIGHTS). The connection is kept after that: the origin writes a byte to it whenever
+// a frame is written, and the edge regards the end of the connection as the end of the session (or the origin).
+class OvtSharedMemoryServer
+{
+public:
+	~OvtSharedMemoryServer();
+
+	bool Start(const ov::String &path, OvtSharedMemoryObserver *observer);
+	void Stop();
+
+	const ov::String &GetPath() const
+	{
+		return _path;
+	}
+
+	// (Edge) Connects to the origin, and receives the ring of the session
+	// connection: The connection of the session, it is readable when frames are written (or the session is ended)
+	static std::shared_ptr<OvtSharedMemoryRing> Attach(const ov::String &path, uint32_t token, int *connection);
+
+	// Writes a byte to the connection of an edge without blocking (the edge reads all the frames when it wakes up)
+	static void Notify(int connection);
+
+private:
+	void AcceptThread();
+	void HandleConnection(int connection);
+
+	ov::String _path;
+	OvtSharedMemoryObserver *_observer = nullptr;
+
+	int _server_socket = -1;
+	std::atomic<bool> _stop_thread_flag{true};
+	std::thread _thread;
+};
@@ -8,16 +8,19 @@
 //==============================================================================
 #include "physical_port.h"
 
+#include <base/ovlibrary/probe.h>
+
 #include <algorithm>
 
 #include "physical_port_private.h"
 #include "physical_port_worker.h"
 
-#define PHYSICAL_PORT_WORKER_COUNT 16
 #define PHYSICAL_PORT_EPOLL_TIMEOUT_MSEC 500
 
 PhysicalPort::PhysicalPort()
 	: _type(ov::SocketType::Unknown),
+	  _reactor_count(1),
+	  _worker_count(0),
 	  _server_socket(nullptr),
 	  _datagram_socket(nullptr),
 
@@ -33,21 +36,49 @@ PhysicalPort::~PhysicalPort()
 bool PhysicalPort::Create(ov::SocketType type,
 						  const ov::SocketAddress &address,
 						  int send_buffer_size,
-						  int recv_buffer_size)
+						  int recv_buffer_size,
+						  int reactor_count,
+						  int worker_count,
+						  bool worker_affinity)
 {
 	OV_ASSERT2((_server_socket == nullptr) && (_datagram_socket == nullptr));
 
 	logtd("Trying to start server...");
 
+	reactor_count = std::max(reactor_count, 1);
+
+	_send_buffer_size = send_buffer_size;
+	_recv_buffer_size = recv_buffer_size;
+	_worker_affinity = worker_affinity;
+
+	if (_inherited_handles.empty() == false)
+	{
+		if (static_cast<int>(_inherited_handles.size()) != reactor_count)
+		{
+			logti("The port %s is inherited with %zu reactor(s) (requested: %d)", address.ToString().CStr(), _inherited_handles.size(), reactor_count);
+		}
+
+		reactor_count = static_cast<int>(_inherited_handles.size());
+	}
+
 	switch (type)
 	{
 		case ov::SocketType::Srt:
+			// SRT manages its own UDP socket, so SO_REUSEPORT cannot be used
+			if (reactor_count > 1)
+			{
+				logtw("Multiple reactors are not supported for SRT port: %s", address.ToString().CStr());
+				reactor_count = 1;
+			}
+
+			[[fallthrough]];
+
 		case ov::SocketType::Tcp: {
-			return CreateServerSocket(type, address, send_buffer_size, recv_buffer_size);
+			return CreateServerSocket(type, address, send_buffer_size, recv_buffer_size, reactor_count, worker_count, worker_affinity);
 		}
 
 		case ov::SocketType::Udp: {
-			return CreateDatagramSocket(type, address);
+			return CreateDatagramSocket(type, address, reactor_count);
 		}
 
 		case ov::SocketType::Unknown:
@@ -60,166 +91,327 @@ bool PhysicalPort::Create(ov::SocketType type,
 bool PhysicalPort::CreateServerSocket(ov::SocketType type,
 									  const ov::SocketAddress &address,
 									  int send_buffer_size,
-									  int recv_buffer_size)
+									  int recv_buffer_size,
+									  int reactor_count,
+									  int worker_count,
+									  bool worker_affinity)
 {
+	for (int index = 0; index < reactor_count; index++)
+	{
+		auto socket = std::make_shared<ov::ServerSocket>();
+		bool result = _inherited_handles.empty()
+						  ? socket->Prepare(type, address, send_buffer_size, recv_buffer_size, ov::ServerSocket::GetAcceptOptions().backlog, (reactor_count > 1))
+						  : socket->Inherit(_inherited_handles[index], address);
+
+		if (result == false)
+		{
+			logte("Could not prepare the socket #%d of %s", index, address.ToString().CStr());
+
+			for (auto &prepared_socket : _server_socket_list)
+			{
+				prepared_socket->Close();
+			}
+
+			_server_socket_list.clear();
+
+			return false;
+		}
+
+		_server_socket_list.push_back(socket);
+	}
+
 	// Prepare physical port workers
+	int processor_count = ov::Platform::GetProcessorCount();
+
+	if (worker_count <= 0)
+	{
+		worker_count = processor_count;
+	}
+
 	{
 		auto lock_guard = std::lock_guard(_worker_mutex);
-		for (int index = 0; index < PHYSICAL_PORT_WORKER_COUNT; index++)
+		for (int index = 0; index < worker_count; index++)
 		{
-			_worker_list.emplace_back(std::make_shared<PhysicalPortWorker>(GetSharedPtr()));
+			// The workers are pinned to the processors next to the ones used by the reactors
+			int processor_index = worker_affinity ? ((reactor_count + index) % processor_count) : -1;
+
+			_worker_list.emplace_back(std::make_shared<PhysicalPortWorker>(GetSharedPtr(), index, processor_index));
 		}
 	}
 
-	auto socket = std::make_shared<ov::ServerSocket>();
+	_worker_count = worker_count;
+
+	_type = type;
+	_reactor_count = reactor_count;
+	_server_socket = _server_socket_list.front();
+
+	_need_to_stop = false;
 
-	if (socket->Prepare(type, address, send_buffer_size, recv_buffer_size, 4096))
 	{
-		_type = type;
-		_server_socket = socket;
+		auto shared_lock = std::shared_lock(_worker_mutex);
+		for (auto &worker : _worker_list)
+		{
+			worker->Start();
+		}
+	}
 
-		_need_to_stop = false;
+	for (int index = 0; index < reactor_count; index++)
+	{
+		_thread_list.emplace_back(&PhysicalPort::ServerSocketThread, this, _server_socket_list[index], index);
+	}
 
-		auto proc = [&, socket]() -> void {
-			auto client_callback = [&](const std::shared_ptr<ov::ClientSocket> &client, ov::SocketConnectionState state, const std::shared_ptr<ov::Error> &error) -> ov::SocketConnectionState {
-				switch (state)
-				{
-					case ov::SocketConnectionState::Connected: {
-						logtd("New client is connected: %s", client->ToString().CStr());
+	_address = address;
 
-						// Notify observers
-						auto func = std::bind(&PhysicalPortObserver::OnConnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client));
-						for_each(_observer_list.begin(), _observer_list.end(), func);
+	return true;
+}
 
-						break;
-					}
+void PhysicalPort::ServerSocketThread(std::shared_ptr<ov::ServerSocket> socket, int reactor_index)
+{
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Socket);
 
-					case ov::SocketConnectionState::Disconnect: {
-						logtd("Disconnected by server: %s", client->ToString().CStr());
+	if ((_reactor_count > 1) && (ov::Platform::SetThreadAffinity(reactor_index) == false))
+	{
+		logtw("Could not set the affinity of the reactor #%d for %s", reactor_index, socket->ToString().CStr());
+	}
 
-						// Notify observers
-						auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Disconnect, nullptr);
-						for_each(_observer_list.begin(), _observer_list.end(), func);
+	auto client_callback = [&](const std::shared_ptr<ov::ClientSocket> &client, ov::SocketConnectionState state, const std::shared_ptr<ov::Error> &error) -> ov::SocketConnectionState {
+		switch (state)
+		{
+			case ov::SocketConnectionState::Connected: {
+				auto worker = AssignWorker(client);
 
-						break;
-					}
+				if (worker != nullptr)
+				{
+					logtd("New client is connected: %s (worker #%d, clients: %d, queued tasks: %zu, %lld bytes/sec)",
+						  client->ToString().CStr(), worker->GetIndex(), worker->GetClientCount(), worker->GetQueueDepth(), static_cast<long long>(worker->GetBytesPerSecond()));
+				}
 
-					case ov::SocketConnectionState::Disconnected: {
-						logtd("Client is disconnected: %s", client->ToString().CStr());
+				// Notify observers
+				auto func = std::bind(&PhysicalPortObserver::OnConnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client));
+				for_each(_observer_list.begin(), _observer_list.end(), func);
 
-						// Notify observers
-						auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Disconnected, nullptr);
-						for_each(_observer_list.begin(), _observer_list.end(), func);
+				break;
+			}
 
-						break;
-					}
+			case ov::SocketConnectionState::Disconnect: {
+				logtd("Disconnected by server: %s", client->ToString().CStr());
 
-					case ov::SocketConnectionState::Error: {
-						logtd("Client is disconnected with error: %s (%s)", client->ToString().CStr(), (error != nullptr) ? error->ToString().CStr() : "N/A");
+				ReleaseWorker(client);
 
-						// Notify observers
-						auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Error, error);
-						for_each(_observer_list.begin(), _observer_list.end(), func);
+				// Notify observers
+				auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Disconnect, nullptr);
+				for_each(_observer_list.begin(), _observer_list.end(), func);
 
-						break;
-					}
-				}
+				break;
+			}
 
-				return state;
-			};
+			case ov::SocketConnectionState::Disconnected: {
+				logtd("Client is disconnected: %s", client->ToString().CStr());
 
-			auto data_callback = [&](const std::shared_ptr<ov::ClientSocket> &client, const std::shared_ptr<const ov::Data> &data) -> ov::SocketConnectionState {
-				auto sock = client->GetSocket();
+				ReleaseWorker(client);
 
-				if (sock.IsValid())
-				{
-					logtd("Received data %d bytes:\n%s", data->GetLength(), data->Dump().CStr());
+				// Notify observers
+				auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Disconnected, nullptr);
+				for_each(_observer_list.begin(), _observer_list.end(), func);
 
-					auto shared_lock = std::shared_lock(_worker_mutex, std::defer_lock);
+				break;
+			}
 
-					shared_lock.lock();
-					auto &worker = _worker_list.at(sock.GetSocket() % PHYSICAL_PORT_WORKER_COUNT);
-					shared_lock.unlock();
+			case ov::SocketConnectionState::Error: {
+				logtd("Client is disconnected with error: %s (%s)", client->ToString().CStr(), (error != nullptr) ? error->ToString().CStr() : "N/A");
 
-					if (worker->AddTask(client, data) == false)
-					{
-						logte("Could not add task");
-					}
-				}
-				else
-				{
-					logtw("Received data %d bytes from disconnected client");
-				}
+				ReleaseWorker(client);
 
-				return ov::SocketConnectionState::Connected;
-			};
+				// Notify observers
+				auto func = bind(&PhysicalPortObserver::OnDisconnected, std::placeholders::_1, std::static_pointer_cast<ov::Socket>(client), PhysicalPortDisconnectReason::Error, error);
+				for_each(_observer_list.begin(), _observer_list.end(), func);
 
-			while ((_need_to_stop == false) && (socket->DispatchEvent(client_callback, data_callback, PHYSICAL_PORT_EPOLL_TIMEOUT_MSEC)))
-			{
+				break;
 			}
+		}
 
-			socket->Close();
+		return state;
+	};
 
-			logtd("Server is stopped");
-		};
+	auto data_callback = [&](const std::shared_ptr<ov::ClientSocket> &client, const std::shared_ptr<const ov::Data> &data) -> ov::SocketConnectionState {
+		auto sock = client->GetSocket();
 
+		if (sock.IsValid())
 		{
-			auto shared_lock = std::shared_lock(_worker_mutex);
-			for (auto &worker : _worker_list)
+			logtd("Received data %d bytes:\n%s", data->GetLength(), data->Dump().CStr());
+			OV_PROBE2(port_receive, client->GetId(), data->GetLength());
+
+			auto worker = GetWorker(client);
+
+			if (worker == nullptr)
+			{
+				// The data arrived before the connected event
+				worker = AssignWorker(client);
+			}
+
+			if (worker == nullptr)
 			{
-				worker->Start();
+				logte("Could not add task");
 			}
+			else if (worker->AddTask(client, data) == false)
+			{
+				// The worker cannot keep up with the client
+				return ov::SocketConnectionState::Disconnect;
+			}
+		}
+		else
+		{
+			logtw("Received data %d bytes from disconnected client");
 		}
 
-		_thread = std::thread(proc);
+		return ov::SocketConnectionState::Connected;
+	};
 
-		_address = address;
+	while ((_need_to_stop == false) && (socket->DispatchEvent(client_callback, data_callback, PHYSICAL_PORT_EPOLL_TIMEOUT_MSEC)))
+	{
+	}
 
-		return true;
+	socket->Close();
+
+	logtd("Server is stopped (reactor #%d)", reactor_index);
+}
+
+std::shared_ptr<PhysicalPortWorker> PhysicalPort::AssignWorker(const std::shared_ptr<ov::ClientSocket> &client)
+{
+	auto lock_guard = std::lock_guard(_worker_mutex);
+
+	if (_worker_list.empty())
+	{
+		return nullptr;
 	}
 
-	return false;
+	// Find the worker that receives the least bytes/sec, so the heavy clients (e.g. high bitrate ingest) don't share a worker.
+	// If the traffic is similar, the fewer clients wins, and then the shallower queue
+	auto worker = *std::min_element(_worker_list.begin(), _worker_list.end(), [](const auto &a, const auto &b) -> bool {
+		auto a_traffic = a->GetBytesPerSecond();
+		auto b_traffic = b->GetBytesPerSecond();
+
+		if (std::abs(a_traffic - b_traffic) > PHYSICAL_PORT_WORKER_TRAFFIC_TOLERANCE)
+		{
+			return a_traffic < b_traffic;
+		}
+
+		auto a_count = a->GetClientCount();
+		auto b_count = b->GetClientCount();
+
+		return (a_count != b_count) ? (a_count < b_count) : (a->GetQueueDepth() < b->GetQueueDepth());
+	});
+
+	auto &assigned_worker = _worker_map[client->GetSocket().GetSocket()];
+
+	if (assigned_worker != nullptr)
+	{
+		// The socket id was reused before the previous client is released
+		assigned_worker->DecreaseClientCount();
+	}
+
+	assigned_worker = worker;
+	worker->IncreaseClientCount();
+
+	return worker;
 }
 
-bool PhysicalPort::CreateDatagramSocket(ov::SocketType type, const ov::SocketAddress &address)
+std::shared_ptr<PhysicalPortWorker> PhysicalPort::GetWorker(const std::shared_ptr<ov::ClientSocket> &client)
 {
-	auto socket = std::make_shared<ov::DatagramSocket>();
+	auto shared_lock = std::shared_lock(_worker_mutex);
+
+	auto item = _worker_map.find(client->GetSocket().GetSocket());
 
-	if (socket->Prepare(address))
+	if (item != _worker_map.end())
 	{
-		_type = type;
-		_datagram_socket = socket;
+		return item->second;
+	}
 
-		_need_to_stop = false;
+	return nullptr;
+}
 
-		auto proc = [&, socket]() -> void {
-			auto data_callback = [&](const std::shared_ptr<ov::DatagramSocket> &socket, const ov::SocketAddress &remote_address, const std::shared_ptr<const ov::Data> &data) -> bool {
-				logtd("Received data %d bytes:\n%s", data->GetLength(), data->Dump().CStr());
+void PhysicalPort::ReleaseWorker(const std::shared_ptr<ov::ClientSocket> &client)
+{
+	auto lock_guard = std::lock_guard(_worker_mutex);
 
-				// Notify observers
-				auto func = std::bind(&PhysicalPortObserver::OnDataReceived, std::placeholders::_1, socket, remote_address, ref(data));
-				for_each(_observer_list.begin(), _observer_list.end(), func);
+	auto item = _worker_map.find(client->GetSocket().GetSocket());
+
+	if (item != _worker_map.end())
+	{
+		item->second->DecreaseClientCount();
+		_worker_map.erase(item);
+	}
+}
+
+bool PhysicalPort::CreateDatagramSocket(ov::SocketType type, const ov::SocketAddress &address, int reactor_count)
+{
+	for (int index = 0; index < reactor_count; index++)
+	{
+		auto socket = std::make_shared<ov::DatagramSocket>();
+		bool result = _inherited_handles.empty()
+						  ? socket->Prepare(address, (reactor_count > 1))
+						  : socket->Inherit(_inherited_handles[index], address);
 
-				return true;
-			};
+		if (result == false)
+		{
+			logte("Could not prepare the socket #%d of %s", index, address.ToString().CStr());
 
-			while ((_need_to_stop == false) && (socket->DispatchEvent(data_callback, 500)))
+			for (auto &prepared_socket : _datagram_socket_list)
 			{
+				prepared_socket->Close();
 			}
 
-			socket->Close();
+			_datagram_socket_list.clear();
+
+			return false;
+		}
+
+		_datagram_socket_list.push_back(socket);
+	}
+
+	_type = type;
+	_reactor_count = reactor_count;
+	_datagram_socket = _datagram_socket_list.front();
 
-			logtd("Server is stopped");
-		};
+	_need_to_stop = false;
 
-		_thread = std::thread(proc);
+	for (int index = 0; index < reactor_count; index++)
+	{
+		_thread_list.emplace_back(&PhysicalPort::DatagramSocketThread, this, _datagram_socket_list[index], index);
+	}
+
+	_address = address;
+
+	return true;
+}
+
+void PhysicalPort::DatagramSocketThread(std::shared_ptr<ov::DatagramSocket> socket, int reactor_index)
+{
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Socket);
 
-		_address = address;
+	if ((_reactor_count > 1) && (ov::Platform::SetThreadAffinity(reactor_index) == false))
+	{
+		logtw("Could not set the affinity of the reactor #%d for %s", reactor_index, socket->ToString().CStr());
+	}
+
+	auto data_callback = [&](const std::shared_ptr<ov::DatagramSocket> &socket, const ov::SocketAddress &remote_address, const std::shared_ptr<const ov::Data> &data) -> bool {
+		logtd("Received data %d bytes:\n%s", data->GetLength(), data->Dump().CStr());
+		OV_PROBE2(port_receive, socket->GetId(), data->GetLength());
+
+		// Notify observers
+		auto func = std::bind(&PhysicalPortObserver::OnDataReceived, std::placeholders::_1, socket, remote_address, ref(data));
+		for_each(_observer_list.begin(), _observer_list.end(), func);
 
 		return true;
+	};
+
+	while ((_need_to_stop == false) && (socket->DispatchEvent(data_callback, PHYSICAL_PORT_EPOLL_TIMEOUT_MSEC)))
+	{
 	}
 
-	return false;
+	socket->Close();
+
+	logtd("Server is stopped (reactor #%d)", reactor_index);
 }
 
 bool PhysicalPort::Close()
@@ -237,33 +429,169 @@ bool PhysicalPort::Close()
 	{
 		auto lock_guard = std::lock_guard(_worker_mutex);
 		_worker_list.clear();
+		_worker_map.clear();
 	}
 
-	if (_thread.joinable())
+	for (auto &thread : _thread_list)
 	{
-		_thread.join();
+		if (thread.joinable())
+		{
+			thread.join();
+		}
 	}
 
-	_thread = std::thread();
+	_thread_list.clear();
 
-	auto socket = GetSocket();
+	bool result = true;
 
-	if (socket != nullptr)
+	for (auto &socket : _server_socket_list)
 	{
-		if ((socket->GetState() == ov::SocketState::Closed) || (socket->Close()))
-		{
-			_server_socket = nullptr;
-			_datagram_socket = nullptr;
+		result = result && ((socket->GetState() == ov::SocketState::Closed) || socket->Close());
+	}
 
-			_observer_list.clear();
+	for (auto &socket : _datagram_socket_list)
+	{
+		result = result && ((socket->GetState() == ov::SocketState::Closed) || socket->Close());
+	}
 
-			return true;
+	if ((GetSocket() != nullptr) && result)
+	{
+		_server_socket = nullptr;
+		_datagram_socket = nullptr;
+
+		_server_socket_list.clear();
+		_datagram_socket_list.clear();
+
+		_observer_list.clear();
+
+		return true;
+	}
+
+	return false;
+}
+
+bool PhysicalPort::Suspend()
+{
+	auto observer_list = _observer_list;
+
+	if (Close() == false)
+	{
+		return false;
+	}
+
+	_suspended_observer_list = std::move(observer_list);
+
+	return true;
+}
+
+bool PhysicalPort::Resume()
+{
+	if (GetSocket() != nullptr)
+	{
+		// Not suspended
+		return false;
+	}
+
+	// The inherited sockets are already used by the first Create()
+	_inherited_handles.clear();
+
+	if (Create(_type, _address, _send_buffer_size, _recv_buffer_size, _reactor_count, _worker_count, _worker_affinity) == false)
+	{
+		return false;
+	}
+
+	_observer_list = std::move(_suspended_observer_list);
+	_suspended_observer_list.clear();
+
+	return true;
+}
+
+void PhysicalPort::SetInheritedHandles(const std::vector<int> &native_handles)
+{
+	OV_ASSERT2((_server_socket == nullptr) && (_datagram_socket == nullptr));
+
+	_inherited_handles = native_handles;
+}
+
+std::vector<int> PhysicalPort::GetNativeHandles() const
+{
+	std::vector<int> native_handles;
+
+	switch (_type)
+	{
+		case ov::SocketType::Tcp:
+			for (auto &socket : _server_socket_list)
+			{
+				native_handles.push_back(socket->GetId());
+			}
+			break;
+
+		case ov::SocketType::Udp:
+			for (auto &socket : _datagram_socket_list)
+			{
+				native_handles.push_back(socket->GetId());
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	return native_handles;
+}
+
+bool PhysicalPort::StopAccepting()
+{
+	switch (_type)
+	{
+		case ov::SocketType::Tcp: {
+			bool result = true;
+
+			for (auto &socket : _server_socket_list)
+			{
+				result = socket->StopAccepting() && result;
+			}
+
+			return result;
 		}
+
+		case ov::SocketType::Udp:
+			// The sockets are closed by the reactors
+			_need_to_stop = true;
+
+			for (auto &thread : _thread_list)
+			{
+				if (thread.joinable())
+				{
+					thread.join();
+				}
+			}
+
+			_thread_list.clear();
+
+			return true;
+
+		default:
+			break;
 	}
 
 	return false;
 }
 
+int PhysicalPort::GetClientCount()
+{
+	auto shared_lock = std::shared_lock(_worker_mutex);
+
+	int client_count = 0;
+
+	for (auto &worker : _worker_list)
+	{
+		client_count += worker->GetClientCount();
+	}
+
+	return client_count;
+}
+
 ov::SocketState PhysicalPort::GetState() const
 {
 	auto socket = GetSocket();
@@ -323,7 +651,17 @@ bool PhysicalPort::RemoveObserver(PhysicalPortObserver *observer)
 
 	if (item == _observer_list.end())
 	{
-		return false;
+		// The observer of the suspended port must not be notified after Resume()
+		auto suspended_item = std::find(_suspended_observer_list.begin(), _suspended_observer_list.end(), observer);
+
+		if (suspended_item == _suspended_observer_list.end())
+		{
+			return false;
+		}
+
+		_suspended_observer_list.erase(suspended_item);
+
+		return true;
 	}
 
 	_observer_list.erase(item);
@@ -333,5 +671,46 @@ bool PhysicalPort::RemoveObserver(PhysicalPortObserver *observer)
 
 bool PhysicalPort::DisconnectClient(ov::ClientSocket *client_socket)
 {
-	return _server_socket->DisconnectClient(client_socket, ov::SocketConnectionState::Disconnect);
+	// The client must be disconnected by the reactor that accepted it
+	auto server_socket = (client_socket != nullptr) ? client_socket->GetServerSocket() : nullptr;
+
+	if (server_socket == nullptr)
+	{
+		OV_ASSERT2(server_socket != nullptr);
+		return false;
+	}
+
+	return server_socket->DisconnectClient(client_socket, ov::SocketConnectionState::Disconnect);
+}
+
+bool PhysicalPort::SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options)
+{
+	if (_type != ov::SocketType::Tcp)
+	{
+		return false;
+	}
+
+	for (auto &socket : _server_socket_list)
+	{
+		socket->SetLowLatencyOptions(options);
+	}
+
+	return true;
+}
+
+bool PhysicalPort::SetDeferAccept(int seconds)
+{
+	if (_type != ov::SocketType::Tcp)
+	{
+		return false;
+	}
+
+	bool result = true;
+
+	for (auto &socket : _server_socket_list)
+	{
+		result = socket->SetDeferAccept(seconds) && result;
+	}
+
+	return result;
 }
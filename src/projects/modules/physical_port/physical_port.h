@@ -13,9 +13,14 @@
 #include <functional>
 #include <memory>
 #include <thread>
+#include <unordered_map>
 
 #include "physical_port_observer.h"
 
+#define PHYSICAL_PORT_DEFAULT_WORKER_COUNT 16
+// The workers whose traffic differs less than this (bytes/sec) are considered as equally loaded (512 Kbps)
+#define PHYSICAL_PORT_WORKER_TRAFFIC_TOLERANCE (64 * 1024)
+
 class PhysicalPortWorker;
 
 // PhysicalPort는 여러 곳에서 공유해서 사용할 수 있음
@@ -28,13 +33,40 @@ public:
 	PhysicalPort();
 	virtual ~PhysicalPort();
 
+	// If reactor_count > 1, opens the sockets as many as reactor_count with SO_REUSEPORT,
+	// and each socket is dispatched by its own thread pinned to a processor (TCP/UDP only)
+	//
+	// worker_count: The number of threads that deliver the received data of TCP clients to the observers
+	//               (0: the number of processors)
+	// worker_affinity: If true, each worker thread is pinned to a processor
 	bool Create(ov::SocketType type,
 				const ov::SocketAddress &address,
 				int send_buffer_size = 0,
-				int recv_buffer_size = 0);
+				int recv_buffer_size = 0,
+				int reactor_count = 1,
+				int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT,
+				bool worker_affinity = false);
 
 	bool Close();
 
+	// Closes the sockets, but keeps the observers and the options, so Resume() can open the port again (for the hot upgrade)
+	bool Suspend();
+	// Opens the port suspended by Suspend() with the same options, and the observers receive its clients again
+	bool Resume();
+
+	// The sockets inherited from the previous process are used instead of creating new ones (must be called before Create())
+	// The reactor count becomes the number of the handles
+	void SetInheritedHandles(const std::vector<int> &native_handles);
+	// The descriptors of the listening sockets to hand over to the new process (TCP/UDP only)
+	std::vector<int> GetNativeHandles() const;
+
+	// Stops accepting the new clients for the hot upgrade, the connected clients are served until they are disconnected
+	// (The reactors of UDP port are stopped, because the datagrams are received by the new process)
+	bool StopAccepting();
+
+	// The number of the TCP clients that are connected to this port
+	int GetClientCount();
+
 	ov::SocketState GetState() const;
 
 	ov::SocketType GetType() const
@@ -47,6 +79,16 @@ public:
 		return _address;
 	}
 
+	int GetReactorCount() const
+	{
+		return _reactor_count;
+	}
+
+	int GetWorkerCount() const
+	{
+		return _worker_count;
+	}
+
 	std::shared_ptr<const ov::Socket> GetSocket() const;
 	std::shared_ptr<ov::Socket> GetSocket();
 
@@ -56,25 +98,59 @@ public:
 
 	bool DisconnectClient(ov::ClientSocket *client_socket);
 
+	// Applies the options to the clients accepted after this call (TCP only)
+	bool SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options);
+	// TCP_DEFER_ACCEPT of the listening sockets (TCP only, See ov::TcpAcceptOptions)
+	bool SetDeferAccept(int seconds);
+
 protected:
 	bool CreateServerSocket(ov::SocketType type,
 							const ov::SocketAddress &address,
 							int send_buffer_size,
-							int recv_buffer_size);
+							int recv_buffer_size,
+							int reactor_count,
+							int worker_count,
+							bool worker_affinity);
+
+	bool CreateDatagramSocket(ov::SocketType type, const ov::SocketAddress &address, int reactor_count);
 
-	bool CreateDatagramSocket(ov::SocketType type, const ov::SocketAddress &address);
+	void ServerSocketThread(std::shared_ptr<ov::ServerSocket> socket, int reactor_index);
+	void DatagramSocketThread(std::shared_ptr<ov::DatagramSocket> socket, int reactor_index);
+
+	// Assigns the least loaded worker to the client, and the client stays on it until disconnected
+	// to keep the order of the received data
+	std::shared_ptr<PhysicalPortWorker> AssignWorker(const std::shared_ptr<ov::ClientSocket> &client);
+	std::shared_ptr<PhysicalPortWorker> GetWorker(const std::shared_ptr<ov::ClientSocket> &client);
+	void ReleaseWorker(const std::shared_ptr<ov::ClientSocket> &client);
 
 	ov::SocketType _type;
 	ov::SocketAddress _address;
-
+	int _reactor_count;
+	int _worker_count;
+	// The options of Create() (See Resume())
+	int _send_buffer_size = 0;
+	int _recv_buffer_size = 0;
+	bool _worker_affinity = false;
+
+	// The first socket of _server_socket_list/_datagram_socket_list
 	std::shared_ptr<ov::ServerSocket> _server_socket;
 	std::shared_ptr<ov::DatagramSocket> _datagram_socket;
 
+	// One socket per reactor
+	std::vector<std::shared_ptr<ov::ServerSocket>> _server_socket_list;
+	std::vector<std::shared_ptr<ov::DatagramSocket>> _datagram_socket_list;
+
+	std::vector<int> _inherited_handles;
+
 	volatile bool _need_to_stop;
-	std::thread _thread;
+	std::vector<std::thread> _thread_list;
 
 	std::vector<PhysicalPortObserver *> _observer_list;
+	// The observers of the suspended port
+	std::vector<PhysicalPortObserver *> _suspended_observer_list;
 
 	std::shared_mutex _worker_mutex;
 	std::vector<std::shared_ptr<PhysicalPortWorker>> _worker_list;
+	// key: socket id of the client
+	std::unordered_map<int, std::shared_ptr<PhysicalPortWorker>> _worker_map;
 };
@@ -8,8 +8,18 @@
 //==============================================================================
 #include "physical_port_manager.h"
 
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include "physical_port_private.h"
 
+// A message of the hot upgrade channel, which carries one descriptor (the last message has no descriptor)
+struct InheritedPortMessage
+{
+	int32_t type;
+	char address[128];
+};
+
 PhysicalPortManager::PhysicalPortManager()
 {
 }
@@ -18,8 +28,10 @@ PhysicalPortManager::~PhysicalPortManager()
 {
 }
 
-std::shared_ptr<PhysicalPort> PhysicalPortManager::CreatePort(ov::SocketType type, const ov::SocketAddress &address)
+std::shared_ptr<PhysicalPort> PhysicalPortManager::CreatePort(ov::SocketType type, const ov::SocketAddress &address, int reactor_count, int worker_count, bool worker_affinity)
 {
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
 	auto key = std::make_pair(type, address);
 	auto item = _port_list.find(key);
 	std::shared_ptr<PhysicalPort> port = nullptr;
@@ -28,7 +40,17 @@ std::shared_ptr<PhysicalPort> PhysicalPortManager::CreatePort(ov::SocketType typ
 	{
 		port = std::make_shared<PhysicalPort>();
 
-		if (port->Create(type, address))
+		auto inherited_item = _inherited_handle_list.find(std::make_pair(type, address.ToString()));
+
+		if (inherited_item != _inherited_handle_list.end())
+		{
+			logti("The port %s is inherited from the previous process (%zu socket(s))", address.ToString().CStr(), inherited_item->second.size());
+
+			port->SetInheritedHandles(inherited_item->second);
+			_inherited_handle_list.erase(inherited_item);
+		}
+
+		if (port->Create(type, address, 0, 0, reactor_count, worker_count, worker_affinity))
 		{
 			_port_list[key] = port;
 		}
@@ -40,6 +62,11 @@ std::shared_ptr<PhysicalPort> PhysicalPortManager::CreatePort(ov::SocketType typ
 	else
 	{
 		port = item->second;
+
+		if (port->GetReactorCount() != std::max(reactor_count, 1))
+		{
+			logtw("The port %s is already created with %d reactor(s) (requested: %d)", address.ToString().CStr(), port->GetReactorCount(), reactor_count);
+		}
 	}
 
 	return port;
@@ -47,6 +74,8 @@ std::shared_ptr<PhysicalPort> PhysicalPortManager::CreatePort(ov::SocketType typ
 
 bool PhysicalPortManager::DeletePort(std::shared_ptr<PhysicalPort> &port)
 {
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
 	auto key = std::make_pair(port->GetType(), port->GetAddress());
 	auto item = _port_list.find(key);
 
@@ -65,3 +94,187 @@ bool PhysicalPortManager::DeletePort(std::shared_ptr<PhysicalPort> &port)
 
 	return true;
 }
+
+bool PhysicalPortManager::SendPorts(int channel)
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	auto send_message = [channel](ov::SocketType type, const ov::String &address, int native_handle) -> bool {
+		InheritedPortMessage message{};
+
+		message.type = static_cast<int32_t>(type);
+		::strncpy(message.address, address.CStr(), sizeof(message.address) - 1);
+
+		iovec iov{&message, sizeof(message)};
+		uint8_t control[CMSG_SPACE(sizeof(int))]{};
+
+		msghdr header{};
+		header.msg_iov = &iov;
+		header.msg_iovlen = 1;
+
+		if (native_handle >= 0)
+		{
+			header.msg_control = control;
+			header.msg_controllen = sizeof(control);
+
+			auto cmsg = CMSG_FIRSTHDR(&header);
+			cmsg->cmsg_level = SOL_SOCKET;
+			cmsg->cmsg_type = SCM_RIGHTS;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+			::memcpy(CMSG_DATA(cmsg), &native_handle, sizeof(int));
+		}
+
+		return ::sendmsg(channel, &header, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(message));
+	};
+
+	for (auto &item : _port_list)
+	{
+		auto &port = item.second;
+		auto address = port->GetAddress().ToString();
+
+		for (auto native_handle : port->GetNativeHandles())
+		{
+			if (send_message(port->GetType(), address, native_handle) == false)
+			{
+				logte("Could not send the socket #%d of %s: %s", native_handle, address.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+				return false;
+			}
+
+			logtd("The socket #%d of %s is sent", native_handle, address.CStr());
+		}
+	}
+
+	return send_message(ov::SocketType::Unknown, "", -1);
+}
+
+bool PhysicalPortManager::ReceivePorts(int channel)
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	size_t count = 0;
+
+	while (true)
+	{
+		InheritedPortMessage message{};
+
+		iovec iov{&message, sizeof(message)};
+		uint8_t control[CMSG_SPACE(sizeof(int))]{};
+
+		msghdr header{};
+		header.msg_iov = &iov;
+		header.msg_iovlen = 1;
+		header.msg_control = control;
+		header.msg_controllen = sizeof(control);
+
+		auto read_bytes = ::recvmsg(channel, &header, MSG_CMSG_CLOEXEC);
+
+		if (read_bytes != static_cast<ssize_t>(sizeof(message)))
+		{
+			logte("Could not receive the sockets from the previous process: %s", (read_bytes < 0) ? ov::Error::CreateErrorFromErrno()->ToString().CStr() : "Invalid message");
+			return false;
+		}
+
+		auto type = static_cast<ov::SocketType>(message.type);
+
+		if (type == ov::SocketType::Unknown)
+		{
+			break;
+		}
+
+		auto cmsg = CMSG_FIRSTHDR(&header);
+
+		if ((cmsg == nullptr) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS))
+		{
+			logte("The socket of %s is not received", message.address);
+			return false;
+		}
+
+		int native_handle;
+		::memcpy(&native_handle, CMSG_DATA(cmsg), sizeof(int));
+
+		message.address[sizeof(message.address) - 1] = '\0';
+		_inherited_handle_list[std::make_pair(type, ov::String(message.address))].push_back(native_handle);
+
+		logtd("The socket #%d of %s is received", native_handle, message.address);
+		count++;
+	}
+
+	logti("%zu socket(s) of %zu port(s) are received from the previous process", count, _inherited_handle_list.size());
+
+	return true;
+}
+
+void PhysicalPortManager::CloseInheritedHandles()
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	for (auto &item : _inherited_handle_list)
+	{
+		logtw("The inherited port %s is not used by the current configuration", item.first.second.CStr());
+
+		for (auto native_handle : item.second)
+		{
+			::close(native_handle);
+		}
+	}
+
+	_inherited_handle_list.clear();
+}
+
+void PhysicalPortManager::ClosePorts(ov::SocketType type)
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	for (auto &item : _port_list)
+	{
+		if (item.first.first == type)
+		{
+			logtw("The port %s is closed, and its clients are disconnected", item.first.second.ToString().CStr());
+			item.second->Suspend();
+		}
+	}
+}
+
+void PhysicalPortManager::ReopenPorts(ov::SocketType type)
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	for (auto &item : _port_list)
+	{
+		if ((item.first.first == type) && (item.second->GetSocket() == nullptr))
+		{
+			if (item.second->Resume())
+			{
+				logti("The port %s is opened again", item.first.second.ToString().CStr());
+			}
+			else
+			{
+				logte("Could not open the port %s again", item.first.second.ToString().CStr());
+			}
+		}
+	}
+}
+
+void PhysicalPortManager::StopAccepting()
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	for (auto &item : _port_list)
+	{
+		item.second->StopAccepting();
+	}
+}
+
+int PhysicalPortManager::GetClientCount()
+{
+	auto lock_guard = std::lock_guard(_port_list_mutex);
+
+	int client_count = 0;
+
+	for (auto &item : _port_list)
+	{
+		client_count += item.second->GetClientCount();
+	}
+
+	return client_count;
+}
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "physical_port.h"
 #include "physical_port_observer.h"
@@ -20,12 +22,35 @@ public:
 
 	virtual ~PhysicalPortManager();
 
-	std::shared_ptr<PhysicalPort> CreatePort(ov::SocketType type, const ov::SocketAddress &address);
+	// reactor_count, worker_count, worker_affinity: See PhysicalPort::Create()
+	std::shared_ptr<PhysicalPort> CreatePort(ov::SocketType type, const ov::SocketAddress &address, int reactor_count = 1,
+											 int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT, bool worker_affinity = false);
 
 	bool DeletePort(std::shared_ptr<PhysicalPort> &port);
 
+	// Hot upgrade (See <Performance><HotUpgrade>)
+	//
+	// Sends the descriptors of the TCP/UDP ports to the new process through the unix domain socket (SCM_RIGHTS)
+	bool SendPorts(int channel);
+	// Receives the descriptors from the old process, and they are used by CreatePort() instead of binding the address again
+	bool ReceivePorts(int channel);
+	// Closes the received descriptors that are not used by any module
+	void CloseInheritedHandles();
+	// Closes the ports that can't be handed over (such as SRT), so the new process can bind them
+	void ClosePorts(ov::SocketType type);
+	// Opens the ports closed by ClosePorts() again, if the new process could not be started
+	void ReopenPorts(ov::SocketType type);
+	// Stops accepting the new clients of all ports, after the new process is ready
+	void StopAccepting();
+	// The number of the TCP clients of all ports
+	int GetClientCount();
+
 protected:
 	PhysicalPortManager();
 
+	// The modules are created in parallel (See main.cpp)
+	std::mutex _port_list_mutex;
 	std::map<std::pair<ov::SocketType, ov::SocketAddress>, std::shared_ptr<PhysicalPort>> _port_list;
+	// The descriptors received from the old process (key: type, address)
+	std::map<std::pair<ov::SocketType, ov::String>, std::vector<int>> _inherited_handle_list;
 };
@@ -14,9 +14,11 @@
 #include "physical_port.h"
 #include "physical_port_private.h"
 
-PhysicalPortWorker::PhysicalPortWorker(const std::shared_ptr<PhysicalPort> &physical_port)
+PhysicalPortWorker::PhysicalPortWorker(const std::shared_ptr<PhysicalPort> &physical_port, int index, int processor_index)
 	: _observer_list(physical_port->_observer_list),
-	  _physical_port(physical_port)
+	  _physical_port(physical_port),
+	  _index(index),
+	  _processor_index(processor_index)
 {
 }
 
@@ -41,10 +43,15 @@ bool PhysicalPortWorker::Start()
 	}
 
 	ov::String queue_name;
-	queue_name.Format("[%p] PhyPortWorker for #%d (%s)", this, socket->GetSocket().GetSocket(), socket->GetLocalAddress()->ToString().CStr());
+	queue_name.Format("[%p] PhyPortWorker #%d for #%d (%s)", this, _index, socket->GetSocket().GetSocket(), socket->GetLocalAddress()->ToString().CStr());
 
 	_task_list.SetAlias(queue_name);
 
+	// The bytes received over TCP cannot be dropped, so the client that overflows the queue is disconnected
+	_task_list.SetLimit(0, _max_queue_bytes, ov::QueueOverflowPolicy::Disconnect, [](const Task &task) -> size_t {
+		return task.data->GetLength();
+	});
+
 	_stop = false;
 	_thread = std::thread(&PhysicalPortWorker::ThreadProc, this);
 
@@ -78,20 +85,74 @@ bool PhysicalPortWorker::AddTask(const std::shared_ptr<ov::ClientSocket> &client
 		return false;
 	}
 
+	UpdateTraffic(data->GetLength());
+
 	Task task(client, data);
-	_task_list.Enqueue(std::move(task));
+
+	if (_task_list.Enqueue(std::move(task)) == false)
+	{
+		logtw("The queue of the worker #%d is full (%zu bytes), the client will be disconnected: %s",
+			  _index, _task_list.GetBytes(), client->ToString().CStr());
+		return false;
+	}
 
 	return true;
 }
 
+void PhysicalPortWorker::UpdateTraffic(size_t bytes)
+{
+	auto lock_guard = std::lock_guard(_traffic_mutex);
+
+	auto now = std::chrono::steady_clock::now();
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _traffic_window_start).count();
+
+	_traffic_window_bytes += bytes;
+
+	if (elapsed >= PHYSICAL_PORT_WORKER_TRAFFIC_WINDOW_MSEC)
+	{
+		_bytes_per_second = static_cast<int64_t>(_traffic_window_bytes * 1000 / elapsed);
+
+		_traffic_window_start = now;
+		_traffic_window_bytes = 0;
+	}
+}
+
+int64_t PhysicalPortWorker::GetBytesPerSecond() const
+{
+	auto lock_guard = std::lock_guard(_traffic_mutex);
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _traffic_window_start).count();
+
+	if (elapsed >= (PHYSICAL_PORT_WORKER_TRAFFIC_WINDOW_MSEC * 2))
+	{
+		// No data has arrived for a while (the clients are idle or gone), so the last measurement is stale
+		return static_cast<int64_t>(_traffic_window_bytes * 1000 / elapsed);
+	}
+
+	return _bytes_per_second;
+}
+
 void PhysicalPortWorker::ThreadProc()
 {
+	ov::ThreadMetrics thread_metrics("PortWorker", ov::ThreadClass::NetworkIo);
+	// The providers handle the received data in this thread (such as the reassembly of RTMP chunks)
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Ingest);
+
+	if ((_processor_index >= 0) && (ov::Platform::SetThreadAffinity(_processor_index) == false))
+	{
+		logtw("Could not set the affinity of the worker #%d to the processor #%d", _index, _processor_index);
+	}
+
 	while (_stop == false)
 	{
+		thread_metrics.BeginIdle();
 		auto task = _task_list.Dequeue();
+		thread_metrics.EndIdle();
 
 		if (task.has_value())
 		{
+			thread_metrics.CountLoop();
+
 			auto &value = task.value();
 
 			auto &client = value.client;
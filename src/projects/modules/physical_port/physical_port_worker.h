@@ -10,22 +10,66 @@
 
 #include <base/ovsocket/ovsocket.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <thread>
 
+// The interval to measure the received bytes per second of a worker
+#define PHYSICAL_PORT_WORKER_TRAFFIC_WINDOW_MSEC 1000
+
 class PhysicalPort;
 class PhysicalPortObserver;
 
 class PhysicalPortWorker
 {
 public:
-	PhysicalPortWorker(const std::shared_ptr<PhysicalPort> &physical_port);
+	// processor_index: The processor to which the thread is pinned (-1: not pinned)
+	PhysicalPortWorker(const std::shared_ptr<PhysicalPort> &physical_port, int index, int processor_index = -1);
 	virtual ~PhysicalPortWorker();
 
 	bool Start();
 	bool Stop();
 
+	// Returns false if the worker is stopped or the queue is full (the client should be disconnected)
 	bool AddTask(const std::shared_ptr<ov::ClientSocket> &client, const std::shared_ptr<const ov::Data> &data);
 
+	// The bytes that can wait for each worker (0: unlimited), See <Performance><Backpressure>
+	static void SetMaxQueueBytes(size_t max_queue_bytes)
+	{
+		_max_queue_bytes = max_queue_bytes;
+	}
+
+	int GetIndex() const
+	{
+		return _index;
+	}
+
+	// The number of clients assigned to this worker
+	int GetClientCount() const
+	{
+		return _client_count;
+	}
+
+	void IncreaseClientCount()
+	{
+		_client_count++;
+	}
+
+	void DecreaseClientCount()
+	{
+		_client_count--;
+	}
+
+	// The number of tasks waiting to be processed
+	size_t GetQueueDepth() const
+	{
+		return _task_list.Size();
+	}
+
+	// The received bytes per second of the clients assigned to this worker
+	int64_t GetBytesPerSecond() const;
+
 protected:
 	struct Task
 	{
@@ -35,17 +79,32 @@ protected:
 		{
 		}
 
-		const std::shared_ptr<ov::ClientSocket> client;
-		const std::shared_ptr<const ov::Data> data;
+		std::shared_ptr<ov::ClientSocket> client;
+		std::shared_ptr<const ov::Data> data;
 	};
 
 	void ThreadProc();
 
+	void UpdateTraffic(size_t bytes);
+
 	std::vector<PhysicalPortObserver *> &_observer_list;
 	std::shared_ptr<PhysicalPort> _physical_port;
 
+	int _index;
+	int _processor_index;
+
+	std::atomic<int> _client_count { 0 };
+
+	// AddTask() is called by the reactors, and GetBytesPerSecond() is called while assigning a worker
+	mutable std::mutex _traffic_mutex;
+	std::chrono::steady_clock::time_point _traffic_window_start = std::chrono::steady_clock::now();
+	size_t _traffic_window_bytes = 0;
+	int64_t _bytes_per_second = 0;
+
 	std::thread _thread;
 	volatile bool _stop = true;
 
 	ov::Queue<Task> _task_list { nullptr, 500 };
+
+	inline static std::atomic<size_t> _max_queue_bytes { 0 };
 };
@@ -19,8 +19,9 @@ RtcP2PManager::RtcP2PManager(const cfg::Server &server_config)
 	if (_is_enabled)
 	{
 		_max_client_peers_per_host_peer = p2p_info.GetMaxClientPeersPerHostPeer();
+		_max_depth = std::max(p2p_info.GetMaxDepth(), 1);
 
-		logti("P2P is enabled (Client peers per host peer: %d)", _max_client_peers_per_host_peer);
+		logti("P2P is enabled (Client peers per host peer: %d, Max depth: %d)", _max_client_peers_per_host_peer, _max_depth);
 	}
 	else
 	{
@@ -28,13 +29,16 @@ RtcP2PManager::RtcP2PManager(const cfg::Server &server_config)
 	}
 }
 
-std::shared_ptr<RtcPeerInfo> RtcP2PManager::CreatePeerInfo(peer_id_t id, const std::shared_ptr<WebSocketClient> &ws_client)
+std::shared_ptr<RtcPeerInfo> RtcP2PManager::CreatePeerInfo(peer_id_t id, const ov::String &stream_key, uint32_t uplink_kbps, const std::shared_ptr<WebSocketClient> &ws_client)
 {
 	auto request = ws_client->GetClient()->GetRequest();
 
 	auto user_agent = request->GetHeader("USER-AGENT");
 	auto peer_info = RtcPeerInfo::FromUserAgent(id, user_agent, ws_client);
 
+	peer_info->_stream_key = stream_key;
+	peer_info->_uplink_kbps = uplink_kbps;
+
 	if (IsEnabled())
 	{
 		auto lock_guard = std::lock_guard(_list_mutex);
@@ -74,41 +78,37 @@ bool RtcP2PManager::RemovePeer(const std::shared_ptr<RtcPeerInfo> &peer)
 {
 	auto lock_guard = std::lock_guard(_list_mutex);
 
-	if (peer->IsHost())
+	auto peer_info = _peer_list.find(peer->GetId());
+
+	if (peer_info == _peer_list.end())
 	{
-		// Remove client peers
-		auto client_list = peer->_client_list;
+		return false;
 	}
-	else
-	{
-		// Remove client from host peer
-		auto host_peer = peer->_host_peer;
 
-		if (host_peer != nullptr)
-		{
-			host_peer->_client_list.erase(peer->GetId());
-			if (static_cast<int64_t>(host_peer->_client_list.size()) < _max_client_peers_per_host_peer)
-			{
-				if (host_peer->CanAccept())
-				{
-					_available_list[peer->GetId()] = host_peer;
-				}
-			}
-		}
+	_peer_list.erase(peer_info);
 
-		_total_client_count--;
-	}
+	// Remove client from host peer
+	auto host_peer = peer->_host_peer;
 
-	_available_list.erase(peer->GetId());
+	if (host_peer != nullptr)
+	{
+		host_peer->_client_list.erase(peer->GetId());
+		peer->_host_peer = nullptr;
+		_total_client_count--;
 
-	auto peer_info = _peer_list.find(peer->GetId());
+		UpdateAvailability(host_peer);
+	}
 
-	if (peer_info == _peer_list.end())
+	// The clients lose their parent until they are reassigned
+	for (auto &client : peer->_client_list)
 	{
-		return false;
+		client.second->_host_peer = nullptr;
+		_total_client_count--;
 	}
 
-	_peer_list.erase(peer->GetId());
+	peer->_client_list.clear();
+
+	UpdateAvailability(peer);
 
 	return true;
 }
@@ -139,11 +139,7 @@ bool RtcP2PManager::RegisterAsHostPeer(const std::shared_ptr<RtcPeerInfo> &peer)
 	}
 
 	peer_info->MakeAsHost();
-
-	if (peer_info->CanAccept())
-	{
-		_available_list[peer->GetId()] = peer_info;
-	}
+	SetDepth(peer_info, 0);
 
 	return true;
 }
@@ -165,44 +161,187 @@ std::shared_ptr<RtcPeerInfo> RtcP2PManager::TryToRegisterAsClientPeer(const std:
 
 	auto lock_guard = std::lock_guard(_list_mutex);
 
-	for (const auto &host : _available_list)
+	if (peer->_host_peer != nullptr)
+	{
+		OV_ASSERT2(false);
+		logtw("Client peer %s already has a host: %s", peer->ToString().CStr(), peer->_host_peer->ToString().CStr());
+		return nullptr;
+	}
+
+	auto host_peer = FindBestParent(peer);
+
+	if (host_peer != nullptr)
+	{
+		AttachClientPeer(host_peer, peer);
+	}
+
+	return host_peer;
+}
+
+std::shared_ptr<RtcPeerInfo> RtcP2PManager::ReassignClientPeer(const std::shared_ptr<RtcPeerInfo> &peer)
+{
+	if ((_is_enabled == false) || (peer == nullptr))
+	{
+		return nullptr;
+	}
+
+	auto lock_guard = std::lock_guard(_list_mutex);
+
+	if ((_peer_list.find(peer->GetId()) == _peer_list.end()) || (peer->_host_peer != nullptr))
+	{
+		// The peer has left, or is attached already
+		return nullptr;
+	}
+
+	auto host_peer = FindBestParent(peer);
+
+	if (host_peer != nullptr)
+	{
+		AttachClientPeer(host_peer, peer);
+	}
+
+	return host_peer;
+}
+
+std::shared_ptr<RtcPeerInfo> RtcP2PManager::FindBestParent(const std::shared_ptr<RtcPeerInfo> &peer)
+{
+	auto stream_item = _available_list.find(peer->_stream_key);
+
+	if (stream_item == _available_list.end())
 	{
-		auto &host_peer = host.second;
+		return nullptr;
+	}
+
+	// The clients of the peer come along with it, so the whole subtree must be within the depth limit
+	int height = GetSubtreeHeight(peer);
+	std::shared_ptr<RtcPeerInfo> best_parent;
 
-		if (host_peer->IsCompatibleWith(peer))
+	for (const auto &item : stream_item->second)
+	{
+		auto &candidate = item.second;
+
+		if ((candidate == peer) ||
+			((candidate->_depth + 1 + height) > _max_depth) ||
+			(candidate->IsCompatibleWith(peer) == false) ||
+			IsDescendantOf(candidate, peer))
+		{
+			continue;
+		}
+
+		if ((best_parent == nullptr) || IsBetterParent(candidate, best_parent, peer))
 		{
-			OV_ASSERT2(host_peer->IsHost());
+			best_parent = candidate;
+		}
+	}
+
+	return best_parent;
+}
+
+bool RtcP2PManager::IsBetterParent(const std::shared_ptr<RtcPeerInfo> &candidate, const std::shared_ptr<RtcPeerInfo> &current, const std::shared_ptr<RtcPeerInfo> &peer) const
+{
+	// 1. The same network group (the traffic is likely to stay within the ISP/region)
+	bool is_candidate_near = (peer->_network_group.IsEmpty() == false) && (candidate->_network_group == peer->_network_group);
+	bool is_current_near = (peer->_network_group.IsEmpty() == false) && (current->_network_group == peer->_network_group);
+
+	if (is_candidate_near != is_current_near)
+	{
+		return is_candidate_near;
+	}
+
+	// 2. The shallower (less latency, and less peers are affected when a parent leaves)
+	if (candidate->_depth != current->_depth)
+	{
+		return candidate->_depth < current->_depth;
+	}
 
-			auto &client_list = host_peer->_client_list;
+	// 3. The more uplink per client after accepting the peer
+	uint64_t candidate_uplink = candidate->_uplink_kbps / (candidate->_client_list.size() + 1);
+	uint64_t current_uplink = current->_uplink_kbps / (current->_client_list.size() + 1);
+
+	if (candidate_uplink != current_uplink)
+	{
+		return candidate_uplink > current_uplink;
+	}
+
+	// 4. The less loaded
+	return candidate->_client_list.size() < current->_client_list.size();
+}
 
-			peer_id_t client_id = peer->GetId();
+void RtcP2PManager::AttachClientPeer(const std::shared_ptr<RtcPeerInfo> &parent, const std::shared_ptr<RtcPeerInfo> &peer)
+{
+	OV_ASSERT2(peer->_host_peer == nullptr);
 
-			auto client_peer = client_list.find(client_id);
+	parent->_client_list[peer->GetId()] = peer;
+	peer->_host_peer = parent;
+	_total_client_count++;
 
-			if (client_peer == client_list.end())
-			{
-				client_list[client_id] = peer;
-				_total_client_count++;
+	SetDepth(peer, parent->_depth + 1);
+	UpdateAvailability(parent);
+}
 
-				peer->_host_peer = host_peer;
+void RtcP2PManager::SetDepth(const std::shared_ptr<RtcPeerInfo> &peer, int depth)
+{
+	peer->_depth = depth;
+	UpdateAvailability(peer);
 
-				if (static_cast<int64_t>(client_list.size()) >= _max_client_peers_per_host_peer)
-				{
-					// Now, the host cannot accept another client
-					_available_list.erase(host.first);
-				}
-			}
-			else
-			{
-				OV_ASSERT2(false);
-				logtw("Client peer %s is already exists (previous peer: %s)", peer->ToString().CStr(), client_peer->second->ToString().CStr());
-			}
+	for (auto &client : peer->_client_list)
+	{
+		SetDepth(client.second, depth + 1);
+	}
+}
 
-			return host_peer;
+void RtcP2PManager::UpdateAvailability(const std::shared_ptr<RtcPeerInfo> &peer)
+{
+	bool is_available =
+		peer->CanAccept() &&
+		// A peer that receives the stream from nobody cannot relay it
+		(peer->IsHost() || (peer->_host_peer != nullptr)) &&
+		(peer->_depth < _max_depth) &&
+		(static_cast<int64_t>(peer->_client_list.size()) < _max_client_peers_per_host_peer) &&
+		(_peer_list.find(peer->GetId()) != _peer_list.end());
+
+	if (is_available)
+	{
+		_available_list[peer->_stream_key][peer->GetId()] = peer;
+		return;
+	}
+
+	auto stream_item = _available_list.find(peer->_stream_key);
+
+	if (stream_item != _available_list.end())
+	{
+		stream_item->second.erase(peer->GetId());
+
+		if (stream_item->second.empty())
+		{
+			_available_list.erase(stream_item);
 		}
 	}
+}
 
-	return nullptr;
+int RtcP2PManager::GetSubtreeHeight(const std::shared_ptr<RtcPeerInfo> &peer) const
+{
+	int height = 0;
+
+	for (const auto &client : peer->_client_list)
+	{
+		height = std::max(height, GetSubtreeHeight(client.second) + 1);
+	}
+
+	return height;
+}
+
+bool RtcP2PManager::IsDescendantOf(const std::shared_ptr<RtcPeerInfo> &peer, const std::shared_ptr<RtcPeerInfo> &ancestor) const
+{
+	for (auto parent = peer->_host_peer; parent != nullptr; parent = parent->_host_peer)
+	{
+		if (parent == ancestor)
+		{
+			return true;
+		}
+	}
+
+	return false;
 }
 
 std::shared_ptr<RtcPeerInfo> RtcP2PManager::GetClientPeerOf(const std::shared_ptr<RtcPeerInfo> &host, peer_id_t client_id)
@@ -254,4 +393,11 @@ int RtcP2PManager::GetPeerCount() const
 int RtcP2PManager::GetClientPeerCount() const
 {
 	return _total_client_count;
-}
\ No newline at end of file
+}
+
+double RtcP2PManager::GetOffloadedPercentage() const
+{
+	int peer_count = GetPeerCount();
+
+	return (peer_count > 0) ? (GetClientPeerCount() * 100.0 / peer_count) : 0.0;
+}
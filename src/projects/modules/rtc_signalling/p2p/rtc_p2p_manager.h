@@ -10,26 +10,37 @@
 
 #include "rtc_peer_info.h"
 
+// Builds the trees of the peers of each stream
+//
+// A host peer receives the stream from OME, and a client peer receives it from its parent (a host or another client).
+// A parent is chosen from the peers of the same stream, preferring the same network group, then the shallower and
+// the one with more uplink per client. The depth of the trees is limited by <P2P><MaxDepth>.
 class RtcP2PManager
 {
 public:
 	RtcP2PManager(const cfg::Server &server_config);
 
 	// Create a PeerInfo from user-agent
-	std::shared_ptr<RtcPeerInfo> CreatePeerInfo(peer_id_t id, const std::shared_ptr<WebSocketClient> &ws_client);
+	std::shared_ptr<RtcPeerInfo> CreatePeerInfo(peer_id_t id, const ov::String &stream_key, uint32_t uplink_kbps, const std::shared_ptr<WebSocketClient> &ws_client);
 
 	// Add to _peer_list
 	std::shared_ptr<RtcPeerInfo> FindPeer(peer_id_t peer_id);
+	// The clients of the peer are detached (get them with GetClientPeerList() before, and call ReassignClientPeer() for them)
 	bool RemovePeer(const std::shared_ptr<RtcPeerInfo> &peer);
 
 	bool RegisterAsHostPeer(const std::shared_ptr<RtcPeerInfo> &peer);
 	std::shared_ptr<RtcPeerInfo> TryToRegisterAsClientPeer(const std::shared_ptr<RtcPeerInfo> &peer);
+	// Finds a new parent for the client whose parent has left (its own clients stay attached to it)
+	// Returns nullptr if there is no parent that can accept the client
+	std::shared_ptr<RtcPeerInfo> ReassignClientPeer(const std::shared_ptr<RtcPeerInfo> &peer);
 
 	std::shared_ptr<RtcPeerInfo> GetClientPeerOf(const std::shared_ptr<RtcPeerInfo> &host, peer_id_t client_id);
 	std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>> GetClientPeerList(const std::shared_ptr<RtcPeerInfo> &host);
 
 	int GetPeerCount() const;
 	int GetClientPeerCount() const;
+	// The percentage of the peers that receive the stream from the other peers instead of OME
+	double GetOffloadedPercentage() const;
 
 	bool IsEnabled() const
 	{
@@ -37,9 +48,21 @@ public:
 	}
 
 protected:
+	// These must be called with _list_mutex locked
+	std::shared_ptr<RtcPeerInfo> FindBestParent(const std::shared_ptr<RtcPeerInfo> &peer);
+	bool IsBetterParent(const std::shared_ptr<RtcPeerInfo> &candidate, const std::shared_ptr<RtcPeerInfo> &current, const std::shared_ptr<RtcPeerInfo> &peer) const;
+	void AttachClientPeer(const std::shared_ptr<RtcPeerInfo> &parent, const std::shared_ptr<RtcPeerInfo> &peer);
+	void SetDepth(const std::shared_ptr<RtcPeerInfo> &peer, int depth);
+	// Adds the peer to _available_list if it can accept one more client, or removes it
+	void UpdateAvailability(const std::shared_ptr<RtcPeerInfo> &peer);
+	// The number of levels below the peer (0: no client)
+	int GetSubtreeHeight(const std::shared_ptr<RtcPeerInfo> &peer) const;
+	bool IsDescendantOf(const std::shared_ptr<RtcPeerInfo> &peer, const std::shared_ptr<RtcPeerInfo> &ancestor) const;
+
 	bool _is_enabled = false;
 
 	int _max_client_peers_per_host_peer = -1;
+	int _max_depth = 1;
 
 	std::recursive_mutex _list_mutex;
 
@@ -47,9 +70,10 @@ protected:
 	// key: peer id, value: peer info list
 	std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>> _peer_list;
 
-	// List of hosts that can accept client
-	// key: host id, value: host info
-	std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>> _available_list;
+	// List of peers (hosts and relaying clients) that can accept client
+	// key: stream key, value: [key: peer id, value: peer info]
+	std::map<ov::String, std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>>> _available_list;
 
+	// The number of the peers that have a parent
 	int _total_client_count = 0;
 };
@@ -18,6 +18,7 @@ std::shared_ptr<RtcPeerInfo> RtcPeerInfo::FromUserAgent(peer_id_t id, const ov::
 	peer_info->_id = id;
 	peer_info->_browser = browser;
 	peer_info->_ws_client = ws_client;
+	peer_info->_network_group = MakeNetworkGroup(ws_client);
 
 	peer_info->_can_accept =
 		(
@@ -107,6 +108,30 @@ RtcPeerBrowser RtcPeerInfo::ParseBrowserInfo(const ov::String &user_agent)
 	return std::move(browser);
 }
 
+ov::String RtcPeerInfo::MakeNetworkGroup(const std::shared_ptr<WebSocketClient> &ws_client)
+{
+	auto remote = ws_client->GetClient()->GetRequest()->GetRemote();
+	auto address = (remote != nullptr) ? remote->GetRemoteAddress() : nullptr;
+
+	if (address == nullptr)
+	{
+		return "";
+	}
+
+	auto ip_address = address->GetIpAddress();
+
+	// IPv4: a.b.c.d => a.b.c, IPv6: a:b:c:... => a:b:c
+	const char *delimiter = (ip_address.IndexOf(':') >= 0) ? ":" : ".";
+	auto tokens = ip_address.Split(delimiter);
+
+	if (tokens.size() < 3)
+	{
+		return ip_address;
+	}
+
+	return ov::String::FormatString("%s%s%s%s%s", tokens[0].CStr(), delimiter, tokens[1].CStr(), delimiter, tokens[2].CStr());
+}
+
 bool RtcPeerInfo::IsCompatibleWith(const std::shared_ptr<RtcPeerInfo> &peer)
 {
 	if(_browser.browser_type == RtcBrowserType::Other)
@@ -123,21 +148,25 @@ ov::String RtcPeerInfo::ToString() const
 	if(IsHost())
 	{
 		return ov::String::FormatString(
-			"<PeerInfo: %p, Host peer, id: %d, can accept: %s, client count: %d, browser: %s>",
+			"<PeerInfo: %p, Host peer, id: %d, can accept: %s, client count: %zu, network: %s, browser: %s>",
 			this,
 			_id,
 			_can_accept ? "true" : "false",
 			_client_list.size(),
+			_network_group.CStr(),
 			_browser.ToString().CStr()
 		);
 	}
 	else
 	{
 		return ov::String::FormatString(
-			"<PeerInfo: %p, Client peer, id: %d, can accept: %s, browser: %s>",
+			"<PeerInfo: %p, Client peer, id: %d, depth: %d, can accept: %s, client count: %zu, network: %s, browser: %s>",
 			this,
 			_id,
+			_depth,
 			_can_accept ? "true" : "false",
+			_client_list.size(),
+			_network_group.CStr(),
 			_browser.ToString().CStr()
 		);
 	}
@@ -230,6 +230,35 @@ public:
 		return _browser;
 	}
 
+	// <app>/<stream> that the peer plays
+	const ov::String &GetStreamKey() const
+	{
+		return _stream_key;
+	}
+
+	// The prefix of the address (IPv4: /24, IPv6: /48), the peers in the same group are likely to be close
+	const ov::String &GetNetworkGroup() const
+	{
+		return _network_group;
+	}
+
+	// The uplink bandwidth reported by the player (0: unknown)
+	uint32_t GetUplinkKbps() const
+	{
+		return _uplink_kbps;
+	}
+
+	// 0: receives from OME (host), N: there are N peers between OME and this peer
+	int GetDepth() const
+	{
+		return _depth;
+	}
+
+	size_t GetClientCount() const
+	{
+		return _client_list.size();
+	}
+
 	std::shared_ptr<RtcPeerInfo> GetHostPeer()
 	{
 		return _host_peer;
@@ -249,6 +278,7 @@ public:
 protected:
 	RtcPeerInfo() = default;
 	static RtcPeerBrowser ParseBrowserInfo(const ov::String &user_agent);
+	static ov::String MakeNetworkGroup(const std::shared_ptr<WebSocketClient> &ws_client);
 
 	// peer id
 	peer_id_t _id = 0;
@@ -261,6 +291,11 @@ protected:
 	// OS & browser type
 	RtcPeerBrowser _browser;
 
+	ov::String _stream_key;
+	ov::String _network_group;
+	uint32_t _uplink_kbps = 0;
+	int _depth = 0;
+
 	// host peer info (client only)
 	std::shared_ptr<RtcPeerInfo> _host_peer;
 
@@ -21,6 +21,13 @@ class WebSocketClient;
 class RtcSignallingObserver : public ov::EnableSharedFromThis<RtcSignallingObserver>
 {
 public:
+	// Called before OnRequestOffer(). If the stream is not ready yet (such as being pulled from the origin), returns false
+	// and calls on_prepared when it is ready (or failed), then OnRequestOffer() is called on that thread
+	virtual bool OnPrepareStream(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, const std::function<void()> &on_prepared)
+	{
+		return true;
+	}
+
 	// Request offer가 오면, SDP를 생성해서 전달해줘야 함
 	// observer가 여러 개 등록되어 있는 경우, 가장 먼저 반환되는 SDP를 사용함
 	virtual std::shared_ptr<SessionDescription> OnRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, std::vector<RtcIceCandidate> *ice_candidates) = 0;
@@ -37,4 +44,8 @@ public:
     // client bitrate info check method
     virtual uint32_t OnGetBitrate(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name) = 0;
 
+	// Called after the offer is generated. If the frames of the stream are encrypted end-to-end (SFrame),
+	// the key is delivered to the player with the offer
+	virtual bool OnGetFrameEncryptionKey(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, uint64_t *key_id, std::shared_ptr<const ov::Data> *key) = 0;
+
 };
@@ -23,7 +23,7 @@ RtcSignallingServer::RtcSignallingServer(const cfg::Server &server_config)
 {
 }
 
-bool RtcSignallingServer::Start(const ov::SocketAddress *address, const ov::SocketAddress *tls_address)
+bool RtcSignallingServer::Start(const ov::SocketAddress *address, const ov::SocketAddress *tls_address, int reactor_count, int worker_count, bool worker_affinity)
 {
 	if ((_http_server != nullptr) || (_https_server != nullptr))
 	{
@@ -54,13 +54,16 @@ bool RtcSignallingServer::Start(const ov::SocketAddress *address, const ov::Sock
 	}
 
 	result = result && InitializeWebSocketServer();
+	result = result && _offer_executor.Start("RtcOffer", RTC_SIGNALLING_OFFER_THREAD_COUNT, ov::ThreadClass::NetworkIo);
 
-	result = result && ((_http_server == nullptr) || _http_server->Start(*address));
-	result = result && ((_https_server == nullptr) || _https_server->Start(*tls_address));
+	result = result && ((_http_server == nullptr) || _http_server->Start(*address, reactor_count, worker_count, worker_affinity));
+	result = result && ((_https_server == nullptr) || _https_server->Start(*tls_address, reactor_count, worker_count, worker_affinity));
 
 	if (result == false)
 	{
 		// Rollback
+		_offer_executor.Stop();
+
 		if (_http_server != nullptr)
 		{
 			_http_server->Stop();
@@ -116,22 +119,21 @@ bool RtcSignallingServer::InitializeWebSocketServer()
 
 			auto info = std::make_shared<RtcSignallingInfo>(host_name, app_name, stream_name, internal_app_name);
 
+			while (true)
 			{
-				auto lock_guard = std::lock_guard(_client_list_mutex);
+				peer_id_t id = ov::Random::GenerateInt32(1, INT32_MAX);
 
-				while (true)
-				{
-					peer_id_t id = ov::Random::GenerateInt32(1, INT32_MAX);
+				auto &shard = GetClientShard(id);
+				auto lock_guard = std::lock_guard(shard.mutex);
 
-					auto client = _client_list.find(id);
+				auto client = shard.client_list.find(id);
 
-					if (client == _client_list.end())
-					{
-						info->id = id;
-						_client_list[id] = info;
+				if (client == shard.client_list.end())
+				{
+					info->id = id;
+					shard.client_list[id] = info;
 
-						break;
-					}
+					break;
 				}
 			}
 
@@ -185,22 +187,7 @@ bool RtcSignallingServer::InitializeWebSocketServer()
 
 			if (error != nullptr)
 			{
-				if (error->GetCode() == 404)
-				{
-					logte("Cannot find stream [%s/%s]", info->internal_app_name.CStr(), info->stream_name.CStr());
-				}
-				else
-				{
-					logte("An error occurred while dispatch command %s for stream [%s/%s]: %s, disconnecting...", command.CStr(), info->internal_app_name.CStr(), info->stream_name.CStr(), error->ToString().CStr());
-				}
-
-				ov::JsonObject response_json;
-				Json::Value &value = response_json.GetJsonValue();
-
-				value["code"] = error->GetCode();
-				value["error"] = error->GetMessage().CStr();
-
-				ws_client->Send(response_json.ToString());
+				SendError(ws_client, command, info, error);
 
 				return HttpInterceptorResult::Disconnect;
 			}
@@ -222,6 +209,8 @@ bool RtcSignallingServer::InitializeWebSocketServer()
 
 			if (info != nullptr)
 			{
+				info->is_closed = true;
+
 				if (info->id != P2P_INVALID_PEER_ID)
 				{
 					// The client is disconnected without send "close" command
@@ -434,6 +423,14 @@ bool RtcSignallingServer::Stop()
 	auto http_result = (_http_server != nullptr) ? _http_server->Stop() : true;
 	auto https_result = (_https_server != nullptr) ? _https_server->Stop() : true;
 
+	// The offers that are not generated yet are discarded
+	_offer_executor.Stop();
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_offer_queue_map_mutex);
+		_offer_queue_map.clear();
+	}
+
 	return http_result && https_result;
 }
 
@@ -441,7 +438,13 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchCommand(const std::share
 {
 	if (command == "request_offer")
 	{
-		return DispatchRequestOffer(ws_client, info);
+		// "uplink_kbps" is optional
+		info->uplink_kbps = static_cast<uint32_t>(std::max(object.GetIntValue("uplink_kbps"), 0));
+		// "trickle" is optional
+		const auto &trickle_value = object.GetJsonValue("trickle");
+		info->is_trickle = trickle_value.isBool() && trickle_value.asBool();
+
+		return EnqueueRequestOffer(ws_client, info);
 	}
 
 	if (info->id != object.GetInt64Value("id"))
@@ -473,7 +476,114 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchCommand(const std::share
 	return ov::Error::CreateError(HttpStatusCode::BadRequest, "Unknown command: %s", command.CStr());
 }
 
-std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info)
+void RtcSignallingServer::SendError(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &command, const std::shared_ptr<RtcSignallingInfo> &info, const std::shared_ptr<ov::Error> &error)
+{
+	if (error->GetCode() == 404)
+	{
+		logte("Cannot find stream [%s/%s]", info->internal_app_name.CStr(), info->stream_name.CStr());
+	}
+	else
+	{
+		logte("An error occurred while dispatch command %s for stream [%s/%s]: %s, disconnecting...", command.CStr(), info->internal_app_name.CStr(), info->stream_name.CStr(), error->ToString().CStr());
+	}
+
+	ov::JsonWriter writer;
+
+	writer.BeginObject()
+		.Member("code", error->GetCode())
+		.Member("error", error->GetMessage())
+		.EndObject();
+
+	ws_client->Send(writer);
+}
+
+std::shared_ptr<ov::Error> RtcSignallingServer::EnqueueRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info)
+{
+	if (_offer_executor.IsRunning() == false)
+	{
+		return DispatchRequestOffer(ws_client, info);
+	}
+
+	// The requests for the same stream are processed together by a task, so a join storm to a stream
+	// does not occupy all threads of the executor, and the other streams are not delayed by it
+	ov::String stream_key = ov::String::FormatString("%s/%s", info->internal_app_name.CStr(), info->stream_name.CStr());
+	bool need_to_schedule = false;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_offer_queue_map_mutex);
+
+		auto &queue = _offer_queue_map[stream_key];
+
+		queue.requests.push_back({ws_client, info});
+
+		if (queue.is_scheduled == false)
+		{
+			queue.is_scheduled = true;
+			need_to_schedule = true;
+		}
+	}
+
+	if (need_to_schedule)
+	{
+		if (_offer_executor.Post([this, stream_key]() { ProcessRequestOffers(stream_key); }) == false)
+		{
+			// The server is being stopped
+			std::lock_guard<std::mutex> lock_guard(_offer_queue_map_mutex);
+			_offer_queue_map.erase(stream_key);
+
+			return ov::Error::CreateError(HttpStatusCode::ServiceUnavailable, "The signalling server is stopped");
+		}
+	}
+
+	return nullptr;
+}
+
+void RtcSignallingServer::ProcessRequestOffers(const ov::String &stream_key)
+{
+	while (true)
+	{
+		std::deque<OfferRequest> requests;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_offer_queue_map_mutex);
+
+			auto item = _offer_queue_map.find(stream_key);
+
+			if (item == _offer_queue_map.end())
+			{
+				// Stop() cleared the queues
+				return;
+			}
+
+			if (item->second.requests.empty())
+			{
+				_offer_queue_map.erase(item);
+				return;
+			}
+
+			requests.swap(item->second.requests);
+		}
+
+		for (auto &request : requests)
+		{
+			if (request.info->is_closed)
+			{
+				logtd("The client is disconnected before the offer is generated: %s", request.ws_client->ToString().CStr());
+				continue;
+			}
+
+			auto error = DispatchRequestOffer(request.ws_client, request.info);
+
+			if (error != nullptr)
+			{
+				SendError(request.ws_client, "request_offer", request.info, error);
+				request.ws_client->Close();
+			}
+		}
+	}
+}
+
+std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info, bool is_stream_prepared)
 {
 	auto &client = ws_client->GetClient();
 	auto request = client->GetRequest();
@@ -481,12 +591,43 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::
 	ov::String application_name = info->internal_app_name;
 	ov::String stream_name = info->stream_name;
 
+	if (is_stream_prepared == false)
+	{
+		// When the stream is pulled from the origin, the thread of the signalling server is not blocked until it is completed
+		for (auto &observer : _observers)
+		{
+			auto on_prepared = [this, ws_client, info]() mutable {
+				if (info->is_closed)
+				{
+					logtd("The client is disconnected while the stream is prepared: %s", ws_client->ToString().CStr());
+					return;
+				}
+
+				auto error = DispatchRequestOffer(ws_client, info, true);
+
+				if (error != nullptr)
+				{
+					SendError(ws_client, "request_offer", info, error);
+					ws_client->Close();
+				}
+			};
+
+			if (observer->OnPrepareStream(ws_client, application_name, stream_name, on_prepared) == false)
+			{
+				logtd("Waiting for the stream to be prepared: [%s/%s], client: %s", application_name.CStr(), stream_name.CStr(), ws_client->ToString().CStr());
+
+				// The offer will be sent by on_prepared
+				return nullptr;
+			}
+		}
+	}
+
 	std::shared_ptr<SessionDescription> sdp = nullptr;
 	std::shared_ptr<ov::Error> error = nullptr;
 
 	std::shared_ptr<RtcPeerInfo> host_peer = nullptr;
 
-	std::shared_ptr<RtcPeerInfo> peer_info = _p2p_manager.CreatePeerInfo(info->id, ws_client);
+	std::shared_ptr<RtcPeerInfo> peer_info = _p2p_manager.CreatePeerInfo(info->id, ov::String::FormatString("%s/%s", application_name.CStr(), stream_name.CStr()), info->uplink_kbps, ws_client);
 
 	if (peer_info == nullptr)
 	{
@@ -529,7 +670,7 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::
 		}
 
 		// None of the hosts can accept this client, so the peer will be connectioned to OME
-		std::find_if(_observers.begin(), _observers.end(), [ws_client, info, &sdp, application_name, stream_name](auto &observer) -> bool {
+		auto offer_observer = std::find_if(_observers.begin(), _observers.end(), [ws_client, info, &sdp, application_name, stream_name](auto &observer) -> bool {
 			// Ask observer to fill local_candidates
 			sdp = observer->OnRequestOffer(ws_client, application_name, stream_name, &(info->local_candidates));
 			return sdp != nullptr;
@@ -556,53 +697,78 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::
 				// P2P manager is disabled
 			}
 
-			ov::JsonObject response_json;
-
-			Json::Value &value = response_json.GetJsonValue();
-
-			// Create a "SDP" object into value
-			Json::Value &sdp_value = value["sdp"];
-
 			// Generate offer_sdp string from SessionDescription
 			ov::String offer_sdp;
 			if (sdp->ToString(offer_sdp))
 			{
-				value["command"] = "offer";
-				value["id"] = info->id;
-				value["peer_id"] = P2P_OME_PEER_ID;
-				sdp_value["sdp"] = offer_sdp.CStr();
-				sdp_value["type"] = "offer";
+				// The offer is the largest message of the signalling, so it is written directly without a ::Json::Value tree
+				ov::JsonWriter writer(offer_sdp.GetLength() + 1024);
 
-				// candidates: [ <candidate>, <candidate>, ... ]
-				Json::Value candidates(Json::ValueType::arrayValue);
+				writer.BeginObject()
+					.Member("command", "offer")
+					.Member("id", info->id)
+					.Member("peer_id", P2P_OME_PEER_ID);
+
+				writer.Key("sdp")
+					.BeginObject()
+					.Member("sdp", offer_sdp)
+					.Member("type", "offer")
+					.EndObject();
 
+				// candidates: [ <candidate>, <candidate>, ... ]
+				//
 				// candiate:
 				// {
 				//     "candidate":"candidate:0 1 UDP 50 192.168.0.183 10000 typ host generation 0",
 				//     "sdpMLineIndex":0,
 				//     "sdpMid":"video"
 				// }
+				writer.Key("candidates").BeginArray();
 
-				// Send local candidate list to client
-				for (const auto &candidate : info->local_candidates)
+				// Send local candidate list to client (See SendLocalCandidates() for the trickle ICE)
+				if (info->is_trickle == false)
 				{
-					Json::Value item;
-
-					item["candidate"] = candidate.GetCandidateString().CStr();
-					item["sdpMLineIndex"] = candidate.GetSdpMLineIndex();
-					if (candidate.GetSdpMid().IsEmpty() == false)
+					for (const auto &candidate : info->local_candidates)
 					{
-						item["sdpMid"] = candidate.GetSdpMid().CStr();
+						writer.BeginObject()
+							.Member("candidate", candidate.GetCandidateString())
+							.Member("sdpMLineIndex", candidate.GetSdpMLineIndex());
+
+						if (candidate.GetSdpMid().IsEmpty() == false)
+						{
+							writer.Member("sdpMid", candidate.GetSdpMid());
+						}
+
+						writer.EndObject();
 					}
+				}
 
-					candidates.append(item);
+				writer.EndArray();
+
+				// sframe: { "kid": <key id>, "key": <base64 encoded base key> }
+				uint64_t key_id = 0;
+				std::shared_ptr<const ov::Data> key;
+
+				if ((*offer_observer)->OnGetFrameEncryptionKey(ws_client, application_name, stream_name, &key_id, &key))
+				{
+					writer.Key("sframe")
+						.BeginObject()
+						.Member("kid", key_id)
+						.Member("key", ov::Base64::Encode(key))
+						.EndObject();
 				}
-				value["candidates"] = candidates;
-				value["code"] = static_cast<int>(HttpStatusCode::OK);
+
+				writer.Member("code", static_cast<int>(HttpStatusCode::OK))
+					.EndObject();
 
 				info->offer_sdp = sdp;
 
-				ws_client->Send(response_json.ToString());
+				ws_client->Send(writer);
+
+				if (info->is_trickle)
+				{
+					SendLocalCandidates(ws_client, info);
+				}
 			}
 			else
 			{
@@ -625,6 +791,9 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchRequestOffer(const std::
 			  host_peer->ToString().CStr(),
 			  peer_info->ToString().CStr());
 
+		logti("P2P: %d of %d peers are served by the other peers (offloaded: %.1f%%)",
+			  _p2p_manager.GetClientPeerCount(), _p2p_manager.GetPeerCount(), _p2p_manager.GetOffloadedPercentage());
+
 		// Send 'request_offer_p2p' command to the host
 		Json::Value value;
 
@@ -723,6 +892,33 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchAnswer(const std::shared
 	return nullptr;
 }
 
+void RtcSignallingServer::SendLocalCandidates(const std::shared_ptr<WebSocketClient> &ws_client, const std::shared_ptr<RtcSignallingInfo> &info)
+{
+	// The player can apply the offer and start the checks of the candidates while the others are received
+	for (const auto &candidate : info->local_candidates)
+	{
+		Json::Value value;
+
+		value["command"] = "candidate";
+		value["id"] = info->id;
+		value["peer_id"] = P2P_OME_PEER_ID;
+
+		Json::Value candidate_value;
+
+		candidate_value["candidate"] = candidate.GetCandidateString().CStr();
+		candidate_value["sdpMLineIndex"] = candidate.GetSdpMLineIndex();
+
+		if (candidate.GetSdpMid().IsEmpty() == false)
+		{
+			candidate_value["sdpMid"] = candidate.GetSdpMid().CStr();
+		}
+
+		value["candidates"].append(candidate_value);
+
+		ws_client->Send(value);
+	}
+}
+
 std::shared_ptr<ov::Error> RtcSignallingServer::DispatchCandidate(const std::shared_ptr<WebSocketClient> &ws_client, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info)
 {
 	const Json::Value &candidates_value = object.GetJsonValue("candidates");
@@ -921,9 +1117,10 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchStop(const std::shared_p
 
 		if (info->id != P2P_INVALID_PEER_ID)
 		{
-			auto lock_guard = std::lock_guard(_client_list_mutex);
+			auto &shard = GetClientShard(info->id);
+			auto lock_guard = std::lock_guard(shard.mutex);
 
-			_client_list.erase(info->id);
+			shard.client_list.erase(info->id);
 			info->id = P2P_INVALID_PEER_ID;
 		}
 
@@ -931,54 +1128,36 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchStop(const std::shared_p
 		{
 			logtd("Deleting a peer from p2p manager...: %s", peer_info->ToString().CStr());
 
-			_p2p_manager.RemovePeer(peer_info);
-
-			if (peer_info->IsHost())
-			{
-				logtd("[Host -> OME] The host peer is requested stop: %s", peer_info->ToString().CStr());
-
-				// Broadcast to client peers
-				auto client_list = _p2p_manager.GetClientPeerList(peer_info);
+			// A client peer may relay the stream to its own clients, so both of the host and the clients are handled
+			auto host_info = peer_info->GetHostPeer();
+			auto client_list = _p2p_manager.GetClientPeerList(peer_info);
 
-				for (auto &client : client_list)
-				{
-					auto &client_info = client.second;
-
-					Json::Value value;
-
-					value["command"] = "stop";
-					value["id"] = client_info->GetId();
-					value["peer_id"] = peer_info->GetId();
-
-					client_info->GetResponse()->Send(value);
+			_p2p_manager.RemovePeer(peer_info);
 
-					// remove client from peer
-					_p2p_manager.RemovePeer(client_info);
-				}
-			}
-			else
+			if (host_info != nullptr)
 			{
 				// Client peer -> OME
 				logtd("[Client -> OME] The client peer is requested stop: %s", peer_info->ToString().CStr());
 
 				// Send to host peer
-				auto host_info = peer_info->GetHostPeer();
+				Json::Value value;
 
-				if (host_info != nullptr)
-				{
-					Json::Value value;
+				value["command"] = "stop";
+				value["id"] = host_info->GetId();
+				value["peer_id"] = peer_info->GetId();
 
-					value["command"] = "stop";
-					value["id"] = host_info->GetId();
-					value["peer_id"] = peer_info->GetId();
-
-					host_info->GetResponse()->Send(value);
-				}
-				else
-				{
-					// The peer disconnected before dispatch request_offer
-				}
+				host_info->GetResponse()->Send(value);
+			}
+			else if (peer_info->IsHost())
+			{
+				logtd("[Host -> OME] The host peer is requested stop: %s", peer_info->ToString().CStr());
 			}
+			else
+			{
+				// The peer disconnected before dispatch request_offer
+			}
+
+			RebalanceClientPeers(peer_info, client_list);
 		}
 		else
 		{
@@ -993,3 +1172,51 @@ std::shared_ptr<ov::Error> RtcSignallingServer::DispatchStop(const std::shared_p
 
 	return nullptr;
 }
+
+void RtcSignallingServer::RebalanceClientPeers(const std::shared_ptr<RtcPeerInfo> &left_peer, const std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>> &client_list)
+{
+	for (auto &client : client_list)
+	{
+		auto &client_info = client.second;
+
+		// The connection to the peer that has left is closed
+		{
+			Json::Value value;
+
+			value["command"] = "stop";
+			value["id"] = client_info->GetId();
+			value["peer_id"] = left_peer->GetId();
+
+			client_info->GetResponse()->Send(value);
+		}
+
+		auto new_host_peer = _p2p_manager.ReassignClientPeer(client_info);
+
+		if (new_host_peer != nullptr)
+		{
+			logtd("[Client -> Host] The client is reassigned to another host\n    Host: %s\n    Client: %s",
+				  new_host_peer->ToString().CStr(),
+				  client_info->ToString().CStr());
+
+			// The new host sends an offer to the client (the same as a new client)
+			Json::Value value;
+
+			value["command"] = "request_offer_p2p";
+			value["id"] = new_host_peer->GetId();
+			value["peer_id"] = client_info->GetId();
+
+			new_host_peer->GetResponse()->Send(value);
+		}
+		else
+		{
+			logtd("[Client -> OME] There is no host that can accept the client: %s", client_info->ToString().CStr());
+
+			// The client cannot relay the stream anymore, so its clients are reassigned too
+			auto sub_client_list = _p2p_manager.GetClientPeerList(client_info);
+
+			_p2p_manager.RemovePeer(client_info);
+
+			RebalanceClientPeers(client_info, sub_client_list);
+		}
+	}
+}
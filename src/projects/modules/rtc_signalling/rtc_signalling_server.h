@@ -17,19 +17,27 @@
 #include <media_router/media_router_application.h>
 #include <modules/ice/ice.h>
 
+#include <deque>
 #include <memory>
+#include <unordered_map>
 
 #include "modules/rtc_signalling/p2p/rtc_p2p_manager.h"
 #include "rtc_ice_candidate.h"
 #include "rtc_signalling_observer.h"
 
+// The client table is split by the peer id, so the connections/disconnections do not wait for each other
+#define RTC_SIGNALLING_CLIENT_SHARD_COUNT 16
+// The number of threads that generate the offers (0: the number of processors)
+#define RTC_SIGNALLING_OFFER_THREAD_COUNT 0
+
 class RtcSignallingServer : public ov::EnableSharedFromThis<RtcSignallingServer>
 {
 public:
 	RtcSignallingServer(const cfg::Server &server_config);
 	~RtcSignallingServer() override = default;
 
-	bool Start(const ov::SocketAddress *address, const ov::SocketAddress *tls_address);
+	bool Start(const ov::SocketAddress *address, const ov::SocketAddress *tls_address, int reactor_count = 1,
+			   int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT, bool worker_affinity = false);
 	bool Stop();
 
 	bool AddObserver(const std::shared_ptr<RtcSignallingObserver> &observer);
@@ -83,6 +91,13 @@ protected:
 		// Whether it's a peer used only as a client
 		bool peer_was_client = false;
 
+		// The uplink bandwidth that the player reported with "request_offer" (0: unknown), used to choose the P2P parents
+		uint32_t uplink_kbps = 0;
+
+		// The player reported "trickle": true with "request_offer", the offer is sent without the candidates,
+		// and they follow in a "candidate" command (the player sends its candidates with "candidate" anyway)
+		bool is_trickle = false;
+
 		std::shared_ptr<RtcPeerInfo> peer_info;
 
 		// Offer SDP (SDP of OME/host peer)
@@ -95,20 +110,61 @@ protected:
 
 		// candidates of host/client peer
 		std::vector<RtcIceCandidate> remote_candidates;
+
+		// Set when the WebSocket is closed, the offer that was waiting for the stream is not sent
+		std::atomic<bool> is_closed{false};
 	};
 
 	using SdpCallback = std::function<void(std::shared_ptr<SessionDescription> sdp, std::shared_ptr<ov::Error> error)>;
 
+	struct ClientShard
+	{
+		std::mutex mutex;
+		std::unordered_map<peer_id_t, std::shared_ptr<RtcSignallingInfo>> client_list;
+	};
+
+	struct OfferRequest
+	{
+		std::shared_ptr<WebSocketClient> ws_client;
+		std::shared_ptr<RtcSignallingInfo> info;
+	};
+
+	// The offer requests of a stream, which are processed by one task of _offer_executor
+	struct OfferQueue
+	{
+		std::deque<OfferRequest> requests;
+		// Whether a task is posted to process the requests
+		bool is_scheduled = false;
+	};
+
+	ClientShard &GetClientShard(peer_id_t id)
+	{
+		return _client_shards[static_cast<uint32_t>(id) % RTC_SIGNALLING_CLIENT_SHARD_COUNT];
+	}
+
 	bool InitializeWebSocketServer();
 
 	std::shared_ptr<ov::Error> DispatchCommand(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &command, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info, const std::shared_ptr<const WebSocketFrame> &message);
-	std::shared_ptr<ov::Error> DispatchRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info);
+	// If is_stream_prepared is false, the observers prepare the stream first, and the offer may be sent later on the other thread
+	std::shared_ptr<ov::Error> DispatchRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info, bool is_stream_prepared = false);
+	// Queues the request to generate the offer on _offer_executor instead of the thread of the WebSocket
+	std::shared_ptr<ov::Error> EnqueueRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info);
+	// Processes the queued requests of a stream in a batch
+	void ProcessRequestOffers(const ov::String &stream_key);
 	std::shared_ptr<ov::Error> DispatchAnswer(const std::shared_ptr<WebSocketClient> &ws_client, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info);
 	std::shared_ptr<ov::Error> DispatchCandidate(const std::shared_ptr<WebSocketClient> &ws_client, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info);
 	std::shared_ptr<ov::Error> DispatchOfferP2P(const std::shared_ptr<WebSocketClient> &ws_client, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info);
 	std::shared_ptr<ov::Error> DispatchCandidateP2P(const std::shared_ptr<WebSocketClient> &ws_client, const ov::JsonObject &object, std::shared_ptr<RtcSignallingInfo> &info);
 	std::shared_ptr<ov::Error> DispatchStop(const std::shared_ptr<WebSocketClient> &ws_client, std::shared_ptr<RtcSignallingInfo> &info);
 
+	// Finds new parents for the clients of the peer that has left, and asks them to send offers.
+	// The clients that cannot be reassigned are stopped (and their clients are reassigned in turn)
+	void RebalanceClientPeers(const std::shared_ptr<RtcPeerInfo> &left_peer, const std::map<peer_id_t, std::shared_ptr<RtcPeerInfo>> &client_list);
+
+	void SendLocalCandidates(const std::shared_ptr<WebSocketClient> &ws_client, const std::shared_ptr<RtcSignallingInfo> &info);
+
+	void SendError(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &command, const std::shared_ptr<RtcSignallingInfo> &info, const std::shared_ptr<ov::Error> &error);
+
 	const cfg::Server _server_config;
 
 	std::shared_ptr<HttpServer> _http_server;
@@ -116,8 +172,12 @@ protected:
 
 	std::vector<std::shared_ptr<RtcSignallingObserver>> _observers;
 
-	std::map<peer_id_t, std::shared_ptr<RtcSignallingInfo>> _client_list;
-	std::shared_mutex _client_list_mutex;
+	ClientShard _client_shards[RTC_SIGNALLING_CLIENT_SHARD_COUNT];
+
+	ov::Executor _offer_executor;
+	// key: <internal app name>/<stream name>
+	std::map<ov::String, OfferQueue> _offer_queue_map;
+	std::mutex _offer_queue_map_mutex;
 
 	RtcP2PManager _p2p_manager;
 };
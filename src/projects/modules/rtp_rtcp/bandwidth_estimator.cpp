@@ -0,0 +1,361 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "bandwidth_estimator.h"
+
+#include <chrono>
+#include <cmath>
+
+#define OV_LOG_TAG "BandwidthEstimator"
+
+// The gain of the trend to compare with the threshold
+#define BWE_TRENDLINE_THRESHOLD_GAIN 4.0
+// Smoothing coefficient of the accumulated delay
+#define BWE_TRENDLINE_SMOOTHING_COEFFICIENT 0.9
+
+// Adaptive threshold of the overuse detector
+#define BWE_THRESHOLD_INITIAL 12.5
+#define BWE_THRESHOLD_MIN 6.0
+#define BWE_THRESHOLD_MAX 600.0
+#define BWE_THRESHOLD_K_UP 0.0087
+#define BWE_THRESHOLD_K_DOWN 0.039
+// The overuse must be continued for this time to be signaled
+#define BWE_OVERUSING_TIME_THRESHOLD_MS 10.0
+
+// AIMD
+#define BWE_INCREASE_RATE_PER_SECOND 1.08
+#define BWE_DECREASE_FACTOR 0.85
+#define BWE_DECREASE_INTERVAL_MS 200
+
+BandwidthEstimator::BandwidthEstimator(uint32_t start_bitrate, uint32_t min_bitrate, uint32_t max_bitrate)
+	: _min_bitrate(min_bitrate),
+	  _max_bitrate(max_bitrate),
+	  _threshold(BWE_THRESHOLD_INITIAL),
+	  _delay_based_bitrate(start_bitrate),
+	  _loss_based_bitrate(start_bitrate),
+	  _estimated_bitrate(start_bitrate)
+{
+	_sent_packets.resize(BWE_SENT_PACKET_HISTORY_SIZE);
+}
+
+int64_t BandwidthEstimator::GetNowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void BandwidthEstimator::SetStartBitrate(uint32_t bitrate)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_is_feedback_received)
+	{
+		return;
+	}
+
+	_delay_based_bitrate = std::max<double>(_min_bitrate, std::min<double>(bitrate, _max_bitrate));
+	_loss_based_bitrate = _delay_based_bitrate;
+	_estimated_bitrate = static_cast<uint32_t>(_delay_based_bitrate);
+}
+
+void BandwidthEstimator::OnPacketSent(uint16_t transport_sequence_number, size_t size)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto &packet = _sent_packets[transport_sequence_number & (BWE_SENT_PACKET_HISTORY_SIZE - 1)];
+
+	packet.is_valid = true;
+	packet.transport_sequence_number = transport_sequence_number;
+	packet.send_time_us = GetNowUs();
+	packet.size = size;
+}
+
+void BandwidthEstimator::OnTransportFeedback(const RtcpTransportFeedback &feedback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	int64_t now_ms = GetNowUs() / 1000;
+
+	_is_feedback_received = true;
+
+	int64_t first_arrival_time_us = -1;
+	int64_t last_arrival_time_us = -1;
+	size_t acknowledged_bytes = 0;
+
+	for (const auto &result : feedback.packets)
+	{
+		if (result.received == false)
+		{
+			continue;
+		}
+
+		auto &packet = _sent_packets[result.sequence_number & (BWE_SENT_PACKET_HISTORY_SIZE - 1)];
+
+		if ((packet.is_valid == false) || (packet.transport_sequence_number != result.sequence_number))
+		{
+			// Too old packet
+			continue;
+		}
+
+		acknowledged_bytes += packet.size;
+
+		if (first_arrival_time_us < 0)
+		{
+			first_arrival_time_us = result.arrival_time_us;
+		}
+
+		last_arrival_time_us = std::max(last_arrival_time_us, result.arrival_time_us);
+
+		if (_current_group.is_valid == false)
+		{
+			_current_group.is_valid = true;
+			_current_group.first_send_time_us = packet.send_time_us;
+			_current_group.last_send_time_us = packet.send_time_us;
+			_current_group.last_arrival_time_us = result.arrival_time_us;
+		}
+		else if (packet.send_time_us < _current_group.first_send_time_us)
+		{
+			// Reordered packet of the previous group
+		}
+		else if ((packet.send_time_us - _current_group.first_send_time_us) < BWE_BURST_INTERVAL_US)
+		{
+			_current_group.last_send_time_us = std::max(_current_group.last_send_time_us, packet.send_time_us);
+			_current_group.last_arrival_time_us = std::max(_current_group.last_arrival_time_us, result.arrival_time_us);
+		}
+		else
+		{
+			// A new group is started, so the delay variation between the previous group and the current group can be calculated
+			if (_previous_group.is_valid)
+			{
+				double send_delta_ms = (_current_group.last_send_time_us - _previous_group.last_send_time_us) / 1000.0;
+				double arrival_delta_ms = (_current_group.last_arrival_time_us - _previous_group.last_arrival_time_us) / 1000.0;
+
+				_last_delta_ms = send_delta_ms;
+				UpdateDelay(arrival_delta_ms - send_delta_ms, _current_group.last_arrival_time_us / 1000.0, now_ms);
+			}
+
+			_previous_group = _current_group;
+
+			_current_group.first_send_time_us = packet.send_time_us;
+			_current_group.last_send_time_us = packet.send_time_us;
+			_current_group.last_arrival_time_us = result.arrival_time_us;
+		}
+	}
+
+	if ((acknowledged_bytes > 0) && (last_arrival_time_us > first_arrival_time_us))
+	{
+		double bitrate = (acknowledged_bytes * 8.0 * 1000000.0) / (last_arrival_time_us - first_arrival_time_us);
+
+		_acknowledged_bitrate = (_acknowledged_bitrate == 0.0) ? bitrate : ((_acknowledged_bitrate * 0.8) + (bitrate * 0.2));
+	}
+
+	UpdateDelayBasedBitrate(now_ms);
+}
+
+void BandwidthEstimator::UpdateDelay(double delay_variation_ms, double arrival_time_ms, int64_t now_ms)
+{
+	_delay_sample_count++;
+
+	_accumulated_delay_ms += delay_variation_ms;
+	_smoothed_delay_ms = (_smoothed_delay_ms * BWE_TRENDLINE_SMOOTHING_COEFFICIENT) + (_accumulated_delay_ms * (1.0 - BWE_TRENDLINE_SMOOTHING_COEFFICIENT));
+
+	if (_first_arrival_time_ms < 0.0)
+	{
+		_first_arrival_time_ms = arrival_time_ms;
+	}
+
+	_delay_samples.emplace_back(arrival_time_ms - _first_arrival_time_ms, _smoothed_delay_ms);
+
+	if (_delay_samples.size() > BWE_TRENDLINE_WINDOW_SIZE)
+	{
+		_delay_samples.pop_front();
+	}
+
+	double trend = _previous_trend;
+
+	if (_delay_samples.size() == BWE_TRENDLINE_WINDOW_SIZE)
+	{
+		// Slope of the linear regression
+		double sum_x = 0.0;
+		double sum_y = 0.0;
+
+		for (const auto &sample : _delay_samples)
+		{
+			sum_x += sample.first;
+			sum_y += sample.second;
+		}
+
+		double average_x = sum_x / _delay_samples.size();
+		double average_y = sum_y / _delay_samples.size();
+
+		double numerator = 0.0;
+		double denominator = 0.0;
+
+		for (const auto &sample : _delay_samples)
+		{
+			numerator += (sample.first - average_x) * (sample.second - average_y);
+			denominator += (sample.first - average_x) * (sample.first - average_x);
+		}
+
+		if (denominator != 0.0)
+		{
+			trend = numerator / denominator;
+		}
+	}
+
+	// Overuse detection
+	double modified_trend = std::min<size_t>(_delay_sample_count, 60) * trend * BWE_TRENDLINE_THRESHOLD_GAIN;
+
+	if (modified_trend > _threshold)
+	{
+		if (_overusing_time_ms < 0.0)
+		{
+			// Initialize the timer, assuming that the overuse is started in the middle of the groups
+			_overusing_time_ms = _last_delta_ms / 2.0;
+		}
+		else
+		{
+			_overusing_time_ms += _last_delta_ms;
+		}
+
+		_overuse_count++;
+
+		if ((_overusing_time_ms > BWE_OVERUSING_TIME_THRESHOLD_MS) && (_overuse_count > 1) && (trend >= _previous_trend))
+		{
+			_overusing_time_ms = 0.0;
+			_overuse_count = 0;
+			_usage = BandwidthUsage::Overusing;
+		}
+	}
+	else if (modified_trend < -_threshold)
+	{
+		_overusing_time_ms = -1.0;
+		_overuse_count = 0;
+		_usage = BandwidthUsage::Underusing;
+	}
+	else
+	{
+		_overusing_time_ms = -1.0;
+		_overuse_count = 0;
+		_usage = BandwidthUsage::Normal;
+	}
+
+	_previous_trend = trend;
+
+	UpdateThreshold(modified_trend, now_ms);
+}
+
+void BandwidthEstimator::UpdateThreshold(double modified_trend, int64_t now_ms)
+{
+	if (_last_threshold_update_ms < 0)
+	{
+		_last_threshold_update_ms = now_ms;
+	}
+
+	double absolute_trend = std::fabs(modified_trend);
+
+	if (absolute_trend > (_threshold + 15.0))
+	{
+		// Don't adapt to the sudden spike (e.g. the route is changed)
+		_last_threshold_update_ms = now_ms;
+		return;
+	}
+
+	double k = (absolute_trend < _threshold) ? BWE_THRESHOLD_K_DOWN : BWE_THRESHOLD_K_UP;
+	int64_t elapsed_ms = std::min<int64_t>(now_ms - _last_threshold_update_ms, 100);
+
+	_threshold += k * (absolute_trend - _threshold) * elapsed_ms;
+	_threshold = std::max(BWE_THRESHOLD_MIN, std::min(_threshold, BWE_THRESHOLD_MAX));
+
+	_last_threshold_update_ms = now_ms;
+}
+
+void BandwidthEstimator::UpdateDelayBasedBitrate(int64_t now_ms)
+{
+	if (_last_delay_based_update_ms < 0)
+	{
+		_last_delay_based_update_ms = now_ms;
+	}
+
+	int64_t elapsed_ms = std::max<int64_t>(0, std::min<int64_t>(now_ms - _last_delay_based_update_ms, 1000));
+
+	switch (_usage)
+	{
+		case BandwidthUsage::Overusing:
+			if ((_last_decrease_ms < 0) || ((now_ms - _last_decrease_ms) >= BWE_DECREASE_INTERVAL_MS))
+			{
+				double base_bitrate = (_acknowledged_bitrate > 0.0) ? _acknowledged_bitrate : _delay_based_bitrate;
+
+				_delay_based_bitrate = std::min(_delay_based_bitrate, base_bitrate * BWE_DECREASE_FACTOR);
+				_last_decrease_ms = now_ms;
+			}
+			break;
+
+		case BandwidthUsage::Underusing:
+			// Hold the bitrate until the queues are drained
+			break;
+
+		case BandwidthUsage::Normal:
+		{
+			double bitrate = _delay_based_bitrate * std::pow(BWE_INCREASE_RATE_PER_SECOND, elapsed_ms / 1000.0);
+
+			if (_acknowledged_bitrate > 0.0)
+			{
+				// Don't increase too far beyond the bitrate which is actually sent
+				bitrate = std::max(_delay_based_bitrate, std::min(bitrate, (_acknowledged_bitrate * 1.5) + 10000.0));
+			}
+
+			_delay_based_bitrate = bitrate;
+			break;
+		}
+	}
+
+	_delay_based_bitrate = std::max<double>(_min_bitrate, std::min<double>(_delay_based_bitrate, _max_bitrate));
+	_last_delay_based_update_ms = now_ms;
+
+	UpdateEstimatedBitrate();
+}
+
+void BandwidthEstimator::OnReceiverReport(uint8_t fraction_lost)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	double loss = fraction_lost / 256.0;
+
+	if (loss < 0.02)
+	{
+		_loss_based_bitrate *= 1.05;
+	}
+	else if (loss > 0.1)
+	{
+		_loss_based_bitrate = _estimated_bitrate * (1.0 - (0.5 * loss));
+	}
+
+	_loss_based_bitrate = std::max<double>(_min_bitrate, std::min<double>(_loss_based_bitrate, _max_bitrate));
+
+	UpdateEstimatedBitrate();
+}
+
+void BandwidthEstimator::UpdateEstimatedBitrate()
+{
+	auto estimated_bitrate = static_cast<uint32_t>(std::min(_delay_based_bitrate, _loss_based_bitrate));
+
+	if (estimated_bitrate != _estimated_bitrate)
+	{
+		logtd("Estimated bitrate is changed: %u -> %u (delay-based: %.0f, loss-based: %.0f, acknowledged: %.0f)",
+			  _estimated_bitrate, estimated_bitrate, _delay_based_bitrate, _loss_based_bitrate, _acknowledged_bitrate);
+	}
+
+	_estimated_bitrate = estimated_bitrate;
+}
+
+uint32_t BandwidthEstimator::GetEstimatedBitrate() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	return _estimated_bitrate;
+}
@@ -0,0 +1,120 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "rtcp_packet.h"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#define BWE_START_BITRATE (1000 * 1000)
+#define BWE_MIN_BITRATE (100 * 1000)
+#define BWE_MAX_BITRATE (20 * 1000 * 1000)
+
+// The number of the sent packets kept to match the transport-wide feedback (must be the power of 2)
+#define BWE_SENT_PACKET_HISTORY_SIZE 4096
+// The packets sent within this interval are grouped as a burst
+#define BWE_BURST_INTERVAL_US 5000
+// The number of the delay samples used to calculate the trend of the delay
+#define BWE_TRENDLINE_WINDOW_SIZE 20
+
+// Estimates the available bandwidth of a session from the transport-wide congestion control feedback and receiver reports.
+// This is a simplified version of the Google Congestion Control (draft-ietf-rmcat-gcc-02):
+//  - Delay-based: the trend of the one-way delay variation of the packet groups is used to detect the overuse,
+//                 and the bitrate is controlled with AIMD
+//  - Loss-based: the bitrate is decreased when the fraction lost of the receiver report is high
+// The estimated bitrate is min(delay-based, loss-based).
+class BandwidthEstimator
+{
+public:
+	explicit BandwidthEstimator(uint32_t start_bitrate = BWE_START_BITRATE, uint32_t min_bitrate = BWE_MIN_BITRATE, uint32_t max_bitrate = BWE_MAX_BITRATE);
+
+	// Replaces the initial estimate (ignored after the feedback is received)
+	void SetStartBitrate(uint32_t bitrate);
+
+	// Called when a packet that has the transport-wide sequence number is sent
+	void OnPacketSent(uint16_t transport_sequence_number, size_t size);
+
+	void OnTransportFeedback(const RtcpTransportFeedback &feedback);
+	// fraction_lost: 1/256
+	void OnReceiverReport(uint8_t fraction_lost);
+
+	// bps
+	uint32_t GetEstimatedBitrate() const;
+
+private:
+	enum class BandwidthUsage
+	{
+		Normal,
+		Underusing,
+		Overusing
+	};
+
+	struct SentPacket
+	{
+		bool is_valid = false;
+		uint16_t transport_sequence_number = 0;
+		int64_t send_time_us = 0;
+		size_t size = 0;
+	};
+
+	struct PacketGroup
+	{
+		bool is_valid = false;
+		int64_t first_send_time_us = 0;
+		int64_t last_send_time_us = 0;
+		int64_t last_arrival_time_us = 0;
+	};
+
+	static int64_t GetNowUs();
+
+	void UpdateDelay(double delay_variation_ms, double arrival_time_ms, int64_t now_ms);
+	void UpdateThreshold(double modified_trend, int64_t now_ms);
+	void UpdateDelayBasedBitrate(int64_t now_ms);
+	void UpdateEstimatedBitrate();
+
+	mutable std::mutex _mutex;
+
+	uint32_t _min_bitrate;
+	uint32_t _max_bitrate;
+
+	std::vector<SentPacket> _sent_packets;
+
+	PacketGroup _current_group;
+	PacketGroup _previous_group;
+
+	// Trendline filter
+	double _accumulated_delay_ms = 0.0;
+	double _smoothed_delay_ms = 0.0;
+	double _first_arrival_time_ms = -1.0;
+	size_t _delay_sample_count = 0;
+	std::deque<std::pair<double, double>> _delay_samples;
+
+	// Overuse detector
+	double _threshold;
+	double _previous_trend = 0.0;
+	int64_t _last_threshold_update_ms = -1;
+	double _overusing_time_ms = -1.0;
+	int _overuse_count = 0;
+	double _last_delta_ms = 0.0;
+	BandwidthUsage _usage = BandwidthUsage::Normal;
+
+	// The bitrate acknowledged by the feedback (bps)
+	double _acknowledged_bitrate = 0.0;
+
+	// Rate controllers (bps)
+	double _delay_based_bitrate;
+	double _loss_based_bitrate;
+	int64_t _last_delay_based_update_ms = -1;
+	int64_t _last_decrease_ms = -1;
+
+	uint32_t _estimated_bitrate;
+	bool _is_feedback_received = false;
+};
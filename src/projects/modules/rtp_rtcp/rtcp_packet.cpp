@@ -102,6 +102,12 @@ ov::String  RtcpPacket::GetPacketTypeString(RtcpPacketType type)
         case RtcpPacketType::APP :
             result = "APP";
             break;
+        case RtcpPacketType::RTPFB :
+            result = "RTPFB";
+            break;
+        case RtcpPacketType::PSFB :
+            result = "PSFB";
+            break;
     }
 
     return result;
@@ -131,7 +137,7 @@ bool RtcpPacket::IsRtcpPacket(const std::shared_ptr<const ov::Data> &data,
     // rtcp rr packet check
     if(version != RTCP_HEADER_VERSION ||
        type < (int)RtcpPacketType::SR ||
-       type > (int)RtcpPacketType::APP ||
+       type > (int)RtcpPacketType::PSFB ||
        data->GetLength() < RTCP_HEADER_SIZE + payload_size)
     {
         return false;
@@ -179,6 +185,251 @@ bool RtcpPacket::RrParseing(int report_count,
     return true;
 }
 
+//====================================================================================================
+// Generic NACK Parsing
+/*
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |V=2|P|  FMT=1  |  PT=RTPFB=205 |             length            |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                  SSRC of packet sender                        |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                  SSRC of media source                         |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |            PID                |             BLP               | FCI
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ :                              ...                              :
+
+ - PID: the sequence number of the lost packet
+ - BLP: bitmask of the following lost packets (bit i means PID + i + 1 is lost)
+ */
+//====================================================================================================
+bool RtcpPacket::NackParsing(const std::shared_ptr<const ov::Data> &data, RtcpNack &nack)
+{
+    if(data->GetLength() < RTCP_HEADER_SIZE + 8)
+    {
+        return false;
+    }
+
+    ov::ByteStream stream(data.get());
+    stream.Skip(RTCP_HEADER_SIZE);
+
+    nack.sender_ssrc = stream.ReadBE32();
+    nack.media_ssrc = stream.ReadBE32();
+
+    while(stream.Remained() >= 4)
+    {
+        uint16_t pid = stream.ReadBE16();
+        uint16_t blp = stream.ReadBE16();
+
+        nack.sequence_numbers.push_back(pid);
+
+        for(int bit = 0; bit < 16; bit++)
+        {
+            if(blp & (1 << bit))
+            {
+                nack.sequence_numbers.push_back(static_cast<uint16_t>(pid + bit + 1));
+            }
+        }
+    }
+
+    return true;
+}
+
+//====================================================================================================
+// Transport-wide congestion control feedback Parsing
+// (draft-holmer-rmcat-transport-wide-cc-extensions-01)
+/*
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |V=2|P|  FMT=15 |    PT=205     |           length              |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                     SSRC of packet sender                     |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                      SSRC of media source                     |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |      base sequence number     |      packet status count      |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                 reference time                | fb pkt. count |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |          packet chunk         |         packet chunk          |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ .                                                               .
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |         packet chunk          |  recv delta   |  recv delta   |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ .                                                               .
+ 
+ Packet chunk
+  - Run length chunk:    |0|S(2)|Run Length(13)|
+  - Status vector chunk: |1|S|symbol list(14)| (S=0: 14 symbols of 1 bit, S=1: 7 symbols of 2 bits)
+ Symbol: 0 = not received, 1 = small delta(1 byte), 2 = large or negative delta(2 bytes)
+ */
+//====================================================================================================
+#define RTCP_TRANSPORT_CC_SYMBOL_NOT_RECEIVED   (0)
+#define RTCP_TRANSPORT_CC_SYMBOL_SMALL_DELTA    (1)
+#define RTCP_TRANSPORT_CC_SYMBOL_LARGE_DELTA    (2)
+// Unit of the reference time: 64ms, Unit of the recv delta: 250us
+#define RTCP_TRANSPORT_CC_REFERENCE_TIME_UNIT_US    (64000)
+#define RTCP_TRANSPORT_CC_DELTA_UNIT_US             (250)
+
+bool RtcpPacket::TransportFeedbackParsing(const std::shared_ptr<const ov::Data> &data, RtcpTransportFeedback &feedback)
+{
+    if(data->GetLength() < RTCP_HEADER_SIZE + 16)
+    {
+        return false;
+    }
+
+    ov::ByteStream stream(data.get());
+    stream.Skip(RTCP_HEADER_SIZE);
+
+    feedback.sender_ssrc = stream.ReadBE32();
+    feedback.media_ssrc = stream.ReadBE32();
+    feedback.base_sequence_number = stream.ReadBE16();
+
+    uint16_t packet_status_count = stream.ReadBE16();
+    uint32_t reference_time_and_count = stream.ReadBE32();
+
+    // reference time is a 24 bits signed integer
+    auto reference_time = static_cast<int32_t>(reference_time_and_count) >> 8;
+    feedback.feedback_packet_count = static_cast<uint8_t>(reference_time_and_count & 0xFF);
+
+    // Symbols of the packets
+    std::vector<uint8_t> symbols;
+    symbols.reserve(packet_status_count);
+
+    while(symbols.size() < packet_status_count)
+    {
+        if(stream.Remained() < 2)
+        {
+            return false;
+        }
+
+        uint16_t chunk = stream.ReadBE16();
+        size_t remained_count = packet_status_count - symbols.size();
+
+        if((chunk & 0x8000) == 0)
+        {
+            // Run length chunk
+            uint8_t symbol = (chunk >> 13) & 0x03;
+            size_t run_length = std::min(static_cast<size_t>(chunk & 0x1FFF), remained_count);
+
+            symbols.insert(symbols.end(), run_length, symbol);
+        }
+        else if((chunk & 0x4000) == 0)
+        {
+            // Status vector chunk (14 symbols of 1 bit)
+            for(int index = 13; (index >= 0) && (symbols.size() < packet_status_count); index--)
+            {
+                symbols.push_back((chunk >> index) & 0x01);
+            }
+        }
+        else
+        {
+            // Status vector chunk (7 symbols of 2 bits)
+            for(int index = 6; (index >= 0) && (symbols.size() < packet_status_count); index--)
+            {
+                symbols.push_back((chunk >> (index * 2)) & 0x03);
+            }
+        }
+    }
+
+    feedback.packets.clear();
+    feedback.packets.reserve(packet_status_count);
+
+    int64_t arrival_time_us = static_cast<int64_t>(reference_time) * RTCP_TRANSPORT_CC_REFERENCE_TIME_UNIT_US;
+    auto sequence_number = feedback.base_sequence_number;
+
+    for(auto symbol : symbols)
+    {
+        RtcpTransportFeedback::PacketResult result;
+
+        result.sequence_number = sequence_number++;
+
+        if(symbol == RTCP_TRANSPORT_CC_SYMBOL_SMALL_DELTA)
+        {
+            if(stream.Remained() < 1)
+            {
+                return false;
+            }
+
+            arrival_time_us += static_cast<int64_t>(stream.Read8()) * RTCP_TRANSPORT_CC_DELTA_UNIT_US;
+            result.received = true;
+        }
+        else if(symbol == RTCP_TRANSPORT_CC_SYMBOL_LARGE_DELTA)
+        {
+            if(stream.Remained() < 2)
+            {
+                return false;
+            }
+
+            arrival_time_us += static_cast<int64_t>(static_cast<int16_t>(stream.ReadBE16())) * RTCP_TRANSPORT_CC_DELTA_UNIT_US;
+            result.received = true;
+        }
+
+        result.arrival_time_us = arrival_time_us;
+
+        feedback.packets.push_back(result);
+    }
+
+    return true;
+}
+
+//====================================================================================================
+// PLI/FIR Parsing
+/*
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |V=2|P|   FMT   |  PT=PSFB=206  |             length            |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                  SSRC of packet sender                        |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                  SSRC of media source (0 for FIR)             |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ |                              SSRC                             | FCI of FIR
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ | Seq nr.       |    Reserved                                   |
+ +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+ */
+//====================================================================================================
+bool RtcpPacket::KeyFrameRequestParsing(int fmt, const std::shared_ptr<const ov::Data> &data, std::vector<uint32_t> &media_ssrcs)
+{
+    if(data->GetLength() < RTCP_HEADER_SIZE + 8)
+    {
+        return false;
+    }
+
+    ov::ByteStream stream(data.get());
+    stream.Skip(RTCP_HEADER_SIZE);
+
+    // SSRC of packet sender
+    stream.ReadBE32();
+    uint32_t media_ssrc = stream.ReadBE32();
+
+    if(fmt == RTCP_PSFB_FMT_PLI)
+    {
+        media_ssrcs.push_back(media_ssrc);
+        return true;
+    }
+
+    if(fmt == RTCP_PSFB_FMT_FIR)
+    {
+        while(stream.Remained() >= 8)
+        {
+            media_ssrcs.push_back(stream.ReadBE32());
+            // Seq nr. + Reserved
+            stream.ReadBE32();
+        }
+
+        return (media_ssrcs.empty() == false);
+    }
+
+    return false;
+}
+
 //====================================================================================================
 // SR type packet Make
 /*
@@ -253,6 +504,81 @@ std::shared_ptr<ov::Data> RtcpPacket::MakeSrPacket(uint32_t ssrc, uint32_t rtp_t
     return MakeSrPacket(msw, lsw, ssrc, rtp_timestamp, packet_count, octet_count);
 }
 
+//====================================================================================================
+// Make Generic NACK Packet (RFC 4585 6.2.1)
+// - Each FCI has PID(the first lost packet) and BLP(the bitmask of the following 16 lost packets)
+//====================================================================================================
+std::shared_ptr<ov::Data> RtcpPacket::MakeNackPacket(uint32_t sender_ssrc, uint32_t media_ssrc, const std::vector<uint16_t> &sequence_numbers)
+{
+    std::vector<std::pair<uint16_t, uint16_t>> fci_list;
+
+    for(auto sequence_number : sequence_numbers)
+    {
+        if(fci_list.empty() == false)
+        {
+            auto &fci = fci_list.back();
+            auto distance = static_cast<uint16_t>(sequence_number - fci.first);
+
+            if((distance >= 1) && (distance <= 16))
+            {
+                fci.second |= (1 << (distance - 1));
+                continue;
+            }
+        }
+
+        fci_list.emplace_back(sequence_number, 0);
+    }
+
+    if(fci_list.empty())
+    {
+        return nullptr;
+    }
+
+    size_t length = RTCP_HEADER_SIZE + 8 + (fci_list.size() * 4);
+    auto nack_packet = std::make_shared<ov::Data>(length + RTCP_SRTCP_TRAILER_CAPACITY);
+
+    nack_packet->SetLength(length);
+    auto buffer = nack_packet->GetWritableDataAs<uint8_t>();
+
+    buffer[0] = (RTCP_HEADER_VERSION << 6) | RTCP_RTPFB_FMT_NACK;
+    buffer[1] = static_cast<uint8_t>(RtcpPacketType::RTPFB);
+    // The length in 32-bit words minus one
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[2], static_cast<uint16_t>((length / 4) - 1));
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[4], sender_ssrc);
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[8], media_ssrc);
+
+    size_t offset = RTCP_HEADER_SIZE + 8;
+
+    for(const auto &fci : fci_list)
+    {
+        ByteWriter<uint16_t>::WriteBigEndian(&buffer[offset], fci.first);
+        ByteWriter<uint16_t>::WriteBigEndian(&buffer[offset + 2], fci.second);
+        offset += 4;
+    }
+
+    return nack_packet;
+}
+
+//====================================================================================================
+// Make Picture Loss Indication Packet (RFC 4585 6.3.1)
+//====================================================================================================
+std::shared_ptr<ov::Data> RtcpPacket::MakePliPacket(uint32_t sender_ssrc, uint32_t media_ssrc)
+{
+    size_t length = RTCP_HEADER_SIZE + 8;
+    auto pli_packet = std::make_shared<ov::Data>(length + RTCP_SRTCP_TRAILER_CAPACITY);
+
+    pli_packet->SetLength(length);
+    auto buffer = pli_packet->GetWritableDataAs<uint8_t>();
+
+    buffer[0] = (RTCP_HEADER_VERSION << 6) | RTCP_PSFB_FMT_PLI;
+    buffer[1] = static_cast<uint8_t>(RtcpPacketType::PSFB);
+    ByteWriter<uint16_t>::WriteBigEndian(&buffer[2], static_cast<uint16_t>((length / 4) - 1));
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[4], sender_ssrc);
+    ByteWriter<uint32_t>::WriteBigEndian(&buffer[8], media_ssrc);
+
+    return pli_packet;
+}
+
 //====================================================================================================
 // Delay Calculation
 // - calculation form rr packet
@@ -11,6 +11,8 @@
 
 #define RTCP_HEADER_VERSION         (2)
 #define RTCP_HEADER_SIZE            (4)
+// The room for the trailer of SRTCP (auth tag up to 16 bytes + E/SRTCP index 4 bytes)
+#define RTCP_SRTCP_TRAILER_CAPACITY (20)
 #define RTCP_REPORT_BLOCK_LENGTH    (24)
 #define RTCP_MAX_BLOCK_COUNT        (0x1F)
 
@@ -22,11 +24,21 @@ enum class RtcpPacketType
     SDES = 202, // Source Description message
     BYE = 203,  // Bye message
     APP = 204,  // Application specfic RTCP
+    RTPFB = 205, // Transport layer feedback message (RFC 4585)
+    PSFB = 206, // Payload-specific feedback message (RFC 4585)
 };
 
+// FMT of the transport layer feedback message
+#define RTCP_RTPFB_FMT_NACK         (1)
+#define RTCP_RTPFB_FMT_TRANSPORT_CC (15) // Transport-wide congestion control feedback
+// FMT of the payload-specific feedback message
+#define RTCP_PSFB_FMT_PLI           (1) // Picture Loss Indication
+#define RTCP_PSFB_FMT_FIR           (4) // Full Intra Request (RFC 5104)
+
 struct RtcpReceiverReport
 {
-    time_t create_time = time(nullptr);
+    // Monotonic time in milliseconds (See ov::Clock)
+    int64_t create_time_ms = ov::Clock::CachedNowMs();
 
     uint32_t ssrc = 0;                      // Synchronization source
     uint32_t ssrc_1 = 0;                    //
@@ -42,6 +54,34 @@ struct RtcpReceiverReport
     double rtt = 0; // (Round Trip Time) calculation form rr packet
 };
 
+// Generic NACK (RTPFB, FMT=1)
+struct RtcpNack
+{
+    uint32_t sender_ssrc = 0;
+    uint32_t media_ssrc = 0;
+
+    // Lost packets
+    std::vector<uint16_t> sequence_numbers;
+};
+
+// Transport-wide congestion control feedback (RTPFB, FMT=15)
+struct RtcpTransportFeedback
+{
+    struct PacketResult
+    {
+        uint16_t sequence_number = 0;   // Transport-wide sequence number
+        bool received = false;
+        int64_t arrival_time_us = 0;    // Arrival time in the clock of the receiver (valid only if received)
+    };
+
+    uint32_t sender_ssrc = 0;
+    uint32_t media_ssrc = 0;
+    uint16_t base_sequence_number = 0;
+    uint8_t feedback_packet_count = 0;
+
+    std::vector<PacketResult> packets;
+};
+
 //====================================================================================================
 // RtcpPacket
 //====================================================================================================
@@ -65,8 +105,21 @@ public :
                             const std::shared_ptr<const ov::Data> &data,
                             std::vector<std::shared_ptr<RtcpReceiverReport>> &receiver_reports);
 
+    // data must contain only one NACK message (report_count is FMT of the feedback message)
+    static bool NackParsing(const std::shared_ptr<const ov::Data> &data, RtcpNack &nack);
+
+    // data must contain only one transport-wide congestion control feedback message
+    static bool TransportFeedbackParsing(const std::shared_ptr<const ov::Data> &data, RtcpTransportFeedback &feedback);
+
+    // Parses PLI or FIR, and returns the ssrcs of the media sources that need a key frame
+    static bool KeyFrameRequestParsing(int fmt, const std::shared_ptr<const ov::Data> &data, std::vector<uint32_t> &media_ssrcs);
+
     static std::shared_ptr<ov::Data> MakeSrPacket(uint32_t ssrc, uint32_t rtp_timestamp, uint32_t packet_count, uint32_t octet_count);
     static std::shared_ptr<ov::Data> MakeSrPacket(uint32_t lsr, uint32_t dlsr, uint32_t ssrc, uint32_t rtp_timestamp, uint32_t packet_count, uint32_t octet_count);
 
+    // Feedback messages of a receiver (the lost sequence numbers are packed into PID/BLP pairs)
+    static std::shared_ptr<ov::Data> MakeNackPacket(uint32_t sender_ssrc, uint32_t media_ssrc, const std::vector<uint16_t> &sequence_numbers);
+    static std::shared_ptr<ov::Data> MakePliPacket(uint32_t sender_ssrc, uint32_t media_ssrc);
+
     static double   DelayCalculation(uint32_t lsr, uint32_t dlsr);
 };
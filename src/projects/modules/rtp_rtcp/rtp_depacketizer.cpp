@@ -0,0 +1,324 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtp_depacketizer.h"
+
+#include "rtp_depacketizer_h264.h"
+
+#define OV_LOG_TAG "RtpDepacketizer"
+
+std::shared_ptr<RtpDepacketizer> RtpDepacketizer::Create(common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id)
+{
+	switch (codec_id)
+	{
+		case common::MediaCodecId::H264:
+			return std::make_shared<RtpDepacketizerH264>(media_type, track_id);
+
+		case common::MediaCodecId::Opus:
+			// An Opus payload is a frame
+			return std::make_shared<RtpDepacketizer>(media_type, track_id);
+
+		default:
+			return nullptr;
+	}
+}
+
+RtpDepacketizer::RtpDepacketizer(common::MediaType media_type, int32_t track_id)
+	: _media_type(media_type),
+	  _track_id(track_id),
+	  _slots(RTP_DEPACKETIZER_REORDER_BUFFER_SIZE)
+{
+	// The video frames before the first key frame cannot be decoded
+	_is_key_frame_required = (IsSinglePacketFrame() == false);
+
+	static_assert((RTP_DEPACKETIZER_REORDER_BUFFER_SIZE & (RTP_DEPACKETIZER_REORDER_BUFFER_SIZE - 1)) == 0, "RTP_DEPACKETIZER_REORDER_BUFFER_SIZE must be the power of 2");
+}
+
+void RtpDepacketizer::AppendPacket(const std::shared_ptr<const RtpPacket> &packet)
+{
+	if (packet->Buffer() == nullptr)
+	{
+		// Failed to parse
+		return;
+	}
+
+	uint16_t sequence_number = packet->SequenceNumber();
+
+	if (_is_first_packet)
+	{
+		_is_first_packet = false;
+		_next_sequence_number = sequence_number;
+		_highest_sequence_number = sequence_number;
+	}
+
+	auto distance = static_cast<int16_t>(sequence_number - _next_sequence_number);
+
+	if (distance < 0)
+	{
+		// Already processed or regarded as lost
+		return;
+	}
+
+	if (distance >= RTP_DEPACKETIZER_REORDER_BUFFER_SIZE)
+	{
+		// The packets before the window are regarded as lost to make room for this packet
+		uint16_t window_start = sequence_number - RTP_DEPACKETIZER_REORDER_BUFFER_SIZE + 1;
+
+		while (_next_sequence_number != window_start)
+		{
+			auto &slot = _slots[_next_sequence_number & (RTP_DEPACKETIZER_REORDER_BUFFER_SIZE - 1)];
+
+			if (slot.is_filled && (slot.sequence_number == _next_sequence_number))
+			{
+				ProcessPacket(*slot.packet);
+				slot.is_filled = false;
+				slot.packet = nullptr;
+				_pending_count--;
+			}
+			else
+			{
+				OnPacketLost();
+			}
+
+			_next_sequence_number++;
+		}
+
+		_is_waiting_for_missing_packet = false;
+	}
+
+	auto &slot = _slots[sequence_number & (RTP_DEPACKETIZER_REORDER_BUFFER_SIZE - 1)];
+
+	if (slot.is_filled)
+	{
+		// Duplicated
+		return;
+	}
+
+	slot.is_filled = true;
+	slot.sequence_number = sequence_number;
+	slot.packet = packet;
+	_pending_count++;
+
+	if (static_cast<int16_t>(sequence_number - _highest_sequence_number) > 0)
+	{
+		_highest_sequence_number = sequence_number;
+	}
+
+	Drain();
+}
+
+void RtpDepacketizer::Drain()
+{
+	while (_pending_count > 0)
+	{
+		auto &slot = _slots[_next_sequence_number & (RTP_DEPACKETIZER_REORDER_BUFFER_SIZE - 1)];
+
+		if (slot.is_filled && (slot.sequence_number == _next_sequence_number))
+		{
+			ProcessPacket(*slot.packet);
+			slot.is_filled = false;
+			slot.packet = nullptr;
+			_pending_count--;
+
+			_next_sequence_number++;
+			_is_waiting_for_missing_packet = false;
+			continue;
+		}
+
+		// There is a hole before the pending packets
+		auto current = std::chrono::steady_clock::now();
+
+		if (_is_waiting_for_missing_packet == false)
+		{
+			_is_waiting_for_missing_packet = true;
+			_missing_since = current;
+			break;
+		}
+
+		if (std::chrono::duration_cast<std::chrono::milliseconds>(current - _missing_since).count() < _max_delay_msec)
+		{
+			break;
+		}
+
+		// Give up waiting, the consecutive missing packets are skipped together
+		OnPacketLost();
+		_next_sequence_number++;
+	}
+}
+
+std::vector<uint16_t> RtpDepacketizer::GetMissingSequenceNumbers() const
+{
+	std::vector<uint16_t> missing_sequence_numbers;
+
+	if (_pending_count == 0)
+	{
+		return missing_sequence_numbers;
+	}
+
+	for (uint16_t sequence_number = _next_sequence_number; sequence_number != _highest_sequence_number; sequence_number++)
+	{
+		auto &slot = _slots[sequence_number & (RTP_DEPACKETIZER_REORDER_BUFFER_SIZE - 1)];
+
+		if ((slot.is_filled == false) || (slot.sequence_number != sequence_number))
+		{
+			missing_sequence_numbers.push_back(sequence_number);
+		}
+	}
+
+	return missing_sequence_numbers;
+}
+
+void RtpDepacketizer::ProcessPacket(const RtpPacket &packet)
+{
+	if (_has_frame && (packet.Timestamp() != _frame_timestamp))
+	{
+		// The marker of the previous frame is lost
+		CompleteFrame();
+	}
+
+	if (_has_frame == false)
+	{
+		BeginFrame(packet.Timestamp());
+	}
+
+	if (OnPayload(packet.Payload(), packet.PayloadSize()) == false)
+	{
+		_is_frame_corrupted = true;
+	}
+
+	if (packet.Marker() || IsSinglePacketFrame())
+	{
+		CompleteFrame();
+	}
+}
+
+void RtpDepacketizer::OnPacketLost()
+{
+	if (IsSinglePacketFrame())
+	{
+		// The other frames are not affected
+		return;
+	}
+
+	// It is not known whether the lost packet belongs to the current frame or the next one
+	if (_has_frame)
+	{
+		_is_frame_corrupted = true;
+	}
+
+	_is_next_frame_corrupted = true;
+}
+
+bool RtpDepacketizer::OnPayload(const uint8_t *payload, size_t length)
+{
+	return _frame->Append(payload, length);
+}
+
+void RtpDepacketizer::BeginFrame(uint32_t timestamp)
+{
+	_has_frame = true;
+	_frame_timestamp = timestamp;
+
+	// The previous frame is owned by the MediaPacket, so a new buffer is preallocated as large as the largest frame
+	_frame = std::make_shared<ov::Data>(_frame_capacity);
+	_fragmentation_header.fragmentation_offset.clear();
+	_fragmentation_header.fragmentation_length.clear();
+	_fragmentation_header.fragmentation_time_diff.clear();
+	_fragmentation_header.fragmentation_pl_type.clear();
+	_fragmentation_header.last_fragment_complete = false;
+	_is_key_frame = false;
+
+	_is_frame_corrupted = _is_next_frame_corrupted;
+	_is_next_frame_corrupted = false;
+
+	if (_is_first_timestamp)
+	{
+		_is_first_timestamp = false;
+		_last_timestamp = timestamp;
+	}
+
+	_extended_timestamp += static_cast<int32_t>(timestamp - _last_timestamp);
+	_last_timestamp = timestamp;
+}
+
+void RtpDepacketizer::CompleteFrame()
+{
+	if (_has_frame == false)
+	{
+		return;
+	}
+
+	_has_frame = false;
+
+	if (OnFrameEnd() == false)
+	{
+		_is_frame_corrupted = true;
+	}
+
+	auto frame = std::move(_frame);
+
+	if (frame->GetLength() == 0)
+	{
+		return;
+	}
+
+	_frame_capacity = std::max(_frame_capacity, frame->GetLength());
+
+	if (IsSinglePacketFrame() == false)
+	{
+		if (_is_frame_corrupted)
+		{
+			if (_is_key_frame_required == false)
+			{
+				logtd("A frame of track %d has been dropped due to the packet loss, waiting for a key frame", _track_id);
+			}
+
+			_is_key_frame_required = true;
+			return;
+		}
+
+		if (_is_key_frame_required)
+		{
+			if (_is_key_frame == false)
+			{
+				return;
+			}
+
+			_is_key_frame_required = false;
+		}
+	}
+
+	auto media_packet = std::make_shared<MediaPacket>(_media_type, _track_id, std::static_pointer_cast<const ov::Data>(frame),
+													  _extended_timestamp, _extended_timestamp, 0LL,
+													  _is_key_frame ? MediaPacketFlag::Key : MediaPacketFlag::NoFlag);
+
+	if (_fragmentation_header.GetCount() > 0)
+	{
+		_fragmentation_header.last_fragment_complete = true;
+		media_packet->SetFragHeader(&_fragmentation_header);
+	}
+
+	_media_packets.push_back(std::move(media_packet));
+}
+
+bool RtpDepacketizer::IsAvailableMediaPacket() const
+{
+	return _media_packets.empty() == false;
+}
+
+std::shared_ptr<MediaPacket> RtpDepacketizer::PopMediaPacket()
+{
+	if (_media_packets.empty())
+	{
+		return nullptr;
+	}
+
+	auto media_packet = std::move(_media_packets.front());
+	_media_packets.pop_front();
+
+	return media_packet;
+}
@@ -0,0 +1,129 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include "rtp_packet.h"
+
+// The number of packets that can be held for reordering (must be the power of 2)
+#define RTP_DEPACKETIZER_REORDER_BUFFER_SIZE 512
+// The time to wait for a missing packet before it is regarded as lost
+#define RTP_DEPACKETIZER_DEFAULT_MAX_DELAY_MSEC 200
+// The initial capacity of the frame buffer, it grows to the size of the largest frame
+#define RTP_DEPACKETIZER_DEFAULT_FRAME_CAPACITY (64 * 1024)
+
+// Reorders the received RTP packets of a track and reassembles them into MediaPackets.
+// It is used by every RTP ingest path, so the packets are depacketized the same way regardless of the transport.
+//
+// The base class treats a payload as a frame as is (audio codecs such as Opus),
+// and the subclasses parse the payload formats of the video codecs.
+//
+// Not thread-safe: the packets of a track must be appended by one thread at a time.
+class RtpDepacketizer
+{
+public:
+	// Returns nullptr if the codec is not supported
+	static std::shared_ptr<RtpDepacketizer> Create(common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id);
+
+	RtpDepacketizer(common::MediaType media_type, int32_t track_id);
+	virtual ~RtpDepacketizer() = default;
+
+	void SetMaxDelay(int max_delay_msec)
+	{
+		_max_delay_msec = max_delay_msec;
+	}
+
+	// The packets can be appended out of order, the late/duplicated packets are ignored
+	void AppendPacket(const std::shared_ptr<const RtpPacket> &packet);
+
+	bool IsAvailableMediaPacket() const;
+	std::shared_ptr<MediaPacket> PopMediaPacket();
+
+	// The sequence numbers that are not received yet between the reordered packets (to request NACK)
+	std::vector<uint16_t> GetMissingSequenceNumbers() const;
+
+	// A frame has been dropped by the packet loss, and frames are dropped until a key frame arrives (to request PLI/FIR)
+	bool IsKeyFrameRequired() const
+	{
+		return _is_key_frame_required;
+	}
+
+protected:
+	// Called with the payloads in order of the sequence number
+	// Returns false if the payload is malformed, then the frame is dropped
+	virtual bool OnPayload(const uint8_t *payload, size_t length);
+
+	// Called before the frame is completed
+	// Returns false if the frame is not complete (such as an unterminated fragmentation unit)
+	virtual bool OnFrameEnd()
+	{
+		return true;
+	}
+
+	// These are valid between the first payload and the end of a frame
+	std::shared_ptr<ov::Data> _frame;
+	FragmentationHeader _fragmentation_header;
+	bool _is_key_frame = false;
+
+private:
+	struct Slot
+	{
+		bool is_filled = false;
+		uint16_t sequence_number = 0;
+		std::shared_ptr<const RtpPacket> packet;
+	};
+
+	// Returns true if the frame of a packet has only one packet
+	bool IsSinglePacketFrame() const
+	{
+		return _media_type == common::MediaType::Audio;
+	}
+
+	void Drain();
+	void ProcessPacket(const RtpPacket &packet);
+	void OnPacketLost();
+
+	void BeginFrame(uint32_t timestamp);
+	void CompleteFrame();
+
+	common::MediaType _media_type;
+	int32_t _track_id;
+
+	int _max_delay_msec = RTP_DEPACKETIZER_DEFAULT_MAX_DELAY_MSEC;
+
+	// Reorder buffer, indexed by the sequence number
+	std::vector<Slot> _slots;
+	bool _is_first_packet = true;
+	uint16_t _next_sequence_number = 0;
+	uint16_t _highest_sequence_number = 0;
+	size_t _pending_count = 0;
+	bool _is_waiting_for_missing_packet = false;
+	std::chrono::steady_clock::time_point _missing_since;
+
+	// Frame assembly
+	bool _has_frame = false;
+	uint32_t _frame_timestamp = 0;
+	bool _is_frame_corrupted = false;
+	bool _is_next_frame_corrupted = false;
+	bool _is_key_frame_required = false;
+	size_t _frame_capacity = RTP_DEPACKETIZER_DEFAULT_FRAME_CAPACITY;
+
+	// RTP timestamp to PTS (the RTP timestamp is wrapped around in 32 bits)
+	bool _is_first_timestamp = true;
+	uint32_t _last_timestamp = 0;
+	int64_t _extended_timestamp = 0;
+
+	std::deque<std::shared_ptr<MediaPacket>> _media_packets;
+};
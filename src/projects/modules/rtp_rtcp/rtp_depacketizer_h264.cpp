@@ -0,0 +1,148 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtp_depacketizer_h264.h"
+
+#include <modules/h264/h264.h>
+
+#include "base/ovlibrary/byte_io.h"
+
+#define OV_LOG_TAG "RtpDepacketizer"
+
+#define RTP_H264_STAP_A 24
+#define RTP_H264_FU_A 28
+
+#define RTP_H264_FU_START_BIT 0x80
+#define RTP_H264_FU_END_BIT 0x40
+
+static constexpr uint8_t kAnnexBStartCode[4] = {0x00, 0x00, 0x00, 0x01};
+
+void RtpDepacketizerH264::AppendNalUnit(const uint8_t *nal_unit, size_t length)
+{
+	_frame->Append(kAnnexBStartCode, sizeof(kAnnexBStartCode));
+
+	_fragmentation_header.fragmentation_offset.push_back(_frame->GetLength());
+	_fragmentation_header.fragmentation_length.push_back(length);
+
+	_frame->Append(nal_unit, length);
+
+	if ((nal_unit[0] & kH264NalUnitTypeMask) == static_cast<uint8_t>(H264NalUnitType::IdrSlice))
+	{
+		_is_key_frame = true;
+	}
+}
+
+bool RtpDepacketizerH264::OnPayload(const uint8_t *payload, size_t length)
+{
+	if (length < 1)
+	{
+		return false;
+	}
+
+	uint8_t packet_type = payload[0] & kH264NalUnitTypeMask;
+
+	if (_is_fu_a_in_progress && (packet_type != RTP_H264_FU_A))
+	{
+		// The end of the previous FU-A is lost
+		_is_fu_a_in_progress = false;
+		return false;
+	}
+
+	if ((packet_type >= 1) && (packet_type <= 23))
+	{
+		// Single NAL unit
+		AppendNalUnit(payload, length);
+		return true;
+	}
+
+	if (packet_type == RTP_H264_STAP_A)
+	{
+		// STAP-A header(1) + [NALU size(2) + NALU] * N
+		size_t offset = 1;
+
+		while (offset < length)
+		{
+			if (offset + 2 > length)
+			{
+				logtw("Invalid STAP-A packet: no room for the NAL unit size");
+				return false;
+			}
+
+			size_t nal_unit_size = ByteReader<uint16_t>::ReadBigEndian(payload + offset);
+			offset += 2;
+
+			if ((nal_unit_size == 0) || (offset + nal_unit_size > length))
+			{
+				logtw("Invalid STAP-A packet: NAL unit size %zu exceeds the payload", nal_unit_size);
+				return false;
+			}
+
+			AppendNalUnit(payload + offset, nal_unit_size);
+			offset += nal_unit_size;
+		}
+
+		return true;
+	}
+
+	if (packet_type == RTP_H264_FU_A)
+	{
+		// FU indicator(1) + FU header(1) + fragment
+		if (length < 2)
+		{
+			return false;
+		}
+
+		uint8_t fu_header = payload[1];
+		bool is_start = (fu_header & RTP_H264_FU_START_BIT);
+		bool is_end = (fu_header & RTP_H264_FU_END_BIT);
+
+		if (is_start)
+		{
+			if (_is_fu_a_in_progress)
+			{
+				// The end of the previous FU-A is lost
+				return false;
+			}
+
+			// The NAL header is made of F/NRI of the FU indicator and the type of the FU header
+			uint8_t nal_header = (payload[0] & 0xE0) | (fu_header & kH264NalUnitTypeMask);
+
+			AppendNalUnit(&nal_header, 1);
+			_is_fu_a_in_progress = true;
+		}
+		else if (_is_fu_a_in_progress == false)
+		{
+			// The start of the FU-A is lost
+			return false;
+		}
+
+		_frame->Append(payload + 2, length - 2);
+		_fragmentation_header.fragmentation_length.back() += (length - 2);
+
+		if (is_end)
+		{
+			_is_fu_a_in_progress = false;
+		}
+
+		return true;
+	}
+
+	// STAP-B, MTAP and FU-B are only for the interleaved mode
+	logtw("Unsupported H.264 RTP packet type: %d", packet_type);
+	return false;
+}
+
+bool RtpDepacketizerH264::OnFrameEnd()
+{
+	if (_is_fu_a_in_progress)
+	{
+		_is_fu_a_in_progress = false;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,28 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "rtp_depacketizer.h"
+
+// Reassembles Single NAL unit, STAP-A and FU-A packets (RFC 6184, packetization-mode 0/1) into an Annex-B frame.
+// The fragmentation header of the MediaPacket points to each NAL unit (after the start code).
+class RtpDepacketizerH264 : public RtpDepacketizer
+{
+public:
+	using RtpDepacketizer::RtpDepacketizer;
+
+protected:
+	bool OnPayload(const uint8_t *payload, size_t length) override;
+	bool OnFrameEnd() override;
+
+private:
+	void AppendNalUnit(const uint8_t *nal_unit, size_t length);
+
+	// Whether the end of the FU-A which is being reassembled is not received yet
+	bool _is_fu_a_in_progress = false;
+};
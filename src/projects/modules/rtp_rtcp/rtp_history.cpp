@@ -0,0 +1,55 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtp_history.h"
+
+#define OV_LOG_TAG "RtpHistory"
+
+RtpHistory::RtpHistory(size_t capacity)
+{
+	// The sequence number is 16 bits, so no more than 65536 items are needed
+	size_t size = 1;
+
+	while ((size < capacity) && (size < 65536))
+	{
+		size <<= 1;
+	}
+
+	_items.resize(size);
+	_mask = size - 1;
+}
+
+void RtpHistory::Store(uint16_t sequence_number, uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto &item = _items[sequence_number & _mask];
+
+	item.sequence_number = sequence_number;
+	item.packet_type = packet_type;
+	item.packet = packet;
+}
+
+std::shared_ptr<const ov::Data> RtpHistory::Find(uint16_t sequence_number, uint32_t *packet_type) const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto &item = _items[sequence_number & _mask];
+
+	if ((item.packet == nullptr) || (item.sequence_number != sequence_number))
+	{
+		return nullptr;
+	}
+
+	if (packet_type != nullptr)
+	{
+		*packet_type = item.packet_type;
+	}
+
+	return item.packet;
+}
@@ -0,0 +1,45 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <mutex>
+#include <vector>
+
+// The number of packets kept for the retransmission (about 5 seconds of 2Mbps video)
+#define RTP_HISTORY_DEFAULT_CAPACITY 1024
+
+// A ring of the recently packetized RTP packets, indexed by the sequence number.
+// It is shared by all sessions of the stream, so the packets must not be modified (the sessions copy them before SRTP).
+class RtpHistory
+{
+public:
+	// capacity is rounded up to the power of 2
+	explicit RtpHistory(size_t capacity = RTP_HISTORY_DEFAULT_CAPACITY);
+
+	void Store(uint16_t sequence_number, uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet);
+
+	// Returns nullptr if the packet is not in the history (never stored or already overwritten)
+	std::shared_ptr<const ov::Data> Find(uint16_t sequence_number, uint32_t *packet_type) const;
+
+private:
+	struct Item
+	{
+		uint16_t sequence_number = 0;
+		// The packet type to pass to pub::Session::SendOutgoingData()
+		uint32_t packet_type = 0;
+		std::shared_ptr<const ov::Data> packet;
+	};
+
+	mutable std::mutex _mutex;
+
+	std::vector<Item> _items;
+	size_t _mask = 0;
+};
@@ -0,0 +1,240 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtp_pacer.h"
+
+#include <base/ovsocket/datagram_batch.h>
+
+#include <algorithm>
+#include <chrono>
+
+#define OV_LOG_TAG "RtpPacer"
+
+// Smoothing coefficient of the average queue delay
+#define RTP_PACER_QUEUE_DELAY_SMOOTHING 0.95
+// The budget can be accumulated to send at least a full-sized packet
+#define RTP_PACER_MIN_BUDGET_BYTES 1500
+
+RtpPacer::RtpPacer(SendCallback callback)
+	: _callback(std::move(callback))
+{
+}
+
+void RtpPacer::SetTargetBitrate(uint32_t target_bitrate)
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	if (target_bitrate == 0)
+	{
+		_pacing_rate = 0.0;
+		return;
+	}
+
+	auto pacing_bitrate = std::max(target_bitrate * RTP_PACER_PACING_FACTOR, static_cast<double>(RTP_PACER_MIN_PACING_BITRATE));
+
+	_pacing_rate = pacing_bitrate / 8.0;
+}
+
+void RtpPacer::Enqueue(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite)
+{
+	Item item;
+
+	item.packet = packet;
+
+	if (rewrite != nullptr)
+	{
+		item.is_rewritten = true;
+		item.rewrite = *rewrite;
+	}
+
+	item.enqueued_time_ms = RtpPacerScheduler::GetNowMs();
+
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	if (_is_stopped)
+	{
+		return;
+	}
+
+	_queue.push_back(std::move(item));
+}
+
+void RtpPacer::Stop()
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	_is_stopped = true;
+	_queue.clear();
+}
+
+double RtpPacer::GetAverageQueueDelayMs() const
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	return _average_queue_delay_ms;
+}
+
+size_t RtpPacer::GetQueueSize() const
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	return _queue.size();
+}
+
+void RtpPacer::Process(int64_t now_ms)
+{
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		auto elapsed_ms = (_last_process_ms == 0) ? RTP_PACER_TICK_MS : std::max(now_ms - _last_process_ms, static_cast<int64_t>(0));
+		_last_process_ms = now_ms;
+
+		if (_is_stopped || _queue.empty())
+		{
+			// Don't accumulate the budget while idle, the burst after the idle period is limited to max budget
+			_budget = std::min(_budget, 0.0);
+			return;
+		}
+
+		if (_pacing_rate > 0.0)
+		{
+			auto max_budget = std::max(_pacing_rate * RTP_PACER_MAX_BUDGET_MS / 1000.0, static_cast<double>(RTP_PACER_MIN_BUDGET_BYTES));
+
+			_budget = std::min(_budget + (_pacing_rate * elapsed_ms / 1000.0), max_budget);
+		}
+
+		while (_queue.empty() == false)
+		{
+			auto &item = _queue.front();
+			auto queue_delay_ms = now_ms - item.enqueued_time_ms;
+
+			if ((_pacing_rate > 0.0) && (_budget <= 0.0) && (queue_delay_ms < RTP_PACER_MAX_QUEUE_DELAY_MS))
+			{
+				break;
+			}
+
+			if (_pacing_rate > 0.0)
+			{
+				_budget -= item.packet->GetLength();
+			}
+
+			_average_queue_delay_ms = (_average_queue_delay_ms * RTP_PACER_QUEUE_DELAY_SMOOTHING) + (queue_delay_ms * (1.0 - RTP_PACER_QUEUE_DELAY_SMOOTHING));
+
+			_sending_items.push_back(std::move(item));
+			_queue.pop_front();
+		}
+	}
+
+	// The callback is called without the lock, because it takes the lock of the session
+	for (auto &item : _sending_items)
+	{
+		_callback(item.packet, item.is_rewritten ? &item.rewrite : nullptr);
+	}
+
+	_sending_items.clear();
+}
+
+RtpPacerScheduler::~RtpPacerScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+		_is_running = false;
+	}
+
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+}
+
+int64_t RtpPacerScheduler::GetNowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RtpPacerScheduler::Register(const std::shared_ptr<RtpPacer> &pacer)
+{
+	std::lock_guard<std::mutex> lock_guard(_mutex);
+
+	_pacers.push_back(pacer);
+
+	if (_is_running == false)
+	{
+		// The thread is started when the first pacer is registered
+		_is_running = true;
+		_thread = std::thread(&RtpPacerScheduler::SchedulerThread, this);
+	}
+}
+
+void RtpPacerScheduler::SchedulerThread()
+{
+	ov::ThreadMetrics thread_metrics("RtpPacer", ov::ThreadClass::NetworkIo);
+	std::vector<std::shared_ptr<RtpPacer>> pacers;
+	auto next_tick = std::chrono::steady_clock::now();
+
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock_guard(_mutex);
+
+			if (_is_running == false)
+			{
+				break;
+			}
+
+			auto iterator = _pacers.begin();
+
+			while (iterator != _pacers.end())
+			{
+				auto pacer = iterator->lock();
+
+				if (pacer == nullptr)
+				{
+					// The session is released
+					iterator = _pacers.erase(iterator);
+					continue;
+				}
+
+				pacers.push_back(std::move(pacer));
+				++iterator;
+			}
+		}
+
+		thread_metrics.CountLoop();
+
+		auto now_ms = GetNowMs();
+
+		{
+			// The packets sent by all pacers in this tick are sent with a few system calls
+			ov::DatagramBatch batch;
+
+			for (auto &pacer : pacers)
+			{
+				pacer->Process(now_ms);
+			}
+
+			batch.Flush();
+		}
+
+		pacers.clear();
+
+		next_tick += std::chrono::milliseconds(RTP_PACER_TICK_MS);
+
+		auto now = std::chrono::steady_clock::now();
+
+		if (next_tick < now)
+		{
+			// Too late (overloaded), don't try to catch up the missed ticks
+			next_tick = now;
+		}
+
+		thread_metrics.BeginIdle();
+		std::this_thread::sleep_until(next_tick);
+		thread_metrics.EndIdle();
+	}
+}
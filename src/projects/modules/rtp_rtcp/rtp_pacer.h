@@ -0,0 +1,110 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "rtp_rtcp.h"
+
+#include <base/ovlibrary/singleton.h>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// The period of sending the packets in the queues of the pacers
+#define RTP_PACER_TICK_MS 5
+// The packets are sent at (target bitrate * this factor)
+#define RTP_PACER_PACING_FACTOR 1.5
+// The pacing rate is not lower than this value, so the queue can be drained even if the target bitrate is underestimated
+#define RTP_PACER_MIN_PACING_BITRATE (300 * 1000)
+// The budget is accumulated up to this duration (to send a small burst after an idle period)
+#define RTP_PACER_MAX_BUDGET_MS 10
+// The packets waiting longer than this are sent regardless of the budget, to bound the latency
+#define RTP_PACER_MAX_QUEUE_DELAY_MS 500
+
+// Smooths the outgoing packets of a session with a token bucket.
+// A key frame is packetized and broadcasted at once, so without pacing it becomes a burst of hundreds of packets for each viewer.
+//
+// The packets are sent by the thread of RtpPacerScheduler which is shared by all pacers.
+class RtpPacer
+{
+public:
+	// Called by the thread of RtpPacerScheduler
+	using SendCallback = std::function<bool(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite)>;
+
+	explicit RtpPacer(SendCallback callback);
+
+	// bps, 0 means that the packets are not paced (sent at the next tick)
+	void SetTargetBitrate(uint32_t target_bitrate);
+
+	void Enqueue(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite);
+
+	// Discards the packets in the queue, and doesn't send any more packets
+	void Stop();
+
+	// Average time that the packets waited in the queue
+	double GetAverageQueueDelayMs() const;
+	size_t GetQueueSize() const;
+
+protected:
+	friend class RtpPacerScheduler;
+
+	void Process(int64_t now_ms);
+
+	struct Item
+	{
+		std::shared_ptr<const ov::Data> packet;
+		bool is_rewritten = false;
+		RtpHeaderRewrite rewrite;
+		int64_t enqueued_time_ms = 0;
+	};
+
+	SendCallback _callback;
+
+	mutable std::mutex _mutex;
+
+	bool _is_stopped = false;
+	std::deque<Item> _queue;
+
+	// bytes/s
+	double _pacing_rate = 0.0;
+	double _budget = 0.0;
+	int64_t _last_process_ms = 0;
+
+	double _average_queue_delay_ms = 0.0;
+
+	// Items being sent by Process() (reused to avoid the allocation for every tick)
+	std::vector<Item> _sending_items;
+};
+
+// Drives all pacers with a timer of RTP_PACER_TICK_MS.
+// The datagrams sent in a tick are sent together with sendmmsg() (See ov::DatagramBatch)
+class RtpPacerScheduler : public ov::Singleton<RtpPacerScheduler>
+{
+public:
+	~RtpPacerScheduler() override;
+
+	static int64_t GetNowMs();
+
+	// The pacer is removed from the scheduler when it is released
+	void Register(const std::shared_ptr<RtpPacer> &pacer);
+
+protected:
+	friend class ov::Singleton<RtpPacerScheduler>;
+
+	RtpPacerScheduler() = default;
+
+	void SchedulerThread();
+
+	std::mutex _mutex;
+	std::vector<std::weak_ptr<RtpPacer>> _pacers;
+
+	bool _is_running = false;
+	std::thread _thread;
+};
@@ -41,9 +41,6 @@ RtpPacket::RtpPacket(const std::shared_ptr<ov::Data> &data)
 		return;
 	}
 
-	// We don't use the Padding, Extension and CSRC yet. 
-	// If the P and the E are set, it can't be parsed but this class is used for a packet that generated from this class now,
-	// TODO(Getroot): RTP Packet parsing must be fully supported.
 	_padding_size = 0;
 	_extension_size = 0;
 
@@ -52,9 +49,9 @@ RtpPacket::RtpPacket(const std::shared_ptr<ov::Data> &data)
 	_origin_payload_type = 0;
 
 	// CC
-	//_cc = buffer[0] & 0xFF;
+	_cc = buffer[0] & 0x0F;
 	// Marker
-	_marker = (buffer[1] & (1 << 8));
+	_marker = (buffer[1] & 0x80) != 0;
 	// PT
 	_payload_type = buffer[1] & 0x7f;
 	// Sequence Number
@@ -63,8 +60,38 @@ RtpPacket::RtpPacket(const std::shared_ptr<ov::Data> &data)
 	_timestamp = ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
 	// SSRC
 	_ssrc = ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
-	_payload_offset = FIXED_HEADER_SIZE + _cc;
+	_payload_offset = FIXED_HEADER_SIZE + (_cc * 4);
+
+	// Extension (e.g. transport-wide sequence number that is added for each session)
+	if((buffer[0] & 0x10) && (data->GetLength() >= _payload_offset + 4))
+	{
+		// The length of the extension is in 32-bit words, excluding the 4 bytes of the extension header
+		_extension_size = 4 + (ByteReader<uint16_t>::ReadBigEndian(&buffer[_payload_offset + 2]) * 4);
+		_payload_offset += _extension_size;
+	}
+
+	if(data->GetLength() < _payload_offset)
+	{
+		// Wrong data
+		return;
+	}
+
 	_payload_size = data->GetLength() - _payload_offset;
+
+	// Padding (the last byte is the number of the padding bytes including itself)
+	if((buffer[0] & 0x20) && (_payload_size > 0))
+	{
+		uint8_t padding_size = buffer[data->GetLength() - 1];
+		if((padding_size == 0) || (padding_size > _payload_size))
+		{
+			// Wrong data
+			_payload_size = 0;
+			return;
+		}
+
+		_padding_size = padding_size;
+		_payload_size -= padding_size;
+	}
 	
 	// Full data
 	_data = data;
@@ -9,7 +9,14 @@
 #define RED_HEADER_SIZE				1
 #define ONE_BYTE_EXTENSION_ID		0xBEDE
 #define ONE_BYTE_HEADER_SIZE		1
+// Transport-wide sequence number (draft-holmer-rmcat-transport-wide-cc-extensions-01)
+#define RTP_TRANSPORT_CC_EXTENSION_URI	"http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01"
+#define RTP_TRANSPORT_CC_EXTENSION_ID	1
+// 0xBEDE(2) + length(2) + ID/L(1) + transport-wide sequence number(2) + padding(1)
+#define RTP_TRANSPORT_CC_EXTENSION_SIZE	8
 #define DEFAULT_MAX_PACKET_SIZE		1472
+// Room for the trailer that lower layers append to a packet (e.g. SRTP auth tag, up to SRTP_MAX_TRAILER_LEN)
+#define RTP_TRAILER_RESERVED_SIZE	144
 
 //  0                   1                   2                   3
 //  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
@@ -94,8 +101,8 @@ protected:
 	uint32_t	_ssrc = 0;
 	size_t		_payload_size = 0;		// Payload Size
 
-	//TODO: Extension은 향후 확장
-	size_t		_extension_size;
+	// Including the 4 bytes of the extension header (0xBEDE + length)
+	size_t		_extension_size = 0;
 
 	// BYTE로 변환된 헤더
 	// std::vector<uint8_t>	_buffer;
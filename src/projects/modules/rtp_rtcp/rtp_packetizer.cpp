@@ -17,6 +17,7 @@ RtpPacketizer::RtpPacketizer(std::shared_ptr<RtpRtcpPacketizerInterface> session
 	_sequence_number = (uint16_t)rand();
 	_red_sequence_number = (uint16_t)rand();
 	_ulpfec_enabled = false;
+	_red_enabled = true;
 }
 
 RtpPacketizer::~RtpPacketizer()
@@ -59,6 +60,26 @@ void RtpPacketizer::SetUlpfec(uint8_t red_payload_type, uint8_t ulpfec_payload_t
 	_ulpfec_payload_type = ulpfec_payload_type;
 }
 
+void RtpPacketizer::SetRedEnabled(bool enabled)
+{
+	if((_red_enabled == true) && (enabled == false))
+	{
+		// The packets of the current frame are not protected
+		_ulpfec_generator.Reset();
+	}
+
+	_red_enabled = enabled;
+}
+
+void RtpPacketizer::SetUlpfecProtectionRate(uint32_t media_packets_per_fec)
+{
+	if(_ulpfec_generator.GetProtectionRate() != media_packets_per_fec)
+	{
+		logtd("ULPFEC protection is changed: ssrc(%u) 1 FEC packet per %u media packets", _ssrc, media_packets_per_fec);
+		_ulpfec_generator.SetProtectionRate(media_packets_per_fec);
+	}
+}
+
 bool RtpPacketizer::Packetize(FrameType frame_type,
                                    uint32_t timestamp,
                                    const uint8_t *payload_data,
@@ -140,7 +161,7 @@ bool RtpPacketizer::PacketizeVideo(RtpVideoCodecType video_type,
 		_stream->OnRtpPacketized(packet);
 
 		// RED First
-		if(_ulpfec_enabled)
+		if(_ulpfec_enabled && _red_enabled)
 		{
 			GenerateRedAndFecPackets(packet);
 		}
@@ -15,6 +15,10 @@ public:
 	void SetVideoCodec(RtpVideoCodecType codec_type);
 	void SetAudioCodec(RtpAudioCodecType codec_type);
 	void SetUlpfec(uint8_t _red_payload_type, uint8_t _ulpfec_payload_type);
+	// The RED (and FEC) packets are generated only while some sessions receive them
+	void SetRedEnabled(bool enabled);
+	// media_packets_per_fec: 0 means RED without FEC
+	void SetUlpfecProtectionRate(uint32_t media_packets_per_fec);
 	void SetPayloadType(uint8_t payload_type);
 	void SetSSRC(uint32_t ssrc);
 	void SetCsrcs(const std::vector<uint32_t> &csrcs);
@@ -64,6 +68,7 @@ private:
 	uint16_t _red_sequence_number;
 
 	bool _ulpfec_enabled;
+	bool _red_enabled;
 	uint8_t _red_payload_type;
 	uint8_t _ulpfec_payload_type;
 
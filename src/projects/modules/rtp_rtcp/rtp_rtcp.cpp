@@ -1,6 +1,8 @@
 #include "rtp_rtcp.h"
 #include "publishers/webrtc/rtc_application.h"
 #include "publishers/webrtc/rtc_stream.h"
+#include "publishers/webrtc/rtc_session.h"
+#include "modules/dtls_srtp/srtp_transport.h"
 #include <base/ovlibrary/byte_io.h>
 
 #define OV_LOG_TAG "RtpRtcp"
@@ -11,62 +13,210 @@ RtpRtcp::RtpRtcp(uint32_t id, std::shared_ptr<pub::Session> session, const std::
 {
     for(auto ssrc : ssrc_list)
     {
-        auto rtcp_generator = std::make_shared<RtcpSRGenerator>(ssrc);
-        _rtcp_sr_generators[ssrc] = rtcp_generator;
+        _sender_statistics[ssrc] = SenderStatistics();
     }
 }
 
 RtpRtcp::~RtpRtcp()
 {
-    _rtcp_sr_generators.clear();
+    _sender_statistics.clear();
 }
 
-bool RtpRtcp::SendOutgoingData(const std::shared_ptr<ov::Data> &packet)
+void RtpRtcp::RegisterLowerNode(std::shared_ptr<pub::SessionNode> node)
 {
-	// Lower Node is SRTP
+	SessionNode::RegisterLowerNode(node);
+
+	_srtp_transport = std::dynamic_pointer_cast<SrtpTransport>(node);
+}
+
+bool RtpRtcp::Stop()
+{
+	_srtp_transport.reset();
+
+	return SessionNode::Stop();
+}
+
+bool RtpRtcp::SendToLowerNode(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data)
+{
+	if(_srtp_transport != nullptr)
+	{
+		return _srtp_transport->SendData(from_node, data);
+	}
+
 	auto node = GetLowerNode();
-	if(!node)
+
+	return (node != nullptr) && node->SendData(from_node, data);
+}
+
+bool RtpRtcp::SendOutgoingData(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite)
+{
+	if(packet->GetLength() < FIXED_HEADER_SIZE)
 	{
 		return false;
 	}
 
-    RtpPacket rtp_packet(packet);
+	// SRTP encrypts the packet in place and appends the auth tag, so each session needs its own buffer.
+	// Allocate it once with enough capacity, so that SRTP doesn't have to reallocate and copy it again.
+	auto session_packet = std::make_shared<ov::Data>(packet->GetLength() + RTP_TRANSPORT_CC_EXTENSION_SIZE + RTP_TRAILER_RESERVED_SIZE);
 
-    // Parsing error
-	if(rtp_packet.Buffer() == nullptr)
-    {
-        return false;
-    }
+	auto ssrc = (rewrite != nullptr) ? rewrite->ssrc : ByteReader<uint32_t>::ReadBigEndian(packet->GetDataAs<uint8_t>() + 8);
 
-    if(_rtcp_sr_generators.find(rtp_packet.Ssrc()) == _rtcp_sr_generators.end())
-    {
-        return false;
-    }
-    
-    auto rtcp_sr_generator = _rtcp_sr_generators[rtp_packet.Ssrc()];
-    
-    rtcp_sr_generator->AddRTPPacketAndGenerateRtcpSR(rtp_packet);
-    if(rtcp_sr_generator->IsAvailableRtcpSRPacket())
-    {
-        auto rtcp_sr_packet = rtcp_sr_generator->PopRtcpSRPacket();
-        if(!node->SendData(pub::SessionNodeType::Rtcp, rtcp_sr_packet))
-        {
-            logtd("Send RTCP failed : ssrc(%u)", rtp_packet.Ssrc());
-        }
-		else
+	auto statistics = _sender_statistics.find(ssrc);
+	if(statistics == _sender_statistics.end())
+	{
+		return false;
+	}
+
+	// The packets from the packetizer don't have any extension (See AppendWithTransportCc())
+	auto buffer = packet->GetDataAs<uint8_t>();
+	size_t header_size = FIXED_HEADER_SIZE + ((buffer[0] & 0x0F) * 4);
+	size_t padding_size = (buffer[0] & 0x20) ? buffer[packet->GetLength() - 1] : 0;
+
+	if(packet->GetLength() < (header_size + padding_size))
+	{
+		return false;
+	}
+
+	// The packet is shared by all sessions, so the transport-wide sequence number is added while copying it
+	auto extension_id = _transport_cc_extension_ids.find(ssrc);
+
+	if(extension_id != _transport_cc_extension_ids.end())
+	{
+		auto transport_sequence_number = _transport_sequence_number++;
+
+		if(AppendWithTransportCc(session_packet, packet, extension_id->second, transport_sequence_number) == false)
 		{
-			logtd("Send RTCP succeed : ssrc(%u) length(%d)", rtp_packet.Ssrc(), rtcp_sr_packet->GetLength());
+			return false;
 		}
-    }
 
-	if(!node->SendData(pub::SessionNodeType::Rtp, packet))
-    {
+		_bandwidth_estimator.OnPacketSent(transport_sequence_number, session_packet->GetLength());
+	}
+	else if(session_packet->Append(packet) == false)
+	{
 		return false;
-    }
+	}
+
+	if(rewrite != nullptr)
+	{
+		auto header = session_packet->GetWritableDataAs<uint8_t>();
+
+		ByteWriter<uint16_t>::WriteBigEndian(&header[2], rewrite->sequence_number);
+		ByteWriter<uint32_t>::WriteBigEndian(&header[4], rewrite->timestamp);
+		ByteWriter<uint32_t>::WriteBigEndian(&header[8], rewrite->ssrc);
+	}
+
+	// The SR is sent by the timer of the stream (See SendSenderReport()), only the counts are updated here
+	statistics->second.packet_count++;
+	statistics->second.octet_count += static_cast<uint32_t>(packet->GetLength() - header_size - padding_size);
+
+	return SendToLowerNode(pub::SessionNodeType::Rtp, session_packet);
+}
+
+bool RtpRtcp::SendSenderReport(const std::shared_ptr<const ov::Data> &sr_template, const RtpHeaderRewrite *rewrite)
+{
+	if(sr_template->GetLength() < (RTCP_HEADER_SIZE + 24))
+	{
+		return false;
+	}
+
+	auto ssrc = (rewrite != nullptr) ? rewrite->ssrc : ByteReader<uint32_t>::ReadBigEndian(sr_template->GetDataAs<uint8_t>() + 4);
+
+	auto statistics = _sender_statistics.find(ssrc);
+	if(statistics == _sender_statistics.end())
+	{
+		// This session doesn't receive the ssrc
+		return false;
+	}
+
+	// SRTCP appends the trailer in place
+	auto sr_packet = std::make_shared<ov::Data>(sr_template->GetLength() + RTCP_SRTCP_TRAILER_CAPACITY);
+	sr_packet->Append(sr_template);
+
+	auto buffer = sr_packet->GetWritableDataAs<uint8_t>();
+
+	if(rewrite != nullptr)
+	{
+		ByteWriter<uint32_t>::WriteBigEndian(&buffer[4], rewrite->ssrc);
+		ByteWriter<uint32_t>::WriteBigEndian(&buffer[16], rewrite->timestamp);
+	}
+
+	ByteWriter<uint32_t>::WriteBigEndian(&buffer[20], statistics->second.packet_count);
+	ByteWriter<uint32_t>::WriteBigEndian(&buffer[24], statistics->second.octet_count);
+
+	if(SendToLowerNode(pub::SessionNodeType::Rtcp, sr_packet) == false)
+	{
+		logtd("Send RTCP failed : ssrc(%u)", ssrc);
+		return false;
+	}
 
 	return true;
 }
 
+bool RtpRtcp::AppendWithTransportCc(const std::shared_ptr<ov::Data> &session_packet, const std::shared_ptr<const ov::Data> &packet, uint8_t extension_id, uint16_t transport_sequence_number)
+{
+	auto buffer = packet->GetDataAs<uint8_t>();
+
+	// The packets from the packetizer don't have any extension
+	if(buffer[0] & 0x10)
+	{
+		return false;
+	}
+
+	size_t header_size = FIXED_HEADER_SIZE + ((buffer[0] & 0x0F) * 4);
+
+	if(packet->GetLength() < header_size)
+	{
+		return false;
+	}
+
+	//  0                   1                   2                   3
+	//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+	// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+	// |       0xBE    |    0xDE       |           length=1            |
+	// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+	// |  ID   | L=1   |transport-wide sequence number | zero padding  |
+	// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+	uint8_t extension[RTP_TRANSPORT_CC_EXTENSION_SIZE];
+
+	ByteWriter<uint16_t>::WriteBigEndian(&extension[0], ONE_BYTE_EXTENSION_ID);
+	ByteWriter<uint16_t>::WriteBigEndian(&extension[2], 1);
+	extension[4] = static_cast<uint8_t>((extension_id << 4) | (2 - 1));
+	ByteWriter<uint16_t>::WriteBigEndian(&extension[5], transport_sequence_number);
+	extension[7] = 0;
+
+	if((session_packet->Append(buffer, header_size) == false) ||
+	   (session_packet->Append(extension, sizeof(extension)) == false) ||
+	   (session_packet->Append(buffer + header_size, packet->GetLength() - header_size) == false))
+	{
+		return false;
+	}
+
+	// X bit
+	session_packet->GetWritableDataAs<uint8_t>()[0] |= 0x10;
+
+	return true;
+}
+
+void RtpRtcp::SetTransportCcExtensionId(uint32_t ssrc, uint8_t extension_id)
+{
+	_transport_cc_extension_ids[ssrc] = extension_id;
+}
+
+bool RtpRtcp::IsBandwidthEstimationEnabled() const
+{
+	return (_transport_cc_extension_ids.empty() == false);
+}
+
+void RtpRtcp::SetStartBitrate(uint32_t bitrate)
+{
+	_bandwidth_estimator.SetStartBitrate(bitrate);
+}
+
+uint32_t RtpRtcp::GetEstimatedBitrate() const
+{
+	return _bandwidth_estimator.GetEstimatedBitrate();
+}
+
 bool RtpRtcp::SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data)
 {
 	// RTPRTCP는 Send를 하는 첫번째 NODE이므로 SendData를 통해 스트림을 받지 않고 SendOutgoingData를 사용한다.
@@ -85,27 +235,104 @@ bool RtpRtcp::OnDataReceived(pub::SessionNodeType from_node, const std::shared_p
 		return false;
 	}
 
-    RtcpPacketType packet_type;
-    uint32_t payload_size;
-    int report_count;
+    // The RTCP packets are sent in a compound packet (e.g. RR + NACK)
+    size_t offset = 0;
+    bool result = false;
 
-    // rtcp packet check
-    if (!RtcpPacket::IsRtcpPacket(data, packet_type, payload_size, report_count) || report_count <= 0)
+    while(offset < data->GetLength())
     {
-        logtd("Packet is not RTCP",RtcpPacket::GetPacketTypeString(packet_type).CStr());
-        return false;
+        auto packet = data->Subdata(offset);
+
+        RtcpPacketType packet_type;
+        uint32_t payload_size;
+        int report_count;
+
+        // rtcp packet check
+        if (!RtcpPacket::IsRtcpPacket(packet, packet_type, payload_size, report_count))
+        {
+            logtd("Packet is not RTCP");
+            break;
+        }
+
+        auto packet_length = RTCP_HEADER_SIZE + payload_size;
+
+        if(packet_length < packet->GetLength())
+        {
+            packet = packet->Subdata(0L, packet_length);
+        }
+
+        if(report_count > 0)
+        {
+            result = RtcpPacketProcess(packet_type, payload_size, report_count, packet) || result;
+        }
+
+        offset += packet_length;
     }
 
-    return RtcpPacketProcess(packet_type, payload_size, report_count, data);
+    return result;
 }
 
 // rtcp packet process
-// - current process only RR type
+// - RR, generic NACK and PLI/FIR
 bool RtpRtcp::RtcpPacketProcess(RtcpPacketType packet_type,
                                uint32_t payload_size,
                                int report_count,
                                const std::shared_ptr<const ov::Data> &data)
 {
+    // Generic NACK
+    if ((packet_type == RtcpPacketType::RTPFB) && (report_count == RTCP_RTPFB_FMT_NACK))
+    {
+        RtcpNack nack;
+
+        if (!RtcpPacket::NackParsing(data, nack))
+        {
+            logtd("RTCP(nack) packet parsing fail");
+            return false;
+        }
+
+        // Retransmit the lost packets through the SRTP of this session
+        std::static_pointer_cast<RtcSession>(GetSession())->OnNackReceived(nack);
+        return true;
+    }
+
+    // Transport-wide congestion control feedback
+    if ((packet_type == RtcpPacketType::RTPFB) && (report_count == RTCP_RTPFB_FMT_TRANSPORT_CC))
+    {
+        RtcpTransportFeedback feedback;
+
+        if (!RtcpPacket::TransportFeedbackParsing(data, feedback))
+        {
+            logtd("RTCP(transport-cc) packet parsing fail");
+            return false;
+        }
+
+        _bandwidth_estimator.OnTransportFeedback(feedback);
+        return true;
+    }
+
+    // PLI/FIR
+    if ((packet_type == RtcpPacketType::PSFB) && ((report_count == RTCP_PSFB_FMT_PLI) || (report_count == RTCP_PSFB_FMT_FIR)))
+    {
+        std::vector<uint32_t> media_ssrcs;
+
+        if (!RtcpPacket::KeyFrameRequestParsing(report_count, data, media_ssrcs))
+        {
+            logtd("RTCP(%s) packet parsing fail", (report_count == RTCP_PSFB_FMT_PLI) ? "pli" : "fir");
+            return false;
+        }
+
+        // The requests of all sessions are coalesced by the stream
+        for (auto media_ssrc : media_ssrcs)
+        {
+            if (_sender_statistics.find(media_ssrc) != _sender_statistics.end())
+            {
+                std::static_pointer_cast<RtcSession>(GetSession())->OnKeyFrameRequestReceived(media_ssrc);
+            }
+        }
+
+        return true;
+    }
+
     // Receiver Report
     if (packet_type != RtcpPacketType::RR)
     {
@@ -123,9 +350,9 @@ bool RtpRtcp::RtcpPacketProcess(RtcpPacketType packet_type,
 
 
 
-    if(_first_receiver_report_time == 0)
+    if(_first_receiver_report_time_ms == 0)
     {
-        _first_receiver_report_time = receiver_reports[0]->create_time;
+        _first_receiver_report_time_ms = receiver_reports[0]->create_time_ms;
     }
 
     // logtd("RTCP RR(Receiver Report) Packet received - size(%d/%d) report_count(%d)",
@@ -135,11 +362,17 @@ bool RtpRtcp::RtcpPacketProcess(RtcpPacketType packet_type,
 
     for(const auto &receiver_report : receiver_reports)
     {
+        _bandwidth_estimator.OnReceiverReport(receiver_report->fraction_lost);
+
+        // The protection rate of ULPFEC follows the loss
+        std::static_pointer_cast<RtcSession>(GetSession())->OnReceiverReportReceived(*receiver_report);
+
         // RR info setting
-        std::static_pointer_cast<RtcApplication>(GetSession()->GetApplication())->OnReceiverReport(
-                GetSession()->GetStream()->GetId(),
-            GetSession()->GetId(),
-            _first_receiver_report_time,
+        auto session = std::static_pointer_cast<RtcSession>(GetSession());
+        std::static_pointer_cast<RtcApplication>(session->GetApplication())->OnReceiverReport(
+                session->GetStream()->GetId(),
+            session->GetId(),
+            _first_receiver_report_time_ms,
             receiver_report);
 	}
     return true;
@@ -3,7 +3,18 @@
 #include "rtp_rtcp_defines.h"
 #include "rtp_packetizer.h"
 #include "base/publisher/session_node.h"
-#include "modules/rtp_rtcp/rtcp_sr_generator.h"
+#include "modules/rtp_rtcp/rtcp_packet.h"
+#include "modules/rtp_rtcp/bandwidth_estimator.h"
+
+class SrtpTransport;
+
+// The header fields overwritten in the copy of a session (e.g. the session is receiving the other rendition of the stream)
+struct RtpHeaderRewrite
+{
+	uint32_t ssrc = 0;
+	uint16_t sequence_number = 0;
+	uint32_t timestamp = 0;
+};
 
 class RtpRtcp : public pub::SessionNode
 {
@@ -12,9 +23,25 @@ public:
 	~RtpRtcp() override;
 
 	// 패킷을 전송한다. 성능을 위해 상위에서 Packetizing을 하는 경우 사용한다.
-	bool SendOutgoingData(const std::shared_ptr<ov::Data> &packet);
+	// packet is shared by all sessions, it is copied once into a buffer for this session which has room for the SRTP trailer.
+	bool SendOutgoingData(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite = nullptr);
+	// Sends the SR made from the template of the stream (See RtcStream::SendSenderReports()) with the counts of this session.
+	// The ssrc/RTP timestamp of the template are replaced with rewrite if it is not nullptr.
+	bool SendSenderReport(const std::shared_ptr<const ov::Data> &sr_template, const RtpHeaderRewrite *rewrite = nullptr);
+
+	// The transport-wide sequence number is added to the packets of the ssrc (the ID is negotiated by a=extmap of the answer)
+	// It must be called before the node is started
+	void SetTransportCcExtensionId(uint32_t ssrc, uint8_t extension_id);
+	bool IsBandwidthEstimationEnabled() const;
+	// The initial estimate before any feedback is received (bps)
+	void SetStartBitrate(uint32_t bitrate);
+	// bps
+	uint32_t GetEstimatedBitrate() const;
 
 	// Implement SessionNode Interface
+	// If the lower node is SrtpTransport (WebRTC session), the packets are sent to it directly (See SendToLowerNode())
+	void RegisterLowerNode(std::shared_ptr<pub::SessionNode> node) override;
+	bool Stop() override;
 	// RtpRtcp는 최상위 노드로 SendData를 사용하지 않는다. SendOutgoingData를 사용한다.
 	bool SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data) override;
 	// Lower Node(SRTP)로부터 데이터를 받는다.
@@ -25,9 +52,30 @@ public:
                             int report_count,
                             const std::shared_ptr<const ov::Data> &data);
 private:
-    time_t _first_receiver_report_time = 0; // 0 - not received RR packet
+    bool SendToLowerNode(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data);
+
+    // Copies the packet into session_packet, inserting the transport-wide sequence number extension after the CSRCs
+    bool AppendWithTransportCc(const std::shared_ptr<ov::Data> &session_packet, const std::shared_ptr<const ov::Data> &packet, uint8_t extension_id, uint16_t transport_sequence_number);
+
+    int64_t _first_receiver_report_time_ms = 0; // 0 - not received RR packet
     time_t _last_sender_report_time = 0;
     uint64_t _send_packet_sequence_number = 0;
 
-    std::map<uint32_t, std::shared_ptr<RtcpSRGenerator>> _rtcp_sr_generators;
+    struct SenderStatistics
+    {
+        uint32_t packet_count = 0;
+        // The bytes of the payloads
+        uint32_t octet_count = 0;
+    };
+    // key: ssrc, the counts of the RTP packets sent to this session (reported by SR)
+    std::map<uint32_t, SenderStatistics> _sender_statistics;
+
+    // The lower node of the WebRTC session, called without the lookup of the node and the virtual dispatch (SrtpTransport is final)
+    std::shared_ptr<SrtpTransport> _srtp_transport;
+
+    // key: ssrc, value: ID of the transport-wide sequence number extension
+    std::map<uint32_t, uint8_t> _transport_cc_extension_ids;
+    // Shared by all ssrcs of this session (transport-wide)
+    uint16_t _transport_sequence_number = 0;
+    BandwidthEstimator _bandwidth_estimator;
 };
@@ -3,6 +3,12 @@
 
 #include <string.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#	include <immintrin.h>
+#elif defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
 constexpr size_t 	kFecHeaderSize					= 10;
 constexpr size_t 	kMaskSizeLbitClear				= 2;
 constexpr size_t	kMaskSizeLbitSet				= 6;
@@ -11,24 +17,86 @@ constexpr size_t	kFecLevelHeaderSizeLbitSet		= 2 + kMaskSizeLbitSet;
 constexpr size_t 	kUlpfecMaxMediaPacketsLbitClear	= 16;
 constexpr size_t 	kUlpfecMaxMediaPacketsLbitSet	= 48;
 
-constexpr size_t    kMediaPacketNumMakeFec          = 100 / 10; // 25% Rate, 1 fec packet per 4 media packets.
+// dst ^= src
+static inline void XorBuffer(uint8_t *dst, const uint8_t *src, size_t length)
+{
+	size_t offset = 0;
+
+#if defined(__AVX2__)
+	for(; (offset + 32) <= length; offset += 32)
+	{
+		auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + offset));
+		auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + offset));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + offset), _mm256_xor_si256(a, b));
+	}
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	for(; (offset + 16) <= length; offset += 16)
+	{
+		auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + offset));
+		auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + offset));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + offset), _mm_xor_si128(a, b));
+	}
+#elif defined(__ARM_NEON)
+	for(; (offset + 16) <= length; offset += 16)
+	{
+		vst1q_u8(dst + offset, veorq_u8(vld1q_u8(dst + offset), vld1q_u8(src + offset)));
+	}
+#endif
+
+	// The rest (or all of the buffer if there is no SIMD) is processed in 8 bytes
+	for(; (offset + 8) <= length; offset += 8)
+	{
+		uint64_t a, b;
+		memcpy(&a, dst + offset, sizeof(a));
+		memcpy(&b, src + offset, sizeof(b));
+		a ^= b;
+		memcpy(dst + offset, &a, sizeof(a));
+	}
+
+	for(; offset < length; offset++)
+	{
+		dst[offset] ^= src[offset];
+	}
+}
 
 UlpfecGenerator::UlpfecGenerator()
 {
-	_high_level = false;
+	_media_packets_per_fec = ULPFEC_DEFAULT_MEDIA_PACKETS_PER_FEC;
 }
 
 UlpfecGenerator::~UlpfecGenerator()
 {
 }
 
-void UlpfecGenerator::SetHighRateProtection(bool high_level)
+void UlpfecGenerator::SetProtectionRate(uint32_t media_packets_per_fec)
+{
+	if(media_packets_per_fec == 0)
+	{
+		Reset();
+	}
+
+	_media_packets_per_fec = media_packets_per_fec;
+}
+
+uint32_t UlpfecGenerator::GetProtectionRate() const
+{
+	return _media_packets_per_fec;
+}
+
+void UlpfecGenerator::Reset()
 {
-	_high_level = high_level;
+	_media_packets.clear();
 }
 
 bool UlpfecGenerator::AddRtpPacketAndGenerateFec(std::shared_ptr<RedRtpPacket> packet)
 {
+	if(_media_packets_per_fec == 0)
+	{
+		return true;
+	}
+
 	_media_packets.push_back(packet);
 
 	if(packet->Marker())
@@ -60,8 +128,7 @@ bool UlpfecGenerator::NextPacket(RtpPacket *packet)
 bool UlpfecGenerator::Encode()
 {
 	size_t media_size = _media_packets.size();
-	//uint32_t rate = static_cast<uint32_t>(kMediaPacketNumMakeFec / (_high_level?2:1));
-	uint32_t fec_packet_count = static_cast<uint32_t>(std::ceil((float)media_size / (float)kMediaPacketNumMakeFec));
+	uint32_t fec_packet_count = static_cast<uint32_t>((media_size + _media_packets_per_fec - 1) / _media_packets_per_fec);
 	uint32_t media_packet_idx = 0;
 	size_t mask_len = 0;
 
@@ -194,10 +261,7 @@ void UlpfecGenerator::XorFecPacket(uint8_t *fec_packet, size_t fec_header_len, R
 	fec_packet[9] ^= rtp_payload_length_network_order[1];
 
 	// XOR Payload
-	for(size_t i = 0; i < rtp_payload_len; i++)
-	{
-		fec_packet[fec_header_len + i] ^= rtp_payload[i];
-	}
+	XorBuffer(&fec_packet[fec_header_len], rtp_payload, rtp_payload_len);
 }
 
 void UlpfecGenerator::FinalizeFecHeader(uint8_t *fec_packet, const size_t fec_payload_len, const uint8_t *mask, const size_t mask_len)
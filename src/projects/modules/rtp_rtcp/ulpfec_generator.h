@@ -37,17 +37,25 @@
  *	The current version of OME protects all contiguous media packets with one FEC packet,
  *  and one media packet only protects with one FEC packet.
  *  Fec packets is generated by a frame.
- *  Current version generates only one fec packet, near future we will apply bursty mask model.
- *  The session determines whether the FEC PACKET is sent according to the network status (using RTCP RR).
+ *  The stream determines how many media packets are protected with one FEC packet
+ *  according to the loss of the sessions receiving RED (using RTCP RR).
  */
 
+// The number of media packets protected with one FEC packet by default (10%)
+#define ULPFEC_DEFAULT_MEDIA_PACKETS_PER_FEC	10
+
 class UlpfecGenerator
 {
 public:
 	UlpfecGenerator();
 	~UlpfecGenerator();
 
-	void SetHighRateProtection(bool high_level);
+	// media_packets_per_fec: 0 means that no FEC packet is generated
+	void SetProtectionRate(uint32_t media_packets_per_fec);
+	uint32_t GetProtectionRate() const;
+	// Drops the media packets that are not protected yet
+	void Reset();
+
 	// Because RTP is already being sent out, we execute ulpfec using the newly created red packet.
 	// I used this technique to reduce the copying and improve performance.
 	bool AddRtpPacketAndGenerateFec(std::shared_ptr<RedRtpPacket> packet);
@@ -61,5 +69,5 @@ private:
 
 	std::queue<std::shared_ptr<ov::Data>>	    _generated_fec_packets;
 	std::vector<std::shared_ptr<RedRtpPacket>>	_media_packets;
-	bool                                        _high_level;
+	uint32_t                                    _media_packets_per_fec;
 };
\ No newline at end of file
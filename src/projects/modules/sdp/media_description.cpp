@@ -80,6 +80,12 @@ bool MediaDescription::UpdateData(ov::String &sdp)
 		sdp.AppendFormat("a=rtcp-mux\r\n");
 	}
 
+	// Extmap
+	for(auto &extmap : _extmap)
+	{
+		sdp.AppendFormat("a=extmap:%d %s\r\n", extmap.first, extmap.second.CStr());
+	}
+
 	// Payloads
 	for(auto &payload : _payload_list)
 	{
@@ -336,6 +342,21 @@ bool MediaDescription::ParsingMediaLine(char type, std::string content)
 					EnableRtcpFb(static_cast<uint8_t>(std::stoul(matches[1])), std::string(matches[2]).c_str(), true);
 				}
 			}
+			else if(content.compare(0, OV_COUNTOF("ext") - 1, "ext") == 0)
+			{
+				// a=extmap:1 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01
+				// a=extmap:2/sendonly urn:ietf:params:rtp-hdrext:toffset
+				if(std::regex_search(content, matches, std::regex("^extmap:(\\d+)(?:\\/\\w+)? (\\S+)")))
+				{
+					if(matches.size() != 2 + 1)
+					{
+						parsing_error = true;
+						break;
+					}
+
+					AddExtmap(static_cast<uint8_t>(std::stoul(matches[1])), std::string(matches[2]).c_str());
+				}
+			}
 			else if(content.compare(0, OV_COUNTOF("mid") - 1, "mid") == 0)
 			{
 				// a=mid:video,
@@ -391,6 +412,25 @@ bool MediaDescription::ParsingMediaLine(char type, std::string content)
 
 					SetFramerate(std::stof(matches[1]));
 				}
+			}
+			else if(content.compare(0, OV_COUNTOF("fm") - 1, "fm") == 0)
+			{
+				// a=fmtp:102 level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42001f
+				if(std::regex_search(content, matches, std::regex("^fmtp:(\\d+) (.*)")))
+				{
+					if(matches.size() != 2 + 1)
+					{
+						parsing_error = true;
+						break;
+					}
+
+					auto payload = GetPayload(static_cast<uint8_t>(std::stoul(matches[1])));
+
+					if(payload != nullptr)
+					{
+						payload->SetFmtp(std::string(matches[2]).c_str());
+					}
+				}
 			}
 				// a=sendonly
 			else if(content.compare(0, OV_COUNTOF("se") - 1, "se") == 0 ||
@@ -419,7 +459,6 @@ bool MediaDescription::ParsingMediaLine(char type, std::string content)
 			else
 			{
 				//TODO: Implementing of unknown attributes
-            	//a=fmtp:112 minptime=10;useinbandfec=1
 				logw("SDP", "Unknown Attributes : %c=%s", type, content.c_str());
 			}
 
@@ -516,6 +555,11 @@ const std::shared_ptr<PayloadAttr> MediaDescription::GetFirstPayload()
 	return _payload_list[0];
 }
 
+const std::vector<std::shared_ptr<PayloadAttr>> &MediaDescription::GetPayloadList() const
+{
+	return _payload_list;
+}
+
 // a=rtcp-mux
 void MediaDescription::UseRtcpMux(bool flag)
 {
@@ -644,6 +688,25 @@ const ov::String MediaDescription::GetCname()
 	return _cname;
 }
 
+// a=extmap:1 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01
+void MediaDescription::AddExtmap(uint8_t id, const ov::String &uri)
+{
+	_extmap[id] = uri;
+}
+
+uint8_t MediaDescription::GetExtmapId(const ov::String &uri)
+{
+	for(auto &extmap : _extmap)
+	{
+		if(extmap.second == uri)
+		{
+			return extmap.first;
+		}
+	}
+
+	return 0;
+}
+
 // a=rtpmap:96 VP8/50000
 bool MediaDescription::AddRtpmap(uint8_t payload_type, const ov::String &codec,
                                  uint32_t rate, const ov::String &parameters)
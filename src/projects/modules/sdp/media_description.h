@@ -62,6 +62,8 @@ public:
 	void AddPayload(const std::shared_ptr<PayloadAttr> &payload);
 	const std::shared_ptr<PayloadAttr> GetPayload(uint8_t id);
 	const std::shared_ptr<PayloadAttr> GetFirstPayload();
+	// In order of the preference of the peer (the order of m= line)
+	const std::vector<std::shared_ptr<PayloadAttr>> &GetPayloadList() const;
 
 	// a=rtcp-mux
 	void UseRtcpMux(bool flag = true);
@@ -95,6 +97,11 @@ public:
 	bool EnableRtcpFb(uint8_t id, const ov::String &type, bool on);
 	void EnableRtcpFb(uint8_t id, const PayloadAttr::RtcpFbType &type, bool on);
 
+	// a=extmap:1 http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01
+	void AddExtmap(uint8_t id, const ov::String &uri);
+	// Returns 0 if the extension is not negotiated
+	uint8_t GetExtmapId(const ov::String &uri);
+
 	// a=ssrc:2064629418 cname:{b2266c86-259f-4853-8662-ea94cf0835a3}
 	void SetCname(uint32_t ssrc, const ov::String &cname);
 
@@ -133,4 +140,6 @@ private:
 
 	std::shared_ptr<SessionDescription> _session_description;
 	std::vector<std::shared_ptr<PayloadAttr>> _payload_list;
+	// key: ID, value: URI
+	std::map<uint8_t, ov::String> _extmap;
 };
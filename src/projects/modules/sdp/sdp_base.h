@@ -39,6 +39,12 @@ public:
 protected:
 	virtual bool UpdateData(ov::String &sdp) = 0;
 
+	// Used when the text is rendered without UpdateData() (e.g. from the pre-rendered template)
+	void SetSdpText(const ov::String &sdp)
+	{
+		_sdp_text = sdp;
+	}
+
 private:
 	ov::String _sdp_text;
 };
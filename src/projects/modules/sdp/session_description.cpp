@@ -44,6 +44,12 @@ bool SessionDescription::UpdateData(ov::String &sdp)
 
 	for(auto &t : _media_list)
 	{
+		// The rejected media (port 0) cannot be bundled
+		if(t->GetPort() == 0)
+		{
+			continue;
+		}
+
 		sdp.AppendFormat(" %s", t->GetMid().CStr());
 	}
 
@@ -64,6 +70,11 @@ bool SessionDescription::UpdateData(ov::String &sdp)
 		sdp.AppendFormat("a=msid-semantic:%s %s\r\n", _msid_semantic.CStr(), _msid_token.CStr());
 	}
 
+	if(_ice_lite)
+	{
+		sdp += "a=ice-lite\r\n";
+	}
+
 	// Common Attributes
 	ov::String common_attr_text;
 
@@ -91,6 +102,84 @@ bool SessionDescription::UpdateData(ov::String &sdp)
 	return true;
 }
 
+bool SessionDescription::UpdateTemplate()
+{
+	_has_template = false;
+
+	ov::String sdp;
+
+	if(UpdateData(sdp) == false)
+	{
+		return false;
+	}
+
+	SetSdpText(sdp);
+
+	// o=OvenMediaEngine 1882243660 2 IN IP4 127.0.0.1
+	ov::String origin_prefix = ov::String::FormatString("\r\no=%s ", _user_name.CStr());
+	ov::String session_id = ov::String::FormatString("%u", _session_id);
+	ov::String ufrag_prefix = "\r\na=ice-ufrag:";
+
+	auto session_id_index = sdp.IndexOf(origin_prefix);
+	auto ufrag_index = sdp.IndexOf(ufrag_prefix);
+
+	if((session_id_index < 0) || (ufrag_index < 0) || (GetIceUfrag().IsEmpty()))
+	{
+		// Cannot be patched, CreateOffer() renders the text for each offer
+		return true;
+	}
+
+	session_id_index += origin_prefix.GetLength();
+	ufrag_index += ufrag_prefix.GetLength();
+
+	if(ufrag_index < session_id_index)
+	{
+		return true;
+	}
+
+	auto session_id_end = session_id_index + session_id.GetLength();
+	auto ufrag_end = ufrag_index + GetIceUfrag().GetLength();
+
+	_template_head = sdp.Substring(0, session_id_index);
+	_template_middle = sdp.Substring(session_id_end, ufrag_index - session_id_end);
+	_template_tail = sdp.Substring(ufrag_end);
+	_has_template = true;
+
+	return true;
+}
+
+std::shared_ptr<SessionDescription> SessionDescription::CreateOffer(uint32_t session_id, const ov::String &ice_ufrag) const
+{
+	auto offer = std::make_shared<SessionDescription>(*this);
+
+	offer->_session_id = session_id;
+	offer->SetIceUfrag(ice_ufrag);
+	offer->_has_template = false;
+	offer->_template_head.Clear();
+	offer->_template_middle.Clear();
+	offer->_template_tail.Clear();
+
+	if(_has_template)
+	{
+		ov::String sdp;
+
+		sdp.SetCapacity(_template_head.GetLength() + _template_middle.GetLength() + _template_tail.GetLength() + ice_ufrag.GetLength() + 10);
+		sdp += _template_head;
+		sdp.AppendFormat("%u", session_id);
+		sdp += _template_middle;
+		sdp += ice_ufrag;
+		sdp += _template_tail;
+
+		offer->SetSdpText(sdp);
+	}
+	else
+	{
+		offer->Update();
+	}
+
+	return offer;
+}
+
 bool SessionDescription::FromString(const ov::String &sdp)
 {
 	static const std::regex ValidLineRegex("^([a-z])=(.*)");
@@ -262,6 +351,11 @@ bool SessionDescription::ParsingSessionLine(char type, std::string content)
 					SetMsidSemantic(std::string(matches[1]).c_str(), std::string(matches[2]).c_str());
 				}
 			}
+			// a=ice-lite
+			else if(content == "ice-lite")
+			{
+				_ice_lite = true;
+			}
 			else if(ParsingCommonAttrLine(type, content))
 			{
 				// Nothing to do
@@ -383,6 +477,17 @@ ov::String SessionDescription::GetMsidToken() const
 	return _msid_token;
 }
 
+// a=ice-lite
+void SessionDescription::SetIceLite(bool ice_lite)
+{
+	_ice_lite = ice_lite;
+}
+
+bool SessionDescription::IsIceLite() const
+{
+	return _ice_lite;
+}
+
 // m=video 9 UDP/TLS/RTP/SAVPF 97
 void SessionDescription::AddMedia(std::shared_ptr<MediaDescription> media)
 {
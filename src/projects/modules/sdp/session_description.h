@@ -84,6 +84,10 @@ public:
 	ov::String GetMsidSemantic() const;
 	ov::String GetMsidToken() const;
 
+	// a=ice-lite (session level only, RFC 8839 5.3)
+	void SetIceLite(bool ice_lite);
+	bool IsIceLite() const;
+
 	// m=video 9 UDP/TLS/RTP/SAVPF 97
 	// a=group:BUNDLE 에 AddMedia의 mid를 추가한다. OME는 BUNDLE-ONLY만 지원한다. (2018.05.01)
 	void AddMedia(std::shared_ptr<MediaDescription> media);
@@ -98,6 +102,13 @@ public:
 	ov::String GetIceUfrag() override;
 	ov::String GetIcePwd() override;
 
+	// Pre-renders the SDP text of this description as a template. Call it again whenever the description is changed.
+	// Only the origin session id and the ice-ufrag are different from each offer,
+	// so CreateOffer() patches those fields of the template instead of rendering all media descriptions again.
+	bool UpdateTemplate();
+	// Returns a copy which has the given session id/ice-ufrag, and its SDP text is already rendered
+	std::shared_ptr<SessionDescription> CreateOffer(uint32_t session_id, const ov::String &ice_ufrag) const;
+
 	bool operator ==(const SessionDescription &description) const
 	{
 		// TODO(getroot): this와 description이 같은지를 판단할 수 있게 해주세요
@@ -130,9 +141,18 @@ private:
 	ov::String _msid_semantic;
 	ov::String _msid_token;
 
+	bool _ice_lite = false;
+
 	// group:Bundle
 	std::vector<ov::String> _bundles;
 
 	// Media
 	std::vector<std::shared_ptr<MediaDescription>> _media_list;
+
+	// The pre-rendered text, split at the session id and the ice-ufrag
+	// (<head><session id><middle><ice-ufrag><tail>)
+	bool _has_template = false;
+	ov::String _template_head;
+	ov::String _template_middle;
+	ov::String _template_tail;
 };
\ No newline at end of file
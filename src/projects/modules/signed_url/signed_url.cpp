@@ -1,6 +1,8 @@
 #include <openssl/evp.h>
 #include <openssl/des.h>
+#include <openssl/crypto.h>
 #include <base/ovcrypto/base_64.h>
+#include <base/ovcrypto/message_digest.h>
 #include <base/ovlibrary/converter.h>
 
 #include "signed_url.h"
@@ -35,8 +37,78 @@
 	logti("url : %s", url.CStr());
 */
 
+SignedUrl::Cache SignedUrl::_cache;
+
+std::shared_ptr<const SignedUrl> SignedUrl::Cache::Find(const std::string &cache_key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto item = _index.find(cache_key);
+    if(item == _index.end())
+    {
+        return nullptr;
+    }
+
+    auto signed_url = item->second->second;
+
+    if(signed_url->IsStreamExpired())
+    {
+        // The token will never be valid again
+        _entries.erase(item->second);
+        _index.erase(item);
+        return nullptr;
+    }
+
+    _entries.splice(_entries.begin(), _entries, item->second);
+
+    return signed_url;
+}
+
+void SignedUrl::Cache::Add(const std::string &cache_key, const std::shared_ptr<const SignedUrl> &signed_url)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if(_index.find(cache_key) != _index.end())
+    {
+        // Another thread has loaded the same token
+        return;
+    }
+
+    _entries.emplace_front(cache_key, signed_url);
+    _index.emplace(cache_key, _entries.begin());
+
+    while(_entries.size() > SIGNED_URL_CACHE_SIZE)
+    {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+    }
+}
+
 std::shared_ptr<const SignedUrl> SignedUrl::Load(SignedUrlType type, const ov::String &key, const ov::String &data)
 {
+    // The key is included, so the same token is verified again for the virtual host that has another key.
+    // Only the digest of the key is kept in the cache, not the key itself
+    uint8_t key_digest[32];
+
+    if(ov::MessageDigest::ComputeDigest(ov::CryptoAlgorithm::Sha256, key.CStr(), key.GetLength(), key_digest, sizeof(key_digest)) == false)
+    {
+        return nullptr;
+    }
+
+    std::string cache_key;
+    cache_key.reserve(sizeof(key_digest) + data.GetLength() + 3);
+    cache_key.append(1, static_cast<char>('0' + static_cast<int>(type)));
+    cache_key.append(1, '\n');
+    cache_key.append(reinterpret_cast<const char *>(key_digest), sizeof(key_digest));
+    cache_key.append(1, '\n');
+    cache_key.append(data.CStr(), data.GetLength());
+
+    auto cached_signed_url = _cache.Find(cache_key);
+    if(cached_signed_url != nullptr)
+    {
+        return cached_signed_url;
+    }
+
     auto signed_url = std::make_shared<SignedUrl>();
 
     if(type == SignedUrlType::Type0)
@@ -46,14 +118,44 @@ std::shared_ptr<const SignedUrl> SignedUrl::Load(SignedUrlType type, const ov::S
             return nullptr;
         }
     }
+    else if(type == SignedUrlType::Type1)
+    {
+        if(signed_url->ProcessType1(key, data) == false)
+        {
+            return nullptr;
+        }
+    }
     else
     {
         return nullptr;
     }
 
+    if(signed_url->IsStreamExpired() == false)
+    {
+        _cache.Add(cache_key, signed_url);
+    }
+
     return signed_url;
 }
 
+bool SignedUrl::ParseType(const ov::String &name, SignedUrlType *type)
+{
+    auto upper_name = name.UpperCaseString();
+
+    if(upper_name == "DES")
+    {
+        *type = SignedUrlType::Type0;
+        return true;
+    }
+    else if(upper_name == "HMAC-SHA256")
+    {
+        *type = SignedUrlType::Type1;
+        return true;
+    }
+
+    return false;
+}
+
 uint64_t SignedUrl::GetNowMS() const
 {
 	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -144,7 +246,51 @@ bool SignedUrl::ProcessType0(const ov::String &key, const ov::String &data)
         return false;
     }
 
-    auto plain_string = final_data.ToString();
+    return ParsePlainString(final_data.ToString());
+}
+
+// Type1 : BASE64(<Struct>) + "." + BASE64(HMAC-SHA256(<Key>, BASE64(<Struct>)))
+// Struct : Same as Type0 (not encrypted, so the URL can be seen by the client, but cannot be changed without the key)
+bool SignedUrl::ProcessType1(const ov::String &key, const ov::String &data)
+{
+    auto position = data.IndexOf('.');
+    if(position <= 0)
+    {
+        return false;
+    }
+
+    auto encoded_plain = data.Substring(0, position);
+    auto const signature = ov::Base64::Decode(data.Substring(position + 1));
+    if((signature == nullptr) || (signature->GetLength() != ov::MessageDigest::Size(ov::CryptoAlgorithm::Sha256)))
+    {
+        return false;
+    }
+
+    uint8_t expected_signature[EVP_MAX_MD_SIZE];
+    if(ov::MessageDigest::ComputeHmac(ov::CryptoAlgorithm::Sha256, key.CStr(), key.GetLength(),
+                                      encoded_plain.CStr(), encoded_plain.GetLength(),
+                                      expected_signature, sizeof(expected_signature)) == false)
+    {
+        return false;
+    }
+
+    // Compares in a constant time not to leak how many bytes are matched
+    if(CRYPTO_memcmp(expected_signature, signature->GetData(), signature->GetLength()) != 0)
+    {
+        return false;
+    }
+
+    auto const plain_data = ov::Base64::Decode(encoded_plain);
+    if(plain_data == nullptr)
+    {
+        return false;
+    }
+
+    return ParsePlainString(plain_data->ToString());
+}
+
+bool SignedUrl::ParsePlainString(const ov::String &plain_string)
+{
     auto items = plain_string.Split(",");
     if(items.size() != 5)
     {
@@ -219,7 +365,10 @@ bool SignedUrl::Encrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &plain_in,
 
 bool SignedUrl::Decrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &encrypted_in, ov::Data &plain_out) const
 {
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    // The context is reused by the thread (it is reset by EVP_DecryptInit_ex() for each token)
+    static thread_local std::unique_ptr<EVP_CIPHER_CTX, decltype(&EVP_CIPHER_CTX_free)> thread_ctx(EVP_CIPHER_CTX_new(), EVP_CIPHER_CTX_free);
+
+    EVP_CIPHER_CTX *ctx = thread_ctx.get();
     if(ctx == nullptr)
     {
         return false;
@@ -227,24 +376,15 @@ bool SignedUrl::Decrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &encrypted
 
     int ret; 
 
-    ret = EVP_CIPHER_CTX_init(ctx);
-    if(ret != 1)
-    {
-        EVP_CIPHER_CTX_free(ctx);
-        return false;
-    }
-
     ret = EVP_DecryptInit_ex(ctx, EVP_des_ecb(), NULL, (uint8_t *)key.CStr(), NULL);
     if(ret != 1)
     {
-        EVP_CIPHER_CTX_free(ctx);
         return false;
     }
 
     ret = EVP_CIPHER_CTX_set_padding(ctx, 0);
     if(ret != 1)
     {
-        EVP_CIPHER_CTX_free(ctx);
         return false;
     }
 
@@ -258,19 +398,16 @@ bool SignedUrl::Decrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &encrypted
     ret = EVP_DecryptUpdate(ctx, out, &num_bytes_out, (uint8_t *)encrypted_in.GetWritableDataAs<uint8_t>(), encrypted_in.GetLength());
     if(ret != 1)
     {
-        EVP_CIPHER_CTX_free(ctx);
         return false;
     }
     total_out_length += num_bytes_out;
     ret = EVP_DecryptFinal_ex(ctx, out + num_bytes_out, &num_bytes_out);
     if(ret != 1)
     {
-        EVP_CIPHER_CTX_free(ctx);
         return false;
     }
 
     total_out_length += num_bytes_out;
-    EVP_CIPHER_CTX_free(ctx);
 
     // There are paddings in decrypted text
     std::shared_ptr<ov::Data> final_data;
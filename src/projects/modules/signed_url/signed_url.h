@@ -3,18 +3,29 @@
 #include <base/ovsocket/socket_address.h>
 #include <base/ovlibrary/ovlibrary.h>
 
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// The number of the verified tokens that are kept to skip decoding the same token again (HLS/DASH players send it with every request)
+#define SIGNED_URL_CACHE_SIZE 10000
+
 enum class SignedUrlType
 {
     // Type0 : Des.Decrypt(Base64.Decode("[url],[client ip],[token expired time],[stream expired time]", key, ECB Mode, Pkcs5 Padding))
     Type0, 
-    // No defined yet
+    // Type1 : Base64("[url],[client ip],[session id],[token expired time],[stream expired time]") + "." + Base64(HMAC-SHA256(key, <the first part>))
     Type1,  
 };
 
 class SignedUrl
 {
 public:
+    // The token that has been loaded before is found in the cache (the expiration is checked by the caller for each request)
 	static std::shared_ptr<const SignedUrl> Load(SignedUrlType type, const ov::String &key, const ov::String &data);
+    // "DES" (Type0) or "HMAC-SHA256" (Type1), returns false for the unknown names
+    static bool ParseType(const ov::String &name, SignedUrlType *type);
 
     uint64_t	            GetNowMS() const;
     const ov::String&       GetUrl() const;
@@ -28,11 +39,31 @@ public:
 
 
     bool ProcessType0(const ov::String &key, const ov::String &data);
+    bool ProcessType1(const ov::String &key, const ov::String &data);
+    // Parses "[url],[client ip],[session id],[token expired time],[stream expired time]"
+    bool ParsePlainString(const ov::String &plain_string);
 
     bool Encrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &plain_in, ov::Data &encrypted_out) const;
     bool Decrypt_DES_ECB_PKCS5(const ov::String &key, ov::Data &encrypted_in, ov::Data &plain_out) const;
     
 private:
+    // A bounded LRU of the loaded tokens, keyed by the type, the digest of the key and the token
+    class Cache
+    {
+    public:
+        std::shared_ptr<const SignedUrl> Find(const std::string &cache_key);
+        void Add(const std::string &cache_key, const std::shared_ptr<const SignedUrl> &signed_url);
+
+    private:
+        using Entry = std::pair<std::string, std::shared_ptr<const SignedUrl>>;
+
+        std::mutex _mutex;
+        // The most recently used entry is at the front
+        std::list<Entry> _entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> _index;
+    };
+
+    static Cache _cache;
 
     ov::String  _key;
     ov::String  _full_string;
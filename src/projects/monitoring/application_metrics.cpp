@@ -89,17 +89,24 @@ namespace mon
         return _streams[stream.GetId()];
     }
 
+    std::map<uint32_t, std::shared_ptr<StreamMetrics>> ApplicationMetrics::GetStreamMetricsList()
+    {
+        std::shared_lock<std::shared_mutex> lock(_map_guard);
+        return _streams;
+    }
+
     void ApplicationMetrics::IncreaseBytesIn(uint64_t value)
     {
         // Forward value to HostMetrics to sum
-		GetHostMetrics()->IncreaseBytesIn(value);
+		// (_host_metrics is used directly, GetHostMetrics() copies the pointer that is shared by the threads)
+		_host_metrics->IncreaseBytesIn(value);
 		CommonMetrics::IncreaseBytesIn(value);
     }
 
     void ApplicationMetrics::IncreaseBytesOut(PublisherType type, uint64_t value)
     {
         // Forward value to HostMetrics to sum
-		GetHostMetrics()->IncreaseBytesOut(type, value);
+		_host_metrics->IncreaseBytesOut(type, value);
 		CommonMetrics::IncreaseBytesOut(type, value);
     }
 
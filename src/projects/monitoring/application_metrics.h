@@ -49,6 +49,8 @@ namespace mon
 		bool OnStreamDeleted(const info::Stream &stream);
 
 		std::shared_ptr<StreamMetrics> GetStreamMetrics(const info::Stream &stream);
+		// A copy of the map, to iterate without the lock
+		std::map<uint32_t, std::shared_ptr<StreamMetrics>> GetStreamMetricsList();
 
 		// Overriding from CommonMetrics 
 		void IncreaseBytesIn(uint64_t value) override;
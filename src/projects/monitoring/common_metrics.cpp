@@ -8,8 +8,6 @@ namespace mon
 {
     CommonMetrics::CommonMetrics()
     {
-        _total_bytes_in = 0;
-        _total_bytes_out = 0;
         _total_connections = 0;
 		_max_total_connections = 0;
 
@@ -19,7 +17,6 @@ namespace mon
 
         for(int i=0; i<static_cast<int8_t>(PublisherType::NumberOfPublishers); i++)
         {
-            _publisher_metrics[i]._bytes_out = 0;
             _publisher_metrics[i]._connections = 0;
         }
         _created_time = std::chrono::system_clock::now();
@@ -66,13 +63,43 @@ namespace mon
         return _last_updated_time;
     }
 
+    CommonMetrics::CounterShard &CommonMetrics::GetCounterShard()
+	{
+		static std::atomic<uint32_t> next_shard_index{0};
+		static thread_local uint32_t shard_index = next_shard_index++ % METRICS_COUNTER_SHARD_COUNT;
+
+		return _counter_shards[shard_index];
+	}
+
+	void CommonMetrics::UpdateTime(std::chrono::system_clock::time_point *time, const std::chrono::system_clock::time_point &now)
+	{
+		if (*time != now)
+		{
+			*time = now;
+		}
+	}
+
     uint64_t CommonMetrics::GetTotalBytesIn()
 	{
-		return _total_bytes_in.load();
+		uint64_t total = 0;
+
+		for (auto &shard : _counter_shards)
+		{
+			total += shard.bytes_in.load(std::memory_order_relaxed);
+		}
+
+		return total;
 	}
 	uint64_t CommonMetrics::GetTotalBytesOut()
 	{
-		return _total_bytes_out;
+		uint64_t total = 0;
+
+		for (auto &shard : _counter_shards)
+		{
+			total += shard.bytes_out.load(std::memory_order_relaxed);
+		}
+
+		return total;
 	}
 	uint32_t CommonMetrics::GetTotalConnections()
 	{
@@ -100,7 +127,14 @@ namespace mon
 
 	uint64_t CommonMetrics::GetBytesOut(PublisherType type)
 	{
-		return _publisher_metrics[static_cast<int8_t>(type)]._bytes_out;
+		uint64_t total = 0;
+
+		for (auto &shard : _counter_shards)
+		{
+			total += shard.publisher_bytes_out[static_cast<int8_t>(type)].load(std::memory_order_relaxed);
+		}
+
+		return total;
 	}
 	uint64_t CommonMetrics::GetConnections(PublisherType type)
 	{
@@ -109,9 +143,12 @@ namespace mon
 
     void CommonMetrics::IncreaseBytesIn(uint64_t value)
 	{
-		_total_bytes_in += value;
-		_last_recv_time = std::chrono::system_clock::now();
-		UpdateDate();
+		GetCounterShard().bytes_in.fetch_add(value, std::memory_order_relaxed);
+
+		// Called for every packet, so the coarse clock is used
+		auto now = ov::Clock::CoarseSystemNow();
+		UpdateTime(&_last_recv_time, now);
+		UpdateTime(&_last_updated_time, now);
 	}
 	void CommonMetrics::IncreaseBytesOut(PublisherType type, uint64_t value)
 	{
@@ -120,10 +157,13 @@ namespace mon
 			return;
 		}
 		
-		_publisher_metrics[static_cast<int8_t>(type)]._bytes_out += value;
-		_total_bytes_out += value;
-		_last_sent_time = std::chrono::system_clock::now();
-		UpdateDate();
+		auto &shard = GetCounterShard();
+		shard.publisher_bytes_out[static_cast<int8_t>(type)].fetch_add(value, std::memory_order_relaxed);
+		shard.bytes_out.fetch_add(value, std::memory_order_relaxed);
+
+		auto now = ov::Clock::CoarseSystemNow();
+		UpdateTime(&_last_sent_time, now);
+		UpdateTime(&_last_updated_time, now);
 	}
 
 	void CommonMetrics::OnSessionConnected(PublisherType type)
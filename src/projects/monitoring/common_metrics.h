@@ -8,6 +8,10 @@
 #include "base/info/info.h"
 #include "base/info/stream.h"
 
+// The byte counters are sharded by thread, so the threads that count the packets don't contend for a cache line
+// (the threads beyond this share the shards)
+#define METRICS_COUNTER_SHARD_COUNT 16
+
 namespace mon
 {
 	class CommonMetrics
@@ -44,11 +48,24 @@ namespace mon
 		std::chrono::system_clock::time_point _created_time;
 		std::chrono::system_clock::time_point _last_updated_time;
 
-		// From Provider
-		std::atomic<uint64_t> _total_bytes_in;
+		// The counters that are increased per packet, the shard of the calling thread is increased
+		// and the shards are summed when they are read (GetTotalBytesIn(), ...)
+		struct alignas(64) CounterShard
+		{
+			// From Provider
+			std::atomic<uint64_t> bytes_in{0};
+			// From Publishers
+			std::atomic<uint64_t> bytes_out{0};
+			std::atomic<uint64_t> publisher_bytes_out[static_cast<int8_t>(PublisherType::NumberOfPublishers)] = {};
+		};
+
+		CounterShard &GetCounterShard();
+		// Updated only when the coarse clock ticks, so the threads don't write the cache line per packet
+		static void UpdateTime(std::chrono::system_clock::time_point *time, const std::chrono::system_clock::time_point &now);
+
+		CounterShard _counter_shards[METRICS_COUNTER_SHARD_COUNT];
 
 		// From Publishers
-		std::atomic<uint64_t> _total_bytes_out;
 		std::atomic<uint32_t> _total_connections;
 		
 		std::atomic<uint32_t> _max_total_connections;
@@ -62,7 +79,6 @@ namespace mon
 		class PublisherMetrics
 		{
 		public:
-			std::atomic<uint64_t> _bytes_out;
 			std::atomic<uint32_t> _connections;
 		};
 
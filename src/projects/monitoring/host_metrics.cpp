@@ -4,6 +4,7 @@
 
 #include "monitoring_private.h"
 #include "host_metrics.h"
+#include "monitoring.h"
 
 namespace mon
 {
@@ -14,6 +15,8 @@ namespace mon
 														ov::Converter::ToString(_created_time).CStr());
 		
 		out_str.Append(CommonMetrics::GetInfoString());
+		// The resources of the machine, shared by all hosts
+		out_str.Append(MonitorInstance->GetResourceMetrics().GetInfoString());
 
 		if(show_children)
 		{
@@ -75,4 +78,10 @@ namespace mon
 
 		return _applications[app_info.GetId()];
 	}
+
+	std::map<uint32_t, std::shared_ptr<ApplicationMetrics>> HostMetrics::GetApplicationMetricsList()
+	{
+		std::shared_lock<std::shared_mutex> lock(_map_guard);
+		return _applications;
+	}
 }  // namespace mon
\ No newline at end of file
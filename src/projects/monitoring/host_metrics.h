@@ -41,6 +41,8 @@ namespace mon
 		bool OnApplicationDeleted(const info::Application &app_info);
 
 		std::shared_ptr<ApplicationMetrics> GetApplicationMetrics(const info::Application &app_info);
+		// A copy of the map, to iterate without the lock
+		std::map<uint32_t, std::shared_ptr<ApplicationMetrics>> GetApplicationMetricsList();
 
 	private:
 		std::shared_mutex _map_guard;
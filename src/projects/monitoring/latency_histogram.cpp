@@ -0,0 +1,36 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "latency_histogram.h"
+
+namespace mon
+{
+	LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const
+	{
+		Snapshot snapshot;
+
+		for (int index = 0; index < BucketCount; index++)
+		{
+			snapshot.buckets[index] = _buckets[index].load(std::memory_order_relaxed);
+		}
+
+		snapshot.sum_usec = _sum_usec.load(std::memory_order_relaxed);
+		snapshot.count = _count.load(std::memory_order_relaxed);
+
+		return snapshot;
+	}
+
+	int64_t LatencyHistogram::GetUpperBoundUsec(int index)
+	{
+		if (index >= LATENCY_HISTOGRAM_FINITE_BUCKET_COUNT)
+		{
+			return -1;
+		}
+
+		return 1LL << (LATENCY_HISTOGRAM_MIN_SHIFT + index);
+	}
+}  // namespace mon
@@ -0,0 +1,76 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include "base/common_types.h"
+
+// The upper bound of the first bucket is 2^LATENCY_HISTOGRAM_MIN_SHIFT usec (8us),
+// and each bucket doubles it up to 2^(LATENCY_HISTOGRAM_MIN_SHIFT + LATENCY_HISTOGRAM_FINITE_BUCKET_COUNT - 1) usec (~16.8s)
+#define LATENCY_HISTOGRAM_MIN_SHIFT 3
+#define LATENCY_HISTOGRAM_FINITE_BUCKET_COUNT 22
+
+namespace mon
+{
+	// A histogram of latencies with logarithmic buckets (the relative error is bounded like HDR histograms),
+	// Record() is lock-free so it can be called for every packet/frame
+	class LatencyHistogram
+	{
+	public:
+		// The last bucket is +Inf
+		static constexpr int BucketCount = LATENCY_HISTOGRAM_FINITE_BUCKET_COUNT + 1;
+
+		struct Snapshot
+		{
+			// Not cumulative
+			uint64_t buckets[BucketCount]{};
+			uint64_t count = 0;
+			uint64_t sum_usec = 0;
+		};
+
+		void Record(int64_t usec)
+		{
+			usec = std::max<int64_t>(usec, 0);
+
+			_buckets[GetBucketIndex(usec)].fetch_add(1, std::memory_order_relaxed);
+			_sum_usec.fetch_add(usec, std::memory_order_relaxed);
+			_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Record(const std::chrono::steady_clock::time_point &start_time)
+		{
+			Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
+		}
+
+		// The buckets/sum/count are not updated atomically together, so they may differ slightly
+		Snapshot GetSnapshot() const;
+
+		// The upper bound of the bucket (-1 for +Inf)
+		static int64_t GetUpperBoundUsec(int index);
+
+	private:
+		static int GetBucketIndex(int64_t usec)
+		{
+			if (usec <= (1LL << LATENCY_HISTOGRAM_MIN_SHIFT))
+			{
+				return 0;
+			}
+
+			// The smallest bucket that 2^(MIN_SHIFT + index) >= usec
+			int bits = 64 - __builtin_clzll(static_cast<uint64_t>(usec - 1));
+
+			return std::min(bits - LATENCY_HISTOGRAM_MIN_SHIFT, LATENCY_HISTOGRAM_FINITE_BUCKET_COUNT);
+		}
+
+		std::atomic<uint64_t> _buckets[BucketCount]{};
+		std::atomic<uint64_t> _sum_usec{0};
+		std::atomic<uint64_t> _count{0};
+	};
+}  // namespace mon
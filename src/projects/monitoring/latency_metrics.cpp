@@ -0,0 +1,331 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "latency_metrics.h"
+
+#include <base/ovsocket/ovsocket.h>
+
+#include <algorithm>
+
+#include "monitoring_private.h"
+
+namespace mon
+{
+	struct LatencyStageInfo
+	{
+		const char *name;
+		const char *help;
+	};
+
+	static const LatencyStageInfo &GetStageInfo(LatencyStage stage)
+	{
+		static const LatencyStageInfo stage_info_list[] = {
+			{"ome_ingest_to_router_seconds", "Time from the creation of a packet by the provider to MediaRouter"},
+			{"ome_router_queue_wait_seconds", "Time a packet waits in the queue of a MediaRouter stream"},
+			{"ome_transcode_decode_seconds", "Time of the decoder calls for a packet"},
+			{"ome_transcode_filter_seconds", "Time of the filter calls for a frame"},
+			{"ome_transcode_encode_seconds", "Time from a frame to the encoder to its encoded packet"},
+			{"ome_publisher_packetize_seconds", "Time a publisher takes to packetize a frame"},
+			{"ome_publisher_send_queue_delay_seconds", "Time a packet waits in the queue of a stream worker before it is sent to the sessions"},
+			{"ome_transcode_decode_delay_seconds", "Time from a packet to the decoder to its decoded frame"}};
+
+		return stage_info_list[static_cast<int>(stage)];
+	}
+
+	static ov::String EscapeLabelValue(const ov::String &value)
+	{
+		ov::String escaped;
+
+		for (size_t index = 0; index < value.GetLength(); index++)
+		{
+			char character = value[index];
+
+			switch (character)
+			{
+				case '\\':
+					escaped.Append("\\\\");
+					break;
+
+				case '"':
+					escaped.Append("\\\"");
+					break;
+
+				case '\n':
+					escaped.Append("\\n");
+					break;
+
+				default:
+					escaped.Append(character);
+					break;
+			}
+		}
+
+		return escaped;
+	}
+
+	// name="value",name="value",...
+	static ov::String MakeLabelsString(const MetricLabels &labels)
+	{
+		ov::String labels_string;
+
+		for (const auto &label : labels)
+		{
+			if (labels_string.IsEmpty() == false)
+			{
+				labels_string.Append(',');
+			}
+
+			labels_string.AppendFormat("%s=\"%s\"", label.first.CStr(), EscapeLabelValue(label.second).CStr());
+		}
+
+		return labels_string;
+	}
+
+	std::shared_ptr<LatencyHistogram> LatencyMetrics::GetHistogram(LatencyStage stage, const MetricLabels &labels)
+	{
+		std::lock_guard<std::mutex> lock_guard(_histogram_map_mutex);
+
+		auto &histogram = _histogram_map[{stage, MakeLabelsString(labels)}];
+
+		if (histogram == nullptr)
+		{
+			histogram = std::make_shared<LatencyHistogram>();
+		}
+
+		return histogram;
+	}
+
+	ov::String LatencyMetrics::ToPrometheusText()
+	{
+		ov::String text;
+
+		std::vector<std::pair<std::pair<LatencyStage, ov::String>, std::shared_ptr<LatencyHistogram>>> histogram_list;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_histogram_map_mutex);
+
+			for (auto item = _histogram_map.begin(); item != _histogram_map.end();)
+			{
+				if (item->second.use_count() == 1)
+				{
+					// Nobody records into it anymore (the stream has been deleted)
+					item = _histogram_map.erase(item);
+					continue;
+				}
+
+				histogram_list.emplace_back(item->first, item->second);
+				++item;
+			}
+		}
+
+		// The histograms are sorted by the stage, so the HELP/TYPE of a stage is written once
+		bool is_first = true;
+		LatencyStage last_stage = LatencyStage::IngestToRouter;
+
+		for (const auto &item : histogram_list)
+		{
+			auto stage = item.first.first;
+			auto &labels_string = item.first.second;
+			auto &stage_info = GetStageInfo(stage);
+			auto label_prefix = labels_string.IsEmpty() ? ov::String("") : ov::String::FormatString("%s,", labels_string.CStr());
+
+			if (is_first || (stage != last_stage))
+			{
+				text.AppendFormat("# HELP %s %s\n", stage_info.name, stage_info.help);
+				text.AppendFormat("# TYPE %s histogram\n", stage_info.name);
+
+				is_first = false;
+				last_stage = stage;
+			}
+
+			auto snapshot = item.second->GetSnapshot();
+			uint64_t cumulative_count = 0;
+
+			for (int index = 0; index < LatencyHistogram::BucketCount; index++)
+			{
+				cumulative_count += snapshot.buckets[index];
+
+				auto upper_bound = LatencyHistogram::GetUpperBoundUsec(index);
+
+				if (upper_bound < 0)
+				{
+					text.AppendFormat("%s_bucket{%sle=\"+Inf\"} %llu\n", stage_info.name, label_prefix.CStr(), static_cast<unsigned long long>(cumulative_count));
+				}
+				else
+				{
+					text.AppendFormat("%s_bucket{%sle=\"%.9g\"} %llu\n", stage_info.name, label_prefix.CStr(), upper_bound / 1000000.0, static_cast<unsigned long long>(cumulative_count));
+				}
+			}
+
+			text.AppendFormat("%s_sum{%s} %.6f\n", stage_info.name, labels_string.CStr(), snapshot.sum_usec / 1000000.0);
+			// The count must be the same as the +Inf bucket
+			text.AppendFormat("%s_count{%s} %llu\n", stage_info.name, labels_string.CStr(), static_cast<unsigned long long>(cumulative_count));
+		}
+
+		// The queues that have the same alias are summed up
+		struct QueueStatus
+		{
+			uint64_t depth = 0;
+			uint64_t bytes = 0;
+			uint64_t dropped_count = 0;
+		};
+
+		std::map<ov::String, QueueStatus> queue_status_map;
+
+		ov::QueueRegistry::ForEach([&queue_status_map](const ov::QueueMetricsInterface &queue) {
+			auto &status = queue_status_map[queue.GetAlias()];
+
+			status.depth += queue.Size();
+			status.bytes += queue.GetBytes();
+			status.dropped_count += queue.GetDroppedCount();
+		});
+
+		text.Append("# HELP ome_queue_depth The number of items in the queue\n");
+		text.Append("# TYPE ome_queue_depth gauge\n");
+
+		for (const auto &item : queue_status_map)
+		{
+			text.AppendFormat("ome_queue_depth{queue=\"%s\"} %llu\n", EscapeLabelValue(item.first).CStr(), static_cast<unsigned long long>(item.second.depth));
+		}
+
+		text.Append("# HELP ome_queue_bytes The bytes of the items in the queue (only the queues that have a byte limit)\n");
+		text.Append("# TYPE ome_queue_bytes gauge\n");
+
+		for (const auto &item : queue_status_map)
+		{
+			if (item.second.bytes > 0)
+			{
+				text.AppendFormat("ome_queue_bytes{queue=\"%s\"} %llu\n", EscapeLabelValue(item.first).CStr(), static_cast<unsigned long long>(item.second.bytes));
+			}
+		}
+
+		text.Append("# HELP ome_queue_dropped_total The number of items dropped by the limit of the queue\n");
+		text.Append("# TYPE ome_queue_dropped_total counter\n");
+
+		for (const auto &item : queue_status_map)
+		{
+			if (item.second.dropped_count > 0)
+			{
+				text.AppendFormat("ome_queue_dropped_total{queue=\"%s\"} %llu\n", EscapeLabelValue(item.first).CStr(), static_cast<unsigned long long>(item.second.dropped_count));
+			}
+		}
+
+		// The threads that have the same name are distinguished by the thread id
+		struct ThreadStatus
+		{
+			ov::String labels;
+			int64_t cpu_time_usec;
+			int64_t idle_time_usec;
+			int64_t uptime_usec;
+			uint64_t loop_count;
+		};
+
+		std::vector<ThreadStatus> thread_status_list;
+
+		ov::ThreadRegistry::ForEach([&thread_status_list](const ov::ThreadMetrics &thread_metrics) {
+			thread_status_list.push_back({
+				ov::String::FormatString("thread=\"%s\",tid=\"%d\"", EscapeLabelValue(thread_metrics.GetName()).CStr(), thread_metrics.GetThreadId()),
+				thread_metrics.GetCpuTimeUsec(),
+				thread_metrics.GetIdleTimeUsec(),
+				thread_metrics.GetUptimeUsec(),
+				thread_metrics.GetLoopCount()});
+		});
+
+		text.Append("# HELP ome_thread_cpu_seconds_total The CPU time consumed by the thread\n");
+		text.Append("# TYPE ome_thread_cpu_seconds_total counter\n");
+
+		for (const auto &status : thread_status_list)
+		{
+			text.AppendFormat("ome_thread_cpu_seconds_total{%s} %.6f\n", status.labels.CStr(), status.cpu_time_usec / 1000000.0);
+		}
+
+		text.Append("# HELP ome_thread_idle_seconds_total The time the thread waited for the work\n");
+		text.Append("# TYPE ome_thread_idle_seconds_total counter\n");
+
+		for (const auto &status : thread_status_list)
+		{
+			text.AppendFormat("ome_thread_idle_seconds_total{%s} %.6f\n", status.labels.CStr(), status.idle_time_usec / 1000000.0);
+		}
+
+		text.Append("# HELP ome_thread_loops_total The number of the iterations of the loop of the thread\n");
+		text.Append("# TYPE ome_thread_loops_total counter\n");
+
+		for (const auto &status : thread_status_list)
+		{
+			text.AppendFormat("ome_thread_loops_total{%s} %llu\n", status.labels.CStr(), static_cast<unsigned long long>(status.loop_count));
+		}
+
+		text.Append("# HELP ome_thread_busy_ratio The ratio of the time the thread was not idle since it started\n");
+		text.Append("# TYPE ome_thread_busy_ratio gauge\n");
+
+		for (const auto &status : thread_status_list)
+		{
+			double busy_ratio = (status.uptime_usec > 0) ? (1.0 - (static_cast<double>(status.idle_time_usec) / status.uptime_usec)) : 0.0;
+
+			text.AppendFormat("ome_thread_busy_ratio{%s} %.4f\n", status.labels.CStr(), std::clamp(busy_ratio, 0.0, 1.0));
+		}
+
+		if (ov::MemoryAccounting::IsEnabled())
+		{
+			constexpr auto category_count = static_cast<size_t>(ov::MemoryCategory::Count);
+
+			text.Append("# HELP ome_memory_bytes The live bytes of ov::Data by where they were allocated\n");
+			text.Append("# TYPE ome_memory_bytes gauge\n");
+
+			for (size_t index = 0; index < category_count; index++)
+			{
+				auto category = static_cast<ov::MemoryCategory>(index);
+
+				text.AppendFormat("ome_memory_bytes{category=\"%s\"} %lld\n", ov::MemoryAccounting::StringFromCategory(category), static_cast<long long>(ov::MemoryAccounting::GetBytes(category)));
+			}
+
+			text.Append("# HELP ome_stream_memory_bytes The live bytes of ov::Data of the stream by where they were allocated\n");
+			text.Append("# TYPE ome_stream_memory_bytes gauge\n");
+
+			for (const auto &snapshot : ov::MemoryAccounting::GetAccountSnapshots())
+			{
+				auto stream_label = EscapeLabelValue(snapshot.name);
+
+				for (size_t index = 0; index < category_count; index++)
+				{
+					if (snapshot.bytes[index] != 0)
+					{
+						text.AppendFormat("ome_stream_memory_bytes{stream=\"%s\",category=\"%s\"} %lld\n",
+										  stream_label.CStr(), ov::MemoryAccounting::StringFromCategory(static_cast<ov::MemoryCategory>(index)), static_cast<long long>(snapshot.bytes[index]));
+					}
+				}
+			}
+		}
+
+		auto accept_statistics = ov::ServerSocket::GetAcceptStatistics();
+
+		text.Append("# HELP ome_tcp_accepted_total The TCP connections accepted by the server sockets\n");
+		text.Append("# TYPE ome_tcp_accepted_total counter\n");
+		text.AppendFormat("ome_tcp_accepted_total %llu\n", static_cast<unsigned long long>(accept_statistics.accepted_count));
+		text.Append("# HELP ome_tcp_accept_errors_total The accept() failures other than EAGAIN (such as EMFILE)\n");
+		text.Append("# TYPE ome_tcp_accept_errors_total counter\n");
+		text.AppendFormat("ome_tcp_accept_errors_total %llu\n", static_cast<unsigned long long>(accept_statistics.error_count));
+		text.Append("# HELP ome_tcp_accept_batch_full_total The times more connections were waiting than the accept batch\n");
+		text.Append("# TYPE ome_tcp_accept_batch_full_total counter\n");
+		text.AppendFormat("ome_tcp_accept_batch_full_total %llu\n", static_cast<unsigned long long>(accept_statistics.batch_full_count));
+
+		if (ov::DataPool::IsEnabled())
+		{
+			// The free buffers are not in ome_memory_bytes
+			text.Append("# HELP ome_data_pool_bytes The bytes held by the size classes of ov::DataPool\n");
+			text.Append("# TYPE ome_data_pool_bytes gauge\n");
+
+			for (const auto &statistics : ov::DataPool::GetStatistics())
+			{
+				text.AppendFormat("ome_data_pool_bytes{size=\"%zu\",state=\"in_use\"} %lld\n", statistics.buffer_size, static_cast<long long>(statistics.in_use_count * static_cast<int64_t>(statistics.buffer_size)));
+				text.AppendFormat("ome_data_pool_bytes{size=\"%zu\",state=\"free\"} %lld\n", statistics.buffer_size, static_cast<long long>(statistics.free_count * static_cast<int64_t>(statistics.buffer_size)));
+			}
+		}
+
+		return text;
+	}
+}  // namespace mon
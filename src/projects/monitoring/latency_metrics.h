@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "latency_histogram.h"
+
+namespace mon
+{
+	// Where the latency is measured
+	enum class LatencyStage : uint8_t
+	{
+		// From the creation of a packet by the provider to MediaRouter
+		IngestToRouter,
+		// The time a packet waits in the queue of a MediaRouter stream
+		RouterQueueWait,
+		// The time of the decoder/filter calls for a packet/frame (per decoder/filter)
+		Decode,
+		Filter,
+		// From a frame to the encoder to its encoded packet (per rendition)
+		Encode,
+		// The time a publisher takes to packetize a frame and queue the packets to the stream workers
+		Packetize,
+		// The time a packet waits in the queue of a stream worker before it is sent to the sessions
+		SendQueueDelay,
+		// From a packet to the decoder to its decoded frame (the delay of the frame threading/reordering, per decoder)
+		DecodeDelay
+	};
+
+	using MetricLabels = std::vector<std::pair<ov::String, ov::String>>;
+
+	// The latency histograms of the media pipeline, and the exporter of them (Prometheus text format)
+	class LatencyMetrics
+	{
+	public:
+		// The histogram of the stage/labels is shared by the callers (created if it doesn't exist).
+		// The caller keeps the histogram and records into it, and the histogram is not exported anymore after all callers release it.
+		std::shared_ptr<LatencyHistogram> GetHistogram(LatencyStage stage, const MetricLabels &labels);
+
+		// The histograms, the depths of all ov::Queue instances and the statistics of all ov::ThreadMetrics
+		// in the Prometheus text exposition format (version 0.0.4)
+		ov::String ToPrometheusText();
+
+	private:
+		std::mutex _histogram_map_mutex;
+		// <stage, labels string> : histogram
+		std::map<std::pair<LatencyStage, ov::String>, std::shared_ptr<LatencyHistogram>> _histogram_map;
+	};
+}  // namespace mon
@@ -0,0 +1,206 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "metrics_server.h"
+
+#include "monitoring.h"
+#include "monitoring_private.h"
+#include "packet_tracer.h"
+#include "profiler.h"
+
+namespace mon
+{
+	// The worst sessions of all streams (See StreamMetrics::GetWorstSessions())
+	static ov::String GetWorstSessionsJson()
+	{
+		Json::Value root;
+		Json::Value &streams = root["streams"];
+
+		streams = Json::arrayValue;
+
+		for (const auto &host : MonitorInstance->GetHostMetricsList())
+		{
+			for (const auto &app : host.second->GetApplicationMetricsList())
+			{
+				for (const auto &item : app.second->GetStreamMetricsList())
+				{
+					auto &stream_metrics = item.second;
+					auto worst_sessions = stream_metrics->GetWorstSessions();
+
+					if (worst_sessions.empty())
+					{
+						continue;
+					}
+
+					Json::Value stream;
+
+					stream["app"] = app.second->GetName().CStr();
+					stream["stream"] = stream_metrics->GetName().CStr();
+					stream["slowSessionsDisconnected"] = static_cast<Json::UInt64>(stream_metrics->GetSlowSessionDisconnectedCount());
+
+					Json::Value &sessions = stream["sessions"];
+					sessions = Json::arrayValue;
+
+					for (const auto &session_stats : worst_sessions)
+					{
+						Json::Value session;
+
+						session["id"] = session_stats.session_id;
+						session["publisher"] = ov::Converter::ToString(session_stats.publisher_type).CStr();
+						session["sentBytes"] = static_cast<Json::UInt64>(session_stats.sent_bytes);
+						session["sentPackets"] = static_cast<Json::UInt64>(session_stats.sent_packets);
+						session["droppedPackets"] = static_cast<Json::UInt64>(session_stats.dropped_packets);
+						session["nack"] = static_cast<Json::UInt64>(session_stats.nack_count);
+						session["retransmittedPackets"] = static_cast<Json::UInt64>(session_stats.retransmitted_packets);
+						session["keyFrameRequests"] = static_cast<Json::UInt64>(session_stats.key_frame_request_count);
+						session["rttMsec"] = session_stats.rtt_ms;
+						session["lossPercent"] = session_stats.GetLossPercent();
+						session["queueDelayMsec"] = session_stats.queue_delay_ms;
+
+						sessions.append(session);
+					}
+
+					streams.append(stream);
+				}
+			}
+		}
+
+		return ov::Json::Stringify(root);
+	}
+
+	bool MetricsServer::Start(const ov::SocketAddress &address)
+	{
+		if (_http_server != nullptr)
+		{
+			OV_ASSERT(false, "Server is already running");
+			return false;
+		}
+
+		auto interceptor = std::make_shared<MonitoringInterceptor>();
+
+		interceptor->Register(HttpMethod::Get, "/metrics(\\?.*)?", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+			auto text = MonitorInstance->GetLatencyMetrics().ToPrometheusText();
+			text.Append(MonitorInstance->GetResourceMetrics().ToPrometheusText());
+			text.Append(MonitorInstance->GetTranscodeMetrics().ToPrometheusText());
+			text.Append(MonitorInstance->GetPullMetrics().ToPrometheusText());
+
+			response->SetHeader("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+			response->SetHeader("Content-Length", ov::String::FormatString("%zu", text.GetLength()));
+			response->AppendString(text);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		// ?format=chrome returns the traces in the format of chrome://tracing
+		interceptor->Register(HttpMethod::Get, "/traces(\\?.*)?", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+			bool is_chrome_format = (client->GetRequest()->GetRequestTarget().IndexOf("format=chrome") >= 0);
+			auto text = is_chrome_format ? PacketTracer::GetInstance()->ToChromeTraceJson() : PacketTracer::GetInstance()->ToJson();
+
+			response->SetHeader("Content-Type", "application/json");
+			response->SetHeader("Content-Length", ov::String::FormatString("%zu", text.GetLength()));
+			response->AppendString(text);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		interceptor->Register(HttpMethod::Get, "/sessions(\\?.*)?", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+			auto text = GetWorstSessionsJson();
+
+			response->SetHeader("Content-Type", "application/json");
+			response->SetHeader("Content-Length", ov::String::FormatString("%zu", text.GetLength()));
+			response->AppendString(text);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		// ?seconds=N (default: 10) - the request is completed after the profiling
+		interceptor->Register(HttpMethod::Get, "/profile(\\?.*)?", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+			auto target = client->GetRequest()->GetRequestTarget();
+			auto seconds_index = target.IndexOf("seconds=");
+			int duration_sec = (seconds_index >= 0) ? ::atoi(target.CStr() + seconds_index + 8) : 10;
+
+			ov::String folded_stacks;
+			ov::String error_message;
+
+			if (Profiler::GetInstance()->Profile(duration_sec, &folded_stacks, &error_message) == false)
+			{
+				folded_stacks = error_message + "\n";
+				response->SetStatusCode(Profiler::GetInstance()->IsEnabled() ? HttpStatusCode::Conflict : HttpStatusCode::Forbidden);
+			}
+
+			response->SetHeader("Content-Type", "text/plain; charset=utf-8");
+			response->SetHeader("Content-Length", ov::String::FormatString("%zu", folded_stacks.GetLength()));
+			response->AppendString(folded_stacks);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		// 503 while the load shedding rejects the new sessions, so the load balancers can route the viewers to other servers
+		interceptor->Register(HttpMethod::Get, "/health(\\?.*)?", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+			auto &resource_metrics = MonitorInstance->GetResourceMetrics();
+			auto json = resource_metrics.ToJson();
+
+			if (resource_metrics.IsOverloaded())
+			{
+				response->SetStatusCode(HttpStatusCode::ServiceUnavailable);
+			}
+
+			response->SetHeader("Content-Type", "application/json");
+			response->SetHeader("Content-Length", ov::String::FormatString("%zu", json->GetLength()));
+			// The cached JSON is not copied
+			response->AppendData(json);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		interceptor->Register(HttpMethod::Get, ".*", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+
+			response->SetStatusCode(HttpStatusCode::NotFound);
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		auto http_server = std::make_shared<HttpServer>();
+
+		if ((http_server->AddInterceptor(interceptor) == false) || (http_server->Start(address) == false))
+		{
+			logte("Could not start the metrics server on %s", address.ToString().CStr());
+			return false;
+		}
+
+		logti("The metrics server is listening on %s (GET /metrics, /traces, /sessions, /profile, /health)", address.ToString().CStr());
+
+		_http_server = http_server;
+
+		return true;
+	}
+
+	bool MetricsServer::Stop()
+	{
+		if (_http_server == nullptr)
+		{
+			return false;
+		}
+
+		auto result = _http_server->Stop();
+		_http_server = nullptr;
+
+		return result;
+	}
+}  // namespace mon
@@ -0,0 +1,24 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "monitoring_interceptor.h"
+
+namespace mon
+{
+	// Serves the metrics of LatencyMetrics at GET /metrics (Prometheus text format)
+	class MetricsServer
+	{
+	public:
+		bool Start(const ov::SocketAddress &address);
+		bool Stop();
+
+	private:
+		std::shared_ptr<HttpServer> _http_server;
+	};
+}  // namespace mon
@@ -14,6 +14,9 @@ namespace mon
 			auto &host = t.second;
 			host->ShowInfo();
 		}
+
+		_transcode_metrics.ShowInfo();
+		_pull_metrics.ShowInfo();
 	}
 
 	void Monitoring::Release()
@@ -101,6 +104,26 @@ namespace mon
 		return app_metrics->OnStreamDeleted(stream);
 	}
 
+	TranscodeMetrics &Monitoring::GetTranscodeMetrics()
+	{
+		return _transcode_metrics;
+	}
+
+	LatencyMetrics &Monitoring::GetLatencyMetrics()
+	{
+		return _latency_metrics;
+	}
+
+	ResourceMetrics &Monitoring::GetResourceMetrics()
+	{
+		return _resource_metrics;
+	}
+
+	PullMetrics &Monitoring::GetPullMetrics()
+	{
+		return _pull_metrics;
+	}
+
 	std::shared_ptr<HostMetrics> Monitoring::GetHostMetrics(const info::Host &host_info)
 	{
 		std::shared_lock<std::shared_mutex> lock(_map_guard);
@@ -112,6 +135,12 @@ namespace mon
 		return _hosts[host_info.GetId()];
 	}
 
+	std::map<uint32_t, std::shared_ptr<HostMetrics>> Monitoring::GetHostMetricsList()
+	{
+		std::shared_lock<std::shared_mutex> lock(_map_guard);
+		return _hosts;
+	}
+
 	std::shared_ptr<ApplicationMetrics> Monitoring::GetApplicationMetrics(const info::Application &app_info)
 	{
 		auto host_metric = GetHostMetrics(app_info.GetHostInfo());
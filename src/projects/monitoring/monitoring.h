@@ -7,6 +7,10 @@
 #include "base/info/host.h"
 #include "base/info/info.h"
 #include "host_metrics.h"
+#include "latency_metrics.h"
+#include "pull_metrics.h"
+#include "resource_metrics.h"
+#include "transcode_metrics.h"
 #include <shared_mutex>
 
 #define MonitorInstance				mon::Monitoring::GetInstance()
@@ -39,9 +43,21 @@ namespace mon
         std::shared_ptr<HostMetrics> GetHostMetrics(const info::Host &host_info);
         std::shared_ptr<ApplicationMetrics> GetApplicationMetrics(const info::Application &app_info);
         std::shared_ptr<StreamMetrics>  GetStreamMetrics(const info::Stream &stream_info);
+		// A copy of the map, to iterate without the lock
+		std::map<uint32_t, std::shared_ptr<HostMetrics>> GetHostMetricsList();
+
+		TranscodeMetrics &GetTranscodeMetrics();
+		LatencyMetrics &GetLatencyMetrics();
+		ResourceMetrics &GetResourceMetrics();
+		PullMetrics &GetPullMetrics();
 
 	private:
 		std::shared_mutex _map_guard;
 		std::map<uint32_t, std::shared_ptr<HostMetrics>> _hosts;
+
+		TranscodeMetrics _transcode_metrics;
+		LatencyMetrics _latency_metrics;
+		ResourceMetrics _resource_metrics;
+		PullMetrics _pull_metrics;
 	};
 }  // namespace mon
\ No newline at end of file
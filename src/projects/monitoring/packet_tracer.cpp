@@ -0,0 +1,237 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "packet_tracer.h"
+
+#include <map>
+
+#include "monitoring_private.h"
+
+namespace mon
+{
+	static const char *GetStageName(int stage)
+	{
+		static const char *stage_name_list[] = {
+			"created",
+			"routerIn",
+			"routerInPopped",
+			"transcodeIn",
+			"routerOut",
+			"routerOutPopped",
+			"publisherQueued",
+			"packetized",
+			"sessionSent"};
+
+		static_assert(OV_COUNTOF(stage_name_list) == static_cast<int>(PacketTraceStage::StageCount), "The names of the stages must be updated");
+
+		return stage_name_list[stage];
+	}
+
+	static int64_t ToUsec(const std::chrono::steady_clock::time_point &time_point)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(time_point.time_since_epoch()).count();
+	}
+
+	PacketTrace::PacketTrace(uint64_t id, const ov::String &app_name, const ov::String &stream_name, int32_t track_id, int64_t pts)
+		: _id(id),
+		  _app_name(app_name),
+		  _stream_name(stream_name),
+		  _track_id(track_id),
+		  _pts(pts)
+	{
+	}
+
+	PacketTrace::~PacketTrace()
+	{
+		if (_is_forked == false)
+		{
+			PacketTracer::GetInstance()->Submit(*this);
+		}
+	}
+
+	void PacketTrace::Mark(PacketTraceStage stage, const std::chrono::steady_clock::time_point &time_point)
+	{
+		int64_t expected = 0;
+
+		_timestamps[static_cast<int>(stage)].compare_exchange_strong(expected, ToUsec(time_point), std::memory_order_relaxed);
+	}
+
+	std::shared_ptr<PacketTrace> PacketTrace::Fork(const char *publisher_name)
+	{
+		auto trace = std::make_shared<PacketTrace>(PacketTracer::GetInstance()->IssueTraceId(), _app_name, _stream_name, _track_id, _pts);
+
+		trace->_publisher_name = publisher_name;
+
+		for (int stage = 0; stage < static_cast<int>(PacketTraceStage::StageCount); stage++)
+		{
+			trace->_timestamps[stage].store(_timestamps[stage].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+		_is_forked = true;
+
+		return trace;
+	}
+
+	PacketTracer *PacketTracer::GetInstance()
+	{
+		static auto instance = new PacketTracer();
+		return instance;
+	}
+
+	void PacketTracer::SetSampleInterval(uint32_t sample_interval)
+	{
+		_sample_interval = sample_interval;
+	}
+
+	void PacketTracer::Submit(const PacketTrace &trace)
+	{
+		Record record{trace.GetId(), trace.GetPublisherName(), trace.GetAppName(), trace.GetStreamName(), trace.GetTrackId(), trace.GetPts(), {}};
+
+		for (int stage = 0; stage < static_cast<int>(PacketTraceStage::StageCount); stage++)
+		{
+			record.timestamps[stage] = trace.GetTimestamp(static_cast<PacketTraceStage>(stage));
+		}
+
+		std::lock_guard<std::mutex> lock_guard(_record_mutex);
+
+		if (_records.size() >= PACKET_TRACER_MAX_TRACE_COUNT)
+		{
+			_records.pop_front();
+		}
+
+		_records.push_back(std::move(record));
+	}
+
+	std::vector<PacketTracer::Record> PacketTracer::GetRecords()
+	{
+		std::lock_guard<std::mutex> lock_guard(_record_mutex);
+
+		return std::vector<Record>(_records.begin(), _records.end());
+	}
+
+	ov::String PacketTracer::ToJson()
+	{
+		Json::Value root;
+		Json::Value &traces = root["traces"];
+
+		traces = Json::arrayValue;
+
+		for (const auto &record : GetRecords())
+		{
+			Json::Value trace;
+
+			trace["id"] = static_cast<Json::UInt64>(record.id);
+			trace["publisher"] = record.publisher_name.CStr();
+			trace["app"] = record.app_name.CStr();
+			trace["stream"] = record.stream_name.CStr();
+			trace["track"] = record.track_id;
+			trace["pts"] = static_cast<Json::Int64>(record.pts);
+
+			Json::Value &stages = trace["stages"];
+			stages = Json::objectValue;
+
+			int64_t first_timestamp = 0;
+			int64_t last_timestamp = 0;
+
+			for (int stage = 0; stage < static_cast<int>(PacketTraceStage::StageCount); stage++)
+			{
+				auto timestamp = record.timestamps[stage];
+
+				if (timestamp == 0)
+				{
+					continue;
+				}
+
+				if (first_timestamp == 0)
+				{
+					first_timestamp = timestamp;
+				}
+
+				last_timestamp = timestamp;
+
+				stages[GetStageName(stage)] = static_cast<Json::Int64>(timestamp - first_timestamp);
+			}
+
+			trace["totalUsec"] = static_cast<Json::Int64>(last_timestamp - first_timestamp);
+
+			traces.append(trace);
+		}
+
+		return ov::Json::Stringify(root);
+	}
+
+	ov::String PacketTracer::ToChromeTraceJson()
+	{
+		Json::Value root;
+		Json::Value &events = root["traceEvents"];
+
+		events = Json::arrayValue;
+
+		// A process per stream ("publisher app/stream"), a thread per trace
+		std::map<ov::String, int> process_id_map;
+
+		for (const auto &record : GetRecords())
+		{
+			auto process_name = ov::String::FormatString("%s%s%s/%s",
+														 record.publisher_name.CStr(), record.publisher_name.IsEmpty() ? "" : " ",
+														 record.app_name.CStr(), record.stream_name.CStr());
+
+			auto process_item = process_id_map.find(process_name);
+			int process_id = 0;
+
+			if (process_item == process_id_map.end())
+			{
+				process_id = static_cast<int>(process_id_map.size()) + 1;
+				process_id_map[process_name] = process_id;
+
+				Json::Value metadata;
+
+				metadata["name"] = "process_name";
+				metadata["ph"] = "M";
+				metadata["pid"] = process_id;
+				metadata["args"]["name"] = process_name.CStr();
+
+				events.append(metadata);
+			}
+			else
+			{
+				process_id = process_item->second;
+			}
+
+			int last_stage = -1;
+
+			for (int stage = 0; stage < static_cast<int>(PacketTraceStage::StageCount); stage++)
+			{
+				if (record.timestamps[stage] == 0)
+				{
+					continue;
+				}
+
+				if (last_stage >= 0)
+				{
+					Json::Value event;
+
+					event["name"] = ov::String::FormatString("%s -> %s", GetStageName(last_stage), GetStageName(stage)).CStr();
+					event["cat"] = "packet";
+					event["ph"] = "X";
+					event["ts"] = static_cast<Json::Int64>(record.timestamps[last_stage]);
+					event["dur"] = static_cast<Json::Int64>(record.timestamps[stage] - record.timestamps[last_stage]);
+					event["pid"] = process_id;
+					event["tid"] = static_cast<Json::UInt64>(record.id);
+					event["args"]["track"] = record.track_id;
+					event["args"]["pts"] = static_cast<Json::Int64>(record.pts);
+
+					events.append(event);
+				}
+
+				last_stage = stage;
+			}
+		}
+
+		return ov::Json::Stringify(root);
+	}
+}  // namespace mon
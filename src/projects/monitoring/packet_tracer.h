@@ -0,0 +1,165 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "base/common_types.h"
+
+// The number of the completed traces kept by PacketTracer
+#define PACKET_TRACER_MAX_TRACE_COUNT 1024
+
+namespace mon
+{
+	// The hops of a packet through the pipeline (in order)
+	enum class PacketTraceStage : uint8_t
+	{
+		// The packet was created by the provider (after it was received and parsed) or by the encoder
+		Created,
+		// Pushed to/popped from the incoming stream of MediaRouter
+		RouterIn,
+		RouterInPopped,
+		// Received by the transcoder (the trace of a transcoded track ends here, the encoded packets are traced separately)
+		TranscodeIn,
+		// Pushed to/popped from the outgoing stream of MediaRouter
+		RouterOut,
+		RouterOutPopped,
+		// Queued to the application of a publisher
+		PublisherQueued,
+		// Packetized by the stream of the publisher
+		Packetized,
+		// The first packet of the frame was passed to the sessions
+		SessionSent,
+
+		StageCount
+	};
+
+	// The timestamps of the stages of a sampled packet (See PacketTracer), shared by the clones of the packet
+	// It is submitted to PacketTracer when it is released, unless it has been forked for the publishers.
+	class PacketTrace
+	{
+	public:
+		PacketTrace(uint64_t id, const ov::String &app_name, const ov::String &stream_name, int32_t track_id, int64_t pts);
+		~PacketTrace();
+
+		// Only the first time of each stage is kept (the packet may be cloned for several outputs)
+		void Mark(PacketTraceStage stage, const std::chrono::steady_clock::time_point &time_point = std::chrono::steady_clock::now());
+
+		// Each publisher traces its own copy from here, the stages that are already marked are copied
+		std::shared_ptr<PacketTrace> Fork(const char *publisher_name);
+
+		uint64_t GetId() const
+		{
+			return _id;
+		}
+
+		const ov::String &GetPublisherName() const
+		{
+			return _publisher_name;
+		}
+
+		const ov::String &GetAppName() const
+		{
+			return _app_name;
+		}
+
+		const ov::String &GetStreamName() const
+		{
+			return _stream_name;
+		}
+
+		int32_t GetTrackId() const
+		{
+			return _track_id;
+		}
+
+		int64_t GetPts() const
+		{
+			return _pts;
+		}
+
+		// usec of steady_clock (0: the stage was not reached)
+		int64_t GetTimestamp(PacketTraceStage stage) const
+		{
+			return _timestamps[static_cast<int>(stage)].load(std::memory_order_relaxed);
+		}
+
+	private:
+		uint64_t _id;
+		ov::String _publisher_name;
+		ov::String _app_name;
+		ov::String _stream_name;
+		int32_t _track_id;
+		int64_t _pts;
+
+		std::atomic<int64_t> _timestamps[static_cast<int>(PacketTraceStage::StageCount)]{};
+		std::atomic<bool> _is_forked{false};
+	};
+
+	// Samples 1 of N packets that enter MediaRouter (See MediaRouteStream::Push()), and keeps the last traces of them
+	class PacketTracer
+	{
+	public:
+		// Never destroyed, because the packets may be released after the static objects are destroyed
+		static PacketTracer *GetInstance();
+
+		// 0 disables the tracing
+		void SetSampleInterval(uint32_t sample_interval);
+
+		// Whether the packet should be traced (1 of N calls)
+		bool ShouldSample()
+		{
+			auto sample_interval = _sample_interval.load(std::memory_order_relaxed);
+
+			return (sample_interval > 0) && ((_sample_count.fetch_add(1, std::memory_order_relaxed) % sample_interval) == 0);
+		}
+
+		std::shared_ptr<PacketTrace> CreateTrace(const ov::String &app_name, const ov::String &stream_name, int32_t track_id, int64_t pts)
+		{
+			return std::make_shared<PacketTrace>(IssueTraceId(), app_name, stream_name, track_id, pts);
+		}
+
+		uint64_t IssueTraceId()
+		{
+			return _last_trace_id.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		void Submit(const PacketTrace &trace);
+
+		// {"traces": [{"id", "publisher", "app", "stream", "track", "pts", "stages": {"created": 0, "routerIn": usec from created, ...}, "totalUsec"}]}
+		ov::String ToJson();
+		// The Trace Event Format of Chrome (chrome://tracing, Perfetto), a hop between the stages is a complete event
+		ov::String ToChromeTraceJson();
+
+	private:
+		struct Record
+		{
+			uint64_t id;
+			ov::String publisher_name;
+			ov::String app_name;
+			ov::String stream_name;
+			int32_t track_id;
+			int64_t pts;
+			int64_t timestamps[static_cast<int>(PacketTraceStage::StageCount)];
+		};
+
+		std::vector<Record> GetRecords();
+
+		std::atomic<uint32_t> _sample_interval{0};
+		std::atomic<uint64_t> _sample_count{0};
+		std::atomic<uint64_t> _last_trace_id{0};
+
+		std::mutex _record_mutex;
+		std::deque<Record> _records;
+	};
+}  // namespace mon
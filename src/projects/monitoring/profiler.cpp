@@ -0,0 +1,218 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "profiler.h"
+
+#include <execinfo.h>
+#include <sys/prctl.h>
+#include <sys/time.h>
+
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+#include "monitoring_private.h"
+
+// The frames of OnSignal() and the signal trampoline
+#define PROFILER_SKIP_FRAME_COUNT 2
+
+namespace mon
+{
+	Profiler *Profiler::GetInstance()
+	{
+		static auto instance = new Profiler();
+
+		return instance;
+	}
+
+	void Profiler::SetEnabled(bool is_enabled, int frequency, int max_duration_sec)
+	{
+		std::lock_guard<std::mutex> lock_guard(_profile_mutex);
+
+		_frequency = std::clamp(frequency, 1, 1000);
+		_max_duration_sec = std::max(max_duration_sec, 1);
+
+		if (is_enabled)
+		{
+			// backtrace() loads libgcc at the first call, which is not allowed in the signal handler
+			void *frame = nullptr;
+			::backtrace(&frame, 1);
+		}
+
+		_is_enabled = is_enabled;
+	}
+
+	bool Profiler::IsEnabled() const
+	{
+		return _is_enabled;
+	}
+
+	int Profiler::GetMaxDuration() const
+	{
+		return _max_duration_sec;
+	}
+
+	void Profiler::OnSignal(int signum, siginfo_t *info, void *context)
+	{
+		auto profiler = GetInstance();
+
+		if (profiler->_is_sampling.load(std::memory_order_relaxed) == false)
+		{
+			return;
+		}
+
+		auto index = profiler->_sample_count.fetch_add(1, std::memory_order_relaxed);
+
+		if (index >= PROFILER_MAX_SAMPLE_COUNT)
+		{
+			return;
+		}
+
+		int saved_errno = errno;
+		auto &sample = profiler->_samples[index];
+
+		sample.depth = ::backtrace(sample.frames, PROFILER_MAX_STACK_DEPTH);
+		::prctl(PR_GET_NAME, sample.thread_name, 0, 0, 0);
+		sample.is_completed.store(true, std::memory_order_release);
+
+		errno = saved_errno;
+	}
+
+	bool Profiler::Profile(int duration_sec, ov::String *folded_stacks, ov::String *error_message)
+	{
+		if (_is_enabled == false)
+		{
+			*error_message = "The profiler is disabled";
+			return false;
+		}
+
+		std::unique_lock<std::mutex> lock(_profile_mutex, std::try_to_lock);
+
+		if (lock.owns_lock() == false)
+		{
+			*error_message = "Another profiling is in progress";
+			return false;
+		}
+
+		duration_sec = std::clamp(duration_sec, 1, _max_duration_sec);
+
+		if (_samples == nullptr)
+		{
+			_samples = new Sample[PROFILER_MAX_SAMPLE_COUNT];
+		}
+
+		if (_is_handler_installed == false)
+		{
+			// The handler is not uninstalled, because a pending SIGPROF may be delivered after the timer is stopped
+			struct sigaction action = {};
+
+			action.sa_sigaction = OnSignal;
+			action.sa_flags = SA_SIGINFO | SA_RESTART;
+			::sigemptyset(&action.sa_mask);
+
+			if (::sigaction(SIGPROF, &action, nullptr) != 0)
+			{
+				error_message->Format("Could not install the handler of SIGPROF: %s", ::strerror(errno));
+				return false;
+			}
+
+			_is_handler_installed = true;
+		}
+
+		for (size_t index = 0; index < PROFILER_MAX_SAMPLE_COUNT; index++)
+		{
+			_samples[index].is_completed = false;
+		}
+
+		_sample_count = 0;
+		_is_sampling = true;
+
+		// ITIMER_PROF counts the CPU time of the process, so the busy threads are sampled more
+		struct itimerval timer = {};
+		timer.it_interval.tv_usec = 1000000 / _frequency;
+		timer.it_value = timer.it_interval;
+
+		if (::setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+		{
+			_is_sampling = false;
+			error_message->Format("Could not start the timer: %s", ::strerror(errno));
+			return false;
+		}
+
+		logti("Profiling for %d seconds (%d Hz)", duration_sec, _frequency);
+
+		std::this_thread::sleep_for(std::chrono::seconds(duration_sec));
+
+		timer = {};
+		::setitimer(ITIMER_PROF, &timer, nullptr);
+		_is_sampling = false;
+
+		// The handlers that have started before the timer is stopped
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+		size_t sample_count = _sample_count;
+
+		if (sample_count > PROFILER_MAX_SAMPLE_COUNT)
+		{
+			logtw("%zu samples have been dropped", sample_count - PROFILER_MAX_SAMPLE_COUNT);
+			sample_count = PROFILER_MAX_SAMPLE_COUNT;
+		}
+
+		*folded_stacks = ToFoldedStacks(sample_count);
+
+		logti("Profiling is completed (%zu samples)", sample_count);
+
+		return true;
+	}
+
+	ov::String Profiler::ToFoldedStacks(size_t sample_count)
+	{
+		// The symbolization is expensive, so each address is symbolized once
+		std::unordered_map<void *, ov::String> symbol_cache;
+		std::map<ov::String, uint64_t> stack_counts;
+
+		for (size_t index = 0; index < sample_count; index++)
+		{
+			auto &sample = _samples[index];
+
+			if (sample.is_completed.load(std::memory_order_acquire) == false)
+			{
+				continue;
+			}
+
+			ov::String stack = sample.thread_name;
+
+			// The frames are from the leaf to the root
+			for (int frame_index = sample.depth - 1; frame_index >= PROFILER_SKIP_FRAME_COUNT; frame_index--)
+			{
+				auto address = sample.frames[frame_index];
+				auto symbol = symbol_cache.find(address);
+
+				if (symbol == symbol_cache.end())
+				{
+					// ';' separates the frames and ' ' separates the count in the folded format
+					auto name = ov::StackTrace::GetSymbolName(address).Replace(";", ":").Replace(" ", "_");
+					symbol = symbol_cache.emplace(address, name).first;
+				}
+
+				stack.Append(';');
+				stack.Append(symbol->second);
+			}
+
+			stack_counts[stack]++;
+		}
+
+		ov::String folded_stacks;
+
+		for (const auto &item : stack_counts)
+		{
+			folded_stacks.AppendFormat("%s %" PRIu64 "\n", item.first.CStr(), item.second);
+		}
+
+		return folded_stacks;
+	}
+}  // namespace mon
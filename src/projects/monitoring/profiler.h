@@ -0,0 +1,66 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <signal.h>
+
+#include <atomic>
+#include <mutex>
+
+#define PROFILER_MAX_STACK_DEPTH 48
+// The samples beyond this are dropped (about 60 seconds of 99 Hz on 16 busy cores)
+#define PROFILER_MAX_SAMPLE_COUNT 100000
+
+namespace mon
+{
+	// Samples the stacks of the threads that are using the CPU with SIGPROF (ITIMER_PROF),
+	// so a flame graph can be made where perf cannot be attached (e.g. in the containers)
+	class Profiler
+	{
+	public:
+		// Never destroyed, because SIGPROF may be delivered while the static objects are destroyed
+		static Profiler *GetInstance();
+
+		// Profile() fails unless it is enabled
+		void SetEnabled(bool is_enabled, int frequency, int max_duration_sec);
+		bool IsEnabled() const;
+		int GetMaxDuration() const;
+
+		// Samples the stacks for the duration (blocking the caller), and returns them in the folded format
+		// ("<thread>;<root frame>;...;<leaf frame> <count>" per line, the input of flamegraph.pl and speedscope).
+		// Only one profiling runs at a time.
+		bool Profile(int duration_sec, ov::String *folded_stacks, ov::String *error_message);
+
+	private:
+		struct Sample
+		{
+			std::atomic<bool> is_completed{false};
+			char thread_name[16];
+			int depth;
+			void *frames[PROFILER_MAX_STACK_DEPTH];
+		};
+
+		// Must be async-signal-safe
+		static void OnSignal(int signum, siginfo_t *info, void *context);
+
+		ov::String ToFoldedStacks(size_t sample_count);
+
+		std::atomic<bool> _is_enabled{false};
+		int _frequency = 99;
+		int _max_duration_sec = 60;
+
+		std::mutex _profile_mutex;
+		bool _is_handler_installed = false;
+
+		// Allocated by the first Profile(), and reused
+		Sample *_samples = nullptr;
+		std::atomic<bool> _is_sampling{false};
+		std::atomic<size_t> _sample_count{0};
+	};
+}  // namespace mon
@@ -0,0 +1,105 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "pull_metrics.h"
+
+#include "monitoring_private.h"
+
+namespace mon
+{
+	ov::String PullMetrics::GetInfoString()
+	{
+		ov::String out_str;
+
+		out_str.AppendFormat(
+			"\n\t>> Pull connections\n"
+			"\tWaiting : %u, Connecting : %u, Succeeded : %llu, Failed : %llu, Timed out : %llu\n",
+			GetWaitingCount(), GetConnectingCount(),
+			static_cast<unsigned long long>(GetSucceededCount()),
+			static_cast<unsigned long long>(GetFailedCount()),
+			static_cast<unsigned long long>(GetTimedOutCount()));
+
+		return out_str;
+	}
+
+	void PullMetrics::ShowInfo()
+	{
+		logti("%s", GetInfoString().CStr());
+	}
+
+	void PullMetrics::OnWaiting()
+	{
+		_waiting_count++;
+	}
+
+	void PullMetrics::OnConnecting()
+	{
+		_waiting_count--;
+		_connecting_count++;
+	}
+
+	void PullMetrics::OnSucceeded()
+	{
+		_connecting_count--;
+		_succeeded_count++;
+	}
+
+	void PullMetrics::OnFailed()
+	{
+		_connecting_count--;
+		_failed_count++;
+	}
+
+	void PullMetrics::OnTimedOut()
+	{
+		_waiting_count--;
+		_timed_out_count++;
+	}
+
+	uint32_t PullMetrics::GetWaitingCount() const
+	{
+		return _waiting_count;
+	}
+
+	uint32_t PullMetrics::GetConnectingCount() const
+	{
+		return _connecting_count;
+	}
+
+	uint64_t PullMetrics::GetSucceededCount() const
+	{
+		return _succeeded_count;
+	}
+
+	uint64_t PullMetrics::GetFailedCount() const
+	{
+		return _failed_count;
+	}
+
+	uint64_t PullMetrics::GetTimedOutCount() const
+	{
+		return _timed_out_count;
+	}
+
+	ov::String PullMetrics::ToPrometheusText()
+	{
+		ov::String text;
+
+		text.Append("# HELP ome_pull_streams The pull streams that are waiting for a connection slot or connecting to the origins\n");
+		text.Append("# TYPE ome_pull_streams gauge\n");
+		text.AppendFormat("ome_pull_streams{state=\"waiting\"} %u\n", GetWaitingCount());
+		text.AppendFormat("ome_pull_streams{state=\"connecting\"} %u\n", GetConnectingCount());
+
+		text.Append("# HELP ome_pull_requests_total The number of the pull requests by the result\n");
+		text.Append("# TYPE ome_pull_requests_total counter\n");
+		text.AppendFormat("ome_pull_requests_total{result=\"succeeded\"} %llu\n", static_cast<unsigned long long>(GetSucceededCount()));
+		text.AppendFormat("ome_pull_requests_total{result=\"failed\"} %llu\n", static_cast<unsigned long long>(GetFailedCount()));
+		text.AppendFormat("ome_pull_requests_total{result=\"timed_out\"} %llu\n", static_cast<unsigned long long>(GetTimedOutCount()));
+
+		return text;
+	}
+}  // namespace mon
@@ -0,0 +1,53 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+
+#include "base/common_types.h"
+
+namespace mon
+{
+	// The pull streams that are connecting to the origins (Updated by PullConnectionLimiter)
+	//
+	// After a restart, the progress of the reconnects is (succeeded + failed) / (waiting + connecting + succeeded + failed)
+	class PullMetrics
+	{
+	public:
+		ov::String GetInfoString();
+		void ShowInfo();
+
+		void OnWaiting();
+		// The pull has got a slot
+		void OnConnecting();
+		void OnSucceeded();
+		void OnFailed();
+		// The pull has not got a slot within the wait time
+		void OnTimedOut();
+
+		// The pulls that are waiting for a slot (or for the back-off of the origins)
+		uint32_t GetWaitingCount() const;
+		uint32_t GetConnectingCount() const;
+
+		// Total counts since the server started
+		uint64_t GetSucceededCount() const;
+		uint64_t GetFailedCount() const;
+		uint64_t GetTimedOutCount() const;
+
+		// The gauges/counters in the Prometheus text exposition format (version 0.0.4)
+		ov::String ToPrometheusText();
+
+	private:
+		std::atomic<uint32_t> _waiting_count{0};
+		std::atomic<uint32_t> _connecting_count{0};
+
+		std::atomic<uint64_t> _succeeded_count{0};
+		std::atomic<uint64_t> _failed_count{0};
+		std::atomic<uint64_t> _timed_out_count{0};
+	};
+}  // namespace mon
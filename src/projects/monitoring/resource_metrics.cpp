@@ -0,0 +1,433 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "resource_metrics.h"
+
+#include <unistd.h>
+
+#include "monitoring_private.h"
+
+namespace mon
+{
+	// The files of /proc are small, and their size is not known before reading
+	static ov::String ReadProcFile(const char *path)
+	{
+		ov::String content;
+		auto file = ::fopen(path, "r");
+
+		if (file == nullptr)
+		{
+			return content;
+		}
+
+		char buffer[4096];
+		size_t length;
+
+		while ((length = ::fread(buffer, 1, sizeof(buffer), file)) > 0)
+		{
+			content.Append(buffer, length);
+		}
+
+		::fclose(file);
+
+		return content;
+	}
+
+	bool ResourceMetrics::ReadCpuTimes(CpuTimes *cpu_times)
+	{
+		auto content = ReadProcFile("/proc/stat");
+		unsigned long long values[8] = {};
+
+		// cpu  user nice system idle iowait irq softirq steal ...
+		if (::sscanf(content.CStr(), "cpu %llu %llu %llu %llu %llu %llu %llu %llu",
+					 &values[0], &values[1], &values[2], &values[3], &values[4], &values[5], &values[6], &values[7]) < 4)
+		{
+			return false;
+		}
+
+		cpu_times->total = 0;
+
+		for (auto value : values)
+		{
+			cpu_times->total += value;
+		}
+
+		cpu_times->idle = values[3] + values[4];
+
+		return true;
+	}
+
+	bool ResourceMetrics::ReadProcessCpuTicks(uint64_t *ticks)
+	{
+		auto content = ReadProcFile("/proc/self/stat");
+		// The process name can have spaces, so the fields are parsed after the last ')'
+		auto fields = ::strrchr(content.CStr(), ')');
+		unsigned long utime = 0;
+		unsigned long stime = 0;
+
+		// state(3) ppid pgrp session tty_nr tpgid flags minflt cminflt majflt cmajflt utime(14) stime(15)
+		if ((fields == nullptr) || (::sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) != 2))
+		{
+			return false;
+		}
+
+		*ticks = utime + stime;
+
+		return true;
+	}
+
+	bool ResourceMetrics::ReadMemory(uint64_t *total_bytes, uint64_t *available_bytes, uint64_t *process_rss_bytes)
+	{
+		auto lines = ReadProcFile("/proc/meminfo").Split("\n");
+		unsigned long long total_kb = 0;
+		unsigned long long available_kb = 0;
+
+		for (const auto &line : lines)
+		{
+			::sscanf(line.CStr(), "MemTotal: %llu kB", &total_kb);
+			::sscanf(line.CStr(), "MemAvailable: %llu kB", &available_kb);
+		}
+
+		if (total_kb == 0)
+		{
+			return false;
+		}
+
+		*total_bytes = total_kb * 1024;
+		*available_bytes = available_kb * 1024;
+
+		// size resident ...
+		unsigned long long resident_pages = 0;
+
+		if (::sscanf(ReadProcFile("/proc/self/statm").CStr(), "%*u %llu", &resident_pages) == 1)
+		{
+			*process_rss_bytes = resident_pages * ::sysconf(_SC_PAGESIZE);
+		}
+
+		return true;
+	}
+
+	bool ResourceMetrics::ReadNetworkBytes(uint64_t *rx_bytes, uint64_t *tx_bytes)
+	{
+		auto lines = ReadProcFile("/proc/net/dev").Split("\n");
+
+		*rx_bytes = 0;
+		*tx_bytes = 0;
+
+		// <interface>: <rx bytes> packets errs drop fifo frame compressed multicast <tx bytes> ...
+		for (const auto &line : lines)
+		{
+			auto tokens = line.Split(":");
+
+			if ((tokens.size() != 2) || (tokens[0].Trim() == "lo"))
+			{
+				continue;
+			}
+
+			unsigned long long rx = 0;
+			unsigned long long tx = 0;
+
+			if (::sscanf(tokens[1].CStr(), "%llu %*u %*u %*u %*u %*u %*u %*u %llu", &rx, &tx) == 2)
+			{
+				*rx_bytes += rx;
+				*tx_bytes += tx;
+			}
+		}
+
+		return true;
+	}
+
+	bool ResourceMetrics::ReadSocketBufferUsage(double *tcp_usage, double *udp_usage)
+	{
+		auto lines = ReadProcFile("/proc/net/sockstat").Split("\n");
+		unsigned long long tcp_pages = 0;
+		unsigned long long udp_pages = 0;
+
+		for (const auto &line : lines)
+		{
+			if (line.HasPrefix("TCP:"))
+			{
+				auto index = line.IndexOf(" mem ");
+				tcp_pages = (index >= 0) ? ::strtoull(line.CStr() + index + 5, nullptr, 10) : 0;
+			}
+			else if (line.HasPrefix("UDP:"))
+			{
+				auto index = line.IndexOf(" mem ");
+				udp_pages = (index >= 0) ? ::strtoull(line.CStr() + index + 5, nullptr, 10) : 0;
+			}
+		}
+
+		// min pressure max (pages)
+		unsigned long long tcp_max_pages = 0;
+		unsigned long long udp_max_pages = 0;
+
+		::sscanf(ReadProcFile("/proc/sys/net/ipv4/tcp_mem").CStr(), "%*u %*u %llu", &tcp_max_pages);
+		::sscanf(ReadProcFile("/proc/sys/net/ipv4/udp_mem").CStr(), "%*u %*u %llu", &udp_max_pages);
+
+		*tcp_usage = (tcp_max_pages > 0) ? (tcp_pages * 100.0 / tcp_max_pages) : 0.0;
+		*udp_usage = (udp_max_pages > 0) ? (udp_pages * 100.0 / udp_max_pages) : 0.0;
+
+		return true;
+	}
+
+	bool ResourceMetrics::ReadUdpBufferErrors(uint64_t *errors)
+	{
+		auto lines = ReadProcFile("/proc/net/snmp").Split("\n");
+		std::vector<ov::String> names;
+
+		// "Udp: InDatagrams NoPorts InErrors OutDatagrams RcvbufErrors SndbufErrors ..." followed by the values
+		for (const auto &line : lines)
+		{
+			if (line.HasPrefix("Udp:") == false)
+			{
+				continue;
+			}
+
+			auto tokens = line.Split(" ");
+
+			if (names.empty())
+			{
+				names = std::move(tokens);
+				continue;
+			}
+
+			*errors = 0;
+
+			for (size_t index = 1; (index < tokens.size()) && (index < names.size()); index++)
+			{
+				if ((names[index] == "RcvbufErrors") || (names[index] == "SndbufErrors"))
+				{
+					*errors += ::strtoull(tokens[index].CStr(), nullptr, 10);
+				}
+			}
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void ResourceMetrics::Update()
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		ResourceSnapshot snapshot;
+		CpuTimes cpu_times;
+		uint64_t process_cpu_ticks = 0;
+		uint64_t rx_bytes = 0;
+		uint64_t tx_bytes = 0;
+		uint64_t udp_buffer_errors = 0;
+
+		bool is_cpu_read = ReadCpuTimes(&cpu_times) && ReadProcessCpuTicks(&process_cpu_ticks);
+		bool is_memory_read = ReadMemory(&snapshot.memory_total_bytes, &snapshot.memory_available_bytes, &snapshot.process_rss_bytes);
+		bool is_network_read = ReadNetworkBytes(&rx_bytes, &tx_bytes);
+		ReadSocketBufferUsage(&snapshot.tcp_buffer_usage, &snapshot.udp_buffer_usage);
+		bool is_udp_errors_read = ReadUdpBufferErrors(&udp_buffer_errors);
+
+		if (is_memory_read)
+		{
+			snapshot.memory_usage = (snapshot.memory_total_bytes - snapshot.memory_available_bytes) * 100.0 / snapshot.memory_total_bytes;
+		}
+
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		if (_has_last_values)
+		{
+			auto elapsed_sec = std::chrono::duration<double>(now - _last_update_time).count();
+
+			if (is_cpu_read && (cpu_times.total > _last_cpu_times.total))
+			{
+				auto total = cpu_times.total - _last_cpu_times.total;
+				auto idle = cpu_times.idle - _last_cpu_times.idle;
+
+				snapshot.cpu_usage = (total - std::min(idle, total)) * 100.0 / total;
+				snapshot.process_cpu_usage = ((process_cpu_ticks - _last_process_cpu_ticks) * 100.0 / ::sysconf(_SC_CLK_TCK)) / elapsed_sec;
+			}
+
+			if (is_network_read && (elapsed_sec > 0.0))
+			{
+				// The counters are reset when an interface is removed
+				snapshot.network_rx_bps = (rx_bytes >= _last_rx_bytes) ? static_cast<uint64_t>((rx_bytes - _last_rx_bytes) * 8 / elapsed_sec) : 0;
+				snapshot.network_tx_bps = (tx_bytes >= _last_tx_bytes) ? static_cast<uint64_t>((tx_bytes - _last_tx_bytes) * 8 / elapsed_sec) : 0;
+			}
+
+			if (is_udp_errors_read && (elapsed_sec > 0.0) && (udp_buffer_errors >= _last_udp_buffer_errors))
+			{
+				snapshot.udp_buffer_errors_per_sec = static_cast<uint64_t>((udp_buffer_errors - _last_udp_buffer_errors) / elapsed_sec);
+			}
+
+			snapshot.is_valid = is_cpu_read && is_memory_read;
+		}
+
+		_has_last_values = true;
+		_last_update_time = now;
+		_last_cpu_times = cpu_times;
+		_last_process_cpu_ticks = process_cpu_ticks;
+		_last_rx_bytes = rx_bytes;
+		_last_tx_bytes = tx_bytes;
+		_last_udp_buffer_errors = udp_buffer_errors;
+
+		_snapshot = snapshot;
+		// Built again by the next ToJson()
+		_json = nullptr;
+		_json_generation++;
+	}
+
+	ResourceSnapshot ResourceMetrics::GetSnapshot()
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+		return _snapshot;
+	}
+
+	void ResourceMetrics::SetLoadSheddingLimits(const LoadSheddingLimits &limits)
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+		_limits = limits;
+		_json = nullptr;
+		_json_generation++;
+	}
+
+	bool ResourceMetrics::IsOverloaded(ov::String *reason)
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		if ((_limits.is_enabled == false) || (_snapshot.is_valid == false))
+		{
+			return false;
+		}
+
+		ov::String overload_reason;
+
+		if ((_limits.max_cpu_usage > 0.0) && (_snapshot.cpu_usage > _limits.max_cpu_usage))
+		{
+			overload_reason.Format("CPU usage %.1f%% > %.1f%%", _snapshot.cpu_usage, _limits.max_cpu_usage);
+		}
+		else if ((_limits.max_memory_usage > 0.0) && (_snapshot.memory_usage > _limits.max_memory_usage))
+		{
+			overload_reason.Format("Memory usage %.1f%% > %.1f%%", _snapshot.memory_usage, _limits.max_memory_usage);
+		}
+		else if ((_limits.max_network_tx_bps > 0) && (_snapshot.network_tx_bps > _limits.max_network_tx_bps))
+		{
+			overload_reason.Format("Network TX %" PRIu64 " Mbps > %" PRIu64 " Mbps", _snapshot.network_tx_bps / 1000000, _limits.max_network_tx_bps / 1000000);
+		}
+		else if ((_limits.max_socket_buffer_usage > 0.0) &&
+				 (std::max(_snapshot.tcp_buffer_usage, _snapshot.udp_buffer_usage) > _limits.max_socket_buffer_usage))
+		{
+			overload_reason.Format("Socket buffer usage (TCP %.1f%%, UDP %.1f%%) > %.1f%%", _snapshot.tcp_buffer_usage, _snapshot.udp_buffer_usage, _limits.max_socket_buffer_usage);
+		}
+		else
+		{
+			return false;
+		}
+
+		if (reason != nullptr)
+		{
+			*reason = overload_reason;
+		}
+
+		return true;
+	}
+
+	ov::String ResourceMetrics::GetInfoString()
+	{
+		auto snapshot = GetSnapshot();
+
+		if (snapshot.is_valid == false)
+		{
+			return "";
+		}
+
+		return ov::String::FormatString(
+			"CPU: %.1f%% (process: %.1f%%), Memory: %.1f%% (process RSS: %" PRIu64 " MB), Network: RX %" PRIu64 " Mbps / TX %" PRIu64 " Mbps\n"
+			"Socket buffers: TCP %.1f%%, UDP %.1f%% (UDP buffer errors: %" PRIu64 "/s)\n",
+			snapshot.cpu_usage, snapshot.process_cpu_usage, snapshot.memory_usage, snapshot.process_rss_bytes / (1024 * 1024),
+			snapshot.network_rx_bps / 1000000, snapshot.network_tx_bps / 1000000,
+			snapshot.tcp_buffer_usage, snapshot.udp_buffer_usage, snapshot.udp_buffer_errors_per_sec);
+	}
+
+	ov::String ResourceMetrics::ToPrometheusText()
+	{
+		auto snapshot = GetSnapshot();
+		ov::String text;
+
+		if (snapshot.is_valid == false)
+		{
+			return text;
+		}
+
+		auto append_gauge = [&text](const char *name, const char *help, double value) {
+			text.AppendFormat("# HELP %s %s\n", name, help);
+			text.AppendFormat("# TYPE %s gauge\n", name);
+			text.AppendFormat("%s %.9g\n", name, value);
+		};
+
+		append_gauge("ome_host_cpu_usage_percent", "The CPU usage of the host (all cores)", snapshot.cpu_usage);
+		append_gauge("ome_process_cpu_usage_percent", "The CPU usage of OvenMediaEngine (100 = a core)", snapshot.process_cpu_usage);
+		append_gauge("ome_host_memory_usage_percent", "The memory usage of the host except the page cache", snapshot.memory_usage);
+		append_gauge("ome_process_resident_memory_bytes", "The resident memory of OvenMediaEngine", snapshot.process_rss_bytes);
+		append_gauge("ome_host_network_receive_bps", "The received bits per second of all interfaces except the loopback", snapshot.network_rx_bps);
+		append_gauge("ome_host_network_transmit_bps", "The transmitted bits per second of all interfaces except the loopback", snapshot.network_tx_bps);
+		append_gauge("ome_host_tcp_buffer_usage_percent", "The memory of the TCP socket buffers relative to tcp_mem", snapshot.tcp_buffer_usage);
+		append_gauge("ome_host_udp_buffer_usage_percent", "The memory of the UDP socket buffers relative to udp_mem", snapshot.udp_buffer_usage);
+		append_gauge("ome_host_udp_buffer_errors_per_second", "The datagrams dropped because the socket buffers were full", snapshot.udp_buffer_errors_per_sec);
+		append_gauge("ome_overloaded", "Whether the new sessions and pulls are rejected by the load shedding", IsOverloaded() ? 1.0 : 0.0);
+
+		return text;
+	}
+
+	std::shared_ptr<const ov::Data> ResourceMetrics::ToJson()
+	{
+		uint64_t generation;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_mutex);
+
+			if (_json != nullptr)
+			{
+				return _json;
+			}
+
+			generation = _json_generation;
+		}
+
+		auto snapshot = GetSnapshot();
+		ov::String reason;
+		bool is_overloaded = IsOverloaded(&reason);
+		ov::JsonWriter writer(512);
+
+		writer.BeginObject()
+			.Member("overloaded", is_overloaded);
+
+		if (reason.IsEmpty() == false)
+		{
+			writer.Member("reason", reason);
+		}
+
+		writer.Member("cpuUsage", snapshot.cpu_usage)
+			.Member("processCpuUsage", snapshot.process_cpu_usage)
+			.Member("memoryUsage", snapshot.memory_usage)
+			.Member("processRssBytes", snapshot.process_rss_bytes)
+			.Member("networkRxBps", snapshot.network_rx_bps)
+			.Member("networkTxBps", snapshot.network_tx_bps)
+			.Member("tcpBufferUsage", snapshot.tcp_buffer_usage)
+			.Member("udpBufferUsage", snapshot.udp_buffer_usage)
+			.Member("udpBufferErrorsPerSec", snapshot.udp_buffer_errors_per_sec)
+			.EndObject();
+
+		std::shared_ptr<const ov::Data> json = writer.ToData();
+
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		// If Update() is called while building the JSON, the next ToJson() builds it again
+		if (generation == _json_generation)
+		{
+			_json = json;
+		}
+
+		return json;
+	}
+}  // namespace mon
@@ -0,0 +1,106 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <mutex>
+
+namespace mon
+{
+	// The resources of the machine (not per virtual host, they share the machine)
+	struct ResourceSnapshot
+	{
+		bool is_valid = false;
+
+		// 0~100 (all cores)
+		double cpu_usage = 0.0;
+		// 100 = a core
+		double process_cpu_usage = 0.0;
+
+		uint64_t memory_total_bytes = 0;
+		uint64_t memory_available_bytes = 0;
+		uint64_t process_rss_bytes = 0;
+		// 0~100 (except the page cache)
+		double memory_usage = 0.0;
+
+		// All interfaces except the loopback (bps)
+		uint64_t network_rx_bps = 0;
+		uint64_t network_tx_bps = 0;
+
+		// The memory of the socket buffers relative to the maximum of the kernel (tcp_mem/udp_mem, 0~100)
+		double tcp_buffer_usage = 0.0;
+		double udp_buffer_usage = 0.0;
+		// The datagrams dropped because the socket buffers were full (per second)
+		uint64_t udp_buffer_errors_per_sec = 0;
+	};
+
+	// The thresholds to reject the new sessions/pulls (0 disables the threshold)
+	struct LoadSheddingLimits
+	{
+		bool is_enabled = false;
+		double max_cpu_usage = 0.0;
+		double max_memory_usage = 0.0;
+		uint64_t max_network_tx_bps = 0;
+		double max_socket_buffer_usage = 0.0;
+	};
+
+	// Samples the resources from /proc, and decides whether the server accepts more load
+	class ResourceMetrics
+	{
+	public:
+		// Called about every second (the rates are calculated from the last call)
+		void Update();
+
+		ResourceSnapshot GetSnapshot();
+
+		void SetLoadSheddingLimits(const LoadSheddingLimits &limits);
+		// Whether the new sessions/pulls should be rejected, *reason is set if overloaded
+		bool IsOverloaded(ov::String *reason = nullptr);
+
+		ov::String GetInfoString();
+		// The gauges in the Prometheus text exposition format (version 0.0.4)
+		ov::String ToPrometheusText();
+		// {"overloaded", "reason", "cpuUsage", ...} for the health check of the load balancers
+		//
+		// The JSON is built once per Update() and shared by the responses until the next Update()
+		// (the load balancers poll it frequently)
+		std::shared_ptr<const ov::Data> ToJson();
+
+	private:
+		struct CpuTimes
+		{
+			uint64_t total = 0;
+			uint64_t idle = 0;
+		};
+
+		static bool ReadCpuTimes(CpuTimes *cpu_times);
+		static bool ReadProcessCpuTicks(uint64_t *ticks);
+		static bool ReadMemory(uint64_t *total_bytes, uint64_t *available_bytes, uint64_t *process_rss_bytes);
+		static bool ReadNetworkBytes(uint64_t *rx_bytes, uint64_t *tx_bytes);
+		static bool ReadSocketBufferUsage(double *tcp_usage, double *udp_usage);
+		static bool ReadUdpBufferErrors(uint64_t *errors);
+
+		std::mutex _mutex;
+
+		ResourceSnapshot _snapshot;
+		LoadSheddingLimits _limits;
+		// The cache of ToJson() (nullptr if it should be built again)
+		std::shared_ptr<const ov::Data> _json;
+		uint64_t _json_generation = 0;
+
+		// The values of the last Update() to calculate the rates
+		bool _has_last_values = false;
+		std::chrono::steady_clock::time_point _last_update_time;
+		CpuTimes _last_cpu_times;
+		uint64_t _last_process_cpu_ticks = 0;
+		uint64_t _last_rx_bytes = 0;
+		uint64_t _last_tx_bytes = 0;
+		uint64_t _last_udp_buffer_errors = 0;
+	};
+}  // namespace mon
@@ -0,0 +1,86 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include "base/common_types.h"
+
+namespace mon
+{
+	// The egress statistics of a session.
+	// Updated by the threads that send the packets and process the feedback of the session, so all fields are atomic.
+	struct SessionStats
+	{
+		// The bytes/packets that are actually passed to the socket (after SRTP, including the retransmissions)
+		std::atomic<uint64_t> sent_bytes{0};
+		std::atomic<uint64_t> sent_packets{0};
+		// The packets that could not be sent (the socket buffer is full (EAGAIN), or the session is closed)
+		std::atomic<uint64_t> dropped_packets{0};
+
+		std::atomic<uint64_t> nack_count{0};
+		std::atomic<uint64_t> retransmitted_packets{0};
+		// PLI/FIR
+		std::atomic<uint64_t> key_frame_request_count{0};
+
+		// From the last receiver report (-1: unknown)
+		std::atomic<int32_t> rtt_ms{-1};
+		// 1/256
+		std::atomic<uint8_t> fraction_lost{0};
+		// Average time that the packets wait in the pacer of the session
+		std::atomic<int32_t> queue_delay_ms{0};
+	};
+
+	// A copy of SessionStats at a point in time, to report
+	struct SessionStatsSnapshot
+	{
+		SessionStatsSnapshot() = default;
+
+		SessionStatsSnapshot(uint32_t session_id, PublisherType publisher_type, const SessionStats &stats)
+			: session_id(session_id),
+			  publisher_type(publisher_type),
+			  sent_bytes(stats.sent_bytes),
+			  sent_packets(stats.sent_packets),
+			  dropped_packets(stats.dropped_packets),
+			  nack_count(stats.nack_count),
+			  retransmitted_packets(stats.retransmitted_packets),
+			  key_frame_request_count(stats.key_frame_request_count),
+			  rtt_ms(stats.rtt_ms),
+			  fraction_lost(stats.fraction_lost),
+			  queue_delay_ms(stats.queue_delay_ms)
+		{
+		}
+
+		double GetLossPercent() const
+		{
+			return (fraction_lost * 100.0) / 256.0;
+		}
+
+		// Higher is worse. 1% of the loss weighs as much as 100 ms of the delay.
+		double GetScore() const
+		{
+			return queue_delay_ms + std::max(rtt_ms, 0) + (GetLossPercent() * 100.0);
+		}
+
+		uint32_t session_id = 0;
+		PublisherType publisher_type = PublisherType::Unknown;
+
+		uint64_t sent_bytes = 0;
+		uint64_t sent_packets = 0;
+		uint64_t dropped_packets = 0;
+
+		uint64_t nack_count = 0;
+		uint64_t retransmitted_packets = 0;
+		uint64_t key_frame_request_count = 0;
+
+		int32_t rtt_ms = -1;
+		uint8_t fraction_lost = 0;
+		int32_t queue_delay_ms = 0;
+	};
+}  // namespace mon
@@ -20,6 +20,57 @@ namespace mon
 									"\tElapsed time in response from origin server : %f ms\n",
 									GetOriginRequestTimeMSec(), GetOriginResponseTimeMSec());
 		}
+
+		if(GetPacingQueueDelayMSec() > 0)
+		{
+			out_str.AppendFormat("\n\tPacing queue delay : %f ms\n", GetPacingQueueDelayMSec());
+		}
+
+		auto handshake_count = GetDtlsHandshakeCount();
+
+		if(handshake_count > 0)
+		{
+			static const int64_t buckets[] = DTLS_HANDSHAKE_LATENCY_BUCKETS;
+			auto histogram = GetDtlsHandshakeLatencyHistogram();
+
+			out_str.AppendFormat("\n\tDTLS handshakes : %" PRIu64 " (resumed: %" PRIu64 ")\n\tDTLS handshake latency :", handshake_count, GetDtlsResumedHandshakeCount());
+
+			for(size_t index = 0; index < histogram.size(); index++)
+			{
+				if(index < OV_COUNTOF(buckets))
+				{
+					out_str.AppendFormat(" <=%" PRId64 "ms: %" PRIu64, buckets[index], histogram[index]);
+				}
+				else
+				{
+					out_str.AppendFormat(" >%" PRId64 "ms: %" PRIu64, buckets[OV_COUNTOF(buckets) - 1], histogram[index]);
+				}
+			}
+
+			out_str.Append("\n");
+		}
+
+		if(GetQueueDroppedPacketCount() > 0)
+		{
+			out_str.AppendFormat("\n\tDropped by backpressure : %" PRIu64 " packets (%" PRIu64 " bytes)\n", GetQueueDroppedPacketCount(), GetQueueDroppedBytes());
+		}
+
+		auto worst_sessions = GetWorstSessions();
+
+		if(worst_sessions.empty() == false)
+		{
+			out_str.AppendFormat("\n\tWorst sessions (slow sessions disconnected: %" PRIu64 ") :\n", GetSlowSessionDisconnectedCount());
+
+			for(const auto &session : worst_sessions)
+			{
+				out_str.AppendFormat("\t\t#%u (%s) sent: %" PRIu64 " bytes/%" PRIu64 " packets, dropped: %" PRIu64 ", NACK: %" PRIu64 " (retransmitted: %" PRIu64 "), PLI/FIR: %" PRIu64 ", RTT: %d ms, loss: %.1f%%, queue delay: %d ms\n",
+									 session.session_id, ov::Converter::ToString(session.publisher_type).CStr(),
+									 session.sent_bytes, session.sent_packets, session.dropped_packets,
+									 session.nack_count, session.retransmitted_packets, session.key_frame_request_count,
+									 session.rtt_ms, session.GetLossPercent(), session.queue_delay_ms);
+			}
+		}
+
 		out_str.Append("\n");
 		out_str.Append(CommonMetrics::GetInfoString());
 
@@ -40,6 +91,10 @@ namespace mon
 	{
 		return _response_time_from_origin_msec;
 	}
+	double StreamMetrics::GetPacingQueueDelayMSec()
+	{
+		return _pacing_queue_delay_msec;
+	}
 
 	// Setter
 	void StreamMetrics::SetOriginRequestTimeMSec(double value)
@@ -52,16 +107,103 @@ namespace mon
 		_response_time_from_origin_msec = value;
 		UpdateDate();
 	}
+	void StreamMetrics::UpdatePacingQueueDelayMSec(double value)
+	{
+		// Each session reports its own delay, so the reports are smoothed
+		// (Not atomic as a whole, but a lost update is harmless for the average)
+		_pacing_queue_delay_msec = (_pacing_queue_delay_msec * 0.9) + (value * 0.1);
+	}
+
+	void StreamMetrics::OnDtlsHandshakeCompleted(int64_t latency_msec, bool is_resumed)
+	{
+		static const int64_t buckets[] = DTLS_HANDSHAKE_LATENCY_BUCKETS;
+		static_assert(OV_COUNTOF(buckets) + 1 == DTLS_HANDSHAKE_LATENCY_BUCKET_COUNT, "The bucket count is mismatched");
+
+		size_t index = 0;
+
+		while((index < OV_COUNTOF(buckets)) && (latency_msec > buckets[index]))
+		{
+			index++;
+		}
+
+		_dtls_handshake_latency_histogram[index]++;
+
+		if(is_resumed)
+		{
+			_dtls_resumed_handshake_count++;
+		}
+	}
+
+	std::vector<uint64_t> StreamMetrics::GetDtlsHandshakeLatencyHistogram()
+	{
+		std::vector<uint64_t> histogram;
+
+		for(auto &count : _dtls_handshake_latency_histogram)
+		{
+			histogram.push_back(count);
+		}
+
+		return histogram;
+	}
+
+	uint64_t StreamMetrics::GetDtlsHandshakeCount()
+	{
+		uint64_t total = 0;
+
+		for(auto &count : _dtls_handshake_latency_histogram)
+		{
+			total += count;
+		}
+
+		return total;
+	}
+
+	uint64_t StreamMetrics::GetDtlsResumedHandshakeCount()
+	{
+		return _dtls_resumed_handshake_count;
+	}
+
+	StreamMetrics *StreamMetrics::GetOriginStreamMetrics()
+	{
+		auto origin_stream_metrics = _origin_stream_metrics.load(std::memory_order_acquire);
+
+		if(origin_stream_metrics != nullptr)
+		{
+			return origin_stream_metrics;
+		}
+
+		auto origin_stream_info = GetOriginStream();
+		if(origin_stream_info == nullptr)
+		{
+			return nullptr;
+		}
+
+		// The origin stream may not be registered yet, then it is looked up again next time
+		auto origin_stream_metrics_holder = _app_metrics->GetStreamMetrics(*origin_stream_info);
+		if(origin_stream_metrics_holder == nullptr)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(_origin_stream_metrics_mutex);
+
+		if(_origin_stream_metrics_holder == nullptr)
+		{
+			_origin_stream_metrics_holder = origin_stream_metrics_holder;
+			_origin_stream_metrics.store(_origin_stream_metrics_holder.get(), std::memory_order_release);
+		}
+
+		return _origin_stream_metrics_holder.get();
+	}
 
 	void StreamMetrics::IncreaseBytesIn(uint64_t value)
 	{
 		CommonMetrics::IncreaseBytesIn(value);
 
 		// If this stream is child then send event to parent
-		auto origin_stream_info = GetOriginStream();
-		if(origin_stream_info != nullptr)
+		if(_is_child_stream)
 		{
-			auto origin_stream_metric = _app_metrics->GetStreamMetrics(*origin_stream_info);
+			auto origin_stream_metric = GetOriginStreamMetrics();
 			if(origin_stream_metric != nullptr)
 			{
 				origin_stream_metric->IncreaseBytesIn(value);
@@ -70,7 +212,7 @@ namespace mon
 		else
 		{
 			// Forward value to AppMetrics to sum
-			GetApplicationMetrics()->IncreaseBytesIn(value);
+			_app_metrics->IncreaseBytesIn(value);
 		}
 	}
 
@@ -79,10 +221,9 @@ namespace mon
 		CommonMetrics::IncreaseBytesOut(type, value);
 
 		// If this stream is child then send event to parent
-		auto origin_stream_info = GetOriginStream();
-		if(origin_stream_info != nullptr)
+		if(_is_child_stream)
 		{
-			auto origin_stream_metric = _app_metrics->GetStreamMetrics(*origin_stream_info);
+			auto origin_stream_metric = GetOriginStreamMetrics();
 			if(origin_stream_metric != nullptr)
 			{
 				origin_stream_metric->IncreaseBytesOut(type, value);
@@ -91,7 +232,7 @@ namespace mon
 		else
 		{
 			// Forward value to AppMetrics to sum
-			GetApplicationMetrics()->IncreaseBytesOut(type, value);
+			_app_metrics->IncreaseBytesOut(type, value);
 		}
 	}
 
@@ -100,10 +241,9 @@ namespace mon
 		CommonMetrics::OnSessionConnected(type);
 
 		// If this stream is child then send event to parent
-		auto origin_stream_info = GetOriginStream();
-		if(origin_stream_info != nullptr)
+		if(_is_child_stream)
 		{
-			auto origin_stream_metric = _app_metrics->GetStreamMetrics(*origin_stream_info);
+			auto origin_stream_metric = GetOriginStreamMetrics();
 			if(origin_stream_metric != nullptr)
 			{
 				origin_stream_metric->OnSessionConnected(type);
@@ -112,11 +252,11 @@ namespace mon
 		else
 		{
 			// Sending a connection event to application only if it hasn't origin stream to prevent double sum. 
-			GetApplicationMetrics()->OnSessionConnected(type);
+			_app_metrics->OnSessionConnected(type);
 
 			logti("A new session has started playing %s/%s on the %s publihser. %s(%u)/Stream total(%u)/App total(%u)", 
 					GetApplicationInfo().GetName().CStr(), GetName().CStr(), 
-					ov::Converter::ToString(type).CStr(), ov::Converter::ToString(type).CStr(), GetConnections(type), GetTotalConnections(), GetApplicationMetrics()->GetTotalConnections());
+					ov::Converter::ToString(type).CStr(), ov::Converter::ToString(type).CStr(), GetConnections(type), GetTotalConnections(), _app_metrics->GetTotalConnections());
 		}
 	}
 	
@@ -125,10 +265,9 @@ namespace mon
 		CommonMetrics::OnSessionDisconnected(type);
 
 		// If this stream is child then send event to parent
-		auto origin_stream_info = GetOriginStream();
-		if(origin_stream_info != nullptr)
+		if(_is_child_stream)
 		{
-			auto origin_stream_metric = _app_metrics->GetStreamMetrics(*origin_stream_info);
+			auto origin_stream_metric = GetOriginStreamMetrics();
 			if(origin_stream_metric != nullptr)
 			{
 				origin_stream_metric->OnSessionDisconnected(type);
@@ -137,12 +276,75 @@ namespace mon
 		else
 		{
 			// Sending a connection event to application only if it hasn't origin stream to prevent double sum. 
-			GetApplicationMetrics()->OnSessionDisconnected(type);
+			_app_metrics->OnSessionDisconnected(type);
 
 			logti("A session has stopped playing %s/%s on the %s publihser. Concurrent Viewers[%s(%u)/Stream total(%u)/App total(%u)]", 
 					GetApplicationInfo().GetName().CStr(), GetName().CStr(), 
-					ov::Converter::ToString(type).CStr(), ov::Converter::ToString(type).CStr(), GetConnections(type), GetTotalConnections(), GetApplicationMetrics()->GetTotalConnections());
+					ov::Converter::ToString(type).CStr(), ov::Converter::ToString(type).CStr(), GetConnections(type), GetTotalConnections(), _app_metrics->GetTotalConnections());
+		}
+	}
+
+	void StreamMetrics::OnQueuePacketDropped(uint64_t bytes)
+	{
+		_queue_dropped_packet_count++;
+		_queue_dropped_bytes += bytes;
+	}
+
+	uint64_t StreamMetrics::GetQueueDroppedPacketCount()
+	{
+		return _queue_dropped_packet_count;
+	}
+
+	uint64_t StreamMetrics::GetQueueDroppedBytes()
+	{
+		return _queue_dropped_bytes;
+	}
+
+	void StreamMetrics::UpdateWorstSessions(const void *worker, std::vector<SessionStatsSnapshot> sessions)
+	{
+		std::lock_guard<std::mutex> lock(_worst_sessions_mutex);
+
+		if(sessions.empty())
+		{
+			_worst_sessions.erase(worker);
+			return;
+		}
+
+		_worst_sessions[worker] = std::move(sessions);
+	}
+
+	std::vector<SessionStatsSnapshot> StreamMetrics::GetWorstSessions(size_t count)
+	{
+		std::vector<SessionStatsSnapshot> worst_sessions;
+
+		{
+			std::lock_guard<std::mutex> lock(_worst_sessions_mutex);
+
+			for(const auto &item : _worst_sessions)
+			{
+				worst_sessions.insert(worst_sessions.end(), item.second.begin(), item.second.end());
+			}
+		}
+
+		std::sort(worst_sessions.begin(), worst_sessions.end(), [](const SessionStatsSnapshot &a, const SessionStatsSnapshot &b) {
+			return a.GetScore() > b.GetScore();
+		});
+
+		if(worst_sessions.size() > count)
+		{
+			worst_sessions.resize(count);
 		}
+
+		return worst_sessions;
 	}
 
+	void StreamMetrics::OnSlowSessionDisconnected()
+	{
+		_slow_session_disconnected_count++;
+	}
+
+	uint64_t StreamMetrics::GetSlowSessionDisconnectedCount()
+	{
+		return _slow_session_disconnected_count;
+	}
 }  // namespace mon
\ No newline at end of file
@@ -9,6 +9,13 @@
 #include "base/info/info.h"
 #include "base/info/stream.h"
 #include "common_metrics.h"
+#include "session_stats.h"
+
+// Upper bounds of the buckets of the DTLS handshake latency histogram (ms), the last bucket is for the rest
+#define DTLS_HANDSHAKE_LATENCY_BUCKETS	{10, 25, 50, 100, 250, 500, 1000, 2500, 5000}
+#define DTLS_HANDSHAKE_LATENCY_BUCKET_COUNT	10
+// The number of the worst sessions that are kept per stream
+#define WORST_SESSION_COUNT	10
 
 namespace mon
 {
@@ -22,6 +29,10 @@ namespace mon
 		{
 			_request_time_to_origin_msec = 0;
 			_response_time_from_origin_msec = 0;
+			_pacing_queue_delay_msec = 0;
+
+			// The stream is copied, so the origin stream is not changed
+			_is_child_stream = (GetOriginStream() != nullptr);
 		}
 
 		~StreamMetrics()
@@ -42,16 +53,63 @@ namespace mon
 		void SetOriginRequestTimeMSec(double value);
 		void SetOriginResponseTimeMSec(double value);
 
+		// Average time that the outgoing packets wait in the pacers of the sessions
+		double GetPacingQueueDelayMSec();
+		void UpdatePacingQueueDelayMSec(double value);
+
+		// Histogram of the DTLS handshake latency of the sessions
+		void OnDtlsHandshakeCompleted(int64_t latency_msec, bool is_resumed);
+		std::vector<uint64_t> GetDtlsHandshakeLatencyHistogram();
+		uint64_t GetDtlsHandshakeCount();
+		uint64_t GetDtlsResumedHandshakeCount();
+
+		// The packets of the stream that the queues of the pipeline have dropped by the backpressure limits
+		void OnQueuePacketDropped(uint64_t bytes);
+		uint64_t GetQueueDroppedPacketCount();
+		uint64_t GetQueueDroppedBytes();
+
+		// The worst sessions of each stream worker of the publishers (See pub::StreamWorker), replaced by each report of the worker
+		// (an empty list removes the reports of the worker)
+		void UpdateWorstSessions(const void *worker, std::vector<SessionStatsSnapshot> sessions);
+		// The worst sessions of the stream (the worst first)
+		std::vector<SessionStatsSnapshot> GetWorstSessions(size_t count = WORST_SESSION_COUNT);
+		// The sessions that have been disconnected because they fell behind
+		void OnSlowSessionDisconnected();
+		uint64_t GetSlowSessionDisconnectedCount();
+
 		// Overriding from CommonMetrics 
 		void IncreaseBytesIn(uint64_t value) override;
 		void IncreaseBytesOut(PublisherType type, uint64_t value) override;
 		void OnSessionConnected(PublisherType type) override;
 		void OnSessionDisconnected(PublisherType type) override;
 	private:
+		// The metrics of the origin stream if this is a child (transcoded) stream, nullptr if not
+		// (it is looked up once and cached, so the counters are forwarded without the lookup per packet)
+		StreamMetrics *GetOriginStreamMetrics();
+
 		// Related to origin, From Provider
 		std::atomic<double> _request_time_to_origin_msec;
 		std::atomic<double> _response_time_from_origin_msec;
 
+		// From Publisher (smoothed over the sessions)
+		std::atomic<double> _pacing_queue_delay_msec;
+
+		std::atomic<uint64_t> _dtls_handshake_latency_histogram[DTLS_HANDSHAKE_LATENCY_BUCKET_COUNT] = {};
+		std::atomic<uint64_t> _dtls_resumed_handshake_count{0};
+
+		std::atomic<uint64_t> _queue_dropped_packet_count{0};
+		std::atomic<uint64_t> _queue_dropped_bytes{0};
+
+		std::mutex _worst_sessions_mutex;
+		std::map<const void *, std::vector<SessionStatsSnapshot>> _worst_sessions;
+		std::atomic<uint64_t> _slow_session_disconnected_count{0};
+
 		std::shared_ptr<ApplicationMetrics>	_app_metrics;
+
+		std::mutex _origin_stream_metrics_mutex;
+		// Keeps _origin_stream_metrics alive
+		std::shared_ptr<StreamMetrics> _origin_stream_metrics_holder;
+		std::atomic<StreamMetrics *> _origin_stream_metrics{nullptr};
+		bool _is_child_stream = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_metrics.h"
+
+#include "monitoring_private.h"
+
+namespace mon
+{
+	ov::String TranscodeMetrics::GetInfoString()
+	{
+		ov::String out_str;
+
+		auto budget_to_string = [](int64_t budget) -> ov::String {
+			return (budget > 0) ? ov::String::FormatString("%.1f Mpx/s", budget / 1000000.0) : ov::String("unlimited");
+		};
+
+		out_str.AppendFormat(
+			"\n\t>> Transcode budget\n"
+			"\tCPU : %.1f Mpx/s / %s, GPU : %.1f Mpx/s / %s\n"
+			"\tAdmitted streams : %llu, Downgraded streams : %llu, Rejected streams : %llu, Queued streams : %u\n"
+			"\tDegraded streams : %u (skip non-reference), %u (halve frame rate), %u (skip to key frame)\n",
+			GetCPUUsage() / 1000000.0, budget_to_string(GetCPUBudget()).CStr(),
+			GetGPUUsage() / 1000000.0, budget_to_string(GetGPUBudget()).CStr(),
+			static_cast<unsigned long long>(GetAdmittedStreamCount()),
+			static_cast<unsigned long long>(GetDowngradedStreamCount()),
+			static_cast<unsigned long long>(GetRejectedStreamCount()),
+			GetQueuedStreamCount(),
+			GetDegradedStreamCount(1), GetDegradedStreamCount(2), GetDegradedStreamCount(3));
+
+		return out_str;
+	}
+
+	void TranscodeMetrics::ShowInfo()
+	{
+		logti("%s", GetInfoString().CStr());
+	}
+
+	void TranscodeMetrics::SetBudget(int64_t cpu_budget, int64_t gpu_budget)
+	{
+		_cpu_budget = cpu_budget;
+		_gpu_budget = gpu_budget;
+	}
+
+	int64_t TranscodeMetrics::GetCPUBudget() const
+	{
+		return _cpu_budget;
+	}
+
+	int64_t TranscodeMetrics::GetGPUBudget() const
+	{
+		return _gpu_budget;
+	}
+
+	void TranscodeMetrics::SetUsage(int64_t cpu_usage, int64_t gpu_usage)
+	{
+		_cpu_usage = cpu_usage;
+		_gpu_usage = gpu_usage;
+	}
+
+	int64_t TranscodeMetrics::GetCPUUsage() const
+	{
+		return _cpu_usage;
+	}
+
+	int64_t TranscodeMetrics::GetGPUUsage() const
+	{
+		return _gpu_usage;
+	}
+
+	void TranscodeMetrics::SetQueuedStreamCount(uint32_t count)
+	{
+		_queued_stream_count = count;
+	}
+
+	uint32_t TranscodeMetrics::GetQueuedStreamCount() const
+	{
+		return _queued_stream_count;
+	}
+
+	void TranscodeMetrics::OnStreamAdmitted()
+	{
+		_admitted_stream_count++;
+	}
+
+	void TranscodeMetrics::OnStreamDowngraded()
+	{
+		_downgraded_stream_count++;
+	}
+
+	void TranscodeMetrics::OnStreamRejected()
+	{
+		_rejected_stream_count++;
+	}
+
+	uint64_t TranscodeMetrics::GetAdmittedStreamCount() const
+	{
+		return _admitted_stream_count;
+	}
+
+	uint64_t TranscodeMetrics::GetDowngradedStreamCount() const
+	{
+		return _downgraded_stream_count;
+	}
+
+	uint64_t TranscodeMetrics::GetRejectedStreamCount() const
+	{
+		return _rejected_stream_count;
+	}
+
+	void TranscodeMetrics::OnDegradeLevelChanged(int32_t old_level, int32_t new_level, bool is_step)
+	{
+		if ((old_level < 0) || (old_level > MaxDegradeLevel) || (new_level < 0) || (new_level > MaxDegradeLevel))
+		{
+			return;
+		}
+
+		if (old_level > 0)
+		{
+			_degraded_stream_counts[old_level]--;
+		}
+
+		if (new_level > 0)
+		{
+			_degraded_stream_counts[new_level]++;
+		}
+
+		if (is_step)
+		{
+			_degrade_step_counts[new_level]++;
+		}
+	}
+
+	uint32_t TranscodeMetrics::GetDegradedStreamCount(int32_t level) const
+	{
+		return ((level > 0) && (level <= MaxDegradeLevel)) ? _degraded_stream_counts[level].load() : 0;
+	}
+
+	uint64_t TranscodeMetrics::GetDegradeStepCount(int32_t level) const
+	{
+		return ((level > 0) && (level <= MaxDegradeLevel)) ? _degrade_step_counts[level].load() : 0;
+	}
+
+	ov::String TranscodeMetrics::ToPrometheusText()
+	{
+		ov::String text;
+
+		text.Append("# HELP ome_transcode_degraded_streams The transcode streams at the degrade level (1: skip non-reference frames, 2: halve the frame rate of the lower renditions, 3: skip to the next key frame)\n");
+		text.Append("# TYPE ome_transcode_degraded_streams gauge\n");
+
+		for (int32_t level = 1; level <= MaxDegradeLevel; level++)
+		{
+			text.AppendFormat("ome_transcode_degraded_streams{level=\"%d\"} %u\n", level, GetDegradedStreamCount(level));
+		}
+
+		text.Append("# HELP ome_transcode_degrade_steps_total The number of times the transcode streams are degraded to the level\n");
+		text.Append("# TYPE ome_transcode_degrade_steps_total counter\n");
+
+		for (int32_t level = 1; level <= MaxDegradeLevel; level++)
+		{
+			text.AppendFormat("ome_transcode_degrade_steps_total{level=\"%d\"} %llu\n", level, static_cast<unsigned long long>(GetDegradeStepCount(level)));
+		}
+
+		return text;
+	}
+}  // namespace mon
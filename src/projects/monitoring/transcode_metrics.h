@@ -0,0 +1,75 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "base/common_types.h"
+
+namespace mon
+{
+	// The encoding budget of the transcoder (Updated by TranscodeScheduler), and the degraded transcode streams (Updated by TranscodeDegradeLadder)
+	class TranscodeMetrics
+	{
+	public:
+		ov::String GetInfoString();
+		void ShowInfo();
+
+		// Budget (pixels per second, 0 = unlimited)
+		void SetBudget(int64_t cpu_budget, int64_t gpu_budget);
+		int64_t GetCPUBudget() const;
+		int64_t GetGPUBudget() const;
+
+		// Pixels per second of the encoders of the admitted streams
+		void SetUsage(int64_t cpu_usage, int64_t gpu_usage);
+		int64_t GetCPUUsage() const;
+		int64_t GetGPUUsage() const;
+
+		void SetQueuedStreamCount(uint32_t count);
+		uint32_t GetQueuedStreamCount() const;
+
+		void OnStreamAdmitted();
+		void OnStreamDowngraded();
+		void OnStreamRejected();
+
+		uint64_t GetAdmittedStreamCount() const;
+		uint64_t GetDowngradedStreamCount() const;
+		uint64_t GetRejectedStreamCount() const;
+
+		// level: 0 = not degraded ~ MaxDegradeLevel (See TranscodeDegradeLevel)
+		// is_step: whether the stream is degraded one more step (not restored)
+		void OnDegradeLevelChanged(int32_t old_level, int32_t new_level, bool is_step);
+		// The number of the streams currently at the level
+		uint32_t GetDegradedStreamCount(int32_t level) const;
+		// The number of times the streams are degraded to the level
+		uint64_t GetDegradeStepCount(int32_t level) const;
+
+		// The gauges/counters in the Prometheus text exposition format (version 0.0.4)
+		ov::String ToPrometheusText();
+
+		static constexpr int32_t MaxDegradeLevel = 3;
+
+	private:
+		std::atomic<int64_t> _cpu_budget{0};
+		std::atomic<int64_t> _gpu_budget{0};
+		std::atomic<int64_t> _cpu_usage{0};
+		std::atomic<int64_t> _gpu_usage{0};
+
+		std::atomic<uint32_t> _queued_stream_count{0};
+
+		// Total counts since the server started
+		std::atomic<uint64_t> _admitted_stream_count{0};
+		std::atomic<uint64_t> _downgraded_stream_count{0};
+		std::atomic<uint64_t> _rejected_stream_count{0};
+
+		std::array<std::atomic<uint32_t>, MaxDegradeLevel + 1> _degraded_stream_counts{};
+		std::array<std::atomic<uint64_t>, MaxDegradeLevel + 1> _degrade_step_counts{};
+	};
+}  // namespace mon
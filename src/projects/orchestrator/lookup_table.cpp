@@ -0,0 +1,278 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "lookup_table.h"
+
+#include "orchestrator_private.h"
+
+// The maximum number of the domain names whose result is cached
+#define DOMAIN_LOOKUP_CACHE_SIZE 4096
+
+DomainPattern::DomainPattern(const ov::String &pattern)
+	: _pattern(pattern)
+{
+	auto buffer = pattern.CStr();
+	auto length = pattern.GetLength();
+
+	_tokens.reserve(length);
+
+	for (size_t index = 0; index < length; index++)
+	{
+		switch (buffer[index])
+		{
+			case '*':
+				// "**" is the same as "*"
+				if (_tokens.empty() || (_tokens.back().type != TokenType::AnySequence))
+				{
+					_tokens.push_back({TokenType::AnySequence, '\0'});
+				}
+				_has_wildcard = true;
+				break;
+
+			case '?':
+				_tokens.push_back({TokenType::OptionalCharacter, '\0'});
+				_has_wildcard = true;
+				break;
+
+			default:
+				_tokens.push_back({TokenType::Character, buffer[index]});
+				break;
+		}
+	}
+}
+
+bool DomainPattern::IsMatched(const ov::String &domain_name) const
+{
+	auto buffer = domain_name.CStr();
+	auto length = domain_name.GetLength();
+
+	// The set of the positions of domain_name that can be reached after the tokens processed so far
+	// (simulation of the NFA, so the time is O(tokens * length) without backtracking)
+	std::vector<bool> positions(length + 1, false);
+	std::vector<bool> next_positions(length + 1, false);
+	positions[0] = true;
+
+	for (const auto &token : _tokens)
+	{
+		bool is_reachable = false;
+
+		std::fill(next_positions.begin(), next_positions.end(), false);
+
+		switch (token.type)
+		{
+			case TokenType::Character:
+				for (size_t position = 0; position < length; position++)
+				{
+					if (positions[position] && (buffer[position] == token.character))
+					{
+						next_positions[position + 1] = true;
+						is_reachable = true;
+					}
+				}
+				break;
+
+			case TokenType::AnySequence:
+				// All positions after the first reachable position
+				for (size_t position = 0; position <= length; position++)
+				{
+					is_reachable = is_reachable || positions[position];
+					next_positions[position] = is_reachable;
+				}
+				break;
+
+			case TokenType::OptionalCharacter:
+				for (size_t position = 0; position <= length; position++)
+				{
+					if (positions[position])
+					{
+						next_positions[position] = true;
+
+						if (position < length)
+						{
+							next_positions[position + 1] = true;
+						}
+
+						is_reachable = true;
+					}
+				}
+				break;
+		}
+
+		if (is_reachable == false)
+		{
+			return false;
+		}
+
+		positions.swap(next_positions);
+	}
+
+	return positions[length];
+}
+
+void DomainLookupTable::AddPattern(const ov::String &pattern, const ov::String &vhost_name)
+{
+	auto index = _entries.size();
+
+	_entries.emplace_back(pattern, vhost_name);
+
+	if (_entries.back().pattern.HasWildcard())
+	{
+		_wildcard_list.push_back(index);
+	}
+	else
+	{
+		// The first one has the priority
+		_exact_map.emplace(pattern.CStr(), index);
+	}
+}
+
+ov::String DomainLookupTable::Lookup(const ov::String &domain_name) const
+{
+	std::string key = domain_name.CStr();
+
+	{
+		std::shared_lock<std::shared_mutex> lock(_result_cache_mutex);
+
+		auto item = _result_cache.find(key);
+
+		if (item != _result_cache.end())
+		{
+			return item->second;
+		}
+	}
+
+	auto vhost_name = LookupInternal(domain_name);
+
+	{
+		std::unique_lock<std::shared_mutex> lock(_result_cache_mutex);
+
+		if (_result_cache.size() >= DOMAIN_LOOKUP_CACHE_SIZE)
+		{
+			logtd("The domain lookup cache is full, clearing...");
+			_result_cache.clear();
+		}
+
+		_result_cache.emplace(std::move(key), vhost_name);
+	}
+
+	return vhost_name;
+}
+
+ov::String DomainLookupTable::LookupInternal(const ov::String &domain_name) const
+{
+	size_t matched_index = _entries.size();
+
+	auto exact_item = _exact_map.find(domain_name.CStr());
+
+	if (exact_item != _exact_map.end())
+	{
+		matched_index = exact_item->second;
+	}
+
+	// Only the wildcard patterns that have a higher priority than the exact match need to be tested
+	for (auto index : _wildcard_list)
+	{
+		if (index >= matched_index)
+		{
+			break;
+		}
+
+		if (_entries[index].pattern.IsMatched(domain_name))
+		{
+			matched_index = index;
+			break;
+		}
+	}
+
+	if (matched_index < _entries.size())
+	{
+		return _entries[matched_index].vhost_name;
+	}
+
+	return "";
+}
+
+LocationTrie::LocationTrie()
+{
+	Clear();
+}
+
+void LocationTrie::Clear()
+{
+	_nodes.clear();
+	_nodes.emplace_back();
+}
+
+void LocationTrie::AddLocation(const ov::String &location, size_t index)
+{
+	size_t node_index = 0;
+
+	for (size_t position = 0; position < location.GetLength(); position++)
+	{
+		auto character = location.Get(position);
+		auto &children = _nodes[node_index].children;
+		auto child = children.find(character);
+
+		if (child == children.end())
+		{
+			auto child_index = _nodes.size();
+
+			// The reference of children is invalidated by emplace_back()
+			_nodes[node_index].children[character] = child_index;
+			_nodes.emplace_back();
+
+			node_index = child_index;
+		}
+		else
+		{
+			node_index = child->second;
+		}
+	}
+
+	auto &node = _nodes[node_index];
+
+	// If the same location is added twice, the first one has the priority
+	if (node.has_index == false)
+	{
+		node.has_index = true;
+		node.index = index;
+	}
+}
+
+bool LocationTrie::Lookup(const ov::String &location, size_t *index) const
+{
+	size_t node_index = 0;
+	bool found = false;
+
+	// All nodes on the path are the prefixes of the location, and the one that was added first is used
+	for (size_t position = 0;; position++)
+	{
+		auto &node = _nodes[node_index];
+
+		if (node.has_index && ((found == false) || (node.index < *index)))
+		{
+			*index = node.index;
+			found = true;
+		}
+
+		if (position >= location.GetLength())
+		{
+			break;
+		}
+
+		auto child = node.children.find(location.Get(position));
+
+		if (child == node.children.end())
+		{
+			break;
+		}
+
+		node_index = child->second;
+	}
+
+	return found;
+}
@@ -0,0 +1,126 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// A domain name pattern of <Domain><Names>, which is compiled once
+//
+// "*" matches any sequence of characters (including an empty sequence), and "?" matches zero or one character
+// (the same as ".*"/".?" of the regex that was used before)
+class DomainPattern
+{
+public:
+	explicit DomainPattern(const ov::String &pattern);
+
+	bool HasWildcard() const
+	{
+		return _has_wildcard;
+	}
+
+	const ov::String &GetPattern() const
+	{
+		return _pattern;
+	}
+
+	bool IsMatched(const ov::String &domain_name) const;
+
+private:
+	enum class TokenType : uint8_t
+	{
+		Character,
+		// "*"
+		AnySequence,
+		// "?"
+		OptionalCharacter
+	};
+
+	struct Token
+	{
+		TokenType type;
+		char character;
+	};
+
+	ov::String _pattern;
+	std::vector<Token> _tokens;
+	bool _has_wildcard = false;
+};
+
+// Finds the VirtualHost of a domain name
+//
+// The first pattern (in the order of the VirtualHosts and their domains) that matches the domain name is used.
+// The names without a wildcard are found with a hash table, and only the wildcard patterns before it are tested.
+// The results are cached until the table is replaced (See Orchestrator::ApplyOriginMap())
+class DomainLookupTable
+{
+public:
+	// Patterns must be added in the order of priority
+	void AddPattern(const ov::String &pattern, const ov::String &vhost_name);
+
+	// Returns an empty string if not found
+	ov::String Lookup(const ov::String &domain_name) const;
+
+private:
+	struct Entry
+	{
+		Entry(const ov::String &pattern, const ov::String &vhost_name)
+			: pattern(pattern),
+			  vhost_name(vhost_name)
+		{
+		}
+
+		DomainPattern pattern;
+		ov::String vhost_name;
+	};
+
+	ov::String LookupInternal(const ov::String &domain_name) const;
+
+	std::vector<Entry> _entries;
+
+	// key: the pattern without a wildcard, value: the index of _entries
+	std::unordered_map<std::string, size_t> _exact_map;
+	// The indices of the patterns that have a wildcard (ascending order)
+	std::vector<size_t> _wildcard_list;
+
+	// Host headers are given by the clients, so the number of the cached results is limited
+	mutable std::unordered_map<std::string, ov::String> _result_cache;
+	mutable std::shared_mutex _result_cache_mutex;
+};
+
+// Finds the <Origin> of a location (/<app>/<stream>) with a prefix tree of the <Location>s
+//
+// Like the linear search that was used before, the first origin (in the order of the list) whose location is a prefix of the location is used
+class LocationTrie
+{
+public:
+	LocationTrie();
+
+	void Clear();
+
+	// Locations must be added in the order of priority, index is returned by Lookup()
+	void AddLocation(const ov::String &location, size_t index);
+
+	// Returns false if not found
+	bool Lookup(const ov::String &location, size_t *index) const;
+
+private:
+	struct Node
+	{
+		std::unordered_map<char, size_t> children;
+
+		bool has_index = false;
+		size_t index = 0;
+	};
+
+	// _nodes[0] is the root
+	std::vector<Node> _nodes;
+};
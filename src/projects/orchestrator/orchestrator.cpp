@@ -15,6 +15,9 @@
 
 #include "orchestrator_private.h"
 
+// The result of the pull request is reused for this time (to absorb the burst of the requests of the same stream)
+#define ORCHESTRATOR_PULL_STREAM_RESULT_TTL_MS 1000
+
 bool Orchestrator::ApplyForVirtualHost(const std::shared_ptr<VirtualHost> &virtual_host)
 {
 	auto succeeded = true;
@@ -275,11 +278,114 @@ bool Orchestrator::ApplyOriginMap(const std::vector<info::Host> &host_list)
 		}
 	}
 
+	UpdateLookupTables();
+
 	logtd("All items are applied");
 
 	return result;
 }
 
+bool Orchestrator::ApplyApplications(const std::vector<info::Host> &host_list)
+{
+	auto scoped_lock = std::scoped_lock(_module_list_mutex, _virtual_host_map_mutex);
+	bool result = true;
+
+	for (auto &host_info : host_list)
+	{
+		auto vhost = GetVirtualHost(host_info.GetName());
+
+		if (vhost == nullptr)
+		{
+			logte("Could not find VirtualHost to apply the applications: %s", host_info.GetName().CStr());
+			result = false;
+			continue;
+		}
+
+		// info::Host issues a new ID whenever it is created, so the host that is created first is used to keep the ID of the metrics
+		mon::Monitoring::GetInstance()->OnHostCreated(vhost->host_info);
+
+		// key: the name of the application, value: the serialized configuration
+		std::map<ov::String, ov::String> app_config_map;
+
+		for (auto &app_config : host_info.GetApplicationList())
+		{
+			app_config_map[ResolveApplicationName(host_info.GetName(), app_config.GetName())] = app_config.ToString();
+		}
+
+		// Delete the applications that are removed or changed (app_map is modified while deleting, so it is iterated over a copy)
+		auto app_map = vhost->app_map;
+
+		for (auto &app_item : app_map)
+		{
+			auto &app_info = app_item.second->app_info;
+			auto app_config = app_config_map.find(app_info.GetName());
+
+			if (app_config == app_config_map.end())
+			{
+				if (app_info.IsDynamicApp())
+				{
+					// Created by a pull request, not by the configuration
+					continue;
+				}
+
+				logti("Application is removed from the configuration: %s", app_info.GetName().CStr());
+			}
+			else if (app_info.IsDynamicApp() || (app_info.GetConfig().ToString() != app_config->second))
+			{
+				logti("Application is changed, trying to restart: %s", app_info.GetName().CStr());
+			}
+			else
+			{
+				// Not changed
+				continue;
+			}
+
+			if (DeleteApplicationInternal(app_info) != Result::Succeeded)
+			{
+				logte("Could not delete application: %s", app_info.GetName().CStr());
+				result = false;
+			}
+		}
+
+		// Create the applications that are new or changed (CreateApplicationInternal() returns Exists for the others)
+		for (auto &app_config : host_info.GetApplicationList())
+		{
+			info::Application app_info(vhost->host_info, GetNextAppId(), ResolveApplicationName(host_info.GetName(), app_config.GetName()), app_config, false);
+
+			if (CreateApplicationInternal(host_info.GetName(), app_info) == Result::Failed)
+			{
+				logte("Could not create application: %s", app_info.GetName().CStr());
+				result = false;
+			}
+		}
+	}
+
+	return result;
+}
+
+void Orchestrator::UpdateLookupTables()
+{
+	auto domain_lookup_table = std::make_shared<DomainLookupTable>();
+
+	// CAUTION: This code is important to order, so don't use _virtual_host_map
+	for (auto &vhost : _virtual_host_list)
+	{
+		for (auto &domain : vhost->domain_list)
+		{
+			domain_lookup_table->AddPattern(domain.name, vhost->name);
+		}
+
+		vhost->location_trie.Clear();
+
+		for (size_t index = 0; index < vhost->origin_list.size(); index++)
+		{
+			vhost->location_trie.AddLocation(vhost->origin_list[index].location, index);
+		}
+	}
+
+	std::atomic_store(&_domain_lookup_table, std::shared_ptr<const DomainLookupTable>(domain_lookup_table));
+}
+
 const std::vector<std::shared_ptr<Orchestrator::VirtualHost>> &Orchestrator::GetVirtualHostList()
 {
 	return _virtual_host_list;
@@ -400,6 +506,11 @@ Orchestrator::ItemState Orchestrator::ProcessOriginList(std::vector<Origin> *ori
 						origin.state = (is_equal == false) ? ItemState::Changed : ItemState::NotChanged;
 					}
 
+					// <Balance> is applied to the next pull, so the streams don't need to be recreated
+					origin.balance = Origin::ParseBalance(origin_config.GetBalance());
+					// <Prewarm>/<Directory> are applied when the OVT provider checks them again (See GetSubscribedOriginList())
+					origin.UpdateSubscription(origin_config);
+
 					if (origin.state == ItemState::Changed)
 					{
 						is_changed = true;
@@ -533,24 +644,13 @@ bool Orchestrator::UnregisterModule(const std::shared_ptr<OrchestratorModuleInte
 
 ov::String Orchestrator::GetVhostNameFromDomain(const ov::String &domain_name)
 {
-	// TODO(dimiden): I think it would be nice to create a VHost cache for performance
-
 	if (domain_name.IsEmpty() == false)
 	{
-		auto scoped_lock = std::scoped_lock(_virtual_host_map_mutex);
+		auto domain_lookup_table = std::atomic_load(&_domain_lookup_table);
 
-		// Search for the domain corresponding to domain_name
-
-		// CAUTION: This code is important to order, so don't use _virtual_host_map
-		for (auto &vhost_item : _virtual_host_list)
+		if (domain_lookup_table != nullptr)
 		{
-			for (auto &domain_item : vhost_item->domain_list)
-			{
-				if (std::regex_match(domain_name.CStr(), domain_item.regex_for_domain))
-				{
-					return vhost_item->name;
-				}
-			}
+			return domain_lookup_table->Lookup(domain_name);
 		}
 	}
 
@@ -608,6 +708,10 @@ std::shared_ptr<pvd::Provider> Orchestrator::GetProviderForScheme(const ov::Stri
 	{
 		type = ProviderType::Ovt;
 	}
+	else if (lower_scheme == "replay")
+	{
+		type = ProviderType::Replay;
+	}
 	else
 	{
 		logte("Could not find a provider for scheme [%s]", scheme.CStr());
@@ -770,70 +874,145 @@ bool Orchestrator::GetUrlListForLocationInternal(const ov::String &vhost_app_nam
 	ov::String location = ov::String::FormatString("/%s/%s", real_app_name.CStr(), stream_name.CStr());
 
 	// Find the origin using the location
-	for (auto &domain : domain_list)
+	size_t origin_index = 0;
+
+	// The origin is used only if the VirtualHost has a domain
+	if (domain_list.empty() || (vhost->location_trie.Lookup(location, &origin_index) == false) || (origin_index >= origin_list.size()))
+	{
+		logtd("Could not find the item that match location: %s", location.CStr());
+		return false;
+	}
+
+	auto &domain = domain_list[0];
+	auto &origin = origin_list[origin_index];
+
+	// If the location has the prefix that configured in <Origins>, extract the remaining part
+	// For example, if the settings is:
+	//      <Origin>
+	//      	<Location>/app/stream</Location>
+	//      	<Pass>
+	//              <Scheme>ovt</Scheme>
+	//              <Urls>
+	//      		    <Url>origin.airensoft.com:9000/another_app/and_stream</Url>
+	//              </Urls>
+	//      	</Pass>
+	//      </Origin>
+	// And when the location is "/app/stream_o",
+	//
+	// <Location>: /app/stream
+	// location:   /app/stream_o
+	//                        ~~ <= remaining part
+	auto remaining_part = location.Substring(origin.location.GetLength());
+
+	logtd("Found: location: %s (app: %s, stream: %s), remaining_part: %s", origin.location.CStr(), real_app_name.CStr(), stream_name.CStr(), remaining_part.CStr());
+
+	for (auto url : origin.url_list)
+	{
+		// Append the remaining_part to the URL
+
+		// For example,
+		//    url:     ovt://origin.airensoft.com:9000/another_app/and_stream
+		//    new_url: ovt://origin.airensoft.com:9000/another_app/and_stream_o
+		//                                                                   ~~ <= remaining part
+
+		// Prepend "<scheme>://"
+		url.Prepend("://");
+		url.Prepend(origin.scheme);
+
+		// Append remaining_part
+		url.Append(remaining_part);
+
+		url_list->push_back(url);
+	}
+
+	if (used_domain != nullptr)
+	{
+		*used_domain = &domain;
+	}
+
+	if (used_origin != nullptr)
+	{
+		*used_origin = &origin;
+	}
+
+	return (url_list->size() > 0) ? true : false;
+}
+
+std::vector<Orchestrator::SubscribedOrigin> Orchestrator::GetSubscribedOriginList() const
+{
+	std::vector<SubscribedOrigin> subscribed_origin_list;
+
+	auto scoped_lock = std::scoped_lock(_virtual_host_map_mutex);
+
+	for (auto &vhost : _virtual_host_list)
 	{
-		for (auto &origin : origin_list)
+		// The origin is used only if the VirtualHost has a domain (See GetUrlListForLocationInternal())
+		if (vhost->domain_list.empty())
 		{
-			logtd("Trying to find the item that match location: %s", location.CStr());
+			continue;
+		}
 
-			// TODO(dimien): Replace with the regex
-			if (location.HasPrefix(origin.location))
+		for (auto &origin : vhost->origin_list)
+		{
+			if (((origin.is_prewarm_enabled == false) && (origin.is_directory_enabled == false)) || (origin.scheme.LowerCaseString() != "ovt"))
 			{
-				// If the location has the prefix that configured in <Origins>, extract the remaining part
-				// For example, if the settings is:
-				//      <Origin>
-				//      	<Location>/app/stream</Location>
-				//      	<Pass>
-				//              <Scheme>ovt</Scheme>
-				//              <Urls>
-				//      		    <Url>origin.airensoft.com:9000/another_app/and_stream</Url>
-				//              </Urls>
-				//      	</Pass>
-				//      </Origin>
-				// And when the location is "/app/stream_o",
-				//
-				// <Location>: /app/stream
-				// location:   /app/stream_o
-				//                        ~~ <= remaining part
-				auto remaining_part = location.Substring(origin.location.GetLength());
-
-				logtd("Found: location: %s (app: %s, stream: %s), remaining_part: %s", origin.location.CStr(), real_app_name.CStr(), stream_name.CStr(), remaining_part.CStr());
-
-				for (auto url : origin.url_list)
-				{
-					// Append the remaining_part to the URL
+				continue;
+			}
+
+			// <Location> must be /<app> (or /<app>/)
+			auto location = origin.location;
 
-					// For example,
-					//    url:     ovt://origin.airensoft.com:9000/another_app/and_stream
-					//    new_url: ovt://origin.airensoft.com:9000/another_app/and_stream_o
-					//                                                                   ~~ <= remaining part
+			if (location.HasSuffix("/"))
+			{
+				location = location.Left(location.GetLength() - 1);
+			}
 
-					// Prepend "<scheme>://"
-					url.Prepend("://");
-					url.Prepend(origin.scheme);
+			if ((location.HasPrefix("/") == false) || (location.GetLength() < 2) || (location.IndexOf('/', 1) >= 0))
+			{
+				logtd("<Prewarm>/<Directory> is ignored, <Location> must be an application: %s", origin.location.CStr());
+				continue;
+			}
 
-					// Append remaining_part
-					url.Append(remaining_part);
+			SubscribedOrigin subscribed_origin;
 
-					url_list->push_back(url);
-				}
+			subscribed_origin.vhost_app_name = ResolveApplicationName(vhost->name, location.Substring(1));
+			subscribed_origin.stream_name_list = origin.prewarm_stream_name_list;
+			subscribed_origin.is_prewarm_enabled = origin.is_prewarm_enabled;
+			subscribed_origin.is_directory_enabled = origin.is_directory_enabled;
 
-				if (used_domain != nullptr)
+			for (auto url : origin.url_list)
+			{
+				// Prepend "<scheme>://"
+				url.Prepend("://");
+				url.Prepend(origin.scheme);
+
+				auto parsed_url = ov::Url::Parse(url.CStr());
+
+				if ((parsed_url == nullptr) || parsed_url->App().IsEmpty() || (parsed_url->Stream().IsEmpty() == false))
 				{
-					*used_domain = &domain;
+					logtd("<Prewarm>/<Directory> is ignored for the URL, it must be ovt://<host>:<port>/<app>: %s", url.CStr());
+					continue;
 				}
 
-				if (used_origin != nullptr)
+				if (origin.is_directory_enabled)
 				{
-					*used_origin = &origin;
+					auto subscribed_url_origin = subscribed_origin;
+					subscribed_url_origin.url_list.push_back(url);
+					subscribed_origin_list.push_back(subscribed_url_origin);
+					continue;
 				}
 
-				return (url_list->size() > 0) ? true : false;
+				subscribed_origin.url_list.push_back(url);
+			}
+
+			if (subscribed_origin.url_list.empty() == false)
+			{
+				subscribed_origin_list.push_back(subscribed_origin);
 			}
 		}
 	}
 
-	return false;
+	return subscribed_origin_list;
 }
 
 Orchestrator::Result Orchestrator::CreateApplicationInternal(const ov::String &vhost_name, const info::Application &app_info)
@@ -1109,8 +1288,131 @@ const info::Application &Orchestrator::GetApplicationInfoByVHostAppName(const ov
 	return GetApplicationInfoInternal(vhost_app_name);
 }
 
-bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset)
+// Records the time from the pull request to the creation of the stream
+static void SetPullLatency(const std::shared_ptr<pvd::Stream> &stream, const std::chrono::steady_clock::time_point &begin)
+{
+	auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(stream));
+
+	if (stream_metrics != nullptr)
+	{
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+		stream_metrics->SetOriginRequestTimeMSec(elapsed.count());
+	}
+}
+
+std::shared_future<bool> Orchestrator::RequestPullStreamOnce(const ov::String &key, const std::function<bool()> &pull_function, const PullStreamCallback &callback)
 {
+	std::shared_ptr<PullStreamRequest> request;
+	bool is_owner = false;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_pull_stream_request_mutex);
+
+		auto now = std::chrono::steady_clock::now();
+
+		// Remove the expired results
+		for (auto item = _pull_stream_requests.begin(); item != _pull_stream_requests.end();)
+		{
+			auto &old_request = item->second;
+			std::lock_guard<std::mutex> request_lock_guard(old_request->mutex);
+
+			if (old_request->is_completed &&
+				((now - old_request->completed_time) >= std::chrono::milliseconds(ORCHESTRATOR_PULL_STREAM_RESULT_TTL_MS)))
+			{
+				item = _pull_stream_requests.erase(item);
+			}
+			else
+			{
+				++item;
+			}
+		}
+
+		auto &item = _pull_stream_requests[key];
+
+		if (item == nullptr)
+		{
+			item = std::make_shared<PullStreamRequest>();
+			item->future = item->promise.get_future().share();
+			is_owner = true;
+		}
+
+		request = item;
+	}
+
+	if (callback != nullptr)
+	{
+		std::unique_lock<std::mutex> lock(request->mutex);
+
+		if (request->is_completed == false)
+		{
+			request->callbacks.push_back(callback);
+		}
+		else
+		{
+			lock.unlock();
+			callback(request->future.get());
+		}
+	}
+
+	if (is_owner == false)
+	{
+		logtd("Joined the pull request in progress: %s", key.CStr());
+		return request->future;
+	}
+
+	// Pulling a stream may take a long time (connecting to the origin, ...),
+	// so it is done in a new thread to not block the thread of the requester (signalling, HTTP, ...)
+	std::thread([key, request, pull_function]() {
+		ov::String overload_reason;
+		bool result = false;
+
+		// A new pull would add the ingest/transcoding load, so it is rejected while the server is overloaded
+		if (MonitorInstance->GetResourceMetrics().IsOverloaded(&overload_reason))
+		{
+			logtw("Could not pull the stream: %s (overloaded: %s)", key.CStr(), overload_reason.CStr());
+		}
+		else
+		{
+			result = pull_function();
+		}
+
+		// The promise is fulfilled first, so the callbacks registered after this can get the result immediately
+		request->promise.set_value(result);
+
+		std::vector<PullStreamCallback> callbacks;
+		{
+			std::lock_guard<std::mutex> lock_guard(request->mutex);
+
+			request->is_completed = true;
+			request->completed_time = std::chrono::steady_clock::now();
+			callbacks.swap(request->callbacks);
+		}
+
+		logtd("The pull request is completed: %s (result: %s, requesters: %zu)", key.CStr(), result ? "true" : "false", callbacks.size());
+
+		for (auto &callback : callbacks)
+		{
+			callback(result);
+		}
+	}).detach();
+
+	return request->future;
+}
+
+std::shared_future<bool> Orchestrator::RequestPullStreamAsync(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset, const PullStreamCallback &callback)
+{
+	return RequestPullStreamOnce(
+		ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()),
+		[this, vhost_app_name, stream_name, url, offset]() -> bool {
+			return RequestPullStreamInternal(vhost_app_name, stream_name, url, offset);
+		},
+		callback);
+}
+
+bool Orchestrator::RequestPullStreamInternal(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset)
+{
+	auto begin = std::chrono::steady_clock::now();
+
 	auto parsed_url = ov::Url::Parse(url.CStr());
 
 	if (parsed_url != nullptr)
@@ -1164,10 +1466,16 @@ bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov:
 			  vhost_app_name.CStr(), stream_name.CStr(),
 			  GetOrchestratorModuleTypeName(provider_module->GetModuleType()).CStr());
 
-		auto stream = provider_module->PullStream(app_info, stream_name, {source}, offset);
+		auto stream = _pull_connection_limiter.Pull(
+			ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()), {source}, _origin_health_table,
+			[&]() -> std::shared_ptr<pvd::Stream> {
+				return provider_module->PullStream(app_info, stream_name, {source}, offset);
+			});
 
 		if (stream != nullptr)
 		{
+			SetPullLatency(stream, begin);
+
 			logti("The stream was pulled successfully: [%s/%s] (%u)",
 				  vhost_app_name.CStr(), stream_name.CStr(), stream->GetId());
 
@@ -1211,8 +1519,20 @@ bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov:
 	return false;
 }
 
-bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset)
+std::shared_future<bool> Orchestrator::RequestPullStreamAsync(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset, const PullStreamCallback &callback)
+{
+	return RequestPullStreamOnce(
+		ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()),
+		[this, vhost_app_name, stream_name, offset]() -> bool {
+			return RequestPullStreamInternal(vhost_app_name, stream_name, offset);
+		},
+		callback);
+}
+
+bool Orchestrator::RequestPullStreamInternal(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset)
 {
+	auto begin = std::chrono::steady_clock::now();
+
 	std::shared_ptr<OrchestratorProviderModuleInterface> provider_module;
 	auto app_info = info::Application::GetInvalidApplication();
 	Result result = Result::Failed;
@@ -1240,6 +1560,15 @@ bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov:
 			return false;
 		}
 
+		// The provider tries the URLs in this order, and fails over to the next one when the origin is broken
+		url_list = _origin_health_table.Sort(ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()), url_list, used_origin->balance);
+
+		// The origins that have the stream are tried before the others, so the pull doesn't wait for the origins that don't have it
+		if (used_origin->is_directory_enabled && _stream_directory.Sort(vhost_app_name, stream_name, &url_list))
+		{
+			logtd("The stream directory has found the origin of [%s/%s]: %s", vhost_app_name.CStr(), stream_name.CStr(), url_list[0].CStr());
+		}
+
 		{
 			auto scoped_lock_for_module_list = std::scoped_lock(_module_list_mutex);
 			provider_module = GetProviderModuleForScheme(used_origin->scheme);
@@ -1279,10 +1608,16 @@ bool Orchestrator::RequestPullStream(const ov::String &vhost_app_name, const ov:
 		  vhost_app_name.CStr(), stream_name.CStr(),
 		  GetOrchestratorModuleTypeName(provider_module->GetModuleType()).CStr());
 
-	auto stream = provider_module->PullStream(app_info, stream_name, url_list, offset);
+	auto stream = _pull_connection_limiter.Pull(
+		ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()), url_list, _origin_health_table,
+		[&]() -> std::shared_ptr<pvd::Stream> {
+			return provider_module->PullStream(app_info, stream_name, url_list, offset);
+		});
 
 	if (stream != nullptr)
 	{
+		SetPullLatency(stream, begin);
+
 		auto stream_id = stream->GetId();
 
 		auto exists_in_origin = (used_origin->stream_map.find(stream_id) != used_origin->stream_map.end());
@@ -9,8 +9,12 @@
 #pragma once
 
 #include "data_structure.h"
+#include "lookup_table.h"
+#include "origin_health.h"
+#include "pull_connection_limiter.h"
+#include "stream_directory.h"
 #include "base/info/host.h"
-#include <regex>
+#include <future>
 
 #include <base/media_route/media_route_application_observer.h>
 #include <base/provider/provider.h>
@@ -105,6 +109,7 @@ public:
 		Origin(const cfg::OriginsOrigin &origin_config)
 			: scheme(origin_config.GetPass().GetScheme()),
 			  location(origin_config.GetLocation()),
+			  balance(ParseBalance(origin_config.GetBalance())),
 			  state(ItemState::New)
 
 		{
@@ -119,14 +124,47 @@ public:
 				url_list.push_back(item.GetUrl());
 			}
 
+			UpdateSubscription(origin_config);
+
 			this->origin_config = origin_config;
 		}
 
+		void UpdateSubscription(const cfg::OriginsOrigin &origin_config)
+		{
+			auto &prewarm_config = origin_config.GetPrewarm();
+
+			is_directory_enabled = origin_config.IsDirectoryEnabled();
+			is_prewarm_enabled = prewarm_config.IsParsed();
+			prewarm_stream_name_list.clear();
+
+			for (auto &stream_name : prewarm_config.GetStreamNameList())
+			{
+				prewarm_stream_name_list.push_back(stream_name.GetName());
+			}
+		}
+
 		bool IsValid() const
 		{
 			return state != ItemState::Unknown;
 		}
 
+		static OriginBalance ParseBalance(const ov::String &balance)
+		{
+			auto lower_case_balance = balance.LowerCaseString();
+
+			if (lower_case_balance == "leastload")
+			{
+				return OriginBalance::LeastLoaded;
+			}
+
+			if (lower_case_balance == "hash")
+			{
+				return OriginBalance::Hash;
+			}
+
+			return OriginBalance::Order;
+		}
+
 		info::application_id_t app_id = 0U;
 
 		ov::String scheme;
@@ -135,6 +173,14 @@ public:
 		ov::String location;
 		// Generated URL list from <Origin>.<Pass>.<URL>
 		std::vector<ov::String> url_list;
+		// How url_list is ordered when a stream is pulled
+		OriginBalance balance = OriginBalance::Order;
+
+		// <Prewarm>: The streams are pulled when they are created in the origin (See GetSubscribedOriginList())
+		bool is_prewarm_enabled = false;
+		// <Directory>: The streams are pulled from the origin that has them (See StreamDirectory)
+		bool is_directory_enabled = false;
+		std::vector<ov::String> prewarm_stream_name_list;
 
 		// Original configuration
 		cfg::OriginsOrigin origin_config;
@@ -152,7 +198,6 @@ public:
 			: name(name),
 			  state(ItemState::New)
 		{
-			UpdateRegex();
 		}
 
 		bool IsValid() const
@@ -160,32 +205,8 @@ public:
 			return state != ItemState::Unknown;
 		}
 
-		bool UpdateRegex()
-		{
-			// Escape special characters
-			auto special_characters = std::regex(R"([[\\./+{}$^|])");
-			ov::String escaped = std::regex_replace(name.CStr(), special_characters, R"(\$&)").c_str();
-			// Change "*"/"?" to ".*"/".?"
-			escaped = escaped.Replace("*", ".*");
-			escaped = escaped.Replace("?", ".?");
-			escaped.Prepend("^");
-			escaped.Append("$");
-
-			try
-			{
-				regex_for_domain = std::regex(escaped);
-			}
-			catch (std::exception &e)
-			{
-				return false;
-			}
-
-			return true;
-		}
-
-		// The name of Domain (eg: *.airensoft.com)
+		// The name of Domain (eg: *.airensoft.com), which is compiled into the DomainLookupTable
 		ov::String name;
-		std::regex regex_for_domain;
 
 		// A list of streams generated by this domain rule
 		std::map<info::stream_id_t, std::shared_ptr<Stream>> stream_map;
@@ -309,6 +330,8 @@ public:
 
 		// Origin list
 		std::vector<Origin> origin_list;
+		// The index of origin_list by the location (rebuilt when the origin_list is changed)
+		LocationTrie location_trie;
 
 		// Application list
 		std::map<info::application_id_t, std::shared_ptr<Application>> app_map;
@@ -325,6 +348,12 @@ public:
 	}
 
 	bool ApplyOriginMap(const std::vector<info::Host> &host_list);
+	/// Compares the applications of the configuration with the applications created by the previous configuration,
+	/// and then creates the new applications, deletes the removed ones, and restarts (delete and create) the changed ones.
+	/// The other applications and their streams are not touched.
+	///
+	/// @note ApplyOriginMap() must be called first, so the VirtualHosts of host_list exist
+	bool ApplyApplications(const std::vector<info::Host> &host_list);
 
 	const std::vector<std::shared_ptr<Orchestrator::VirtualHost>>& GetVirtualHostList();
 
@@ -363,6 +392,52 @@ public:
 
 	bool GetUrlListForLocation(const ov::String &vhost_app_name, const ov::String &stream_name, std::vector<ov::String> *url_list);
 
+	// An <Origin> that has <Prewarm> or <Directory>
+	struct SubscribedOrigin
+	{
+		bool operator==(const SubscribedOrigin &other) const
+		{
+			return (vhost_app_name == other.vhost_app_name) && (url_list == other.url_list) && (stream_name_list == other.stream_name_list) &&
+				   (is_prewarm_enabled == other.is_prewarm_enabled) && (is_directory_enabled == other.is_directory_enabled);
+		}
+
+		// The application of this server that the streams are pulled into
+		ov::String vhost_app_name;
+		// ovt://<host>:<port>/<app> of the origins
+		std::vector<ov::String> url_list;
+		// The patterns of the stream names (all streams are pulled if it is empty)
+		std::vector<ov::String> stream_name_list;
+
+		bool is_prewarm_enabled = false;
+		// The streams that the origins notify are registered to the StreamDirectory
+		bool is_directory_enabled = false;
+	};
+
+	/// The <Origin>s that have <Prewarm> or <Directory>, the OVT provider subscribes to the applications of the origins
+	///
+	/// @note Only the OVT origins of which <Location> is an application (/<app>) and the URLs are ovt://<host>:<port>/<app> are returned,
+	/// because the name of a stream must be the same in the origin and this server.
+	/// An <Origin> that has <Directory> is split by the URLs, because all the origins are subscribed to (not only the first available one)
+	std::vector<SubscribedOrigin> GetSubscribedOriginList() const;
+
+	/// The health of the origins, the pull streams report the results of the connections to it
+	OriginHealthTable &GetOriginHealthTable()
+	{
+		return _origin_health_table;
+	}
+
+	/// The origins that have the streams, the OVT provider registers the streams that the origins notify
+	StreamDirectory &GetStreamDirectory()
+	{
+		return _stream_directory;
+	}
+
+	/// The pull streams connect to the origins through it (See <Performance><PullConnection>)
+	PullConnectionLimiter &GetPullConnectionLimiter()
+	{
+		return _pull_connection_limiter;
+	}
+
 	/// Create an application and notify the modules
 	///
 	/// @param vhost_name A name of VirtualHost
@@ -386,13 +461,35 @@ public:
 	const info::Application &GetApplicationInfoByName(const ov::String &vhost_name, const ov::String &app_name) const;
 	const info::Application &GetApplicationInfoByVHostAppName(const ov::String &vhost_app_name) const;
 
-	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset);
+	// Called when the pull is completed
+	using PullStreamCallback = std::function<void(bool result)>;
+
+	/// Pull a stream from the URL (or from the origin map) asynchronously
+	///
+	/// @param callback Called with the result when the pull is completed. It is called on the thread of the pull,
+	///                 or on the caller's thread if the result is already known (can be nullptr)
+	///
+	/// @return The future of the result
+	///
+	/// @note The concurrent requests of the same stream (vhost/app/stream) share one pull, and the result is reused for a short time
+	/// (When a popular stream is requested by the edge, thousands of players request it at the same time)
+	std::shared_future<bool> RequestPullStreamAsync(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset, const PullStreamCallback &callback);
+	std::shared_future<bool> RequestPullStreamAsync(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset, const PullStreamCallback &callback);
+
+	/// Pull a stream from the URL (or from the origin map), and wait for the result
+	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset)
+	{
+		return RequestPullStreamAsync(vhost_app_name, stream_name, url, offset, nullptr).get();
+	}
 	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url)
 	{
 		return RequestPullStream(vhost_app_name, stream_name, url, 0);
 	}
 
-	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset);
+	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset)
+	{
+		return RequestPullStreamAsync(vhost_app_name, stream_name, offset, nullptr).get();
+	}
 	bool RequestPullStream(const ov::String &vhost_app_name, const ov::String &stream_name)
 	{
 		return RequestPullStream(vhost_app_name, stream_name, 0);
@@ -403,6 +500,9 @@ protected:
 
 	bool ApplyForVirtualHost(const std::shared_ptr<VirtualHost> &virtual_host);
 
+	// Rebuilds the tables that are used to find VirtualHost/Origin from the domain/location
+	void UpdateLookupTables();
+
 	/// Compares a list of domains and adds them to added_domain_list if a new entry is found
 	///
 	/// @param domain_list The domain list
@@ -440,6 +540,26 @@ protected:
 	Result DeleteApplicationInternal(const ov::String &vhost_name, info::application_id_t app_id);
 	Result DeleteApplicationInternal(const info::Application &app_info);
 
+	// A pull request that is in progress (or completed recently)
+	struct PullStreamRequest
+	{
+		std::mutex mutex;
+
+		std::promise<bool> promise;
+		std::shared_future<bool> future;
+		// The callbacks of the requesters that are called when the pull is completed
+		std::vector<PullStreamCallback> callbacks;
+
+		bool is_completed = false;
+		std::chrono::steady_clock::time_point completed_time;
+	};
+
+	// Only the first request of the key calls pull_function in a new thread, and the other requests share the result
+	std::shared_future<bool> RequestPullStreamOnce(const ov::String &key, const std::function<bool()> &pull_function, const PullStreamCallback &callback);
+
+	bool RequestPullStreamInternal(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url, off_t offset);
+	bool RequestPullStreamInternal(const ov::String &vhost_app_name, const ov::String &stream_name, off_t offset);
+
 	const info::Application &GetApplicationInfoInternal(const ov::String &vhost_app_name) const;
 	const info::Application &GetApplicationInfoInternal(const ov::String &vhost_name, const ov::String &app_name) const;
 	const info::Application &GetApplicationInfoInternal(const ov::String &vhost_name, info::application_id_t app_id) const;
@@ -461,4 +581,15 @@ protected:
 	std::map<ov::String, std::shared_ptr<VirtualHost>> _virtual_host_map;
 	// ordered vhost list
 	std::vector<std::shared_ptr<VirtualHost>> _virtual_host_list;
+
+	// Replaced as a whole by UpdateLookupTables(), so it can be used without _virtual_host_map_mutex (See std::atomic_load())
+	std::shared_ptr<const DomainLookupTable> _domain_lookup_table;
+
+	OriginHealthTable _origin_health_table;
+	StreamDirectory _stream_directory;
+	PullConnectionLimiter _pull_connection_limiter;
+
+	std::mutex _pull_stream_request_mutex;
+	// key: vhost_app_name/stream_name
+	std::map<ov::String, std::shared_ptr<PullStreamRequest>> _pull_stream_requests;
 };
\ No newline at end of file
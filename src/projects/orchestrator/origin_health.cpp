@@ -0,0 +1,209 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "origin_health.h"
+
+#include <algorithm>
+
+#include "orchestrator_private.h"
+
+// The weight of the latest sample of the moving averages
+#define ORIGIN_HEALTH_SMOOTHING_FACTOR 0.2
+// The back-off after the first failure, it is doubled for each consecutive failure
+#define ORIGIN_HEALTH_MIN_BACKOFF_MSEC 1000
+#define ORIGIN_HEALTH_MAX_BACKOFF_MSEC 30000
+
+// FNV-1a, the result must be the same on all servers (unlike std::hash)
+static uint64_t HashString(const std::string &value)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (auto character : value)
+	{
+		hash ^= static_cast<uint8_t>(character);
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+std::string OriginHealthTable::GetKey(const ov::String &url)
+{
+	auto parsed_url = ov::Url::Parse(url.CStr());
+
+	if (parsed_url == nullptr)
+	{
+		return url.CStr();
+	}
+
+	return ov::String::FormatString("%s:%u", parsed_url->Domain().CStr(), parsed_url->Port()).CStr();
+}
+
+void OriginHealthTable::OnConnected(const ov::String &url, double rtt_msec)
+{
+	std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+	auto &health = _health_map[GetKey(url)];
+
+	health.rtt_msec = (health.rtt_msec == 0.0) ? rtt_msec : (health.rtt_msec * (1.0 - ORIGIN_HEALTH_SMOOTHING_FACTOR) + rtt_msec * ORIGIN_HEALTH_SMOOTHING_FACTOR);
+	health.failure_rate *= (1.0 - ORIGIN_HEALTH_SMOOTHING_FACTOR);
+	health.consecutive_failures = 0;
+	health.available_time = std::chrono::steady_clock::time_point();
+	health.active_stream_count++;
+}
+
+void OriginHealthTable::OnDisconnected(const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+	auto item = _health_map.find(GetKey(url));
+
+	if ((item != _health_map.end()) && (item->second.active_stream_count > 0))
+	{
+		item->second.active_stream_count--;
+	}
+}
+
+void OriginHealthTable::OnFailed(const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+	auto key = GetKey(url);
+	auto &health = _health_map[key];
+
+	health.failure_rate = health.failure_rate * (1.0 - ORIGIN_HEALTH_SMOOTHING_FACTOR) + ORIGIN_HEALTH_SMOOTHING_FACTOR;
+	health.consecutive_failures++;
+
+	auto backoff_msec = static_cast<int64_t>(ORIGIN_HEALTH_MIN_BACKOFF_MSEC) << std::min(health.consecutive_failures - 1, 5);
+	backoff_msec = std::min<int64_t>(backoff_msec, ORIGIN_HEALTH_MAX_BACKOFF_MSEC);
+	// 50% ~ 100% of the back-off
+	backoff_msec = (backoff_msec / 2) + ov::Random::GenerateInt32(0, static_cast<int32_t>(backoff_msec / 2));
+
+	health.available_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff_msec);
+
+	logtw("Origin %s has failed (consecutive failures: %d, failure rate: %.2f, rtt: %.1fms), it is not preferred for %lldms",
+		  key.c_str(), health.consecutive_failures, health.failure_rate, health.rtt_msec, static_cast<long long>(backoff_msec));
+}
+
+bool OriginHealthTable::IsAvailable(const ov::String &url) const
+{
+	std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+	auto item = _health_map.find(GetKey(url));
+
+	return (item == _health_map.end()) || (item->second.available_time <= std::chrono::steady_clock::now());
+}
+
+std::chrono::steady_clock::time_point OriginHealthTable::GetAvailableTime(const std::vector<ov::String> &url_list) const
+{
+	std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+	std::chrono::steady_clock::time_point available_time = std::chrono::steady_clock::time_point::max();
+
+	for (const auto &url : url_list)
+	{
+		auto item = _health_map.find(GetKey(url));
+
+		if (item == _health_map.end())
+		{
+			return std::chrono::steady_clock::time_point();
+		}
+
+		available_time = std::min(available_time, item->second.available_time);
+	}
+
+	return url_list.empty() ? std::chrono::steady_clock::time_point() : available_time;
+}
+
+std::vector<ov::String> OriginHealthTable::Sort(const ov::String &stream_key, const std::vector<ov::String> &url_list, OriginBalance balance) const
+{
+	struct Candidate
+	{
+		size_t index;
+		bool is_available;
+		std::chrono::steady_clock::time_point available_time;
+		int active_stream_count;
+		double rtt_msec;
+		uint64_t hash;
+	};
+
+	std::vector<Candidate> candidates;
+	candidates.reserve(url_list.size());
+
+	{
+		auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock_guard(_health_map_mutex);
+
+		for (size_t index = 0; index < url_list.size(); index++)
+		{
+			auto key = GetKey(url_list[index]);
+			auto item = _health_map.find(key);
+
+			Candidate candidate{index, true, {}, 0, 0.0, 0};
+
+			if (item != _health_map.end())
+			{
+				auto &health = item->second;
+
+				candidate.is_available = (health.available_time <= now);
+				candidate.available_time = health.available_time;
+				candidate.active_stream_count = health.active_stream_count;
+				candidate.rtt_msec = health.rtt_msec;
+			}
+
+			if (balance == OriginBalance::Hash)
+			{
+				candidate.hash = HashString(ov::String::FormatString("%s@%s", stream_key.CStr(), key.c_str()).CStr());
+			}
+
+			candidates.push_back(candidate);
+		}
+	}
+
+	std::stable_sort(candidates.begin(), candidates.end(), [balance](const Candidate &first, const Candidate &second) -> bool {
+		if (first.is_available != second.is_available)
+		{
+			return first.is_available;
+		}
+
+		if (first.is_available == false)
+		{
+			// The origin that will recover first
+			return first.available_time < second.available_time;
+		}
+
+		switch (balance)
+		{
+			case OriginBalance::Order:
+				break;
+
+			case OriginBalance::LeastLoaded:
+				if (first.active_stream_count != second.active_stream_count)
+				{
+					return first.active_stream_count < second.active_stream_count;
+				}
+
+				return first.rtt_msec < second.rtt_msec;
+
+			case OriginBalance::Hash:
+				return first.hash > second.hash;
+		}
+
+		return false;
+	});
+
+	std::vector<ov::String> sorted_url_list;
+	sorted_url_list.reserve(url_list.size());
+
+	for (auto &candidate : candidates)
+	{
+		sorted_url_list.push_back(url_list[candidate.index]);
+	}
+
+	return sorted_url_list;
+}
@@ -0,0 +1,74 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// How the URLs of an <Origin> are ordered when a stream is pulled (<Origin><Balance>)
+enum class OriginBalance : uint8_t
+{
+	// In the order of <Urls> (default)
+	Order,
+	// The origin that is pulling the fewest streams for this server first, and then the one with the lower RTT
+	LeastLoaded,
+	// The origin is chosen by the hash of the stream name (rendezvous hashing),
+	// so all edges pull the same stream from the same origin, and only the streams of a removed origin are moved
+	Hash
+};
+
+// The health of the origins that is reported by the pull streams (OVT/RTSP)
+//
+// Origins are identified by <host>:<port> of the URL, so all streams pulled from an origin share the health.
+// An origin that failed is not preferred for a while (the back-off increases with the consecutive failures, and is jittered
+// so the streams of the origins that failed together don't come back together), but it is still tried last when the others are unavailable.
+class OriginHealthTable
+{
+public:
+	// Called when the stream is pulled from the url (rtt_msec: the time taken to connect and describe)
+	void OnConnected(const ov::String &url, double rtt_msec);
+	// Called when the stream that was connected stops pulling from the url
+	void OnDisconnected(const ov::String &url);
+	// Called when the connection to the url has failed (or the connected stream has broken)
+	void OnFailed(const ov::String &url);
+
+	// Returns false if the origin is in the back-off period
+	bool IsAvailable(const ov::String &url) const;
+	// Returns the time when the first of the origins is out of the back-off period (the past if one of them is available)
+	std::chrono::steady_clock::time_point GetAvailableTime(const std::vector<ov::String> &url_list) const;
+
+	// Returns the URLs ordered by the balance, the unavailable origins are moved to the end
+	//
+	// stream_key: the key that is used to hash (vhost/app/stream)
+	std::vector<ov::String> Sort(const ov::String &stream_key, const std::vector<ov::String> &url_list, OriginBalance balance) const;
+
+private:
+	struct Health
+	{
+		// Exponentially weighted moving average of the time taken to connect and describe
+		double rtt_msec = 0.0;
+		// Exponentially weighted moving average of the results (0.0: succeeded ~ 1.0: failed)
+		double failure_rate = 0.0;
+		int consecutive_failures = 0;
+		// The origin is not preferred until this time
+		std::chrono::steady_clock::time_point available_time;
+
+		// The number of streams that are being pulled from the origin
+		int active_stream_count = 0;
+	};
+
+	static std::string GetKey(const ov::String &url);
+
+	mutable std::mutex _health_map_mutex;
+	// key: <host>:<port>
+	std::unordered_map<std::string, Health> _health_map;
+};
@@ -0,0 +1,95 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "pull_connection_limiter.h"
+
+#include <monitoring/monitoring.h>
+
+#include <thread>
+
+#include "orchestrator_private.h"
+
+void PullConnectionLimiter::Configure(const cfg::PullConnection &config)
+{
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		_is_enabled = config.IsEnabled();
+		_max_concurrency = std::max(config.GetMaxConcurrency(), 1);
+		_max_wait_time = std::chrono::milliseconds(std::max(config.GetMaxWaitTime(), 1));
+	}
+
+	// The pulls waiting for a slot may have more slots now
+	_condition.notify_all();
+
+	if (config.IsEnabled())
+	{
+		logti("Pull connections are limited (concurrency: %d, max wait time: %dms)", config.GetMaxConcurrency(), config.GetMaxWaitTime());
+	}
+}
+
+std::shared_ptr<pvd::Stream> PullConnectionLimiter::Pull(const ov::String &stream_key, const std::vector<ov::String> &url_list,
+														 const OriginHealthTable &origin_health_table, const PullFunction &pull_function)
+{
+	auto &metrics = MonitorInstance->GetPullMetrics();
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	metrics.OnWaiting();
+
+	if (_is_enabled)
+	{
+		auto deadline = std::chrono::steady_clock::now() + _max_wait_time;
+		auto available_time = origin_health_table.GetAvailableTime(url_list);
+
+		if (available_time > std::chrono::steady_clock::now())
+		{
+			// The origins were failing, try again after the (jittered) back-off instead of all pulls at once
+			lock.unlock();
+
+			logtd("[%s] Waiting for the back-off of the origins", stream_key.CStr());
+			std::this_thread::sleep_until(std::min(available_time, deadline));
+
+			lock.lock();
+		}
+
+		if (_condition.wait_until(lock, deadline, [this]() -> bool {
+				return (_is_enabled == false) || (_connecting_count < _max_concurrency);
+			}) == false)
+		{
+			metrics.OnTimedOut();
+
+			logtw("[%s] Could not get a slot to connect to the origin in %lldms (%d pulls are connecting)",
+				  stream_key.CStr(), static_cast<long long>(_max_wait_time.count()), _connecting_count);
+
+			return nullptr;
+		}
+	}
+
+	_connecting_count++;
+	metrics.OnConnecting();
+
+	lock.unlock();
+
+	auto stream = pull_function();
+
+	lock.lock();
+	_connecting_count--;
+	lock.unlock();
+
+	_condition.notify_one();
+
+	if (stream != nullptr)
+	{
+		metrics.OnSucceeded();
+	}
+	else
+	{
+		metrics.OnFailed();
+	}
+
+	return stream;
+}
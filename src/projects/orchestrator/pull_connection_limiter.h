@@ -0,0 +1,49 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/provider/stream.h>
+#include <config/config.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "origin_health.h"
+
+// Limits the pull streams that connect to the origins at once (<Performance><PullConnection>)
+//
+// When the server restarts (or a network comes back), all pull streams reconnect at the same time, and the threads
+// of the pulls block in connect/handshake against the same origins. A pull waits for a slot here, and a pull whose
+// origins are all in the back-off period (See OriginHealthTable) waits for the end of it first without holding a slot,
+// so the reconnects are spread over time by the jittered back-off.
+class PullConnectionLimiter
+{
+public:
+	typedef std::function<std::shared_ptr<pvd::Stream>()> PullFunction;
+
+	void Configure(const cfg::PullConnection &config);
+
+	// Calls pull_function when a slot is available
+	//
+	// Returns nullptr if no slot is available within the max wait time
+	std::shared_ptr<pvd::Stream> Pull(const ov::String &stream_key, const std::vector<ov::String> &url_list,
+									  const OriginHealthTable &origin_health_table, const PullFunction &pull_function);
+
+protected:
+	std::mutex _mutex;
+	std::condition_variable _condition;
+
+	bool _is_enabled = false;
+	int _max_concurrency = 0;
+	std::chrono::milliseconds _max_wait_time{0};
+
+	int _connecting_count = 0;
+};
@@ -0,0 +1,144 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "stream_directory.h"
+
+#include "orchestrator_private.h"
+
+std::string StreamDirectory::GetOriginKey(const ov::String &url)
+{
+	auto parsed_url = ov::Url::Parse(url.CStr());
+
+	if (parsed_url == nullptr)
+	{
+		return url.CStr();
+	}
+
+	return ov::String::FormatString("%s:%u", parsed_url->Domain().CStr(), parsed_url->Port()).CStr();
+}
+
+std::string StreamDirectory::GetStreamKey(const ov::String &vhost_app_name, const ov::String &stream_name)
+{
+	return ov::String::FormatString("%s/%s", vhost_app_name.CStr(), stream_name.CStr()).CStr();
+}
+
+void StreamDirectory::OnSubscribed(const ov::String &vhost_app_name, const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_directory_mutex);
+
+	_subscribed_origin_map[vhost_app_name.CStr()].insert(GetOriginKey(url));
+}
+
+void StreamDirectory::OnUnsubscribed(const ov::String &vhost_app_name, const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_directory_mutex);
+
+	auto origin_key = GetOriginKey(url);
+	auto item = _subscribed_origin_map.find(vhost_app_name.CStr());
+
+	if (item != _subscribed_origin_map.end())
+	{
+		item->second.erase(origin_key);
+
+		if (item->second.empty())
+		{
+			_subscribed_origin_map.erase(item);
+		}
+	}
+
+	// The streams of the application that were registered by the origin are invalidated
+	auto prefix = ov::String::FormatString("%s/", vhost_app_name.CStr());
+
+	for (auto it = _stream_map.begin(); it != _stream_map.end();)
+	{
+		if (ov::String(it->first.c_str()).HasPrefix(prefix))
+		{
+			it->second.erase(origin_key);
+
+			if (it->second.empty())
+			{
+				it = _stream_map.erase(it);
+				continue;
+			}
+		}
+
+		++it;
+	}
+}
+
+void StreamDirectory::Register(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_directory_mutex);
+
+	_stream_map[GetStreamKey(vhost_app_name, stream_name)].insert(GetOriginKey(url));
+}
+
+void StreamDirectory::Unregister(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url)
+{
+	std::lock_guard<std::mutex> lock_guard(_directory_mutex);
+
+	auto item = _stream_map.find(GetStreamKey(vhost_app_name, stream_name));
+
+	if (item == _stream_map.end())
+	{
+		return;
+	}
+
+	item->second.erase(GetOriginKey(url));
+
+	if (item->second.empty())
+	{
+		_stream_map.erase(item);
+	}
+}
+
+bool StreamDirectory::Sort(const ov::String &vhost_app_name, const ov::String &stream_name, std::vector<ov::String> *url_list) const
+{
+	std::lock_guard<std::mutex> lock_guard(_directory_mutex);
+
+	auto subscribed_item = _subscribed_origin_map.find(vhost_app_name.CStr());
+
+	if (subscribed_item == _subscribed_origin_map.end())
+	{
+		// The directory is not used for the application
+		return false;
+	}
+
+	auto stream_item = _stream_map.find(GetStreamKey(vhost_app_name, stream_name));
+
+	std::vector<ov::String> found_url_list;
+	std::vector<ov::String> unknown_url_list;
+	std::vector<ov::String> missing_url_list;
+
+	for (const auto &url : *url_list)
+	{
+		auto origin_key = GetOriginKey(url);
+
+		if ((stream_item != _stream_map.end()) && (stream_item->second.find(origin_key) != stream_item->second.end()))
+		{
+			found_url_list.push_back(url);
+		}
+		else if (subscribed_item->second.find(origin_key) == subscribed_item->second.end())
+		{
+			unknown_url_list.push_back(url);
+		}
+		else
+		{
+			// The origin would have registered the stream if it had it, but it is still tried last (the notification may be late)
+			missing_url_list.push_back(url);
+		}
+	}
+
+	bool is_found = (found_url_list.empty() == false);
+
+	url_list->clear();
+	url_list->insert(url_list->end(), found_url_list.begin(), found_url_list.end());
+	url_list->insert(url_list->end(), unknown_url_list.begin(), unknown_url_list.end());
+	url_list->insert(url_list->end(), missing_url_list.begin(), missing_url_list.end());
+
+	return is_found;
+}
@@ -0,0 +1,51 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// The origins that have the streams (<Origin><Directory>)
+//
+// The origins register the streams when they are created and unregister them when they are deleted
+// (the OVT provider receives them with SUBSCRIBE/NOTIFY), so a stream is pulled from the origin that has it
+// instead of trying the origins that don't have it. It is a cache of the origins: the entries of an origin are
+// invalidated when the subscription to it is broken, and the URLs are tried in the usual order if the directory doesn't know the stream.
+//
+// Origins are identified by <host>:<port> of the URL (the same as OriginHealthTable)
+class StreamDirectory
+{
+public:
+	// The origin of the url is subscribed to, so the streams of the application that are not registered are not in the origin
+	void OnSubscribed(const ov::String &vhost_app_name, const ov::String &url);
+	// The subscription to the origin is broken, the streams of it are not known anymore
+	void OnUnsubscribed(const ov::String &vhost_app_name, const ov::String &url);
+
+	void Register(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url);
+	void Unregister(const ov::String &vhost_app_name, const ov::String &stream_name, const ov::String &url);
+
+	// Reorders the URLs: the origins that have the stream first, then the origins that are not known,
+	// and the origins that don't have the stream last (the order is kept in each group)
+	//
+	// Returns true if an origin that has the stream is found
+	bool Sort(const ov::String &vhost_app_name, const ov::String &stream_name, std::vector<ov::String> *url_list) const;
+
+private:
+	static std::string GetOriginKey(const ov::String &url);
+	static std::string GetStreamKey(const ov::String &vhost_app_name, const ov::String &stream_name);
+
+	mutable std::mutex _directory_mutex;
+	// key: vhost_app_name, value: the origins that are subscribed to
+	std::unordered_map<std::string, std::unordered_set<std::string>> _subscribed_origin_map;
+	// key: vhost_app_name/stream_name, value: the origins that have the stream
+	std::unordered_map<std::string, std::unordered_set<std::string>> _stream_map;
+};
@@ -0,0 +1,559 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_connection.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+
+#define OV_LOG_TAG "OvtConnection"
+
+// The stop flag is checked at this interval while waiting for the packets
+#define OVT_CONNECTION_POLL_INTERVAL_MSEC 100
+#define OVT_CONNECTION_CONNECT_TIMEOUT_MSEC 1000
+// The data is received in this unit (several packets at once)
+#define OVT_CONNECTION_RECV_UNIT (64 * 1024)
+
+namespace pvd
+{
+	//====================================================================================================
+	// OvtChannel
+	//====================================================================================================
+	OvtChannel::OvtChannel()
+	{
+		_event_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+		if (_event_fd == -1)
+		{
+			logte("Could not create the event fd of the channel: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		}
+	}
+
+	OvtChannel::~OvtChannel()
+	{
+		if (_event_fd != -1)
+		{
+			::close(_event_fd);
+			_event_fd = -1;
+		}
+	}
+
+	void OvtChannel::Signal()
+	{
+		uint64_t value = 1;
+		[[maybe_unused]] auto result = ::write(_event_fd, &value, sizeof(value));
+	}
+
+	void OvtChannel::Consume()
+	{
+		uint64_t value = 0;
+		[[maybe_unused]] auto result = ::read(_event_fd, &value, sizeof(value));
+	}
+
+	bool OvtChannel::Push(const std::shared_ptr<OvtPacket> &packet)
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		if (_is_closed || (_packets.size() >= OVT_CHANNEL_MAX_QUEUED_PACKETS))
+		{
+			return false;
+		}
+
+		_packets.push_back(packet);
+
+		if (_packets.size() == 1)
+		{
+			Signal();
+		}
+
+		return true;
+	}
+
+	void OvtChannel::Close()
+	{
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		if (_is_closed == false)
+		{
+			_is_closed = true;
+			Signal();
+		}
+	}
+
+	std::vector<std::shared_ptr<OvtPacket>> OvtChannel::Pop(size_t max_count, bool *is_closed)
+	{
+		std::vector<std::shared_ptr<OvtPacket>> packets;
+		std::lock_guard<std::mutex> lock_guard(_mutex);
+
+		Consume();
+
+		while ((_packets.empty() == false) && (packets.size() < max_count))
+		{
+			packets.push_back(std::move(_packets.front()));
+			_packets.pop_front();
+		}
+
+		*is_closed = _is_closed && _packets.empty();
+
+		// The event fd is level-triggered for the StreamMotor, so it stays readable while the rest are left
+		if ((_packets.empty() == false) || *is_closed)
+		{
+			Signal();
+		}
+
+		return packets;
+	}
+
+	//====================================================================================================
+	// OvtConnection
+	//====================================================================================================
+	static std::mutex g_connection_pool_mutex;
+	// key: domain:port
+	static std::map<ov::String, std::vector<std::weak_ptr<OvtConnection>>> g_connection_pool;
+
+	std::shared_ptr<OvtConnection> OvtConnection::Acquire(const ov::String &domain, int port, int max_connection_count)
+	{
+		std::lock_guard<std::mutex> lock_guard(g_connection_pool_mutex);
+
+		auto &connection_list = g_connection_pool[ov::String::FormatString("%s:%d", domain.CStr(), port)];
+		std::shared_ptr<OvtConnection> least_loaded_connection;
+		size_t least_channel_count = 0;
+
+		for (auto it = connection_list.begin(); it != connection_list.end();)
+		{
+			auto connection = it->lock();
+
+			// The broken connections are released by the streams when they fail over
+			if ((connection == nullptr) || (connection->IsConnected() == false))
+			{
+				it = connection_list.erase(it);
+				continue;
+			}
+
+			auto channel_count = connection->GetChannelCount();
+
+			if ((least_loaded_connection == nullptr) || (channel_count < least_channel_count))
+			{
+				least_loaded_connection = connection;
+				least_channel_count = channel_count;
+			}
+
+			++it;
+		}
+
+		if ((least_loaded_connection != nullptr) && (static_cast<int>(connection_list.size()) >= max_connection_count))
+		{
+			return least_loaded_connection;
+		}
+
+		auto connection = std::shared_ptr<OvtConnection>(new OvtConnection(domain, port));
+
+		if (connection->Connect() == false)
+		{
+			// The existing connection is used if any
+			return least_loaded_connection;
+		}
+
+		connection_list.push_back(connection);
+
+		logti("A new connection to the origin is made: %s (%zu connection(s))", connection->ToString().CStr(), connection_list.size());
+
+		return connection;
+	}
+
+	OvtConnection::OvtConnection(const ov::String &domain, int port)
+		: _domain(domain),
+		  _port(port)
+	{
+		_recv_buffer.SetLength(OVT_CONNECTION_RECV_UNIT + OVT_MAX_PACKET_SIZE);
+	}
+
+	OvtConnection::~OvtConnection()
+	{
+		Disconnect();
+	}
+
+	ov::String OvtConnection::ToString() const
+	{
+		return ov::String::FormatString("ovt://%s:%d", _domain.CStr(), _port);
+	}
+
+	bool OvtConnection::Connect()
+	{
+		if (_socket.Create(ov::SocketType::Tcp) == false)
+		{
+			logte("Could not create the socket for %s", ToString().CStr());
+			return false;
+		}
+
+		auto error = _socket.Connect(ov::SocketAddress(_domain, _port), OVT_CONNECTION_CONNECT_TIMEOUT_MSEC);
+
+		if (error != nullptr)
+		{
+			logte("Cannot connect to origin server (%s) : %s", error->GetMessage().CStr(), ToString().CStr());
+			_socket.Close();
+			return false;
+		}
+
+		_is_connected = true;
+		_stop_thread_flag = false;
+		_thread = std::thread(&OvtConnection::ReceiverThread, this);
+
+		return true;
+	}
+
+	void OvtConnection::Disconnect()
+	{
+		_stop_thread_flag = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+
+		_socket.Close();
+	}
+
+	size_t OvtConnection::GetChannelCount()
+	{
+		std::lock_guard<std::mutex> lock_guard(_channel_map_mutex);
+
+		return _channel_map.size();
+	}
+
+	bool OvtConnection::SendPacket(uint8_t payload_type, uint32_t session_id, const std::shared_ptr<const ov::Data> &payload)
+	{
+		OvtPacket packet;
+
+		packet.SetSessionId(session_id);
+		packet.SetPayloadType(payload_type);
+		packet.SetMarker(0);
+		packet.SetTimestampNow();
+		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+
+		std::lock_guard<std::mutex> lock_guard(_send_mutex);
+
+		return _socket.Send(packet.GetData()) == static_cast<ssize_t>(packet.GetData()->GetLength());
+	}
+
+	std::shared_ptr<OvtControlMessage> OvtConnection::SendRequest(uint8_t payload_type, uint32_t session_id, const ov::String &url, OvtControlMessage::Transport transport,
+																  const std::shared_ptr<OvtChannel> &channel, uint32_t *response_session_id)
+	{
+		std::lock_guard<std::mutex> lock_guard(_request_mutex);
+
+		auto response = RequestInternal(payload_type, session_id, url, transport, channel, response_session_id);
+
+		if ((response != nullptr) && (_control_format == OvtControlMessage::Format::Binary) && (response->GetFormat() == OvtControlMessage::Format::Json))
+		{
+			// The origin that doesn't support the binary format responds with a JSON error, so the request is sent again in JSON
+			logti("The origin doesn't support the binary control message, JSON is used: %s", ToString().CStr());
+
+			_control_format = OvtControlMessage::Format::Json;
+			response = RequestInternal(payload_type, session_id, url, transport, channel, response_session_id);
+		}
+
+		return response;
+	}
+
+	std::shared_ptr<OvtControlMessage> OvtConnection::RequestInternal(uint8_t payload_type, uint32_t session_id, const ov::String &url, OvtControlMessage::Transport transport,
+																	  const std::shared_ptr<OvtChannel> &channel, uint32_t *response_session_id)
+	{
+		if (_is_connected == false)
+		{
+			return nullptr;
+		}
+
+		auto request_id = ++_last_request_id;
+		auto payload = OvtControlMessage::SerializeRequest(_control_format, request_id, url, transport);
+
+		if (payload == nullptr)
+		{
+			return nullptr;
+		}
+
+		std::unique_lock<std::mutex> lock(_response_mutex);
+
+		_waiting_request_id = request_id;
+		_waiting_channel = channel;
+		_response = nullptr;
+
+		if (SendPacket(payload_type, session_id, payload) == false)
+		{
+			logte("Could not send the request to %s", ToString().CStr());
+			_waiting_request_id = 0;
+			_waiting_channel = nullptr;
+			return nullptr;
+		}
+
+		_response_condition.wait_for(lock, std::chrono::milliseconds(OVT_CONNECTION_RESPONSE_TIMEOUT_MSEC), [this]() -> bool {
+			return (_response != nullptr) || (_is_connected == false);
+		});
+
+		auto response = std::move(_response);
+
+		if (response == nullptr)
+		{
+			logte("No response has been received from %s (request id: %u)", ToString().CStr(), request_id);
+		}
+		else if (response_session_id != nullptr)
+		{
+			*response_session_id = _response_session_id;
+		}
+
+		_waiting_request_id = 0;
+		_waiting_channel = nullptr;
+
+		return response;
+	}
+
+	void OvtConnection::StopSession(uint32_t session_id, const ov::String &url)
+	{
+		std::shared_ptr<OvtChannel> channel;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_channel_map_mutex);
+
+			auto item = _channel_map.find(session_id);
+
+			if (item != _channel_map.end())
+			{
+				channel = std::move(item->second);
+				_channel_map.erase(item);
+			}
+		}
+
+		if (channel != nullptr)
+		{
+			channel->Close();
+		}
+
+		if (_is_connected == false)
+		{
+			return;
+		}
+
+		// The response is ignored by the receiver thread (no request is waiting for it)
+		OvtControlMessage::Format format;
+		uint32_t request_id;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_request_mutex);
+
+			format = _control_format;
+			request_id = ++_last_request_id;
+		}
+
+		auto payload = OvtControlMessage::SerializeRequest(format, request_id, url);
+
+		if ((payload == nullptr) || (SendPacket(OVT_PAYLOAD_TYPE_STOP, session_id, payload) == false))
+		{
+			logtw("Could not send STOP of the session %u to %s", session_id, ToString().CStr());
+		}
+	}
+
+	void OvtConnection::ReceiverThread()
+	{
+		ov::ThreadMetrics thread_metrics("OvtConnection", ov::ThreadClass::NetworkIo);
+
+		while (_stop_thread_flag == false)
+		{
+			struct pollfd poll_fd = {_socket.GetSocket().GetSocket(), POLLIN, 0};
+
+			thread_metrics.BeginIdle();
+			auto result = ::poll(&poll_fd, 1, OVT_CONNECTION_POLL_INTERVAL_MSEC);
+			thread_metrics.EndIdle();
+
+			if ((result == 0) || ((result < 0) && (errno == EINTR)))
+			{
+				continue;
+			}
+
+			if ((result < 0) || (ProcessReceivedData() == false))
+			{
+				break;
+			}
+		}
+
+		if (_stop_thread_flag == false)
+		{
+			logtw("The connection to the origin is broken: %s", ToString().CStr());
+		}
+
+		// The streams fail over when their channels are closed
+		{
+			std::lock_guard<std::mutex> lock_guard(_response_mutex);
+
+			_is_connected = false;
+			_response_condition.notify_all();
+		}
+
+		std::unordered_map<uint32_t, std::shared_ptr<OvtChannel>> channel_map;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_channel_map_mutex);
+			channel_map = std::move(_channel_map);
+		}
+
+		for (auto &item : channel_map)
+		{
+			item.second->Close();
+		}
+	}
+
+	bool OvtConnection::ProcessReceivedData()
+	{
+		size_t read_bytes = 0;
+		auto buffer = _recv_buffer.GetWritableDataAs<uint8_t>();
+		auto error = _socket.Recv(buffer + _recv_buffer_offset, _recv_buffer.GetLength() - _recv_buffer_offset, &read_bytes, true);
+
+		if (read_bytes == 0)
+		{
+			// The socket is readable but there is no data: the connection is closed
+			if (error != nullptr)
+			{
+				logte("An error occurred while receiving packet: %s", error->ToString().CStr());
+			}
+
+			return false;
+		}
+
+		_recv_buffer_offset += read_bytes;
+
+		size_t offset = 0;
+
+		while ((_recv_buffer_offset - offset) >= OVT_FIXED_HEADER_SIZE)
+		{
+			OvtPacket header;
+
+			if (header.LoadHeader(ov::Data(buffer + offset, OVT_FIXED_HEADER_SIZE, true)) == false)
+			{
+				logte("An error occurred while receiving header: Invalid packet from %s", ToString().CStr());
+				return false;
+			}
+
+			size_t packet_size = OVT_FIXED_HEADER_SIZE + header.PayloadLength();
+
+			if ((_recv_buffer_offset - offset) < packet_size)
+			{
+				// Need more data
+				break;
+			}
+
+			auto packet = std::make_shared<OvtPacket>();
+
+			if (packet->Load(ov::Data(buffer + offset, packet_size, true)) == false)
+			{
+				logte("An error occurred while receiving payload: Invalid packet from %s", ToString().CStr());
+				return false;
+			}
+
+			offset += packet_size;
+
+			if (packet->PayloadType() == OVT_PAYLOAD_TYPE_MEDIA_PACKET)
+			{
+				ProcessMediaPacket(packet);
+			}
+			else
+			{
+				ProcessControlPacket(packet);
+			}
+		}
+
+		// The partial packet is moved to the front of the buffer
+		if (offset > 0)
+		{
+			::memmove(buffer, buffer + offset, _recv_buffer_offset - offset);
+			_recv_buffer_offset -= offset;
+		}
+
+		return true;
+	}
+
+	void OvtConnection::ProcessMediaPacket(const std::shared_ptr<OvtPacket> &packet)
+	{
+		std::shared_ptr<OvtChannel> channel;
+
+		{
+			std::lock_guard<std::mutex> lock_guard(_channel_map_mutex);
+
+			auto item = _channel_map.find(packet->SessionId());
+
+			if (item == _channel_map.end())
+			{
+				// The packets that are sent before STOP is handled by the origin
+				return;
+			}
+
+			channel = item->second;
+		}
+
+		if (channel->Push(packet) == false)
+		{
+			// The stream cannot keep up with the origin, it fails over when the channel is closed
+			// (the other streams of the connection are not blocked by it)
+			logtw("The packets of the session %u are not processed in time, the session is closed: %s", packet->SessionId(), ToString().CStr());
+
+			std::lock_guard<std::mutex> lock_guard(_channel_map_mutex);
+			_channel_map.erase(packet->SessionId());
+
+			channel->Close();
+		}
+	}
+
+	void OvtConnection::ProcessControlPacket(const std::shared_ptr<OvtPacket> &packet)
+	{
+		// The responses of the different sessions may be fragmented at the same time
+		auto key = (static_cast<uint64_t>(packet->PayloadType()) << 32) | packet->SessionId();
+		auto &fragments = _control_fragments[key];
+
+		if (fragments == nullptr)
+		{
+			fragments = std::make_shared<ov::Data>();
+		}
+
+		fragments->Append(packet->Payload(), packet->PayloadLength());
+
+		if (packet->Marker() == false)
+		{
+			return;
+		}
+
+		auto message = OvtControlMessage::Parse(fragments);
+		_control_fragments.erase(key);
+
+		if ((message == nullptr) || (message->IsValidResponse() == false))
+		{
+			logtw("An invalid response has been received from %s", ToString().CStr());
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock_guard(_response_mutex);
+
+		if (_waiting_request_id == 0)
+		{
+			// The responses of STOP, and the responses that are timed out
+			return;
+		}
+
+		// The origin responds to the request that cannot be parsed with ID 0 (the binary format is not supported)
+		if ((message->GetId() != _waiting_request_id) && (message->GetId() != 0))
+		{
+			return;
+		}
+
+		if ((_waiting_channel != nullptr) && (message->GetCode() == 200))
+		{
+			// Bound before the next packet is received, so the first packets of the session are not lost
+			std::lock_guard<std::mutex> channel_lock_guard(_channel_map_mutex);
+			_channel_map[packet->SessionId()] = _waiting_channel;
+		}
+
+		_response = message;
+		_response_session_id = packet->SessionId();
+		_response_condition.notify_all();
+	}
+}  // namespace pvd
@@ -0,0 +1,146 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/ovsocket/socket.h>
+#include <modules/ovt_packetizer/ovt_control_message.h>
+#include <modules/ovt_packetizer/ovt_packet.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+// How long a response of the origin is waited for (the origin may pull the stream from the upper tier before it responds)
+#define OVT_CONNECTION_RESPONSE_TIMEOUT_MSEC 10000
+// The packets of a session that are not processed yet, the session is closed if the stream cannot keep up with it
+#define OVT_CHANNEL_MAX_QUEUED_PACKETS 8192
+// The number of the packets that a stream processes at once, so the streams of a connection are processed in turn
+#define OVT_CHANNEL_MAX_PACKETS_PER_PROCESS 64
+
+namespace pvd
+{
+	// The packets of a session (a stream) that are received over the shared connection
+	//
+	// The receiver thread of the connection pushes the packets, and the StreamMotor pops them when the event fd becomes readable.
+	class OvtChannel
+	{
+	public:
+		OvtChannel();
+		~OvtChannel();
+
+		// Readable while there are packets to pop (or the channel is closed)
+		int GetEventFd() const
+		{
+			return _event_fd;
+		}
+
+		// Returns false if the channel is closed, or the queue is full
+		bool Push(const std::shared_ptr<OvtPacket> &packet);
+		// The connection is broken or the session is stopped
+		void Close();
+
+		// Pops up to max_count packets
+		// is_closed: true if the channel is closed and all the packets are popped
+		std::vector<std::shared_ptr<OvtPacket>> Pop(size_t max_count, bool *is_closed);
+
+	private:
+		void Signal();
+		void Consume();
+
+		int _event_fd = -1;
+
+		std::mutex _mutex;
+		std::deque<std::shared_ptr<OvtPacket>> _packets;
+		bool _is_closed = false;
+	};
+
+	// A connection to an origin that is shared by the streams pulled from it (See <Providers><OVT><MultiplexConnections>)
+	//
+	// The streams send DESCRIBE/PLAY/STOP over the connection, and the media packets are routed to the channels of the streams by the session ID.
+	// The origin already handles many sessions per connection, so the protocol is not changed.
+	class OvtConnection
+	{
+	public:
+		// Returns the connection to the origin that has the fewest channels, a new connection is made if there are fewer than max_connection_count
+		static std::shared_ptr<OvtConnection> Acquire(const ov::String &domain, int port, int max_connection_count);
+
+		~OvtConnection();
+
+		bool IsConnected() const
+		{
+			return _is_connected;
+		}
+
+		// Sends the request, and waits for the response (nullptr if the connection is broken, or no response comes in time)
+		//
+		// channel: (PLAY) The channel is bound to the session ID of the response before the packets of the session are received
+		// response_session_id: The session ID in the header of the response
+		std::shared_ptr<OvtControlMessage> SendRequest(uint8_t payload_type, uint32_t session_id, const ov::String &url, OvtControlMessage::Transport transport,
+													   const std::shared_ptr<OvtChannel> &channel = nullptr, uint32_t *response_session_id = nullptr);
+
+		// Unbinds the channel of the session, and sends STOP without waiting for the response
+		void StopSession(uint32_t session_id, const ov::String &url);
+
+		ov::String ToString() const;
+
+	private:
+		OvtConnection(const ov::String &domain, int port);
+
+		bool Connect();
+		void Disconnect();
+
+		bool SendPacket(uint8_t payload_type, uint32_t session_id, const std::shared_ptr<const ov::Data> &payload);
+		// Sends the request in the format of the connection, and waits for the response to it
+		std::shared_ptr<OvtControlMessage> RequestInternal(uint8_t payload_type, uint32_t session_id, const ov::String &url, OvtControlMessage::Transport transport,
+														   const std::shared_ptr<OvtChannel> &channel, uint32_t *response_session_id);
+
+		void ReceiverThread();
+		// Parses the packets in the receive buffer
+		bool ProcessReceivedData();
+		void ProcessControlPacket(const std::shared_ptr<OvtPacket> &packet);
+		void ProcessMediaPacket(const std::shared_ptr<OvtPacket> &packet);
+
+		size_t GetChannelCount();
+
+		ov::String _domain;
+		int _port;
+
+		ov::Socket _socket;
+		std::mutex _send_mutex;
+		std::atomic<bool> _is_connected{false};
+
+		std::atomic<bool> _stop_thread_flag{true};
+		std::thread _thread;
+
+		// Used by the receiver thread only
+		ov::Data _recv_buffer;
+		size_t _recv_buffer_offset = 0;
+		// The fragments of the control messages, key: (payload type << 32) | session ID
+		std::map<uint64_t, std::shared_ptr<ov::Data>> _control_fragments;
+
+		// A request is sent at a time, so the responses that are fragmented are not mixed
+		std::mutex _request_mutex;
+		// The format of the control messages, it is negotiated with the first request of the connection
+		OvtControlMessage::Format _control_format = OvtControlMessage::Format::Binary;
+		uint32_t _last_request_id = 0;
+
+		// The request that is waiting for the response (protected by _response_mutex)
+		std::mutex _response_mutex;
+		std::condition_variable _response_condition;
+		uint32_t _waiting_request_id = 0;
+		std::shared_ptr<OvtChannel> _waiting_channel;
+		std::shared_ptr<OvtControlMessage> _response;
+		uint32_t _response_session_id = 0;
+
+		std::mutex _channel_map_mutex;
+		// key: session ID
+		std::unordered_map<uint32_t, std::shared_ptr<OvtChannel>> _channel_map;
+	};
+}  // namespace pvd
@@ -37,6 +37,73 @@ namespace pvd
 		logtd("Terminated OvtProvider modules.");
 	}
 
+	bool OvtProvider::Start()
+	{
+		_stop_prewarm_thread_flag = false;
+		_prewarm_thread = std::thread(&OvtProvider::PrewarmThread, this);
+
+		return Provider::Start();
+	}
+
+	bool OvtProvider::Stop()
+	{
+		if(_stop_prewarm_thread_flag == false)
+		{
+			_stop_prewarm_thread_flag = true;
+
+			if(_prewarm_thread.joinable())
+			{
+				_prewarm_thread.join();
+			}
+
+			// The subscriptions are stopped before the applications, so no stream is pulled while stopping
+			_subscription_list.clear();
+		}
+
+		return Provider::Stop();
+	}
+
+	void OvtProvider::PrewarmThread()
+	{
+		while(_stop_prewarm_thread_flag == false)
+		{
+			UpdateSubscriptions();
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(OVT_PREWARM_CHECK_INTERVAL_MSEC));
+		}
+	}
+
+	void OvtProvider::UpdateSubscriptions()
+	{
+		auto subscribed_origin_list = Orchestrator::GetInstance()->GetSubscribedOriginList();
+		std::vector<std::shared_ptr<OvtSubscription>> subscription_list;
+
+		for(const auto &subscribed_origin : subscribed_origin_list)
+		{
+			auto item = std::find_if(_subscription_list.begin(), _subscription_list.end(), [&subscribed_origin](const std::shared_ptr<OvtSubscription> &subscription) -> bool {
+				return subscription->GetOrigin() == subscribed_origin;
+			});
+
+			if(item != _subscription_list.end())
+			{
+				// Not changed
+				subscription_list.push_back(*item);
+				_subscription_list.erase(item);
+				continue;
+			}
+
+			logti("Subscribing to %s for the streams of %s", subscribed_origin.url_list[0].CStr(), subscribed_origin.vhost_app_name.CStr());
+
+			auto subscription = std::make_shared<OvtSubscription>(subscribed_origin);
+			subscription->Start();
+
+			subscription_list.push_back(subscription);
+		}
+
+		// The remaining subscriptions were removed from the configuration (they are stopped when they are released)
+		_subscription_list.swap(subscription_list);
+	}
+
 	std::shared_ptr<pvd::Application> OvtProvider::OnCreateProviderApplication(const info::Application &app_info)
 	{
 		return OvtApplication::Create(GetSharedPtrAs<pvd::Provider>(), app_info);
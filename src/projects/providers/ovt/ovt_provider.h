@@ -10,6 +10,11 @@
 #include <base/provider/provider.h>
 #include <orchestrator/orchestrator.h>
 
+#include "ovt_subscription.h"
+
+// <Origins><Origin><Prewarm>/<Directory> are checked at this interval (the origin map can be changed)
+#define OVT_PREWARM_CHECK_INTERVAL_MSEC 1000
+
 /*
  * OvtProvider
  * 		: Create PhysicalPort, OvtApplication
@@ -51,9 +56,21 @@ namespace pvd
 		{
 			return "OvtProvider";
 		}
+
+		bool Start() override;
+		bool Stop() override;
 		
 	protected:
 		std::shared_ptr<pvd::Application> OnCreateProviderApplication(const info::Application &app_info) override;
 		bool OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application) override;
+
+	private:
+		// Keeps the subscriptions the same as the <Origin>s that have <Prewarm> or <Directory>
+		void PrewarmThread();
+		void UpdateSubscriptions();
+
+		std::atomic<bool> _stop_prewarm_thread_flag{true};
+		std::thread _prewarm_thread;
+		std::vector<std::shared_ptr<OvtSubscription>> _subscription_list;
 	};
 }  // namespace pvd
\ No newline at end of file
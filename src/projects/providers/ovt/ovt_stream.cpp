@@ -7,6 +7,13 @@
 #include "base/info/application.h"
 #include "ovt_stream.h"
 
+#include <base/ovlibrary/byte_io.h>
+#include <orchestrator/orchestrator.h>
+
+#include <sys/socket.h>
+
+#include <thread>
+
 #define OV_LOG_TAG "OvtStream"
 
 namespace pvd
@@ -50,24 +57,60 @@ namespace pvd
 		{
 			_curr_url = _url_list[0];
 		}
+
+		_depacketizer = std::make_shared<OvtDepacketizer>();
+
+		auto ovt_config = application->GetProvider<cfg::OvtProvider>();
+		if(ovt_config != nullptr)
+		{
+			_use_datagram = ovt_config->IsDatagramEnabled();
+			_retransmit_deadline_msec = ovt_config->GetRetransmitDeadline();
+			_multiplex_connection_count = ovt_config->GetMultiplexConnections();
+			_use_shared_memory = ovt_config->IsSharedMemoryEnabled();
+		}
 	}
 
 	OvtStream::~OvtStream()
 	{
 		Stop();
 
-		_client_socket.Close();
+		DisconnectOrigin();
 	}
 
 	bool OvtStream::Start()
 	{
-		_recv_buffer.SetLength(OVT_DEFAULT_MAX_PACKET_SIZE);
+		// The origin may send the packets up to the maximum payload length
+		_recv_buffer.SetLength(OVT_MAX_PACKET_SIZE);
 		ResetRecvBuffer();
 
+		// The URLs are ordered by the Orchestrator (See <Origin><Balance>)
+		for(const auto &url : _url_list)
+		{
+			if(ConnectAndDescribe(url))
+			{
+				return pvd::Stream::Start();
+			}
+		}
+
+		return false;
+	}
+
+	bool OvtStream::ConnectAndDescribe(const std::shared_ptr<const ov::Url> &url)
+	{
+		auto &origin_health_table = Orchestrator::GetInstance()->GetOriginHealthTable();
+
+		_curr_url = url;
+		_state = State::IDLE;
+		// The binary format is tried first for each connection (See RequestDescribe())
+		_control_format = OvtControlMessage::Format::Binary;
+
 		// For statistics
 		auto begin = std::chrono::steady_clock::now();
 		if (!ConnectOrigin())
 		{
+			origin_health_table.OnFailed(url->Source());
+			_client_socket.Close();
+			_connection.reset();
 			return false;
 		}
 
@@ -78,6 +121,9 @@ namespace pvd
 		begin = std::chrono::steady_clock::now();
 		if (!RequestDescribe())
 		{
+			origin_health_table.OnFailed(url->Source());
+			_client_socket.Close();
+			_connection.reset();
 			return false;
 		}
 
@@ -85,7 +131,125 @@ namespace pvd
 		elapsed = end - begin;
 		_origin_response_time_msec = elapsed.count();
 
-		return pvd::Stream::Start();
+		origin_health_table.OnConnected(url->Source(), _origin_request_time_msec + _origin_response_time_msec);
+		_is_origin_connected = true;
+
+		return true;
+	}
+
+	void OvtStream::DisconnectOrigin()
+	{
+		if(_is_origin_connected)
+		{
+			Orchestrator::GetInstance()->GetOriginHealthTable().OnDisconnected(_curr_url->Source());
+			_is_origin_connected = false;
+		}
+
+		_client_socket.Close();
+
+		if(_connection != nullptr)
+		{
+			// The connection is closed when the last stream releases it
+			if(_channel != nullptr)
+			{
+				_connection->StopSession(_session_id, _curr_url->Source());
+				_channel.reset();
+			}
+
+			_connection.reset();
+		}
+
+		if(_is_datagram_mode)
+		{
+			logti("%s/%s(%u) - Datagram mode: %llu packets were recovered, %llu packets were lost",
+				  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(),
+				  static_cast<unsigned long long>(_reorder_buffer->GetRecoveredCount()), static_cast<unsigned long long>(_reorder_buffer->GetLostCount()));
+
+			_datagram_socket.Close();
+			_is_datagram_mode = false;
+			_reorder_buffer.reset();
+		}
+
+		StopSharedMemory();
+	}
+
+	bool OvtStream::Failover()
+	{
+		if(_curr_url == nullptr)
+		{
+			return false;
+		}
+
+		auto &origin_health_table = Orchestrator::GetInstance()->GetOriginHealthTable();
+		auto failed_url = _curr_url;
+
+		logtw("%s/%s(%u) The connection to the origin is broken, trying to fail over: %s",
+			  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), failed_url->Source().CStr());
+
+		DisconnectOrigin();
+		origin_health_table.OnFailed(failed_url->Source());
+
+		// The partial packet/message of the previous connection is discarded
+		_packet_mold.reset();
+		ResetRecvBuffer();
+		_depacketizer = std::make_shared<OvtDepacketizer>();
+
+		size_t failed_index = 0;
+		for(size_t index = 0; index < _url_list.size(); index++)
+		{
+			if(_url_list[index] == failed_url)
+			{
+				failed_index = index;
+				break;
+			}
+		}
+
+		// The next origins are tried first (including the failed one at last),
+		// and the origins in the back-off period are tried after the available ones
+		std::vector<std::shared_ptr<const ov::Url>> available_url_list;
+		std::vector<std::shared_ptr<const ov::Url>> unavailable_url_list;
+
+		for(size_t count = 1; count <= _url_list.size(); count++)
+		{
+			auto &url = _url_list[(failed_index + count) % _url_list.size()];
+
+			if(origin_health_table.IsAvailable(url->Source()))
+			{
+				available_url_list.push_back(url);
+			}
+			else
+			{
+				unavailable_url_list.push_back(url);
+			}
+		}
+
+		available_url_list.insert(available_url_list.end(), unavailable_url_list.begin(), unavailable_url_list.end());
+
+		for(const auto &url : available_url_list)
+		{
+			if(ConnectAndDescribe(url) == false)
+			{
+				continue;
+			}
+
+			if(RequestPlay() == false)
+			{
+				DisconnectOrigin();
+				origin_health_table.OnFailed(url->Source());
+				continue;
+			}
+
+			logti("%s/%s(%u) has failed over to the origin: %s",
+				  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), url->Source().CStr());
+
+			_is_timestamp_offset_required = true;
+
+			return true;
+		}
+
+		_state = State::ERROR;
+
+		return false;
 	}
 	
 	bool OvtStream::Play()
@@ -142,7 +306,19 @@ namespace pvd
 			logte("The scheme is not OVT : %s", scheme.CStr());
 			return false;
 		}
-		
+
+		if (_multiplex_connection_count > 0)
+		{
+			_connection = OvtConnection::Acquire(_curr_url->Domain(), _curr_url->Port(), _multiplex_connection_count);
+			if (_connection == nullptr)
+			{
+				_state = State::ERROR;
+				return false;
+			}
+
+			_state = State::CONNECTED;
+			return true;
+		}
 
 		if (!_client_socket.Create(ov::SocketType::Tcp))
 		{
@@ -166,32 +342,49 @@ namespace pvd
 		return true;
 	}
 
-	bool OvtStream::RequestDescribe()
+	bool OvtStream::SendRequest(uint8_t payload_type, uint32_t session_id, OvtControlMessage::Transport transport)
 	{
-		if(_state != State::CONNECTED)
+		_last_request_id++;
+
+		auto payload = OvtControlMessage::SerializeRequest(_control_format, _last_request_id, _curr_url->Source(), transport);
+		if(payload == nullptr)
 		{
 			return false;
 		}
 
 		OvtPacket packet;
 
-		packet.SetSessionId(0);
-		packet.SetPayloadType(OVT_PAYLOAD_TYPE_DESCRIBE);
+		packet.SetSessionId(session_id);
+		packet.SetPayloadType(payload_type);
 		packet.SetMarker(0);
 		packet.SetTimestampNow();
+		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
 
-		Json::Value root;
+		auto sent_size = _client_socket.Send(packet.GetData());
 
-		_last_request_id++;
-		root["id"] = _last_request_id;
-		root["url"] = _curr_url->Source().CStr();
+		return sent_size == static_cast<ssize_t>(packet.GetData()->GetLength());
+	}
 
-		auto payload = ov::Json::Stringify(root).ToData(false);
+	bool OvtStream::RequestDescribe()
+	{
+		if(_state != State::CONNECTED)
+		{
+			return false;
+		}
 
-		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+		if(_connection != nullptr)
+		{
+			auto response = _connection->SendRequest(OVT_PAYLOAD_TYPE_DESCRIBE, 0, _curr_url->Source(), OvtControlMessage::Transport::Connection);
+			if(response == nullptr)
+			{
+				_state = State::ERROR;
+				return false;
+			}
 
-		auto sent_size = _client_socket.Send(packet.GetData());
-		if(sent_size != static_cast<ssize_t>(packet.GetData()->GetLength()))
+			return ProcessDescribeResponse(response, response->GetId());
+		}
+
+		if(SendRequest(OVT_PAYLOAD_TYPE_DESCRIBE, 0) == false)
 		{
 			_state = State::ERROR;
 			logte("Could not send Describe message");
@@ -210,127 +403,124 @@ namespace pvd
 			return false;
 		}
 
-		// Parsing Payload
-		ov::String payload = data->GetDataAs<char>();
-		ov::JsonObject object = ov::Json::Parse(payload);
+		auto response = OvtControlMessage::Parse(data);
 
-		if (object.IsNull())
+		if (response == nullptr)
 		{
 			_state = State::ERROR;
-			logte("An invalid response : Json format");
+			logte("An invalid response : Format");
 			return false;
 		}
 
-		Json::Value &json_id = object.GetJsonValue()["id"];
-		Json::Value &json_code = object.GetJsonValue()["code"];
-		Json::Value &json_message = object.GetJsonValue()["message"];
-		Json::Value &json_stream = object.GetJsonValue()["stream"];
+		if ((_control_format == OvtControlMessage::Format::Binary) && (response->GetFormat() == OvtControlMessage::Format::Json))
+		{
+			// The origin that doesn't support the binary format responds with a JSON error, so the request is sent again in JSON
+			logti("The origin doesn't support the binary control message, JSON is used: %s", _curr_url->Source().CStr());
+
+			_control_format = OvtControlMessage::Format::Json;
+			return RequestDescribe();
+		}
+
+		return ProcessDescribeResponse(response, request_id);
+	}
 
-		if (!json_id.isUInt() || !json_code.isUInt() || json_message.isNull())
+	bool OvtStream::ProcessDescribeResponse(const std::shared_ptr<OvtControlMessage> &response, uint32_t request_id)
+	{
+		if (response->IsValidResponse() == false)
 		{
 			_state = State::ERROR;
 			logte("An invalid response : There are no required keys");
 			return false;
 		}
 
-		if (request_id != json_id.asUInt())
+		if (request_id != response->GetId())
 		{
 			_state = State::ERROR;
-			logte("An invalid response : Response ID is wrong. (%d / %d)", request_id, json_id.asUInt());
+			logte("An invalid response : Response ID is wrong. (%d / %d)", request_id, response->GetId());
 			return false;
 		}
 
-		if (json_code.asUInt() != 200)
+		if (response->GetCode() != 200)
 		{
 			_state = State::ERROR;
-			logte("Describe : Server Failure : %d (%s)", json_code.asUInt(), json_message.asString().c_str());
+			logte("Describe : Server Failure : %d (%s)", response->GetCode(), response->GetMessage().CStr());
 			return false;
 		}
 
-		if (json_stream.isNull())
+		if (response->HasStream() == false)
 		{
 			_state = State::ERROR;
 			logte("An invalid response : There is no stream key");
 			return false;
 		}
 
-		// Parse stream and add track
-		auto json_tracks = json_stream["tracks"];
+		auto &tracks = response->GetTracks();
 
-		// Validation
-		if (json_stream["appName"].isNull() || json_stream["streamName"].isNull() || json_stream["tracks"].isNull() ||
-			!json_tracks.isArray())
+		if (GetTracks().empty())
+		{
+			for (auto &track : tracks)
+			{
+				AddTrack(track);
+			}
+		}
+		else if (IsSameTracks(tracks) == false)
 		{
+			// The tracks cannot be changed while the stream is being played
 			_state = State::ERROR;
-			logte("Invalid json payload : stream");
+			logte("The tracks of the origin are different from the tracks of the stream: %s", _curr_url->Source().CStr());
 			return false;
 		}
 
-		//SetName(json_stream["streamName"].asString().c_str());
-		std::shared_ptr<MediaTrack> new_track;
+		_state = State::DESCRIBED;
+		return true;
+	}
+
+	bool OvtStream::IsSameTracks(const std::vector<std::shared_ptr<MediaTrack>> &tracks) const
+	{
+		auto &current_tracks = GetTracks();
 
-		for (size_t i = 0; i < json_tracks.size(); i++)
+		if (current_tracks.size() != tracks.size())
 		{
-			auto json_track = json_tracks[static_cast<int>(i)];
+			return false;
+		}
 
-			new_track = std::make_shared<MediaTrack>();
+		for (auto &track : tracks)
+		{
+			auto item = current_tracks.find(track->GetId());
 
-			// Validation
-			if (!json_track["id"].isUInt() || !json_track["codecId"].isUInt() || !json_track["mediaType"].isUInt() ||
-				!json_track["timebase_num"].isUInt() || !json_track["timebase_den"].isUInt() ||
-				!json_track["bitrate"].isUInt() ||
-				!json_track["startFrameTime"].isUInt64() || !json_track["lastFrameTime"].isUInt64())
+			if (item == current_tracks.end())
 			{
-				_state = State::ERROR;
-				logte("Invalid json track [%d]", i);
 				return false;
 			}
 
-			new_track->SetId(json_track["id"].asUInt());
-			new_track->SetCodecId(static_cast<common::MediaCodecId>(json_track["codecId"].asUInt()));
-			new_track->SetMediaType(static_cast<common::MediaType>(json_track["mediaType"].asUInt()));
-			new_track->SetTimeBase(json_track["timebase_num"].asUInt(), json_track["timebase_den"].asUInt());
-			new_track->SetBitrate(json_track["bitrate"].asUInt());
-			new_track->SetStartFrameTime(json_track["startFrameTime"].asUInt64());
-			new_track->SetLastFrameTime(json_track["lastFrameTime"].asUInt64());
+			auto &current_track = item->second;
 
-			// video or audio
-			if (new_track->GetMediaType() == common::MediaType::Video)
+			if ((current_track->GetMediaType() != track->GetMediaType()) ||
+				(current_track->GetCodecId() != track->GetCodecId()) ||
+				(current_track->GetTimeBase().GetNum() != track->GetTimeBase().GetNum()) ||
+				(current_track->GetTimeBase().GetDen() != track->GetTimeBase().GetDen()))
 			{
-				auto json_video_track = json_track["videoTrack"];
-				if (json_video_track.isNull())
-				{
-					_state = State::ERROR;
-					logte("Invalid json videoTrack");
-					return false;
-				}
-
-				new_track->SetFrameRate(json_video_track["framerate"].asDouble());
-				new_track->SetWidth(json_video_track["width"].asUInt());
-				new_track->SetHeight(json_video_track["height"].asUInt());
+				return false;
 			}
-			else if (new_track->GetMediaType() == common::MediaType::Audio)
-			{
-				auto json_audio_track = json_track["audioTrack"];
-				if (json_audio_track.isNull())
-				{
-					_state = State::ERROR;
-					logte("Invalid json audioTrack");
-					return false;
-				}
+		}
 
-				new_track->SetSampleRate(json_audio_track["samplerate"].asUInt());
-				new_track->GetSample().SetFormat(
-						static_cast<common::AudioSample::Format>(json_audio_track["sampleFormat"].asInt()));
-				new_track->GetChannel().SetLayout(
-						static_cast<common::AudioChannel::Layout>(json_audio_track["layout"].asUInt()));
-			}
+		return true;
+	}
+
+	OvtControlMessage::Transport OvtStream::GetPlayTransport() const
+	{
+		// The origin that is not on the same host (or doesn't support the shared memory) falls back to the next transport
+		if (_use_shared_memory)
+		{
+			return OvtControlMessage::Transport::SharedMemory;
+		}
 
-			AddTrack(new_track);
+		if (_use_datagram)
+		{
+			return OvtControlMessage::Transport::Datagram;
 		}
 
-		_state = State::DESCRIBED;
-		return true;
+		return OvtControlMessage::Transport::Connection;
 	}
 
 	bool OvtStream::RequestPlay()
@@ -340,24 +530,34 @@ namespace pvd
 			return false;
 		}
 
-		OvtPacket packet;
+		if(_connection != nullptr)
+		{
+			// The channel is bound to the session before the first packet of the session is received
+			auto channel = std::make_shared<OvtChannel>();
+			uint32_t session_id = 0;
 
-		packet.SetSessionId(0);
-		packet.SetPayloadType(OVT_PAYLOAD_TYPE_PLAY);
-		packet.SetMarker(0);
-		packet.SetTimestampNow();
+			auto response = _connection->SendRequest(OVT_PAYLOAD_TYPE_PLAY, 0, _curr_url->Source(), GetPlayTransport(), channel, &session_id);
+			if(response == nullptr)
+			{
+				_state = State::ERROR;
+				return false;
+			}
 
-		Json::Value root;
-		_last_request_id++;
-		root["id"] = _last_request_id;
-		root["url"] = _curr_url->Source().CStr();
+			if(ProcessPlayResponse(response, response->GetId(), session_id) == false)
+			{
+				if(response->GetCode() == 200)
+				{
+					_connection->StopSession(session_id, _curr_url->Source());
+				}
 
-		auto payload = ov::Json::Stringify(root).ToData(false);
+				return false;
+			}
 
-		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+			_channel = channel;
+			return true;
+		}
 
-		auto sent_size = _client_socket.Send(packet.GetData());
-		if(sent_size != static_cast<ssize_t>(packet.GetData()->GetLength()))
+		if(SendRequest(OVT_PAYLOAD_TYPE_PLAY, 0, GetPlayTransport()) == false)
 		{
 			_state = State::ERROR;
 			logte("Could not send Play message");
@@ -388,42 +588,70 @@ namespace pvd
 		}
 		
 		// Parsing Payload
-		ov::String payload((const char *) packet->Payload(), packet->PayloadLength());
-		ov::JsonObject object = ov::Json::Parse(payload);
+		auto response = OvtControlMessage::Parse(std::make_shared<ov::Data>(packet->Payload(), packet->PayloadLength(), true));
 
-		if (object.IsNull())
+		if (response == nullptr)
 		{
 			_state = State::ERROR;
-			logte("An invalid response : Json format");
+			logte("An invalid response : Format");
 			return false;
 		}
 
-		Json::Value &json_id = object.GetJsonValue()["id"];
-		Json::Value &json_code = object.GetJsonValue()["code"];
-		Json::Value &json_message = object.GetJsonValue()["message"];
+		return ProcessPlayResponse(response, request_id, packet->SessionId());
+	}
 
-		if (!json_id.isUInt() || !json_code.isUInt() || json_message.isNull())
+	bool OvtStream::ProcessPlayResponse(const std::shared_ptr<OvtControlMessage> &response, uint32_t request_id, uint32_t session_id)
+	{
+		if (response->IsValidResponse() == false)
 		{
 			_state = State::ERROR;
 			logte("An invalid response : There are no required keys");
 			return false;
 		}
 
-		if (request_id != json_id.asUInt())
+		if (request_id != response->GetId())
 		{
 			_state = State::ERROR;
 			logte("An invalid response : Response ID is wrong.");
 			return false;
 		}
 
-		if (json_code.asUInt() != 200)
+		if (response->GetCode() != 200)
 		{
 			_state = State::ERROR;
-			logte("Play : Server Failure : %s (%d)", json_code.asUInt(), json_message.asString().c_str());
+			logte("Play : Server Failure : %d (%s)", response->GetCode(), response->GetMessage().CStr());
 			return false;
 		}
 
-		_session_id = packet->SessionId();
+		_session_id = session_id;
+
+		if (response->GetSharedMemoryPath().IsEmpty() == false)
+		{
+			if (StartSharedMemory(response->GetSharedMemoryPath(), response->GetSharedMemoryToken()) == false)
+			{
+				_state = State::ERROR;
+				return false;
+			}
+		}
+		else if (_use_shared_memory)
+		{
+			// The origin is not on the same host, or it doesn't support the shared memory
+			logtw("%s/%s(%u) - The origin doesn't share the memory, the packets are received over the connection: %s",
+				  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _curr_url->Source().CStr());
+		}
+		else if (_use_datagram)
+		{
+			if (response->GetDatagramPort() == 0)
+			{
+				logtw("%s/%s(%u) - The origin doesn't support the datagram mode, the packets are received over the connection: %s",
+					  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _curr_url->Source().CStr());
+			}
+			else if (StartDatagram(response->GetDatagramPort(), response->GetDatagramToken()) == false)
+			{
+				_state = State::ERROR;
+				return false;
+			}
+		}
 
 		_state = State::PLAYING;
 		return true;
@@ -436,24 +664,15 @@ namespace pvd
 			return false;
 		}
 
-		OvtPacket packet;
-
-		packet.SetSessionId(_session_id);
-		packet.SetPayloadType(OVT_PAYLOAD_TYPE_STOP);
-		packet.SetMarker(0);
-		packet.SetTimestampNow();
-
-		Json::Value root;
-		_last_request_id++;
-		root["id"] = _last_request_id;
-		root["url"] = _curr_url->Source().CStr();
-
-		auto payload = ov::Json::Stringify(root).ToData(false);
-
-		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+		if(_connection != nullptr)
+		{
+			// The other streams keep using the connection, so the response is not waited for
+			_connection->StopSession(_session_id, _curr_url->Source());
+			_channel.reset();
+			return true;
+		}
 
-		auto sent_size = _client_socket.Send(packet.GetData());
-		if(sent_size != static_cast<ssize_t>(packet.GetData()->GetLength()))
+		if(SendRequest(OVT_PAYLOAD_TYPE_STOP, _session_id) == false)
 		{
 			_state = State::ERROR;
 			logte("Could not send Stop message");
@@ -472,38 +691,33 @@ namespace pvd
 		}
 
 		// Parsing Payload
-		ov::String payload((const char *) packet->Payload(), packet->PayloadLength());
-		ov::JsonObject object = ov::Json::Parse(payload);
+		auto response = OvtControlMessage::Parse(std::make_shared<ov::Data>(packet->Payload(), packet->PayloadLength(), true));
 
-		if (object.IsNull())
+		if (response == nullptr)
 		{
 			_state = State::ERROR;
-			logte("An invalid response : Json format");
+			logte("An invalid response : Format");
 			return false;
 		}
 
-		Json::Value &json_id = object.GetJsonValue()["id"];
-		Json::Value &json_code = object.GetJsonValue()["code"];
-		Json::Value &json_message = object.GetJsonValue()["message"];
-
-		if (!json_id.isUInt() || !json_code.isUInt() || json_message.isNull())
+		if (response->IsValidResponse() == false)
 		{
 			_state = State::ERROR;
 			logte("An invalid response : There are no required keys");
 			return false;
 		}
 
-		if (request_id != json_id.asUInt())
+		if (request_id != response->GetId())
 		{
 			_state = State::ERROR;
 			logte("An invalid response : Response ID is wrong.");
 			return false;
 		}
 
-		if (json_code.asUInt() != 200)
+		if (response->GetCode() != 200)
 		{
 			_state = State::ERROR;
-			logte("Stop : Server Failure : %d (%s)", json_code.asUInt(), json_message.asString().c_str());
+			logte("Stop : Server Failure : %d (%s)", response->GetCode(), response->GetMessage().CStr());
 			return false;
 		}
 
@@ -669,13 +883,434 @@ namespace pvd
 		return std::move(_packet_mold);;
 	}
 
+	void OvtStream::AdjustTimestamp(const std::shared_ptr<MediaTrack> &track, const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		auto track_id = track->GetId();
+		// seconds per unit
+		auto timebase = track->GetTimeBase().GetExpr();
+
+		if (timebase <= 0.0)
+		{
+			return;
+		}
+
+		if (_is_timestamp_offset_required)
+		{
+			// The first packet from the new origin continues from the last packet of the track,
+			// and the other tracks are shifted by the same time to keep the A/V sync of the origin
+			auto item = _next_dts_map.find(track_id);
+
+			if (item != _next_dts_map.end())
+			{
+				_timestamp_offset_sec = (item->second - media_packet->GetDts()) * timebase;
+
+				logti("%s/%s(%u) The timestamps of the new origin are shifted by %.3f seconds",
+					  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _timestamp_offset_sec);
+			}
+
+			_is_timestamp_offset_required = false;
+		}
+
+		if (_timestamp_offset_sec != 0.0)
+		{
+			auto offset = static_cast<int64_t>(_timestamp_offset_sec / timebase);
+
+			media_packet->SetPts(media_packet->GetPts() + offset);
+			media_packet->SetDts(media_packet->GetDts() + offset);
+		}
+
+		_next_dts_map[track_id] = media_packet->GetDts() + std::max<int64_t>(media_packet->GetDuration(), 1);
+	}
+
 	int OvtStream::GetFileDescriptorForDetectingEvent()
 	{
+		if(_is_shared_memory_mode)
+		{
+			return _shared_memory_connection;
+		}
+
+		if(_is_datagram_mode)
+		{
+			return _datagram_socket.GetSocket().GetSocket();
+		}
+
+		if(_channel != nullptr)
+		{
+			return _channel->GetEventFd();
+		}
+
 		return _client_socket.GetSocket().GetSocket();
 	}
 
+	bool OvtStream::StartDatagram(uint16_t port, uint32_t token)
+	{
+		ov::SocketAddress address(_curr_url->Domain(), port);
+
+		if ((_datagram_socket.Create(ov::SocketType::Udp) == false) || (_datagram_socket.Connect(address) != nullptr))
+		{
+			logte("%s/%s(%u) - Could not create the datagram socket for %s", GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), address.ToString().CStr());
+			_datagram_socket.Close();
+			return false;
+		}
+
+		_datagram_token = token;
+		_reorder_buffer = std::make_shared<OvtReorderBuffer>(_retransmit_deadline_msec);
+		_is_waiting_for_marker = false;
+		_is_datagram_mode = true;
+
+		// BIND is sent again until the first media packet is received (the datagrams may be lost)
+		auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(OVT_TIMEOUT_MSEC);
+
+		while (std::chrono::steady_clock::now() < timeout)
+		{
+			SendDatagramBind();
+
+			auto bind_timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds(OVT_DATAGRAM_BIND_INTERVAL_MSEC);
+
+			while (std::chrono::steady_clock::now() < bind_timeout)
+			{
+				auto result = ReceiveDatagram();
+
+				if (result == ReceivePacketResult::COMPLETE)
+				{
+					logti("%s/%s(%u) - The media packets are received over UDP from %s",
+						  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), address.ToString().CStr());
+					return true;
+				}
+				else if (result != ReceivePacketResult::IMCOMPLETE)
+				{
+					return false;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		}
+
+		logte("%s/%s(%u) - No media packet has been received over UDP from %s", GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), address.ToString().CStr());
+
+		return false;
+	}
+
+	bool OvtStream::SendDatagramMessage(uint8_t payload_type, const std::shared_ptr<const ov::Data> &payload)
+	{
+		OvtPacket packet;
+
+		packet.SetSessionId(_session_id);
+		packet.SetPayloadType(payload_type);
+		packet.SetMarker(0);
+		packet.SetTimestampNow();
+		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+
+		return _datagram_socket.Send(packet.GetData()) == static_cast<ssize_t>(packet.GetData()->GetLength());
+	}
+
+	void OvtStream::SendDatagramBind()
+	{
+		uint8_t token[sizeof(uint32_t)];
+		ByteWriter<uint32_t>::WriteBigEndian(token, _datagram_token);
+
+		SendDatagramMessage(OVT_PAYLOAD_TYPE_DATAGRAM_BIND, std::make_shared<ov::Data>(token, sizeof(token), true));
+
+		_last_bind_time = std::chrono::steady_clock::now();
+	}
+
+	OvtStream::ReceivePacketResult OvtStream::ReceiveDatagram()
+	{
+		auto buffer = _recv_buffer.GetWritableDataAs<uint8_t>();
+		size_t read_bytes = 0;
+
+		auto error = _datagram_socket.Recv(buffer, _recv_buffer.GetLength(), &read_bytes, true);
+
+		if (read_bytes == 0)
+		{
+			if (error != nullptr)
+			{
+				// ICMP port unreachable is also reported here
+				logte("An error occurred while receiving datagram: %s", error->ToString().CStr());
+				_state = State::ERROR;
+				return ReceivePacketResult::ERROR;
+			}
+
+			return ReceivePacketResult::IMCOMPLETE;
+		}
+
+		auto packet = std::make_shared<OvtPacket>();
+
+		if ((packet->Load(ov::Data(buffer, read_bytes, true)) == false) ||
+			(packet->PayloadType() != OVT_PAYLOAD_TYPE_MEDIA_PACKET) || (packet->SessionId() != _session_id))
+		{
+			// The datagrams that are not for this session are ignored
+			logtd("%s/%s(%u) - An unexpected datagram was received", GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId());
+			return ReceivePacketResult::IMCOMPLETE;
+		}
+
+		// StreamMotor balances the streams by this
+		if (_stream_metrics != nullptr)
+		{
+			_stream_metrics->IncreaseBytesIn(read_bytes);
+		}
+
+		_reorder_buffer->Push(packet);
+
+		return ReceivePacketResult::COMPLETE;
+	}
+
+	Stream::ProcessMediaResult OvtStream::ProcessDatagram()
+	{
+		// Reads all the datagrams in the socket buffer, and they are reordered
+		while (true)
+		{
+			auto result = ReceiveDatagram();
+
+			if (result == ReceivePacketResult::IMCOMPLETE)
+			{
+				break;
+			}
+			else if (result != ReceivePacketResult::COMPLETE)
+			{
+				return ProcessMediaResult::PROCESS_MEDIA_FAILURE;
+			}
+		}
+
+		auto nack_list = _reorder_buffer->GetNackList();
+
+		if (nack_list.empty() == false)
+		{
+			SendDatagramMessage(OVT_PAYLOAD_TYPE_NACK, OvtNack::Serialize(_datagram_token, nack_list));
+		}
+
+		// Keeps the NAT binding
+		if ((std::chrono::steady_clock::now() - _last_bind_time) >= std::chrono::milliseconds(OVT_DATAGRAM_KEEPALIVE_INTERVAL_MSEC))
+		{
+			SendDatagramBind();
+		}
+
+		bool is_discontinuous = false;
+		std::shared_ptr<OvtPacket> packet;
+
+		while ((packet = _reorder_buffer->Pop(&is_discontinuous)) != nullptr)
+		{
+			if (is_discontinuous)
+			{
+				// The frame that has the lost packets cannot be restored, so it is dropped with the partial data of the depacketizer.
+				// It is not known whether the packet after the loss starts a new frame, so the packets are dropped until the next marker.
+				_depacketizer = std::make_shared<OvtDepacketizer>();
+				_is_waiting_for_marker = true;
+			}
+
+			if (_is_waiting_for_marker)
+			{
+				_is_waiting_for_marker = (packet->Marker() == false);
+				continue;
+			}
+
+			ProcessOvtMediaPacket(packet);
+		}
+
+		return ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
+	}
+
+	Stream::ProcessMediaResult OvtStream::ProcessChannel()
+	{
+		// A limited number of packets are processed at once, so the other streams of the StreamMotor are not starved by a busy stream
+		bool is_closed = false;
+		auto packets = _channel->Pop(OVT_CHANNEL_MAX_PACKETS_PER_PROCESS, &is_closed);
+
+		for (auto &packet : packets)
+		{
+			// StreamMotor balances the streams by this
+			if (_stream_metrics != nullptr)
+			{
+				_stream_metrics->IncreaseBytesIn(packet->PayloadLength());
+			}
+
+			ProcessOvtMediaPacket(packet);
+		}
+
+		if (is_closed)
+		{
+			logte("%s/%s(%u) - The session has been closed by the connection: %s",
+				  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _connection->ToString().CStr());
+			_state = State::ERROR;
+			return ProcessMediaResult::PROCESS_MEDIA_FAILURE;
+		}
+
+		return packets.empty() ? ProcessMediaResult::PROCESS_MEDIA_TRY_AGAIN : ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
+	}
+
+	bool OvtStream::StartSharedMemory(const ov::String &path, uint32_t token)
+	{
+		int connection = -1;
+		auto ring = OvtSharedMemoryServer::Attach(path, token, &connection);
+
+		if (ring == nullptr)
+		{
+			logte("%s/%s(%u) - Could not attach the shared memory of the origin: %s", GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), path.CStr());
+			return false;
+		}
+
+		_shared_memory_connection = connection;
+		_shared_memory_ring = ring;
+		// The frames before the latest key frame are not needed
+		_shared_memory_sequence = ring->GetStartSequence();
+		_tracks_waiting_for_key_frame.clear();
+
+		for (const auto &item : GetTracks())
+		{
+			if (item.second->GetMediaType() == common::MediaType::Video)
+			{
+				_tracks_waiting_for_key_frame.insert(item.first);
+			}
+		}
+
+		_is_shared_memory_mode = true;
+
+		logti("%s/%s(%u) - The frames are read from the shared memory of the origin: %s",
+			  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), path.CStr());
+
+		return true;
+	}
+
+	void OvtStream::StopSharedMemory()
+	{
+		if (_shared_memory_connection != -1)
+		{
+			// The origin stops sharing the frames with the session when the connection is closed
+			::close(_shared_memory_connection);
+			_shared_memory_connection = -1;
+		}
+
+		_shared_memory_ring.reset();
+		_is_shared_memory_mode = false;
+	}
+
+	Stream::ProcessMediaResult OvtStream::ProcessSharedMemory()
+	{
+		// The notifications are coalesced, the frames are read from the sequence regardless of the number of them
+		uint8_t buffer[256];
+
+		while (true)
+		{
+			auto read_bytes = ::recv(_shared_memory_connection, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+			if (read_bytes > 0)
+			{
+				continue;
+			}
+
+			if ((read_bytes == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+			{
+				logte("%s/%s(%u) - The session of the shared memory has been closed by the origin: %s",
+					  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _curr_url->Source().CStr());
+				_state = State::ERROR;
+				return ProcessMediaResult::PROCESS_MEDIA_FAILURE;
+			}
+
+			break;
+		}
+
+		// A limited number of frames are read at once, so the other streams of the StreamMotor are not starved by a busy stream
+		for (int count = 0; count < OVT_CHANNEL_MAX_PACKETS_PER_PROCESS; count++)
+		{
+			std::shared_ptr<MediaPacket> media_packet;
+			auto result = _shared_memory_ring->Read(&_shared_memory_sequence, &media_packet);
+
+			if (result == OvtSharedMemoryRing::ReadResult::Empty)
+			{
+				return ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
+			}
+
+			if (result == OvtSharedMemoryRing::ReadResult::Lost)
+			{
+				logtw("%s/%s(%u) - The frames of the shared memory have been overwritten before they are read, resumes from the key frame",
+					  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId());
+
+				for (const auto &item : GetTracks())
+				{
+					if (item.second->GetMediaType() == common::MediaType::Video)
+					{
+						_tracks_waiting_for_key_frame.insert(item.first);
+					}
+				}
+
+				continue;
+			}
+
+			auto track_id = media_packet->GetTrackId();
+
+			if (_tracks_waiting_for_key_frame.find(track_id) != _tracks_waiting_for_key_frame.end())
+			{
+				if (media_packet->GetFlag() != MediaPacketFlag::Key)
+				{
+					continue;
+				}
+
+				_tracks_waiting_for_key_frame.erase(track_id);
+			}
+
+			// StreamMotor balances the streams by this
+			if (_stream_metrics != nullptr)
+			{
+				_stream_metrics->IncreaseBytesIn(media_packet->GetData()->GetLength());
+			}
+
+			SendMediaPacket(media_packet);
+		}
+
+		// The rest are read when the next frame is notified (64 frames are read for every frame written, so the stream catches up soon)
+		return ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
+	}
+
+	void OvtStream::ProcessOvtMediaPacket(const std::shared_ptr<OvtPacket> &packet)
+	{
+		_depacketizer->AppendPacket(packet);
+
+		if (_depacketizer->IsAvaliableMediaPacket())
+		{
+			auto media_packet = _depacketizer->PopMediaPacket();
+
+			SendMediaPacket(media_packet);
+		}
+	}
+
+	void OvtStream::SendMediaPacket(const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		auto track = GetTrack(media_packet->GetTrackId());
+		if(track == nullptr)
+		{
+			logtw("%s/%s(%u) - Unknown track: %d", GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), media_packet->GetTrackId());
+			return;
+		}
+
+		AdjustTimestamp(track, media_packet);
+
+		// Make Header (Fragmentation) if it is H.264
+		if(track->GetCodecId() == common::MediaCodecId::H264)
+		{
+			AvcVideoPacketFragmentizer fragmentizer;
+			fragmentizer.MakeHeader(media_packet);
+		}
+
+		_application->SendFrame(GetSharedPtrAs<info::Stream>(), media_packet);
+	}
+
 	Stream::ProcessMediaResult OvtStream::ProcessMediaPacket()
 	{
+		if(_is_shared_memory_mode)
+		{
+			return ProcessSharedMemory();
+		}
+
+		if(_is_datagram_mode)
+		{
+			return ProcessDatagram();
+		}
+
+		if(_channel != nullptr)
+		{
+			return ProcessChannel();
+		}
+
 		// Non block
 		auto result = ProceedToReceivePacket(true);
 		std::shared_ptr<OvtPacket> packet = nullptr;
@@ -722,22 +1357,13 @@ namespace pvd
 
 		if(packet->PayloadType() == OVT_PAYLOAD_TYPE_MEDIA_PACKET)
 		{
-			_depacketizer.AppendPacket(packet);
-
-			if (_depacketizer.IsAvaliableMediaPacket())
+			// StreamMotor balances the streams by this
+			if(_stream_metrics != nullptr)
 			{
-				auto media_packet = _depacketizer.PopMediaPacket();
-
-				// Make Header (Fragmentation) if it is H.264
-				auto track = GetTrack(media_packet->GetTrackId());
-				if(track->GetCodecId() == common::MediaCodecId::H264)
-				{
-					AvcVideoPacketFragmentizer fragmentizer;
-					fragmentizer.MakeHeader(media_packet);
-				}
-
-				_application->SendFrame(GetSharedPtrAs<info::Stream>(), media_packet);
+				_stream_metrics->IncreaseBytesIn(packet->PayloadLength());
 			}
+
+			ProcessOvtMediaPacket(packet);
 		}
 		else
 		{
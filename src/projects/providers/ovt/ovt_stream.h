@@ -11,10 +11,15 @@
 #include <base/ovlibrary/semaphore.h>
 #include <base/provider/application.h>
 #include <modules/ovt_packetizer/ovt_packet.h>
+#include <modules/ovt_packetizer/ovt_control_message.h>
 #include <modules/ovt_packetizer/ovt_depacketizer.h>
+#include <modules/ovt_packetizer/ovt_datagram.h>
+#include <modules/ovt_packetizer/ovt_shared_memory.h>
 
 #include <monitoring/monitoring.h>
 
+#include "ovt_connection.h"
+
 #define OVT_TIMEOUT_MSEC		3000
 namespace pvd
 {
@@ -32,6 +37,9 @@ namespace pvd
 		// Media data has to be processed here.
 		Stream::ProcessMediaResult ProcessMediaPacket() override;
 
+		// Connects to the other origins in the order of the URL list, and plays the same stream
+		bool Failover() override;
+
 	private:
 
 		enum class ReceivePacketResult : uint8_t
@@ -47,14 +55,54 @@ namespace pvd
 		bool Start() override;
 		bool Play() override;
 		bool Stop() override;
+		// Connects to the origin of the url and describes the stream, the result is reported to the Orchestrator
+		bool ConnectAndDescribe(const std::shared_ptr<const ov::Url> &url);
+		// Closes the connection to the current origin
+		void DisconnectOrigin();
 		bool ConnectOrigin();
+		// Sends the request in _control_format with a new request id (_last_request_id)
+		bool SendRequest(uint8_t payload_type, uint32_t session_id, OvtControlMessage::Transport transport = OvtControlMessage::Transport::Connection);
 		bool RequestDescribe();
 		bool ReceiveDescribe(uint32_t request_id);
+		bool ProcessDescribeResponse(const std::shared_ptr<OvtControlMessage> &response, uint32_t request_id);
 		bool RequestPlay();
 		bool ReceivePlay(uint32_t request_id);
+		bool ProcessPlayResponse(const std::shared_ptr<OvtControlMessage> &response, uint32_t request_id, uint32_t session_id);
 		bool RequestStop();
 		bool ReceiveStop(uint32_t request_id, const std::shared_ptr<OvtPacket> &packet);
 
+		// The tracks of the origin must be the same as the tracks of the stream after failover
+		bool IsSameTracks(const std::vector<std::shared_ptr<MediaTrack>> &tracks) const;
+		// Makes the timestamps of the new origin continue from the last packet after failover
+		void AdjustTimestamp(const std::shared_ptr<MediaTrack> &track, const std::shared_ptr<MediaPacket> &media_packet);
+
+		// Datagram mode (See OVT_PAYLOAD_TYPE_DATAGRAM_BIND)
+		// Binds the UDP socket to the session, and waits for the first media packet
+		bool StartDatagram(uint16_t port, uint32_t token);
+		bool SendDatagramMessage(uint8_t payload_type, const std::shared_ptr<const ov::Data> &payload);
+		void SendDatagramBind();
+		// Receives a datagram into the reorder buffer (IMCOMPLETE: no datagram)
+		ReceivePacketResult ReceiveDatagram();
+		ProcessMediaResult ProcessDatagram();
+
+		// Multiplexing mode (See <Providers><OVT><MultiplexConnections>)
+		// Processes the packets that are routed to the channel by the shared connection
+		ProcessMediaResult ProcessChannel();
+
+		// Shared memory mode (See OvtSharedMemoryRing)
+		// Receives the ring of the session from the origin on the same host
+		bool StartSharedMemory(const ov::String &path, uint32_t token);
+		void StopSharedMemory();
+		// Reads the frames that are written to the ring since the last call
+		ProcessMediaResult ProcessSharedMemory();
+
+		// The transport that is requested with PLAY
+		OvtControlMessage::Transport GetPlayTransport() const;
+
+		// Depacketizes the media packet and sends the frame to the application
+		void ProcessOvtMediaPacket(const std::shared_ptr<OvtPacket> &packet);
+		void SendMediaPacket(const std::shared_ptr<MediaPacket> &media_packet);
+
 		void ResetRecvBuffer();
 		ReceivePacketResult ProceedToReceivePacket(bool non_block = false);
 		std::shared_ptr<OvtPacket> GetPacket();
@@ -65,6 +113,8 @@ namespace pvd
 
 		std::vector<std::shared_ptr<const ov::Url>> _url_list;
 		std::shared_ptr<const ov::Url>				_curr_url;
+		// Reported to the Orchestrator as connected, it is reported as disconnected when the connection is closed
+		bool _is_origin_connected = false;
 
 		ov::Socket _client_socket;
 		ov::Data _recv_buffer;
@@ -72,12 +122,51 @@ namespace pvd
 		std::shared_ptr<OvtPacket> _packet_mold;
 
 		uint32_t _last_request_id;
+		// The format of the control messages, it is negotiated with the first DESCRIBE of the connection
+		OvtControlMessage::Format _control_format = OvtControlMessage::Format::Binary;
 		uint32_t _session_id;
 
 		double _origin_request_time_msec = 0;
 		double _origin_response_time_msec = 0;
 
-		OvtDepacketizer _depacketizer;
+		std::shared_ptr<OvtDepacketizer> _depacketizer;
+
+		// The timestamps of the origins are not the same, so the packets from the new origin are shifted by this
+		double _timestamp_offset_sec = 0.0;
+		bool _is_timestamp_offset_required = false;
+		// key: track id, value: dts + duration of the last packet sent to the application
+		std::map<int32_t, int64_t> _next_dts_map;
 		std::shared_ptr<mon::StreamMetrics> _stream_metrics;
+
+		// <Providers><OVT><Datagram>
+		bool _use_datagram = false;
+		int _retransmit_deadline_msec = OVT_DATAGRAM_DEFAULT_DEADLINE_MSEC;
+		// true if the origin sends the media packets over UDP
+		bool _is_datagram_mode = false;
+		uint32_t _datagram_token = 0;
+		ov::Socket _datagram_socket;
+		std::shared_ptr<OvtReorderBuffer> _reorder_buffer;
+		std::chrono::steady_clock::time_point _last_bind_time;
+		// The packets are dropped until the end of the frame after a loss
+		bool _is_waiting_for_marker = false;
+
+		// <Providers><OVT><MultiplexConnections>
+		int _multiplex_connection_count = 0;
+		// The connection shared with the other streams pulled from the origin (nullptr if it is not used)
+		std::shared_ptr<OvtConnection> _connection;
+		// The packets of the session that are received over _connection
+		std::shared_ptr<OvtChannel> _channel;
+
+		// <Providers><OVT><SharedMemory>
+		bool _use_shared_memory = false;
+		// true if the frames are read from the ring of the origin on the same host
+		bool _is_shared_memory_mode = false;
+		// Readable when the origin writes frames to the ring, and closed when the session of the origin is ended
+		int _shared_memory_connection = -1;
+		std::shared_ptr<OvtSharedMemoryRing> _shared_memory_ring;
+		// The sequence of the next frame to read
+		uint64_t _shared_memory_sequence = 0;
+		// The video tracks that wait for a key frame after the frames are lost
+		std::set<int32_t> _tracks_waiting_for_key_frame;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,338 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "ovt_subscription.h"
+
+#include <poll.h>
+
+#define OV_LOG_TAG "OvtSubscription"
+
+// The stop flag is checked at this interval while waiting for the notifications
+#define OVT_SUBSCRIPTION_POLL_INTERVAL_MSEC 100
+#define OVT_SUBSCRIPTION_CONNECT_TIMEOUT_MSEC 1000
+
+namespace pvd
+{
+	OvtSubscription::OvtSubscription(const Orchestrator::SubscribedOrigin &origin)
+		: _origin(origin)
+	{
+		for (auto &stream_name : _origin.stream_name_list)
+		{
+			_stream_name_patterns.emplace_back(stream_name);
+		}
+	}
+
+	OvtSubscription::~OvtSubscription()
+	{
+		Stop();
+	}
+
+	bool OvtSubscription::Start()
+	{
+		if (_stop_thread_flag == false)
+		{
+			return true;
+		}
+
+		_stop_thread_flag = false;
+		_thread = std::thread(&OvtSubscription::SubscriptionThread, this);
+
+		return true;
+	}
+
+	void OvtSubscription::Stop()
+	{
+		if (_stop_thread_flag)
+		{
+			return;
+		}
+
+		_stop_thread_flag = true;
+
+		if (_thread.joinable())
+		{
+			_thread.join();
+		}
+	}
+
+	void OvtSubscription::SubscriptionThread()
+	{
+		while (_stop_thread_flag == false)
+		{
+			// The origins that are failing are tried last
+			auto url_list = Orchestrator::GetInstance()->GetOriginHealthTable().Sort(_origin.vhost_app_name, _origin.url_list, OriginBalance::Order);
+
+			for (const auto &url : url_list)
+			{
+				if (_stop_thread_flag)
+				{
+					break;
+				}
+
+				if (Subscribe(url) == false)
+				{
+					_socket.Close();
+					continue;
+				}
+
+				logti("Subscribed to the streams of %s for %s", url.CStr(), _origin.vhost_app_name.CStr());
+
+				auto &stream_directory = Orchestrator::GetInstance()->GetStreamDirectory();
+
+				if (_origin.is_directory_enabled)
+				{
+					// The origin sends the current streams first, and then the changes
+					stream_directory.OnSubscribed(_origin.vhost_app_name, url);
+				}
+
+				uint8_t payload_type = 0;
+				std::shared_ptr<OvtControlMessage> message;
+
+				while ((message = ReceiveMessage(&payload_type)) != nullptr)
+				{
+					if (payload_type == OVT_PAYLOAD_TYPE_NOTIFY)
+					{
+						HandleNotification(url, message);
+					}
+				}
+
+				_socket.Close();
+
+				if (_origin.is_directory_enabled)
+				{
+					// The streams may be created/deleted while the subscription is broken
+					stream_directory.OnUnsubscribed(_origin.vhost_app_name, url);
+				}
+
+				if (_stop_thread_flag == false)
+				{
+					logtw("The subscription to %s is broken, subscribing again", url.CStr());
+				}
+
+				break;
+			}
+
+			for (int elapsed = 0; (elapsed < OVT_SUBSCRIPTION_RETRY_INTERVAL_MSEC) && (_stop_thread_flag == false); elapsed += OVT_SUBSCRIPTION_POLL_INTERVAL_MSEC)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(OVT_SUBSCRIPTION_POLL_INTERVAL_MSEC));
+			}
+		}
+
+		_socket.Close();
+	}
+
+	bool OvtSubscription::Subscribe(const ov::String &url)
+	{
+		auto parsed_url = ov::Url::Parse(url.CStr());
+
+		if (parsed_url == nullptr)
+		{
+			return false;
+		}
+
+		if (_socket.Create(ov::SocketType::Tcp) == false)
+		{
+			logte("Could not create the socket to subscribe to %s", url.CStr());
+			return false;
+		}
+
+		auto error = _socket.Connect(ov::SocketAddress(parsed_url->Domain(), parsed_url->Port()), OVT_SUBSCRIPTION_CONNECT_TIMEOUT_MSEC);
+
+		if (error != nullptr)
+		{
+			logtd("Could not connect to %s to subscribe: %s", url.CStr(), error->GetMessage().CStr());
+			return false;
+		}
+
+		// The origins that support SUBSCRIBE support the binary format
+		_last_request_id++;
+		auto payload = OvtControlMessage::SerializeRequest(OvtControlMessage::Format::Binary, _last_request_id, url);
+
+		if (payload == nullptr)
+		{
+			return false;
+		}
+
+		OvtPacket packet;
+
+		packet.SetSessionId(0);
+		packet.SetPayloadType(OVT_PAYLOAD_TYPE_SUBSCRIBE);
+		packet.SetMarker(1);
+		packet.SetTimestampNow();
+		packet.SetPayload(payload->GetDataAs<uint8_t>(), payload->GetLength());
+
+		if (_socket.Send(packet.GetData()) != static_cast<ssize_t>(packet.GetData()->GetLength()))
+		{
+			return false;
+		}
+
+		uint8_t payload_type = 0;
+		auto response = ReceiveMessage(&payload_type);
+
+		if ((response == nullptr) || (response->IsValidResponse() == false) || (response->GetId() != _last_request_id))
+		{
+			logtw("Could not subscribe to %s: Invalid response (The origin may not support SUBSCRIBE)", url.CStr());
+			return false;
+		}
+
+		if ((payload_type != OVT_PAYLOAD_TYPE_SUBSCRIBE) || (response->GetCode() != 200))
+		{
+			logtw("Could not subscribe to %s: %u (%s)", url.CStr(), response->GetCode(), response->GetMessage().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	std::shared_ptr<OvtControlMessage> OvtSubscription::ReceiveMessage(uint8_t *payload_type)
+	{
+		auto payload = std::make_shared<ov::Data>();
+		uint8_t header_buffer[OVT_FIXED_HEADER_SIZE];
+
+		while (true)
+		{
+			OvtPacket packet;
+
+			if ((ReceiveBytes(header_buffer, sizeof(header_buffer)) == false) ||
+				(packet.LoadHeader(ov::Data(header_buffer, sizeof(header_buffer), true)) == false))
+			{
+				return nullptr;
+			}
+
+			auto offset = payload->GetLength();
+			payload->SetLength(offset + packet.PayloadLength());
+
+			if ((packet.PayloadLength() > 0) && (ReceiveBytes(payload->GetWritableDataAs<uint8_t>() + offset, packet.PayloadLength()) == false))
+			{
+				return nullptr;
+			}
+
+			if (packet.Marker())
+			{
+				*payload_type = packet.PayloadType();
+				break;
+			}
+		}
+
+		return OvtControlMessage::Parse(payload);
+	}
+
+	bool OvtSubscription::ReceiveBytes(uint8_t *buffer, size_t length)
+	{
+		size_t offset = 0;
+
+		while (offset < length)
+		{
+			if (_stop_thread_flag)
+			{
+				return false;
+			}
+
+			// The notifications may not come for a long time, so it is waited with a timeout to check the stop flag
+			struct pollfd poll_fd = {_socket.GetSocket().GetSocket(), POLLIN, 0};
+			auto result = ::poll(&poll_fd, 1, OVT_SUBSCRIPTION_POLL_INTERVAL_MSEC);
+
+			if (result == 0)
+			{
+				continue;
+			}
+			else if (result < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				return false;
+			}
+
+			size_t read_bytes = 0;
+			auto error = _socket.Recv(buffer + offset, length - offset, &read_bytes, true);
+
+			if (read_bytes == 0)
+			{
+				// The socket is readable but there is no data: the connection is closed
+				if (error != nullptr)
+				{
+					logtd("Could not receive the notification: %s", error->ToString().CStr());
+				}
+
+				return false;
+			}
+
+			offset += read_bytes;
+		}
+
+		return true;
+	}
+
+	void OvtSubscription::HandleNotification(const ov::String &url, const std::shared_ptr<OvtControlMessage> &message)
+	{
+		if (message->HasStream() == false)
+		{
+			return;
+		}
+
+		auto &stream_name = message->GetStreamName();
+		auto is_created = (message->GetStreamEvent() == OvtControlMessage::StreamEvent::Created);
+
+		if (_origin.is_directory_enabled)
+		{
+			auto &stream_directory = Orchestrator::GetInstance()->GetStreamDirectory();
+
+			if (is_created)
+			{
+				stream_directory.Register(_origin.vhost_app_name, stream_name, url);
+			}
+			else
+			{
+				stream_directory.Unregister(_origin.vhost_app_name, stream_name, url);
+			}
+		}
+
+		if ((_origin.is_prewarm_enabled == false) || (is_created == false))
+		{
+			// The pulled stream is stopped by itself when the origin deletes the stream
+			return;
+		}
+
+		if (IsMatched(stream_name) == false)
+		{
+			logtd("%s/%s is created in the origin, but it is not prewarmed", _origin.vhost_app_name.CStr(), stream_name.CStr());
+			return;
+		}
+
+		logti("Prewarming %s/%s, it is created in the origin", _origin.vhost_app_name.CStr(), stream_name.CStr());
+
+		// If the stream is already pulled (or being pulled by a viewer), the request is joined to it
+		auto vhost_app_name = _origin.vhost_app_name;
+		Orchestrator::GetInstance()->RequestPullStreamAsync(vhost_app_name, stream_name, 0, [vhost_app_name, stream_name](bool result) {
+			if (result == false)
+			{
+				logtw("Could not prewarm %s/%s", vhost_app_name.CStr(), stream_name.CStr());
+			}
+		});
+	}
+
+	bool OvtSubscription::IsMatched(const ov::String &stream_name) const
+	{
+		if (_stream_name_patterns.empty())
+		{
+			return true;
+		}
+
+		for (auto &pattern : _stream_name_patterns)
+		{
+			if (pattern.IsMatched(stream_name))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}  // namespace pvd
@@ -0,0 +1,63 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/ovsocket/socket.h>
+#include <modules/ovt_packetizer/ovt_control_message.h>
+#include <modules/ovt_packetizer/ovt_packet.h>
+#include <orchestrator/orchestrator.h>
+
+#include <atomic>
+#include <thread>
+
+// The subscription is connected again after this time when the connection is broken
+#define OVT_SUBSCRIPTION_RETRY_INTERVAL_MSEC 1000
+
+namespace pvd
+{
+	// Subscribes to an application of the origin (See OVT_PAYLOAD_TYPE_SUBSCRIBE) for an <Origin> that has <Prewarm> or <Directory>
+	//
+	// <Prewarm>: The streams of the application are pulled as soon as the origin creates them.
+	// The first viewer of the edge doesn't wait for connecting to the origin, describing and the first key frame.
+	// <Directory>: The streams that the origin creates/deletes are registered/unregistered to the StreamDirectory.
+	class OvtSubscription
+	{
+	public:
+		explicit OvtSubscription(const Orchestrator::SubscribedOrigin &origin);
+		~OvtSubscription();
+
+		bool Start();
+		void Stop();
+
+		const Orchestrator::SubscribedOrigin &GetOrigin() const
+		{
+			return _origin;
+		}
+
+	private:
+		void SubscriptionThread();
+
+		bool Subscribe(const ov::String &url);
+		// Returns nullptr if the connection is broken or the subscription is stopped
+		std::shared_ptr<OvtControlMessage> ReceiveMessage(uint8_t *payload_type);
+		bool ReceiveBytes(uint8_t *buffer, size_t length);
+
+		void HandleNotification(const ov::String &url, const std::shared_ptr<OvtControlMessage> &message);
+		bool IsMatched(const ov::String &stream_name) const;
+
+		Orchestrator::SubscribedOrigin _origin;
+		std::vector<DomainPattern> _stream_name_patterns;
+
+		ov::Socket _socket;
+		uint32_t _last_request_id = 0;
+
+		std::atomic<bool> _stop_thread_flag{true};
+		std::thread _thread;
+	};
+}  // namespace pvd
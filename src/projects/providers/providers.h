@@ -9,6 +9,9 @@
 #pragma once
 
 #include "./ovt/ovt_provider.h"
+#include "./replay/replay_provider.h"
 #include "./rtmp/rtmp_provider.h"
 #include "./rtsp/rtsp_provider.h"
-#include "./rtspc/rtspc_provider.h"
\ No newline at end of file
+#include "./rtspc/rtspc_provider.h"
+#include "./srt/srt_provider.h"
+#include "./webrtc/webrtc_provider.h"
\ No newline at end of file
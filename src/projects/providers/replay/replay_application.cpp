@@ -0,0 +1,35 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "replay_application.h"
+
+#include "replay_stream.h"
+
+#define OV_LOG_TAG "ReplayApplication"
+
+namespace pvd
+{
+	std::shared_ptr<ReplayApplication> ReplayApplication::Create(const std::shared_ptr<Provider> &provider, const info::Application &application_info)
+	{
+		auto application = std::make_shared<ReplayApplication>(provider, application_info);
+
+		application->Start();
+
+		return application;
+	}
+
+	ReplayApplication::ReplayApplication(const std::shared_ptr<Provider> &provider, const info::Application &info)
+		: Application(provider, info)
+	{
+	}
+
+	std::shared_ptr<pvd::Stream> ReplayApplication::CreatePullStream(const uint32_t stream_id, const ov::String &stream_name, const std::vector<ov::String> &url_list)
+	{
+		return ReplayStream::Create(GetSharedPtrAs<pvd::Application>(), stream_id, stream_name, url_list);
+	}
+}  // namespace pvd
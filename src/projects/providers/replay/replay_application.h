@@ -0,0 +1,36 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/provider/application.h>
+#include <base/provider/stream.h>
+
+namespace pvd
+{
+	class ReplayApplication : public pvd::Application
+	{
+	public:
+		static std::shared_ptr<ReplayApplication> Create(const std::shared_ptr<Provider> &provider, const info::Application &application_info);
+
+		explicit ReplayApplication(const std::shared_ptr<Provider> &provider, const info::Application &info);
+		~ReplayApplication() override = default;
+
+		std::shared_ptr<pvd::Stream> CreatePullStream(const uint32_t stream_id, const ov::String &stream_name, const std::vector<ov::String> &url_list) override;
+		std::shared_ptr<pvd::Stream> CreatePushStream(const uint32_t stream_id, const ov::String &stream_name) override
+		{
+			return nullptr;
+		}
+
+		MediaRouteApplicationConnector::ConnectorType GetConnectorType() override
+		{
+			return MediaRouteApplicationConnector::ConnectorType::Provider;
+		}
+	};
+}  // namespace pvd
@@ -0,0 +1,51 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "replay_provider.h"
+
+#include "replay_application.h"
+
+#define OV_LOG_TAG "ReplayProvider"
+
+namespace pvd
+{
+	std::shared_ptr<ReplayProvider> ReplayProvider::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+	{
+		auto provider = std::make_shared<ReplayProvider>(server_config, router);
+
+		if (provider->Start() == false)
+		{
+			logte("An error occurred while creating ReplayProvider");
+			return nullptr;
+		}
+
+		return provider;
+	}
+
+	ReplayProvider::ReplayProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+		: Provider(server_config, router)
+	{
+		logtd("Created Replay Provider module.");
+	}
+
+	ReplayProvider::~ReplayProvider()
+	{
+		Stop();
+		logtd("Terminated Replay Provider module.");
+	}
+
+	std::shared_ptr<pvd::Application> ReplayProvider::OnCreateProviderApplication(const info::Application &app_info)
+	{
+		return ReplayApplication::Create(GetSharedPtrAs<pvd::Provider>(), app_info);
+	}
+
+	bool ReplayProvider::OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application)
+	{
+		return true;
+	}
+}  // namespace pvd
@@ -0,0 +1,49 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/provider/application.h>
+#include <base/provider/provider.h>
+
+namespace pvd
+{
+	// Replays the capture files of <Server><Performance><Capture> through the MediaRouter, the transcoder and the publishers
+	// (replay://<any host>/<file name>, See ReplayStream)
+	//
+	// A captured ingest (with the odd encoder that caused a problem) is reproduced offline, and the CPU usage, the latency
+	// and the allocations of the pipeline are compared between the versions with the metrics.
+	class ReplayProvider : public pvd::Provider
+	{
+	public:
+		static std::shared_ptr<ReplayProvider> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+
+		explicit ReplayProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+		~ReplayProvider() override;
+
+		ProviderStreamDirection GetProviderStreamDirection() const override
+		{
+			return ProviderStreamDirection::Pull;
+		}
+
+		ProviderType GetProviderType() const override
+		{
+			return ProviderType::Replay;
+		}
+
+		const char *GetProviderName() const override
+		{
+			return "ReplayProvider";
+		}
+
+	protected:
+		std::shared_ptr<pvd::Application> OnCreateProviderApplication(const info::Application &app_info) override;
+		bool OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application) override;
+	};
+}  // namespace pvd
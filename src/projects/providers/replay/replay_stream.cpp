@@ -0,0 +1,343 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "replay_stream.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "replay_application.h"
+
+#define OV_LOG_TAG "ReplayStream"
+
+namespace pvd
+{
+	std::shared_ptr<ReplayStream> ReplayStream::Create(const std::shared_ptr<pvd::Application> &application,
+													   const uint32_t stream_id, const ov::String &stream_name,
+													   const std::vector<ov::String> &url_list)
+	{
+		info::Stream stream_info(*std::static_pointer_cast<info::Application>(application), StreamSourceType::Replay);
+
+		stream_info.SetId(stream_id);
+		stream_info.SetName(stream_name);
+
+		auto stream = std::make_shared<ReplayStream>(application, stream_info, url_list);
+		if (!stream->Start())
+		{
+			// Explicit deletion
+			stream.reset();
+			return nullptr;
+		}
+
+		return stream;
+	}
+
+	ReplayStream::ReplayStream(const std::shared_ptr<pvd::Application> &application, const info::Stream &stream_info, const std::vector<ov::String> &url_list)
+		: pvd::Stream(application, stream_info),
+		  _url_list(url_list)
+	{
+		_state = State::IDLE;
+	}
+
+	ReplayStream::~ReplayStream()
+	{
+		Stop();
+
+		if (_timer_fd != -1)
+		{
+			::close(_timer_fd);
+			_timer_fd = -1;
+		}
+	}
+
+	bool ReplayStream::ParseUrl(const ov::String &url)
+	{
+		auto parsed_url = ov::Url::Parse(url.CStr(), true);
+
+		if (parsed_url == nullptr)
+		{
+			logte("Invalid URL: %s", url.CStr());
+			return false;
+		}
+
+		ov::String file_name = parsed_url->Path();
+
+		if (file_name.HasPrefix("/"))
+		{
+			file_name = file_name.Substring(1);
+		}
+
+		ov::String file_path;
+
+		if (MediaCapture::ResolveFilePath(file_name, &file_path) == false)
+		{
+			logte("Could not resolve the capture file of %s (Is <Server><Performance><Capture><Path> configured?)", url.CStr());
+			return false;
+		}
+
+		const auto &query_map = parsed_url->QueryMap();
+
+		auto speed = query_map.find("speed");
+		if (speed != query_map.end())
+		{
+			if (speed->second.LowerCaseString() == "max")
+			{
+				_speed = 0.0;
+			}
+			else
+			{
+				_speed = ov::Converter::ToDouble(speed->second);
+
+				if (_speed <= 0.0)
+				{
+					logte("Invalid speed: %s (%s)", speed->second.CStr(), url.CStr());
+					return false;
+				}
+			}
+		}
+
+		auto loop = query_map.find("loop");
+		if (loop != query_map.end())
+		{
+			_loop_count = ov::Converter::ToUInt32(loop->second);
+		}
+
+		_reader = MediaCaptureReader::Open(file_path);
+
+		if (_reader == nullptr)
+		{
+			logte("Could not open the capture file: %s", file_path.CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	bool ReplayStream::Start()
+	{
+		if (_url_list.empty())
+		{
+			logte("There is no URL to replay: %s/%s", GetApplicationInfo().GetName().CStr(), GetName().CStr());
+			return false;
+		}
+
+		if (ParseUrl(_url_list[0]) == false)
+		{
+			_state = State::ERROR;
+			return false;
+		}
+
+		for (const auto &track : _reader->GetTracks())
+		{
+			AddTrack(track);
+		}
+
+		logti("%s/%s(%u) will replay %s (speed: %s, loop: %u)",
+			  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), _url_list[0].CStr(),
+			  (_speed > 0.0) ? ov::String::FormatString("%.2f", _speed).CStr() : "max", _loop_count);
+
+		_state = State::DESCRIBED;
+
+		return pvd::Stream::Start();
+	}
+
+	bool ReplayStream::Play()
+	{
+		_timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+		if (_timer_fd == -1)
+		{
+			logte("Could not create a timer: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			_state = State::ERROR;
+			return false;
+		}
+
+		_has_next_record = ReadNextRecord();
+		_play_start_time = std::chrono::steady_clock::now();
+
+		// With speed=max the timer is never read after it expires, so the descriptor stays readable
+		if (ArmTimer(_play_start_time) == false)
+		{
+			_state = State::ERROR;
+			return false;
+		}
+
+		_state = State::PLAYING;
+
+		return pvd::Stream::Play();
+	}
+
+	bool ReplayStream::Stop()
+	{
+		if (_state != State::PLAYING)
+		{
+			return true;
+		}
+
+		_state = State::STOPPING;
+
+		return pvd::Stream::Stop();
+	}
+
+	int ReplayStream::GetFileDescriptorForDetectingEvent()
+	{
+		return _timer_fd;
+	}
+
+	bool ReplayStream::ArmTimer(const std::chrono::steady_clock::time_point &due_time)
+	{
+		// steady_clock is CLOCK_MONOTONIC
+		auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(due_time.time_since_epoch()).count();
+
+		struct itimerspec timer_spec = {};
+		timer_spec.it_value.tv_sec = nsec / 1000000000LL;
+		timer_spec.it_value.tv_nsec = nsec % 1000000000LL;
+
+		if (timer_spec.it_value.tv_sec == 0 && timer_spec.it_value.tv_nsec == 0)
+		{
+			// Zero disarms the timer
+			timer_spec.it_value.tv_nsec = 1;
+		}
+
+		if (::timerfd_settime(_timer_fd, TFD_TIMER_ABSTIME, &timer_spec, nullptr) != 0)
+		{
+			logte("Could not arm the timer: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	std::chrono::steady_clock::time_point ReplayStream::GetDueTime() const
+	{
+		auto time_usec = _next_record.time_usec + _loop_time_offset_usec;
+
+		return _play_start_time + std::chrono::microseconds(static_cast<int64_t>(time_usec / _speed));
+	}
+
+	bool ReplayStream::ReadNextRecord()
+	{
+		while (true)
+		{
+			if (_reader->Read(&_next_record))
+			{
+				auto &timestamp = _track_timestamps[_next_record.media_packet->GetTrackId()];
+				auto &media_packet = _next_record.media_packet;
+
+				if (_played_loop_count == 0)
+				{
+					if (timestamp.packet_count == 0)
+					{
+						timestamp.first_dts = media_packet->GetDts();
+					}
+
+					timestamp.last_dts = media_packet->GetDts();
+					timestamp.last_duration = media_packet->GetDuration();
+					timestamp.packet_count++;
+
+					_last_time_usec = _next_record.time_usec;
+				}
+
+				media_packet->SetPts(media_packet->GetPts() + timestamp.offset);
+				media_packet->SetDts(media_packet->GetDts() + timestamp.offset);
+
+				return true;
+			}
+
+			_played_loop_count++;
+
+			if ((_loop_count != 0) && (_played_loop_count >= _loop_count))
+			{
+				return false;
+			}
+
+			if ((_sent_packet_count == 0) || (_reader->Rewind() == false))
+			{
+				return false;
+			}
+
+			// The next loop starts after the last packet of the loop, as if the file is played again in the same stream
+			for (auto &item : _track_timestamps)
+			{
+				auto &timestamp = item.second;
+				auto duration = timestamp.last_duration;
+
+				if ((duration <= 0) && (timestamp.packet_count > 1))
+				{
+					duration = (timestamp.last_dts - timestamp.first_dts) / static_cast<int64_t>(timestamp.packet_count - 1);
+				}
+
+				timestamp.offset += (timestamp.last_dts + std::max<int64_t>(duration, 1)) - timestamp.first_dts;
+			}
+
+			auto packet_count = std::max<uint64_t>(_sent_packet_count / _played_loop_count, 1);
+			_loop_time_offset_usec += _last_time_usec + (_last_time_usec / static_cast<int64_t>(packet_count));
+		}
+	}
+
+	Stream::ProcessMediaResult ReplayStream::ProcessMediaPacket()
+	{
+		if (_state != State::PLAYING)
+		{
+			return ProcessMediaResult::PROCESS_MEDIA_TRY_AGAIN;
+		}
+
+		bool is_realtime = (_speed > 0.0);
+
+		if (is_realtime)
+		{
+			uint64_t expirations;
+
+			if (::read(_timer_fd, &expirations, sizeof(expirations)) < 0)
+			{
+				if (errno == EAGAIN)
+				{
+					return ProcessMediaResult::PROCESS_MEDIA_TRY_AGAIN;
+				}
+
+				logte("Could not read the timer: %s", ov::Error::CreateErrorFromErrno()->ToString().CStr());
+				return ProcessMediaResult::PROCESS_MEDIA_FAILURE;
+			}
+		}
+
+		auto now = std::chrono::steady_clock::now();
+
+		for (int count = 0; _has_next_record && (count < REPLAY_MAX_PACKETS_PER_EVENT); count++)
+		{
+			if (is_realtime && (GetDueTime() > now))
+			{
+				break;
+			}
+
+			_application->SendFrame(GetSharedPtrAs<info::Stream>(), _next_record.media_packet);
+			_sent_packet_count++;
+
+			_has_next_record = ReadNextRecord();
+		}
+
+		if (_has_next_record == false)
+		{
+			auto elapsed_msec = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _play_start_time).count();
+
+			logti("%s/%s(%u) has finished the replay: %" PRIu64 " packets in %" PRId64 " ms (%.1f packets/s)",
+				  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(),
+				  _sent_packet_count, static_cast<int64_t>(elapsed_msec),
+				  (elapsed_msec > 0) ? (_sent_packet_count * 1000.0 / elapsed_msec) : 0.0);
+
+			_state = State::STOPPED;
+			return ProcessMediaResult::PROCESS_MEDIA_FINISH;
+		}
+
+		if (is_realtime && (ArmTimer(GetDueTime()) == false))
+		{
+			return ProcessMediaResult::PROCESS_MEDIA_FAILURE;
+		}
+
+		return ProcessMediaResult::PROCESS_MEDIA_SUCCESS;
+	}
+}  // namespace pvd
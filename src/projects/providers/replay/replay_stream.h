@@ -0,0 +1,86 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/provider/application.h>
+#include <base/provider/stream.h>
+#include <modules/media_capture/media_capture.h>
+
+#include <chrono>
+#include <map>
+
+// The maximum number of packets that are sent per event (the other streams of the StreamMotor are not starved with speed=max)
+#define REPLAY_MAX_PACKETS_PER_EVENT 64
+
+namespace pvd
+{
+	// Replays a capture file as an incoming stream
+	//
+	// replay://<any host>/<file name>[?speed=<factor|max>][&loop=<count>]
+	// 	file name: The name of the capture file in <Server><Performance><Capture><Path>
+	// 	speed: 1 (default) sends the packets at the pace they were captured, 2 sends them twice as fast,
+	// 		and max sends them as fast as the pipeline takes them
+	// 	loop: The number of times the file is played (default: 1, 0: forever), the timestamps continue over the loops
+	class ReplayStream : public pvd::Stream
+	{
+	public:
+		static std::shared_ptr<ReplayStream> Create(const std::shared_ptr<pvd::Application> &application, const uint32_t stream_id, const ov::String &stream_name, const std::vector<ov::String> &url_list);
+
+		ReplayStream(const std::shared_ptr<pvd::Application> &application, const info::Stream &stream_info, const std::vector<ov::String> &url_list);
+		~ReplayStream() final;
+
+		// A timerfd that is readable when the next packet is due
+		int GetFileDescriptorForDetectingEvent() override;
+		Stream::ProcessMediaResult ProcessMediaPacket() override;
+
+	private:
+		bool Start() override;
+		bool Play() override;
+		bool Stop() override;
+
+		bool ParseUrl(const ov::String &url);
+		// Reads the next record, and rewinds the file if there are loops left (returns false at the end of the replay)
+		bool ReadNextRecord();
+		// The time the record of _next_record is due
+		std::chrono::steady_clock::time_point GetDueTime() const;
+		bool ArmTimer(const std::chrono::steady_clock::time_point &due_time);
+
+		std::vector<ov::String> _url_list;
+
+		std::shared_ptr<MediaCaptureReader> _reader;
+
+		// 0 if the packets are sent as fast as possible
+		double _speed = 1.0;
+		// 0 if the file is played forever
+		uint32_t _loop_count = 1;
+		uint32_t _played_loop_count = 0;
+
+		int _timer_fd = -1;
+		std::chrono::steady_clock::time_point _play_start_time;
+
+		MediaCaptureReader::Record _next_record;
+		bool _has_next_record = false;
+
+		// The time and the timestamps of the loops that are played are added to the records of the next loop
+		int64_t _loop_time_offset_usec = 0;
+		int64_t _last_time_usec = 0;
+		struct TrackTimestamp
+		{
+			int64_t first_dts = 0;
+			int64_t last_dts = 0;
+			int64_t last_duration = 0;
+			int64_t offset = 0;
+			uint64_t packet_count = 0;
+		};
+		std::map<int32_t, TrackTimestamp> _track_timestamps;
+
+		uint64_t _sent_packet_count = 0;
+	};
+}  // namespace pvd
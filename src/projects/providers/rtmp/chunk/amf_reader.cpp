@@ -0,0 +1,250 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "amf_reader.h"
+
+// Objects nested deeper than this are treated as malformed
+#define AMF_READER_MAX_DEPTH 16
+
+AmfReader::AmfReader(const void *data, size_t length)
+	: _data(static_cast<const uint8_t *>(data)),
+	  _length((data == nullptr) ? 0 : length)
+{
+}
+
+AmfTypeMarker AmfReader::PeekMarker() const
+{
+	if (IsEnd())
+	{
+		return AmfTypeMarker::Unsupported;
+	}
+
+	return static_cast<AmfTypeMarker>(_data[_position]);
+}
+
+bool AmfReader::ReadNumber(double *number)
+{
+	if ((PeekMarker() != AmfTypeMarker::Number) || (Has(1 + 8) == false))
+	{
+		return false;
+	}
+
+	if (number != nullptr)
+	{
+		AmfUtil::DecodeNumber(_data + _position, number);
+	}
+	_position += 1 + 8;
+
+	return true;
+}
+
+bool AmfReader::ReadBoolean(bool *boolean)
+{
+	if ((PeekMarker() != AmfTypeMarker::Boolean) || (Has(1 + 1) == false))
+	{
+		return false;
+	}
+
+	if (boolean != nullptr)
+	{
+		*boolean = (_data[_position + 1] != 0);
+	}
+	_position += 1 + 1;
+
+	return true;
+}
+
+bool AmfReader::ReadUtf8(size_t length_size, std::string_view *string)
+{
+	if (Has(length_size) == false)
+	{
+		return false;
+	}
+
+	size_t length = (length_size == 2) ? AmfUtil::ReadInt16(_data + _position) : AmfUtil::ReadInt32(_data + _position);
+
+	if (Has(length_size + length) == false)
+	{
+		return false;
+	}
+
+	if (string != nullptr)
+	{
+		*string = std::string_view(reinterpret_cast<const char *>(_data + _position + length_size), length);
+	}
+
+	_position += length_size + length;
+
+	return true;
+}
+
+bool AmfReader::ReadString(std::string_view *string)
+{
+	switch (PeekMarker())
+	{
+		case AmfTypeMarker::String:
+			_position++;
+			return ReadUtf8(2, string);
+
+		case AmfTypeMarker::LongString:
+			_position++;
+			return ReadUtf8(4, string);
+
+		default:
+			return false;
+	}
+}
+
+bool AmfReader::ReadObjectBegin()
+{
+	switch (PeekMarker())
+	{
+		case AmfTypeMarker::Object:
+			_position++;
+			return true;
+
+		case AmfTypeMarker::EcmaArray:
+			// The count of the ECMA array is not reliable, the end marker is used instead
+			if (Has(1 + 4) == false)
+			{
+				return false;
+			}
+			_position += 1 + 4;
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+bool AmfReader::ReadPropertyName(std::string_view *name, bool *is_end)
+{
+	*is_end = false;
+
+	// Like AmfObjectArray::Decode(), the end marker is also accepted without the preceding empty name
+	if (PeekMarker() == AmfTypeMarker::ObjectEnd)
+	{
+		_position++;
+		*is_end = true;
+		return true;
+	}
+
+	if (ReadUtf8(2, name) == false)
+	{
+		return false;
+	}
+
+	if (name->empty() && (PeekMarker() == AmfTypeMarker::ObjectEnd))
+	{
+		_position++;
+		*is_end = true;
+	}
+
+	return true;
+}
+
+bool AmfReader::Skip()
+{
+	return Skip(0);
+}
+
+bool AmfReader::Skip(int depth)
+{
+	if (depth > AMF_READER_MAX_DEPTH)
+	{
+		return false;
+	}
+
+	switch (PeekMarker())
+	{
+		case AmfTypeMarker::Number:
+			return ReadNumber(nullptr);
+
+		case AmfTypeMarker::Boolean:
+			return ReadBoolean(nullptr);
+
+		case AmfTypeMarker::String:
+		case AmfTypeMarker::LongString:
+			return ReadString(nullptr);
+
+		case AmfTypeMarker::Null:
+		case AmfTypeMarker::Undefined:
+			_position++;
+			return true;
+
+		case AmfTypeMarker::Reference:
+			if (Has(1 + 2) == false)
+			{
+				return false;
+			}
+			_position += 1 + 2;
+			return true;
+
+		case AmfTypeMarker::Date:
+			// Number (8) + Timezone (2)
+			if (Has(1 + 8 + 2) == false)
+			{
+				return false;
+			}
+			_position += 1 + 8 + 2;
+			return true;
+
+		case AmfTypeMarker::Object:
+		case AmfTypeMarker::EcmaArray:
+		{
+			if (ReadObjectBegin() == false)
+			{
+				return false;
+			}
+
+			while (true)
+			{
+				std::string_view name;
+				bool is_end;
+
+				if (ReadPropertyName(&name, &is_end) == false)
+				{
+					return false;
+				}
+
+				if (is_end)
+				{
+					return true;
+				}
+
+				if (Skip(depth + 1) == false)
+				{
+					return false;
+				}
+			}
+		}
+
+		case AmfTypeMarker::StrictArray:
+		{
+			if (Has(1 + 4) == false)
+			{
+				return false;
+			}
+
+			uint32_t count = AmfUtil::ReadInt32(_data + _position + 1);
+			_position += 1 + 4;
+
+			for (uint32_t index = 0; index < count; index++)
+			{
+				if (Skip(depth + 1) == false)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		default:
+			return false;
+	}
+}
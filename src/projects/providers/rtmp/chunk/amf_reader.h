@@ -0,0 +1,55 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <string_view>
+
+#include "amf_document.h"
+
+// Pull-style AMF0 reader which walks the encoded bytes without allocating anything.
+// Strings are returned as views into the buffer, so they are valid only while the buffer is alive.
+// AmfDocument should be used when the whole structure is needed (such as control commands).
+class AmfReader
+{
+public:
+	AmfReader(const void *data, size_t length);
+
+	bool IsEnd() const
+	{
+		return _position >= _length;
+	}
+
+	// Returns AmfTypeMarker::Unsupported if there is no more data
+	AmfTypeMarker PeekMarker() const;
+
+	// nullptr can be passed to skip the value
+	bool ReadNumber(double *number);
+	bool ReadBoolean(bool *boolean);
+	// String and LongString
+	bool ReadString(std::string_view *string);
+
+	// Object and EcmaArray
+	bool ReadObjectBegin();
+	// Reads the name of the next property of the object, *is_end is set after the end of the object is consumed
+	bool ReadPropertyName(std::string_view *name, bool *is_end);
+
+	// Skips the next value including nested objects/arrays
+	bool Skip();
+
+private:
+	bool Skip(int depth);
+	bool ReadUtf8(size_t length_size, std::string_view *string);
+	bool Has(size_t length) const
+	{
+		return (_length - _position) >= length;
+	}
+
+	const uint8_t *_data;
+	size_t _length;
+	size_t _position = 0;
+};
@@ -244,6 +244,10 @@ RtmpChunkParser::ParseResult RtmpChunkParser::ParseMessageHeader(ov::ByteStream
 	off_t current_offset = stream.GetOffset();
 #endif  // DEBUG
 
+	uint24_t timestamp = 0;
+	uint24_t length = 0;
+	uint8_t type_id = 0;
+
 	// Obtain header size to move the offset of raw_data_pos
 	switch (_current_chunk_header->basic_header.format_type)
 	{
@@ -255,9 +259,11 @@ RtmpChunkParser::ParseResult RtmpChunkParser::ParseMessageHeader(ov::ByteStream
 				return ParseResult::NeedMoreData;
 			}
 
-			_current_chunk_header->header.type_0.timestamp = stream.ReadBE24();
-			_current_chunk_header->header.type_0.length = stream.ReadBE24();
-			_current_chunk_header->header.type_0.type_id = stream.Read8();
+			stream.ReadBE(timestamp, length, type_id);
+
+			_current_chunk_header->header.type_0.timestamp = timestamp;
+			_current_chunk_header->header.type_0.length = length;
+			_current_chunk_header->header.type_0.type_id = type_id;
 			_current_chunk_header->header.type_0.stream_id = stream.ReadLE32();
 
 			_current_chunk_header->payload_size = _current_chunk_header->header.type_0.length;
@@ -274,9 +280,11 @@ RtmpChunkParser::ParseResult RtmpChunkParser::ParseMessageHeader(ov::ByteStream
 				return ParseResult::NeedMoreData;
 			}
 
-			_current_chunk_header->header.type_1.timestamp_delta = stream.ReadBE24();
-			_current_chunk_header->header.type_1.length = stream.ReadBE24();
-			_current_chunk_header->header.type_1.type_id = stream.Read8();
+			stream.ReadBE(timestamp, length, type_id);
+
+			_current_chunk_header->header.type_1.timestamp_delta = timestamp;
+			_current_chunk_header->header.type_1.length = length;
+			_current_chunk_header->header.type_1.type_id = type_id;
 
 			_current_chunk_header->payload_size = _current_chunk_header->header.type_1.length;
 
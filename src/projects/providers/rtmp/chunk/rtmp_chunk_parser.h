@@ -47,6 +47,16 @@ public:
 		return nullptr;
 	}
 
+	std::shared_ptr<const RtmpChunkHeader> GetParsedChunkHeader() const
+	{
+		if (IsParseCompleted())
+		{
+			return _current_chunk_header;
+		}
+
+		return nullptr;
+	}
+
 	static RtmpChunkType GetChunkType(uint8_t first_byte);
 	static int GetBasicHeaderSize(uint8_t first_byte);
 
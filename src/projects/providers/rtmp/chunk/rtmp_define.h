@@ -251,6 +251,8 @@ public :
         //h.264 AVC 헤더 관련 설정 정보
         avc_sps = std::make_shared<std::vector<uint8_t>>();
         avc_pps = std::make_shared<std::vector<uint8_t>>();
+
+        audio_specific_config = std::make_shared<std::vector<uint8_t>>();
     }
 
 public :
@@ -278,6 +280,9 @@ public :
     //h.264 AVC 헤더 관련 설정 정보
     std::shared_ptr<std::vector<uint8_t>> avc_sps;
     std::shared_ptr<std::vector<uint8_t>> avc_pps;
+
+    // AAC AudioSpecificConfig of the sequence header
+    std::shared_ptr<std::vector<uint8_t>> audio_specific_config;
 };
 
 #pragma pack()
\ No newline at end of file
@@ -323,6 +323,14 @@ bool RtmpImportChunk::CalculateForType3Header(const std::shared_ptr<RtmpChunkHea
 
 std::shared_ptr<const RtmpMessage> RtmpImportChunk::FinalizeMessage(const std::shared_ptr<const RtmpChunkHeader> &chunk_header, ov::ByteStream &stream)
 {
+	if (chunk_header->expected_payload_size == chunk_header->payload_size)
+	{
+		// There is no type 3 header in the middle, so the payload can be referenced without copying
+		auto payload_data = stream.GetRemainData()->Subdata(0LL, chunk_header->payload_size);
+
+		return std::make_shared<RtmpMessage>(chunk_header, std::move(payload_data));
+	}
+
 	// We need to exclude the type 3 headers
 	int index = 0;
 	int basic_header_size = chunk_header->basic_header_size;
@@ -414,6 +422,25 @@ size_t RtmpImportChunk::GetMessageCount() const
 	return _message_queue.Size();
 }
 
+size_t RtmpImportChunk::GetPendingPayloadSize() const
+{
+	if (_parser.IsParseCompleted() == false)
+	{
+		return 0;
+	}
+
+	auto chunk_header = _parser.GetParsedChunkHeader();
+
+	if (chunk_header == nullptr)
+	{
+		return 0;
+	}
+
+	auto item = _chunk_map.find(chunk_header->basic_header.stream_id);
+
+	return (item != _chunk_map.end()) ? item->second->expected_payload_size : 0;
+}
+
 void RtmpImportChunk::SetAppName(const ov::String &app_name)
 {
 	_app_name = app_name;
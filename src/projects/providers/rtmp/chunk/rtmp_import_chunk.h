@@ -28,6 +28,9 @@ public:
 	std::shared_ptr<const RtmpMessage> GetMessage();
 	size_t GetMessageCount() const;
 
+	// The number of bytes needed to finalize the message whose header is already parsed (0: no such message)
+	size_t GetPendingPayloadSize() const;
+
 	void SetChunkSize(size_t chunk_size)
 	{
 		_chunk_size = chunk_size;
@@ -59,7 +59,6 @@ RtmpChunkStream::RtmpChunkStream(ov::ClientSocket *remote, IRtmpChunkStream *str
 
 	_remote = remote;
 	_stream_interface = stream_interface;
-	_remained_data = nullptr;
 	_app_id = info::application_id_t();
 	_stream_id = 0;
 	_device_string = RTMP_UNKNOWN_DEVICE_TYPE_STRING;
@@ -79,10 +78,10 @@ RtmpChunkStream::RtmpChunkStream(ov::ClientSocket *remote, IRtmpChunkStream *str
 	_video_sequence_info_process = false;
 	_audio_sequence_info_process = false;
 
-	_stream_check_time = time(nullptr);
+	_stream_check_time = ov::Clock::CachedNowSec();
 	_previous_key_frame_timestamp = 0;
 
-	_last_packet_time = time(nullptr);
+	_last_packet_time = ov::Clock::CachedNowSec();
 
 	_stat_stop_watch.Start();
 }
@@ -176,34 +175,81 @@ bool RtmpChunkStream::SendData(int data_size, uint8_t *data)
 
 int32_t RtmpChunkStream::OnDataReceived(const std::shared_ptr<const ov::Data> &data)
 {
-	if ((_remained_data == nullptr) || _remained_data->IsEmpty())
+	if ((_memory_account == nullptr) && (_stream_name.IsEmpty() == false))
 	{
-		_remained_data = data->Clone();
-	}
-	else
-	{
-		_remained_data->Append(data);
+		_memory_account = ov::MemoryAccounting::GetAccount(_app_name, _stream_name);
 	}
 
-	if (_stat_stop_watch.IsElapsed(5000) && _stat_stop_watch.Update())
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Ingest, _memory_account);
+
+	// The received data is referenced without copying
+	_received_data_list.push_back(data);
+	_received_length += data->GetLength();
+
+	_stat_received_bytes += data->GetLength();
+
+	if (_stat_stop_watch.IsElapsed(5000))
 	{
-		logts("Stats for RtmpChunkStream: Message Q: %zu, Remained bytes: %zu",
+		auto elapsed = _stat_stop_watch.Elapsed();
+
+		_stat_stop_watch.Update();
+
+		logts("Stats for RtmpChunkStream: [%s/%s] Message Q: %zu, Remained bytes: %zu, Received: %.2f Mbps, Parse: %u times (avg: %.1f us, max: %lld us)",
+			  _app_name.CStr(), _stream_name.CStr(),
 			  _import_chunk->GetMessageCount(),
-			  _remained_data->GetAllocatedDataSize());
+			  _received_length,
+			  (elapsed > 0) ? (_stat_received_bytes * 8.0 / 1000.0 / elapsed) : 0.0,
+			  _stat_parse_count,
+			  (_stat_parse_count > 0) ? (static_cast<double>(_stat_parse_total_usec) / _stat_parse_count) : 0.0,
+			  static_cast<long long>(_stat_parse_max_usec));
+
+		_stat_received_bytes = 0;
+		_stat_parse_count = 0;
+		_stat_parse_total_usec = 0;
+		_stat_parse_max_usec = 0;
 	}
 
-	if (_remained_data->GetLength() > RTMP_MAX_PACKET_SIZE)
+	if (_received_length > RTMP_MAX_PACKET_SIZE)
 	{
 		logte("The packet is ignored because the size is too large: [%s/%s] (%u/%u), packet size: %zu, threshold: %d",
 			  _app_name.CStr(), _stream_name.CStr(),
 			  _app_id, _stream_id,
-			  _remained_data->GetLength(),
+			  _received_length,
 			  RTMP_MAX_PACKET_SIZE);
 
 		return -1;
 	}
 
-	logtp("Trying to parse data\n%s", _remained_data->Dump(_remained_data->GetLength()).CStr());
+	if (_received_length < _required_length)
+	{
+		// The pending message cannot be completed yet, so don't need to merge the data
+		return data->GetLength();
+	}
+
+	std::shared_ptr<const ov::Data> remained_data;
+
+	if (_received_data_list.size() == 1)
+	{
+		remained_data = std::move(_received_data_list.front());
+	}
+	else
+	{
+		// The message spans multiple reads, so merge them into one buffer at once
+		auto merged_data = std::make_shared<ov::Data>(_received_length);
+
+		for (const auto &received_data : _received_data_list)
+		{
+			merged_data->Append(received_data);
+		}
+
+		remained_data = std::move(merged_data);
+	}
+
+	_received_data_list.clear();
+
+	logtp("Trying to parse data\n%s", remained_data->Dump(remained_data->GetLength()).CStr());
+
+	auto parse_start = std::chrono::steady_clock::now();
 
 	while(true)
 	{
@@ -211,11 +257,11 @@ int32_t RtmpChunkStream::OnDataReceived(const std::shared_ptr<const ov::Data> &d
 
 		if (_handshake_state == RtmpHandshakeState::Complete)
 		{
-			process_size = ReceiveChunkPacket(_remained_data);
+			process_size = ReceiveChunkPacket(remained_data);
 		}
 		else
 		{
-			process_size = ReceiveHandshakePacket(_remained_data);
+			process_size = ReceiveHandshakePacket(remained_data);
 		}
 
 		if (process_size < 0)
@@ -223,7 +269,7 @@ int32_t RtmpChunkStream::OnDataReceived(const std::shared_ptr<const ov::Data> &d
 			logtd("Could not parse RTMP packet: [%s/%s] (%u/%u), size: %zu bytes, returns: %d",
 				_app_name.CStr(), _stream_name.CStr(),
 				_app_id, _stream_id,
-				_remained_data->GetLength(),
+				remained_data->GetLength(),
 				process_size);
 
 			return process_size;
@@ -235,10 +281,30 @@ int32_t RtmpChunkStream::OnDataReceived(const std::shared_ptr<const ov::Data> &d
 			break;
 		}
 
-		_remained_data = _remained_data->Subdata(process_size);
+		remained_data = remained_data->Subdata(process_size);
+	}
+
+	// The time spent to parse the data and to deliver the frames to the provider
+	auto parse_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - parse_start).count();
+
+	_stat_parse_count++;
+	_stat_parse_total_usec += parse_time;
+	_stat_parse_max_usec = std::max<int64_t>(_stat_parse_max_usec, parse_time);
+
+	_received_length = remained_data->GetLength();
+	_required_length = 0;
+
+	if (_received_length > 0)
+	{
+		_received_data_list.push_back(std::move(remained_data));
+
+		if (_handshake_state == RtmpHandshakeState::Complete)
+		{
+			_required_length = _import_chunk->GetPendingPayloadSize();
+		}
 	}
-	
-	// All data are already appended to _remained_data
+
+	// All data are already kept in _received_data_list
 	return data->GetLength();
 }
 
@@ -602,6 +668,17 @@ void RtmpChunkStream::ReceiveAmfCommandMessage(const std::shared_ptr<const RtmpM
 //====================================================================================================
 void RtmpChunkStream::ReceiveAmfDataMessage(const std::shared_ptr<const RtmpMessage> &message)
 {
+	{
+		RtmpMetaData meta_data;
+
+		if (ReadAmfMetaData(message, &meta_data))
+		{
+			OnAmfMetaData(message->header, meta_data);
+			return;
+		}
+	}
+
+	// Not a well-formed onMetaData, falls back to AmfDocument
 	AmfDocument document;
 	int32_t decode_lehgth = 0;
 	ov::String message_name;
@@ -634,7 +711,27 @@ void RtmpChunkStream::ReceiveAmfDataMessage(const std::shared_ptr<const RtmpMess
 		(document.GetProperty(2)->GetType() == AmfDataType::Object ||
 		 document.GetProperty(2)->GetType() == AmfDataType::Array))
 	{
-		OnAmfMetaData(message->header, document, 2);
+		AmfObjectArray *object = nullptr;
+		RtmpMetaData meta_data;
+
+		if (document.GetProperty(2)->GetType() == AmfDataType::Object)
+		{
+			object = (AmfObjectArray *)(document.GetProperty(2)->GetObject());
+		}
+		else
+		{
+			object = (AmfObjectArray *)(document.GetProperty(2)->GetArray());
+		}
+
+		for (int index = 0; object->GetName(index) != nullptr; index++)
+		{
+			const char *string = (object->GetType(index) == AmfDataType::String) ? object->GetString(index) : nullptr;
+
+			CollectMetaDataProperty(&meta_data, object->GetName(index), object->GetType(index), object->GetNumber(index),
+									(string != nullptr) ? std::string_view(string) : std::string_view());
+		}
+
+		OnAmfMetaData(message->header, meta_data);
 	}
 	else
 	{
@@ -1173,7 +1270,7 @@ bool RtmpChunkStream::ReceiveVideoMessage(const std::shared_ptr<const RtmpMessag
 	}
 
 	// setting packet time
-	_last_packet_time = time(nullptr);
+	_last_packet_time = ov::Clock::CachedNowSec();
 
 	// video stream callback 호출
 	if (_media_info->video_streaming)
@@ -1195,7 +1292,7 @@ bool RtmpChunkStream::ReceiveVideoMessage(const std::shared_ptr<const RtmpMessag
 		_last_video_timestamp = message->header->completed.timestamp;
 		_video_frame_count++;
 
-		time_t current_time = time(nullptr);
+		int64_t current_time = ov::Clock::CachedNowSec();
 		uint32_t check_gap = current_time - _stream_check_time;
 
 		if (check_gap >= 60)
@@ -1212,7 +1309,7 @@ bool RtmpChunkStream::ReceiveVideoMessage(const std::shared_ptr<const RtmpMessag
 				  _last_video_timestamp - _previous_last_video_timestamp,
 				  _last_audio_timestamp - _previous_last_audio_timestamp);
 
-			_stream_check_time = time(nullptr);
+			_stream_check_time = current_time;
 			_video_frame_count = 0;
 			_audio_frame_count = 0;
 			_previous_last_video_timestamp = _last_video_timestamp;
@@ -1293,7 +1390,7 @@ bool RtmpChunkStream::ReceiveAudioMessage(const std::shared_ptr<const RtmpMessag
 	}
 
 	// setting packet time
-	_last_packet_time = time(nullptr);
+	_last_packet_time = ov::Clock::CachedNowSec();
 
 	// audio stream callback 호출
 	if (_media_info->audio_streaming)
@@ -1449,6 +1546,8 @@ bool RtmpChunkStream::AudioSequenceHeaderProcess(const std::shared_ptr<const ov:
 	_media_info->audio_samplerate = samplerate;
 	_media_info->audio_sampleindex = sample_index;
 	_media_info->audio_channels = channels;
+	// Control byte(1) + AACPacketType(1) + AudioSpecificConfig
+	_media_info->audio_specific_config->assign(data->GetDataAs<uint8_t>() + 2, data->GetDataAs<uint8_t>() + data->GetLength());
 
 	_media_info->audio_streaming = true;
 
@@ -1543,223 +1642,271 @@ bool RtmpChunkStream::StreamCreate()
 
 //====================================================================================================
 // Amf Command - OnMetaData
+// - Read without AmfDocument, since some encoders repeat it during the stream
 //====================================================================================================
-bool RtmpChunkStream::OnAmfMetaData(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document,
-									int32_t object_index)
+bool RtmpChunkStream::ReadAmfMetaData(const std::shared_ptr<const RtmpMessage> &message, RtmpMetaData *meta_data)
 {
-	// setting packet time
-	_last_packet_time = time(nullptr);
-
-	RtmpCodecType video_codec_type = RtmpCodecType::Unknown;
-	RtmpCodecType audio_codec_type = RtmpCodecType::Unknown;
-	double frame_rate = 30.0;
-	double video_width = 0;
-	double video_height = 0;
-	double video_bitrate = 0;
-	double audio_bitrate = 0.0;
-	double audio_channels = 1.0;
-	double audio_samplerate = 0.0;
-	double audio_samplesize = 0.0;
-	AmfObjectArray *object = nullptr;
-	int32_t index = 0;
-	ov::String bitrate_string;
-	RtmpEncoderType encoder_type = RtmpEncoderType::Custom;
+	AmfReader reader(message->payload->GetData(), std::min(static_cast<size_t>(message->header->payload_size), message->payload->GetLength()));
+	std::string_view message_name;
+	std::string_view data_name;
 
-	// dump 정보 출력
-	std::string dump_string;
-	document.Dump(dump_string);
-	logtd(dump_string.c_str());
-
-	// object encoding 얻기
-	if (document.GetProperty(object_index)->GetType() == AmfDataType::Object)
+	if ((reader.ReadString(&message_name) == false) || (message_name != RTMP_CMD_DATA_SETDATAFRAME))
 	{
-		object = (AmfObjectArray *)(document.GetProperty(object_index)->GetObject());
-	}
-	else
-	{
-		object = (AmfObjectArray *)(document.GetProperty(object_index)->GetArray());
+		return false;
 	}
 
-	// DeviceType
-	if ((index = object->FindName("videodevice")) >= 0 && object->GetType(index) == AmfDataType::String)
+	if ((reader.ReadString(&data_name) == false) || (data_name != RTMP_CMD_DATA_ONMETADATA))
 	{
-		_device_string = object->GetString(index);  //DeviceType - XSplit
+		return false;
 	}
-	else if ((index = object->FindName("encoder")) >= 0 && object->GetType(index) == AmfDataType::String)
+
+	if (reader.ReadObjectBegin() == false)
 	{
-		_device_string = object->GetString(index);
+		return false;
 	}
 
-	// Encoder 인식
-	if (_device_string.IndexOf("Open Broadcaster") >= 0)
+	while (true)
 	{
-		encoder_type = RtmpEncoderType::OBS;
+		std::string_view name;
+		bool is_end;
+
+		if (reader.ReadPropertyName(&name, &is_end) == false)
+		{
+			return false;
+		}
+
+		if (is_end)
+		{
+			return true;
+		}
+
+		switch (reader.PeekMarker())
+		{
+			case AmfTypeMarker::Number:
+			{
+				double number;
+
+				if (reader.ReadNumber(&number) == false)
+				{
+					return false;
+				}
+
+				CollectMetaDataProperty(meta_data, name, AmfDataType::Number, number, std::string_view());
+				break;
+			}
+
+			case AmfTypeMarker::String:
+			case AmfTypeMarker::LongString:
+			{
+				std::string_view string;
+
+				if (reader.ReadString(&string) == false)
+				{
+					return false;
+				}
+
+				CollectMetaDataProperty(meta_data, name, AmfDataType::String, 0.0, string);
+				break;
+			}
+
+			default:
+				// Not interested in the other types
+				if (reader.Skip() == false)
+				{
+					return false;
+				}
+				break;
+		}
 	}
-	else if (_device_string.IndexOf("obs-output") >= 0)
+}
+
+void RtmpChunkStream::CollectMetaDataProperty(RtmpMetaData *meta_data, const std::string_view &name, AmfDataType type, double number, const std::string_view &string)
+{
+	bool is_number = (type == AmfDataType::Number);
+	bool is_string = (type == AmfDataType::String);
+
+	if (is_number)
 	{
-		encoder_type = RtmpEncoderType::OBS;
+		logtd("MetaData - %.*s : %f", static_cast<int>(name.size()), name.data(), number);
 	}
-	else if (_device_string.IndexOf("XSplitBroadcaster") >= 0)
+	else if (is_string)
 	{
-		encoder_type = RtmpEncoderType::Xsplit;
+		logtd("MetaData - %.*s : %.*s", static_cast<int>(name.size()), name.data(), static_cast<int>(string.size()), string.data());
 	}
-	else if (_device_string.IndexOf("Lavf") >= 0)
+
+	// DeviceType
+	if ((name == "videodevice") && is_string && (meta_data->device_priority <= 2))
 	{
-		encoder_type = RtmpEncoderType::Lavf;
+		meta_data->device = string;  //DeviceType - XSplit
+		meta_data->device_priority = 2;
 	}
-	else
+	else if ((name == "encoder") && is_string && (meta_data->device_priority <= 1))
 	{
-		encoder_type = RtmpEncoderType::Custom;
+		meta_data->device = string;
+		meta_data->device_priority = 1;
 	}
-
 	// Video Codec
-	if ((index = object->FindName("videocodecid")) >= 0)
+	else if (name == "videocodecid")
 	{
-		if (object->GetType(index) == AmfDataType::String && strcmp("avc1", object->GetString(index)) == 0)
-		{
-			video_codec_type = RtmpCodecType::H264;
-		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp("H264Avc", object->GetString(index)) == 0)
-		{
-			video_codec_type = RtmpCodecType::H264;
-		}
-		else if (object->GetType(index) == AmfDataType::Number && object->GetNumber(index) == 7.0)
+		if ((is_string && ((string == "avc1") || (string == "H264Avc"))) ||
+			(is_number && (number == 7.0)))
 		{
-			video_codec_type = RtmpCodecType::H264;
+			meta_data->video_codec_type = RtmpCodecType::H264;
 		}
 	}
-
 	// Video Framerate
-	if ((index = object->FindName("framerate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "framerate") && is_number && (meta_data->frame_rate_priority <= 2))
 	{
-		frame_rate = object->GetNumber(index);
+		meta_data->frame_rate = number;
+		meta_data->frame_rate_priority = 2;
 	}
-	else if ((index = object->FindName("videoframerate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "videoframerate") && is_number && (meta_data->frame_rate_priority <= 1))
 	{
-		frame_rate = object->GetNumber(index);
+		meta_data->frame_rate = number;
+		meta_data->frame_rate_priority = 1;
 	}
-
-	// Video Width
-	if ((index = object->FindName("width")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	// Video Width/Height
+	else if ((name == "width") && is_number)
 	{
-		video_width = object->GetNumber(index);
+		meta_data->video_width = number;
 	}
-
-	// Video Height
-	if ((index = object->FindName("height")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "height") && is_number)
 	{
-		video_height = object->GetNumber(index);
+		meta_data->video_height = number;
 	}
-
 	// Video Bitrate
-	if ((index = object->FindName("videodatarate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "maxBitrate") && is_string && (meta_data->video_bitrate_priority <= 3))
 	{
-		video_bitrate = object->GetNumber(index);
-	}  // Video Data Rate
-	if ((index = object->FindName("bitrate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+		// The string is not null-terminated
+		char bitrate_string[32];
+		size_t length = std::min(string.size(), sizeof(bitrate_string) - 1);
+
+		::memcpy(bitrate_string, string.data(), length);
+		bitrate_string[length] = '\0';
+
+		meta_data->video_bitrate = strtol(bitrate_string, nullptr, 0);
+		meta_data->video_bitrate_priority = 3;
+	}
+	else if ((name == "bitrate") && is_number && (meta_data->video_bitrate_priority <= 2))
 	{
-		video_bitrate = object->GetNumber(index);
-	}  // Video Data Rate
-	if (((index = object->FindName("maxBitrate")) >= 0) && object->GetType(index) == AmfDataType::String)
+		meta_data->video_bitrate = number;
+		meta_data->video_bitrate_priority = 2;
+	}
+	else if ((name == "videodatarate") && is_number && (meta_data->video_bitrate_priority <= 1))
 	{
-		bitrate_string = object->GetString(index);
-		video_bitrate = strtol(bitrate_string.CStr(), nullptr, 0);
+		meta_data->video_bitrate = number;  // Video Data Rate
+		meta_data->video_bitrate_priority = 1;
 	}
-
 	// Audio Codec
-	if ((index = object->FindName("audiocodecid")) >= 0)
+	else if (name == "audiocodecid")
 	{
-		if (object->GetType(index) == AmfDataType::String && strcmp("mp4a", object->GetString(index)) == 0)
+		if ((is_string && (string == "mp4a")) || (is_number && (number == 10.0)))
 		{
-			audio_codec_type = RtmpCodecType::AAC;  //AAC
+			meta_data->audio_codec_type = RtmpCodecType::AAC;  //AAC
 		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp("mp3", object->GetString(index)) == 0)
+		else if ((is_string && ((string == "mp3") || (string == ".mp3"))) || (is_number && (number == 2.0)))
 		{
-			audio_codec_type = RtmpCodecType::MP3;  //MP3
+			meta_data->audio_codec_type = RtmpCodecType::MP3;  //MP3
 		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp(".mp3", object->GetString(index)) == 0)
+		else if ((is_string && (string == "speex")) || (is_number && (number == 11.0)))
 		{
-			audio_codec_type = RtmpCodecType::MP3;  //MP3
+			meta_data->audio_codec_type = RtmpCodecType::SPEEX;  //Speex
 		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp("speex", object->GetString(index)) == 0)
-		{
-			audio_codec_type = RtmpCodecType::SPEEX;  //Speex
-		}
-		else if (object->GetType(index) == AmfDataType::Number && object->GetNumber(index) == 10.0)
-		{
-			audio_codec_type = RtmpCodecType::AAC;  //AAC
-		}
-		else if (object->GetType(index) == AmfDataType::Number && object->GetNumber(index) == 11.0)
-		{
-			audio_codec_type = RtmpCodecType::SPEEX;  //Speex
-		}
-		else if (object->GetType(index) == AmfDataType::Number && object->GetNumber(index) == 2.0)
-		{
-			audio_codec_type = RtmpCodecType::MP3;
-		}  //MP3
 	}
-
 	// Audio bitreate
-	if ((index = object->FindName("audiodatarate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "audiodatarate") && is_number && (meta_data->audio_bitrate_priority <= 2))
 	{
-		audio_bitrate = object->GetNumber(index);  // Audio Data Rate
+		meta_data->audio_bitrate = number;  // Audio Data Rate
+		meta_data->audio_bitrate_priority = 2;
 	}
-	else if ((index = object->FindName("audiobitrate")) >= 0 && object->GetType(index) == AmfDataType::Number)
+	else if ((name == "audiobitrate") && is_number && (meta_data->audio_bitrate_priority <= 1))
 	{
-		audio_bitrate = object->GetNumber(index);
-	}  // Audio Data Rate
-
+		meta_data->audio_bitrate = number;
+		meta_data->audio_bitrate_priority = 1;
+	}
 	// Audio Channels
-	if ((index = object->FindName("audiochannels")) >= 0)
+	else if (name == "audiochannels")
 	{
-		if (object->GetType(index) == AmfDataType::Number)
+		if (is_number)
 		{
-			audio_channels = object->GetNumber(index);
+			meta_data->audio_channels = number;
 		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp("stereo", object->GetString(index)) == 0)
+		else if (is_string && (string == "stereo"))
 		{
-			audio_channels = 2;
+			meta_data->audio_channels = 2;
 		}
-		else if (object->GetType(index) == AmfDataType::String && strcmp("mono", object->GetString(index)) == 0)
+		else if (is_string && (string == "mono"))
 		{
-			audio_channels = 1;
+			meta_data->audio_channels = 1;
 		}
 	}
+	// Audio samplerate/samplesize
+	else if ((name == "audiosamplerate") && is_number)
+	{
+		meta_data->audio_samplerate = number;  // Audio Sample Rate
+	}
+	else if ((name == "audiosamplesize") && is_number)
+	{
+		meta_data->audio_samplesize = number;  // Audio Sample Size
+	}
+}
+
+bool RtmpChunkStream::OnAmfMetaData(const std::shared_ptr<const RtmpChunkHeader> &header, const RtmpMetaData &meta_data)
+{
+	// setting packet time
+	_last_packet_time = ov::Clock::CachedNowSec();
 
-	// Audio samplerate
-	if ((index = object->FindName("audiosamplerate")) >= 0)
+	RtmpEncoderType encoder_type = RtmpEncoderType::Custom;
+
+	if (meta_data.device_priority > 0)
 	{
-		audio_samplerate = object->GetNumber(index);
-	}  // Audio Sample Rate
+		_device_string = ov::String(meta_data.device.data(), meta_data.device.size());
+	}
 
-	// Audio samplesize
-	if ((index = object->FindName("audiosamplesize")) >= 0)
+	// Encoder 인식
+	if (_device_string.IndexOf("Open Broadcaster") >= 0)
+	{
+		encoder_type = RtmpEncoderType::OBS;
+	}
+	else if (_device_string.IndexOf("obs-output") >= 0)
+	{
+		encoder_type = RtmpEncoderType::OBS;
+	}
+	else if (_device_string.IndexOf("XSplitBroadcaster") >= 0)
 	{
-		audio_samplesize = object->GetNumber(index);
-	}  // Audio Sample Size
+		encoder_type = RtmpEncoderType::Xsplit;
+	}
+	else if (_device_string.IndexOf("Lavf") >= 0)
+	{
+		encoder_type = RtmpEncoderType::Lavf;
+	}
+	else
+	{
+		encoder_type = RtmpEncoderType::Custom;
+	}
 
 	// support codec check (H264/AAC 지원)
-	if (!(video_codec_type == RtmpCodecType::H264) && !(audio_codec_type == RtmpCodecType::AAC))
+	if (!(meta_data.video_codec_type == RtmpCodecType::H264) && !(meta_data.audio_codec_type == RtmpCodecType::AAC))
 	{
 		logtw("codec type fail - stream(%s/%s) id(%u/%u) video(%s) audio(%s)",
 			  _app_name.CStr(),
 			  _stream_name.CStr(),
 			  _app_id,
 			  _stream_id,
-			  GetCodecString(video_codec_type).CStr(),
-			  GetCodecString(audio_codec_type).CStr());
-	}
-
-	_media_info->video_codec_type = video_codec_type;
-	_media_info->video_width = (int32_t)video_width;
-	_media_info->video_height = (int32_t)video_height;
-	_media_info->video_framerate = (float)frame_rate;
-	_media_info->video_bitrate = (int32_t)video_bitrate;
-	_media_info->audio_codec_type = audio_codec_type;
-	_media_info->audio_bitrate = (int32_t)audio_bitrate;
-	_media_info->audio_channels = (int32_t)audio_channels;
-	_media_info->audio_bits = (int32_t)audio_samplesize;
-	_media_info->audio_samplerate = (int32_t)audio_samplerate;
+			  GetCodecString(meta_data.video_codec_type).CStr(),
+			  GetCodecString(meta_data.audio_codec_type).CStr());
+	}
+
+	_media_info->video_codec_type = meta_data.video_codec_type;
+	_media_info->video_width = (int32_t)meta_data.video_width;
+	_media_info->video_height = (int32_t)meta_data.video_height;
+	_media_info->video_framerate = (float)meta_data.frame_rate;
+	_media_info->video_bitrate = (int32_t)meta_data.video_bitrate;
+	_media_info->audio_codec_type = meta_data.audio_codec_type;
+	_media_info->audio_bitrate = (int32_t)meta_data.audio_bitrate;
+	_media_info->audio_channels = (int32_t)meta_data.audio_channels;
+	_media_info->audio_bits = (int32_t)meta_data.audio_samplesize;
+	_media_info->audio_samplerate = (int32_t)meta_data.audio_samplerate;
 	_media_info->encoder_type = encoder_type;
 
 	return true;
@@ -18,11 +18,39 @@
 #include <config/config.h>
 
 #include "providers/rtmp/chunk/amf_document.h"
+#include "providers/rtmp/chunk/amf_reader.h"
 #include "providers/rtmp/chunk/rtmp_chunk_parser.h"
 #include "providers/rtmp/chunk/rtmp_export_chunk.h"
 #include "providers/rtmp/chunk/rtmp_handshake.h"
 #include "providers/rtmp/chunk/rtmp_import_chunk.h"
 
+// The known properties of onMetaData
+// - The strings point into the payload of the message, so this is valid only while the message is handled
+struct RtmpMetaData
+{
+	// videodevice(2) > encoder(1)
+	std::string_view device;
+	int device_priority = 0;
+
+	RtmpCodecType video_codec_type = RtmpCodecType::Unknown;
+	// framerate(2) > videoframerate(1)
+	double frame_rate = 30.0;
+	int frame_rate_priority = 0;
+	double video_width = 0.0;
+	double video_height = 0.0;
+	// maxBitrate(3) > bitrate(2) > videodatarate(1)
+	double video_bitrate = 0.0;
+	int video_bitrate_priority = 0;
+
+	RtmpCodecType audio_codec_type = RtmpCodecType::Unknown;
+	// audiodatarate(2) > audiobitrate(1)
+	double audio_bitrate = 0.0;
+	int audio_bitrate_priority = 0;
+	double audio_channels = 1.0;
+	double audio_samplerate = 0.0;
+	double audio_samplesize = 0.0;
+};
+
 class IRtmpChunkStream
 {
 public:
@@ -85,7 +113,8 @@ public:
 		return _stream_id;
 	}
 
-	time_t GetLastPacketTime()
+	// Monotonic time in seconds (See ov::Clock)
+	int64_t GetLastPacketTime()
 	{
 		return _last_packet_time;
 	}
@@ -129,7 +158,11 @@ private:
 	void OnAmfFCPublish(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
 	void OnAmfPublish(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
 	void OnAmfDeleteStream(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
-	bool OnAmfMetaData(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, int32_t object_index);
+	bool OnAmfMetaData(const std::shared_ptr<const RtmpChunkHeader> &header, const RtmpMetaData &meta_data);
+
+	// Reads @setDataFrame(onMetaData) with AmfReader, returns false if the message should be handled by AmfDocument
+	bool ReadAmfMetaData(const std::shared_ptr<const RtmpMessage> &message, RtmpMetaData *meta_data);
+	void CollectMetaDataProperty(RtmpMetaData *meta_data, const std::string_view &name, AmfDataType type, double number, const std::string_view &string);
 
 	bool SendMessagePacket(std::shared_ptr<RtmpMuxMessageHeader> &message_header, std::shared_ptr<std::vector<uint8_t>> &data);
 
@@ -174,7 +207,12 @@ protected:
 	uint32_t _stream_id;
 	ov::String _device_string;
 
-	std::shared_ptr<ov::Data> _remained_data;
+	// The received data that is not processed yet
+	// - Each socket read is kept as is, and they are merged into one buffer only when a message spans multiple reads
+	std::vector<std::shared_ptr<const ov::Data>> _received_data_list;
+	size_t _received_length = 0;
+	// The number of bytes needed to complete the pending message (0: unknown)
+	size_t _required_length = 0;
 	RtmpHandshakeState _handshake_state;
 	std::shared_ptr<RtmpImportChunk> _import_chunk;
 	std::shared_ptr<RtmpExportChunk> _export_chunk;
@@ -192,7 +230,7 @@ protected:
 	bool _video_sequence_info_process;
 	bool _audio_sequence_info_process;
 
-	time_t _stream_check_time;
+	int64_t _stream_check_time;
 	uint32_t _key_frame_interval = 0;
 	uint32_t _previous_key_frame_timestamp;
 	uint32_t _last_video_timestamp = 0;
@@ -202,7 +240,16 @@ protected:
 	uint32_t _video_frame_count = 0;
 	uint32_t _audio_frame_count = 0;
 
-	time_t _last_packet_time;
+	int64_t _last_packet_time;
 
 	ov::StopWatch _stat_stop_watch;
+
+	// Per-connection metrics, logged and reset every stats interval
+	uint64_t _stat_received_bytes = 0;
+	uint32_t _stat_parse_count = 0;
+	int64_t _stat_parse_total_usec = 0;
+	int64_t _stat_parse_max_usec = 0;
+
+	// Created when the stream name is known (See ov::MemoryAccounting)
+	std::shared_ptr<ov::MemoryAccount> _memory_account;
 };
@@ -46,6 +46,7 @@ bool RtmpProvider::Start()
 	// Get Server & Host configuration
 	auto server = GetServerConfig();
 
+	auto &rtmp_port = server.GetBind().GetProviders().GetRtmp();
 	auto rtmp_address = ov::SocketAddress(server.GetIp(), static_cast<uint16_t>(server.GetBind().GetProviders().GetRtmpPort()));
 
 	// Create RtmpServer
@@ -54,7 +55,7 @@ bool RtmpProvider::Start()
 	// Connect RtmpServer to Observer
 	_rtmp_server->AddObserver(RtmpObserver::GetSharedPtr());
 
-	if (!_rtmp_server->Start(rtmp_address))
+	if (!_rtmp_server->Start(rtmp_address, rtmp_port.GetReactorCount(), rtmp_port.GetWorkerCount(), rtmp_port.GetWorkerAffinity()))
 	{
 		return false;
 	}
@@ -175,6 +176,12 @@ bool RtmpProvider::OnStreamReadyComplete(const ov::String &app_name,
 		new_track->SetBitrate(media_info->audio_bitrate * 1000);
 		// new_track->SetSampleSize(conn->_audio_samplesize);
 
+		if (media_info->audio_specific_config->empty() == false)
+		{
+			// The consumers of raw AAC (such as RTMP/MP4) use this instead of parsing the ADTS header of the frames
+			new_track->SetCodecExtradata(*media_info->audio_specific_config);
+		}
+
 		if (media_info->audio_channels == 1)
 		{
 			new_track->GetChannel().SetLayout(common::AudioChannel::Layout::LayoutMono);
@@ -251,7 +258,9 @@ bool RtmpProvider::OnVideoData(info::application_id_t application_id,
 
 
 	int64_t cts = 0;
-	stream->ConvertToVideoData( new_data, cts);
+	// The positions of NAL units are obtained while converting, so MediaRouter doesn't need to scan the start codes
+	FragmentationHeader fragmentation;
+	stream->ConvertToVideoData(new_data, cts, &fragmentation);
 	if(new_data->GetLength() <= 0)
 	{
 		return true;
@@ -286,6 +295,8 @@ bool RtmpProvider::OnVideoData(info::application_id_t application_id,
 											  // duration,
 											  frame_type == RtmpFrameType::VideoIFrame ? MediaPacketFlag::Key : MediaPacketFlag::NoFlag);
 
+	pbuf->SetFragHeader(&fragmentation);
+
 	application->SendFrame(stream, std::move(pbuf));
 
 	return true;
@@ -318,13 +329,12 @@ bool RtmpProvider::OnAudioData(info::application_id_t application_id,
 		stream_metrics->IncreaseBytesIn(data->GetLength());
 	}
 
-	// TODO: This is a memory copy overhead code.
-	// Change is required in a way that does not copy memory.
-	const std::shared_ptr<ov::Data> &new_data = data->Clone();
-
 	// TODO: It is currently fixed to AAC.
 	// Depending on the codec, the bitstream conversion must be processed.
-	if(stream->ConvertToAudioData(new_data) == 0)
+	// The ADTS header is made once per packet, so the packetizers of TS use the frame as it is
+	auto new_data = stream->ConvertToAudioData(data);
+
+	if(new_data == nullptr)
 	{
 		return true;
 	}
@@ -18,7 +18,7 @@ RtmpServer::~RtmpServer()
 	OV_ASSERT2(_physical_port == nullptr);
 }
 
-bool RtmpServer::Start(const ov::SocketAddress &address)
+bool RtmpServer::Start(const ov::SocketAddress &address, int reactor_count, int worker_count, bool worker_affinity)
 {
 	if (_physical_port != nullptr)
 	{
@@ -26,7 +26,7 @@ bool RtmpServer::Start(const ov::SocketAddress &address)
 		return false;
 	}
 
-	_physical_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Tcp, address);
+	_physical_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Tcp, address, reactor_count, worker_count, worker_affinity);
 
 	if (_physical_port == nullptr)
 	{
@@ -351,7 +351,7 @@ bool RtmpServer::OnDeleteStream(ov::ClientSocket *remote,
 
 ov::DelayQueueAction RtmpServer::OnGarbageCheck(void *parameter)
 {
-	time_t current_time = ::time(nullptr);
+	int64_t current_time = ov::Clock::CachedNowSec();
 	std::map<ov::Socket *, std::shared_ptr<RtmpChunkStream>> garbage_list;
 
 	{
@@ -367,7 +367,7 @@ ov::DelayQueueAction RtmpServer::OnGarbageCheck(void *parameter)
 				logtw("RTMP input stream has timed out: [%s/%s] (%u/%u), elapsed: %d, threshold: %d",
 					  chunk_stream->GetAppName().CStr(), chunk_stream->GetStreamName().CStr(),
 					  chunk_stream->GetAppId(), chunk_stream->GetStreamId(),
-					  elapsed, MAX_STREAM_PACKET_GAP);
+					  static_cast<int>(elapsed), MAX_STREAM_PACKET_GAP);
 
 				garbage_list.emplace(item);
 			}
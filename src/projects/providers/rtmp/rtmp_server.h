@@ -22,7 +22,8 @@ public:
     RtmpServer() = default;
     virtual ~RtmpServer();
 
-    bool Start(const ov::SocketAddress &address);
+    bool Start(const ov::SocketAddress &address, int reactor_count = 1,
+               int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT, bool worker_affinity = false);
     bool Stop();
     bool AddObserver(const std::shared_ptr<RtmpObserver> &observer);
     bool RemoveObserver(const std::shared_ptr<RtmpObserver> &observer);
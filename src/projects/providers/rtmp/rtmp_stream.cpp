@@ -46,13 +46,13 @@ bool RtmpStream::Stop()
 	return true;
 }
 
-bool RtmpStream::ConvertToVideoData(const std::shared_ptr<ov::Data> &data, int64_t &cts)
+bool RtmpStream::ConvertToVideoData(const std::shared_ptr<ov::Data> &data, int64_t &cts, FragmentationHeader *fragmentation)
 {
-	return _bsfv.Convert(data, cts);
+	return _bsfv.Convert(data, cts, fragmentation);
 }
 
 
-uint32_t RtmpStream::ConvertToAudioData(const std::shared_ptr<ov::Data> &data)
+std::shared_ptr<ov::Data> RtmpStream::ConvertToAudioData(const std::shared_ptr<const ov::Data> &data)
 {
-	return _bsfa.convert_to(data);
+	return _bsfa.Convert(data);
 }
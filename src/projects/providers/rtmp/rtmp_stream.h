@@ -30,8 +30,9 @@ public:
 	bool Start() override;
 	bool Stop() override;
 
-	bool ConvertToVideoData(const std::shared_ptr<ov::Data> &data, int64_t &cts);
-	uint32_t ConvertToAudioData(const std::shared_ptr<ov::Data> &data);
+	bool ConvertToVideoData(const std::shared_ptr<ov::Data> &data, int64_t &cts, FragmentationHeader *fragmentation = nullptr);
+	// Returns nullptr if the data is not an audio frame (such as the sequence header)
+	std::shared_ptr<ov::Data> ConvertToAudioData(const std::shared_ptr<const ov::Data> &data);
 
 private:
 	// bitstream filters
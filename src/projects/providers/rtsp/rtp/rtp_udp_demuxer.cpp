@@ -0,0 +1,191 @@
+#include "rtp_udp_demuxer.h"
+#include "rtp_udp_track.h"
+#include "rtp_packet_header.h"
+#include "../rtcp/rtcp_packet_header.h"
+
+#define OV_LOG_TAG "RtpUdpDemuxer"
+
+RtpUdpDemuxer::ConnectionObserver::ConnectionObserver(RtpUdpDemuxer &demuxer) : demuxer_(demuxer)
+{
+}
+
+void RtpUdpDemuxer::RtpConnectionObserver::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
+    const ov::SocketAddress &address,
+    const std::shared_ptr<const ov::Data> &data)
+{
+    demuxer_.OnRtpPacket(address, data);
+}
+
+void RtpUdpDemuxer::RtcpConnectionObserver::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
+    const ov::SocketAddress &address,
+    const std::shared_ptr<const ov::Data> &data)
+{
+    demuxer_.OnRtcpPacket(address, data);
+}
+
+RtpUdpDemuxer::RtpUdpDemuxer() : rtp_observer_(*this),
+    rtcp_observer_(*this)
+{
+}
+
+RtpUdpDemuxer::~RtpUdpDemuxer()
+{
+    Stop();
+}
+
+bool RtpUdpDemuxer::Start(const ov::SocketAddress &rtp_address, int reactor_count)
+{
+    auto rtcp_address = rtp_address;
+    rtcp_address.SetPort(rtp_address.Port() + 1);
+
+    rtp_physical_port_ = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Udp, rtp_address, reactor_count);
+    rtcp_physical_port_ = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Udp, rtcp_address, reactor_count);
+    if (rtp_physical_port_ == nullptr || rtcp_physical_port_ == nullptr)
+    {
+        logte("Cannot open the shared RTP/RTCP ports %s/%u", rtp_address.ToString().CStr(), rtcp_address.Port());
+        Stop();
+        return false;
+    }
+    rtp_physical_port_->AddObserver(&rtp_observer_);
+    rtcp_physical_port_->AddObserver(&rtcp_observer_);
+
+    logti("RTSP UDP tracks are received on %s/%u (reactors: %d)", rtp_address.ToString().CStr(), rtcp_address.Port(), reactor_count);
+    return true;
+}
+
+void RtpUdpDemuxer::Stop()
+{
+    if (rtp_physical_port_)
+    {
+        rtp_physical_port_->RemoveObserver(&rtp_observer_);
+        PhysicalPortManager::Instance()->DeletePort(rtp_physical_port_);
+        rtp_physical_port_ = nullptr;
+    }
+    if (rtcp_physical_port_)
+    {
+        rtcp_physical_port_->RemoveObserver(&rtcp_observer_);
+        PhysicalPortManager::Instance()->DeletePort(rtcp_physical_port_);
+        rtcp_physical_port_ = nullptr;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(sources_mutex_);
+    rtp_sources_.clear();
+    rtcp_sources_.clear();
+}
+
+bool RtpUdpDemuxer::IsStarted() const
+{
+    return rtp_physical_port_ != nullptr;
+}
+
+void RtpUdpDemuxer::GetServerPorts(uint16_t &rtp_port, uint16_t &rtcp_port) const
+{
+    rtp_port = rtp_physical_port_->GetAddress().Port();
+    rtcp_port = rtcp_physical_port_->GetAddress().Port();
+}
+
+bool RtpUdpDemuxer::AddTrack(const ov::SocketAddress &rtp_source, const ov::SocketAddress &rtcp_source, RtpUdpTrack *track, uint32_t stream_id)
+{
+    std::unique_lock<std::shared_mutex> lock(sources_mutex_);
+    // Two tracks cannot be sent from the same address/port since they could not be told apart before their SSRCs are known
+    if (rtp_sources_.find(rtp_source) != rtp_sources_.end() || rtcp_sources_.find(rtcp_source) != rtcp_sources_.end())
+    {
+        logte("Source %s is already used by another track", rtp_source.ToString().CStr());
+        return false;
+    }
+    rtp_sources_.emplace(rtp_source, Source{ .track_ = track, .stream_id_ = stream_id });
+    rtcp_sources_.emplace(rtcp_source, Source{ .track_ = track, .stream_id_ = stream_id });
+    return true;
+}
+
+void RtpUdpDemuxer::RemoveStream(uint32_t stream_id)
+{
+    std::unique_lock<std::shared_mutex> lock(sources_mutex_);
+    for (auto *sources : { &rtp_sources_, &rtcp_sources_ })
+    {
+        for (auto source_iterator = sources->begin(); source_iterator != sources->end();)
+        {
+            if (source_iterator->second.stream_id_ == stream_id)
+            {
+                source_iterator = sources->erase(source_iterator);
+            }
+            else
+            {
+                ++source_iterator;
+            }
+        }
+    }
+}
+
+void RtpUdpDemuxer::OnRtpPacket(const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+{
+    if (data->GetLength() < RtpPacketHeaderSize)
+    {
+        return;
+    }
+    const auto ssrc = ntohl(*reinterpret_cast<const uint32_t*>(data->GetDataAs<uint8_t>() + 8));
+    Dispatch(rtp_sources_, address, ssrc, data, false);
+}
+
+void RtpUdpDemuxer::OnRtcpPacket(const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+{
+    // The track reads the whole first packet of the compound packet, so a truncated one is dropped here
+    if (data->GetLength() < RtcpPacketHeaderSize)
+    {
+        return;
+    }
+    const auto *rtcp_packet = data->GetDataAs<uint8_t>();
+    const size_t rtcp_packet_size = (ntohs(*reinterpret_cast<const uint16_t*>(rtcp_packet + 2)) + 1) * 4;
+    if (data->GetLength() < rtcp_packet_size)
+    {
+        return;
+    }
+    const auto ssrc = ntohl(*reinterpret_cast<const uint32_t*>(rtcp_packet + 4));
+    Dispatch(rtcp_sources_, address, ssrc, data, true);
+}
+
+void RtpUdpDemuxer::Dispatch(std::unordered_map<ov::SocketAddress, Source> &sources, const ov::SocketAddress &address, uint32_t ssrc, const std::shared_ptr<const ov::Data> &data, bool is_rtcp)
+{
+    auto add_packet = [&](RtpUdpTrack *track) {
+        const auto *packet = data->GetDataAs<uint8_t>();
+        auto packet_data = std::make_shared<std::vector<uint8_t>>(packet, packet + data->GetLength());
+        is_rtcp ? track->AddRtcpPacket(packet_data) : track->AddRtpPacket(packet_data);
+    };
+
+    {
+        std::shared_lock<std::shared_mutex> lock(sources_mutex_);
+        auto source_iterator = sources.find(address);
+        if (source_iterator == sources.end())
+        {
+            logtd("Packet from unknown source %s is dropped", address.ToString().CStr());
+            return;
+        }
+        auto &source = source_iterator->second;
+        if (source.ssrc_.has_value())
+        {
+            if (source.ssrc_.value() == ssrc)
+            {
+                add_packet(source.track_);
+            }
+            return;
+        }
+    }
+
+    // The first packet of the source locks its SSRC
+    std::unique_lock<std::shared_mutex> lock(sources_mutex_);
+    auto source_iterator = sources.find(address);
+    if (source_iterator == sources.end())
+    {
+        return;
+    }
+    auto &source = source_iterator->second;
+    if (source.ssrc_.has_value() == false)
+    {
+        logtd("SSRC %u is locked for source %s", ssrc, address.ToString().CStr());
+        source.ssrc_ = ssrc;
+    }
+    if (source.ssrc_.value() == ssrc)
+    {
+        add_packet(source.track_);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <base/ovsocket/ovsocket.h>
+#include <modules/physical_port/physical_port.h>
+#include <modules/physical_port/physical_port_manager.h>
+
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+class RtpUdpTrack;
+
+/*
+    Receives the RTP/RTCP packets of all the UDP tracks on a single pair of ports (RTCP on the RTP port + 1)
+    instead of opening a pair of ports per track, and hands them to the track by the source address of the packet,
+    the SSRC of a source is locked on its first packet so a stray sender reusing the address/port is dropped.
+
+    The ports are opened with SO_REUSEPORT (reactor_count sockets each), so the receiving is spread over the reactor threads
+    and each socket drains the packets with recvmmsg.
+
+    Lock order: the demuxer lock is held while the packet is handed to the track (which takes the server lock),
+    so the sources must be added/removed without holding the server lock.
+*/
+class RtpUdpDemuxer
+{
+    class ConnectionObserver : public PhysicalPortObserver
+    {
+    public:
+        ConnectionObserver(RtpUdpDemuxer &demuxer);
+
+    protected:
+        RtpUdpDemuxer &demuxer_;
+    };
+
+    class RtpConnectionObserver : public ConnectionObserver
+    {
+    public:
+        using ConnectionObserver::ConnectionObserver;
+
+    protected:
+        void OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
+                            const ov::SocketAddress &address,
+                            const std::shared_ptr<const ov::Data> &data) override;
+    };
+
+    class RtcpConnectionObserver : public ConnectionObserver
+    {
+    public:
+        using ConnectionObserver::ConnectionObserver;
+
+    protected:
+        void OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
+                            const ov::SocketAddress &address,
+                            const std::shared_ptr<const ov::Data> &data) override;
+    };
+
+    struct Source
+    {
+        RtpUdpTrack *track_;
+        uint32_t stream_id_;
+        // Locked on the first packet of the source
+        std::optional<uint32_t> ssrc_;
+    };
+
+public:
+    RtpUdpDemuxer();
+    RtpUdpDemuxer(const RtpUdpDemuxer&) = delete;
+    ~RtpUdpDemuxer();
+
+    bool Start(const ov::SocketAddress &rtp_address, int reactor_count);
+    void Stop();
+
+    bool IsStarted() const;
+    void GetServerPorts(uint16_t &rtp_port, uint16_t &rtcp_port) const;
+
+    // rtp_source/rtcp_source: the address of the camera and the client_port of the SETUP request
+    bool AddTrack(const ov::SocketAddress &rtp_source, const ov::SocketAddress &rtcp_source, RtpUdpTrack *track, uint32_t stream_id);
+    void RemoveStream(uint32_t stream_id);
+
+private:
+    void OnRtpPacket(const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data);
+    void OnRtcpPacket(const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data);
+    // Hands the packet to the track of the source if the SSRC matches
+    void Dispatch(std::unordered_map<ov::SocketAddress, Source> &sources, const ov::SocketAddress &address, uint32_t ssrc, const std::shared_ptr<const ov::Data> &data, bool is_rtcp);
+
+private:
+    std::shared_ptr<PhysicalPort> rtp_physical_port_;
+    std::shared_ptr<PhysicalPort> rtcp_physical_port_;
+    RtpConnectionObserver rtp_observer_;
+    RtcpConnectionObserver rtcp_observer_;
+
+    mutable std::shared_mutex sources_mutex_;
+    std::unordered_map<ov::SocketAddress, Source> rtp_sources_;
+    std::unordered_map<ov::SocketAddress, Source> rtcp_sources_;
+};
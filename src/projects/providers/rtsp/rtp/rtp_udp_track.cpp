@@ -34,6 +34,11 @@ void RtpUdpTrack::RtcpConnectionObserver::OnDataReceived(const std::shared_ptr<o
 
 void RtpUdpTrack::GetServerPorts(uint16_t &rtp_port, uint16_t &rtcp_port)
 {
+    if (demuxer_)
+    {
+        demuxer_->GetServerPorts(rtp_port, rtcp_port);
+        return;
+    }
     rtp_port = rtp_physical_port_->GetAddress().Port();
     rtcp_port = rtcp_physical_port_->GetAddress().Port();
 }
@@ -55,3 +60,38 @@ RtpUdpTrack::RtpUdpTrack(RtspServer &rtsp_server,
     rtcp_physical_port_->AddObserver(&rtcp_observer_);
 }
 
+RtpUdpTrack::RtpUdpTrack(RtspServer &rtsp_server,
+    common::MediaType media_type,
+    common::MediaCodecId media_codec_id,
+    uint32_t stream_id,
+    uint8_t track_id,
+    uint32_t clock_frequency,
+    RtpUdpDemuxer &demuxer) : RtpTrack(rtsp_server, media_type, media_codec_id, stream_id, track_id, clock_frequency),
+    demuxer_(&demuxer),
+    rtp_observer_(*this),
+    rtcp_observer_(*this)
+{
+}
+
+RtpUdpTrack::~RtpUdpTrack()
+{
+    // The sources of the demuxer are removed by the server before the stream is deleted (see the lock order of RtpUdpDemuxer)
+    if (rtp_physical_port_)
+    {
+        rtp_physical_port_->RemoveObserver(&rtp_observer_);
+    }
+    if (rtcp_physical_port_)
+    {
+        rtcp_physical_port_->RemoveObserver(&rtcp_observer_);
+    }
+}
+
+bool RtpUdpTrack::AddSource(const ov::SocketAddress &rtp_source, const ov::SocketAddress &rtcp_source)
+{
+    if (demuxer_ == nullptr)
+    {
+        return true;
+    }
+    return demuxer_->AddTrack(rtp_source, rtcp_source, this, stream_id_);
+}
+
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rtp_track.h"
+#include "rtp_udp_demuxer.h"
 
 #include <modules/physical_port/physical_port.h>
 #include <modules/physical_port/physical_port_manager.h>
@@ -57,10 +58,34 @@ public:
         uint32_t clock_frequency,
         std::shared_ptr<PhysicalPort> rtp_physical_port,
         std::shared_ptr<PhysicalPort> rtcp_physical_port);
+    // The packets are received on the shared ports of the demuxer
+    RtpUdpTrack(RtspServer &rtsp_server,
+        common::MediaType media_type,
+        common::MediaCodecId media_codec_id,
+        uint32_t stream_id,
+        uint8_t track_id,
+        uint32_t clock_frequency,
+        RtpUdpDemuxer &demuxer);
     RtpUdpTrack(const RtpUdpTrack&) = delete;
+    ~RtpUdpTrack() override;
 
 public:
     void GetServerPorts(uint16_t &rtp_port, uint16_t &rtcp_port);
+    // Registers the client ports of the SETUP request to the demuxer (shared ports only),
+    // must not be called with the server lock held
+    bool AddSource(const ov::SocketAddress &rtp_source, const ov::SocketAddress &rtcp_source);
+
+    template<typename U>
+    static std::unique_ptr<U> Create(RtspServer &rtsp_server,
+        common::MediaType media_type,
+        common::MediaCodecId media_codec_id,
+        uint32_t stream_id,
+        uint8_t track_id,
+        uint32_t clock_frequency,
+        RtpUdpDemuxer &demuxer)
+    {
+        return std::make_unique<U>(rtsp_server, media_type, media_codec_id, stream_id, track_id, clock_frequency, demuxer);
+    }
 
     template< typename U, ov::SocketType socket_type>
     static std::unique_ptr<U> Create(RtspServer &rtsp_server,
@@ -102,6 +127,7 @@ public:
     }
 
 private:
+    RtpUdpDemuxer *demuxer_ = nullptr;
     std::shared_ptr<PhysicalPort> rtp_physical_port_;
     std::shared_ptr<PhysicalPort> rtcp_physical_port_;
     RtpConnectionObserver rtp_observer_;
@@ -196,6 +196,15 @@ void RtspConnection::OnRtspRequest(const RtspRequest &rtsp_request)
                     SendResponse(rtsp_request, 500);
                     return;                 
                 }
+                // The packets of the shared ports are told apart by the address of the camera and the client ports
+                auto rtp_source = *remote_->GetRemoteAddress(), rtcp_source = *remote_->GetRemoteAddress();
+                rtp_source.SetPort(client_rtp_port);
+                rtcp_source.SetPort(client_rtcp_port);
+                if (rtp_udp_track->AddSource(rtp_source, rtcp_source) == false)
+                {
+                    SendResponse(rtsp_request, 461);
+                    return;
+                }
                 rtp_udp_track->GetServerPorts(server_rtp_port, server_rtcp_port);
                 auto data = std::make_shared<ov::Data>();
                 ov::ByteStream byte_stream(data.get());
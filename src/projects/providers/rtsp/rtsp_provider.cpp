@@ -45,6 +45,17 @@ namespace pvd
         rtsp_server_ = std::make_shared<RtspServer>();
 
         rtsp_server_->AddObserver(RtspObserver::GetSharedPtr());
+
+        const auto &rtsp_udp_config = server.GetBind().GetProviders().GetRtspUdp();
+        if (rtsp_udp_config.GetPort() > 0)
+        {
+            auto rtp_address = ov::SocketAddress(server.GetIp(), static_cast<uint16_t>(rtsp_udp_config.GetPort()));
+            if (rtsp_server_->StartUdpDemuxer(rtp_address, rtsp_udp_config.GetReactorCount()) == false)
+            {
+                return false;
+            }
+        }
+
         if(rtsp_server_->Start(rtsp_address) == false)
         {
             return false;
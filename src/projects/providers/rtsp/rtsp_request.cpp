@@ -1,5 +1,6 @@
 #include "rtsp_request.h"
 
+#include <charconv>
 #include <string>
 
 RtspRequest::RtspRequest(std::vector<uint8_t> data) : data_(std::move(data))
@@ -102,11 +103,11 @@ std::unique_ptr<RtspRequest> RtspRequest::Parse(std::vector<uint8_t> data)
                     std::string_view header_value(reinterpret_cast<const char*>(line_start_position) + header_start_position, line.size() - header_start_position);
                     if (header_name == "CSeq")
                     {
-                        rtsp_request->cseq_ = std::stoi(std::string(header_value.begin(), header_value.end()));
+                        std::from_chars(header_value.data(), header_value.data() + header_value.size(), rtsp_request->cseq_);
                     }
                     else if (header_name == "Content-Length")
                     {
-                        rtsp_request->content_length_ = std::stoi(std::string(header_value.begin(), header_value.end()));
+                        std::from_chars(header_value.data(), header_value.data() + header_value.size(), rtsp_request->content_length_);
                     }
                     else
                     {
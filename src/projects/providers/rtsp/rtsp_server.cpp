@@ -165,6 +165,35 @@ void RtspServer::OnDisconnected(const std::shared_ptr<ov::Socket> &remote,
     }
 }
 
+bool RtspServer::StartUdpDemuxer(const ov::SocketAddress &rtp_address, int reactor_count)
+{
+    return rtp_udp_demuxer_.Start(rtp_address, reactor_count);
+}
+
+RtpUdpDemuxer &RtspServer::GetUdpDemuxer()
+{
+    return rtp_udp_demuxer_;
+}
+
+void RtspServer::RemoveUdpSources(const std::string &stream_path)
+{
+    if (rtp_udp_demuxer_.IsStarted() == false)
+    {
+        return;
+    }
+    uint32_t stream_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto stream_iterator = stream_ids_.find(stream_path);
+        if (stream_iterator == stream_ids_.end())
+        {
+            return;
+        }
+        stream_id = stream_iterator->second;
+    }
+    rtp_udp_demuxer_.RemoveStream(stream_id);
+}
+
 bool RtspServer::Disconnect(const ov::String &app_name, uint32_t stream_id)
 {
     return true;
@@ -206,6 +235,7 @@ bool RtspServer::OnStreamAnnounced(const std::string_view &app_name,
 {
     // Not sure if announce when the stream arrives or wait till all the tracks are set up, currently announce as soon as it shows up
     const auto stream_path = std::string(app_name.data(), app_name.size()).append("/").append(std::string(stream_name.data(), stream_name.size()));
+    RemoveUdpSources(stream_path);
     
     std::lock_guard<std::mutex> lock(mutex_);
     {
@@ -282,7 +312,15 @@ bool RtspServer::OnUdpStreamTrackSetup(const std::string_view &rtsp_uri,
         return false;
     }
 
-    auto rtp_udp_track = CreateTrack<RtpUdpTrack>(stream_track, *this, rtp_udp_port_range_);
+    std::unique_ptr<RtpUdpTrack> rtp_udp_track;
+    if (rtp_udp_demuxer_.IsStarted())
+    {
+        rtp_udp_track = CreateTrack<RtpUdpTrack>(stream_track, *this, rtp_udp_demuxer_);
+    }
+    else
+    {
+        rtp_udp_track = CreateTrack<RtpUdpTrack>(stream_track, *this, rtp_udp_port_range_);
+    }
     if (rtp_udp_track == nullptr)
     {
         return false;
@@ -358,6 +396,7 @@ bool RtspServer::OnStreamTeardown(const std::string_view &app_name,
     const std::string_view &stream_name)
 {
     const auto stream_path = std::string(app_name.data(), app_name.size()).append("/").append(std::string(stream_name.data(), stream_name.size()));
+    RemoveUdpSources(stream_path);
     std::lock_guard<std::mutex> lock(mutex_);
     auto stream_iterator = stream_ids_.find(stream_path);
     if (stream_iterator != stream_ids_.end())
@@ -5,6 +5,7 @@
 #include "rtsp_connection.h"
 #include "rtp/rtp_track.h"
 #include "rtp/rtp_udp_track.h"
+#include "rtp/rtp_udp_demuxer.h"
 #include "rtp/rtp_tcp_track.h"
 #include "rtcp/rtcp_packet_header.h"
 
@@ -53,6 +54,10 @@ public:
     virtual ~RtspServer() = default;
 
 public:
+    // The UDP tracks are received on the shared ports (<Bind><Providers><RTSPUDP>) instead of a pair of ports per track
+    bool StartUdpDemuxer(const ov::SocketAddress &rtp_address, int reactor_count);
+    RtpUdpDemuxer &GetUdpDemuxer();
+
     bool Disconnect(const ov::String &app_name, uint32_t stream_id);
 
     bool OnStreamAnnounced(const std::string_view &app_name, 
@@ -101,6 +106,8 @@ private:
     StreamTrackInfo *FindTrackStream(const std::lock_guard<std::mutex> &lock, const std::string &track_path);
  
     void DeleteStream(const std::lock_guard<std::mutex> &lock, std::unordered_map<std::string, uint32_t>::iterator &stream_id_iterator);
+    // Must be called before the stream is deleted, without holding the lock (see RtpUdpDemuxer)
+    void RemoveUdpSources(const std::string &stream_path);
 
 private:
     std::mutex mutex_;
@@ -117,4 +124,5 @@ private:
     std::unordered_map<std::string, StreamTrackInfo> stream_tracks_;
     // TODO(rubu): make these configurable
     ov::PortRange<ov::SocketType::Udp> rtp_udp_port_range_ = {2000, 3000};
+    RtpUdpDemuxer rtp_udp_demuxer_;
 };
@@ -8,6 +8,8 @@
 #include "rtspc_stream.h"
 #include "modules/aac/aac.h"
 
+#include <orchestrator/orchestrator.h>
+
 #define OV_LOG_TAG "RtspcStream"
 
 namespace pvd
@@ -57,7 +59,19 @@ namespace pvd
 	{
 		Stop();
 
-		Release();
+		DisconnectOrigin();
+
+		if(_cumulative_pts != nullptr)
+		{
+			delete[] _cumulative_pts;
+			_cumulative_pts = nullptr;
+		}
+		
+		if(_cumulative_dts != nullptr)
+		{
+			delete[] _cumulative_dts;
+			_cumulative_dts = nullptr;
+		}
 	}
 
 	void RtspcStream::Release()
@@ -73,16 +87,6 @@ namespace pvd
 			av_dict_free(&_format_options);
 			_format_options = nullptr;
 		}	
-
-		if(_cumulative_pts != nullptr)
-		{
-			delete[] _cumulative_pts;
-		}
-		
-		if(_cumulative_dts != nullptr)
-		{
-			delete[] _cumulative_dts;
-		}
 	}
 
 	bool RtspcStream::Start()
@@ -94,9 +98,30 @@ namespace pvd
 
 		_stop_watch.Start();
 
+		// The URLs are ordered by the Orchestrator (See <Origin><Balance>)
+		for(const auto &url : _url_list)
+		{
+			if(ConnectAndDescribe(url))
+			{
+				return pvd::Stream::Start();
+			}
+		}
+
+		return false;
+	}
+
+	bool RtspcStream::ConnectAndDescribe(const std::shared_ptr<const ov::Url> &url)
+	{
+		auto &origin_health_table = Orchestrator::GetInstance()->GetOriginHealthTable();
+
+		_curr_url = url;
+		_state = State::IDLE;
+
 		auto begin = std::chrono::steady_clock::now();
 		if (!ConnectTo())
 		{
+			origin_health_table.OnFailed(url->Source());
+			Release();
 			return false;
 		}
 
@@ -107,6 +132,8 @@ namespace pvd
 		begin = std::chrono::steady_clock::now();
 		if (!RequestDescribe())
 		{
+			origin_health_table.OnFailed(url->Source());
+			Release();
 			return false;
 		}
 
@@ -114,7 +141,84 @@ namespace pvd
 		elapsed = end - begin;
 		_origin_response_time_msec = elapsed.count();
 
-		return pvd::Stream::Start();
+		origin_health_table.OnConnected(url->Source(), _origin_request_time_msec + _origin_response_time_msec);
+		_is_origin_connected = true;
+
+		return true;
+	}
+
+	void RtspcStream::DisconnectOrigin()
+	{
+		if(_is_origin_connected)
+		{
+			Orchestrator::GetInstance()->GetOriginHealthTable().OnDisconnected(_curr_url->Source());
+			_is_origin_connected = false;
+		}
+
+		Release();
+	}
+
+	bool RtspcStream::Failover()
+	{
+		if(_curr_url == nullptr)
+		{
+			return false;
+		}
+
+		auto &origin_health_table = Orchestrator::GetInstance()->GetOriginHealthTable();
+		auto failed_url = _curr_url;
+
+		logtw("%s/%s(%u) The connection to the origin is broken, trying to fail over: %s",
+			  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), failed_url->Source().CStr());
+
+		DisconnectOrigin();
+		origin_health_table.OnFailed(failed_url->Source());
+
+		size_t failed_index = 0;
+		for(size_t index = 0; index < _url_list.size(); index++)
+		{
+			if(_url_list[index] == failed_url)
+			{
+				failed_index = index;
+				break;
+			}
+		}
+
+		// The next origins are tried first (including the failed one at last),
+		// and the origins in the back-off period are tried after the available ones
+		std::vector<std::shared_ptr<const ov::Url>> available_url_list;
+		std::vector<std::shared_ptr<const ov::Url>> unavailable_url_list;
+
+		for(size_t count = 1; count <= _url_list.size(); count++)
+		{
+			auto &url = _url_list[(failed_index + count) % _url_list.size()];
+
+			if(origin_health_table.IsAvailable(url->Source()))
+			{
+				available_url_list.push_back(url);
+			}
+			else
+			{
+				unavailable_url_list.push_back(url);
+			}
+		}
+
+		available_url_list.insert(available_url_list.end(), unavailable_url_list.begin(), unavailable_url_list.end());
+
+		for(const auto &url : available_url_list)
+		{
+			if(ConnectAndDescribe(url) && RequestPlay())
+			{
+				logti("%s/%s(%u) has failed over to the origin: %s",
+					  GetApplicationInfo().GetName().CStr(), GetName().CStr(), GetId(), url->Source().CStr());
+
+				return true;
+			}
+		}
+
+		_state = State::ERROR;
+
+		return false;
 	}
 
 	bool RtspcStream::Play()
@@ -177,7 +281,22 @@ namespace pvd
 		_format_context->interrupt_callback.callback = InterruptCallback;
 		_format_context->interrupt_callback.opaque = this;
 
-		::av_dict_set(&_format_options, "rtsp_transport", "tcp", 0);
+		auto provider_config = GetApplicationInfo().GetProvider<cfg::RtspPullProvider>();
+
+		if((provider_config != nullptr) && (provider_config->GetTransport().LowerCaseString() == "udp"))
+		{
+			// libavformat tries UDP first and then TCP if the server doesn't support UDP.
+			// If the server supports RTP/AVPF, it also sends RTCP NACK for the missing packets.
+			::av_dict_set(&_format_options, "rtsp_transport", "udp+tcp", 0);
+			::av_dict_set_int(&_format_options, "reorder_queue_size", provider_config->GetReorderQueueSize(), 0);
+			// in microseconds
+			::av_dict_set_int(&_format_options, "max_delay", static_cast<int64_t>(provider_config->GetMaxDelay()) * 1000, 0);
+			::av_dict_set_int(&_format_options, "buffer_size", RTSP_PULL_UDP_BUFFER_SIZE, 0);
+		}
+		else
+		{
+			::av_dict_set(&_format_options, "rtsp_transport", "tcp", 0);
+		}
 		
 		_format_context->flags |= AVFMT_FLAG_GENPTS;
 		// This is a feature added to the existing ffmpeg for OME.
@@ -225,6 +344,8 @@ namespace pvd
 			return false;
 		}
 
+		std::vector<std::shared_ptr<MediaTrack>> tracks;
+
 		for (uint32_t track_id = 0; track_id < _format_context->nb_streams; track_id++)
 		{
 			AVStream *stream = _format_context->streams[track_id];
@@ -281,18 +402,54 @@ namespace pvd
 													common::AudioChannel::Layout::LayoutUnknown));
 			}
 
-			AddTrack(new_track);
+			tracks.push_back(new_track);
+		}
+
+		if(GetTracks().empty())
+		{
+			for(auto &track : tracks)
+			{
+				AddTrack(track);
+			}
+		}
+		else
+		{
+			// After failover, the origin must have the same tracks because the tracks cannot be changed while the stream is being played
+			bool is_same_tracks = (GetTracks().size() == tracks.size()) && (_cumulative_count == _format_context->nb_streams);
+
+			for(auto &track : tracks)
+			{
+				auto current_track = GetTrack(track->GetId());
+
+				if((current_track == nullptr) || (current_track->GetMediaType() != track->GetMediaType()) || (current_track->GetCodecId() != track->GetCodecId()))
+				{
+					is_same_tracks = false;
+					break;
+				}
+			}
+
+			if(is_same_tracks == false)
+			{
+				_state = State::ERROR;
+				logte("The tracks of the origin are different from the tracks of the stream: %s", _curr_url->Source().CStr());
+
+				return false;
+			}
 		}
 
 		// Sometimes the values of PTS/DTS are negative or incorrect(invalid pts) 
 		// Decided to calculate PTS/DTS as the cumulative value of the packet duration.
-		_cumulative_pts = new int64_t[_format_context->nb_streams];
-		_cumulative_dts = new int64_t[_format_context->nb_streams];
-
-		for(uint32_t i=0 ; i<_format_context->nb_streams ; ++i)
+		if(_cumulative_pts == nullptr)
 		{
-			_cumulative_pts[i] = 0;
-			_cumulative_dts[i] = 0;
+			_cumulative_count = _format_context->nb_streams;
+			_cumulative_pts = new int64_t[_cumulative_count];
+			_cumulative_dts = new int64_t[_cumulative_count];
+
+			for(uint32_t i=0 ; i<_cumulative_count ; ++i)
+			{
+				_cumulative_pts[i] = 0;
+				_cumulative_dts[i] = 0;
+			}
 		}
 
 		_state = State::DESCRIBED;
@@ -331,6 +488,32 @@ namespace pvd
 	}
 
 	Stream::ProcessMediaResult RtspcStream::ProcessMediaPacket()
+	{
+		// Read the queued packets together to reduce the wake-ups of the StreamMotor
+		auto result = ReadMediaPacket();
+
+		for(int count = 1; (result == ProcessMediaResult::PROCESS_MEDIA_SUCCESS) && (count < RTSP_PULL_MAX_PACKETS_PER_EVENT); count++)
+		{
+			if(_state != State::PLAYING)
+			{
+				break;
+			}
+
+			auto next_result = ReadMediaPacket();
+
+			if(next_result == ProcessMediaResult::PROCESS_MEDIA_TRY_AGAIN)
+			{
+				// There is no more packet for now
+				break;
+			}
+
+			result = next_result;
+		}
+
+		return result;
+	}
+
+	Stream::ProcessMediaResult RtspcStream::ReadMediaPacket()
 	{
 		AVPacket packet;
 		av_init_packet(&packet);
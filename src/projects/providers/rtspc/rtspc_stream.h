@@ -23,6 +23,10 @@ extern "C"
 
 //TODO(Dimiden): It needs to move to configuration
 #define RTSP_PULL_TIMEOUT_MSEC	10000
+// The maximum number of packets that are read per event, UDP transport may have many datagrams queued for an event
+#define RTSP_PULL_MAX_PACKETS_PER_EVENT	64
+// The receive buffer of the RTP/RTCP sockets when the UDP transport is used
+#define RTSP_PULL_UDP_BUFFER_SIZE	(2 * 1024 * 1024)
 
 namespace pvd
 {
@@ -41,18 +45,30 @@ namespace pvd
 		// Media data has to be processed here.
 		Stream::ProcessMediaResult ProcessMediaPacket() override;
 
+		// Connects to the other origins in the order of the URL list, and plays the same stream
+		bool Failover() override;
+
 	private:
 		bool Start() override;
 		bool Play() override;
 		bool Stop() override;
+		// Connects to the origin of the url and describes the stream, the result is reported to the Orchestrator
+		bool ConnectAndDescribe(const std::shared_ptr<const ov::Url> &url);
+		// Closes the connection to the current origin
+		void DisconnectOrigin();
 		bool ConnectTo();
 		bool RequestDescribe();
 		bool RequestPlay();
 		bool RequestStop();
 		void Release();
 
+		// Reads a packet and sends it to the application
+		Stream::ProcessMediaResult ReadMediaPacket();
+
 		std::vector<std::shared_ptr<const ov::Url>> _url_list;
 		std::shared_ptr<const ov::Url> _curr_url;
+		// Reported to the Orchestrator as connected, it is reported as disconnected when the connection is closed
+		bool _is_origin_connected = false;
 		ov::StopWatch _stop_watch;
 
 		AVFormatContext *_format_context = nullptr;
@@ -60,8 +76,10 @@ namespace pvd
 		
 		static int InterruptCallback(void *ctx);
 
+		// They are kept after failover, so the timestamps continue from the previous origin
 		int64_t *_cumulative_pts = nullptr;
 		int64_t *_cumulative_dts = nullptr;
+		uint32_t _cumulative_count = 0;
 
 		double _origin_request_time_msec = 0;
 		double _origin_response_time_msec = 0;
@@ -0,0 +1,8 @@
+LOCAL_PATH := $(call get_local_path)
+include $(DEFAULT_VARIABLES)
+
+LOCAL_TARGET := srt_provider
+
+$(call add_pkg_config,srt)
+
+include $(BUILD_STATIC_LIBRARY)
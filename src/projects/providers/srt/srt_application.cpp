@@ -0,0 +1,32 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "srt_application.h"
+
+#include "srt_stream.h"
+
+#define OV_LOG_TAG "SrtApplication"
+
+namespace pvd
+{
+	std::shared_ptr<SrtApplication> SrtApplication::Create(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info)
+	{
+		auto application = std::make_shared<SrtApplication>(provider, application_info);
+		application->Start();
+		return application;
+	}
+
+	SrtApplication::SrtApplication(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info)
+		: Application(provider, application_info)
+	{
+	}
+
+	std::shared_ptr<pvd::Stream> SrtApplication::CreatePushStream(const uint32_t stream_id, const ov::String &stream_name)
+	{
+		return SrtStream::Create(GetSharedPtrAs<pvd::Application>(), stream_id, stream_name);
+	}
+}  // namespace pvd
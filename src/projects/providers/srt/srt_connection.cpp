@@ -0,0 +1,394 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "srt_connection.h"
+
+#include <modules/h264/h264.h>
+#include <modules/h264/h264_sps.h>
+
+#include "srt_stream.h"
+
+#define OV_LOG_TAG "SrtProvider"
+
+// The number of samples in an AAC frame
+#define SRT_AAC_SAMPLES_PER_FRAME 1024
+// The timebase of MPEG-TS
+#define SRT_MPEGTS_TIMESCALE 90000
+
+using namespace common;
+
+namespace pvd
+{
+	static const int kAdtsSampleRates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350};
+
+	struct AdtsHeader
+	{
+		int sample_rate = 0;
+		int channels = 0;
+		size_t header_length = 0;
+		size_t frame_length = 0;
+	};
+
+	static bool ParseAdtsHeader(const uint8_t *data, size_t length, AdtsHeader *header)
+	{
+		if ((length < 7) || (data[0] != 0xFF) || ((data[1] & 0xF6) != 0xF0))
+		{
+			return false;
+		}
+
+		int sample_rate_index = (data[2] >> 2) & 0x0F;
+
+		if (sample_rate_index >= static_cast<int>(OV_COUNTOF(kAdtsSampleRates)))
+		{
+			return false;
+		}
+
+		header->sample_rate = kAdtsSampleRates[sample_rate_index];
+		header->channels = ((data[2] & 0x01) << 2) | ((data[3] >> 6) & 0x03);
+		// protection_absent == 0: CRC(2) follows the header
+		header->header_length = (data[1] & 0x01) ? 7 : 9;
+		header->frame_length = ((data[3] & 0x03) << 11) | (data[4] << 3) | ((data[5] >> 5) & 0x07);
+
+		return (header->frame_length > header->header_length);
+	}
+
+	// Calls the callback with each NAL unit (without the start code) of the Annex-B data.
+	template <typename Tcallback>
+	static void ForEachNalUnit(const uint8_t *data, size_t length, Tcallback callback)
+	{
+		size_t nal_unit_start = 0;
+		bool has_nal_unit = false;
+		size_t offset = 0;
+
+		while (offset + 3 <= length)
+		{
+			if ((data[offset] != 0x00) || (data[offset + 1] != 0x00) || (data[offset + 2] != 0x01))
+			{
+				// The start code is searched for from the last byte which can be a part of it
+				offset += (data[offset + 2] > 0x01) ? 3 : 1;
+				continue;
+			}
+
+			if (has_nal_unit)
+			{
+				// The zero byte of a 4 bytes start code doesn't belong to the NAL unit
+				size_t nal_unit_end = ((offset > nal_unit_start) && (data[offset - 1] == 0x00)) ? (offset - 1) : offset;
+
+				if (nal_unit_end > nal_unit_start)
+				{
+					callback(nal_unit_start, nal_unit_end - nal_unit_start);
+				}
+			}
+
+			offset += 3;
+			nal_unit_start = offset;
+			has_nal_unit = true;
+		}
+
+		if (has_nal_unit && (length > nal_unit_start))
+		{
+			callback(nal_unit_start, length - nal_unit_start);
+		}
+	}
+
+	SrtConnection::SrtConnection(const std::shared_ptr<ov::Socket> &remote, const std::shared_ptr<SrtApplication> &application, const ov::String &stream_name)
+		: _remote(remote),
+		  _application(application),
+		  _stream_name(stream_name)
+	{
+		_last_packet_time = ov::Clock::CachedNowSec();
+	}
+
+	SrtConnection::~SrtConnection()
+	{
+		OV_ASSERT2(_stream == nullptr);
+	}
+
+	bool SrtConnection::OnDataReceived(const std::shared_ptr<const ov::Data> &data)
+	{
+		_last_packet_time = ov::Clock::CachedNowSec();
+
+		if (_stream_metrics != nullptr)
+		{
+			_stream_metrics->IncreaseBytesIn(data->GetLength());
+		}
+
+		if (_demuxer.AppendData(data->GetData(), data->GetLength()) == false)
+		{
+			logte("Could not demux the data of [%s/%s] from %s, the stream must be MPEG-TS",
+				  _application->GetName().CStr(), _stream_name.CStr(), _remote->ToString().CStr());
+			return false;
+		}
+
+		if ((_is_pmt_handled == false) && _demuxer.IsPmtReceived())
+		{
+			_is_pmt_handled = true;
+
+			if (OnPmtReceived() == false)
+			{
+				return false;
+			}
+		}
+
+		while (_demuxer.IsAvailablePes())
+		{
+			auto pes = _demuxer.PopPes();
+
+			auto item = _track_map.find(pes->pid);
+			if (item == _track_map.end())
+			{
+				continue;
+			}
+
+			auto &context = item->second;
+
+			if (_stream == nullptr)
+			{
+				if (context.is_probed == false)
+				{
+					if (context.track->GetMediaType() == MediaType::Video)
+					{
+						ProbeVideo(context, *pes);
+					}
+					else
+					{
+						ProbeAudio(context, *pes);
+					}
+				}
+
+				bool is_probed = std::all_of(_track_map.begin(), _track_map.end(), [](const auto &item) -> bool {
+					return item.second.is_probed;
+				});
+
+				if (is_probed == false)
+				{
+					// The frames can't be described before the tracks are known
+					continue;
+				}
+
+				if (CreateStream() == false)
+				{
+					return false;
+				}
+			}
+
+			if (context.track->GetMediaType() == MediaType::Video)
+			{
+				SendVideoFrame(pes);
+			}
+			else
+			{
+				SendAudioFrames(pes);
+			}
+		}
+
+		return true;
+	}
+
+	void SrtConnection::Close()
+	{
+		if (_stream != nullptr)
+		{
+			_application->DeleteStream(_stream);
+			_stream = nullptr;
+		}
+	}
+
+	bool SrtConnection::OnPmtReceived()
+	{
+		bool has_video = false;
+		bool has_audio = false;
+
+		for (const auto &item : _demuxer.GetElementaryStreams())
+		{
+			auto pid = item.first;
+			auto stream_type = static_cast<MpegTsStreamType>(item.second);
+
+			// Only the first stream of each media type is ingested
+			if ((stream_type == MpegTsStreamType::H264) && (has_video == false))
+			{
+				auto track = std::make_shared<MediaTrack>();
+
+				// Video is fixed on Track 0
+				track->SetId(0);
+				track->SetMediaType(MediaType::Video);
+				track->SetCodecId(MediaCodecId::H264);
+				track->SetTimeBase(1, SRT_MPEGTS_TIMESCALE);
+
+				_track_map[pid].track = track;
+				has_video = true;
+			}
+			else if ((stream_type == MpegTsStreamType::AacAdts) && (has_audio == false))
+			{
+				auto track = std::make_shared<MediaTrack>();
+
+				// Audio is fixed on Track 1
+				track->SetId(1);
+				track->SetMediaType(MediaType::Audio);
+				track->SetCodecId(MediaCodecId::Aac);
+				track->GetSample().SetFormat(common::AudioSample::Format::S16);
+
+				_track_map[pid].track = track;
+				has_audio = true;
+			}
+			else
+			{
+				logtw("The elementary stream (PID: 0x%04X, stream type: 0x%02X) of [%s/%s] is ignored (only the first H.264 and AAC are supported)",
+					  pid, item.second, _application->GetName().CStr(), _stream_name.CStr());
+			}
+		}
+
+		if (_track_map.empty())
+		{
+			logte("There is no supported elementary stream in [%s/%s] from %s", _application->GetName().CStr(), _stream_name.CStr(), _remote->ToString().CStr());
+			return false;
+		}
+
+		return true;
+	}
+
+	void SrtConnection::ProbeVideo(TrackContext &context, const MpegTsPes &pes)
+	{
+		auto data = pes.data->GetDataAs<uint8_t>();
+
+		ForEachNalUnit(data, pes.data->GetLength(), [&](size_t offset, size_t length) {
+			H264Sps sps;
+
+			if ((context.is_probed == false) &&
+				((data[offset] & kH264NalUnitTypeMask) == static_cast<uint8_t>(H264NalUnitType::Sps)) &&
+				H264Sps::Parse(data + offset, length, sps))
+			{
+				context.track->SetWidth(sps.GetWidth());
+				context.track->SetHeight(sps.GetHeight());
+				context.track->SetFrameRate(sps.GetFps());
+
+				context.first_dts = pes.dts;
+				context.is_probed = true;
+			}
+		});
+	}
+
+	void SrtConnection::ProbeAudio(TrackContext &context, const MpegTsPes &pes)
+	{
+		AdtsHeader header;
+
+		if (ParseAdtsHeader(pes.data->GetDataAs<uint8_t>(), pes.data->GetLength(), &header) == false)
+		{
+			return;
+		}
+
+		context.track->SetSampleRate(header.sample_rate);
+		context.track->SetTimeBase(1, header.sample_rate);
+		context.track->GetChannel().SetLayout((header.channels == 1) ? AudioChannel::Layout::LayoutMono : AudioChannel::Layout::LayoutStereo);
+
+		context.first_dts = pes.dts;
+		context.is_probed = true;
+	}
+
+	bool SrtConnection::CreateStream()
+	{
+		std::vector<std::shared_ptr<MediaTrack>> tracks;
+
+		_base_timestamp = INT64_MAX;
+
+		for (const auto &item : _track_map)
+		{
+			tracks.push_back(item.second.track);
+			_base_timestamp = std::min(_base_timestamp, item.second.first_dts);
+		}
+
+		if (_application->GetStreamByName(_stream_name) != nullptr)
+		{
+			logti("Duplicate Stream Input(reject) - app(%s) stream(%s)", _application->GetName().CStr(), _stream_name.CStr());
+			return false;
+		}
+
+		_stream = _application->CreateStream(_stream_name, tracks);
+
+		if (_stream == nullptr)
+		{
+			logte("Could not create the stream - app(%s) stream(%s)", _application->GetName().CStr(), _stream_name.CStr());
+			return false;
+		}
+
+		_stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(_stream));
+
+		logti("[%s/%s] SRT Provider stream has been created: id(%u/%u) remote(%s)",
+			  _application->GetName().CStr(), _stream_name.CStr(),
+			  _application->GetId(), _stream->GetId(),
+			  _remote->ToString().CStr());
+
+		return true;
+	}
+
+	void SrtConnection::SendVideoFrame(const std::shared_ptr<MpegTsPes> &pes)
+	{
+		auto data = pes->data->GetDataAs<uint8_t>();
+		bool is_key_frame = false;
+
+		// The positions of NAL units are obtained while finding the key frame, so MediaRouter doesn't need to scan the start codes
+		FragmentationHeader fragmentation;
+
+		ForEachNalUnit(data, pes->data->GetLength(), [&](size_t offset, size_t length) {
+			fragmentation.fragmentation_offset.push_back(offset);
+			fragmentation.fragmentation_length.push_back(length);
+
+			if ((data[offset] & kH264NalUnitTypeMask) == static_cast<uint8_t>(H264NalUnitType::IdrSlice))
+			{
+				is_key_frame = true;
+			}
+		});
+
+		if (fragmentation.GetCount() == 0)
+		{
+			return;
+		}
+
+		fragmentation.last_fragment_complete = true;
+
+		// The PES buffer is used as is
+		auto media_packet = std::make_shared<MediaPacket>(MediaType::Video, 0, pes->data,
+														  pes->pts - _base_timestamp, pes->dts - _base_timestamp, -1LL,
+														  is_key_frame ? MediaPacketFlag::Key : MediaPacketFlag::NoFlag);
+		media_packet->SetFragHeader(&fragmentation);
+
+		_application->SendFrame(_stream, std::move(media_packet));
+	}
+
+	void SrtConnection::SendAudioFrames(const std::shared_ptr<MpegTsPes> &pes)
+	{
+		auto sample_rate = _stream->GetTrack(1)->GetSampleRate();
+		auto data = pes->data->GetDataAs<uint8_t>();
+		size_t length = pes->data->GetLength();
+		size_t offset = 0;
+		int64_t frame_index = 0;
+
+		// A PES may have several ADTS frames
+		while (offset < length)
+		{
+			AdtsHeader header;
+
+			if ((ParseAdtsHeader(data + offset, length - offset, &header) == false) || ((offset + header.frame_length) > length))
+			{
+				logtd("Invalid ADTS frame of [%s/%s] at %zu/%zu", _application->GetName().CStr(), _stream_name.CStr(), offset, length);
+				break;
+			}
+
+			// 1/90000 -> 1/sample_rate
+			int64_t timestamp = ((pes->pts - _base_timestamp) * sample_rate / SRT_MPEGTS_TIMESCALE) + (frame_index * SRT_AAC_SAMPLES_PER_FRAME);
+
+			// Subdata() shares the PES buffer
+			auto media_packet = std::make_shared<MediaPacket>(MediaType::Audio, 1, pes->data->Subdata(offset, header.frame_length),
+															  timestamp, timestamp, SRT_AAC_SAMPLES_PER_FRAME, MediaPacketFlag::Key);
+
+			_application->SendFrame(_stream, std::move(media_packet));
+
+			offset += header.frame_length;
+			frame_index++;
+		}
+	}
+}  // namespace pvd
@@ -0,0 +1,92 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/media_route/media_buffer.h>
+#include <base/ovsocket/ovsocket.h>
+#include <modules/mpegts/mpegts_demuxer.h>
+#include <monitoring/monitoring.h>
+
+#include "srt_application.h"
+
+namespace pvd
+{
+	// An SRT publisher, which sends MPEG-TS.
+	//
+	// The stream is created after the PMT and the codec parameters of every track (the SPS of H.264 and the ADTS header of AAC) are received,
+	// because MPEG-TS has no header that describes the tracks. The frames before that are dropped.
+	class SrtConnection
+	{
+	public:
+		SrtConnection(const std::shared_ptr<ov::Socket> &remote, const std::shared_ptr<SrtApplication> &application, const ov::String &stream_name);
+		~SrtConnection();
+
+		// Returns false if the data cannot be demuxed or the stream cannot be created, then the connection must be closed
+		bool OnDataReceived(const std::shared_ptr<const ov::Data> &data);
+
+		// Deletes the stream of the connection
+		void Close();
+
+		const std::shared_ptr<ov::Socket> &GetRemote() const
+		{
+			return _remote;
+		}
+
+		const std::shared_ptr<SrtApplication> &GetApplication() const
+		{
+			return _application;
+		}
+
+		const ov::String &GetStreamName() const
+		{
+			return _stream_name;
+		}
+
+		// Monotonic time in seconds (See ov::Clock)
+		int64_t GetLastPacketTime() const
+		{
+			return _last_packet_time;
+		}
+
+	private:
+		struct TrackContext
+		{
+			std::shared_ptr<MediaTrack> track;
+
+			// Whether the codec parameters of the track are known
+			bool is_probed = false;
+			int64_t first_dts = 0;
+		};
+
+		bool OnPmtReceived();
+
+		void ProbeVideo(TrackContext &context, const MpegTsPes &pes);
+		void ProbeAudio(TrackContext &context, const MpegTsPes &pes);
+		bool CreateStream();
+
+		void SendVideoFrame(const std::shared_ptr<MpegTsPes> &pes);
+		void SendAudioFrames(const std::shared_ptr<MpegTsPes> &pes);
+
+		std::shared_ptr<ov::Socket> _remote;
+		std::shared_ptr<SrtApplication> _application;
+		ov::String _stream_name;
+		std::shared_ptr<pvd::Stream> _stream;
+		std::shared_ptr<mon::StreamMetrics> _stream_metrics;
+
+		MpegTsDemuxer _demuxer;
+		bool _is_pmt_handled = false;
+
+		// key: PID
+		std::map<uint16_t, TrackContext> _track_map;
+
+		// The smallest DTS of the probed tracks, it is subtracted from the timestamps to start the stream from 0 keeping the A/V synchronization
+		int64_t _base_timestamp = 0;
+
+		int64_t _last_packet_time = 0;
+	};
+}  // namespace pvd
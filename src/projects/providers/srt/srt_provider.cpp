@@ -0,0 +1,327 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "srt_provider.h"
+
+#include <config/config.h>
+
+#include "srt_application.h"
+
+#define OV_LOG_TAG "SrtProvider"
+
+// If there is no data for this period (seconds), the connection is closed
+#define SRT_MAX_STREAM_PACKET_GAP 10
+
+namespace pvd
+{
+	// Parses the stream id into the host, app and stream
+	static bool ParseStreamId(const ov::String &stream_id, ov::String *host, ov::String *app_name, ov::String *stream_name)
+	{
+		if (stream_id.HasPrefix("#!::"))
+		{
+			// SRT access control syntax: #!::key1=value1,key2=value2,...
+			ov::String resource;
+			ov::String mode;
+
+			for (const auto &key_value : stream_id.Substring(4).Split(","))
+			{
+				auto position = key_value.IndexOf('=');
+
+				if (position < 0)
+				{
+					continue;
+				}
+
+				auto key = key_value.Left(position).Trim();
+				auto value = key_value.Substring(position + 1).Trim();
+
+				if (key == "h")
+				{
+					*host = value;
+				}
+				else if (key == "r")
+				{
+					resource = value;
+				}
+				else if (key == "m")
+				{
+					mode = value;
+				}
+			}
+
+			if ((mode.IsEmpty() == false) && (mode != "publish"))
+			{
+				return false;
+			}
+
+			auto tokens = resource.Split("/");
+			std::vector<ov::String> names;
+
+			for (const auto &token : tokens)
+			{
+				if (token.IsEmpty() == false)
+				{
+					names.push_back(token);
+				}
+			}
+
+			if (names.size() != 2)
+			{
+				return false;
+			}
+
+			*app_name = names[0];
+			*stream_name = names[1];
+		}
+		else
+		{
+			auto url = ov::Url::Parse(ov::Url::Decode(stream_id).CStr());
+
+			if (url == nullptr)
+			{
+				return false;
+			}
+
+			*host = url->Domain();
+			*app_name = url->App();
+			*stream_name = url->Stream();
+		}
+
+		return (app_name->IsEmpty() == false) && (stream_name->IsEmpty() == false);
+	}
+
+	std::shared_ptr<SrtProvider> SrtProvider::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+	{
+		auto provider = std::make_shared<SrtProvider>(server_config, router);
+		if (!provider->Start())
+		{
+			logte("An error occurred while creating SrtProvider");
+			return nullptr;
+		}
+		return provider;
+	}
+
+	SrtProvider::SrtProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+		: Provider(server_config, router)
+	{
+		logtd("Created SRT Provider module.");
+	}
+
+	SrtProvider::~SrtProvider()
+	{
+		logti("Terminated SRT Provider module.");
+	}
+
+	bool SrtProvider::Start()
+	{
+		auto server_config = GetServerConfig();
+		auto &srt_port = server_config.GetBind().GetProviders().GetSrt();
+
+		if (srt_port.IsParsed() == false)
+		{
+			logtd("SRT Provider is disabled");
+			return true;
+		}
+
+		if (srt_port.GetSocketType() != ov::SocketType::Srt)
+		{
+			logte("The port of SRT Provider must be an SRT port (such as 9999/srt)");
+			return false;
+		}
+
+		auto srt_address = ov::SocketAddress(server_config.GetIp(), static_cast<uint16_t>(srt_port.GetPort()));
+
+		_physical_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Srt, srt_address, srt_port.GetReactorCount(), srt_port.GetWorkerCount(), srt_port.GetWorkerAffinity());
+
+		if (_physical_port == nullptr)
+		{
+			logte("Could not initialize phyiscal port for SRT server: %s", srt_address.ToString().CStr());
+			return false;
+		}
+
+		_physical_port->AddObserver(this);
+
+		_garbage_check_timer.Push(std::bind(&SrtProvider::OnGarbageCheck, this, std::placeholders::_1), 3000);
+		_garbage_check_timer.Start();
+
+		logti("SRT Server has started listening on %s...", srt_address.ToString().CStr());
+
+		return Provider::Start();
+	}
+
+	bool SrtProvider::Stop()
+	{
+		if (_physical_port != nullptr)
+		{
+			_garbage_check_timer.Stop();
+
+			_physical_port->RemoveObserver(this);
+			PhysicalPortManager::Instance()->DeletePort(_physical_port);
+			_physical_port = nullptr;
+		}
+
+		std::unordered_map<ov::Socket *, std::shared_ptr<SrtConnection>> connection_map;
+		{
+			std::unique_lock<std::shared_mutex> lock(_connection_map_mutex);
+			connection_map.swap(_connection_map);
+		}
+
+		for (const auto &item : connection_map)
+		{
+			item.second->Close();
+		}
+
+		return Provider::Stop();
+	}
+
+	std::shared_ptr<pvd::Application> SrtProvider::OnCreateProviderApplication(const info::Application &application_info)
+	{
+		return SrtApplication::Create(pvd::Provider::GetSharedPtrAs<pvd::Provider>(), application_info);
+	}
+
+	bool SrtProvider::OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application)
+	{
+		std::vector<std::shared_ptr<SrtConnection>> connections;
+		{
+			std::shared_lock<std::shared_mutex> lock(_connection_map_mutex);
+
+			for (const auto &item : _connection_map)
+			{
+				if (item.second->GetApplication() == application)
+				{
+					connections.push_back(item.second);
+				}
+			}
+		}
+
+		for (const auto &connection : connections)
+		{
+			Disconnect(connection);
+		}
+
+		return true;
+	}
+
+	void SrtProvider::OnConnected(const std::shared_ptr<ov::Socket> &remote)
+	{
+		auto stream_id = remote->GetStreamId();
+		ov::String host;
+		ov::String app_name;
+		ov::String stream_name;
+
+		if (ParseStreamId(stream_id, &host, &app_name, &stream_name) == false)
+		{
+			// The connection without the context is closed when the data is received
+			logtw("Invalid stream id of the SRT client %s: [%s]", remote->ToString().CStr(), stream_id.CStr());
+			return;
+		}
+
+		auto internal_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(host, app_name);
+		auto application = std::dynamic_pointer_cast<SrtApplication>(GetApplicationByName(internal_app_name));
+
+		if (application == nullptr)
+		{
+			logtw("Could not find the application [%s] for the SRT client %s", internal_app_name.CStr(), remote->ToString().CStr());
+			return;
+		}
+
+		logti("A SRT client has connected from %s: [%s/%s]", remote->ToString().CStr(), internal_app_name.CStr(), stream_name.CStr());
+
+		std::unique_lock<std::shared_mutex> lock(_connection_map_mutex);
+		_connection_map[remote.get()] = std::make_shared<SrtConnection>(remote, application, stream_name);
+	}
+
+	void SrtProvider::OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+	{
+		auto connection = GetConnection(remote.get());
+
+		if (connection == nullptr)
+		{
+			_physical_port->DisconnectClient(dynamic_cast<ov::ClientSocket *>(remote.get()));
+			return;
+		}
+
+		// The data of a connection is delivered by one worker, so the connection is not locked
+		if (connection->OnDataReceived(data) == false)
+		{
+			Disconnect(connection);
+		}
+	}
+
+	void SrtProvider::OnDisconnected(const std::shared_ptr<ov::Socket> &remote, PhysicalPortDisconnectReason reason, const std::shared_ptr<const ov::Error> &error)
+	{
+		std::shared_ptr<SrtConnection> connection;
+		{
+			std::unique_lock<std::shared_mutex> lock(_connection_map_mutex);
+
+			auto item = _connection_map.find(remote.get());
+			if (item == _connection_map.end())
+			{
+				return;
+			}
+
+			connection = item->second;
+			_connection_map.erase(item);
+		}
+
+		logti("The SRT client is disconnected: [%s/%s], remote: %s",
+			  connection->GetApplication()->GetName().CStr(), connection->GetStreamName().CStr(), remote->ToString().CStr());
+
+		connection->Close();
+	}
+
+	std::shared_ptr<SrtConnection> SrtProvider::GetConnection(ov::Socket *remote)
+	{
+		std::shared_lock<std::shared_mutex> lock(_connection_map_mutex);
+
+		auto item = _connection_map.find(remote);
+		if (item == _connection_map.end())
+		{
+			return nullptr;
+		}
+
+		return item->second;
+	}
+
+	void SrtProvider::Disconnect(const std::shared_ptr<SrtConnection> &connection)
+	{
+		// The connection is removed by OnDisconnected()
+		_physical_port->DisconnectClient(dynamic_cast<ov::ClientSocket *>(connection->GetRemote().get()));
+	}
+
+	ov::DelayQueueAction SrtProvider::OnGarbageCheck(void *parameter)
+	{
+		int64_t current_time = ov::Clock::CachedNowSec();
+		std::vector<std::shared_ptr<SrtConnection>> garbage_list;
+
+		{
+			std::shared_lock<std::shared_mutex> lock(_connection_map_mutex);
+
+			for (const auto &item : _connection_map)
+			{
+				auto &connection = item.second;
+				auto elapsed = current_time - connection->GetLastPacketTime();
+
+				if (elapsed > SRT_MAX_STREAM_PACKET_GAP)
+				{
+					logtw("SRT input stream has timed out: [%s/%s], elapsed: %ld, threshold: %d, remote: %s",
+						  connection->GetApplication()->GetName().CStr(), connection->GetStreamName().CStr(),
+						  elapsed, SRT_MAX_STREAM_PACKET_GAP, connection->GetRemote()->ToString().CStr());
+
+					garbage_list.push_back(connection);
+				}
+			}
+		}
+
+		for (const auto &connection : garbage_list)
+		{
+			Disconnect(connection);
+		}
+
+		return ov::DelayQueueAction::Repeat;
+	}
+}  // namespace pvd
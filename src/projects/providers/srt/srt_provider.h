@@ -0,0 +1,85 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/provider/application.h>
+#include <base/provider/provider.h>
+#include <modules/physical_port/physical_port_manager.h>
+#include <orchestrator/orchestrator.h>
+
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "srt_connection.h"
+
+/*
+ * SrtProvider
+ * 		: Receives MPEG-TS (H.264/AAC) over SRT
+ *
+ * 	The publisher sets the stream id to one of these:
+ * 		srt://<host>[:<port>]/<app>/<stream> (URL encoded)
+ * 		#!::h=<host>,r=<app>/<stream>[,m=publish] (SRT access control syntax)
+ *
+ * 	The SRT sockets are waited by the SRT epoll of the PhysicalPort, and the data is delivered by the worker of each connection.
+ */
+
+namespace pvd
+{
+	class SrtProvider : public pvd::Provider, protected PhysicalPortObserver
+	{
+	public:
+		static std::shared_ptr<SrtProvider> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+
+		explicit SrtProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+		~SrtProvider() override;
+
+		ProviderStreamDirection GetProviderStreamDirection() const override
+		{
+			return ProviderStreamDirection::Push;
+		}
+
+		ProviderType GetProviderType() const override
+		{
+			return ProviderType::Srt;
+		}
+
+		const char *GetProviderName() const override
+		{
+			return "SrtProvider";
+		}
+
+		bool Start() override;
+		bool Stop() override;
+
+	protected:
+		std::shared_ptr<pvd::Application> OnCreateProviderApplication(const info::Application &application_info) override;
+		bool OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application) override;
+
+		//--------------------------------------------------------------------
+		// Implementation of PhysicalPortObserver
+		//--------------------------------------------------------------------
+		void OnConnected(const std::shared_ptr<ov::Socket> &remote) override;
+		void OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data) override;
+		void OnDisconnected(const std::shared_ptr<ov::Socket> &remote, PhysicalPortDisconnectReason reason, const std::shared_ptr<const ov::Error> &error) override;
+
+	private:
+		std::shared_ptr<SrtConnection> GetConnection(ov::Socket *remote);
+		void Disconnect(const std::shared_ptr<SrtConnection> &connection);
+
+		ov::DelayQueueAction OnGarbageCheck(void *parameter);
+
+		std::shared_ptr<PhysicalPort> _physical_port;
+
+		// The connections whose stream id is resolved to an application
+		std::unordered_map<ov::Socket *, std::shared_ptr<SrtConnection>> _connection_map;
+		std::shared_mutex _connection_map_mutex;
+
+		ov::DelayQueue _garbage_check_timer;
+	};
+}  // namespace pvd
@@ -0,0 +1,28 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "base/common_types.h"
+#include "base/provider/application.h"
+#include "base/provider/stream.h"
+
+namespace pvd
+{
+	// The frames are demuxed by SrtConnection, so the stream only represents the ingested stream
+	class SrtStream : public pvd::Stream
+	{
+	public:
+		static std::shared_ptr<SrtStream> Create(const std::shared_ptr<pvd::Application> &application, const uint32_t stream_id, const ov::String &stream_name);
+
+		explicit SrtStream(const std::shared_ptr<pvd::Application> &application, const info::Stream &stream_info);
+		~SrtStream() final = default;
+
+		bool Start() override;
+		bool Stop() override;
+	};
+}  // namespace pvd
@@ -0,0 +1,32 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "webrtc_application.h"
+
+#include "webrtc_stream.h"
+
+#define OV_LOG_TAG "WebRtcApplication"
+
+namespace pvd
+{
+	std::shared_ptr<WebRtcApplication> WebRtcApplication::Create(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info)
+	{
+		auto application = std::make_shared<WebRtcApplication>(provider, application_info);
+		application->Start();
+		return application;
+	}
+
+	WebRtcApplication::WebRtcApplication(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info)
+		: Application(provider, application_info)
+	{
+	}
+
+	std::shared_ptr<pvd::Stream> WebRtcApplication::CreatePushStream(const uint32_t stream_id, const ov::String &stream_name)
+	{
+		return WebRtcStream::Create(GetSharedPtrAs<pvd::Application>(), stream_id, stream_name);
+	}
+}  // namespace pvd
@@ -0,0 +1,31 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "base/common_types.h"
+#include "base/provider/application.h"
+#include "base/provider/stream.h"
+
+namespace pvd
+{
+	class WebRtcApplication : public pvd::Application
+	{
+	protected:
+		std::shared_ptr<pvd::Stream> CreatePushStream(const uint32_t stream_id, const ov::String &stream_name) override;
+		std::shared_ptr<pvd::Stream> CreatePullStream(const uint32_t stream_id, const ov::String &stream_name, const std::vector<ov::String> &url_list) override
+		{
+			return nullptr;
+		}
+
+	public:
+		static std::shared_ptr<WebRtcApplication> Create(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info);
+
+		explicit WebRtcApplication(const std::shared_ptr<pvd::Provider> &provider, const info::Application &application_info);
+		~WebRtcApplication() override = default;
+	};
+}  // namespace pvd
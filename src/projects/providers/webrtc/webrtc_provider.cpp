@@ -0,0 +1,626 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "webrtc_provider.h"
+
+#include <config/config.h>
+#include <modules/rtc_signalling/rtc_ice_candidate.h>
+
+#include "webrtc_application.h"
+#include "webrtc_stream.h"
+
+#define OV_LOG_TAG "WebRtcProvider"
+
+// The answer is used when the offer does not have the fmtp of H.264
+#define WEBRTC_PROVIDER_DEFAULT_H264_FMTP "level-asymmetry-allowed=1;packetization-mode=1;profile-level-id=42e01f"
+
+using namespace common;
+
+namespace pvd
+{
+	std::shared_ptr<WebRtcProvider> WebRtcProvider::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+	{
+		auto provider = std::make_shared<WebRtcProvider>(server_config, router);
+		if (!provider->Start())
+		{
+			logte("An error occurred while creating WebRtcProvider");
+			return nullptr;
+		}
+		return provider;
+	}
+
+	WebRtcProvider::WebRtcProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+		: Provider(server_config, router)
+	{
+		logtd("Created WebRTC Provider module.");
+	}
+
+	WebRtcProvider::~WebRtcProvider()
+	{
+		logti("Terminated WebRTC Provider module.");
+	}
+
+	bool WebRtcProvider::Start()
+	{
+		auto server_config = GetServerConfig();
+		auto &webrtc_port_info = server_config.GetBind().GetProviders().GetWebrtc();
+
+		if (webrtc_port_info.IsParsed() == false)
+		{
+			logtd("WebRTC Provider is disabled");
+			return true;
+		}
+
+		auto port = static_cast<uint16_t>(webrtc_port_info.GetSignallingPort());
+		auto tls_port = static_cast<uint16_t>(webrtc_port_info.GetSignallingTlsPort());
+		bool has_port = (port != 0);
+		bool has_tls_port = (tls_port != 0);
+
+		if ((has_port == false) && (has_tls_port == false))
+		{
+			logte("Invalid WebRTC Port settings");
+			return false;
+		}
+
+		// All sessions share the certificate, so the fingerprint of the answer is always the same
+		_certificate = std::make_shared<Certificate>();
+
+		auto error = _certificate->Generate();
+		if (error != nullptr)
+		{
+			logte("Cannot create certificate: %s", error->ToString().CStr());
+			return false;
+		}
+
+		_dtls_context = DtlsTransport::CreateTlsContext(_certificate);
+
+		_ice_port = IcePortManager::Instance()->CreatePort(webrtc_port_info.GetIceCandidates(), IcePortObserver::GetSharedPtr());
+		if (_ice_port == nullptr)
+		{
+			logte("Cannot initialize ICE Port. Check your ICE configuration");
+			return false;
+		}
+
+		ov::SocketAddress address = ov::SocketAddress(server_config.GetIp(), port);
+		ov::SocketAddress tls_address = ov::SocketAddress(server_config.GetIp(), tls_port);
+		auto signalling_port = webrtc_port_info.GetSignalling();
+		bool result = true;
+
+		if (has_port)
+		{
+			_http_server = std::make_shared<HttpServer>();
+
+			result = result && InitializeHttpServer(_http_server);
+			result = result && _http_server->Start(address, signalling_port.GetReactorCount(), signalling_port.GetWorkerCount(), signalling_port.GetWorkerAffinity());
+		}
+
+		if (has_tls_port)
+		{
+			_https_server = std::make_shared<HttpsServer>();
+			auto vhost_list = Orchestrator::GetInstance()->GetVirtualHostList();
+			_https_server->SetVirtualHostList(vhost_list);
+
+			result = result && InitializeHttpServer(_https_server);
+			result = result && _https_server->Start(tls_address, signalling_port.GetReactorCount(), signalling_port.GetWorkerCount(), signalling_port.GetWorkerAffinity());
+		}
+
+		if (result == false)
+		{
+			// Rollback
+			logte("An error occurred while initialize WebRTC Provider");
+
+			if (_http_server != nullptr)
+			{
+				_http_server->Stop();
+				_http_server = nullptr;
+			}
+
+			if (_https_server != nullptr)
+			{
+				_https_server->Stop();
+				_https_server = nullptr;
+			}
+
+			IcePortManager::Instance()->ReleasePort(_ice_port, IcePortObserver::GetSharedPtr());
+			_ice_port = nullptr;
+
+			return false;
+		}
+
+		logti("WebRTC Provider has started listening on %s%s%s%s...",
+			  has_port ? address.ToString().CStr() : "",
+			  (has_port && has_tls_port) ? ", " : "",
+			  has_tls_port ? "TLS: " : "",
+			  has_tls_port ? tls_address.ToString().CStr() : "");
+
+		return Provider::Start();
+	}
+
+	bool WebRtcProvider::Stop()
+	{
+		if (_http_server != nullptr)
+		{
+			_http_server->Stop();
+		}
+
+		if (_https_server != nullptr)
+		{
+			_https_server->Stop();
+		}
+
+		std::vector<std::shared_ptr<WebRtcSession>> sessions;
+		{
+			std::shared_lock<std::shared_mutex> lock(_session_map_mutex);
+
+			for (const auto &item : _session_map)
+			{
+				sessions.push_back(item.second);
+			}
+		}
+
+		for (const auto &session : sessions)
+		{
+			DeleteSession(session);
+		}
+
+		if (_ice_port != nullptr)
+		{
+			IcePortManager::Instance()->ReleasePort(_ice_port, IcePortObserver::GetSharedPtr());
+		}
+
+		return Provider::Stop();
+	}
+
+	std::shared_ptr<pvd::Application> WebRtcProvider::OnCreateProviderApplication(const info::Application &application_info)
+	{
+		return WebRtcApplication::Create(pvd::Provider::GetSharedPtrAs<pvd::Provider>(), application_info);
+	}
+
+	bool WebRtcProvider::OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application)
+	{
+		std::vector<std::shared_ptr<WebRtcSession>> sessions;
+		{
+			std::shared_lock<std::shared_mutex> lock(_session_map_mutex);
+
+			for (const auto &item : _session_map)
+			{
+				if (item.second->GetApplication() == application)
+				{
+					sessions.push_back(item.second);
+				}
+			}
+		}
+
+		for (const auto &session : sessions)
+		{
+			DeleteSession(session);
+		}
+
+		return true;
+	}
+
+	bool WebRtcProvider::InitializeHttpServer(const std::shared_ptr<HttpServer> &http_server)
+	{
+		auto http_interceptor = std::make_shared<HttpDefaultInterceptor>();
+
+		// CORS preflight of the browsers
+		http_interceptor->Register(HttpMethod::Options, ".*", [](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			auto response = client->GetResponse();
+
+			response->SetStatusCode(HttpStatusCode::NoContent);
+			response->SetHeader("Access-Control-Allow-Origin", "*");
+			response->SetHeader("Access-Control-Allow-Methods", "POST, DELETE, OPTIONS");
+			response->SetHeader("Access-Control-Allow-Headers", "Content-Type");
+			response->SetHeader("Access-Control-Expose-Headers", "Location");
+			response->Response();
+
+			return HttpNextHandler::DoNotCall;
+		});
+
+		// /<app>/<stream>
+		http_interceptor->Register(HttpMethod::Post, "/[^/?]+/[^/?]+(\\?.*)?", [this](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			return OnOfferRequested(client);
+		});
+
+		// /<app>/<stream>/<session_id>
+		http_interceptor->Register(HttpMethod::Delete, "/[^/?]+/[^/?]+/\\d+(\\?.*)?", [this](const std::shared_ptr<HttpClient> &client) -> HttpNextHandler {
+			return OnDeleteRequested(client);
+		});
+
+		return http_server->AddInterceptor(http_interceptor);
+	}
+
+	HttpNextHandler WebRtcProvider::OnOfferRequested(const std::shared_ptr<HttpClient> &client)
+	{
+		auto request = client->GetRequest();
+		auto response = client->GetResponse();
+
+		response->SetHeader("Access-Control-Allow-Origin", "*");
+		response->SetHeader("Access-Control-Expose-Headers", "Location");
+
+		auto tokens = request->GetRequestTarget().Split("?")[0].Split("/");
+		auto host_name = request->GetHeader("HOST").Split(":")[0];
+		auto &app_name = tokens[1];
+		auto &stream_name = tokens[2];
+		auto remote = request->GetRemote();
+		ov::String description = (remote != nullptr) ? remote->ToString() : "(unknown)";
+
+		auto internal_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(host_name, app_name);
+		auto application = std::dynamic_pointer_cast<WebRtcApplication>(GetApplicationByName(internal_app_name));
+
+		if (application == nullptr)
+		{
+			logtw("Could not find the application [%s] for WebRTC ingest from %s", internal_app_name.CStr(), description.CStr());
+			response->SetStatusCode(HttpStatusCode::NotFound);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		auto request_body = request->GetRequestBody();
+		auto offer_sdp = std::make_shared<SessionDescription>();
+
+		if ((request_body == nullptr) || (offer_sdp->FromString(ov::String(request_body->GetDataAs<char>(), request_body->GetLength())) == false))
+		{
+			logtw("Could not parse the offer of %s/%s from %s", internal_app_name.CStr(), stream_name.CStr(), description.CStr());
+			response->SetStatusCode(HttpStatusCode::BadRequest);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		// Checking the stream name and creating the stream are done at once, the stream can be published by only one peer
+		std::unique_lock<std::shared_mutex> lock(_session_map_mutex);
+
+		if (application->GetStreamByName(stream_name) != nullptr)
+		{
+			logti("Duplicate Stream Input(reject) - app(%s) stream(%s)", internal_app_name.CStr(), stream_name.CStr());
+			response->SetStatusCode(HttpStatusCode::Conflict);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		session_id_t session_id;
+		do
+		{
+			session_id = ov::Random::GenerateUInt32();
+		} while ((session_id == 0) || (_session_map.find(session_id) != _session_map.end()));
+
+		std::vector<NegotiatedTrack> negotiated_tracks;
+		auto answer_sdp = CreateAnswer(offer_sdp, session_id, &negotiated_tracks);
+		ov::String answer_text;
+
+		if ((answer_sdp == nullptr) || (RenderAnswer(answer_sdp, &answer_text) == false))
+		{
+			logtw("There is no media to receive in the offer of %s/%s from %s (only H.264 and Opus are supported)",
+				  internal_app_name.CStr(), stream_name.CStr(), description.CStr());
+			response->SetStatusCode(HttpStatusCode::NotAcceptable);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		std::vector<std::shared_ptr<MediaTrack>> tracks;
+		for (const auto &negotiated_track : negotiated_tracks)
+		{
+			tracks.push_back(negotiated_track.track);
+		}
+
+		auto stream = application->CreateStream(stream_name, tracks);
+		if (stream == nullptr)
+		{
+			logte("Could not create the stream - app(%s) stream(%s)", internal_app_name.CStr(), stream_name.CStr());
+			response->SetStatusCode(HttpStatusCode::InternalServerError);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		auto session = WebRtcSession::Create(application, stream, session_id, answer_sdp, offer_sdp, _ice_port);
+
+		bool result = true;
+		for (const auto &negotiated_track : negotiated_tracks)
+		{
+			const auto &track = negotiated_track.track;
+			result = result && session->AddTrack(negotiated_track.payload_type, track->GetMediaType(), track->GetCodecId(), track->GetId());
+		}
+
+		if ((result == false) || (session->Start(_certificate, _dtls_context) == false))
+		{
+			logte("Could not start the session - app(%s) stream(%s)", internal_app_name.CStr(), stream_name.CStr());
+			session->Stop();
+			application->DeleteStream(stream);
+			response->SetStatusCode(HttpStatusCode::InternalServerError);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		_session_map[session_id] = session;
+		lock.unlock();
+
+		// The packets of the session are received after the STUN binding request of the peer
+		_ice_port->AddSession(session, answer_sdp, offer_sdp);
+
+		logti("WebRTC ingest has started - app(%s) stream(%s) session(%u) from %s", internal_app_name.CStr(), stream_name.CStr(), session_id, description.CStr());
+
+		response->SetStatusCode(HttpStatusCode::Created);
+		response->SetHeader("Content-Type", "application/sdp");
+		response->SetHeader("Location", ov::String::FormatString("/%s/%s/%u", app_name.CStr(), stream_name.CStr(), session_id));
+		response->SetHeader("Content-Length", ov::String::FormatString("%zu", answer_text.GetLength()));
+		response->AppendString(answer_text);
+		response->Response();
+
+		return HttpNextHandler::DoNotCall;
+	}
+
+	HttpNextHandler WebRtcProvider::OnDeleteRequested(const std::shared_ptr<HttpClient> &client)
+	{
+		auto request = client->GetRequest();
+		auto response = client->GetResponse();
+
+		response->SetHeader("Access-Control-Allow-Origin", "*");
+
+		auto tokens = request->GetRequestTarget().Split("?")[0].Split("/");
+		auto session_id = static_cast<session_id_t>(ov::Converter::ToUInt32(tokens[3]));
+		auto &stream_name = tokens[2];
+
+		std::shared_ptr<WebRtcSession> session;
+		{
+			std::shared_lock<std::shared_mutex> lock(_session_map_mutex);
+
+			auto item = _session_map.find(session_id);
+			if (item != _session_map.end())
+			{
+				session = item->second;
+			}
+		}
+
+		if ((session == nullptr) || (session->GetStream()->GetName() != stream_name))
+		{
+			response->SetStatusCode(HttpStatusCode::NotFound);
+			response->Response();
+			return HttpNextHandler::DoNotCall;
+		}
+
+		logti("WebRTC ingest is stopped by the peer - app(%s) stream(%s) session(%u)",
+			  session->GetApplication()->GetName().CStr(), stream_name.CStr(), session_id);
+
+		DeleteSession(session);
+
+		response->SetStatusCode(HttpStatusCode::OK);
+		response->Response();
+
+		return HttpNextHandler::DoNotCall;
+	}
+
+	std::shared_ptr<SessionDescription> WebRtcProvider::CreateAnswer(const std::shared_ptr<SessionDescription> &offer_sdp, session_id_t session_id,
+																	 std::vector<NegotiatedTrack> *negotiated_tracks)
+	{
+		auto answer_sdp = std::make_shared<SessionDescription>();
+		answer_sdp->SetOrigin("OvenMediaEngine", session_id, 2, "IN", 4, "127.0.0.1");
+		answer_sdp->SetTiming(0, 0);
+		answer_sdp->SetIceUfrag(_ice_port->GenerateUfrag());
+		answer_sdp->SetIcePwd(ov::Random::GenerateString(32));
+		answer_sdp->SetFingerprint("sha-256", _certificate->GetFingerprint("sha-256"));
+
+		bool has_video = false;
+		bool has_audio = false;
+
+		for (const auto &offer_media : offer_sdp->GetMediaList())
+		{
+			auto answer_media = std::make_shared<MediaDescription>(answer_sdp);
+			answer_media->SetConnection(4, "0.0.0.0");
+			answer_media->SetMid(offer_media->GetMid());
+			answer_media->SetSetup(MediaDescription::SetupType::Passive);
+			answer_media->UseDtls(true);
+			answer_media->UseRtcpMux(true);
+			answer_media->SetMediaType(offer_media->GetMediaType());
+
+			auto offer_direction = offer_media->GetDirection();
+			bool is_sending = (offer_direction == MediaDescription::Direction::SendOnly) || (offer_direction == MediaDescription::Direction::SendRecv);
+
+			std::shared_ptr<PayloadAttr> selected_payload;
+
+			// Only the first media of each type is received
+			if (is_sending && (offer_media->GetMediaType() == MediaDescription::MediaType::Video) && (has_video == false))
+			{
+				for (const auto &offer_payload : offer_media->GetPayloadList())
+				{
+					if (offer_payload->GetCodecStr().UpperCaseString() != "H264")
+					{
+						continue;
+					}
+
+					// The interleaved mode (packetization-mode=2) is not supported
+					auto fmtp = offer_payload->GetFmtp();
+					bool is_non_interleaved = (fmtp.IndexOf("packetization-mode=1") >= 0);
+					bool is_single_nal_unit = (fmtp.IndexOf("packetization-mode") < 0) || (fmtp.IndexOf("packetization-mode=0") >= 0);
+
+					if (is_non_interleaved || ((selected_payload == nullptr) && is_single_nal_unit))
+					{
+						selected_payload = offer_payload;
+
+						if (is_non_interleaved)
+						{
+							break;
+						}
+					}
+				}
+
+				if (selected_payload != nullptr)
+				{
+					auto payload = std::make_shared<PayloadAttr>();
+					auto fmtp = selected_payload->GetFmtp();
+
+					payload->SetRtpmap(selected_payload->GetId(), "H264", 90000);
+					payload->SetFmtp(fmtp.IsEmpty() ? WEBRTC_PROVIDER_DEFAULT_H264_FMTP : fmtp);
+					// The lost packets and key frames are requested by WebRtcRtpReceiver
+					payload->EnableRtcpFb(PayloadAttr::RtcpFbType::Nack, true);
+					payload->EnableRtcpFb(PayloadAttr::RtcpFbType::NackPli, true);
+					payload->EnableRtcpFb(PayloadAttr::RtcpFbType::CcmFir, true);
+					answer_media->AddPayload(payload);
+
+					auto track = std::make_shared<MediaTrack>();
+
+					// Video is fixed on Track 0
+					track->SetId(0);
+					track->SetMediaType(MediaType::Video);
+					track->SetCodecId(MediaCodecId::H264);
+					track->SetTimeBase(1, 90000);
+
+					negotiated_tracks->push_back({selected_payload->GetId(), track});
+					has_video = true;
+				}
+			}
+			else if (is_sending && (offer_media->GetMediaType() == MediaDescription::MediaType::Audio) && (has_audio == false))
+			{
+				for (const auto &offer_payload : offer_media->GetPayloadList())
+				{
+					if ((offer_payload->GetCodecStr().UpperCaseString() == "OPUS") && (offer_payload->GetCodecRate() == 48000))
+					{
+						selected_payload = offer_payload;
+						break;
+					}
+				}
+
+				if (selected_payload != nullptr)
+				{
+					auto payload = std::make_shared<PayloadAttr>();
+
+					// Opus is always signalled as 2 channels (RFC 7587)
+					payload->SetRtpmap(selected_payload->GetId(), "opus", 48000, "2");
+					payload->SetFmtp(selected_payload->GetFmtp());
+					answer_media->AddPayload(payload);
+
+					auto track = std::make_shared<MediaTrack>();
+
+					// Audio is fixed on Track 1
+					track->SetId(1);
+					track->SetMediaType(MediaType::Audio);
+					track->SetCodecId(MediaCodecId::Opus);
+					track->SetSampleRate(48000);
+					track->GetSample().SetFormat(common::AudioSample::Format::S16);
+					track->GetChannel().SetLayout(common::AudioChannel::Layout::LayoutStereo);
+					track->SetTimeBase(1, 48000);
+
+					negotiated_tracks->push_back({selected_payload->GetId(), track});
+					has_audio = true;
+				}
+			}
+
+			if (selected_payload != nullptr)
+			{
+				answer_media->SetDirection(MediaDescription::Direction::RecvOnly);
+			}
+			else
+			{
+				// Rejected (RFC 3264 6), the m= line must have a format anyway
+				answer_media->SetPort(0);
+				answer_media->SetDirection(MediaDescription::Direction::Inactive);
+
+				for (const auto &offer_payload : offer_media->GetPayloadList())
+				{
+					if (offer_payload->GetId() != 0)
+					{
+						auto payload = std::make_shared<PayloadAttr>();
+						payload->SetRtpmap(offer_payload->GetId(), offer_payload->GetCodecStr(), offer_payload->GetCodecRate(), offer_payload->GetCodecParams());
+						answer_media->AddPayload(payload);
+						break;
+					}
+				}
+			}
+
+			answer_sdp->AddMedia(answer_media);
+		}
+
+		if (negotiated_tracks->empty())
+		{
+			return nullptr;
+		}
+
+		return answer_sdp;
+	}
+
+	bool WebRtcProvider::RenderAnswer(const std::shared_ptr<SessionDescription> &answer_sdp, ov::String *answer_text)
+	{
+		if (answer_sdp->ToString(*answer_text) == false)
+		{
+			return false;
+		}
+
+		// The candidates are not a part of the SDP model, they are added to the first media (all media are bundled)
+		ov::String candidates;
+		for (const auto &candidate : _ice_port->GetIceCandidateList())
+		{
+			candidates.AppendFormat("a=%s\r\n", candidate.GetCandidateString().CStr());
+		}
+		candidates.Append("a=end-of-candidates\r\n");
+
+		auto first_media = answer_text->IndexOf("\r\nm=");
+		if (first_media < 0)
+		{
+			return false;
+		}
+
+		auto second_media = answer_text->IndexOf("\r\nm=", first_media + 2);
+		if (second_media < 0)
+		{
+			answer_text->Append(candidates);
+		}
+		else
+		{
+			*answer_text = answer_text->Left(second_media + 2) + candidates + answer_text->Substring(second_media + 2);
+		}
+
+		return true;
+	}
+
+	void WebRtcProvider::DeleteSession(const std::shared_ptr<WebRtcSession> &session)
+	{
+		{
+			std::unique_lock<std::shared_mutex> lock(_session_map_mutex);
+
+			if (_session_map.erase(session->GetId()) == 0)
+			{
+				// Already deleted
+				return;
+			}
+		}
+
+		_ice_port->RemoveSession(session);
+		session->Stop();
+
+		session->GetApplication()->DeleteStream(session->GetStream());
+	}
+
+	void WebRtcProvider::OnStateChanged(IcePort &port, const std::shared_ptr<info::Session> &session_info, IcePortConnectionState state)
+	{
+		auto session = std::static_pointer_cast<WebRtcSession>(session_info);
+
+		switch (state)
+		{
+			case IcePortConnectionState::New:
+			case IcePortConnectionState::Checking:
+			case IcePortConnectionState::Connected:
+			case IcePortConnectionState::Completed:
+				break;
+
+			case IcePortConnectionState::Failed:
+			case IcePortConnectionState::Disconnected:
+			case IcePortConnectionState::Closed:
+				logti("WebRTC ingest has been disconnected - app(%s) stream(%s) session(%u)",
+					  session->GetApplication()->GetName().CStr(), session->GetStream()->GetName().CStr(), session->GetId());
+				DeleteSession(session);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	void WebRtcProvider::OnDataReceived(IcePort &port, const std::shared_ptr<info::Session> &session_info, std::shared_ptr<const ov::Data> data)
+	{
+		// All packets except STUN are received
+		std::static_pointer_cast<WebRtcSession>(session_info)->OnPacketReceived(data);
+	}
+}  // namespace pvd
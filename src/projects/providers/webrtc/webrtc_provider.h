@@ -0,0 +1,105 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovcrypto/ovcrypto.h>
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/provider/application.h>
+#include <base/provider/provider.h>
+#include <http_server/http_server.h>
+#include <http_server/https_server.h>
+#include <modules/ice/ice.h>
+#include <modules/sdp/session_description.h>
+#include <orchestrator/orchestrator.h>
+
+#include <shared_mutex>
+
+#include "webrtc_session.h"
+
+/*
+ * WebRtcProvider
+ * 		: Receives the streams that are published by WebRTC (WHIP-style signalling)
+ *
+ * 	POST /<app>/<stream>					: SDP offer -> 201 Created, SDP answer and Location of the session
+ * 	DELETE /<app>/<stream>/<session_id>		: Stop publishing
+ *
+ * 	The answer has all the ICE candidates of the provider, so there is no trickle ICE.
+ * 	The media is received by WebRtcSession through the IcePort of the provider (ICE -> DTLS -> SRTP -> RTP).
+ */
+
+namespace pvd
+{
+	class WebRtcProvider : public pvd::Provider, public IcePortObserver
+	{
+	public:
+		static std::shared_ptr<WebRtcProvider> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+
+		explicit WebRtcProvider(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+		~WebRtcProvider() override;
+
+		ProviderStreamDirection GetProviderStreamDirection() const override
+		{
+			return ProviderStreamDirection::Push;
+		}
+
+		ProviderType GetProviderType() const override
+		{
+			return ProviderType::Webrtc;
+		}
+
+		const char *GetProviderName() const override
+		{
+			return "WebRtcProvider";
+		}
+
+		bool Start() override;
+		bool Stop() override;
+
+	protected:
+		std::shared_ptr<pvd::Application> OnCreateProviderApplication(const info::Application &application_info) override;
+		bool OnDeleteProviderApplication(const std::shared_ptr<pvd::Application> &application) override;
+
+		//--------------------------------------------------------------------
+		// Implementation of IcePortObserver
+		//--------------------------------------------------------------------
+		void OnStateChanged(IcePort &port, const std::shared_ptr<info::Session> &session_info, IcePortConnectionState state) override;
+		void OnDataReceived(IcePort &port, const std::shared_ptr<info::Session> &session_info, std::shared_ptr<const ov::Data> data) override;
+
+	private:
+		// The track which is negotiated by the answer
+		struct NegotiatedTrack
+		{
+			uint8_t payload_type = 0;
+			std::shared_ptr<MediaTrack> track;
+		};
+
+		bool InitializeHttpServer(const std::shared_ptr<HttpServer> &http_server);
+
+		HttpNextHandler OnOfferRequested(const std::shared_ptr<HttpClient> &client);
+		HttpNextHandler OnDeleteRequested(const std::shared_ptr<HttpClient> &client);
+
+		std::shared_ptr<SessionDescription> CreateAnswer(const std::shared_ptr<SessionDescription> &offer_sdp, session_id_t session_id,
+														 std::vector<NegotiatedTrack> *negotiated_tracks);
+		// Renders the answer with the ICE candidates of the provider
+		bool RenderAnswer(const std::shared_ptr<SessionDescription> &answer_sdp, ov::String *answer_text);
+
+		// Stops the session and deletes the stream of the session
+		void DeleteSession(const std::shared_ptr<WebRtcSession> &session);
+
+		std::shared_ptr<HttpServer> _http_server;
+		std::shared_ptr<HttpsServer> _https_server;
+
+		std::shared_ptr<IcePort> _ice_port;
+		std::shared_ptr<Certificate> _certificate;
+		std::shared_ptr<ov::TlsContext> _dtls_context;
+
+		// key: session id
+		std::map<session_id_t, std::shared_ptr<WebRtcSession>> _session_map;
+		std::shared_mutex _session_map_mutex;
+	};
+}  // namespace pvd
@@ -0,0 +1,159 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "webrtc_rtp_receiver.h"
+
+#include <base/ovlibrary/converter.h>
+#include <modules/rtp_rtcp/rtcp_packet.h>
+
+#define OV_LOG_TAG "WebRtcProvider"
+
+namespace pvd
+{
+	WebRtcRtpReceiver::WebRtcRtpReceiver(uint32_t id, const std::shared_ptr<info::Session> &session)
+		: SessionNode(id, pub::SessionNodeType::Rtp, session)
+	{
+		_sender_ssrc = ov::Random::GenerateUInt32();
+	}
+
+	bool WebRtcRtpReceiver::AddTrack(uint8_t payload_type, common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id)
+	{
+		auto depacketizer = RtpDepacketizer::Create(media_type, codec_id, track_id);
+
+		if (depacketizer == nullptr)
+		{
+			logte("Could not create a depacketizer for %s", ov::Converter::ToString(codec_id).CStr());
+			return false;
+		}
+
+		auto &track = _tracks[payload_type];
+
+		track.media_type = media_type;
+		track.depacketizer = depacketizer;
+
+		return true;
+	}
+
+	void WebRtcRtpReceiver::SetMediaPacketHandler(const MediaPacketHandler &handler)
+	{
+		_media_packet_handler = handler;
+	}
+
+	bool WebRtcRtpReceiver::SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data)
+	{
+		return false;
+	}
+
+	bool WebRtcRtpReceiver::OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data)
+	{
+		if (GetState() != SessionNode::NodeState::Started)
+		{
+			logtd("SessionNode has not started, so the received data has been canceled.");
+			return false;
+		}
+
+		if (from_node == pub::SessionNodeType::Rtcp)
+		{
+			// The reports of the sender (SR/SDES) are not used yet
+			return true;
+		}
+
+		// RtpPacket shares the buffer of data
+		auto packet = std::make_shared<RtpPacket>(std::const_pointer_cast<ov::Data>(data));
+
+		if (packet->Buffer() == nullptr)
+		{
+			return false;
+		}
+
+		auto item = _tracks.find(packet->PayloadType());
+
+		if (item == _tracks.end())
+		{
+			// Not negotiated (such as RTX/RED/ULPFEC)
+			return false;
+		}
+
+		auto &track = item->second;
+
+		if (track.media_ssrc != packet->Ssrc())
+		{
+			if (track.media_ssrc != 0)
+			{
+				logti("The SSRC of payload type %d has been changed: %u -> %u", packet->PayloadType(), track.media_ssrc, packet->Ssrc());
+			}
+
+			track.media_ssrc = packet->Ssrc();
+		}
+
+		track.depacketizer->AppendPacket(packet);
+
+		while (track.depacketizer->IsAvailableMediaPacket())
+		{
+			auto media_packet = track.depacketizer->PopMediaPacket();
+
+			if (_media_packet_handler != nullptr)
+			{
+				_media_packet_handler(media_packet);
+			}
+		}
+
+		SendFeedbacks(track);
+
+		return true;
+	}
+
+	void WebRtcRtpReceiver::SendFeedbacks(Track &track)
+	{
+		if (track.media_type != common::MediaType::Video)
+		{
+			// NACK/PLI are negotiated only for the video
+			return;
+		}
+
+		auto current = std::chrono::steady_clock::now();
+
+		if (std::chrono::duration_cast<std::chrono::milliseconds>(current - track.last_nack_time).count() >= WEBRTC_RTP_RECEIVER_NACK_INTERVAL_MSEC)
+		{
+			auto missing_sequence_numbers = track.depacketizer->GetMissingSequenceNumbers();
+
+			if (missing_sequence_numbers.empty() == false)
+			{
+				auto nack_packet = RtcpPacket::MakeNackPacket(_sender_ssrc, track.media_ssrc, missing_sequence_numbers);
+
+				if (nack_packet != nullptr)
+				{
+					logtd("Request to retransmit %zu packets of SSRC %u", missing_sequence_numbers.size(), track.media_ssrc);
+					SendRtcp(nack_packet);
+				}
+
+				track.last_nack_time = current;
+			}
+		}
+
+		if (track.depacketizer->IsKeyFrameRequired() &&
+			(std::chrono::duration_cast<std::chrono::milliseconds>(current - track.last_pli_time).count() >= WEBRTC_RTP_RECEIVER_PLI_INTERVAL_MSEC))
+		{
+			logtd("Request a key frame of SSRC %u", track.media_ssrc);
+			SendRtcp(RtcpPacket::MakePliPacket(_sender_ssrc, track.media_ssrc));
+
+			track.last_pli_time = current;
+		}
+	}
+
+	bool WebRtcRtpReceiver::SendRtcp(const std::shared_ptr<ov::Data> &packet)
+	{
+		auto node = GetLowerNode();
+
+		if (node == nullptr)
+		{
+			return false;
+		}
+
+		return node->SendData(pub::SessionNodeType::Rtcp, packet);
+	}
+}  // namespace pvd
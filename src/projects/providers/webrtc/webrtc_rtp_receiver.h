@@ -0,0 +1,66 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/publisher/session_node.h>
+#include <modules/rtp_rtcp/rtp_depacketizer.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+
+// The interval to request the retransmission of the same missing packets
+#define WEBRTC_RTP_RECEIVER_NACK_INTERVAL_MSEC 50
+// The interval to request a key frame while the frames are dropped
+#define WEBRTC_RTP_RECEIVER_PLI_INTERVAL_MSEC 1000
+
+namespace pvd
+{
+	// The upper node of SrtpTransport in the ingest session
+	// - Depacketizes RTP packets into MediaPackets for each negotiated payload type
+	// - Requests the lost packets (NACK) and key frames (PLI) to the peer
+	class WebRtcRtpReceiver : public pub::SessionNode
+	{
+	public:
+		using MediaPacketHandler = std::function<void(const std::shared_ptr<MediaPacket> &media_packet)>;
+
+		WebRtcRtpReceiver(uint32_t id, const std::shared_ptr<info::Session> &session);
+		~WebRtcRtpReceiver() override = default;
+
+		// It must be called before the node is started
+		bool AddTrack(uint8_t payload_type, common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id);
+		void SetMediaPacketHandler(const MediaPacketHandler &handler);
+
+		// There is nothing to send except the feedbacks
+		bool SendData(pub::SessionNodeType from_node, const std::shared_ptr<ov::Data> &data) override;
+		bool OnDataReceived(pub::SessionNodeType from_node, const std::shared_ptr<const ov::Data> &data) override;
+
+	private:
+		struct Track
+		{
+			common::MediaType media_type = common::MediaType::Unknown;
+			std::shared_ptr<RtpDepacketizer> depacketizer;
+
+			// The SSRC of the peer is learned from the first packet (it is not always signalled in the offer)
+			uint32_t media_ssrc = 0;
+
+			std::chrono::steady_clock::time_point last_nack_time;
+			std::chrono::steady_clock::time_point last_pli_time;
+		};
+
+		void SendFeedbacks(Track &track);
+		bool SendRtcp(const std::shared_ptr<ov::Data> &packet);
+
+		std::map<uint8_t, Track> _tracks;
+		MediaPacketHandler _media_packet_handler;
+
+		// The SSRC of this receiver in the feedback messages
+		uint32_t _sender_ssrc;
+	};
+}  // namespace pvd
@@ -0,0 +1,165 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "webrtc_session.h"
+
+#define OV_LOG_TAG "WebRtcProvider"
+
+namespace pvd
+{
+	std::shared_ptr<WebRtcSession> WebRtcSession::Create(const std::shared_ptr<pvd::Application> &application,
+														 const std::shared_ptr<pvd::Stream> &stream,
+														 session_id_t session_id,
+														 const std::shared_ptr<SessionDescription> &local_sdp,
+														 const std::shared_ptr<SessionDescription> &peer_sdp,
+														 const std::shared_ptr<IcePort> &ice_port)
+	{
+		auto session_info = info::Session(*std::static_pointer_cast<info::Stream>(stream), session_id);
+
+		return std::make_shared<WebRtcSession>(session_info, application, stream, local_sdp, peer_sdp, ice_port);
+	}
+
+	WebRtcSession::WebRtcSession(const info::Session &session_info,
+								 const std::shared_ptr<pvd::Application> &application,
+								 const std::shared_ptr<pvd::Stream> &stream,
+								 const std::shared_ptr<SessionDescription> &local_sdp,
+								 const std::shared_ptr<SessionDescription> &peer_sdp,
+								 const std::shared_ptr<IcePort> &ice_port)
+		: info::Session(*std::static_pointer_cast<info::Stream>(stream), session_info),
+		  _application(application),
+		  _stream(stream),
+		  _local_sdp(local_sdp),
+		  _peer_sdp(peer_sdp),
+		  _ice_port(ice_port)
+	{
+		_stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(stream));
+	}
+
+	WebRtcSession::~WebRtcSession()
+	{
+		logtd("WebRtcSession(%u) has been terminated finally", GetId());
+	}
+
+	bool WebRtcSession::AddTrack(uint8_t payload_type, common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id)
+	{
+		if (_rtp_receiver == nullptr)
+		{
+			_rtp_receiver = std::make_shared<WebRtcRtpReceiver>((uint32_t)pub::SessionNodeType::Rtp, GetSharedPtr());
+		}
+
+		return _rtp_receiver->AddTrack(payload_type, media_type, codec_id, track_id);
+	}
+
+	bool WebRtcSession::Start(const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<ov::TlsContext> &dtls_context)
+	{
+		std::lock_guard<std::mutex> lock(_node_mutex);
+
+		if (_rtp_receiver == nullptr)
+		{
+			logte("There is no track to receive");
+			return false;
+		}
+
+		auto session = GetSharedPtr();
+
+		std::weak_ptr<WebRtcSession> weak_session = GetSharedPtrAs<WebRtcSession>();
+		_rtp_receiver->SetMediaPacketHandler([weak_session](const std::shared_ptr<MediaPacket> &media_packet) {
+			auto session = weak_session.lock();
+
+			if (session != nullptr)
+			{
+				session->OnMediaPacket(media_packet);
+			}
+		});
+
+		_srtp_transport = std::make_shared<SrtpTransport>((uint32_t)pub::SessionNodeType::Srtp, session);
+
+		_dtls_transport = std::make_shared<DtlsTransport>((uint32_t)pub::SessionNodeType::Dtls, session);
+		_dtls_transport->SetLocalCertificate(certificate);
+		_dtls_transport->SetTlsContext(dtls_context);
+		_dtls_transport->SetPeerFingerprint(_peer_sdp->GetFingerprintAlgorithm(), _peer_sdp->GetFingerprintValue());
+		_dtls_transport->StartDTLS();
+
+		_dtls_ice_transport = std::make_shared<DtlsIceTransport>((uint32_t)pub::SessionNodeType::Ice, session, _ice_port);
+
+		_rtp_receiver->RegisterUpperNode(nullptr);
+		_rtp_receiver->RegisterLowerNode(_srtp_transport);
+		_rtp_receiver->Start();
+		_srtp_transport->RegisterUpperNode(_rtp_receiver);
+		_srtp_transport->RegisterLowerNode(_dtls_transport);
+		_srtp_transport->Start();
+		_dtls_transport->RegisterUpperNode(_srtp_transport);
+		_dtls_transport->RegisterLowerNode(_dtls_ice_transport);
+		_dtls_transport->Start();
+		_dtls_ice_transport->RegisterUpperNode(_dtls_transport);
+		_dtls_ice_transport->RegisterLowerNode(nullptr);
+		_dtls_ice_transport->Start();
+
+		_is_started = true;
+
+		return true;
+	}
+
+	bool WebRtcSession::Stop()
+	{
+		std::lock_guard<std::mutex> lock(_node_mutex);
+
+		_is_started = false;
+
+		// The nodes have the references of this session, so they must be stopped to release it
+		if (_rtp_receiver != nullptr)
+		{
+			_rtp_receiver->Stop();
+			_rtp_receiver = nullptr;
+		}
+
+		if (_dtls_ice_transport != nullptr)
+		{
+			_dtls_ice_transport->Stop();
+			_dtls_ice_transport = nullptr;
+		}
+
+		if (_dtls_transport != nullptr)
+		{
+			_dtls_transport->Stop();
+			_dtls_transport = nullptr;
+		}
+
+		if (_srtp_transport != nullptr)
+		{
+			_srtp_transport->Stop();
+			_srtp_transport = nullptr;
+		}
+
+		return true;
+	}
+
+	void WebRtcSession::OnPacketReceived(const std::shared_ptr<const ov::Data> &data)
+	{
+		std::lock_guard<std::mutex> lock(_node_mutex);
+
+		if (_is_started == false)
+		{
+			return;
+		}
+
+		_received_bytes += data->GetLength();
+
+		if (_stream_metrics != nullptr)
+		{
+			_stream_metrics->IncreaseBytesIn(data->GetLength());
+		}
+
+		// ICE -> DTLS -> SRTP -> RTP/RTCP
+		_dtls_ice_transport->OnDataReceived(pub::SessionNodeType::None, data);
+	}
+
+	void WebRtcSession::OnMediaPacket(const std::shared_ptr<MediaPacket> &media_packet)
+	{
+		_application->SendFrame(_stream, media_packet);
+	}
+}  // namespace pvd
@@ -0,0 +1,97 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/info/session.h>
+#include <base/ovcrypto/ovcrypto.h>
+#include <base/provider/application.h>
+#include <base/provider/stream.h>
+#include <modules/dtls_srtp/dtls_ice_transport.h>
+#include <modules/dtls_srtp/dtls_transport.h>
+#include <modules/dtls_srtp/srtp_transport.h>
+#include <modules/ice/ice_port.h>
+#include <modules/sdp/session_description.h>
+#include <monitoring/monitoring.h>
+
+#include "webrtc_rtp_receiver.h"
+
+namespace pvd
+{
+	// A peer which publishes a stream
+	//
+	// The nodes are stacked in reverse order of RtcSession, the packets go up from IcePort:
+	// [ICE/STUN] -> [DTLS] -> [SRTP] -> [WebRtcRtpReceiver] -> MediaPackets -> Application
+	// and the feedbacks (NACK/PLI) go down from WebRtcRtpReceiver.
+	class WebRtcSession : public info::Session
+	{
+	public:
+		static std::shared_ptr<WebRtcSession> Create(const std::shared_ptr<pvd::Application> &application,
+													 const std::shared_ptr<pvd::Stream> &stream,
+													 session_id_t session_id,
+													 const std::shared_ptr<SessionDescription> &local_sdp,
+													 const std::shared_ptr<SessionDescription> &peer_sdp,
+													 const std::shared_ptr<IcePort> &ice_port);
+
+		WebRtcSession(const info::Session &session_info,
+					  const std::shared_ptr<pvd::Application> &application,
+					  const std::shared_ptr<pvd::Stream> &stream,
+					  const std::shared_ptr<SessionDescription> &local_sdp,
+					  const std::shared_ptr<SessionDescription> &peer_sdp,
+					  const std::shared_ptr<IcePort> &ice_port);
+		~WebRtcSession() override;
+
+		// It must be called before Start()
+		bool AddTrack(uint8_t payload_type, common::MediaType media_type, common::MediaCodecId codec_id, int32_t track_id);
+
+		bool Start(const std::shared_ptr<Certificate> &certificate, const std::shared_ptr<ov::TlsContext> &dtls_context);
+		bool Stop();
+
+		// Called from the thread of IcePort
+		void OnPacketReceived(const std::shared_ptr<const ov::Data> &data);
+
+		const std::shared_ptr<pvd::Application> &GetApplication() const
+		{
+			return _application;
+		}
+
+		const std::shared_ptr<pvd::Stream> &GetStream() const
+		{
+			return _stream;
+		}
+
+		const std::shared_ptr<SessionDescription> &GetLocalSdp() const
+		{
+			return _local_sdp;
+		}
+
+		const std::shared_ptr<SessionDescription> &GetPeerSdp() const
+		{
+			return _peer_sdp;
+		}
+
+	private:
+		void OnMediaPacket(const std::shared_ptr<MediaPacket> &media_packet);
+
+		std::shared_ptr<pvd::Application> _application;
+		std::shared_ptr<pvd::Stream> _stream;
+		std::shared_ptr<mon::StreamMetrics> _stream_metrics;
+
+		std::shared_ptr<SessionDescription> _local_sdp;
+		std::shared_ptr<SessionDescription> _peer_sdp;
+		std::shared_ptr<IcePort> _ice_port;
+
+		std::shared_ptr<WebRtcRtpReceiver> _rtp_receiver;
+		std::shared_ptr<SrtpTransport> _srtp_transport;
+		std::shared_ptr<DtlsTransport> _dtls_transport;
+		std::shared_ptr<DtlsIceTransport> _dtls_ice_transport;
+
+		// The packets are received by the threads of IcePort, and the session is stopped by the others
+		std::mutex _node_mutex;
+		bool _is_started = false;
+	};
+}  // namespace pvd
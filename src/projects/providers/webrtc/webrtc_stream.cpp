@@ -0,0 +1,44 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "webrtc_stream.h"
+
+#include "base/info/application.h"
+
+namespace pvd
+{
+	std::shared_ptr<WebRtcStream> WebRtcStream::Create(const std::shared_ptr<pvd::Application> &application, const uint32_t stream_id, const ov::String &stream_name)
+	{
+		info::Stream stream_info(*std::static_pointer_cast<info::Application>(application), StreamSourceType::Webrtc);
+		stream_info.SetId(stream_id);
+		stream_info.SetName(stream_name);
+
+		auto stream = std::make_shared<WebRtcStream>(application, stream_info);
+		if (stream != nullptr)
+		{
+			stream->Start();
+		}
+		return stream;
+	}
+
+	WebRtcStream::WebRtcStream(const std::shared_ptr<pvd::Application> &application, const info::Stream &stream_info)
+		: pvd::Stream(application, stream_info)
+	{
+	}
+
+	bool WebRtcStream::Start()
+	{
+		_state = Stream::State::PLAYING;
+		return true;
+	}
+
+	bool WebRtcStream::Stop()
+	{
+		_state = Stream::State::STOPPING;
+		return true;
+	}
+}  // namespace pvd
@@ -0,0 +1,28 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "base/common_types.h"
+#include "base/provider/application.h"
+#include "base/provider/stream.h"
+
+namespace pvd
+{
+	// The frames are depacketized by WebRtcSession, so the stream only represents the ingested stream
+	class WebRtcStream : public pvd::Stream
+	{
+	public:
+		static std::shared_ptr<WebRtcStream> Create(const std::shared_ptr<pvd::Application> &application, const uint32_t stream_id, const ov::String &stream_name);
+
+		explicit WebRtcStream(const std::shared_ptr<pvd::Application> &application, const info::Stream &stream_info);
+		~WebRtcStream() final = default;
+
+		bool Start() override;
+		bool Stop() override;
+	};
+}  // namespace pvd
@@ -1,5 +1,6 @@
 #include "ovt_private.h"
 #include "ovt_application.h"
+#include "ovt_publisher.h"
 #include "ovt_stream.h"
 #include "ovt_session.h"
 
@@ -11,9 +12,10 @@ std::shared_ptr<OvtApplication> OvtApplication::Create(const std::shared_ptr<pub
 }
 
 OvtApplication::OvtApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
-		: Application(publisher, application_info)
+		: Application(publisher, application_info),
+		  _publisher(std::static_pointer_cast<OvtPublisher>(publisher))
 {
-
+	SetDirectDispatch(true);
 }
 
 OvtApplication::~OvtApplication()
@@ -32,6 +34,34 @@ bool OvtApplication::Stop()
 	return Application::Stop();
 }
 
+bool OvtApplication::OnCreateStream(const std::shared_ptr<info::Stream> &info)
+{
+	if(Application::OnCreateStream(info) == false)
+	{
+		return false;
+	}
+
+	// The stream is notified after it is added, so the edges can pull it as soon as they are notified
+	auto publisher = _publisher.lock();
+	if(publisher != nullptr)
+	{
+		publisher->NotifyStreamEvent(*this, info->GetName(), OvtControlMessage::StreamEvent::Created);
+	}
+
+	return true;
+}
+
+bool OvtApplication::OnDeleteStream(const std::shared_ptr<info::Stream> &info)
+{
+	auto publisher = _publisher.lock();
+	if(publisher != nullptr)
+	{
+		publisher->NotifyStreamEvent(*this, info->GetName(), OvtControlMessage::StreamEvent::Deleted);
+	}
+
+	return Application::OnDeleteStream(info);
+}
+
 std::shared_ptr<pub::Stream> OvtApplication::CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count)
 {
 	logtd("OvtApplication::CreateStream : %s/%u", info->GetName().CStr(), info->GetId());
@@ -6,6 +6,8 @@
 
 #include "ovt_stream.h"
 
+class OvtPublisher;
+
 class OvtApplication : public pub::Application
 {
 public:
@@ -13,6 +15,10 @@ public:
 	OvtApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info);
 	~OvtApplication() final;
 
+	// The subscribers of the application are notified of the stream (See OVT_PAYLOAD_TYPE_SUBSCRIBE)
+	bool OnCreateStream(const std::shared_ptr<info::Stream> &info) override;
+	bool OnDeleteStream(const std::shared_ptr<info::Stream> &info) override;
+
 private:
 	bool Start() override;
 	bool Stop() override;
@@ -20,4 +26,6 @@ private:
 	// Application Implementation
 	std::shared_ptr<pub::Stream> CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count) override;
 	bool DeleteStream(const std::shared_ptr<info::Stream> &info) override;
+
+	std::weak_ptr<OvtPublisher> _publisher;
 };
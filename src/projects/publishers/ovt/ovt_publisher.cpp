@@ -3,6 +3,9 @@
 #include "ovt_publisher.h"
 #include "ovt_session.h"
 
+#include <base/ovlibrary/byte_io.h>
+#include <modules/ovt_packetizer/ovt_datagram.h>
+
 std::shared_ptr<OvtPublisher> OvtPublisher::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
 {
 	auto ovt = std::make_shared<OvtPublisher>(server_config, router);
@@ -43,16 +46,60 @@ bool OvtPublisher::Start()
 			const ov::String &ip = server_config.GetIp();
 			ov::SocketAddress address = ov::SocketAddress(ip.IsEmpty() ? nullptr : ip.CStr(), static_cast<uint16_t>(port));
 
-			_server_port = PhysicalPortManager::Instance()->CreatePort(origin.GetSocketType(), address);
+			_server_port = PhysicalPortManager::Instance()->CreatePort(origin.GetSocketType(), address, origin.GetReactorCount(),
+																				   origin.GetWorkerCount(), origin.GetWorkerAffinity());
 			if (_server_port != nullptr)
 			{
 				logti("Ovt Publisher has started listening on %s", address.ToString().CStr());
 				_server_port->AddObserver(this);
+
+				if (origin.GetLowLatency().IsEnabled())
+				{
+					// The packets of OVT cannot be dropped, so only the socket options are used
+					_server_port->SetLowLatencyOptions(origin.GetLowLatency().ToSocketOptions());
+				}
 			}
 			else
 			{
 				logte("Could not create relay port. Origin features will not work.");
 			}
+
+			int datagram_port = origin.GetDatagramPort();
+
+			if ((_server_port != nullptr) && (datagram_port > 0))
+			{
+				ov::SocketAddress datagram_address = ov::SocketAddress(ip.IsEmpty() ? nullptr : ip.CStr(), static_cast<uint16_t>(datagram_port));
+
+				_datagram_port = PhysicalPortManager::Instance()->CreatePort(ov::SocketType::Udp, datagram_address, origin.GetReactorCount());
+
+				if (_datagram_port != nullptr)
+				{
+					logti("Ovt Publisher has started listening on %s for the datagram mode", datagram_address.ToString().CStr());
+					_datagram_port_number = static_cast<uint16_t>(datagram_port);
+					_datagram_port->AddObserver(this);
+				}
+				else
+				{
+					logte("Could not create the datagram port. The edges will receive the packets over the connection.");
+				}
+			}
+
+			const auto &shared_memory_path = origin.GetSharedMemoryPath();
+
+			if ((_server_port != nullptr) && (shared_memory_path.IsEmpty() == false))
+			{
+				_shared_memory_server = std::make_shared<OvtSharedMemoryServer>();
+
+				if (_shared_memory_server->Start(shared_memory_path, this))
+				{
+					logti("Ovt Publisher has started listening on %s for the shared memory mode", shared_memory_path.CStr());
+				}
+				else
+				{
+					logte("Could not listen on %s. The edges on the same host will receive the packets over the connection.", shared_memory_path.CStr());
+					_shared_memory_server.reset();
+				}
+			}
 		}
 		else
 		{
@@ -76,6 +123,17 @@ bool OvtPublisher::Stop()
 		_server_port->Close();
 	}
 
+	if (_datagram_port != nullptr)
+	{
+		_datagram_port->RemoveObserver(this);
+		_datagram_port->Close();
+	}
+
+	if (_shared_memory_server != nullptr)
+	{
+		_shared_memory_server->Stop();
+	}
+
 	return Publisher::Stop();
 }
 
@@ -99,6 +157,12 @@ void OvtPublisher::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
 									const ov::SocketAddress &address,
 									const std::shared_ptr<const ov::Data> &data)
 {
+	if(remote->GetType() == ov::SocketType::Udp)
+	{
+		HandleDatagram(remote, address, data);
+		return;
+	}
+
 	auto packet = std::make_shared<OvtPacket>(*data);
 	if(!packet->IsPacketAvailable())
 	{
@@ -107,30 +171,28 @@ void OvtPublisher::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
 		return;
 	}
 
-	// Parsing Payload
-	ov::String payload((const char *)packet->Payload(), packet->PayloadLength());
-	ov::JsonObject object = ov::Json::Parse(payload);
+	// Parsing Payload (The edge requests in JSON or binary, and the response is sent in the same format)
+	auto request = OvtControlMessage::Parse(std::make_shared<ov::Data>(packet->Payload(), packet->PayloadLength(), true));
 
-	if(object.IsNull())
+	if(request == nullptr)
 	{
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), 0, 404, "An invalid request : Json format");
+		ResponseResult(remote, OvtControlMessage::Format::Json, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), 0, 404, "An invalid request : Json format");
 		return;
 	}
 
-	Json::Value &json_request_id = object.GetJsonValue()["id"];
-	Json::Value &json_request_url = object.GetJsonValue()["url"];
+	auto format = request->GetFormat();
 
-	if(json_request_id.isNull() || json_request_url.isNull() || !json_request_id.isUInt())
+	if(request->IsValidRequest() == false)
 	{
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), 0, 404, "An invalid request : Id or Url are not valid");
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), 0, 404, "An invalid request : Id or Url are not valid");
 		return;
 	}
 
-	uint32_t request_id = json_request_id.asUInt();
-	auto url = ov::Url::Parse(json_request_url.asString());
+	uint32_t request_id = request->GetId();
+	auto url = ov::Url::Parse(request->GetUrl().CStr());
 	if(url == nullptr)
 	{
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), json_request_id.asUInt(), 404, "An invalid request : Url is not valid");
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), request_id, 404, "An invalid request : Url is not valid");
 		return;
 	}
 
@@ -138,18 +200,21 @@ void OvtPublisher::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
 	{
 		case OVT_PAYLOAD_TYPE_DESCRIBE:
 			// Add session
-			HandleDescribeRequest(remote, request_id, url);
+			HandleDescribeRequest(remote, format, request_id, url);
 			break;
 		case OVT_PAYLOAD_TYPE_PLAY:
-			HandlePlayRequest(remote, request_id, url);
+			HandlePlayRequest(remote, format, request_id, url, request->GetRequestedTransport());
 			break;
 		case OVT_PAYLOAD_TYPE_STOP:
 			// Remove session
-			HandleStopRequest(remote, packet->SessionId(), request_id, url);
+			HandleStopRequest(remote, format, packet->SessionId(), request_id, url);
+			break;
+		case OVT_PAYLOAD_TYPE_SUBSCRIBE:
+			HandleSubscribeRequest(remote, format, request_id, url);
 			break;
 		default:
 			// Response error message and disconnect
-			ResponseResult(remote, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), request_id, 404, "An invalid request");
+			ResponseResult(remote, format, OVT_PAYLOAD_TYPE_ERROR, packet->SessionId(), request_id, 404, "An invalid request");
 			break;
 	}
 }
@@ -173,25 +238,88 @@ void OvtPublisher::OnDisconnected(const std::shared_ptr<ov::Socket> &remote,
 	}
 
 	UnlinkRemoteFromStream(remote->GetId());
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_subscriber_map_mutex);
+
+		for(auto it = _subscriber_map.begin(); it != _subscriber_map.end();)
+		{
+			if(it->second.remote->GetId() == remote->GetId())
+			{
+				it = _subscriber_map.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_session_token_map_mutex);
+
+		for(auto it = _session_token_map.begin(); it != _session_token_map.end();)
+		{
+			auto session = it->second.lock();
+
+			if((session == nullptr) || (session->GetConnector()->GetId() == remote->GetId()))
+			{
+				it = _session_token_map.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
 }
 
-void OvtPublisher::HandleDescribeRequest(const std::shared_ptr<ov::Socket> &remote, const uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
+void OvtPublisher::HandleDescribeRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, const uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
 {
-	auto vhost_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(url->Domain(), url->App());
-	auto stream = std::static_pointer_cast<OvtStream>(GetStream(vhost_app_name, url->Stream()));
+	auto orchestrator = Orchestrator::GetInstance();
+	auto vhost_app_name = orchestrator->ResolveApplicationNameFromDomain(url->Domain(), url->App());
+	auto stream_name = url->Stream();
+
+	if(GetStream(vhost_app_name, stream_name) == nullptr)
+	{
+		std::vector<ov::String> url_list;
+
+		if(orchestrator->GetUrlListForLocation(vhost_app_name, stream_name, &url_list))
+		{
+			// This server is a mid-tier of the OVT relay tree (the <Origins> of the edges point to this server, and the <Origins> of this server point to the upper tier).
+			// The stream is pulled once, and all the edges are served from it, so the egress of the origin doesn't grow with the number of edges.
+			// The edge waits for the response, so it is sent when the pull is completed.
+			auto publisher = GetSharedPtrAs<OvtPublisher>();
+
+			logti("Pulling the stream [%s/%s] to relay it to %s", vhost_app_name.CStr(), stream_name.CStr(), remote->ToString().CStr());
+
+			orchestrator->RequestPullStreamAsync(vhost_app_name, stream_name, 0, [publisher, remote, format, request_id, vhost_app_name, stream_name](bool result) {
+				publisher->ResponseDescription(remote, format, request_id, vhost_app_name, stream_name);
+			});
+
+			return;
+		}
+	}
+
+	ResponseDescription(remote, format, request_id, vhost_app_name, stream_name);
+}
+
+void OvtPublisher::ResponseDescription(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const ov::String &vhost_app_name, const ov::String &stream_name)
+{
+	auto stream = std::static_pointer_cast<OvtStream>(GetStream(vhost_app_name, stream_name));
 	if(stream == nullptr)
 	{
 		ov::String msg;
-		msg.Format("There is no such stream (%s/%s)", vhost_app_name.CStr(), url->Stream().CStr());
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_DESCRIBE, 0, request_id, 404, msg);
+		msg.Format("There is no such stream (%s/%s)", vhost_app_name.CStr(), stream_name.CStr());
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_DESCRIBE, 0, request_id, 404, msg);
 		return;
 	}
 
-	Json::Value description = stream->GetDescription();
-	ResponseResult(remote, OVT_PAYLOAD_TYPE_DESCRIBE, 0, request_id, 200, "ok", "stream", description);
+	// The description is serialized once per stream and format, so it is not rebuilt for each edge
+	ResponseResult(remote, format, OVT_PAYLOAD_TYPE_DESCRIBE, 0, request_id, 200, "ok", stream->GetDescription(format));
 }
 
-void OvtPublisher::HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote, uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
+void OvtPublisher::HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const std::shared_ptr<const ov::Url> &url, OvtControlMessage::Transport transport)
 {
 	auto vhost_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(url->Domain(), url->App());
 	
@@ -200,7 +328,7 @@ void OvtPublisher::HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote,
 	{
 		ov::String msg;
 		msg.Format("There is no such app (%s)", vhost_app_name.CStr());
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
 		return;
 	}
 
@@ -209,7 +337,7 @@ void OvtPublisher::HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote,
 	{
 		ov::String msg;
 		msg.Format("There is no such stream (%s/%s)", vhost_app_name.CStr(), url->Stream().CStr());
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
 		return;
 	}
 
@@ -218,18 +346,46 @@ void OvtPublisher::HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote,
 	{
 		ov::String msg;
 		msg.Format("Internal Error : Cannot create session");
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_PLAY, 0, request_id, 404, msg);
 		return;
 	}
 
 	LinkRemoteWithStream(remote->GetId(), stream);
 
-	ResponseResult(remote, OVT_PAYLOAD_TYPE_PLAY, session->GetId(), request_id, 200, "ok");
+	auto remote_address = remote->GetRemoteAddress();
+	// The memory can be shared only with the edges on the same host
+	bool is_local = (remote_address != nullptr) && (remote_address->GetIpAddress().HasPrefix("127.") || (remote_address->GetIpAddress() == "::1"));
+
+	if((transport == OvtControlMessage::Transport::SharedMemory) && (_shared_memory_server != nullptr) && is_local && (stream->EnableSharedMemory() != nullptr))
+	{
+		auto token = IssueSessionToken(session);
+
+		session->EnableSharedMemory(token);
+
+		auto payload = OvtControlMessage::SerializeResponse(format, request_id, 200, "ok", _shared_memory_server->GetPath(), token);
+		if(payload != nullptr)
+		{
+			SendResponse(remote, OVT_PAYLOAD_TYPE_PLAY, session->GetId(), payload);
+		}
+	}
+	else if((transport == OvtControlMessage::Transport::Datagram) && (_datagram_port != nullptr))
+	{
+		auto token = IssueSessionToken(session);
+
+		session->EnableDatagram(token);
+		stream->EnableRetransmit();
+
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_PLAY, session->GetId(), request_id, 200, "ok", nullptr, _datagram_port_number, token);
+	}
+	else
+	{
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_PLAY, session->GetId(), request_id, 200, "ok");
+	}
 
 	stream->AddSession(session);
 }
 
-void OvtPublisher::HandleStopRequest(const std::shared_ptr<ov::Socket> &remote, uint32_t session_id, uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
+void OvtPublisher::HandleStopRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t session_id, uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
 {
 	auto vhost_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(url->Domain(), url->App());
 	auto stream = std::static_pointer_cast<OvtStream>(GetStream(vhost_app_name, url->Stream()));
@@ -238,48 +394,222 @@ void OvtPublisher::HandleStopRequest(const std::shared_ptr<ov::Socket> &remote,
 	{
 		ov::String msg;
 		msg.Format("There is no such stream (%s/%s)", vhost_app_name.CStr(), url->Stream().CStr());
-		ResponseResult(remote, OVT_PAYLOAD_TYPE_STOP, 0, request_id, 404, msg);
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_STOP, 0, request_id, 404, msg);
 		return;
 	}
 
-	ResponseResult(remote, OVT_PAYLOAD_TYPE_STOP, session_id, request_id, 200, "ok");
+	ResponseResult(remote, format, OVT_PAYLOAD_TYPE_STOP, session_id, request_id, 200, "ok");
 
 	stream->RemoveSession(session_id);
 }
 
-void OvtPublisher::ResponseResult(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, uint32_t request_id, uint32_t code, const ov::String &msg)
+void OvtPublisher::HandleSubscribeRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const std::shared_ptr<const ov::Url> &url)
+{
+	auto vhost_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(url->Domain(), url->App());
+
+	auto app = std::static_pointer_cast<OvtApplication>(GetApplicationByName(vhost_app_name.CStr()));
+	if(app == nullptr)
+	{
+		ov::String msg;
+		msg.Format("There is no such app (%s)", vhost_app_name.CStr());
+		ResponseResult(remote, format, OVT_PAYLOAD_TYPE_SUBSCRIBE, 0, request_id, 404, msg);
+		return;
+	}
+
+	logti("%s has subscribed to the streams of %s", remote->ToString().CStr(), vhost_app_name.CStr());
+
+	// The subscriber is added before the current streams are notified, so a stream that is created in the meantime is not missed
+	// (the edge may be notified of it twice, and it is harmless)
+	{
+		std::lock_guard<std::mutex> lock_guard(_subscriber_map_mutex);
+		_subscriber_map.emplace(vhost_app_name, Subscriber{remote, format});
+	}
+
+	ResponseResult(remote, format, OVT_PAYLOAD_TYPE_SUBSCRIBE, 0, request_id, 200, "ok");
+
+	for(const auto &stream : app->GetStreamList())
+	{
+		SendNotification(remote, format, vhost_app_name, stream->GetName(), OvtControlMessage::StreamEvent::Created);
+	}
+}
+
+void OvtPublisher::NotifyStreamEvent(const info::Application &application, const ov::String &stream_name, OvtControlMessage::StreamEvent event)
+{
+	std::vector<Subscriber> subscribers;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_subscriber_map_mutex);
+
+		auto range = _subscriber_map.equal_range(application.GetName());
+		for(auto it = range.first; it != range.second; ++it)
+		{
+			subscribers.push_back(it->second);
+		}
+	}
+
+	for(const auto &subscriber : subscribers)
+	{
+		SendNotification(subscriber.remote, subscriber.format, application.GetName(), stream_name, event);
+	}
+}
+
+void OvtPublisher::SendNotification(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, const ov::String &app_name, const ov::String &stream_name, OvtControlMessage::StreamEvent event)
+{
+	// The edge needs only the name of the stream, it is described when the edge pulls it
+	auto stream_description = OvtControlMessage::SerializeStreamDescription(format, app_name, stream_name, {});
+	auto payload = (stream_description != nullptr) ? OvtControlMessage::SerializeNotification(format, event, stream_description) : nullptr;
+
+	if(payload == nullptr)
+	{
+		logte("Could not serialize the notification : %s/%s", app_name.CStr(), stream_name.CStr());
+		return;
+	}
+
+	SendResponse(remote, OVT_PAYLOAD_TYPE_NOTIFY, 0, payload);
+}
+
+uint32_t OvtPublisher::IssueSessionToken(const std::shared_ptr<OvtSession> &session)
 {
-	Json::Value root;
+	std::lock_guard<std::mutex> lock_guard(_session_token_map_mutex);
 
-	root["id"] = request_id;
-	root["code"] = code;
-	root["message"] = msg.CStr();
+	while(true)
+	{
+		// The token is random so that the other hosts cannot guess it
+		auto token = ov::Random::GenerateUInt32();
 
-	SendResponse(remote, payload_type, session_id, ov::Json::Stringify(root));
+		if(_session_token_map.find(token) == _session_token_map.end())
+		{
+			_session_token_map.emplace(token, session);
+			return token;
+		}
+	}
 }
 
-void OvtPublisher::ResponseResult(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, uint32_t request_id,
-									uint32_t code, const ov::String &msg, const ov::String &key, const Json::Value &value)
+std::shared_ptr<OvtSession> OvtPublisher::FindSessionByToken(uint32_t token)
 {
-	Json::Value root;
+	std::lock_guard<std::mutex> lock_guard(_session_token_map_mutex);
+
+	auto item = _session_token_map.find(token);
+
+	if(item == _session_token_map.end())
+	{
+		return nullptr;
+	}
+
+	auto session = item->second.lock();
+
+	if(session == nullptr)
+	{
+		// The session has been stopped
+		_session_token_map.erase(item);
+	}
+
+	return session;
+}
+
+std::shared_ptr<OvtSharedMemoryRing> OvtPublisher::OnSharedMemoryRequested(uint32_t token)
+{
+	auto session = FindSessionByToken(token);
+
+	if((session == nullptr) || (session->IsSharedMemoryEnabled() == false))
+	{
+		logtw("Unknown shared memory session (token: %u)", token);
+		return nullptr;
+	}
+
+	auto stream = std::static_pointer_cast<OvtStream>(session->GetStream());
 
-	root["id"] = request_id;
-	root["code"] = code;
-	root["message"] = msg.CStr();
-	root[key.CStr()] = value;
+	return stream->GetSharedMemoryRing();
+}
+
+bool OvtPublisher::OnSharedMemoryAttached(uint32_t token, int connection)
+{
+	auto session = FindSessionByToken(token);
+
+	if((session == nullptr) || (session->IsSharedMemoryEnabled() == false))
+	{
+		// The session has been stopped in the meantime
+		return false;
+	}
+
+	if(session->AttachSharedMemory(connection) == false)
+	{
+		return false;
+	}
+
+	auto stream = std::static_pointer_cast<OvtStream>(session->GetStream());
+	stream->AddSharedMemorySession(session);
+
+	logti("OvtSession(%u) - The frames of %s/%s are shared with the edge on the same host",
+		  session->GetId(), stream->GetApplication()->GetName().CStr(), stream->GetName().CStr());
+
+	return true;
+}
+
+void OvtPublisher::HandleDatagram(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data)
+{
+	OvtPacket packet(*data);
+
+	if((packet.IsPacketAvailable() == false) || (packet.PayloadLength() < sizeof(uint32_t)))
+	{
+		// Datagrams from unknown hosts are ignored without a response
+		return;
+	}
+
+	uint32_t token = ByteReader<uint32_t>::ReadBigEndian(packet.Payload());
+	auto session = FindSessionByToken(token);
+
+	if((session == nullptr) || (session->GetId() != packet.SessionId()))
+	{
+		logtd("Unknown datagram session : %s (token: %u, session: %u)", address.ToString().CStr(), token, packet.SessionId());
+		return;
+	}
+
+	switch(packet.PayloadType())
+	{
+		case OVT_PAYLOAD_TYPE_DATAGRAM_BIND:
+			session->BindDatagram(remote, address);
+			break;
+
+		case OVT_PAYLOAD_TYPE_NACK: {
+			std::vector<uint16_t> sequence_numbers;
+
+			if(session->IsBoundTo(address) && OvtNack::Parse(packet.Payload(), packet.PayloadLength(), &token, &sequence_numbers))
+			{
+				auto stream = std::static_pointer_cast<OvtStream>(session->GetStream());
+				stream->Retransmit(session, sequence_numbers);
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+void OvtPublisher::ResponseResult(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint8_t payload_type, uint32_t session_id, uint32_t request_id,
+									uint32_t code, const ov::String &msg, const std::shared_ptr<const ov::Data> &stream_description,
+									uint16_t datagram_port, uint32_t datagram_token)
+{
+	auto payload = OvtControlMessage::SerializeResponse(format, request_id, code, msg, stream_description, datagram_port, datagram_token);
+
+	if(payload == nullptr)
+	{
+		logte("Could not serialize the response : id(%u) code(%u)", request_id, code);
+		return;
+	}
 
-	SendResponse(remote, payload_type, session_id, ov::Json::Stringify(root));
+	SendResponse(remote, payload_type, session_id, payload);
 }
 
-void OvtPublisher::SendResponse(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, const ov::String &payload)
+void OvtPublisher::SendResponse(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, const std::shared_ptr<const ov::Data> &payload)
 {
 	size_t max_payload_size = OVT_DEFAULT_MAX_PACKET_SIZE - OVT_FIXED_HEADER_SIZE;
-	size_t remain_payload_len = payload.GetLength();
+	size_t remain_payload_len = payload->GetLength();
 	size_t offset = 0;
 	uint32_t sn = 0;
 
-	auto data = payload.ToData(false);
-	auto buffer = data->GetDataAs<uint8_t>();
+	auto buffer = payload->GetDataAs<uint8_t>();
 
 	while(remain_payload_len != 0)
 	{
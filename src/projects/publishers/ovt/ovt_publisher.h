@@ -1,6 +1,8 @@
 #pragma once
 
 #include "modules/ovt_packetizer/ovt_packet.h"
+#include "modules/ovt_packetizer/ovt_control_message.h"
+#include "modules/ovt_packetizer/ovt_shared_memory.h"
 
 #include "base/common_types.h"
 #include "base/ovlibrary/url.h"
@@ -8,10 +10,11 @@
 #include "base/media_route/media_route_application_interface.h"
 
 #include "ovt_application.h"
+#include "ovt_session.h"
 
 #include <orchestrator/orchestrator.h>
 
-class OvtPublisher : public pub::Publisher, public PhysicalPortObserver
+class OvtPublisher : public pub::Publisher, public PhysicalPortObserver, public OvtSharedMemoryObserver
 {
 public:
 	static std::shared_ptr<OvtPublisher> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
@@ -20,6 +23,9 @@ public:
 	~OvtPublisher() override;
 	bool Stop() override;
 
+	// Sends NOTIFY to the subscribers of the application (See OVT_PAYLOAD_TYPE_SUBSCRIBE)
+	void NotifyStreamEvent(const info::Application &application, const ov::String &stream_name, OvtControlMessage::StreamEvent event);
+
 private:
 	bool Start() override;
 
@@ -50,21 +56,61 @@ private:
 	void OnDisconnected(const std::shared_ptr<ov::Socket> &remote, PhysicalPortDisconnectReason reason, const std::shared_ptr<const ov::Error> &error) override;
 	//--------------------------------------------------------------------
 
+	//--------------------------------------------------------------------
+	// Implementation of OvtSharedMemoryObserver
+	//--------------------------------------------------------------------
+	std::shared_ptr<OvtSharedMemoryRing> OnSharedMemoryRequested(uint32_t token) override;
+	bool OnSharedMemoryAttached(uint32_t token, int connection) override;
+	//--------------------------------------------------------------------
+
+
+	// format: The format of the request, the response is sent in the same format
+	void HandleDescribeRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
+	void ResponseDescription(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const ov::String &vhost_app_name, const ov::String &stream_name);
+	void HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const std::shared_ptr<const ov::Url> &url, OvtControlMessage::Transport transport);
+	void HandleStopRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t session_id, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
+	void HandleSubscribeRequest(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
+	void SendNotification(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, const ov::String &app_name, const ov::String &stream_name, OvtControlMessage::StreamEvent event);
 
-	void HandleDescribeRequest(const std::shared_ptr<ov::Socket> &remote, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
-	void HandlePlayRequest(const std::shared_ptr<ov::Socket> &remote, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
-	void HandleStopRequest(const std::shared_ptr<ov::Socket> &remote, uint32_t session_id, uint32_t request_id, const std::shared_ptr<const ov::Url> &url);
+	void ResponseResult(const std::shared_ptr<ov::Socket> &remote, OvtControlMessage::Format format, uint8_t payload_type, uint32_t session_id, uint32_t request_id,
+						uint32_t code, const ov::String &msg, const std::shared_ptr<const ov::Data> &stream_description = nullptr,
+						uint16_t datagram_port = 0, uint32_t datagram_token = 0);
 
-	void ResponseResult(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, uint32_t request_id, uint32_t code, const ov::String &msg);
-	void ResponseResult(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, uint32_t request_id, uint32_t code, const ov::String &msg, const ov::String &key, const Json::Value &value);
+	void SendResponse(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, const std::shared_ptr<const ov::Data> &payload);
 
-	void SendResponse(const std::shared_ptr<ov::Socket> &remote, uint8_t payload_type, uint32_t session_id, const ov::String &payload);
 
+	// The sessions of the datagram/shared memory mode are found by the token
+	uint32_t IssueSessionToken(const std::shared_ptr<OvtSession> &session);
+	std::shared_ptr<OvtSession> FindSessionByToken(uint32_t token);
+
+	// Datagram mode (See OVT_PAYLOAD_TYPE_DATAGRAM_BIND)
+	void HandleDatagram(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data);
 
 	bool LinkRemoteWithStream(int remote_id, std::shared_ptr<OvtStream> &stream);
 	bool UnlinkRemoteFromStream(int remote_id);
 
 	std::shared_ptr<PhysicalPort> _server_port;
+	// <DatagramPort>, the media packets are sent over it to the edges of the datagram mode
+	std::shared_ptr<PhysicalPort> _datagram_port;
+	uint16_t _datagram_port_number = 0;
+
+	// <SharedMemoryPath>, the rings of the streams are handed over to the edges on the same host through it
+	std::shared_ptr<OvtSharedMemoryServer> _shared_memory_server;
+
+	std::mutex _session_token_map_mutex;
+	// key: token
+	std::unordered_map<uint32_t, std::weak_ptr<OvtSession>> _session_token_map;
+
+	struct Subscriber
+	{
+		std::shared_ptr<ov::Socket> remote;
+		// The notifications are sent in the format of the request
+		OvtControlMessage::Format format;
+	};
+
+	std::mutex _subscriber_map_mutex;
+	// key: vhost_app_name
+	std::multimap<ov::String, Subscriber> _subscriber_map;
 
 	// When a client is disconnected ungracefully, this map helps to find stream and delete the session quickly
 	std::multimap<int, std::shared_ptr<OvtStream>>	_remote_stream_map;
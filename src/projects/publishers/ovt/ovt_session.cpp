@@ -1,9 +1,14 @@
 #include "base/info/stream.h"
 #include "base/ovlibrary/byte_io.h"
+#include "base/publisher/application.h"
 #include "base/publisher/stream.h"
+#include "modules/ovt_packetizer/ovt_packet.h"
 #include "ovt_session.h"
 #include "ovt_private.h"
 
+#include <modules/ovt_packetizer/ovt_shared_memory.h>
+#include <unistd.h>
+
 std::shared_ptr<OvtSession> OvtSession::Create(const std::shared_ptr<pub::Application> &application,
 										  	   const std::shared_ptr<pub::Stream> &stream,
 										  	   uint32_t session_id,
@@ -26,11 +31,25 @@ OvtSession::OvtSession(const info::Session &session_info,
 {
 	_connector = connector;
 	_sent_ready = false;
+
+	auto ovt_config = application->GetPublisher<cfg::OvtPublisher>();
+	if(ovt_config != nullptr)
+	{
+		_late_frame_deadline_msec = ovt_config->GetLateFrameDeadline();
+	}
 }
 
 OvtSession::~OvtSession()
 {
 	Stop();
+
+	auto connection = _shared_memory_connection.exchange(-1);
+	if(connection != -1)
+	{
+		// The edge regards it as the end of the session
+		::close(connection);
+	}
+
 	logtd("OvtSession(%d) has been terminated finally", GetId());
 }
 
@@ -42,11 +61,17 @@ bool OvtSession::Start()
 
 bool OvtSession::Stop()
 {
+	if(_skipped_frame_count > 0)
+	{
+		logti("OvtSession(%u) - %llu late frames were skipped", GetId(), static_cast<unsigned long long>(_skipped_frame_count));
+		_skipped_frame_count = 0;
+	}
+
 	logtd("OvtSession(%d) has stopped", GetId());
 	return Session::Stop();
 }
 
-bool OvtSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet)
+bool OvtSession::IsReadyToSend(uint32_t packet_type)
 {
 	// packet_type in OvtSession means marker of OVT Packet
 	// OvtSession should send full packet so it will start to send from next packet of marker packet.
@@ -60,21 +85,409 @@ bool OvtSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov
 		return false;
 	}
 
+	return true;
+}
+
+bool OvtSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet)
+{
+	if(IsSharedMemoryEnabled())
+	{
+		// The edge reads the frames from the ring
+		return false;
+	}
+
+	if(IsDatagramEnabled())
+	{
+		std::lock_guard<std::mutex> lock_guard(_datagram_mutex);
+
+		// The first packet is sent after the edge is ready to receive
+		if(_datagram_socket == nullptr)
+		{
+			return false;
+		}
+	}
+
+	if(IsReadyToSend(packet_type) == false)
+	{
+		return false;
+	}
+
 	// Set OVT Session ID into packet
 	// It is also possible to use OvtPacket::Load, but for performance, as follows.
-	auto buffer = packet->GetWritableDataAs<uint8_t>();
+	// The packet is shared by all sessions, so the session id is written into a copy of it
+	auto session_packet = packet->Clone();
+	auto buffer = session_packet->GetWritableDataAs<uint8_t>();
 	ByteWriter<uint32_t>::WriteBigEndian(&buffer[12], GetId());
 
-	_connector->Send(packet->GetData(), packet->GetLength());
+	if(IsDatagramEnabled())
+	{
+		return SendDatagram(session_packet);
+	}
+
+	if(_late_frame_deadline_msec > 0)
+	{
+		auto client_socket = std::dynamic_pointer_cast<ov::ClientSocket>(_connector);
+
+		if((client_socket != nullptr) && (client_socket->GetType() == ov::SocketType::Tcp))
+		{
+			return SendScheduledPacket(client_socket, packet_type, session_packet, nullptr);
+		}
+	}
+
+	_connector->Send(session_packet->GetData(), session_packet->GetLength());
 
 	return true;
 }
 
+bool OvtSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+{
+	if(IsSharedMemoryEnabled())
+	{
+		return false;
+	}
+
+	auto client_socket = std::dynamic_pointer_cast<ov::ClientSocket>(_connector);
+
+	if((client_socket == nullptr) || (client_socket->GetType() != ov::SocketType::Tcp) || IsDatagramEnabled())
+	{
+		// Each send() of the datagram-oriented sockets (SRT/UDP) is a message, so the packet is sent at once
+		return pub::Session::SendOutgoingData(packet_type, header, payload);
+	}
+
+	if(IsReadyToSend(packet_type) == false)
+	{
+		return false;
+	}
+
+	// Only the header is copied to set the session id, and the payload (the slice of the frame) is sent as it is
+	auto session_header = header->Clone();
+	auto buffer = session_header->GetWritableDataAs<uint8_t>();
+	ByteWriter<uint32_t>::WriteBigEndian(&buffer[12], GetId());
+
+	if(_late_frame_deadline_msec > 0)
+	{
+		return SendScheduledPacket(client_socket, packet_type, session_header, payload);
+	}
+
+	client_socket->Send(ov::DataChain{session_header, payload});
+
+	return true;
+}
+
+bool OvtSession::SendScheduledPacket(const std::shared_ptr<ov::ClientSocket> &client_socket, bool marker,
+									 const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+{
+	// The packets of a frame are sent contiguously (the edge depacketizes the frames in the order of the packets),
+	// so the frames are reordered, not the packets
+	if(_frame_state == FrameState::None)
+	{
+		BeginFrame(client_socket, header);
+	}
+
+	switch(_frame_state)
+	{
+		case FrameState::PassThrough:
+			if(payload != nullptr)
+			{
+				client_socket->Send(ov::DataChain{header, payload});
+			}
+			else
+			{
+				client_socket->Send(header);
+			}
+			break;
+
+		case FrameState::Queued:
+			_current_frame->slices.push_back(header);
+			_current_frame->size += header->GetLength();
+
+			if(payload != nullptr)
+			{
+				_current_frame->slices.push_back(payload);
+				_current_frame->size += payload->GetLength();
+			}
+			break;
+
+		case FrameState::None:
+		case FrameState::Dropped:
+			break;
+	}
+
+	if(marker)
+	{
+		if(_frame_state == FrameState::Queued)
+		{
+			EnqueueFrame(_current_frame);
+			_current_frame.reset();
+		}
+
+		_frame_state = FrameState::None;
+	}
+
+	// The held frames are sent when the next packet is produced (audio is produced every few tens of milliseconds)
+	if(IsFrameQueueEmpty() == false)
+	{
+		DrainFrames(client_socket);
+	}
+
+	return true;
+}
+
+void OvtSession::BeginFrame(const std::shared_ptr<ov::ClientSocket> &client_socket, const std::shared_ptr<const ov::Data> &header)
+{
+	auto frame = std::make_shared<QueuedFrame>();
+
+	// The first packet of a frame has the MediaPacket header after the OVT header (See OvtPacketizer::Packetize())
+	if(header->GetLength() >= (OVT_FIXED_HEADER_SIZE + MEDIA_PACKET_HEADER_SIZE))
+	{
+		auto media_header = header->GetDataAs<uint8_t>() + OVT_FIXED_HEADER_SIZE;
+		auto media_type = static_cast<common::MediaType>(media_header[28]);
+		auto media_flag = static_cast<MediaPacketFlag>(media_header[29]);
+
+		frame->track_id = ByteReader<uint32_t>::ReadBigEndian(&media_header[0]);
+
+		if(media_type == common::MediaType::Video)
+		{
+			frame->priority = (media_flag == MediaPacketFlag::Key) ? FramePriority::Medium : FramePriority::Low;
+		}
+	}
+
+	if(frame->priority == FramePriority::Medium)
+	{
+		_tracks_waiting_for_key_frame.erase(frame->track_id);
+	}
+	else if((frame->priority == FramePriority::Low) && (_tracks_waiting_for_key_frame.find(frame->track_id) != _tracks_waiting_for_key_frame.end()))
+	{
+		// The delta frame cannot be decoded without the skipped ones, so the edge resumes the track from the next key frame
+		_frame_state = FrameState::Dropped;
+		_skipped_frame_count++;
+		return;
+	}
+
+	if(IsFrameQueueEmpty() && (client_socket->GetSendQueueSize() < OVT_SESSION_SEND_QUEUE_THRESHOLD))
+	{
+		_frame_state = FrameState::PassThrough;
+		return;
+	}
+
+	frame->queued_time = std::chrono::steady_clock::now();
+
+	_current_frame = frame;
+	_frame_state = FrameState::Queued;
+}
+
+void OvtSession::EnqueueFrame(const std::shared_ptr<QueuedFrame> &frame)
+{
+	if(frame->priority == FramePriority::Medium)
+	{
+		// The key frame is sent before the delta frames, so the older delta frames of the track are no longer needed (and must not follow it)
+		for(auto &queue : {&_frame_queues[static_cast<size_t>(FramePriority::Medium)], &_frame_queues[static_cast<size_t>(FramePriority::Low)]})
+		{
+			for(auto it = queue->begin(); it != queue->end();)
+			{
+				if((*it)->track_id == frame->track_id)
+				{
+					_queued_bytes -= (*it)->size;
+					_skipped_frame_count++;
+					it = queue->erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+	}
+
+	_frame_queues[static_cast<size_t>(frame->priority)].push_back(frame);
+	_queued_bytes += frame->size;
+
+	if(_queued_bytes > OVT_SESSION_MAX_QUEUED_BYTES)
+	{
+		// The connection cannot keep up with the stream even if the late frames are skipped
+		logtw("OvtSession(%u) - The connection is congested (%zu bytes are held), the video frames are skipped until the next key frames", GetId(), _queued_bytes);
+
+		for(auto priority : {FramePriority::Medium, FramePriority::Low})
+		{
+			auto &queue = _frame_queues[static_cast<size_t>(priority)];
+
+			for(auto &queued_frame : queue)
+			{
+				_queued_bytes -= queued_frame->size;
+				_skipped_frame_count++;
+				_tracks_waiting_for_key_frame.insert(queued_frame->track_id);
+			}
+
+			queue.clear();
+		}
+	}
+}
+
+void OvtSession::DropDeltaFrames(uint32_t track_id)
+{
+	auto &queue = _frame_queues[static_cast<size_t>(FramePriority::Low)];
+
+	for(auto it = queue.begin(); it != queue.end();)
+	{
+		if((*it)->track_id == track_id)
+		{
+			_queued_bytes -= (*it)->size;
+			_skipped_frame_count++;
+			it = queue.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	_tracks_waiting_for_key_frame.insert(track_id);
+}
+
+void OvtSession::DrainFrames(const std::shared_ptr<ov::ClientSocket> &client_socket)
+{
+	auto &delta_queue = _frame_queues[static_cast<size_t>(FramePriority::Low)];
+	auto deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(_late_frame_deadline_msec);
+
+	// The delta frames are queued in the order they are produced, so the oldest one is at the front
+	while((delta_queue.empty() == false) && (delta_queue.front()->queued_time < deadline))
+	{
+		auto track_id = delta_queue.front()->track_id;
+
+		logtd("OvtSession(%u) - The delta frames of the track %u are late, they are skipped until the next key frame", GetId(), track_id);
+
+		DropDeltaFrames(track_id);
+	}
+
+	while(client_socket->GetSendQueueSize() < OVT_SESSION_SEND_QUEUE_THRESHOLD)
+	{
+		std::shared_ptr<QueuedFrame> frame;
+
+		for(auto &queue : _frame_queues)
+		{
+			if(queue.empty() == false)
+			{
+				frame = std::move(queue.front());
+				queue.pop_front();
+				break;
+			}
+		}
+
+		if(frame == nullptr)
+		{
+			break;
+		}
+
+		_queued_bytes -= frame->size;
+
+		if(client_socket->Send(ov::DataChain(std::move(frame->slices))) < 0)
+		{
+			break;
+		}
+	}
+}
+
 const std::shared_ptr<ov::Socket> OvtSession::GetConnector()
 {
 	return _connector;
 }
 
+void OvtSession::EnableDatagram(uint32_t token)
+{
+	_datagram_token = token;
+}
+
+void OvtSession::EnableSharedMemory(uint32_t token)
+{
+	_shared_memory_token = token;
+}
+
+bool OvtSession::AttachSharedMemory(int connection)
+{
+	int expected = -1;
+
+	// The token is used once
+	return _shared_memory_connection.compare_exchange_strong(expected, connection);
+}
+
+void OvtSession::NotifySharedMemory()
+{
+	auto connection = _shared_memory_connection.load();
+
+	if(connection != -1)
+	{
+		OvtSharedMemoryServer::Notify(connection);
+	}
+}
+
+bool OvtSession::BindDatagram(const std::shared_ptr<ov::Socket> &socket, const ov::SocketAddress &address)
+{
+	auto remote_address = _connector->GetRemoteAddress();
+
+	// Only the edge that has requested PLAY can receive the packets
+	if((remote_address == nullptr) || (remote_address->GetIpAddress() != address.GetIpAddress()))
+	{
+		logtw("OvtSession(%u) - The datagram is not from the edge : %s (expected: %s)",
+			  GetId(), address.ToString().CStr(), (remote_address != nullptr) ? remote_address->ToString().CStr() : "N/A");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock_guard(_datagram_mutex);
+
+	if(_datagram_socket == nullptr)
+	{
+		logti("OvtSession(%u) - The media packets are sent to %s over UDP", GetId(), address.ToString().CStr());
+	}
+
+	// The address may be changed by the NAT, the latest one is used
+	_datagram_socket = socket;
+	_datagram_address = address;
+
+	return true;
+}
+
+bool OvtSession::IsBoundTo(const ov::SocketAddress &address)
+{
+	std::lock_guard<std::mutex> lock_guard(_datagram_mutex);
+
+	return (_datagram_socket != nullptr) && (_datagram_address == address);
+}
+
+bool OvtSession::Retransmit(const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload)
+{
+	auto session_packet = header->Clone();
+
+	if(payload != nullptr)
+	{
+		session_packet->Append(payload);
+	}
+
+	auto buffer = session_packet->GetWritableDataAs<uint8_t>();
+	ByteWriter<uint32_t>::WriteBigEndian(&buffer[12], GetId());
+
+	return SendDatagram(session_packet);
+}
+
+bool OvtSession::SendDatagram(const std::shared_ptr<ov::Data> &packet)
+{
+	std::shared_ptr<ov::Socket> socket;
+	ov::SocketAddress address;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_datagram_mutex);
+
+		socket = _datagram_socket;
+		address = _datagram_address;
+	}
+
+	if(socket == nullptr)
+	{
+		return false;
+	}
+
+	return socket->SendTo(address, packet) == static_cast<ssize_t>(packet->GetLength());
+}
+
 void OvtSession::OnPacketReceived(const std::shared_ptr<info::Session> &session_info,
 									const std::shared_ptr<const ov::Data> &data)
 {
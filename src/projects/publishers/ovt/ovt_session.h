@@ -1,9 +1,18 @@
 #pragma once
 
 #include <base/info/media_track.h>
-#include <base/ovsocket/socket.h>
+#include <base/ovsocket/ovsocket.h>
 #include <base/publisher/session.h>
 
+#include <array>
+#include <deque>
+#include <unordered_set>
+
+// While the send queue of the connection has more than this, the frames are held by the session, so they can be sent in the order of the priority
+#define OVT_SESSION_SEND_QUEUE_THRESHOLD (64 * 1024)
+// If the frames held by the session exceed this, the video frames are skipped until the next key frames
+#define OVT_SESSION_MAX_QUEUED_BYTES (4 * 1024 * 1024)
+
 class OvtSession : public pub::Session
 {
 public:
@@ -21,14 +30,126 @@ public:
 	bool Start() override;
 	bool Stop() override;
 
-	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet) override;
+	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet) override;
+	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload) override;
 	void OnPacketReceived(const std::shared_ptr<info::Session> &session_info,
 						const std::shared_ptr<const ov::Data> &data) override;
 
 
 	const std::shared_ptr<ov::Socket> GetConnector();
 
+	// In the datagram mode, the packets are sent over UDP to the address that the edge bound with the token
+	// (See OVT_PAYLOAD_TYPE_DATAGRAM_BIND), and they are not sent until it is bound
+	void EnableDatagram(uint32_t token);
+	bool IsDatagramEnabled() const
+	{
+		return _datagram_token != 0;
+	}
+	uint32_t GetDatagramToken() const
+	{
+		return _datagram_token;
+	}
+	// Returns false if the address is not from the IP address of the connector
+	bool BindDatagram(const std::shared_ptr<ov::Socket> &socket, const ov::SocketAddress &address);
+	bool IsBoundTo(const ov::SocketAddress &address);
+	// Sends the packet that the edge has lost again (regardless of IsReadyToSend())
+	bool Retransmit(const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
+
+	// In the shared memory mode, the frames are read by the edge from the ring of the stream (See OvtSharedMemoryRing),
+	// and nothing is sent over the connection
+	void EnableSharedMemory(uint32_t token);
+	bool IsSharedMemoryEnabled() const
+	{
+		return _shared_memory_token != 0;
+	}
+	// The session owns the connection of the edge, and the edge is notified through it (it is closed when the session is ended)
+	bool AttachSharedMemory(int connection);
+	void NotifySharedMemory();
+
+	// The first packet that the session will receive is the first packet of a frame (the GOP cache),
+	// so it doesn't have to wait for the marker packet
+	void SetReadyToSend()
+	{
+		_sent_ready = true;
+	}
+
 private:
+	// The frames held while the connection is congested (See <Publishers><OVT><LateFrameDeadline>)
+	enum class FramePriority : uint8_t
+	{
+		// Audio (and the other tracks), never skipped
+		High = 0,
+		// Video key frame
+		Medium,
+		// Video delta frame, skipped if it is late
+		Low,
+
+		Count
+	};
+
+	struct QueuedFrame
+	{
+		uint32_t track_id = 0;
+		FramePriority priority = FramePriority::High;
+		std::chrono::steady_clock::time_point queued_time;
+
+		// The headers (with the session ID) and the payloads of the packets of the frame
+		std::vector<std::shared_ptr<const ov::Data>> slices;
+		size_t size = 0;
+	};
+
+	// What is done with the packets of the current frame
+	enum class FrameState : uint8_t
+	{
+		// Waiting for the first packet of a frame
+		None,
+		// Sent as they are received
+		PassThrough,
+		// Held in _current_frame
+		Queued,
+		// Skipped (a delta frame of the track that waits for a key frame)
+		Dropped
+	};
+
+	// Sends the packet over the connection by the priority of the frame
+	bool SendScheduledPacket(const std::shared_ptr<ov::ClientSocket> &client_socket, bool marker,
+							 const std::shared_ptr<const ov::Data> &header, const std::shared_ptr<const ov::Data> &payload);
+	// Decides what to do with the frame by the MediaPacket header of the first packet
+	void BeginFrame(const std::shared_ptr<ov::ClientSocket> &client_socket, const std::shared_ptr<const ov::Data> &header);
+	void EnqueueFrame(const std::shared_ptr<QueuedFrame> &frame);
+	// Sends the held frames while the send queue of the connection is below OVT_SESSION_SEND_QUEUE_THRESHOLD
+	void DrainFrames(const std::shared_ptr<ov::ClientSocket> &client_socket);
+	// Drops the held delta frames of the track, and the next delta frames of it are skipped until a key frame
+	void DropDeltaFrames(uint32_t track_id);
+	bool IsFrameQueueEmpty() const
+	{
+		return _queued_bytes == 0;
+	}
+
+	bool SendDatagram(const std::shared_ptr<ov::Data> &packet);
+
+	// Returns false if the packets before the first marker packet must be dropped
+	bool IsReadyToSend(uint32_t packet_type);
+
 	std::shared_ptr<ov::Socket>		_connector;
 	bool 							_sent_ready;
+
+	uint32_t						_datagram_token = 0;
+	std::mutex						_datagram_mutex;
+	std::shared_ptr<ov::Socket>		_datagram_socket;
+	ov::SocketAddress				_datagram_address;
+
+	uint32_t						_shared_memory_token = 0;
+	std::atomic<int>				_shared_memory_connection{-1};
+
+	// Used by the worker of the session only
+	// 0: The frames are sent in the order they are produced
+	int								_late_frame_deadline_msec = 0;
+	FrameState						_frame_state = FrameState::None;
+	std::shared_ptr<QueuedFrame>	_current_frame;
+	std::array<std::deque<std::shared_ptr<QueuedFrame>>, static_cast<size_t>(FramePriority::Count)> _frame_queues;
+	size_t							_queued_bytes = 0;
+	// The video tracks of which the delta frames are skipped until a key frame
+	std::unordered_set<uint32_t>	_tracks_waiting_for_key_frame;
+	uint64_t						_skipped_frame_count = 0;
 };
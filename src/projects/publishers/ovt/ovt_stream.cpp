@@ -32,81 +32,22 @@ OvtStream::~OvtStream()
 bool OvtStream::Start(uint32_t worker_count)
 {
 	logtd("OvtStream(%d) has been started", GetId());
-	_packetizer = std::make_shared<OvtPacketizer>(OvtPacketizerInterface::GetSharedPtr());
-
-	/*
-	"stream" :
-	{
-		"appName" : "app",
-		"streamName" : "stream_720p",
-		"tracks":
-		[
-			{
-				"id" : 3291291,
-				"codecId" : 32198392,
-				"mediaType" : 0 | 1 | 2, # video | audio | data
-				"timebase_num" : 90000,
-				"timebase_den" : 90000,
-				"bitrate" : 5000000,
-				"startFrameTime" : 1293219321,
-				"lastFrameTime" : 1932193921,
-				"videoTrack" :
-				{
-					"framerate" : 29.97,
-					"width" : 1280,
-					"height" : 720
-				},
-				"audioTrack" :
-				{
-					"samplerate" : 44100,
-					"sampleFormat" : "s16",
-					"layout" : "stereo"
-				}
-			}
-		]
-	}
-*/
-
-	Json::Value 	json_root;
-	Json::Value		json_tracks;
-
-	json_root["appName"] = GetApplication()->GetName().CStr();
-	json_root["streamName"] = GetName().CStr();
-
-	for(auto &track_item : _tracks)
-	{
-		auto &track = track_item.second;
-
-		Json::Value json_track;
-		Json::Value json_video_track;
-		Json::Value json_audio_track;
-
-		json_track["id"] = track->GetId();
-		json_track["codecId"] = static_cast<int8_t>(track->GetCodecId());
-		json_track["mediaType"] = static_cast<int8_t>(track->GetMediaType());
-		json_track["timebase_num"] = track->GetTimeBase().GetNum();
-		json_track["timebase_den"] = track->GetTimeBase().GetDen();
-		json_track["bitrate"] = track->GetBitrate();
-		json_track["startFrameTime"] = track->GetStartFrameTime();
-		json_track["lastFrameTime"] = track->GetLastFrameTime();
-
-		json_video_track["framerate"] = track->GetFrameRate();
-		json_video_track["width"] = track->GetWidth();
-		json_video_track["height"] = track->GetHeight();
-
-		json_audio_track["samplerate"] = track->GetSampleRate();
-		json_audio_track["sampleFormat"] = static_cast<int8_t>(track->GetSample().GetFormat());
-		json_audio_track["layout"] = static_cast<uint32_t>(track->GetChannel().GetLayout());
-
-		json_track["videoTrack"] = json_video_track;
-		json_track["audioTrack"] = json_audio_track;
-
-		json_tracks.append(json_track);
-	}
-
-	json_root["tracks"] = json_tracks;
-
-	_description = json_root;
+	auto ovt_config = GetApplication()->GetPublisher<cfg::OvtPublisher>();
+	size_t max_packet_size = (ovt_config != nullptr) ? ovt_config->GetMaxPacketSize() : OVT_DEFAULT_MAX_PACKET_SIZE;
+
+	_packetizer = std::make_shared<OvtPacketizer>(OvtPacketizerInterface::GetSharedPtr(), max_packet_size);
+
+	// The description is the same for all edges, so it is serialized once in each format
+	_json_description = OvtControlMessage::SerializeStreamDescription(OvtControlMessage::Format::Json, GetApplication()->GetName(), GetName(), _tracks);
+	_binary_description = OvtControlMessage::SerializeStreamDescription(OvtControlMessage::Format::Binary, GetApplication()->GetName(), GetName(), _tracks);
+
+	if((_json_description == nullptr) || (_binary_description == nullptr))
+	{
+		logte("Could not serialize the description of the stream (%s/%s)", GetApplication()->GetName().CStr(), GetName().CStr());
+		return false;
+	}
+
+	_stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(pub::Stream::GetSharedPtr()));
 
 	return Stream::Start(worker_count);
 }
@@ -121,12 +62,21 @@ bool OvtStream::Stop()
 		_packetizer.reset();
 		_packetizer = nullptr;
 	}
+	mlock.unlock();
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_shared_memory_mutex);
+		_shared_memory_ring.reset();
+		_shared_memory_sessions.clear();
+	}
 
 	return Stream::Stop();
 }
 
 void OvtStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 {
+	WriteSharedMemory(media_packet);
+
 	// Callback OnOvtPacketized()
 	std::unique_lock<std::mutex> mlock(_packetizer_lock);
 	if(_packetizer != nullptr)
@@ -137,6 +87,8 @@ void OvtStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 
 void OvtStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
 {
+	WriteSharedMemory(media_packet);
+
 	// Callback OnOvtPacketized()
 	std::unique_lock<std::mutex> mlock(_packetizer_lock);
 	if(_packetizer != nullptr)
@@ -145,16 +97,199 @@ void OvtStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
 	}
 }
 
+std::shared_ptr<OvtSharedMemoryRing> OvtStream::EnableSharedMemory()
+{
+	std::lock_guard<std::mutex> lock_guard(_shared_memory_mutex);
+
+	if(_shared_memory_ring == nullptr)
+	{
+		ov::String name;
+		name.Format("ovt-%s-%s", GetApplication()->GetName().CStr(), GetName().CStr());
+
+		_shared_memory_ring = OvtSharedMemoryRing::Create(name);
+
+		if(_shared_memory_ring == nullptr)
+		{
+			logte("OvtStream(%s/%s) - Could not create the shared memory, the edges will receive the packets over the connection",
+				  GetApplication()->GetName().CStr(), GetName().CStr());
+		}
+	}
+
+	return _shared_memory_ring;
+}
+
+std::shared_ptr<OvtSharedMemoryRing> OvtStream::GetSharedMemoryRing()
+{
+	std::lock_guard<std::mutex> lock_guard(_shared_memory_mutex);
+
+	return _shared_memory_ring;
+}
+
+void OvtStream::AddSharedMemorySession(const std::shared_ptr<OvtSession> &session)
+{
+	std::lock_guard<std::mutex> lock_guard(_shared_memory_mutex);
+
+	_shared_memory_sessions.push_back(session);
+}
+
+void OvtStream::WriteSharedMemory(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	std::lock_guard<std::mutex> lock_guard(_shared_memory_mutex);
+
+	if(_shared_memory_ring == nullptr)
+	{
+		return;
+	}
+
+	// The frame is written once for all the edges on the same host
+	if(_shared_memory_ring->Write(media_packet) == false)
+	{
+		return;
+	}
+
+	for(auto it = _shared_memory_sessions.begin(); it != _shared_memory_sessions.end();)
+	{
+		auto session = it->lock();
+
+		if(session == nullptr)
+		{
+			// The session has been stopped
+			it = _shared_memory_sessions.erase(it);
+			continue;
+		}
+
+		session->NotifySharedMemory();
+		++it;
+	}
+
+	if(_stream_metrics != nullptr)
+	{
+		_stream_metrics->IncreaseBytesOut(PublisherType::Ovt, media_packet->GetData()->GetLength() * _shared_memory_sessions.size());
+	}
+}
+
 bool OvtStream::OnOvtPacketized(std::shared_ptr<OvtPacket> &packet)
 {
+	if(_is_retransmit_enabled)
+	{
+		_retransmit_history.Add(packet->SequenceNumber(), packet->GetData(), packet->GetPayloadData());
+	}
+
 	// Broadcasting
-	BroadcastPacket(packet->Marker(), packet->GetData());
+	if(packet->GetPayloadData() != nullptr)
+	{
+		// The payload is not copied (See OvtPacketizer::Packetize())
+		BroadcastPacket(packet->Marker(), packet->GetData(), packet->GetPayloadData());
+	}
+	else
+	{
+		BroadcastPacket(packet->Marker(), packet->GetData());
+	}
+
+	if(_stream_metrics != nullptr)
+	{
+		auto packet_size = packet->GetData()->GetLength() + ((packet->GetPayloadData() != nullptr) ? packet->GetPayloadData()->GetLength() : 0);
+		_stream_metrics->IncreaseBytesOut(PublisherType::Ovt, packet_size * GetSessionCount());
+	}
+
 	return true;
 }
 
-Json::Value& OvtStream::GetDescription()
+// Collects the packets of the GOP cache for a new session instead of broadcasting them
+class OvtGopCachePacketizer : public OvtPacketizerInterface
 {
-	return _description;
+public:
+	explicit OvtGopCachePacketizer(std::vector<std::shared_ptr<pub::StreamPacket>> *packets)
+		: _packets(packets)
+	{
+	}
+
+	bool OnOvtPacketized(std::shared_ptr<OvtPacket> &packet) override
+	{
+		_packets->push_back(std::make_shared<pub::StreamPacket>(packet->Marker(), packet->GetData(), packet->GetPayloadData()));
+		return true;
+	}
+
+private:
+	std::vector<std::shared_ptr<pub::StreamPacket>> *_packets;
+};
+
+bool OvtStream::PacketizeGopCache(const std::shared_ptr<pub::Session> &session, const std::vector<std::shared_ptr<MediaPacket>> &media_packets, std::vector<std::shared_ptr<pub::StreamPacket>> *packets)
+{
+	auto ovt_session = std::static_pointer_cast<OvtSession>(session);
+
+	if(ovt_session->IsSharedMemoryEnabled())
+	{
+		// The edge starts from the latest key frame in the ring
+		return false;
+	}
+
+	if(ovt_session->IsDatagramEnabled())
+	{
+		// The edge reorders the datagrams with the sequence numbers of the stream, so the packets of another sequence cannot be inserted
+		return false;
+	}
+
+	auto ovt_config = GetApplication()->GetPublisher<cfg::OvtPublisher>();
+	size_t max_packet_size = (ovt_config != nullptr) ? ovt_config->GetMaxPacketSize() : OVT_DEFAULT_MAX_PACKET_SIZE;
+
+	// The edge doesn't check the sequence numbers of the packets received over the connection, so a separate packetizer is used
+	auto collector = std::make_shared<OvtGopCachePacketizer>(packets);
+	OvtPacketizer packetizer(collector, max_packet_size);
+
+	for(const auto &media_packet : media_packets)
+	{
+		packetizer.Packetize(media_packet->GetPts(), media_packet);
+	}
+
+	if(packets->empty())
+	{
+		return false;
+	}
+
+	ovt_session->SetReadyToSend();
+
+	logtd("OvtStream(%s/%s) - The session %u is primed with %zu frames (%zu packets)",
+		  GetApplication()->GetName().CStr(), GetName().CStr(), session->GetId(), media_packets.size(), packets->size());
+
+	return true;
+}
+
+const std::shared_ptr<const ov::Data> &OvtStream::GetDescription(OvtControlMessage::Format format) const
+{
+	return (format == OvtControlMessage::Format::Binary) ? _binary_description : _json_description;
+}
+
+void OvtStream::EnableRetransmit()
+{
+	_is_retransmit_enabled = true;
+}
+
+void OvtStream::Retransmit(const std::shared_ptr<OvtSession> &session, const std::vector<uint16_t> &sequence_numbers)
+{
+	std::shared_ptr<const ov::Data> header;
+	std::shared_ptr<const ov::Data> payload;
+	size_t retransmitted_bytes = 0;
+
+	for(auto sequence_number : sequence_numbers)
+	{
+		if(_retransmit_history.Find(sequence_number, &header, &payload) == false)
+		{
+			// Expired, the edge will give up the packet
+			logtd("OvtStream(%s/%s) - The packet %u is not in the history", GetApplication()->GetName().CStr(), GetName().CStr(), sequence_number);
+			continue;
+		}
+
+		if(session->Retransmit(header, payload))
+		{
+			retransmitted_bytes += header->GetLength() + ((payload != nullptr) ? payload->GetLength() : 0);
+		}
+	}
+
+	if(_stream_metrics != nullptr)
+	{
+		_stream_metrics->IncreaseBytesOut(PublisherType::Ovt, retransmitted_bytes);
+	}
 }
 
 bool OvtStream::RemoveSessionByConnectorId(int connector_id)
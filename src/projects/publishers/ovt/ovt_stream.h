@@ -2,7 +2,13 @@
 
 #include <base/common_types.h>
 #include <base/publisher/stream.h>
+#include <modules/ovt_packetizer/ovt_control_message.h>
+#include <modules/ovt_packetizer/ovt_datagram.h>
 #include <modules/ovt_packetizer/ovt_packetizer.h>
+#include <modules/ovt_packetizer/ovt_shared_memory.h>
+#include <monitoring/monitoring.h>
+
+class OvtSession;
 
 class OvtStream : public pub::Stream, public OvtPacketizerInterface
 {
@@ -21,13 +27,40 @@ public:
 
 	bool RemoveSessionByConnectorId(int connector_id);
 
-	Json::Value&		GetDescription();
+	// The sent packets are kept to be retransmitted after an edge of the datagram mode has played the stream
+	void EnableRetransmit();
+	// Sends the packets that the edge has lost again (NACK)
+	void Retransmit(const std::shared_ptr<OvtSession> &session, const std::vector<uint16_t> &sequence_numbers);
+
+	// Creates the ring of the stream when the first edge of the shared memory mode plays it (nullptr if it cannot be created)
+	std::shared_ptr<OvtSharedMemoryRing> EnableSharedMemory();
+	std::shared_ptr<OvtSharedMemoryRing> GetSharedMemoryRing();
+	// The session is notified whenever a frame is written to the ring
+	void AddSharedMemorySession(const std::shared_ptr<OvtSession> &session);
+
+	// The serialized "stream" of the describe response
+	const std::shared_ptr<const ov::Data> &GetDescription(OvtControlMessage::Format format) const;
 
 private:
 	bool Start(uint32_t worker_count) override;
 	bool Stop() override;
 
-	Json::Value							_description;
+	void WriteSharedMemory(const std::shared_ptr<MediaPacket> &media_packet);
+
+	bool PacketizeGopCache(const std::shared_ptr<pub::Session> &session, const std::vector<std::shared_ptr<MediaPacket>> &media_packets, std::vector<std::shared_ptr<pub::StreamPacket>> *packets) override;
+
+	std::shared_ptr<const ov::Data>		_json_description;
+	std::shared_ptr<const ov::Data>		_binary_description;
 	std::mutex 							_packetizer_lock;
 	std::shared_ptr<OvtPacketizer>		_packetizer;
+
+	std::atomic<bool>					_is_retransmit_enabled{false};
+	OvtRetransmitHistory				_retransmit_history;
+
+	std::mutex							_shared_memory_mutex;
+	std::shared_ptr<OvtSharedMemoryRing>	_shared_memory_ring;
+	std::vector<std::weak_ptr<OvtSession>>	_shared_memory_sessions;
+
+	// The bytes sent to the edges are counted, so the stream that is relayed by this server (as a mid-tier edge) is not regarded as unused
+	std::shared_ptr<mon::StreamMetrics>	_stream_metrics;
 };
@@ -9,5 +9,7 @@
 #pragma once
 
 #include "./ovt/ovt_publisher.h"
+#include "./record/record_publisher.h"
+#include "./rtmp/rtmp_publisher.h"
 #include "./segment/publishers.h"
 #include "./webrtc/webrtc_publisher.h"
\ No newline at end of file
@@ -0,0 +1,9 @@
+LOCAL_PATH := $(call get_local_path)
+include $(DEFAULT_VARIABLES)
+
+LOCAL_STATIC_LIBRARIES := \
+	segment_stream
+
+LOCAL_TARGET := record_publisher
+
+include $(BUILD_STATIC_LIBRARY)
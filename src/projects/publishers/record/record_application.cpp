@@ -0,0 +1,84 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "record_application.h"
+
+#include "record_publisher_private.h"
+#include "record_stream.h"
+
+std::shared_ptr<RecordApplication> RecordApplication::Create(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
+{
+	auto application = std::make_shared<RecordApplication>(publisher, application_info);
+	application->Start();
+	return application;
+}
+
+RecordApplication::RecordApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
+	: Application(publisher, application_info)
+{
+	SetDirectDispatch(true);
+}
+
+RecordApplication::~RecordApplication()
+{
+	Stop();
+	logtd("RecordApplication(%d) has been terminated finally", GetId());
+}
+
+bool RecordApplication::Start()
+{
+	auto record_config = GetPublisher<cfg::RecordPublisher>();
+
+	if (record_config != nullptr)
+	{
+		_writer = std::make_shared<RecordWriter>(ov::String::FormatString("%s - Record writer queue", GetName().CStr()), record_config->GetMaxPendingBytes());
+		_writer->Start();
+	}
+
+	return Application::Start();
+}
+
+bool RecordApplication::Stop()
+{
+	auto result = Application::Stop();
+
+	// The streams are stopped, so the fragments of them are written before the writer is stopped
+	if (_writer != nullptr)
+	{
+		_writer->Stop();
+	}
+
+	return result;
+}
+
+std::shared_ptr<pub::Stream> RecordApplication::CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count)
+{
+	logtd("RecordApplication::CreateStream : %s/%u", info->GetName().CStr(), info->GetId());
+
+	if (_writer == nullptr)
+	{
+		return nullptr;
+	}
+
+	return RecordStream::Create(GetSharedPtrAs<pub::Application>(), *info, worker_count, _writer);
+}
+
+bool RecordApplication::DeleteStream(const std::shared_ptr<info::Stream> &info)
+{
+	logtd("RecordApplication::DeleteStream : %s/%u", info->GetName().CStr(), info->GetId());
+
+	auto stream = std::static_pointer_cast<RecordStream>(GetStream(info->GetId()));
+	if (stream == nullptr)
+	{
+		logte("RecordApplication::Delete stream failed. Cannot find stream (%s)", info->GetName().CStr());
+		return false;
+	}
+
+	logtd("RecordApplication %s/%s stream has been deleted", GetName().CStr(), stream->GetName().CStr());
+
+	return true;
+}
@@ -0,0 +1,33 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/publisher/application.h>
+
+#include "record_stream.h"
+#include "record_writer.h"
+
+class RecordApplication : public pub::Application
+{
+public:
+	static std::shared_ptr<RecordApplication> Create(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info);
+	RecordApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info);
+	~RecordApplication() final;
+
+private:
+	bool Start() override;
+	bool Stop() override;
+
+	// Application Implementation
+	std::shared_ptr<pub::Stream> CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count) override;
+	bool DeleteStream(const std::shared_ptr<info::Stream> &info) override;
+
+	// The files of the streams of the application are written by this
+	std::shared_ptr<RecordWriter> _writer;
+};
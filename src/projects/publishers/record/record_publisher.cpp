@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "record_publisher.h"
+
+#include "record_publisher_private.h"
+
+std::shared_ptr<RecordPublisher> RecordPublisher::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+{
+	auto record = std::make_shared<RecordPublisher>(server_config, router);
+
+	if (!record->Start())
+	{
+		logte("An error occurred while creating RecordPublisher");
+		return nullptr;
+	}
+
+	return record;
+}
+
+RecordPublisher::RecordPublisher(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+	: Publisher(server_config, router)
+{
+}
+
+RecordPublisher::~RecordPublisher()
+{
+	logtd("RecordPublisher has been terminated finally");
+}
+
+bool RecordPublisher::Start()
+{
+	return Publisher::Start();
+}
+
+bool RecordPublisher::Stop()
+{
+	return Publisher::Stop();
+}
+
+std::shared_ptr<pub::Application> RecordPublisher::OnCreatePublisherApplication(const info::Application &application_info)
+{
+	return RecordApplication::Create(RecordPublisher::GetSharedPtrAs<pub::Publisher>(), application_info);
+}
+
+bool RecordPublisher::OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application)
+{
+	return true;
+}
+
+bool RecordPublisher::GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections)
+{
+	return true;
+}
@@ -0,0 +1,46 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/media_route/media_route_application_interface.h>
+#include <base/publisher/publisher.h>
+
+#include "record_application.h"
+
+// Records the streams of the applications that have <Publishers><Record> to fragmented MP4 files
+class RecordPublisher : public pub::Publisher
+{
+public:
+	static std::shared_ptr<RecordPublisher> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+
+	RecordPublisher(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+	~RecordPublisher() override;
+	bool Stop() override;
+
+private:
+	bool Start() override;
+
+	//--------------------------------------------------------------------
+	// Implementation of Publisher
+	//--------------------------------------------------------------------
+	PublisherType GetPublisherType() const override
+	{
+		return PublisherType::Record;
+	}
+	const char *GetPublisherName() const override
+	{
+		return "RecordPublisher";
+	}
+
+	std::shared_ptr<pub::Application> OnCreatePublisherApplication(const info::Application &application_info) override;
+	bool OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application) override;
+
+	bool GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections) override;
+	//--------------------------------------------------------------------
+};
@@ -0,0 +1,399 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "record_stream.h"
+
+#include <base/publisher/application.h>
+#include <media_router/bitstream/avc_video_packet_fragmentizer.h>
+#include <publishers/segment/segment_stream/packetizer/m4s_init_writer.h>
+#include <publishers/segment/segment_stream/packetizer/m4s_segment_writer.h>
+
+#include "record_publisher_private.h"
+
+// Sample flags of trun (See DashPacketizer::AppendVideoFrameInternal())
+#define RECORD_SAMPLE_FLAG_KEY_FRAME 0x02000000
+#define RECORD_SAMPLE_FLAG_INTER_FRAME 0x01010000
+
+std::shared_ptr<RecordStream> RecordStream::Create(const std::shared_ptr<pub::Application> application,
+												   const info::Stream &info,
+												   uint32_t worker_count,
+												   const std::shared_ptr<RecordWriter> &writer)
+{
+	auto stream = std::make_shared<RecordStream>(application, info, writer);
+	if (!stream->Start(worker_count))
+	{
+		return nullptr;
+	}
+	return stream;
+}
+
+RecordStream::RecordStream(const std::shared_ptr<pub::Application> application,
+						   const info::Stream &info,
+						   const std::shared_ptr<RecordWriter> &writer)
+	: Stream(application, info),
+	  _writer(writer)
+{
+}
+
+RecordStream::~RecordStream()
+{
+	logtd("RecordStream(%s/%s) has been terminated finally", GetApplication()->GetName().CStr(), GetName().CStr());
+}
+
+bool RecordStream::Start(uint32_t worker_count)
+{
+	auto record_config = GetApplication()->GetPublisher<cfg::RecordPublisher>();
+
+	if (record_config == nullptr)
+	{
+		return false;
+	}
+
+	for (auto &track_item : _tracks)
+	{
+		auto &track = track_item.second;
+
+		if ((_video.track == nullptr) && (track->GetCodecId() == common::MediaCodecId::H264))
+		{
+			InitializeTrack(_video, track, record_config->GetFileDuration(), record_config->GetFragmentDuration());
+		}
+		else if ((_audio.track == nullptr) && (track->GetCodecId() == common::MediaCodecId::Aac))
+		{
+			InitializeTrack(_audio, track, record_config->GetFileDuration(), record_config->GetFragmentDuration());
+		}
+	}
+
+	if ((_video.track == nullptr) && (_audio.track == nullptr))
+	{
+		logtw("RecordStream(%s/%s) has no H.264/AAC track, the stream will not be recorded", GetApplication()->GetName().CStr(), GetName().CStr());
+	}
+
+	// <FilePath>/<app>/<stream>
+	_directory = record_config->GetFilePath();
+
+	for (const auto &name : {GetApplication()->GetName(), GetName()})
+	{
+		_directory = ov::PathManager::Combine(_directory, name);
+
+		if (ov::PathManager::MakeDirectory(_directory.CStr()) == false)
+		{
+			logte("Could not create the record directory: %s (%s)", _directory.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			return false;
+		}
+	}
+
+	logtd("RecordStream(%u) has been started", GetId());
+
+	return Stream::Start(worker_count);
+}
+
+bool RecordStream::Stop()
+{
+	CloseFile(_video);
+	CloseFile(_audio);
+
+	logtd("RecordStream(%u) has been stopped", GetId());
+
+	return Stream::Stop();
+}
+
+bool RecordStream::IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track)
+{
+	return ((_video.track != nullptr) && (_video.track->GetId() == track->GetId())) ||
+		   ((_audio.track != nullptr) && (_audio.track->GetId() == track->GetId()));
+}
+
+void RecordStream::InitializeTrack(RecordTrack &record_track, const std::shared_ptr<MediaTrack> &track, int file_duration, int fragment_duration)
+{
+	bool is_video = (track->GetMediaType() == common::MediaType::Video);
+	auto timescale = track->GetTimeBase().GetTimescale();
+
+	record_track.track = track;
+	record_track.media_type = is_video ? M4sMediaType::Video : M4sMediaType::Audio;
+	record_track.track_id = is_video ? 1 : 2;
+	record_track.file_suffix = is_video ? "video" : "audio";
+	record_track.file_duration = static_cast<int64_t>(file_duration * timescale);
+	record_track.fragment_duration = static_cast<int64_t>(fragment_duration * timescale / 1000.0);
+}
+
+std::shared_ptr<SampleData> RecordStream::MakeVideoSample(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	// Use the const GetData() not to separate the payload shared with the other publishers
+	const MediaPacket &const_packet = *media_packet;
+	auto data = const_packet.GetData();
+	auto bitstream = data->GetDataAs<uint8_t>();
+
+	const FragmentationHeader *fragmentation = const_packet.GetFragHeader();
+	FragmentationHeader annexb_fragmentation;
+
+	if (fragmentation->GetCount() == 0)
+	{
+		AvcVideoPacketFragmentizer::MakeFragmentationHeader(bitstream, data->GetLength(), &annexb_fragmentation);
+		fragmentation = &annexb_fragmentation;
+	}
+
+	// Convert Annex-B to AVCC (4-byte NAL lengths), the parameter sets go into the init segment
+	auto sample_data = std::make_shared<ov::Data>(data->GetLength() + (fragmentation->GetCount() * sizeof(uint32_t)));
+
+	for (size_t index = 0; index < fragmentation->GetCount(); index++)
+	{
+		auto nal_offset = fragmentation->fragmentation_offset[index];
+		auto nal_length = fragmentation->fragmentation_length[index];
+
+		if ((nal_length == 0) || ((nal_offset + nal_length) > data->GetLength()))
+		{
+			continue;
+		}
+
+		auto nal = bitstream + nal_offset;
+
+		switch (nal[0] & 0x1F)
+		{
+			case 7:
+				_sps.assign(nal, nal + nal_length);
+				break;
+
+			case 8:
+				_pps.assign(nal, nal + nal_length);
+				break;
+
+			case 9:
+				// AUD is not used in MP4
+				break;
+
+			default:
+			{
+				uint32_t length = ov::HostToBE32(static_cast<uint32_t>(nal_length));
+
+				sample_data->Append(&length, sizeof(length));
+				sample_data->Append(nal, nal_length);
+				break;
+			}
+		}
+	}
+
+	if (sample_data->IsEmpty())
+	{
+		return nullptr;
+	}
+
+	uint32_t flag = (media_packet->GetFlag() == MediaPacketFlag::Key) ? RECORD_SAMPLE_FLAG_KEY_FRAME : RECORD_SAMPLE_FLAG_INTER_FRAME;
+	auto composition_time_offset = std::max(media_packet->GetPts() - media_packet->GetDts(), static_cast<int64_t>(0));
+
+	return std::make_shared<SampleData>(std::max(media_packet->GetDuration(), static_cast<int64_t>(0)), flag, media_packet->GetDts(),
+										static_cast<uint32_t>(composition_time_offset), sample_data);
+}
+
+std::shared_ptr<SampleData> RecordStream::MakeAudioSample(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	const MediaPacket &const_packet = *media_packet;
+	auto data = const_packet.GetData();
+	auto raw = data->GetDataAs<uint8_t>();
+	size_t raw_length = data->GetLength();
+	size_t header_length = 0;
+
+	if ((raw_length >= 7) && (raw[0] == 0xFF) && ((raw[1] & 0xF0) == 0xF0))
+	{
+		// Skip the ADTS header (9 bytes if it has CRC)
+		header_length = ((raw[1] & 0x01) == 0x01) ? 7 : 9;
+	}
+
+	if (raw_length <= header_length)
+	{
+		return nullptr;
+	}
+
+	// The payload is shared with the other publishers, SampleData is only read by M4sSegmentWriter
+	auto sample_data = std::const_pointer_cast<ov::Data>(data->Subdata(header_length));
+
+	return std::make_shared<SampleData>(std::max(media_packet->GetDuration(), static_cast<int64_t>(0)), media_packet->GetDts(), sample_data);
+}
+
+void RecordStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if ((_video.track == nullptr) || (media_packet->GetTrackId() != static_cast<int32_t>(_video.track->GetId())))
+	{
+		return;
+	}
+
+	auto sample = MakeVideoSample(media_packet);
+
+	if (sample != nullptr)
+	{
+		AppendSample(_video, sample, media_packet->GetFlag() == MediaPacketFlag::Key);
+	}
+}
+
+void RecordStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if ((_audio.track == nullptr) || (media_packet->GetTrackId() != static_cast<int32_t>(_audio.track->GetId())))
+	{
+		return;
+	}
+
+	auto sample = MakeAudioSample(media_packet);
+
+	if (sample != nullptr)
+	{
+		AppendSample(_audio, sample, true);
+	}
+}
+
+void RecordStream::AppendSample(RecordTrack &record_track, const std::shared_ptr<SampleData> &sample, bool is_key_frame)
+{
+	if (record_track.pending_sample != nullptr)
+	{
+		// The duration of the packet is used if the timestamps are not increasing
+		auto duration = sample->timestamp - record_track.pending_sample->timestamp;
+
+		if (duration > 0)
+		{
+			record_track.pending_sample->duration = duration;
+		}
+
+		record_track.samples.push_back(std::move(record_track.pending_sample));
+	}
+
+	if (NeedNewFile(record_track, sample, is_key_frame))
+	{
+		CloseFile(record_track);
+
+		if (OpenFile(record_track, sample) == false)
+		{
+			return;
+		}
+	}
+	else if (record_track.file == nullptr)
+	{
+		// Waiting for the frame that starts a file
+		return;
+	}
+	else if (record_track.samples.empty() == false)
+	{
+		auto fragment_duration = sample->timestamp - record_track.samples.front()->timestamp;
+
+		// The video fragments start with the key frames if possible, so the players can seek to them
+		if ((fragment_duration >= record_track.fragment_duration) &&
+			(is_key_frame || (fragment_duration >= (record_track.fragment_duration * 2))))
+		{
+			WriteFragment(record_track);
+		}
+	}
+
+	record_track.pending_sample = sample;
+}
+
+bool RecordStream::NeedNewFile(const RecordTrack &record_track, const std::shared_ptr<SampleData> &sample, bool is_key_frame) const
+{
+	if ((record_track.media_type == M4sMediaType::Audio) && (_video.track != nullptr))
+	{
+		// The audio file is started with the video file
+		auto video_file_start_time = _video_file_start_time.load();
+
+		return (video_file_start_time >= 0) && (video_file_start_time != record_track.file_start_time);
+	}
+
+	if (is_key_frame == false)
+	{
+		return false;
+	}
+
+	return (record_track.file == nullptr) ||
+		   ((sample->timestamp - record_track.file_start_timestamp) >= record_track.file_duration);
+}
+
+bool RecordStream::OpenFile(RecordTrack &record_track, const std::shared_ptr<SampleData> &sample)
+{
+	std::shared_ptr<ov::Data> init_data;
+
+	if (record_track.media_type == M4sMediaType::Video)
+	{
+		if (_sps.empty() || _pps.empty())
+		{
+			// The parameter sets are not received yet
+			return false;
+		}
+
+		auto sps = std::make_shared<const ov::Data>(_sps.data(), _sps.size());
+		auto pps = std::make_shared<const ov::Data>(_pps.data(), _pps.size());
+
+		// init segment doesn't have duration
+		init_data = M4sInitWriter(M4sMediaType::Video, 0, _video.track, _audio.track, sps, pps).CreateData();
+	}
+	else
+	{
+		init_data = M4sInitWriter(M4sMediaType::Audio, 0, _video.track, _audio.track, nullptr, nullptr).CreateData();
+	}
+
+	if (init_data == nullptr)
+	{
+		logte("Could not make the init segment of %s for %s/%s", record_track.file_suffix, GetApplication()->GetName().CStr(), GetName().CStr());
+		return false;
+	}
+
+	int64_t file_start_time = (record_track.media_type == M4sMediaType::Audio) ? _video_file_start_time.load() : -1;
+
+	if (file_start_time < 0)
+	{
+		file_start_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	auto path = ov::String::FormatString("%s/%lld_%s.mp4", _directory.CStr(), file_start_time, record_track.file_suffix);
+
+	record_track.file = std::make_shared<RecordFile>(path, init_data);
+	record_track.file_start_time = file_start_time;
+	record_track.file_start_timestamp = sample->timestamp;
+	record_track.sequence_number = 1;
+
+	if (record_track.media_type == M4sMediaType::Video)
+	{
+		_video_file_start_time = file_start_time;
+	}
+
+	return true;
+}
+
+void RecordStream::WriteFragment(RecordTrack &record_track)
+{
+	if (record_track.samples.empty() || (record_track.file == nullptr))
+	{
+		record_track.samples.clear();
+		return;
+	}
+
+	// The timestamps of a file start from 0
+	auto start_timestamp = record_track.samples.front()->timestamp - record_track.file_start_timestamp;
+
+	M4sSegmentWriter writer(record_track.media_type, record_track.sequence_number++, record_track.track_id, start_timestamp, true);
+	auto fragment = writer.AppendSamples(record_track.samples);
+
+	record_track.samples.clear();
+
+	if (fragment == nullptr)
+	{
+		logte("Could not make a fragment of %s for %s/%s", record_track.file_suffix, GetApplication()->GetName().CStr(), GetName().CStr());
+		return;
+	}
+
+	if (_writer->Write(record_track.file, fragment) == false)
+	{
+		logtw("A fragment of %s is dropped (the writer falls behind): %s", record_track.file_suffix, record_track.file->GetPath().CStr());
+	}
+}
+
+void RecordStream::CloseFile(RecordTrack &record_track)
+{
+	if (record_track.pending_sample != nullptr)
+	{
+		record_track.samples.push_back(std::move(record_track.pending_sample));
+	}
+
+	WriteFragment(record_track);
+
+	// The file is closed by the writer after the fragments are written
+	record_track.file = nullptr;
+}
@@ -0,0 +1,93 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/publisher/stream.h>
+#include <publishers/segment/segment_stream/packetizer/m4s_writer.h>
+
+#include "record_writer.h"
+
+// Records the first H.264/AAC tracks of the stream to fragmented MP4 files
+//
+// The fragments are made by the M4s writers of the DASH packetizer, so each track is recorded to its own file
+// (<FilePath>/<app>/<stream>/<start time>_video.mp4 and <start time>_audio.mp4, the start time is in milliseconds since epoch).
+// A new file is started at the first video key frame after FileDuration, and the audio file is started with it.
+class RecordStream : public pub::Stream
+{
+public:
+	static std::shared_ptr<RecordStream> Create(const std::shared_ptr<pub::Application> application,
+												const info::Stream &info,
+												uint32_t worker_count,
+												const std::shared_ptr<RecordWriter> &writer);
+	explicit RecordStream(const std::shared_ptr<pub::Application> application,
+						  const info::Stream &info,
+						  const std::shared_ptr<RecordWriter> &writer);
+	~RecordStream() final;
+
+	void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+	void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+
+	bool IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track) override;
+
+private:
+	struct RecordTrack
+	{
+		std::shared_ptr<MediaTrack> track;
+		M4sMediaType media_type = M4sMediaType::Video;
+		// The ID of the track in the file (M4sInitWriter uses 1 for video and 2 for audio)
+		uint32_t track_id = 0;
+		const char *file_suffix = nullptr;
+
+		// In the timebase of the track
+		int64_t fragment_duration = 0;
+		int64_t file_duration = 0;
+
+		std::shared_ptr<RecordFile> file;
+		// The start time of the file (milliseconds since epoch), it is the name of the file
+		int64_t file_start_time = -1;
+		// The DTS of the first frame of the file, the timestamps in the file start from 0
+		int64_t file_start_timestamp = 0;
+		uint32_t sequence_number = 1;
+
+		// The duration of a frame is known when the next frame is received
+		std::shared_ptr<SampleData> pending_sample;
+		std::vector<std::shared_ptr<const SampleData>> samples;
+	};
+
+	bool Start(uint32_t worker_count) override;
+	bool Stop() override;
+
+	void InitializeTrack(RecordTrack &record_track, const std::shared_ptr<MediaTrack> &track, int file_duration, int fragment_duration);
+
+	// Returns nullptr if there is no frame to record
+	std::shared_ptr<SampleData> MakeVideoSample(const std::shared_ptr<MediaPacket> &media_packet);
+	std::shared_ptr<SampleData> MakeAudioSample(const std::shared_ptr<MediaPacket> &media_packet);
+
+	// Appends the sample to the fragment of the track, and writes the fragment/starts a new file if needed
+	// is_key_frame: A new file can be started with the sample
+	void AppendSample(RecordTrack &record_track, const std::shared_ptr<SampleData> &sample, bool is_key_frame);
+	bool NeedNewFile(const RecordTrack &record_track, const std::shared_ptr<SampleData> &sample, bool is_key_frame) const;
+	bool OpenFile(RecordTrack &record_track, const std::shared_ptr<SampleData> &sample);
+	void WriteFragment(RecordTrack &record_track);
+	// Writes the samples of the track including the pending sample, and releases the file
+	void CloseFile(RecordTrack &record_track);
+
+	std::shared_ptr<RecordWriter> _writer;
+	ov::String _directory;
+
+	RecordTrack _video;
+	RecordTrack _audio;
+
+	// The start time of the current video file, the audio follows it (-1: no video file yet)
+	std::atomic<int64_t> _video_file_start_time{-1};
+
+	// The latest parameter sets for the init segment of the video file
+	std::vector<uint8_t> _sps;
+	std::vector<uint8_t> _pps;
+};
@@ -0,0 +1,203 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "record_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <set>
+
+#include "record_publisher_private.h"
+
+RecordFile::RecordFile(const ov::String &path, const std::shared_ptr<const ov::Data> &init_data)
+	: _path(path),
+	  _init_data(init_data)
+{
+}
+
+RecordFile::~RecordFile()
+{
+	Flush();
+	Close();
+}
+
+bool RecordFile::Open()
+{
+	_file_descriptor = ::open(_path.CStr(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+	if (_file_descriptor < 0)
+	{
+		logte("Could not create a record file: %s (%s)", _path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		_is_failed = true;
+		return false;
+	}
+
+	logti("Recording to %s", _path.CStr());
+
+	_buffer.reserve(RECORD_FILE_BUFFER_SIZE + (RECORD_FILE_BUFFER_SIZE / 4));
+	_buffer.assign(_init_data->GetDataAs<uint8_t>(), _init_data->GetDataAs<uint8_t>() + _init_data->GetLength());
+
+	return true;
+}
+
+void RecordFile::Close()
+{
+	if (_file_descriptor >= 0)
+	{
+		::close(_file_descriptor);
+		_file_descriptor = -1;
+
+		logti("Record file is closed: %s", _path.CStr());
+	}
+}
+
+bool RecordFile::Append(const std::shared_ptr<const ov::Data> &data)
+{
+	if (_is_failed || ((_file_descriptor < 0) && (Open() == false)))
+	{
+		return false;
+	}
+
+	auto buffer = data->GetDataAs<uint8_t>();
+	_buffer.insert(_buffer.end(), buffer, buffer + data->GetLength());
+
+	return (_buffer.size() < RECORD_FILE_BUFFER_SIZE) || Flush();
+}
+
+bool RecordFile::Flush()
+{
+	if (_buffer.empty() || (_file_descriptor < 0))
+	{
+		return true;
+	}
+
+	auto buffer = _buffer.data();
+	auto length = _buffer.size();
+	size_t written = 0;
+
+	while (written < length)
+	{
+		auto result = ::write(_file_descriptor, buffer + written, length - written);
+
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			logte("Could not write to the record file: %s (%s), the stream is not recorded anymore", _path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+
+			_buffer.clear();
+			_is_failed = true;
+			Close();
+
+			return false;
+		}
+
+		written += result;
+	}
+
+	_buffer.clear();
+
+	return true;
+}
+
+RecordWriter::RecordWriter(const ov::String &alias, size_t max_pending_bytes)
+{
+	_fragment_queue.SetAlias(alias);
+
+	// Blocking the streams would delay the other publishers, so the new fragments are dropped instead
+	_fragment_queue.SetLimit(0, max_pending_bytes, ov::QueueOverflowPolicy::Disconnect, [](const Fragment &fragment) -> size_t {
+		return fragment.data->GetLength();
+	});
+}
+
+RecordWriter::~RecordWriter()
+{
+	Stop();
+}
+
+bool RecordWriter::Start()
+{
+	if (_stop_thread_flag == false)
+	{
+		return true;
+	}
+
+	_stop_thread_flag = false;
+	_thread = std::thread(&RecordWriter::WriterThread, this);
+
+	return true;
+}
+
+void RecordWriter::Stop()
+{
+	if (_stop_thread_flag)
+	{
+		return;
+	}
+
+	_stop_thread_flag = true;
+
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+}
+
+bool RecordWriter::Write(const std::shared_ptr<RecordFile> &file, const std::shared_ptr<const ov::Data> &data)
+{
+	if (_stop_thread_flag)
+	{
+		return false;
+	}
+
+	return _fragment_queue.Enqueue(Fragment{file, data});
+}
+
+void RecordWriter::WriterThread()
+{
+	ov::ThreadMetrics thread_metrics("RecordWriter", ov::ThreadClass::Background);
+
+	// The files that have the fragments in the buffer (the last reference of a rolled file is released here, after it is written)
+	std::set<std::shared_ptr<RecordFile>> buffered_files;
+
+	while (true)
+	{
+		thread_metrics.BeginIdle();
+		auto fragment = _fragment_queue.Dequeue(_stop_thread_flag ? 0 : RECORD_WRITER_FLUSH_INTERVAL_MSEC);
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
+
+		if (fragment.has_value())
+		{
+			fragment->file->Append(fragment->data);
+			buffered_files.insert(fragment->file);
+
+			if (_fragment_queue.IsEmpty() == false)
+			{
+				// Gather the fragments that are waiting into the buffers
+				continue;
+			}
+		}
+
+		for (auto &file : buffered_files)
+		{
+			file->Flush();
+		}
+
+		buffered_files.clear();
+
+		if ((fragment.has_value() == false) && _stop_thread_flag)
+		{
+			break;
+		}
+	}
+}
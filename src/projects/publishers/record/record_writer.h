@@ -0,0 +1,89 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <atomic>
+#include <thread>
+
+// The fragments of a file are gathered up to this before they are written, so a write() carries several fragments when the writer falls behind
+#define RECORD_FILE_BUFFER_SIZE (1024 * 1024)
+// The buffered fragments are written if no fragment is received for this
+#define RECORD_WRITER_FLUSH_INTERVAL_MSEC 500
+
+class RecordWriter;
+
+// A file that is being recorded
+//
+// The file is opened by the writer thread when the first fragment is written (the init segment is written first),
+// and it is closed when the last reference is released (the stream rolls it, and the writer has written its fragments)
+class RecordFile
+{
+public:
+	RecordFile(const ov::String &path, const std::shared_ptr<const ov::Data> &init_data);
+	~RecordFile();
+
+	const ov::String &GetPath() const
+	{
+		return _path;
+	}
+
+private:
+	friend class RecordWriter;
+
+	// (Writer thread) Buffers the fragment, and writes the buffer if it is full
+	bool Append(const std::shared_ptr<const ov::Data> &data);
+	// (Writer thread) Writes the buffer
+	bool Flush();
+
+	bool Open();
+	void Close();
+
+	ov::String _path;
+	std::shared_ptr<const ov::Data> _init_data;
+
+	int _file_descriptor = -1;
+	// The fragments are not written anymore once an error occurred
+	bool _is_failed = false;
+
+	std::vector<uint8_t> _buffer;
+};
+
+// Writes the fragments of the streams to the files in a thread, so the streams are not blocked by the disk
+//
+// The fragments that are not written yet are limited by max_pending_bytes. If the disk is slower than the streams,
+// the new fragments are dropped (the file has a gap, but the fragments that are written are still playable),
+// and they are exported as ome_queue_dropped_total of the queue.
+class RecordWriter
+{
+public:
+	RecordWriter(const ov::String &alias, size_t max_pending_bytes);
+	~RecordWriter();
+
+	bool Start();
+	// The fragments that are received before Stop() are written
+	void Stop();
+
+	// Returns false if the fragment is dropped
+	bool Write(const std::shared_ptr<RecordFile> &file, const std::shared_ptr<const ov::Data> &data);
+
+private:
+	struct Fragment
+	{
+		std::shared_ptr<RecordFile> file;
+		std::shared_ptr<const ov::Data> data;
+	};
+
+	void WriterThread();
+
+	ov::Queue<Fragment> _fragment_queue;
+
+	std::atomic<bool> _stop_thread_flag{true};
+	std::thread _thread;
+};
@@ -0,0 +1,212 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_publisher.h"
+
+#include "rtmp_publisher_private.h"
+#include "rtmp_publisher_session.h"
+
+std::shared_ptr<RtmpPublisher> RtmpPublisher::Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+{
+	auto rtmp = std::make_shared<RtmpPublisher>(server_config, router);
+
+	if (!rtmp->Start())
+	{
+		logte("An error occurred while creating RtmpPublisher");
+		return nullptr;
+	}
+
+	return rtmp;
+}
+
+RtmpPublisher::RtmpPublisher(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router)
+	: Publisher(server_config, router)
+{
+}
+
+RtmpPublisher::~RtmpPublisher()
+{
+	logtd("RtmpPublisher has been terminated finally");
+}
+
+bool RtmpPublisher::Start()
+{
+	auto server_config = GetServerConfig();
+
+	// The default port of <Bind><Publishers><RTMP> is the same as the RTMP provider, so it listens only if configured
+	const auto &rtmp_port = server_config.GetBind().GetPublishers().GetRtmp();
+
+	if (rtmp_port.IsParsed())
+	{
+		int port = rtmp_port.GetPort();
+
+		if (port > 0)
+		{
+			const ov::String &ip = server_config.GetIp();
+			ov::SocketAddress address = ov::SocketAddress(ip.IsEmpty() ? nullptr : ip.CStr(), static_cast<uint16_t>(port));
+
+			_server_port = PhysicalPortManager::Instance()->CreatePort(rtmp_port.GetSocketType(), address, rtmp_port.GetReactorCount(),
+																	   rtmp_port.GetWorkerCount(), rtmp_port.GetWorkerAffinity());
+			if (_server_port != nullptr)
+			{
+				logti("RTMP Publisher has started listening on %s", address.ToString().CStr());
+				_server_port->AddObserver(this);
+			}
+			else
+			{
+				logte("Could not create RTMP publisher port. RTMP players will not be served.");
+			}
+		}
+		else
+		{
+			logte("Invalid RTMP publisher port: %d", port);
+		}
+	}
+
+	return Publisher::Start();
+}
+
+bool RtmpPublisher::Stop()
+{
+	if (_server_port != nullptr)
+	{
+		_server_port->RemoveObserver(this);
+		_server_port->Close();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_connection_map_lock);
+		_connection_map.clear();
+	}
+
+	return Publisher::Stop();
+}
+
+std::shared_ptr<pub::Application> RtmpPublisher::OnCreatePublisherApplication(const info::Application &application_info)
+{
+	return RtmpPublisherApplication::Create(RtmpPublisher::GetSharedPtrAs<pub::Publisher>(), application_info);
+}
+
+bool RtmpPublisher::OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application)
+{
+	return true;
+}
+
+std::shared_ptr<RtmpPublisherConnection> RtmpPublisher::GetConnection(int remote_id)
+{
+	std::lock_guard<std::mutex> lock_guard(_connection_map_lock);
+
+	auto item = _connection_map.find(remote_id);
+
+	if (item == _connection_map.end())
+	{
+		return nullptr;
+	}
+
+	return item->second;
+}
+
+void RtmpPublisher::OnConnected(const std::shared_ptr<ov::Socket> &remote)
+{
+	logti("A RTMP player has connected from %s", remote->ToString().CStr());
+
+	std::lock_guard<std::mutex> lock_guard(_connection_map_lock);
+
+	_connection_map[remote->GetId()] = std::make_shared<RtmpPublisherConnection>(remote, this);
+}
+
+void RtmpPublisher::OnDataReceived(const std::shared_ptr<ov::Socket> &remote,
+								   const ov::SocketAddress &address,
+								   const std::shared_ptr<const ov::Data> &data)
+{
+	// The data of a remote is always delivered by the same worker, so the connection doesn't need to be locked
+	auto connection = GetConnection(remote->GetId());
+
+	if (connection == nullptr)
+	{
+		return;
+	}
+
+	if (connection->OnDataReceived(data) == false)
+	{
+		logte("An error occurred while process the RTMP packet from %s, Disconnecting...", remote->ToString().CStr());
+
+		_server_port->DisconnectClient(dynamic_cast<ov::ClientSocket *>(remote.get()));
+	}
+}
+
+void RtmpPublisher::OnDisconnected(const std::shared_ptr<ov::Socket> &remote,
+								   PhysicalPortDisconnectReason reason,
+								   const std::shared_ptr<const ov::Error> &error)
+{
+	std::shared_ptr<RtmpPublisherConnection> connection;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_connection_map_lock);
+
+		auto item = _connection_map.find(remote->GetId());
+
+		if (item == _connection_map.end())
+		{
+			return;
+		}
+
+		connection = item->second;
+		_connection_map.erase(item);
+	}
+
+	logti("A RTMP player has disconnected from %s", remote->ToString().CStr());
+
+	if (connection->GetStreamName().IsEmpty() == false)
+	{
+		auto stream = std::static_pointer_cast<RtmpPublisherStream>(GetStream(connection->GetVHostAppName(), connection->GetStreamName()));
+
+		if (stream != nullptr)
+		{
+			stream->RemoveSessionByConnectorId(remote->GetId());
+		}
+	}
+}
+
+bool RtmpPublisher::OnPlay(const std::shared_ptr<RtmpPublisherConnection> &connection, const ov::String &vhost_app_name, const ov::String &stream_name)
+{
+	auto app = std::static_pointer_cast<RtmpPublisherApplication>(GetApplicationByName(vhost_app_name));
+	if (app == nullptr)
+	{
+		logtw("There is no such app (%s)", vhost_app_name.CStr());
+		return false;
+	}
+
+	auto stream = std::static_pointer_cast<RtmpPublisherStream>(app->GetStream(stream_name));
+	if (stream == nullptr)
+	{
+		logtw("There is no such stream (%s/%s)", vhost_app_name.CStr(), stream_name.CStr());
+		return false;
+	}
+
+	auto session = RtmpPublisherSession::Create(app, stream, stream->IssueUniqueSessionId(), connection);
+	if (session == nullptr)
+	{
+		logte("Could not create a session for %s/%s", vhost_app_name.CStr(), stream_name.CStr());
+		return false;
+	}
+
+	// The responses must arrive before the first chunk of the stream
+	if (connection->SendPlayStart() == false)
+	{
+		return false;
+	}
+
+	stream->AddSession(session);
+
+	return true;
+}
+
+bool RtmpPublisher::GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections)
+{
+	return true;
+}
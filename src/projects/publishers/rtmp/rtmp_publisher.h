@@ -0,0 +1,71 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/media_route/media_route_application_interface.h>
+#include <base/publisher/publisher.h>
+#include <modules/physical_port/physical_port_manager.h>
+
+#include "rtmp_publisher_application.h"
+#include "rtmp_publisher_connection.h"
+
+// Serves the streams to the RTMP players (play only)
+// Each FLV tag is chunked once per stream, and the chunks are shared by all players of the stream
+class RtmpPublisher : public pub::Publisher, public PhysicalPortObserver, public RtmpPublisherConnectionObserver
+{
+public:
+	static std::shared_ptr<RtmpPublisher> Create(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+
+	RtmpPublisher(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
+	~RtmpPublisher() override;
+	bool Stop() override;
+
+private:
+	bool Start() override;
+
+	//--------------------------------------------------------------------
+	// Implementation of Publisher
+	//--------------------------------------------------------------------
+	PublisherType GetPublisherType() const override
+	{
+		return PublisherType::Rtmp;
+	}
+	const char *GetPublisherName() const override
+	{
+		return "RTMPPublisher";
+	}
+
+	std::shared_ptr<pub::Application> OnCreatePublisherApplication(const info::Application &application_info) override;
+	bool OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application) override;
+
+	bool GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections) override;
+	//--------------------------------------------------------------------
+
+	//--------------------------------------------------------------------
+	// Implementation of PhysicalPortObserver
+	//--------------------------------------------------------------------
+	void OnConnected(const std::shared_ptr<ov::Socket> &remote) override;
+	void OnDataReceived(const std::shared_ptr<ov::Socket> &remote, const ov::SocketAddress &address, const std::shared_ptr<const ov::Data> &data) override;
+	void OnDisconnected(const std::shared_ptr<ov::Socket> &remote, PhysicalPortDisconnectReason reason, const std::shared_ptr<const ov::Error> &error) override;
+	//--------------------------------------------------------------------
+
+	//--------------------------------------------------------------------
+	// Implementation of RtmpPublisherConnectionObserver
+	//--------------------------------------------------------------------
+	bool OnPlay(const std::shared_ptr<RtmpPublisherConnection> &connection, const ov::String &vhost_app_name, const ov::String &stream_name) override;
+	//--------------------------------------------------------------------
+
+	std::shared_ptr<RtmpPublisherConnection> GetConnection(int remote_id);
+
+	std::shared_ptr<PhysicalPort> _server_port;
+
+	std::mutex _connection_map_lock;
+	// key: remote id
+	std::map<int, std::shared_ptr<RtmpPublisherConnection>> _connection_map;
+};
@@ -0,0 +1,68 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_publisher_application.h"
+
+#include "rtmp_publisher_private.h"
+#include "rtmp_publisher_stream.h"
+
+std::shared_ptr<RtmpPublisherApplication> RtmpPublisherApplication::Create(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
+{
+	auto application = std::make_shared<RtmpPublisherApplication>(publisher, application_info);
+	application->Start();
+	return application;
+}
+
+RtmpPublisherApplication::RtmpPublisherApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
+	: Application(publisher, application_info)
+{
+	SetDirectDispatch(true);
+}
+
+RtmpPublisherApplication::~RtmpPublisherApplication()
+{
+	Stop();
+	logtd("RtmpPublisherApplication(%d) has been terminated finally", GetId());
+}
+
+bool RtmpPublisherApplication::Start()
+{
+	return Application::Start();
+}
+
+bool RtmpPublisherApplication::Stop()
+{
+	return Application::Stop();
+}
+
+std::shared_ptr<pub::Stream> RtmpPublisherApplication::CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count)
+{
+	logtd("RtmpPublisherApplication::CreateStream : %s/%u", info->GetName().CStr(), info->GetId());
+	if (worker_count == 0)
+	{
+		// RtmpPublisherStream should have worker threads, so the chunks are sent to the players in parallel
+		worker_count = MIN_STREAM_WORKER_THREAD_COUNT;
+	}
+
+	return RtmpPublisherStream::Create(GetSharedPtrAs<pub::Application>(), *info, worker_count);
+}
+
+bool RtmpPublisherApplication::DeleteStream(const std::shared_ptr<info::Stream> &info)
+{
+	logtd("RtmpPublisherApplication::DeleteStream : %s/%u", info->GetName().CStr(), info->GetId());
+
+	auto stream = std::static_pointer_cast<RtmpPublisherStream>(GetStream(info->GetId()));
+	if (stream == nullptr)
+	{
+		logte("RtmpPublisherApplication::Delete stream failed. Cannot find stream (%s)", info->GetName().CStr());
+		return false;
+	}
+
+	logtd("RtmpPublisherApplication %s/%s stream has been deleted", GetName().CStr(), stream->GetName().CStr());
+
+	return true;
+}
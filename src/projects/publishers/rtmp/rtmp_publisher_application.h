@@ -0,0 +1,29 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/publisher/application.h>
+
+#include "rtmp_publisher_stream.h"
+
+class RtmpPublisherApplication : public pub::Application
+{
+public:
+	static std::shared_ptr<RtmpPublisherApplication> Create(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info);
+	RtmpPublisherApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info);
+	~RtmpPublisherApplication() final;
+
+private:
+	bool Start() override;
+	bool Stop() override;
+
+	// Application Implementation
+	std::shared_ptr<pub::Stream> CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count) override;
+	bool DeleteStream(const std::shared_ptr<info::Stream> &info) override;
+};
@@ -0,0 +1,552 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_publisher_connection.h"
+
+#include <base/ovlibrary/url.h>
+#include <orchestrator/orchestrator.h>
+
+#include "rtmp_publisher_private.h"
+#include "rtmp_publisher_stream.h"
+
+RtmpPublisherConnection::RtmpPublisherConnection(const std::shared_ptr<ov::Socket> &remote, RtmpPublisherConnectionObserver *observer)
+	: _remote(remote),
+	  _observer(observer)
+{
+	_import_chunk = std::make_shared<RtmpImportChunk>(RTMP_DEFAULT_CHUNK_SIZE);
+	// The commands are sent with the same chunk size as the media chunks (See SendSetChunkSize())
+	_export_chunk = std::make_shared<RtmpExportChunk>(false, RTMP_PUBLISHER_CHUNK_SIZE);
+}
+
+bool RtmpPublisherConnection::OnDataReceived(const std::shared_ptr<const ov::Data> &data)
+{
+	std::shared_ptr<const ov::Data> current_data;
+
+	if ((_remained_data == nullptr) || _remained_data->IsEmpty())
+	{
+		current_data = data;
+	}
+	else
+	{
+		// The players send only a few small commands, so merging is cheap here
+		auto merged_data = _remained_data->Clone();
+		merged_data->Append(data);
+		current_data = std::move(merged_data);
+	}
+
+	if (current_data->GetLength() > static_cast<size_t>(RTMP_MAX_PACKET_SIZE))
+	{
+		logte("The packet is too large: %zu bytes, remote: %s", current_data->GetLength(), _remote->ToString().CStr());
+		return false;
+	}
+
+	while (current_data->IsEmpty() == false)
+	{
+		off_t process_size = (_handshake_state == RtmpHandshakeState::Complete) ? ReceiveChunkPacket(current_data) : ReceiveHandshakePacket(current_data);
+
+		if (process_size < 0)
+		{
+			return false;
+		}
+		else if (process_size == 0)
+		{
+			// Need more data
+			break;
+		}
+
+		current_data = current_data->Subdata(process_size);
+	}
+
+	_remained_data = current_data;
+
+	return true;
+}
+
+off_t RtmpPublisherConnection::ReceiveHandshakePacket(const std::shared_ptr<const ov::Data> &data)
+{
+	switch (_handshake_state)
+	{
+		case RtmpHandshakeState::Uninitialized:
+		{
+			// C0 + C1
+			if (data->GetLength() < (sizeof(uint8_t) + RTMP_HANDSHAKE_PACKET_SIZE))
+			{
+				return 0;
+			}
+
+			auto version = data->At(0);
+
+			if (version != RTMP_HANDSHAKE_VERSION)
+			{
+				logte("Invalid RTMP version: %d, expected: %d, remote: %s", version, RTMP_HANDSHAKE_VERSION, _remote->ToString().CStr());
+				return -1;
+			}
+
+			// S0 + S1 + S2
+			auto handshake = std::make_shared<ov::Data>(sizeof(uint8_t) + (RTMP_HANDSHAKE_PACKET_SIZE * 2));
+			handshake->SetLength(handshake->GetCapacity());
+
+			auto buffer = handshake->GetWritableDataAs<uint8_t>();
+			buffer[0] = RTMP_HANDSHAKE_VERSION;
+			RtmpHandshake::MakeS1(buffer + sizeof(uint8_t));
+			RtmpHandshake::MakeS2(data->GetDataAs<uint8_t>() + sizeof(uint8_t), buffer + sizeof(uint8_t) + RTMP_HANDSHAKE_PACKET_SIZE);
+
+			if (Send(handshake) == false)
+			{
+				logte("Could not send S0/S1/S2 packets to %s", _remote->ToString().CStr());
+				return -1;
+			}
+
+			_handshake_state = RtmpHandshakeState::S2;
+
+			return sizeof(uint8_t) + RTMP_HANDSHAKE_PACKET_SIZE;
+		}
+
+		case RtmpHandshakeState::S2:
+			// C2
+			if (data->GetLength() < RTMP_HANDSHAKE_PACKET_SIZE)
+			{
+				return 0;
+			}
+
+			_handshake_state = RtmpHandshakeState::Complete;
+			logtd("Handshake is completed: %s", _remote->ToString().CStr());
+
+			return RTMP_HANDSHAKE_PACKET_SIZE;
+
+		default:
+			logte("Failed to handshake: state: %d", static_cast<int32_t>(_handshake_state));
+			return -1;
+	}
+}
+
+off_t RtmpPublisherConnection::ReceiveChunkPacket(const std::shared_ptr<const ov::Data> &data)
+{
+	bool is_completed = false;
+	int import_size = _import_chunk->Import(data, &is_completed);
+
+	if (import_size < 0)
+	{
+		logte("An error occurred while parse RTMP data: %d, remote: %s", import_size, _remote->ToString().CStr());
+		return import_size;
+	}
+
+	if (is_completed && (ReceiveChunkMessage() == false))
+	{
+		return -1;
+	}
+
+	return import_size;
+}
+
+bool RtmpPublisherConnection::ReceiveChunkMessage()
+{
+	while (true)
+	{
+		auto message = _import_chunk->GetMessage();
+
+		if ((message == nullptr) || (message->payload == nullptr))
+		{
+			break;
+		}
+
+		switch (message->header->completed.type_id)
+		{
+			case RTMP_MSGID_SET_CHUNK_SIZE:
+			{
+				auto chunk_size = RtmpMuxUtil::ReadInt32(message->payload->GetData());
+
+				if (chunk_size <= 0)
+				{
+					logte("Invalid chunk size: %d", chunk_size);
+					return false;
+				}
+
+				_import_chunk->SetChunkSize(chunk_size);
+				break;
+			}
+
+			case RTMP_MSGID_AMF0_COMMAND_MESSAGE:
+				ReceiveAmfCommandMessage(message);
+				break;
+
+			case RTMP_MSGID_ACKNOWLEDGEMENT:
+			case RTMP_MSGID_WINDOWACKNOWLEDGEMENT_SIZE:
+			case RTMP_MSGID_USER_CONTROL_MESSAGE:
+				// The players report what they received, but the publisher doesn't wait for them
+				break;
+
+			default:
+				logtd("Unknown Type - Type(%d)", message->header->completed.type_id);
+				break;
+		}
+	}
+
+	return true;
+}
+
+void RtmpPublisherConnection::ReceiveAmfCommandMessage(const std::shared_ptr<const RtmpMessage> &message)
+{
+	AmfDocument document;
+	ov::String message_name;
+	double transaction_id = 0.0;
+
+	if (document.Decode(message->payload->GetData(), message->header->payload_size) == 0)
+	{
+		logte("AmfDocument Size 0 ");
+		return;
+	}
+
+	if (document.GetProperty(0) == nullptr || document.GetProperty(0)->GetType() != AmfDataType::String)
+	{
+		logte("Message Name Fail");
+		return;
+	}
+	message_name = document.GetProperty(0)->GetString();
+
+	if (document.GetProperty(1) != nullptr && document.GetProperty(1)->GetType() == AmfDataType::Number)
+	{
+		transaction_id = document.GetProperty(1)->GetNumber();
+	}
+
+	if (message_name == RTMP_CMD_NAME_CONNECT)
+	{
+		OnAmfConnect(message->header, document, transaction_id);
+	}
+	else if (message_name == RTMP_CMD_NAME_CREATESTREAM)
+	{
+		OnAmfCreateStream(message->header, document, transaction_id);
+	}
+	else if (message_name == RTMP_CMD_NAME_PLAY)
+	{
+		OnAmfPlay(message->header, document, transaction_id);
+	}
+	else if ((message_name == RTMP_CMD_NAME_DELETESTREAM) || (message_name == RTMP_CMD_NAME_CLOSESTREAM))
+	{
+		// The session is removed when the player disconnects
+	}
+	else
+	{
+		logtd("Unknown Amf0CommandMessage - Message(%s:%.1f)", message_name.CStr(), transaction_id);
+	}
+}
+
+bool RtmpPublisherConnection::OnAmfConnect(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id)
+{
+	double object_encoding = 0.0;
+	ov::String app_name;
+	ov::String tc_url;
+
+	if (document.GetProperty(2) != nullptr && document.GetProperty(2)->GetType() == AmfDataType::Object)
+	{
+		AmfObject *object = document.GetProperty(2)->GetObject();
+		int32_t index;
+
+		if ((index = object->FindName("objectEncoding")) >= 0 && object->GetType(index) == AmfDataType::Number)
+		{
+			object_encoding = object->GetNumber(index);
+		}
+
+		if ((index = object->FindName("app")) >= 0 && object->GetType(index) == AmfDataType::String)
+		{
+			app_name = object->GetString(index);
+		}
+
+		if ((index = object->FindName("tcUrl")) >= 0 && object->GetType(index) == AmfDataType::String)
+		{
+			tc_url = object->GetString(index);
+		}
+	}
+
+	// Parse the URL to obtain the domain name
+	auto url = ov::Url::Parse(tc_url.CStr());
+
+	if (url != nullptr)
+	{
+		_domain = url->Domain();
+	}
+
+	_vhost_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(_domain, app_name);
+
+	if (!SendWindowAcknowledgementSize() ||
+		!SendSetPeerBandwidth() ||
+		!SendSetChunkSize() ||
+		!SendAmfConnectResult(header->basic_header.stream_id, transaction_id, object_encoding))
+	{
+		logte("Could not send the response of connect to %s", _remote->ToString().CStr());
+		return false;
+	}
+
+	return true;
+}
+
+bool RtmpPublisherConnection::OnAmfCreateStream(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id)
+{
+	if (!SendAmfCreateStreamResult(header->basic_header.stream_id, transaction_id))
+	{
+		logte("SendAmfCreateStreamResult Fail");
+		return false;
+	}
+
+	return true;
+}
+
+bool RtmpPublisherConnection::OnAmfPlay(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id)
+{
+	_command_chunk_stream_id = header->basic_header.stream_id;
+
+	if (document.GetProperty(3) == nullptr || document.GetProperty(3)->GetType() != AmfDataType::String)
+	{
+		logte("OnPlay - Stream Name None");
+		SendAmfOnStatus(_command_chunk_stream_id, "error", "NetStream.Play.Failed", "Stream name is not specified.");
+		return false;
+	}
+
+	_stream_name = document.GetProperty(3)->GetString();
+
+	// Drop the query string (e.g. stream?token=...)
+	auto query_position = _stream_name.IndexOf('?');
+	if (query_position >= 0)
+	{
+		_stream_name = _stream_name.Substring(0, query_position);
+	}
+
+	logti("A RTMP player requested %s/%s from %s", _vhost_app_name.CStr(), _stream_name.CStr(), _remote->ToString().CStr());
+
+	if ((_observer == nullptr) || (_observer->OnPlay(GetSharedPtr(), _vhost_app_name, _stream_name) == false))
+	{
+		SendAmfOnStatus(_command_chunk_stream_id, "error", "NetStream.Play.StreamNotFound", "No such stream.");
+		return false;
+	}
+
+	return true;
+}
+
+bool RtmpPublisherConnection::Send(const std::shared_ptr<const ov::Data> &data)
+{
+	std::lock_guard<std::mutex> lock_guard(_send_lock);
+
+	return _remote->Send(data) == static_cast<ssize_t>(data->GetLength());
+}
+
+bool RtmpPublisherConnection::SendMessagePacket(std::shared_ptr<RtmpMuxMessageHeader> &message_header, std::shared_ptr<std::vector<uint8_t>> &data)
+{
+	if (message_header == nullptr)
+	{
+		return false;
+	}
+
+	auto export_data = _export_chunk->ExportStreamData(message_header, data);
+
+	if (export_data == nullptr || export_data->data() == nullptr)
+	{
+		return false;
+	}
+
+	return Send(std::make_shared<ov::Data>(export_data->data(), export_data->size(), export_data));
+}
+
+bool RtmpPublisherConnection::SendAmfCommand(std::shared_ptr<RtmpMuxMessageHeader> &message_header, AmfDocument &document)
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(2048);
+	uint32_t body_size = 0;
+
+	if (message_header == nullptr)
+	{
+		return false;
+	}
+
+	body_size = document.Encode(body->data());
+
+	if (body_size == 0)
+	{
+		return false;
+	}
+
+	message_header->body_size = body_size;
+	body->resize(body_size);
+
+	return SendMessagePacket(message_header, body);
+}
+
+bool RtmpPublisherConnection::SendUserControlMessage(uint16_t message, std::shared_ptr<std::vector<uint8_t>> &data)
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_URGENT,
+																 0,
+																 RTMP_MSGID_USER_CONTROL_MESSAGE,
+																 0,
+																 data->size() + 2);
+
+	data->insert(data->begin(), 0);
+	data->insert(data->begin(), 0);
+	RtmpMuxUtil::WriteInt16(data->data(), message);
+
+	return SendMessagePacket(message_header, data);
+}
+
+bool RtmpPublisherConnection::SendWindowAcknowledgementSize()
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_URGENT,
+																 0,
+																 RTMP_MSGID_WINDOWACKNOWLEDGEMENT_SIZE,
+																 0,
+																 body->size());
+
+	RtmpMuxUtil::WriteInt32(body->data(), RTMP_DEFAULT_ACKNOWNLEDGEMENT_SIZE);
+
+	return SendMessagePacket(message_header, body);
+}
+
+bool RtmpPublisherConnection::SendSetPeerBandwidth()
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(5);
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_URGENT,
+																 0,
+																 RTMP_MSGID_SET_PEERBANDWIDTH,
+																 0,
+																 body->size());
+
+	RtmpMuxUtil::WriteInt32(body->data(), RTMP_DEFAULT_PEER_BANDWIDTH);
+	// Limit type: dynamic
+	RtmpMuxUtil::WriteInt8(body->data() + 4, 2);
+
+	return SendMessagePacket(message_header, body);
+}
+
+bool RtmpPublisherConnection::SendSetChunkSize()
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(sizeof(int));
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_CHUNK_STREAM_ID_URGENT,
+																 0,
+																 RTMP_MSGID_SET_CHUNK_SIZE,
+																 0,
+																 body->size());
+
+	RtmpMuxUtil::WriteInt32(body->data(), RTMP_PUBLISHER_CHUNK_SIZE);
+
+	return SendMessagePacket(message_header, body);
+}
+
+bool RtmpPublisherConnection::SendStreamBegin()
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(4);
+
+	RtmpMuxUtil::WriteInt32(body->data(), RTMP_PUBLISHER_STREAM_ID);
+
+	return SendUserControlMessage(RTMP_UCMID_STREAMBEGIN, body);
+}
+
+bool RtmpPublisherConnection::SendAmfConnectResult(uint32_t chunk_stream_id, double transaction_id, double object_encoding)
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(chunk_stream_id,
+																 0,
+																 RTMP_MSGID_AMF0_COMMAND_MESSAGE,
+																 0,
+																 0);
+	AmfDocument document;
+	AmfObject *object = nullptr;
+	AmfArray *array = nullptr;
+
+	// _result
+	document.AddProperty(RTMP_ACK_NAME_RESULT);
+	document.AddProperty(transaction_id);
+
+	// properties
+	object = new AmfObject;
+	object->AddProperty("fmsVer", "FMS/3,5,2,654");
+	object->AddProperty("capabilities", 31.0);
+	object->AddProperty("mode", 1.0);
+
+	document.AddProperty(object);
+
+	// information
+	object = new AmfObject;
+	object->AddProperty("level", "status");
+	object->AddProperty("code", "NetConnection.Connect.Success");
+	object->AddProperty("description", "Connection succeeded.");
+	object->AddProperty("objectEncoding", object_encoding);
+
+	array = new AmfArray;
+	array->AddProperty("version", "3,5,2,654");
+	object->AddProperty("data", array);
+
+	document.AddProperty(object);
+
+	return SendAmfCommand(message_header, document);
+}
+
+bool RtmpPublisherConnection::SendAmfCreateStreamResult(uint32_t chunk_stream_id, double transaction_id)
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(chunk_stream_id,
+																 0,
+																 RTMP_MSGID_AMF0_COMMAND_MESSAGE,
+																 0,
+																 0);
+	AmfDocument document;
+
+	document.AddProperty(RTMP_ACK_NAME_RESULT);
+	document.AddProperty(transaction_id);
+	document.AddProperty(AmfDataType::Null);
+	document.AddProperty(static_cast<double>(RTMP_PUBLISHER_STREAM_ID));
+
+	return SendAmfCommand(message_header, document);
+}
+
+bool RtmpPublisherConnection::SendAmfOnStatus(uint32_t chunk_stream_id, const char *level, const char *code, const char *description)
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(chunk_stream_id,
+																 0,
+																 RTMP_MSGID_AMF0_COMMAND_MESSAGE,
+																 RTMP_PUBLISHER_STREAM_ID,
+																 0);
+	AmfDocument document;
+	AmfObject *object = nullptr;
+
+	document.AddProperty(RTMP_CMD_NAME_ONSTATUS);
+	document.AddProperty(0.0);
+	document.AddProperty(AmfDataType::Null);
+
+	object = new AmfObject;
+	object->AddProperty("level", level);
+	object->AddProperty("code", code);
+	object->AddProperty("description", description);
+
+	document.AddProperty(object);
+
+	return SendAmfCommand(message_header, document);
+}
+
+bool RtmpPublisherConnection::SendSampleAccess()
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(RTMP_PUBLISHER_CHUNK_STREAM_ID_DATA,
+																 0,
+																 RTMP_MSGID_AMF0_DATA_MESSAGE,
+																 RTMP_PUBLISHER_STREAM_ID,
+																 0);
+	AmfDocument document;
+
+	document.AddProperty("|RtmpSampleAccess");
+	document.AddProperty(false);
+	document.AddProperty(false);
+
+	return SendAmfCommand(message_header, document);
+}
+
+bool RtmpPublisherConnection::SendPlayStart()
+{
+	if (!SendStreamBegin() ||
+		!SendAmfOnStatus(_command_chunk_stream_id, "status", "NetStream.Play.Reset", "Playing and resetting stream.") ||
+		!SendAmfOnStatus(_command_chunk_stream_id, "status", "NetStream.Play.Start", "Started playing stream.") ||
+		!SendSampleAccess())
+	{
+		logte("Could not send the response of play to %s", _remote->ToString().CStr());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,101 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+#include <base/ovsocket/ovsocket.h>
+#include <providers/rtmp/chunk/amf_document.h>
+#include <providers/rtmp/chunk/rtmp_export_chunk.h>
+#include <providers/rtmp/chunk/rtmp_handshake.h>
+#include <providers/rtmp/chunk/rtmp_import_chunk.h>
+
+class RtmpPublisherConnection;
+
+class RtmpPublisherConnectionObserver
+{
+public:
+	// Called when the player sends the play command
+	// Returns false if there is no such stream
+	virtual bool OnPlay(const std::shared_ptr<RtmpPublisherConnection> &connection, const ov::String &vhost_app_name, const ov::String &stream_name) = 0;
+};
+
+// Handles the handshake and the commands of a player connected to the RTMP publisher
+class RtmpPublisherConnection : public ov::EnableSharedFromThis<RtmpPublisherConnection>
+{
+public:
+	RtmpPublisherConnection(const std::shared_ptr<ov::Socket> &remote, RtmpPublisherConnectionObserver *observer);
+
+	// Returns false if the connection must be closed
+	bool OnDataReceived(const std::shared_ptr<const ov::Data> &data);
+
+	// The control messages and the media chunks are sent from different threads, so the sends are serialized here
+	bool Send(const std::shared_ptr<const ov::Data> &data);
+
+	// Sends StreamBegin, onStatus(NetStream.Play.Reset/Start) and |RtmpSampleAccess
+	bool SendPlayStart();
+
+	int GetId() const
+	{
+		return _remote->GetId();
+	}
+
+	const std::shared_ptr<ov::Socket> &GetRemote() const
+	{
+		return _remote;
+	}
+
+	const ov::String &GetVHostAppName() const
+	{
+		return _vhost_app_name;
+	}
+
+	const ov::String &GetStreamName() const
+	{
+		return _stream_name;
+	}
+
+private:
+	off_t ReceiveHandshakePacket(const std::shared_ptr<const ov::Data> &data);
+	off_t ReceiveChunkPacket(const std::shared_ptr<const ov::Data> &data);
+	bool ReceiveChunkMessage();
+
+	void ReceiveAmfCommandMessage(const std::shared_ptr<const RtmpMessage> &message);
+	bool OnAmfConnect(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
+	bool OnAmfCreateStream(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
+	bool OnAmfPlay(const std::shared_ptr<const RtmpChunkHeader> &header, AmfDocument &document, double transaction_id);
+
+	bool SendMessagePacket(std::shared_ptr<RtmpMuxMessageHeader> &message_header, std::shared_ptr<std::vector<uint8_t>> &data);
+	bool SendAmfCommand(std::shared_ptr<RtmpMuxMessageHeader> &message_header, AmfDocument &document);
+	bool SendUserControlMessage(uint16_t message, std::shared_ptr<std::vector<uint8_t>> &data);
+	bool SendWindowAcknowledgementSize();
+	bool SendSetPeerBandwidth();
+	bool SendSetChunkSize();
+	bool SendStreamBegin();
+	bool SendAmfConnectResult(uint32_t chunk_stream_id, double transaction_id, double object_encoding);
+	bool SendAmfCreateStreamResult(uint32_t chunk_stream_id, double transaction_id);
+	bool SendAmfOnStatus(uint32_t chunk_stream_id, const char *level, const char *code, const char *description);
+	bool SendSampleAccess();
+
+	std::shared_ptr<ov::Socket> _remote;
+	RtmpPublisherConnectionObserver *_observer = nullptr;
+
+	std::mutex _send_lock;
+
+	RtmpHandshakeState _handshake_state = RtmpHandshakeState::Uninitialized;
+	std::shared_ptr<const ov::Data> _remained_data;
+
+	std::shared_ptr<RtmpImportChunk> _import_chunk;
+	std::shared_ptr<RtmpExportChunk> _export_chunk;
+
+	// The chunk stream id of the play command, the responses are sent to it
+	uint32_t _command_chunk_stream_id = RTMP_CHUNK_STREAM_ID_CONTROL;
+
+	ov::String _domain;
+	ov::String _vhost_app_name;
+	ov::String _stream_name;
+};
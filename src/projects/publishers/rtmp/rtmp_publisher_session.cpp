@@ -0,0 +1,86 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_publisher_session.h"
+
+#include <base/info/stream.h>
+
+#include "rtmp_publisher_private.h"
+#include "rtmp_publisher_stream.h"
+
+std::shared_ptr<RtmpPublisherSession> RtmpPublisherSession::Create(const std::shared_ptr<pub::Application> &application,
+																   const std::shared_ptr<pub::Stream> &stream,
+																   uint32_t session_id,
+																   const std::shared_ptr<RtmpPublisherConnection> &connection)
+{
+	auto session_info = info::Session(*std::static_pointer_cast<info::Stream>(stream), session_id);
+	auto session = std::make_shared<RtmpPublisherSession>(session_info, application, stream, connection);
+	if (!session->Start())
+	{
+		return nullptr;
+	}
+	return session;
+}
+
+RtmpPublisherSession::RtmpPublisherSession(const info::Session &session_info,
+										   const std::shared_ptr<pub::Application> &application,
+										   const std::shared_ptr<pub::Stream> &stream,
+										   const std::shared_ptr<RtmpPublisherConnection> &connection)
+	: pub::Session(session_info, application, stream),
+	  _connection(connection)
+{
+}
+
+RtmpPublisherSession::~RtmpPublisherSession()
+{
+	Stop();
+	logtd("RtmpPublisherSession(%d) has been terminated finally", GetId());
+}
+
+bool RtmpPublisherSession::Start()
+{
+	logtd("RtmpPublisherSession(%d) has started", GetId());
+	return Session::Start();
+}
+
+bool RtmpPublisherSession::Stop()
+{
+	logtd("RtmpPublisherSession(%d) has stopped", GetId());
+	return Session::Stop();
+}
+
+bool RtmpPublisherSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet)
+{
+	if (_started == false)
+	{
+		auto stream = std::static_pointer_cast<RtmpPublisherStream>(GetStream());
+
+		if (stream->HasVideo() && (packet_type != static_cast<uint32_t>(RtmpPublisherPacketType::VideoKeyFrame)))
+		{
+			// Wait for a key frame
+			return false;
+		}
+
+		for (const auto &header_packet : {stream->GetMetadataPacket(), stream->GetVideoSequenceHeaderPacket(), stream->GetAudioSequenceHeaderPacket()})
+		{
+			if ((header_packet != nullptr) && (_connection->Send(header_packet) == false))
+			{
+				return false;
+			}
+		}
+
+		_started = true;
+	}
+
+	return _connection->Send(packet);
+}
+
+void RtmpPublisherSession::OnPacketReceived(const std::shared_ptr<info::Session> &session_info,
+											const std::shared_ptr<const ov::Data> &data)
+{
+	// NOTHING YET
+}
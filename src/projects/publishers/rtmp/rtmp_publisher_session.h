@@ -0,0 +1,46 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/publisher/session.h>
+
+#include "rtmp_publisher_connection.h"
+
+class RtmpPublisherSession : public pub::Session
+{
+public:
+	static std::shared_ptr<RtmpPublisherSession> Create(const std::shared_ptr<pub::Application> &application,
+														const std::shared_ptr<pub::Stream> &stream,
+														uint32_t session_id,
+														const std::shared_ptr<RtmpPublisherConnection> &connection);
+
+	RtmpPublisherSession(const info::Session &session_info,
+						 const std::shared_ptr<pub::Application> &application,
+						 const std::shared_ptr<pub::Stream> &stream,
+						 const std::shared_ptr<RtmpPublisherConnection> &connection);
+	~RtmpPublisherSession() override;
+
+	bool Start() override;
+	bool Stop() override;
+
+	// The packet is the chunks shared by all sessions of the stream, so it is sent as it is
+	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet) override;
+	void OnPacketReceived(const std::shared_ptr<info::Session> &session_info,
+						  const std::shared_ptr<const ov::Data> &data) override;
+
+	int GetConnectorId() const
+	{
+		return _connection->GetId();
+	}
+
+private:
+	std::shared_ptr<RtmpPublisherConnection> _connection;
+
+	// The player starts to receive the frames from a key frame, after onMetaData and the sequence headers
+	bool _started = false;
+};
@@ -0,0 +1,518 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtmp_publisher_stream.h"
+
+#include <base/publisher/application.h>
+#include <media_router/bitstream/avc_video_packet_fragmentizer.h>
+#include <providers/rtmp/chunk/amf_document.h>
+
+#include "rtmp_publisher_private.h"
+#include "rtmp_publisher_session.h"
+
+// FLV tag header bytes (https://www.adobe.com/content/dam/acom/en/devnet/flv/video_file_format_spec_v10.pdf)
+#define RTMP_PUBLISHER_FLV_AVC_KEY_FRAME 0x17
+#define RTMP_PUBLISHER_FLV_AVC_INTER_FRAME 0x27
+// AAC, 44kHz, 16bit, stereo (The players always use the values of AudioSpecificConfig for AAC)
+#define RTMP_PUBLISHER_FLV_AAC 0xAF
+
+std::shared_ptr<RtmpPublisherStream> RtmpPublisherStream::Create(const std::shared_ptr<pub::Application> application,
+																 const info::Stream &info,
+																 uint32_t worker_count)
+{
+	auto stream = std::make_shared<RtmpPublisherStream>(application, info);
+	if (!stream->Start(worker_count))
+	{
+		return nullptr;
+	}
+	return stream;
+}
+
+RtmpPublisherStream::RtmpPublisherStream(const std::shared_ptr<pub::Application> application,
+										 const info::Stream &info)
+	: Stream(application, info)
+{
+}
+
+RtmpPublisherStream::~RtmpPublisherStream()
+{
+	logtd("RtmpPublisherStream(%s/%s) has been terminated finally", GetApplication()->GetName().CStr(), GetName().CStr());
+}
+
+bool RtmpPublisherStream::Start(uint32_t worker_count)
+{
+	for (auto &track_item : _tracks)
+	{
+		auto &track = track_item.second;
+
+		if ((_video_track == nullptr) && (track->GetCodecId() == common::MediaCodecId::H264))
+		{
+			_video_track = track;
+		}
+		else if ((_audio_track == nullptr) && (track->GetCodecId() == common::MediaCodecId::Aac))
+		{
+			_audio_track = track;
+		}
+	}
+
+	if ((_video_track == nullptr) && (_audio_track == nullptr))
+	{
+		logtw("RtmpPublisherStream(%s/%s) has no H.264/AAC track, RTMP players will not receive any frame",
+			  GetApplication()->GetName().CStr(), GetName().CStr());
+	}
+
+	_export_chunk = std::make_shared<RtmpExportChunk>(false, RTMP_PUBLISHER_CHUNK_SIZE);
+	_metadata_packet = MakeMetadataPacket();
+
+	logtd("RtmpPublisherStream(%u) has been started", GetId());
+
+	return Stream::Start(worker_count);
+}
+
+bool RtmpPublisherStream::Stop()
+{
+	logtd("RtmpPublisherStream(%u) has been stopped", GetId());
+
+	return Stream::Stop();
+}
+
+bool RtmpPublisherStream::IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track)
+{
+	return ((_video_track != nullptr) && (_video_track->GetId() == track->GetId())) ||
+		   ((_audio_track != nullptr) && (_audio_track->GetId() == track->GetId()));
+}
+
+uint32_t RtmpPublisherStream::ToRtmpTimestamp(const std::shared_ptr<MediaTrack> &track, int64_t timestamp) const
+{
+	// RTMP timestamps are 32-bit milliseconds, and they wrap around
+	return static_cast<uint32_t>(static_cast<int64_t>(timestamp * track->GetTimeBase().GetExpr() * 1000.0));
+}
+
+std::shared_ptr<ov::Data> RtmpPublisherStream::MakeChunks(uint32_t chunk_stream_id, uint8_t type_id, uint32_t timestamp, const std::shared_ptr<std::vector<uint8_t>> &body)
+{
+	auto message_header = std::make_shared<RtmpMuxMessageHeader>(chunk_stream_id,
+																 timestamp,
+																 type_id,
+																 RTMP_PUBLISHER_STREAM_ID,
+																 body->size());
+	auto message_body = body;
+	std::shared_ptr<std::vector<uint8_t>> chunks;
+
+	{
+		// Every message starts with a type 0 header, so the chunks don't depend on the previous messages of the session
+		std::lock_guard<std::mutex> lock_guard(_export_chunk_lock);
+		chunks = _export_chunk->ExportStreamData(message_header, message_body);
+	}
+
+	if (chunks == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Wrap the chunks without copying
+	return std::make_shared<ov::Data>(chunks->data(), chunks->size(), chunks);
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::MakeMetadataPacket()
+{
+	AmfDocument document;
+	auto array = new AmfArray;
+
+	document.AddProperty(RTMP_CMD_DATA_ONMETADATA);
+
+	if (_video_track != nullptr)
+	{
+		array->AddProperty("width", static_cast<double>(_video_track->GetWidth()));
+		array->AddProperty("height", static_cast<double>(_video_track->GetHeight()));
+		array->AddProperty("framerate", _video_track->GetFrameRate());
+		array->AddProperty("videodatarate", static_cast<double>(_video_track->GetBitrate()) / 1000.0);
+		// AVC
+		array->AddProperty("videocodecid", 7.0);
+	}
+
+	if (_audio_track != nullptr)
+	{
+		array->AddProperty("audiodatarate", static_cast<double>(_audio_track->GetBitrate()) / 1000.0);
+		array->AddProperty("audiosamplerate", static_cast<double>(_audio_track->GetSampleRate()));
+		array->AddProperty("audiochannels", static_cast<double>(_audio_track->GetChannel().GetCounts()));
+		// AAC
+		array->AddProperty("audiocodecid", 10.0);
+	}
+
+	document.AddProperty(array);
+
+	auto body = std::make_shared<std::vector<uint8_t>>(2048);
+	auto body_size = document.Encode(body->data());
+
+	if (body_size == 0)
+	{
+		return nullptr;
+	}
+
+	body->resize(body_size);
+
+	return MakeChunks(RTMP_PUBLISHER_CHUNK_STREAM_ID_DATA, RTMP_MSGID_AMF0_DATA_MESSAGE, 0, body);
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::MakeVideoSequenceHeaderPacket(const uint8_t *sps, size_t sps_length, const uint8_t *pps, size_t pps_length)
+{
+	if (sps_length < 4)
+	{
+		return nullptr;
+	}
+
+	// FLV video tag header (5 bytes) + AVCDecoderConfigurationRecord
+	auto body = std::make_shared<std::vector<uint8_t>>(5 + 11 + sps_length + pps_length);
+	auto buffer = body->data();
+
+	buffer[0] = RTMP_PUBLISHER_FLV_AVC_KEY_FRAME;
+	// AVCPacketType: AVC sequence header
+	buffer[1] = 0x00;
+	// Composition time
+	RtmpMuxUtil::WriteInt24(buffer + 2, 0);
+	buffer += 5;
+
+	// configurationVersion, AVCProfileIndication, profile_compatibility, AVCLevelIndication
+	buffer[0] = 0x01;
+	buffer[1] = sps[1];
+	buffer[2] = sps[2];
+	buffer[3] = sps[3];
+	// lengthSizeMinusOne: 3 (4-byte NAL lengths)
+	buffer[4] = 0xFF;
+	// numOfSequenceParameterSets: 1
+	buffer[5] = 0xE1;
+	buffer += 6;
+
+	buffer += RtmpMuxUtil::WriteInt16(buffer, static_cast<int16_t>(sps_length));
+	::memcpy(buffer, sps, sps_length);
+	buffer += sps_length;
+
+	// numOfPictureParameterSets: 1
+	*(buffer++) = 0x01;
+	buffer += RtmpMuxUtil::WriteInt16(buffer, static_cast<int16_t>(pps_length));
+	::memcpy(buffer, pps, pps_length);
+
+	return MakeChunks(RTMP_PUBLISHER_CHUNK_STREAM_ID_VIDEO, RTMP_MSGID_VIDEO_MESSAGE, 0, body);
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::MakeAudioSequenceHeaderPacket(const uint8_t *audio_specific_config, size_t length)
+{
+	auto body = std::make_shared<std::vector<uint8_t>>(2 + length);
+	auto buffer = body->data();
+
+	buffer[0] = RTMP_PUBLISHER_FLV_AAC;
+	// AACPacketType: AAC sequence header
+	buffer[1] = 0x00;
+	::memcpy(buffer + 2, audio_specific_config, length);
+
+	return MakeChunks(RTMP_PUBLISHER_CHUNK_STREAM_ID_AUDIO, RTMP_MSGID_AUDIO_MESSAGE, 0, body);
+}
+
+std::shared_ptr<ov::Data> RtmpPublisherStream::MakeVideoFramePacket(const std::shared_ptr<MediaPacket> &media_packet, bool *is_key_frame,
+																	const uint8_t **sps, size_t *sps_length, const uint8_t **pps, size_t *pps_length)
+{
+	// Use the const GetData() not to separate the payload shared with the other publishers
+	const MediaPacket &const_packet = *media_packet;
+	auto data = const_packet.GetData();
+	auto bitstream = data->GetDataAs<uint8_t>();
+
+	const FragmentationHeader *fragmentation = const_packet.GetFragHeader();
+	FragmentationHeader annexb_fragmentation;
+
+	if (fragmentation->GetCount() == 0)
+	{
+		AvcVideoPacketFragmentizer::MakeFragmentationHeader(bitstream, data->GetLength(), &annexb_fragmentation);
+		fragmentation = &annexb_fragmentation;
+	}
+
+	*sps = nullptr;
+	*sps_length = 0;
+	*pps = nullptr;
+	*pps_length = 0;
+
+	// Convert Annex-B to AVCC (4-byte NAL lengths) after the 5-byte tag header
+	auto body = std::make_shared<std::vector<uint8_t>>();
+	body->reserve(5 + data->GetLength() + (fragmentation->GetCount() * 4));
+	body->resize(5);
+
+	for (size_t index = 0; index < fragmentation->GetCount(); index++)
+	{
+		auto nal_offset = fragmentation->fragmentation_offset[index];
+		auto nal_length = fragmentation->fragmentation_length[index];
+
+		if ((nal_length == 0) || ((nal_offset + nal_length) > data->GetLength()))
+		{
+			continue;
+		}
+
+		auto nal = bitstream + nal_offset;
+
+		switch (nal[0] & 0x1F)
+		{
+			case 7:
+				// SPS goes into the sequence header
+				*sps = nal;
+				*sps_length = nal_length;
+				break;
+
+			case 8:
+				// PPS goes into the sequence header
+				*pps = nal;
+				*pps_length = nal_length;
+				break;
+
+			case 9:
+				// AUD is not used in FLV
+				break;
+
+			default:
+			{
+				uint8_t length_bytes[4];
+				RtmpMuxUtil::WriteInt32(length_bytes, static_cast<int>(nal_length));
+
+				body->insert(body->end(), length_bytes, length_bytes + sizeof(length_bytes));
+				body->insert(body->end(), nal, nal + nal_length);
+				break;
+			}
+		}
+	}
+
+	if (body->size() == 5)
+	{
+		// There is no frame
+		return nullptr;
+	}
+
+	*is_key_frame = (media_packet->GetFlag() == MediaPacketFlag::Key);
+	auto timestamp = ToRtmpTimestamp(_video_track, media_packet->GetDts());
+	auto composition_time = static_cast<int>((media_packet->GetPts() - media_packet->GetDts()) * _video_track->GetTimeBase().GetExpr() * 1000.0);
+
+	auto buffer = body->data();
+	buffer[0] = *is_key_frame ? RTMP_PUBLISHER_FLV_AVC_KEY_FRAME : RTMP_PUBLISHER_FLV_AVC_INTER_FRAME;
+	// AVCPacketType: AVC NALU
+	buffer[1] = 0x01;
+	RtmpMuxUtil::WriteInt24(buffer + 2, composition_time);
+
+	return MakeChunks(RTMP_PUBLISHER_CHUNK_STREAM_ID_VIDEO, RTMP_MSGID_VIDEO_MESSAGE, timestamp, body);
+}
+
+std::shared_ptr<ov::Data> RtmpPublisherStream::MakeAudioFramePacket(const std::shared_ptr<MediaPacket> &media_packet, uint8_t *config_buffer,
+																	const uint8_t **config, size_t *config_length)
+{
+	const MediaPacket &const_packet = *media_packet;
+	auto data = const_packet.GetData();
+	auto raw = data->GetDataAs<uint8_t>();
+	size_t raw_length = data->GetLength();
+
+	*config = nullptr;
+	*config_length = 0;
+
+	auto &codec_extradata = _audio_track->GetCodecExtradata();
+
+	if ((raw_length >= 7) && (raw[0] == 0xFF) && ((raw[1] & 0xF0) == 0xF0))
+	{
+		// Strip the ADTS header
+		size_t header_length = (raw[1] & 0x01) ? 7 : 9;
+
+		if (raw_length <= header_length)
+		{
+			return nullptr;
+		}
+
+		if (codec_extradata.empty())
+		{
+			// Make the AudioSpecificConfig from the ADTS header (such as the frames of the encoder)
+			uint8_t object_type = ((raw[2] >> 6) & 0x03) + 1;
+			uint8_t sampling_frequency_index = (raw[2] >> 2) & 0x0F;
+			uint8_t channel_configuration = ((raw[2] & 0x01) << 2) | ((raw[3] >> 6) & 0x03);
+
+			config_buffer[0] = (object_type << 3) | (sampling_frequency_index >> 1);
+			config_buffer[1] = ((sampling_frequency_index & 0x01) << 7) | (channel_configuration << 3);
+
+			*config = config_buffer;
+			*config_length = 2;
+		}
+
+		raw += header_length;
+		raw_length -= header_length;
+	}
+
+	if (codec_extradata.empty() == false)
+	{
+		// The extradata is the AudioSpecificConfig of the sequence header (such as RTMP ingest), so the ADTS header is not parsed
+		*config = codec_extradata.data();
+		*config_length = codec_extradata.size();
+	}
+
+	auto body = std::make_shared<std::vector<uint8_t>>(2 + raw_length);
+	auto buffer = body->data();
+
+	buffer[0] = RTMP_PUBLISHER_FLV_AAC;
+	// AACPacketType: AAC raw
+	buffer[1] = 0x01;
+	::memcpy(buffer + 2, raw, raw_length);
+
+	return MakeChunks(RTMP_PUBLISHER_CHUNK_STREAM_ID_AUDIO, RTMP_MSGID_AUDIO_MESSAGE, ToRtmpTimestamp(_audio_track, media_packet->GetDts()), body);
+}
+
+void RtmpPublisherStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if ((_video_track == nullptr) || (media_packet->GetTrackId() != static_cast<int32_t>(_video_track->GetId())))
+	{
+		return;
+	}
+
+	bool is_key_frame = false;
+	const uint8_t *sps = nullptr;
+	size_t sps_length = 0;
+	const uint8_t *pps = nullptr;
+	size_t pps_length = 0;
+
+	auto packet = MakeVideoFramePacket(media_packet, &is_key_frame, &sps, &sps_length, &pps, &pps_length);
+
+	if ((sps != nullptr) && (pps != nullptr) &&
+		((_last_sps.size() != sps_length) || (::memcmp(_last_sps.data(), sps, sps_length) != 0) ||
+		 (_last_pps.size() != pps_length) || (::memcmp(_last_pps.data(), pps, pps_length) != 0)))
+	{
+		auto sequence_header_packet = MakeVideoSequenceHeaderPacket(sps, sps_length, pps, pps_length);
+
+		if (sequence_header_packet != nullptr)
+		{
+			_last_sps.assign(sps, sps + sps_length);
+			_last_pps.assign(pps, pps + pps_length);
+
+			{
+				std::lock_guard<std::shared_mutex> lock_guard(_header_packet_lock);
+				_video_sequence_header_packet = sequence_header_packet;
+			}
+
+			// The sessions already playing receive the new sequence header before the next key frame
+			BroadcastPacket(static_cast<uint32_t>(RtmpPublisherPacketType::Video), sequence_header_packet->Clone());
+		}
+	}
+
+	if (packet != nullptr)
+	{
+		BroadcastPacket(static_cast<uint32_t>(is_key_frame ? RtmpPublisherPacketType::VideoKeyFrame : RtmpPublisherPacketType::Video), packet);
+	}
+}
+
+void RtmpPublisherStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if ((_audio_track == nullptr) || (media_packet->GetTrackId() != static_cast<int32_t>(_audio_track->GetId())))
+	{
+		return;
+	}
+
+	uint8_t audio_specific_config[2];
+	const uint8_t *config = nullptr;
+	size_t config_length = 0;
+
+	auto packet = MakeAudioFramePacket(media_packet, audio_specific_config, &config, &config_length);
+
+	if ((config != nullptr) &&
+		((_last_audio_specific_config.size() != config_length) || (::memcmp(_last_audio_specific_config.data(), config, config_length) != 0)))
+	{
+		auto sequence_header_packet = MakeAudioSequenceHeaderPacket(config, config_length);
+
+		if (sequence_header_packet != nullptr)
+		{
+			_last_audio_specific_config.assign(config, config + config_length);
+
+			{
+				std::lock_guard<std::shared_mutex> lock_guard(_header_packet_lock);
+				_audio_sequence_header_packet = sequence_header_packet;
+			}
+
+			BroadcastPacket(static_cast<uint32_t>(RtmpPublisherPacketType::Audio), sequence_header_packet->Clone());
+		}
+	}
+
+	if (_last_audio_specific_config.empty())
+	{
+		// The players cannot decode the frames without the sequence header
+		return;
+	}
+
+	if (packet != nullptr)
+	{
+		BroadcastPacket(static_cast<uint32_t>(RtmpPublisherPacketType::Audio), packet);
+	}
+}
+
+bool RtmpPublisherStream::PacketizeGopCache(const std::shared_ptr<pub::Session> &session, const std::vector<std::shared_ptr<MediaPacket>> &media_packets, std::vector<std::shared_ptr<pub::StreamPacket>> *packets)
+{
+	// The session sends the latest sequence headers before the first key frame (See RtmpPublisherSession::SendOutgoingData())
+	for (const auto &media_packet : media_packets)
+	{
+		std::shared_ptr<ov::Data> packet;
+		RtmpPublisherPacketType packet_type = RtmpPublisherPacketType::Video;
+
+		if ((_video_track != nullptr) && (media_packet->GetTrackId() == static_cast<int32_t>(_video_track->GetId())))
+		{
+			bool is_key_frame = false;
+			const uint8_t *sps = nullptr;
+			size_t sps_length = 0;
+			const uint8_t *pps = nullptr;
+			size_t pps_length = 0;
+
+			packet = MakeVideoFramePacket(media_packet, &is_key_frame, &sps, &sps_length, &pps, &pps_length);
+			packet_type = is_key_frame ? RtmpPublisherPacketType::VideoKeyFrame : RtmpPublisherPacketType::Video;
+		}
+		else if ((_audio_track != nullptr) && (_last_audio_specific_config.empty() == false) &&
+				 (media_packet->GetTrackId() == static_cast<int32_t>(_audio_track->GetId())))
+		{
+			uint8_t audio_specific_config[2];
+			const uint8_t *config = nullptr;
+			size_t config_length = 0;
+
+			packet = MakeAudioFramePacket(media_packet, audio_specific_config, &config, &config_length);
+			packet_type = RtmpPublisherPacketType::Audio;
+		}
+
+		if (packet != nullptr)
+		{
+			packets->push_back(std::make_shared<pub::StreamPacket>(static_cast<uint32_t>(packet_type), packet));
+		}
+	}
+
+	return packets->empty() == false;
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::GetMetadataPacket()
+{
+	std::shared_lock<std::shared_mutex> lock(_header_packet_lock);
+	return _metadata_packet;
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::GetVideoSequenceHeaderPacket()
+{
+	std::shared_lock<std::shared_mutex> lock(_header_packet_lock);
+	return _video_sequence_header_packet;
+}
+
+std::shared_ptr<const ov::Data> RtmpPublisherStream::GetAudioSequenceHeaderPacket()
+{
+	std::shared_lock<std::shared_mutex> lock(_header_packet_lock);
+	return _audio_sequence_header_packet;
+}
+
+bool RtmpPublisherStream::RemoveSessionByConnectorId(int connector_id)
+{
+	for (const auto &item : GetAllSessions())
+	{
+		auto session = std::static_pointer_cast<RtmpPublisherSession>(item.second);
+
+		if (session->GetConnectorId() == connector_id)
+		{
+			RemoveSession(session->GetId());
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,97 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/common_types.h>
+#include <base/publisher/stream.h>
+#include <providers/rtmp/chunk/rtmp_export_chunk.h>
+
+#include <shared_mutex>
+
+// All players of the publisher receive the chunks of this size, so the chunks of a tag are shared by all of them
+#define RTMP_PUBLISHER_CHUNK_SIZE 4096
+// The message stream id that is returned by createStream
+#define RTMP_PUBLISHER_STREAM_ID 1
+#define RTMP_PUBLISHER_CHUNK_STREAM_ID_AUDIO 4
+#define RTMP_PUBLISHER_CHUNK_STREAM_ID_DATA 5
+#define RTMP_PUBLISHER_CHUNK_STREAM_ID_VIDEO 6
+
+enum class RtmpPublisherPacketType : uint32_t
+{
+	Video,
+	VideoKeyFrame,
+	Audio
+};
+
+class RtmpPublisherStream : public pub::Stream
+{
+public:
+	static std::shared_ptr<RtmpPublisherStream> Create(const std::shared_ptr<pub::Application> application,
+													   const info::Stream &info,
+													   uint32_t worker_count);
+	explicit RtmpPublisherStream(const std::shared_ptr<pub::Application> application,
+								 const info::Stream &info);
+	~RtmpPublisherStream() final;
+
+	void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+	void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+
+	// Only the first H.264/AAC tracks are sent
+	bool IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track) override;
+
+	bool HasVideo() const
+	{
+		return _video_track != nullptr;
+	}
+
+	// Chunked onMetaData and the latest sequence headers, which are sent before the first frame of a new session
+	// (nullptr if not available yet)
+	std::shared_ptr<const ov::Data> GetMetadataPacket();
+	std::shared_ptr<const ov::Data> GetVideoSequenceHeaderPacket();
+	std::shared_ptr<const ov::Data> GetAudioSequenceHeaderPacket();
+
+	bool RemoveSessionByConnectorId(int connector_id);
+
+private:
+	bool Start(uint32_t worker_count) override;
+	bool Stop() override;
+
+	bool PacketizeGopCache(const std::shared_ptr<pub::Session> &session, const std::vector<std::shared_ptr<MediaPacket>> &media_packets, std::vector<std::shared_ptr<pub::StreamPacket>> *packets) override;
+
+	uint32_t ToRtmpTimestamp(const std::shared_ptr<MediaTrack> &track, int64_t timestamp) const;
+
+	// Serialize the frame into chunks (nullptr if there is nothing to send), the parameter sets point into the frame (or config_buffer)
+	std::shared_ptr<ov::Data> MakeVideoFramePacket(const std::shared_ptr<MediaPacket> &media_packet, bool *is_key_frame,
+												   const uint8_t **sps, size_t *sps_length, const uint8_t **pps, size_t *pps_length);
+	// config_buffer: 2 bytes to make the AudioSpecificConfig from the ADTS header
+	std::shared_ptr<ov::Data> MakeAudioFramePacket(const std::shared_ptr<MediaPacket> &media_packet, uint8_t *config_buffer,
+												   const uint8_t **config, size_t *config_length);
+
+	// Serialize the FLV tag body into chunks once, the result is shared by all sessions
+	std::shared_ptr<ov::Data> MakeChunks(uint32_t chunk_stream_id, uint8_t type_id, uint32_t timestamp, const std::shared_ptr<std::vector<uint8_t>> &body);
+
+	std::shared_ptr<const ov::Data> MakeMetadataPacket();
+	std::shared_ptr<const ov::Data> MakeVideoSequenceHeaderPacket(const uint8_t *sps, size_t sps_length, const uint8_t *pps, size_t pps_length);
+	std::shared_ptr<const ov::Data> MakeAudioSequenceHeaderPacket(const uint8_t *audio_specific_config, size_t length);
+
+	std::shared_ptr<MediaTrack> _video_track;
+	std::shared_ptr<MediaTrack> _audio_track;
+
+	std::mutex _export_chunk_lock;
+	std::shared_ptr<RtmpExportChunk> _export_chunk;
+
+	std::shared_mutex _header_packet_lock;
+	std::shared_ptr<const ov::Data> _metadata_packet;
+	std::shared_ptr<const ov::Data> _video_sequence_header_packet;
+	std::shared_ptr<const ov::Data> _audio_sequence_header_packet;
+
+	// To rebuild the sequence headers only when the parameter sets are changed
+	std::vector<uint8_t> _last_sps;
+	std::vector<uint8_t> _last_pps;
+	std::vector<uint8_t> _last_audio_specific_config;
+};
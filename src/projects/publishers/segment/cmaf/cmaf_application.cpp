@@ -37,6 +37,8 @@ CmafApplication::CmafApplication(const std::shared_ptr<pub::Publisher> &publishe
     _segment_count = publisher_info->GetSegmentCount();
     _segment_duration = publisher_info->GetSegmentDuration();
 	_chunked_transfer = chunked_transfer;
+
+	SetDirectDispatch(true);
 }
 
 //====================================================================================================
@@ -57,6 +59,8 @@ bool CmafApplication::Start()
 	
 	_segment_count = publisher_info->GetSegmentCount();
 	_segment_duration = publisher_info->GetSegmentDuration();
+	_segment_storage = SegmentStorage::Create(publisher_info->GetSegmentStoragePath());
+	_thumbnail_options = SegmentStream::GetThumbnailOptions(publisher_info->GetThumbnail());
 
 	return Application::Start();
 }
@@ -82,7 +86,9 @@ std::shared_ptr<pub::Stream> CmafApplication::CreateStream(const std::shared_ptr
                             GetSharedPtrAs<pub::Application>(),
                             *info.get(),
                             thread_count,
-							_chunked_transfer);
+							_chunked_transfer,
+							_segment_storage,
+							_thumbnail_options);
 }
 
 //====================================================================================================
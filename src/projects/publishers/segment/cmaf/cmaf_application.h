@@ -40,5 +40,8 @@ private :
     int _segment_duration;
 
 	std::shared_ptr<ICmafChunkedTransfer> _chunked_transfer = nullptr;
+	std::shared_ptr<SegmentStorage> _segment_storage;
+	// nullptr if <Thumbnail> is disabled
+	std::shared_ptr<const TranscodeThumbnail::Options> _thumbnail_options;
 
 };
@@ -28,10 +28,25 @@ bool CmafInterceptor::IsInterceptorForRequest(const std::shared_ptr<const HttpCl
 		(request_target.IndexOf(CMAF_MPD_VIDEO_FULL_SUFFIX) >= 0) ||
 		(request_target.IndexOf(CMAF_MPD_AUDIO_FULL_SUFFIX) >= 0) ||
 		(request_target.IndexOf(CMAF_PLAYLIST_FULL_FILE_NAME) >= 0) ||
+		(request_target.IndexOf(CMAF_HLS_VIDEO_PART_FULL_SUFFIX) >= 0) ||
+		(request_target.IndexOf(CMAF_HLS_AUDIO_PART_FULL_SUFFIX) >= 0) ||
+		(request_target.IndexOf(CMAF_HLS_PLAYLIST_FULL_SUFFIX) >= 0) ||
 		((_is_crossdomain_block == false) && request_target.IndexOf(DASH_CORS_FILE_NAME) >= 0))
 	{
 		return true;
 	}
 
 	return false;
-}
\ No newline at end of file
+}
+
+bool CmafWebSocketInterceptor::IsInterceptorForRequest(const std::shared_ptr<const HttpClient> &client)
+{
+	auto request_target = client->GetRequest()->GetRequestTarget().Split("?")[0];
+
+	if (request_target.HasSuffix(CMAF_WEB_SOCKET_FULL_SUFFIX) == false)
+	{
+		return false;
+	}
+
+	return WebSocketInterceptor::IsInterceptorForRequest(client);
+}
@@ -8,6 +8,7 @@
 //==============================================================================
 #pragma once
 
+#include <http_server/interceptors/web_socket/web_socket_interceptor.h>
 #include <publishers/segment/segment_stream/segment_stream_interceptor.h>
 
 class CmafInterceptor : public SegmentStreamInterceptor
@@ -18,3 +19,14 @@ public:
 	//--------------------------------------------------------------------
 	bool IsInterceptorForRequest(const std::shared_ptr<const HttpClient> &client) override;
 };
+
+// Accepts the WebSocket requests of fMP4 (<app>/<stream>/video_ll.ws, audio_ll.ws) only,
+// so it can share the port with the other WebSocket services
+class CmafWebSocketInterceptor : public WebSocketInterceptor
+{
+protected:
+	//--------------------------------------------------------------------
+	// Implementation of HttpRequestInterceptorInterface
+	//--------------------------------------------------------------------
+	bool IsInterceptorForRequest(const std::shared_ptr<const HttpClient> &client) override;
+};
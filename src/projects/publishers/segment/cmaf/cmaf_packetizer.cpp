@@ -11,6 +11,7 @@
 #include "cmaf_private.h"
 // TODO(dimiden): Merge DASH and CMAF module later
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <numeric>
 #include <sstream>
@@ -22,6 +23,11 @@
 #define CMAF_JITTER_CORRECTION_PER_ONCE 1000
 #define CMAF_JITTER_CORRECTION_INTERVAL 5000
 
+// The target duration of the LL-HLS partial segments (ms)
+#define CMAF_HLS_PART_TARGET_DURATION 500
+// The number of the latest completed segments whose parts are listed in the LL-HLS playlist
+#define CMAF_HLS_PART_SEGMENT_COUNT 2
+
 CmafPacketizer::CmafPacketizer(const ov::String &app_name, const ov::String &stream_name,
 							   PacketizerStreamType stream_type,
 							   const ov::String &segment_prefix,
@@ -44,7 +50,40 @@ CmafPacketizer::CmafPacketizer(const ov::String &app_name, const ov::String &str
 		_audio_chunk_writer = std::make_shared<CmafChunkWriter>(M4sMediaType::Audio, 2, _ideal_duration_for_audio);
 	}
 
-	_chunked_transfer = chunked_transfer;
+	std::atomic_store(&_chunked_transfer, chunked_transfer);
+
+	// The full segments are kept in the ring of DashPacketizer, so the playlist must not list more than it holds
+	_ll_hls_segment_count = std::max(std::min(segment_count, _segment_save_count - 1), 1U);
+
+	if (_video_track != nullptr)
+	{
+		_ll_hls_video_track.media_type = common::MediaType::Video;
+		_ll_hls_video_track.play_list_file_name = CMAF_HLS_VIDEO_PLAYLIST_FULL_FILE_NAME;
+		_ll_hls_video_track.init_file_name = CMAF_MPD_VIDEO_FULL_INIT_FILE_NAME;
+		_ll_hls_video_track.part_suffix = CMAF_HLS_VIDEO_PART_FULL_SUFFIX;
+		_ll_hls_video_track.scale = _video_scale;
+	}
+
+	if (_audio_track != nullptr)
+	{
+		_ll_hls_audio_track.media_type = common::MediaType::Audio;
+		_ll_hls_audio_track.play_list_file_name = CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME;
+		_ll_hls_audio_track.init_file_name = CMAF_MPD_AUDIO_FULL_INIT_FILE_NAME;
+		_ll_hls_audio_track.part_suffix = CMAF_HLS_AUDIO_PART_FULL_SUFFIX;
+		_ll_hls_audio_track.scale = _audio_scale;
+	}
+
+	UpdateLlHlsMasterPlayList();
+}
+
+CmafPacketizer::~CmafPacketizer()
+{
+	auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+	if (chunked_transfer != nullptr)
+	{
+		chunked_transfer->OnLlHlsFinished(_app_name, _stream_name);
+	}
 }
 
 ov::String CmafPacketizer::GetFileName(int64_t start_timestamp, common::MediaType media_type) const
@@ -82,10 +121,19 @@ bool CmafPacketizer::AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &fram
 	return AppendVideoFrameInternal(frame, _video_chunk_writer->GetSegmentDuration(), [this, frame](const std::shared_ptr<const SampleData> data, bool new_segment_written) {
 		auto chunk_data = _video_chunk_writer->AppendSample(data);
 
-		if (chunk_data != nullptr && _chunked_transfer != nullptr)
+		auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+		if (chunk_data != nullptr && chunked_transfer != nullptr)
 		{
 			// Response chunk data to HTTP client
-			_chunked_transfer->OnCmafChunkDataPush(_app_name, _stream_name, GetFileName(-1LL, common::MediaType::Video), true, chunk_data);
+			chunked_transfer->OnCmafChunkDataPush(_app_name, _stream_name, GetFileName(-1LL, common::MediaType::Video), true, chunk_data);
+		}
+
+		if (chunk_data != nullptr)
+		{
+			// sample_is_non_sync_sample is not set for the key frames
+			AppendLlHlsChunk(_ll_hls_video_track, _video_chunk_writer->GetSequenceNumber(), GetFileName(-1LL, common::MediaType::Video),
+							 data, (data->flag & 0x00010000) == 0, chunk_data);
 		}
 
 		_last_video_pts = data->timestamp;
@@ -102,10 +150,18 @@ bool CmafPacketizer::AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &fram
 	return AppendAudioFrameInternal(frame, _audio_chunk_writer->GetSegmentDuration(), [this, frame](const std::shared_ptr<const SampleData> data, bool new_segment_written) {
 		auto chunk_data = _audio_chunk_writer->AppendSample(data);
 
-		if (chunk_data != nullptr && _chunked_transfer != nullptr)
+		auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+		if (chunk_data != nullptr && chunked_transfer != nullptr)
 		{
 			// Response chunk data to HTTP client
-			_chunked_transfer->OnCmafChunkDataPush(_app_name, _stream_name, GetFileName(-1LL, common::MediaType::Audio), false, chunk_data);
+			chunked_transfer->OnCmafChunkDataPush(_app_name, _stream_name, GetFileName(-1LL, common::MediaType::Audio), false, chunk_data);
+		}
+
+		if (chunk_data != nullptr)
+		{
+			AppendLlHlsChunk(_ll_hls_audio_track, _audio_chunk_writer->GetSequenceNumber(), GetFileName(-1LL, common::MediaType::Audio),
+							 data, true, chunk_data);
 		}
 
 		_last_audio_pts = data->timestamp;
@@ -141,9 +197,13 @@ bool CmafPacketizer::WriteVideoSegment()
 
 	_duration_delta_for_video += (_ideal_duration_for_video - segment_duration);
 
-	if (_chunked_transfer != nullptr)
+	FlushLlHlsPart(_ll_hls_video_track, true, (segment_duration * _video_scale) / 1000.0);
+
+	auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+	if (chunked_transfer != nullptr)
 	{
-		_chunked_transfer->OnCmafChunkedComplete(_app_name, _stream_name, file_name, true);
+		chunked_transfer->OnCmafChunkedComplete(_app_name, _stream_name, file_name, true);
 	}
 
 	return true;
@@ -173,9 +233,13 @@ bool CmafPacketizer::WriteAudioSegment()
 
 	_duration_delta_for_audio += (_ideal_duration_for_audio - segment_duration);
 
-	if (_chunked_transfer != nullptr)
+	FlushLlHlsPart(_ll_hls_audio_track, true, (segment_duration * _audio_scale) / 1000.0);
+
+	auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+	if (chunked_transfer != nullptr)
 	{
-		_chunked_transfer->OnCmafChunkedComplete(_app_name, _stream_name, file_name, false);
+		chunked_transfer->OnCmafChunkedComplete(_app_name, _stream_name, file_name, false);
 	}
 
 	return true;
@@ -283,10 +347,6 @@ void CmafPacketizer::DoJitterCorrection()
 
 bool CmafPacketizer::UpdatePlayList()
 {
-	std::ostringstream play_list_stream;
-	double time_shift_buffer_depth = 6;
-	double minimumUpdatePeriod = _segment_duration;
-
 	if (IsReadyForStreaming() == false)
 	{
 		return false;
@@ -294,10 +354,30 @@ bool CmafPacketizer::UpdatePlayList()
 
 	DoJitterCorrection();
 
+	// The segments are not listed ($Number$), so the MPDs are changed only by the jitter correction or the new tracks
+	auto ll_mpd = MakeMpd(DASH_MPD_PUBLISH_TIME_PLACEHOLDER, true);
+
+	if (IsTemplateMpdChanged(ll_mpd) == false)
+	{
+		return true;
+	}
+
 	ov::String publish_time = MakeUtcSecond(::time(nullptr));
 
 	logtd("Trying to update playlist for CMAF with availabilityStartTime: %s, publishTime: %s", _start_time.CStr(), publish_time.CStr());
 
+	SetPlayList(ll_mpd.Replace(DASH_MPD_PUBLISH_TIME_PLACEHOLDER, publish_time));
+	std::atomic_store(&_dash_play_list, std::shared_ptr<const PlayListData>(MakePlayList(MakeMpd(publish_time, false))));
+
+	return true;
+}
+
+ov::String CmafPacketizer::MakeMpd(const ov::String &publish_time, bool is_low_latency) const
+{
+	std::ostringstream play_list_stream;
+	double time_shift_buffer_depth = 6;
+	double minimumUpdatePeriod = DASH_MPD_TEMPLATE_MINIMUM_UPDATE_PERIOD;
+
 	play_list_stream
 		<< std::fixed << std::setprecision(3)
 		<< "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
@@ -336,10 +416,24 @@ bool CmafPacketizer::UpdatePlayList()
 			<< "\" par=\"" << _pixel_aspect_ratio << "\" frameRate=\"" << _video_track->GetFrameRate()
 			<< "\" segmentAlignment=\"true\" startWithSAP=\"1\" subsegmentAlignment=\"true\" subsegmentStartsWithSAP=\"1\">\n"
 			<< "\t\t\t<SegmentTemplate presentationTimeOffset=\"0\" timescale=\"" << static_cast<uint32_t>(_video_track->GetTimeBase().GetTimescale())
-			<< "\" duration=\"" << static_cast<uint32_t>(_segment_duration * _video_track->GetTimeBase().GetTimescale())
-			<< "\" availabilityTimeOffset=\"" << availability_time_offset
-			<< "\" startNumber=\"0\" initialization=\"" << CMAF_MPD_VIDEO_FULL_INIT_FILE_NAME
-			<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << CMAF_MPD_VIDEO_FULL_SUFFIX << "\" />\n"
+			<< "\" duration=\"" << static_cast<uint32_t>(_segment_duration * _video_track->GetTimeBase().GetTimescale());
+
+		if (is_low_latency)
+		{
+			play_list_stream
+				<< "\" availabilityTimeOffset=\"" << availability_time_offset
+				<< "\" startNumber=\"0\" initialization=\"" << CMAF_MPD_VIDEO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << CMAF_MPD_VIDEO_FULL_SUFFIX << "\" />\n";
+		}
+		else
+		{
+			// DASH view: the same segments are served with the names of DASH
+			play_list_stream
+				<< "\" startNumber=\"0\" initialization=\"" << DASH_MPD_VIDEO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << DASH_MPD_VIDEO_FULL_SUFFIX << "\" />\n";
+		}
+
+		play_list_stream
 			<< "\t\t\t<Representation codecs=\"avc1.42401f\" sar=\"1:1\" "
 			<< "bandwidth=\"" << _video_track->GetBitrate() << "\" />\n"
 			<< "\t\t</AdaptationSet>\n";
@@ -356,10 +450,23 @@ bool CmafPacketizer::UpdatePlayList()
 			<< "\t\t\t<AudioChannelConfiguration schemeIdUri=\"urn:mpeg:dash:23003:3:audio_channel_configuration:2011\" "
 			<< "value=\"" << _audio_track->GetChannel().GetCounts() << "\"/>\n"
 			<< "\t\t\t<SegmentTemplate presentationTimeOffset=\"0\" timescale=\"" << static_cast<uint32_t>(_audio_track->GetTimeBase().GetTimescale())
-			<< "\" duration=\"" << static_cast<uint32_t>(_segment_duration * _audio_track->GetTimeBase().GetTimescale())
-			<< "\" availabilityTimeOffset=\"" << availability_time_offset
-			<< "\" startNumber=\"0\" initialization=\"" << CMAF_MPD_AUDIO_FULL_INIT_FILE_NAME
-			<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << CMAF_MPD_AUDIO_FULL_SUFFIX << "\" />\n"
+			<< "\" duration=\"" << static_cast<uint32_t>(_segment_duration * _audio_track->GetTimeBase().GetTimescale());
+
+		if (is_low_latency)
+		{
+			play_list_stream
+				<< "\" availabilityTimeOffset=\"" << availability_time_offset
+				<< "\" startNumber=\"0\" initialization=\"" << CMAF_MPD_AUDIO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << CMAF_MPD_AUDIO_FULL_SUFFIX << "\" />\n";
+		}
+		else
+		{
+			play_list_stream
+				<< "\" startNumber=\"0\" initialization=\"" << DASH_MPD_AUDIO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << DASH_MPD_AUDIO_FULL_SUFFIX << "\" />\n";
+		}
+
+		play_list_stream
 			<< "\t\t\t<Representation codecs=\"mp4a.40.2\" audioSamplingRate=\"" << _audio_track->GetSampleRate()
 			<< "\" bandwidth=\"" << _audio_track->GetBitrate() << "\" />\n"
 			<< "\t\t</AdaptationSet>\n";
@@ -369,9 +476,417 @@ bool CmafPacketizer::UpdatePlayList()
 					 //  << "\t<UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:direct:2014\" value=\"%s\"/>\n"
 					 << "</MPD>\n";
 
-	ov::String play_list = play_list_stream.str().c_str();
+	return play_list_stream.str().c_str();
+}
 
-	SetPlayList(play_list);
+bool CmafPacketizer::ParseLlHlsPartFileName(const ov::String &file_name, common::MediaType *media_type, int64_t *msn, int64_t *part)
+{
+	const char *suffix = nullptr;
+
+	if (file_name.HasSuffix(CMAF_HLS_VIDEO_PART_FULL_SUFFIX))
+	{
+		*media_type = common::MediaType::Video;
+		suffix = CMAF_HLS_VIDEO_PART_FULL_SUFFIX;
+	}
+	else if (file_name.HasSuffix(CMAF_HLS_AUDIO_PART_FULL_SUFFIX))
+	{
+		*media_type = common::MediaType::Audio;
+		suffix = CMAF_HLS_AUDIO_PART_FULL_SUFFIX;
+	}
+	else
+	{
+		return false;
+	}
+
+	// <prefix>_<msn>_<part>
+	auto name = file_name.Substring(0, file_name.GetLength() - ::strlen(suffix));
+	int64_t numbers[2];
+
+	for (int index = 1; index >= 0; index--)
+	{
+		auto position = name.IndexOfRev('_');
+
+		if (position <= 0)
+		{
+			return false;
+		}
+
+		char *end = nullptr;
+		auto number_string = name.CStr() + position + 1;
+		numbers[index] = ::strtoll(number_string, &end, 10);
+
+		if ((end == number_string) || (*end != '\0') || (numbers[index] < 0LL))
+		{
+			return false;
+		}
+
+		name = name.Substring(0, position);
+	}
+
+	*msn = numbers[0];
+	*part = numbers[1];
 
 	return true;
 }
+
+ov::String CmafPacketizer::GetLlHlsPartFileName(const LlHlsTrack &track, int64_t msn, size_t part_index) const
+{
+	return ov::String::FormatString("%s_%lld_%zu%s", _segment_prefix.CStr(), msn, part_index, track.part_suffix);
+}
+
+void CmafPacketizer::AppendLlHlsChunk(LlHlsTrack &track, int64_t msn, const ov::String &file_name,
+									  const std::shared_ptr<const SampleData> &sample, bool independent, const std::shared_ptr<ov::Data> &chunk_data)
+{
+	if ((track.current_segment != nullptr) && (track.current_segment->msn != msn))
+	{
+		// The segment is not completed by WriteSegment() (it should not happen)
+		logtw("[%s/%s] The LL-HLS segment %lld is replaced by %lld", _app_name.CStr(), _stream_name.CStr(), track.current_segment->msn, msn);
+		FlushLlHlsPart(track, true);
+	}
+
+	if (track.current_segment == nullptr)
+	{
+		auto segment = std::make_shared<LlHlsSegment>();
+
+		segment->msn = msn;
+		segment->file_name = file_name;
+
+		std::lock_guard<std::mutex> lock_guard(_ll_hls_mutex);
+		track.current_segment = segment;
+	}
+
+	int64_t sample_end_timestamp = sample->timestamp + static_cast<int64_t>(sample->duration);
+
+	// A part must not be longer than the part target
+	if ((track.part_data != nullptr) && (((sample_end_timestamp - track.part_start_timestamp) * track.scale) > CMAF_HLS_PART_TARGET_DURATION))
+	{
+		FlushLlHlsPart(track, false);
+	}
+
+	if (track.part_data == nullptr)
+	{
+		track.part_data = std::make_shared<ov::Data>(chunk_data->GetLength() * 16);
+		track.part_start_timestamp = sample->timestamp;
+		track.part_independent = independent;
+	}
+
+	track.part_data->Append(chunk_data.get());
+	track.part_end_timestamp = sample_end_timestamp;
+
+	if (((track.part_end_timestamp - track.part_start_timestamp) * track.scale) >= CMAF_HLS_PART_TARGET_DURATION)
+	{
+		FlushLlHlsPart(track, false);
+	}
+}
+
+void CmafPacketizer::FlushLlHlsPart(LlHlsTrack &track, bool complete_segment, double segment_duration)
+{
+	if (track.current_segment == nullptr)
+	{
+		return;
+	}
+
+	LlHlsPart part;
+
+	if (track.part_data != nullptr)
+	{
+		auto &segment = track.current_segment;
+		auto part_duration = track.part_end_timestamp - track.part_start_timestamp;
+
+		part.duration = (part_duration * track.scale) / 1000.0;
+		part.independent = track.part_independent;
+		part.segment = std::make_shared<SegmentData>(track.media_type, static_cast<int>(segment->msn),
+													 GetLlHlsPartFileName(track, segment->msn, segment->parts.size()),
+													 track.part_start_timestamp, static_cast<uint64_t>(part_duration),
+													 track.part_data);
+
+		track.part_data = nullptr;
+		track.part_start_timestamp = -1LL;
+		track.part_end_timestamp = -1LL;
+	}
+	else if (complete_segment == false)
+	{
+		// Nothing to flush
+		return;
+	}
+
+	std::shared_ptr<const PlayListData> play_list;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_ll_hls_mutex);
+
+		if (part.segment != nullptr)
+		{
+			track.current_segment->parts.push_back(part);
+		}
+
+		if (complete_segment)
+		{
+			if (segment_duration <= 0.0)
+			{
+				segment_duration = std::accumulate(track.current_segment->parts.begin(), track.current_segment->parts.end(), 0.0,
+												   [](double sum, const LlHlsPart &part) -> double { return sum + part.duration; });
+			}
+
+			track.current_segment->duration = segment_duration;
+			track.segments.push_back(track.current_segment);
+			track.current_segment = nullptr;
+
+			while (track.segments.size() > _ll_hls_segment_count)
+			{
+				track.segments.pop_front();
+			}
+
+			// The parts of the old segments are not listed anymore
+			if (track.segments.size() > CMAF_HLS_PART_SEGMENT_COUNT)
+			{
+				track.segments[track.segments.size() - CMAF_HLS_PART_SEGMENT_COUNT - 1]->parts.clear();
+			}
+		}
+
+		UpdateLlHlsPlayList(track);
+		play_list = track.play_list;
+	}
+
+	auto chunked_transfer = std::atomic_load(&_chunked_transfer);
+
+	if (chunked_transfer != nullptr)
+	{
+		chunked_transfer->OnLlHlsPartAdded(_app_name, _stream_name, track.play_list_file_name, play_list, part.segment);
+	}
+}
+
+void CmafPacketizer::UpdateLlHlsPlayList(LlHlsTrack &track)
+{
+	std::ostringstream play_list_stream;
+	double part_target = CMAF_HLS_PART_TARGET_DURATION / 1000.0;
+	double max_duration = _segment_duration;
+
+	for (auto &segment : track.segments)
+	{
+		max_duration = std::max(max_duration, segment->duration);
+	}
+
+	auto target_duration = static_cast<int64_t>(std::ceil(max_duration));
+	auto &first_segment = track.segments.empty() ? track.current_segment : track.segments.front();
+
+	play_list_stream
+		<< std::fixed << std::setprecision(3)
+		<< "#EXTM3U\n"
+		<< "#EXT-X-VERSION:6\n"
+		<< "#EXT-X-TARGETDURATION:" << target_duration << "\n"
+		<< "#EXT-X-SERVER-CONTROL:CAN-BLOCK-RELOAD=YES,PART-HOLD-BACK=" << (part_target * 3.0) << "\n"
+		<< "#EXT-X-PART-INF:PART-TARGET=" << part_target << "\n"
+		<< "#EXT-X-MEDIA-SEQUENCE:" << first_segment->msn << "\n"
+		<< "#EXT-X-MAP:URI=\"" << track.init_file_name << "\"\n";
+
+	auto write_parts = [&play_list_stream](const std::shared_ptr<LlHlsSegment> &segment) {
+		for (auto &part : segment->parts)
+		{
+			play_list_stream
+				<< "#EXT-X-PART:DURATION=" << part.duration
+				<< ",URI=\"" << part.segment->file_name.CStr() << "\""
+				<< (part.independent ? ",INDEPENDENT=YES" : "") << "\n";
+		}
+	};
+
+	for (auto &segment : track.segments)
+	{
+		write_parts(segment);
+
+		play_list_stream
+			<< "#EXTINF:" << segment->duration << ",\n"
+			<< segment->file_name.CStr() << "\n";
+	}
+
+	int64_t last_msn;
+	int64_t last_part;
+
+	if (track.current_segment != nullptr)
+	{
+		write_parts(track.current_segment);
+
+		last_msn = track.current_segment->msn;
+		last_part = static_cast<int64_t>(track.current_segment->parts.size()) - 1LL;
+	}
+	else
+	{
+		last_msn = track.segments.back()->msn + 1LL;
+		last_part = -1LL;
+	}
+
+	play_list_stream << "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"" << GetLlHlsPartFileName(track, last_msn, static_cast<size_t>(last_part + 1LL)).CStr() << "\"\n";
+
+	auto play_list = MakePlayList(play_list_stream.str().c_str());
+
+	play_list->last_msn = last_msn;
+	play_list->last_part = last_part;
+	play_list->max_blocking_time_ms = target_duration * 3LL * 1000LL;
+
+	track.play_list = play_list;
+}
+
+void CmafPacketizer::UpdateLlHlsMasterPlayList()
+{
+	std::ostringstream play_list_stream;
+	int64_t bandwidth = 0LL;
+	std::vector<ov::String> codecs;
+
+	play_list_stream
+		<< "#EXTM3U\n"
+		<< "#EXT-X-VERSION:6\n"
+		<< "#EXT-X-INDEPENDENT-SEGMENTS\n";
+
+	if (_video_track != nullptr)
+	{
+		bandwidth += _video_track->GetBitrate();
+		codecs.emplace_back("avc1.42401f");
+	}
+
+	if (_audio_track != nullptr)
+	{
+		bandwidth += _audio_track->GetBitrate();
+		codecs.emplace_back("mp4a.40.2");
+	}
+
+	// The audio is a separate rendition of the video (the tracks have their own init segments)
+	bool has_audio_group = (_video_track != nullptr) && (_audio_track != nullptr);
+
+	if (has_audio_group)
+	{
+		play_list_stream
+			<< "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"audio\",NAME=\"audio\",DEFAULT=YES,AUTOSELECT=YES,URI=\""
+			<< CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME << "\"\n";
+	}
+
+	play_list_stream << "#EXT-X-STREAM-INF:BANDWIDTH=" << bandwidth << ",CODECS=\"" << ov::String::Join(codecs, ",").CStr() << "\"";
+
+	if (_video_track != nullptr)
+	{
+		play_list_stream << ",RESOLUTION=" << _video_track->GetWidth() << "x" << _video_track->GetHeight();
+	}
+
+	if (has_audio_group)
+	{
+		play_list_stream << ",AUDIO=\"audio\"";
+	}
+
+	play_list_stream
+		<< "\n"
+		<< ((_video_track != nullptr) ? CMAF_HLS_VIDEO_PLAYLIST_FULL_FILE_NAME : CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME) << "\n";
+
+	_ll_hls_master_play_list = MakePlayList(play_list_stream.str().c_str());
+}
+
+const std::shared_ptr<SegmentData> CmafPacketizer::GetSegmentData(const ov::String &file_name)
+{
+	common::MediaType media_type;
+	int64_t msn;
+	int64_t part;
+
+	if (ParseLlHlsPartFileName(file_name, &media_type, &msn, &part) == false)
+	{
+		return DashPacketizer::GetSegmentData(file_name);
+	}
+
+	if (IsReadyForStreaming() == false)
+	{
+		return nullptr;
+	}
+
+	auto &track = (media_type == common::MediaType::Video) ? _ll_hls_video_track : _ll_hls_audio_track;
+
+	std::lock_guard<std::mutex> lock_guard(_ll_hls_mutex);
+
+	auto find_part = [&](const std::shared_ptr<LlHlsSegment> &segment) -> std::shared_ptr<SegmentData> {
+		if ((segment == nullptr) || (segment->msn != msn) || (part >= static_cast<int64_t>(segment->parts.size())))
+		{
+			return nullptr;
+		}
+
+		auto &part_segment = segment->parts[part].segment;
+
+		return (part_segment->file_name == file_name) ? part_segment : nullptr;
+	};
+
+	if ((track.current_segment != nullptr) && (track.current_segment->msn == msn))
+	{
+		return find_part(track.current_segment);
+	}
+
+	for (auto segment = track.segments.rbegin(); segment != track.segments.rend(); ++segment)
+	{
+		if ((*segment)->msn == msn)
+		{
+			return find_part(*segment);
+		}
+	}
+
+	return nullptr;
+}
+
+bool CmafPacketizer::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
+{
+	if (file_name.HasSuffix(CMAF_HLS_PLAYLIST_FULL_SUFFIX) == false)
+	{
+		return DashPacketizer::GetPlayList(file_name, play_list);
+	}
+
+	if (IsReadyForStreaming() == false)
+	{
+		logtd("A LL-HLS playlist was requested before the stream began");
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock_guard(_ll_hls_mutex);
+
+	if (file_name == CMAF_HLS_PLAYLIST_FULL_FILE_NAME)
+	{
+		*play_list = _ll_hls_master_play_list;
+	}
+	else if ((file_name == CMAF_HLS_VIDEO_PLAYLIST_FULL_FILE_NAME) && (_video_track != nullptr))
+	{
+		*play_list = _ll_hls_video_track.play_list;
+	}
+	else if ((file_name == CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME) && (_audio_track != nullptr))
+	{
+		*play_list = _ll_hls_audio_track.play_list;
+	}
+	else
+	{
+		*play_list = nullptr;
+	}
+
+	return (*play_list != nullptr);
+}
+
+bool CmafPacketizer::AcquireFeeder(const void *feeder)
+{
+	const void *current_feeder = nullptr;
+
+	return _feeder.compare_exchange_strong(current_feeder, feeder) || (current_feeder == feeder);
+}
+
+void CmafPacketizer::ReleaseFeeder(const void *feeder)
+{
+	const void *current_feeder = feeder;
+
+	_feeder.compare_exchange_strong(current_feeder, nullptr);
+}
+
+void CmafPacketizer::SetChunkedTransfer(const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer)
+{
+	std::atomic_store(&_chunked_transfer, chunked_transfer);
+}
+
+bool CmafPacketizer::GetDashPlayList(std::shared_ptr<const PlayListData> *play_list)
+{
+	if (IsReadyForStreaming() == false)
+	{
+		return false;
+	}
+
+	*play_list = std::atomic_load(&_dash_play_list);
+
+	return (*play_list != nullptr);
+}
@@ -10,6 +10,9 @@
 
 #include <publishers/segment/segment_stream/packetizer/cmaf_chunk_writer.h>
 
+#include <atomic>
+#include <deque>
+
 #include "../dash/dash_packetizer.h"
 
 class ICmafChunkedTransfer
@@ -24,6 +27,14 @@ public:
 	virtual void OnCmafChunkedComplete(const ov::String &app_name, const ov::String &stream_name,
 									   const ov::String &file_name,
 									   bool is_video) = 0;
+
+	// This callback will be called when a LL-HLS partial segment is added, with the playlist that contains it
+	virtual void OnLlHlsPartAdded(const ov::String &app_name, const ov::String &stream_name,
+								  const ov::String &play_list_file_name, const std::shared_ptr<const PlayListData> &play_list,
+								  const std::shared_ptr<SegmentData> &part) = 0;
+
+	// This callback will be called when the packetizer is released (the held requests cannot be satisfied anymore)
+	virtual void OnLlHlsFinished(const ov::String &app_name, const ov::String &stream_name) = 0;
 };
 
 class CmafPacketizer : public DashPacketizer
@@ -35,6 +46,7 @@ public:
 				   uint32_t segment_count, uint32_t segment_duration,
 				   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
 				   const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer);
+	~CmafPacketizer() override;
 
 	virtual const char *GetPacketizerName() const
 	{
@@ -56,7 +68,65 @@ public:
 	bool AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &frame) override;
 	bool AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &frame) override;
 
+	const std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) override;
+	bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list) override;
+
+	// <prefix>_<msn>_<part>_video_part_ll.m4s (or _audio_part_ll.m4s)
+	static bool ParseLlHlsPartFileName(const ov::String &file_name, common::MediaType *media_type, int64_t *msn, int64_t *part);
+
+	// The packetizer can be shared by the publishers of a stream (see CmafStreamPacketizer),
+	// and only one of them feeds the frames. Returns false if another one is feeding.
+	bool AcquireFeeder(const void *feeder);
+	void ReleaseFeeder(const void *feeder);
+
+	// The publisher that creates the packetizer might not have the chunked transfer (DASH)
+	void SetChunkedTransfer(const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer);
+
+	// MPD of DASH over the same segments (the segments are requested with the names of DASH)
+	bool GetDashPlayList(std::shared_ptr<const PlayListData> *play_list);
+
 protected:
+	struct LlHlsPart
+	{
+		std::shared_ptr<SegmentData> segment;
+		// Unit: second
+		double duration = 0.0;
+		// Starts with a key frame
+		bool independent = false;
+	};
+
+	struct LlHlsSegment
+	{
+		int64_t msn = 0LL;
+		ov::String file_name;
+		// Unit: second
+		double duration = 0.0;
+		std::vector<LlHlsPart> parts;
+	};
+
+	struct LlHlsTrack
+	{
+		common::MediaType media_type = common::MediaType::Unknown;
+		const char *play_list_file_name = nullptr;
+		const char *init_file_name = nullptr;
+		const char *part_suffix = nullptr;
+		// Milliseconds per timestamp unit
+		double scale = 0.0;
+
+		// The completed segments of the playlist
+		std::deque<std::shared_ptr<LlHlsSegment>> segments;
+		// The segment that is being created (nullptr if no sample is appended after the last segment)
+		std::shared_ptr<LlHlsSegment> current_segment;
+
+		// The chunks of the part that is being created
+		std::shared_ptr<ov::Data> part_data;
+		int64_t part_start_timestamp = -1LL;
+		int64_t part_end_timestamp = -1LL;
+		bool part_independent = false;
+
+		std::shared_ptr<const PlayListData> play_list;
+	};
+
 	//--------------------------------------------------------------------
 	// Override DashPacketizer
 	//--------------------------------------------------------------------
@@ -65,15 +135,38 @@ protected:
 	ov::String MakeJitterStatString(int64_t elapsed_time, int64_t current_time, int64_t jitter, int64_t adjusted_jitter, int64_t new_jitter_correction, int64_t video_delta, int64_t audio_delta, int64_t stream_delta) const;
 	void DoJitterCorrection();
 	bool UpdatePlayList() override;
+	ov::String MakeMpd(const ov::String &publish_time, bool is_low_latency) const;
+
+	ov::String GetLlHlsPartFileName(const LlHlsTrack &track, int64_t msn, size_t part_index) const;
+	// Appends the chunk (moof + mdat of a sample) to the current part, and closes the part if it reaches the part target
+	void AppendLlHlsChunk(LlHlsTrack &track, int64_t msn, const ov::String &file_name,
+						  const std::shared_ptr<const SampleData> &sample, bool independent, const std::shared_ptr<ov::Data> &chunk_data);
+	// Closes the current part, and the current segment too if complete_segment is true (segment_duration: in second)
+	void FlushLlHlsPart(LlHlsTrack &track, bool complete_segment, double segment_duration = 0.0);
+	// Called with _ll_hls_mutex
+	void UpdateLlHlsPlayList(LlHlsTrack &track);
+	void UpdateLlHlsMasterPlayList();
 
 private:
 	std::shared_ptr<CmafChunkWriter> _video_chunk_writer = nullptr;
 	std::shared_ptr<CmafChunkWriter> _audio_chunk_writer = nullptr;
 
+	// Accessed with std::atomic_load()/std::atomic_store()
 	std::shared_ptr<ICmafChunkedTransfer> _chunked_transfer = nullptr;
+	std::atomic<const void *> _feeder{nullptr};
+
+	std::shared_ptr<const PlayListData> _dash_play_list;
 
 	bool _is_first_video_frame = true;
 	bool _is_first_audio_frame = true;
 
 	int64_t _jitter_correction = 0LL;
+
+	// Used to serve the parts and the playlists to the HTTP threads
+	std::mutex _ll_hls_mutex;
+	LlHlsTrack _ll_hls_video_track;
+	LlHlsTrack _ll_hls_audio_track;
+	std::shared_ptr<const PlayListData> _ll_hls_master_play_list;
+	// The number of the completed segments in the media playlists
+	uint32_t _ll_hls_segment_count = 0U;
 };
\ No newline at end of file
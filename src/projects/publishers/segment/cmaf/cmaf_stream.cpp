@@ -20,11 +20,13 @@ std::shared_ptr<CmafStream> CmafStream::Create(int segment_count,
                                               const std::shared_ptr<pub::Application> application,
                                               const info::Stream &info,
                                               uint32_t worker_count,
-                                              const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer)
+                                              const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer,
+                                              const std::shared_ptr<SegmentStorage> &segment_storage,
+                                              const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options)
 {
     auto stream = std::make_shared<CmafStream>(application, info, chunked_transfer);
 
-    if (!stream->Start(segment_count, segment_duration, 0))
+    if (!stream->Start(segment_count, segment_duration, 0, segment_storage, thumbnail_options))
     {
         return nullptr;
     }
@@ -24,7 +24,9 @@ public:
                                                const std::shared_ptr<pub::Application> application,
                                                const info::Stream &info,
                                                uint32_t worker_count,
-                                               const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer);
+                                               const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer,
+                                               const std::shared_ptr<SegmentStorage> &segment_storage = nullptr,
+                                               const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options = nullptr);
 
     CmafStream(const std::shared_ptr<pub::Application> application,
     		const info::Stream &info,
@@ -40,6 +42,7 @@ public:
     {
         auto stream_packetizer = std::make_shared<CmafStreamPacketizer>(GetApplication()->GetName(),
                                                                         GetName(),
+                                                                        GetId(),
                                                                         segment_count,
                                                                         segment_duration,
                                                                         segment_prefix,
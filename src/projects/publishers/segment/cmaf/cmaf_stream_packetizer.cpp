@@ -10,32 +10,37 @@
 #include "cmaf_stream_packetizer.h"
 #include "cmaf_private.h"
 
+#include "../dash/dash_define.h"
+
+std::mutex CmafStreamPacketizer::_shared_packetizers_mutex;
+std::map<ov::String, CmafStreamPacketizer::SharedPacketizer> CmafStreamPacketizer::_shared_packetizers;
+
 //====================================================================================================
 // Constructor
 //====================================================================================================
 CmafStreamPacketizer::CmafStreamPacketizer(const ov::String &app_name,
 										   const ov::String &stream_name,
+										   uint32_t stream_id,
 										   int segment_count,
 										   int segment_duration,
 										   const ov::String &segment_prefix,
 										   PacketizerStreamType stream_type,
 										   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
-										   const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer)
+										   const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer,
+										   CmafPackagingView view)
 	: StreamPacketizer(app_name,
 					   stream_name,
 					   segment_count,
 					   segment_duration,
 					   stream_type,
-					   video_track, audio_track)
+					   video_track, audio_track),
+	  _view(view)
 {
-	_packetizer = std::make_shared<CmafPacketizer>(app_name,
-												   stream_name,
-												   stream_type,
-												   segment_prefix,
-												   segment_count,
-												   segment_duration,
-												   video_track, audio_track,
-												   chunked_transfer);
+	_cmaf_packetizer = AcquirePacketizer(app_name, stream_name, stream_id,
+										 segment_count, segment_duration, segment_prefix,
+										 stream_type, video_track, audio_track,
+										 chunked_transfer);
+	_packetizer = _cmaf_packetizer;
 }
 
 //====================================================================================================
@@ -43,6 +48,70 @@ CmafStreamPacketizer::CmafStreamPacketizer(const ov::String &app_name,
 //====================================================================================================
 CmafStreamPacketizer::~CmafStreamPacketizer()
 {
+	// Another publisher continues to feed the frames
+	_cmaf_packetizer->ReleaseFeeder(this);
+}
+
+std::shared_ptr<CmafPacketizer> CmafStreamPacketizer::AcquirePacketizer(const ov::String &app_name,
+																		const ov::String &stream_name,
+																		uint32_t stream_id,
+																		int segment_count,
+																		int segment_duration,
+																		const ov::String &segment_prefix,
+																		PacketizerStreamType stream_type,
+																		const std::shared_ptr<MediaTrack> &video_track, const std::shared_ptr<MediaTrack> &audio_track,
+																		const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer)
+{
+	auto key = ov::String::FormatString("%s/%s/%u", app_name.CStr(), stream_name.CStr(), stream_id);
+
+	std::lock_guard<std::mutex> lock_guard(_shared_packetizers_mutex);
+
+	// Remove the packetizers of the deleted streams
+	for (auto item = _shared_packetizers.begin(); item != _shared_packetizers.end();)
+	{
+		item = item->second.packetizer.expired() ? _shared_packetizers.erase(item) : std::next(item);
+	}
+
+	auto item = _shared_packetizers.find(key);
+
+	if (item != _shared_packetizers.end())
+	{
+		auto packetizer = item->second.packetizer.lock();
+
+		if (item->second.segment_duration == segment_duration)
+		{
+			logtd("[%s/%s] The CMAF packaging is shared", app_name.CStr(), stream_name.CStr());
+
+			if (chunked_transfer != nullptr)
+			{
+				packetizer->SetChunkedTransfer(chunked_transfer);
+			}
+
+			return packetizer;
+		}
+
+		logtw("[%s/%s] Could not share the CMAF packaging: the segment duration is different (%d != %d)",
+			  app_name.CStr(), stream_name.CStr(), item->second.segment_duration, segment_duration);
+	}
+
+	auto packetizer = std::make_shared<CmafPacketizer>(app_name,
+													   stream_name,
+													   stream_type,
+													   segment_prefix,
+													   segment_count,
+													   segment_duration,
+													   video_track, audio_track,
+													   chunked_transfer);
+
+	if (item == _shared_packetizers.end())
+	{
+		auto &shared_packetizer = _shared_packetizers[key];
+
+		shared_packetizer.packetizer = packetizer;
+		shared_packetizer.segment_duration = segment_duration;
+	}
+
+	return packetizer;
 }
 
 //====================================================================================================
@@ -50,6 +119,12 @@ CmafStreamPacketizer::~CmafStreamPacketizer()
 //====================================================================================================
 bool CmafStreamPacketizer::AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &data)
 {
+	if (_cmaf_packetizer->AcquireFeeder(this) == false)
+	{
+		// The frames are packaged by another publisher
+		return true;
+	}
+
 	return _packetizer->AppendVideoFrame(data);
 }
 
@@ -58,6 +133,11 @@ bool CmafStreamPacketizer::AppendVideoFrame(std::shared_ptr<PacketizerFrameData>
 //====================================================================================================
 bool CmafStreamPacketizer::AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &data)
 {
+	if (_cmaf_packetizer->AcquireFeeder(this) == false)
+	{
+		return true;
+	}
+
 	return _packetizer->AppendAudioFrame(data);
 }
 
@@ -65,9 +145,14 @@ bool CmafStreamPacketizer::AppendAudioFrame(std::shared_ptr<PacketizerFrameData>
 // Get PlayList
 // - MPD
 //====================================================================================================
-bool CmafStreamPacketizer::GetPlayList(ov::String &play_list)
+bool CmafStreamPacketizer::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
 {
-	return _packetizer->GetPlayList(play_list);
+	if (_view == CmafPackagingView::Dash)
+	{
+		return (file_name == DASH_PLAYLIST_FULL_FILE_NAME) ? _cmaf_packetizer->GetDashPlayList(play_list) : false;
+	}
+
+	return _packetizer->GetPlayList(file_name, play_list);
 }
 
 //====================================================================================================
@@ -76,5 +161,18 @@ bool CmafStreamPacketizer::GetPlayList(ov::String &play_list)
 //====================================================================================================
 std::shared_ptr<SegmentData> CmafStreamPacketizer::GetSegmentData(const ov::String &file_name)
 {
+	if (_view == CmafPackagingView::Dash)
+	{
+		// <prefix>_<number>_video.m4s => <prefix>_<number>_video_ll.m4s (init_video.m4s => init_video_ll.m4s)
+		if ((file_name.HasSuffix(DASH_MPD_VIDEO_FULL_SUFFIX) == false) && (file_name.HasSuffix(DASH_MPD_AUDIO_FULL_SUFFIX) == false))
+		{
+			return nullptr;
+		}
+
+		auto name_length = file_name.GetLength() - (sizeof(DASH_SEGMENT_EXT) - 1) - 1;
+
+		return _packetizer->GetSegmentData(file_name.Substring(0, name_length) + DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT);
+	}
+
 	return _packetizer->GetSegmentData(file_name);
 }
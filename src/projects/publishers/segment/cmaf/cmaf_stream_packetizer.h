@@ -11,17 +11,32 @@
 #include <publishers/segment/segment_stream/stream_packetizer.h>
 #include "cmaf_packetizer.h"
 
+#include <map>
+#include <mutex>
+
+enum class CmafPackagingView : int32_t
+{
+	// LLDASH (manifest_ll.mpd) and LL-HLS
+	LowLatency,
+	// DASH (manifest.mpd), the segments are served with the names of DASH
+	Dash,
+};
+
+// The CMAF packaging of a stream is shared by the segment publishers (LLDASH and DASH of the same segment duration),
+// so the frames are parsed and boxed only once and each publisher is a view over the same segments.
 class CmafStreamPacketizer : public StreamPacketizer
 {
 public:
     CmafStreamPacketizer(const ov::String &app_name,
 						const ov::String &stream_name,
+						uint32_t stream_id,
 						int segment_count,
 						int segment_duration,
 						const  ov::String &segment_prefix,
 						PacketizerStreamType stream_type,
 						std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
-						const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer);
+						const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer,
+						CmafPackagingView view = CmafPackagingView::LowLatency);
 
     virtual ~CmafStreamPacketizer();
 
@@ -30,10 +45,32 @@ public :
     // Implement StreamPacketizer Interface
     bool AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &data) override;
     bool AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &data) override;
-    bool GetPlayList(ov::String &play_list) override;
+    bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list) override;
 	std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) override;
 
 private :
+	struct SharedPacketizer
+	{
+		std::weak_ptr<CmafPacketizer> packetizer;
+		int segment_duration = 0;
+	};
+
+	// Returns the packetizer of the stream (created if there is no packetizer of the same segment duration)
+	static std::shared_ptr<CmafPacketizer> AcquirePacketizer(const ov::String &app_name,
+															 const ov::String &stream_name,
+															 uint32_t stream_id,
+															 int segment_count,
+															 int segment_duration,
+															 const ov::String &segment_prefix,
+															 PacketizerStreamType stream_type,
+															 const std::shared_ptr<MediaTrack> &video_track, const std::shared_ptr<MediaTrack> &audio_track,
+															 const std::shared_ptr<ICmafChunkedTransfer> &chunked_transfer);
+
+	CmafPackagingView _view;
+	std::shared_ptr<CmafPacketizer> _cmaf_packetizer;
 
+	static std::mutex _shared_packetizers_mutex;
+	// Key: [app name]/[stream name]/[stream id]
+	static std::map<ov::String, SharedPacketizer> _shared_packetizers;
 };
 
@@ -11,6 +11,438 @@
 #include "cmaf_packetizer.h"
 #include "cmaf_private.h"
 
+#include <orchestrator/orchestrator.h>
+
+#define CMAF_HLS_CONTENT_TYPE "application/vnd.apple.mpegurl"
+// The interval to check the expired LL-HLS requests (ms)
+#define CMAF_HLS_EXPIRE_CHECK_INTERVAL 100
+
+// Returns false if the value is not a number (value is not changed if the key does not exist)
+static bool ParseQueryNumber(const std::map<ov::String, ov::String> &query_map, const char *key, int64_t *value)
+{
+	auto item = query_map.find(key);
+
+	if (item == query_map.end())
+	{
+		return true;
+	}
+
+	char *end = nullptr;
+	auto number = ::strtoll(item->second.CStr(), &end, 10);
+
+	if ((end == item->second.CStr()) || (*end != '\0') || (number < 0LL))
+	{
+		return false;
+	}
+
+	*value = number;
+
+	return true;
+}
+
+CmafStreamServer::CmafStreamServer()
+{
+	_ll_hls_timer.Push(
+		[this](void *parameter) -> ov::DelayQueueAction {
+			ExpireLlHlsRequests();
+			return ov::DelayQueueAction::Repeat;
+		},
+		CMAF_HLS_EXPIRE_CHECK_INTERVAL);
+	_ll_hls_timer.Start();
+}
+
+CmafStreamServer::~CmafStreamServer()
+{
+	_ll_hls_timer.Stop();
+}
+
+std::shared_ptr<WebSocketInterceptor> CmafStreamServer::CreateWebSocketInterceptor()
+{
+	auto web_socket_interceptor = std::make_shared<CmafWebSocketInterceptor>();
+
+	web_socket_interceptor->SetConnectionHandler(
+		[this](const std::shared_ptr<WebSocketClient> &ws_client) -> HttpInterceptorResult {
+			return OnWebSocketConnected(ws_client);
+		});
+
+	// The players don't send any message
+	web_socket_interceptor->SetMessageHandler(
+		[](const std::shared_ptr<WebSocketClient> &ws_client, const std::shared_ptr<const WebSocketFrame> &message) -> HttpInterceptorResult {
+			return HttpInterceptorResult::Keep;
+		});
+
+	web_socket_interceptor->SetErrorHandler(
+		[this](const std::shared_ptr<WebSocketClient> &ws_client, const std::shared_ptr<const ov::Error> &error) {
+			OnWebSocketClosed(ws_client);
+		});
+
+	web_socket_interceptor->SetCloseHandler(
+		[this](const std::shared_ptr<WebSocketClient> &ws_client) {
+			OnWebSocketClosed(ws_client);
+		});
+
+	return web_socket_interceptor;
+}
+
+HttpConnection CmafStreamServer::ProcessStreamRequest(const std::shared_ptr<HttpClient> &client,
+													  const ov::String &app_name, const ov::String &stream_name,
+													  const ov::String &file_name, const ov::String &file_ext)
+{
+	if (file_ext == CMAF_HLS_PLAYLIST_EXT)
+	{
+		return ProcessLlHlsPlayListRequest(client, app_name, stream_name, file_name);
+	}
+
+	return DashStreamServer::ProcessStreamRequest(client, app_name, stream_name, file_name, file_ext);
+}
+
+HttpConnection CmafStreamServer::ProcessLlHlsPlayListRequest(const std::shared_ptr<HttpClient> &client,
+															 const ov::String &app_name, const ov::String &stream_name,
+															 const ov::String &file_name)
+{
+	auto response = client->GetResponse();
+
+	std::shared_ptr<const PlayListData> play_list;
+
+	auto item = std::find_if(_observers.begin(), _observers.end(),
+							 [&client, &app_name, &stream_name, &file_name, &play_list](auto &observer) -> bool {
+								 return observer->OnPlayListRequest(client, app_name, stream_name, file_name, play_list);
+							 });
+
+	if (item == _observers.end())
+	{
+		logtd("Could not find a LL-HLS playlist for [%s/%s], %s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		response->SetStatusCode(HttpStatusCode::NotFound);
+		response->Response();
+
+		return HttpConnection::Closed;
+	}
+
+	if ((response->GetStatusCode() != HttpStatusCode::OK) || (play_list == nullptr))
+	{
+		response->Response();
+		return HttpConnection::Closed;
+	}
+
+	// Blocking playlist reload
+	int64_t msn = -1LL;
+	int64_t part = -1LL;
+	auto parsed_url = ov::Url::Parse(client->GetRequest()->GetUri().CStr(), true);
+
+	if (parsed_url != nullptr)
+	{
+		auto &query_map = parsed_url->QueryMap();
+
+		if ((ParseQueryNumber(query_map, "_HLS_msn", &msn) == false) ||
+			(ParseQueryNumber(query_map, "_HLS_part", &part) == false) ||
+			((part >= 0LL) && (msn < 0LL)))
+		{
+			response->SetStatusCode(HttpStatusCode::BadRequest);
+			response->Response();
+
+			return HttpConnection::Closed;
+		}
+	}
+
+	// The master playlist is not updated
+	if ((msn < 0LL) || (play_list->last_msn < 0LL))
+	{
+		ResponsePlayList(client, play_list, CMAF_HLS_CONTENT_TYPE);
+		return HttpConnection::Closed;
+	}
+
+	{
+		auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+
+		std::unique_lock<std::mutex> lock(_ll_hls_guard);
+
+		// The playlist might be updated after it is obtained
+		auto latest_item = _ll_hls_play_lists.find(key);
+
+		if ((latest_item != _ll_hls_play_lists.end()) && IsLlHlsRequestSatisfied(*(latest_item->second), play_list->last_msn, play_list->last_part + 1LL))
+		{
+			play_list = latest_item->second;
+		}
+
+		if (IsLlHlsRequestSatisfied(*play_list, msn, part) == false)
+		{
+			if (msn > (play_list->last_msn + 2LL))
+			{
+				// Too far in the future
+				lock.unlock();
+
+				response->SetStatusCode(HttpStatusCode::BadRequest);
+				response->Response();
+
+				return HttpConnection::Closed;
+			}
+
+			LlHlsPendingRequest pending_request;
+
+			pending_request.client = client;
+			pending_request.msn = msn;
+			pending_request.part = part;
+			pending_request.expire_time = Packetizer::GetCurrentTick() + play_list->max_blocking_time_ms;
+
+			_ll_hls_pending_requests[key].push_back(std::move(pending_request));
+
+			return HttpConnection::KeepAlive;
+		}
+	}
+
+	ResponsePlayList(client, play_list, CMAF_HLS_CONTENT_TYPE);
+
+	return HttpConnection::Closed;
+}
+
+bool CmafStreamServer::HoldLlHlsPartRequest(const std::shared_ptr<HttpClient> &client,
+											const ov::String &app_name, const ov::String &stream_name,
+											const ov::String &file_name)
+{
+	common::MediaType media_type;
+	int64_t msn;
+	int64_t part;
+
+	if (CmafPacketizer::ParseLlHlsPartFileName(file_name, &media_type, &msn, &part) == false)
+	{
+		return false;
+	}
+
+	auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(),
+										(media_type == common::MediaType::Video) ? CMAF_HLS_VIDEO_PLAYLIST_FULL_FILE_NAME : CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME);
+
+	std::lock_guard<std::mutex> lock_guard(_ll_hls_guard);
+
+	auto item = _ll_hls_play_lists.find(key);
+
+	if (item == _ll_hls_play_lists.end())
+	{
+		// The stream does not exist (or is not started yet)
+		return false;
+	}
+
+	auto &play_list = item->second;
+
+	// Only the next part of the playlist (EXT-X-PRELOAD-HINT) is held
+	if ((IsLlHlsRequestSatisfied(*play_list, msn, part)) ||
+		(((msn == play_list->last_msn) && (part == (play_list->last_part + 1LL))) == false))
+	{
+		return false;
+	}
+
+	LlHlsPendingRequest pending_request;
+
+	pending_request.client = client;
+	pending_request.part_file_name = file_name;
+	pending_request.msn = msn;
+	pending_request.part = part;
+	pending_request.expire_time = Packetizer::GetCurrentTick() + play_list->max_blocking_time_ms;
+
+	_ll_hls_pending_requests[key].push_back(std::move(pending_request));
+
+	return true;
+}
+
+bool CmafStreamServer::IsLlHlsRequestSatisfied(const PlayListData &play_list, int64_t msn, int64_t part)
+{
+	if (part < 0LL)
+	{
+		// The whole segment is requested
+		return play_list.last_msn > msn;
+	}
+
+	return (play_list.last_msn > msn) || ((play_list.last_msn == msn) && (play_list.last_part >= part));
+}
+
+void CmafStreamServer::ResponseLlHlsPart(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<SegmentData> &part)
+{
+	auto response = client->GetResponse();
+
+	response->SetHeader("Content-Type", (part->media_type == common::MediaType::Video) ? "video/mp4" : "audio/mp4");
+	response->AppendData(part->data);
+	response->Response();
+}
+
+void CmafStreamServer::OnLlHlsPartAdded(const ov::String &app_name, const ov::String &stream_name,
+										const ov::String &play_list_file_name, const std::shared_ptr<const PlayListData> &play_list,
+										const std::shared_ptr<SegmentData> &part)
+{
+	auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(), play_list_file_name.CStr());
+
+	std::vector<std::shared_ptr<HttpClient>> play_list_clients;
+	std::vector<std::shared_ptr<HttpClient>> part_clients;
+	std::vector<std::shared_ptr<HttpClient>> not_found_clients;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_ll_hls_guard);
+
+		_ll_hls_play_lists[key] = play_list;
+
+		auto item = _ll_hls_pending_requests.find(key);
+
+		if (item == _ll_hls_pending_requests.end())
+		{
+			return;
+		}
+
+		auto &pending_requests = item->second;
+
+		for (auto request = pending_requests.begin(); request != pending_requests.end();)
+		{
+			if (request->part_file_name.IsEmpty())
+			{
+				if (IsLlHlsRequestSatisfied(*play_list, request->msn, request->part) == false)
+				{
+					++request;
+					continue;
+				}
+
+				play_list_clients.push_back(request->client);
+			}
+			else if ((part != nullptr) && (request->part_file_name == part->file_name))
+			{
+				part_clients.push_back(request->client);
+			}
+			else if (IsLlHlsRequestSatisfied(*play_list, request->msn, request->part))
+			{
+				// The segment is completed before the hinted part is created
+				not_found_clients.push_back(request->client);
+			}
+			else
+			{
+				++request;
+				continue;
+			}
+
+			request = pending_requests.erase(request);
+		}
+
+		if (pending_requests.empty())
+		{
+			_ll_hls_pending_requests.erase(item);
+		}
+	}
+
+	for (auto &client : play_list_clients)
+	{
+		ResponsePlayList(client, play_list, CMAF_HLS_CONTENT_TYPE);
+		CompleteDeferredResponse(client);
+	}
+
+	for (auto &client : part_clients)
+	{
+		ResponseLlHlsPart(client, part);
+		CompleteDeferredResponse(client);
+	}
+
+	for (auto &client : not_found_clients)
+	{
+		client->GetResponse()->SetStatusCode(HttpStatusCode::NotFound);
+		client->GetResponse()->Response();
+		CompleteDeferredResponse(client);
+	}
+}
+
+void CmafStreamServer::OnLlHlsFinished(const ov::String &app_name, const ov::String &stream_name)
+{
+	auto prefix = ov::String::FormatString("%s/%s/", app_name.CStr(), stream_name.CStr());
+	std::vector<std::shared_ptr<HttpClient>> clients;
+	std::vector<std::shared_ptr<WebSocketClient>> ws_clients;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_web_socket_guard);
+
+		for (auto item = _web_socket_tracks.lower_bound(prefix); (item != _web_socket_tracks.end()) && item->first.HasPrefix(prefix);)
+		{
+			auto track = item->second;
+
+			{
+				std::lock_guard<std::mutex> track_lock_guard(track->mutex);
+
+				for (auto &subscriber : track->subscribers)
+				{
+					ws_clients.push_back(subscriber.client);
+				}
+			}
+
+			item = _web_socket_tracks.erase(item);
+		}
+	}
+
+	// The players reconnect when the stream is created again
+	for (auto &ws_client : ws_clients)
+	{
+		ws_client->Close();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_ll_hls_guard);
+
+		for (auto item = _ll_hls_play_lists.lower_bound(prefix); (item != _ll_hls_play_lists.end()) && item->first.HasPrefix(prefix);)
+		{
+			item = _ll_hls_play_lists.erase(item);
+		}
+
+		for (auto item = _ll_hls_pending_requests.lower_bound(prefix); (item != _ll_hls_pending_requests.end()) && item->first.HasPrefix(prefix);)
+		{
+			for (auto &request : item->second)
+			{
+				clients.push_back(request.client);
+			}
+
+			item = _ll_hls_pending_requests.erase(item);
+		}
+	}
+
+	for (auto &client : clients)
+	{
+		client->GetResponse()->SetStatusCode(HttpStatusCode::NotFound);
+		client->GetResponse()->Response();
+		CompleteDeferredResponse(client);
+	}
+}
+
+void CmafStreamServer::ExpireLlHlsRequests()
+{
+	std::vector<LlHlsPendingRequest> expired_requests;
+	auto now = Packetizer::GetCurrentTick();
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_ll_hls_guard);
+
+		for (auto item = _ll_hls_pending_requests.begin(); item != _ll_hls_pending_requests.end();)
+		{
+			auto &pending_requests = item->second;
+
+			for (auto request = pending_requests.begin(); request != pending_requests.end();)
+			{
+				if (request->expire_time > now)
+				{
+					++request;
+					continue;
+				}
+
+				expired_requests.push_back(std::move(*request));
+				request = pending_requests.erase(request);
+			}
+
+			item = pending_requests.empty() ? _ll_hls_pending_requests.erase(item) : std::next(item);
+		}
+	}
+
+	for (auto &request : expired_requests)
+	{
+		auto response = request.client->GetResponse();
+
+		logtd("The LL-HLS request is expired: %s (msn: %lld, part: %lld)", response->GetRemote()->ToString().CStr(), request.msn, request.part);
+
+		// The playlist is not updated during 3 x target duration
+		response->SetStatusCode(request.part_file_name.IsEmpty() ? HttpStatusCode::ServiceUnavailable : HttpStatusCode::NotFound);
+		response->Response();
+		CompleteDeferredResponse(request.client);
+	}
+}
+
 HttpConnection CmafStreamServer::ProcessSegmentRequest(const std::shared_ptr<HttpClient> &client,
 												  const ov::String &app_name, const ov::String &stream_name,
 												  const ov::String &file_name,
@@ -24,16 +456,30 @@ HttpConnection CmafStreamServer::ProcessSegmentRequest(const std::shared_ptr<Htt
 	std::shared_ptr<SegmentData> segment = nullptr;
 
 	// Check if the requested file is being created
+	std::shared_ptr<CmafChunkedSegment> chunked_segment;
+
 	{
 		auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
 
 		std::unique_lock<std::mutex> lock(_http_chunk_guard);
 
 		auto chunk_item = _http_chunk_list.find(key);
+
 		if (chunk_item != _http_chunk_list.end())
+		{
+			chunked_segment = chunk_item->second;
+		}
+	}
+
+	if (chunked_segment != nullptr)
+	{
+		std::unique_lock<std::mutex> lock(chunked_segment->mutex);
+
+		// The segment might be completed after it is found, then it is served as a normal segment
+		if (chunked_segment->is_completed == false)
 		{
 			// The file is being created
-			logtd("Requested file is being created");
+			logtd("Requested file is being created (%zu chunks, %zu bytes)", chunked_segment->chunk_log.size(), chunked_segment->length);
 
 			// Set HTTP header
 			response->SetHeader("Content-Type", is_video ? "video/mp4" : "audio/mp4");
@@ -42,47 +488,332 @@ HttpConnection CmafStreamServer::ProcessSegmentRequest(const std::shared_ptr<Htt
 			response->SetKeepAlive();
 			response->SetChunkedTransfer();
 
-			// Append data to HTTP response
-			response->AppendData(chunk_item->second->chunked_data);
+			// The header and the chunks pushed so far are sent with a single write
+			for (auto &chunk : chunked_segment->chunk_log)
+			{
+				response->AppendData(chunk);
+			}
+
 			response->Response();
 
-			chunk_item->second->client_list.push_back(client);
+			chunked_segment->subscribers.push_back(client);
 
 			return HttpConnection::KeepAlive;
 		}
 	}
 
+	common::MediaType part_media_type;
+	int64_t part_msn;
+	int64_t part_index;
+
+	if (CmafPacketizer::ParseLlHlsPartFileName(file_name, &part_media_type, &part_msn, &part_index))
+	{
+		auto find_part = [&]() -> bool {
+			return std::find_if(_observers.begin(), _observers.end(),
+								[&client, &app_name, &stream_name, &file_name, &segment](auto &observer) -> bool {
+									return observer->OnSegmentRequest(client, app_name, stream_name, file_name, segment);
+								}) != _observers.end();
+		};
+
+		if (find_part() == false)
+		{
+			if (HoldLlHlsPartRequest(client, app_name, stream_name, file_name))
+			{
+				return HttpConnection::KeepAlive;
+			}
+
+			// The part might be added after the first lookup
+			if (find_part() == false)
+			{
+				response->SetStatusCode(HttpStatusCode::NotFound);
+				response->Response();
+
+				return HttpConnection::Closed;
+			}
+		}
+
+		ResponseLlHlsPart(client, segment);
+
+		return HttpConnection::Closed;
+	}
+
 	return DashStreamServer::ProcessSegmentRequest(client, app_name, stream_name, file_name, segment_type);
 }
 
+std::shared_ptr<CmafStreamServer::CmafWebSocketTrack> CmafStreamServer::GetWebSocketTrack(const ov::String &app_name, const ov::String &stream_name, bool is_video)
+{
+	auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(),
+										is_video ? CMAF_WEB_SOCKET_VIDEO_FULL_FILE_NAME : CMAF_WEB_SOCKET_AUDIO_FULL_FILE_NAME);
+
+	std::lock_guard<std::mutex> lock_guard(_web_socket_guard);
+
+	auto &track = _web_socket_tracks[key];
+
+	if (track == nullptr)
+	{
+		track = std::make_shared<CmafWebSocketTrack>();
+	}
+
+	return track;
+}
+
+HttpInterceptorResult CmafStreamServer::OnWebSocketConnected(const std::shared_ptr<WebSocketClient> &ws_client)
+{
+	auto client = ws_client->GetClient();
+	auto request = client->GetRequest();
+
+	ov::String app_name;
+	ov::String stream_name;
+	ov::String file_name;
+	ov::String file_ext;
+
+	if (ParseRequestUrl(request->GetRequestTarget(), app_name, stream_name, file_name, file_ext) == false)
+	{
+		logtd("Failed to parse URL: %s", request->GetRequestTarget().CStr());
+		return HttpInterceptorResult::Disconnect;
+	}
+
+	auto host_name = request->GetHeader("HOST").Split(":")[0];
+	app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(host_name, app_name);
+
+	bool is_video = (file_name == CMAF_WEB_SOCKET_VIDEO_FULL_FILE_NAME);
+
+	if ((is_video == false) && (file_name != CMAF_WEB_SOCKET_AUDIO_FULL_FILE_NAME))
+	{
+		logtd("Unknown track of fMP4 over WebSocket: %s", request->GetRequestTarget().CStr());
+		return HttpInterceptorResult::Disconnect;
+	}
+
+	// The stream (and the signed URL) is checked as the MPD of LLDASH is requested
+	std::shared_ptr<const PlayListData> play_list;
+
+	auto item = std::find_if(_observers.begin(), _observers.end(),
+							 [&client, &app_name, &stream_name, &play_list](auto &observer) -> bool {
+								 return observer->OnPlayListRequest(client, app_name, stream_name, CMAF_PLAYLIST_FULL_FILE_NAME, play_list);
+							 });
+
+	if ((item == _observers.end()) || (play_list == nullptr))
+	{
+		logtd("Could not find a stream for fMP4 over WebSocket: [%s/%s], %s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		return HttpInterceptorResult::Disconnect;
+	}
+
+	std::shared_ptr<SegmentData> init_segment;
+	ov::String init_file_name = is_video ? CMAF_MPD_VIDEO_FULL_INIT_FILE_NAME : CMAF_MPD_AUDIO_FULL_INIT_FILE_NAME;
+
+	item = std::find_if(_observers.begin(), _observers.end(),
+						[&client, &app_name, &stream_name, &init_file_name, &init_segment](auto &observer) -> bool {
+							return observer->OnSegmentRequest(client, app_name, stream_name, init_file_name, init_segment);
+						});
+
+	if (item == _observers.end())
+	{
+		// The track does not exist (or is not started yet)
+		logtd("Could not find the init segment for fMP4 over WebSocket: [%s/%s], %s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		return HttpInterceptorResult::Disconnect;
+	}
+
+	auto track = GetWebSocketTrack(app_name, stream_name, is_video);
+
+	std::lock_guard<std::mutex> lock_guard(track->mutex);
+
+	// The current segment starts with a key frame, so the player can start from its first chunk
+	if (ws_client->Send(init_segment->data, WebSocketFrameOpcode::Binary) < 0)
+	{
+		return HttpInterceptorResult::Disconnect;
+	}
+
+	for (auto &chunk : track->chunk_log)
+	{
+		if (ws_client->Send(chunk, WebSocketFrameOpcode::Binary) < 0)
+		{
+			return HttpInterceptorResult::Disconnect;
+		}
+	}
+
+	logtd("%s subscribes fMP4 over WebSocket: [%s/%s], %s (%zu chunks of %s)",
+		  ws_client->ToString().CStr(), app_name.CStr(), stream_name.CStr(), file_name.CStr(), track->chunk_log.size(), track->file_name.CStr());
+
+	track->subscribers.push_back(CmafWebSocketSubscriber{ws_client, false});
+
+	return HttpInterceptorResult::Keep;
+}
+
+void CmafStreamServer::OnWebSocketClosed(const std::shared_ptr<WebSocketClient> &ws_client)
+{
+	std::lock_guard<std::mutex> lock_guard(_web_socket_guard);
+
+	for (auto item = _web_socket_tracks.begin(); item != _web_socket_tracks.end();)
+	{
+		auto &track = item->second;
+
+		std::unique_lock<std::mutex> lock(track->mutex);
+
+		auto &subscribers = track->subscribers;
+
+		subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [&ws_client](const auto &subscriber) -> bool {
+							  return subscriber.client == ws_client;
+						  }),
+						  subscribers.end());
+
+		// The track of a stream that is not pushed anymore
+		bool is_unused = subscribers.empty() && track->file_name.IsEmpty();
+
+		lock.unlock();
+
+		item = is_unused ? _web_socket_tracks.erase(item) : std::next(item);
+	}
+}
+
+void CmafStreamServer::PushWebSocketChunk(const ov::String &app_name, const ov::String &stream_name,
+										  const ov::String &file_name,
+										  bool is_video,
+										  const std::shared_ptr<const ov::Data> &chunk_data)
+{
+	auto track = GetWebSocketTrack(app_name, stream_name, is_video);
+
+	std::vector<std::shared_ptr<WebSocketClient>> broken_clients;
+
+	{
+		std::lock_guard<std::mutex> lock_guard(track->mutex);
+
+		if (track->file_name != file_name)
+		{
+			// A new segment
+			track->file_name = file_name;
+			track->chunk_log.clear();
+
+			for (auto &subscriber : track->subscribers)
+			{
+				subscriber.is_skipping = false;
+			}
+		}
+
+		track->chunk_log.push_back(chunk_data);
+
+		if (track->subscribers.empty())
+		{
+			return;
+		}
+
+		// The frame header of the chunk is made once for all subscribers
+		auto frame_header = WebSocketClient::MakeFrameHeader(WebSocketFrameOpcode::Binary, chunk_data->GetLength());
+
+		for (auto subscriber = track->subscribers.begin(); subscriber != track->subscribers.end();)
+		{
+			if (subscriber->is_skipping)
+			{
+				++subscriber;
+				continue;
+			}
+
+			auto remote = subscriber->client->GetClient()->GetResponse()->GetRemote();
+
+			if ((remote != nullptr) && remote->IsSendQueueLate())
+			{
+				// A chunk cannot be dropped alone (the next frames refer it), so the player resumes from the next segment
+				logtd("The chunks of [%s/%s, %s] are late for %s (%lld ms), the rest of the segment is skipped",
+					  app_name.CStr(), stream_name.CStr(), file_name.CStr(), remote->ToString().CStr(), remote->GetSendQueueDelay());
+
+				subscriber->is_skipping = true;
+				++subscriber;
+				continue;
+			}
+
+			if (subscriber->client->Send(frame_header, chunk_data) < 0)
+			{
+				broken_clients.push_back(subscriber->client);
+				subscriber = track->subscribers.erase(subscriber);
+				continue;
+			}
+
+			++subscriber;
+		}
+	}
+
+	for (auto &client : broken_clients)
+	{
+		logtd("Failed to send the chunk of [%s/%s, %s] to %s", app_name.CStr(), stream_name.CStr(), file_name.CStr(), client->ToString().CStr());
+		client->Close();
+	}
+}
+
 void CmafStreamServer::OnCmafChunkDataPush(const ov::String &app_name, const ov::String &stream_name,
 										   const ov::String &file_name,
 										   bool is_video,
 										   std::shared_ptr<ov::Data> &chunk_data)
 {
+	PushWebSocketChunk(app_name, stream_name, file_name, is_video, chunk_data);
+
 	auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
 
-	std::unique_lock<std::mutex> lock(_http_chunk_guard);
+	std::shared_ptr<CmafChunkedSegment> chunked_segment;
+
+	{
+		std::unique_lock<std::mutex> lock(_http_chunk_guard);
+
+		auto chunk_item = _http_chunk_list.find(key);
+
+		if (chunk_item == _http_chunk_list.end())
+		{
+			// New chunk data is arrived
+			logtd("Create a new chunk for [%s/%s, %s], size: %zu bytes", app_name.CStr(), stream_name.CStr(), file_name.CStr(), chunk_data->GetLength());
+			_http_chunk_list.emplace(key, std::make_shared<CmafChunkedSegment>(chunk_data));
+			return;
+		}
+
+		chunked_segment = chunk_item->second;
+	}
+
+	std::unique_lock<std::mutex> lock(chunked_segment->mutex);
 
-	auto chunk_item = _http_chunk_list.find(key);
-	if (chunk_item == _http_chunk_list.end())
+	chunked_segment->chunk_log.push_back(chunk_data);
+	chunked_segment->length += chunk_data->GetLength();
+
+	if (chunked_segment->subscribers.empty())
 	{
-		// New chunk data is arrived
-		logtd("Create a new chunk for [%s/%s, %s], size: %zu bytes", app_name.CStr(), stream_name.CStr(), file_name.CStr(), chunk_data->GetLength());
-		_http_chunk_list.emplace(key, std::make_shared<CmafHttpChunkedData>(chunk_data));
 		return;
 	}
 
-	chunk_item->second->AddChunkData(chunk_data);
+	// The framing of the chunk is made once for all subscribers, and each subscriber sends it with a single write
+	auto chunk_header = HttpResponse::MakeChunkHeader(chunk_data->GetLength());
+	std::vector<std::shared_ptr<HttpClient>> late_subscribers;
 
-	for (auto client : chunk_item->second->client_list)
+	for (auto subscriber = chunked_segment->subscribers.begin(); subscriber != chunked_segment->subscribers.end();)
 	{
-		auto response = client->GetResponse();
+		auto response = (*subscriber)->GetResponse();
+		auto remote = response->GetRemote();
 
-		if (response->SendChunkedData(chunk_data) == false)
+		if ((remote != nullptr) && remote->IsSendQueueLate())
+		{
+			// The previous chunks are still waiting to be sent (See <LowLatency><MaxQueueDelay>), so the rest of this segment is
+			// too late to be played. Finish the segment here instead of queueing it, and the player continues with the next segment.
+			logtd("The chunks of [%s/%s, %s] are late for %s (%lld ms), the rest of the segment is skipped",
+				  app_name.CStr(), stream_name.CStr(), file_name.CStr(), remote->ToString().CStr(), remote->GetSendQueueDelay());
+
+			late_subscribers.push_back(*subscriber);
+			subscriber = chunked_segment->subscribers.erase(subscriber);
+			continue;
+		}
+
+		if (response->SendChunkedData(chunk_header, chunk_data) == false)
 		{
 			logtd("Failed to send the chunked data for [%s/%s, %s] to %s (%zu bytes)", app_name.CStr(), stream_name.CStr(), file_name.CStr(), response->GetRemote()->ToString().CStr(), chunk_data->GetLength());
+
+			// The connection is broken: don't send the next chunks
+			subscriber = chunked_segment->subscribers.erase(subscriber);
+			continue;
 		}
+
+		++subscriber;
+	}
+
+	lock.unlock();
+
+	for (auto &client : late_subscribers)
+	{
+		client->GetResponse()->SendChunkedData(nullptr);
+		CompleteDeferredResponse(client);
 	}
 }
 
@@ -90,7 +821,7 @@ void CmafStreamServer::OnCmafChunkedComplete(const ov::String &app_name, const o
 											 const ov::String &file_name,
 											 bool is_video)
 {
-	std::shared_ptr<CmafHttpChunkedData> chunked_data;
+	std::shared_ptr<CmafChunkedSegment> chunked_segment;
 
 	{
 		auto key = ov::String::FormatString("%s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
@@ -106,14 +837,25 @@ void CmafStreamServer::OnCmafChunkedComplete(const ov::String &app_name, const o
 			return;
 		}
 
-		chunked_data = chunk_item->second;
+		chunked_segment = chunk_item->second;
 
 		_http_chunk_list.erase(chunk_item);
 	}
 
-	logtd("The chunk is completed [%s/%s, %s]", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+	std::vector<std::shared_ptr<HttpClient>> subscribers;
+
+	{
+		std::unique_lock<std::mutex> lock(chunked_segment->mutex);
+
+		chunked_segment->is_completed = true;
+		subscribers.swap(chunked_segment->subscribers);
+	}
+
+	logtd("The chunk is completed [%s/%s, %s] (%zu chunks, %zu bytes, %zu subscribers)",
+		  app_name.CStr(), stream_name.CStr(), file_name.CStr(),
+		  chunked_segment->chunk_log.size(), chunked_segment->length, subscribers.size());
 
-	for (auto client : chunked_data->client_list)
+	for (auto &client : subscribers)
 	{
 		auto response = client->GetResponse();
 
@@ -123,6 +865,6 @@ void CmafStreamServer::OnCmafChunkedComplete(const ov::String &app_name, const o
 				  response->GetRemote()->ToString().CStr(), app_name.CStr(), stream_name.CStr(), file_name.CStr());
 		}
 
-		response->Close();
+		CompleteDeferredResponse(client);
 	}
 }
\ No newline at end of file
@@ -16,6 +16,9 @@
 class CmafStreamServer : public DashStreamServer, public ICmafChunkedTransfer
 {
 public:
+	CmafStreamServer();
+	~CmafStreamServer() override;
+
 	PublisherType GetPublisherType() const noexcept override
 	{
 		return PublisherType::LlDash;
@@ -31,28 +34,80 @@ public:
 		return std::make_shared<CmafInterceptor>();
 	}
 
+	std::shared_ptr<WebSocketInterceptor> CreateWebSocketInterceptor() override;
+
 protected:
-	struct CmafHttpChunkedData
+	// A segment that is being created
+	//
+	// The chunks are kept in a log shared by all viewers of the segment (without copying),
+	// so a late joiner gets the chunks pushed so far with a single write,
+	// and each chunk is framed once and sent to all subscribers in one pass.
+	struct CmafChunkedSegment
 	{
 	public:
-		CmafHttpChunkedData(const std::shared_ptr<const ov::Data> &data)
+		CmafChunkedSegment(const std::shared_ptr<const ov::Data> &data)
 		{
-			chunked_data = std::make_shared<ov::Data>(104 * 1024);
-			chunked_data->Append(data);
+			chunk_log.push_back(data);
+			length = data->GetLength();
 		}
 
-		void AddChunkData(const std::shared_ptr<ov::Data> &data)
-		{
-			chunked_data->Append(data);
-		}
+		// Guards chunk_log/subscribers (the sends to the subscribers are also serialized by this lock)
+		std::mutex mutex;
+
+		// The chunks are not modified after they are pushed
+		std::vector<std::shared_ptr<const ov::Data>> chunk_log;
+		size_t length = 0;
+
+		std::vector<std::shared_ptr<HttpClient>> subscribers;
+		bool is_completed = false;
+	};
 
-		std::shared_ptr<ov::Data> chunked_data;
-		std::vector<std::shared_ptr<HttpClient>> client_list;
+	// A player of fMP4 over WebSocket
+	struct CmafWebSocketSubscriber
+	{
+		std::shared_ptr<WebSocketClient> client;
+		// The send queue is late, the chunks are skipped until the next segment (which starts with a key frame)
+		bool is_skipping = false;
+	};
+
+	// A track of fMP4 over WebSocket
+	//
+	// The chunk is framed once and sent to all subscribers, and a new subscriber gets
+	// the init segment and the chunks of the current segment so far, so it can start without waiting for the next segment.
+	struct CmafWebSocketTrack
+	{
+		// Guards all members (the sends to the subscribers are also serialized by this lock)
+		std::mutex mutex;
+
+		// The segment that is being created
+		ov::String file_name;
+		std::vector<std::shared_ptr<const ov::Data>> chunk_log;
+
+		std::vector<CmafWebSocketSubscriber> subscribers;
+	};
+
+	// A LL-HLS request that is held until the playlist (or the part) is available
+	struct LlHlsPendingRequest
+	{
+		std::shared_ptr<HttpClient> client;
+
+		// Empty if the playlist is requested
+		ov::String part_file_name;
+
+		int64_t msn = -1LL;
+		// -1 means the whole segment of the msn
+		int64_t part = -1LL;
+
+		int64_t expire_time = 0LL;
 	};
 
 	//--------------------------------------------------------------------
 	// Overriding functions of DashStreamServer
 	//--------------------------------------------------------------------
+	HttpConnection ProcessStreamRequest(const std::shared_ptr<HttpClient> &client,
+										const ov::String &app_name, const ov::String &stream_name,
+										const ov::String &file_name, const ov::String &file_ext) override;
+
 	HttpConnection ProcessSegmentRequest(const std::shared_ptr<HttpClient> &client,
 									const ov::String &app_name, const ov::String &stream_name,
 									const ov::String &file_name,
@@ -70,8 +125,50 @@ protected:
 							   const ov::String &file_name,
 							   bool is_video) override;
 
+	void OnLlHlsPartAdded(const ov::String &app_name, const ov::String &stream_name,
+						  const ov::String &play_list_file_name, const std::shared_ptr<const PlayListData> &play_list,
+						  const std::shared_ptr<SegmentData> &part) override;
+
+	void OnLlHlsFinished(const ov::String &app_name, const ov::String &stream_name) override;
+
+	// fMP4 over WebSocket (<app>/<stream>/video_ll.ws or audio_ll.ws)
+	HttpInterceptorResult OnWebSocketConnected(const std::shared_ptr<WebSocketClient> &ws_client);
+	void OnWebSocketClosed(const std::shared_ptr<WebSocketClient> &ws_client);
+	void PushWebSocketChunk(const ov::String &app_name, const ov::String &stream_name,
+							const ov::String &file_name,
+							bool is_video,
+							const std::shared_ptr<const ov::Data> &chunk_data);
+	std::shared_ptr<CmafWebSocketTrack> GetWebSocketTrack(const ov::String &app_name, const ov::String &stream_name, bool is_video);
+
+	// LL-HLS playlist request with the blocking playlist reload (_HLS_msn & _HLS_part)
+	HttpConnection ProcessLlHlsPlayListRequest(const std::shared_ptr<HttpClient> &client,
+											   const ov::String &app_name, const ov::String &stream_name,
+											   const ov::String &file_name);
+	// Holds the request of the part that is not created yet (EXT-X-PRELOAD-HINT), returns false if it cannot be held
+	bool HoldLlHlsPartRequest(const std::shared_ptr<HttpClient> &client,
+							  const ov::String &app_name, const ov::String &stream_name,
+							  const ov::String &file_name);
+
+	static bool IsLlHlsRequestSatisfied(const PlayListData &play_list, int64_t msn, int64_t part);
+	void ResponseLlHlsPart(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<SegmentData> &part);
+	// Responds the held requests that are expired
+	void ExpireLlHlsRequests();
+
 	// A temporary queue for the intermediate chunks
 	// Key: [app name]/[stream name]/[file name]
-	std::map<ov::String, std::shared_ptr<CmafHttpChunkedData>> _http_chunk_list;
+	// (_http_chunk_guard only guards the map, each segment has its own lock)
+	std::map<ov::String, std::shared_ptr<CmafChunkedSegment>> _http_chunk_list;
 	std::mutex _http_chunk_guard;
+
+	// Key: [app name]/[stream name]/[video_ll.ws or audio_ll.ws]
+	// (_web_socket_guard only guards the map, each track has its own lock)
+	std::map<ov::String, std::shared_ptr<CmafWebSocketTrack>> _web_socket_tracks;
+	std::mutex _web_socket_guard;
+
+	// The latest LL-HLS media playlists, and the requests held until they are updated
+	// Key: [app name]/[stream name]/[playlist file name]
+	std::map<ov::String, std::shared_ptr<const PlayListData>> _ll_hls_play_lists;
+	std::map<ov::String, std::vector<LlHlsPendingRequest>> _ll_hls_pending_requests;
+	std::mutex _ll_hls_guard;
+	ov::DelayQueue _ll_hls_timer;
 };
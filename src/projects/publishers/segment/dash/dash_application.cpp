@@ -33,6 +33,8 @@ DashApplication::DashApplication(const std::shared_ptr<pub::Publisher> &publishe
     auto publisher_info = application_info.GetPublisher<cfg::DashPublisher>();
     _segment_count = publisher_info->GetSegmentCount();
     _segment_duration = publisher_info->GetSegmentDuration();
+
+	SetDirectDispatch(true);
 }
 
 //====================================================================================================
@@ -53,6 +55,22 @@ bool DashApplication::Start()
 	
 	_segment_count = publisher_info->GetSegmentCount();
 	_segment_duration = publisher_info->GetSegmentDuration();
+	_segment_storage = SegmentStorage::Create(publisher_info->GetSegmentStoragePath());
+	_thumbnail_options = SegmentStream::GetThumbnailOptions(publisher_info->GetThumbnail());
+	_use_number_template = publisher_info->IsNumberTemplate();
+	_on_demand_idle_timeout = SegmentStream::GetOnDemandIdleTimeout(publisher_info->GetOnDemand());
+
+	// If LLDASH is enabled with the same segment duration, the segments of LLDASH are also used for DASH
+	auto ll_dash_publisher_info = GetPublisher<cfg::LlDashPublisher>();
+
+	_share_cmaf_packaging = (ll_dash_publisher_info != nullptr) &&
+							ll_dash_publisher_info->IsParsed() &&
+							(ll_dash_publisher_info->GetSegmentDuration() == _segment_duration);
+
+	if (_share_cmaf_packaging)
+	{
+		logti("DASH of %s shares the CMAF packaging with LLDASH", GetName().CStr());
+	}
 
 	return Application::Start();
 }
@@ -77,7 +95,12 @@ std::shared_ptr<pub::Stream> DashApplication::CreateStream(const std::shared_ptr
                             _segment_duration,
                             GetSharedPtrAs<pub::Application>(),
                             *info.get(),
-                            thread_count);
+                            thread_count,
+                            _share_cmaf_packaging,
+                            _segment_storage,
+                            _thumbnail_options,
+                            _use_number_template,
+                            _on_demand_idle_timeout);
 }
 
 
@@ -34,4 +34,12 @@ private:
 private :
     int _segment_count;
     int _segment_duration;
+    bool _share_cmaf_packaging = false;
+    std::shared_ptr<SegmentStorage> _segment_storage;
+    // nullptr if <Thumbnail> is disabled
+    std::shared_ptr<const TranscodeThumbnail::Options> _thumbnail_options;
+    // <SegmentTemplate>Number</SegmentTemplate>
+    bool _use_number_template = false;
+    // 0 if <OnDemand> is disabled
+    int _on_demand_idle_timeout = 0;
 };
@@ -19,14 +19,43 @@
 #define DASH_PLAYLIST_EXT "mpd"
 #define DASH_LOW_LATENCY_SUFFIX "_ll"
 
+// Replaced with the current time for each request
+#define DASH_MPD_UTC_TIMING_PLACEHOLDER "${UTCTiming}"
+// Replaced with the time of the last structural update (the MPDs with $Number$ don't change for the new segments)
+#define DASH_MPD_PUBLISH_TIME_PLACEHOLDER "${PublishTime}"
+// minimumUpdatePeriod (in seconds) of the MPDs with $Number$, the players only need to refetch them for the structural updates
+#define DASH_MPD_TEMPLATE_MINIMUM_UPDATE_PERIOD 30
+
 #define DASH_MPD_VIDEO_FULL_SUFFIX DASH_MPD_VIDEO_SUFFIX "." DASH_SEGMENT_EXT
 #define DASH_MPD_AUDIO_FULL_SUFFIX DASH_MPD_AUDIO_SUFFIX "." DASH_SEGMENT_EXT
 #define DASH_MPD_VIDEO_FULL_INIT_FILE_NAME DASH_MPD_VIDEO_INIT_FILE_NAME "." DASH_SEGMENT_EXT
 #define DASH_MPD_AUDIO_FULL_INIT_FILE_NAME DASH_MPD_AUDIO_INIT_FILE_NAME "." DASH_SEGMENT_EXT
 #define DASH_PLAYLIST_FULL_FILE_NAME DASH_PLAYLIST_FILE_NAME "." DASH_PLAYLIST_EXT
+// The master playlist of a stream group (<app>/<group>/master.mpd)
+#define DASH_MASTER_PLAYLIST_FULL_FILE_NAME "master." DASH_PLAYLIST_EXT
 
 #define CMAF_MPD_VIDEO_FULL_SUFFIX DASH_MPD_VIDEO_SUFFIX DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
 #define CMAF_MPD_AUDIO_FULL_SUFFIX DASH_MPD_AUDIO_SUFFIX DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
 #define CMAF_MPD_VIDEO_FULL_INIT_FILE_NAME DASH_MPD_VIDEO_INIT_FILE_NAME DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
 #define CMAF_MPD_AUDIO_FULL_INIT_FILE_NAME DASH_MPD_AUDIO_INIT_FILE_NAME DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
 #define CMAF_PLAYLIST_FULL_FILE_NAME DASH_PLAYLIST_FILE_NAME DASH_LOW_LATENCY_SUFFIX "." DASH_PLAYLIST_EXT
+
+// LL-HLS (the same fMP4 chunks of LLDASH are served as the partial segments)
+#define CMAF_HLS_PLAYLIST_EXT "m3u8"
+#define CMAF_HLS_PART_SUFFIX "_part"
+#define CMAF_HLS_PLAYLIST_FILE_NAME "playlist"
+#define CMAF_HLS_VIDEO_PLAYLIST_FILE_NAME "video"
+#define CMAF_HLS_AUDIO_PLAYLIST_FILE_NAME "audio"
+
+#define CMAF_HLS_PLAYLIST_FULL_SUFFIX DASH_LOW_LATENCY_SUFFIX "." CMAF_HLS_PLAYLIST_EXT
+#define CMAF_HLS_VIDEO_PART_FULL_SUFFIX DASH_MPD_VIDEO_SUFFIX CMAF_HLS_PART_SUFFIX DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
+#define CMAF_HLS_AUDIO_PART_FULL_SUFFIX DASH_MPD_AUDIO_SUFFIX CMAF_HLS_PART_SUFFIX DASH_LOW_LATENCY_SUFFIX "." DASH_SEGMENT_EXT
+#define CMAF_HLS_PLAYLIST_FULL_FILE_NAME CMAF_HLS_PLAYLIST_FILE_NAME CMAF_HLS_PLAYLIST_FULL_SUFFIX
+#define CMAF_HLS_VIDEO_PLAYLIST_FULL_FILE_NAME CMAF_HLS_VIDEO_PLAYLIST_FILE_NAME CMAF_HLS_PLAYLIST_FULL_SUFFIX
+#define CMAF_HLS_AUDIO_PLAYLIST_FULL_FILE_NAME CMAF_HLS_AUDIO_PLAYLIST_FILE_NAME CMAF_HLS_PLAYLIST_FULL_SUFFIX
+
+// fMP4 over WebSocket (the same fMP4 chunks of LLDASH are pushed to the MSE players, one socket per track)
+#define CMAF_WEB_SOCKET_EXT "ws"
+#define CMAF_WEB_SOCKET_FULL_SUFFIX DASH_LOW_LATENCY_SUFFIX "." CMAF_WEB_SOCKET_EXT
+#define CMAF_WEB_SOCKET_VIDEO_FULL_FILE_NAME "video" CMAF_WEB_SOCKET_FULL_SUFFIX
+#define CMAF_WEB_SOCKET_AUDIO_FULL_FILE_NAME "audio" CMAF_WEB_SOCKET_FULL_SUFFIX
@@ -10,7 +10,10 @@
 #include "dash_define.h"
 #include "dash_private.h"
 
+#include <base/ovlibrary/probe.h>
+
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <numeric>
 #include <sstream>
@@ -19,13 +22,15 @@ DashPacketizer::DashPacketizer(const ov::String &app_name, const ov::String &str
 							   PacketizerStreamType stream_type,
 							   const ov::String &segment_prefix,
 							   uint32_t segment_count, uint32_t segment_duration,
-							   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track)
+							   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+							   bool use_number_template)
 	: Packetizer(app_name, stream_name,
 				 PacketizerType::Dash,
 				 stream_type,
 				 segment_prefix,
 				 segment_count, segment_duration,
-				 video_track, audio_track)
+				 video_track, audio_track),
+	  _use_number_template(use_number_template)
 {
 	_mpd_min_buffer_time = 6;
 
@@ -125,6 +130,19 @@ int DashPacketizer::GetStartPatternSize(const uint8_t *buffer, const size_t buff
 
 ov::String DashPacketizer::GetFileName(int64_t start_timestamp, common::MediaType media_type) const
 {
+	if (_use_number_template)
+	{
+		bool is_video = (media_type == common::MediaType::Video);
+		auto ideal_duration = is_video ? _ideal_duration_for_video : _ideal_duration_for_audio;
+		auto last_number = is_video ? _last_video_number : _last_audio_number;
+
+		// The segments are cut at the key frames, so a segment can start before its ideal position if the GOP is not aligned to the segment duration.
+		// The number must be increased anyway.
+		auto number = std::max(static_cast<int64_t>(std::llround(start_timestamp / ideal_duration)), last_number + 1);
+
+		return ov::String::FormatString("%s_%lld%s", _segment_prefix.CStr(), number, is_video ? DASH_MPD_VIDEO_FULL_SUFFIX : DASH_MPD_AUDIO_FULL_SUFFIX);
+	}
+
 	switch (media_type)
 	{
 		case common::MediaType::Video:
@@ -760,6 +778,11 @@ bool DashPacketizer::UpdatePlayList()
 		return false;
 	}
 
+	if (_use_number_template)
+	{
+		return UpdateNumberTemplatePlayList();
+	}
+
 	ov::String publishTime = MakeUtcSecond(::time(nullptr));
 
 	logtd("Trying to update playlist for %s with availabilityStartTime: %s, publishTime: %s", GetPacketizerName(), _start_time.CStr(), publishTime.CStr());
@@ -823,12 +846,20 @@ bool DashPacketizer::UpdatePlayList()
 	}
 
 	play_list_stream << "\t</Period>\n"
-					 << "\t<UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:direct:2014\" value=\"%s\"/>\n"
+					 << "\t<UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:direct:2014\" value=\"" DASH_MPD_UTC_TIMING_PLACEHOLDER "\"/>\n"
 					 << "</MPD>\n";
 
 	ov::String play_list = play_list_stream.str().c_str();
 
-	SetPlayList(play_list);
+	SetPlayList(play_list, DASH_MPD_UTC_TIMING_PLACEHOLDER);
+
+	auto rendition = std::make_shared<RenditionData>();
+	rendition->start_time = _start_time;
+	rendition->time_shift_buffer_depth = time_shift_buffer_depth;
+	rendition->minimum_update_period = minimumUpdatePeriod;
+	rendition->video_timeline = video_urls;
+	rendition->audio_timeline = audio_urls;
+	SetRendition(rendition);
 
 	if(_stat_stop_watch.IsElapsed(5000) && _stat_stop_watch.Update())
 	{
@@ -846,6 +877,94 @@ bool DashPacketizer::UpdatePlayList()
 	return true;
 }
 
+bool DashPacketizer::UpdateNumberTemplatePlayList()
+{
+	std::ostringstream play_list_stream;
+
+	play_list_stream
+		<< std::fixed << std::setprecision(3)
+		<< "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		   "<MPD xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+		   "\txmlns=\"urn:mpeg:dash:schema:mpd:2011\"\n"
+		   "\txmlns:xlink=\"http://www.w3.org/1999/xlink\"\n"
+		   "\txsi:schemaLocation=\"urn:mpeg:DASH:schema:MPD:2011 http://standards.iso.org/ittf/PubliclyAvailableStandards/MPEG-DASH_schema_files/DASH-MPD.xsd\"\n"
+		   "\tprofiles=\"urn:mpeg:dash:profile:isoff-live:2011\"\n"
+		   "\ttype=\"dynamic\"\n"
+		<< "\tminimumUpdatePeriod=\"PT" << DASH_MPD_TEMPLATE_MINIMUM_UPDATE_PERIOD << "S\"\n"
+		<< "\tpublishTime=\"" DASH_MPD_PUBLISH_TIME_PLACEHOLDER "\"\n"
+		<< "\tavailabilityStartTime=\"" << _start_time.CStr() << "\"\n"
+		<< "\ttimeShiftBufferDepth=\"PT" << (_segment_duration * _segment_count) << "S\"\n"
+		<< "\tsuggestedPresentationDelay=\"PT" << std::setprecision(1) << (_segment_duration * _segment_count) << "S\"\n"
+		<< "\tminBufferTime=\"PT2S\">\n"
+		<< "\t<Period id=\"0\" start=\"PT0S\">\n";
+
+	// The segment of $Number$ starts at presentationTimeOffset + (($Number$ - startNumber) * duration)
+	if (_video_start_number >= 0LL)
+	{
+		auto duration = static_cast<uint64_t>(_ideal_duration_for_video);
+
+		play_list_stream
+			<< "\t\t<AdaptationSet group=\"1\" mimeType=\"video/mp4\" "
+			<< "width=\"" << _video_track->GetWidth() << "\" height=\"" << _video_track->GetHeight()
+			<< "\" par=\"" << _pixel_aspect_ratio << "\" frameRate=\"" << _video_track->GetFrameRate()
+			<< "\" segmentAlignment=\"true\" startWithSAP=\"1\" subsegmentAlignment=\"true\" subsegmentStartsWithSAP=\"1\">\n"
+			<< "\t\t\t<SegmentTemplate presentationTimeOffset=\"" << (_video_start_number * duration)
+			<< "\" timescale=\"" << static_cast<uint32_t>(_video_track->GetTimeBase().GetTimescale())
+			<< "\" duration=\"" << duration << "\" startNumber=\"" << _video_start_number
+			<< "\" initialization=\"" << DASH_MPD_VIDEO_FULL_INIT_FILE_NAME << "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << DASH_MPD_VIDEO_FULL_SUFFIX << "\" />\n"
+			<< "\t\t\t<Representation id=\"0\" codecs=\"avc1.42401f\" sar=\"1:1\" bandwidth=\"" << _video_track->GetBitrate()
+			<< "\" />\n"
+			<< "\t\t</AdaptationSet>\n";
+	}
+
+	if (_audio_start_number >= 0LL)
+	{
+		auto duration = static_cast<uint64_t>(_ideal_duration_for_audio);
+
+		play_list_stream
+			<< "\t\t<AdaptationSet group=\"2\" mimeType=\"audio/mp4\" lang=\"und\" segmentAlignment=\"true\" startWithSAP=\"1\" subsegmentAlignment=\"true\" subsegmentStartsWithSAP=\"1\">\n"
+			<< "\t\t\t<AudioChannelConfiguration schemeIdUri=\"urn:mpeg:dash:23003:3:audio_channel_configuration:2011\" value=\""
+			<< _audio_track->GetChannel().GetCounts() << "\"/>\n"
+			<< "\t\t\t<SegmentTemplate presentationTimeOffset=\"" << (_audio_start_number * duration)
+			<< "\" timescale=\"" << static_cast<uint32_t>(_audio_track->GetTimeBase().GetTimescale())
+			<< "\" duration=\"" << duration << "\" startNumber=\"" << _audio_start_number
+			<< "\" initialization=\"" << DASH_MPD_AUDIO_FULL_INIT_FILE_NAME << "\" media=\"" << _segment_prefix.CStr() << "_$Number$" << DASH_MPD_AUDIO_FULL_SUFFIX << "\" />\n"
+			<< "\t\t\t<Representation id=\"1\" codecs=\"mp4a.40.2\" audioSamplingRate=\"" << _audio_track->GetSampleRate()
+			<< "\" bandwidth=\"" << _audio_track->GetBitrate() << "\" />\n"
+			<< "\t\t</AdaptationSet>\n";
+	}
+
+	play_list_stream << "\t</Period>\n"
+					 << "\t<UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:direct:2014\" value=\"" DASH_MPD_UTC_TIMING_PLACEHOLDER "\"/>\n"
+					 << "</MPD>\n";
+
+	ov::String play_list = play_list_stream.str().c_str();
+
+	if (IsTemplateMpdChanged(play_list) == false)
+	{
+		// Only a new segment is added, the players already know it from the template
+		return true;
+	}
+
+	logtd("The MPD of %s is updated for stream [%s/%s] (availabilityStartTime: %s)", GetPacketizerName(), _app_name.CStr(), _stream_name.CStr(), _start_time.CStr());
+
+	SetPlayList(play_list.Replace(DASH_MPD_PUBLISH_TIME_PLACEHOLDER, MakeUtcSecond(::time(nullptr))), DASH_MPD_UTC_TIMING_PLACEHOLDER);
+
+	return true;
+}
+
+bool DashPacketizer::IsTemplateMpdChanged(const ov::String &mpd)
+{
+	if (mpd == _last_template_mpd)
+	{
+		return false;
+	}
+
+	_last_template_mpd = mpd;
+
+	return true;
+}
+
 const std::shared_ptr<SegmentData> DashPacketizer::GetSegmentData(const ov::String &file_name)
 {
 	if (IsReadyForStreaming() == false)
@@ -856,32 +975,15 @@ const std::shared_ptr<SegmentData> DashPacketizer::GetSegmentData(const ov::Stri
 	}
 
 	auto file_type = GetFileType(file_name);
+	int64_t number;
 
 	switch (file_type)
 	{
 		case DashFileType::VideoSegment:
-		{
-			std::unique_lock<std::mutex> lock(_video_segment_guard);
-
-			auto item = std::find_if(_video_segment_datas.begin(), _video_segment_datas.end(),
-									 [&](std::shared_ptr<SegmentData> const &value) -> bool {
-										 return value != nullptr ? value->file_name == file_name : false;
-									 });
-
-			return (item != _video_segment_datas.end()) ? (*item) : nullptr;
-		}
+			return ParseSegmentNumber(file_name, &number) ? _video_segments.Find(number, file_name) : nullptr;
 
 		case DashFileType::AudioSegment:
-		{
-			std::unique_lock<std::mutex> lock(_audio_segment_guard);
-
-			auto item = std::find_if(_audio_segment_datas.begin(), _audio_segment_datas.end(),
-									 [&](std::shared_ptr<SegmentData> const &value) -> bool {
-										 return value != nullptr ? value->file_name == file_name : false;
-									 });
-
-			return (item != _audio_segment_datas.end()) ? (*item) : nullptr;
-		}
+			return ParseSegmentNumber(file_name, &number) ? _audio_segments.Find(number, file_name) : nullptr;
 
 		case DashFileType::VideoInit:
 			return _video_init_file;
@@ -901,19 +1003,28 @@ const std::shared_ptr<SegmentData> DashPacketizer::GetSegmentData(const ov::Stri
 bool DashPacketizer::SetSegmentData(ov::String file_name, uint64_t duration, int64_t timestamp, std::shared_ptr<ov::Data> &data)
 {
 	auto file_type = GetFileType(file_name);
+	int64_t number = 0;
+
+	if (ParseSegmentNumber(file_name, &number) == false)
+	{
+		logte("Could not parse the number of the segment: %s", file_name.CStr());
+		return false;
+	}
 
 	switch (file_type)
 	{
 		case DashFileType::VideoSegment:
 		{
-			// video segment mutex
-			std::unique_lock<std::mutex> lock(_video_segment_guard);
+			OV_PROBE6(segment_close, _app_name.CStr(), _stream_name.CStr(), static_cast<int>(common::MediaType::Video), timestamp, duration, data->GetLength());
 
-			_video_segment_datas[_current_video_index++] = std::make_shared<SegmentData>(common::MediaType::Video, _sequence_number++, file_name, timestamp, duration, data);
+			auto segment_data = StoreSegmentData(data);
 
-			if (_segment_save_count <= _current_video_index)
+			_video_segments.Push(number, std::make_shared<SegmentData>(common::MediaType::Video, _sequence_number++, file_name, timestamp, duration, segment_data));
+
+			if (_use_number_template)
 			{
-				_current_video_index = 0;
+				_video_start_number = (_video_start_number < 0LL) ? number : _video_start_number;
+				_last_video_number = number;
 			}
 
 			_video_segment_count++;
@@ -926,14 +1037,16 @@ bool DashPacketizer::SetSegmentData(ov::String file_name, uint64_t duration, int
 
 		case DashFileType::AudioSegment:
 		{
-			// audio segment mutex
-			std::unique_lock<std::mutex> lock(_audio_segment_guard);
+			OV_PROBE6(segment_close, _app_name.CStr(), _stream_name.CStr(), static_cast<int>(common::MediaType::Audio), timestamp, duration, data->GetLength());
+
+			auto segment_data = StoreSegmentData(data);
 
-			_audio_segment_datas[_current_audio_index++] = std::make_shared<SegmentData>(common::MediaType::Audio, _sequence_number++, file_name, timestamp, duration, data);
+			_audio_segments.Push(number, std::make_shared<SegmentData>(common::MediaType::Audio, _sequence_number++, file_name, timestamp, duration, segment_data));
 
-			if (_segment_save_count <= _current_audio_index)
+			if (_use_number_template)
 			{
-				_current_audio_index = 0;
+				_audio_start_number = (_audio_start_number < 0LL) ? number : _audio_start_number;
+				_last_audio_number = number;
 			}
 
 			_audio_segment_count++;
@@ -967,7 +1080,7 @@ void DashPacketizer::SetReadyForStreaming() noexcept
 	Packetizer::SetReadyForStreaming();
 }
 
-bool DashPacketizer::GetPlayList(ov::String &play_list)
+bool DashPacketizer::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
 {
 	if (IsReadyForStreaming() == false)
 	{
@@ -975,9 +1088,5 @@ bool DashPacketizer::GetPlayList(ov::String &play_list)
 		return false;
 	}
 
-	ov::String current_time = MakeUtcMillisecond();
-
-	play_list = ov::String::FormatString(_play_list.CStr(), current_time.CStr());
-
-	return true;
+	return Packetizer::GetPlayList(file_name, play_list);
 }
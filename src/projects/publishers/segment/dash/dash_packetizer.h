@@ -29,7 +29,8 @@ public:
 				   PacketizerStreamType stream_type,
 				   const ov::String &segment_prefix,
 				   uint32_t segment_count, uint32_t segment_duration,
-				   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track);
+				   std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+				   bool use_number_template = false);
 
 	virtual const char *GetPacketizerName() const
 	{
@@ -47,7 +48,7 @@ public:
 	const std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) override;
 	bool SetSegmentData(ov::String file_name, uint64_t duration, int64_t timestamp, std::shared_ptr<ov::Data> &data) override;
 
-	bool GetPlayList(ov::String &play_list) override;
+	bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list) override;
 
 protected:
 	using DataCallback = std::function<void(const std::shared_ptr<const SampleData> &data, bool new_segment_written)>;
@@ -74,6 +75,11 @@ protected:
 	bool GetSegmentInfos(ov::String *video_urls, ov::String *audio_urls, double *time_shift_buffer_depth, double *minimum_update_period);
 
 	virtual bool UpdatePlayList();
+	// The MPD of the SegmentTemplate ($Number$) mode, which doesn't list the segments
+	bool UpdateNumberTemplatePlayList();
+	// Whether the MPD (made with DASH_MPD_PUBLISH_TIME_PLACEHOLDER) differs from the last one,
+	// so the playlist (and its ETag) is replaced only by the structural updates
+	bool IsTemplateMpdChanged(const ov::String &mpd);
 
 	virtual void SetReadyForStreaming() noexcept override;
 
@@ -120,5 +126,15 @@ protected:
 
 	double _duration_margin;
 
+	// The segments are named with $Number$ (the media time / the ideal duration) instead of $Time$ (See <SegmentTemplate> of <DASH>)
+	bool _use_number_template = false;
+	// startNumber (the number of the first segment), -1 if no segment is written yet
+	int64_t _video_start_number = -1LL;
+	int64_t _audio_start_number = -1LL;
+	int64_t _last_video_number = -1LL;
+	int64_t _last_audio_number = -1LL;
+	// The last MPD with DASH_MPD_PUBLISH_TIME_PLACEHOLDER
+	ov::String _last_template_mpd;
+
 	ov::StopWatch _stat_stop_watch;
 };
\ No newline at end of file
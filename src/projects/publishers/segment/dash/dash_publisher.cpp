@@ -8,11 +8,15 @@
 //==============================================================================
 #include "dash_publisher.h"
 #include "dash_application.h"
+#include "dash_define.h"
 #include "dash_private.h"
 #include "dash_stream_server.h"
 
 #include <config/config_manager.h>
 
+#include <iomanip>
+#include <sstream>
+
 std::shared_ptr<DashPublisher> DashPublisher::Create(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager,
 													 const cfg::Server &server_config,
 													 const std::shared_ptr<MediaRouteInterface> &router)
@@ -50,4 +54,131 @@ std::shared_ptr<pub::Application> DashPublisher::OnCreatePublisherApplication(co
 bool DashPublisher::OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application)
 {
 	return true;
+}
+
+const char *DashPublisher::GetMasterPlayListFileName() const
+{
+	return DASH_MASTER_PLAYLIST_FULL_FILE_NAME;
+}
+
+std::shared_ptr<const PlayListData> DashPublisher::MakeMasterPlayList(const std::vector<std::shared_ptr<SegmentStream>> &renditions)
+{
+	std::ostringstream video_stream;
+	std::ostringstream audio_stream;
+	ov::String start_time;
+	double time_shift_buffer_depth = 0.0;
+	double minimum_update_period = 0.0;
+	int representation_count = 0;
+
+	video_stream << std::fixed << std::setprecision(3);
+
+	for (const auto &rendition : renditions)
+	{
+		auto rendition_data = rendition->GetRendition();
+
+		if (rendition_data == nullptr)
+		{
+			// Not ready yet (or packaged by LLDASH, or with $Number$ that has no timeline)
+			continue;
+		}
+
+		// Each rendition has its own SegmentTimeline, the segments are in the directory of the stream
+		auto &video_track = rendition->GetVideoTrack();
+		auto &audio_track = rendition->GetAudioTrack();
+		ov::String path = ov::String::FormatString("../%s/", rendition->GetName().CStr());
+
+		if ((video_track != nullptr) && (rendition_data->video_timeline.IsEmpty() == false))
+		{
+			video_stream
+				<< "\t\t\t<Representation id=\"" << rendition->GetName().CStr() << "_video\" codecs=\"avc1.42401f\" sar=\"1:1\""
+				<< " width=\"" << video_track->GetWidth() << "\" height=\"" << video_track->GetHeight()
+				<< "\" frameRate=\"" << video_track->GetFrameRate() << "\" bandwidth=\"" << video_track->GetBitrate() << "\">\n"
+				<< "\t\t\t\t<SegmentTemplate timescale=\"" << static_cast<uint32_t>(video_track->GetTimeBase().GetTimescale())
+				<< "\" initialization=\"" << path.CStr() << DASH_MPD_VIDEO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << path.CStr() << rendition->GetName().CStr() << "_$Time$" << DASH_MPD_VIDEO_FULL_SUFFIX << "\">\n"
+				<< "\t\t\t\t\t<SegmentTimeline>\n"
+				<< rendition_data->video_timeline.CStr()
+				<< "\t\t\t\t\t</SegmentTimeline>\n"
+				<< "\t\t\t\t</SegmentTemplate>\n"
+				<< "\t\t\t</Representation>\n";
+		}
+
+		if ((audio_track != nullptr) && (rendition_data->audio_timeline.IsEmpty() == false))
+		{
+			audio_stream
+				<< "\t\t\t<Representation id=\"" << rendition->GetName().CStr() << "_audio\" codecs=\"mp4a.40.2\""
+				<< " audioSamplingRate=\"" << audio_track->GetSampleRate() << "\" bandwidth=\"" << audio_track->GetBitrate() << "\">\n"
+				<< "\t\t\t\t<AudioChannelConfiguration schemeIdUri=\"urn:mpeg:dash:23003:3:audio_channel_configuration:2011\" value=\""
+				<< audio_track->GetChannel().GetCounts() << "\"/>\n"
+				<< "\t\t\t\t<SegmentTemplate timescale=\"" << static_cast<uint32_t>(audio_track->GetTimeBase().GetTimescale())
+				<< "\" initialization=\"" << path.CStr() << DASH_MPD_AUDIO_FULL_INIT_FILE_NAME
+				<< "\" media=\"" << path.CStr() << rendition->GetName().CStr() << "_$Time$" << DASH_MPD_AUDIO_FULL_SUFFIX << "\">\n"
+				<< "\t\t\t\t\t<SegmentTimeline>\n"
+				<< rendition_data->audio_timeline.CStr()
+				<< "\t\t\t\t\t</SegmentTimeline>\n"
+				<< "\t\t\t\t</SegmentTemplate>\n"
+				<< "\t\t\t</Representation>\n";
+		}
+
+		// The earliest rendition (the timestamps of the segments are the same for all renditions)
+		if (start_time.IsEmpty() || (rendition_data->start_time < start_time))
+		{
+			start_time = rendition_data->start_time;
+		}
+
+		time_shift_buffer_depth = std::max(time_shift_buffer_depth, rendition_data->time_shift_buffer_depth);
+		minimum_update_period = (representation_count == 0) ? rendition_data->minimum_update_period : std::min(minimum_update_period, rendition_data->minimum_update_period);
+
+		representation_count++;
+	}
+
+	if (representation_count == 0)
+	{
+		return nullptr;
+	}
+
+	std::ostringstream play_list_stream;
+	auto video_representations = video_stream.str();
+	auto audio_representations = audio_stream.str();
+
+	play_list_stream
+		<< std::fixed << std::setprecision(3)
+		<< "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		   "<MPD xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+		   "\txmlns=\"urn:mpeg:dash:schema:mpd:2011\"\n"
+		   "\txmlns:xlink=\"http://www.w3.org/1999/xlink\"\n"
+		   "\txsi:schemaLocation=\"urn:mpeg:DASH:schema:MPD:2011 http://standards.iso.org/ittf/PubliclyAvailableStandards/MPEG-DASH_schema_files/DASH-MPD.xsd\"\n"
+		   "\tprofiles=\"urn:mpeg:dash:profile:isoff-live:2011\"\n"
+		   "\ttype=\"dynamic\"\n"
+		<< "\tminimumUpdatePeriod=\"PT" << minimum_update_period << "S\"\n"
+		<< "\tpublishTime=\"" << Packetizer::MakeUtcSecond(::time(nullptr)).CStr() << "\"\n"
+		<< "\tavailabilityStartTime=\"" << start_time.CStr() << "\"\n"
+		<< "\ttimeShiftBufferDepth=\"PT" << time_shift_buffer_depth << "S\"\n"
+		<< "\tminBufferTime=\"PT2S\">\n"
+		<< "\t<Period id=\"0\" start=\"PT0S\">\n";
+
+	if (video_representations.empty() == false)
+	{
+		play_list_stream
+			<< "\t\t<AdaptationSet group=\"1\" mimeType=\"video/mp4\" segmentAlignment=\"true\" startWithSAP=\"1\" subsegmentAlignment=\"true\" subsegmentStartsWithSAP=\"1\">\n"
+			<< video_representations
+			<< "\t\t</AdaptationSet>\n";
+	}
+
+	if (audio_representations.empty() == false)
+	{
+		play_list_stream
+			<< "\t\t<AdaptationSet group=\"2\" mimeType=\"audio/mp4\" lang=\"und\" segmentAlignment=\"true\" startWithSAP=\"1\" subsegmentAlignment=\"true\" subsegmentStartsWithSAP=\"1\">\n"
+			<< audio_representations
+			<< "\t\t</AdaptationSet>\n";
+	}
+
+	play_list_stream << "\t</Period>\n"
+					 << "\t<UTCTiming schemeIdUri=\"urn:mpeg:dash:utc:direct:2014\" value=\"" DASH_MPD_UTC_TIMING_PLACEHOLDER "\"/>\n"
+					 << "</MPD>\n";
+
+	ov::String play_list = play_list_stream.str().c_str();
+
+	// The current time is inserted for each request, so it is not revalidated with the ETag
+	return Packetizer::MakePlayListData(play_list, MakeETag(play_list), DASH_MPD_UTC_TIMING_PLACEHOLDER);
 }
\ No newline at end of file
@@ -17,11 +17,20 @@ std::shared_ptr<DashStream> DashStream::Create(int segment_count,
                                               int segment_duration,
                                               const std::shared_ptr<pub::Application> application,
                                               const info::Stream &info,
-                                              uint32_t worker_count)
+                                              uint32_t worker_count,
+                                              bool share_cmaf_packaging,
+                                              const std::shared_ptr<SegmentStorage> &segment_storage,
+                                              const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options,
+                                              bool use_number_template,
+                                              int on_demand_idle_timeout)
 {
-    auto stream = std::make_shared<DashStream>(application, info);
+    auto stream = std::make_shared<DashStream>(application, info, share_cmaf_packaging);
 
-    if (!stream->Start(segment_count, segment_duration, 0))
+    // Must be set before Start() creates the packetizer
+    stream->_use_number_template = use_number_template;
+    stream->SetOnDemand(on_demand_idle_timeout);
+
+    if (!stream->Start(segment_count, segment_duration, 0, segment_storage, thumbnail_options))
     {
         return nullptr;
     }
@@ -34,8 +43,9 @@ std::shared_ptr<DashStream> DashStream::Create(int segment_count,
 // - DASH/HLS : H264/AAC only
 // TODO : 다중 트랜스코딩/다중 트랙 구분 및 처리 필요
 //====================================================================================================
-DashStream::DashStream(const std::shared_ptr<pub::Application> application, const info::Stream &info)
-                    : SegmentStream(application, info)
+DashStream::DashStream(const std::shared_ptr<pub::Application> application, const info::Stream &info, bool share_cmaf_packaging)
+                    : SegmentStream(application, info),
+                      _share_cmaf_packaging(share_cmaf_packaging)
 {
 
 }
@@ -12,6 +12,7 @@
 #include "base/publisher/application.h"
 #include "base/publisher/stream.h"
 #include "dash_stream_packetizer.h"
+#include "../cmaf/cmaf_stream_packetizer.h"
 
 //====================================================================================================
 // DashStream
@@ -23,9 +24,14 @@ public:
                                                int segment_duration,
                                                const std::shared_ptr<pub::Application> application,
                                                const info::Stream &info,
-                                               uint32_t worker_count);
+                                               uint32_t worker_count,
+                                               bool share_cmaf_packaging = false,
+                                               const std::shared_ptr<SegmentStorage> &segment_storage = nullptr,
+                                               const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options = nullptr,
+                                               bool use_number_template = false,
+                                               int on_demand_idle_timeout = 0);
 
-	DashStream(const std::shared_ptr<pub::Application> application, const info::Stream &info);
+	DashStream(const std::shared_ptr<pub::Application> application, const info::Stream &info, bool share_cmaf_packaging = false);
 
 	~DashStream();
 
@@ -35,17 +41,38 @@ public:
                                                             PacketizerStreamType stream_type,
                                                             std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track) override
     {
+        if (_share_cmaf_packaging)
+        {
+            // The segments of LLDASH are served with the names of DASH
+            auto stream_packetizer = std::make_shared<CmafStreamPacketizer>(GetApplication()->GetName(),
+                                                                            GetName(),
+                                                                            GetId(),
+                                                                            segment_count,
+                                                                            segment_duration,
+                                                                            segment_prefix,
+                                                                            stream_type,
+                                                                            video_track, audio_track,
+                                                                            nullptr,
+                                                                            CmafPackagingView::Dash);
+
+            return std::static_pointer_cast<StreamPacketizer>(stream_packetizer);
+        }
+
         auto stream_packetizer = std::make_shared<DashStreamPacketizer>(GetApplication()->GetName(),
                                                                         GetName(),
                                                                         segment_count,
                                                                         segment_duration,
                                                                         segment_prefix,
                                                                         stream_type,
-                                                                        video_track, audio_track);
+                                                                        video_track, audio_track,
+                                                                        _use_number_template);
 
         return std::static_pointer_cast<StreamPacketizer>(stream_packetizer);
     }
 
 private:
-
+	// Use the CMAF packaging of LLDASH instead of packaging the frames again
+	bool _share_cmaf_packaging = false;
+	// The MPD uses $Number$ instead of SegmentTimeline (the CMAF packaging always uses $Number$)
+	bool _use_number_template = false;
 };
@@ -39,7 +39,7 @@ HttpConnection DashStreamServer::ProcessPlayListRequest(const std::shared_ptr<Ht
 {
 	auto response = client->GetResponse();
 
-	ov::String play_list;
+	std::shared_ptr<const PlayListData> play_list;
 
 	auto item = std::find_if(_observers.begin(), _observers.end(),
 							 [&client, &app_name, &stream_name, &file_name, &play_list](auto &observer) -> bool {
@@ -55,20 +55,13 @@ HttpConnection DashStreamServer::ProcessPlayListRequest(const std::shared_ptr<Ht
 		return HttpConnection::Closed;
 	}
 
-	if(response->GetStatusCode() != HttpStatusCode::OK || play_list.IsEmpty())
+	if(response->GetStatusCode() != HttpStatusCode::OK || play_list == nullptr)
 	{
 		response->Response();
 		return HttpConnection::Closed;
 	}
 
-	// Set HTTP header
-	response->SetHeader("Content-Type", "application/dash+xml");
-	response->SetHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-	response->SetHeader("Pragma", "no-cache");
-	response->SetHeader("Expires", "0");
-		
-	response->AppendString(play_list);
-	response->Response();
+	ResponsePlayList(client, play_list, "application/dash+xml");
 
 	return HttpConnection::Closed;
 }
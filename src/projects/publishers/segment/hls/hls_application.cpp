@@ -30,6 +30,7 @@ std::shared_ptr<HlsApplication> HlsApplication::Create(const std::shared_ptr<pub
 HlsApplication::HlsApplication(const std::shared_ptr<pub::Publisher> &publisher, const info::Application &application_info)
 	: Application(publisher, application_info)
 {
+	SetDirectDispatch(true);
 }
 
 //====================================================================================================
@@ -50,6 +51,20 @@ bool HlsApplication::Start()
 
 	_segment_count = publisher_info->GetSegmentCount();
 	_segment_duration = publisher_info->GetSegmentDuration();
+	_segment_storage = SegmentStorage::Create(publisher_info->GetSegmentStoragePath());
+	_thumbnail_options = SegmentStream::GetThumbnailOptions(publisher_info->GetThumbnail());
+	_on_demand_idle_timeout = SegmentStream::GetOnDemandIdleTimeout(publisher_info->GetOnDemand());
+
+	auto &encryption_config = publisher_info->GetEncryption();
+
+	if (encryption_config.IsEnabled())
+	{
+		auto encryption_options = std::make_shared<SegmentEncryptor::Options>();
+
+		encryption_options->key_rotation = encryption_config.GetKeyRotation();
+
+		_encryption_options = encryption_options;
+	}
 
 	return Application::Start();
 }
@@ -74,7 +89,11 @@ std::shared_ptr<pub::Stream> HlsApplication::CreateStream(const std::shared_ptr<
                              _segment_duration,
                              GetSharedPtrAs<pub::Application>(),
                              *info.get(),
-							 thread_count);
+							 thread_count,
+							 _segment_storage,
+							 _thumbnail_options,
+							 _encryption_options,
+							 _on_demand_idle_timeout);
 }
 
 //====================================================================================================
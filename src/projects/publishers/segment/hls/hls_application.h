@@ -10,6 +10,7 @@
 #pragma once
 #include "base/common_types.h"
 #include "base/publisher/application.h"
+#include <publishers/segment/segment_stream/packetizer/segment_encryptor.h>
 #include <publishers/segment/segment_stream/segment_stream.h>
 
 //====================================================================================================
@@ -35,4 +36,11 @@ private:
 private :
     int _segment_count;
     int _segment_duration;
+    std::shared_ptr<SegmentStorage> _segment_storage;
+    // nullptr if <Thumbnail> is disabled
+    std::shared_ptr<const TranscodeThumbnail::Options> _thumbnail_options;
+    // nullptr if <Encryption> is disabled
+    std::shared_ptr<const SegmentEncryptor::Options> _encryption_options;
+    // 0 if <OnDemand> is disabled
+    int _on_demand_idle_timeout = 0;
 };
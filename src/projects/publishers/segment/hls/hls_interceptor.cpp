@@ -10,6 +10,8 @@
 #include "hls_interceptor.h"
 #include "hls_private.h"
 
+#include "../dash/dash_define.h"
+
 HlsInterceptor::HlsInterceptor()
 {
 
@@ -35,6 +37,12 @@ bool HlsInterceptor::IsInterceptorForRequest(const std::shared_ptr<const HttpCli
 		return false;
 	}
 
+    // LL-HLS playlists are served by LLDASH publisher
+    if(request->GetRequestTarget().IndexOf(CMAF_HLS_PLAYLIST_FULL_SUFFIX) >= 0)
+    {
+        return false;
+    }
+
     // ts/m3u8
     if((request->GetRequestTarget().IndexOf(".ts") >= 0) ||
        (request->GetRequestTarget().IndexOf(".m3u8") >= 0) ||
@@ -16,6 +16,7 @@
 #include <sstream>
 
 #include <base/ovlibrary/ovlibrary.h>
+#include <base/ovlibrary/probe.h>
 #include <publishers/segment/segment_stream/packetizer/packetizer_define.h>
 
 #define HLS_MAX_TEMP_VIDEO_DATA_COUNT (500)
@@ -28,7 +29,8 @@ HlsPacketizer::HlsPacketizer(const ov::String &app_name,
 							 const ov::String &segment_prefix,
 							 uint32_t segment_count,
 							 uint32_t segment_duration,
-							 std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track)
+							 std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+							 const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options)
 	: Packetizer(app_name,
 				 stream_name,
 				 PacketizerType::Hls,
@@ -47,6 +49,14 @@ HlsPacketizer::HlsPacketizer(const ov::String &app_name,
 	_duration_margin = _segment_duration * 0.1;
 
 	_stat_stop_watch.Start();
+
+	if (encryption_options != nullptr)
+	{
+		// Keeps the keys of all segments in the segment ring (+1 for the key of the segment being made)
+		size_t key_count = (encryption_options->key_rotation > 0) ? ((_segment_save_count / encryption_options->key_rotation) + 2) : 1;
+
+		_encryptor = std::make_shared<SegmentEncryptor>(*encryption_options, key_count);
+	}
 }
 
 bool HlsPacketizer::AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &frame_data)
@@ -141,6 +151,15 @@ bool HlsPacketizer::SegmentWrite(int64_t start_timestamp, uint64_t duration)
 
 	auto ts_writer = std::make_shared<TsWriter>(_video_enable, _audio_enable);
 
+	size_t total_frame_size = 0;
+
+	for (auto &frame_data : _frame_datas)
+	{
+		total_frame_size += frame_data->data->GetLength();
+	}
+
+	ts_writer->Reserve(_frame_datas.size(), total_frame_size);
+
 	for (auto &frame_data : _frame_datas)
 	{
 		// Write TS(PES)
@@ -173,6 +192,22 @@ bool HlsPacketizer::SegmentWrite(int64_t start_timestamp, uint64_t duration)
 
 	auto ts_data = ts_writer->GetDataStream();
 
+	if (_encryptor != nullptr)
+	{
+		// Encrypted once here, all requests of the segment share it
+		ts_data = _encryptor->Encrypt(_sequence_number, ts_data);
+
+		if (ts_data == nullptr)
+		{
+			logte("Could not encrypt the HLS segment #%u for stream [%s/%s]", _sequence_number, _app_name.CStr(), _stream_name.CStr());
+
+			_video_enable = false;
+			_audio_enable = false;
+
+			return false;
+		}
+	}
+
 	SetSegmentData(ov::String::FormatString("%s_%u.ts", _segment_prefix.CStr(), _sequence_number),
 				   duration,
 				   start_timestamp,
@@ -201,6 +236,14 @@ bool HlsPacketizer::UpdatePlayList()
 
 	for (const auto &segment_data : segment_datas)
 	{
+		if (_encryptor != nullptr)
+		{
+			// The IV is written explicitly since #EXT-X-MEDIA-SEQUENCE is not the sequence number of the first segment
+			m3u8_play_list << "#EXT-X-KEY:METHOD=AES-128,URI=\"" << _segment_prefix.CStr() << "_"
+						   << _encryptor->GetKeyIndex(segment_data->sequence_number) << "." HLS_KEY_EXT "\","
+						   << "IV=" << SegmentEncryptor::MakeIvString(segment_data->sequence_number).CStr() << "\r\n";
+		}
+
 		m3u8_play_list << "#EXTINF:" << std::fixed << std::setprecision(0)
 					   << (double)(segment_data->duration) / (double)(PACKTYZER_DEFAULT_TIMESCALE) << "\r\n"
 					   << segment_data->file_name.CStr() << "\r\n";
@@ -245,20 +288,14 @@ const std::shared_ptr<SegmentData> HlsPacketizer::GetSegmentData(const ov::Strin
 		return nullptr;
 	}
 
-	// video segment mutex
-	std::unique_lock<std::mutex> lock(_video_segment_guard);
+	int64_t number;
 
-	auto item = std::find_if(_video_segment_datas.begin(),
-							 _video_segment_datas.end(), [&](std::shared_ptr<SegmentData> const &value) -> bool {
-								 return value != nullptr ? value->file_name == file_name : false;
-							 });
-
-	if (item == _video_segment_datas.end())
+	if (ParseSegmentNumber(file_name, &number) == false)
 	{
 		return nullptr;
 	}
 
-	return (*item);
+	return _video_segments.Find(number, file_name);
 }
 
 bool HlsPacketizer::SetSegmentData(ov::String file_name,
@@ -266,24 +303,28 @@ bool HlsPacketizer::SetSegmentData(ov::String file_name,
 								   int64_t timestamp,
 								   std::shared_ptr<ov::Data> &data)
 {
+	OV_PROBE6(segment_close, _app_name.CStr(), _stream_name.CStr(), static_cast<int>(common::MediaType::Unknown), timestamp, duration, data->GetLength());
+
+	auto stored_data = StoreSegmentData(data);
+
 	auto segment_data = std::make_shared<SegmentData>(
 		common::MediaType::Unknown,
 		_sequence_number++,
 		file_name,
 		timestamp,
 		duration,
-		data);
-
-	// video segment mutex
-	std::unique_lock<std::mutex> lock(_video_segment_guard);
+		stored_data);
 
-	_video_segment_datas[_current_video_index++] = segment_data;
+	int64_t number = 0;
 
-	if (_segment_save_count <= _current_video_index)
+	if (ParseSegmentNumber(file_name, &number) == false)
 	{
-		_current_video_index = 0;
+		logte("Could not parse the number of the segment: %s", file_name.CStr());
+		return false;
 	}
 
+	_video_segments.Push(number, segment_data);
+
 	if ((IsReadyForStreaming() == false) && (_sequence_number > _segment_count))
 	{
 		SetReadyForStreaming();
@@ -294,3 +335,15 @@ bool HlsPacketizer::SetSegmentData(ov::String file_name,
 
 	return true;
 }
+
+std::shared_ptr<const ov::Data> HlsPacketizer::GetKey(const ov::String &file_name) const
+{
+	int64_t number;
+
+	if ((_encryptor == nullptr) || (file_name.HasSuffix("." HLS_KEY_EXT) == false) || (ParseSegmentNumber(file_name, &number) == false) || (number < 0))
+	{
+		return nullptr;
+	}
+
+	return _encryptor->GetKey(static_cast<uint32_t>(number));
+}
@@ -8,6 +8,7 @@
 //==============================================================================
 
 #pragma once
+#include <publishers/segment/segment_stream/packetizer/segment_encryptor.h>
 #include <publishers/segment/segment_stream/packetizer/ts_writer.h>
 
 //====================================================================================================
@@ -24,7 +25,8 @@ public:
                 const ov::String &segment_prefix,
                 uint32_t segment_count,
                 uint32_t segment_duration,
-                std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track);
+                std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+                const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options = nullptr);
 
 	~HlsPacketizer() = default;
 
@@ -45,6 +47,8 @@ public :
 								int64_t timestamp,
 								std::shared_ptr<ov::Data> &data) override;
 
+    std::shared_ptr<const ov::Data> GetKey(const ov::String &file_name) const override;
+
     bool SegmentWrite(int64_t start_timestamp, uint64_t duration);
 
 protected : 	
@@ -60,5 +64,8 @@ protected :
     bool _video_enable;
 
     ov::StopWatch _stat_stop_watch;
+
+    // nullptr if the segments are not encrypted
+    std::shared_ptr<SegmentEncryptor> _encryptor;
 };
 
@@ -12,4 +12,8 @@
 
 #define HLS_SEGMENT_EXT 		"ts"
 #define HLS_PLAYLIST_EXT 		"m3u8"
+// The key of the encrypted segments (<prefix>_<key index>.key)
+#define HLS_KEY_EXT 			"key"
 #define HLS_PLAYLIST_FILE_NAME 	"playlist.m3u8"
+// The master playlist of a stream group (<app>/<group>/master.m3u8)
+#define HLS_MASTER_PLAYLIST_FILE_NAME 	"master.m3u8"
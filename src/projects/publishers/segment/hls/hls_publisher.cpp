@@ -15,6 +15,9 @@
 #include <modules/signed_url/signed_url.h>
 #include <orchestrator/orchestrator.h>
 
+#include <iomanip>
+#include <sstream>
+
 std::shared_ptr<HlsPublisher> HlsPublisher::Create(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager,
 												   const cfg::Server &server_config,
 												   const std::shared_ptr<MediaRouteInterface> &router)
@@ -50,4 +53,63 @@ std::shared_ptr<pub::Application> HlsPublisher::OnCreatePublisherApplication(con
 bool HlsPublisher::OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application)
 {
 	return true;
+}
+
+const char *HlsPublisher::GetMasterPlayListFileName() const
+{
+	return HLS_MASTER_PLAYLIST_FILE_NAME;
+}
+
+const char *HlsPublisher::GetPlayListFileName() const
+{
+	return HLS_PLAYLIST_FILE_NAME;
+}
+
+std::shared_ptr<const PlayListData> HlsPublisher::MakeMasterPlayList(const std::vector<std::shared_ptr<SegmentStream>> &renditions)
+{
+	std::ostringstream play_list_stream;
+
+	play_list_stream
+		<< "#EXTM3U\n"
+		<< "#EXT-X-VERSION:3\n"
+		// The keyframes of the renditions are aligned by the transcoder
+		<< "#EXT-X-INDEPENDENT-SEGMENTS\n";
+
+	for (const auto &rendition : renditions)
+	{
+		auto &video_track = rendition->GetVideoTrack();
+		auto &audio_track = rendition->GetAudioTrack();
+		std::vector<ov::String> codecs;
+
+		if (video_track != nullptr)
+		{
+			codecs.emplace_back("avc1.42401f");
+		}
+
+		if (audio_track != nullptr)
+		{
+			codecs.emplace_back("mp4a.40.2");
+		}
+
+		play_list_stream << "#EXT-X-STREAM-INF:BANDWIDTH=" << GetBandwidth(rendition) << ",CODECS=\"" << ov::String::Join(codecs, ",").CStr() << "\"";
+
+		if (video_track != nullptr)
+		{
+			play_list_stream << ",RESOLUTION=" << video_track->GetWidth() << "x" << video_track->GetHeight();
+
+			if (video_track->GetFrameRate() > 0.0)
+			{
+				play_list_stream << ",FRAME-RATE=" << std::fixed << std::setprecision(3) << video_track->GetFrameRate();
+			}
+		}
+
+		// The playlist of the rendition is in the directory of the stream
+		play_list_stream
+			<< "\n"
+			<< "../" << rendition->GetName().CStr() << "/" HLS_PLAYLIST_FILE_NAME "\n";
+	}
+
+	ov::String play_list = play_list_stream.str().c_str();
+
+	return Packetizer::MakePlayListData(play_list, MakeETag(play_list));
 }
\ No newline at end of file
@@ -31,6 +31,13 @@ protected:
 	std::shared_ptr<pub::Application> OnCreatePublisherApplication(const info::Application &application_info) override;
 	bool OnDeletePublisherApplication(const std::shared_ptr<pub::Application> &application) override;
 
+	//--------------------------------------------------------------------
+	// Stream group
+	//--------------------------------------------------------------------
+	const char *GetMasterPlayListFileName() const override;
+	const char *GetPlayListFileName() const override;
+	std::shared_ptr<const PlayListData> MakeMasterPlayList(const std::vector<std::shared_ptr<SegmentStream>> &renditions) override;
+
 	PublisherType GetPublisherType() const override
 	{
 		return PublisherType::Hls;
@@ -17,11 +17,19 @@ std::shared_ptr<HlsStream> HlsStream::Create(int segment_count,
                                              int segment_duration,
                                              const std::shared_ptr<pub::Application> application,
                                              const info::Stream &info,
-                                             uint32_t worker_count)
+                                             uint32_t worker_count,
+                                             const std::shared_ptr<SegmentStorage> &segment_storage,
+                                             const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options,
+                                             const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options,
+                                             int on_demand_idle_timeout)
 {
     auto stream = std::make_shared<HlsStream>(application, info);
 
-    if (!stream->Start(segment_count, segment_duration, 0))
+    // Must be set before Start() creates the packetizer
+    stream->_encryption_options = encryption_options;
+    stream->SetOnDemand(on_demand_idle_timeout);
+
+    if (!stream->Start(segment_count, segment_duration, 0, segment_storage, thumbnail_options))
     {
         return nullptr;
     }
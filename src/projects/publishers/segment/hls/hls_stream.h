@@ -23,7 +23,11 @@ public:
 											 int segment_duration,
 											 const std::shared_ptr<pub::Application> application,
 											 const info::Stream &info,
-											 uint32_t worker_count);
+											 uint32_t worker_count,
+											 const std::shared_ptr<SegmentStorage> &segment_storage = nullptr,
+											 const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options = nullptr,
+											 const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options = nullptr,
+											 int on_demand_idle_timeout = 0);
 
 	HlsStream(const std::shared_ptr<pub::Application> application, const info::Stream &info);
 
@@ -41,10 +45,13 @@ public:
 																	   segment_duration,
 																	   segment_prefix,
 																	   stream_type,
-																	   video_track, audio_track);
+																	   video_track, audio_track,
+																	   _encryption_options);
 
 		return std::static_pointer_cast<StreamPacketizer>(stream_packetizer);
 	}
 
 private:
+	// nullptr if the segments are not encrypted
+	std::shared_ptr<const SegmentEncryptor::Options> _encryption_options;
 };
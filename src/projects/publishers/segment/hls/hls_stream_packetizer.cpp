@@ -19,7 +19,8 @@ HlsStreamPacketizer::HlsStreamPacketizer(const ov::String &app_name,
                                         int segment_duration,
                                         const ov::String &segment_prefix,
                                         PacketizerStreamType stream_type,
-                                        std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track) :
+                                        std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+                                        const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options) :
                                         StreamPacketizer(app_name,
                                                         stream_name,
                                                         segment_count,
@@ -33,7 +34,8 @@ HlsStreamPacketizer::HlsStreamPacketizer(const ov::String &app_name,
                                                 segment_prefix,
                                                 segment_count,
                                                 segment_duration,
-                                                video_track, audio_track);
+                                                video_track, audio_track,
+                                                encryption_options);
 }
 
 //====================================================================================================
@@ -63,9 +65,9 @@ bool HlsStreamPacketizer::AppendAudioFrame(std::shared_ptr<PacketizerFrameData>
 // Get PlayList
 // - M3U8
 //====================================================================================================
-bool HlsStreamPacketizer::GetPlayList(ov::String &play_list)
+bool HlsStreamPacketizer::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
 {
-    return _packetizer->GetPlayList(play_list);
+    return _packetizer->GetPlayList(file_name, play_list);
 }
 
 //====================================================================================================
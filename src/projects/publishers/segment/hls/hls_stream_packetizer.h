@@ -24,7 +24,8 @@ public:
                         int segment_duration,
                         const ov::String &segment_prefix,
                         PacketizerStreamType stream_type,
-                        std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track);
+                        std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track,
+                        const std::shared_ptr<const SegmentEncryptor::Options> &encryption_options = nullptr);
 
     virtual ~HlsStreamPacketizer();
 
@@ -33,7 +34,7 @@ public :
     // Implement StreamPacketizer Interface
     bool AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &data) override;
     bool AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &data) override;
-    bool GetPlayList(ov::String &play_list) override;
+    bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list) override;
 	std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) override;
 
 private :
@@ -18,7 +18,7 @@ HttpConnection HlsStreamServer::ProcessStreamRequest(const std::shared_ptr<HttpC
 {
 	auto response = client->GetResponse();
 
-	if (file_name == HLS_PLAYLIST_FILE_NAME)
+	if ((file_name == HLS_PLAYLIST_FILE_NAME) || (file_name == HLS_MASTER_PLAYLIST_FILE_NAME))
 	{
 		return ProcessPlayListRequest(client, app_name, stream_name, file_name, PlayListType::M3u8);
 	}
@@ -26,6 +26,10 @@ HttpConnection HlsStreamServer::ProcessStreamRequest(const std::shared_ptr<HttpC
 	{
 		return ProcessSegmentRequest(client, app_name, stream_name, file_name, SegmentType::MpegTs);
 	}
+	else if (file_ext == HLS_KEY_EXT)
+	{
+		return ProcessKeyRequest(client, app_name, stream_name, file_name);
+	}
 
 	response->SetStatusCode(HttpStatusCode::NotFound);
 	response->Response();
@@ -39,7 +43,7 @@ HttpConnection HlsStreamServer::ProcessPlayListRequest(const std::shared_ptr<Htt
 {
 	auto response = client->GetResponse();
 
-	ov::String play_list;
+	std::shared_ptr<const PlayListData> play_list;
 	std::shared_ptr<info::Stream> stream_info;
 
 	auto item = std::find_if(_observers.begin(), _observers.end(),
@@ -59,21 +63,19 @@ HttpConnection HlsStreamServer::ProcessPlayListRequest(const std::shared_ptr<Htt
 		return HttpConnection::Closed;
 	}
 
-	if(response->GetStatusCode() != HttpStatusCode::OK || play_list.IsEmpty())
+	if(response->GetStatusCode() != HttpStatusCode::OK || play_list == nullptr)
 	{
 		logte("Could not find a %s playlist for [%s/%s], %s : %d", GetPublisherName(), app_name.CStr(), stream_name.CStr(), file_name.CStr(), response->GetStatusCode());
 		response->Response();
 		return HttpConnection::Closed;
 	}
 
-	// Set HTTP header
-	response->SetHeader("Content-Type", "application/vnd.apple.mpegurl");
-	response->SetHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-	response->SetHeader("Pragma", "no-cache");
-	response->SetHeader("Expires", "0");
+	if (file_name == HLS_PLAYLIST_FILE_NAME)
+	{
+		play_list = AppendQueryStringToKeyUris(client, play_list);
+	}
 
-	response->AppendString(play_list);
-	auto sent_bytes = response->Response();
+	auto sent_bytes = ResponsePlayList(client, play_list, "application/vnd.apple.mpegurl");
 
 	if (stream_info != nullptr)
 	{
@@ -87,6 +89,33 @@ HttpConnection HlsStreamServer::ProcessPlayListRequest(const std::shared_ptr<Htt
 	return HttpConnection::Closed;
 }
 
+std::shared_ptr<const PlayListData> HlsStreamServer::AppendQueryStringToKeyUris(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const PlayListData> &play_list)
+{
+	auto parsed_url = ov::Url::Parse(client->GetRequest()->GetUri().CStr());
+
+	if ((parsed_url == nullptr) || parsed_url->Query().IsEmpty() || (play_list->head == nullptr))
+	{
+		return play_list;
+	}
+
+	ov::String key_uri_suffix = "." HLS_KEY_EXT "\"";
+	ov::String content(play_list->head->GetDataAs<char>(), play_list->head->GetLength());
+
+	if (content.IndexOf(key_uri_suffix.CStr()) < 0)
+	{
+		// The segments are not encrypted
+		return play_list;
+	}
+
+	// The shared playlist is not modified, a copy is made for the request (the ETag is the same, since the URL has the same query string)
+	auto new_play_list = std::make_shared<PlayListData>(*play_list);
+	auto new_content = content.Replace(key_uri_suffix.CStr(), ov::String::FormatString("." HLS_KEY_EXT "?%s\"", parsed_url->Query().CStr()).CStr());
+
+	new_play_list->head = new_content.ToData(false);
+
+	return new_play_list;
+}
+
 HttpConnection HlsStreamServer::ProcessSegmentRequest(const std::shared_ptr<HttpClient> &client,
 													  const ov::String &app_name, const ov::String &stream_name,
 													  const ov::String &file_name,
@@ -130,3 +159,53 @@ HttpConnection HlsStreamServer::ProcessSegmentRequest(const std::shared_ptr<Http
 
 	return HttpConnection::Closed;
 }
+
+HttpConnection HlsStreamServer::ProcessKeyRequest(const std::shared_ptr<HttpClient> &client,
+												  const ov::String &app_name, const ov::String &stream_name,
+												  const ov::String &file_name)
+{
+	auto response = client->GetResponse();
+
+	std::shared_ptr<const ov::Data> key;
+	std::shared_ptr<info::Stream> stream_info;
+
+	auto item = std::find_if(_observers.begin(), _observers.end(),
+							 [&client, &app_name, &stream_name, &file_name, &stream_info, &key](auto &observer) -> bool {
+								 return observer->OnKeyRequest(client, app_name, stream_name, file_name, stream_info, key);
+							 });
+
+	if (item == _observers.end())
+	{
+		logtd("Could not find HLS key: %s/%s, %s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		response->SetStatusCode(HttpStatusCode::NotFound);
+		response->Response();
+
+		return HttpConnection::Closed;
+	}
+
+	if ((response->GetStatusCode() != HttpStatusCode::OK) || (key == nullptr))
+	{
+		// The signed URL of the key is not valid
+		logtd("Could not serve HLS key: %s/%s, %s : %d", app_name.CStr(), stream_name.CStr(), file_name.CStr(), response->GetStatusCode());
+		response->Response();
+
+		return HttpConnection::Closed;
+	}
+
+	// The key must not be stored by the shared caches (such as CDN) with the encrypted segments
+	response->SetHeader("Content-Type", "application/octet-stream");
+	response->SetHeader("Cache-Control", "private, no-store");
+	response->AppendData(key);
+	auto sent_bytes = response->Response();
+
+	if (stream_info != nullptr)
+	{
+		auto stream_metric = StreamMetrics(*stream_info);
+		if (stream_metric != nullptr)
+		{
+			stream_metric->IncreaseBytesOut(PublisherType::Hls, sent_bytes);
+		}
+	}
+
+	return HttpConnection::Closed;
+}
@@ -47,4 +47,13 @@ protected:
 										 const ov::String &app_name, const ov::String &stream_name,
 										 const ov::String &file_name,
 										 SegmentType segment_type) override;
+
+	// The key of the encrypted segments (See <Encryption> of <HLS>)
+	HttpConnection ProcessKeyRequest(const std::shared_ptr<HttpClient> &client,
+									 const ov::String &app_name, const ov::String &stream_name,
+									 const ov::String &file_name);
+
+	// The keys are protected with the token of the playlist (See <SignedURL>), so the query string of the playlist request
+	// is carried to the URIs of #EXT-X-KEY. Returns play_list itself if it has no key or the request has no query string.
+	std::shared_ptr<const PlayListData> AppendQueryStringToKeyUris(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const PlayListData> &play_list);
 };
@@ -24,7 +24,7 @@ SegmentPublisher::~SegmentPublisher()
 	logtd("Publisher has been destroyed");
 }
 
-bool SegmentPublisher::Start(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager, const cfg::TlsPort &port_config, const std::shared_ptr<SegmentStreamServer> &stream_server)
+bool SegmentPublisher::Start(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager, const cfg::SegmentPort &port_config, const std::shared_ptr<SegmentStreamServer> &stream_server)
 {
 	auto server_config = GetServerConfig();
 	auto ip = server_config.GetIp();
@@ -44,9 +44,12 @@ bool SegmentPublisher::Start(std::map<int, std::shared_ptr<HttpServer>> &http_se
 	// TODO(Dimiden): The Cross Domain configure must be at VHost Level.
 	//stream_server->SetCrossDomain(cross_domains);
 
+	stream_server->SetKeepAlive(port_config.GetKeepAliveTimeout(), port_config.GetMaxKeepAliveRequests());
+
 	// Start the DASH Server
 	if (stream_server->Start(has_port ? &address : nullptr, has_tls_port ? &tls_address : nullptr,
-							 http_server_manager, DEFAULT_SEGMENT_WORKER_THREAD_COUNT) == false)
+							 http_server_manager, DEFAULT_SEGMENT_WORKER_THREAD_COUNT,
+							 port_config.GetReactorCount(), port_config.GetWorkerCount(), port_config.GetWorkerAffinity()) == false)
 	{
 		logte("An error occurred while start %s Publisher", GetPublisherName());
 		return false;
@@ -54,6 +57,17 @@ bool SegmentPublisher::Start(std::map<int, std::shared_ptr<HttpServer>> &http_se
 
 	_stream_server = stream_server;
 
+	auto &low_latency_config = port_config.GetLowLatency();
+
+	if (low_latency_config.IsEnabled())
+	{
+		stream_server->SetLowLatencyOptions(low_latency_config.ToSocketOptions());
+
+		logti("%s uses the low latency egress (not sent low watermark: %d bytes, max pacing rate: %d Kbps, max queue delay: %d ms)",
+			  GetPublisherName(),
+			  low_latency_config.GetNotSentLowWatermark(), low_latency_config.GetMaxPacingRate(), low_latency_config.GetMaxQueueDelay());
+	}
+
 	logti("%s has started listening on %s%s%s%s...",
 		  GetPublisherName(),
 		  has_port ? address.ToString().CStr() : "",
@@ -85,7 +99,7 @@ bool SegmentPublisher::GetMonitoringCollectionData(std::vector<std::shared_ptr<p
 bool SegmentPublisher::OnPlayListRequest(const std::shared_ptr<HttpClient> &client,
 										 const ov::String &app_name, const ov::String &stream_name,
 										 const ov::String &file_name,
-										 ov::String &play_list)
+										 std::shared_ptr<const PlayListData> &play_list)
 {
 	auto request = client->GetRequest();
 	auto uri = request->GetUri();
@@ -114,6 +128,13 @@ bool SegmentPublisher::OnPlayListRequest(const std::shared_ptr<HttpClient> &clie
 		}
 	}
 
+	auto master_play_list_file_name = GetMasterPlayListFileName();
+	if ((master_play_list_file_name != nullptr) && (file_name == master_play_list_file_name))
+	{
+		// <app>/<group>/master.*
+		return OnMasterPlayListRequest(client, app_name, stream_name, play_list);
+	}
+
 	auto stream = GetStreamAs<SegmentStream>(app_name, stream_name);
 	if (stream == nullptr)
 	{
@@ -174,7 +195,19 @@ bool SegmentPublisher::OnPlayListRequest(const std::shared_ptr<HttpClient> &clie
 		else
 		{
 			// If the stream does not exists, request to the provider
-			if (orchestrator->RequestPullStream(app_name, stream_name) == false)
+			// The HTTP worker does not wait for the pull in progress, and the player retries like the playlist that is not ready yet
+			auto pull_result = orchestrator->RequestPullStreamAsync(app_name, stream_name, 0, nullptr);
+
+			if (pull_result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				logtd("The stream is being pulled: %s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
+				client->GetResponse()->SetStatusCode(HttpStatusCode::Accepted);
+
+				// Returns true when the observer search can be ended.
+				return true;
+			}
+
+			if (pull_result.get() == false)
 			{
 				logte("Could not request pull stream for URL : %s/%s/%s", app_name.CStr(), stream_name.CStr(), file_name.CStr());
 				client->GetResponse()->SetStatusCode(HttpStatusCode::NotAcceptable);
@@ -197,7 +230,7 @@ bool SegmentPublisher::OnPlayListRequest(const std::shared_ptr<HttpClient> &clie
 		return false;
 	}
 
-	if (stream->GetPlayList(play_list) == false)
+	if (stream->GetPlayList(file_name, &play_list) == false)
 	{
 		logtw("Could not get a playlist for %s [%p, %s/%s, %s]", GetPublisherName(), stream.get(), app_name.CStr(), stream_name.CStr(), file_name.CStr());
 		client->GetResponse()->SetStatusCode(HttpStatusCode::Accepted);
@@ -209,6 +242,163 @@ bool SegmentPublisher::OnPlayListRequest(const std::shared_ptr<HttpClient> &clie
 	return true;
 }
 
+bool SegmentPublisher::OnMasterPlayListRequest(const std::shared_ptr<HttpClient> &client,
+											   const ov::String &app_name, const ov::String &group_name,
+											   std::shared_ptr<const PlayListData> &play_list)
+{
+	std::vector<std::shared_ptr<SegmentStream>> renditions;
+	auto application = GetApplicationByName(app_name);
+
+	if (application != nullptr)
+	{
+		for (const auto &stream : application->GetStreamList())
+		{
+			auto segment_stream = std::static_pointer_cast<SegmentStream>(stream);
+
+			if ((segment_stream->GetGroupName() == group_name) &&
+				((segment_stream->GetVideoTrack() != nullptr) || (segment_stream->GetAudioTrack() != nullptr)))
+			{
+				renditions.push_back(segment_stream);
+			}
+		}
+	}
+
+	if (renditions.empty())
+	{
+		logtw("Could not find a stream group for %s [%s/%s]", GetPublisherName(), app_name.CStr(), group_name.CStr());
+
+		// This means it need to query the next observer.
+		return false;
+	}
+
+	// The players usually start with the first rendition, so the lowest bandwidth comes first
+	std::stable_sort(renditions.begin(), renditions.end(), [](const auto &rendition1, const auto &rendition2) -> bool {
+		return GetBandwidth(rendition1) < GetBandwidth(rendition2);
+	});
+
+	play_list = MakeMasterPlayList(renditions);
+
+	if (play_list == nullptr)
+	{
+		logtd("The renditions of the stream group are not ready for %s [%s/%s]", GetPublisherName(), app_name.CStr(), group_name.CStr());
+		client->GetResponse()->SetStatusCode(HttpStatusCode::Accepted);
+
+		// Returns true when the observer search can be ended.
+		return true;
+	}
+
+	client->GetResponse()->SetStatusCode(HttpStatusCode::OK);
+	return true;
+}
+
+int64_t SegmentPublisher::GetBandwidth(const std::shared_ptr<SegmentStream> &stream)
+{
+	auto &video_track = stream->GetVideoTrack();
+	auto &audio_track = stream->GetAudioTrack();
+	int64_t bandwidth = 0LL;
+
+	if (video_track != nullptr)
+	{
+		bandwidth += video_track->GetBitrate();
+	}
+
+	if (audio_track != nullptr)
+	{
+		bandwidth += audio_track->GetBitrate();
+	}
+
+	return bandwidth;
+}
+
+ov::String SegmentPublisher::MakeETag(const ov::String &play_list)
+{
+	return ov::String::FormatString("\"%016zx\"", std::hash<std::string_view>()(play_list.ToStringView()));
+}
+
+bool SegmentPublisher::OnThumbnailRequest(const std::shared_ptr<HttpClient> &client,
+										  const ov::String &app_name, const ov::String &stream_name,
+										  const ov::String &file_name,
+										  std::shared_ptr<info::Stream> &stream_info,
+										  std::shared_ptr<const PlayListData> &thumbnail)
+{
+	auto stream = GetStreamAs<SegmentStream>(app_name, stream_name);
+
+	if (stream == nullptr)
+	{
+		// This means it need to query the next observer.
+		return false;
+	}
+
+	thumbnail = stream->GetThumbnail(file_name);
+
+	if (thumbnail == nullptr)
+	{
+		// The thumbnail is disabled for this publisher, or the first key frame is not captured yet
+		return false;
+	}
+
+	// The thumbnail shows the stream, so it is protected like the playlists
+	auto parsed_url = ov::Url::Parse(client->GetRequest()->GetUri().CStr(), true);
+	std::shared_ptr<PlaylistRequestInfo> playlist_request_info;
+
+	if ((parsed_url == nullptr) ||
+		((app_name.HasSuffix("_insecure") == false) && (HandleSignedUrl(app_name, stream_name, client, parsed_url, playlist_request_info) == false)))
+	{
+		client->GetResponse()->SetStatusCode(HttpStatusCode::Forbidden);
+
+		// Returns true when the observer search can be ended.
+		return true;
+	}
+
+	stream_info = stream;
+
+	client->GetResponse()->SetStatusCode(HttpStatusCode::OK);
+	return true;
+}
+
+bool SegmentPublisher::OnKeyRequest(const std::shared_ptr<HttpClient> &client,
+									const ov::String &app_name, const ov::String &stream_name,
+									const ov::String &file_name,
+									std::shared_ptr<info::Stream> &stream_info,
+									std::shared_ptr<const ov::Data> &key)
+{
+	auto stream = GetStreamAs<SegmentStream>(app_name, stream_name);
+
+	if (stream == nullptr)
+	{
+		// This means it need to query the next observer.
+		return false;
+	}
+
+	key = stream->GetKey(file_name);
+
+	if (key == nullptr)
+	{
+		logtw("Could not find a key for %s [%s/%s, %s]", GetPublisherName(), app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		return false;
+	}
+
+	// The URI of the key in the playlist has the query string of the playlist request (See HlsStreamServer::ProcessPlayListRequest()),
+	// so the key is protected with the token of the playlist
+	auto parsed_url = ov::Url::Parse(client->GetRequest()->GetUri().CStr(), true);
+	std::shared_ptr<PlaylistRequestInfo> playlist_request_info;
+
+	if ((parsed_url == nullptr) ||
+		((app_name.HasSuffix("_insecure") == false) && (HandleSignedUrl(app_name, stream_name, client, parsed_url, playlist_request_info, GetPlayListFileName()) == false)))
+	{
+		key = nullptr;
+		client->GetResponse()->SetStatusCode(HttpStatusCode::Forbidden);
+
+		// Returns true when the observer search can be ended.
+		return true;
+	}
+
+	stream_info = stream;
+
+	client->GetResponse()->SetStatusCode(HttpStatusCode::OK);
+	return true;
+}
+
 bool SegmentPublisher::OnSegmentRequest(const std::shared_ptr<HttpClient> &client,
 										const ov::String &app_name, const ov::String &stream_name,
 										const ov::String &file_name,
@@ -541,7 +731,7 @@ void SegmentPublisher::UpdateSegmentRequestInfo(SegmentRequestInfo &info)
 
 bool SegmentPublisher::HandleSignedUrl(const ov::String &app_name, const ov::String &stream_name,
 									   const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Url> &request_url,
-									   std::shared_ptr<PlaylistRequestInfo> &request_info)
+									   std::shared_ptr<PlaylistRequestInfo> &request_info, const char *signed_file_name)
 {
 	auto orchestrator = Orchestrator::GetInstance();
 	auto &server_config = GetServerConfig();
@@ -603,8 +793,15 @@ bool SegmentPublisher::HandleSignedUrl(const ov::String &app_name, const ov::Str
 			return false;
 		}
 
+		SignedUrlType signed_url_type;
+		if (SignedUrl::ParseType(signed_url_config.GetType(), &signed_url_type) == false)
+		{
+			logte("Unknown type of the signed url: %s (DES or HMAC-SHA256)", signed_url_config.GetType().CStr());
+			return false;
+		}
+
 		// Decoding and parsing
-		auto signed_url = SignedUrl::Load(SignedUrlType::Type0, crypto_key, item->second);
+		auto signed_url = SignedUrl::Load(signed_url_type, crypto_key, item->second);
 		if (signed_url == nullptr)
 		{
 			logte("Could not obtain decrypted information of the signed url: %s, key: %s, value: %s", request_url->Source().CStr(), query_string_key.CStr(), item->second.CStr());
@@ -612,6 +809,14 @@ bool SegmentPublisher::HandleSignedUrl(const ov::String &app_name, const ov::Str
 		}
 
 		auto url_to_compare = request_url->ToUrlString(false);
+
+		if (signed_file_name != nullptr)
+		{
+			// The token is signed for another file of the same stream (<app>/<stream>/<signed_file_name>)
+			url_to_compare = url_to_compare.Left(url_to_compare.IndexOfRev('/') + 1);
+			url_to_compare.Append(signed_file_name);
+		}
+
 		url_to_compare.AppendFormat("?rtspURI=%s", ov::Url::Encode(rtsp_item->second).CStr());
 
 		std::vector<ov::String> messages;
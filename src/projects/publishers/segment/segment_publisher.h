@@ -12,6 +12,7 @@
 #include <base/media_route/media_route_application_interface.h>
 #include <base/publisher/publisher.h>
 #include <config/config.h>
+#include <publishers/segment/segment_stream/segment_stream.h>
 #include <publishers/segment/segment_stream/segment_stream_server.h>
 
 #define DEFAULT_SEGMENT_WORKER_THREAD_COUNT 4
@@ -205,13 +206,15 @@ protected:
 	SegmentPublisher(const cfg::Server &server_config, const std::shared_ptr<MediaRouteInterface> &router);
 	~SegmentPublisher() override;
 
-	bool Start(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager, const cfg::TlsPort &port_config, const std::shared_ptr<SegmentStreamServer> &stream_server);
+	bool Start(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager, const cfg::SegmentPort &port_config, const std::shared_ptr<SegmentStreamServer> &stream_server);
 	virtual bool Start(std::map<int, std::shared_ptr<HttpServer>> &http_server_manager) = 0;
 	
 
+	// signed_file_name: the file that the token is signed for, if it is not the requested file
+	//                   (The keys of HLS are requested with the token of the playlist, See HlsStreamServer::ProcessPlayListRequest())
 	bool HandleSignedUrl(const ov::String &app_name, const ov::String &stream_name, 
 						const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const ov::Url> &request_url,
-						std::shared_ptr<PlaylistRequestInfo> &request_info);
+						std::shared_ptr<PlaylistRequestInfo> &request_info, const char *signed_file_name = nullptr);
 
 	//--------------------------------------------------------------------
 	// Implementation of SegmentStreamObserver
@@ -219,16 +222,59 @@ protected:
 	bool OnPlayListRequest(const std::shared_ptr<HttpClient> &client,
 						   const ov::String &app_name, const ov::String &stream_name,
 						   const ov::String &file_name,
-						   ov::String &play_list) override;
+						   std::shared_ptr<const PlayListData> &play_list) override;
 
 	bool OnSegmentRequest(const std::shared_ptr<HttpClient> &client,
 						  const ov::String &app_name, const ov::String &stream_name,
 						  const ov::String &file_name,
 						  std::shared_ptr<SegmentData> &segment) override;
 
+	bool OnThumbnailRequest(const std::shared_ptr<HttpClient> &client,
+							const ov::String &app_name, const ov::String &stream_name,
+							const ov::String &file_name,
+							std::shared_ptr<info::Stream> &stream_info,
+							std::shared_ptr<const PlayListData> &thumbnail) override;
+
+	bool OnKeyRequest(const std::shared_ptr<HttpClient> &client,
+					  const ov::String &app_name, const ov::String &stream_name,
+					  const ov::String &file_name,
+					  std::shared_ptr<info::Stream> &stream_info,
+					  std::shared_ptr<const ov::Data> &key) override;
+
+	//--------------------------------------------------------------------
+	// Stream group (the renditions of an ABR stream, See <Stream><Group>)
+	//--------------------------------------------------------------------
+	// The file name of the master playlist (<app>/<group>/<file name>), nullptr if the publisher does not provide it
+	virtual const char *GetMasterPlayListFileName() const
+	{
+		return nullptr;
+	}
+
+	// The file name of the playlist of a stream, which the signed URL of a key request is compared with
+	virtual const char *GetPlayListFileName() const
+	{
+		return nullptr;
+	}
+
+	// renditions: sorted by the bandwidth in ascending order
+	// Returns nullptr if the renditions are not ready yet
+	virtual std::shared_ptr<const PlayListData> MakeMasterPlayList(const std::vector<std::shared_ptr<SegmentStream>> &renditions)
+	{
+		return nullptr;
+	}
+
+	// The sum of the bitrates of the packetized tracks
+	static int64_t GetBandwidth(const std::shared_ptr<SegmentStream> &stream);
+	// The ETag of the playlist that is not made by a packetizer
+	static ov::String MakeETag(const ov::String &play_list);
+
 	std::shared_ptr<SegmentStreamServer> _stream_server = nullptr;
 
 private:
+	bool OnMasterPlayListRequest(const std::shared_ptr<HttpClient> &client,
+								 const ov::String &app_name, const ov::String &group_name,
+								 std::shared_ptr<const PlayListData> &play_list);
+
 	bool		StartSessionTableManager();
 	void 		RequestTableUpdateThread();
 
@@ -7,5 +7,6 @@ LOCAL_SOURCE_FILES := $(LOCAL_SOURCE_FILES) $(call get_sub_source_list,packetize
 LOCAL_HEADER_FILES := $(LOCAL_HEADER_FILES) $(call get_sub_source_list,packetizer)
 
 $(call add_pkg_config,srt)
+$(call add_pkg_config,openssl)
 
 include $(BUILD_STATIC_LIBRARY)
\ No newline at end of file
@@ -10,8 +10,6 @@
 
 #define OV_LOG_TAG "CMAF.Writer"
 
-#define DEFAULT_CHUNK_HEADER_SIZE (256)
-
 CmafChunkWriter::CmafChunkWriter(M4sMediaType media_type, uint32_t track_id, double ideal_duration)
 	: M4sWriter(media_type),
 	  _track_id(track_id),
@@ -60,10 +58,14 @@ const std::shared_ptr<ov::Data> CmafChunkWriter::AppendSample(const std::shared_
 		logtd("Calculated sequence number: %lld, %f = %u", _start_timestamp, _ideal_duration, _sequence_number);
 	}
 
-	auto chunk_stream = std::make_shared<ov::Data>(sample_data->data->GetLength() + DEFAULT_CHUNK_HEADER_SIZE);
+	// The size of the boxes is known before writing, so the sample is copied only once
+	size_t mdat_size = MP4_BOX_HEADER_SIZE + sample_data->data->GetLength() + ((_media_type == M4sMediaType::Video) ? sizeof(uint32_t) : 0);
+	M4sBoxWriter writer(GetMoofBoxSize() + mdat_size);
+
+	WriteMoofBox(writer, sample_data);
+	WriteMdatBox(writer, sample_data->data);
 
-	WriteMoofBox(chunk_stream, sample_data);
-	WriteMdatBox(chunk_stream, sample_data->data);
+	auto chunk_stream = writer.Finish();
 
 	_chunked_data->Append(chunk_stream.get());
 
@@ -98,47 +100,45 @@ uint64_t CmafChunkWriter::GetSegmentDuration() const
 	return duration;
 }
 
-int CmafChunkWriter::WriteMoofBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<const SampleData> &sample_data)
+size_t CmafChunkWriter::GetMoofBoxSize() const
 {
-	auto data = std::make_shared<ov::Data>(DEFAULT_CHUNK_HEADER_SIZE);
-
-	WriteMfhdBox(data);
-	WriteTrafBox(data, sample_data);
-
-	WriteBoxData("moof", data, data_stream);
+	// Sample Item Count + Data offset + duration + size [+ flag + cts]
+	size_t trun_size = MP4_BOX_EXT_HEADER_SIZE + 8 + ((_media_type == M4sMediaType::Video) ? 16 : 8);
+	size_t traf_size = MP4_BOX_HEADER_SIZE + (MP4_BOX_EXT_HEADER_SIZE + 4) + (MP4_BOX_EXT_HEADER_SIZE + 8) + trun_size;
 
-	// trun data offset value change
-	int position = (_media_type == M4sMediaType::Video) ? data_stream->GetLength() - 16 - 4 : data_stream->GetLength() - 8 - 4;
-
-	if (position < 0)
-	{
-		return -1;
-	}
-
-	ByteWriter<uint32_t>::WriteBigEndian(data_stream->GetWritableDataAs<uint8_t>() + position, data_stream->GetLength() + 8);
-
-	return data_stream->GetLength();
+	return MP4_BOX_HEADER_SIZE + (MP4_BOX_EXT_HEADER_SIZE + 4) + traf_size;
 }
 
-int CmafChunkWriter::WriteMfhdBox(std::shared_ptr<ov::Data> &data_stream)
+void CmafChunkWriter::WriteMoofBox(M4sBoxWriter &writer, const std::shared_ptr<const SampleData> &sample_data)
 {
-	auto data = std::make_shared<ov::Data>();
+	auto moof_position = writer.GetPosition();
+	size_t data_offset_position = 0;
 
-	WriteUint32(_sequence_number, data);
+	writer.BeginBox("moof");
+	WriteMfhdBox(writer);
+	WriteTrafBox(writer, sample_data, &data_offset_position);
+	writer.EndBox();
 
-	return WriteBoxData("mfhd", 0, 0, data, data_stream);
+	// trun data offset: from the start of moof to the sample in mdat
+	writer.WriteUint32At(data_offset_position, writer.GetPosition() - moof_position + MP4_BOX_HEADER_SIZE);
 }
 
-int CmafChunkWriter::WriteTrafBox(std::shared_ptr<ov::Data> &data_stream,
-								  const std::shared_ptr<const SampleData> &sample_data)
+void CmafChunkWriter::WriteMfhdBox(M4sBoxWriter &writer)
 {
-	auto data = std::make_shared<ov::Data>();
-
-	WriteTfhdBox(data);
-	WriteTfdtBox(data, sample_data->timestamp);
-	WriteTrunBox(data, sample_data);
+	writer.BeginBox("mfhd", 0, 0);
+	writer.WriteUint32(_sequence_number);
+	writer.EndBox();
+}
 
-	return WriteBoxData("traf", data, data_stream);
+void CmafChunkWriter::WriteTrafBox(M4sBoxWriter &writer,
+								   const std::shared_ptr<const SampleData> &sample_data,
+								   size_t *data_offset_position)
+{
+	writer.BeginBox("traf");
+	WriteTfhdBox(writer);
+	WriteTfdtBox(writer, sample_data->timestamp);
+	WriteTrunBox(writer, sample_data, data_offset_position);
+	writer.EndBox();
 }
 
 #define TFHD_FLAG_BASE_DATA_OFFSET_PRESENT (0x00001)
@@ -149,23 +149,18 @@ int CmafChunkWriter::WriteTrafBox(std::shared_ptr<ov::Data> &data_stream,
 #define TFHD_FLAG_DURATION_IS_EMPTY (0x10000)
 #define TFHD_FLAG_DEFAULT_BASE_IS_MOOF (0x20000)
 
-int CmafChunkWriter::WriteTfhdBox(std::shared_ptr<ov::Data> &data_stream)
+void CmafChunkWriter::WriteTfhdBox(M4sBoxWriter &writer)
 {
-	auto data = std::make_shared<ov::Data>();
-	uint32_t flag = TFHD_FLAG_DEFAULT_BASE_IS_MOOF;
-
-	WriteUint32(_track_id, data);  // track id
-
-	return WriteBoxData("tfhd", 0, flag, data, data_stream);
+	writer.BeginBox("tfhd", 0, TFHD_FLAG_DEFAULT_BASE_IS_MOOF);
+	writer.WriteUint32(_track_id);  // track id
+	writer.EndBox();
 }
 
-int CmafChunkWriter::WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream, int64_t timestamp)
+void CmafChunkWriter::WriteTfdtBox(M4sBoxWriter &writer, int64_t timestamp)
 {
-	auto data = std::make_shared<ov::Data>();
-
-	WriteUint64(timestamp, data);  // Base media decode time
-
-	return WriteBoxData("tfdt", 1, 0, data, data_stream);
+	writer.BeginBox("tfdt", 1, 0);
+	writer.WriteUint64(timestamp);  // Base media decode time
+	writer.EndBox();
 }
 
 #define TRUN_FLAG_DATA_OFFSET_PRESENT (0x0001)
@@ -175,10 +170,10 @@ int CmafChunkWriter::WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream, int64_
 #define TRUN_FLAG_SAMPLE_FLAGS_PRESENT (0x0400)
 #define TRUN_FLAG_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT (0x0800)
 
-int CmafChunkWriter::WriteTrunBox(std::shared_ptr<ov::Data> &data_stream,
-								  const std::shared_ptr<const SampleData> &sample_data)
+void CmafChunkWriter::WriteTrunBox(M4sBoxWriter &writer,
+								   const std::shared_ptr<const SampleData> &sample_data,
+								   size_t *data_offset_position)
 {
-	auto data = std::make_shared<ov::Data>();
 	uint32_t flag = 0;
 
 	if (M4sMediaType::Video == _media_type)
@@ -191,26 +186,40 @@ int CmafChunkWriter::WriteTrunBox(std::shared_ptr<ov::Data> &data_stream,
 		flag = TRUN_FLAG_DATA_OFFSET_PRESENT | TRUN_FLAG_SAMPLE_DURATION_PRESENT | TRUN_FLAG_SAMPLE_SIZE_PRESENT;
 	}
 
-	WriteUint32(1, data);			// Sample Item Count;
-	WriteUint32(0x11111111, data);  // Data offset - temp 0 setting
+	writer.BeginBox("trun", 0, flag);
 
-	WriteUint32(sample_data->duration, data);  // duration
+	writer.WriteUint32(1);  // Sample Item Count;
+
+	// Data offset - written after moof is completed
+	*data_offset_position = writer.GetPosition();
+	writer.WriteUint32(0);
+
+	writer.WriteUint32(sample_data->duration);  // duration
 
 	if (_media_type == M4sMediaType::Video)
 	{
-		WriteUint32(sample_data->data->GetLength() + 4, data);	// size + sample
-		WriteUint32(sample_data->flag, data);					  // flag
-		WriteUint32(sample_data->composition_time_offset, data);  // cts
+		writer.WriteUint32(sample_data->data->GetLength() + 4);	// size + sample
+		writer.WriteUint32(sample_data->flag);					 // flag
+		writer.WriteUint32(sample_data->composition_time_offset);  // cts
 	}
 	else if (_media_type == M4sMediaType::Audio)
 	{
-		WriteUint32(sample_data->data->GetLength(), data);  // sample
+		writer.WriteUint32(sample_data->data->GetLength());  // sample
 	}
 
-	return WriteBoxData("trun", 0, flag, data, data_stream);
+	writer.EndBox();
 }
 
-int CmafChunkWriter::WriteMdatBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<ov::Data> &frame_data)
+void CmafChunkWriter::WriteMdatBox(M4sBoxWriter &writer, const std::shared_ptr<ov::Data> &frame_data)
 {
-	return WriteBoxData("mdat", frame_data, data_stream, _media_type == M4sMediaType::Video ? true : false);
-}
\ No newline at end of file
+	writer.BeginBox("mdat");
+
+	if (_media_type == M4sMediaType::Video)
+	{
+		writer.WriteUint32(frame_data->GetLength());
+	}
+
+	writer.WriteData(frame_data);
+
+	writer.EndBox();
+}
@@ -52,14 +52,17 @@ public:
 	std::shared_ptr<ov::Data> GetChunkedSegment();
 
 protected:
-	int WriteMoofBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<const SampleData> &sample_data);
-	int WriteMfhdBox(std::shared_ptr<ov::Data> &data_stream);
-	int WriteTrafBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<const SampleData> &sample_data);
-	int WriteTfhdBox(std::shared_ptr<ov::Data> &data_stream);
-	int WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream, int64_t timestamp);
-	int WriteTrunBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<const SampleData> &sample_data);
-
-	int WriteMdatBox(std::shared_ptr<ov::Data> &data_stream, const std::shared_ptr<ov::Data> &frame_data);
+	size_t GetMoofBoxSize() const;
+
+	void WriteMoofBox(M4sBoxWriter &writer, const std::shared_ptr<const SampleData> &sample_data);
+	void WriteMfhdBox(M4sBoxWriter &writer);
+	void WriteTrafBox(M4sBoxWriter &writer, const std::shared_ptr<const SampleData> &sample_data, size_t *data_offset_position);
+	void WriteTfhdBox(M4sBoxWriter &writer);
+	void WriteTfdtBox(M4sBoxWriter &writer, int64_t timestamp);
+	// data_offset_position: the position of the data offset, which is written after the size of moof is determined
+	void WriteTrunBox(M4sBoxWriter &writer, const std::shared_ptr<const SampleData> &sample_data, size_t *data_offset_position);
+
+	void WriteMdatBox(M4sBoxWriter &writer, const std::shared_ptr<ov::Data> &frame_data);
 
 private:
 	uint32_t _max_chunked_data_size = 100 * 1024;
@@ -459,15 +459,25 @@ int M4sInitWriter::EsdsBoxWrite(std::shared_ptr<ov::Data> &data_stream)
 		3: AAC SSR (Scalable Sample Rate)
 		4: ...
    */
-	BitWriter bit_writer(2);
-	bit_writer.Write(5, 2);										  // object type - 2: AAC LC (Low Complexity)
-	bit_writer.Write(4, _audio_sample_index);					  // frequency index
-	bit_writer.Write(4, _audio_track->GetChannel().GetCounts());  // channel configuration
-
 	WriteUint8(5, data);  // tag
 	WriteUint8(2, data);  // tag size
 
-	WriteData(bit_writer.GetData(), (int)bit_writer.GetDataSize(), data);  //
+	auto &audio_specific_config = _audio_track->GetCodecExtradata();
+
+	if (audio_specific_config.size() == 2)
+	{
+		// The AudioSpecificConfig of the sequence header (such as RTMP ingest)
+		WriteData(audio_specific_config, data);
+	}
+	else
+	{
+		BitWriter bit_writer(2);
+		bit_writer.Write(5, 2);										  // object type - 2: AAC LC (Low Complexity)
+		bit_writer.Write(4, _audio_sample_index);					  // frequency index
+		bit_writer.Write(4, _audio_track->GetChannel().GetCounts());  // channel configuration
+
+		WriteData(bit_writer.GetData(), (int)bit_writer.GetDataSize(), data);  //
+	}
 
 	// sl config(1)
 	WriteUint8(6, data);  // tag
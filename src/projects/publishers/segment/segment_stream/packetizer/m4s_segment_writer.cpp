@@ -8,14 +8,13 @@
 //==============================================================================
 #include "m4s_segment_writer.h"
 
-#define DEFAULT_SEGMENT_HEADER_SIZE (4096)
-
-M4sSegmentWriter::M4sSegmentWriter(M4sMediaType media_type, uint32_t sequence_number, uint32_t track_id, int64_t start_timestamp)
+M4sSegmentWriter::M4sSegmentWriter(M4sMediaType media_type, uint32_t sequence_number, uint32_t track_id, int64_t start_timestamp, bool has_nal_length)
 	: M4sWriter(media_type),
 
 	  _sequence_number(sequence_number),
 	  _track_id(track_id),
-	  _start_timestamp(start_timestamp)
+	  _start_timestamp(start_timestamp),
+	  _nal_length_size(((media_type == M4sMediaType::Video) && (has_nal_length == false)) ? sizeof(uint32_t) : 0U)
 {
 }
 
@@ -29,62 +28,55 @@ const std::shared_ptr<ov::Data> M4sSegmentWriter::AppendSamples(const std::vecto
 
 	for (const auto &sample_data : sample_datas)
 	{
-		total_sample_size += sample_data->data->GetLength();
-
-		if (_media_type == M4sMediaType::Video)
-		{
-			total_sample_size += sizeof(uint32_t);
-		}
+		total_sample_size += sample_data->data->GetLength() + _nal_length_size;
 	}
 
-	auto data_stream = std::make_shared<ov::Data>(total_sample_size + DEFAULT_SEGMENT_HEADER_SIZE);
+	// The size of the boxes is known before writing, so the samples are copied only once
+	M4sBoxWriter writer(GetMoofBoxSize(sample_datas.size()) + MP4_BOX_HEADER_SIZE + total_sample_size);
 
-	WriteMoofBox(data_stream, sample_datas);
-	WriteMdatBox(data_stream, sample_datas, total_sample_size);
+	WriteMoofBox(writer, sample_datas);
+	WriteMdatBox(writer, sample_datas);
 
-	return data_stream;
+	return writer.Finish();
 }
 
-int M4sSegmentWriter::WriteMoofBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas)
+size_t M4sSegmentWriter::GetMoofBoxSize(size_t sample_count) const
 {
-	auto data = std::make_shared<ov::Data>(DEFAULT_SEGMENT_HEADER_SIZE);
-
-	WriteMfhdBox(data);
-	WriteTrafBox(data, sample_datas);
-
-	WriteBoxData("moof", data, data_stream);
-
-	int position = (_media_type == M4sMediaType::Video) ? data_stream->GetLength() - sample_datas.size() * 16 - 4 : data_stream->GetLength() - sample_datas.size() * 8 - 4;
-
-	if (position < 0)
-	{
-		return -1;
-	}
-
-	// trun data offset value change
-	ByteWriter<uint32_t>::WriteBigEndian(data_stream->GetWritableDataAs<uint8_t>() + position, data_stream->GetLength() + 8);
+	// Sample Item Count + Data offset + (duration + size [+ flag + cts]) * count
+	size_t trun_size = MP4_BOX_EXT_HEADER_SIZE + 8 + sample_count * ((_media_type == M4sMediaType::Video) ? 16 : 8);
+	size_t traf_size = MP4_BOX_HEADER_SIZE + (MP4_BOX_EXT_HEADER_SIZE + 4) + (MP4_BOX_EXT_HEADER_SIZE + 8) + trun_size;
 
-	return data_stream->GetLength();
+	return MP4_BOX_HEADER_SIZE + (MP4_BOX_EXT_HEADER_SIZE + 4) + traf_size;
 }
 
-int M4sSegmentWriter::WriteMfhdBox(std::shared_ptr<ov::Data> &data_stream)
+void M4sSegmentWriter::WriteMoofBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas)
 {
-	auto data = std::make_shared<ov::Data>();
+	auto moof_position = writer.GetPosition();
+	size_t data_offset_position = 0;
 
-	WriteUint32(_sequence_number, data);  // Sequence Number
+	writer.BeginBox("moof");
+	WriteMfhdBox(writer);
+	WriteTrafBox(writer, sample_datas, &data_offset_position);
+	writer.EndBox();
 
-	return WriteBoxData("mfhd", 0, 0, data, data_stream);
+	// trun data offset: from the start of moof to the first sample in mdat
+	writer.WriteUint32At(data_offset_position, writer.GetPosition() - moof_position + MP4_BOX_HEADER_SIZE);
 }
 
-int M4sSegmentWriter::WriteTrafBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas)
+void M4sSegmentWriter::WriteMfhdBox(M4sBoxWriter &writer)
 {
-	auto data = std::make_shared<ov::Data>();
-
-	WriteTfhdBox(data);
-	WriteTfdtBox(data);
-	WriteTrunBox(data, sample_datas);
+	writer.BeginBox("mfhd", 0, 0);
+	writer.WriteUint32(_sequence_number);  // Sequence Number
+	writer.EndBox();
+}
 
-	return WriteBoxData("traf", data, data_stream);
+void M4sSegmentWriter::WriteTrafBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, size_t *data_offset_position)
+{
+	writer.BeginBox("traf");
+	WriteTfhdBox(writer);
+	WriteTfdtBox(writer);
+	WriteTrunBox(writer, sample_datas, data_offset_position);
+	writer.EndBox();
 }
 
 #define TFHD_FLAG_BASE_DATA_OFFSET_PRESENT (0x00001)
@@ -95,23 +87,18 @@ int M4sSegmentWriter::WriteTrafBox(std::shared_ptr<ov::Data> &data_stream, const
 #define TFHD_FLAG_DURATION_IS_EMPTY (0x10000)
 #define TFHD_FLAG_DEFAULT_BASE_IS_MOOF (0x20000)
 
-int M4sSegmentWriter::WriteTfhdBox(std::shared_ptr<ov::Data> &data_stream)
+void M4sSegmentWriter::WriteTfhdBox(M4sBoxWriter &writer)
 {
-	auto data = std::make_shared<ov::Data>();
-	uint32_t flag = TFHD_FLAG_DEFAULT_BASE_IS_MOOF;
-
-	WriteUint32(_track_id, data);  // track id
-
-	return WriteBoxData("tfhd", 0, flag, data, data_stream);
+	writer.BeginBox("tfhd", 0, TFHD_FLAG_DEFAULT_BASE_IS_MOOF);
+	writer.WriteUint32(_track_id);  // track id
+	writer.EndBox();
 }
 
-int M4sSegmentWriter::WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream)
+void M4sSegmentWriter::WriteTfdtBox(M4sBoxWriter &writer)
 {
-	auto data = std::make_shared<ov::Data>();
-
-	WriteUint64(_start_timestamp, data);  // Base media decode time
-
-	return WriteBoxData("tfdt", 1, 0, data, data_stream);
+	writer.BeginBox("tfdt", 1, 0);
+	writer.WriteUint64(_start_timestamp);  // Base media decode time
+	writer.EndBox();
 }
 
 #define TRUN_FLAG_DATA_OFFSET_PRESENT (0x0001)
@@ -121,9 +108,8 @@ int M4sSegmentWriter::WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream)
 #define TRUN_FLAG_SAMPLE_FLAGS_PRESENT (0x0400)
 #define TRUN_FLAG_SAMPLE_COMPOSITION_TIME_OFFSET_PRESENT (0x0800)
 
-int M4sSegmentWriter::WriteTrunBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas)
+void M4sSegmentWriter::WriteTrunBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, size_t *data_offset_position)
 {
-	auto data = std::make_shared<ov::Data>();
 	uint32_t flag = 0;
 
 	if (M4sMediaType::Video == _media_type)
@@ -136,43 +122,47 @@ int M4sSegmentWriter::WriteTrunBox(std::shared_ptr<ov::Data> &data_stream, const
 		flag = TRUN_FLAG_DATA_OFFSET_PRESENT | TRUN_FLAG_SAMPLE_DURATION_PRESENT | TRUN_FLAG_SAMPLE_SIZE_PRESENT;
 	}
 
-	WriteUint32(sample_datas.size(), data);  // Sample Item Count;
-	WriteUint32(0x11111111, data);			 // Data offset - temp 0 setting
+	writer.BeginBox("trun", 0, flag);
+
+	writer.WriteUint32(sample_datas.size());  // Sample Item Count;
+
+	// Data offset - written after moof is completed
+	*data_offset_position = writer.GetPosition();
+	writer.WriteUint32(0);
 
 	for (auto &sample_data : sample_datas)
 	{
-		WriteUint32(sample_data->duration, data);  // duration
+		writer.WriteUint32(sample_data->duration);  // duration
 
 		if (_media_type == M4sMediaType::Video)
 		{
-			WriteUint32(sample_data->data->GetLength() + 4, data);	// size + sample
-			WriteUint32(sample_data->flag, data);					  // flag
-			WriteUint32(sample_data->composition_time_offset, data);  // compoistion timeoffset
+			writer.WriteUint32(sample_data->data->GetLength() + _nal_length_size);	 // size + sample
+			writer.WriteUint32(sample_data->flag);					 // flag
+			writer.WriteUint32(sample_data->composition_time_offset);  // compoistion timeoffset
 		}
 		else if (_media_type == M4sMediaType::Audio)
 		{
-			WriteUint32(sample_data->data->GetLength(), data);  // sample
+			writer.WriteUint32(sample_data->data->GetLength());  // sample
 		}
 	}
 
-	return WriteBoxData("trun", 0, flag, data, data_stream);
+	writer.EndBox();
 }
 
-int M4sSegmentWriter::WriteMdatBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, uint32_t total_sample_size)
+void M4sSegmentWriter::WriteMdatBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas)
 {
-	WriteUint32(MP4_BOX_HEADER_SIZE + total_sample_size, data_stream);  // box size write
-	WriteText("mdat", data_stream);										// type write
+	writer.BeginBox("mdat");
 
 	for (auto &sample_data : sample_datas)
 	{
 		// only video)
-		if (_media_type == M4sMediaType::Video)
+		if (_nal_length_size > 0)
 		{
-			WriteUint32(sample_data->data->GetLength(), data_stream);
+			writer.WriteUint32(sample_data->data->GetLength());
 		}
 
-		WriteData(sample_data->data, data_stream);
+		writer.WriteData(sample_data->data);
 	}
 
-	return data_stream->GetLength();
-}
\ No newline at end of file
+	writer.EndBox();
+}
@@ -14,22 +14,29 @@
 class M4sSegmentWriter : public M4sWriter
 {
 public:
-	M4sSegmentWriter(M4sMediaType media_type, uint32_t sequence_number, uint32_t track_id, int64_t start_timestamp);
+	// has_nal_length: The video samples already have the 4-byte lengths of the NAL units (AVCC), so they are written as they are
+	// (otherwise a sample must be a NAL unit without the start code, and the length is added)
+	M4sSegmentWriter(M4sMediaType media_type, uint32_t sequence_number, uint32_t track_id, int64_t start_timestamp, bool has_nal_length = false);
 	~M4sSegmentWriter() final;
 
 	const std::shared_ptr<ov::Data> AppendSamples(const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
 
 protected:
-	int WriteMoofBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
-	int WriteMfhdBox(std::shared_ptr<ov::Data> &data_stream);
-	int WriteTrafBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
-	int WriteTfhdBox(std::shared_ptr<ov::Data> &data_stream);
-	int WriteTfdtBox(std::shared_ptr<ov::Data> &data_stream);
-	int WriteTrunBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
-	int WriteMdatBox(std::shared_ptr<ov::Data> &data_stream, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, uint32_t total_sample_size);
+	size_t GetMoofBoxSize(size_t sample_count) const;
+
+	void WriteMoofBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
+	void WriteMfhdBox(M4sBoxWriter &writer);
+	void WriteTrafBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, size_t *data_offset_position);
+	void WriteTfhdBox(M4sBoxWriter &writer);
+	void WriteTfdtBox(M4sBoxWriter &writer);
+	// data_offset_position: the position of the data offset, which is written after the size of moof is determined
+	void WriteTrunBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas, size_t *data_offset_position);
+	void WriteMdatBox(M4sBoxWriter &writer, const std::vector<std::shared_ptr<const SampleData>> &sample_datas);
 
 private:
 	uint32_t _sequence_number = 0U;
 	uint32_t _track_id = 0U;
 	int64_t _start_timestamp = 0LL;
+	// The bytes that are added before each video sample
+	uint32_t _nal_length_size = 0U;
 };
\ No newline at end of file
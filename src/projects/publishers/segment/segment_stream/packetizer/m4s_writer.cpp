@@ -9,6 +9,117 @@
 
 #include "m4s_writer.h"
 
+M4sBoxWriter::M4sBoxWriter(size_t capacity)
+	: _data(std::make_shared<ov::Data>(capacity))
+{
+	_box_positions.reserve(8);
+
+	_data->SetLength(capacity);
+	_buffer = _data->GetWritableDataAs<uint8_t>();
+	_capacity = capacity;
+}
+
+uint8_t *M4sBoxWriter::Reserve(size_t length)
+{
+	if ((_position + length) > _capacity)
+	{
+		// The expected size was wrong - grow the buffer
+		_capacity = std::max(_position + length, _capacity * 2);
+		_data->SetLength(_capacity);
+		_buffer = _data->GetWritableDataAs<uint8_t>();
+	}
+
+	auto buffer = _buffer + _position;
+	_position += length;
+
+	return buffer;
+}
+
+void M4sBoxWriter::BeginBox(const char *type)
+{
+	_box_positions.push_back(_position);
+
+	// The size is written by EndBox()
+	Reserve(sizeof(uint32_t));
+	WriteData(type, 4);
+}
+
+void M4sBoxWriter::BeginBox(const char *type, uint8_t version, uint32_t flags)
+{
+	BeginBox(type);
+
+	WriteUint8(version);
+	WriteUint24(flags);
+}
+
+void M4sBoxWriter::EndBox()
+{
+	OV_ASSERT2(_box_positions.empty() == false);
+
+	auto box_position = _box_positions.back();
+	_box_positions.pop_back();
+
+	WriteUint32At(box_position, static_cast<uint32_t>(_position - box_position));
+}
+
+void M4sBoxWriter::WriteUint64(uint64_t value)
+{
+	ByteWriter<uint64_t>::WriteBigEndian(Reserve(sizeof(uint64_t)), value);
+}
+
+void M4sBoxWriter::WriteUint32(uint32_t value)
+{
+	ByteWriter<uint32_t>::WriteBigEndian(Reserve(sizeof(uint32_t)), value);
+}
+
+void M4sBoxWriter::WriteUint24(uint32_t value)
+{
+	auto buffer = Reserve(3);
+
+	buffer[0] = static_cast<uint8_t>((value >> 16) & 0xFF);
+	buffer[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+	buffer[2] = static_cast<uint8_t>(value & 0xFF);
+}
+
+void M4sBoxWriter::WriteUint16(uint16_t value)
+{
+	ByteWriter<uint16_t>::WriteBigEndian(Reserve(sizeof(uint16_t)), value);
+}
+
+void M4sBoxWriter::WriteUint8(uint8_t value)
+{
+	*Reserve(1) = value;
+}
+
+void M4sBoxWriter::WriteData(const void *data, size_t length)
+{
+	if (length > 0)
+	{
+		::memcpy(Reserve(length), data, length);
+	}
+}
+
+void M4sBoxWriter::WriteData(const std::shared_ptr<const ov::Data> &data)
+{
+	WriteData(data->GetData(), data->GetLength());
+}
+
+void M4sBoxWriter::WriteUint32At(size_t position, uint32_t value)
+{
+	OV_ASSERT2((position + sizeof(uint32_t)) <= _position);
+
+	ByteWriter<uint32_t>::WriteBigEndian(_buffer + position, value);
+}
+
+std::shared_ptr<ov::Data> M4sBoxWriter::Finish()
+{
+	OV_ASSERT2(_box_positions.empty());
+
+	_data->SetLength(_position);
+
+	return std::move(_data);
+}
+
 //====================================================================================================
 // Constructor
 //====================================================================================================
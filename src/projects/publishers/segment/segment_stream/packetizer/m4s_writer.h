@@ -59,6 +59,54 @@ public:
 	std::shared_ptr<ov::Data> data;
 };
 
+//====================================================================================================
+// M4sBoxWriter
+// - Writes the boxes into a buffer which is allocated once.
+//   The size of a box is written when the box is closed (backpatching),
+//   so the nested boxes (moof/traf/trun) are written in place instead of being copied to the parent box.
+//====================================================================================================
+class M4sBoxWriter
+{
+public:
+	// capacity: expected size of the boxes (the buffer grows if it is not enough)
+	explicit M4sBoxWriter(size_t capacity);
+
+	void BeginBox(const char *type);
+	void BeginBox(const char *type, uint8_t version, uint32_t flags);
+	// Writes the size of the last open box
+	void EndBox();
+
+	void WriteUint64(uint64_t value);
+	void WriteUint32(uint32_t value);
+	void WriteUint24(uint32_t value);
+	void WriteUint16(uint16_t value);
+	void WriteUint8(uint8_t value);
+	void WriteData(const void *data, size_t length);
+	void WriteData(const std::shared_ptr<const ov::Data> &data);
+
+	// Overwrites the value that is already written
+	void WriteUint32At(size_t position, uint32_t value);
+
+	size_t GetPosition() const
+	{
+		return _position;
+	}
+
+	// Returns the written boxes (the writer must not be used after this)
+	std::shared_ptr<ov::Data> Finish();
+
+protected:
+	uint8_t *Reserve(size_t length);
+
+	std::shared_ptr<ov::Data> _data;
+	uint8_t *_buffer = nullptr;
+	size_t _capacity = 0;
+	size_t _position = 0;
+
+	// The positions of the open boxes
+	std::vector<size_t> _box_positions;
+};
+
 //====================================================================================================
 // M4sWriter
 //====================================================================================================
@@ -11,6 +11,8 @@
 
 #include <sys/time.h>
 #include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <sstream>
 
 Packetizer::Packetizer(const ov::String &app_name, const ov::String &stream_name,
@@ -28,18 +30,44 @@ Packetizer::Packetizer(const ov::String &app_name, const ov::String &stream_name
 	  _segment_duration(segment_duration),
 
 	  _video_track(video_track),
-	  _audio_track(audio_track)
+	  _audio_track(audio_track),
+
+	  _video_segments(_segment_save_count),
+	  // Only for dash
+	  _audio_segments((_packetizer_type == PacketizerType::Dash) ? _segment_save_count : 1)
+{
+}
+
+bool Packetizer::ParseSegmentNumber(const ov::String &file_name, int64_t *number) const
 {
-	for (uint32_t index = 0; index < _segment_save_count; index++)
+	auto prefix_length = _segment_prefix.GetLength();
+
+	if ((file_name.GetLength() <= (prefix_length + 1)) ||
+		(::strncmp(file_name.CStr(), _segment_prefix.CStr(), prefix_length) != 0) ||
+		(file_name[prefix_length] != '_'))
 	{
-		_video_segment_datas.push_back(nullptr);
+		return false;
+	}
+
+	const char *start = file_name.CStr() + prefix_length + 1;
+	char *end = nullptr;
 
-		// Only for dash
-		if (_packetizer_type == PacketizerType::Dash)
-		{
-			_audio_segment_datas.push_back(nullptr);
-		}
+	errno = 0;
+	auto value = ::strtoll(start, &end, 10);
+
+	if ((end == start) || (errno != 0))
+	{
+		return false;
 	}
+
+	*number = value;
+
+	return true;
+}
+
+std::shared_ptr<const ov::Data> Packetizer::GetKey(const ov::String &file_name) const
+{
+	return nullptr;
 }
 
 uint32_t Packetizer::Gcd(uint32_t n1, uint32_t n2)
@@ -134,11 +162,55 @@ uint64_t Packetizer::ConvertTimeScale(uint64_t time, const common::Timebase &fro
 	return (uint64_t)((double)time * ratio);
 }
 
-void Packetizer::SetPlayList(ov::String &play_list)
+void Packetizer::SetPlayList(const ov::String &play_list, const char *current_time_placeholder)
+{
+	std::atomic_store(&_play_list, std::shared_ptr<const PlayListData>(MakePlayList(play_list, current_time_placeholder)));
+}
+
+std::shared_ptr<PlayListData> Packetizer::MakePlayList(const ov::String &play_list, const char *current_time_placeholder)
+{
+	// Only the packetizer thread updates the playlist
+	_play_list_version++;
+
+	return MakePlayListData(play_list, ov::String::FormatString("\"%08x-%llu\"", _play_list_id, _play_list_version), current_time_placeholder);
+}
+
+std::shared_ptr<PlayListData> Packetizer::MakePlayListData(const ov::String &play_list, const ov::String &etag, const char *current_time_placeholder)
+{
+	auto play_list_data = std::make_shared<PlayListData>();
+	auto now = ::time(nullptr);
+	struct tm now_tm;
+	char last_modified[64];
+
+	::gmtime_r(&now, &now_tm);
+	::strftime(last_modified, sizeof(last_modified), "%a, %d %b %Y %H:%M:%S GMT", &now_tm);
+
+	play_list_data->etag = etag;
+	play_list_data->last_modified = last_modified;
+
+	auto placeholder_index = (current_time_placeholder != nullptr) ? play_list.IndexOf(current_time_placeholder) : -1;
+
+	if (placeholder_index >= 0)
+	{
+		play_list_data->head = play_list.Substring(0, placeholder_index).ToData(false);
+		play_list_data->tail = play_list.Substring(placeholder_index + ::strlen(current_time_placeholder)).ToData(false);
+	}
+	else
+	{
+		play_list_data->head = play_list.ToData(false);
+	}
+
+	return play_list_data;
+}
+
+void Packetizer::SetRendition(const std::shared_ptr<const RenditionData> &rendition)
 {
-	std::unique_lock<std::mutex> lock(_play_list_guard);
+	std::atomic_store(&_rendition, rendition);
+}
 
-	_play_list = play_list;
+std::shared_ptr<const RenditionData> Packetizer::GetRendition() const
+{
+	return std::atomic_load(&_rendition);
 }
 
 bool Packetizer::IsReadyForStreaming() const noexcept
@@ -151,107 +223,40 @@ void Packetizer::SetReadyForStreaming() noexcept
 	_streaming_start = true;
 }
 
-bool Packetizer::GetPlayList(ov::String &play_list)
+bool Packetizer::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
 {
 	if (IsReadyForStreaming() == false)
 	{
 		return false;
 	}
 
-	std::unique_lock<std::mutex> lock(_play_list_guard);
+	*play_list = std::atomic_load(&_play_list);
 
-	play_list = _play_list;
+	return (*play_list != nullptr);
+}
 
-	return true;
+void Packetizer::SetSegmentStorage(const std::shared_ptr<SegmentStorage> &segment_storage)
+{
+	std::atomic_store(&_segment_storage, segment_storage);
 }
 
-bool Packetizer::GetVideoPlaySegments(std::vector<std::shared_ptr<SegmentData>> &segment_datas)
+std::shared_ptr<ov::Data> Packetizer::StoreSegmentData(const std::shared_ptr<ov::Data> &data)
 {
-	uint32_t begin_index = (_current_video_index >= _segment_count) ? (_current_video_index - _segment_count) : (_segment_save_count - (_segment_count - _current_video_index));
-	uint32_t end_index = (begin_index <= (_segment_save_count - _segment_count)) ? (begin_index + _segment_count) - 1 : (_segment_count - (_segment_save_count - begin_index)) - 1;
+	auto segment_storage = std::atomic_load(&_segment_storage);
 
-	// video segment mutex
-	std::unique_lock<std::mutex> lock(_video_segment_guard);
+	return (segment_storage != nullptr) ? segment_storage->Store(data) : data;
+}
 
-	if (begin_index <= end_index)
-	{
-		for (auto item = _video_segment_datas.begin() + begin_index; item <= _video_segment_datas.begin() + end_index; item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-	}
-	else
-	{
-		for (auto item = _video_segment_datas.begin() + begin_index; item < _video_segment_datas.end(); item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-
-		for (auto item = _video_segment_datas.begin(); item <= _video_segment_datas.begin() + end_index; item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-	}
+bool Packetizer::GetVideoPlaySegments(std::vector<std::shared_ptr<SegmentData>> &segment_datas)
+{
+	_video_segments.GetLatest(_segment_count, &segment_datas);
 
 	return true;
 }
 
 bool Packetizer::GetAudioPlaySegments(std::vector<std::shared_ptr<SegmentData>> &segment_datas)
 {
-	uint32_t begin_index = (_current_audio_index >= _segment_count) ? (_current_audio_index - _segment_count) : (_segment_save_count - (_segment_count - _current_audio_index));
-	uint32_t end_index = (begin_index <= (_segment_save_count - _segment_count)) ? (begin_index + _segment_count) - 1 : (_segment_count - (_segment_save_count - begin_index)) - 1;
-
-	// audio segment mutex
-	std::unique_lock<std::mutex> lock(_audio_segment_guard);
-
-	if (begin_index <= end_index)
-	{
-		for (auto item = _audio_segment_datas.begin() + begin_index; item <= _audio_segment_datas.begin() + end_index; item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-	}
-	else
-	{
-		for (auto item = _audio_segment_datas.begin() + begin_index; item < _audio_segment_datas.end(); item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-		for (auto item = _audio_segment_datas.begin(); item <= _audio_segment_datas.begin() + end_index; item++)
-		{
-			if (*item == nullptr)
-			{
-				return true;
-			}
-
-			segment_datas.push_back(*item);
-		}
-	}
+	_audio_segments.GetLatest(_segment_count, &segment_datas);
 
 	return true;
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "packetizer_define.h"
+#include "segment_ring.h"
+#include "segment_storage.h"
 
 #include <base/info/application.h>
 #include <base/ovlibrary/ovlibrary.h>
@@ -31,6 +33,8 @@ public:
 
 	virtual const std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) = 0;
 	virtual bool SetSegmentData(ov::String file_name, uint64_t duration, int64_t timestamp, std::shared_ptr<ov::Data> &data) = 0;
+	// The key of the encrypted segments (nullptr if the packetizer doesn't encrypt the segments)
+	virtual std::shared_ptr<const ov::Data> GetKey(const ov::String &file_name) const;
 
 	// Convert timescale of "time" to "to_timescale" from "from_timescale"
 	//
@@ -44,10 +48,21 @@ public:
 	//   +--------+---------+--------+-----------+
 	static uint64_t ConvertTimeScale(uint64_t time, const common::Timebase &from_timebase, const common::Timebase &to_timebase);
 
-	void SetPlayList(ov::String &play_list);
+	// current_time_placeholder: the position where the current time is inserted for each request (nullptr if not needed)
+	void SetPlayList(const ov::String &play_list, const char *current_time_placeholder = nullptr);
 
 	virtual bool IsReadyForStreaming() const noexcept;
-	virtual bool GetPlayList(ov::String &play_list);
+	// file_name: the requested file name (the packetizers that have only one playlist ignore it)
+	virtual bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list);
+
+	// The segments of this rendition for the master playlist of the stream group (nullptr if the packetizer does not provide it)
+	std::shared_ptr<const RenditionData> GetRendition() const;
+
+	// Creates the playlist data with the given ETag (for the playlists that are not made by a packetizer)
+	static std::shared_ptr<PlayListData> MakePlayListData(const ov::String &play_list, const ov::String &etag, const char *current_time_placeholder = nullptr);
+
+	// The closed segments are stored in the storage instead of the heap (nullptr: keep them in memory)
+	void SetSegmentStorage(const std::shared_ptr<SegmentStorage> &segment_storage);
 
 	bool GetVideoPlaySegments(std::vector<std::shared_ptr<SegmentData>> &segment_datas);
 	bool GetAudioPlaySegments(std::vector<std::shared_ptr<SegmentData>> &segment_datas);
@@ -62,6 +77,17 @@ public:
 protected:
 	virtual void SetReadyForStreaming() noexcept;
 
+	// Creates a new version of the playlist data (the packetizers that have several playlists keep it by themselves)
+	std::shared_ptr<PlayListData> MakePlayList(const ov::String &play_list, const char *current_time_placeholder = nullptr);
+
+	void SetRendition(const std::shared_ptr<const RenditionData> &rendition);
+
+	// Returns the data to keep in the segment ring (the data that references the segment storage if it is set)
+	std::shared_ptr<ov::Data> StoreSegmentData(const std::shared_ptr<ov::Data> &data);
+
+	// Parses the number from the segment file name (<segment_prefix>_<number>...)
+	bool ParseSegmentNumber(const ov::String &file_name, int64_t *number) const;
+
 	ov::String _app_name;
 	ov::String _stream_name;
 	PacketizerType _packetizer_type;
@@ -78,18 +104,23 @@ protected:
 
 	uint32_t _sequence_number = 1U;
 	bool _streaming_start = false;
-	ov::String _play_list;
+
+	// Accessed with std::atomic_load()/std::atomic_store()
+	std::shared_ptr<const PlayListData> _play_list;
+	// Used to make the ETag unique across the packetizers (and the restarts of the stream)
+	uint32_t _play_list_id = ov::Random::GenerateUInt32();
+	uint64_t _play_list_version = 0ULL;
+
+	// Accessed with std::atomic_load()/std::atomic_store()
+	std::shared_ptr<const RenditionData> _rendition;
 
 	bool _video_init = false;
 	bool _audio_init = false;
 
-	uint32_t _current_video_index = 0U;
-	uint32_t _current_audio_index = 0U;
-
-	std::vector<std::shared_ptr<SegmentData>> _video_segment_datas;  // m4s : video , ts : video+audio
-	std::vector<std::shared_ptr<SegmentData>> _audio_segment_datas;  // m4s : audio
+	// The segments are pushed by the packetizer thread, and read by the HTTP threads without the lock
+	SegmentRing _video_segments;  // m4s : video , ts : video+audio
+	SegmentRing _audio_segments;  // m4s : audio
 
-	std::mutex _video_segment_guard;
-	std::mutex _audio_segment_guard;
-	std::mutex _play_list_guard;
+	// Accessed with std::atomic_load()/std::atomic_store()
+	std::shared_ptr<SegmentStorage> _segment_storage;
 };
@@ -136,3 +136,44 @@ struct PacketizerFrameData
 };
 
 #pragma pack(pop)
+
+// The rendered playlist (m3u8/mpd), which is created when a segment is added and shared by all requests until the next update
+struct PlayListData
+{
+	// "<random id of the packetizer>-<version>", the version is increased whenever the playlist is updated
+	ov::String etag;
+	// Last-Modified (RFC 7231 IMF-fixdate)
+	ov::String last_modified;
+
+	// If the playlist has a position where the current time is inserted for each request (DASH UTCTiming),
+	// it is split into head/tail at the position. Otherwise, the whole playlist is in head and tail is nullptr.
+	std::shared_ptr<const ov::Data> head;
+	std::shared_ptr<const ov::Data> tail;
+
+	// LL-HLS: the position of the last partial segment in the playlist (the segment msn is being created),
+	// -1 if there is no part of the segment yet. Used to hold the blocking playlist reloads (_HLS_msn/_HLS_part).
+	int64_t last_msn = -1LL;
+	int64_t last_part = -1LL;
+	// How long a blocking playlist reload can be held (3 x target duration)
+	int64_t max_blocking_time_ms = 0LL;
+
+	// A static playlist is the same for all requests, so it can be revalidated with ETag
+	bool IsStatic() const
+	{
+		return tail == nullptr;
+	}
+};
+
+// The segments of a rendition, updated with the playlist (DASH).
+// The master playlist of a stream group lists them in a Representation of each rendition.
+struct RenditionData
+{
+	// availabilityStartTime of the rendition
+	ov::String start_time;
+	double time_shift_buffer_depth = 0.0;
+	double minimum_update_period = 0.0;
+
+	// <S> elements of <SegmentTimeline>
+	ov::String video_timeline;
+	ov::String audio_timeline;
+};
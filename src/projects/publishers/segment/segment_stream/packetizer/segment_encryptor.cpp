@@ -0,0 +1,157 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "segment_encryptor.h"
+
+#include <openssl/rand.h>
+
+#define OV_LOG_TAG "SegmentEncryptor"
+
+// AES block size
+#define SEGMENT_ENCRYPTION_BLOCK_SIZE 16
+
+SegmentEncryptor::SegmentEncryptor(const Options &options, size_t key_count)
+	: _options(options),
+	  _key_count(std::max(key_count, static_cast<size_t>(1)))
+{
+	_cipher_context = ::EVP_CIPHER_CTX_new();
+
+	if ((_cipher_context != nullptr) &&
+		(::EVP_EncryptInit_ex(_cipher_context, ::EVP_aes_128_cbc(), nullptr, nullptr, nullptr) != 1))
+	{
+		::EVP_CIPHER_CTX_free(_cipher_context);
+		_cipher_context = nullptr;
+	}
+
+	if (_cipher_context == nullptr)
+	{
+		logte("Could not create the cipher context");
+	}
+}
+
+SegmentEncryptor::~SegmentEncryptor()
+{
+	if (_cipher_context != nullptr)
+	{
+		::EVP_CIPHER_CTX_free(_cipher_context);
+		_cipher_context = nullptr;
+	}
+}
+
+uint32_t SegmentEncryptor::GetKeyIndex(uint32_t sequence_number) const
+{
+	if (_options.key_rotation == 0)
+	{
+		return 0;
+	}
+
+	// The sequence number starts from 1
+	return (std::max(sequence_number, 1U) - 1) / _options.key_rotation;
+}
+
+void SegmentEncryptor::MakeIv(uint32_t sequence_number, uint8_t iv[SEGMENT_ENCRYPTION_IV_SIZE])
+{
+	::memset(iv, 0, SEGMENT_ENCRYPTION_IV_SIZE);
+
+	for (size_t index = 0; index < sizeof(sequence_number); index++)
+	{
+		iv[SEGMENT_ENCRYPTION_IV_SIZE - 1 - index] = static_cast<uint8_t>(sequence_number >> (index * 8));
+	}
+}
+
+ov::String SegmentEncryptor::MakeIvString(uint32_t sequence_number)
+{
+	uint8_t iv[SEGMENT_ENCRYPTION_IV_SIZE];
+
+	MakeIv(sequence_number, iv);
+
+	return ov::String::FormatString("0x%s", ov::ToHexString(iv, sizeof(iv)).CStr());
+}
+
+std::shared_ptr<const ov::Data> SegmentEncryptor::GetOrCreateKey(uint32_t key_index)
+{
+	std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+	auto item = _keys.find(key_index);
+
+	if (item != _keys.end())
+	{
+		return item->second;
+	}
+
+	auto key = std::make_shared<ov::Data>(SEGMENT_ENCRYPTION_KEY_SIZE);
+	key->SetLength(SEGMENT_ENCRYPTION_KEY_SIZE);
+
+	if (::RAND_bytes(key->GetWritableDataAs<uint8_t>(), SEGMENT_ENCRYPTION_KEY_SIZE) != 1)
+	{
+		logte("Could not generate the key #%u", key_index);
+		return nullptr;
+	}
+
+	_keys.emplace(key_index, key);
+
+	// The keys of the segments that are already removed from the playlist are not needed anymore
+	while (_keys.size() > _key_count)
+	{
+		_keys.erase(_keys.begin());
+	}
+
+	return key;
+}
+
+std::shared_ptr<ov::Data> SegmentEncryptor::Encrypt(uint32_t sequence_number, const std::shared_ptr<const ov::Data> &data)
+{
+	if ((_cipher_context == nullptr) || (data == nullptr))
+	{
+		return nullptr;
+	}
+
+	auto key = GetOrCreateKey(GetKeyIndex(sequence_number));
+
+	if (key == nullptr)
+	{
+		return nullptr;
+	}
+
+	uint8_t iv[SEGMENT_ENCRYPTION_IV_SIZE];
+	MakeIv(sequence_number, iv);
+
+	auto length = data->GetLength();
+	// PKCS#7 always adds the padding (a full block if the length is a multiple of the block size)
+	auto encrypted_length = ((length / SEGMENT_ENCRYPTION_BLOCK_SIZE) + 1) * SEGMENT_ENCRYPTION_BLOCK_SIZE;
+
+	auto encrypted = std::make_shared<ov::Data>(encrypted_length);
+	encrypted->SetLength(encrypted_length);
+
+	auto buffer = encrypted->GetWritableDataAs<uint8_t>();
+	int update_length = 0;
+	int final_length = 0;
+
+	// The cipher is set in the constructor, only the key and IV are changed for each segment
+	if ((::EVP_EncryptInit_ex(_cipher_context, nullptr, nullptr, key->GetDataAs<uint8_t>(), iv) != 1) ||
+		(::EVP_EncryptUpdate(_cipher_context, buffer, &update_length, data->GetDataAs<uint8_t>(), static_cast<int>(length)) != 1) ||
+		(::EVP_EncryptFinal_ex(_cipher_context, buffer + update_length, &final_length) != 1))
+	{
+		logte("Could not encrypt the segment #%u (length: %zu)", sequence_number, length);
+		return nullptr;
+	}
+
+	OV_ASSERT2(static_cast<size_t>(update_length + final_length) == encrypted_length);
+	encrypted->SetLength(update_length + final_length);
+
+	return encrypted;
+}
+
+std::shared_ptr<const ov::Data> SegmentEncryptor::GetKey(uint32_t key_index) const
+{
+	std::lock_guard<std::mutex> lock_guard(_key_mutex);
+
+	auto item = _keys.find(key_index);
+
+	return (item != _keys.end()) ? item->second : nullptr;
+}
@@ -0,0 +1,70 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <openssl/evp.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+
+#define SEGMENT_ENCRYPTION_KEY_SIZE 16
+#define SEGMENT_ENCRYPTION_IV_SIZE 16
+
+// Encrypts the closed segments with AES-128-CBC (PKCS#7 padding), which is METHOD=AES-128 of HLS.
+//
+// A segment is encrypted once when it is closed, and the encrypted data is shared by all requests (and stored like the clear one),
+// so there is no per-request work. The cipher context is reused for all segments (OpenSSL uses AES-NI if the CPU supports it).
+// The key is changed every key_rotation segments, and the keys of the recent segments are kept to be served to the players.
+class SegmentEncryptor
+{
+public:
+	struct Options
+	{
+		// The number of the segments encrypted with a key (0: the key is not changed)
+		uint32_t key_rotation = 0;
+	};
+
+	// key_count: the number of the recent keys to keep (the keys of the segments that can be requested)
+	SegmentEncryptor(const Options &options, size_t key_count);
+	~SegmentEncryptor();
+
+	SegmentEncryptor(const SegmentEncryptor &encryptor) = delete;
+	SegmentEncryptor &operator=(const SegmentEncryptor &encryptor) = delete;
+
+	// The index of the key that encrypts the segment
+	uint32_t GetKeyIndex(uint32_t sequence_number) const;
+
+	// The IV of the segment (the sequence number in big-endian, as HLS does if the IV is omitted)
+	static void MakeIv(uint32_t sequence_number, uint8_t iv[SEGMENT_ENCRYPTION_IV_SIZE]);
+	// "0x" + the IV in hex (for the IV attribute of #EXT-X-KEY)
+	static ov::String MakeIvString(uint32_t sequence_number);
+
+	// Returns the encrypted segment (nullptr if failed)
+	// Must be called by the thread that closes the segments
+	std::shared_ptr<ov::Data> Encrypt(uint32_t sequence_number, const std::shared_ptr<const ov::Data> &data);
+
+	// Returns nullptr if the key is rotated out (or not created yet)
+	// Can be called by any thread
+	std::shared_ptr<const ov::Data> GetKey(uint32_t key_index) const;
+
+protected:
+	std::shared_ptr<const ov::Data> GetOrCreateKey(uint32_t key_index);
+
+	Options _options;
+	size_t _key_count;
+
+	EVP_CIPHER_CTX *_cipher_context = nullptr;
+
+	// key index => key
+	mutable std::mutex _key_mutex;
+	std::map<uint32_t, std::shared_ptr<const ov::Data>> _keys;
+};
@@ -0,0 +1,112 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "segment_ring.h"
+
+SegmentRing::SegmentRing(size_t capacity)
+	: _slots(std::max(capacity, static_cast<size_t>(1)))
+{
+}
+
+void SegmentRing::Push(int64_t number, const std::shared_ptr<SegmentData> &segment)
+{
+	auto push_count = _push_count.load(std::memory_order_relaxed);
+	auto &slot = _slots[push_count % _slots.size()];
+
+	if ((push_count > 0) && (number != (_last_number.load(std::memory_order_relaxed) + 1)))
+	{
+		_is_sequential.store(false, std::memory_order_relaxed);
+	}
+
+	// The reader checks the file name of the loaded segment, so it doesn't matter if it sees the new number with the old segment
+	slot.number.store(number, std::memory_order_relaxed);
+	std::atomic_store(&slot.segment, segment);
+
+	_last_number.store(number, std::memory_order_relaxed);
+	_push_count.store(push_count + 1, std::memory_order_release);
+}
+
+std::shared_ptr<SegmentData> SegmentRing::LoadIfMatched(const Slot &slot, const ov::String &file_name) const
+{
+	auto segment = std::atomic_load(&slot.segment);
+
+	if ((segment != nullptr) && (segment->file_name == file_name))
+	{
+		return segment;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<SegmentData> SegmentRing::Find(int64_t number, const ov::String &file_name) const
+{
+	auto push_count = _push_count.load(std::memory_order_acquire);
+
+	if (push_count == 0)
+	{
+		return nullptr;
+	}
+
+	auto capacity = _slots.size();
+
+	if (_is_sequential.load(std::memory_order_relaxed))
+	{
+		// _last_number might be newer than push_count, then the slot doesn't match and the slots are scanned
+		auto distance = _last_number.load(std::memory_order_relaxed) - number;
+
+		if ((distance >= 0) && (static_cast<uint64_t>(distance) < std::min(push_count, static_cast<uint64_t>(capacity))))
+		{
+			auto segment = LoadIfMatched(_slots[(push_count - 1 - distance) % capacity], file_name);
+
+			if (segment != nullptr)
+			{
+				return segment;
+			}
+		}
+	}
+
+	for (auto &slot : _slots)
+	{
+		if (slot.number.load(std::memory_order_relaxed) == number)
+		{
+			auto segment = LoadIfMatched(slot, file_name);
+
+			if (segment != nullptr)
+			{
+				return segment;
+			}
+		}
+	}
+
+	return nullptr;
+}
+
+void SegmentRing::GetLatest(size_t count, std::vector<std::shared_ptr<SegmentData>> *segments) const
+{
+	auto push_count = _push_count.load(std::memory_order_acquire);
+	auto capacity = _slots.size();
+
+	count = std::min(count, capacity);
+
+	if (push_count < count)
+	{
+		return;
+	}
+
+	for (uint64_t index = push_count - count; index < push_count; index++)
+	{
+		auto segment = std::atomic_load(&(_slots[index % capacity].segment));
+
+		if (segment == nullptr)
+		{
+			return;
+		}
+
+		segments->push_back(segment);
+	}
+}
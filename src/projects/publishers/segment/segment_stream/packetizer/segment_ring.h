@@ -0,0 +1,60 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "packetizer_define.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// A fixed-size ring of the recent segments, which is written by the packetizer thread and read by the HTTP threads without a lock.
+//
+// Each segment is indexed by the number in its file name (<prefix>_<number>...), which is the sequence number for HLS/CMAF
+// and the start timestamp for DASH. If the numbers are consecutive, the slot is calculated from the number directly,
+// otherwise the numbers of the slots are compared (the file name is compared only once for the found slot).
+class SegmentRing
+{
+public:
+	explicit SegmentRing(size_t capacity);
+
+	// Only one thread can push the segments
+	void Push(int64_t number, const std::shared_ptr<SegmentData> &segment);
+
+	// Returns nullptr if the segment is already removed from the ring (or not created yet)
+	std::shared_ptr<SegmentData> Find(int64_t number, const ov::String &file_name) const;
+
+	// Returns the last <count> segments in the order of creation
+	// (the segments are not returned until <count> segments are pushed, like the previous implementation)
+	void GetLatest(size_t count, std::vector<std::shared_ptr<SegmentData>> *segments) const;
+
+	size_t GetCapacity() const
+	{
+		return _slots.size();
+	}
+
+protected:
+	struct Slot
+	{
+		std::atomic<int64_t> number{0};
+		// Accessed with std::atomic_load()/std::atomic_store()
+		std::shared_ptr<SegmentData> segment;
+	};
+
+	std::shared_ptr<SegmentData> LoadIfMatched(const Slot &slot, const ov::String &file_name) const;
+
+	std::vector<Slot> _slots;
+
+	// The number of segments that have been pushed
+	std::atomic<uint64_t> _push_count{0};
+
+	// The number of the last pushed segment, and whether the numbers have been consecutive
+	std::atomic<int64_t> _last_number{0};
+	std::atomic<bool> _is_sequential{true};
+};
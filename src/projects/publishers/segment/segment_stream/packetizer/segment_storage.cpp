@@ -0,0 +1,99 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "segment_storage.h"
+#include "../segment_stream_private.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::shared_ptr<SegmentStorage> SegmentStorage::Create(const ov::String &directory)
+{
+	if (directory.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	if (::access(directory.CStr(), W_OK) != 0)
+	{
+		logte("Could not use the segment storage: %s (%s)", directory.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return nullptr;
+	}
+
+	logti("The segments are stored in %s", directory.CStr());
+
+	return std::make_shared<SegmentStorage>(directory);
+}
+
+SegmentStorage::SegmentStorage(const ov::String &directory)
+	: _directory(directory)
+{
+}
+
+std::shared_ptr<ov::Data> SegmentStorage::Store(const std::shared_ptr<ov::Data> &data)
+{
+	if ((data == nullptr) || data->IsEmpty())
+	{
+		return data;
+	}
+
+	auto file_path = ov::String::FormatString("%s/ome_segment_%d_%p_%llu", _directory.CStr(), ::getpid(), this, ++_last_file_id);
+
+	int fd = ::open(file_path.CStr(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+
+	if (fd < 0)
+	{
+		logtw("Could not create a segment file: %s (%s)", file_path.CStr(), ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		return data;
+	}
+
+	// The file is removed when the mapping is released (and nothing is left if the process is terminated)
+	::unlink(file_path.CStr());
+
+	auto buffer = data->GetDataAs<uint8_t>();
+	auto length = data->GetLength();
+	size_t written = 0;
+
+	while (written < length)
+	{
+		auto result = ::write(fd, buffer + written, length - written);
+
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			logtw("Could not write the segment to the file (%zu bytes): %s", length, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+			::close(fd);
+			return data;
+		}
+
+		written += result;
+	}
+
+	auto mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+
+	if (mapping == MAP_FAILED)
+	{
+		logtw("Could not map the segment file (%zu bytes): %s", length, ov::Error::CreateErrorFromErrno()->ToString().CStr());
+		::close(fd);
+		return data;
+	}
+
+	// The file descriptor is kept open with the mapping, so the plain HTTP responses can be sent using sendfile()
+	auto owner = std::shared_ptr<const void>(mapping, [length, fd](const void *address) {
+		::munmap(const_cast<void *>(address), length);
+		::close(fd);
+	});
+
+	return std::make_shared<ov::Data>(mapping, length, owner, fd, 0);
+}
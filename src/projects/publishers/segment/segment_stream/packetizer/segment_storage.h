@@ -0,0 +1,43 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <atomic>
+#include <memory>
+
+// Keeps the closed segments in the files instead of the heap, so the segment history (DVR window) doesn't grow the RSS.
+//
+// Each segment is written to a file in the directory (tmpfs such as /dev/shm is recommended), which is unlinked right after it is mapped.
+// The returned data references the mapping without copying, and the mapping (and the file) is released with the last reference,
+// even if the data is still waiting in the send queue of a socket.
+// The data also keeps the file descriptor, so the sockets can send it with sendfile() instead of copying it from the mapping.
+class SegmentStorage
+{
+public:
+	// Returns nullptr if the directory is not writable
+	static std::shared_ptr<SegmentStorage> Create(const ov::String &directory);
+
+	explicit SegmentStorage(const ov::String &directory);
+
+	// Returns the data that references the file, or the data itself if it could not be stored
+	std::shared_ptr<ov::Data> Store(const std::shared_ptr<ov::Data> &data);
+
+	const ov::String &GetDirectory() const
+	{
+		return _directory;
+	}
+
+protected:
+	ov::String _directory;
+
+	// Used to make the file names unique
+	std::atomic<uint64_t> _last_file_id{0};
+};
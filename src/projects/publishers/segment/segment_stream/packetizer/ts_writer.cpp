@@ -146,6 +146,38 @@ bool TsWriter::WriteDataStream(int data_size, const uint8_t *data)
 	return true;
 }
 
+//====================================================================================================
+// Sample 들을 위한 버퍼 확보
+// - 각 Sample은 최대 (PES Header + AUD + PCR adaptation) 만큼 증가
+//====================================================================================================
+void TsWriter::Reserve(size_t sample_count, size_t total_sample_size)
+{
+	size_t payload_size = total_sample_size + sample_count * (PES_HEADER_WIDTH_DTS_SIZE + H264_AUD_SIZE + 2 + TS_PCR_ADAPTATION_SIZE);
+
+	// The last packet of each sample may be stuffed
+	size_t packet_count = (payload_size / TS_PACKET_PAYLOAD_SIZE) + sample_count;
+
+	_data_stream->Reserve(_data_stream->GetLength() + packet_count * TS_PACKET_SIZE);
+}
+
+//====================================================================================================
+// Stream Data 버퍼에 TS 패킷 공간 추가
+//====================================================================================================
+uint8_t *TsWriter::AllocatePackets(size_t packet_count)
+{
+	auto offset = _data_stream->GetLength();
+	auto length = offset + packet_count * TS_PACKET_SIZE;
+
+	if (_data_stream->GetCapacity() < length)
+	{
+		_data_stream->Reserve(std::max(length, _data_stream->GetCapacity() * 2));
+	}
+
+	_data_stream->SetLength(length);
+
+	return _data_stream->GetWritableDataAs<uint8_t>() + offset;
+}
+
 //====================================================================================================
 // PAT(Program Association Table)  쓰기
 // - 프로그램의 번호와 Program Map Table을 담고 있는 패킷의 Packet Identifier(PID) 간의 연결 관계를 담고 있다.
@@ -273,6 +305,7 @@ bool TsWriter::WritePMT()
 // - PES 헤더 추가 (DTS 사용 않함)
 //    Header(9Byte) + PTS(5Byte) + [DTS(5Byte)]
 // - TS 헤더 추가
+// - 필요한 패킷 수를 미리 계산하여 버퍼에 직접 기록 (frame data는 복사 외에 변경하지 않음)
 //====================================================================================================
 bool TsWriter::WriteSample(bool is_video,
 						   bool is_keyframe,
@@ -284,82 +317,82 @@ bool TsWriter::WriteSample(bool is_video,
 		0,
 	};
 	uint32_t pes_header_size = 0;
-	uint32_t rest_data_size = 0;
-	uint32_t payload_size = 0;
-	const uint8_t *data_pos = nullptr;
-	bool first_payload = true;
 
 	//Video(H264) - access unit delimiter(AUD) 정보 추가
-	if (is_video)
-	{
-		data->Insert(g_aud, 0, H264_AUD_SIZE);
-	}
+	uint32_t aud_size = is_video ? H264_AUD_SIZE : 0;
 
-	data_pos = data->GetDataAs<uint8_t>();
+	const uint8_t *data_pos = data->GetDataAs<uint8_t>();
+	uint32_t data_size = static_cast<uint32_t>(data->GetLength());
 
 	// PES Header 생성
-	MakePesHeader(data->GetLength(), is_video, timestamp, time_offset, pes_header, pes_header_size);
+	MakePesHeader(aud_size + data_size, is_video, timestamp, time_offset, pes_header, pes_header_size);
+
+	int pid = is_video ? TS_DEFAULT_VIDEO_PID : TS_DEFAULT_AUDIO_PID;
+	uint32_t &continuity_count = is_video ? _video_continuity_count : _audio_continuity_count;
+	bool use_pcr = is_video || (!_video_enable && _audio_enable);
 
 	// TS Header + Payload 설정
-	rest_data_size = pes_header_size + data->GetLength();
+	uint32_t rest_data_size = pes_header_size + aud_size + data_size;
+
+	// 패킷 수 계산 (첫 패킷은 PCR 만큼 작음)
+	uint32_t first_payload_size = TS_PACKET_PAYLOAD_SIZE - (use_pcr ? (2 + TS_PCR_ADAPTATION_SIZE) : 0);
+	size_t packet_count = 1;
+
+	if (rest_data_size > first_payload_size)
+	{
+		packet_count += (rest_data_size - first_payload_size + TS_PACKET_PAYLOAD_SIZE - 1) / TS_PACKET_PAYLOAD_SIZE;
+	}
+
+	uint8_t *packet = AllocatePackets(packet_count);
+
+	// First packet: TS Header + PES Header + AUD + Data
+	uint32_t payload_size = rest_data_size;
+	uint8_t *payload = packet + WriteTsHeader(packet, pid, continuity_count++, true, payload_size, use_pcr, timestamp * 300, is_keyframe);
 
-	// Buffer 공간 체크
-	// (Payload 개수 + 2)*  TS_PACKET_SIZE
+	::memcpy(payload, pes_header, pes_header_size);
+	payload += pes_header_size;
+
+	if (aud_size > 0)
+	{
+		::memcpy(payload, g_aud, aud_size);
+		payload += aud_size;
+	}
+
+	payload_size -= (pes_header_size + aud_size);
+	::memcpy(payload, data_pos, payload_size);
+
+	data_pos += payload_size;
+	rest_data_size -= (pes_header_size + aud_size + payload_size);
+	packet += TS_PACKET_SIZE;
 
 	while (rest_data_size > 0)
 	{
 		payload_size = rest_data_size;
-
-		if (payload_size > TS_PACKET_PAYLOAD_SIZE)
-		{
-			payload_size = TS_PACKET_PAYLOAD_SIZE;
-		}
-
-		if (first_payload)
-		{
-			first_payload = false;
-
-			// TS Header 설정
-			if (is_video)
-				MakeTsHeader(TS_DEFAULT_VIDEO_PID,
-							 _video_continuity_count++,
-							 true,
-							 payload_size,
-							 true,
-							 timestamp * 300,
-							 is_keyframe);
-			else
-				MakeTsHeader(TS_DEFAULT_AUDIO_PID,
-							 _audio_continuity_count++,
-							 true,
-							 payload_size,
-							 (!_video_enable && _audio_enable),
-							 timestamp * 300,
-							 is_keyframe);
-
-			// PES헤더 설정
-			WriteDataStream(pes_header_size, pes_header);
-			rest_data_size -= pes_header_size;
-			payload_size -= pes_header_size;
-		}
-		else
-		{
-			// TS Header 설정
-			if (is_video)
-				MakeTsHeader(TS_DEFAULT_VIDEO_PID, _video_continuity_count++, false, payload_size, false, 0, is_keyframe);
-			else
-				MakeTsHeader(TS_DEFAULT_AUDIO_PID, _audio_continuity_count++, false, payload_size, false, 0, is_keyframe);
-		}
+		payload = packet + WriteTsHeader(packet, pid, continuity_count++, false, payload_size, false, 0, is_keyframe);
 
 		// Data 설정
-		WriteDataStream(payload_size, data_pos);
+		::memcpy(payload, data_pos, payload_size);
 		data_pos += payload_size;
 		rest_data_size -= payload_size;
-	};
+		packet += TS_PACKET_SIZE;
+	}
 
 	return true;
 }
 
+//====================================================================================================
+// PTS/DTS 기록 (5Byte)
+// - prefix(4bit) + [32..30](3bit) + marker + [29..15](15bit) + marker + [14..0](15bit) + marker
+//====================================================================================================
+static inline void WritePesTimestamp(uint8_t *buffer, uint8_t prefix, uint64_t timestamp)
+{
+	buffer[0] = static_cast<uint8_t>((prefix << 4) | (((timestamp >> 30) & 0x07) << 1) | 0x01);
+	buffer[1] = static_cast<uint8_t>(timestamp >> 22);
+	buffer[2] = static_cast<uint8_t>((((timestamp >> 15) & 0x7F) << 1) | 0x01);
+	buffer[3] = static_cast<uint8_t>(timestamp >> 7);
+	buffer[4] = static_cast<uint8_t>(((timestamp & 0x7F) << 1) | 0x01);
+}
+
 //====================================================================================================
 // PES Header 생성 (Packetized Elementary Stream )
 // - 네트워크 전송을 위한 패킷의 크기로 나누어진 Elementary Stream이다. 분할된 첫 조각을 포함하는 패킷에는 PES 헤더라는 정보가 포함되어 전송되며 이후에는 분할된 데이터만 포함된다.
@@ -402,48 +435,25 @@ bool TsWriter::MakePesHeader(int data_size,
 	}
 
 	//PES Header 설정
-	BitWriter pes_bit(header_size);
-	pes_bit.Write(24, 0x000001);		 // packet_start_code_prefix
-	pes_bit.Write(8, stream_id);		 // stream_id
-	pes_bit.Write(16, pes_packet_size);  // PES_packet_length
-	pes_bit.Write(2, 2);				 // '01'
-	pes_bit.Write(2, 0);				 // PES_scrambling_control
-	pes_bit.Write(1, 0);				 // PES_priority
-	pes_bit.Write(1, 1);				 // data_alignment_indicator
-	pes_bit.Write(1, 0);				 // copyright
-	pes_bit.Write(1, 0);				 // original_or_copy
-	pes_bit.Write(2, is_dts ? 3 : 2);	// PTS_DTS_flags
-	pes_bit.Write(1, 0);				 // ESCR_flag
-	pes_bit.Write(1, 0);				 // ES_rate_flag
-	pes_bit.Write(1, 0);				 // DSM_trick_mode_flag
-	pes_bit.Write(1, 0);				 // additional_copy_info_flag
-	pes_bit.Write(1, 0);				 // PES_CRC_flag
-	pes_bit.Write(1, 0);				 // PES_extension_flag
-	pes_bit.Write(8, header_size - 9);   // PES_header_data_length
-
-	//PTS
-	pes_bit.Write(4, is_dts ? 3 : 2);		   // '0010'(PTS) or '0011'(PTS+DTS)
-	pes_bit.Write(3, (uint32_t)(pts >> 30));   // PTS[32..30]
-	pes_bit.Write(1, 1);					   // marker_bit
-	pes_bit.Write(15, (uint32_t)(pts >> 15));  // PTS[29..15]
-	pes_bit.Write(1, 1);					   // marker_bit
-	pes_bit.Write(15, (uint32_t)pts);		   // PTS[14..0]
-	pes_bit.Write(1, 1);					   // market_bit
-
-	//DTS
+	header[0] = 0x00;										 // packet_start_code_prefix
+	header[1] = 0x00;
+	header[2] = 0x01;
+	header[3] = static_cast<uint8_t>(stream_id);			 // stream_id
+	header[4] = static_cast<uint8_t>(pes_packet_size >> 8);  // PES_packet_length
+	header[5] = static_cast<uint8_t>(pes_packet_size);
+	header[6] = 0x84;										 // '10' + data_alignment_indicator
+	header[7] = is_dts ? 0xC0 : 0x80;						 // PTS_DTS_flags
+	header[8] = static_cast<uint8_t>(header_size - 9);		 // PES_header_data_length
+
+	//PTS: '0010'(PTS) or '0011'(PTS+DTS)
+	WritePesTimestamp(header + 9, is_dts ? 3 : 2, pts);
+
+	//DTS: '0001'
 	if (is_dts)
 	{
-		pes_bit.Write(4, 1);					   // '0001'
-		pes_bit.Write(3, (uint32_t)(dts >> 30));   // DTS[32..30]
-		pes_bit.Write(1, 1);					   // marker_bit
-		pes_bit.Write(15, (uint32_t)(dts >> 15));  // DTS[29..15]
-		pes_bit.Write(1, 1);					   // marker_bit
-		pes_bit.Write(15, (uint32_t)dts);		   // DTS[14..0]
-		pes_bit.Write(1, 1);					   // market_bit
+		WritePesTimestamp(header + 14, 1, dts);
 	}
 
-	memcpy(header, pes_bit.GetData(), pes_bit.GetDataSize());
-
 	return true;
 }
 
@@ -452,27 +462,22 @@ bool TsWriter::MakePesHeader(int data_size,
 // - PCR : Program Clock Reference
 // - Adaptation field control : Playload의 위치가 확인
 // - Continuity counter : 0~15 순환되며  각각 패킷에 부여
+// - packet 에는 TS_PACKET_SIZE 공간이 있어야 함
 //====================================================================================================
-bool TsWriter::MakeTsHeader(int pid,
-							uint32_t continuity_count,
-							bool payload_start,
-							uint32_t &payload_size,
-							bool use_pcr,
-							uint64_t pcr,
-							bool is_keyframe)
+uint32_t TsWriter::WriteTsHeader(uint8_t *packet,
+								 int pid,
+								 uint32_t continuity_count,
+								 bool payload_start,
+								 uint32_t &payload_size,
+								 bool use_pcr,
+								 uint64_t pcr,
+								 bool is_keyframe)
 {
-	uint8_t header[TS_HEADER_SIZE] = {
-		0,
-	};
-	uint8_t adaptation_data[TS_PCR_ADAPTATION_SIZE] = {
-		0,
-	};
 	uint32_t adaptation_field_size = 0;
-	uint32_t pcr_size = 0;
 
-	header[0] = TS_SYNC_BYTE;
-	header[1] = (uint8_t)(((payload_start ? 1 : 0) << 6) | (pid >> 8));
-	header[2] = (uint8_t)(pid & 0xFF);
+	packet[0] = TS_SYNC_BYTE;
+	packet[1] = (uint8_t)(((payload_start ? 1 : 0) << 6) | (pid >> 8));
+	packet[2] = (uint8_t)(pid & 0xFF);
 
 	if (use_pcr)
 	{
@@ -494,28 +499,21 @@ bool TsWriter::MakeTsHeader(int pid,
 	// no adaptation field
 	if (adaptation_field_size == 0)
 	{
-		header[3] = (uint8_t)(1 << 4 | (continuity_count & 0x0F));
-
-		//Segment 데이터 설정
-		WriteDataStream(4, header);
+		packet[3] = (uint8_t)(1 << 4 | (continuity_count & 0x0F));
 
-		return true;
+		return TS_HEADER_SIZE;
 	}
 
 	// adaptation field present
-	header[3] = (uint8_t)(3 << 4 | (continuity_count & 0x0F));
+	packet[3] = (uint8_t)(3 << 4 | (continuity_count & 0x0F));
 
-	//Segment 데이터 설정
-	WriteDataStream(4, header);
+	uint8_t *adaptation_data = packet + TS_HEADER_SIZE;
 
 	if (adaptation_field_size == 1)
 	{
 		adaptation_data[0] = 0;
 
-		//Segment 데이터 설정
-		WriteDataStream(1, adaptation_data);
-
-		return true;
+		return TS_HEADER_SIZE + 1;
 	}
 
 	// two or more bytes (stuffing and/or PCR)
@@ -527,22 +525,20 @@ bool TsWriter::MakeTsHeader(int pid,
 		adaptation_data[1] = (uint8_t)(adaptation_data[1] | 1 << 6);
 	}
 
-	//Segment 데이터 설정
-	WriteDataStream(2, adaptation_data);
+	uint32_t pcr_size = 0;
 
 	if (use_pcr)
 	{
-		BitWriter pcr_bit(TS_PCR_ADAPTATION_SIZE);
+		// base(33bit) + reserved(6bit) + extension(9bit)
 		uint64_t pcr_base = pcr / 300;
 		uint32_t pcr_ext = (uint32_t)(pcr % 300);
 
-		pcr_bit.Write(1, (uint32_t)(pcr_base >> 32));
-		pcr_bit.Write(32, (uint32_t)pcr_base);
-		pcr_bit.Write(6, 0x3F);
-		pcr_bit.Write(9, pcr_ext);
-
-		//Segment 데이터 설정
-		WriteDataStream((int)pcr_bit.GetDataSize(), pcr_bit.GetData());
+		adaptation_data[2] = (uint8_t)(pcr_base >> 25);
+		adaptation_data[3] = (uint8_t)(pcr_base >> 17);
+		adaptation_data[4] = (uint8_t)(pcr_base >> 9);
+		adaptation_data[5] = (uint8_t)(pcr_base >> 1);
+		adaptation_data[6] = (uint8_t)(((pcr_base & 0x01) << 7) | 0x7E | ((pcr_ext >> 8) & 0x01));
+		adaptation_data[7] = (uint8_t)(pcr_ext);
 
 		//PCR 사이즈 저장
 		pcr_size = TS_PCR_ADAPTATION_SIZE;
@@ -551,8 +547,26 @@ bool TsWriter::MakeTsHeader(int pid,
 	//Stuffing Bytes
 	if (adaptation_field_size > 2)
 	{
-		WriteDataStream(adaptation_field_size - pcr_size - 2, HLS_STUFFING_BYTES);
+		::memset(adaptation_data + 2 + pcr_size, 0xFF, adaptation_field_size - pcr_size - 2);
 	}
 
-	return true;
+	return TS_HEADER_SIZE + adaptation_field_size;
+}
+
+//====================================================================================================
+// TS Header 설정 (Stream Data 버퍼에 추가)
+//====================================================================================================
+bool TsWriter::MakeTsHeader(int pid,
+							uint32_t continuity_count,
+							bool payload_start,
+							uint32_t &payload_size,
+							bool use_pcr,
+							uint64_t pcr,
+							bool is_keyframe)
+{
+	uint8_t header[TS_PACKET_SIZE];
+
+	auto header_size = WriteTsHeader(header, pid, continuity_count, payload_start, payload_size, use_pcr, pcr, is_keyframe);
+
+	return WriteDataStream(header_size, header);
 }
@@ -29,6 +29,9 @@ public :
                    uint64_t time_offset,
                    std::shared_ptr<ov::Data> &frame_data);
 
+	// Reserves the buffer for the samples to be written (to avoid growing the buffer for each sample)
+	void Reserve(size_t sample_count, size_t total_sample_size);
+
 	std::shared_ptr<ov::Data> GetDataStream()
 	{
 		return _data_stream;
@@ -45,6 +48,16 @@ protected :
                         uint8_t * header,
                         uint32_t & header_size);
 
+	// Writes TS header + adaptation field to the packet, and returns the size of them
+	static uint32_t WriteTsHeader(uint8_t *packet,
+						int pid,
+						uint32_t continuity_count,
+						bool payload_start,
+						uint32_t & payload_size,
+						bool use_pcr,
+						uint64_t pcr,
+						bool is_keyframe);
+
 	bool MakeTsHeader(int pid,
                         uint32_t continuity_count,
                         bool payload_start,
@@ -55,6 +68,9 @@ protected :
 
 	bool WriteDataStream(int data_size, const uint8_t * dat);
 
+	// Appends the packets to the stream, and returns the pointer to the first packet
+	uint8_t *AllocatePackets(size_t packet_count);
+
 protected :
     bool _video_enable;
     bool _audio_enable;
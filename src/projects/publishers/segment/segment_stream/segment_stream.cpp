@@ -8,6 +8,7 @@
 //==============================================================================
 
 #include "segment_stream.h"
+#include "base/publisher/application.h"
 #include "config/items/items.h"
 #include "segment_stream_private.h"
 #include "stream_packetizer.h"
@@ -24,7 +25,8 @@ SegmentStream::~SegmentStream()
 	Stop();
 }
 
-bool SegmentStream::Start(int segment_count, int segment_duration, uint32_t worker_count)
+bool SegmentStream::Start(int segment_count, int segment_duration, uint32_t worker_count, const std::shared_ptr<SegmentStorage> &segment_storage,
+						  const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options)
 {
 	std::shared_ptr<MediaTrack> video_track = nullptr;
 	std::shared_ptr<MediaTrack> audio_track = nullptr;
@@ -68,23 +70,31 @@ bool SegmentStream::Start(int segment_count, int segment_duration, uint32_t work
 
 	if ((video_track != nullptr) || (audio_track != nullptr))
 	{
-		PacketizerStreamType stream_type = PacketizerStreamType::Common;
+		_stream_type = PacketizerStreamType::Common;
 
 		if (video_track == nullptr)
 		{
-			stream_type = PacketizerStreamType::AudioOnly;
+			_stream_type = PacketizerStreamType::AudioOnly;
 		}
 
 		if (audio_track == nullptr)
 		{
-			stream_type = PacketizerStreamType::VideoOnly;
+			_stream_type = PacketizerStreamType::VideoOnly;
 		}
 
-		_stream_packetizer = CreateStreamPacketizer(segment_count > 0 ? segment_count : DEFAULT_SEGMENT_COUNT,
-													segment_duration > 0 ? segment_duration : DEFAULT_SEGMENT_DURATION,
-													GetName(),  // stream name --> prefix
-													stream_type,
-													std::move(video_track), std::move(audio_track));
+		_segment_count = segment_count > 0 ? segment_count : DEFAULT_SEGMENT_COUNT;
+		_segment_duration = segment_duration > 0 ? segment_duration : DEFAULT_SEGMENT_DURATION;
+		_segment_storage = segment_storage;
+
+		if (_on_demand_idle_timeout_ms == 0)
+		{
+			_stream_packetizer = CreatePacketizer();
+		}
+		else
+		{
+			logtd("The segments of %s/%s are packaged on demand (idle timeout: %lld ms)",
+				  GetApplication()->GetName().CStr(), GetName().CStr(), _on_demand_idle_timeout_ms);
+		}
 	}
 	else
 	{
@@ -92,9 +102,138 @@ bool SegmentStream::Start(int segment_count, int segment_duration, uint32_t work
 		//logtw("For output DASH/HLS, one of H264(video) or AAC(audio) codecs must be encoded.");
 	}
 
+	if ((thumbnail_options != nullptr) && (_video_track != nullptr))
+	{
+		_thumbnail = TranscodeThumbnail::Create(*this, _video_track, *thumbnail_options);
+	}
+
 	return Stream::Start(worker_count);
 }
 
+std::shared_ptr<const TranscodeThumbnail::Options> SegmentStream::GetThumbnailOptions(const cfg::Thumbnail &thumbnail_config)
+{
+	if (thumbnail_config.IsEnabled() == false)
+	{
+		return nullptr;
+	}
+
+	auto options = std::make_shared<TranscodeThumbnail::Options>();
+
+	options->interval_ms = thumbnail_config.GetInterval();
+	options->width = thumbnail_config.GetWidth();
+	options->format = thumbnail_config.GetFormat();
+	options->quality = thumbnail_config.GetQuality();
+
+	return options;
+}
+
+int SegmentStream::GetOnDemandIdleTimeout(const cfg::OnDemand &on_demand_config)
+{
+	return on_demand_config.IsEnabled() ? on_demand_config.GetIdleTimeout() : 0;
+}
+
+void SegmentStream::SetOnDemand(int idle_timeout)
+{
+	_on_demand_idle_timeout_ms = (idle_timeout > 0) ? (static_cast<int64_t>(idle_timeout) * 1000) : 0;
+}
+
+std::shared_ptr<StreamPacketizer> SegmentStream::CreatePacketizer()
+{
+	auto stream_packetizer = CreateStreamPacketizer(_segment_count,
+													_segment_duration,
+													GetName(),  // stream name --> prefix
+													_stream_type,
+													_video_track, _audio_track);
+
+	if ((stream_packetizer != nullptr) && (_segment_storage != nullptr))
+	{
+		stream_packetizer->SetSegmentStorage(_segment_storage);
+	}
+
+	return stream_packetizer;
+}
+
+std::shared_ptr<StreamPacketizer> SegmentStream::GetPacketizerToAppend()
+{
+	auto stream_packetizer = std::atomic_load(&_stream_packetizer);
+
+	if ((_on_demand_idle_timeout_ms == 0) || (_media_tracks.empty()))
+	{
+		return stream_packetizer;
+	}
+
+	auto last_request_ms = _last_request_ms.load();
+	bool is_requested = (last_request_ms != 0) && ((ov::Clock::CoarseNowMs() - last_request_ms) < _on_demand_idle_timeout_ms);
+
+	if (stream_packetizer != nullptr)
+	{
+		if (is_requested == false)
+		{
+			// The HTTP workers that are serving the segments keep the packetizer until they finish
+			std::atomic_store(&_stream_packetizer, std::shared_ptr<StreamPacketizer>());
+
+			logti("The packaging of %s/%s is stopped (no request for %lld ms)",
+				  GetApplication()->GetName().CStr(), GetName().CStr(), _on_demand_idle_timeout_ms);
+
+			return nullptr;
+		}
+
+		return stream_packetizer;
+	}
+
+	if (is_requested == false)
+	{
+		return nullptr;
+	}
+
+	stream_packetizer = CreatePacketizer();
+
+	if (stream_packetizer == nullptr)
+	{
+		return nullptr;
+	}
+
+	// The frames since the last key frame are packaged first, so the first segment doesn't wait for the next key frame
+	auto gop_cache = GetDeliveredGopCache();
+
+	for (const auto &media_packet : gop_cache)
+	{
+		AppendPacket(stream_packetizer, media_packet);
+	}
+
+	std::atomic_store(&_stream_packetizer, stream_packetizer);
+
+	logti("The packaging of %s/%s is started by a request (%zu frames of the GOP cache)",
+		  GetApplication()->GetName().CStr(), GetName().CStr(), gop_cache.size());
+
+	return stream_packetizer;
+}
+
+void SegmentStream::AppendPacket(const std::shared_ptr<StreamPacketizer> &stream_packetizer, const std::shared_ptr<MediaPacket> &media_packet)
+{
+	if (_media_tracks.find(media_packet->GetTrackId()) == _media_tracks.end())
+	{
+		return;
+	}
+
+	if (media_packet->GetMediaType() == MediaType::Video)
+	{
+		stream_packetizer->AppendVideoData(media_packet, _video_track->GetTimeBase().GetTimescale(), 0);
+	}
+	else if (media_packet->GetMediaType() == MediaType::Audio)
+	{
+		stream_packetizer->AppendAudioData(media_packet, _audio_track->GetTimeBase().GetTimescale());
+	}
+}
+
+void SegmentStream::OnRequested() const
+{
+	if (_on_demand_idle_timeout_ms > 0)
+	{
+		_last_request_ms = ov::Clock::CoarseNowMs();
+	}
+}
+
 bool SegmentStream::Stop()
 {
 	return Stream::Stop();
@@ -108,17 +247,29 @@ bool SegmentStream::Stop()
 //====================================================================================================
 void SegmentStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 {
-	if (_stream_packetizer != nullptr && _media_tracks.find(media_packet->GetTrackId()) != _media_tracks.end())
+	// The segments are kept for the playlists, so they are accounted apart from the packets of the other publishers
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Segment, GetMemoryAccount());
+
+	auto stream_packetizer = GetPacketizerToAppend();
+
+	if (stream_packetizer != nullptr)
 	{
-		//        int nul_header_size = 0;
-		//
-		//        if(fragmentation != nullptr && fragmentation->fragmentation_vector_size > 0)
-		//        {
-		//            nul_header_size = fragmentation->fragmentation_offset[fragmentation->fragmentation_vector_size - 1];
-		//            logtd("null header size - %d", nul_header_size);
-		//        }
+		AppendPacket(stream_packetizer, media_packet);
+	}
+
+	if ((_thumbnail != nullptr) && (media_packet->GetTrackId() == static_cast<int32_t>(_video_track->GetId())))
+	{
+		auto image = _thumbnail->Process(media_packet);
+
+		if (image != nullptr)
+		{
+			_thumbnail_version++;
 
-		_stream_packetizer->AppendVideoData(media_packet, _video_track->GetTimeBase().GetTimescale(), 0);
+			auto thumbnail_data = Packetizer::MakePlayListData("", ov::String::FormatString("\"%08x-%llu\"", _thumbnail_id, _thumbnail_version));
+			thumbnail_data->head = std::move(image);
+
+			std::atomic_store(&_thumbnail_data, std::shared_ptr<const PlayListData>(std::move(thumbnail_data)));
+		}
 	}
 }
 
@@ -128,9 +279,13 @@ void SegmentStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_pac
 //====================================================================================================
 void SegmentStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
 {
-	if (_stream_packetizer != nullptr && _media_tracks.find(media_packet->GetTrackId()) != _media_tracks.end())
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Segment, GetMemoryAccount());
+
+	auto stream_packetizer = GetPacketizerToAppend();
+
+	if (stream_packetizer != nullptr)
 	{
-		_stream_packetizer->AppendAudioData(media_packet, _audio_track->GetTimeBase().GetTimescale());
+		AppendPacket(stream_packetizer, media_packet);
 	}
 }
 
@@ -138,26 +293,70 @@ void SegmentStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_pac
 // GetPlayList
 // - M3U8/MPD
 //====================================================================================================
-bool SegmentStream::GetPlayList(ov::String &play_list)
+bool SegmentStream::GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list)
 {
-	if (_stream_packetizer != nullptr)
+	// In the on-demand mode, the first request starts the packaging, and is answered as not ready (202 Accepted)
+	OnRequested();
+
+	auto stream_packetizer = std::atomic_load(&_stream_packetizer);
+
+	if (stream_packetizer != nullptr)
 	{
-		return _stream_packetizer->GetPlayList(play_list);
+		return stream_packetizer->GetPlayList(file_name, play_list);
 	}
 
 	return false;
 }
 
+std::shared_ptr<const ov::Data> SegmentStream::GetKey(const ov::String &file_name) const
+{
+	OnRequested();
+
+	auto stream_packetizer = std::atomic_load(&_stream_packetizer);
+
+	return (stream_packetizer != nullptr) ? stream_packetizer->GetKey(file_name) : nullptr;
+}
+
+bool SegmentStream::IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track)
+{
+	return ((_video_track != nullptr) && (_video_track->GetId() == track->GetId())) ||
+		   ((_audio_track != nullptr) && (_audio_track->GetId() == track->GetId()));
+}
+
+std::shared_ptr<const RenditionData> SegmentStream::GetRendition() const
+{
+	// Requested for the master playlist of the stream group
+	OnRequested();
+
+	auto stream_packetizer = std::atomic_load(&_stream_packetizer);
+
+	return (stream_packetizer != nullptr) ? stream_packetizer->GetRendition() : nullptr;
+}
+
+std::shared_ptr<const PlayListData> SegmentStream::GetThumbnail(const ov::String &file_name) const
+{
+	if ((_thumbnail == nullptr) || (file_name != ov::String::FormatString("%s.%s", SEGMENT_THUMBNAIL_FILE_NAME, _thumbnail->GetFileExtension())))
+	{
+		return nullptr;
+	}
+
+	return std::atomic_load(&_thumbnail_data);
+}
+
 //====================================================================================================
 // GetSegmentData
 // - TS/M4S(mp4)
 //====================================================================================================
 std::shared_ptr<SegmentData> SegmentStream::GetSegmentData(const ov::String &file_name)
 {
-	if (_stream_packetizer == nullptr)
+	OnRequested();
+
+	auto stream_packetizer = std::atomic_load(&_stream_packetizer);
+
+	if (stream_packetizer == nullptr)
 	{
 		return nullptr;
 	}
 
-	return _stream_packetizer->GetSegmentData(file_name);
+	return stream_packetizer->GetSegmentData(file_name);
 }
\ No newline at end of file
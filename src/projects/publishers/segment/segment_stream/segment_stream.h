@@ -12,7 +12,13 @@
 #include "base/common_types.h"
 #include "base/publisher/stream.h"
 #include "stream_packetizer.h"
+#include <config/config.h>
+#include <atomic>
 #include <map>
+#include <transcode/transcode_thumbnail.h>
+
+// <app>/<stream>/thumb.<jpg|webp> (See <Thumbnail> of the segment publishers)
+#define SEGMENT_THUMBNAIL_FILE_NAME "thumb"
 
 //====================================================================================================
 // SegmentStream
@@ -28,11 +34,44 @@ public :
     void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
     void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
 
-    bool Start(int segment_count, int segment_duration, uint32_t worker_count);
+    // segment_storage: the storage to keep the closed segments (nullptr: memory)
+    // thumbnail_options: the thumbnails are made from the key frames of the video track (nullptr: disabled)
+    bool Start(int segment_count, int segment_duration, uint32_t worker_count, const std::shared_ptr<SegmentStorage> &segment_storage = nullptr,
+               const std::shared_ptr<const TranscodeThumbnail::Options> &thumbnail_options = nullptr);
+
+    // Returns nullptr if the thumbnail is disabled
+    static std::shared_ptr<const TranscodeThumbnail::Options> GetThumbnailOptions(const cfg::Thumbnail &thumbnail_config);
+    // Returns 0 if the on-demand packaging is disabled
+    static int GetOnDemandIdleTimeout(const cfg::OnDemand &on_demand_config);
+
+    // On-demand packaging (idle_timeout > 0): the packetizer is created by the first request of the playlist,
+    // and released if there is no request of the playlists/segments for idle_timeout seconds.
+    // Must be called before Start()
+    void SetOnDemand(int idle_timeout);
+
     bool Stop() override;
 
-    bool GetPlayList(ov::String &play_list);
+    bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list);
 	std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name);
+	// The latest thumbnail (revalidated with ETag like the playlists), nullptr if it is disabled or not made yet
+	std::shared_ptr<const PlayListData> GetThumbnail(const ov::String &file_name) const;
+	// The key of the encrypted segments, nullptr if the segments are not encrypted or the key is rotated out
+	std::shared_ptr<const ov::Data> GetKey(const ov::String &file_name) const;
+
+	// For the master playlist of the stream group
+	std::shared_ptr<const RenditionData> GetRendition() const;
+	// Only the packetized tracks are delivered
+	bool IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track) override;
+
+	// The tracks that are packetized (nullptr if there is no H264/AAC track)
+	const std::shared_ptr<MediaTrack> &GetVideoTrack() const
+	{
+		return _video_track;
+	}
+	const std::shared_ptr<MediaTrack> &GetAudioTrack() const
+	{
+		return _audio_track;
+	}
     virtual std::shared_ptr<StreamPacketizer> CreateStreamPacketizer(int segment_count,
                                                                     int segment_duration,
                                                                     const  ov::String &segment_prefix,
@@ -40,9 +79,35 @@ public :
                                                                     std::shared_ptr<MediaTrack> video_track, std::shared_ptr<MediaTrack> audio_track) = 0;
 
 private :
+    std::shared_ptr<StreamPacketizer> CreatePacketizer();
+    // The packetizer that the frames are appended to, it is created or released here in the on-demand mode
+    // (called by the thread that sends the frames)
+    std::shared_ptr<StreamPacketizer> GetPacketizerToAppend();
+    void AppendPacket(const std::shared_ptr<StreamPacketizer> &stream_packetizer, const std::shared_ptr<MediaPacket> &media_packet);
+    // Keeps the packetizer of the on-demand mode
+    void OnRequested() const;
+
+    // Replaced by the thread that sends the frames in the on-demand mode, read by the HTTP workers with std::atomic_load()
     std::shared_ptr<StreamPacketizer> _stream_packetizer = nullptr;
     std::map<uint32_t, std::shared_ptr<MediaTrack>> _media_tracks;
 
     std::shared_ptr<MediaTrack> _video_track;
     std::shared_ptr<MediaTrack> _audio_track;
+
+    // To create the packetizer
+    int _segment_count = 0;
+    int _segment_duration = 0;
+    PacketizerStreamType _stream_type = PacketizerStreamType::Common;
+    std::shared_ptr<SegmentStorage> _segment_storage;
+
+    // 0: the packetizer is created by Start() and kept until the stream is deleted
+    int64_t _on_demand_idle_timeout_ms = 0;
+    // The last request of the playlists/segments (0: not requested yet)
+    mutable std::atomic<int64_t> _last_request_ms{0};
+
+    std::shared_ptr<TranscodeThumbnail> _thumbnail;
+    // Updated by the thread that sends the video frames, read by the HTTP workers
+    std::shared_ptr<const PlayListData> _thumbnail_data;
+    uint32_t _thumbnail_id = ov::Random::GenerateUInt32();
+    uint64_t _thumbnail_version = 0;
 };
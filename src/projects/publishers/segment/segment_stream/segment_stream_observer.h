@@ -23,11 +23,25 @@ public:
 	virtual bool OnPlayListRequest(const std::shared_ptr<HttpClient> &client,
 								   const ov::String &app_name, const ov::String &stream_name,
 								   const ov::String &file_name,
-								   ov::String &play_list) = 0;
+								   std::shared_ptr<const PlayListData> &play_list) = 0;
 
 	// Called when the client requests a segment (such as .ts, .m4s)
 	virtual bool OnSegmentRequest(const std::shared_ptr<HttpClient> &client,
 								  const ov::String &app_name, const ov::String &stream_name,
 								  const ov::String &file_name,
 								  std::shared_ptr<SegmentData> &segment) = 0;
+
+	// Called when the client requests the thumbnail of a stream (thumb.jpg, thumb.webp)
+	virtual bool OnThumbnailRequest(const std::shared_ptr<HttpClient> &client,
+									const ov::String &app_name, const ov::String &stream_name,
+									const ov::String &file_name,
+									std::shared_ptr<info::Stream> &stream_info,
+									std::shared_ptr<const PlayListData> &thumbnail) = 0;
+
+	// Called when the client requests the key of the encrypted segments (such as .key)
+	virtual bool OnKeyRequest(const std::shared_ptr<HttpClient> &client,
+							  const ov::String &app_name, const ov::String &stream_name,
+							  const ov::String &file_name,
+							  std::shared_ptr<info::Stream> &stream_info,
+							  std::shared_ptr<const ov::Data> &key) = 0;
 };
@@ -9,17 +9,21 @@
 #include "segment_stream_server.h"
 #include <regex>
 #include <sstream>
+#include "segment_stream.h"
 #include "segment_stream_private.h"
 
+#include <monitoring/monitoring.h>
+
 SegmentStreamServer::SegmentStreamServer()
 {
-	_cross_domain_xml =
+	_cross_domain_xml = ov::String(
 		"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
 		"<!DOCTYPE cross-domain-policy SYSTEM \"http://www.adobe.com/xml/dtds/cross-domain-policy.dtd\">\n"
 		"<cross-domain-policy>\n"
 		"\t<allow-access-from domain=\"*\" secure=\"false\"/>\n"
 		"\t<site-control permitted-cross-domain-policies=\"all\"/>\n"
-		"</cross-domain-policy>";
+		"</cross-domain-policy>")
+							.ToData(false);
 }
 
 template <typename Thttp_server>
@@ -62,7 +66,10 @@ static std::shared_ptr<Thttp_server> CreateHttpServerIfNeeded(std::map<int, std:
 bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 								const ov::SocketAddress *tls_address,
 								std::map<int, std::shared_ptr<HttpServer>> &http_server_manager,
-								int thread_count)
+								int thread_count,
+								int reactor_count,
+								int worker_count,
+								bool worker_affinity)
 {
 	if ((_http_server != nullptr) || (_https_server != nullptr))
 	{
@@ -77,6 +84,8 @@ bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 	auto segment_stream_interceptor = CreateInterceptor();
 	segment_stream_interceptor->SetCrossdomainBlock();
 
+	auto web_socket_interceptor = CreateWebSocketInterceptor();
+
 	bool need_to_start_http_server = false;
 	bool need_to_start_https_server = false;
 
@@ -87,6 +96,11 @@ bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 
 		if (_http_server != nullptr)
 		{
+			if (web_socket_interceptor != nullptr)
+			{
+				_http_server->AddInterceptor(web_socket_interceptor);
+			}
+
 			_http_server->AddInterceptor(segment_stream_interceptor);
 		}
 		else
@@ -104,6 +118,12 @@ bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 		{
 			auto vhost_list = Orchestrator::GetInstance()->GetVirtualHostList();
 			_https_server->SetVirtualHostList(vhost_list);
+
+			if (web_socket_interceptor != nullptr)
+			{
+				_https_server->AddInterceptor(web_socket_interceptor);
+			}
+
 			_https_server->AddInterceptor(segment_stream_interceptor);
 		}
 		else
@@ -116,12 +136,23 @@ bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 		// TLS is disabled
 	}
 
-	result = result && ((need_to_start_http_server == false) || (_http_server == nullptr) || _http_server->Start(*address));
-	result = result && ((need_to_start_https_server == false) || (_https_server == nullptr) || _https_server->Start(*tls_address));
+	result = result && ((need_to_start_http_server == false) || (_http_server == nullptr) || _http_server->Start(*address, reactor_count, worker_count, worker_affinity));
+	result = result && ((need_to_start_https_server == false) || (_https_server == nullptr) || _https_server->Start(*tls_address, reactor_count, worker_count, worker_affinity));
 
 	if (result)
 	{
 		segment_stream_interceptor->Start(thread_count, process_handler);
+
+		if (_keep_alive_timeout_ms > 0)
+		{
+			_keep_alive_timer.Push(
+				[this](void *parameter) -> ov::DelayQueueAction {
+					CloseIdleConnections();
+					return ov::DelayQueueAction::Repeat;
+				},
+				std::min(_keep_alive_timeout_ms, 1000));
+			_keep_alive_timer.Start();
+		}
 	}
 	else
 	{
@@ -145,7 +176,14 @@ bool SegmentStreamServer::Start(const ov::SocketAddress *address,
 bool SegmentStreamServer::Stop()
 {
 	// Remove Interceptor
-	
+
+	_keep_alive_timer.Stop();
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_keep_alive_mutex);
+		_keep_alive_clients.clear();
+	}
+
 	// Stop server
 	if (_http_server != nullptr)
 	{
@@ -280,6 +318,22 @@ bool SegmentStreamServer::ProcessRequest(const std::shared_ptr<HttpClient> &clie
 	auto request = client->GetRequest();
 	HttpConnection connetion = HttpConnection::Closed;
 
+	// The response of the previous request might be remained when the connection is reused
+	response->InitResponseInfo();
+
+	bool keep_alive = BeginKeepAliveRequest(client);
+
+	if (keep_alive)
+	{
+		response->SetKeepAlive();
+		response->SetHeader("Keep-Alive", ov::String::FormatString("timeout=%d", _keep_alive_timeout_ms / 1000));
+	}
+	else if (_keep_alive_timeout_ms > 0)
+	{
+		// The client didn't want to keep the connection, or reached the maximum number of requests
+		response->SetHeader("Connection", "close");
+	}
+
 	do
 	{
 		ov::String app_name;
@@ -295,7 +349,10 @@ bool SegmentStreamServer::ProcessRequest(const std::shared_ptr<HttpClient> &clie
 		if (request_target.IndexOf("crossdomain.xml") >= 0)
 		{
 			response->SetHeader("Content-Type", "text/x-cross-domain-policy");
-			response->AppendString(_cross_domain_xml);
+			// Rendered once, shared by all responses
+			response->AppendData(_cross_domain_xml);
+
+			response->Response();
 			break;
 		}
 
@@ -304,6 +361,7 @@ bool SegmentStreamServer::ProcessRequest(const std::shared_ptr<HttpClient> &clie
 		{
 			logtd("Failed to parse URL: %s", request_target.CStr());
 			response->SetStatusCode(HttpStatusCode::NotFound);
+			response->Response();
 			break;
 		}
 
@@ -316,15 +374,33 @@ bool SegmentStreamServer::ProcessRequest(const std::shared_ptr<HttpClient> &clie
 		auto host_name = request->GetHeader("HOST").Split(":")[0];
 		ov::String internal_app_name = Orchestrator::GetInstance()->ResolveApplicationNameFromDomain(host_name, app_name);
 
+		if (file_name.HasPrefix(SEGMENT_THUMBNAIL_FILE_NAME "."))
+		{
+			connetion = ProcessThumbnailRequest(client, internal_app_name, stream_name, file_name, file_ext);
+			break;
+		}
+
 		connetion = ProcessStreamRequest(client, internal_app_name, stream_name, file_name, file_ext);
 	} while (false);
 
+	if (keep_alive)
+	{
+		EndKeepAliveRequest(client, connetion == HttpConnection::Closed);
+	}
+
 	switch (connetion)
 	{
 		case HttpConnection::Closed:
+			if (keep_alive)
+			{
+				// The response is completed, wait for the next request
+				return true;
+			}
+
 			return response->Close();
 
 		case HttpConnection::KeepAlive:
+			// The response is not completed yet (e.g. CMAF chunked transfer), the sender calls CompleteDeferredResponse()
 			return true;
 
 		default:
@@ -336,26 +412,25 @@ bool SegmentStreamServer::ProcessRequest(const std::shared_ptr<HttpClient> &clie
 
 bool SegmentStreamServer::SetAllowOrigin(const ov::String &origin_url, const std::shared_ptr<HttpResponse> &response)
 {
-	if (_cors_urls.empty())
+	if (_cors_origins.empty() && _cors_wildcard_origins.empty())
 	{
 		// Not need to check CORS
 		response->SetHeader("Access-Control-Allow-Origin", "*");
 		return true;
 	}
 
-	auto item = std::find_if(_cors_urls.begin(), _cors_urls.end(),
-							 [&origin_url](auto &url) -> bool {
-								 if (url.HasPrefix("http://*."))
-									 return origin_url.HasSuffix(url.Substring(strlen("http://*")));
-								 else if (url.HasPrefix("https://*."))
-									 return origin_url.HasSuffix(url.Substring(strlen("https://*")));
-
-								 return (origin_url == url);
-							 });
-
-	if (item == _cors_urls.end())
+	if (_cors_origins.find(origin_url) == _cors_origins.end())
 	{
-		return false;
+		// http://*.ovenplayer.com matches http://demo.ovenplayer.com
+		auto item = std::find_if(_cors_wildcard_origins.begin(), _cors_wildcard_origins.end(),
+								 [&origin_url](const CorsWildcardOrigin &wildcard) -> bool {
+									 return origin_url.HasPrefix(wildcard.scheme) && origin_url.HasSuffix(wildcard.suffix);
+								 });
+
+		if (item == _cors_wildcard_origins.end())
+		{
+			return false;
+		}
 	}
 
 	// response->SetHeader("Access-Control-Allow-Credentials", "true");
@@ -365,6 +440,235 @@ bool SegmentStreamServer::SetAllowOrigin(const ov::String &origin_url, const std
 	return true;
 }
 
+void SegmentStreamServer::SetKeepAlive(int keep_alive_timeout, int max_keep_alive_requests)
+{
+	_keep_alive_timeout_ms = std::max(keep_alive_timeout, 0) * 1000;
+	_max_keep_alive_requests = std::max(max_keep_alive_requests, 0);
+}
+
+bool SegmentStreamServer::SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options)
+{
+	bool result = true;
+
+	if (_http_server != nullptr)
+	{
+		result = _http_server->SetLowLatencyOptions(options) && result;
+	}
+
+	if (_https_server != nullptr)
+	{
+		result = _https_server->SetLowLatencyOptions(options) && result;
+	}
+
+	return result;
+}
+
+bool SegmentStreamServer::BeginKeepAliveRequest(const std::shared_ptr<HttpClient> &client)
+{
+	if ((_keep_alive_timeout_ms <= 0) || (client->GetRequest()->IsKeepAliveRequest() == false))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock_guard(_keep_alive_mutex);
+
+	auto &info = _keep_alive_clients[client.get()];
+
+	if (info.client.lock() != client)
+	{
+		// A new connection (or the address of a closed client is reused)
+		info = KeepAliveInfo();
+		info.client = client;
+	}
+
+	info.request_count++;
+
+	if ((_max_keep_alive_requests > 0) && (info.request_count >= static_cast<uint32_t>(_max_keep_alive_requests)))
+	{
+		// This is the last request of the connection
+		_keep_alive_clients.erase(client.get());
+		return false;
+	}
+
+	info.processing_count++;
+
+	return true;
+}
+
+void SegmentStreamServer::EndKeepAliveRequest(const std::shared_ptr<HttpClient> &client, bool is_response_completed)
+{
+	std::lock_guard<std::mutex> lock_guard(_keep_alive_mutex);
+
+	auto item = _keep_alive_clients.find(client.get());
+
+	if (item != _keep_alive_clients.end())
+	{
+		if (is_response_completed == false)
+		{
+			// Still processing until the sender of the response calls CompleteDeferredResponse()
+			return;
+		}
+
+		auto &info = item->second;
+
+		if (info.processing_count > 0)
+		{
+			info.processing_count--;
+		}
+
+		info.last_response_time = Packetizer::GetCurrentTick();
+	}
+}
+
+void SegmentStreamServer::CompleteDeferredResponse(const std::shared_ptr<HttpClient> &client)
+{
+	{
+		std::lock_guard<std::mutex> lock_guard(_keep_alive_mutex);
+
+		auto item = _keep_alive_clients.find(client.get());
+
+		if ((item != _keep_alive_clients.end()) && (item->second.client.lock() == client))
+		{
+			auto &info = item->second;
+
+			if (info.processing_count > 0)
+			{
+				info.processing_count--;
+			}
+
+			info.last_response_time = Packetizer::GetCurrentTick();
+
+			return;
+		}
+	}
+
+	client->GetResponse()->Close();
+}
+
+void SegmentStreamServer::CloseIdleConnections()
+{
+	std::vector<std::shared_ptr<HttpClient>> idle_clients;
+	auto now = Packetizer::GetCurrentTick();
+
+	{
+		std::lock_guard<std::mutex> lock_guard(_keep_alive_mutex);
+
+		for (auto item = _keep_alive_clients.begin(); item != _keep_alive_clients.end();)
+		{
+			auto &info = item->second;
+			auto client = info.client.lock();
+
+			if (client == nullptr)
+			{
+				// Already disconnected
+				item = _keep_alive_clients.erase(item);
+				continue;
+			}
+
+			if ((info.processing_count == 0) && ((now - info.last_response_time) >= _keep_alive_timeout_ms))
+			{
+				idle_clients.push_back(client);
+				item = _keep_alive_clients.erase(item);
+				continue;
+			}
+
+			++item;
+		}
+	}
+
+	for (auto &client : idle_clients)
+	{
+		logtd("Closing the idle connection: %s", client->GetResponse()->GetRemote()->ToString().CStr());
+		client->GetResponse()->Close();
+	}
+}
+
+HttpConnection SegmentStreamServer::ProcessThumbnailRequest(const std::shared_ptr<HttpClient> &client,
+															const ov::String &app_name, const ov::String &stream_name,
+															const ov::String &file_name, const ov::String &file_ext)
+{
+	auto response = client->GetResponse();
+
+	std::shared_ptr<const PlayListData> thumbnail;
+	std::shared_ptr<info::Stream> stream_info;
+
+	auto item = std::find_if(_observers.begin(), _observers.end(),
+							 [&client, &app_name, &stream_name, &file_name, &stream_info, &thumbnail](auto &observer) -> bool {
+								 return observer->OnThumbnailRequest(client, app_name, stream_name, file_name, stream_info, thumbnail);
+							 });
+
+	if (item == _observers.end())
+	{
+		logtd("Could not find a %s thumbnail for [%s/%s], %s", GetPublisherName(), app_name.CStr(), stream_name.CStr(), file_name.CStr());
+		response->SetStatusCode(HttpStatusCode::NotFound);
+		response->Response();
+
+		return HttpConnection::Closed;
+	}
+
+	if ((response->GetStatusCode() != HttpStatusCode::OK) || (thumbnail == nullptr))
+	{
+		response->Response();
+		return HttpConnection::Closed;
+	}
+
+	// The thumbnail is replaced once per interval, so the pollers revalidate it with If-None-Match like the playlists
+	auto sent_bytes = ResponsePlayList(client, thumbnail, (file_ext == "webp") ? "image/webp" : "image/jpeg");
+
+	if (stream_info != nullptr)
+	{
+		auto stream_metric = StreamMetrics(*stream_info);
+		if (stream_metric != nullptr)
+		{
+			stream_metric->IncreaseBytesOut(GetPublisherType(), sent_bytes);
+		}
+	}
+
+	return HttpConnection::Closed;
+}
+
+uint32_t SegmentStreamServer::ResponsePlayList(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const PlayListData> &play_list, const char *content_type)
+{
+	auto request = client->GetRequest();
+	auto response = client->GetResponse();
+
+	response->SetHeader("Content-Type", content_type);
+	response->SetHeader("Pragma", "no-cache");
+	response->SetHeader("Expires", "0");
+
+	if (play_list->IsStatic() == false)
+	{
+		// The current time is inserted, so it cannot be cached
+		response->SetHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+
+		response->AppendData(play_list->head);
+		response->AppendString(Packetizer::MakeUtcMillisecond());
+		response->AppendData(play_list->tail);
+
+		return response->Response();
+	}
+
+	// The clients must revalidate the playlist for each request, but they can reuse it if it is not changed
+	response->SetHeader("Cache-Control", "no-cache");
+	response->SetHeader("ETag", play_list->etag);
+	response->SetHeader("Last-Modified", play_list->last_modified);
+
+	// Last-Modified has the resolution of 1 second, and the playlist can be updated twice in a second,
+	// so only If-None-Match is used to revalidate
+	auto if_none_match = request->GetHeader("If-None-Match");
+
+	if ((if_none_match.IsEmpty() == false) && ((if_none_match == "*") || (if_none_match.IndexOf(play_list->etag.CStr()) >= 0)))
+	{
+		response->SetStatusCode(HttpStatusCode::NotModified);
+
+		return response->Response();
+	}
+
+	response->AppendData(play_list->head);
+
+	return response->Response();
+}
+
 //====================================================================================================
 // SetCrossDomain Parsing/Setting
 //  crossdoamin : only domain
@@ -387,6 +691,11 @@ void SegmentStreamServer::SetCrossDomain(const std::vector<cfg::Url> &url_list)
 		return;
 	}
 
+	std::vector<ov::String> cors_urls;
+
+	_cors_origins.clear();
+	_cors_wildcard_origins.clear();
+
 	for (auto &url_item : url_list)
 	{
 		ov::String url = url_item.GetUrl();
@@ -394,69 +703,68 @@ void SegmentStreamServer::SetCrossDomain(const std::vector<cfg::Url> &url_list)
 		// all access allow
 		if (url == "*")
 		{
-			crossdmain_urls.clear();
-			_cors_urls.clear();
 			return;
 		}
 
 		// http
 		if (url.HasPrefix(http_prefix))
 		{
-			if (!UrlExistCheck(crossdmain_urls, url.Substring(http_prefix.GetLength())))
-				crossdmain_urls.push_back(url.Substring(http_prefix.GetLength()));
-
-			if (!UrlExistCheck(_cors_urls, url))
-				_cors_urls.push_back(url);
+			crossdmain_urls.push_back(url.Substring(http_prefix.GetLength()));
+			cors_urls.push_back(url);
 		}
 		// https
 		else if (url.HasPrefix(https_prefix))
 		{
-			if (!UrlExistCheck(crossdmain_urls, url.Substring(https_prefix.GetLength())))
-				crossdmain_urls.push_back(url.Substring(https_prefix.GetLength()));
-
-			if (!UrlExistCheck(_cors_urls, url))
-				_cors_urls.push_back(url);
+			crossdmain_urls.push_back(url.Substring(https_prefix.GetLength()));
+			cors_urls.push_back(url);
 		}
 		// only domain
 		else
 		{
-			if (!UrlExistCheck(crossdmain_urls, url))
-				crossdmain_urls.push_back(url);
+			crossdmain_urls.push_back(url);
+			cors_urls.push_back(http_prefix + url);
+			cors_urls.push_back(https_prefix + url);
+		}
+	}
 
-			if (!UrlExistCheck(_cors_urls, http_prefix + url))
-				_cors_urls.push_back(http_prefix + url);
+	// Compiled once here, so the origin of each request is checked with a lookup
+	for (auto &url : cors_urls)
+	{
+		auto scheme = url.HasPrefix(https_prefix) ? https_prefix : http_prefix;
+
+		if (url.HasPrefix(scheme + "*."))
+		{
+			// "http://*.ovenplayer.com" => "http://" + ".ovenplayer.com"
+			CorsWildcardOrigin wildcard;
+			wildcard.scheme = scheme;
+			wildcard.suffix = url.Substring(scheme.GetLength() + 1);
 
-			if (!UrlExistCheck(_cors_urls, https_prefix + url))
-				_cors_urls.push_back(https_prefix + url);
+			_cors_wildcard_origins.push_back(wildcard);
+		}
+		else
+		{
+			_cors_origins.insert(url);
 		}
 	}
 
 	// crossdomain.xml
 	std::ostringstream cross_domain_xml;
+	std::unordered_set<ov::String> written_domains;
 
 	cross_domain_xml << "<?xml version=\"1.0\"?>\r\n";
 	cross_domain_xml << "<cross-domain-policy>\r\n";
 	for (auto &url : crossdmain_urls)
 	{
-		cross_domain_xml << "    <allow-access-from domain=\"" << url.CStr() << "\"/>\r\n";
+		if (written_domains.insert(url).second)
+		{
+			cross_domain_xml << "    <allow-access-from domain=\"" << url.CStr() << "\"/>\r\n";
+		}
 	}
 	cross_domain_xml << "</cross-domain-policy>";
 
-	_cross_domain_xml = cross_domain_xml.str().c_str();
-	ov::String cors_urls;
-	for (auto &url : _cors_urls)
-		cors_urls += url + "\n";
-	logtd("CORS \n%s", cors_urls.CStr());
-
-	logtd("crossdomain.xml \n%s", _cross_domain_xml.CStr());
-}
-
-bool SegmentStreamServer::UrlExistCheck(const std::vector<ov::String> &url_list, const ov::String &check_url)
-{
-	auto item = std::find_if(url_list.begin(), url_list.end(),
-							 [&check_url](auto &url) -> bool {
-								 return check_url == url;
-							 });
+	auto xml = cross_domain_xml.str();
+	_cross_domain_xml = std::make_shared<ov::Data>(xml.c_str(), xml.length());
 
-	return (item != url_list.end());
+	logtd("CORS: %zu origins, %zu wildcards", _cors_origins.size(), _cors_wildcard_origins.size());
+	logtd("crossdomain.xml \n%s", xml.c_str());
 }
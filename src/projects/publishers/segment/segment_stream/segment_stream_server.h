@@ -9,6 +9,8 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "segment_stream_interceptor.h"
 #include "segment_stream_observer.h"
@@ -29,7 +31,10 @@ public:
 		const ov::SocketAddress *address,
 		const ov::SocketAddress *tls_address,
 		std::map<int, std::shared_ptr<HttpServer>> &http_server_manager,
-		int thread_count);
+		int thread_count,
+		int reactor_count = 1,
+		int worker_count = PHYSICAL_PORT_DEFAULT_WORKER_COUNT,
+		bool worker_affinity = false);
 	bool Stop();
 	
 	bool AddObserver(const std::shared_ptr<SegmentStreamObserver> &observer);
@@ -39,6 +44,14 @@ public:
 
 	void SetCrossDomain(const std::vector<cfg::Url> &url_list);
 
+	// keep_alive_timeout: in seconds (0 disables keep-alive), max_keep_alive_requests: 0 means unlimited
+	// Must be called before Start()
+	void SetKeepAlive(int keep_alive_timeout, int max_keep_alive_requests);
+
+	// Bounds the time the responses wait in the send queues (See ov::TcpLowLatencyOptions)
+	// Must be called after Start() (the options are shared by the publishers that use the same port)
+	bool SetLowLatencyOptions(const ov::TcpLowLatencyOptions &options);
+
 	bool GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections);
 
 	virtual PublisherType GetPublisherType() const noexcept = 0;
@@ -47,6 +60,11 @@ public:
 	{
 		return std::make_shared<SegmentStreamInterceptor>();
 	}
+	// The interceptor of the WebSocket requests, which is registered before the segment interceptor (nullptr if not supported)
+	virtual std::shared_ptr<WebSocketInterceptor> CreateWebSocketInterceptor()
+	{
+		return nullptr;
+	}
 
 protected:
 	bool ParseRequestUrl(const ov::String &request_url,
@@ -74,12 +92,57 @@ protected:
 												 const ov::String &file_name,
 												 SegmentType segment_type) = 0;
 
-	bool UrlExistCheck(const std::vector<ov::String> &url_list, const ov::String &check_url);
+	// <app>/<stream>/thumb.<jpg|webp> is served by all segment publishers
+	HttpConnection ProcessThumbnailRequest(const std::shared_ptr<HttpClient> &client,
+										   const ov::String &app_name, const ov::String &stream_name,
+										   const ov::String &file_name, const ov::String &file_ext);
+
+	// Returns whether the connection can be reused after the response, and counts the request
+	bool BeginKeepAliveRequest(const std::shared_ptr<HttpClient> &client);
+	// If the response is not completed (HttpConnection::KeepAlive), CompleteDeferredResponse() must be called after it is sent
+	void EndKeepAliveRequest(const std::shared_ptr<HttpClient> &client, bool is_response_completed);
+	// Waits for the next request if the connection can be reused, otherwise closes it
+	void CompleteDeferredResponse(const std::shared_ptr<HttpClient> &client);
+	// Closes the connections that have been idle for the keep-alive timeout
+	void CloseIdleConnections();
+
+	// Responds with the shared playlist data, or 304 Not Modified if the client already has the same version (If-None-Match)
+	// Returns the number of bytes sent
+	uint32_t ResponsePlayList(const std::shared_ptr<HttpClient> &client, const std::shared_ptr<const PlayListData> &play_list, const char *content_type);
 
 protected:
+	// <Url>http://*.ovenplayer.com</Url>
+	struct CorsWildcardOrigin
+	{
+		// "http://"
+		ov::String scheme;
+		// ".ovenplayer.com"
+		ov::String suffix;
+	};
+
+	struct KeepAliveInfo
+	{
+		std::weak_ptr<HttpClient> client;
+
+		uint32_t request_count = 0;
+		// The number of requests being processed (a request might be processed by another worker before the previous one is finished)
+		uint32_t processing_count = 0;
+		int64_t last_response_time = 0;
+	};
+
 	std::shared_ptr<HttpServer> _http_server;
 	std::shared_ptr<HttpsServer> _https_server;
 	std::vector<std::shared_ptr<SegmentStreamObserver>> _observers;
-	std::vector<ov::String> _cors_urls;
-	ov::String _cross_domain_xml;
+	// The allowed origins of CORS, such as "https://demo.ovenplayer.com" (both are empty if all origins are allowed)
+	std::unordered_set<ov::String> _cors_origins;
+	std::vector<CorsWildcardOrigin> _cors_wildcard_origins;
+	// The body of crossdomain.xml (allows all domains if <CrossDomain> is not set)
+	std::shared_ptr<const ov::Data> _cross_domain_xml;
+
+	int _keep_alive_timeout_ms = 0;
+	int _max_keep_alive_requests = 0;
+
+	std::mutex _keep_alive_mutex;
+	std::unordered_map<const HttpClient *, KeepAliveInfo> _keep_alive_clients;
+	ov::DelayQueue _keep_alive_timer;
 };
@@ -1,10 +1,15 @@
 #include "segment_worker_manager.h"
 #include "segment_stream_private.h"
 
+// Interval of the queue wait time statistics
+#define SEGMENT_WORKER_STATISTICS_INTERVAL 5000
+
 //====================================================================================================
 // SegmentWorker constructorc
 //====================================================================================================
-SegmentWorker::SegmentWorker()
+SegmentWorker::SegmentWorker(SegmentWorkerManager *manager, size_t index)
+	: _manager(manager),
+	  _index(index)
 {
 	_stop_thread_flag = true;
 }
@@ -15,6 +20,7 @@ SegmentWorker::SegmentWorker()
 SegmentWorker::~SegmentWorker()
 {
 	Stop();
+	Join();
 }
 
 //====================================================================================================
@@ -37,6 +43,7 @@ bool SegmentWorker::Start(const SegmentProcessHandler &process_handler)
 
 //====================================================================================================
 // SegmentWorker stop
+// - The manager wakes up the workers after calling Stop() of all workers
 //====================================================================================================
 bool SegmentWorker::Stop()
 {
@@ -46,43 +53,61 @@ bool SegmentWorker::Stop()
 	}
 
 	_stop_thread_flag = true;
-	// Generate Event
-	_queue_event.Notify();
-	if(_worker_thread.joinable())
+
+	return true;
+}
+
+//====================================================================================================
+// SegmentWorker join
+//====================================================================================================
+void SegmentWorker::Join()
+{
+	if (_worker_thread.joinable())
 	{
 		_worker_thread.join();
 	}
+}
 
-	return true;
+//====================================================================================================
+// push lane
+//====================================================================================================
+void SegmentWorker::PushLane(const std::shared_ptr<SegmentWorkLane> &lane)
+{
+	std::unique_lock<std::mutex> lock(_lane_guard);
+	_lanes.push_back(lane);
 }
 
 //====================================================================================================
-// add work info
+// pop lane (owner)
 //====================================================================================================
-bool SegmentWorker::AddWorkInfo(std::shared_ptr<SegmentWorkInfo> work_info)
+std::shared_ptr<SegmentWorkLane> SegmentWorker::PopLane()
 {
-	std::unique_lock<std::mutex> lock(_work_info_guard);
-	_work_infos.push(work_info);
+	std::unique_lock<std::mutex> lock(_lane_guard);
+
+	if (_lanes.empty())
+		return nullptr;
 
-	_queue_event.Notify();
+	auto lane = _lanes.front();
+	_lanes.pop_front();
 
-	return true;
+	return lane;
 }
 
 //====================================================================================================
-// pop work info
+// steal lane (other workers)
+// - The newest lane is stolen, so the owner keeps processing the lanes in the order they are queued
 //====================================================================================================
-std::shared_ptr<SegmentWorkInfo> SegmentWorker::PopWorkInfo()
+std::shared_ptr<SegmentWorkLane> SegmentWorker::StealLane()
 {
-	std::unique_lock<std::mutex> lock(_work_info_guard);
+	std::unique_lock<std::mutex> lock(_lane_guard);
 
-	if (_work_infos.empty())
+	if (_lanes.empty())
 		return nullptr;
 
-	auto work_info = _work_infos.front();
-	_work_infos.pop();
+	auto lane = _lanes.back();
+	_lanes.pop_back();
 
-	return work_info;
+	return lane;
 }
 
 //====================================================================================================
@@ -90,30 +115,61 @@ std::shared_ptr<SegmentWorkInfo> SegmentWorker::PopWorkInfo()
 //====================================================================================================
 void SegmentWorker::WorkerThread()
 {
-	while (!_stop_thread_flag)
+	ov::ThreadMetrics thread_metrics("SegmentWorker", ov::ThreadClass::Media);
+	bool need_to_wait = true;
+
+	while (true)
 	{
 		// quequ event wait
-		_queue_event.Wait();
+		if (need_to_wait)
+		{
+			thread_metrics.BeginIdle();
+			_manager->WaitForLane();
+			thread_metrics.EndIdle();
+		}
 
-		auto work_info = PopWorkInfo();
+		if (_stop_thread_flag)
+		{
+			break;
+		}
 
-		if (work_info == nullptr)
+		auto lane = _manager->TakeLane(_index);
+
+		if (lane == nullptr)
 		{
-			if (_stop_thread_flag == false)
-			{
-				// It's a problem if there's nothing in the queue despite the event
-				OV_ASSERT2(false);
-			}
+			// The event is notified after the lane is queued, so there is a lane for this wakeup.
+			// It was queued in a worker that is already checked, so check again without waiting.
+			need_to_wait = false;
+			std::this_thread::yield();
+			continue;
+		}
+
+		need_to_wait = true;
+		thread_metrics.CountLoop();
+
+		auto work_info = _manager->PopWorkInfo(lane);
 
+		if (work_info == nullptr)
+		{
+			// It's a problem if there's nothing in the lane despite the lane is scheduled
+			OV_ASSERT2(false);
 			continue;
 		}
 
+		_manager->UpdateStatistics(work_info, lane->affinity != _index);
+
 		if (_process_handler(work_info->client, work_info->request_target, work_info->origin_url) == false)
 		{
 			logte("Segment process handler fail - target(%s)", work_info->request_target.CStr());
 		}
 
 		//        logtd("Segment process handler - target(%s)", work_info->request_target.CStr());
+
+		if (_manager->CompleteWorkInfo(lane, work_info))
+		{
+			// The next request of the client is processed after the other clients queued in this worker
+			_manager->NotifyLane(_index, lane);
+		}
 	}
 }
 
@@ -130,11 +186,13 @@ bool SegmentWorkerManager::Start(int worker_count, const SegmentProcessHandler &
 	// Create WorkerThread
 	for (int index = 0; index < _worker_count; index++)
 	{
-		auto worker = std::make_shared<SegmentWorker>();
+		auto worker = std::make_shared<SegmentWorker>(this, index);
 		worker->Start(process_handler);
 		_workers.push_back(worker);
 	}
 
+	_statistics_stop_watch.Start();
+
 	return true;
 }
 
@@ -148,26 +206,187 @@ bool SegmentWorkerManager::Stop()
 		worker->Stop();
 	}
 
+	// Wake up all workers to exit
+	for (size_t index = 0; index < _workers.size(); index++)
+	{
+		_lane_event.Notify();
+	}
+
+	for (const auto &worker : _workers)
+	{
+		worker->Join();
+	}
+
+	_workers.clear();
+
+	std::unique_lock<std::mutex> lock(_lane_guard);
+	_lanes.clear();
+
 	return true;
 }
 
 //====================================================================================================
 // Worker Add
+// - The works of the same client are queued in the same lane
 //====================================================================================================
 #define MAX_WORKER_INDEX 100000000
 bool SegmentWorkerManager::AddWork(const std::shared_ptr<HttpClient> &response,
 								   const ov::String &request_target,
 								   const ov::String &origin_url)
 {
+	if (_workers.empty())
+	{
+		return false;
+	}
+
 	auto work_info = std::make_shared<SegmentWorkInfo>(response, request_target, origin_url);
+	std::shared_ptr<SegmentWorkLane> lane;
 
-	// insert thread
-	_workers[(_worker_index % _worker_count)]->AddWorkInfo(work_info);
+	{
+		std::unique_lock<std::mutex> lock(_lane_guard);
+
+		auto &client_lane = _lanes[response.get()];
+
+		if (client_lane == nullptr)
+		{
+			client_lane = std::make_shared<SegmentWorkLane>();
+			client_lane->affinity = static_cast<size_t>(_worker_index % _worker_count);
 
-	if (_worker_index < MAX_WORKER_INDEX)
-		_worker_index++;
-	else
-		_worker_index = 0;
+			if (_worker_index < MAX_WORKER_INDEX)
+				_worker_index++;
+			else
+				_worker_index = 0;
+		}
+
+		client_lane->work_infos.push_back(work_info);
+
+		if (client_lane->is_scheduled == false)
+		{
+			client_lane->is_scheduled = true;
+			lane = client_lane;
+		}
+	}
+
+	// If the lane is already scheduled, the work will be processed after the previous works of the client
+	if (lane != nullptr)
+	{
+		NotifyLane(lane->affinity, lane);
+	}
 
 	return true;
 }
+
+//====================================================================================================
+// Queue a lane to the worker
+//====================================================================================================
+void SegmentWorkerManager::NotifyLane(size_t worker_index, const std::shared_ptr<SegmentWorkLane> &lane)
+{
+	_workers[worker_index]->PushLane(lane);
+	_lane_event.Notify();
+}
+
+//====================================================================================================
+// Wait until a lane is queued
+//====================================================================================================
+void SegmentWorkerManager::WaitForLane()
+{
+	_lane_event.Wait();
+}
+
+//====================================================================================================
+// Take a lane from the worker, or steal it from the other workers
+//====================================================================================================
+std::shared_ptr<SegmentWorkLane> SegmentWorkerManager::TakeLane(size_t worker_index)
+{
+	auto lane = _workers[worker_index]->PopLane();
+
+	if (lane != nullptr)
+	{
+		return lane;
+	}
+
+	for (size_t offset = 1; offset < _workers.size(); offset++)
+	{
+		lane = _workers[(worker_index + offset) % _workers.size()]->StealLane();
+
+		if (lane != nullptr)
+		{
+			return lane;
+		}
+	}
+
+	return nullptr;
+}
+
+//====================================================================================================
+// Pop the first work of the lane
+//====================================================================================================
+std::shared_ptr<SegmentWorkInfo> SegmentWorkerManager::PopWorkInfo(const std::shared_ptr<SegmentWorkLane> &lane)
+{
+	std::unique_lock<std::mutex> lock(_lane_guard);
+
+	if (lane->work_infos.empty())
+	{
+		return nullptr;
+	}
+
+	auto work_info = lane->work_infos.front();
+	lane->work_infos.pop_front();
+
+	return work_info;
+}
+
+//====================================================================================================
+// Release the lane if there is no more work of the client
+//====================================================================================================
+bool SegmentWorkerManager::CompleteWorkInfo(const std::shared_ptr<SegmentWorkLane> &lane, const std::shared_ptr<SegmentWorkInfo> &work_info)
+{
+	std::unique_lock<std::mutex> lock(_lane_guard);
+
+	if (lane->work_infos.empty() == false)
+	{
+		return true;
+	}
+
+	lane->is_scheduled = false;
+
+	auto item = _lanes.find(work_info->client.get());
+
+	if ((item != _lanes.end()) && (item->second == lane))
+	{
+		_lanes.erase(item);
+	}
+
+	return false;
+}
+
+//====================================================================================================
+// Queue wait time statistics
+//====================================================================================================
+void SegmentWorkerManager::UpdateStatistics(const std::shared_ptr<SegmentWorkInfo> &work_info, bool is_stolen)
+{
+	auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - work_info->enqueued_time).count();
+
+	std::unique_lock<std::mutex> lock(_statistics_guard);
+
+	_statistics_count++;
+	_statistics_total_wait_us += wait_us;
+	_statistics_max_wait_us = std::max(_statistics_max_wait_us, static_cast<int64_t>(wait_us));
+
+	if (is_stolen)
+	{
+		_statistics_stolen_count++;
+	}
+
+	if (_statistics_stop_watch.IsElapsed(SEGMENT_WORKER_STATISTICS_INTERVAL) && _statistics_stop_watch.Update())
+	{
+		logtd("Segment worker queue wait time - requests: %lld, stolen: %lld, avg: %.3fms, max: %.3fms",
+			  _statistics_count, _statistics_stolen_count,
+			  (_statistics_total_wait_us / 1000.0) / _statistics_count, _statistics_max_wait_us / 1000.0);
+
+		_statistics_count = 0;
+		_statistics_stolen_count = 0;
+		_statistics_total_wait_us = 0;
+		_statistics_max_wait_us = 0;
+	}
+}
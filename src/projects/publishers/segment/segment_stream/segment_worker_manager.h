@@ -9,7 +9,9 @@
 #pragma once
 
 #include <string>
-#include <queue>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
 #include "base/ovlibrary/ovlibrary.h"
 #include "base/ovlibrary/semaphore.h"
 #include "http_server/http_client.h"
@@ -18,42 +20,70 @@ struct SegmentWorkInfo
     SegmentWorkInfo(const std::shared_ptr<HttpClient> &client, const ov::String &request_target, const ov::String &origin_url)
         : client(client),
         request_target(request_target),
-        origin_url(origin_url)
+        origin_url(origin_url),
+        enqueued_time(std::chrono::steady_clock::now())
     {
     }
-    
+
     std::shared_ptr<HttpClient> client = nullptr;
     ov::String request_target;
     ov::String origin_url;
+
+    // To measure the time spent in the queue
+    std::chrono::steady_clock::time_point enqueued_time;
+};
+
+//====================================================================================================
+// SegmentWorkLane
+// - The works of a client, processed in the order they are added, by one worker at a time
+//====================================================================================================
+struct SegmentWorkLane
+{
+    // Guarded by SegmentWorkerManager::_lane_guard
+    std::deque<std::shared_ptr<SegmentWorkInfo>> work_infos;
+
+    // true while the lane is queued in a worker or being processed
+    bool is_scheduled = false;
+
+    // The worker that processes the lane by default
+    size_t affinity = 0;
 };
 
 using SegmentProcessHandler = std::function<bool(const std::shared_ptr<HttpClient> &client,
 												const ov::String &request_target,
 												const ov::String &origin_url)>;
+
+class SegmentWorkerManager;
+
 //====================================================================================================
 // SegmentWorker
 //====================================================================================================
 class SegmentWorker
 {
 public:
-    SegmentWorker();
+    SegmentWorker(SegmentWorkerManager *manager, size_t index);
     ~SegmentWorker();
 
     bool Start(const SegmentProcessHandler &process_handler);
     bool Stop();
+    void Join();
 
-    bool AddWorkInfo(std::shared_ptr<SegmentWorkInfo> work_info);
-    std::shared_ptr<SegmentWorkInfo> PopWorkInfo();
+    // The owner pops from the front, and the other workers steal from the back
+    void PushLane(const std::shared_ptr<SegmentWorkLane> &lane);
+    std::shared_ptr<SegmentWorkLane> PopLane();
+    std::shared_ptr<SegmentWorkLane> StealLane();
 
 private:
     void WorkerThread();
 
 private :
-    std::queue<std::shared_ptr<SegmentWorkInfo>> _work_infos;
-    std::mutex _work_info_guard;
-    ov::Semaphore _queue_event;
+    SegmentWorkerManager *_manager;
+    size_t _index;
 
-    bool _stop_thread_flag;
+    std::deque<std::shared_ptr<SegmentWorkLane>> _lanes;
+    std::mutex _lane_guard;
+
+    volatile bool _stop_thread_flag;
     std::thread _worker_thread;
 
     SegmentProcessHandler _process_handler;
@@ -61,12 +91,18 @@ private :
 
 //====================================================================================================
 // SegmentWorkerManager
+// - The works are grouped by the client to keep the order of the requests of a client,
+//   and an idle worker steals the clients queued in a busy worker,
+//   so a slow request (a big segment to a slow client, an origin fetch, ...) blocks only its client.
 //====================================================================================================
 class SegmentWorkerManager
 {
 public :
     SegmentWorkerManager() = default;
-    ~SegmentWorkerManager() = default;
+    ~SegmentWorkerManager()
+    {
+        Stop();
+    }
 
 public :
     bool Start(int worker_count, const SegmentProcessHandler &process_handler);
@@ -75,9 +111,36 @@ public :
 				const ov::String &request_target,
 				const ov::String &origin_url);
 
+protected:
+    friend class SegmentWorker;
+
+    // Called by the workers
+    void WaitForLane();
+    std::shared_ptr<SegmentWorkLane> TakeLane(size_t worker_index);
+    std::shared_ptr<SegmentWorkInfo> PopWorkInfo(const std::shared_ptr<SegmentWorkLane> &lane);
+    // Returns true if the lane has remaining works (the lane must be pushed again)
+    bool CompleteWorkInfo(const std::shared_ptr<SegmentWorkLane> &lane, const std::shared_ptr<SegmentWorkInfo> &work_info);
+
+    void NotifyLane(size_t worker_index, const std::shared_ptr<SegmentWorkLane> &lane);
+    void UpdateStatistics(const std::shared_ptr<SegmentWorkInfo> &work_info, bool is_stolen);
+
 private:
     int _worker_count = 0;
     int _worker_index = 0;
 
     std::vector<std::shared_ptr<SegmentWorker>> _workers;
-};
\ No newline at end of file
+
+    // The number of the lanes queued in the workers
+    ov::Semaphore _lane_event;
+
+    std::mutex _lane_guard;
+    std::unordered_map<const HttpClient *, std::shared_ptr<SegmentWorkLane>> _lanes;
+
+    // Queue wait time metrics
+    std::mutex _statistics_guard;
+    ov::StopWatch _statistics_stop_watch;
+    int64_t _statistics_count = 0;
+    int64_t _statistics_stolen_count = 0;
+    int64_t _statistics_total_wait_us = 0;
+    int64_t _statistics_max_wait_us = 0;
+};
@@ -46,9 +46,27 @@ public:
 	// Child must implement this functions
 	virtual bool AppendVideoFrame(std::shared_ptr<PacketizerFrameData> &dEncodedFrameata) = 0;
 	virtual bool AppendAudioFrame(std::shared_ptr<PacketizerFrameData> &data) = 0;
-	virtual bool GetPlayList(ov::String &play_list) = 0;
+	virtual bool GetPlayList(const ov::String &file_name, std::shared_ptr<const PlayListData> *play_list) = 0;
 	virtual std::shared_ptr<SegmentData> GetSegmentData(const ov::String &file_name) = 0;
 
+	std::shared_ptr<const RenditionData> GetRendition() const
+	{
+		return (_packetizer != nullptr) ? _packetizer->GetRendition() : nullptr;
+	}
+
+	std::shared_ptr<const ov::Data> GetKey(const ov::String &file_name) const
+	{
+		return (_packetizer != nullptr) ? _packetizer->GetKey(file_name) : nullptr;
+	}
+
+	void SetSegmentStorage(const std::shared_ptr<SegmentStorage> &segment_storage)
+	{
+		if (_packetizer != nullptr)
+		{
+			_packetizer->SetSegmentStorage(segment_storage);
+		}
+	}
+
 protected:
 	std::shared_ptr<Packetizer> _packetizer = nullptr;
 
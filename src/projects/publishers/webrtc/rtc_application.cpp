@@ -2,7 +2,10 @@
 #include "rtc_application.h"
 
 #include "modules/ice/ice_port_manager.h"
+#include "monitoring/monitoring.h"
 
+// The SRs are not sent at the exact interval, so the resolution of the timer can be coarse
+#define RTC_SENDER_REPORT_TIMER_TICK_MS 50
 
 std::shared_ptr<RtcApplication> RtcApplication::Create(const std::shared_ptr<pub::Publisher> &publisher, 
 													   const info::Application &application_info,
@@ -18,10 +21,13 @@ RtcApplication::RtcApplication(const std::shared_ptr<pub::Publisher> &publisher,
 							   const info::Application &application_info,
                                const std::shared_ptr<IcePort> &ice_port,
                                const std::shared_ptr<RtcSignallingServer> &rtc_signalling)
-	: Application(publisher, application_info)
+	: Application(publisher, application_info),
+	  _sender_report_timer(RTC_SENDER_REPORT_TIMER_TICK_MS)
 {
 	_ice_port = ice_port;
 	_rtc_signalling = rtc_signalling;
+
+	SetDirectDispatch(true);
 }
 
 RtcApplication::~RtcApplication()
@@ -35,6 +41,21 @@ std::shared_ptr<Certificate> RtcApplication::GetCertificate()
 	return _certificate;
 }
 
+std::shared_ptr<ov::TlsContext> RtcApplication::GetDtlsContext()
+{
+	return _dtls_context;
+}
+
+ov::TimerWheel *RtcApplication::GetSenderReportTimer()
+{
+	return &_sender_report_timer;
+}
+
+bool RtcApplication::PushDtlsPacket(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data)
+{
+	return _dtls_worker_pool.Push(session_info, data);
+}
+
 std::shared_ptr<pub::Stream> RtcApplication::CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count)
 {
 	// Stream Class 생성할때는 복사를 사용한다.
@@ -44,7 +65,58 @@ std::shared_ptr<pub::Stream> RtcApplication::CreateStream(const std::shared_ptr<
 		// RtcStream should have worker threads.
 		worker_count = MIN_STREAM_WORKER_THREAD_COUNT;
 	}
-	return RtcStream::Create(GetSharedPtrAs<pub::Application>(), *info, worker_count);
+	auto stream = RtcStream::Create(GetSharedPtrAs<pub::Application>(), *info, worker_count);
+
+	if((stream != nullptr) && stream->IsRenditionSwitchingEnabled())
+	{
+		auto group_id = GetRenditionGroupId(info);
+
+		std::lock_guard<std::mutex> lock(_rendition_group_mutex);
+		_rendition_groups[group_id].push_back(stream);
+		UpdateRenditions(group_id);
+	}
+
+	return stream;
+}
+
+info::stream_id_t RtcApplication::GetRenditionGroupId(const std::shared_ptr<info::Stream> &info)
+{
+	auto origin_stream = info->GetOriginStream();
+
+	return (origin_stream != nullptr) ? origin_stream->GetId() : info->GetId();
+}
+
+// _rendition_group_mutex must be locked
+void RtcApplication::UpdateRenditions(info::stream_id_t group_id)
+{
+	auto group = _rendition_groups.find(group_id);
+
+	if(group == _rendition_groups.end())
+	{
+		return;
+	}
+
+	auto &streams = group->second;
+
+	for(auto &stream : streams)
+	{
+		std::vector<std::shared_ptr<RtcStream>> renditions;
+
+		for(auto &rendition : streams)
+		{
+			if(rendition != stream)
+			{
+				renditions.push_back(rendition);
+			}
+		}
+
+		stream->SetRenditions(renditions);
+	}
+
+	if(streams.empty())
+	{
+		_rendition_groups.erase(group);
+	}
 }
 
 bool RtcApplication::DeleteStream(const std::shared_ptr<info::Stream> &info)
@@ -72,6 +144,24 @@ bool RtcApplication::DeleteStream(const std::shared_ptr<info::Stream> &info)
 		_rtc_signalling->Disconnect(GetName(), stream->GetName(), session->GetPeerSDP());
 	}
 
+	if(stream->IsRenditionSwitchingEnabled())
+	{
+		auto group_id = GetRenditionGroupId(info);
+
+		std::lock_guard<std::mutex> lock(_rendition_group_mutex);
+		auto group = _rendition_groups.find(group_id);
+
+		if(group != _rendition_groups.end())
+		{
+			auto &streams = group->second;
+			streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+		}
+
+		// The other renditions don't forward the packets to this stream any more
+		stream->SetRenditions({});
+		UpdateRenditions(group_id);
+	}
+
 	logtd("RtcApplication %s/%s stream has been deleted", GetName().CStr(), stream->GetName().CStr());
 
 	return true;
@@ -92,20 +182,65 @@ bool RtcApplication::Start()
 		}
 	}
 
+	if(_dtls_context == nullptr)
+	{
+		// Each session creates its own SSL_CTX if it is not available
+		_dtls_context = DtlsTransport::CreateTlsContext(_certificate);
+	}
+
+	auto webrtc_config = GetPublisher<cfg::WebrtcPublisher>();
+	auto dtls_worker_count = (webrtc_config != nullptr) ? webrtc_config->GetDtlsWorkerCount() : 2;
+
+	if(dtls_worker_count > 0)
+	{
+		_dtls_worker_pool.Start(dtls_worker_count);
+	}
+
+	_sender_report_timer.Start();
+
 	return Application::Start();
 }
 
 bool RtcApplication::Stop()
 {
-	return Application::Stop();
+	_dtls_worker_pool.Stop();
+
+	auto result = Application::Stop();
+
+	// The streams have cancelled their timers while they are deleted
+	_sender_report_timer.Stop();
+
+	return result;
 }
 
 // RTCP RR packet info
 // call from stream -> session -> RtpRtcp
 // packetizer checkr check ssrc_1(video/audio)
+void RtcApplication::DisconnectSession(const std::shared_ptr<RtcSession> &session)
+{
+	auto stream = std::static_pointer_cast<RtcStream>(session->GetStream());
+
+	logtw("Disconnecting session %u of %s/%s", session->GetId(), GetName().CStr(), stream->GetName().CStr());
+
+	if(stream->RemoveSession(session->GetId()) == false)
+	{
+		// Already disconnected
+		return;
+	}
+
+	auto stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(stream));
+	if(stream_metrics != nullptr)
+	{
+		stream_metrics->OnSessionDisconnected(PublisherType::Webrtc);
+	}
+
+	_ice_port->RemoveSession(session);
+	_rtc_signalling->Disconnect(GetName(), stream->GetName(), session->GetPeerSDP());
+}
+
 void RtcApplication::OnReceiverReport(uint32_t stream_id,
                                       uint32_t session_id,
-                                      time_t first_receiver_report_time,
+                                      int64_t first_receiver_report_time_ms,
                                       const std::shared_ptr<RtcpReceiverReport> &receiver_report)
 {
     logtd("Rtcp Report: app(%u) stream(%u) session(%u) ssrc(%u) fraction(%u/256) packet_lost(%d) jitter(%u) delay(%.6f)",
@@ -9,6 +9,7 @@
 #include <modules/rtc_signalling/rtc_signalling.h>
 #include <modules/rtp_rtcp/rtcp_packet.h>
 #include "rtc_stream.h"
+#include "rtc_dtls_worker_pool.h"
 
 class RtcApplication : public pub::Application
 {
@@ -25,10 +26,20 @@ public:
 	~RtcApplication() final;
 
 	std::shared_ptr<Certificate> GetCertificate();
+	// SSL_CTX shared by the DTLS of all sessions (nullptr if it could not be created)
+	std::shared_ptr<ov::TlsContext> GetDtlsContext();
+
+	// Returns false if the DTLS workers are disabled (the packet should be pushed to the application queue)
+	// Runs the periodic RTCP SR of the streams
+	ov::TimerWheel *GetSenderReportTimer();
+	bool PushDtlsPacket(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data);
+
+	// Closes the session from the server side (the stream, IcePort and the signalling)
+	void DisconnectSession(const std::shared_ptr<RtcSession> &session);
 
     void OnReceiverReport(uint32_t stream_id,
                         uint32_t session_id,
-                        time_t first_receiver_report_time,
+                        int64_t first_receiver_report_time_ms,
                         const std::shared_ptr<RtcpReceiverReport> &receiver_report);
 
 private:
@@ -39,7 +50,18 @@ private:
 	std::shared_ptr<pub::Stream> CreateStream(const std::shared_ptr<info::Stream> &info, uint32_t worker_count) override;
 	bool DeleteStream(const std::shared_ptr<info::Stream> &info) override;
 
+	// The streams transcoded from the same input stream (and the input stream itself) are the renditions of each other
+	static info::stream_id_t GetRenditionGroupId(const std::shared_ptr<info::Stream> &info);
+	void UpdateRenditions(info::stream_id_t group_id);
+
 	std::shared_ptr<IcePort> _ice_port;
 	std::shared_ptr<RtcSignallingServer> _rtc_signalling;
 	std::shared_ptr<Certificate> _certificate;
+	std::shared_ptr<ov::TlsContext> _dtls_context;
+	RtcDtlsWorkerPool _dtls_worker_pool;
+	ov::TimerWheel _sender_report_timer;
+
+	// key: group id (id of the input stream), value: streams
+	std::mutex _rendition_group_mutex;
+	std::map<info::stream_id_t, std::vector<std::shared_ptr<RtcStream>>> _rendition_groups;
 };
\ No newline at end of file
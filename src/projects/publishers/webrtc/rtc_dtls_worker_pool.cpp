@@ -0,0 +1,117 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtc_private.h"
+#include "rtc_dtls_worker_pool.h"
+
+#include <base/publisher/session.h>
+
+RtcDtlsWorkerPool::~RtcDtlsWorkerPool()
+{
+	Stop();
+}
+
+bool RtcDtlsWorkerPool::Start(int worker_count)
+{
+	std::lock_guard<std::shared_mutex> lock(_workers_mutex);
+
+	if(_workers.empty() == false)
+	{
+		return false;
+	}
+
+	for(int index = 0; index < worker_count; index++)
+	{
+		auto worker = std::make_unique<Worker>("DTLS worker queue");
+
+		worker->thread = std::thread(WorkerThread, worker.get());
+
+		_workers.push_back(std::move(worker));
+	}
+
+	logti("%d DTLS worker(s) are started", worker_count);
+
+	return true;
+}
+
+bool RtcDtlsWorkerPool::Stop()
+{
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	{
+		std::lock_guard<std::shared_mutex> lock(_workers_mutex);
+		workers.swap(_workers);
+	}
+
+	if(workers.empty())
+	{
+		return false;
+	}
+
+	for(auto &worker : workers)
+	{
+		worker->queue.Stop();
+	}
+
+	for(auto &worker : workers)
+	{
+		if(worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+
+	return true;
+}
+
+bool RtcDtlsWorkerPool::IsRunning() const
+{
+	std::shared_lock<std::shared_mutex> lock(_workers_mutex);
+
+	return (_workers.empty() == false);
+}
+
+bool RtcDtlsWorkerPool::Push(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data)
+{
+	std::shared_lock<std::shared_mutex> lock(_workers_mutex);
+
+	if(_workers.empty())
+	{
+		return false;
+	}
+
+	auto &worker = _workers[session_info->GetId() % _workers.size()];
+
+	worker->queue.Enqueue(Packet{session_info, data});
+
+	return true;
+}
+
+void RtcDtlsWorkerPool::WorkerThread(Worker *worker)
+{
+	ov::ThreadMetrics thread_metrics("RtcDtlsWorker", ov::ThreadClass::NetworkIo);
+
+	while(true)
+	{
+		thread_metrics.BeginIdle();
+		auto packet = worker->queue.Dequeue();
+		thread_metrics.EndIdle();
+
+		if(packet.has_value() == false)
+		{
+			// Stopped
+			break;
+		}
+
+		thread_metrics.CountLoop();
+
+		auto session = std::static_pointer_cast<pub::Session>(packet->session_info);
+
+		session->OnPacketReceived(packet->session_info, packet->data);
+	}
+}
@@ -0,0 +1,62 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/info/session.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// A warning is logged if more packets than this are waiting in a worker
+#define RTC_DTLS_WORKER_QUEUE_THRESHOLD 1000
+
+// Processes the DTLS packets (handshakes) of the sessions with the dedicated threads,
+// so the handshakes (ECDHE, signature) of many joining viewers don't delay the other packets of the application thread.
+// The DTLS packets of a session are processed by the same worker in order.
+class RtcDtlsWorkerPool
+{
+public:
+	RtcDtlsWorkerPool() = default;
+	~RtcDtlsWorkerPool();
+
+	bool Start(int worker_count);
+	bool Stop();
+
+	bool IsRunning() const;
+
+	// Returns false if the pool is not running (the packet should be processed by the caller)
+	bool Push(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data);
+
+private:
+	struct Packet
+	{
+		std::shared_ptr<info::Session> session_info;
+		std::shared_ptr<const ov::Data> data;
+	};
+
+	struct Worker
+	{
+		Worker(const char *alias)
+			: queue(alias, RTC_DTLS_WORKER_QUEUE_THRESHOLD)
+		{
+		}
+
+		ov::Queue<Packet> queue;
+		std::thread thread;
+	};
+
+	static void WorkerThread(Worker *worker);
+
+	// Push() is called by the ICE threads while the pool is stopped
+	mutable std::shared_mutex _workers_mutex;
+	std::vector<std::unique_ptr<Worker>> _workers;
+};
@@ -0,0 +1,303 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtc_private.h"
+#include "rtc_rendition_switcher.h"
+#include "rtc_stream.h"
+
+#include <base/ovlibrary/byte_io.h>
+
+#include <algorithm>
+
+RtcRenditionSwitcher::RtcRenditionSwitcher(const std::shared_ptr<RtcStream> &stream, bool is_red)
+	: _stream(stream),
+	  _is_red(is_red),
+	  _current(stream)
+{
+	_last_selection_ms = GetNowMs();
+	_last_switch_ms = _last_selection_ms;
+}
+
+RtcRenditionSwitcher::~RtcRenditionSwitcher()
+{
+	_current = _stream;
+	_pending = nullptr;
+
+	UpdateSubscription();
+}
+
+int64_t RtcRenditionSwitcher::GetNowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool RtcRenditionSwitcher::IsCompatible(const std::shared_ptr<RtcStream> &rendition) const
+{
+	// The payload types/codec parameters negotiated with the player must be valid for the rendition
+	return (rendition->GetVideoSsrc() != 0) &&
+		   (rendition->GetVideoCodecId() == _stream->GetVideoCodecId()) &&
+		   (rendition->GetVideoPayloadType() == _stream->GetVideoPayloadType());
+}
+
+bool RtcRenditionSwitcher::IsSelectionRequired() const
+{
+	return (GetNowMs() - _last_selection_ms) >= RTC_RENDITION_SELECT_INTERVAL_MS;
+}
+
+void RtcRenditionSwitcher::Select(uint32_t estimated_bitrate)
+{
+	auto now_ms = GetNowMs();
+	_last_selection_ms = now_ms;
+
+	// [bitrate, rendition]
+	std::vector<std::pair<uint32_t, std::shared_ptr<RtcStream>>> candidates;
+
+	candidates.emplace_back(_stream->GetVideoBitrate(), _stream);
+
+	for (auto &rendition : _stream->GetRenditions())
+	{
+		if (IsCompatible(rendition))
+		{
+			candidates.emplace_back(rendition->GetVideoBitrate(), rendition);
+		}
+	}
+
+	auto selected = (_pending != nullptr) ? _pending : _current;
+	auto selected_item = std::find_if(candidates.begin(), candidates.end(), [&selected](const auto &candidate) { return candidate.second == selected; });
+
+	if ((selected_item != candidates.end()) && (selected_item->first == 0))
+	{
+		// The bitrate of the selected rendition is not measured yet
+		return;
+	}
+
+	// Exclude the renditions that are not measured yet
+	candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const auto &candidate) { return candidate.first == 0; }), candidates.end());
+
+	if (candidates.empty())
+	{
+		return;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+	selected_item = std::find_if(candidates.begin(), candidates.end(), [&selected](const auto &candidate) { return candidate.second == selected; });
+
+	std::shared_ptr<RtcStream> target = selected;
+
+	if ((selected_item == candidates.end()) || (selected_item->first > estimated_bitrate))
+	{
+		// The selected rendition is deleted, or it exceeds the bandwidth: select the highest one that fits (or the lowest one)
+		target = candidates.front().second;
+
+		for (auto &candidate : candidates)
+		{
+			if (candidate.first <= estimated_bitrate)
+			{
+				target = candidate.second;
+			}
+		}
+	}
+	else if ((now_ms - _last_switch_ms) >= RTC_RENDITION_UP_SWITCH_INTERVAL_MS)
+	{
+		// Step up one rendition at a time
+		auto next_item = selected_item + 1;
+
+		if ((next_item != candidates.end()) && (next_item->first <= (estimated_bitrate * RTC_RENDITION_UP_SWITCH_HEADROOM)))
+		{
+			target = next_item->second;
+		}
+	}
+
+	if (target != selected)
+	{
+		logtd("Rendition is changed: %s -> %s (estimated bitrate: %u)", selected->GetName().CStr(), target->GetName().CStr(), estimated_bitrate);
+
+		SetPending((target == _current) ? nullptr : target);
+	}
+
+	if (_pending != nullptr)
+	{
+		// The switch is done at the next key frame
+		_pending->RequestKeyFrame(_pending->GetVideoSsrc());
+	}
+}
+
+void RtcRenditionSwitcher::SetPending(const std::shared_ptr<RtcStream> &rendition)
+{
+	_pending = rendition;
+
+	UpdateSubscription();
+}
+
+void RtcRenditionSwitcher::UpdateSubscription()
+{
+	bool is_subscribing = (_current != _stream) || ((_pending != nullptr) && (_pending != _stream));
+
+	if (is_subscribing == _is_subscribing)
+	{
+		return;
+	}
+
+	_is_subscribing = is_subscribing;
+
+	if (is_subscribing)
+	{
+		_stream->AddRenditionSubscriber();
+	}
+	else
+	{
+		_stream->RemoveRenditionSubscriber();
+	}
+}
+
+void RtcRenditionSwitcher::Switch(uint16_t sequence_number, uint32_t timestamp)
+{
+	if (_has_last_packet)
+	{
+		_sequence_number_offset = static_cast<uint16_t>(_last_sequence_number + 1 - sequence_number);
+
+		// The renditions of the same input usually have the same timestamps, keep them to preserve the A/V sync
+		auto delta = static_cast<int32_t>(timestamp - _last_timestamp);
+
+		if ((delta > 0) && (delta < 90000))
+		{
+			_timestamp_offset = 0;
+		}
+		else
+		{
+			_timestamp_offset = _last_timestamp + RTC_RENDITION_TIMESTAMP_GAP - timestamp;
+		}
+	}
+	else
+	{
+		_sequence_number_offset = 0;
+		_timestamp_offset = 0;
+	}
+
+	_switched_sequence_number = static_cast<uint16_t>(sequence_number + _sequence_number_offset);
+	_is_rewriting = true;
+
+	_current = _pending;
+	_pending = nullptr;
+
+	_last_switch_ms = GetNowMs();
+
+	UpdateSubscription();
+
+	logtd("Rendition is switched to %s (sequence number offset: %u, timestamp offset: %u)", _current->GetName().CStr(), _sequence_number_offset, _timestamp_offset);
+}
+
+bool RtcRenditionSwitcher::Process(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet, RtpHeaderRewrite *rewrite, bool *is_rewritten)
+{
+	*is_rewritten = false;
+
+	if (packet->GetLength() < FIXED_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	auto buffer = packet->GetDataAs<uint8_t>();
+	auto ssrc = ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
+
+	if (ssrc == _stream->GetAudioSsrc())
+	{
+		// The audio is always sent from the stream
+		return true;
+	}
+
+	auto sequence_number = ByteReader<uint16_t>::ReadBigEndian(&buffer[2]);
+	auto timestamp = ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
+
+	if ((_pending != nullptr) && (ssrc == _pending->GetVideoSsrc()) && (packet_type & RTC_PACKET_TYPE_KEY_FRAME_START))
+	{
+		Switch(sequence_number, timestamp);
+	}
+
+	if (ssrc != _current->GetVideoSsrc())
+	{
+		// The other renditions
+		return false;
+	}
+
+	auto output_sequence_number = static_cast<uint16_t>(sequence_number + _sequence_number_offset);
+	auto output_timestamp = timestamp + _timestamp_offset;
+
+	if ((_has_last_packet == false) || (static_cast<int16_t>(output_sequence_number - _last_sequence_number) > 0))
+	{
+		_has_last_packet = true;
+		_last_sequence_number = output_sequence_number;
+		_last_timestamp = output_timestamp;
+	}
+
+	if (_is_rewriting)
+	{
+		rewrite->ssrc = _stream->GetVideoSsrc();
+		rewrite->sequence_number = output_sequence_number;
+		rewrite->timestamp = output_timestamp;
+
+		*is_rewritten = true;
+	}
+
+	return true;
+}
+
+bool RtcRenditionSwitcher::ProcessSenderReport(uint32_t ssrc, uint32_t rtp_timestamp, RtpHeaderRewrite *rewrite, bool *is_rewritten)
+{
+	*is_rewritten = false;
+
+	if (ssrc == _stream->GetAudioSsrc())
+	{
+		return true;
+	}
+
+	if (ssrc != _current->GetVideoSsrc())
+	{
+		return false;
+	}
+
+	if (_is_rewriting)
+	{
+		rewrite->ssrc = _stream->GetVideoSsrc();
+		rewrite->timestamp = rtp_timestamp + _timestamp_offset;
+
+		*is_rewritten = true;
+	}
+
+	return true;
+}
+
+std::shared_ptr<RtcStream> RtcRenditionSwitcher::GetCurrent() const
+{
+	return _current;
+}
+
+std::shared_ptr<const ov::Data> RtcRenditionSwitcher::FindPacket(uint16_t sequence_number, uint32_t *packet_type) const
+{
+	if (_is_rewriting && (static_cast<int16_t>(sequence_number - _switched_sequence_number) < 0))
+	{
+		// The packet was sent before the switch, it is the packet of the other rendition
+		return nullptr;
+	}
+
+	auto source_sequence_number = static_cast<uint16_t>(sequence_number - _sequence_number_offset);
+
+	auto history = _current->GetRtpHistory(_current->GetVideoSsrc(), _is_red);
+
+	if (history == nullptr)
+	{
+		history = _current->GetRtpHistory(_current->GetVideoSsrc(), false);
+
+		if (history == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	return history->Find(source_sequence_number, packet_type);
+}
@@ -0,0 +1,88 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "modules/rtp_rtcp/rtp_rtcp.h"
+
+#include <memory>
+
+class RtcStream;
+
+// The rendition is evaluated at most once in this interval
+#define RTC_RENDITION_SELECT_INTERVAL_MS 1000
+// Minimum interval from the last switch to the up-switch, to avoid the oscillation
+#define RTC_RENDITION_UP_SWITCH_INTERVAL_MS 5000
+// A higher rendition is selected only when it uses less than this ratio of the estimated bandwidth
+#define RTC_RENDITION_UP_SWITCH_HEADROOM 0.85
+// If the timestamps of the renditions are not continuous, the new rendition starts after this gap (90kHz, 1 frame of 30fps)
+#define RTC_RENDITION_TIMESTAMP_GAP 3000
+
+// Selects the video rendition of a session among the stream and the other renditions transcoded from the same input,
+// by the estimated bandwidth of the session.
+//
+// All renditions are sent with the SSRC of the stream, and the sequence numbers/timestamps are rewritten,
+// so the player sees a single continuous video. The switch is done at the first packet of a key frame of the new rendition.
+//
+// It is not thread-safe, RtcSession calls it with its send lock.
+class RtcRenditionSwitcher
+{
+public:
+	// is_red: whether the session receives the video in RED (The sequence numbers of RED are used)
+	RtcRenditionSwitcher(const std::shared_ptr<RtcStream> &stream, bool is_red);
+	~RtcRenditionSwitcher();
+
+	bool IsSelectionRequired() const;
+	// estimated_bitrate: bps
+	void Select(uint32_t estimated_bitrate);
+
+	// Returns false if the packet must not be sent to the session.
+	// *is_rewritten is set to true if the header must be rewritten with rewrite.
+	bool Process(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet, RtpHeaderRewrite *rewrite, bool *is_rewritten);
+	// The same as Process() for the SR template of the ssrc (the SR of the current rendition is sent with the rewritten timestamp)
+	bool ProcessSenderReport(uint32_t ssrc, uint32_t rtp_timestamp, RtpHeaderRewrite *rewrite, bool *is_rewritten);
+
+	// The rendition of which the video is being sent to the session
+	std::shared_ptr<RtcStream> GetCurrent() const;
+
+	// Finds the packet of the (rewritten) video sequence number for the retransmission
+	std::shared_ptr<const ov::Data> FindPacket(uint16_t sequence_number, uint32_t *packet_type) const;
+
+private:
+	static int64_t GetNowMs();
+
+	bool IsCompatible(const std::shared_ptr<RtcStream> &rendition) const;
+	void SetPending(const std::shared_ptr<RtcStream> &rendition);
+	void Switch(uint16_t sequence_number, uint32_t timestamp);
+	void UpdateSubscription();
+
+	std::shared_ptr<RtcStream> _stream;
+	bool _is_red;
+
+	std::shared_ptr<RtcStream> _current;
+	// The rendition to switch at the next key frame
+	std::shared_ptr<RtcStream> _pending;
+
+	// Whether this session is receiving the packets of the other renditions
+	bool _is_subscribing = false;
+
+	// Once switched, all video packets are rewritten (even if the stream itself is selected again)
+	bool _is_rewriting = false;
+	uint16_t _sequence_number_offset = 0;
+	uint32_t _timestamp_offset = 0;
+	// The first (rewritten) sequence number after the last switch
+	uint16_t _switched_sequence_number = 0;
+
+	// The last video packet sent to the session (rewritten)
+	bool _has_last_packet = false;
+	uint16_t _last_sequence_number = 0;
+	uint32_t _last_timestamp = 0;
+
+	int64_t _last_selection_ms = 0;
+	int64_t _last_switch_ms = 0;
+};
@@ -3,7 +3,10 @@
 #include "rtc_session.h"
 #include "rtc_application.h"
 #include "rtc_stream.h"
+#include "modules/rtp_rtcp/rtp_packet.h"
+#include <base/ovlibrary/byte_io.h>
 
+#include <algorithm>
 #include <utility>
 
 std::shared_ptr<RtcSession> RtcSession::Create(const std::shared_ptr<pub::Application> &application,
@@ -107,6 +110,50 @@ bool RtcSession::Start()
     // RTP RTCP 생성
 	_rtp_rtcp = std::make_shared<RtpRtcp>((uint32_t)pub::SessionNodeType::Rtp, session, ssrc_list);
 
+	// Transport-wide congestion control is used only if the player accepted the extension
+	for(size_t i = 0; i < peer_media_desc_list.size(); i++)
+	{
+		auto extension_id = peer_media_desc_list[i]->GetExtmapId(RTP_TRANSPORT_CC_EXTENSION_URI);
+
+		if(extension_id != 0)
+		{
+			_rtp_rtcp->SetTransportCcExtensionId(offer_media_desc_list[i]->GetSsrc(), extension_id);
+		}
+	}
+
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+
+	if(stream->IsRenditionSwitchingEnabled() && (_video_payload_type != 0) && _rtp_rtcp->IsBandwidthEstimationEnabled())
+	{
+		_rendition_switcher = std::make_shared<RtcRenditionSwitcher>(stream, _video_payload_type == RED_PAYLOAD_TYPE);
+
+		// Assume that the requested rendition fits the bandwidth until the feedback says otherwise
+		if(stream->GetVideoBitrate() > 0)
+		{
+			_rtp_rtcp->SetStartBitrate(stream->GetVideoBitrate());
+		}
+	}
+
+	if((_video_payload_type != 0) && (stream->GetVideoCodecId() == common::MediaCodecId::Vp8))
+	{
+		_temporal_layer_filter = std::make_shared<RtcTemporalLayerFilter>();
+	}
+
+	if(stream->IsPacingEnabled() && (_video_payload_type != 0))
+	{
+		std::weak_ptr<RtcSession> weak_session = std::static_pointer_cast<RtcSession>(GetSharedPtr());
+
+		_pacer = std::make_shared<RtpPacer>([weak_session](const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite) -> bool {
+			auto rtc_session = weak_session.lock();
+
+			return (rtc_session != nullptr) ? rtc_session->SendPacedData(packet, rewrite) : false;
+		});
+
+		UpdatePacer();
+
+		RtpPacerScheduler::Instance()->Register(_pacer);
+	}
+
 	// SRTP 생성
 	_srtp_transport = std::make_shared<SrtpTransport>((uint32_t)pub::SessionNodeType::Srtp, session);
 
@@ -114,10 +161,25 @@ bool RtcSession::Start()
 	_dtls_transport = std::make_shared<DtlsTransport>((uint32_t)pub::SessionNodeType::Dtls, session);
 	std::shared_ptr<RtcApplication> application = std::static_pointer_cast<RtcApplication>(GetApplication());
 	_dtls_transport->SetLocalCertificate(application->GetCertificate());
+	_dtls_transport->SetTlsContext(application->GetDtlsContext());
+	_dtls_transport->SetPeerFingerprint(_peer_sdp->GetFingerprintAlgorithm(), _peer_sdp->GetFingerprintValue());
+
+	std::weak_ptr<RtcStream> weak_stream = stream;
+	_dtls_transport->SetHandshakeCompletedCallback([weak_stream](int64_t latency_ms, bool is_resumed) {
+		auto stream = weak_stream.lock();
+
+		if(stream != nullptr)
+		{
+			stream->OnDtlsHandshakeCompleted(latency_ms, is_resumed);
+		}
+	});
+	// The payloads are already encrypted once for all sessions, so the encryption of SRTP can be skipped
+	_dtls_transport->SetNullCipherAllowed(stream->GetFrameEncryptor() != nullptr);
 	_dtls_transport->StartDTLS();
 
 	// ICE-DTLS 생성
 	_dtls_ice_transport = std::make_shared<DtlsIceTransport>((uint32_t)pub::SessionNodeType::Ice, session, _ice_port);
+	_dtls_ice_transport->SetSessionStats(&GetStats());
 
 	// 노드를 연결한다.
 	_rtp_rtcp->RegisterUpperNode(nullptr);
@@ -133,6 +195,11 @@ bool RtcSession::Start()
 	_dtls_ice_transport->RegisterLowerNode(nullptr);
 	_dtls_ice_transport->Start();
 
+	if(_video_payload_type == RED_PAYLOAD_TYPE)
+	{
+		stream->AddRedSession();
+	}
+
 	return Session::Start();
 }
 
@@ -151,6 +218,24 @@ bool RtcSession::Stop()
 		_rtp_rtcp->Stop();
 	}
 
+	{
+		// The other renditions don't need to forward the packets to this session
+		std::lock_guard<std::mutex> lock(_send_mutex);
+		_rendition_switcher.reset();
+
+		if(_pacer != nullptr)
+		{
+			_pacer->Stop();
+		}
+
+		ReportSentBytes();
+	}
+
+	if(_video_payload_type == RED_PAYLOAD_TYPE)
+	{
+		std::static_pointer_cast<RtcStream>(GetStream())->RemoveRedSession();
+	}
+
 	if(_dtls_ice_transport != nullptr)
 	{
 		_dtls_ice_transport->Stop();
@@ -194,8 +279,13 @@ void RtcSession::OnPacketReceived(const std::shared_ptr<info::Session> &session_
 	_dtls_ice_transport->OnDataReceived(pub::SessionNodeType::None, data);
 }
 
-bool RtcSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet)
+bool RtcSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet)
 {
+	if(packet_type & RTC_PACKET_TYPE_SENDER_REPORT)
+	{
+		return SendSenderReport(packet);
+	}
+
 	auto rtp_payload_type = static_cast<uint8_t>(packet_type & 0xFF);
 	auto red_block_pt = static_cast<uint8_t>((packet_type & 0xFF00) >> 8);
 	auto origin_pt_of_fec = static_cast<uint8_t>((packet_type & 0xFF0000) >> 16);
@@ -214,7 +304,424 @@ bool RtcSession::SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov
 		}
 	}
 
+	std::lock_guard<std::mutex> lock(_send_mutex);
+
+	RtpHeaderRewrite rewrite;
+	bool is_rewritten = false;
+
+	if(_rendition_switcher != nullptr)
+	{
+		if(_rendition_switcher->IsSelectionRequired())
+		{
+			auto bitrate = _rtp_rtcp->GetEstimatedBitrate();
+
+			_rendition_switcher->Select((_bitrate_cap > 0) ? std::min(bitrate, _bitrate_cap) : bitrate);
+		}
+
+		if(_rendition_switcher->Process(packet_type, packet, &rewrite, &is_rewritten) == false)
+		{
+			return false;
+		}
+	}
+
+	if((_temporal_layer_filter != nullptr) && (rtp_payload_type == _video_payload_type))
+	{
+		if(FilterTemporalLayer(packet_type, packet, &rewrite, &is_rewritten) == false)
+		{
+			return false;
+		}
+	}
+
 	_sent_bytes += packet->GetLength();
 
-	return _rtp_rtcp->SendOutgoingData(packet);
+	if((_pacer != nullptr) && (rtp_payload_type == _video_payload_type))
+	{
+		UpdatePacer();
+
+		_pacer->Enqueue(packet, is_rewritten ? &rewrite : nullptr);
+		return true;
+	}
+
+	return _rtp_rtcp->SendOutgoingData(packet, is_rewritten ? &rewrite : nullptr);
+}
+
+bool RtcSession::SendSenderReport(const std::shared_ptr<const ov::Data> &sr_template)
+{
+	if(sr_template->GetLength() < (RTCP_HEADER_SIZE + 24))
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(_send_mutex);
+
+	RtpHeaderRewrite rewrite;
+	bool is_rewritten = false;
+
+	if(_rendition_switcher != nullptr)
+	{
+		auto buffer = sr_template->GetDataAs<uint8_t>();
+
+		if(_rendition_switcher->ProcessSenderReport(ByteReader<uint32_t>::ReadBigEndian(&buffer[4]), ByteReader<uint32_t>::ReadBigEndian(&buffer[16]), &rewrite, &is_rewritten) == false)
+		{
+			return false;
+		}
+	}
+
+	return _rtp_rtcp->SendSenderReport(sr_template, is_rewritten ? &rewrite : nullptr);
+}
+
+bool RtcSession::SendPacedData(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite)
+{
+	std::lock_guard<std::mutex> lock(_send_mutex);
+
+	if(GetState() != SessionState::Started)
+	{
+		return false;
+	}
+
+	return _rtp_rtcp->SendOutgoingData(packet, rewrite);
+}
+
+void RtcSession::UpdatePacer()
+{
+	auto now_ms = RtpPacerScheduler::GetNowMs();
+
+	if((now_ms - _last_pacer_update_ms) < 1000)
+	{
+		return;
+	}
+
+	_last_pacer_update_ms = now_ms;
+
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+
+	// Paces at the estimated bandwidth, but not lower than the bitrate of the stream (the queue would grow forever).
+	// If neither is known yet, the packets are sent at the next tick without pacing.
+	uint32_t target_bitrate = stream->GetVideoBitrate();
+
+	if(_rtp_rtcp->IsBandwidthEstimationEnabled())
+	{
+		target_bitrate = std::max(target_bitrate, _rtp_rtcp->GetEstimatedBitrate());
+	}
+
+	_pacer->SetTargetBitrate(target_bitrate);
+
+	auto queue_delay_ms = _pacer->GetAverageQueueDelayMs();
+
+	GetStats().queue_delay_ms = static_cast<int32_t>(queue_delay_ms);
+	stream->UpdatePacingQueueDelay(queue_delay_ms);
+}
+
+bool RtcSession::FilterTemporalLayer(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet, RtpHeaderRewrite *rewrite, bool *is_rewritten)
+{
+	if(packet->GetLength() < FIXED_HEADER_SIZE)
+	{
+		return false;
+	}
+
+	if(_temporal_layer_filter->IsSelectionRequired())
+	{
+		auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+		auto rendition = (_rendition_switcher != nullptr) ? _rendition_switcher->GetCurrent() : stream;
+		auto estimated_bitrate = _rtp_rtcp->IsBandwidthEstimationEnabled() ? _rtp_rtcp->GetEstimatedBitrate() : 0;
+
+		_temporal_layer_filter->Select(estimated_bitrate, rendition->GetVideoBitrate(), GetStats().fraction_lost);
+	}
+
+	auto buffer = packet->GetDataAs<uint8_t>();
+
+	// The header rewritten by the rendition switcher, or the header of the packet
+	auto ssrc = *is_rewritten ? rewrite->ssrc : ByteReader<uint32_t>::ReadBigEndian(&buffer[8]);
+	auto sequence_number = *is_rewritten ? rewrite->sequence_number : ByteReader<uint16_t>::ReadBigEndian(&buffer[2]);
+	auto timestamp = *is_rewritten ? rewrite->timestamp : ByteReader<uint32_t>::ReadBigEndian(&buffer[4]);
+
+	uint16_t output_sequence_number = 0;
+
+	if(_temporal_layer_filter->Process(packet_type, sequence_number, timestamp, &output_sequence_number) == false)
+	{
+		return false;
+	}
+
+	if(*is_rewritten || (output_sequence_number != sequence_number))
+	{
+		rewrite->ssrc = ssrc;
+		rewrite->sequence_number = output_sequence_number;
+		rewrite->timestamp = timestamp;
+
+		*is_rewritten = true;
+	}
+
+	return true;
+}
+
+std::shared_ptr<const ov::Data> RtcSession::FindVideoPacket(uint16_t sequence_number, uint32_t *packet_type)
+{
+	if((_temporal_layer_filter != nullptr) && _temporal_layer_filter->IsRewriting())
+	{
+		if(_temporal_layer_filter->FindSourceSequenceNumber(sequence_number, &sequence_number) == false)
+		{
+			return nullptr;
+		}
+	}
+
+	if(_rendition_switcher != nullptr)
+	{
+		// The sequence numbers are rewritten, so the packets are found from the history of the current rendition
+		return _rendition_switcher->FindPacket(sequence_number, packet_type);
+	}
+
+	// The session that receives RED packets requests the sequence numbers of the RED packets
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+	auto history = stream->GetRtpHistory(stream->GetVideoSsrc(), _video_payload_type == RED_PAYLOAD_TYPE);
+
+	if(history == nullptr)
+	{
+		history = stream->GetRtpHistory(stream->GetVideoSsrc(), false);
+
+		if(history == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	return history->Find(sequence_number, packet_type);
+}
+
+void RtcSession::ReportSentBytes()
+{
+	uint64_t sent_bytes = GetStats().sent_bytes;
+
+	std::static_pointer_cast<RtcStream>(GetStream())->OnSessionBytesSent(sent_bytes - _reported_sent_bytes);
+	_reported_sent_bytes = sent_bytes;
+}
+
+bool RtcSession::CheckHealth()
+{
+	std::lock_guard<std::mutex> lock(_send_mutex);
+
+	if(GetState() != SessionState::Started)
+	{
+		return true;
+	}
+
+	ReportSentBytes();
+
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+	auto timeout_ms = stream->GetSlowConsumerTimeoutMs();
+
+	if(timeout_ms == 0)
+	{
+		return true;
+	}
+
+	auto &stats = GetStats();
+	auto now_ms = RtpPacerScheduler::GetNowMs();
+
+	// The datagrams that could not be sent since the last check are a loss that RR doesn't know yet
+	uint64_t sent_packets = stats.sent_packets;
+	uint64_t dropped_packets = stats.dropped_packets;
+	auto sent_count = sent_packets - _last_checked_sent_packets;
+	auto dropped_count = dropped_packets - _last_checked_dropped_packets;
+	_last_checked_sent_packets = sent_packets;
+	_last_checked_dropped_packets = dropped_packets;
+
+	auto loss_percent = (stats.fraction_lost * 100.0) / 256.0;
+
+	if((sent_count + dropped_count) > 0)
+	{
+		loss_percent = std::max(loss_percent, (dropped_count * 100.0) / (sent_count + dropped_count));
+	}
+
+	bool is_falling_behind = (stats.queue_delay_ms > stream->GetSlowConsumerQueueDelayMs()) ||
+							 (loss_percent > stream->GetSlowConsumerLoss());
+
+	if(is_falling_behind == false)
+	{
+		if(_falling_behind_since_ms != 0)
+		{
+			logti("Session %u has caught up with the stream", GetId());
+			_falling_behind_since_ms = 0;
+		}
+
+		// The higher renditions are allowed again after it has been stable for a while
+		if((_bitrate_cap > 0) && ((now_ms - _last_falling_behind_ms) >= timeout_ms))
+		{
+			_bitrate_cap = 0;
+		}
+
+		return true;
+	}
+
+	_last_falling_behind_ms = now_ms;
+
+	if(_falling_behind_since_ms == 0)
+	{
+		_falling_behind_since_ms = now_ms;
+
+		logtw("Session %u is falling behind the stream (queue delay: %d ms, loss: %.1f%%)", GetId(), stats.queue_delay_ms.load(), loss_percent);
+	}
+	else if((now_ms - _falling_behind_since_ms) >= timeout_ms)
+	{
+		return false;
+	}
+
+	if(_rendition_switcher != nullptr)
+	{
+		auto rendition = _rendition_switcher->GetCurrent();
+		uint32_t bitrate = (_bitrate_cap > 0) ? _bitrate_cap : ((rendition != nullptr) ? rendition->GetVideoBitrate() : 0);
+
+		if(bitrate == 0)
+		{
+			bitrate = _rtp_rtcp->GetEstimatedBitrate();
+		}
+
+		_bitrate_cap = bitrate / 2;
+	}
+
+	return true;
+}
+
+uint32_t RtcSession::GetEstimatedBitrate() const
+{
+	if(_rtp_rtcp == nullptr)
+	{
+		return 0;
+	}
+
+	return _rtp_rtcp->GetEstimatedBitrate();
+}
+
+void RtcSession::OnKeyFrameRequestReceived(uint32_t media_ssrc)
+{
+	logtd("Key frame is requested: session(%u) ssrc(%u)", GetId(), media_ssrc);
+
+	GetStats().key_frame_request_count++;
+
+	std::static_pointer_cast<RtcStream>(GetStream())->RequestKeyFrame(media_ssrc);
+}
+
+void RtcSession::OnReceiverReportReceived(const RtcpReceiverReport &receiver_report)
+{
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+	bool is_video = (receiver_report.ssrc_1 == stream->GetVideoSsrc());
+
+	// The video is the most of the traffic, so the audio is used only if the session doesn't receive the video
+	if(is_video || (_video_payload_type == 0))
+	{
+		auto &stats = GetStats();
+
+		if(receiver_report.rtt > 0.0)
+		{
+			stats.rtt_ms = static_cast<int32_t>(receiver_report.rtt * 1000.0);
+		}
+
+		stats.fraction_lost = receiver_report.fraction_lost;
+	}
+
+	if(receiver_report.ssrc_1 == stream->GetAudioSsrc())
+	{
+		// The in-band FEC of OPUS follows the loss of the audio
+		stream->UpdateAudioFractionLost(GetId(), receiver_report.fraction_lost);
+		return;
+	}
+
+	if((_video_payload_type != RED_PAYLOAD_TYPE) || (is_video == false))
+	{
+		// FEC is not sent to this session
+		return;
+	}
+
+	std::shared_ptr<RtcStream> rendition;
+
+	{
+		std::lock_guard<std::mutex> lock(_send_mutex);
+
+		if(_rendition_switcher != nullptr)
+		{
+			rendition = _rendition_switcher->GetCurrent();
+		}
+	}
+
+	// FEC is generated by the rendition which this session is receiving
+	((rendition != nullptr) ? rendition : stream)->UpdateVideoFractionLost(GetId(), receiver_report.fraction_lost);
+}
+
+void RtcSession::OnNackReceived(const RtcpNack &nack)
+{
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream());
+
+	if(nack.media_ssrc == stream->GetVideoSsrc())
+	{
+		std::unique_lock<std::mutex> lock(_send_mutex);
+
+		if((_rendition_switcher != nullptr) || (_temporal_layer_filter != nullptr))
+		{
+			// The sequence numbers may be rewritten, so the packets are found by the session
+			size_t retransmitted_count = 0;
+
+			for(auto sequence_number : nack.sequence_numbers)
+			{
+				uint32_t packet_type = 0;
+				auto packet = FindVideoPacket(sequence_number, &packet_type);
+
+				if(packet == nullptr)
+				{
+					continue;
+				}
+
+				lock.unlock();
+
+				if(SendOutgoingData(packet_type, packet))
+				{
+					retransmitted_count++;
+				}
+
+				lock.lock();
+			}
+
+			GetStats().nack_count++;
+			GetStats().retransmitted_packets += retransmitted_count;
+
+			logtd("NACK received: ssrc(%u) requested(%zu) retransmitted(%zu)", nack.media_ssrc, nack.sequence_numbers.size(), retransmitted_count);
+			return;
+		}
+	}
+
+	// The session that receives RED packets requests the sequence numbers of the RED packets
+	auto history = stream->GetRtpHistory(nack.media_ssrc, _video_payload_type == RED_PAYLOAD_TYPE);
+
+	if(history == nullptr)
+	{
+		history = stream->GetRtpHistory(nack.media_ssrc, false);
+
+		if(history == nullptr)
+		{
+			logtd("Unknown ssrc of NACK: %u", nack.media_ssrc);
+			return;
+		}
+	}
+
+	size_t retransmitted_count = 0;
+
+	for(auto sequence_number : nack.sequence_numbers)
+	{
+		uint32_t packet_type = 0;
+		auto packet = history->Find(sequence_number, &packet_type);
+
+		if(packet == nullptr)
+		{
+			// Too old packet
+			continue;
+		}
+
+		if(SendOutgoingData(packet_type, packet))
+		{
+			retransmitted_count++;
+		}
+	}
+
+	GetStats().nack_count++;
+	GetStats().retransmitted_packets += retransmitted_count;
+
+	logtd("NACK received: ssrc(%u) requested(%zu) retransmitted(%zu)", nack.media_ssrc, nack.sequence_numbers.size(), retransmitted_count);
 }
\ No newline at end of file
@@ -8,7 +8,10 @@
 #include "modules//dtls_srtp/dtls_ice_transport.h"
 #include "modules/rtp_rtcp/rtp_rtcp.h"
 #include "modules/rtp_rtcp/rtp_rtcp_interface.h"
+#include "modules/rtp_rtcp/rtp_pacer.h"
 #include "modules/dtls_srtp/dtls_transport.h"
+#include "rtc_rendition_switcher.h"
+#include "rtc_temporal_layer_filter.h"
 #include <unordered_set>
 
 /*
@@ -67,10 +70,37 @@ public:
 	const std::shared_ptr<SessionDescription>& GetOfferSDP();
 	const std::shared_ptr<WebSocketClient>& GetWSClient();
 
-	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<ov::Data> &packet) override;
+	bool SendOutgoingData(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet) override;
 	void OnPacketReceived(const std::shared_ptr<info::Session> &session_info, const std::shared_ptr<const ov::Data> &data) override;
 
+	// Retransmits the lost packets in the RTP history of the stream
+	void OnNackReceived(const RtcpNack &nack);
+	void OnReceiverReportReceived(const RtcpReceiverReport &receiver_report);
+	// PLI/FIR
+	void OnKeyFrameRequestReceived(uint32_t media_ssrc);
+
+	// Available bandwidth estimated from the transport-wide congestion control feedback (bps)
+	uint32_t GetEstimatedBitrate() const;
+
+	// Reports the sent bytes to the stream, and handles the session falling behind (See RtcStream::GetSlowConsumerTimeoutMs()):
+	// the bitrate for the rendition selection is halved in each check until it catches up, and it is disconnected after the timeout.
+	bool CheckHealth() override;
+
 private:
+	// Called by the pacer
+	bool SendPacedData(const std::shared_ptr<const ov::Data> &packet, const RtpHeaderRewrite *rewrite);
+	// packet_type has RTC_PACKET_TYPE_SENDER_REPORT
+	bool SendSenderReport(const std::shared_ptr<const ov::Data> &sr_template);
+	// Updates the target bitrate of the pacer, and reports the queue delay (called with the send lock)
+	void UpdatePacer();
+	// Reports the bytes sent since the last report to the stream (called with the send lock)
+	void ReportSentBytes();
+	// Drops the video packet of the temporal layers above the selected layer, and rewrites the sequence number of the others
+	// Returns false if the packet must not be sent (called with the send lock)
+	bool FilterTemporalLayer(uint32_t packet_type, const std::shared_ptr<const ov::Data> &packet, RtpHeaderRewrite *rewrite, bool *is_rewritten);
+	// Finds the packet of the video sequence number sent to the player for the retransmission (called with the send lock)
+	std::shared_ptr<const ov::Data> FindVideoPacket(uint16_t sequence_number, uint32_t *packet_type);
+
 	std::shared_ptr<RtpRtcp>            _rtp_rtcp;
 	std::shared_ptr<SrtpTransport>      _srtp_transport;
 	std::shared_ptr<DtlsTransport>      _dtls_transport;
@@ -81,6 +111,28 @@ private:
 	std::shared_ptr<IcePort>            _ice_port;
 	std::shared_ptr<WebSocketClient> 	_ws_client; // Signalling  
 
+	// SendOutgoingData() is called by the stream workers and the retransmission at the same time
+	std::mutex							_send_mutex;
+
+	// Available only if the rendition switching is enabled and the bandwidth can be estimated
+	std::shared_ptr<RtcRenditionSwitcher>	_rendition_switcher;
+
+	// Available only if the video is VP8 (the encoder may send the temporal layers)
+	std::shared_ptr<RtcTemporalLayerFilter>	_temporal_layer_filter;
+
+	// The video packets are sent through the pacer (if enabled), the audio packets are sent immediately
+	std::shared_ptr<RtpPacer>			_pacer;
+	int64_t								_last_pacer_update_ms = 0;
+
+	// Slow consumer (protected by the send lock)
+	uint64_t							_reported_sent_bytes = 0;
+	uint64_t							_last_checked_sent_packets = 0;
+	uint64_t							_last_checked_dropped_packets = 0;
+	int64_t								_falling_behind_since_ms = 0;
+	int64_t								_last_falling_behind_ms = 0;
+	// The upper limit of the bitrate for the rendition selection while falling behind (0: no limit)
+	uint32_t							_bitrate_cap = 0;
+
 	uint8_t 							_red_block_pt = 0;
 	uint8_t                             _video_payload_type = 0;
 	uint8_t                             _audio_payload_type = 0;
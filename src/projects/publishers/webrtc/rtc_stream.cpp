@@ -4,6 +4,8 @@
 #include "rtc_session.h"
 #include <base/info/media_extradata.h>
 
+#include <cmath>
+
 using namespace common;
 
 std::shared_ptr<RtcStream> RtcStream::Create(const std::shared_ptr<pub::Application> application,
@@ -39,6 +41,8 @@ bool RtcStream::Start(uint32_t worker_count)
 	_offer_sdp->SetOrigin("OvenMediaEngine", ov::Random::GenerateUInt32(), 2, "IN", 4, "127.0.0.1");
 	_offer_sdp->SetTiming(0, 0);
 	_offer_sdp->SetIceOption("trickle");
+	// The players are the controlling agents and OME only answers the checks (See IcePort::ProcessBindingRequest())
+	_offer_sdp->SetIceLite(true);
 	_offer_sdp->SetIceUfrag(ov::Random::GenerateString(8));
 	_offer_sdp->SetIcePwd(ov::Random::GenerateString(32));
 	_offer_sdp->SetMsidSemantic("WMS", "*");
@@ -139,12 +143,22 @@ bool RtcStream::Start(uint32_t worker_count)
 					video_media_desc->SetDirection(MediaDescription::Direction::SendOnly);
 					video_media_desc->SetMediaType(MediaDescription::MediaType::Video);
 					video_media_desc->SetCname(ov::Random::GenerateUInt32(), ov::Random::GenerateString(16));
+					// Transport-wide congestion control
+					video_media_desc->AddExtmap(RTP_TRANSPORT_CC_EXTENSION_ID, RTP_TRANSPORT_CC_EXTENSION_URI);
 					_offer_sdp->AddMedia(video_media_desc);
+					_video_ssrc = video_media_desc->GetSsrc();
+					_video_payload_type = payload_type_num;
+					_video_codec_id = track->GetCodecId();
 					first_video_desc = false;
 				}
 
 				//TODO(getroot): WEBRTC에서는 TIMEBASE를 무조건 90000을 쓰는 것으로 보임, 정확히 알아볼것
 				payload->SetRtpmap(payload_type_num++, codec, 90000);
+				// The lost packets are retransmitted from the RTP history
+				payload->EnableRtcpFb(PayloadAttr::RtcpFbType::Nack, true);
+				payload->EnableRtcpFb(PayloadAttr::RtcpFbType::NackPli, true);
+				payload->EnableRtcpFb(PayloadAttr::RtcpFbType::CcmFir, true);
+				payload->EnableRtcpFb(PayloadAttr::RtcpFbType::TransportCc, true);
 
 				video_media_desc->AddPayload(payload);
 
@@ -194,12 +208,15 @@ bool RtcStream::Start(uint32_t worker_count)
 					audio_media_desc->SetDirection(MediaDescription::Direction::SendOnly);
 					audio_media_desc->SetMediaType(MediaDescription::MediaType::Audio);
 					audio_media_desc->SetCname(ov::Random::GenerateUInt32(), ov::Random::GenerateString(16));
+					audio_media_desc->AddExtmap(RTP_TRANSPORT_CC_EXTENSION_ID, RTP_TRANSPORT_CC_EXTENSION_URI);
 					_offer_sdp->AddMedia(audio_media_desc);
+					_audio_ssrc = audio_media_desc->GetSsrc();
 					first_audio_desc = false;
 				}
 
 				payload->SetRtpmap(payload_type_num++, codec, static_cast<uint32_t>(track->GetSample().GetRateNum()),
 								   std::to_string(track->GetChannel().GetCounts()).c_str());
+				payload->EnableRtcpFb(PayloadAttr::RtcpFbType::TransportCc, true);
 
 				audio_media_desc->AddPayload(payload);
 
@@ -228,17 +245,76 @@ bool RtcStream::Start(uint32_t worker_count)
         video_media_desc->AddPayload(ulpfec_payload);
     }
 
+	// The offer SDP is not changed after this, so it is rendered only once for all sessions
+	_offer_sdp->UpdateTemplate();
+
 	logtd("Stream is created : %s/%u", GetName().CStr(), GetId());
 
 	_stream_metrics = StreamMetrics(*std::static_pointer_cast<info::Stream>(pub::Stream::GetSharedPtr()));
 
-	return Stream::Start(worker_count);
+	auto webrtc_config = GetApplication()->GetPublisher<cfg::WebrtcPublisher>();
+	SetEgressBatchSize((webrtc_config != nullptr) ? std::max(webrtc_config->GetEgressBatchSize(), 0) : DEFAULT_EGRESS_BATCH_SIZE);
+	SetRunToCompletion((webrtc_config != nullptr) ? webrtc_config->IsRunToCompletionEnabled() : false);
+	_key_frame_request_interval_ms = (webrtc_config != nullptr) ? std::max(webrtc_config->GetKeyFrameRequestInterval(), 0) : 1000;
+	_is_rendition_switching_enabled = (webrtc_config != nullptr) ? webrtc_config->IsRenditionSwitchingEnabled() : false;
+	_is_pacing_enabled = (webrtc_config != nullptr) ? webrtc_config->IsPacingEnabled() : true;
+	_is_adaptive_fec_enabled = (webrtc_config != nullptr) ? webrtc_config->IsAdaptiveFecEnabled() : true;
+
+	if(webrtc_config != nullptr)
+	{
+		_slow_consumer_queue_delay_ms = std::max(webrtc_config->GetSlowConsumerQueueDelay(), 0);
+		_slow_consumer_loss = std::max(webrtc_config->GetSlowConsumerLoss(), 0);
+		_slow_consumer_timeout_ms = std::max(webrtc_config->GetSlowConsumerTimeout(), 0) * 1000LL;
+	}
+
+	if((webrtc_config != nullptr) && webrtc_config->IsSFrameEnabled())
+	{
+		CreateFrameEncryptor();
+	}
+
+	if(Stream::Start(worker_count) == false)
+	{
+		return false;
+	}
+
+	// The SRs are generated once per stream, not for every packet of every session
+	_sender_report_started_ms = ov::Clock::NowMs();
+
+	std::weak_ptr<RtcStream> weak_stream = std::static_pointer_cast<RtcStream>(pub::Stream::GetSharedPtr());
+	_sender_report_timer = GetApplication()->GetSharedPtrAs<RtcApplication>()->GetSenderReportTimer()->Push(
+		[weak_stream](void *parameter) -> ov::DelayQueueAction {
+			auto stream = weak_stream.lock();
+
+			if(stream == nullptr)
+			{
+				return ov::DelayQueueAction::Stop;
+			}
+
+			stream->SendSenderReports();
+
+			return ov::DelayQueueAction::Repeat;
+		},
+		RTC_SENDER_REPORT_FAST_INTERVAL_MS);
+
+	return true;
 }
 
 bool RtcStream::Stop()
 {
+	if(_sender_report_timer != 0)
+	{
+		GetApplication()->GetSharedPtrAs<RtcApplication>()->GetSenderReportTimer()->Cancel(_sender_report_timer);
+		_sender_report_timer = 0;
+	}
+
 	_offer_sdp->Release();
 	_packetizers.clear();
+	_packetizer_table.clear();
+
+	{
+		std::lock_guard<std::shared_mutex> lock(_rendition_mutex);
+		_renditions.clear();
+	}
 
 	return Stream::Stop();
 }
@@ -270,15 +346,150 @@ bool RtcStream::OnRtpPacketized(std::shared_ptr<RtpPacket> packet)
 	//                 | origin_pt_of_fec | red block_pt | rtp_payload_type |
 	uint32_t payload_type = rtp_payload_type | (red_block_pt << 8) | (origin_pt_of_fec << 16);
 
+	bool is_video = (packet->Ssrc() == _video_ssrc);
+
+	if(is_video)
+	{
+		// The FEC packets of a frame have the layer of the frame (they are dropped with the frame)
+		payload_type |= (static_cast<uint32_t>(_temporal_layer) << RTC_PACKET_TYPE_TEMPORAL_LAYER_SHIFT) & RTC_PACKET_TYPE_TEMPORAL_LAYER_MASK;
+	}
+
+	auto history = GetRtpHistory(packet->Ssrc(), rtp_payload_type == RED_PAYLOAD_TYPE);
+	if(history != nullptr)
+	{
+		history->Store(packet->SequenceNumber(), payload_type, packet->GetData());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_sender_report_mutex);
+
+		auto source = _sender_report_sources.find(packet->Ssrc());
+
+		if(source != _sender_report_sources.end())
+		{
+			source->second.has_packet = true;
+			source->second.last_timestamp = packet->Timestamp();
+			source->second.last_packetized_ms = ov::Clock::NowMs();
+		}
+	}
+
+	if(is_video)
+	{
+		uint8_t flag = (rtp_payload_type == RED_PAYLOAD_TYPE) ? 0x02 : 0x01;
+
+		if(_key_frame_start_flags & flag)
+		{
+			// The rendition switching is done at this packet
+			payload_type |= RTC_PACKET_TYPE_KEY_FRAME_START;
+			_key_frame_start_flags &= ~flag;
+		}
+
+		if(rtp_payload_type != RED_PAYLOAD_TYPE)
+		{
+			MeasureVideoBitrate(packet->GetData()->GetLength());
+		}
+	}
+
+	// The bytes out are reported by the sessions (See OnSessionBytesSent())
 	BroadcastPacket(payload_type, packet->GetData());
-	if(_stream_metrics != nullptr)
+
+	if(is_video && _is_rendition_switching_enabled)
 	{
-		_stream_metrics->IncreaseBytesOut(PublisherType::Webrtc, packet->GetData()->GetLength() * GetSessionCount());
+		// The sessions of the other renditions may be receiving this video (they rewrite the SSRC, sequence number, ...)
+		std::shared_lock<std::shared_mutex> lock(_rendition_mutex);
+
+		for(auto &rendition : _renditions)
+		{
+			if(rendition->_rendition_subscriber_count > 0)
+			{
+				rendition->BroadcastPacket(payload_type, packet->GetData());
+			}
+		}
 	}
 
 	return true;
 }
 
+void RtcStream::SendSenderReports()
+{
+	auto now_ms = ov::Clock::NowMs();
+	auto interval_ms = ((now_ms - _sender_report_started_ms) < RTC_SENDER_REPORT_FAST_DURATION_MS) ? RTC_SENDER_REPORT_FAST_INTERVAL_MS : RTC_SENDER_REPORT_INTERVAL_MS;
+
+	// The timer runs at the fast interval, allow the jitter of the timer
+	if((now_ms - _last_sender_report_ms) < (interval_ms - (RTC_SENDER_REPORT_FAST_INTERVAL_MS / 2)))
+	{
+		return;
+	}
+
+	_last_sender_report_ms = now_ms;
+
+	uint32_t msw = 0;
+	uint32_t lsw = 0;
+	ov::Clock::GetNtpTime(msw, lsw);
+
+	std::vector<std::pair<uint32_t, std::shared_ptr<ov::Data>>> sender_reports;
+
+	{
+		std::lock_guard<std::mutex> lock(_sender_report_mutex);
+
+		for(const auto &[ssrc, source] : _sender_report_sources)
+		{
+			if(source.has_packet == false)
+			{
+				continue;
+			}
+
+			// The RTP timestamp corresponding to the NTP time of the SR
+			auto elapsed_ms = now_ms - source.last_packetized_ms;
+			auto rtp_timestamp = source.last_timestamp + static_cast<uint32_t>((elapsed_ms * source.clock_rate) / 1000);
+
+			// The packet/octet counts are filled in by each session
+			sender_reports.emplace_back(ssrc, RtcpPacket::MakeSrPacket(msw, lsw, ssrc, rtp_timestamp, 0, 0));
+		}
+	}
+
+	for(auto &[ssrc, sender_report] : sender_reports)
+	{
+		BroadcastPacket(RTC_PACKET_TYPE_SENDER_REPORT, sender_report);
+
+		if(_is_rendition_switching_enabled && (ssrc == _video_ssrc))
+		{
+			// The sessions of the other renditions may be receiving this video
+			std::shared_lock<std::shared_mutex> lock(_rendition_mutex);
+
+			for(auto &rendition : _renditions)
+			{
+				if(rendition->_rendition_subscriber_count > 0)
+				{
+					rendition->BroadcastPacket(RTC_PACKET_TYPE_SENDER_REPORT, sender_report);
+				}
+			}
+		}
+	}
+}
+
+void RtcStream::MeasureVideoBitrate(size_t bytes)
+{
+	auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	if(_video_bitrate_measure_start_ms == 0)
+	{
+		_video_bitrate_measure_start_ms = now_ms;
+	}
+
+	_video_bitrate_measure_bytes += bytes;
+
+	auto elapsed_ms = now_ms - _video_bitrate_measure_start_ms;
+
+	if(elapsed_ms >= RTC_VIDEO_BITRATE_MEASURE_INTERVAL_MS)
+	{
+		_video_bitrate = static_cast<uint32_t>((_video_bitrate_measure_bytes * 8 * 1000) / elapsed_ms);
+
+		_video_bitrate_measure_start_ms = now_ms;
+		_video_bitrate_measure_bytes = 0;
+	}
+}
+
 void RtcStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 {
 	auto media_track = GetTrack(media_packet->GetTrackId());
@@ -292,9 +503,26 @@ void RtcStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 	{
 		codec_info.codec_type = CodecType::Vp8;
 
-		// Structure for future expansion.
-		// In the future, when OME uses codec-specific features, certain information is obtained from media_packet.
 		codec_info.codec_specific.vp8 = CodecSpecificInfoVp8();
+
+		if(media_packet->GetTemporalLayer() > 0)
+		{
+			_has_temporal_layers = true;
+		}
+
+		if(_has_temporal_layers)
+		{
+			// The sessions drop the upper layers by the temporal layer index in the payload descriptor
+			if(media_packet->GetTemporalLayer() == 0)
+			{
+				_vp8_tl0_pic_idx++;
+			}
+
+			codec_info.codec_specific.vp8.temporal_idx = media_packet->GetTemporalLayer();
+			codec_info.codec_specific.vp8.layer_sync = media_packet->IsLayerSync();
+			codec_info.codec_specific.vp8.tl0_pic_idx = _vp8_tl0_pic_idx;
+			codec_info.codec_specific.vp8.non_reference = (media_packet->GetTemporalLayer() > 0);
+		}
 	}
 	else if(codec_id == MediaCodecId::H264)
 	{
@@ -320,6 +548,27 @@ void RtcStream::SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet)
 	auto data = media_packet->GetData();
 	auto fragmentation = media_packet->GetFragHeader();
 
+	UpdateRedAndFec(packetizer);
+
+	if(frame_type == FrameType::VideoFrameKey)
+	{
+		// Mark the first packets (RTP and RED) of this frame in OnRtpPacketized()
+		_key_frame_start_flags = 0x03;
+	}
+
+	_temporal_layer = media_packet->GetTemporalLayer();
+
+	if(_frame_encryptor != nullptr)
+	{
+		// Encrypted once here, instead of in every session
+		data = _frame_encryptor->Encrypt(data->GetData(), data->GetLength());
+
+		if(data == nullptr)
+		{
+			return;
+		}
+	}
+
 	packetizer->Packetize(frame_type,
 	                      timestamp,
 	                      data->GetDataAs<uint8_t>(),
@@ -345,6 +594,16 @@ void RtcStream::SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet)
 	auto data = media_packet->GetData();
 	auto fragmentation = media_packet->GetFragHeader();
 
+	if(_frame_encryptor != nullptr)
+	{
+		data = _frame_encryptor->Encrypt(data->GetData(), data->GetLength());
+
+		if(data == nullptr)
+		{
+			return;
+		}
+	}
+
 	packetizer->Packetize(frame_type,
 						  timestamp,
 						  data->GetDataAs<uint8_t>(),
@@ -411,17 +670,24 @@ void RtcStream::AddPacketizer(common::MediaCodecId codec_id, uint32_t id, uint8_
 	packetizer->SetPayloadType(payload_type);
 	packetizer->SetSSRC(ssrc);
 
+	uint32_t clock_rate = 0;
+
 	switch(codec_id)
 	{
 		case MediaCodecId::Vp8:
+			clock_rate = 90000;
 			packetizer->SetVideoCodec(RtpVideoCodecType::Vp8);
 			packetizer->SetUlpfec(RED_PAYLOAD_TYPE, ULPFEC_PAYLOAD_TYPE);
+			_rtp_histories[(static_cast<uint64_t>(ssrc) << 1) | 1] = std::make_shared<RtpHistory>();
 			break;
 		case MediaCodecId::H264:
+			clock_rate = 90000;
 			packetizer->SetVideoCodec(RtpVideoCodecType::H264);
 			packetizer->SetUlpfec(RED_PAYLOAD_TYPE, ULPFEC_PAYLOAD_TYPE);
+			_rtp_histories[(static_cast<uint64_t>(ssrc) << 1) | 1] = std::make_shared<RtpHistory>();
 			break;
 		case MediaCodecId::Opus:
+			clock_rate = 48000;
 			packetizer->SetAudioCodec(RtpAudioCodecType::Opus);
 			break;
 		default:
@@ -429,15 +695,374 @@ void RtcStream::AddPacketizer(common::MediaCodecId codec_id, uint32_t id, uint8_
 			return;
 	}
 
+	_rtp_histories[static_cast<uint64_t>(ssrc) << 1] = std::make_shared<RtpHistory>();
+
+	{
+		std::lock_guard<std::mutex> lock(_sender_report_mutex);
+		_sender_report_sources[ssrc].clock_rate = clock_rate;
+	}
+
 	_packetizers[id] = packetizer;
+
+	if(id < static_cast<uint32_t>(info::MaxIndexedTrackId))
+	{
+		if(id >= _packetizer_table.size())
+		{
+			_packetizer_table.resize(id + 1);
+		}
+
+		_packetizer_table[id] = packetizer;
+	}
 }
 
 std::shared_ptr<RtpPacketizer> RtcStream::GetPacketizer(uint32_t id)
 {
-	if(!_packetizers.count(id))
+	if(id < static_cast<uint32_t>(info::MaxIndexedTrackId))
+	{
+		return (id < _packetizer_table.size()) ? _packetizer_table[id] : nullptr;
+	}
+
+	auto item = _packetizers.find(id);
+	if(item == _packetizers.end())
+	{
+		return nullptr;
+	}
+
+	return item->second;
+}
+
+bool RtcStream::IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track)
+{
+	return GetPacketizer(track->GetId()) != nullptr;
+}
+
+std::shared_ptr<RtpHistory> RtcStream::GetRtpHistory(uint32_t ssrc, bool is_red)
+{
+	auto item = _rtp_histories.find((static_cast<uint64_t>(ssrc) << 1) | (is_red ? 1 : 0));
+
+	if(item == _rtp_histories.end())
 	{
 		return nullptr;
 	}
 
-	return _packetizers[id];
+	return item->second;
+}
+
+void RtcStream::RequestKeyFrame(uint32_t media_ssrc)
+{
+	if(media_ssrc != _video_ssrc)
+	{
+		return;
+	}
+
+	auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	auto last_ms = _last_key_frame_request_ms.load();
+
+	if((now_ms - last_ms) < _key_frame_request_interval_ms)
+	{
+		// A key frame has been requested recently, it will satisfy this request too
+		return;
+	}
+
+	// Only one of the sessions requesting at the same time wins
+	if(_last_key_frame_request_ms.compare_exchange_strong(last_ms, now_ms) == false)
+	{
+		return;
+	}
+
+	auto application = std::static_pointer_cast<pub::Application>(GetApplication());
+
+	if(application->RequestKeyFrame(std::static_pointer_cast<info::Stream>(pub::Stream::GetSharedPtr())) == false)
+	{
+		logtd("Could not request a key frame: %s/%u", GetName().CStr(), GetId());
+	}
+}
+
+uint32_t RtcStream::GetVideoSsrc() const
+{
+	return _video_ssrc;
+}
+
+uint32_t RtcStream::GetAudioSsrc() const
+{
+	return _audio_ssrc;
+}
+
+uint8_t RtcStream::GetVideoPayloadType() const
+{
+	return _video_payload_type;
+}
+
+common::MediaCodecId RtcStream::GetVideoCodecId() const
+{
+	return _video_codec_id;
+}
+
+uint32_t RtcStream::GetVideoBitrate() const
+{
+	return _video_bitrate;
+}
+
+bool RtcStream::IsRenditionSwitchingEnabled() const
+{
+	return _is_rendition_switching_enabled;
+}
+
+void RtcStream::CreateFrameEncryptor()
+{
+	for(auto &track_item : _tracks)
+	{
+		auto &track = track_item.second;
+
+		// The H.264 depacketizer of the players needs the NAL unit headers, so only the codecs that are packetized regardless of the payload are supported
+		if((track->GetMediaType() == MediaType::Video) && (track->GetCodecId() != MediaCodecId::Vp8))
+		{
+			logtw("SFrame is disabled for %s/%s: unsupported codec %s",
+				  GetApplication()->GetName().CStr(), GetName().CStr(), ov::Converter::ToString(track->GetCodecId()).CStr());
+			return;
+		}
+	}
+
+	auto frame_encryptor = std::make_shared<SFrameEncryptor>(GetId(), SFrameEncryptor::GenerateKey());
+
+	if(frame_encryptor->IsValid() == false)
+	{
+		logte("Could not create SFrame encryptor for %s/%s", GetApplication()->GetName().CStr(), GetName().CStr());
+		return;
+	}
+
+	_frame_encryptor = frame_encryptor;
+
+	logti("SFrame is enabled for %s/%s (key id: %u)", GetApplication()->GetName().CStr(), GetName().CStr(), GetId());
+}
+
+std::shared_ptr<SFrameEncryptor> RtcStream::GetFrameEncryptor() const
+{
+	return _frame_encryptor;
+}
+
+bool RtcStream::IsPacingEnabled() const
+{
+	return _is_pacing_enabled;
+}
+
+void RtcStream::UpdatePacingQueueDelay(double queue_delay_ms)
+{
+	if(_stream_metrics != nullptr)
+	{
+		_stream_metrics->UpdatePacingQueueDelayMSec(queue_delay_ms);
+	}
+}
+
+void RtcStream::OnDtlsHandshakeCompleted(int64_t latency_ms, bool is_resumed)
+{
+	if(_stream_metrics != nullptr)
+	{
+		_stream_metrics->OnDtlsHandshakeCompleted(latency_ms, is_resumed);
+	}
+}
+
+void RtcStream::OnSessionBytesSent(uint64_t bytes)
+{
+	if((_stream_metrics != nullptr) && (bytes > 0))
+	{
+		_stream_metrics->IncreaseBytesOut(PublisherType::Webrtc, bytes);
+	}
+}
+
+int32_t RtcStream::GetSlowConsumerQueueDelayMs() const
+{
+	return _slow_consumer_queue_delay_ms;
+}
+
+int32_t RtcStream::GetSlowConsumerLoss() const
+{
+	return _slow_consumer_loss;
+}
+
+int64_t RtcStream::GetSlowConsumerTimeoutMs() const
+{
+	return _slow_consumer_timeout_ms;
+}
+
+void RtcStream::OnSessionFallingBehind(const std::shared_ptr<pub::Session> &session)
+{
+	std::static_pointer_cast<RtcApplication>(GetApplication())->DisconnectSession(std::static_pointer_cast<RtcSession>(session));
+}
+
+void RtcStream::SetRenditions(const std::vector<std::shared_ptr<RtcStream>> &renditions)
+{
+	std::lock_guard<std::shared_mutex> lock(_rendition_mutex);
+	_renditions = renditions;
+}
+
+std::vector<std::shared_ptr<RtcStream>> RtcStream::GetRenditions()
+{
+	std::shared_lock<std::shared_mutex> lock(_rendition_mutex);
+	return _renditions;
+}
+
+void RtcStream::AddRedSession()
+{
+	_red_session_count++;
+}
+
+void RtcStream::RemoveRedSession()
+{
+	_red_session_count--;
+}
+
+void RtcStream::UpdateVideoFractionLost(session_id_t session_id, uint8_t fraction_lost)
+{
+	auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	double loss = fraction_lost / 256.0;
+
+	std::lock_guard<std::mutex> lock(_fraction_lost_mutex);
+
+	auto item = _fraction_losts.find(session_id);
+
+	if(item == _fraction_losts.end())
+	{
+		_fraction_losts[session_id] = FractionLost{loss, now_ms};
+		return;
+	}
+
+	item->second.average = (item->second.average * 0.7) + (loss * 0.3);
+	item->second.updated_ms = now_ms;
+}
+
+void RtcStream::UpdateAudioFractionLost(session_id_t session_id, uint8_t fraction_lost)
+{
+	auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	double loss = fraction_lost / 256.0;
+
+	std::unique_lock<std::mutex> lock(_fraction_lost_mutex);
+
+	auto item = _audio_fraction_losts.find(session_id);
+
+	if(item == _audio_fraction_losts.end())
+	{
+		_audio_fraction_losts[session_id] = FractionLost{loss, now_ms};
+	}
+	else
+	{
+		item->second.average = (item->second.average * 0.7) + (loss * 0.3);
+		item->second.updated_ms = now_ms;
+	}
+
+	if((now_ms - _last_audio_loss_report_ms) < RTC_AUDIO_LOSS_REPORT_INTERVAL_MS)
+	{
+		return;
+	}
+
+	_last_audio_loss_report_ms = now_ms;
+
+	double worst_loss = 0.0;
+
+	for(item = _audio_fraction_losts.begin(); item != _audio_fraction_losts.end();)
+	{
+		if((now_ms - item->second.updated_ms) > RTC_FEC_LOSS_REPORT_TIMEOUT_MS)
+		{
+			// The session is closed (or stopped sending RR)
+			item = _audio_fraction_losts.erase(item);
+			continue;
+		}
+
+		worst_loss = std::max(worst_loss, item->second.average);
+		++item;
+	}
+
+	auto loss_percentage = static_cast<int32_t>(std::round(worst_loss * 100.0));
+
+	if(loss_percentage == _last_audio_loss_percentage)
+	{
+		return;
+	}
+
+	_last_audio_loss_percentage = loss_percentage;
+
+	lock.unlock();
+
+	auto application = std::static_pointer_cast<pub::Application>(GetApplication());
+
+	// Nothing to do if the audio is not encoded by the transcoder (bypassed)
+	application->ReportPacketLoss(std::static_pointer_cast<info::Stream>(pub::Stream::GetSharedPtr()), loss_percentage);
+}
+
+void RtcStream::UpdateRedAndFec(const std::shared_ptr<RtpPacketizer> &packetizer)
+{
+	// The sessions of the other renditions may receive RED of this stream
+	bool is_red_required = _is_rendition_switching_enabled || (_red_session_count > 0);
+
+	packetizer->SetRedEnabled(is_red_required);
+
+	if((is_red_required == false) || (_is_adaptive_fec_enabled == false))
+	{
+		return;
+	}
+
+	auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	if((now_ms - _last_fec_update_ms) < RTC_FEC_UPDATE_INTERVAL_MS)
+	{
+		return;
+	}
+
+	_last_fec_update_ms = now_ms;
+
+	// -1.0: no session has reported yet
+	double worst_loss = -1.0;
+
+	{
+		std::lock_guard<std::mutex> lock(_fraction_lost_mutex);
+
+		for(auto item = _fraction_losts.begin(); item != _fraction_losts.end();)
+		{
+			if((now_ms - item->second.updated_ms) > RTC_FEC_LOSS_REPORT_TIMEOUT_MS)
+			{
+				// The session is closed (or stopped sending RR)
+				item = _fraction_losts.erase(item);
+				continue;
+			}
+
+			worst_loss = std::max(worst_loss, item->second.average);
+			++item;
+		}
+	}
+
+	uint32_t media_packets_per_fec;
+
+	if(worst_loss < 0.0)
+	{
+		media_packets_per_fec = ULPFEC_DEFAULT_MEDIA_PACKETS_PER_FEC;
+	}
+	else if(worst_loss < 0.01)
+	{
+		// Nobody is losing packets, NACK is enough
+		media_packets_per_fec = 0;
+	}
+	else if(worst_loss < 0.05)
+	{
+		media_packets_per_fec = ULPFEC_DEFAULT_MEDIA_PACKETS_PER_FEC;
+	}
+	else if(worst_loss < 0.1)
+	{
+		media_packets_per_fec = 5;
+	}
+	else
+	{
+		media_packets_per_fec = 3;
+	}
+
+	packetizer->SetUlpfecProtectionRate(media_packets_per_fec);
+}
+
+void RtcStream::AddRenditionSubscriber()
+{
+	_rendition_subscriber_count++;
+}
+
+void RtcStream::RemoveRenditionSubscriber()
+{
+	_rendition_subscriber_count--;
 }
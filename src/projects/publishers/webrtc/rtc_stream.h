@@ -1,58 +1,216 @@
-#pragma once
-
-#include <base/ovcrypto/certificate.h>
-#include <base/common_types.h>
-#include <base/info/stream.h>
-#include <base/publisher/stream.h>
-#include "modules/ice/ice_port.h"
-#include "modules/sdp/session_description.h"
-#include "modules/rtp_rtcp/rtp_rtcp_defines.h"
-#include "monitoring/monitoring.h"
-#include "rtc_session.h"
-
-#define PAYLOAD_TYPE_OFFSET		100
-#define RED_PAYLOAD_TYPE		123
-#define	ULPFEC_PAYLOAD_TYPE		124
-#define RTCP_PACKET_TYPE		125 // For internal use
-
-class RtcStream : public pub::Stream, public RtpRtcpPacketizerInterface
-{
-public:
-	static std::shared_ptr<RtcStream> Create(const std::shared_ptr<pub::Application> application,
-	                                         const info::Stream &info,
-	                                         uint32_t worker_count);
-	explicit RtcStream(const std::shared_ptr<pub::Application> application,
-	                   const info::Stream &info);
-	~RtcStream() final;
-
-	// SDP를 생성하고 관리한다.
-	std::shared_ptr<SessionDescription> GetSessionDescription();
-
-	void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
-	void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
-
-	// RTP Packetizer를 생성하여 추가한다.
-	void AddPacketizer(common::MediaCodecId codec_id, uint32_t id, uint8_t payload_type, uint32_t ssrc);
-	std::shared_ptr<RtpPacketizer> GetPacketizer(uint32_t id);
-
-	// RtpRtcpPacketizerInterface Implementation
-	bool OnRtpPacketized(std::shared_ptr<RtpPacket> packet) override;
-
-private:
-	bool Start(uint32_t worker_count) override;
-	bool Stop() override;
-
-	// WebRTC의 RTP 에서 사용하는 형태로 변환한다.
-	void MakeRtpVideoHeader(const CodecSpecificInfo *info, RTPVideoHeader *rtp_video_header);
-	uint16_t AllocateVP8PictureID();
-
-	// VP8 Picture ID
-	uint16_t _vp8_picture_id;
-	std::shared_ptr<SessionDescription> _offer_sdp;
-	std::shared_ptr<Certificate> _certificate;
-
-	// Packetizing을 위해 RtpSender를 이용한다.
-	std::map<uint32_t, std::shared_ptr<RtpPacketizer>> _packetizers;
-
-	std::shared_ptr<mon::StreamMetrics>		_stream_metrics;
+#pragma once
+
+#include <base/ovcrypto/certificate.h>
+#include <base/common_types.h>
+#include <base/info/stream.h>
+#include <base/publisher/stream.h>
+#include "modules/ice/ice_port.h"
+#include "modules/sdp/session_description.h"
+#include "modules/rtp_rtcp/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/rtp_history.h"
+#include "modules/dtls_srtp/sframe_encryptor.h"
+#include "monitoring/monitoring.h"
+#include "rtc_session.h"
+
+#define PAYLOAD_TYPE_OFFSET		100
+#define RED_PAYLOAD_TYPE		123
+#define	ULPFEC_PAYLOAD_TYPE		124
+#define RTCP_PACKET_TYPE		125 // For internal use
+
+// Flag of the packet type which is set to the first packet of a video key frame (in each sequence number space of RTP and RED)
+#define RTC_PACKET_TYPE_KEY_FRAME_START	(1 << 24)
+// Flag of the packet type of the RTCP SR template (the sessions fill in their own packet/octet counts, See RtpRtcp::SendSenderReport())
+#define RTC_PACKET_TYPE_SENDER_REPORT	(1 << 25)
+// The temporal layer of the video frame of the packet (2 bits, See <Encode><Video><TemporalLayers>)
+#define RTC_PACKET_TYPE_TEMPORAL_LAYER_SHIFT	26
+#define RTC_PACKET_TYPE_TEMPORAL_LAYER_MASK		(0x03 << RTC_PACKET_TYPE_TEMPORAL_LAYER_SHIFT)
+#define RTC_PACKET_TYPE_GET_TEMPORAL_LAYER(packet_type)	(((packet_type) & RTC_PACKET_TYPE_TEMPORAL_LAYER_MASK) >> RTC_PACKET_TYPE_TEMPORAL_LAYER_SHIFT)
+// SR is sent frequently for the first RTC_SENDER_REPORT_FAST_DURATION_MS so that the player can sync AV quickly
+#define RTC_SENDER_REPORT_FAST_INTERVAL_MS		500
+#define RTC_SENDER_REPORT_FAST_DURATION_MS		10000
+#define RTC_SENDER_REPORT_INTERVAL_MS			5000
+// The period of measuring the bitrate of the video
+#define RTC_VIDEO_BITRATE_MEASURE_INTERVAL_MS	1000
+// The protection rate of ULPFEC is evaluated at most once in this interval
+#define RTC_FEC_UPDATE_INTERVAL_MS				1000
+// The loss of a session is not considered if it has not sent RR during this time
+#define RTC_FEC_LOSS_REPORT_TIMEOUT_MS			10000
+// The loss of the audio is reported to the OPUS encoder at most once in this interval (See <Encode><Audio><InbandFEC>)
+#define RTC_AUDIO_LOSS_REPORT_INTERVAL_MS		1000
+
+class RtcStream : public pub::Stream, public RtpRtcpPacketizerInterface
+{
+public:
+	static std::shared_ptr<RtcStream> Create(const std::shared_ptr<pub::Application> application,
+	                                         const info::Stream &info,
+	                                         uint32_t worker_count);
+	explicit RtcStream(const std::shared_ptr<pub::Application> application,
+	                   const info::Stream &info);
+	~RtcStream() final;
+
+	// SDP를 생성하고 관리한다.
+	std::shared_ptr<SessionDescription> GetSessionDescription();
+
+	void SendVideoFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+	void SendAudioFrame(const std::shared_ptr<MediaPacket> &media_packet) override;
+
+	// RTP Packetizer를 생성하여 추가한다.
+	void AddPacketizer(common::MediaCodecId codec_id, uint32_t id, uint8_t payload_type, uint32_t ssrc);
+	std::shared_ptr<RtpPacketizer> GetPacketizer(uint32_t id);
+
+	// Only the tracks offered in the SDP (which have a packetizer) are delivered
+	bool IsTrackSubscribed(const std::shared_ptr<MediaTrack> &track) override;
+
+	// Returns the recently packetized packets of the ssrc for the retransmission (NACK).
+	// The RED packets have their own sequence numbers, so they are kept in a separate history.
+	std::shared_ptr<RtpHistory> GetRtpHistory(uint32_t ssrc, bool is_red);
+
+	// Called when a session receives PLI/FIR. The requests of all sessions are coalesced,
+	// and a key frame is requested to the upstream at most once in <KeyFrameRequestInterval>.
+	void RequestKeyFrame(uint32_t media_ssrc);
+
+	uint32_t GetVideoSsrc() const;
+	uint32_t GetAudioSsrc() const;
+	uint8_t GetVideoPayloadType() const;
+	common::MediaCodecId GetVideoCodecId() const;
+	// Measured bitrate of the video RTP packets (bps, 0 if not measured yet)
+	uint32_t GetVideoBitrate() const;
+
+	// Rendition switching
+	bool IsRenditionSwitchingEnabled() const;
+	// The other streams transcoded from the same input stream (managed by RtcApplication)
+	void SetRenditions(const std::vector<std::shared_ptr<RtcStream>> &renditions);
+	std::vector<std::shared_ptr<RtcStream>> GetRenditions();
+	// The video packets of the other renditions are forwarded to this stream only while some sessions need them
+	void AddRenditionSubscriber();
+	void RemoveRenditionSubscriber();
+
+	bool IsPacingEnabled() const;
+	// Called by the sessions periodically with the average queue delay of their pacers
+	void UpdatePacingQueueDelay(double queue_delay_ms);
+
+	// RED/ULPFEC
+	// The RED packets are generated only while some sessions receive them
+	void AddRedSession();
+	void RemoveRedSession();
+	// Called by the sessions receiving RED when RR of the video is received,
+	// the protection rate of ULPFEC follows the worst loss of them
+	void UpdateVideoFractionLost(session_id_t session_id, uint8_t fraction_lost);
+	// Called by the sessions when RR of the audio is received,
+	// the worst loss of them is reported to the encoder of the audio (the in-band FEC of OPUS)
+	void UpdateAudioFractionLost(session_id_t session_id, uint8_t fraction_lost);
+
+	// Called by the sessions to collect the handshake latency
+	void OnDtlsHandshakeCompleted(int64_t latency_ms, bool is_resumed);
+	// Called by the sessions with the bytes they have actually sent
+	void OnSessionBytesSent(uint64_t bytes);
+
+	// Slow consumers (See RtcSession::CheckHealth())
+	int32_t GetSlowConsumerQueueDelayMs() const;
+	// %
+	int32_t GetSlowConsumerLoss() const;
+	// 0: the slow consumers are not handled
+	int64_t GetSlowConsumerTimeoutMs() const;
+	// Disconnects the session which could not catch up
+	void OnSessionFallingBehind(const std::shared_ptr<pub::Session> &session) override;
+
+	// Returns nullptr if the frames are not encrypted end-to-end
+	std::shared_ptr<SFrameEncryptor> GetFrameEncryptor() const;
+
+	// RtpRtcpPacketizerInterface Implementation
+	bool OnRtpPacketized(std::shared_ptr<RtpPacket> packet) override;
+
+private:
+	bool Start(uint32_t worker_count) override;
+	bool Stop() override;
+
+	// WebRTC의 RTP 에서 사용하는 형태로 변환한다.
+	void MakeRtpVideoHeader(const CodecSpecificInfo *info, RTPVideoHeader *rtp_video_header);
+	uint16_t AllocateVP8PictureID();
+	void MeasureVideoBitrate(size_t bytes);
+	void CreateFrameEncryptor();
+	// Called by the packetizer thread before a video frame is packetized
+	void UpdateRedAndFec(const std::shared_ptr<RtpPacketizer> &packetizer);
+	// Called by the timer of RtcApplication, broadcasts the SR templates of the ssrcs
+	void SendSenderReports();
+
+	// VP8 Picture ID
+	uint16_t _vp8_picture_id;
+	// TL0PICIDX of VP8, increased at each frame of the base layer (used once the encoder sends the temporal layers)
+	uint8_t _vp8_tl0_pic_idx = 0;
+	bool _has_temporal_layers = false;
+	// The temporal layer of the video frame being packetized (added to the packet type in OnRtpPacketized())
+	uint8_t _temporal_layer = 0;
+	std::shared_ptr<SessionDescription> _offer_sdp;
+	std::shared_ptr<Certificate> _certificate;
+
+	// Packetizing을 위해 RtpSender를 이용한다.
+	std::map<uint32_t, std::shared_ptr<RtpPacketizer>> _packetizers;
+	// _packetizers indexed by the track ID (See info::MaxIndexedTrackId), looked up for every frame
+	std::vector<std::shared_ptr<RtpPacketizer>> _packetizer_table;
+
+	// [ssrc << 1 | is_red, history] (created by AddPacketizer(), and not changed after the stream is started)
+	std::map<uint64_t, std::shared_ptr<RtpHistory>> _rtp_histories;
+
+	// The ssrc of the video (only the video key frames are requested)
+	uint32_t _video_ssrc = 0;
+	uint32_t _audio_ssrc = 0;
+	uint8_t _video_payload_type = 0;
+	common::MediaCodecId _video_codec_id = common::MediaCodecId::None;
+
+	// RTCP SR (the RTP timestamp of the SR is extrapolated from the last packet of the ssrc)
+	struct SenderReportSource
+	{
+		uint32_t clock_rate = 0;
+		bool has_packet = false;
+		uint32_t last_timestamp = 0;
+		int64_t last_packetized_ms = 0;
+	};
+	std::mutex _sender_report_mutex;
+	// key: ssrc (registered by AddPacketizer())
+	std::map<uint32_t, SenderReportSource> _sender_report_sources;
+	ov::TimerHandle _sender_report_timer = 0;
+	int64_t _sender_report_started_ms = 0;
+	int64_t _last_sender_report_ms = 0;
+
+	// Bit 0: RTP, Bit 1: RED - set when a key frame is packetized, and cleared when its first packet is broadcasted
+	uint8_t _key_frame_start_flags = 0;
+
+	// Video bitrate measurement (updated by the packetizer thread)
+	int64_t _video_bitrate_measure_start_ms = 0;
+	size_t _video_bitrate_measure_bytes = 0;
+	std::atomic<uint32_t> _video_bitrate{0};
+
+	bool _is_rendition_switching_enabled = false;
+	bool _is_pacing_enabled = true;
+
+	bool _is_adaptive_fec_enabled = true;
+	std::atomic<int32_t> _red_session_count{0};
+	struct FractionLost
+	{
+		// Moving average (0.0~1.0)
+		double average = 0.0;
+		int64_t updated_ms = 0;
+	};
+	std::mutex _fraction_lost_mutex;
+	std::map<session_id_t, FractionLost> _fraction_losts;
+	int64_t _last_fec_update_ms = 0;
+	std::map<session_id_t, FractionLost> _audio_fraction_losts;
+	int64_t _last_audio_loss_report_ms = 0;
+	// -1: not reported yet
+	int32_t _last_audio_loss_percentage = -1;
+
+	// All frames (video and audio) are encrypted once for all sessions if SFrame is enabled
+	std::shared_ptr<SFrameEncryptor> _frame_encryptor;
+	std::shared_mutex _rendition_mutex;
+	std::vector<std::shared_ptr<RtcStream>> _renditions;
+	std::atomic<int32_t> _rendition_subscriber_count{0};
+	int64_t _key_frame_request_interval_ms = 0;
+	std::atomic<int64_t> _last_key_frame_request_ms{0};
+
+	int32_t _slow_consumer_queue_delay_ms = 2000;
+	int32_t _slow_consumer_loss = 30;
+	int64_t _slow_consumer_timeout_ms = 5000;
+
+	std::shared_ptr<mon::StreamMetrics>		_stream_metrics;
 };
\ No newline at end of file
@@ -0,0 +1,126 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "rtc_private.h"
+#include "rtc_temporal_layer_filter.h"
+#include "rtc_stream.h"
+
+#include <chrono>
+
+RtcTemporalLayerFilter::RtcTemporalLayerFilter()
+	: _items(RTC_TEMPORAL_LAYER_HISTORY_SIZE),
+	  _output_items(RTC_TEMPORAL_LAYER_HISTORY_SIZE)
+{
+	_last_selection_ms = GetNowMs();
+}
+
+int64_t RtcTemporalLayerFilter::GetNowMs()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool RtcTemporalLayerFilter::IsSelectionRequired() const
+{
+	return (GetNowMs() - _last_selection_ms) >= RTC_TEMPORAL_LAYER_SELECT_INTERVAL_MS;
+}
+
+void RtcTemporalLayerFilter::Select(uint32_t estimated_bitrate, uint32_t stream_bitrate, uint8_t fraction_lost)
+{
+	auto now_ms = GetNowMs();
+	_last_selection_ms = now_ms;
+
+	bool is_bandwidth_known = (estimated_bitrate > 0) && (stream_bitrate > 0);
+	bool is_congested = (fraction_lost >= RTC_TEMPORAL_LAYER_DOWN_FRACTION_LOST) ||
+						(is_bandwidth_known && (estimated_bitrate < stream_bitrate));
+
+	if (is_congested)
+	{
+		if (_target_max_layer > 0)
+		{
+			// The frames of the dropped layer are not encoded again, so the bitrate is lowered from the next frame
+			_target_max_layer--;
+			_last_down_switch_ms = now_ms;
+
+			logtd("Temporal layers above %u are dropped (estimated: %u bps, stream: %u bps, fraction lost: %u/256)", _target_max_layer, estimated_bitrate, stream_bitrate, fraction_lost);
+		}
+
+		return;
+	}
+
+	if ((_target_max_layer < RTC_TEMPORAL_LAYER_MAX_INDEX) &&
+		((now_ms - _last_down_switch_ms) >= RTC_TEMPORAL_LAYER_UP_SWITCH_INTERVAL_MS) &&
+		(fraction_lost < RTC_TEMPORAL_LAYER_UP_FRACTION_LOST) &&
+		((is_bandwidth_known == false) || (stream_bitrate <= (estimated_bitrate * RTC_TEMPORAL_LAYER_UP_SWITCH_HEADROOM))))
+	{
+		_target_max_layer++;
+
+		logtd("Temporal layer %u is resumed (estimated: %u bps, stream: %u bps, fraction lost: %u/256)", _target_max_layer, estimated_bitrate, stream_bitrate, fraction_lost);
+	}
+}
+
+bool RtcTemporalLayerFilter::Process(uint32_t packet_type, uint16_t sequence_number, uint32_t timestamp, uint16_t *output_sequence_number)
+{
+	auto &item = _items[sequence_number & (RTC_TEMPORAL_LAYER_HISTORY_SIZE - 1)];
+
+	if (_has_last_packet && (static_cast<int16_t>(sequence_number - _last_sequence_number) <= 0))
+	{
+		// Retransmission, sent as it was decided
+		if ((item.is_valid == false) || (item.sequence_number != sequence_number) || item.is_dropped)
+		{
+			return false;
+		}
+
+		*output_sequence_number = item.output_sequence_number;
+		return true;
+	}
+
+	if ((_has_last_packet == false) || (timestamp != _last_timestamp))
+	{
+		// The first packet of a frame
+		_max_layer = _target_max_layer;
+		_is_dropping_frame = (RTC_PACKET_TYPE_GET_TEMPORAL_LAYER(packet_type) > _max_layer);
+	}
+
+	_has_last_packet = true;
+	_last_sequence_number = sequence_number;
+	_last_timestamp = timestamp;
+
+	item.is_valid = true;
+	item.sequence_number = sequence_number;
+	item.is_dropped = _is_dropping_frame;
+
+	if (_is_dropping_frame)
+	{
+		_dropped_count++;
+		return false;
+	}
+
+	*output_sequence_number = static_cast<uint16_t>(sequence_number - _dropped_count);
+	item.output_sequence_number = *output_sequence_number;
+
+	auto &output_item = _output_items[*output_sequence_number & (RTC_TEMPORAL_LAYER_HISTORY_SIZE - 1)];
+
+	output_item.is_valid = true;
+	output_item.sequence_number = sequence_number;
+	output_item.output_sequence_number = *output_sequence_number;
+
+	return true;
+}
+
+bool RtcTemporalLayerFilter::FindSourceSequenceNumber(uint16_t output_sequence_number, uint16_t *sequence_number) const
+{
+	auto &output_item = _output_items[output_sequence_number & (RTC_TEMPORAL_LAYER_HISTORY_SIZE - 1)];
+
+	if ((output_item.is_valid == false) || (output_item.output_sequence_number != output_sequence_number))
+	{
+		return false;
+	}
+
+	*sequence_number = output_item.sequence_number;
+	return true;
+}
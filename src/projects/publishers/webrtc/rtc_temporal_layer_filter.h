@@ -0,0 +1,97 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// The highest temporal layer index of the encoders (VP8_MAX_TEMPORAL_LAYERS - 1)
+#define RTC_TEMPORAL_LAYER_MAX_INDEX 2
+// The layers are evaluated at most once in this interval
+#define RTC_TEMPORAL_LAYER_SELECT_INTERVAL_MS 1000
+// Minimum interval from the last drop to the resumption of a layer, to avoid the oscillation
+#define RTC_TEMPORAL_LAYER_UP_SWITCH_INTERVAL_MS 5000
+// A layer is dropped if the fraction lost of RR is higher than this (26/256 = about 10%)
+#define RTC_TEMPORAL_LAYER_DOWN_FRACTION_LOST 26
+// A layer is resumed only if the fraction lost of RR is lower than this (5/256 = about 2%)
+#define RTC_TEMPORAL_LAYER_UP_FRACTION_LOST 5
+// A layer is resumed only if the stream uses less than this ratio of the estimated bandwidth
+#define RTC_TEMPORAL_LAYER_UP_SWITCH_HEADROOM 0.85
+// The number of the recent sequence numbers that can be mapped for the retransmission (power of 2)
+#define RTC_TEMPORAL_LAYER_HISTORY_SIZE 1024
+
+// Drops the upper temporal layers of the VP8 video for a congested session (See <Encode><Video><TemporalLayers>)
+//
+// The player gets a lower framerate from the same encode, instead of the loss of the packets.
+// The sequence numbers after the dropped packets are rewritten, so the player doesn't see the dropped packets as lost.
+// The layer is changed only at the first packet of a frame, and the frames of the upper layers refer only the base layer,
+// so a layer can be resumed from any of its frames.
+//
+// It is not thread-safe, RtcSession calls it with its send lock.
+class RtcTemporalLayerFilter
+{
+public:
+	RtcTemporalLayerFilter();
+
+	bool IsSelectionRequired() const;
+	// estimated_bitrate: bps (0 if the bandwidth is not estimated)
+	// stream_bitrate: bps of the video with all layers
+	// fraction_lost: the fraction lost of the last RR of the video (x/256)
+	void Select(uint32_t estimated_bitrate, uint32_t stream_bitrate, uint8_t fraction_lost);
+
+	// sequence_number/timestamp: the video packet to be sent (after the rendition switcher rewrites it)
+	// Returns false if the packet must not be sent to the session, otherwise *output_sequence_number is the sequence number to send
+	bool Process(uint32_t packet_type, uint16_t sequence_number, uint32_t timestamp, uint16_t *output_sequence_number);
+
+	// Whether the sequence numbers are rewritten (a packet is dropped at least once)
+	bool IsRewriting() const
+	{
+		return _dropped_count > 0;
+	}
+
+	// Finds the sequence number of the packet before rewriting for the retransmission
+	bool FindSourceSequenceNumber(uint16_t output_sequence_number, uint16_t *sequence_number) const;
+
+	uint8_t GetMaxLayer() const
+	{
+		return _max_layer;
+	}
+
+private:
+	static int64_t GetNowMs();
+
+	struct Item
+	{
+		bool is_valid = false;
+		bool is_dropped = false;
+		uint16_t sequence_number = 0;
+		// The rewritten sequence number (if not dropped)
+		uint16_t output_sequence_number = 0;
+	};
+
+	// The layers above this are dropped (applied from the next frame)
+	uint8_t _target_max_layer = RTC_TEMPORAL_LAYER_MAX_INDEX;
+	// The layers above this are dropped in the current frame
+	uint8_t _max_layer = RTC_TEMPORAL_LAYER_MAX_INDEX;
+
+	bool _has_last_packet = false;
+	uint16_t _last_sequence_number = 0;
+	uint32_t _last_timestamp = 0;
+	bool _is_dropping_frame = false;
+
+	// The number of dropped packets (the offset of the sequence numbers)
+	uint16_t _dropped_count = 0;
+
+	// Indexed by the sequence number (and by the output sequence number for the reverse lookup)
+	std::vector<Item> _items;
+	std::vector<Item> _output_items;
+
+	int64_t _last_selection_ms = 0;
+	int64_t _last_down_switch_ms = 0;
+};
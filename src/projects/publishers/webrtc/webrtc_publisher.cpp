@@ -63,7 +63,9 @@ bool WebRtcPublisher::Start()
 	// Initialize RtcSignallingServer
 	_signalling_server = std::make_shared<RtcSignallingServer>(server_config);
 	_signalling_server->AddObserver(RtcSignallingObserver::GetSharedPtr());
-	if (_signalling_server->Start(has_port ? &signalling_address : nullptr, has_tls_port ? &signalling_tls_address : nullptr) == false)
+	auto signalling_port = webrtc_port_info.GetSignalling();
+	if (_signalling_server->Start(has_port ? &signalling_address : nullptr, has_tls_port ? &signalling_tls_address : nullptr,
+								  signalling_port.GetReactorCount(), signalling_port.GetWorkerCount(), signalling_port.GetWorkerAffinity()) == false)
 	{
 		return false;
 	}
@@ -237,9 +239,34 @@ bool WebRtcPublisher::OnDeletePublisherApplication(const std::shared_ptr<pub::Ap
  * Signalling Implementation
  */
 
+// Called before OnRequestOffer()
+bool WebRtcPublisher::OnPrepareStream(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, const std::function<void()> &on_prepared)
+{
+	if (GetStream(application_name, stream_name) != nullptr)
+	{
+		return true;
+	}
+
+	// The stream is pulled in the background (shared with the other players of the stream),
+	// and OnRequestOffer() is called when it is completed. The failure is handled by OnRequestOffer() with the cached result of the pull
+	Orchestrator::GetInstance()->RequestPullStreamAsync(application_name, stream_name, 0, [on_prepared](bool result) {
+		on_prepared();
+	});
+
+	return false;
+}
+
 // Called when receives request offer sdp from client
 std::shared_ptr<SessionDescription> WebRtcPublisher::OnRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, std::vector<RtcIceCandidate> *ice_candidates)
 {
+	ov::String overload_reason;
+
+	if (MonitorInstance->GetResourceMetrics().IsOverloaded(&overload_reason))
+	{
+		logtw("Rejected the offer request of %s/%s (overloaded: %s)", application_name.CStr(), stream_name.CStr(), overload_reason.CStr());
+		return nullptr;
+	}
+
 	// Application -> Stream에서 SDP를 얻어서 반환한다.
 	auto orchestrator = Orchestrator::GetInstance();
 	RequestStreamResult result = RequestStreamResult::init;
@@ -281,13 +308,8 @@ std::shared_ptr<SessionDescription> WebRtcPublisher::OnRequestOffer(const std::s
 
 	auto &candidates = _ice_port->GetIceCandidateList();
 	ice_candidates->insert(ice_candidates->end(), candidates.cbegin(), candidates.cend());
-	auto session_description = std::make_shared<SessionDescription>(*stream->GetSessionDescription());
-	// Generate Unique Session Id
-	session_description->SetOrigin("OvenMediaEngine", ++_last_issued_session_id, 2, "IN", 4, "127.0.0.1");
-	session_description->SetIceUfrag(_ice_port->GenerateUfrag());
-	session_description->Update();
-
-	return session_description;
+	// Generate Unique Session Id, and patch the pre-rendered SDP of the stream
+	return stream->GetSessionDescription()->CreateOffer(++_last_issued_session_id, _ice_port->GenerateUfrag());
 }
 
 // Called when receives an answer sdp from client
@@ -400,12 +422,35 @@ uint32_t WebRtcPublisher::OnGetBitrate(const std::shared_ptr<WebSocketClient> &w
 	return bitrate;
 }
 
+bool WebRtcPublisher::OnGetFrameEncryptionKey(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, uint64_t *key_id, std::shared_ptr<const ov::Data> *key)
+{
+	auto stream = std::static_pointer_cast<RtcStream>(GetStream(application_name, stream_name));
+
+	if (stream == nullptr)
+	{
+		return false;
+	}
+
+	auto frame_encryptor = stream->GetFrameEncryptor();
+
+	if (frame_encryptor == nullptr)
+	{
+		return false;
+	}
+
+	*key_id = frame_encryptor->GetKeyId();
+	*key = frame_encryptor->GetBaseKey();
+
+	return true;
+}
+
 bool WebRtcPublisher::OnIceCandidate(const std::shared_ptr<WebSocketClient> &ws_client,
 									 const ov::String &application_name,
 									 const ov::String &stream_name,
 									 const std::shared_ptr<RtcIceCandidate> &candidate,
 									 const ov::String &username_fragment)
 {
+	// OME is an ICE-lite agent (See RtcStream::Start()), the addresses of the player are learned from its checks
 	return true;
 }
 
@@ -461,5 +506,17 @@ void WebRtcPublisher::OnDataReceived(IcePort &port, const std::shared_ptr<info::
 
 	//받는 Data 형식을 협의해야 한다.
 	auto application = session->GetApplication();
+
+	// DTLS (RFC 7983: 20~63) is processed by the DTLS workers, so the handshakes don't delay the application thread
+	auto buffer = data->GetDataAs<uint8_t>();
+
+	if((data->GetLength() > 0) && (buffer[0] >= 20) && (buffer[0] <= 63))
+	{
+		if(std::static_pointer_cast<RtcApplication>(application)->PushDtlsPacket(session_info, data))
+		{
+			return;
+		}
+	}
+
 	application->PushIncomingPacket(session_info, data);
 }
@@ -27,6 +27,8 @@ public:
 	void OnDataReceived(IcePort &port, const std::shared_ptr<info::Session> &session, std::shared_ptr<const ov::Data> data) override;
 
 	// SignallingObserver Implementation
+	// Pulls the stream asynchronously if it does not exist
+	bool OnPrepareStream(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, const std::function<void()> &on_prepared) override;
 	// 클라이언트가 Request Offer를 하면 다음 함수를 통해 SDP를 받아서 넘겨준다.
 	std::shared_ptr<SessionDescription> OnRequestOffer(const std::shared_ptr<WebSocketClient> &ws_client,
 													   const ov::String &application_name,
@@ -59,6 +61,8 @@ public:
 
     uint32_t OnGetBitrate(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name) override;
 
+	bool OnGetFrameEncryptionKey(const std::shared_ptr<WebSocketClient> &ws_client, const ov::String &application_name, const ov::String &stream_name, uint64_t *key_id, std::shared_ptr<const ov::Data> *key) override;
+
     bool GetMonitoringCollectionData(std::vector<std::shared_ptr<pub::MonitoringCollectionData>> &collections) override;
 
 private:
@@ -8,6 +8,7 @@
 //==============================================================================
 #include "transcode_codec_dec_aac.h"
 #include "base/info/application.h"
+#include "transcode_frame_helper.h"
 
 #define OV_LOG_TAG "TranscodeCodec"
 
@@ -76,6 +77,8 @@ std::shared_ptr<MediaFrame> OvenCodecImplAvcodecDecAAC::RecvBuffer(TranscodeResu
 		output_frame->SetDuration(frame_duration_in_timebase);
 
 		auto data_length = static_cast<uint32_t>(output_frame->GetBytesPerSample() * output_frame->GetNbSamples());
+		// The planes are taken from the frame pool of the stream instead of allocating them every frame
+		auto frame_pool = _input_context->GetFramePool();
 
 		// Copy frame data into out_buf
 		if (TranscodeBase::IsPlanar(output_frame->GetFormat<AVSampleFormat>()))
@@ -83,15 +86,13 @@ std::shared_ptr<MediaFrame> OvenCodecImplAvcodecDecAAC::RecvBuffer(TranscodeResu
 			// If the frame is planar, the data is stored separately in the "_frame->data" array.
 			for (int channel = 0; channel < _frame->channels; channel++)
 			{
-				output_frame->Resize(data_length, channel);
-				uint8_t *output = output_frame->GetWritableBuffer(channel);
-				::memcpy(output, _frame->data[channel], data_length);
+				TranscodeFrameHelper::CopyPlane(frame_pool, output_frame.get(), channel, _frame->data[channel], data_length);
 			}
 		}
 		else
 		{
 			// If the frame is non-planar, it means interleaved data. So, just copy from "_frame->data[0]" into the output_frame
-			output_frame->AppendBuffer(_frame->data[0], data_length * _frame->channels, 0);
+			TranscodeFrameHelper::CopyPlane(frame_pool, output_frame.get(), 0, _frame->data[0], data_length * _frame->channels);
 		}
 
 		::av_frame_unref(_frame);
@@ -49,6 +49,12 @@ std::shared_ptr<MediaFrame> OvenCodecImplAvcodecDecAVC::RecvBuffer(TranscodeResu
 
 				_change_format = true;
 
+				if (_frame->hw_frames_ctx != nullptr)
+				{
+					// The filters need the frames context to process the frames on the device
+					_input_context->SetHWFramesContext(TranscodeHWAccelHelper::RefBuffer(_frame->hw_frames_ctx));
+				}
+
 				// If the format is changed, notify to another module
 				need_to_change_notify = true;
 			}
@@ -72,13 +78,14 @@ std::shared_ptr<MediaFrame> OvenCodecImplAvcodecDecAVC::RecvBuffer(TranscodeResu
 		int64_t duration = (den == 0) ? 0LL : (float)den / _input_context->GetFrameRate();
 		decoded_frame->SetDuration(duration);
 
-		decoded_frame->SetStride(_frame->linesize[0], 0);
-		decoded_frame->SetStride(_frame->linesize[1], 1);
-		decoded_frame->SetStride(_frame->linesize[2], 2);
+		// The filters refer the buffers of the decoder (or the surface on the device) instead of copying the planes
+		if (TranscodeFrameHelper::AttachVideoFrame(decoded_frame.get(), _frame) == false)
+		{
+			::av_frame_unref(_frame);
 
-		decoded_frame->SetBuffer(_frame->data[0], decoded_frame->GetStride(0) * decoded_frame->GetHeight(), 0);		 // Y-Plane
-		decoded_frame->SetBuffer(_frame->data[1], decoded_frame->GetStride(1) * decoded_frame->GetHeight() / 2, 1);  // Cb Plane
-		decoded_frame->SetBuffer(_frame->data[2], decoded_frame->GetStride(2) * decoded_frame->GetHeight() / 2, 2);  // Cr Plane
+			*result = TranscodeResult::DataError;
+			return nullptr;
+		}
 
 		::av_frame_unref(_frame);
 
@@ -61,6 +61,12 @@ bool OvenCodecImplAvcodecEncAAC::Configure(std::shared_ptr<TranscodeContext> out
 		return false;
 	}
 
+	if (output_context->IsInlineProcessing())
+	{
+		// The frames are encoded in SendBuffer()
+		return true;
+	}
+
 	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
 	try
 	{
@@ -94,9 +100,15 @@ void OvenCodecImplAvcodecEncAAC::Stop()
 
 void OvenCodecImplAvcodecEncAAC::ThreadEncode()
 {
+	ov::ThreadMetrics thread_metrics("EncAAC", ov::ThreadClass::Encode);
+
 	while (!_kill_flag)
 	{
+		thread_metrics.BeginIdle();
 		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
 
 		std::unique_lock<std::mutex> mlock(_mutex);
 
@@ -111,95 +123,107 @@ void OvenCodecImplAvcodecEncAAC::ThreadEncode()
 
 		mlock.unlock();
 
-		///////////////////////////////////////////////////
-		// Request frame encoding to codec
-		///////////////////////////////////////////////////
+		if (EncodeInputFrame(std::move(buffer)) == false)
+		{
+			break;
+		}
+	}
+}
 
-		const MediaFrame *frame = buffer.get();
+bool OvenCodecImplAvcodecEncAAC::EncodeInputFrame(std::shared_ptr<const MediaFrame> buffer)
+{
+	///////////////////////////////////////////////////
+	// Request frame encoding to codec
+	///////////////////////////////////////////////////
 
-		// logte("DECODE:: %lld %lld", frame->GetPts(), frame->GetPts() * 1000);
+	const MediaFrame *frame = buffer.get();
 
-		_frame->format = _context->sample_fmt;
-		_frame->nb_samples = _context->frame_size;
-		_frame->pts = frame->GetPts() * 1000;
-		_frame->pkt_duration = frame->GetDuration();
+	// logte("DECODE:: %lld %lld", frame->GetPts(), frame->GetPts() * 1000);
 
-		_frame->channel_layout = _context->channel_layout;
-		_frame->channels = _context->channels;
-		_frame->sample_rate = _context->sample_rate;
+	_frame->format = _context->sample_fmt;
+	_frame->nb_samples = _context->frame_size;
+	_frame->pts = frame->GetPts() * 1000;
+	_frame->pkt_duration = frame->GetDuration();
 
-		if (::av_frame_get_buffer(_frame, 0) < 0)
-		{
-			logte("Could not allocate the audio frame data");
-			break;
-		}
+	_frame->channel_layout = _context->channel_layout;
+	_frame->channels = _context->channels;
+	_frame->sample_rate = _context->sample_rate;
 
-		if (::av_frame_make_writable(_frame) < 0)
-		{
-			logte("Could not make sure the frame data is writable");
-			// *result = TranscodeResult::DataError;
-			break;
-		}
+	if (::av_frame_get_buffer(_frame, 0) < 0)
+	{
+		logte("Could not allocate the audio frame data");
+		return false;
+	}
 
-		::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+	if (::av_frame_make_writable(_frame) < 0)
+	{
+		logte("Could not make sure the frame data is writable");
+		// *result = TranscodeResult::DataError;
+		return false;
+	}
 
-		int ret = ::avcodec_send_frame(_context, _frame);
+	::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
 
-		::av_frame_unref(_frame);
+	int ret = ::avcodec_send_frame(_context, _frame);
 
-		if (ret < 0)
-		{
-			logte("Error sending a frame for encoding : %d", ret);
+	::av_frame_unref(_frame);
 
+	if (ret < 0)
+	{
+		logte("Error sending a frame for encoding : %d", ret);
+
+		if (_thread_work.joinable())
+		{
 			// Failure to send frame to encoder. Wait and put it back in. But it doesn't happen as often as possible.
 			std::unique_lock<std::mutex> mlock(_mutex);
 			_input_buffer.push_front(std::move(buffer));
 			mlock.unlock();
 			_queue_event.Notify();
 		}
+	}
 
-		while (true)
+	while (true)
+	{
+		int ret = ::avcodec_receive_packet(_context, _packet);
+
+		if (ret == AVERROR(EAGAIN))
 		{
-			int ret = ::avcodec_receive_packet(_context, _packet);
-
-			if (ret == AVERROR(EAGAIN))
-			{
-				// Wait for more packet
-				break;
-			}
-			else if (ret == AVERROR_EOF)
-			{
-				logte("Error receiving a packet for decoding : AVERROR_EOF");
-
-				// *result = TranscodeResult::DataError;
-				// return nullptr;
-				break;
-			}
-			else if (ret < 0)
-			{
-				logte("Error receiving a packet for encoding : %d", ret);
-
-				// *result = TranscodeResult::DataError;
-				// return nullptr;
-				break;
-			}
-			else
-			{
-				// Packet is ready
-				auto packet_buffer = std::make_shared<MediaPacket>(common::MediaType::Audio, 1, _packet->data, _packet->size, _packet->pts / 1000, _packet->dts / 1000, _packet->duration, MediaPacketFlag::Key);
-
-				// logte("ENCODED:: %lld, %lld", packet_buffer->GetPts(), _packet->pts);
-				::av_packet_unref(_packet);
-
-				std::unique_lock<std::mutex> mlock(_mutex);
-
-				_output_buffer.push_back(std::move(packet_buffer));
-
-				mlock.unlock();
-			}
+			// Wait for more packet
+			break;
 		}
+		else if (ret == AVERROR_EOF)
+		{
+			logte("Error receiving a packet for decoding : AVERROR_EOF");
 
+			// *result = TranscodeResult::DataError;
+			// return nullptr;
+			break;
+		}
+		else if (ret < 0)
+		{
+			logte("Error receiving a packet for encoding : %d", ret);
+
+			// *result = TranscodeResult::DataError;
+			// return nullptr;
+			break;
+		}
+		else
+		{
+			// Packet is ready
+			auto packet_buffer = std::make_shared<MediaPacket>(common::MediaType::Audio, 1, GetPacketData(), _packet->pts / 1000, _packet->dts / 1000, _packet->duration, MediaPacketFlag::Key);
+
+			// logte("ENCODED:: %lld, %lld", packet_buffer->GetPts(), _packet->pts);
+			::av_packet_unref(_packet);
+
+			std::unique_lock<std::mutex> mlock(_mutex);
+
+			_output_buffer.push_back(std::move(packet_buffer));
+
+			mlock.unlock();
+		}
 	}
+
+	return true;
 }
 
 std::shared_ptr<MediaPacket> OvenCodecImplAvcodecEncAAC::RecvBuffer(TranscodeResult *result)
@@ -27,4 +27,7 @@ public:
 	void ThreadEncode() override;
 
 	void Stop() override;	
+
+protected:
+	bool EncodeInputFrame(std::shared_ptr<const MediaFrame> buffer) override;
 };
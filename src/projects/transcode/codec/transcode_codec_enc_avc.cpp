@@ -10,6 +10,8 @@
 
 #include <unistd.h>
 
+#include "media_router/bitstream/avc_video_packet_fragmentizer.h"
+
 #define OV_LOG_TAG "TranscodeCodec"
 
 
@@ -31,15 +33,22 @@ bool OvenCodecImplAvcodecEncAVC::Configure(std::shared_ptr<TranscodeContext> con
 
 	auto codec_id = GetCodecID();
 
-	AVCodec *codec = ::avcodec_find_encoder(codec_id);
+	_codec = FindHWEncoder();
 
-	if (codec == nullptr)
+	if (_codec == nullptr)
+	{
+		_codec = const_cast<AVCodec *>(::avcodec_find_encoder(codec_id));
+	}
+
+	if (_codec == nullptr)
 	{
 		logte("Could not find encoder: %d (%s)", codec_id, ::avcodec_get_name(codec_id));
 		return false;
 	}
 
-	_context = ::avcodec_alloc_context3(codec);
+	auto hw_accel = _output_context->GetHWAccel();
+
+	_context = ::avcodec_alloc_context3(_codec);
 
 	if (_context == nullptr)
 	{
@@ -50,9 +59,19 @@ bool OvenCodecImplAvcodecEncAVC::Configure(std::shared_ptr<TranscodeContext> con
 	_context->framerate = ::av_d2q(_output_context->GetFrameRate(), AV_TIME_BASE);
 
 	_context->bit_rate = _output_context->GetBitrate();
-	_context->rc_min_rate = _context->bit_rate;
 	_context->rc_max_rate = _context->bit_rate;
-	_context->rc_buffer_size = static_cast<int>(_context->bit_rate / 2);
+
+	if (_output_context->GetRateControl().LowerCaseString() == "vbr")
+	{
+		// Let the bitrate of the simple scenes go down, and keep the peak under the bitrate
+		_context->rc_buffer_size = static_cast<int>(_context->bit_rate);
+	}
+	else
+	{
+		_context->rc_min_rate = _context->bit_rate;
+		_context->rc_buffer_size = static_cast<int>(_context->bit_rate / 2);
+	}
+
 	_context->sample_aspect_ratio = (AVRational){1, 1};
 
 	// From avcodec.h:
@@ -68,53 +87,177 @@ bool OvenCodecImplAvcodecEncAVC::Configure(std::shared_ptr<TranscodeContext> con
 	AVRational codec_timebase = ::av_inv_q(::av_mul_q(::av_d2q(_output_context->GetFrameRate(), AV_TIME_BASE), (AVRational){_context->ticks_per_frame, 1}));
 	_context->time_base = codec_timebase;
 
-	_context->gop_size = _context->framerate.num / _context->framerate.den;
+	_context->gop_size = _output_context->GetGOP();
 	_context->max_b_frames = 0;
-	_context->pix_fmt = AV_PIX_FMT_YUV420P;
+	_context->pix_fmt = (hw_accel != TranscodeHWAccel::None) ? TranscodeHWAccelHelper::GetPixelFormat(hw_accel) : AV_PIX_FMT_YUV420P;
 	_context->width = _output_context->GetVideoWidth();
 	_context->height = _output_context->GetVideoHeight();
-	_context->thread_count = 2;
+	_context->thread_count = GetThreadCount();
 	AVRational output_timebase = TimebaseToAVRational(_output_context->GetTimeBase());
 	_scale = ::av_q2d(::av_div_q(output_timebase, codec_timebase));
 	_scale_inv = ::av_q2d(::av_div_q(codec_timebase, output_timebase));
 
+	if (hw_accel != TranscodeHWAccel::None)
+	{
+		SetHWEncoderOptions(hw_accel);
+	}
+	else
+	{
+		if (SetX264Options() == false)
+		{
+			return false;
+		}
+	}
+
+	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
+	try
+	{
+		_kill_flag = false;
+
+		_thread_work = std::thread(&OvenCodecImplAvcodecEncAVC::ThreadEncode, this);
+	}
+	catch (const std::system_error &e)
+	{
+		_kill_flag = true;
+
+		logte("Failed to start transcode stream thread.");
+	}
+
+	return true;
+}
+
+AVCodec *OvenCodecImplAvcodecEncAVC::FindHWEncoder()
+{
+	auto hw_accel = _output_context->GetHWAccel();
+
+	if (hw_accel == TranscodeHWAccel::None)
+	{
+		return nullptr;
+	}
+
+	AVCodec *codec = nullptr;
+	auto encoder_name = TranscodeHWAccelHelper::GetEncoderName(hw_accel, GetCodecID());
+
+	if (TranscodeHWAccelHelper::GetDeviceContext(hw_accel) != nullptr)
+	{
+		codec = const_cast<AVCodec *>(::avcodec_find_encoder_by_name(encoder_name));
+
+		if (codec == nullptr)
+		{
+			logtw("Could not find the encoder: %s, libx264 will be used", encoder_name);
+		}
+	}
+
+	if (codec == nullptr)
+	{
+		_output_context->SetHWAccel(TranscodeHWAccel::None);
+	}
+
+	return codec;
+}
+
+void OvenCodecImplAvcodecEncAVC::SetHWEncoderOptions(TranscodeHWAccel hw_accel)
+{
+	// The hardware encoders put the SPS/PPS in front of each keyframe like libx264 (MakePacket() relies on it)
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			::av_opt_set(_context->priv_data, "preset", "llhp", 0);
+			::av_opt_set(_context->priv_data, "profile", "baseline", 0);
+			::av_opt_set(_context->priv_data, "rc", "cbr", 0);
+			::av_opt_set_int(_context->priv_data, "zerolatency", 1, 0);
+			::av_opt_set_int(_context->priv_data, "delay", 0, 0);
+			// AV_PICTURE_TYPE_I of RequestKeyFrame() makes an IDR frame
+			::av_opt_set_int(_context->priv_data, "forced-idr", 1, 0);
+			break;
+
+		case TranscodeHWAccel::Qsv:
+			_context->profile = FF_PROFILE_H264_BASELINE;
+			::av_opt_set(_context->priv_data, "preset", "veryfast", 0);
+			::av_opt_set_int(_context->priv_data, "look_ahead", 0, 0);
+			::av_opt_set_int(_context->priv_data, "async_depth", 1, 0);
+			break;
+
+		case TranscodeHWAccel::Vaapi:
+			// VA-API does not support the baseline profile
+			_context->profile = FF_PROFILE_H264_CONSTRAINED_BASELINE;
+			::av_opt_set(_context->priv_data, "rc_mode", "CBR", 0);
+			break;
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+}
+
+bool OvenCodecImplAvcodecEncAVC::OpenHWEncoder(const AVFrame *frame)
+{
+	if (_is_codec_opened)
+	{
+		return true;
+	}
+
+	_context->hw_frames_ctx = ::av_buffer_ref(frame->hw_frames_ctx);
+
+	if (::avcodec_open2(_context, _codec, nullptr) < 0)
+	{
+		logte("Could not open codec: %s (%d)", _codec->name, GetCodecID());
+		return false;
+	}
+
+	logti("%s encoder is opened (%dx%d, %lld bps)", _codec->name, _context->width, _context->height, static_cast<long long>(_context->bit_rate));
+
+	_is_codec_opened = true;
+
+	return true;
+}
+
+bool OvenCodecImplAvcodecEncAVC::SetX264Options()
+{
 	// 인코딩 품질 및 브라우저 호환성
 	// For browser compatibility
 	// _context->profile = FF_PROFILE_H264_MAIN;
 	_context->profile = FF_PROFILE_H264_BASELINE;
 
 	// 인코딩 성능
-	::av_opt_set(_context->priv_data, "preset", "ultrafast", 0);
+	::av_opt_set(_context->priv_data, "preset", _output_context->GetPreset().CStr(), 0);
+
+	// AV_PICTURE_TYPE_I of RequestKeyFrame() makes an IDR frame
+	::av_opt_set_int(_context->priv_data, "forced-idr", 1, 0);
 
 	// 인코딩 딜레이
-	::av_opt_set(_context->priv_data, "tune", "zerolatency", 0);
+	if (_output_context->GetTune().IsEmpty() == false)
+	{
+		::av_opt_set(_context->priv_data, "tune", _output_context->GetTune().CStr(), 0);
+	}
 
 	// 인코딩 딜레이에서 sliced-thread 옵션 제거. MAC 환경에서 브라우저 호환성
-	::av_opt_set(_context->priv_data, "x264opts", "bframes=0:sliced-threads=0:b-adapt=1:no-scenecut:keyint=30:min-keyint=30", 0);
-	// ::av_opt_set(_context->priv_data, "x264opts", "bframes=0:sliced-threads=0:b-adapt=1", 0);
+	// (x264opts is applied after the preset and the tune, so it overrides the values of them)
+	ov::String x264opts = "bframes=0:b-adapt=1:no-scenecut";
+
+	x264opts.AppendFormat(":sliced-threads=%d", _output_context->IsSliceThreads() ? 1 : 0);
+	x264opts.AppendFormat(":keyint=%d:min-keyint=%d", _context->gop_size, _context->gop_size);
+
+	if (_output_context->GetLookahead() >= 0)
+	{
+		x264opts.AppendFormat(":rc-lookahead=%d", _output_context->GetLookahead());
+	}
+
+	::av_opt_set(_context->priv_data, "x264opts", x264opts.CStr(), 0);
 
 	// CBR 옵션 / bitrate는 kbps 단위 / *문제는 MAC 크롬에서 재생이 안된다. 그래서 maxrate 값만 지정해줌.
 	// x264opts.AppendFormat(":nal-hrd=cbr:force-cfr=1:bitrate=%d:vbv-maxrate=%d:vbv-bufsize=%d:", _context->bit_rate/1000,  _context->bit_rate/1000,  _context->bit_rate/1000);
 
-	if (::avcodec_open2(_context, codec, nullptr) < 0)
+	if (::avcodec_open2(_context, _codec, nullptr) < 0)
 	{
-		logte("Could not open codec: %s (%d)", ::avcodec_get_name(codec_id), codec_id);
+		logte("Could not open codec: %s (%d)", ::avcodec_get_name(GetCodecID()), GetCodecID());
 		return false;
 	}
 
-	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
-	try
-	{
-		_kill_flag = false;
-
-		_thread_work = std::thread(&OvenCodecImplAvcodecEncAVC::ThreadEncode, this);
-	}
-	catch (const std::system_error &e)
-	{
-		_kill_flag = true;
+	logti("libx264 encoder is opened (%dx%d, %lld bps, preset: %s, tune: %s, threads: %d, keyint: %d, options: %s)",
+		  _context->width, _context->height, static_cast<long long>(_context->bit_rate),
+		  _output_context->GetPreset().CStr(), _output_context->GetTune().CStr(), _context->thread_count, _context->gop_size, x264opts.CStr());
 
-		logte("Failed to start transcode stream thread.");
-	}
+	_is_codec_opened = true;
 
 	return true;
 }
@@ -134,9 +277,15 @@ void OvenCodecImplAvcodecEncAVC::Stop()
 
 void OvenCodecImplAvcodecEncAVC::ThreadEncode()
 {
+	ov::ThreadMetrics thread_metrics("EncAVC", ov::ThreadClass::Encode);
+
 	while(!_kill_flag)
 	{
+		thread_metrics.BeginIdle();
 		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
 
 		std::unique_lock<std::mutex> mlock(_mutex);
 
@@ -156,35 +305,65 @@ void OvenCodecImplAvcodecEncAVC::ThreadEncode()
 		///////////////////////////////////////////////////
 
 
-		_frame->format = frame->GetFormat();
-		_frame->nb_samples = 1;
-		_frame->pts = frame->GetPts() * _scale;
-		// The encoder will not pass this duration
-		_frame->pkt_duration = frame->GetDuration();
-
-		_frame->width = frame->GetWidth();
-		_frame->height = frame->GetHeight();
-		_frame->linesize[0] = frame->GetStride(0);
-		_frame->linesize[1] = frame->GetStride(1);
-		_frame->linesize[2] = frame->GetStride(2);
-
-		if (::av_frame_get_buffer(_frame, 32) < 0)
+		if (TranscodeHWAccelHelper::IsDeviceFrame(frame.get()))
 		{
-			logte("Could not allocate the video frame data");
-			// *result = TranscodeResult::DataError;
-			break;
+			if (OpenHWEncoder(frame->GetNativeFrameAs<AVFrame>()) == false)
+			{
+				break;
+			}
+		}
+		else if (_is_codec_opened == false)
+		{
+			logtw("%s encoder cannot encode the frame in the host memory, the frame is dropped", _codec->name);
+			continue;
 		}
 
-		if (::av_frame_make_writable(_frame) < 0)
+		// Refer the buffers of the filter (or the surface on the device) instead of copying the planes
+		if (TranscodeFrameHelper::RefVideoFrame(_frame, frame.get()))
 		{
-			logte("Could not make sure the frame data is writable");
-			// *result = TranscodeResult::DataError;
-			break;
+			_frame->pts = frame->GetPts() * _scale;
+			_frame->pkt_duration = frame->GetDuration();
+		}
+		else
+		{
+			_frame->format = frame->GetFormat();
+			_frame->nb_samples = 1;
+			_frame->pts = frame->GetPts() * _scale;
+			// The encoder will not pass this duration
+			_frame->pkt_duration = frame->GetDuration();
+
+			_frame->width = frame->GetWidth();
+			_frame->height = frame->GetHeight();
+			_frame->linesize[0] = frame->GetStride(0);
+			_frame->linesize[1] = frame->GetStride(1);
+			_frame->linesize[2] = frame->GetStride(2);
+
+			if (::av_frame_get_buffer(_frame, 32) < 0)
+			{
+				logte("Could not allocate the video frame data");
+				// *result = TranscodeResult::DataError;
+				break;
+			}
+
+			if (::av_frame_make_writable(_frame) < 0)
+			{
+				logte("Could not make sure the frame data is writable");
+				// *result = TranscodeResult::DataError;
+				break;
+			}
+
+			::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+			::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
+			::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
 		}
 
-		::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
-		::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
-		::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
+		// Evaluated for every frame to track the intervals of the alignment
+		bool is_aligned_key_frame = IsAlignedKeyFrame(frame->GetPts());
+
+		if (PopKeyFrameRequest() || is_aligned_key_frame)
+		{
+			_frame->pict_type = AV_PICTURE_TYPE_I;
+		}
 
 		int ret = ::avcodec_send_frame(_context, _frame);
 		// int ret = 0;
@@ -269,89 +448,10 @@ std::shared_ptr<MediaPacket> OvenCodecImplAvcodecEncAVC::MakePacket() const
 	// This is workaround: avcodec_receive_packet() does not give the duration that sent to avcodec_send_frame()
 	int den = _output_context->GetTimeBase().GetDen();
 	int64_t duration = (den == 0) ? 0LL : (float)den / _output_context->GetFrameRate();
-	auto packet = std::make_shared<MediaPacket>(common::MediaType::Video, 0, _packet->data, _packet->size, _packet->pts * _scale_inv, _packet->dts * _scale_inv, duration, flag);
-	FragmentationHeader fragment_header;
-
-	int nal_pattern_size = 4;
-	int sps_start_index = -1;
-	int sps_end_index = -1;
-	int pps_start_index = -1;
-	int pps_end_index = -1;
-	int fragment_count = 0;
-	int current_index = 0;
-
-	while ((current_index + nal_pattern_size) < _packet->size)
-	{
-		if (_packet->data[current_index] == 0 && _packet->data[current_index + 1] == 0)
-		{
-			if (_packet->data[current_index + 2] == 0 && _packet->data[current_index + 3] == 1)
-			{
-				// Pattern 0x00 0x00 0x00 0x01
-				nal_pattern_size = 4;
-			}
-			else if (_packet->data[current_index + 2] == 1)
-			{
-				// Pattern 0x00 0x00 0x01
-				nal_pattern_size = 3;
-			}
-			else
-			{
-				current_index++;
-				continue;
-			}
-		}
-		else
-		{
-			current_index++;
-			continue;
-		}
-
-		fragment_count++;
-
-		if (sps_start_index == -1)
-		{
-			sps_start_index = current_index + nal_pattern_size;
-			current_index += nal_pattern_size;
-
-			if (_packet->flags != AV_PKT_FLAG_KEY)
-			{
-				break;
-			}
-		}
-		else if (sps_end_index == -1)
-		{
-			sps_end_index = current_index - 1;
-			pps_start_index = current_index + nal_pattern_size;
-			current_index += nal_pattern_size;
-		}
-		else  // (pps_end_index == -1)
-		{
-			pps_end_index = current_index - 1;
-			break;
-		}
-	}
-
-	fragment_header.Clear();
-
-	if (_packet->flags == AV_PKT_FLAG_KEY)  // KeyFrame
-	{
-		// SPS + PPS + IDR
-		fragment_header.fragmentation_offset.emplace_back(sps_start_index);
-		fragment_header.fragmentation_offset.emplace_back(pps_start_index);
-		fragment_header.fragmentation_offset.emplace_back((pps_end_index + 1) + nal_pattern_size);
-
-		fragment_header.fragmentation_length.emplace_back(sps_end_index - (sps_start_index - 1));
-		fragment_header.fragmentation_length.emplace_back(pps_end_index - (pps_start_index - 1));
-		fragment_header.fragmentation_length.emplace_back(_packet->size - (pps_end_index + nal_pattern_size));
-	}
-	else
-	{
-		// NON-IDR
-		fragment_header.fragmentation_offset.emplace_back(sps_start_index);
-		fragment_header.fragmentation_length.emplace_back(_packet->size - (sps_start_index - 1));
-	}
-
-	packet->SetFragHeader(&fragment_header);
+	auto packet = std::make_shared<MediaPacket>(common::MediaType::Video, 0, GetPacketData(), _packet->pts * _scale_inv, _packet->dts * _scale_inv, duration, flag);
+	// SPS/PPS/SEI/slices are found by the same scanner as MediaRouter, so MediaRouter doesn't scan the packet again
+	// (libavcodec doesn't export the NAL units of x264, and the scanner skips the slices with memchr())
+	AvcVideoPacketFragmentizer::MakeFragmentationHeader(_packet->data, _packet->size, packet->GetFragHeader());
 
 	return std::move(packet);
 }
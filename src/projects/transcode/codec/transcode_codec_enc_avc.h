@@ -29,8 +29,19 @@ public:
 	void Stop() override;
 
 private:
+	// Finds the hardware encoder if <HWAcceleration> of the profile is set.
+	// If the encoder or the device is not available, _output_context is changed to use libx264.
+	AVCodec *FindHWEncoder();
+	void SetHWEncoderOptions(TranscodeHWAccel hw_accel);
+	// The hardware encoder is opened when the first frame is received, because it needs the frames context of the frames
+	bool OpenHWEncoder(const AVFrame *frame);
+	bool SetX264Options();
+
 	std::shared_ptr<MediaPacket> MakePacket() const;
 
+	AVCodec *_codec = nullptr;
+	bool _is_codec_opened = false;
+
 	// Used to convert output timebase -> codec timebase
 	double _scale;
 	// Used to convert codec timebase -> output timebase
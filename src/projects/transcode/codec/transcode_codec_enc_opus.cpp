@@ -14,6 +14,13 @@
 
 #define OV_LOG_TAG "TranscodeCodec"
 
+// The expected packet loss until the first report of the players
+#define OPUS_INITIAL_PACKET_LOSS_PERC 10
+// The more loss is expected, the more bits are spent for the FEC, so a few lossy players don't take the quality of the others
+#define OPUS_MAX_PACKET_LOSS_PERC 30
+// The packets of this size or less are the DTX frames (RFC 7587 3.1.3)
+#define OPUS_DTX_PACKET_MAX_SIZE 2
+
 #if 0
 size_t AudioEncoderOpusImpl::SufficientOutputBufferSize() const {
   // Calculate the number of bytes we expect the encoder to produce,
@@ -44,8 +51,8 @@ bool OvenCodecImplAvcodecEncOpus::Configure(std::shared_ptr<TranscodeContext> co
 	}
 
 	// Initialize OPUS encoder
-	// int application = OPUS_APPLICATION_AUDIO;
-	int application = OPUS_APPLICATION_RESTRICTED_LOWDELAY;
+	// The in-band FEC and DTX work only in the SILK/hybrid modes, which RESTRICTED_LOWDELAY (CELT only) disables
+	int application = (context->IsInbandFec() || context->IsDtx()) ? OPUS_APPLICATION_AUDIO : OPUS_APPLICATION_RESTRICTED_LOWDELAY;
 	int error;
 
 	_encoder = ::opus_encoder_create(context->GetAudioSampleRate(), context->GetAudioChannel().GetCounts(), application, &error);
@@ -58,9 +65,11 @@ bool OvenCodecImplAvcodecEncOpus::Configure(std::shared_ptr<TranscodeContext> co
 		return false;
 	}
 
-	// Enable FEC
-	::opus_encoder_ctl(_encoder, OPUS_SET_INBAND_FEC(1));
-	::opus_encoder_ctl(_encoder, OPUS_SET_PACKET_LOSS_PERC(10));
+	// The expected loss is updated by the receiver reports of the players (See SetPacketLossPercentage())
+	::opus_encoder_ctl(_encoder, OPUS_SET_INBAND_FEC(context->IsInbandFec() ? 1 : 0));
+	::opus_encoder_ctl(_encoder, OPUS_SET_PACKET_LOSS_PERC(context->IsInbandFec() ? OPUS_INITIAL_PACKET_LOSS_PERC : 0));
+	// The silence is encoded as 1~2 bytes packets that are not sent, and a comfort noise frame every 400 ms
+	::opus_encoder_ctl(_encoder, OPUS_SET_DTX(context->IsDtx() ? 1 : 0));
 
 	// (48000Hz / 100ms) * 6 = 2880 samples / 600ms
 	const int max_opus_frame_count = (48000 / 100) * 6;
@@ -72,6 +81,14 @@ bool OvenCodecImplAvcodecEncOpus::Configure(std::shared_ptr<TranscodeContext> co
 	_buffer = std::make_shared<ov::Data>(max_opus_frame_count * estimated_channel_count * estimated_frame_size);
 	_format = common::AudioSample::Format::None;
 	_current_pts = -1;
+	_duration = 0LL;
+	_packet_loss_percentage = context->IsInbandFec() ? OPUS_INITIAL_PACKET_LOSS_PERC : 0;
+
+	if (context->IsInlineProcessing())
+	{
+		// The frames are encoded in SendBuffer()
+		return true;
+	}
 
 	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
 	try
@@ -106,112 +123,139 @@ void OvenCodecImplAvcodecEncOpus::Stop()
 
 void OvenCodecImplAvcodecEncOpus::ThreadEncode()
 {
-	const unsigned int frame_count_to_encode = 480 * 2;
-	const unsigned int bytes_to_encode = frame_count_to_encode * _output_context->GetAudioChannel().GetCounts() * _output_context->GetAudioSample().GetSampleSize();
-
-	int64_t duration = 0LL;
+	ov::ThreadMetrics thread_metrics("EncOpus", ov::ThreadClass::Encode);
 
 	while(!_kill_flag)
 	{
-		if (_buffer->GetLength() < bytes_to_encode)
+		thread_metrics.CountLoop();
+
+		// dequeue
+		thread_metrics.BeginIdle();
+		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		std::unique_lock<std::mutex> mlock(_mutex);
+
+		if (_input_buffer.empty())
 		{
-			// dequeue
-			_queue_event.Wait();
+			continue;
+		}
 
-			std::unique_lock<std::mutex> mlock(_mutex);
+		auto frame_buffer = std::move(_input_buffer.front());
+		_input_buffer.pop_front();
 
-			if (_input_buffer.empty())
-			{
-				continue;
-			}
+		mlock.unlock();
 
-			auto frame_buffer = std::move(_input_buffer.front());
-			_input_buffer.pop_front();
+		EncodeInputFrame(std::move(frame_buffer));
+	}
+}
 
-			mlock.unlock();
+bool OvenCodecImplAvcodecEncOpus::EncodeInputFrame(std::shared_ptr<const MediaFrame> frame_buffer)
+{
+	const MediaFrame *frame = frame_buffer.get();
 
-			const MediaFrame *frame = frame_buffer.get();
+	OV_ASSERT2(frame != nullptr);
 
-			OV_ASSERT2(frame != nullptr);
+	AppendFrame(frame);
+	EncodeBufferedSamples();
 
-			// Store frame informations
-			_format = frame->GetFormat<common::AudioSample::Format>();
+	return true;
+}
 
-			if (_current_pts == -1)
-			{
-				_current_pts = frame->GetPts();
-			}
+void OvenCodecImplAvcodecEncOpus::AppendFrame(const MediaFrame *frame)
+{
+	// Store frame informations
+	_format = frame->GetFormat<common::AudioSample::Format>();
+
+	if (_current_pts == -1)
+	{
+		_current_pts = frame->GetPts();
+	}
+
+	_duration += frame->GetDuration();
+
+	// Append frame data into the buffer
+
+	if (frame->GetChannels() == 1)
+	{
+		// Just copy data into buffer
+		_buffer->Append(frame->GetBuffer(0), frame->GetBufferSize(0));
+	}
+	else if (frame->GetChannels() >= 2)
+	{
+		// Currently, OME's OPUS encoder supports up to 2 channels
+		switch (_format)
+		{
+		case common::AudioSample::Format::S16P:
+		case common::AudioSample::Format::FltP:
+		{
+			// Need to interleave if sample type is planar
 
-			duration += frame->GetDuration();
+			off_t current_offset = _buffer->GetLength();
 
-			// Append frame data into the buffer
+			// Reserve extra spaces
+			size_t total_bytes = frame->GetBufferSize(0) + frame->GetBufferSize(1);
+			_buffer->SetLength(current_offset + total_bytes);
 
-			if (frame->GetChannels() == 1)
+			if (_format == common::AudioSample::Format::S16P)
 			{
-				// Just copy data into buffer
-				_buffer->Append(frame->GetBuffer(0), frame->GetBufferSize(0));
+				// S16P
+				ov::Interleave<int16_t>(_buffer->GetWritableDataAs<uint8_t>() + current_offset, frame->GetBuffer(0), frame->GetBuffer(1), frame->GetNbSamples());
+				_format = common::AudioSample::Format::S16;
 			}
-			else if (frame->GetChannels() >= 2)
+			else
 			{
-				// Currently, OME's OPUS encoder supports up to 2 channels
-				switch (_format)
-				{
-				case common::AudioSample::Format::S16P:
-				case common::AudioSample::Format::FltP:
-				{
-					// Need to interleave if sample type is planar
-
-					off_t current_offset = _buffer->GetLength();
-
-					// Reserve extra spaces
-					size_t total_bytes = frame->GetBufferSize(0) + frame->GetBufferSize(1);
-					_buffer->SetLength(current_offset + total_bytes);
-
-					if (_format == common::AudioSample::Format::S16P)
-					{
-						// S16P
-						ov::Interleave<int16_t>(_buffer->GetWritableDataAs<uint8_t>() + current_offset, frame->GetBuffer(0), frame->GetBuffer(1), frame->GetNbSamples());
-						_format = common::AudioSample::Format::S16;
-					}
-					else
-					{
-						// FltP
-						ov::Interleave<float>(_buffer->GetWritableDataAs<uint8_t>() + current_offset, frame->GetBuffer(0), frame->GetBuffer(1), frame->GetNbSamples());
-						_format = common::AudioSample::Format::Flt;
-					}
-
-					break;
-				}
-
-				case common::AudioSample::Format::S16:
-				case common::AudioSample::Format::Flt:
-					// Do not need to interleave if sample type is non-planar
-					_buffer->Append(frame->GetBuffer(0), frame->GetBufferSize(0));
-					break;
-
-				default:
-					logte("Not supported format: %d", _format);
-					break;
-				}
+				// FltP
+				ov::Interleave<float>(_buffer->GetWritableDataAs<uint8_t>() + current_offset, frame->GetBuffer(0), frame->GetBuffer(1), frame->GetNbSamples());
+				_format = common::AudioSample::Format::Flt;
 			}
+
+			break;
 		}
 
-		if (_buffer->GetLength() < bytes_to_encode)
+		case common::AudioSample::Format::S16:
+		case common::AudioSample::Format::Flt:
+			// Do not need to interleave if sample type is non-planar
+			_buffer->Append(frame->GetBuffer(0), frame->GetBufferSize(0));
+			break;
+
+		default:
+			logte("Not supported format: %d", _format);
+			break;
+		}
+	}
+}
+
+void OvenCodecImplAvcodecEncOpus::EncodeBufferedSamples()
+{
+	const unsigned int frame_count_to_encode = 480 * 2;
+	const unsigned int bytes_to_encode = frame_count_to_encode * _output_context->GetAudioChannel().GetCounts() * _output_context->GetAudioSample().GetSampleSize();
+
+	int32_t packet_loss_percentage;
+
+	if (_output_context->IsInbandFec() && PopPacketLossPercentage(&packet_loss_percentage))
+	{
+		packet_loss_percentage = std::min(packet_loss_percentage, OPUS_MAX_PACKET_LOSS_PERC);
+
+		if (packet_loss_percentage != _packet_loss_percentage)
 		{
-			// There is no data to encode
-			// logte("There is no data to encode");
-			continue;
+			logtd("The expected packet loss of OPUS FEC is changed: %d%% -> %d%%", _packet_loss_percentage, packet_loss_percentage);
+
+			::opus_encoder_ctl(_encoder, OPUS_SET_PACKET_LOSS_PERC(packet_loss_percentage));
+			_packet_loss_percentage = packet_loss_percentage;
 		}
+	}
 
+	while (_buffer->GetLength() >= bytes_to_encode)
+	{
 		OV_ASSERT2(_current_pts >= 0);
-		OV_ASSERT2(_buffer->GetLength() >= bytes_to_encode);
 
 		int encoded_bytes = -1;
 
 		// "1275 * 3 + 7" formula is used in opusenc.c:813
 		// or, use the formula in "AudioEncoderOpusImpl::SufficientOutputBufferSize()" of the native code.
 		std::shared_ptr<ov::Data> encoded = std::make_shared<ov::Data>(1275 * 3 + 7);
-		encoded->SetLength(encoded->GetCapacity());
+		encoded->SetLengthUninitialized(encoded->GetCapacity());
 
 		// Encode
 		switch (_format)
@@ -226,14 +270,14 @@ void OvenCodecImplAvcodecEncOpus::ThreadEncode()
 
 		default:
 			// *result = TranscodeResult::DataError;
-			continue;
+			return;
 		}
 
 		if (encoded_bytes < 0)
 		{
 			logte("An error occurred while encode data %zu bytes: %d (Buffer: %zu bytes)", _buffer->GetLength(), encoded_bytes, encoded->GetCapacity());
 			// *result = TranscodeResult::DataError;
-			continue;
+			return;
 		}
 
 		encoded->SetLength(static_cast<size_t>(encoded_bytes));
@@ -244,18 +288,27 @@ void OvenCodecImplAvcodecEncOpus::ThreadEncode()
 		::memmove(buffer, buffer + bytes_to_encode, _buffer->GetLength() - bytes_to_encode);
 		_buffer->SetLength(_buffer->GetLength() - bytes_to_encode);
 
-		auto packet_buffer = std::make_shared<MediaPacket>(common::MediaType::Audio, 1, encoded, _current_pts, _current_pts, duration, MediaPacketFlag::Key);
+		if (_output_context->IsDtx() && (encoded_bytes <= OPUS_DTX_PACKET_MAX_SIZE))
+		{
+			// Not transmitted, the players conceal the gap of the timestamps
+			_current_pts += frame_count_to_encode;
+			_duration = 0L;
+			continue;
+		}
+
+		auto packet_buffer = std::make_shared<MediaPacket>(common::MediaType::Audio, 1, encoded, _current_pts, _current_pts, _duration, MediaPacketFlag::Key);
 		_current_pts += frame_count_to_encode;
 		// logte("opus pts : %lld, queue:%d, buffer:%d", _current_pts, _input_buffer.size(), _buffer->GetLength());
 		// *result = TranscodeResult::DataReady;
-		
-		std::unique_lock<std::mutex> mlock2(_mutex);
 
-		_output_buffer.push_back(std::move(packet_buffer));	
+		std::unique_lock<std::mutex> mlock(_mutex);
 
-		duration = 0L;		
-	}
+		_output_buffer.push_back(std::move(packet_buffer));
 
+		mlock.unlock();
+
+		_duration = 0L;
+	}
 }
 
 void OvenCodecImplAvcodecEncOpus::SendBuffer(std::shared_ptr<const MediaFrame> frame)
@@ -32,10 +32,20 @@ public:
 	void Stop() override;
 
 protected:
+	bool EncodeInputFrame(std::shared_ptr<const MediaFrame> frame_buffer) override;
+	// Appends the samples of the frame to _buffer (interleaved)
+	void AppendFrame(const MediaFrame *frame);
+	// Encodes the samples of _buffer in 20 ms units
+	void EncodeBufferedSamples();
+
 	std::shared_ptr<ov::Data> _buffer;
+	// The duration of the frames appended since the last packet
+	int64_t _duration = 0LL;
 
 	common::AudioSample::Format _format;
 	int64_t _current_pts;
+	// The expected packet loss currently set to the encoder
+	int32_t _packet_loss_percentage = 0;
 
 	OpusEncoder *_encoder;
 };
@@ -8,8 +8,38 @@
 //==============================================================================
 #include "transcode_codec_enc_vp8.h"
 
+#include <algorithm>
+
+extern "C"
+{
+#include <vpx/vp8cx.h>
+}
+
 #define OV_LOG_TAG "TranscodeCodec"
 
+// The base layer refers and updates only the last frame
+#define VP8_TEMPORAL_BASE_LAYER_FLAGS (VP8_EFLAG_NO_REF_GF | VP8_EFLAG_NO_REF_ARF | VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF)
+// The upper layers refer only the last frame of the base layer and update nothing, so any of them can be dropped
+// (every frame of the upper layers is a layer sync frame)
+#define VP8_TEMPORAL_UPPER_LAYER_FLAGS (VP8_EFLAG_NO_REF_GF | VP8_EFLAG_NO_REF_ARF | VP8_EFLAG_NO_UPD_LAST | VP8_EFLAG_NO_UPD_GF | VP8_EFLAG_NO_UPD_ARF | VP8_EFLAG_NO_UPD_ENTROPY)
+
+static std::vector<uint8_t> GetTemporalLayerPattern(int32_t temporal_layers)
+{
+	switch (temporal_layers)
+	{
+		case 2:
+			// 1/2 of the framerate in the base layer
+			return {0, 1};
+
+		case 3:
+			// 1/4 of the framerate in the base layer, 1/2 with the second layer
+			return {0, 2, 1, 2};
+
+		default:
+			return {0};
+	}
+}
+
 OvenCodecImplAvcodecEncVP8::~OvenCodecImplAvcodecEncVP8()
 {
 	Stop();
@@ -22,6 +52,13 @@ bool OvenCodecImplAvcodecEncVP8::Configure(std::shared_ptr<TranscodeContext> con
 		return false;
 	}
 
+	if (_output_context->GetHWAccel() != TranscodeHWAccel::None)
+	{
+		// The filter must output the frames in the host memory for libvpx
+		logtw("VP8 encoder does not support %s, libvpx will be used", TranscodeHWAccelHelper::GetName(_output_context->GetHWAccel()));
+		_output_context->SetHWAccel(TranscodeHWAccel::None);
+	}
+
 	auto codec_id = GetCodecID();
 
 	AVCodec *codec = ::avcodec_find_encoder(codec_id);
@@ -49,12 +86,12 @@ bool OvenCodecImplAvcodecEncVP8::Configure(std::shared_ptr<TranscodeContext> con
 	_context->sample_aspect_ratio = (AVRational){1, 1};
 	_context->time_base = TimebaseToAVRational(_output_context->GetTimeBase());
 	_context->framerate = ::av_d2q(_output_context->GetFrameRate(), AV_TIME_BASE);
-	_context->gop_size = _output_context->GetFrameRate() * 1;  // create keyframes every second
+	_context->gop_size = _output_context->GetGOP();
 	_context->max_b_frames = 0;
 	_context->pix_fmt = AV_PIX_FMT_YUV420P;
 	_context->width = _output_context->GetVideoWidth();
 	_context->height = _output_context->GetVideoHeight();
-	_context->thread_count = 2;
+	_context->thread_count = GetThreadCount();
 
 	AVRational output_timebase = TimebaseToAVRational(_output_context->GetTimeBase());
 	_scale = ::av_q2d(::av_div_q(output_timebase, codec_timebase));
@@ -63,6 +100,26 @@ bool OvenCodecImplAvcodecEncVP8::Configure(std::shared_ptr<TranscodeContext> con
 	AVDictionary *opts = nullptr;
 	// ::av_dict_set_int(&opts, "cpu-used", _context->thread_count, 0);
 	::av_dict_set(&opts, "quality", "realtime", 0);
+	// The packets are output in the order of the frames without delay (the temporal layers of the packets are known by the order)
+	::av_dict_set_int(&opts, "lag-in-frames", 0, 0);
+
+	_temporal_layers = std::clamp(_output_context->GetTemporalLayers(), 1, VP8_MAX_TEMPORAL_LAYERS);
+	_temporal_layer_pattern = GetTemporalLayerPattern(_temporal_layers);
+
+	if (_temporal_layers > 1)
+	{
+		auto periodicity = static_cast<int>(_temporal_layer_pattern.size());
+
+		// The keyframes of libvpx must be the first frames of the periods, so the automatic keyframes are placed
+		// at the multiples of the period and the scene cut is disabled
+		_context->gop_size = std::max(((_context->gop_size + periodicity - 1) / periodicity) * periodicity, periodicity);
+		_context->keyint_min = _context->gop_size;
+
+		auto ts_parameters = MakeTemporalLayerParameters();
+		::av_dict_set(&opts, "ts-parameters", ts_parameters.CStr(), 0);
+
+		logtd("VP8 encoder uses %d temporal layers: %s", _temporal_layers, ts_parameters.CStr());
+	}
 
 	if (::avcodec_open2(_context, codec, &opts) < 0)
 	{
@@ -103,9 +160,15 @@ void OvenCodecImplAvcodecEncVP8::Stop()
 
 void OvenCodecImplAvcodecEncVP8::ThreadEncode()
 {
+	ov::ThreadMetrics thread_metrics("EncVP8", ov::ThreadClass::Encode);
+
 	while(!_kill_flag)
 	{
+		thread_metrics.BeginIdle();
 		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
 
 		std::unique_lock<std::mutex> mlock(_mutex);
 
@@ -124,35 +187,58 @@ void OvenCodecImplAvcodecEncVP8::ThreadEncode()
 		mlock.unlock();
 
 
-		_frame->format = frame->GetFormat();
-		_frame->nb_samples = 1;
-		_frame->pts = frame->GetPts() * _scale;
-		// The encoder will not pass this duration
-		_frame->pkt_duration = frame->GetDuration();
+		// Refer the buffers of the filter instead of copying the planes
+		if (TranscodeFrameHelper::RefVideoFrame(_frame, frame.get()))
+		{
+			_frame->pts = frame->GetPts() * _scale;
+			_frame->pkt_duration = frame->GetDuration();
+		}
+		else
+		{
+			_frame->format = frame->GetFormat();
+			_frame->nb_samples = 1;
+			_frame->pts = frame->GetPts() * _scale;
+			// The encoder will not pass this duration
+			_frame->pkt_duration = frame->GetDuration();
+
+			_frame->width = frame->GetWidth();
+			_frame->height = frame->GetHeight();
+			_frame->linesize[0] = frame->GetStride(0);
+			_frame->linesize[1] = frame->GetStride(1);
+			_frame->linesize[2] = frame->GetStride(2);
+
+			if (::av_frame_get_buffer(_frame, 32) < 0)
+			{
+				logte("Could not allocate the video frame data");
+				// *result = TranscodeResult::DataError;
+				break;
+			}
 
-		_frame->width = frame->GetWidth();
-		_frame->height = frame->GetHeight();
-		_frame->linesize[0] = frame->GetStride(0);
-		_frame->linesize[1] = frame->GetStride(1);
-		_frame->linesize[2] = frame->GetStride(2);
+			if (::av_frame_make_writable(_frame) < 0)
+			{
+				logte("Could not make sure the frame data is writable");
+				// *result = TranscodeResult::DataError;
+				break;
+			}
 
-		if (::av_frame_get_buffer(_frame, 32) < 0)
-		{
-			logte("Could not allocate the video frame data");
-			// *result = TranscodeResult::DataError;
-			break;
+			::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+			::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
+			::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
 		}
 
-		if (::av_frame_make_writable(_frame) < 0)
+		// Evaluated for every frame to track the intervals of the alignment
+		bool is_aligned_key_frame = IsAlignedKeyFrame(frame->GetPts());
+		bool is_key_frame = PopKeyFrameRequest() || is_aligned_key_frame;
+
+		if (_temporal_layers > 1)
 		{
-			logte("Could not make sure the frame data is writable");
-			// *result = TranscodeResult::DataError;
-			break;
+			is_key_frame = SetTemporalLayer(is_key_frame);
 		}
 
-		::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
-		::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
-		::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
+		if (is_key_frame)
+		{
+			_frame->pict_type = AV_PICTURE_TYPE_I;
+		}
 
 		int ret = ::avcodec_send_frame(_context, _frame);
 		// int ret = 0;
@@ -229,13 +315,99 @@ std::shared_ptr<MediaPacket> OvenCodecImplAvcodecEncVP8::RecvBuffer(TranscodeRes
 	return nullptr;
 }
 
-std::shared_ptr<MediaPacket> OvenCodecImplAvcodecEncVP8::MakePacket() const
+ov::String OvenCodecImplAvcodecEncVP8::MakeTemporalLayerParameters() const
+{
+	// The cumulative bitrates of the layers (kbps), the same ratios as libwebrtc
+	auto bitrate = _output_context->GetBitrate() / 1000;
+	std::vector<int32_t> target_bitrates;
+	std::vector<int32_t> rate_decimators;
+
+	if (_temporal_layers == 2)
+	{
+		target_bitrates = {bitrate * 60 / 100, bitrate};
+		rate_decimators = {2, 1};
+	}
+	else
+	{
+		target_bitrates = {bitrate * 40 / 100, bitrate * 60 / 100, bitrate};
+		rate_decimators = {4, 2, 1};
+	}
+
+	std::vector<ov::String> bitrate_list;
+	std::vector<ov::String> decimator_list;
+	std::vector<ov::String> layer_id_list;
+
+	for (auto target_bitrate : target_bitrates)
+	{
+		bitrate_list.push_back(ov::Converter::ToString(target_bitrate));
+	}
+
+	for (auto rate_decimator : rate_decimators)
+	{
+		decimator_list.push_back(ov::Converter::ToString(rate_decimator));
+	}
+
+	for (auto layer : _temporal_layer_pattern)
+	{
+		layer_id_list.push_back(ov::Converter::ToString(layer));
+	}
+
+	return ov::String::FormatString("ts_number_layers=%d:ts_target_bitrate=%s:ts_rate_decimator=%s:ts_periodicity=%zu:ts_layer_id=%s",
+									_temporal_layers,
+									ov::String::Join(bitrate_list, ",").CStr(),
+									ov::String::Join(decimator_list, ",").CStr(),
+									_temporal_layer_pattern.size(),
+									ov::String::Join(layer_id_list, ",").CStr());
+}
+
+bool OvenCodecImplAvcodecEncVP8::SetTemporalLayer(bool is_key_frame_requested)
+{
+	auto index = _temporal_layer_frame_count % _temporal_layer_pattern.size();
+	auto layer = _temporal_layer_pattern[index];
+	bool is_key_frame = false;
+
+	_temporal_layer_frame_count++;
+
+	if (is_key_frame_requested || _is_key_frame_pending)
+	{
+		// The keyframe is delayed to the next period (at most 3 frames),
+		// otherwise the layer counter of libvpx is not in sync with the pattern
+		is_key_frame = (index == 0);
+		_is_key_frame_pending = (is_key_frame == false);
+	}
+
+	::av_dict_set_int(&_frame->metadata, "vp8-flags", (layer == 0) ? VP8_TEMPORAL_BASE_LAYER_FLAGS : VP8_TEMPORAL_UPPER_LAYER_FLAGS, 0);
+	::av_dict_set_int(&_frame->metadata, "temporal_id", layer, 0);
+
+	_temporal_layer_queue.emplace_back(_frame->pts, layer);
+
+	return is_key_frame;
+}
+
+std::shared_ptr<MediaPacket> OvenCodecImplAvcodecEncVP8::MakePacket()
 {
 	auto flag = (_packet->flags & AV_PKT_FLAG_KEY) ? MediaPacketFlag::Key : MediaPacketFlag::NoFlag;
 	// This is workaround: avcodec_receive_packet() does not give the duration that sent to avcodec_send_frame()
 	int den = _output_context->GetTimeBase().GetDen();
 	int64_t duration = (den == 0) ? 0LL : (float)den / _output_context->GetFrameRate();
-	auto packet = std::make_shared<MediaPacket>(common::MediaType::Video, 0, _packet->data, _packet->size, _packet->pts, _packet->dts, duration, flag);
+	auto packet = std::make_shared<MediaPacket>(common::MediaType::Video, 0, GetPacketData(), _packet->pts, _packet->dts, duration, flag);
+
+	if (_temporal_layers > 1)
+	{
+		// The frames dropped by the rate control of libvpx have no packet
+		while ((_temporal_layer_queue.empty() == false) && (_temporal_layer_queue.front().first < _packet->pts))
+		{
+			_temporal_layer_queue.pop_front();
+		}
+
+		if ((_temporal_layer_queue.empty() == false) && (_temporal_layer_queue.front().first == _packet->pts))
+		{
+			auto layer = _temporal_layer_queue.front().second;
+
+			packet->SetTemporalLayer(layer, layer > 0);
+			_temporal_layer_queue.pop_front();
+		}
+	}
 
 	return std::move(packet);
 }
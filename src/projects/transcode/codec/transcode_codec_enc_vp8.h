@@ -10,6 +10,12 @@
 
 #include "transcode_encoder.h"
 
+#include <deque>
+#include <vector>
+
+// The maximum number of the temporal layers (See <Encode><Video><TemporalLayers>)
+#define VP8_MAX_TEMPORAL_LAYERS 3
+
 class OvenCodecImplAvcodecEncVP8 : public TranscodeEncoder
 {
 public:
@@ -29,10 +35,25 @@ public:
 	void Stop() override;
 
 private:
-	std::shared_ptr<MediaPacket> MakePacket() const;
+	std::shared_ptr<MediaPacket> MakePacket();
+
+	// The "ts-parameters" of libvpxenc for _temporal_layers
+	ov::String MakeTemporalLayerParameters() const;
+	// Decides the temporal layer of _frame (the reference/update flags of libvpx are set to the metadata of the frame)
+	// Returns true if the frame should be a keyframe (only the first frame of a period can be a keyframe)
+	bool SetTemporalLayer(bool is_key_frame_requested);
 
 	// Used to convert output timebase -> codec timebase
 	double _scale;
 	// Used to convert codec timebase -> output timebase
 	double _scale_inv;
+
+	int32_t _temporal_layers = 1;
+	// The temporal layer of each frame in a period
+	std::vector<uint8_t> _temporal_layer_pattern;
+	uint64_t _temporal_layer_frame_count = 0;
+	// A keyframe is requested in the middle of a period
+	bool _is_key_frame_pending = false;
+	// <pts, temporal layer> of the frames sent to the encoder (libvpx outputs the packets in the same order)
+	std::deque<std::pair<int64_t, uint8_t>> _temporal_layer_queue;
 };
@@ -10,6 +10,9 @@
 
 #include "transcode_codec_dec_aac.h"
 #include "transcode_codec_dec_avc.h"
+#include "transcode_encoder.h"
+
+#include <base/info/application.h>
 
 #define OV_LOG_TAG "TranscodeCodec"
 
@@ -41,6 +44,31 @@ std::shared_ptr<TranscodeContext>& TranscodeDecoder::GetContext()
 	return _input_context;
 }
 
+void TranscodeDecoder::SetSkipNonReference(bool skip_non_reference)
+{
+	if (_context == nullptr)
+	{
+		return;
+	}
+
+	auto skip_frame = skip_non_reference ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+
+	if (_context->skip_frame != skip_frame)
+	{
+		_context->skip_frame = skip_frame;
+	}
+}
+
+void TranscodeDecoder::SetSkipNonKey(bool skip_non_key)
+{
+	if (_context == nullptr)
+	{
+		return;
+	}
+
+	_context->skip_frame = skip_non_key ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+}
+
 std::shared_ptr<TranscodeDecoder> TranscodeDecoder::CreateDecoder(const info::Stream &info, common::MediaCodecId codec_id, std::shared_ptr<TranscodeContext> input_context)
 {
 	std::shared_ptr<TranscodeDecoder> decoder = nullptr;
@@ -80,7 +108,12 @@ bool TranscodeDecoder::Configure(std::shared_ptr<TranscodeContext> context)
 
 	_input_context = context;
 
-	_codec = ::avcodec_find_decoder(GetCodecID());
+	_codec = FindHWDecoder();
+
+	if (_codec == nullptr)
+	{
+		_codec = ::avcodec_find_decoder(GetCodecID());
+	}
 
 	if (_codec == nullptr)
 	{
@@ -97,12 +130,42 @@ bool TranscodeDecoder::Configure(std::shared_ptr<TranscodeContext> context)
 		return false;
 	}
 
+	auto hw_accel = _input_context->GetHWAccel();
+
+	if (hw_accel != TranscodeHWAccel::None)
+	{
+		_hw_pixel_format = TranscodeHWAccelHelper::GetPixelFormat(hw_accel);
+
+		_context->hw_device_ctx = ::av_buffer_ref(TranscodeHWAccelHelper::GetDeviceContext(hw_accel));
+		_context->opaque = this;
+		_context->get_format = OnGetFormat;
+		// The decoded frames are held by the filters/encoders of other threads
+		_context->extra_hw_frames = TRANSCODE_HW_EXTRA_DECODER_FRAMES;
+	}
+
+	if (hw_accel == TranscodeHWAccel::None)
+	{
+		SetThreadingOptions();
+	}
+
 	if (::avcodec_open2(_context, _codec, nullptr) < 0)
 	{
 		logte("Could not open codec: %s (%d)", ::avcodec_get_name(GetCodecID()), GetCodecID());
 		return false;
 	}
 
+	if (hw_accel != TranscodeHWAccel::None)
+	{
+		logti("[%s/%s(%u)] %s decoder is opened with %s", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(),
+			  _codec->name, TranscodeHWAccelHelper::GetName(hw_accel));
+	}
+	else if (_input_context->GetDecodeMode() != "auto")
+	{
+		logti("[%s/%s(%u)] %s decoder is opened in %s mode (threads: %d, type: %s)", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(),
+			  _codec->name, _input_context->GetDecodeMode().CStr(), _context->thread_count,
+			  (_context->thread_type == FF_THREAD_SLICE) ? "slice" : "frame");
+	}
+
 	_parser = ::av_parser_init(_codec->id);
 
 	if (_parser == nullptr)
@@ -116,6 +179,90 @@ bool TranscodeDecoder::Configure(std::shared_ptr<TranscodeContext> context)
 	return true;
 }
 
+void TranscodeDecoder::SetThreadingOptions()
+{
+	if (_input_context->GetMediaType() != common::MediaType::Video)
+	{
+		return;
+	}
+
+	auto &decode_mode = _input_context->GetDecodeMode();
+	auto thread_count = _input_context->GetThreadCount();
+
+	if (decode_mode == "lowdelay")
+	{
+		// Frame threading delays the output by (thread count - 1) frames, so only the slices of a frame are decoded in parallel.
+		// (The streams encoded with a single slice are decoded by one thread)
+		_context->thread_type = FF_THREAD_SLICE;
+		_context->thread_count = thread_count;
+		// Outputs the frames as soon as they are decoded, without waiting to reorder them
+		_context->flags |= AV_CODEC_FLAG_LOW_DELAY;
+	}
+	else if (decode_mode == "throughput")
+	{
+		// Frame threading scales with the number of the cores regardless of the slices
+		_context->thread_type = FF_THREAD_FRAME;
+		// Shares the cores with the video encoders
+		_context->thread_count = (thread_count > 0) ? thread_count : TranscodeEncoder::GetAutoThreadCount(1);
+	}
+	else if (thread_count > 0)
+	{
+		_context->thread_count = thread_count;
+	}
+}
+
+AVCodec *TranscodeDecoder::FindHWDecoder()
+{
+	auto hw_accel = _input_context->GetHWAccel();
+
+	if (hw_accel == TranscodeHWAccel::None)
+	{
+		return nullptr;
+	}
+
+	AVCodec *codec = nullptr;
+	auto decoder_name = TranscodeHWAccelHelper::GetDecoderName(hw_accel, GetCodecID());
+
+	if (decoder_name == nullptr)
+	{
+		logtw("%s does not support decoding %s, the software decoder will be used", TranscodeHWAccelHelper::GetName(hw_accel), ::avcodec_get_name(GetCodecID()));
+	}
+	else if (TranscodeHWAccelHelper::GetDeviceContext(hw_accel) != nullptr)
+	{
+		codec = const_cast<AVCodec *>(::avcodec_find_decoder_by_name(decoder_name));
+
+		if (codec == nullptr)
+		{
+			logtw("Could not find the decoder: %s, the software decoder will be used", decoder_name);
+		}
+	}
+
+	if (codec == nullptr)
+	{
+		_input_context->SetHWAccel(TranscodeHWAccel::None);
+	}
+
+	return codec;
+}
+
+AVPixelFormat TranscodeDecoder::OnGetFormat(AVCodecContext *context, const AVPixelFormat *pixel_formats)
+{
+	auto decoder = static_cast<TranscodeDecoder *>(context->opaque);
+
+	for (auto pixel_format = pixel_formats; *pixel_format != AV_PIX_FMT_NONE; pixel_format++)
+	{
+		if (*pixel_format == decoder->_hw_pixel_format)
+		{
+			return *pixel_format;
+		}
+	}
+
+	// The profile of the stream may not be supported by the device (e.g. 4:2:2)
+	logtw("The decoder does not offer %s, the frames will be decoded by the software decoder", ::av_get_pix_fmt_name(decoder->_hw_pixel_format));
+
+	return ::avcodec_default_get_format(context, pixel_formats);
+}
+
 void TranscodeDecoder::SendBuffer(std::shared_ptr<const MediaPacket> packet)
 {
 	_input_buffer.push_back(std::move(packet));
@@ -10,6 +10,8 @@
 
 #include "base/info/stream.h"
 #include "transcode_base.h"
+#include "transcode_frame_helper.h"
+#include "transcode_hw_accel.h"
 
 class TranscodeDecoder : public TranscodeBase<MediaPacket, MediaFrame>
 {
@@ -25,9 +27,24 @@ public:
 
 	std::shared_ptr<TranscodeContext>& GetContext();
 
+	// Discards the non-reference frames without decoding them (called by the thread that decodes)
+	void SetSkipNonReference(bool skip_non_reference);
+	// Discards all frames except the key frames without decoding them (for the thumbnails)
+	void SetSkipNonKey(bool skip_non_key);
+
 protected:
 	static const ov::String ShowCodecParameters(const AVCodecContext *context, const AVCodecParameters *parameters);
 
+	// Selects the pixel format of the hardware decoder (falls back to the software format if it is not offered)
+	static AVPixelFormat OnGetFormat(AVCodecContext *context, const AVPixelFormat *pixel_formats);
+
+	// Sets the threads of the software decoder by <Decode><Video><Mode> and <ThreadCount>
+	void SetThreadingOptions();
+
+	// Finds the hardware decoder if <Decode><Video><HWAcceleration> is set.
+	// If the decoder or the device is not available, _input_context is changed to use the software decoder.
+	AVCodec *FindHWDecoder();
+
 	std::shared_ptr<TranscodeContext> _input_context;
 
 	AVCodec *_codec = nullptr;
@@ -35,6 +52,8 @@ protected:
 	AVCodecParserContext *_parser = nullptr;
 	AVCodecParameters *_codec_par = avcodec_parameters_alloc();
 
+	AVPixelFormat _hw_pixel_format = AV_PIX_FMT_NONE;
+
 	bool _change_format = false;
 
 	AVPacket *_pkt;
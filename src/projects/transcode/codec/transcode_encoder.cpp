@@ -13,10 +13,18 @@
 #include "transcode_codec_enc_vp8.h"
 #include "transcode_codec_enc_opus.h"
 
+#include <algorithm>
+#include <cmath>
+#include <thread>
 #include <utility>
 
 #define OV_LOG_TAG "TranscodeCodec"
 
+// The number of threads of x264 doesn't scale well beyond this in low-latency mode
+#define TRANSCODE_MAX_AUTO_THREAD_COUNT 16
+
+std::atomic<int32_t> TranscodeEncoder::_video_encoder_count{0};
+
 TranscodeEncoder::TranscodeEncoder()
 {
 	avcodec_register_all();
@@ -29,6 +37,11 @@ TranscodeEncoder::TranscodeEncoder()
 
 TranscodeEncoder::~TranscodeEncoder()
 {
+	if (_is_counted)
+	{
+		_video_encoder_count--;
+	}
+
 	OV_SAFE_FUNC(_context, nullptr, ::avcodec_free_context, &);
 
 	OV_SAFE_FUNC(_frame, nullptr, ::av_frame_free, &);
@@ -82,11 +95,28 @@ bool TranscodeEncoder::Configure(std::shared_ptr<TranscodeContext> context)
 {
 	_output_context = context;
 
-	return (_output_context != nullptr);
+	if (_output_context == nullptr)
+	{
+		return false;
+	}
+
+	if ((_is_counted == false) && (_output_context->GetMediaType() == common::MediaType::Video))
+	{
+		_video_encoder_count++;
+		_is_counted = true;
+	}
+
+	return true;
 }
 
 void TranscodeEncoder::SendBuffer(std::shared_ptr<const MediaFrame> frame)
 {
+	if (_output_context->IsInlineProcessing())
+	{
+		EncodeInputFrame(std::move(frame));
+		return;
+	}
+
 	std::unique_lock<std::mutex> mlock(_mutex);
 
 	_input_buffer.push_back(std::move(frame));
@@ -96,11 +126,113 @@ void TranscodeEncoder::SendBuffer(std::shared_ptr<const MediaFrame> frame)
 	_queue_event.Notify();;
 }
 
+bool TranscodeEncoder::EncodeInputFrame(std::shared_ptr<const MediaFrame> frame)
+{
+	logte("%s encoder cannot encode the frames inline", ::avcodec_get_name(GetCodecID()));
+
+	return false;
+}
+
 std::shared_ptr<TranscodeContext>& TranscodeEncoder::GetContext()
 {
 	return _output_context;
 }
 
+void TranscodeEncoder::RequestKeyFrame()
+{
+	_is_key_frame_requested = true;
+}
+
+bool TranscodeEncoder::PopKeyFrameRequest()
+{
+	return _is_key_frame_requested.exchange(false);
+}
+
+void TranscodeEncoder::SetPacketLossPercentage(int32_t packet_loss_percentage)
+{
+	_packet_loss_percentage = std::clamp(packet_loss_percentage, 0, 100);
+}
+
+bool TranscodeEncoder::PopPacketLossPercentage(int32_t *packet_loss_percentage)
+{
+	auto value = _packet_loss_percentage.exchange(-1);
+
+	if (value < 0)
+	{
+		return false;
+	}
+
+	*packet_loss_percentage = value;
+	return true;
+}
+
+std::shared_ptr<const ov::Data> TranscodeEncoder::GetPacketData() const
+{
+	if ((_packet->data == nullptr) || (_packet->size <= 0))
+	{
+		return std::make_shared<const ov::Data>();
+	}
+
+	AVBufferRef *buffer = (_packet->buf != nullptr) ? ::av_buffer_ref(_packet->buf) : nullptr;
+
+	if (buffer == nullptr)
+	{
+		// The packet is not reference-counted (or out of memory)
+		return std::make_shared<const ov::Data>(_packet->data, _packet->size);
+	}
+
+	std::shared_ptr<const void> owner(buffer, [](const void *pointer) {
+		auto reference = static_cast<AVBufferRef *>(const_cast<void *>(pointer));
+		::av_buffer_unref(&reference);
+	});
+
+	return std::make_shared<const ov::Data>(_packet->data, _packet->size, owner);
+}
+
+bool TranscodeEncoder::IsAlignedKeyFrame(int64_t pts)
+{
+	auto alignment = _output_context->GetKeyFrameAlignment();
+
+	if (alignment <= 0)
+	{
+		return false;
+	}
+
+	auto pts_ms = static_cast<int64_t>(std::floor(pts * _output_context->GetTimeBase().GetExpr() * 1000.0));
+	// floor() of the division (pts can be negative)
+	auto index = (pts_ms >= 0) ? (pts_ms / alignment) : ((pts_ms - alignment + 1) / alignment);
+
+	if (index == _aligned_key_frame_index)
+	{
+		return false;
+	}
+
+	_aligned_key_frame_index = index;
+
+	return true;
+}
+
+int32_t TranscodeEncoder::GetAutoThreadCount(int32_t pending_encoder_count)
+{
+	int32_t core_count = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+	int32_t encoder_count = std::max(_video_encoder_count.load() + pending_encoder_count, 1);
+
+	return std::clamp(core_count / encoder_count, 1, TRANSCODE_MAX_AUTO_THREAD_COUNT);
+}
+
+int32_t TranscodeEncoder::GetThreadCount() const
+{
+	auto thread_count = _output_context->GetThreadCount();
+
+	if (thread_count > 0)
+	{
+		return thread_count;
+	}
+
+	// This encoder is already counted
+	return GetAutoThreadCount(0);
+}
+
 void TranscodeEncoder::ThreadEncode()
 {
 	// nothing...
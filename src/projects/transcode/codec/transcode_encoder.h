@@ -8,7 +8,11 @@
 //==============================================================================
 #pragma once
 
+#include <atomic>
+
 #include "transcode_base.h"
+#include "transcode_frame_helper.h"
+#include "transcode_hw_accel.h"
 
 class TranscodeEncoder : public TranscodeBase<MediaFrame, MediaPacket>
 {
@@ -28,7 +32,40 @@ public:
 
 	virtual void Stop();
 
+	// The next frame will be encoded as a keyframe (called from other threads)
+	void RequestKeyFrame();
+
+	// The packet loss (0~100) reported by the players of the output stream (called from other threads)
+	// The encoders that can protect the packets (OPUS in-band FEC) apply it from the next frame
+	void SetPacketLossPercentage(int32_t packet_loss_percentage);
+
+	// Divides the cores of the system by the number of the video encoders
+	// (the encoders currently running + pending_encoder_count encoders that are about to be created)
+	static int32_t GetAutoThreadCount(int32_t pending_encoder_count);
+
 protected:
+	// Encodes the frame and queues the packets to _output_buffer on the calling thread
+	// (ThreadEncode() calls it, and SendBuffer() calls it instead if the output context is inline, See TranscodeContext::SetInlineProcessing())
+	// Returns false if the encoder cannot continue
+	virtual bool EncodeInputFrame(std::shared_ptr<const MediaFrame> frame);
+
+	// Returns the thread count of the output context, or the automatic value if it is 0
+	int32_t GetThreadCount() const;
+
+	// Returns true once after RequestKeyFrame() is called
+	bool PopKeyFrameRequest();
+
+	// Returns true once after SetPacketLossPercentage() is called, with the last value
+	bool PopPacketLossPercentage(int32_t *packet_loss_percentage);
+
+	// Returns true if the frame is the first frame of an interval of the keyframe alignment (See TranscodeContext::SetKeyFrameAlignment())
+	// pts: in the timebase of the output context
+	bool IsAlignedKeyFrame(int64_t pts);
+
+	// Returns the payload of _packet without copying it (it keeps a reference of the AVBufferRef of the packet),
+	// so the packet can be unreferenced after this
+	std::shared_ptr<const ov::Data> GetPacketData() const;
+
 	std::shared_ptr<TranscodeContext> _output_context = nullptr;
 
 	AVCodecContext *_context = nullptr;
@@ -47,4 +84,14 @@ protected:
 	std::thread _thread_work;
 	ov::Semaphore _queue_event;
 
+	std::atomic<bool> _is_key_frame_requested{false};
+	// -1 if there is no new report
+	std::atomic<int32_t> _packet_loss_percentage{-1};
+
+	// The index of the interval of the keyframe alignment that the last keyframe is forced in
+	int64_t _aligned_key_frame_index = INT64_MIN;
+
+	// Whether this encoder is counted in _video_encoder_count
+	bool _is_counted = false;
+	static std::atomic<int32_t> _video_encoder_count;
 };
@@ -0,0 +1,87 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_frame_helper.h"
+
+#define OV_LOG_TAG "TranscodeFrame"
+
+std::shared_ptr<void> TranscodeFrameHelper::CloneFrame(const AVFrame *frame)
+{
+	// Only the references of the buffers are copied
+	AVFrame *cloned_frame = ::av_frame_clone(frame);
+
+	if (cloned_frame == nullptr)
+	{
+		return nullptr;
+	}
+
+	return std::shared_ptr<void>(cloned_frame, [](void *frame) {
+		auto av_frame = static_cast<AVFrame *>(frame);
+		::av_frame_free(&av_frame);
+	});
+}
+
+bool TranscodeFrameHelper::AttachVideoFrame(MediaFrame *media_frame, const AVFrame *frame)
+{
+	auto native_frame = CloneFrame(frame);
+
+	if (native_frame == nullptr)
+	{
+		logte("Could not refer the video frame");
+		return false;
+	}
+
+	if (frame->hw_frames_ctx == nullptr)
+	{
+		auto cloned_frame = static_cast<const AVFrame *>(native_frame.get());
+
+		media_frame->SetStride(cloned_frame->linesize[0], 0);
+		media_frame->SetStride(cloned_frame->linesize[1], 1);
+		media_frame->SetStride(cloned_frame->linesize[2], 2);
+
+		media_frame->SetBufferReference(cloned_frame->data[0], media_frame->GetStride(0) * media_frame->GetHeight(), 0);	  // Y-Plane
+		media_frame->SetBufferReference(cloned_frame->data[1], media_frame->GetStride(1) * media_frame->GetHeight() / 2, 1);  // Cb Plane
+		media_frame->SetBufferReference(cloned_frame->data[2], media_frame->GetStride(2) * media_frame->GetHeight() / 2, 2);  // Cr Plane
+	}
+
+	media_frame->SetNativeFrame(std::move(native_frame));
+
+	return true;
+}
+
+bool TranscodeFrameHelper::RefVideoFrame(AVFrame *frame, const MediaFrame *media_frame)
+{
+	auto native_frame = media_frame->GetNativeFrameAs<const AVFrame>();
+
+	if (native_frame == nullptr)
+	{
+		return false;
+	}
+
+	if (::av_frame_ref(frame, native_frame) < 0)
+	{
+		logte("Could not refer the video frame");
+		return false;
+	}
+
+	// The encoders must decide the picture type by themselves (libx264 forces the type of the decoded picture)
+	frame->pict_type = AV_PICTURE_TYPE_NONE;
+	frame->key_frame = 0;
+
+	return true;
+}
+
+void TranscodeFrameHelper::CopyPlane(const std::shared_ptr<TranscodeFramePool> &frame_pool, MediaFrame *media_frame, int32_t plane, const uint8_t *data, size_t length)
+{
+	if ((frame_pool != nullptr) && frame_pool->CopyToPlane(media_frame, plane, data, length))
+	{
+		return;
+	}
+
+	media_frame->SetBuffer(data, static_cast<int32_t>(length), plane);
+}
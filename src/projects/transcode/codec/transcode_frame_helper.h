@@ -0,0 +1,38 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include "transcode_frame_pool.h"
+
+// Passes the video frames between libavcodec/libavfilter and MediaFrame without copying the planes
+class TranscodeFrameHelper
+{
+public:
+	// Wraps av_frame_clone(frame) to store it to MediaFrame::SetNativeFrame()
+	static std::shared_ptr<void> CloneFrame(const AVFrame *frame);
+
+	// Makes media_frame refer the reference-counted buffers of frame.
+	// The planes of media_frame are available through GetBuffer() as before (except the frames in the device memory)
+	static bool AttachVideoFrame(MediaFrame *media_frame, const AVFrame *frame);
+
+	// Makes frame refer the planes of media_frame.
+	// Returns false if media_frame does not have a native frame (the caller must copy the planes)
+	static bool RefVideoFrame(AVFrame *frame, const MediaFrame *media_frame);
+
+	// Copies the plane to a buffer of frame_pool (or to a new buffer if frame_pool is nullptr)
+	static void CopyPlane(const std::shared_ptr<TranscodeFramePool> &frame_pool, MediaFrame *media_frame, int32_t plane, const uint8_t *data, size_t length);
+};
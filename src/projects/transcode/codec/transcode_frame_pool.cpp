@@ -0,0 +1,103 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_frame_pool.h"
+
+#define OV_LOG_TAG "TranscodeFramePool"
+
+// The alignment of the planes given to libav (AVX-512 needs 64 bytes)
+#define TRANSCODE_FRAME_POOL_ALIGNMENT 64
+
+std::shared_ptr<TranscodeFramePool> TranscodeFramePool::Create(size_t max_free_count)
+{
+	return std::shared_ptr<TranscodeFramePool>(new TranscodeFramePool(max_free_count));
+}
+
+TranscodeFramePool::TranscodeFramePool(size_t max_free_count)
+	: _max_free_count(max_free_count)
+{
+}
+
+ov::DataBufferPtr TranscodeFramePool::Allocate(int32_t format, int32_t width, int32_t height, int32_t plane, size_t size)
+{
+	std::shared_ptr<ov::BufferPool> pool;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto &item = _pools[Key(format, width, height, plane)];
+
+		// The size of the same key changes only if the alignment (stride) is changed
+		if ((item == nullptr) || (item->GetBufferSize() < size))
+		{
+			item = ov::BufferPool::Create(size, _max_free_count);
+		}
+
+		pool = item;
+	}
+
+	return pool->Allocate();
+}
+
+AVBufferRef *TranscodeFramePool::AllocateAVBuffer(int32_t format, int32_t width, int32_t height, int32_t plane, size_t size)
+{
+	auto storage = Allocate(format, width, height, plane, size + TRANSCODE_FRAME_POOL_ALIGNMENT);
+
+	if (storage == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto buffer = storage.Get();
+	auto address = reinterpret_cast<uintptr_t>(buffer->GetBytes());
+	auto aligned = (address + TRANSCODE_FRAME_POOL_ALIGNMENT - 1) & ~static_cast<uintptr_t>(TRANSCODE_FRAME_POOL_ALIGNMENT - 1);
+
+	// The reference is released by the free callback of the AVBufferRef
+	buffer->AddRef();
+
+	AVBufferRef *buffer_ref = ::av_buffer_create(
+		reinterpret_cast<uint8_t *>(aligned), static_cast<int>(size),
+		[](void *opaque, uint8_t *data) {
+			static_cast<ov::DataBuffer *>(opaque)->Release();
+		},
+		buffer, 0);
+
+	if (buffer_ref == nullptr)
+	{
+		logte("Could not wrap the buffer of the frame pool (%zu bytes)", size);
+		buffer->Release();
+	}
+
+	return buffer_ref;
+}
+
+bool TranscodeFramePool::CopyToPlane(MediaFrame *media_frame, int32_t plane, const void *data, size_t length)
+{
+	ov::DataBufferPtr storage;
+
+	if (media_frame->GetNbSamples() > 0)
+	{
+		// Audio frame
+		storage = Allocate(media_frame->GetFormat(), media_frame->GetNbSamples(), media_frame->GetChannels(), plane, length);
+	}
+	else
+	{
+		storage = Allocate(media_frame->GetFormat(), media_frame->GetWidth(), media_frame->GetHeight(), plane, length);
+	}
+
+	if (storage == nullptr)
+	{
+		return false;
+	}
+
+	::memcpy(storage->GetBytes(), data, length);
+
+	media_frame->SetBufferStorage(std::move(storage), length, plane);
+
+	return true;
+}
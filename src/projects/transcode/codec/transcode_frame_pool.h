@@ -0,0 +1,58 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+extern "C"
+{
+#include <libavutil/buffer.h>
+}
+
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/buffer_pool.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+// The maximum number of free buffers kept per (format, width, height, plane)
+#define TRANSCODE_FRAME_POOL_MAX_FREE_COUNT 8
+
+// The planes of the decoded/filtered/resampled frames of a stream
+//
+// - The buffers are kept per (format, width, height, plane), so the frames of the same shape reuse the same buffers
+//   (the audio frames use (sample format, number of samples, channels))
+// - A buffer returns to the pool when the last MediaFrame (or AVFrame) that refers it is released
+// - The decoder and the filters of the stream share the pool through TranscodeContext::SetFramePool()
+class TranscodeFramePool
+{
+public:
+	static std::shared_ptr<TranscodeFramePool> Create(size_t max_free_count = TRANSCODE_FRAME_POOL_MAX_FREE_COUNT);
+
+	// Returns a buffer with the capacity of at least size (the bytes are not initialized)
+	ov::DataBufferPtr Allocate(int32_t format, int32_t width, int32_t height, int32_t plane, size_t size);
+
+	// Returns a buffer that can be used as AVFrame::buf[] (aligned for the SIMD kernels of libav)
+	AVBufferRef *AllocateAVBuffer(int32_t format, int32_t width, int32_t height, int32_t plane, size_t size);
+
+	// Copies data to a buffer of the pool, and sets it as the plane of media_frame
+	// (The key is the format/size of media_frame, so they must be set before calling this)
+	bool CopyToPlane(MediaFrame *media_frame, int32_t plane, const void *data, size_t length);
+
+protected:
+	// format, width (or samples), height (or channels), plane
+	using Key = std::tuple<int32_t, int32_t, int32_t, int32_t>;
+
+	explicit TranscodeFramePool(size_t max_free_count);
+
+	const size_t _max_free_count;
+
+	mutable std::mutex _mutex;
+	std::map<Key, std::shared_ptr<ov::BufferPool>> _pools;
+};
@@ -0,0 +1,258 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_hw_accel.h"
+
+#include <map>
+#include <mutex>
+
+#define OV_LOG_TAG "TranscodeHWAccel"
+
+TranscodeHWAccel TranscodeHWAccelHelper::Parse(ov::String name)
+{
+	name.MakeLower();
+
+	if ((name == "nvenc") || (name == "nvdec") || (name == "nvidia") || (name == "cuda"))
+	{
+		return TranscodeHWAccel::Nvidia;
+	}
+	else if (name == "qsv")
+	{
+		return TranscodeHWAccel::Qsv;
+	}
+	else if (name == "vaapi")
+	{
+		return TranscodeHWAccel::Vaapi;
+	}
+	else if (name.IsEmpty() || (name == "none"))
+	{
+		return TranscodeHWAccel::None;
+	}
+
+	logtw("Unknown hardware acceleration: %s, software codecs will be used", name.CStr());
+
+	return TranscodeHWAccel::None;
+}
+
+const char *TranscodeHWAccelHelper::GetName(TranscodeHWAccel hw_accel)
+{
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::None:
+			return "none";
+
+		case TranscodeHWAccel::Nvidia:
+			return "nvidia";
+
+		case TranscodeHWAccel::Qsv:
+			return "qsv";
+
+		case TranscodeHWAccel::Vaapi:
+			return "vaapi";
+	}
+
+	return "unknown";
+}
+
+AVHWDeviceType TranscodeHWAccelHelper::GetDeviceType(TranscodeHWAccel hw_accel)
+{
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			return AV_HWDEVICE_TYPE_CUDA;
+
+		case TranscodeHWAccel::Qsv:
+			return AV_HWDEVICE_TYPE_QSV;
+
+		case TranscodeHWAccel::Vaapi:
+			return AV_HWDEVICE_TYPE_VAAPI;
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+
+	return AV_HWDEVICE_TYPE_NONE;
+}
+
+AVPixelFormat TranscodeHWAccelHelper::GetPixelFormat(TranscodeHWAccel hw_accel)
+{
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			return AV_PIX_FMT_CUDA;
+
+		case TranscodeHWAccel::Qsv:
+			return AV_PIX_FMT_QSV;
+
+		case TranscodeHWAccel::Vaapi:
+			return AV_PIX_FMT_VAAPI;
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+
+	return AV_PIX_FMT_NONE;
+}
+
+TranscodeHWAccel TranscodeHWAccelHelper::FromPixelFormat(int pixel_format)
+{
+	switch (pixel_format)
+	{
+		case AV_PIX_FMT_CUDA:
+			return TranscodeHWAccel::Nvidia;
+
+		case AV_PIX_FMT_QSV:
+			return TranscodeHWAccel::Qsv;
+
+		case AV_PIX_FMT_VAAPI:
+			return TranscodeHWAccel::Vaapi;
+
+		default:
+			break;
+	}
+
+	return TranscodeHWAccel::None;
+}
+
+AVBufferRef *TranscodeHWAccelHelper::GetDeviceContext(TranscodeHWAccel hw_accel)
+{
+	static std::mutex device_mutex;
+	// Key: hardware acceleration, value: device ctx (nullptr if the device could not be opened)
+	static std::map<TranscodeHWAccel, AVBufferRef *> device_map;
+
+	if (hw_accel == TranscodeHWAccel::None)
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(device_mutex);
+
+	auto item = device_map.find(hw_accel);
+
+	if (item != device_map.end())
+	{
+		return item->second;
+	}
+
+	AVBufferRef *device_context = nullptr;
+	// Use the default device (The first GPU for CUDA, /dev/dri/renderD128 for VA-API)
+	int ret = ::av_hwdevice_ctx_create(&device_context, GetDeviceType(hw_accel), nullptr, nullptr, 0);
+
+	if (ret < 0)
+	{
+		char error[AV_ERROR_MAX_STRING_SIZE]{};
+		::av_strerror(ret, error, sizeof(error));
+
+		logte("Could not open the %s device: %s (%d), software codecs will be used instead", GetName(hw_accel), error, ret);
+		device_context = nullptr;
+	}
+	else
+	{
+		logti("The %s device is opened", GetName(hw_accel));
+	}
+
+	// The device is kept open until the process exits
+	device_map[hw_accel] = device_context;
+
+	return device_context;
+}
+
+const char *TranscodeHWAccelHelper::GetDecoderName(TranscodeHWAccel hw_accel, AVCodecID codec_id)
+{
+	if (codec_id != AV_CODEC_ID_H264)
+	{
+		return nullptr;
+	}
+
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			// NVDEC through the hwaccel of the native decoder outputs CUDA frames
+			return "h264";
+
+		case TranscodeHWAccel::Qsv:
+			return "h264_qsv";
+
+		case TranscodeHWAccel::Vaapi:
+			return "h264";
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+
+	return nullptr;
+}
+
+const char *TranscodeHWAccelHelper::GetEncoderName(TranscodeHWAccel hw_accel, AVCodecID codec_id)
+{
+	if (codec_id != AV_CODEC_ID_H264)
+	{
+		return nullptr;
+	}
+
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			return "h264_nvenc";
+
+		case TranscodeHWAccel::Qsv:
+			return "h264_qsv";
+
+		case TranscodeHWAccel::Vaapi:
+			return "h264_vaapi";
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+
+	return nullptr;
+}
+
+ov::String TranscodeHWAccelHelper::GetScaleFilter(TranscodeHWAccel hw_accel, int width, int height, const char *sw_flags)
+{
+	switch (hw_accel)
+	{
+		case TranscodeHWAccel::Nvidia:
+			return ov::String::FormatString("scale_npp=w=%d:h=%d:format=nv12:interp_algo=super", width, height);
+
+		case TranscodeHWAccel::Qsv:
+			return ov::String::FormatString("scale_qsv=w=%d:h=%d:format=nv12", width, height);
+
+		case TranscodeHWAccel::Vaapi:
+			return ov::String::FormatString("scale_vaapi=w=%d:h=%d:format=nv12", width, height);
+
+		case TranscodeHWAccel::None:
+			break;
+	}
+
+	return ov::String::FormatString("scale=%dx%d:flags=%s", width, height, sw_flags);
+}
+
+std::shared_ptr<AVBufferRef> TranscodeHWAccelHelper::RefBuffer(AVBufferRef *buffer)
+{
+	AVBufferRef *new_buffer = (buffer != nullptr) ? ::av_buffer_ref(buffer) : nullptr;
+
+	if (new_buffer == nullptr)
+	{
+		return nullptr;
+	}
+
+	return std::shared_ptr<AVBufferRef>(new_buffer, [](AVBufferRef *buffer) {
+		::av_buffer_unref(&buffer);
+	});
+}
+
+bool TranscodeHWAccelHelper::IsDeviceFrame(const MediaFrame *frame)
+{
+	if ((frame == nullptr) || (frame->HasNativeFrame() == false))
+	{
+		return false;
+	}
+
+	return (FromPixelFormat(frame->GetFormat()) != TranscodeHWAccel::None);
+}
@@ -0,0 +1,62 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include "../transcode_context.h"
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/hwcontext.h>
+}
+
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+// The number of device frames that can be queued between the stages.
+// The surface pools of QSV/VA-API are fixed-size, so the frames must be returned to the pool quickly.
+#define TRANSCODE_HW_MAX_QUEUED_FRAMES 8
+// Additional surfaces allocated by the hardware decoder for the frames held by the filters/encoders
+#define TRANSCODE_HW_EXTRA_DECODER_FRAMES (TRANSCODE_HW_MAX_QUEUED_FRAMES * 2)
+
+class TranscodeHWAccelHelper
+{
+public:
+	// Parses the value of <HWAcceleration>
+	//   - "none" (or empty)
+	//   - "nvenc" ("nvidia", "cuda" and "nvdec" are also accepted)
+	//   - "qsv"
+	//   - "vaapi"
+	static TranscodeHWAccel Parse(ov::String name);
+	static const char *GetName(TranscodeHWAccel hw_accel);
+
+	static AVHWDeviceType GetDeviceType(TranscodeHWAccel hw_accel);
+	// The pixel format of the frames in the device memory
+	static AVPixelFormat GetPixelFormat(TranscodeHWAccel hw_accel);
+	static TranscodeHWAccel FromPixelFormat(int pixel_format);
+
+	// Returns the device context shared by all codecs/filters of the process.
+	// The device is opened on the first call, and nullptr is returned if it is not available.
+	// (The caller must not unref the returned context - use av_buffer_ref() to keep it)
+	static AVBufferRef *GetDeviceContext(TranscodeHWAccel hw_accel);
+
+	// Returns nullptr if the hardware accelerated decoder is not supported for the codec.
+	// (VA-API decodes using the hwaccel of the native decoder, so it returns the name of the native decoder)
+	static const char *GetDecoderName(TranscodeHWAccel hw_accel, AVCodecID codec_id);
+	static const char *GetEncoderName(TranscodeHWAccel hw_accel, AVCodecID codec_id);
+
+	// Returns the filter that scales the frames on the device
+	// sw_flags: the flags of swscale if hw_accel is None
+	static ov::String GetScaleFilter(TranscodeHWAccel hw_accel, int width, int height, const char *sw_flags = "bicubic");
+
+	static std::shared_ptr<AVBufferRef> RefBuffer(AVBufferRef *buffer);
+
+	// Whether the frame is in the device memory
+	static bool IsDeviceFrame(const MediaFrame *frame);
+};
@@ -11,6 +11,8 @@
 
 #include <base/ovlibrary/ovlibrary.h>
 
+#include "../codec/transcode_frame_helper.h"
+
 #define OV_LOG_TAG "MediaFilter.Resampler"
 
 MediaFilterResampler::MediaFilterResampler()
@@ -156,6 +158,12 @@ bool MediaFilterResampler::Configure(const std::shared_ptr<MediaTrack> &input_me
 	_input_context = input_context;
 	_output_context = output_context;
 
+	if (output_context->IsInlineProcessing())
+	{
+		// The frames are resampled in SendBuffer()
+		return true;
+	}
+
 	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
 	try
 	{
@@ -192,9 +200,15 @@ void MediaFilterResampler::TrheadFilter()
 {
 	logtd("Start transcode resampler filter thread.");
 
+	ov::ThreadMetrics thread_metrics("Resampler", ov::ThreadClass::Media);
+
 	while (!_kill_flag)
 	{
+		thread_metrics.BeginIdle();
 		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
 
 		std::unique_lock<std::mutex> mlock(_mutex);
 
@@ -208,143 +222,161 @@ void MediaFilterResampler::TrheadFilter()
 
 		mlock.unlock();
 
-		// logtd("format(%d), channels(%d), samples(%d)", frame->GetFormat(), frame->GetChannels(), frame->GetNbSamples());
-		///logtp("Dequeued data for resampling: %lld\n%s", frame->GetPts(), ov::Dump(frame->GetBuffer(0), frame->GetBufferSize(0), 32).CStr());
-
-		_frame->format = frame->GetFormat();
-		_frame->nb_samples = frame->GetNbSamples();
-		_frame->channel_layout = static_cast<uint64_t>(frame->GetChannelLayout());
-		_frame->channels = frame->GetChannels();
-		_frame->sample_rate = frame->GetSampleRate();
-		_frame->pts = frame->GetPts();
-		_frame->pkt_duration = frame->GetDuration();
-
-		int ret = ::av_frame_get_buffer(_frame, 0);
-		if (ret < 0)
+		if (FilterInputFrame(std::move(frame)) == false)
 		{
-			logte("Could not allocate the audio frame data");
-
-			// *result = TranscodeResult::DataError;
-			// return nullptr;
 			break;
 		}
+	}
+}
 
-		ret = ::av_frame_make_writable(_frame);
-		if (ret < 0)
-		{
-			logte("Could not make writable frame");
+bool MediaFilterResampler::FilterInputFrame(std::shared_ptr<MediaFrame> frame)
+{
+	// logtd("format(%d), channels(%d), samples(%d)", frame->GetFormat(), frame->GetChannels(), frame->GetNbSamples());
+	///logtp("Dequeued data for resampling: %lld\n%s", frame->GetPts(), ov::Dump(frame->GetBuffer(0), frame->GetBufferSize(0), 32).CStr());
+
+	_frame->format = frame->GetFormat();
+	_frame->nb_samples = frame->GetNbSamples();
+	_frame->channel_layout = static_cast<uint64_t>(frame->GetChannelLayout());
+	_frame->channels = frame->GetChannels();
+	_frame->sample_rate = frame->GetSampleRate();
+	_frame->pts = frame->GetPts();
+	_frame->pkt_duration = frame->GetDuration();
+
+	int ret = ::av_frame_get_buffer(_frame, 0);
+	if (ret < 0)
+	{
+		logte("Could not allocate the audio frame data");
 
-			// *result = TranscodeResult::DataError;
-			// return nullptr;
-			 break;
-		}
+		// *result = TranscodeResult::DataError;
+		// return nullptr;
+		return false;
+	}
 
-		// Copy data into frame
-		if (IsPlanar(frame->GetFormat<AVSampleFormat>()))
-		{
-			// If the frame is planar, the data should stored separately in the "_frame->data" array.
-			_frame->linesize[0] = 0;
+	ret = ::av_frame_make_writable(_frame);
+	if (ret < 0)
+	{
+		logte("Could not make writable frame");
 
-			for (int channel = 0; channel < _frame->channels; channel++)
-			{
-				size_t data_length = frame->GetBufferSize(channel);
+		// *result = TranscodeResult::DataError;
+		// return nullptr;
+		return false;
+	}
 
-				::memcpy(_frame->data[channel], frame->GetBuffer(channel), data_length);
-				_frame->linesize[0] += data_length;
-			}
-		}
-		else
+	// Copy data into frame
+	if (IsPlanar(frame->GetFormat<AVSampleFormat>()))
+	{
+		// If the frame is planar, the data should stored separately in the "_frame->data" array.
+		_frame->linesize[0] = 0;
+
+		for (int channel = 0; channel < _frame->channels; channel++)
 		{
-			// If the frame is non-planar, Just copy interleaved data to "_frame->data[0]"
-			::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+			size_t data_length = frame->GetBufferSize(channel);
+
+			::memcpy(_frame->data[channel], frame->GetBuffer(channel), data_length);
+			_frame->linesize[0] += data_length;
 		}
+	}
+	else
+	{
+		// If the frame is non-planar, Just copy interleaved data to "_frame->data[0]"
+		::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+	}
 
-		// Copy packet data into frame
-		if (::av_buffersrc_add_frame_flags(_buffersrc_ctx, _frame, AV_BUFFERSRC_FLAG_KEEP_REF) < 0)
-		{
-			logte("An error occurred while feeding the audio filtergraph: format: %d, pts: %lld, linesize: %d, size: %d", _frame->format, _frame->pts, _frame->linesize[0], _input_buffer.size());
+	// Copy packet data into frame
+	if (::av_buffersrc_add_frame_flags(_buffersrc_ctx, _frame, AV_BUFFERSRC_FLAG_KEEP_REF) < 0)
+	{
+		logte("An error occurred while feeding the audio filtergraph: format: %d, pts: %lld, linesize: %d, size: %d", _frame->format, _frame->pts, _frame->linesize[0], _input_buffer.size());
 
+		if (_thread_work.joinable())
+		{
 			std::unique_lock<std::mutex> mlock(_mutex);
 			_input_buffer.push_front(std::move(frame));
 			mlock.unlock();
 			_queue_event.Notify();
 		}
+	}
 
-		::av_frame_unref(_frame);
+	::av_frame_unref(_frame);
 
 
-		while (true)
-		{
-			int ret = ::av_buffersink_get_frame(_buffersink_ctx, _frame);
+	while (true)
+	{
+		int ret = ::av_buffersink_get_frame(_buffersink_ctx, _frame);
 
-			if (ret == AVERROR(EAGAIN))
-			{
-				// Wait for more packet
-				break;
-			}
-			else if (ret == AVERROR_EOF)
-			{
-				logte("Error receiving a packet for decoding : AVERROR_EOF");
-				// *result = TranscodeResult::EndOfFile;
-				// return nullptr;
-				break;
-			}
-			else if (ret < 0)
+		if (ret == AVERROR(EAGAIN))
+		{
+			// Wait for more packet
+			break;
+		}
+		else if (ret == AVERROR_EOF)
+		{
+			logte("Error receiving a packet for decoding : AVERROR_EOF");
+			// *result = TranscodeResult::EndOfFile;
+			// return nullptr;
+			break;
+		}
+		else if (ret < 0)
+		{
+			logte("Error receiving a packet for decoding : %d", ret);
+			// *result = TranscodeResult::DataError;
+			// return nullptr;
+		
+			break;
+		}
+		else
+		{
+			auto output_frame = std::make_shared<MediaFrame>();
+
+			output_frame->SetFormat(_frame->format);
+			output_frame->SetBytesPerSample(::av_get_bytes_per_sample((AVSampleFormat)_frame->format));
+			output_frame->SetNbSamples(_frame->nb_samples);
+			output_frame->SetChannels(_frame->channels);
+			output_frame->SetSampleRate(_frame->sample_rate);
+			output_frame->SetChannelLayout((common::AudioChannel::Layout)_frame->channel_layout);
+			output_frame->SetPts((_frame->pts == AV_NOPTS_VALUE) ? -1L : _frame->pts);
+			output_frame->SetDuration(_frame->pkt_duration * _scale);
+
+			auto data_length = static_cast<uint32_t>(output_frame->GetBytesPerSample() * output_frame->GetNbSamples());
+			auto frame_pool = _output_context->GetFramePool();
+
+			// Copy frame data into out_buf
+			if (IsPlanar(static_cast<AVSampleFormat>(_frame->format)))
 			{
-				logte("Error receiving a packet for decoding : %d", ret);
-				// *result = TranscodeResult::DataError;
-				// return nullptr;
-			
-				break;
+				// If the frame is planar, the data is stored separately in the "_frame->data" array.
+				for (int channel = 0; channel < _frame->channels; channel++)
+				{
+					TranscodeFrameHelper::CopyPlane(frame_pool, output_frame.get(), channel, _frame->data[channel], data_length);
+				}
 			}
 			else
 			{
-				auto output_frame = std::make_shared<MediaFrame>();
-
-				output_frame->SetFormat(_frame->format);
-				output_frame->SetBytesPerSample(::av_get_bytes_per_sample((AVSampleFormat)_frame->format));
-				output_frame->SetNbSamples(_frame->nb_samples);
-				output_frame->SetChannels(_frame->channels);
-				output_frame->SetSampleRate(_frame->sample_rate);
-				output_frame->SetChannelLayout((common::AudioChannel::Layout)_frame->channel_layout);
-				output_frame->SetPts((_frame->pts == AV_NOPTS_VALUE) ? -1L : _frame->pts);
-				output_frame->SetDuration(_frame->pkt_duration * _scale);
-
-				auto data_length = static_cast<uint32_t>(output_frame->GetBytesPerSample() * output_frame->GetNbSamples());
-
-				// Copy frame data into out_buf
-				if (IsPlanar(static_cast<AVSampleFormat>(_frame->format)))
-				{
-					// If the frame is planar, the data is stored separately in the "_frame->data" array.
-					for (int channel = 0; channel < _frame->channels; channel++)
-					{
-						output_frame->Resize(data_length, channel);
-						uint8_t *output = output_frame->GetWritableBuffer(channel);
-						::memcpy(output, _frame->data[channel], data_length);
-					}
-				}
-				else
-				{
-					// If the frame is non-planar, it means interleaved data. So, just copy from "_frame->data[0]" into the output_frame
-					output_frame->AppendBuffer(_frame->data[0], data_length * _frame->channels, 0);
-				}
+				// If the frame is non-planar, it means interleaved data. So, just copy from "_frame->data[0]" into the output_frame
+				TranscodeFrameHelper::CopyPlane(frame_pool, output_frame.get(), 0, _frame->data[0], data_length * _frame->channels);
+			}
 
-				//logtp("Resampled data: %lld\n%s", output_frame->GetPts(), ov::Dump(_frame->data[0], _frame->linesize[0], 32).CStr());
+			//logtp("Resampled data: %lld\n%s", output_frame->GetPts(), ov::Dump(_frame->data[0], _frame->linesize[0], 32).CStr());
 
-				::av_frame_unref(_frame);
+			::av_frame_unref(_frame);
 
-				// *result = TranscodeResult::DataReady;
-				// return std::move(output_frame);
-				std::unique_lock<std::mutex> mlock(_mutex);
+			// *result = TranscodeResult::DataReady;
+			// return std::move(output_frame);
+			std::unique_lock<std::mutex> mlock(_mutex);
 
-				_output_buffer.push_back(std::move(output_frame));
-			}
+			_output_buffer.push_back(std::move(output_frame));
 		}
 	}
+
+	return true;
 }
 
 int32_t MediaFilterResampler::SendBuffer(std::shared_ptr<MediaFrame> buffer)
 {
+	if (_output_context->IsInlineProcessing())
+	{
+		FilterInputFrame(std::move(buffer));
+		return 0;
+	}
+
 	std::unique_lock<std::mutex> mlock(_mutex);
 
 	_input_buffer.push_back(std::move(buffer));
@@ -31,5 +31,10 @@ public:
 	void Stop();
 
 protected:
+	// Resamples the frame and queues the output frames to _output_buffer on the calling thread
+	// (TrheadFilter() calls it, and SendBuffer() calls it instead if the output context is inline)
+	// Returns false if the filter cannot continue
+	bool FilterInputFrame(std::shared_ptr<MediaFrame> frame);
+
 	bool IsPlanar(AVSampleFormat format);
 };
@@ -9,10 +9,40 @@
 
 #include "media_filter_rescaler.h"
 
+#include "../codec/transcode_frame_helper.h"
+#include "../codec/transcode_frame_pool.h"
+#include "../codec/transcode_hw_accel.h"
+
 #include <base/ovlibrary/ovlibrary.h>
 
 #define OV_LOG_TAG "MediaFilter.Rescaler"
 
+// The frame rates that differ less than this are considered as the same (the fps filter is not needed)
+#define RESCALER_FRAME_RATE_TOLERANCE 0.01
+
+struct ScaleAlgorithm
+{
+	// The name of the flags for the "scale" filter
+	const char *name;
+	int flags;
+};
+
+static ScaleAlgorithm GetScaleAlgorithm(const ov::String &scale_quality)
+{
+	if (scale_quality == "speed")
+	{
+		// swscale has the hand-written MMX/SSE/NEON kernels for the fast bilinear scaler
+		return {"fast_bilinear", SWS_FAST_BILINEAR};
+	}
+
+	if (scale_quality == "balanced")
+	{
+		return {"bilinear", SWS_BILINEAR};
+	}
+
+	return {"bicubic", SWS_BICUBIC};
+}
+
 MediaFilterRescaler::MediaFilterRescaler()
 {
 	::avfilter_register_all();
@@ -37,23 +67,13 @@ MediaFilterRescaler::~MediaFilterRescaler()
 	OV_SAFE_FUNC(_outputs, nullptr, ::avfilter_inout_free, &);
 
 	OV_SAFE_FUNC(_filter_graph, nullptr, ::avfilter_graph_free, &);
+
+	OV_SAFE_FUNC(_sws_context, nullptr, ::sws_freeContext, );
+	OV_SAFE_FUNC(_buffer_pool, nullptr, ::av_buffer_pool_uninit, &);
 }
 
 bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_media_track, const std::shared_ptr<TranscodeContext> &input_context, const std::shared_ptr<TranscodeContext> &output_context)
 {
-	int ret;
-
-	const AVFilter *buffersrc = ::avfilter_get_by_name("buffer");
-	const AVFilter *buffersink = ::avfilter_get_by_name("buffersink");
-
-	_filter_graph = ::avfilter_graph_alloc();
-
-	if ((_filter_graph == nullptr) || (_inputs == nullptr) || (_outputs == nullptr))
-	{
-		logte("Could not allocate variables for filter graph: %p, %p, %p", _filter_graph, _inputs, _outputs);
-		return false;
-	}
-
 	AVRational input_timebase = TimebaseToAVRational(input_context->GetTimeBase());
 	AVRational output_timebase = TimebaseToAVRational(output_context->GetTimeBase());
 
@@ -68,10 +88,74 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 		return false;
 	}
 
+	auto scale_algorithm = GetScaleAlgorithm(output_context->GetScaleQuality());
+	auto input_frame_rate = input_context->GetFrameRate();
+	auto output_frame_rate = output_context->GetFrameRate();
+
+	if ((TranscodeHWAccelHelper::FromPixelFormat(input_media_track->GetFormat()) == TranscodeHWAccel::None) &&
+		(output_context->GetHWAccel() == TranscodeHWAccel::None) &&
+		(input_frame_rate > 0.0f) &&
+		(std::abs(input_frame_rate - output_frame_rate) < RESCALER_FRAME_RATE_TOLERANCE))
+	{
+		// The frame rate is not converted and the frames are on the memory, so the filter graph is not needed.
+		// The frames are scaled by swscale directly (it has the SIMD kernels for x86/ARM), and the timestamps are converted like "settb".
+		_use_swscale = true;
+		_sws_flags = scale_algorithm.flags;
+		_source_timebase = TimebaseToAVRational(input_media_track->GetTimeBase());
+		_sink_timebase = output_timebase;
+
+		logtd("Rescaler is enabled for track #%u using swscale: %ux%u (%s)",
+			  input_media_track->GetId(), output_context->GetVideoWidth(), output_context->GetVideoHeight(), scale_algorithm.name);
+	}
+	else if (ConfigureFilterGraph(input_media_track, input_context, output_context, scale_algorithm.name) == false)
+	{
+		return false;
+	}
+
+	_input_context = input_context;
+	_output_context = output_context;
+
+	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
+	try
+	{
+		_kill_flag = false;
+
+		_thread_work = std::thread(&MediaFilterRescaler::TrheadFilter, this);
+	}
+	catch (const std::system_error &e)
+	{
+		_kill_flag = true;
+
+		logte("Failed to start transcode rescale filter thread.");
+	}
+
+	return true;
+}
+
+bool MediaFilterRescaler::ConfigureFilterGraph(const std::shared_ptr<MediaTrack> &input_media_track, const std::shared_ptr<TranscodeContext> &input_context, const std::shared_ptr<TranscodeContext> &output_context, const char *scale_flags)
+{
+	int ret;
+
+	const AVFilter *buffersrc = ::avfilter_get_by_name("buffer");
+	const AVFilter *buffersink = ::avfilter_get_by_name("buffersink");
+
+	_filter_graph = ::avfilter_graph_alloc();
+
+	if ((_filter_graph == nullptr) || (_inputs == nullptr) || (_outputs == nullptr))
+	{
+		logte("Could not allocate variables for filter graph: %p, %p, %p", _filter_graph, _inputs, _outputs);
+		return false;
+	}
+
 	// Prepare filters
 	//
 	// Filter graph:
 	//     [buffer] -> [fps] -> [scale] -> [settb] -> [buffersink]
+	//
+	// With the hardware acceleration:
+	//     [buffer] -> [fps] -> [scale_npp/scale_qsv/scale_vaapi] -> [settb] -> [buffersink] (the decoder and the encoder are on the same device)
+	//     [buffer] -> [fps] -> [hwdownload] -> [format] -> [scale] -> [settb] -> [buffersink] (only the decoder is on the device)
+	//     [buffer] -> [fps] -> [scale] -> [format] -> [hwupload] -> [settb] -> [buffersink] (only the encoder is on the device)
 
 	// Prepare the input filter
 
@@ -90,11 +174,11 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 */
 	// Removed framerate filter. because, Timestamp of frame is shifted. In case of not constant framerate as is VFR.
 	ov::String input_args = ov::String::FormatString(
-		"video_size=%dx%d:pix_fmt=%d:time_base=%d/%d:pixel_aspect=%d/%d:sws_param=flags=bicubic",
+		"video_size=%dx%d:pix_fmt=%d:time_base=%d/%d:pixel_aspect=%d/%d:sws_param=flags=%s",
 		input_media_track->GetWidth(), input_media_track->GetHeight(),
 		input_media_track->GetFormat(),
 		input_media_track->GetTimeBase().GetNum(), input_media_track->GetTimeBase().GetDen(),
-		1, 1);
+		1, 1, scale_flags);
 
 
 
@@ -105,15 +189,73 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 		return false;
 	}
 
+	// If the decoder outputs the frames on the device, the source filter needs the frames context of them
+	auto input_hw_accel = TranscodeHWAccelHelper::FromPixelFormat(input_media_track->GetFormat());
+	auto hw_frames_context = input_context->GetHWFramesContext();
+
+	if (input_hw_accel != TranscodeHWAccel::None)
+	{
+		if (hw_frames_context == nullptr)
+		{
+			logte("Could not obtain the frames context of %s", TranscodeHWAccelHelper::GetName(input_hw_accel));
+			return false;
+		}
+
+		AVBufferSrcParameters *parameters = ::av_buffersrc_parameters_alloc();
+
+		if (parameters == nullptr)
+		{
+			logte("Could not allocate parameters of the video buffer source filter");
+			return false;
+		}
+
+		parameters->hw_frames_ctx = hw_frames_context.get();
+
+		// av_buffersrc_parameters_set() takes its own reference of hw_frames_ctx
+		ret = ::av_buffersrc_parameters_set(_buffersrc_ctx, parameters);
+		::av_free(parameters);
+
+		if (ret < 0)
+		{
+			logte("Could not set the frames context to the video buffer source filter: %d", ret);
+			return false;
+		}
+	}
+
+	auto output_hw_accel = output_context->GetHWAccel();
+
 	// Prepare output filters
 	std::vector<ov::String> filters = {
 		// "fps" filter options
-		ov::String::FormatString("fps=fps=%.2f:0:round=near", output_context->GetFrameRate()),
+		ov::String::FormatString("fps=fps=%.2f:0:round=near", output_context->GetFrameRate())};
+
+	if ((input_hw_accel != TranscodeHWAccel::None) && (input_hw_accel == output_hw_accel))
+	{
+		// Decoder -> Scaler -> Encoder on the same device (the frames are not copied to the host memory)
+		filters.push_back(TranscodeHWAccelHelper::GetScaleFilter(output_hw_accel, output_context->GetVideoWidth(), output_context->GetVideoHeight()));
+	}
+	else
+	{
+		if (input_hw_accel != TranscodeHWAccel::None)
+		{
+			// The encoder is not on the device of the decoder
+			filters.push_back("hwdownload");
+			filters.push_back("format=nv12");
+		}
+
 		// "scale" filter options
-		ov::String::FormatString("scale=%dx%d:flags=bicubic", output_context->GetVideoWidth(), output_context->GetVideoHeight()),
-		// "settb" filter options
-		ov::String::FormatString("settb=%s", output_context->GetTimeBase().GetStringExpr().CStr()),
-	};
+		filters.push_back(TranscodeHWAccelHelper::GetScaleFilter(TranscodeHWAccel::None, output_context->GetVideoWidth(), output_context->GetVideoHeight(), scale_flags));
+
+		if (output_hw_accel != TranscodeHWAccel::None)
+		{
+			// Upload the scaled frames to the device of the encoder
+			filters.push_back("format=nv12");
+			filters.push_back("hwupload");
+		}
+	}
+
+	// "settb" filter options
+	filters.push_back(ov::String::FormatString("settb=%s", output_context->GetTimeBase().GetStringExpr().CStr()));
 
 	ov::String output_filters = ov::String::Join(filters, ",");
 
@@ -124,7 +266,9 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 		return false;
 	}
 
-	enum AVPixelFormat pix_fmts[] = {AV_PIX_FMT_YUV420P, AV_PIX_FMT_NONE};
+	enum AVPixelFormat pix_fmts[] = {
+		(output_hw_accel != TranscodeHWAccel::None) ? TranscodeHWAccelHelper::GetPixelFormat(output_hw_accel) : AV_PIX_FMT_YUV420P,
+		AV_PIX_FMT_NONE};
 
 	ret = av_opt_set_int_list(_buffersink_ctx, "pix_fmts", pix_fmts, AV_PIX_FMT_NONE, AV_OPT_SEARCH_CHILDREN);
 
@@ -150,6 +294,17 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 		return false;
 	}
 
+	if ((output_hw_accel != TranscodeHWAccel::None) && (input_hw_accel != output_hw_accel))
+	{
+		// hwupload uploads the frames to the device of the filter
+		auto device_context = TranscodeHWAccelHelper::GetDeviceContext(output_hw_accel);
+
+		for (unsigned int index = 0; index < _filter_graph->nb_filters; index++)
+		{
+			_filter_graph->filters[index]->hw_device_ctx = ::av_buffer_ref(device_context);
+		}
+	}
+
 	if ((ret = ::avfilter_graph_config(_filter_graph, nullptr)) < 0)
 	{
 		logte("Could not validate filter graph for rescaling: %d", ret);
@@ -158,23 +313,6 @@ bool MediaFilterRescaler::Configure(const std::shared_ptr<MediaTrack> &input_med
 
 	logtd("Rescaler is enabled for track #%u using parameters: input: %s, outputs: %s", input_media_track->GetId(), input_args.CStr(), output_filters.CStr());
 
-	_input_context = input_context;
-	_output_context = output_context;
-
-	// Generates a thread that reads and encodes frames in the input_buffer queue and places them in the output queue.
-	try
-	{
-		_kill_flag = false;
-
-		_thread_work = std::thread(&MediaFilterRescaler::TrheadFilter, this);
-	}
-	catch (const std::system_error &e)
-	{
-		_kill_flag = true;
-
-		logte("Failed to start transcode rescale filter thread.");
-	}
-
 	return true;
 }
 
@@ -210,9 +348,15 @@ void MediaFilterRescaler::TrheadFilter()
 {
 	logtd("Start transcode rescaler filter thread.");
 
+	ov::ThreadMetrics thread_metrics("Rescaler", ov::ThreadClass::Media);
+
 	while(!_kill_flag)
 	{
+		thread_metrics.BeginIdle();
 		_queue_event.Wait();
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
 
 		std::unique_lock<std::mutex> mlock(_mutex);
 
@@ -229,38 +373,63 @@ void MediaFilterRescaler::TrheadFilter()
 
 		//logtp("Dequeued data for rescaling: %lld (%.0f)\n%s", frame->GetPts(), frame->GetPts() * _output_context->GetTimeBase().GetExpr() * 1000.0f, ov::Dump(frame->GetBuffer(0), frame->GetBufferSize(0), 32).CStr());
 
-		_frame->format = frame->GetFormat();
-		_frame->width = frame->GetWidth();
-		_frame->height = frame->GetHeight();
-		_frame->pts = frame->GetPts() * _scale;
-		_frame->pkt_duration = frame->GetDuration();
+		// Refer the buffers of the decoder/filter (or the surface on the device) instead of copying the planes
+		if (TranscodeFrameHelper::RefVideoFrame(_frame, frame.get()))
+		{
+			_frame->pts = frame->GetPts() * _scale;
+			_frame->pkt_duration = frame->GetDuration();
+		}
+		else
+		{
+			_frame->format = frame->GetFormat();
+			_frame->width = frame->GetWidth();
+			_frame->height = frame->GetHeight();
+			_frame->pts = frame->GetPts() * _scale;
+			_frame->pkt_duration = frame->GetDuration();
+
+			_frame->linesize[0] = frame->GetStride(0);
+			_frame->linesize[1] = frame->GetStride(1);
+			_frame->linesize[2] = frame->GetStride(2);
+
+			int ret = ::av_frame_get_buffer(_frame, 32);
+			if (ret < 0)
+			{
+				logte("Could not allocate the video frame data\n");
 
-		_frame->linesize[0] = frame->GetStride(0);
-		_frame->linesize[1] = frame->GetStride(1);
-		_frame->linesize[2] = frame->GetStride(2);
+				// *result = TranscodeResult::DataError;
+				break;
+			}
 
-		int ret = ::av_frame_get_buffer(_frame, 32);
-		if (ret < 0)
-		{
-			logte("Could not allocate the video frame data\n");
+			ret = ::av_frame_make_writable(_frame);
+			if (ret < 0)
+			{
+				logte("Could not make writable frame: %d", ret);
 
-			// *result = TranscodeResult::DataError;
-			break;
+				// *result = TranscodeResult::DataError;
+				break;
+			}
+
+			// Copy data of frame to _frame
+			::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
+			::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
+			::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
 		}
 
-		ret = ::av_frame_make_writable(_frame);
-		if (ret < 0)
+		if (_use_swscale)
 		{
-			logte("Could not make writable frame: %d", ret);
+			auto output_frame = ScaleFrame(frame->GetDuration());
 
-			// *result = TranscodeResult::DataError;
-			break;
-		}
+			::av_frame_unref(_frame);
 
-		// Copy data of frame to _frame
-		::memcpy(_frame->data[0], frame->GetBuffer(0), frame->GetBufferSize(0));
-		::memcpy(_frame->data[1], frame->GetBuffer(1), frame->GetBufferSize(1));
-		::memcpy(_frame->data[2], frame->GetBuffer(2), frame->GetBufferSize(2));
+			if (output_frame != nullptr)
+			{
+				std::unique_lock<std::mutex> mlock(_mutex);
+
+				_output_buffer.push_back(std::move(output_frame));
+			}
+
+			continue;
+		}
 
 		if (::av_buffersrc_add_frame_flags(_buffersrc_ctx, _frame, AV_BUFFERSRC_FLAG_KEEP_REF) < 0)
 		{
@@ -309,13 +478,12 @@ void MediaFilterRescaler::TrheadFilter()
 				output_frame->SetPts((_frame->pts == AV_NOPTS_VALUE) ? -1LL : _frame->pts);
 				output_frame->SetDuration(_frame->pkt_duration * _scale);
 
-				output_frame->SetStride(_frame->linesize[0], 0);
-				output_frame->SetStride(_frame->linesize[1], 1);
-				output_frame->SetStride(_frame->linesize[2], 2);
-
-				output_frame->SetBuffer(_frame->data[0], output_frame->GetStride(0) * output_frame->GetHeight(), 0);	  // Y-Plane
-				output_frame->SetBuffer(_frame->data[1], output_frame->GetStride(1) * output_frame->GetHeight() / 2, 1);  // Cb Plane
-				output_frame->SetBuffer(_frame->data[2], output_frame->GetStride(2) * output_frame->GetHeight() / 2, 2);  // Cr Plane
+				// The encoders refer the buffers of the filter graph instead of copying the planes
+				if (TranscodeFrameHelper::AttachVideoFrame(output_frame.get(), _frame) == false)
+				{
+					::av_frame_unref(_frame);
+					break;
+				}
 
 				//logtp("Rescaled data: %lld (%.0f)\n%s", output_frame->GetPts(), output_frame->GetPts() * _output_context->GetTimeBase().GetExpr() * 1000.0f, ov::Dump(_frame->data[0], _frame->linesize[0], 32).CStr());
 
@@ -330,6 +498,85 @@ void MediaFilterRescaler::TrheadFilter()
 
 	}
 }
+
+std::shared_ptr<MediaFrame> MediaFilterRescaler::ScaleFrame(int64_t duration)
+{
+	auto width = static_cast<int>(_output_context->GetVideoWidth());
+	auto height = static_cast<int>(_output_context->GetVideoHeight());
+
+	// The context is created again only if the format/size of the input is changed
+	_sws_context = ::sws_getCachedContext(_sws_context,
+										  _frame->width, _frame->height, static_cast<AVPixelFormat>(_frame->format),
+										  width, height, AV_PIX_FMT_YUV420P,
+										  _sws_flags, nullptr, nullptr, nullptr);
+
+	if (_sws_context == nullptr)
+	{
+		logte("Could not create the scaler: %dx%d (format: %d) -> %dx%d", _frame->width, _frame->height, _frame->format, width, height);
+		return nullptr;
+	}
+
+	// The scaled frames are referenced by the encoder for a while, so the buffers are taken from a pool instead of allocating them every frame
+	// (the frame pool of the stream if any, so the renditions of the same size share the buffers)
+	int buffer_size = ::av_image_get_buffer_size(AV_PIX_FMT_YUV420P, width, height, 32);
+	auto frame_pool = _output_context->GetFramePool();
+
+	if ((frame_pool == nullptr) && ((_buffer_pool == nullptr) || (_buffer_pool_size != buffer_size)))
+	{
+		OV_SAFE_FUNC(_buffer_pool, nullptr, ::av_buffer_pool_uninit, &);
+
+		_buffer_pool = ::av_buffer_pool_init(buffer_size, nullptr);
+		_buffer_pool_size = buffer_size;
+
+		if (_buffer_pool == nullptr)
+		{
+			logte("Could not create the buffer pool of the scaler (%d bytes)", buffer_size);
+			return nullptr;
+		}
+	}
+
+	AVFrame *scaled_frame = ::av_frame_alloc();
+
+	if (scaled_frame == nullptr)
+	{
+		return nullptr;
+	}
+
+	scaled_frame->format = AV_PIX_FMT_YUV420P;
+	scaled_frame->width = width;
+	scaled_frame->height = height;
+	scaled_frame->buf[0] = (frame_pool != nullptr)
+							   ? frame_pool->AllocateAVBuffer(AV_PIX_FMT_YUV420P, width, height, 0, buffer_size)
+							   : ::av_buffer_pool_get(_buffer_pool);
+
+	if ((scaled_frame->buf[0] == nullptr) ||
+		(::av_image_fill_arrays(scaled_frame->data, scaled_frame->linesize, scaled_frame->buf[0]->data, AV_PIX_FMT_YUV420P, width, height, 32) < 0))
+	{
+		logte("Could not allocate the scaled frame");
+		::av_frame_free(&scaled_frame);
+		return nullptr;
+	}
+
+	::sws_scale(_sws_context, _frame->data, _frame->linesize, 0, _frame->height, scaled_frame->data, scaled_frame->linesize);
+
+	// Same as the "settb" filter
+	scaled_frame->pts = (_frame->pts == AV_NOPTS_VALUE) ? AV_NOPTS_VALUE : ::av_rescale_q(_frame->pts, _source_timebase, _sink_timebase);
+
+	auto output_frame = std::make_shared<MediaFrame>();
+
+	output_frame->SetFormat(scaled_frame->format);
+	output_frame->SetWidth(scaled_frame->width);
+	output_frame->SetHeight(scaled_frame->height);
+	output_frame->SetPts((scaled_frame->pts == AV_NOPTS_VALUE) ? -1LL : scaled_frame->pts);
+	output_frame->SetDuration(duration * _scale);
+
+	bool result = TranscodeFrameHelper::AttachVideoFrame(output_frame.get(), scaled_frame);
+
+	::av_frame_free(&scaled_frame);
+
+	return result ? output_frame : nullptr;
+}
+
 std::shared_ptr<MediaFrame> MediaFilterRescaler::RecvBuffer(TranscodeResult *result)
 {
 	std::unique_lock<std::mutex> mlock(_mutex);
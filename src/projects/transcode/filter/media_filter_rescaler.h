@@ -15,6 +15,12 @@
 
 #include "../transcode_context.h"
 
+extern "C"
+{
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
 class MediaFilterRescaler : public MediaFilterImpl
 {
 public:
@@ -31,5 +37,19 @@ public:
 	void Stop();
 
 protected:
+	bool ConfigureFilterGraph(const std::shared_ptr<MediaTrack> &input_media_track, const std::shared_ptr<TranscodeContext> &input_context, const std::shared_ptr<TranscodeContext> &output_context, const char *scale_flags);
+
+	// Scales _frame with swscale, and returns the frame that refers the scaled planes
+	std::shared_ptr<MediaFrame> ScaleFrame(int64_t duration);
+
+	// If true, the frames are scaled by swscale directly instead of the filter graph
+	bool _use_swscale = false;
+	int _sws_flags = SWS_BICUBIC;
+	SwsContext *_sws_context = nullptr;
+	AVBufferPool *_buffer_pool = nullptr;
+	int _buffer_pool_size = 0;
 
+	// The timebases of the "buffer" source and the sink (same as the filter graph)
+	AVRational _source_timebase = {1, 1};
+	AVRational _sink_timebase = {1, 1};
 };
@@ -0,0 +1,291 @@
+//==============================================================================
+//
+//  Transcode
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "media_filter_swresampler.h"
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include "../codec/transcode_frame_helper.h"
+
+#define OV_LOG_TAG "MediaFilter.SwResampler"
+
+MediaFilterSwResampler::~MediaFilterSwResampler()
+{
+	OV_SAFE_FUNC(_swr_context, nullptr, ::swr_free, &);
+
+	_input_buffer.clear();
+	_output_buffer.clear();
+}
+
+int32_t MediaFilterSwResampler::GetFrameSize(const std::shared_ptr<TranscodeContext> &output_context)
+{
+	switch (output_context->GetCodecId())
+	{
+		case common::MediaCodecId::Opus:
+			// 20ms (960 samples at 48000Hz)
+			return output_context->GetAudioSampleRate() / 50;
+
+		case common::MediaCodecId::Aac:
+			return 1024;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+bool MediaFilterSwResampler::Configure(const std::shared_ptr<MediaTrack> &input_media_track, const std::shared_ptr<TranscodeContext> &input_context, const std::shared_ptr<TranscodeContext> &output_context)
+{
+	_frame_size = GetFrameSize(output_context);
+
+	if (_frame_size <= 0)
+	{
+		logte("Could not determine the frame size of the output codec: %d", output_context->GetCodecId());
+		return false;
+	}
+
+	_input_format = static_cast<AVSampleFormat>(input_context->GetAudioSample().GetFormat());
+	_input_sample_rate = input_context->GetAudioSampleRate();
+	_input_channels = static_cast<int32_t>(input_context->GetAudioChannel().GetCounts());
+
+	_output_format = static_cast<AVSampleFormat>(output_context->GetAudioSample().GetFormat());
+	_output_sample_rate = output_context->GetAudioSampleRate();
+	_output_layout = output_context->GetAudioChannel().GetLayout();
+	_output_channels = static_cast<int32_t>(output_context->GetAudioChannel().GetCounts());
+
+	if ((_input_format == AV_SAMPLE_FMT_NONE) || (_input_sample_rate <= 0) || (_input_channels <= 0) ||
+		(_output_format == AV_SAMPLE_FMT_NONE) || (_output_sample_rate <= 0) || (_output_channels <= 0))
+	{
+		logte("Invalid audio parameters: input: %s, %dHz, %d channels, output: %s, %dHz, %d channels",
+			  input_context->GetAudioSample().GetName(), _input_sample_rate, _input_channels,
+			  output_context->GetAudioSample().GetName(), _output_sample_rate, _output_channels);
+		return false;
+	}
+
+	_input_timebase = TimebaseToAVRational(input_context->GetTimeBase());
+	_output_timebase = TimebaseToAVRational(output_context->GetTimeBase());
+
+	if ((_input_timebase.num <= 0) || (_input_timebase.den <= 0) || (_output_timebase.num <= 0) || (_output_timebase.den <= 0))
+	{
+		logte("Invalid timebase: input: %d/%d, output: %d/%d",
+			  _input_timebase.num, _input_timebase.den,
+			  _output_timebase.num, _output_timebase.den);
+
+		return false;
+	}
+
+	auto input_layout = static_cast<int64_t>(input_context->GetAudioChannel().GetLayout());
+
+	if (input_layout == 0LL)
+	{
+		input_layout = ::av_get_default_channel_layout(_input_channels);
+	}
+
+	_swr_context = ::swr_alloc_set_opts(nullptr,
+										static_cast<int64_t>(_output_layout), _output_format, _output_sample_rate,
+										input_layout, _input_format, _input_sample_rate,
+										0, nullptr);
+
+	if ((_swr_context == nullptr) || (::swr_init(_swr_context) < 0))
+	{
+		logte("Could not initialize the resampler");
+		OV_SAFE_FUNC(_swr_context, nullptr, ::swr_free, &);
+		return false;
+	}
+
+	bool is_planar = (::av_sample_fmt_is_planar(_output_format) != 0);
+
+	_plane_count = is_planar ? _output_channels : 1;
+	_plane_sample_size = ::av_get_bytes_per_sample(_output_format) * (is_planar ? 1 : _output_channels);
+
+	// Preallocate the FIFO to hold two frames with the samples converted from an input frame (AAC: 1024 samples)
+	_fifo.resize(_plane_count);
+	EnsureFifoSpace(_frame_size + ::swr_get_out_samples(_swr_context, 1024));
+
+	AVRational output_sample_timebase = {1, _output_sample_rate};
+	_frame_duration = ::av_rescale_q(_frame_size, output_sample_timebase, _output_timebase);
+	_resync_threshold = ::av_rescale_q(TRANSCODE_SWRESAMPLER_RESYNC_THRESHOLD_MS, (AVRational){1, 1000}, _output_timebase);
+
+	_input_context = input_context;
+	_output_context = output_context;
+
+	logtd("Resampler (swresample) is enabled for track #%u: input: %s, %dHz, %d channels, output: %s, %dHz, %d channels, frame size: %d",
+		  input_media_track->GetId(),
+		  input_context->GetAudioSample().GetName(), _input_sample_rate, _input_channels,
+		  output_context->GetAudioSample().GetName(), _output_sample_rate, _output_channels,
+		  _frame_size);
+
+	return true;
+}
+
+void MediaFilterSwResampler::EnsureFifoSpace(int32_t count)
+{
+	int32_t required = _fifo_samples + count;
+
+	if (required <= _fifo_capacity)
+	{
+		return;
+	}
+
+	// Grow with a margin, so the FIFO is not reallocated for every frame when the input frames are larger than expected
+	_fifo_capacity = std::max(required, _fifo_capacity * 2);
+
+	for (auto &plane : _fifo)
+	{
+		plane.resize(static_cast<size_t>(_fifo_capacity) * _plane_sample_size);
+	}
+}
+
+int32_t MediaFilterSwResampler::SendBuffer(std::shared_ptr<MediaFrame> buffer)
+{
+	auto frame = buffer.get();
+
+	if ((static_cast<AVSampleFormat>(frame->GetFormat()) != _input_format) ||
+		(frame->GetSampleRate() != _input_sample_rate) ||
+		(frame->GetChannels() != _input_channels))
+	{
+		logte("The frame doesn't match the resampler: format: %d (expected: %d), samplerate: %d (expected: %d), channels: %d (expected: %d)",
+			  frame->GetFormat(), _input_format, frame->GetSampleRate(), _input_sample_rate, frame->GetChannels(), _input_channels);
+		return -1;
+	}
+
+	int32_t input_samples = frame->GetNbSamples();
+
+	if (input_samples <= 0)
+	{
+		return 0;
+	}
+
+	if (frame->GetPts() >= 0)
+	{
+		// Timestamp of the first sample in the FIFO, derived from the frame
+		int64_t expected_pts = ::av_rescale_q(frame->GetPts(), _input_timebase, _output_timebase) -
+							   ::av_rescale_q(_fifo_samples + ::swr_get_delay(_swr_context, _output_sample_rate), (AVRational){1, _output_sample_rate}, _output_timebase);
+
+		if (_next_pts == AV_NOPTS_VALUE)
+		{
+			_next_pts = expected_pts;
+		}
+		else if (std::abs(expected_pts - _next_pts) > _resync_threshold)
+		{
+			logtd("Timestamp is resynchronized: %lld -> %lld", _next_pts, expected_pts);
+			_next_pts = expected_pts;
+		}
+	}
+	else if (_next_pts == AV_NOPTS_VALUE)
+	{
+		_next_pts = 0LL;
+	}
+
+	EnsureFifoSpace(::swr_get_out_samples(_swr_context, input_samples));
+
+	const uint8_t *input_planes[AV_NUM_DATA_POINTERS]{};
+	int input_plane_count = (::av_sample_fmt_is_planar(_input_format) != 0) ? _input_channels : 1;
+
+	for (int plane = 0; (plane < input_plane_count) && (plane < AV_NUM_DATA_POINTERS); plane++)
+	{
+		input_planes[plane] = frame->GetBuffer(plane);
+
+		if (input_planes[plane] == nullptr)
+		{
+			logte("Plane #%d of the frame is empty", plane);
+			return -1;
+		}
+	}
+
+	uint8_t *output_planes[AV_NUM_DATA_POINTERS]{};
+
+	for (int plane = 0; (plane < _plane_count) && (plane < AV_NUM_DATA_POINTERS); plane++)
+	{
+		output_planes[plane] = _fifo[plane].data() + (static_cast<size_t>(_fifo_samples) * _plane_sample_size);
+	}
+
+	int converted = ::swr_convert(_swr_context, output_planes, _fifo_capacity - _fifo_samples, input_planes, input_samples);
+
+	if (converted < 0)
+	{
+		logte("Could not convert the samples: %d", converted);
+		return -1;
+	}
+
+	_fifo_samples += converted;
+
+	PushFrames();
+
+	return 0;
+}
+
+void MediaFilterSwResampler::PushFrames()
+{
+	int32_t read_samples = 0;
+	size_t frame_bytes = static_cast<size_t>(_frame_size) * _plane_sample_size;
+	int32_t bytes_per_sample = ::av_get_bytes_per_sample(_output_format);
+	// The frames have the same shape, so the planes are recycled by the frame pool of the stream
+	auto frame_pool = _output_context->GetFramePool();
+
+	std::unique_lock<std::mutex> mlock(_mutex);
+
+	while ((_fifo_samples - read_samples) >= _frame_size)
+	{
+		auto output_frame = std::make_shared<MediaFrame>();
+
+		output_frame->SetFormat(_output_format);
+		output_frame->SetBytesPerSample(bytes_per_sample);
+		output_frame->SetNbSamples(_frame_size);
+		output_frame->SetChannelLayout(_output_layout);
+		output_frame->SetSampleRate(_output_sample_rate);
+		output_frame->SetPts(_next_pts);
+		output_frame->SetDuration(_frame_duration);
+
+		for (int plane = 0; plane < _plane_count; plane++)
+		{
+			TranscodeFrameHelper::CopyPlane(frame_pool, output_frame.get(), plane, _fifo[plane].data() + (static_cast<size_t>(read_samples) * _plane_sample_size), frame_bytes);
+		}
+
+		_output_buffer.push_back(std::move(output_frame));
+
+		read_samples += _frame_size;
+		_next_pts += _frame_duration;
+	}
+
+	mlock.unlock();
+
+	if (read_samples > 0)
+	{
+		// Move the remaining samples (less than a frame) to the front
+		_fifo_samples -= read_samples;
+
+		if (_fifo_samples > 0)
+		{
+			for (auto &plane : _fifo)
+			{
+				::memmove(plane.data(), plane.data() + (static_cast<size_t>(read_samples) * _plane_sample_size), static_cast<size_t>(_fifo_samples) * _plane_sample_size);
+			}
+		}
+	}
+}
+
+std::shared_ptr<MediaFrame> MediaFilterSwResampler::RecvBuffer(TranscodeResult *result)
+{
+	std::unique_lock<std::mutex> mlock(_mutex);
+
+	if (!_output_buffer.empty())
+	{
+		*result = TranscodeResult::DataReady;
+
+		auto frame = std::move(_output_buffer.front());
+		_output_buffer.pop_front();
+
+		return frame;
+	}
+
+	*result = TranscodeResult::NoData;
+
+	return nullptr;
+}
@@ -0,0 +1,80 @@
+//==============================================================================
+//
+//  Transcode
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+
+#pragma once
+
+#include "media_filter_impl.h"
+#include "base/media_route/media_buffer.h"
+#include "base/media_route/media_type.h"
+
+#include "../transcode_context.h"
+
+extern "C"
+{
+#include <libswresample/swresample.h>
+}
+
+// If the timestamp of the input differs from the expected timestamp more than this value, the output timestamp is resynchronized
+#define TRANSCODE_SWRESAMPLER_RESYNC_THRESHOLD_MS 100
+
+// Converts the sample rate/format/channel layout using libswresample directly, without building the avfilter graph.
+// The converted samples are stored in a preallocated FIFO, and are output by the frame size of the encoder.
+//
+// Unlike MediaFilterResampler, the conversion is done in SendBuffer() to avoid creating a thread for each stream.
+class MediaFilterSwResampler : public MediaFilterImpl
+{
+public:
+	MediaFilterSwResampler() = default;
+	~MediaFilterSwResampler() override;
+
+	// Returns the number of samples of a frame for the encoder of the output context.
+	// If the encoder doesn't have a fixed frame size, 0 is returned (MediaFilterResampler should be used instead).
+	static int32_t GetFrameSize(const std::shared_ptr<TranscodeContext> &output_context);
+
+	bool Configure(const std::shared_ptr<MediaTrack> &input_media_track, const std::shared_ptr<TranscodeContext> &input_context, const std::shared_ptr<TranscodeContext> &output_context) override;
+
+	int32_t SendBuffer(std::shared_ptr<MediaFrame> buffer) override;
+	std::shared_ptr<MediaFrame> RecvBuffer(TranscodeResult *result) override;
+
+protected:
+	// Makes sure that the FIFO can hold additional samples more than count
+	void EnsureFifoSpace(int32_t count);
+	void PushFrames();
+
+	SwrContext *_swr_context = nullptr;
+
+	AVSampleFormat _input_format = AV_SAMPLE_FMT_NONE;
+	int32_t _input_sample_rate = 0;
+	int32_t _input_channels = 0;
+
+	AVSampleFormat _output_format = AV_SAMPLE_FMT_NONE;
+	int32_t _output_sample_rate = 0;
+	int32_t _output_channels = 0;
+	common::AudioChannel::Layout _output_layout = common::AudioChannel::Layout::LayoutUnknown;
+
+	int32_t _frame_size = 0;
+	// Bytes per sample of a plane (= sample size * channels if the output format is interleaved)
+	int32_t _plane_sample_size = 0;
+	int32_t _plane_count = 0;
+
+	// Sample FIFO for each plane
+	std::vector<std::vector<uint8_t>> _fifo;
+	// The number of samples in the FIFO
+	int32_t _fifo_samples = 0;
+	// The capacity of the FIFO (unit: samples)
+	int32_t _fifo_capacity = 0;
+
+	AVRational _input_timebase{};
+	AVRational _output_timebase{};
+
+	// PTS of the first sample in the FIFO (in the output timebase)
+	int64_t _next_pts = AV_NOPTS_VALUE;
+	int64_t _frame_duration = 0LL;
+	int64_t _resync_threshold = 0LL;
+};
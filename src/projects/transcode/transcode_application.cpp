@@ -24,8 +24,8 @@ std::shared_ptr<TranscodeApplication> TranscodeApplication::Create(const info::A
 TranscodeApplication::TranscodeApplication(const info::Application &application_info)
 	: _application_info(application_info)
 {
-	// set alias
-	_indicator.SetAlias(ov::String::FormatString("%s - Transcode Application Indicator", _application_info.GetName().CStr()));
+	_audio_executor_group = TranscodeStream::GetAudioExecutor()->GetGroup(
+		_application_info.GetName().CStr(), _application_info.GetSchedulingWeight(), _application_info.GetMaxWorkerThreads());
 }
 
 TranscodeApplication::~TranscodeApplication()
@@ -35,30 +35,13 @@ TranscodeApplication::~TranscodeApplication()
 
 bool TranscodeApplication::Start()
 {
-
-	try
-	{
-		_kill_flag = false;
-		_thread_looptask = std::thread(&TranscodeApplication::MessageLooper, this);
-	}
-	catch (const std::system_error &e)
-	{
-		_kill_flag = true;
-		logte("Failed to start transcode stream thread");
-		return false;
-	}
-
+	// Each TranscodeStream runs its own pipeline threads
 	return true;
 }
 
 bool TranscodeApplication::Stop()
 {
-	_kill_flag = true;
-	
-	if (_thread_looptask.joinable())
-	{
-		_thread_looptask.join();
-	}
+	std::vector<ov::String> keys;
 
 	std::unique_lock<std::mutex> lock(_mutex);
 
@@ -66,23 +49,78 @@ bool TranscodeApplication::Stop()
 	{
 		auto stream = x.second;
 		stream->Stop();
+
+		keys.push_back(TranscodeScheduler::MakeKey(_application_info, *(stream->GetInputStream())));
+	}
+
+	for (const auto &x : _queued_streams)
+	{
+		keys.push_back(TranscodeScheduler::MakeKey(_application_info, *(x.second)));
 	}
 
 	_streams.clear();
+	_queued_streams.clear();
+
+	// Release() may start the queued streams of other applications
+	lock.unlock();
+
+	for (const auto &key : keys)
+	{
+		TranscodeScheduler::GetInstance()->Release(key);
+	}
 
 	return true;
 }
 
 bool TranscodeApplication::OnCreateStream(const std::shared_ptr<info::Stream> &stream_info)
 {
+	auto scheduler = TranscodeScheduler::GetInstance();
+	auto key = TranscodeScheduler::MakeKey(_application_info, *stream_info);
+
 	std::unique_lock<std::mutex> lock(_mutex);
 
+	auto admission = scheduler->Admit(
+		key, _application_info.GetName(), _application_info.GetSchedulingWeight(),
+		TranscodeStream::GetEncodeCosts(_application_info, stream_info),
+		[this, stream_info](const TranscodeScheduler::Admission &admission) {
+			OnStreamAdmitted(stream_info, admission);
+		});
+
+	switch (admission.result)
+	{
+		case TranscodeScheduler::AdmissionResult::Rejected:
+			return false;
+
+		case TranscodeScheduler::AdmissionResult::Queued:
+			_queued_streams[stream_info->GetId()] = stream_info;
+			return true;
+
+		case TranscodeScheduler::AdmissionResult::Admitted:
+		case TranscodeScheduler::AdmissionResult::Downgraded:
+			break;
+	}
+
+	if (StartStream(stream_info, admission) == false)
+	{
+		lock.unlock();
+		scheduler->Release(key);
+
+		return false;
+	}
+
+	return true;
+}
+
+bool TranscodeApplication::StartStream(const std::shared_ptr<info::Stream> &stream_info, const TranscodeScheduler::Admission &admission)
+{
 	auto stream = std::make_shared<TranscodeStream>(_application_info, stream_info, this);
 	if (stream == nullptr)
 	{
 		return false;
 	}
 
+	stream->SetExcludedProfiles(admission.excluded_profiles);
+
 	if(stream->Start() == false)
 	{
 		return false;
@@ -93,10 +131,48 @@ bool TranscodeApplication::OnCreateStream(const std::shared_ptr<info::Stream> &s
 	return true;
 }
 
+void TranscodeApplication::OnStreamAdmitted(const std::shared_ptr<info::Stream> &stream_info, const TranscodeScheduler::Admission &admission)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto item = _queued_streams.find(stream_info->GetId());
+
+	if (item == _queued_streams.end())
+	{
+		// The stream was deleted while releasing the budget
+		lock.unlock();
+		TranscodeScheduler::GetInstance()->Release(TranscodeScheduler::MakeKey(_application_info, *stream_info));
+
+		return;
+	}
+
+	_queued_streams.erase(item);
+
+	logti("[%s/%s(%u)] Starting the queued stream", _application_info.GetName().CStr(), stream_info->GetName().CStr(), stream_info->GetId());
+
+	if (StartStream(stream_info, admission) == false)
+	{
+		lock.unlock();
+		TranscodeScheduler::GetInstance()->Release(TranscodeScheduler::MakeKey(_application_info, *stream_info));
+	}
+}
+
 bool TranscodeApplication::OnDeleteStream(const std::shared_ptr<info::Stream> &stream_info)
 {
 	std::unique_lock<std::mutex> lock(_mutex);
 
+	auto key = TranscodeScheduler::MakeKey(_application_info, *stream_info);
+
+	if (_queued_streams.erase(stream_info->GetId()) > 0)
+	{
+		lock.unlock();
+
+		// Cancel the queued stream
+		TranscodeScheduler::GetInstance()->Release(key);
+
+		return true;
+	}
+
 	auto stream_bucket = _streams.find(stream_info->GetId());
 
 	if (stream_bucket == _streams.end())
@@ -110,6 +186,11 @@ bool TranscodeApplication::OnDeleteStream(const std::shared_ptr<info::Stream> &s
 
 	_streams.erase(stream_info->GetId());
 
+	lock.unlock();
+
+	// The queued streams may be started here
+	TranscodeScheduler::GetInstance()->Release(key);
+
 	return true;
 }
 
@@ -127,47 +208,47 @@ bool TranscodeApplication::OnSendFrame(const std::shared_ptr<info::Stream> &stre
 
 	auto stream = stream_bucket->second;
 
+	// Push() doesn't block, but the other streams don't need to wait for it
+	lock.unlock();
+
 	return stream->Push(packet);
 }
 
-
-bool TranscodeApplication::AppendIndicator(std::shared_ptr<TranscodeStream> stream, IndicatorQueueType queue_type)
+bool TranscodeApplication::OnKeyFrameRequested(const std::shared_ptr<info::Stream> &stream_info)
 {
-	_indicator.Enqueue( std::make_shared<BufferIndicator>(stream,queue_type) );
+	std::unique_lock<std::mutex> lock(_mutex);
 
-	return true;
-}
+	// Key: the id of the input stream, so find the transcode stream that created the output stream
+	auto streams = _streams;
 
-void TranscodeApplication::MessageLooper()
-{
-	while (!_kill_flag)
+	lock.unlock();
+
+	for (auto &stream : streams)
 	{
-		auto indicator_ref = _indicator.Dequeue(10);
-		if (indicator_ref.has_value() == false)
+		if (stream.second->RequestKeyFrame(stream_info))
 		{
-			// logti("There is no indicator"); 
-			continue;
+			return true;
 		}
+	}
+
+	return false;
+}
+
+bool TranscodeApplication::OnPacketLossReported(const std::shared_ptr<info::Stream> &stream_info, int32_t packet_loss_percentage)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	auto streams = _streams;
 
-		auto indicator = indicator_ref.value();
+	lock.unlock();
 
-		switch(indicator->_queue_type)
+	for (auto &stream : streams)
+	{
+		if (stream.second->ReportPacketLoss(stream_info, packet_loss_percentage))
 		{
-			case BUFFER_INDICATOR_INPUT_PACKETS:
-				indicator->_stream->DoInputPackets();
-				break;
-
-			case BUFFER_INDICATOR_DECODED_FRAMES:
-				indicator->_stream->DoDecodedFrames();
-				break;
-
-			case BUFFER_INDICATOR_FILTERED_FRAMES:
-				indicator->_stream->DoFilteredFrames();
-				break;
-			default:
-				break;
+			return true;
 		}
-
-		// logti("Append Indicator %p %d %d", indicator->_stream, indicator->_queue_type, _indicator.Size());
 	}
-}
\ No newline at end of file
+
+	return false;
+}
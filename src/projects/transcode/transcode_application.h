@@ -19,6 +19,7 @@
 #include "base/media_route/media_buffer.h"
 #include "base/info/stream.h"
 #include "transcode_stream.h"
+#include "transcode_scheduler.h"
 #include <base/ovlibrary/ovlibrary.h>
 
 class TranscodeApplication : public MediaRouteApplicationConnector, public MediaRouteApplicationObserver
@@ -60,44 +61,34 @@ public:
 
 	bool OnSendFrame(const std::shared_ptr<info::Stream> &stream, const std::shared_ptr<MediaPacket> &packet) override;
 
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	// MediaRouteApplicationConnector Implementation
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	// Called when a publisher requests a key frame of the output stream
+	bool OnKeyFrameRequested(const std::shared_ptr<info::Stream> &stream) override;
+	// Called when a publisher reports the packet loss of the players of the output stream
+	bool OnPacketLossReported(const std::shared_ptr<info::Stream> &stream, int32_t packet_loss_percentage) override;
+
+	// The group of the audio executor that the audio-only streams of the application run on (See <Scheduling>)
+	const std::shared_ptr<ov::Executor::Group> &GetAudioExecutorGroup() const
+	{
+		return _audio_executor_group;
+	}
+
 private:
+	// Creates and starts the TranscodeStream (Must be called while holding _mutex)
+	bool StartStream(const std::shared_ptr<info::Stream> &stream_info, const TranscodeScheduler::Admission &admission);
+	// Called by TranscodeScheduler when the queued stream is admitted
+	void OnStreamAdmitted(const std::shared_ptr<info::Stream> &stream_info, const TranscodeScheduler::Admission &admission);
+
 	const info::Application _application_info;
+	std::shared_ptr<ov::Executor::Group> _audio_executor_group;
 
 
 
 private:
 	std::map<int32_t, std::shared_ptr<TranscodeStream>> _streams;
+	// The streams waiting for the transcode budget
+	std::map<int32_t, std::shared_ptr<info::Stream>> _queued_streams;
 	std::mutex _mutex;
-
-	volatile bool _kill_flag;
-	void MessageLooper();
-	std::thread _thread_looptask;
-
-
-public:
-	enum IndicatorQueueType {
-		BUFFER_INDICATOR_INPUT_PACKETS = 0,
-		BUFFER_INDICATOR_DECODED_FRAMES,
-		BUFFER_INDICATOR_FILTERED_FRAMES
-	};	
-	
-	// Indicator
-	bool AppendIndicator(std::shared_ptr<TranscodeStream> stream, IndicatorQueueType _queue_type);
-
-	class BufferIndicator
-	{
-	public:
-		explicit BufferIndicator(std::shared_ptr<TranscodeStream> stream, IndicatorQueueType queue_type)
-		{
-			_stream = stream;
-			_queue_type = queue_type;
-		}
-
-		std::shared_ptr<TranscodeStream> _stream;
-		IndicatorQueueType _queue_type;
-	};
-	
-private:
-	ov::Queue<std::shared_ptr<BufferIndicator>> _indicator;
 };
-
@@ -120,6 +120,16 @@ int32_t TranscodeContext::GetGOP()
 	return _video_gop;
 }
 
+void TranscodeContext::SetKeyFrameAlignment(int32_t alignment)
+{
+	_key_frame_alignment = alignment;
+}
+
+int32_t TranscodeContext::GetKeyFrameAlignment() const
+{
+	return _key_frame_alignment;
+}
+
 void TranscodeContext::SetAudioSampleFormat(common::AudioSample::Format val)
 {
 	_audio_sample.SetFormat(val);
@@ -139,3 +149,153 @@ common::MediaType TranscodeContext::GetMediaType() const
 {
 	return _media_type;
 }
+
+void TranscodeContext::SetHWAccel(TranscodeHWAccel hw_accel)
+{
+	_hw_accel = hw_accel;
+}
+
+TranscodeHWAccel TranscodeContext::GetHWAccel() const
+{
+	return _hw_accel;
+}
+
+void TranscodeContext::SetHWFramesContext(const std::shared_ptr<AVBufferRef> &hw_frames_context)
+{
+	_hw_frames_context = hw_frames_context;
+}
+
+std::shared_ptr<AVBufferRef> TranscodeContext::GetHWFramesContext() const
+{
+	return _hw_frames_context;
+}
+
+void TranscodeContext::SetFramePool(const std::shared_ptr<TranscodeFramePool> &frame_pool)
+{
+	_frame_pool = frame_pool;
+}
+
+std::shared_ptr<TranscodeFramePool> TranscodeContext::GetFramePool() const
+{
+	return _frame_pool;
+}
+
+void TranscodeContext::SetPreset(const ov::String &preset)
+{
+	_preset = preset;
+}
+
+const ov::String &TranscodeContext::GetPreset() const
+{
+	return _preset;
+}
+
+void TranscodeContext::SetTune(const ov::String &tune)
+{
+	_tune = tune;
+}
+
+const ov::String &TranscodeContext::GetTune() const
+{
+	return _tune;
+}
+
+void TranscodeContext::SetThreadCount(int32_t thread_count)
+{
+	_thread_count = thread_count;
+}
+
+int32_t TranscodeContext::GetThreadCount() const
+{
+	return _thread_count;
+}
+
+void TranscodeContext::SetSliceThreads(bool slice_threads)
+{
+	_slice_threads = slice_threads;
+}
+
+bool TranscodeContext::IsSliceThreads() const
+{
+	return _slice_threads;
+}
+
+void TranscodeContext::SetLookahead(int32_t lookahead)
+{
+	_lookahead = lookahead;
+}
+
+int32_t TranscodeContext::GetLookahead() const
+{
+	return _lookahead;
+}
+
+void TranscodeContext::SetRateControl(const ov::String &rate_control)
+{
+	_rate_control = rate_control;
+}
+
+const ov::String &TranscodeContext::GetRateControl() const
+{
+	return _rate_control;
+}
+
+void TranscodeContext::SetInlineProcessing(bool inline_processing)
+{
+	_inline_processing = inline_processing;
+}
+
+bool TranscodeContext::IsInlineProcessing() const
+{
+	return _inline_processing;
+}
+
+void TranscodeContext::SetDecodeMode(const ov::String &decode_mode)
+{
+	_decode_mode = decode_mode.LowerCaseString();
+}
+
+const ov::String &TranscodeContext::GetDecodeMode() const
+{
+	return _decode_mode;
+}
+
+void TranscodeContext::SetScaleQuality(const ov::String &scale_quality)
+{
+	_scale_quality = scale_quality.LowerCaseString();
+}
+
+const ov::String &TranscodeContext::GetScaleQuality() const
+{
+	return _scale_quality;
+}
+
+void TranscodeContext::SetTemporalLayers(int32_t temporal_layers)
+{
+	_temporal_layers = temporal_layers;
+}
+
+int32_t TranscodeContext::GetTemporalLayers() const
+{
+	return _temporal_layers;
+}
+
+void TranscodeContext::SetInbandFec(bool inband_fec)
+{
+	_inband_fec = inband_fec;
+}
+
+bool TranscodeContext::IsInbandFec() const
+{
+	return _inband_fec;
+}
+
+void TranscodeContext::SetDtx(bool dtx)
+{
+	_dtx = dtx;
+}
+
+bool TranscodeContext::IsDtx() const
+{
+	return _dtx;
+}
@@ -14,6 +14,24 @@
 #include <base/ovlibrary/ovlibrary.h>
 #include "base/media_route/media_type.h"
 
+// Defined in libavutil/buffer.h
+struct AVBufferRef;
+
+// Defined in codec/transcode_frame_pool.h
+class TranscodeFramePool;
+
+enum class TranscodeHWAccel : int32_t
+{
+	// Software codecs (libx264, libvpx, ...)
+	None,
+	// NVDEC/NVENC with CUDA frames
+	Nvidia,
+	// Intel Quick Sync Video
+	Qsv,
+	// VA-API (Intel/AMD on Linux)
+	Vaapi
+};
+
 class TranscodeContext
 {
 public:
@@ -81,6 +99,11 @@ public:
 	void SetGOP(int32_t val);
 	int32_t GetGOP();
 
+	// A keyframe is forced at the first frame of each interval (in milliseconds) of the timeline, 0 = disabled
+	// (The renditions encoded from the same frames have the keyframes at the same timestamps)
+	void SetKeyFrameAlignment(int32_t alignment);
+	int32_t GetKeyFrameAlignment() const;
+
 	void SetFrameRate(float val);
 	float GetFrameRate();
 
@@ -97,6 +120,68 @@ public:
 
 	common::MediaType GetMediaType() const;
 
+	//--------------------------------------------------------------------
+	// Hardware acceleration
+	//--------------------------------------------------------------------
+	void SetHWAccel(TranscodeHWAccel hw_accel);
+	TranscodeHWAccel GetHWAccel() const;
+
+	// The AVHWFramesContext of the frames produced by the hardware decoder.
+	// The filters use it to keep the frames on the device.
+	void SetHWFramesContext(const std::shared_ptr<AVBufferRef> &hw_frames_context);
+	std::shared_ptr<AVBufferRef> GetHWFramesContext() const;
+
+	// The buffers of the frames of the stream (See TranscodeFramePool)
+	// nullptr if the frames are allocated from the heap (such as the thumbnail decoder)
+	void SetFramePool(const std::shared_ptr<TranscodeFramePool> &frame_pool);
+	std::shared_ptr<TranscodeFramePool> GetFramePool() const;
+
+	//--------------------------------------------------------------------
+	// Encoder options (<Encode><Video>)
+	//--------------------------------------------------------------------
+	void SetPreset(const ov::String &preset);
+	const ov::String &GetPreset() const;
+
+	void SetTune(const ov::String &tune);
+	const ov::String &GetTune() const;
+
+	// 0 = let the encoder decide
+	void SetThreadCount(int32_t thread_count);
+	int32_t GetThreadCount() const;
+
+	void SetSliceThreads(bool slice_threads);
+	bool IsSliceThreads() const;
+
+	// -1 = use the value of the preset/tune
+	void SetLookahead(int32_t lookahead);
+	int32_t GetLookahead() const;
+
+	void SetRateControl(const ov::String &rate_control);
+	const ov::String &GetRateControl() const;
+
+	// If true, the audio filters/encoders process the frames in SendBuffer() instead of their own threads
+	// (The stream runs them on the audio transcode pool, See TranscodeStream::GetAudioExecutor())
+	void SetInlineProcessing(bool inline_processing);
+	bool IsInlineProcessing() const;
+
+	// auto, lowdelay or throughput (See <Decode><Video><Mode>)
+	void SetDecodeMode(const ov::String &decode_mode);
+	const ov::String &GetDecodeMode() const;
+
+	// quality, balanced or speed (See <Encode><Video><ScaleQuality>)
+	void SetScaleQuality(const ov::String &scale_quality);
+	const ov::String &GetScaleQuality() const;
+
+	// The number of the temporal layers (See <Encode><Video><TemporalLayers>, only VP8 supports it)
+	void SetTemporalLayers(int32_t temporal_layers);
+	int32_t GetTemporalLayers() const;
+
+	// See <Encode><Audio><InbandFEC> and <DTX> (only OPUS supports them)
+	void SetInbandFec(bool inband_fec);
+	bool IsInbandFec() const;
+	void SetDtx(bool dtx);
+	bool IsDtx() const;
+
 private:
 	// Context type
 	//    true = this context will be used for encoding
@@ -124,6 +209,8 @@ private:
 	// GOP : Group Of Picture
 	int32_t _video_gop;
 
+	int32_t _key_frame_alignment = 0;
+
 	common::MediaType _media_type;
 
 	// Sample type
@@ -131,4 +218,21 @@ private:
 
 	// Channel
 	common::AudioChannel _audio_channel;
+
+	TranscodeHWAccel _hw_accel = TranscodeHWAccel::None;
+	std::shared_ptr<AVBufferRef> _hw_frames_context;
+	std::shared_ptr<TranscodeFramePool> _frame_pool;
+
+	ov::String _preset = "ultrafast";
+	ov::String _tune = "zerolatency";
+	int32_t _thread_count = 0;
+	bool _slice_threads = false;
+	int32_t _lookahead = -1;
+	ov::String _rate_control = "cbr";
+	ov::String _scale_quality = "quality";
+	int32_t _temporal_layers = 1;
+	bool _inband_fec = true;
+	bool _dtx = false;
+	ov::String _decode_mode = "auto";
+	bool _inline_processing = false;
 };
@@ -0,0 +1,125 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_degrade_ladder.h"
+
+#include <monitoring/monitoring.h>
+
+// The minimum interval between the steps while the stages are overloaded (the previous step needs time to take effect)
+#define TRANSCODE_DEGRADE_STEP_INTERVAL_MS 1000
+
+// The filter stage waits for the encoders when they are busy, so it is hardly idle if an encoder cannot keep up
+#define TRANSCODE_DEGRADE_HIGH_BUSY_RATIO 0.95
+#define TRANSCODE_DEGRADE_LOW_BUSY_RATIO 0.8
+
+void TranscodeDegradeLadder::Configure(bool is_enabled, double high_watermark, double low_watermark, int64_t recovery_time_ms)
+{
+	_is_enabled = is_enabled;
+	_high_watermark = high_watermark;
+	_low_watermark = low_watermark;
+	_recovery_time_ms = recovery_time_ms;
+}
+
+bool TranscodeDegradeLadder::IsEnabled()
+{
+	return _is_enabled;
+}
+
+TranscodeDegradeLadder::~TranscodeDegradeLadder()
+{
+	if (_level != TranscodeDegradeLevel::None)
+	{
+		// The stream is not degraded anymore
+		MonitorInstance->GetTranscodeMetrics().OnDegradeLevelChanged(static_cast<int32_t>(_level.load()), 0, false);
+	}
+}
+
+bool TranscodeDegradeLadder::Update(double queue_pressure, double busy_ratio)
+{
+	auto now = std::chrono::steady_clock::now();
+	auto level = _level.load();
+
+	if ((queue_pressure >= _high_watermark) || (busy_ratio >= TRANSCODE_DEGRADE_HIGH_BUSY_RATIO))
+	{
+		_is_relieved = false;
+
+		if ((now - _last_step_time) < std::chrono::milliseconds(TRANSCODE_DEGRADE_STEP_INTERVAL_MS))
+		{
+			return false;
+		}
+
+		_last_step_time = now;
+
+		if (level == TranscodeDegradeLevel::SkipToKeyFrame)
+		{
+			// Still overloaded at the last step, skip again
+			_skip_to_key_frame_sequence++;
+			return false;
+		}
+
+		SetLevel(static_cast<TranscodeDegradeLevel>(static_cast<int32_t>(level) + 1));
+
+		return true;
+	}
+
+	if ((queue_pressure > _low_watermark) || (busy_ratio >= TRANSCODE_DEGRADE_LOW_BUSY_RATIO))
+	{
+		_is_relieved = false;
+		return false;
+	}
+
+	if (_is_relieved == false)
+	{
+		_is_relieved = true;
+		_relieved_time = now;
+
+		return false;
+	}
+
+	if ((level == TranscodeDegradeLevel::None) || ((now - _relieved_time) < std::chrono::milliseconds(_recovery_time_ms.load())))
+	{
+		return false;
+	}
+
+	// Restores one step at a time, the next step is restored after the recovery time again
+	_last_step_time = now;
+	_relieved_time = now;
+
+	SetLevel(static_cast<TranscodeDegradeLevel>(static_cast<int32_t>(level) - 1));
+
+	return true;
+}
+
+void TranscodeDegradeLadder::SetLevel(TranscodeDegradeLevel level)
+{
+	auto old_level = _level.exchange(level);
+
+	if (level == TranscodeDegradeLevel::SkipToKeyFrame)
+	{
+		_skip_to_key_frame_sequence++;
+	}
+
+	MonitorInstance->GetTranscodeMetrics().OnDegradeLevelChanged(static_cast<int32_t>(old_level), static_cast<int32_t>(level), level > old_level);
+}
+
+const char *TranscodeDegradeLadder::GetLevelName(TranscodeDegradeLevel level)
+{
+	switch (level)
+	{
+		case TranscodeDegradeLevel::None:
+			return "none";
+		case TranscodeDegradeLevel::SkipNonReference:
+			return "skip_non_reference";
+		case TranscodeDegradeLevel::HalveFrameRate:
+			return "halve_frame_rate";
+		case TranscodeDegradeLevel::SkipToKeyFrame:
+			return "skip_to_key_frame";
+	}
+
+	return "unknown";
+}
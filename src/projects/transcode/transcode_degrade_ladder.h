@@ -0,0 +1,74 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// The steps a transcode stream takes in turn when it cannot keep up, a step includes the previous steps
+enum class TranscodeDegradeLevel : int32_t
+{
+	// All frames are decoded and encoded
+	None = 0,
+	// The decoders discard the non-reference frames (skip_frame = AVDISCARD_NONREF)
+	SkipNonReference,
+	// The lower renditions are encoded at the half frame rate
+	HalveFrameRate,
+	// The decoders drop the packets until the next key frame
+	SkipToKeyFrame
+};
+
+// Degrades a transcode stream step by step while its stages are overloaded, so the latency is bounded
+// instead of the frame rate (See <Performance><TranscodeDegrade> of Server.xml)
+//
+// Update() is called by one thread (the filter stage), and the level is read by the other stages
+class TranscodeDegradeLadder
+{
+public:
+	static void Configure(bool is_enabled, double high_watermark, double low_watermark, int64_t recovery_time_ms);
+	static bool IsEnabled();
+
+	TranscodeDegradeLadder() = default;
+	~TranscodeDegradeLadder();
+
+	// queue_pressure: the depth of the fullest queue of the stages relative to its limit (1.0 = full)
+	// busy_ratio: the time the filter stage spent for the frames relative to the elapsed time (1.0 = never idle)
+	// Returns true if the level is changed
+	bool Update(double queue_pressure, double busy_ratio);
+
+	TranscodeDegradeLevel GetLevel() const
+	{
+		return _level;
+	}
+
+	// Increased whenever the decoders must drop the packets until the next key frame
+	uint32_t GetSkipToKeyFrameSequence() const
+	{
+		return _skip_to_key_frame_sequence;
+	}
+
+	static const char *GetLevelName(TranscodeDegradeLevel level);
+
+private:
+	void SetLevel(TranscodeDegradeLevel level);
+
+	std::atomic<TranscodeDegradeLevel> _level{TranscodeDegradeLevel::None};
+	std::atomic<uint32_t> _skip_to_key_frame_sequence{0};
+
+	std::chrono::steady_clock::time_point _last_step_time;
+	// Whether the stages are under the low watermark, and since when
+	bool _is_relieved = false;
+	std::chrono::steady_clock::time_point _relieved_time;
+
+	inline static std::atomic<bool> _is_enabled{true};
+	inline static std::atomic<double> _high_watermark{0.5};
+	inline static std::atomic<double> _low_watermark{0.1};
+	inline static std::atomic<int64_t> _recovery_time_ms{3000};
+};
@@ -2,6 +2,7 @@
 
 #include "filter/media_filter_resampler.h"
 #include "filter/media_filter_rescaler.h"
+#include "filter/media_filter_swresampler.h"
 
 using namespace common;
 
@@ -37,6 +38,22 @@ bool TranscodeFilter::Configure(std::shared_ptr<MediaTrack> input_media_track, s
 	switch(type)
 	{
 		case MediaType::Audio:
+			// Only the samplerate/format/channel layout are changed for the encoders which have a fixed frame size,
+			// so libswresample is used directly instead of the filter graph
+			if (MediaFilterSwResampler::GetFrameSize(output_context) > 0)
+			{
+				auto swresampler = new MediaFilterSwResampler();
+
+				if (swresampler->Configure(input_media_track, input_context, output_context))
+				{
+					_impl = swresampler;
+					return true;
+				}
+
+				logtw("Could not create the swresample filter. The filter graph will be used instead. track_id(%d)", input_media_track->GetId());
+				delete swresampler;
+			}
+
 			_impl = new MediaFilterResampler();
 			break;
 		case MediaType::Video:
@@ -0,0 +1,304 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_scheduler.h"
+
+#include <monitoring/monitoring.h>
+
+#include <algorithm>
+
+#define OV_LOG_TAG "TranscodeScheduler"
+
+TranscodeScheduler *TranscodeScheduler::GetInstance()
+{
+	static TranscodeScheduler scheduler;
+
+	return &scheduler;
+}
+
+void TranscodeScheduler::Configure(const cfg::TranscodeBudget &config)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (config.IsEnabled())
+	{
+		_cpu_budget = static_cast<int64_t>(config.GetCPUMegaPixelsPerSecond() * 1000000.0);
+		_gpu_budget = static_cast<int64_t>(config.GetGPUMegaPixelsPerSecond() * 1000000.0);
+		_policy = ParsePolicy(config.GetPolicy());
+
+		logti("Transcode budget is enabled (CPU: %.1f Mpx/s, GPU: %.1f Mpx/s, policy: %s)",
+			  config.GetCPUMegaPixelsPerSecond(), config.GetGPUMegaPixelsPerSecond(), GetPolicyName(_policy));
+	}
+	else
+	{
+		_cpu_budget = 0;
+		_gpu_budget = 0;
+		_policy = Policy::Downgrade;
+	}
+
+	UpdateMetrics();
+}
+
+TranscodeScheduler::Admission TranscodeScheduler::Admit(const ov::String &key, const ov::String &tenant, int weight, const std::vector<EncodeCost> &cost_list, AdmissionCallback callback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	auto &metrics = mon::Monitoring::GetInstance()->GetTranscodeMetrics();
+	auto reservation = GetReservation(cost_list);
+	auto budget = GetBudget(weight);
+	Admission admission;
+
+	reservation.tenant = tenant;
+
+	if (IsAvailable(reservation, budget))
+	{
+		Reserve(key, reservation, weight);
+		metrics.OnStreamAdmitted();
+
+		return admission;
+	}
+
+	// A stream that exceeds the whole budget of the tenant will never be admitted, so downgrade it instead of queueing it
+	bool can_be_admitted_later = ((budget.cpu == 0) || (reservation.cpu_usage <= budget.cpu)) &&
+								 ((budget.gpu == 0) || (reservation.gpu_usage <= budget.gpu));
+
+	if ((_policy == Policy::Queue) && can_be_admitted_later)
+	{
+		_queued_stream_list.push_back({key, reservation, weight, std::move(callback)});
+		UpdateMetrics();
+
+		logti("[%s] The stream is queued (CPU: %.1f Mpx/s, GPU: %.1f Mpx/s required, %zu streams are queued)",
+			  key.CStr(), reservation.cpu_usage / 1000000.0, reservation.gpu_usage / 1000000.0, _queued_stream_list.size());
+
+		admission.result = AdmissionResult::Queued;
+		return admission;
+	}
+
+	if (_policy == Policy::Reject)
+	{
+		metrics.OnStreamRejected();
+
+		logtw("[%s] The stream is rejected (CPU: %.1f Mpx/s, GPU: %.1f Mpx/s required)",
+			  key.CStr(), reservation.cpu_usage / 1000000.0, reservation.gpu_usage / 1000000.0);
+
+		admission.result = AdmissionResult::Rejected;
+		return admission;
+	}
+
+	// Add the renditions in the order of the configuration while they fit
+	Reservation downgraded_reservation;
+	downgraded_reservation.tenant = tenant;
+
+	for (auto &cost : cost_list)
+	{
+		if (IsAvailable(cost, downgraded_reservation, budget))
+		{
+			(cost.is_hw_accelerated ? downgraded_reservation.gpu_usage : downgraded_reservation.cpu_usage) += cost.pixels_per_second;
+		}
+		else
+		{
+			admission.excluded_profiles.insert(cost.profile_name);
+		}
+	}
+
+	Reserve(key, downgraded_reservation, weight);
+	metrics.OnStreamAdmitted();
+	metrics.OnStreamDowngraded();
+
+	logtw("[%s] The stream is downgraded, %zu of %zu renditions are excluded (CPU: %.1f/%.1f Mpx/s, GPU: %.1f/%.1f Mpx/s, weight: %d)",
+		  key.CStr(), admission.excluded_profiles.size(), cost_list.size(),
+		  _cpu_usage / 1000000.0, budget.cpu / 1000000.0, _gpu_usage / 1000000.0, budget.gpu / 1000000.0, weight);
+
+	admission.result = AdmissionResult::Downgraded;
+	return admission;
+}
+
+void TranscodeScheduler::Release(const ov::String &key)
+{
+	std::vector<QueuedStream> admitted_stream_list;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		auto item = _reservation_map.find(key);
+
+		if (item != _reservation_map.end())
+		{
+			_cpu_usage -= item->second.cpu_usage;
+			_gpu_usage -= item->second.gpu_usage;
+
+			auto tenant = _tenant_map.find(item->second.tenant);
+
+			if ((tenant != _tenant_map.end()) && (--tenant->second.stream_count <= 0))
+			{
+				_tenant_map.erase(tenant);
+			}
+
+			_reservation_map.erase(item);
+		}
+		else
+		{
+			// Cancel the queued stream
+			_queued_stream_list.erase(
+				std::remove_if(_queued_stream_list.begin(), _queued_stream_list.end(), [&key](const QueuedStream &queued_stream) -> bool {
+					return queued_stream.key == key;
+				}),
+				_queued_stream_list.end());
+		}
+
+		// Admit the queued streams in FIFO order (A large stream must not be starved by the small streams behind it)
+		while ((_queued_stream_list.empty() == false) &&
+			   IsAvailable(_queued_stream_list.front().reservation, GetBudget(_queued_stream_list.front().weight)))
+		{
+			auto &queued_stream = _queued_stream_list.front();
+
+			Reserve(queued_stream.key, queued_stream.reservation, queued_stream.weight);
+			mon::Monitoring::GetInstance()->GetTranscodeMetrics().OnStreamAdmitted();
+
+			logti("[%s] The queued stream is admitted", queued_stream.key.CStr());
+
+			admitted_stream_list.push_back(std::move(queued_stream));
+			_queued_stream_list.erase(_queued_stream_list.begin());
+		}
+
+		UpdateMetrics();
+	}
+
+	std::lock_guard<std::recursive_mutex> callback_lock(_callback_mutex);
+
+	for (auto &admitted_stream : admitted_stream_list)
+	{
+		if (admitted_stream.callback != nullptr)
+		{
+			admitted_stream.callback(Admission());
+		}
+	}
+}
+
+ov::String TranscodeScheduler::MakeKey(const info::Application &application_info, const info::Stream &stream_info)
+{
+	return ov::String::FormatString("%s/%s(%u)", application_info.GetName().CStr(), stream_info.GetName().CStr(), stream_info.GetId());
+}
+
+TranscodeScheduler::Policy TranscodeScheduler::ParsePolicy(ov::String policy)
+{
+	policy.MakeLower();
+
+	if (policy == "queue")
+	{
+		return Policy::Queue;
+	}
+	else if (policy == "reject")
+	{
+		return Policy::Reject;
+	}
+	else if (policy != "downgrade")
+	{
+		logtw("Unknown transcode budget policy: %s, downgrade will be used", policy.CStr());
+	}
+
+	return Policy::Downgrade;
+}
+
+const char *TranscodeScheduler::GetPolicyName(Policy policy)
+{
+	switch (policy)
+	{
+		case Policy::Downgrade:
+			return "downgrade";
+
+		case Policy::Queue:
+			return "queue";
+
+		case Policy::Reject:
+			return "reject";
+	}
+
+	return "unknown";
+}
+
+TranscodeScheduler::Reservation TranscodeScheduler::GetReservation(const std::vector<EncodeCost> &cost_list)
+{
+	Reservation reservation;
+
+	for (auto &cost : cost_list)
+	{
+		(cost.is_hw_accelerated ? reservation.gpu_usage : reservation.cpu_usage) += cost.pixels_per_second;
+	}
+
+	return reservation;
+}
+
+TranscodeScheduler::Budget TranscodeScheduler::GetBudget(int weight) const
+{
+	int max_weight = weight;
+
+	for (auto &item : _tenant_map)
+	{
+		max_weight = std::max(max_weight, item.second.weight);
+	}
+
+	Budget budget;
+
+	budget.cpu = _cpu_budget * weight / std::max(max_weight, 1);
+	budget.gpu = _gpu_budget * weight / std::max(max_weight, 1);
+
+	// A budget must not become unlimited by the weight
+	budget.cpu = ((_cpu_budget > 0) && (budget.cpu == 0)) ? 1 : budget.cpu;
+	budget.gpu = ((_gpu_budget > 0) && (budget.gpu == 0)) ? 1 : budget.gpu;
+
+	return budget;
+}
+
+bool TranscodeScheduler::IsAvailable(const Reservation &reservation, const Budget &budget) const
+{
+	return ((budget.cpu == 0) || ((_cpu_usage + reservation.cpu_usage) <= budget.cpu)) &&
+		   ((budget.gpu == 0) || ((_gpu_usage + reservation.gpu_usage) <= budget.gpu));
+}
+
+bool TranscodeScheduler::IsAvailable(const EncodeCost &cost, const Reservation &reserved, const Budget &budget) const
+{
+	if (cost.is_hw_accelerated)
+	{
+		return (budget.gpu == 0) || ((_gpu_usage + reserved.gpu_usage + cost.pixels_per_second) <= budget.gpu);
+	}
+
+	return (budget.cpu == 0) || ((_cpu_usage + reserved.cpu_usage + cost.pixels_per_second) <= budget.cpu);
+}
+
+void TranscodeScheduler::Reserve(const ov::String &key, const Reservation &reservation, int weight)
+{
+	auto &current_reservation = _reservation_map[key];
+
+	if (current_reservation.tenant.IsEmpty())
+	{
+		auto &tenant = _tenant_map[reservation.tenant];
+
+		tenant.weight = weight;
+		tenant.stream_count++;
+
+		current_reservation.tenant = reservation.tenant;
+	}
+
+	current_reservation.cpu_usage += reservation.cpu_usage;
+	current_reservation.gpu_usage += reservation.gpu_usage;
+
+	_cpu_usage += reservation.cpu_usage;
+	_gpu_usage += reservation.gpu_usage;
+
+	UpdateMetrics();
+}
+
+void TranscodeScheduler::UpdateMetrics()
+{
+	auto &metrics = mon::Monitoring::GetInstance()->GetTranscodeMetrics();
+
+	metrics.SetBudget(_cpu_budget, _gpu_budget);
+	metrics.SetUsage(_cpu_usage, _gpu_usage);
+	metrics.SetQueuedStreamCount(static_cast<uint32_t>(_queued_stream_list.size()));
+}
@@ -0,0 +1,144 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <base/info/application.h>
+#include <base/info/stream.h>
+#include <base/ovlibrary/ovlibrary.h>
+#include <config/config_manager.h>
+
+// Admission control of the transcode streams
+//
+// - The cost of a stream is the sum of width * height * framerate of its video encoders
+//   (Audio encoders and bypass tracks are not counted)
+// - The budget is shared by all applications of the server
+// - The streams of an application (tenant) can fill the budget up to (its weight / the largest weight of the tenants
+//   that have streams), so the tenants of lower weights are downgraded (or queued) first, and the rest of the budget
+//   is left to the tenants of higher weights (See <Scheduling>)
+class TranscodeScheduler
+{
+public:
+	enum class Policy : int32_t
+	{
+		// Start the renditions that fit in the budget
+		Downgrade,
+		// Wait until the budget is released
+		Queue,
+		// Do not start the stream
+		Reject
+	};
+
+	enum class AdmissionResult : int32_t
+	{
+		Admitted,
+		// Some renditions were excluded
+		Downgraded,
+		// The callback will be called when the stream is admitted
+		Queued,
+		Rejected
+	};
+
+	struct EncodeCost
+	{
+		// The name of <Encode>
+		ov::String profile_name;
+		int64_t pixels_per_second = 0;
+		bool is_hw_accelerated = false;
+	};
+
+	struct Admission
+	{
+		AdmissionResult result = AdmissionResult::Admitted;
+		// The profiles that must not be encoded
+		std::set<ov::String> excluded_profiles;
+	};
+
+	// Called when a queued stream is admitted (from the thread that released the budget)
+	typedef std::function<void(const Admission &admission)> AdmissionCallback;
+
+	static TranscodeScheduler *GetInstance();
+
+	void Configure(const cfg::TranscodeBudget &config);
+
+	// key must be unique per stream (see MakeKey())
+	// tenant: The name of the application, weight: the weight of the application (See info::Application::GetSchedulingWeight())
+	Admission Admit(const ov::String &key, const ov::String &tenant, int weight, const std::vector<EncodeCost> &cost_list, AdmissionCallback callback);
+	// Releases the budget of the stream (or cancels the queued stream), and admits the queued streams
+	void Release(const ov::String &key);
+
+	static ov::String MakeKey(const info::Application &application_info, const info::Stream &stream_info);
+
+	static Policy ParsePolicy(ov::String policy);
+	static const char *GetPolicyName(Policy policy);
+
+protected:
+	struct Reservation
+	{
+		int64_t cpu_usage = 0;
+		int64_t gpu_usage = 0;
+		ov::String tenant;
+	};
+
+	struct QueuedStream
+	{
+		ov::String key;
+		Reservation reservation;
+		int weight = 100;
+		AdmissionCallback callback;
+	};
+
+	struct Tenant
+	{
+		int weight = 100;
+		// The number of the streams that have the reservations
+		int stream_count = 0;
+	};
+
+	// The part of the budget that the streams of a tenant can fill (0 = unlimited)
+	struct Budget
+	{
+		int64_t cpu = 0;
+		int64_t gpu = 0;
+	};
+
+	static Reservation GetReservation(const std::vector<EncodeCost> &cost_list);
+
+	// Must be called while holding _mutex
+	Budget GetBudget(int weight) const;
+	bool IsAvailable(const Reservation &reservation, const Budget &budget) const;
+	bool IsAvailable(const EncodeCost &cost, const Reservation &reserved, const Budget &budget) const;
+	void Reserve(const ov::String &key, const Reservation &reservation, int weight);
+	void UpdateMetrics();
+
+	std::mutex _mutex;
+
+	// 0 = unlimited
+	int64_t _cpu_budget = 0;
+	int64_t _gpu_budget = 0;
+	Policy _policy = Policy::Downgrade;
+
+	int64_t _cpu_usage = 0;
+	int64_t _gpu_usage = 0;
+
+	// Key: the key of the stream
+	std::map<ov::String, Reservation> _reservation_map;
+	// Key: the name of the tenant
+	std::map<ov::String, Tenant> _tenant_map;
+	std::vector<QueuedStream> _queued_stream_list;
+
+	// Held while calling the callbacks, so Release() can't return while the callback of the stream is running
+	// (The callback may call Release() again)
+	std::recursive_mutex _callback_mutex;
+};
@@ -10,10 +10,26 @@
 #include "transcode_application.h"
 #include "transcode_stream.h"
 
+#include <base/info/media_extradata.h>
+#include <base/media_route/media_queue_policy.h>
+#include <base/ovlibrary/probe.h>
 #include <config/config_manager.h>
+#include <monitoring/monitoring.h>
+#include <modules/h264/h264_sps.h>
+#include <monitoring/packet_tracer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 #define OV_LOG_TAG "TranscodeStream"
 
+// The number of the packets whose decoded frames are not output yet (See DecodeDelay)
+#define TRANSCODE_DECODE_DELAY_MAX_PENDING 64
+
+// How often the filter stage checks the load of the stages (See TranscodeDegradeLadder)
+#define TRANSCODE_DEGRADE_UPDATE_INTERVAL_MS 200
+
 TranscodeStream::TranscodeStream(const info::Application &application_info, const std::shared_ptr<info::Stream> &stream, TranscodeApplication *parent)
 	: _application_info(application_info)
 {
@@ -27,20 +43,10 @@ TranscodeStream::TranscodeStream(const info::Application &application_info, cons
 
 	// Store Stream information
 	_stream_input = stream;
+	_memory_account = ov::MemoryAccounting::GetAccount(application_info.GetName(), stream->GetName());
 
 	// for generating track ids
 	_last_transcode_id = 0;
-
-	// set alias
-	_queue_input_packets.SetAlias(ov::String::FormatString("%s/%s - Transcode Stream input queue"
-		, _stream_input->GetApplicationInfo().GetName().CStr() ,_stream_input->GetName().CStr()));
-
-	_queue_decoded_frames.SetAlias(ov::String::FormatString("%s/%s - Transcode Stream decoded queue"
-		, _stream_input->GetApplicationInfo().GetName().CStr() ,_stream_input->GetName().CStr()));
-
-	_queue_filterd_frames.SetAlias(ov::String::FormatString("%s/%s - Transcode Stream filtered queue"
-		, _stream_input->GetApplicationInfo().GetName().CStr() ,_stream_input->GetName().CStr()));
-
 }
 
 TranscodeStream::~TranscodeStream()
@@ -56,10 +62,10 @@ TranscodeStream::~TranscodeStream()
 	_filters.clear();
 	_decoders.clear();
 
-	// Delete all data in the queue
-	_queue_input_packets.Clear();
-	_queue_decoded_frames.Clear();
-	_queue_filterd_frames.Clear();
+	// Delete all stages
+	_decode_stages.clear();
+	_filter_stage.reset();
+	_encode_stages.clear();
 
 	// Delete all map of stage
 	_stage_input_to_decoder.clear();
@@ -68,6 +74,10 @@ TranscodeStream::~TranscodeStream()
 	_stage_filter_to_encoder.clear();
 	_stage_encoder_to_output.clear();
 
+	_decoder_root_filters.clear();
+	_filter_children.clear();
+	_filter_encoders.clear();
+
 	_stream_outputs.clear();
 }
 
@@ -100,6 +110,10 @@ bool TranscodeStream::Start()
 		logti("No encoder generated");
 	}
 
+	UpdateIdleEncoders();
+	_on_demand_stop_watch.Start();
+	_degrade_stop_watch.Start();
+
 	// I will make and apply a packet drop policy.
 	_max_queue_threshold = 256;
 
@@ -108,6 +122,13 @@ bool TranscodeStream::Start()
 	// Notify to create a new stream on the media router.
 	CreateStreams();
 
+	if (StartStages() == false)
+	{
+		logte("Could not start the transcode pipeline");
+		Stop();
+		return false;
+	}
+
 	logti("[%s/%s(%u)] Transcoder input stream has been started. Status : (%d) Decoders, (%d) Encoders", 
 						_application_info.GetName().CStr(), _stream_input->GetName().CStr(), _stream_input->GetId(), _decoders.size(), _encoders.size());
 			
@@ -121,10 +142,8 @@ bool TranscodeStream::Stop()
 	logtd("Wait for terminated trancode stream thread. kill_flag(%s)", _kill_flag ? "true" : "false");
 
 
-	// Stop all queues
-	_queue_input_packets.Stop();
-	_queue_decoded_frames.Stop();
-	_queue_filterd_frames.Stop();
+	// Stop all stages of the pipeline
+	StopStages();
 
 	// Stop all encoders
 	for (auto &iter : _encoders)
@@ -169,20 +188,555 @@ bool TranscodeStream::Push(std::shared_ptr<MediaPacket> packet)
 		return true;
 	}
 
-	if (_queue_input_packets.Size() > _max_queue_threshold)
+	auto track_id = packet->GetTrackId();
+
+	if (packet->GetTrace() != nullptr)
+	{
+		packet->GetTrace()->Mark(mon::PacketTraceStage::TranscodeIn);
+	}
+
+	// Bypass tracks don't need to wait for the decoders
+	BypassPacket(track_id, packet);
+
+	auto stage_item_decoder = _stage_input_to_decoder.find(track_id);
+	if (stage_item_decoder == _stage_input_to_decoder.end())
+	{
+		return true;
+	}
+
+	if (_audio_strand != nullptr)
+	{
+		return PostAudioPacket(stage_item_decoder->second, std::move(packet));
+	}
+
+	auto stage_item = _decode_stages.find(stage_item_decoder->second);
+	if (stage_item == _decode_stages.end())
+	{
+		return true;
+	}
+
+	// The caller (MediaRouter) must not be blocked, so the packets are dropped by the policy of the queue if the decoder cannot keep up
+	// (See StartStages())
+	return stage_item->second->queue.Enqueue(std::move(packet));
+}
+
+bool TranscodeStream::PostAudioPacket(MediaTrackId decoder_id, std::shared_ptr<MediaPacket> packet)
+{
+	// The strand has no limit, so the packets are dropped here if the pool cannot keep up
+	// (Audio packets are all key frames, so the decoder doesn't need to skip to the next key frame)
+	if (_audio_pending_count >= _max_queue_threshold)
+	{
+		auto stream_metrics = StreamMetrics(*_stream_input);
+		if (stream_metrics != nullptr)
+		{
+			stream_metrics->OnQueuePacketDropped(MediaQueuePolicy::GetPacketBytes(*packet));
+		}
+
+		return false;
+	}
+
+	_audio_pending_count++;
+
+	bool result = _audio_strand->Post([this, decoder_id, packet]() {
+		ov::MemoryScope memory_scope(ov::MemoryCategory::Transcode, _memory_account);
+
+		_audio_pending_count--;
+
+		if (_kill_flag == false)
+		{
+			DecodePacket(decoder_id, packet);
+		}
+	});
+
+	if (result == false)
+	{
+		_audio_pending_count--;
+	}
+
+	return result;
+}
+
+const std::shared_ptr<info::Stream> &TranscodeStream::GetInputStream() const
+{
+	return _stream_input;
+}
+
+bool TranscodeStream::RequestKeyFrame(const std::shared_ptr<info::Stream> &output_stream)
+{
+	auto output_stream_id = output_stream->GetId();
+
+	auto output_item = std::find_if(_stream_outputs.begin(), _stream_outputs.end(), [output_stream_id](const auto &item) -> bool {
+		return item.second->GetId() == output_stream_id;
+	});
+
+	if (output_item == _stream_outputs.end())
+	{
+		return false;
+	}
+
+	// The request flag of the encoder is cleared when the next frame is encoded, so the requests are coalesced
+	for (auto &encoder_item : _stage_encoder_to_output)
+	{
+		auto &output_tracks = encoder_item.second;
+
+		bool is_feeding = std::any_of(output_tracks.begin(), output_tracks.end(), [output_stream_id](const auto &output_track) -> bool {
+			return output_track.first->GetId() == output_stream_id;
+		});
+
+		if (is_feeding == false)
+		{
+			continue;
+		}
+
+		auto encoder = _encoders.find(encoder_item.first);
+
+		if ((encoder != _encoders.end()) && (encoder->second->GetContext()->GetMediaType() == common::MediaType::Video))
+		{
+			encoder->second->RequestKeyFrame();
+		}
+	}
+
+	for (auto &lane_item : _stage_input_to_output)
+	{
+		auto &lane = lane_item.second;
+
+		bool is_feeding = lane.is_video && std::any_of(lane.outputs.begin(), lane.outputs.end(), [output_stream_id](const auto &output) -> bool {
+			return output.stream->GetId() == output_stream_id;
+		});
+
+		if (is_feeding == false)
+		{
+			continue;
+		}
+
+		auto now_ms = ov::Clock::NowMs();
+		auto last_ms = _last_upstream_key_frame_request_ms.load();
+
+		if (((now_ms - last_ms) >= TRANSCODE_UPSTREAM_KEY_FRAME_REQUEST_INTERVAL_MS) && _last_upstream_key_frame_request_ms.compare_exchange_strong(last_ms, now_ms))
+		{
+			_parent->RequestKeyFrame(_stream_input);
+		}
+
+		break;
+	}
+
+	return true;
+}
+
+bool TranscodeStream::ReportPacketLoss(const std::shared_ptr<info::Stream> &output_stream, int32_t packet_loss_percentage)
+{
+	auto output_stream_id = output_stream->GetId();
+
+	auto output_item = std::find_if(_stream_outputs.begin(), _stream_outputs.end(), [output_stream_id](const auto &item) -> bool {
+		return item.second->GetId() == output_stream_id;
+	});
+
+	if (output_item == _stream_outputs.end())
 	{
-		logti("Queue(stream) is full, please check your system: (queue: %zu > limit: %llu)", _queue_input_packets.Size(), _max_queue_threshold);
 		return false;
 	}
 
-	_queue_input_packets.Enqueue(std::move(packet));
+	// An audio encoder can feed several output streams, the last report wins
+	for (auto &encoder_item : _stage_encoder_to_output)
+	{
+		auto &output_tracks = encoder_item.second;
+
+		bool is_feeding = std::any_of(output_tracks.begin(), output_tracks.end(), [output_stream_id](const auto &output_track) -> bool {
+			return output_track.first->GetId() == output_stream_id;
+		});
+
+		if (is_feeding == false)
+		{
+			continue;
+		}
+
+		auto encoder = _encoders.find(encoder_item.first);
+
+		if ((encoder != _encoders.end()) && (encoder->second->GetContext()->GetMediaType() == common::MediaType::Audio))
+		{
+			encoder->second->SetPacketLossPercentage(packet_loss_percentage);
+		}
+	}
+
+	return true;
+}
+
+void TranscodeStream::SetExcludedProfiles(const std::set<ov::String> &excluded_profiles)
+{
+	_excluded_profiles = excluded_profiles;
+}
+
+std::vector<TranscodeScheduler::EncodeCost> TranscodeStream::GetEncodeCosts(const info::Application &application_info, const std::shared_ptr<info::Stream> &stream)
+{
+	std::vector<TranscodeScheduler::EncodeCost> cost_list;
+
+	// Dynamic applications bypass all tracks
+	if (application_info.IsDynamicApp())
+	{
+		return cost_list;
+	}
+
+	std::shared_ptr<MediaTrack> input_video_track;
+
+	for (auto &input_track_item : stream->GetTracks())
+	{
+		if (input_track_item.second->GetMediaType() == common::MediaType::Video)
+		{
+			input_video_track = input_track_item.second;
+			break;
+		}
+	}
+
+	if (input_video_track == nullptr)
+	{
+		return cost_list;
+	}
+
+	// An encoder is created per <Encode> even if the profile is used by multiple streams (See StoreStageContext())
+	std::set<ov::String> profile_names;
+
+	for (const auto &cfg_stream : application_info.GetConfig().GetStreamList())
+	{
+		for (const auto &cfg_profile : cfg_stream.GetProfileList())
+		{
+			auto cfg_encode = GetEncodeByProfileName(application_info, cfg_profile.GetName());
+			auto cfg_encode_video = (cfg_encode != nullptr) ? cfg_encode->GetVideoProfile() : nullptr;
+
+			if ((cfg_encode_video == nullptr) || (cfg_encode_video->IsActive() == false) || cfg_encode_video->IsBypass() ||
+				(cfg_encode_video->IsAutoBypass() && IsWebRtcCompatible(input_video_track)) ||
+				(IsVideoCodec(GetCodecId(cfg_encode_video->GetCodec())) == false))
+			{
+				continue;
+			}
+
+			if (profile_names.insert(cfg_profile.GetName()).second == false)
+			{
+				continue;
+			}
+
+			int64_t width = (cfg_encode_video->GetWidth() > 0) ? cfg_encode_video->GetWidth() : input_video_track->GetWidth();
+			int64_t height = (cfg_encode_video->GetHeight() > 0) ? cfg_encode_video->GetHeight() : input_video_track->GetHeight();
+			double framerate = (cfg_encode_video->GetFramerate() > 0.0f) ? cfg_encode_video->GetFramerate() : input_video_track->GetFrameRate();
+
+			TranscodeScheduler::EncodeCost cost;
+
+			cost.profile_name = cfg_profile.GetName();
+			cost.pixels_per_second = static_cast<int64_t>(width * height * framerate);
+			// Only H.264 has the hardware encoders (See TranscodeHWAccelHelper::GetEncoderName())
+			cost.is_hw_accelerated = (GetCodecId(cfg_encode_video->GetCodec()) == common::MediaCodecId::H264) &&
+									 (TranscodeHWAccelHelper::Parse(cfg_encode_video->GetHWAcceleration()) != TranscodeHWAccel::None);
+
+			cost_list.push_back(cost);
+		}
+	}
+
+	return cost_list;
+}
+
+ov::Executor *TranscodeStream::GetAudioExecutor()
+{
+	static ov::Executor executor;
+
+	return &executor;
+}
+
+bool TranscodeStream::StartStages()
+{
+	if (_use_audio_pool)
+	{
+		for (auto &iter : _decoders)
+		{
+			_decode_latencies[iter.first] = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::Decode, GetLatencyLabels(iter.first));
+			_decode_delays[iter.first].histogram = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::DecodeDelay, GetLatencyLabels(iter.first));
+		}
+
+		for (auto &iter : _encoders)
+		{
+			_encode_latencies[iter.first].histogram = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::Encode, GetLatencyLabels(iter.first));
+		}
+
+		_audio_strand = std::make_shared<ov::Strand>(GetAudioExecutor(), GetParent()->GetAudioExecutorGroup());
+
+		return true;
+	}
+
+	auto stream_name = ov::String::FormatString("%s/%s", _stream_input->GetApplicationInfo().GetName().CStr(), _stream_input->GetName().CStr());
+
+	try
+	{
+		for (auto &iter : _decoders)
+		{
+			auto decoder_id = iter.first;
+			auto alias = ov::String::FormatString("%s - Transcode Stream decode queue #%d", stream_name.CStr(), decoder_id);
+			auto stage = std::make_unique<Stage<std::shared_ptr<MediaPacket>>>(alias.CStr(), _max_queue_threshold);
+
+			// A decoder cannot decode the frames that refer to a dropped frame, so the queue drops them together
+			bool is_policy_enabled = MediaQueuePolicy::IsEnabled();
+			stage->queue.SetLimit(
+				_max_queue_threshold,
+				is_policy_enabled ? MediaQueuePolicy::GetMaxBytes() : 0,
+				is_policy_enabled ? MediaQueuePolicy::GetPolicy() : ov::QueueOverflowPolicy::DropToKey,
+				[](const std::shared_ptr<MediaPacket> &packet) -> size_t {
+					return MediaQueuePolicy::GetPacketBytes(*packet);
+				},
+				[this](const std::shared_ptr<MediaPacket> &packet) -> ov::QueueItemClass {
+					return MediaQueuePolicy::Classify(*packet, *_stream_input, packet->GetTrackId());
+				});
+
+			stage->queue.SetDropCallback([this](const std::shared_ptr<MediaPacket> &packet, size_t bytes) {
+				auto stream_metrics = StreamMetrics(*_stream_input);
+				if (stream_metrics != nullptr)
+				{
+					stream_metrics->OnQueuePacketDropped(bytes);
+				}
+			});
+
+			_decode_latencies[decoder_id] = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::Decode, GetLatencyLabels(decoder_id));
+			_decode_delays[decoder_id].histogram = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::DecodeDelay, GetLatencyLabels(decoder_id));
+
+			stage->thread = std::thread(&TranscodeStream::DecodeStageLoop, this, decoder_id, stage.get());
+			_decode_stages[decoder_id] = std::move(stage);
+		}
+
+		if (_decoders.empty() == false)
+		{
+			auto alias = ov::String::FormatString("%s - Transcode Stream filter queue", stream_name.CStr());
 
-	if(GetParent() != nullptr)
-		GetParent()->AppendIndicator(this->GetSharedPtr(), TranscodeApplication::IndicatorQueueType::BUFFER_INDICATOR_INPUT_PACKETS);
+			_filter_stage = std::make_unique<Stage<DecodedFrame>>(alias.CStr(), _max_queue_threshold);
+			_filter_stage->thread = std::thread(&TranscodeStream::FilterStageLoop, this, _filter_stage.get());
+		}
+
+		for (auto &iter : _encoders)
+		{
+			auto encoder_id = iter.first;
+			auto alias = ov::String::FormatString("%s - Transcode Stream encode queue #%d", stream_name.CStr(), encoder_id);
+			auto stage = std::make_unique<Stage<std::shared_ptr<const MediaFrame>>>(alias.CStr(), _max_queue_threshold);
+
+			_encode_latencies[encoder_id].histogram = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::Encode, GetLatencyLabels(encoder_id));
+
+			stage->thread = std::thread(&TranscodeStream::EncodeStageLoop, this, encoder_id, stage.get());
+			_encode_stages[encoder_id] = std::move(stage);
+		}
+	}
+	catch (const std::system_error &e)
+	{
+		logte("Failed to start transcode stream thread: %s", e.what());
+		return false;
+	}
 
 	return true;
 }
 
+mon::MetricLabels TranscodeStream::GetLatencyLabels(MediaTrackId track_id) const
+{
+	return {
+		{"app", _stream_input->GetApplicationInfo().GetName()},
+		{"stream", _stream_input->GetName()},
+		{"track", ov::Converter::ToString(track_id)}};
+}
+
+void TranscodeStream::StopStages()
+{
+	if (_audio_strand != nullptr)
+	{
+		// Waits for the running task, the pending packets are discarded
+		_audio_strand->Stop();
+	}
+
+	// Stop all queues first to wake up the threads waiting for the next stage
+	for (auto &iter : _decode_stages)
+	{
+		iter.second->queue.Stop();
+	}
+
+	if (_filter_stage != nullptr)
+	{
+		_filter_stage->queue.Stop();
+	}
+
+	for (auto &iter : _encode_stages)
+	{
+		iter.second->queue.Stop();
+	}
+
+	for (auto &iter : _decode_stages)
+	{
+		if (iter.second->thread.joinable())
+		{
+			iter.second->thread.join();
+		}
+	}
+
+	if ((_filter_stage != nullptr) && _filter_stage->thread.joinable())
+	{
+		_filter_stage->thread.join();
+	}
+
+	for (auto &iter : _encode_stages)
+	{
+		if (iter.second->thread.joinable())
+		{
+			iter.second->thread.join();
+		}
+	}
+}
+
+void TranscodeStream::BindStageToNumaNode()
+{
+	auto numa_node = _stream_input->GetNumaNode();
+
+	if (numa_node >= 0)
+	{
+		ov::Numa::BindThread(numa_node);
+	}
+}
+
+void TranscodeStream::DecodeStageLoop(MediaTrackId decoder_id, Stage<std::shared_ptr<MediaPacket>> *stage)
+{
+	logtd("Started decode stage thread: decoder #%d", decoder_id);
+
+	ov::ThreadMetrics thread_metrics("TcDecode", ov::ThreadClass::Media);
+	BindStageToNumaNode();
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Transcode, _memory_account);
+
+	auto decoder_item = _decoders.find(decoder_id);
+	auto decoder = (decoder_item != _decoders.end()) ? decoder_item->second : nullptr;
+	bool is_video = (decoder != nullptr) && (decoder->GetContext()->GetMediaType() == common::MediaType::Video);
+
+	// See TranscodeDegradeLadder
+	auto skip_to_key_frame_sequence = _degrade_ladder.GetSkipToKeyFrameSequence();
+	bool is_skipping_to_key_frame = false;
+
+	while (_kill_flag == false)
+	{
+		thread_metrics.BeginIdle();
+		auto packet = stage->queue.Dequeue();
+		thread_metrics.EndIdle();
+
+		if (packet.has_value() == false)
+		{
+			// Stop is requested
+			continue;
+		}
+
+		thread_metrics.CountLoop();
+
+		if (is_video)
+		{
+			auto degrade_level = _degrade_ladder.GetLevel();
+
+			decoder->SetSkipNonReference(degrade_level >= TranscodeDegradeLevel::SkipNonReference);
+
+			if (_degrade_ladder.GetSkipToKeyFrameSequence() != skip_to_key_frame_sequence)
+			{
+				skip_to_key_frame_sequence = _degrade_ladder.GetSkipToKeyFrameSequence();
+				is_skipping_to_key_frame = true;
+			}
+
+			if (is_skipping_to_key_frame)
+			{
+				if (packet.value()->GetFlag() != MediaPacketFlag::Key)
+				{
+					auto stream_metrics = StreamMetrics(*_stream_input);
+					if (stream_metrics != nullptr)
+					{
+						stream_metrics->OnQueuePacketDropped(MediaQueuePolicy::GetPacketBytes(*packet.value()));
+					}
+
+					continue;
+				}
+
+				is_skipping_to_key_frame = false;
+			}
+		}
+
+		DecodePacket(decoder_id, std::move(packet.value()));
+	}
+
+	logtd("Terminated decode stage thread: decoder #%d", decoder_id);
+}
+
+void TranscodeStream::FilterStageLoop(Stage<DecodedFrame> *stage)
+{
+	logtd("Started filter stage thread");
+
+	ov::ThreadMetrics thread_metrics("TcFilter", ov::ThreadClass::Media);
+	BindStageToNumaNode();
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Transcode, _memory_account);
+
+	while (_kill_flag == false)
+	{
+		thread_metrics.BeginIdle();
+		auto decoded_frame = stage->queue.Dequeue();
+		thread_metrics.EndIdle();
+
+		if (decoded_frame.has_value() == false)
+		{
+			continue;
+		}
+
+		thread_metrics.CountLoop();
+
+		auto start_time = std::chrono::steady_clock::now();
+		FilterDecodedFrame(std::move(decoded_frame.value().frame), decoded_frame.value().is_format_changed);
+		_filter_busy_time += std::chrono::steady_clock::now() - start_time;
+
+		if (TranscodeDegradeLadder::IsEnabled() && _degrade_stop_watch.IsElapsed(TRANSCODE_DEGRADE_UPDATE_INTERVAL_MS))
+		{
+			UpdateDegradeLevel();
+		}
+	}
+
+	logtd("Terminated filter stage thread");
+}
+
+void TranscodeStream::FilterDecodedFrame(std::shared_ptr<MediaFrame> frame, bool is_format_changed)
+{
+	if (is_format_changed)
+	{
+		// Filters are created/used only by the filter stage (or the strand of the audio transcode pool)
+		ChangeOutputFormat(frame.get());
+	}
+
+	if ((_on_demand_streams.empty() == false) && _on_demand_stop_watch.IsElapsed(1000))
+	{
+		_on_demand_stop_watch.Update();
+		UpdateOnDemandStreams();
+	}
+
+	DoFilters(std::move(frame));
+}
+
+void TranscodeStream::EncodeStageLoop(MediaTrackId encoder_id, Stage<std::shared_ptr<const MediaFrame>> *stage)
+{
+	logtd("Started encode stage thread: encoder #%d", encoder_id);
+
+	ov::ThreadMetrics thread_metrics("TcEncode", ov::ThreadClass::Encode);
+	BindStageToNumaNode();
+	ov::MemoryScope memory_scope(ov::MemoryCategory::Transcode, _memory_account);
+
+	while (_kill_flag == false)
+	{
+		// The encoders have their own threads, so collect the encoded packets even if there is no new frame
+		thread_metrics.BeginIdle();
+		auto frame = stage->queue.Dequeue(10);
+		thread_metrics.EndIdle();
+
+		thread_metrics.CountLoop();
+
+		if (frame.has_value())
+		{
+			EncodeFrame(encoder_id, std::move(frame.value()));
+		}
+		else
+		{
+			SendEncodedPackets(encoder_id);
+		}
+	}
+
+	logtd("Terminated encode stage thread: encoder #%d", encoder_id);
+}
+
 // Create Output Stream and Encoding Transcode Context
 int32_t TranscodeStream::CreateOutputStream()
 {
@@ -289,6 +843,17 @@ int32_t TranscodeStream::CreateOutputStream()
 		// It helps modules to reconize origin stream from provider
 		stream_output->SetOriginStream(_stream_input);
 
+		// The renditions of an ABR stream
+		auto group_name = cfg_stream.GetGroup();
+		if (::strstr(group_name.CStr(), "${OriginStreamName}") != nullptr)
+		{
+			group_name = group_name.Replace("${OriginStreamName}", _stream_input->GetName());
+		}
+		stream_output->SetGroupName(group_name);
+
+		// Whether the bypass video track is added instead of the excluded profiles
+		bool is_bypass_video_added = false;
+
 		// Look up all tracks in the input stream.
 		for (auto &input_track_item : _stream_input->GetTracks())
 		{
@@ -321,7 +886,33 @@ int32_t TranscodeStream::CreateOutputStream()
 
 					if ((cfg_encode_video != nullptr) && (cfg_encode_video->IsActive()))
 					{
-						new_outupt_track->SetBypass(cfg_encode_video->IsBypass());
+						bool is_auto_bypassed = (cfg_encode_video->IsBypass() == false) && cfg_encode_video->IsAutoBypass() && IsWebRtcCompatible(input_track);
+						bool is_excluded = (cfg_encode_video->IsBypass() == false) && (is_auto_bypassed == false) &&
+										   (_excluded_profiles.find(cfg_profile.GetName()) != _excluded_profiles.end());
+
+						if (is_auto_bypassed)
+						{
+							if (is_bypass_video_added)
+							{
+								continue;
+							}
+
+							logti("[%s] The input video is compatible with WebRTC, %s profile is bypassed", stream_name.CStr(), cfg_profile.GetName().CStr());
+							is_bypass_video_added = true;
+						}
+						else if (is_excluded)
+						{
+							if (is_bypass_video_added)
+							{
+								logtw("[%s] %s profile is excluded by the transcode budget", stream_name.CStr(), cfg_profile.GetName().CStr());
+								continue;
+							}
+
+							logtw("[%s] %s profile is excluded by the transcode budget, the input video will be bypassed", stream_name.CStr(), cfg_profile.GetName().CStr());
+							is_bypass_video_added = true;
+						}
+
+						new_outupt_track->SetBypass(cfg_encode_video->IsBypass() || is_excluded || is_auto_bypassed);
 						new_outupt_track->SetId(NewTrackId(new_outupt_track->GetMediaType()));
 						new_outupt_track->SetMediaType(common::MediaType::Video);
 
@@ -337,6 +928,8 @@ int32_t TranscodeStream::CreateOutputStream()
 							new_outupt_track->SetHeight(input_track->GetHeight());
 							new_outupt_track->SetFrameRate(input_track->GetFrameRate());
 							new_outupt_track->SetTimeBase(input_track->GetTimeBase().GetNum(), input_track->GetTimeBase().GetDen());
+							// The parameter sets are signalled in the offer of WebRTC (profile-level-id, sprop-parameter-sets)
+							new_outupt_track->SetCodecExtradata(input_track->GetCodecExtradata());
 						}
 						else
 						{
@@ -401,6 +994,8 @@ int32_t TranscodeStream::CreateOutputStream()
 							new_outupt_track->GetChannel().SetLayout(input_track->GetChannel().GetLayout());
 							new_outupt_track->GetSample().SetFormat(input_track->GetSample().GetFormat());
 							new_outupt_track->SetTimeBase(input_track->GetTimeBase().GetNum(), input_track->GetTimeBase().GetDen());
+							// AudioSpecificConfig of AAC
+							new_outupt_track->SetCodecExtradata(input_track->GetCodecExtradata());
 						}
 						else
 						{
@@ -447,6 +1042,12 @@ int32_t TranscodeStream::CreateOutputStream()
 		// Add to Output Stream List. The key is the output stream name.
 		_stream_outputs.insert(std::make_pair(stream_name, stream_output));
 
+		if (cfg_stream.IsOnDemand())
+		{
+			// Encoders are started by the first session
+			_on_demand_streams[stream_name].idle_timeout_ms = std::max(cfg_stream.GetIdleTimeout(), 0) * 1000LL;
+		}
+
 		logti("[%s/%s(%u)] -> [%s/%s(%u)] Transcoder output stream has been created.", 
 						_application_info.GetName().CStr(), _stream_input->GetName().CStr(), _stream_input->GetId(),
 						_application_info.GetName().CStr(), stream_output->GetName().CStr(), stream_output->GetId());
@@ -500,7 +1101,20 @@ int32_t TranscodeStream::CreateStageMapping()
 
 			if (track_info->IsBypass() == true)
 			{
-				_stage_input_to_output[input_id].push_back(make_pair(stream, output_id));
+				auto &input_track = flow_context->_input_track;
+				auto &lane = _stage_input_to_output[input_id];
+
+				lane.is_video = (input_track->GetMediaType() == common::MediaType::Video);
+
+				BypassOutput output;
+
+				output.stream = stream;
+				output.track_id = output_id;
+				output.input_timebase = {input_track->GetTimeBase().GetNum(), input_track->GetTimeBase().GetDen()};
+				output.output_timebase = {track_info->GetTimeBase().GetNum(), track_info->GetTimeBase().GetDen()};
+				output.is_rescale_required = (::av_cmp_q(output.input_timebase, output.output_timebase) != 0);
+
+				lane.outputs.push_back(std::move(output));
 			}
 			else
 			{
@@ -612,6 +1226,15 @@ int32_t TranscodeStream::CreateDecoders()
 					track->GetBitrate(),
 					track->GetWidth(), track->GetHeight(),
 					track->GetFrameRate());
+
+				{
+					auto &cfg_decode_video = _application_info.GetConfig().GetDecode().GetVideo();
+
+					// <Decode><Video><HWAcceleration>
+					input_context->SetHWAccel(TranscodeHWAccelHelper::Parse(cfg_decode_video.GetHWAcceleration()));
+					input_context->SetDecodeMode(cfg_decode_video.GetMode());
+					input_context->SetThreadCount(cfg_decode_video.GetThreadCount());
+				}
 				break;
 
 			case common::MediaType::Audio:
@@ -628,6 +1251,7 @@ int32_t TranscodeStream::CreateDecoders()
 		}
 
 		input_context->SetTimeBase(track->GetTimeBase());
+		input_context->SetFramePool(_frame_pool);
 
 		CreateDecoder(input_track_id, decoder_track_id, input_context);
 
@@ -667,6 +1291,33 @@ bool TranscodeStream::CreateDecoder(int32_t input_track_id, int32_t decoder_trac
 int32_t TranscodeStream::CreateEncoders()
 {
 	int32_t created_encoder_count = 0;
+	int32_t video_encoder_count = 0;
+
+	// Count the video encoders of this stream to divide the cores when <ThreadCount> is 0
+	for (auto &iter : _map_stage_context)
+	{
+		auto stage_items = _stage_encoder_to_output.find(iter.second->_transcoder_id);
+
+		if ((stage_items != _stage_encoder_to_output.end()) && (stage_items->second.empty() == false))
+		{
+			auto &output_track_info_item = stage_items->second[0];
+			auto tracks = output_track_info_item.first->GetTracks();
+
+			if (tracks[output_track_info_item.second]->GetMediaType() == common::MediaType::Video)
+			{
+				video_encoder_count++;
+			}
+		}
+	}
+
+	// Calculated before creating the encoders, so all encoders of this stream get the same count
+	auto auto_thread_count = TranscodeEncoder::GetAutoThreadCount(video_encoder_count);
+
+	// The audio-only streams (including the streams that bypass the video) are processed by the audio transcode pool
+	bool has_video_decoder = std::any_of(_decoders.begin(), _decoders.end(), [](const auto &item) -> bool {
+		return item.second->GetContext()->GetMediaType() == common::MediaType::Video;
+	});
+	_use_audio_pool = (video_encoder_count == 0) && (has_video_decoder == false) && GetAudioExecutor()->IsRunning();
 
 	for (auto &iter : _map_stage_context)
 	{
@@ -709,6 +1360,48 @@ int32_t TranscodeStream::CreateEncoders()
 					track->GetHeight(),
 					track->GetFrameRate());
 
+				// <Encode><Video><HWAcceleration>
+				auto cfg_encode = GetEncodeByProfileName(_application_info, iter.first.first);
+				auto cfg_encode_video = (cfg_encode != nullptr) ? cfg_encode->GetVideoProfile() : nullptr;
+
+				if (cfg_encode_video != nullptr)
+				{
+					new_output_transcode_context->SetHWAccel(TranscodeHWAccelHelper::Parse(cfg_encode_video->GetHWAcceleration()));
+
+					// One keyframe per second by default
+					auto key_frame_interval = cfg_encode_video->GetKeyFrameInterval();
+					auto frames_per_second = std::max(static_cast<int32_t>(std::round(track->GetFrameRate())), 1);
+					auto key_frame_alignment = GetKeyFrameAlignment();
+
+					if (key_frame_interval <= 0)
+					{
+						key_frame_interval = frames_per_second;
+					}
+
+					if (key_frame_alignment > 0)
+					{
+						// All renditions start a new GOP at the same segment boundaries (the same pts), so the segmenters close the segments on time
+						// and the players can switch between the renditions (See <Stream><Group>) at any segment.
+						// The keyframes are forced only at the boundaries, the GOP of the encoder is kept (the WebRTC renditions still join in a second)
+						new_output_transcode_context->SetKeyFrameAlignment(key_frame_alignment);
+
+						key_frame_interval = std::min(key_frame_interval, std::max(frames_per_second * key_frame_alignment / 1000, 1));
+					}
+
+					new_output_transcode_context->SetGOP(key_frame_interval);
+
+					new_output_transcode_context->SetPreset(cfg_encode_video->GetPreset());
+					new_output_transcode_context->SetTune(cfg_encode_video->GetTune());
+					new_output_transcode_context->SetThreadCount((cfg_encode_video->GetThreadCount() > 0) ? cfg_encode_video->GetThreadCount() : auto_thread_count);
+					new_output_transcode_context->SetSliceThreads(cfg_encode_video->IsSliceThreads());
+					new_output_transcode_context->SetLookahead(cfg_encode_video->GetLookahead());
+					new_output_transcode_context->SetRateControl(cfg_encode_video->GetRateControl());
+					new_output_transcode_context->SetScaleQuality(cfg_encode_video->GetScaleQuality());
+					new_output_transcode_context->SetTemporalLayers(cfg_encode_video->GetTemporalLayers());
+				}
+
+				new_output_transcode_context->SetFramePool(_frame_pool);
+
 				CreateEncoder(encoder_track_id, track, new_output_transcode_context);
 				created_encoder_count++;
 			}
@@ -724,6 +1417,19 @@ int32_t TranscodeStream::CreateEncoders()
 					track->GetBitrate(),
 					track->GetSampleRate());
 
+				// <Encode><Audio><InbandFEC>, <DTX>
+				auto cfg_encode = GetEncodeByProfileName(_application_info, iter.first.first);
+				auto cfg_encode_audio = (cfg_encode != nullptr) ? cfg_encode->GetAudioProfile() : nullptr;
+
+				if (cfg_encode_audio != nullptr)
+				{
+					new_output_transcode_context->SetInbandFec(cfg_encode_audio->IsInbandFec());
+					new_output_transcode_context->SetDtx(cfg_encode_audio->IsDtx());
+				}
+
+				new_output_transcode_context->SetInlineProcessing(_use_audio_pool);
+				new_output_transcode_context->SetFramePool(_frame_pool);
+
 				CreateEncoder(encoder_track_id, track, new_output_transcode_context);
 				created_encoder_count++;
 			}
@@ -739,6 +1445,24 @@ int32_t TranscodeStream::CreateEncoders()
 	return created_encoder_count;
 }
 
+int32_t TranscodeStream::GetKeyFrameAlignment() const
+{
+	int32_t segment_duration = 0;
+
+	auto apply = [&segment_duration](const auto *publisher) {
+		if ((publisher != nullptr) && publisher->IsParsed() && (publisher->GetSegmentDuration() > 0))
+		{
+			segment_duration = std::gcd(segment_duration, publisher->GetSegmentDuration());
+		}
+	};
+
+	apply(_application_info.GetPublisher<cfg::HlsPublisher>());
+	apply(_application_info.GetPublisher<cfg::DashPublisher>());
+	apply(_application_info.GetPublisher<cfg::LlDashPublisher>());
+
+	return segment_duration * 1000;
+}
+
 bool TranscodeStream::CreateEncoder(int32_t encoder_track_id, std::shared_ptr<MediaTrack> media_track, std::shared_ptr<TranscodeContext> output_context)
 {
 	if (media_track == nullptr)
@@ -771,37 +1495,47 @@ void TranscodeStream::ChangeOutputFormat(MediaFrame *buffer)
 	CreateFilters(buffer);
 }
 
-TranscodeResult TranscodeStream::DecodePacket(int32_t track_id, std::shared_ptr<MediaPacket> packet)
+void TranscodeStream::BypassPacket(int32_t track_id, const std::shared_ptr<MediaPacket> &packet)
 {
-	// 1. bypass track processing
 	auto stage_item_to_output = _stage_input_to_output.find(track_id);
-	if (stage_item_to_output != _stage_input_to_output.end())
+	if (stage_item_to_output == _stage_input_to_output.end())
 	{
-		auto &output_tracks = stage_item_to_output->second;
+		return;
+	}
+
+	auto &lane = stage_item_to_output->second;
 
-		for (auto iter : output_tracks)
+	if (lane.is_started == false)
+	{
+		if (lane.is_video && (packet->GetFlag() != MediaPacketFlag::Key))
 		{
-			auto output_stream = iter.first;
-			auto output_track_id = iter.second;
+			// Wait for the key frame
+			return;
+		}
 
-			auto clone_packet = packet->ClonePacket();
+		lane.is_started = true;
+	}
 
-			clone_packet->SetTrackId(output_track_id);
+	for (auto &output : lane.outputs)
+	{
+		// The clone shares the payload with the packet, so only the header is copied
+		auto clone_packet = packet->ClonePacket();
 
-			SendFrame(output_stream, std::move(clone_packet));
-		}
-	}
+		clone_packet->SetTrackId(output.track_id);
 
+		if (output.is_rescale_required)
+		{
+			clone_packet->SetPts(::av_rescale_q(packet->GetPts(), output.input_timebase, output.output_timebase));
+			clone_packet->SetDts(::av_rescale_q(packet->GetDts(), output.input_timebase, output.output_timebase));
+			clone_packet->SetDuration(::av_rescale_q(packet->GetDuration(), output.input_timebase, output.output_timebase));
+		}
 
-	// 2. decoding track processing
-	auto stage_item_decoder = _stage_input_to_decoder.find(track_id);
-	if (stage_item_decoder == _stage_input_to_decoder.end())
-	{
-		return TranscodeResult::NoData;
+		SendFrame(output.stream, std::move(clone_packet));
 	}
+}
 
-	auto decoder_id = stage_item_decoder->second;
-
+TranscodeResult TranscodeStream::DecodePacket(int32_t decoder_id, std::shared_ptr<MediaPacket> packet)
+{
 	auto decoder_item = _decoders.find(decoder_id);
 	if (decoder_item == _decoders.end())
 	{
@@ -809,43 +1543,88 @@ TranscodeResult TranscodeStream::DecodePacket(int32_t track_id, std::shared_ptr<
 	}
 	auto decoder = decoder_item->second.get();
 
+	// Only the calls of the decoder are measured (not the time waiting for the filter stage)
+	// (The map is not modified after the stages are started)
+	auto latency_item = _decode_latencies.find(decoder_id);
+	auto decode_latency = (latency_item != _decode_latencies.end()) ? latency_item->second.get() : nullptr;
+	auto delay_item = _decode_delays.find(decoder_id);
+	auto decode_delay = (delay_item != _decode_delays.end()) ? &(delay_item->second) : nullptr;
+	auto start_time = std::chrono::steady_clock::now();
+
+	if (decode_delay != nullptr)
+	{
+		// The packets that never produce a frame (parameter sets, corrupted packets, ...) must not pile up
+		if (decode_delay->send_times.size() >= TRANSCODE_DECODE_DELAY_MAX_PENDING)
+		{
+			decode_delay->send_times.erase(decode_delay->send_times.begin());
+		}
+
+		decode_delay->send_times.emplace(packet->GetPts(), start_time);
+	}
+
 	// logtp("[#%d] Trying to decode a frame (PTS: %lld)", track_id, packet->GetPts());
+	OV_PROBE4(decoder_in, _stream_input->GetId(), decoder_id, packet->GetPts(), packet->GetDataLength());
 	decoder->SendBuffer(std::move(packet));
 
+	auto decode_time = std::chrono::steady_clock::now() - start_time;
+
 	while (true)
 	{
 		TranscodeResult result;
+		size_t queue_limit;
+
+		start_time = std::chrono::steady_clock::now();
 		auto decoded_frame = decoder->RecvBuffer(&result);
+		decode_time += std::chrono::steady_clock::now() - start_time;
 
 		switch (result)
 		{
 			case TranscodeResult::FormatChanged:
 				// It indicates output format is changed
-
-				// Re-create filter and encoder using the format
-				decoded_frame->SetTrackId(decoder_id);
-				ChangeOutputFormat(decoded_frame.get());
-
 				[[fallthrough]];
 
 			case TranscodeResult::DataReady:
 				decoded_frame->SetTrackId(decoder_id);
+				OV_PROBE4(decoder_out, _stream_input->GetId(), decoder_id, decoded_frame->GetPts(), decoded_frame->GetBufferSize());
+
+				if (decode_delay != nullptr)
+				{
+					auto send_time_item = decode_delay->send_times.find(decoded_frame->GetPts());
+
+					if (send_time_item != decode_delay->send_times.end())
+					{
+						decode_delay->histogram->Record(send_time_item->second);
+
+						// The packets before this frame are already output (or never will be)
+						decode_delay->send_times.erase(decode_delay->send_times.begin(), std::next(send_time_item));
+					}
+				}
 
 				// logtp("[#%d] A packet is decoded (PTS: %lld)", decoder_id, decoded_frame->GetPts());
-				if (_queue_decoded_frames.Size() > _max_queue_threshold)
+
+				if (_audio_strand != nullptr)
 				{
-					logti("Decoded frame queue is full, please check your system");
-					return result;
+					FilterDecodedFrame(std::move(decoded_frame), (result == TranscodeResult::FormatChanged));
+					break;
 				}
 
-				_queue_decoded_frames.Enqueue(std::move(decoded_frame));
+				// Wait for the filter stage if it is busy (The filters will be re-created in the filter stage if the format is changed)
+				queue_limit = GetQueueLimit(decoded_frame.get());
 
-				if(GetParent() != nullptr)
-					GetParent()->AppendIndicator(this->GetSharedPtr(), TranscodeApplication::IndicatorQueueType::BUFFER_INDICATOR_DECODED_FRAMES);
+				if (_filter_stage->queue.EnqueueWait({std::move(decoded_frame), (result == TranscodeResult::FormatChanged)}, queue_limit) == false)
+				{
+					// Stop is requested
+					return TranscodeResult::NoData;
+				}
 
 				break;
 
 			default:
+				if (decode_latency != nullptr)
+				{
+					decode_latency->Record(std::chrono::duration_cast<std::chrono::microseconds>(decode_time).count());
+				}
+
 				// An error occurred
 				// There is no frame to process
 				return result;
@@ -855,9 +1634,9 @@ TranscodeResult TranscodeStream::DecodePacket(int32_t track_id, std::shared_ptr<
 	return TranscodeResult::NoData;
 }
 
-TranscodeResult TranscodeStream::FilterFrame(int32_t track_id, std::shared_ptr<MediaFrame> decoded_frame)
+TranscodeResult TranscodeStream::FilterFrame(int32_t filter_id, std::shared_ptr<MediaFrame> frame)
 {
-	auto filter_item = _filters.find(track_id);
+	auto filter_item = _filters.find(filter_id);
 	if (filter_item == _filters.end())
 	{
 		return TranscodeResult::NoData;
@@ -865,13 +1644,32 @@ TranscodeResult TranscodeStream::FilterFrame(int32_t track_id, std::shared_ptr<M
 
 	auto filter = filter_item->second.get();
 
-	// logtp("[#%d] Trying to apply a filter to the frame (PTS: %lld)", track_id, decoded_frame->GetPts());
-	filter->SendBuffer(std::move(decoded_frame));
+	// Only the calls of the filter are measured (not the child filters and the time waiting for the encoders)
+	auto &filter_latency = _filter_latencies[filter_id];
+	if (filter_latency == nullptr)
+	{
+		filter_latency = MonitorInstance->GetLatencyMetrics().GetHistogram(mon::LatencyStage::Filter, GetLatencyLabels(filter_id));
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	// logtp("[#%d] Trying to apply a filter to the frame (PTS: %lld)", filter_id, frame->GetPts());
+	filter->SendBuffer(std::move(frame));
+
+	auto filter_time = std::chrono::steady_clock::now() - start_time;
 
 	while (true)
 	{
 		TranscodeResult result;
+
+		start_time = std::chrono::steady_clock::now();
 		auto filtered_frame = filter->RecvBuffer(&result);
+		filter_time += std::chrono::steady_clock::now() - start_time;
+
+		if (result != TranscodeResult::DataReady)
+		{
+			filter_latency->Record(std::chrono::duration_cast<std::chrono::microseconds>(filter_time).count());
+		}
 
 		if (static_cast<int>(result) < 0)
 		{
@@ -881,16 +1679,71 @@ TranscodeResult TranscodeStream::FilterFrame(int32_t track_id, std::shared_ptr<M
 		switch (result)
 		{
 			case TranscodeResult::DataReady:
-				filtered_frame->SetTrackId(track_id);
+			{
+				filtered_frame->SetTrackId(filter_id);
 
-				// logtd("[#%d] A frame is filtered (PTS: %lld)", track_id, filtered_frame->GetPts());
+				// logtd("[#%d] A frame is filtered (PTS: %lld)", filter_id, filtered_frame->GetPts());
 
-				_queue_filterd_frames.Enqueue(std::move(filtered_frame));
+				// Feed the smaller renditions scaled from this rendition
+				auto children_item = _filter_children.find(filter_id);
+				bool is_children_fed = true;
 
-				if(GetParent() != nullptr)
-					GetParent()->AppendIndicator(this->GetSharedPtr(), TranscodeApplication::IndicatorQueueType::BUFFER_INDICATOR_FILTERED_FRAMES);
+				if ((children_item != _filter_children.end()) &&
+					(_degrade_ladder.GetLevel() >= TranscodeDegradeLevel::HalveFrameRate) && IsRootFilter(filter_id))
+				{
+					// The lower renditions get every other frame of the largest rendition
+					is_children_fed = ((_degrade_frame_counts[filter_id]++ % 2) == 0);
+				}
+
+				if ((children_item != _filter_children.end()) && is_children_fed)
+				{
+					for (auto child_filter_id : children_item->second)
+					{
+						if (IsFilterActive(child_filter_id))
+						{
+							FilterFrame(child_filter_id, filtered_frame);
+						}
+					}
+				}
+
+				auto encoders_item = _filter_encoders.find(filter_id);
+				if (encoders_item == _filter_encoders.end())
+				{
+					break;
+				}
+
+				// The filters and the encoders don't modify the frame, so they share it
+				auto queue_limit = GetQueueLimit(filtered_frame.get());
+
+				for (auto encoder_id : encoders_item->second)
+				{
+					if (_idle_encoders.find(encoder_id) != _idle_encoders.end())
+					{
+						continue;
+					}
+
+					if (_audio_strand != nullptr)
+					{
+						EncodeFrame(encoder_id, filtered_frame);
+						continue;
+					}
+
+					auto stage_item = _encode_stages.find(encoder_id);
+					if (stage_item == _encode_stages.end())
+					{
+						continue;
+					}
+
+					// Wait for the encoder if it is busy
+					if (stage_item->second->queue.EnqueueWait(filtered_frame, queue_limit) == false)
+					{
+						// Stop is requested
+						return TranscodeResult::NoData;
+					}
+				}
 
 				break;
+			}
 
 			default:
 				return result;
@@ -898,10 +1751,8 @@ TranscodeResult TranscodeStream::FilterFrame(int32_t track_id, std::shared_ptr<M
 	}
 }
 
-TranscodeResult TranscodeStream::EncodeFrame(int32_t filter_id, std::shared_ptr<const MediaFrame> frame)
+TranscodeResult TranscodeStream::EncodeFrame(int32_t encoder_id, std::shared_ptr<const MediaFrame> frame)
 {
-	auto encoder_id = _stage_filter_to_encoder[filter_id];
-
 	auto encoder_item = _encoders.find(encoder_id);
 	if (encoder_item == _encoders.end())
 	{
@@ -912,170 +1763,87 @@ TranscodeResult TranscodeStream::EncodeFrame(int32_t filter_id, std::shared_ptr<
 
 	// logtd("[#%d] Trying to encode the frame (PTS: %lld)", encoder_id, frame->GetPts());
 
-	encoder->SendBuffer(std::move(frame));
-
-	while (true)
+	auto latency_item = _encode_latencies.find(encoder_id);
+	if (latency_item != _encode_latencies.end())
 	{
-		TranscodeResult result;
-
-		auto encoded_packet = encoder->RecvBuffer(&result);
+		auto &send_times = latency_item->second.send_times;
 
-		if (static_cast<int>(result) < 0)
-		{
-			return result;
-		}
-
-		if (result == TranscodeResult::DataReady)
-		{
-			// logtd("[#%d] A packet is encoded (PTS: %lld)", encoder_id, encoded_packet->GetPts());
-
-			// Explore if output tracks exist to send encoded packets
-			auto stage_item = _stage_encoder_to_output.find(encoder_id);
-			if (stage_item == _stage_encoder_to_output.end())
-			{
-				continue;
-			}
-
-			// If a track exists to output, copy the encoded packet and send it to that track.
-			for (auto &iter : stage_item->second)
-			{
-				auto &output_stream = iter.first;
-				auto output_track_id = iter.second;
-
-				auto clone_packet = encoded_packet->ClonePacket();
-				clone_packet->SetTrackId(output_track_id);
-
-				// Send the packet to MediaRouter
-				SendFrame(output_stream, std::move(clone_packet));
-			}
-		}
-	}
-}
-
-#if 0
-void TranscodeStream::LoopTask()
-{
-	logtd("Started transcode stream message loop thread");
-
-	CreateStreams();
+		// The encoder may drop the frames, so the oldest times are discarded
+		if (send_times.size() >= TRANSCODE_ENCODE_LATENCY_MAX_PENDING_FRAMES)
+		{
+			send_times.pop_front();
+		}
 
-	time_t base_time;
-	time(&base_time);
+		send_times.push_back(std::chrono::steady_clock::now());
+	}
 
-	while (!_kill_flag)
-	{
-		_queue_event.Wait();
+	OV_PROBE4(encoder_in, _stream_input->GetId(), encoder_id, frame->GetPts(), frame->GetBufferSize());
+	encoder->SendBuffer(std::move(frame));
 
-		time_t curr_time;
-		time(&curr_time);
+	SendEncodedPackets(encoder_id);
 
-		// for statistics
-		if (difftime(curr_time, base_time) >= 20)
-		{
-			base_time = curr_time;
+	return TranscodeResult::DataReady;
+}
 
-			ov::String dbg_str = ov::String::FormatString("\nStatistics of Transcode Stream [%s/%s]\n"
-				, _application_info.GetName().CStr(), _stream_input->GetName().CStr());
+void TranscodeStream::SendEncodedPackets(int32_t encoder_id)
+{
+	auto encoder_item = _encoders.find(encoder_id);
+	if (encoder_item == _encoders.end())
+	{
+		return;
+	}
 
-			
-			dbg_str.AppendFormat(" - Pipeline\n\tdecode.ready[%d], filter.ready[%d], encode.ready[%d]\n"
-				, _queue_input_packets.Size(), _queue_decoded_frames.Size(), _queue_filterd_frames.Size());
+	auto encoder = encoder_item->second.get();
 
-			dbg_str.AppendFormat(" - Decoders\n");
-			for (auto &iter : _decoders)
-			{
-				auto track_id =iter.first; 
-				auto object = iter.second;
-				dbg_str.AppendFormat("\t[%d] track : input.q [%d], output.q [%d]\n"
-					, track_id, object->GetInputBufferSize(), object->GetOutputBufferSize());
-			}
+	// Explore if output tracks exist to send encoded packets
+	auto stage_item = _stage_encoder_to_output.find(encoder_id);
 
-			dbg_str.AppendFormat(" - Filters\n");
-			for (auto &iter : _filters)
-			{
-				auto track_id =iter.first; 
-				auto object = iter.second;
-				dbg_str.AppendFormat("\t[%d] track : input.q [%d], output.q [%d]\n"
-					, track_id, object->GetInputBufferSize(), object->GetOutputBufferSize());
-			}
+	auto latency_item = _encode_latencies.find(encoder_id);
+	auto encode_latency = (latency_item != _encode_latencies.end()) ? &(latency_item->second) : nullptr;
 
-			dbg_str.AppendFormat(" - Encoders\n");
-			for (auto &iter : _encoders)
-			{
-				auto track_id =iter.first; 
-				auto object = iter.second;
-				dbg_str.AppendFormat("\t[%d] track : input.q [%d], output.q [%d]\n"
-					, track_id, object->GetInputBufferSize(), object->GetOutputBufferSize());
-			}
+	while (true)
+	{
+		TranscodeResult result;
 
-			logts("%s", dbg_str.CStr() );
-		}
+		auto encoded_packet = encoder->RecvBuffer(&result);
 
-		if (_queue_input_packets.Size() > 0)
+		if (result != TranscodeResult::DataReady)
 		{
-			auto packet = _queue_input_packets.Dequeue();
-			if (packet.has_value())
-			{
-				int32_t track_id = packet.value()->GetTrackId();
-
-				DecodePacket(track_id, std::move(packet.value()));
-			}
+			return;
 		}
 
-		if (_queue_decoded_frames.Size() > 0)
+		// logtd("[#%d] A packet is encoded (PTS: %lld)", encoder_id, encoded_packet->GetPts());
+		OV_PROBE4(encoder_out, _stream_input->GetId(), encoder_id, encoded_packet->GetPts(), encoded_packet->GetDataLength());
+
+		if ((encode_latency != nullptr) && (encode_latency->send_times.empty() == false))
 		{
-			auto frame = _queue_decoded_frames.Dequeue();
-			if (frame.has_value())
-			{
-				DoFilters(std::move(frame.value()));
-			}
+			encode_latency->histogram->Record(encode_latency->send_times.front());
+			encode_latency->send_times.pop_front();
 		}
 
-		while (_queue_filterd_frames.Size() > 0)
+		if (stage_item == _stage_encoder_to_output.end())
 		{
-			auto frame = _queue_filterd_frames.Dequeue();
-			if (frame.has_value())
-			{
-				int32_t filter_id = frame.value()->GetTrackId();
-
-				EncodeFrame(filter_id, std::move(frame.value()));
-			}
+			continue;
 		}
-	}
-
-	logtd("Terminated transcode message loop thread");
-}
-#endif
-
-void TranscodeStream::DoInputPackets()
-{
-	auto packet = _queue_input_packets.Dequeue();
-	if (packet.has_value())
-	{
-		int32_t track_id = packet.value()->GetTrackId();
 
-		DecodePacket(track_id, std::move(packet.value()));
-	}
-}
+		// If a track exists to output, copy the encoded packet and send it to that track.
+		// (The clones share the payload with encoded_packet, and the last track uses encoded_packet itself)
+		auto &output_tracks = stage_item->second;
+		size_t remained_track_count = output_tracks.size();
 
+		for (auto &iter : output_tracks)
+		{
+			auto &output_stream = iter.first;
+			auto output_track_id = iter.second;
 
-void TranscodeStream::DoDecodedFrames()
-{
-	auto frame = _queue_decoded_frames.Dequeue();
-	if (frame.has_value())
-	{
-		DoFilters(std::move(frame.value()));
-	}
-}
+			remained_track_count--;
 
-void TranscodeStream::DoFilteredFrames()
-{
-	auto frame = _queue_filterd_frames.Dequeue();
-	if (frame.has_value())
-	{
-		int32_t filter_id = frame.value()->GetTrackId();
+			auto clone_packet = (remained_track_count > 0) ? encoded_packet->ClonePacket() : std::move(encoded_packet);
+			clone_packet->SetTrackId(output_track_id);
 
-		EncodeFrame(filter_id, std::move(frame.value()));
+			// Send the packet to MediaRouter
+			SendFrame(output_stream, std::move(clone_packet));
+		}
 	}
 }
 
@@ -1153,11 +1921,27 @@ void TranscodeStream::CreateFilters(MediaFrame *buffer)
 		return;
 	}
 
+	// Remove the filters created with the previous format
+	auto root_filters_item = _decoder_root_filters.find(decoder_id);
+	if (root_filters_item != _decoder_root_filters.end())
+	{
+		for (auto root_filter_id : root_filters_item->second)
+		{
+			RemoveFilterTree(root_filter_id);
+		}
+
+		_decoder_root_filters.erase(root_filters_item);
+	}
+
+	// 4. Merge the filters that have the same output
+	// [FILTER_ID, Output context]
+	std::vector<std::pair<MediaTrackId, std::shared_ptr<TranscodeContext>>> renditions;
+
 	for (auto &filter_id : filter_item->second)
 	{
 		auto encoder_id = _stage_filter_to_encoder[filter_id];
 
-		if(_encoders.find(encoder_id) == _encoders.end())
+		if (_encoders.find(encoder_id) == _encoders.end())
 		{
 			logte("%d track encoder is not allocated", encoder_id);
 			continue;
@@ -1165,19 +1949,158 @@ void TranscodeStream::CreateFilters(MediaFrame *buffer)
 
 		auto output_transcode_context = _encoders[encoder_id]->GetContext();
 
+		auto rendition = std::find_if(renditions.begin(), renditions.end(), [&output_transcode_context](const auto &rendition) -> bool {
+			return IsSameFilterOutput(rendition.second, output_transcode_context);
+		});
+
+		if (rendition != renditions.end())
+		{
+			logtd("Encoder #%d shares the filter #%d", encoder_id, rendition->first);
+			_filter_encoders[rendition->first].push_back(encoder_id);
+			continue;
+		}
+
+		renditions.emplace_back(filter_id, output_transcode_context);
+		_filter_encoders[filter_id].push_back(encoder_id);
+	}
+
+	if (input_media_track->GetMediaType() == common::MediaType::Video)
+	{
+		// Create the larger rendition first to be able to feed the smaller renditions
+		std::stable_sort(renditions.begin(), renditions.end(), [](const auto &rendition1, const auto &rendition2) -> bool {
+			return (static_cast<uint64_t>(rendition1.second->GetVideoWidth()) * rendition1.second->GetVideoHeight()) >
+				   (static_cast<uint64_t>(rendition2.second->GetVideoWidth()) * rendition2.second->GetVideoHeight());
+		});
+	}
+
+	// 5. Create the filters
+	for (size_t index = 0; index < renditions.size(); index++)
+	{
+		auto filter_id = renditions[index].first;
+		auto &output_transcode_context = renditions[index].second;
+
+		auto filter_input_track = input_media_track;
+		auto filter_input_context = input_transcode_context;
+		MediaTrackId parent_filter_id = -1;
+
+		if (input_media_track->GetMediaType() == common::MediaType::Video)
+		{
+			// Find the smallest rendition that is larger than this rendition (renditions are sorted by the size)
+			for (size_t parent_index = index; parent_index > 0; parent_index--)
+			{
+				auto &parent = renditions[parent_index - 1];
+
+				if ((_filters.find(parent.first) != _filters.end()) && IsCascadableFilterOutput(parent.second, output_transcode_context))
+				{
+					parent_filter_id = parent.first;
+
+					// The parent outputs the scaled frames in YUV420P with the timebase of the output context
+					filter_input_track = std::make_shared<MediaTrack>();
+					filter_input_track->SetId(input_media_track->GetId());
+					filter_input_track->SetMediaType(common::MediaType::Video);
+					filter_input_track->SetWidth(parent.second->GetVideoWidth());
+					filter_input_track->SetHeight(parent.second->GetVideoHeight());
+					filter_input_track->SetFormat(AV_PIX_FMT_YUV420P);
+					filter_input_track->SetTimeBase(parent.second->GetTimeBase().GetNum(), parent.second->GetTimeBase().GetDen());
+
+					filter_input_context = parent.second;
+					break;
+				}
+			}
+		}
+
 		auto transcode_filter = std::make_shared<TranscodeFilter>();
 
-		bool ret = transcode_filter->Configure(input_media_track, input_transcode_context, output_transcode_context);
+		bool ret = transcode_filter->Configure(filter_input_track, filter_input_context, output_transcode_context);
 		if (ret == true)
 		{
 			_filters[filter_id] = transcode_filter;
+
+			if (parent_filter_id >= 0)
+			{
+				logtd("Filter #%d is fed by filter #%d (%ux%u -> %ux%u)", filter_id, parent_filter_id,
+					  filter_input_track->GetWidth(), filter_input_track->GetHeight(),
+					  output_transcode_context->GetVideoWidth(), output_transcode_context->GetVideoHeight());
+
+				_filter_children[parent_filter_id].push_back(filter_id);
+			}
+			else
+			{
+				_decoder_root_filters[decoder_id].push_back(filter_id);
+			}
 		}
 		else
 		{
 			// TODO(soulk) : Create exception processing code if filter creation fails
 			logte("Failed to create filter");
+			_filter_encoders.erase(filter_id);
+		}
+	}
+}
+
+void TranscodeStream::RemoveFilterTree(MediaTrackId filter_id)
+{
+	auto children_item = _filter_children.find(filter_id);
+
+	if (children_item != _filter_children.end())
+	{
+		auto children = std::move(children_item->second);
+		_filter_children.erase(children_item);
+
+		for (auto child_filter_id : children)
+		{
+			RemoveFilterTree(child_filter_id);
 		}
 	}
+
+	_filter_encoders.erase(filter_id);
+	_filters.erase(filter_id);
+	_filter_latencies.erase(filter_id);
+}
+
+bool TranscodeStream::IsSameFilterOutput(const std::shared_ptr<TranscodeContext> &context1, const std::shared_ptr<TranscodeContext> &context2)
+{
+	if ((context1->GetMediaType() != context2->GetMediaType()) ||
+		(context1->GetTimeBase().GetNum() != context2->GetTimeBase().GetNum()) ||
+		(context1->GetTimeBase().GetDen() != context2->GetTimeBase().GetDen()))
+	{
+		return false;
+	}
+
+	switch (context1->GetMediaType())
+	{
+		case common::MediaType::Video:
+			return (context1->GetVideoWidth() == context2->GetVideoWidth()) &&
+				   (context1->GetVideoHeight() == context2->GetVideoHeight()) &&
+				   (context1->GetFrameRate() == context2->GetFrameRate()) &&
+				   (context1->GetHWAccel() == context2->GetHWAccel());
+
+		case common::MediaType::Audio:
+			return (context1->GetAudioSampleRate() == context2->GetAudioSampleRate()) &&
+				   (context1->GetAudioSample().GetFormat() == context2->GetAudioSample().GetFormat()) &&
+				   (context1->GetAudioChannel().GetLayout() == context2->GetAudioChannel().GetLayout());
+
+		default:
+			break;
+	}
+
+	return false;
+}
+
+bool TranscodeStream::IsCascadableFilterOutput(const std::shared_ptr<TranscodeContext> &parent, const std::shared_ptr<TranscodeContext> &child)
+{
+	// The frames on the device are scaled from the decoded frame (the frames context of the parent is not known until it outputs a frame)
+	if ((parent->GetHWAccel() != TranscodeHWAccel::None) || (child->GetHWAccel() != TranscodeHWAccel::None))
+	{
+		return false;
+	}
+
+	return (parent->GetVideoWidth() >= child->GetVideoWidth()) &&
+		   (parent->GetVideoHeight() >= child->GetVideoHeight()) &&
+		   // The fps filter of the parent must not drop the frames needed by the child
+		   (parent->GetFrameRate() == child->GetFrameRate()) &&
+		   (parent->GetTimeBase().GetNum() == child->GetTimeBase().GetNum()) &&
+		   (parent->GetTimeBase().GetDen() == child->GetTimeBase().GetDen());
 }
 
 void TranscodeStream::DoFilters(std::shared_ptr<MediaFrame> frame)
@@ -1186,24 +2109,224 @@ void TranscodeStream::DoFilters(std::shared_ptr<MediaFrame> frame)
 	int32_t decoder_id = frame->GetTrackId();
 
 	// Query filter list to forward decode frame
-	auto filter_item = _stage_decoder_to_filter.find(decoder_id);
-	if (filter_item == _stage_decoder_to_filter.end())
+	auto filter_item = _decoder_root_filters.find(decoder_id);
+	if (filter_item == _decoder_root_filters.end())
 	{
 		logtw("No filter list found");
 		return;
 	}
 
+	// The filters don't modify the decoded frame, so they share it
 	for (auto &filter_id : filter_item->second)
 	{
-		auto frame_clone = frame->CloneFrame();
-		if (frame_clone == nullptr)
+		if (IsFilterActive(filter_id))
+		{
+			FilterFrame(filter_id, frame);
+		}
+	}
+}
+
+void TranscodeStream::UpdateOnDemandStreams()
+{
+	auto now = std::chrono::steady_clock::now();
+	bool is_changed = false;
+
+	for (auto &item : _on_demand_streams)
+	{
+		auto &state = item.second;
+		auto stream_output = _stream_outputs.find(item.first);
+
+		if (stream_output == _stream_outputs.end())
 		{
-			logte("FilterTask -> Unknown Frame");
 			continue;
 		}
 
-		FilterFrame(filter_id, std::move(frame_clone));
+		auto stream_metrics = mon::Monitoring::GetInstance()->GetStreamMetrics(*(stream_output->second));
+		auto connections = (stream_metrics != nullptr) ? stream_metrics->GetTotalConnections() : 0;
+
+		if (connections > 0)
+		{
+			state.last_session_time = now;
+
+			if (state.is_active == false)
+			{
+				logti("[%s/%s] On-demand stream is requested by %u sessions, starting the encoders", _application_info.GetName().CStr(), item.first.CStr(), connections);
+
+				state.is_active = true;
+				is_changed = true;
+			}
+		}
+		else if (state.is_active && (std::chrono::duration_cast<std::chrono::milliseconds>(now - state.last_session_time).count() >= state.idle_timeout_ms))
+		{
+			logti("[%s/%s] On-demand stream has no session for %lld ms, stopping the encoders", _application_info.GetName().CStr(), item.first.CStr(), static_cast<long long>(state.idle_timeout_ms));
+
+			state.is_active = false;
+			is_changed = true;
+		}
+	}
+
+	if (is_changed)
+	{
+		UpdateIdleEncoders();
+	}
+}
+
+void TranscodeStream::UpdateIdleEncoders()
+{
+	for (auto &encoder_item : _encoders)
+	{
+		auto encoder_id = encoder_item.first;
+		auto outputs = _stage_encoder_to_output.find(encoder_id);
+		bool is_needed = (outputs == _stage_encoder_to_output.end());
+
+		if (is_needed == false)
+		{
+			for (auto &output : outputs->second)
+			{
+				auto state = _on_demand_streams.find(output.first->GetName());
+
+				if ((state == _on_demand_streams.end()) || state->second.is_active)
+				{
+					is_needed = true;
+					break;
+				}
+			}
+		}
+
+		if (is_needed)
+		{
+			if (_idle_encoders.erase(encoder_id) > 0)
+			{
+				// The new sessions can't start playing until the next keyframe
+				encoder_item.second->RequestKeyFrame();
+			}
+		}
+		else
+		{
+			_idle_encoders.insert(encoder_id);
+		}
+	}
+}
+
+bool TranscodeStream::IsFilterActive(MediaTrackId filter_id) const
+{
+	if (_idle_encoders.empty())
+	{
+		return true;
+	}
+
+	auto encoders_item = _filter_encoders.find(filter_id);
+
+	if (encoders_item != _filter_encoders.end())
+	{
+		for (auto encoder_id : encoders_item->second)
+		{
+			if (_idle_encoders.find(encoder_id) == _idle_encoders.end())
+			{
+				return true;
+			}
+		}
+	}
+
+	// The smaller renditions are scaled from this filter
+	auto children_item = _filter_children.find(filter_id);
+
+	if (children_item != _filter_children.end())
+	{
+		for (auto child_filter_id : children_item->second)
+		{
+			if (IsFilterActive(child_filter_id))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void TranscodeStream::UpdateDegradeLevel()
+{
+	auto elapsed = _degrade_stop_watch.Elapsed();
+	_degrade_stop_watch.Update();
+
+	auto busy_ratio = (elapsed > 0) ? (std::chrono::duration_cast<std::chrono::microseconds>(_filter_busy_time).count() / (elapsed * 1000.0)) : 0.0;
+	_filter_busy_time = {};
+
+	auto queue_pressure = GetQueuePressure();
+	auto old_level = _degrade_ladder.GetLevel();
+
+	if (_degrade_ladder.Update(queue_pressure, busy_ratio) == false)
+	{
+		return;
+	}
+
+	auto new_level = _degrade_ladder.GetLevel();
+
+	if (new_level > old_level)
+	{
+		logtw("[%s/%s(%u)] Transcoder cannot keep up (queue: %.0f%%, busy: %.0f%%), degraded: %s -> %s",
+			  _application_info.GetName().CStr(), _stream_input->GetName().CStr(), _stream_input->GetId(),
+			  queue_pressure * 100.0, busy_ratio * 100.0,
+			  TranscodeDegradeLadder::GetLevelName(old_level), TranscodeDegradeLadder::GetLevelName(new_level));
+	}
+	else
+	{
+		logti("[%s/%s(%u)] Transcoder is relieved, restored: %s -> %s",
+			  _application_info.GetName().CStr(), _stream_input->GetName().CStr(), _stream_input->GetId(),
+			  TranscodeDegradeLadder::GetLevelName(old_level), TranscodeDegradeLadder::GetLevelName(new_level));
+	}
+
+	if ((old_level >= TranscodeDegradeLevel::HalveFrameRate) && (new_level < TranscodeDegradeLevel::HalveFrameRate))
+	{
+		_degrade_frame_counts.clear();
+	}
+}
+
+double TranscodeStream::GetQueuePressure() const
+{
+	if (_max_queue_threshold == 0)
+	{
+		return 0.0;
+	}
+
+	size_t max_size = 0;
+
+	for (auto &iter : _decode_stages)
+	{
+		max_size = std::max(max_size, iter.second->queue.Size());
+	}
+
+	if (_filter_stage != nullptr)
+	{
+		max_size = std::max(max_size, _filter_stage->queue.Size());
+	}
+
+	for (auto &iter : _encode_stages)
+	{
+		max_size = std::max(max_size, iter.second->queue.Size());
 	}
+
+	return static_cast<double>(max_size) / _max_queue_threshold;
+}
+
+bool TranscodeStream::IsRootFilter(MediaTrackId filter_id) const
+{
+	for (auto &iter : _decoder_root_filters)
+	{
+		if (std::find(iter.second.begin(), iter.second.end(), filter_id) != iter.second.end())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t TranscodeStream::GetQueueLimit(const MediaFrame *frame) const
+{
+	// The frames on the device hold the surfaces of the decoder/filter, so only a few frames can be queued
+	return TranscodeHWAccelHelper::IsDeviceFrame(frame) ? TRANSCODE_HW_MAX_QUEUED_FRAMES : _max_queue_threshold;
 }
 
 uint8_t TranscodeStream::NewTrackId(common::MediaType media_type)
@@ -1265,6 +2388,36 @@ bool TranscodeStream::IsVideoCodec(common::MediaCodecId codec_id)
 	return false;
 }
 
+bool TranscodeStream::IsWebRtcCompatible(const std::shared_ptr<MediaTrack> &track)
+{
+	if (track->GetCodecId() != common::MediaCodecId::H264)
+	{
+		return false;
+	}
+
+	// The parameter sets of the input are known when the stream is created (the sequence header of RTMP)
+	const auto &codec_extradata = track->GetCodecExtradata();
+	H264Extradata h264_extradata;
+
+	if (codec_extradata.empty() || (h264_extradata.Deserialize(codec_extradata) == false) || h264_extradata.GetSps().empty())
+	{
+		return false;
+	}
+
+	for (const auto &sps_bitstream : h264_extradata.GetSps())
+	{
+		H264Sps sps;
+
+		// The B-frames cannot be detected before the frames are received, so only Baseline (which has no B-frames) is bypassed
+		if ((H264Sps::Parse(sps_bitstream.data(), sps_bitstream.size(), sps) == false) || (sps.GetProfile() != 66))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 bool TranscodeStream::IsAudioCodec(common::MediaCodecId codec_id)
 {
 	if( codec_id == common::MediaCodecId::Aac || codec_id == common::MediaCodecId::Mp3 || codec_id == common::MediaCodecId::Opus)
@@ -11,25 +11,40 @@
 #include "codec/transcode_decoder.h"
 #include "codec/transcode_encoder.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <vector>
 #include <queue>
+#include <thread>
 
 #include "base/media_route/media_buffer.h"
 #include "base/media_route/media_type.h"
 #include "base/info/stream.h"
+#include "base/ovlibrary/executor.h"
 
 #include "transcode_context.h"
+#include "transcode_degrade_ladder.h"
 #include "transcode_filter.h"
+#include "transcode_scheduler.h"
 
 #include "codec/transcode_encoder.h"
 #include "codec/transcode_decoder.h"
+#include "codec/transcode_frame_pool.h"
 
 #include <base/info/application.h>
+#include <monitoring/latency_metrics.h>
 
 typedef int32_t MediaTrackId;
 
+// The minimum interval of the key frame requests to the provider (for the bypass video tracks)
+#define TRANSCODE_UPSTREAM_KEY_FRAME_REQUEST_INTERVAL_MS 1000
+
+// The maximum number of the frames waiting for the encoder to measure the encode latency
+#define TRANSCODE_ENCODE_LATENCY_MAX_PENDING_FRAMES 256
+
 class TranscodeApplication;
 
 class TranscodeStageContext
@@ -51,21 +66,115 @@ public:
 
 	bool Push(std::shared_ptr<MediaPacket> packet);
 
+	const std::shared_ptr<info::Stream> &GetInputStream() const;
+
+	// Forces the video encoders that feed the output stream to encode a key frame.
+	// If the output stream has a bypass video track, the key frame is requested to the provider of the input stream.
+	// Returns false if the output stream is not created by this stream.
+	bool RequestKeyFrame(const std::shared_ptr<info::Stream> &output_stream);
+
+	// Passes the packet loss reported by the players of the output stream to the audio encoders that feed it.
+	// Returns false if the output stream is not created by this stream.
+	bool ReportPacketLoss(const std::shared_ptr<info::Stream> &output_stream, int32_t packet_loss_percentage);
+
+	// Must be called before Start()
+	void SetExcludedProfiles(const std::set<ov::String> &excluded_profiles);
+
+	// The costs of the video encoders that will be created for the stream (one per <Encode>)
+	static std::vector<TranscodeScheduler::EncodeCost> GetEncodeCosts(const info::Application &application_info, const std::shared_ptr<info::Stream> &stream);
+
+	// The pool of the audio-only streams (See <Performance><AudioTranscodePool> of Server.xml)
+	static ov::Executor *GetAudioExecutor();
+
 	// For statistics
 	uint64_t 	_max_queue_threshold;
 
-
-	void DoInputPackets();
-	void DoDecodedFrames();
-	void DoFilteredFrames();
-	
 private:
-	// ov::Semaphore _queue_event;
+	// The stages of the pipeline are processed by their own threads
+	//  - Decode: a thread per decoder (input track)
+	//  - Filter: a thread per stream
+	//  - Encode: a thread per encoder (output track)
+	// If the queue of the next stage is full, the previous stage waits for it (backpressure)
+	template <typename T>
+	struct Stage
+	{
+		Stage(const char *alias, size_t threshold)
+			: queue(alias, threshold)
+		{
+		}
+
+		ov::Queue<T> queue;
+		std::thread thread;
+	};
+
+	struct DecodedFrame
+	{
+		std::shared_ptr<MediaFrame> frame;
+		// Filters must be (re)created for this frame
+		bool is_format_changed = false;
+	};
+
+	bool StartStages();
+	void StopStages();
+
+	// Runs the stage thread on the NUMA node of the input stream (if NUMA is enabled)
+	void BindStageToNumaNode();
+	void DecodeStageLoop(MediaTrackId decoder_id, Stage<std::shared_ptr<MediaPacket>> *stage);
+	void FilterStageLoop(Stage<DecodedFrame> *stage);
+	void EncodeStageLoop(MediaTrackId encoder_id, Stage<std::shared_ptr<const MediaFrame>> *stage);
+
+	// The planes of the frames decoded/filtered by this stream (shared by the decoders and the filters)
+	std::shared_ptr<TranscodeFramePool> _frame_pool = TranscodeFramePool::Create();
+
+	// DECODER_ID, STAGE
+	std::map<MediaTrackId, std::unique_ptr<Stage<std::shared_ptr<MediaPacket>>>> _decode_stages;
+	std::unique_ptr<Stage<DecodedFrame>> _filter_stage;
+	// ENCODER_ID, STAGE
+	std::map<MediaTrackId, std::unique_ptr<Stage<std::shared_ptr<const MediaFrame>>>> _encode_stages;
+
+	// The audio-only streams have no stage threads when the audio transcode pool is running.
+	// The packets are decoded, filtered and encoded by a task of the strand instead (the decoders, filters and encoders are inline)
+	bool _use_audio_pool = false;
+	std::shared_ptr<ov::Strand> _audio_strand;
+	// The packets posted to the strand but not decoded yet
+	std::atomic<uint64_t> _audio_pending_count{0};
+
+	bool PostAudioPacket(MediaTrackId decoder_id, std::shared_ptr<MediaPacket> packet);
+	// (Re)creates the filters if needed, and filters the frame (by the filter stage or the strand)
+	void FilterDecodedFrame(std::shared_ptr<MediaFrame> frame, bool is_format_changed);
+
+	// Latency histograms (See mon::LatencyMetrics), each of them is used only by the thread of its stage
+	struct EncodeLatency
+	{
+		std::shared_ptr<mon::LatencyHistogram> histogram;
+		// The times the frames were sent to the encoder, the encoder outputs the packets in the same order
+		std::deque<std::chrono::steady_clock::time_point> send_times;
+	};
+
+	struct DecodeDelay
+	{
+		std::shared_ptr<mon::LatencyHistogram> histogram;
+		// PTS : the time the packet was sent to the decoder (the decoder may reorder the frames)
+		std::map<int64_t, std::chrono::steady_clock::time_point> send_times;
+	};
+
+	mon::MetricLabels GetLatencyLabels(MediaTrackId track_id) const;
+
+	// DECODER_ID, HISTOGRAM
+	std::map<MediaTrackId, std::shared_ptr<mon::LatencyHistogram>> _decode_latencies;
+	// DECODER_ID, DELAY
+	std::map<MediaTrackId, DecodeDelay> _decode_delays;
+	// FILTER_ID, HISTOGRAM (created when the filter is used first)
+	std::map<MediaTrackId, std::shared_ptr<mon::LatencyHistogram>> _filter_latencies;
+	// ENCODER_ID, LATENCY
+	std::map<MediaTrackId, EncodeLatency> _encode_latencies;
 
 	const info::Application _application_info;
 
 	// Input Stream Info
 	std::shared_ptr<info::Stream> _stream_input;
+	// The frames and the packets of the stages (See ov::MemoryAccounting)
+	std::shared_ptr<ov::MemoryAccount> _memory_account;
 
 	// Output Stream Info
 	// [OUTPUT_STREAM_NAME, OUTPUT_stream]
@@ -81,8 +190,29 @@ private:
 	// [INPUT_TRACK, DECODER_ID]
 	std::map <MediaTrackId, MediaTrackId> _stage_input_to_decoder;
 	
+	// The packets of the bypass tracks are sent to the output streams by Push() directly, without passing through the stages
+	struct BypassOutput
+	{
+		std::shared_ptr<info::Stream> stream;
+		MediaTrackId track_id;
+
+		// The timestamps are rescaled only if the timebase of the output track is different from the input track
+		bool is_rescale_required;
+		AVRational input_timebase;
+		AVRational output_timebase;
+	};
+
+	struct BypassLane
+	{
+		bool is_video = false;
+		// The video packets are dropped until the first key frame, so the output starts with a decodable frame
+		bool is_started = false;
+
+		std::vector<BypassOutput> outputs;
+	};
+
 	// [INPUT_TRACK, Output Stream + Track Id]
-	std::map <MediaTrackId, std::vector<std::pair<std::shared_ptr<info::Stream>, MediaTrackId>> > _stage_input_to_output;
+	std::map <MediaTrackId, BypassLane> _stage_input_to_output;
 
 	// [DECODER_ID, FILTER_ID(trasncode_id)]
 	std::map <MediaTrackId, std::vector<MediaTrackId> > _stage_decoder_to_filter;
@@ -102,28 +232,67 @@ private:
 	// FILTER_ID, FILTER
 	std::map<MediaTrackId, std::shared_ptr<TranscodeFilter>> _filters;
 
+	// Rendition tree (only accessed by the filter stage)
+	//
+	// The filters that have the same output (resolution/framerate or samplerate/layout) are created only once,
+	// and a smaller rendition is scaled from the nearest larger rendition instead of the decoded frame:
+	//     Decoder -> [1080p] -> Encoder(H264), Encoder(VP8)
+	//                  +-> [720p] -> Encoder(H264)
+	//                        +-> [360p] -> Encoder(H264)
+	// [DECODER_ID, FILTER_IDs fed by the decoder]
+	std::map<MediaTrackId, std::vector<MediaTrackId>> _decoder_root_filters;
+	// [FILTER_ID, FILTER_IDs fed by the filter]
+	std::map<MediaTrackId, std::vector<MediaTrackId>> _filter_children;
+	// [FILTER_ID, ENCODER_IDs fed by the filter]
+	std::map<MediaTrackId, std::vector<MediaTrackId>> _filter_encoders;
+
 	// Encoder
 	// ENCODER_ID, ENCODER
 	std::map<MediaTrackId, std::shared_ptr<TranscodeEncoder>> _encoders;
 
 
-	// Buffer for encoded(input) media packets
-	ov::Queue<std::shared_ptr<MediaPacket>> _queue_input_packets;
-
-	// Buffer for decoded frames
-	ov::Queue<std::shared_ptr<MediaFrame>> _queue_decoded_frames;
-
-	// Buffer for filtered frames
-	ov::Queue<std::shared_ptr<MediaFrame>> _queue_filterd_frames;
-
+	// On-demand output streams (<Stream><OnDemand>, only accessed by the filter stage)
+	struct OnDemandState
+	{
+		int64_t idle_timeout_ms = 0;
+		bool is_active = false;
+		std::chrono::steady_clock::time_point last_session_time;
+	};
+	// [OUTPUT_STREAM_NAME, STATE]
+	std::map<ov::String, OnDemandState> _on_demand_streams;
+	// The encoders that feed only the inactive on-demand streams (the frames are not sent to them)
+	std::set<MediaTrackId> _idle_encoders;
+	ov::StopWatch _on_demand_stop_watch;
+
+	// Degrades the stream while the stages cannot keep up (updated by the filter stage, read by the other stages)
+	TranscodeDegradeLadder _degrade_ladder;
+	ov::StopWatch _degrade_stop_watch;
+	// The time the filter stage spent for the frames (including the time waiting for the encoders) since the last update
+	std::chrono::steady_clock::duration _filter_busy_time{};
+	// [ROOT_FILTER_ID, FRAME_COUNT] The lower renditions are fed every other frame of the root filters while the frame rate is halved
+	std::map<MediaTrackId, uint64_t> _degrade_frame_counts;
+
+	void UpdateDegradeLevel();
+	// The depth of the fullest queue of the stages relative to its limit
+	double GetQueuePressure() const;
+	bool IsRootFilter(MediaTrackId filter_id) const;
+
+	// Checks the sessions of the on-demand streams (once per second)
+	void UpdateOnDemandStreams();
+	void UpdateIdleEncoders();
+	// Whether the filter feeds any encoder that is not idle
+	bool IsFilterActive(MediaTrackId filter_id) const;
+
+	// The key frame requests of the bypass tracks are sent to the provider at most once in this interval
+	std::atomic<int64_t> _last_upstream_key_frame_request_ms{0};
+
+	// The video profiles excluded by TranscodeScheduler (replaced with the bypass track)
+	std::set<ov::String> _excluded_profiles;
 
 	// last generated output track id.
 	uint8_t _last_track_index = 0;
 
-	volatile bool _kill_flag;
-
-	// void LoopTask();
-	// std::thread _thread_looptask;
+	volatile bool _kill_flag = true;
 
 	TranscodeApplication* GetParent();
 	TranscodeApplication* _parent;
@@ -136,21 +305,38 @@ private:
 	bool CreateDecoder(int32_t input_track_id, int32_t decoder_track_id, std::shared_ptr<TranscodeContext> input_context);
 
 	int32_t CreateEncoders();
+	// The interval (in milliseconds) of the keyframes of the renditions, the GCD of the segment durations of HLS/DASH/LLDASH
+	// (0 if none of them is enabled)
+	int32_t GetKeyFrameAlignment() const;
 	bool CreateEncoder(int32_t encoder_track_id, std::shared_ptr<MediaTrack> media_track, std::shared_ptr<TranscodeContext> output_context);
 
 	// Called when formatting of decoded frames is analyzed or changed.
 	void ChangeOutputFormat(MediaFrame *buffer);
 
 	void CreateFilters(MediaFrame *buffer);
+	// Removes the filter and the filters fed by it
+	void RemoveFilterTree(MediaTrackId filter_id);
+	// Whether a filter can feed both encoders
+	static bool IsSameFilterOutput(const std::shared_ptr<TranscodeContext> &context1, const std::shared_ptr<TranscodeContext> &context2);
+	// Whether the output of a video filter (parent) can be scaled to the output of another video filter (child)
+	static bool IsCascadableFilterOutput(const std::shared_ptr<TranscodeContext> &parent, const std::shared_ptr<TranscodeContext> &child);
 	void DoFilters(std::shared_ptr<MediaFrame> frame);
 
+	// Send the packet to the bypass output tracks
+	void BypassPacket(int32_t track_id, const std::shared_ptr<MediaPacket> &packet);
+
 	// There are 3 steps to process packet
 	// Step 1: Decode (Decode a frame from given packets)
-	TranscodeResult DecodePacket(int32_t track_id, std::shared_ptr<MediaPacket> packet);
+	TranscodeResult DecodePacket(int32_t decoder_id, std::shared_ptr<MediaPacket> packet);
 	// Step 2: Filter (resample/rescale the decoded frame)
-	TranscodeResult FilterFrame(int32_t track_id, std::shared_ptr<MediaFrame> frame);
+	TranscodeResult FilterFrame(int32_t filter_id, std::shared_ptr<MediaFrame> frame);
 	// Step 3: Encode (Encode the filtered frame to packets)
-	TranscodeResult EncodeFrame(int32_t track_id, std::shared_ptr<const MediaFrame> frame);
+	TranscodeResult EncodeFrame(int32_t encoder_id, std::shared_ptr<const MediaFrame> frame);
+	// Send the encoded packets to the output tracks
+	void SendEncodedPackets(int32_t encoder_id);
+
+	// The maximum number of frames that can be queued to the next stage
+	size_t GetQueueLimit(const MediaFrame *frame) const;
 
 	// Transcoding information
 	uint8_t NewTrackId(common::MediaType media_type);
@@ -164,12 +350,14 @@ private:
 	// Send frame with output stream's information
 	void SendFrame(std::shared_ptr<info::Stream> &stream, std::shared_ptr<MediaPacket> packet);
 
-	const cfg::Encode* GetEncodeByProfileName(const info::Application &application_info, ov::String encode_name);
+	static const cfg::Encode* GetEncodeByProfileName(const info::Application &application_info, ov::String encode_name);
 
-	common::MediaCodecId GetCodecId(ov::String name);
+	static common::MediaCodecId GetCodecId(ov::String name);
 
-	bool IsVideoCodec(common::MediaCodecId codec_id);
-	bool IsAudioCodec(common::MediaCodecId codec_id);
+	static bool IsVideoCodec(common::MediaCodecId codec_id);
+	// Whether the track can be sent to the browsers over WebRTC without the transcoding (See <AutoBypass> of the video profile)
+	static bool IsWebRtcCompatible(const std::shared_ptr<MediaTrack> &track);
+	static bool IsAudioCodec(common::MediaCodecId codec_id);
 
 	int GetBitrate(ov::String bitrate);
 };
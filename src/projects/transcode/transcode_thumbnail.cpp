@@ -0,0 +1,283 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "transcode_thumbnail.h"
+
+#include "codec/transcode_decoder.h"
+#include "codec/transcode_frame_helper.h"
+
+extern "C"
+{
+#include <libswscale/swscale.h>
+}
+
+#define OV_LOG_TAG "TranscodeThumbnail"
+
+// Gives up the key frame if the decoder doesn't output it with this many packets (e.g. the key frame is corrupted)
+#define TRANSCODE_THUMBNAIL_MAX_CAPTURING_PACKETS 30
+
+std::shared_ptr<TranscodeThumbnail> TranscodeThumbnail::Create(const info::Stream &stream_info, const std::shared_ptr<MediaTrack> &track, const Options &options)
+{
+	if ((track == nullptr) || (track->GetMediaType() != common::MediaType::Video) || (track->GetCodecId() != common::MediaCodecId::H264))
+	{
+		logtw("[%s/%s(%u)] Thumbnails can be made from a H264 track only", stream_info.GetApplicationInfo().GetName().CStr(), stream_info.GetName().CStr(), stream_info.GetId());
+		return nullptr;
+	}
+
+	auto thumbnail = std::make_shared<TranscodeThumbnail>(stream_info, options);
+
+	auto input_context = std::make_shared<TranscodeContext>(
+		false,
+		track->GetCodecId(),
+		track->GetBitrate(),
+		track->GetWidth(), track->GetHeight(),
+		track->GetFrameRate());
+
+	input_context->SetTimeBase(track->GetTimeBase());
+	// Only a key frame is decoded per interval, so a thread is enough and the frame must come out without the reordering delay
+	input_context->SetDecodeMode("lowdelay");
+	input_context->SetThreadCount(1);
+
+	thumbnail->_decoder = TranscodeDecoder::CreateDecoder(stream_info, track->GetCodecId(), input_context);
+
+	if (thumbnail->_decoder == nullptr)
+	{
+		return nullptr;
+	}
+
+	thumbnail->_decoder->SetSkipNonKey(true);
+
+	if (thumbnail->PrepareEncoder(0, 0) == false)
+	{
+		return nullptr;
+	}
+
+	return thumbnail;
+}
+
+TranscodeThumbnail::TranscodeThumbnail(const info::Stream &stream_info, const Options &options)
+	: _stream_info(stream_info),
+	  _options(options)
+{
+	_decoded_frame = ::av_frame_alloc();
+	_scaled_frame = ::av_frame_alloc();
+	_packet = ::av_packet_alloc();
+}
+
+TranscodeThumbnail::~TranscodeThumbnail()
+{
+	_decoder = nullptr;
+
+	::avcodec_free_context(&_encoder_context);
+	::sws_freeContext(_sws_context);
+
+	::av_frame_free(&_decoded_frame);
+	::av_frame_free(&_scaled_frame);
+	::av_packet_free(&_packet);
+}
+
+std::shared_ptr<ov::Data> TranscodeThumbnail::Process(const std::shared_ptr<MediaPacket> &packet)
+{
+	if (_is_capturing == false)
+	{
+		if ((packet->GetFlag() != MediaPacketFlag::Key) || (_is_captured && (_capture_stop_watch.IsElapsed(_options.interval_ms) == false)))
+		{
+			return nullptr;
+		}
+
+		_is_capturing = true;
+		_capturing_packet_count = 0;
+		_capture_stop_watch.Start();
+	}
+
+	// The packets after the key frame are discarded by the decoder, they only push the key frame out of the parser
+	_decoder->SendBuffer(packet);
+	_capturing_packet_count++;
+
+	std::shared_ptr<ov::Data> image;
+
+	while (true)
+	{
+		TranscodeResult result;
+		auto decoded_frame = _decoder->RecvBuffer(&result);
+
+		if ((result != TranscodeResult::DataReady) && (result != TranscodeResult::FormatChanged))
+		{
+			break;
+		}
+
+		if (_is_capturing)
+		{
+			image = Encode(decoded_frame);
+
+			_is_capturing = false;
+			_is_captured = true;
+		}
+	}
+
+	if (_is_capturing && (_capturing_packet_count >= TRANSCODE_THUMBNAIL_MAX_CAPTURING_PACKETS))
+	{
+		logtw("[%s/%s(%u)] Could not decode the key frame for the thumbnail", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId());
+
+		// Waits for the next key frame
+		_is_capturing = false;
+	}
+
+	return image;
+}
+
+const char *TranscodeThumbnail::GetFileExtension() const
+{
+	return IsWebP() ? "webp" : "jpg";
+}
+
+const char *TranscodeThumbnail::GetContentType() const
+{
+	return IsWebP() ? "image/webp" : "image/jpeg";
+}
+
+bool TranscodeThumbnail::IsWebP() const
+{
+	return _options.format.LowerCaseString() == "webp";
+}
+
+bool TranscodeThumbnail::PrepareEncoder(int width, int height)
+{
+	// libwebp_anim (the default encoder of AV_CODEC_ID_WEBP) outputs the images when it is flushed, so libwebp is used
+	AVCodec *codec = IsWebP() ? ::avcodec_find_encoder_by_name("libwebp") : ::avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+
+	if (codec == nullptr)
+	{
+		logte("[%s/%s(%u)] The encoder of the thumbnail is not available: %s", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(), _options.format.CStr());
+		return false;
+	}
+
+	if ((width == 0) || (height == 0))
+	{
+		// Only checks the encoder
+		return true;
+	}
+
+	if ((_encoder_context != nullptr) && (_encoder_context->width == width) && (_encoder_context->height == height))
+	{
+		return true;
+	}
+
+	::avcodec_free_context(&_encoder_context);
+
+	_encoder_context = ::avcodec_alloc_context3(codec);
+
+	if (_encoder_context == nullptr)
+	{
+		return false;
+	}
+
+	_encoder_context->width = width;
+	_encoder_context->height = height;
+	_encoder_context->time_base = (AVRational){1, 1};
+	// The JPEG encoder needs the full range
+	_encoder_context->pix_fmt = IsWebP() ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_YUVJ420P;
+	_encoder_context->flags |= AV_CODEC_FLAG_QSCALE;
+
+	if (IsWebP())
+	{
+		// The quality factor of libwebp (0 ~ 100)
+		_encoder_context->global_quality = _options.quality * FF_QP2LAMBDA;
+	}
+	else
+	{
+		// The quantizer of JPEG (2: best ~ 31: worst)
+		int qscale = 2 + ((100 - _options.quality) * 29) / 99;
+
+		_encoder_context->qmin = qscale;
+		_encoder_context->qmax = qscale;
+		_encoder_context->global_quality = qscale * FF_QP2LAMBDA;
+	}
+
+	if (::avcodec_open2(_encoder_context, codec, nullptr) < 0)
+	{
+		logte("[%s/%s(%u)] Could not open the encoder of the thumbnail: %s (%dx%d)", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(), codec->name, width, height);
+
+		::avcodec_free_context(&_encoder_context);
+		return false;
+	}
+
+	::av_frame_unref(_scaled_frame);
+
+	_scaled_frame->format = _encoder_context->pix_fmt;
+	_scaled_frame->width = width;
+	_scaled_frame->height = height;
+
+	if (::av_frame_get_buffer(_scaled_frame, 32) < 0)
+	{
+		logte("[%s/%s(%u)] Could not allocate the frame of the thumbnail (%dx%d)", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(), width, height);
+
+		::avcodec_free_context(&_encoder_context);
+		return false;
+	}
+
+	return true;
+}
+
+std::shared_ptr<ov::Data> TranscodeThumbnail::Encode(const std::shared_ptr<MediaFrame> &frame)
+{
+	if (TranscodeFrameHelper::RefVideoFrame(_decoded_frame, frame.get()) == false)
+	{
+		return nullptr;
+	}
+
+	int width = _decoded_frame->width;
+	int height = _decoded_frame->height;
+
+	if ((_options.width > 0) && (_options.width < width))
+	{
+		// 4:2:0 needs the even sizes
+		height = std::max(static_cast<int>((static_cast<int64_t>(height) * _options.width / width) & ~1), 2);
+		width = _options.width & ~1;
+	}
+
+	if (PrepareEncoder(width, height) == false)
+	{
+		::av_frame_unref(_decoded_frame);
+		return nullptr;
+	}
+
+	// Only a frame per interval is scaled, so the fastest algorithm is good enough for a thumbnail
+	_sws_context = ::sws_getCachedContext(_sws_context,
+										  _decoded_frame->width, _decoded_frame->height, static_cast<AVPixelFormat>(_decoded_frame->format),
+										  width, height, _encoder_context->pix_fmt,
+										  SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+
+	if ((_sws_context == nullptr) || (::av_frame_make_writable(_scaled_frame) < 0))
+	{
+		logte("[%s/%s(%u)] Could not scale the thumbnail: %dx%d (format: %d) -> %dx%d", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId(),
+			  _decoded_frame->width, _decoded_frame->height, _decoded_frame->format, width, height);
+
+		::av_frame_unref(_decoded_frame);
+		return nullptr;
+	}
+
+	::sws_scale(_sws_context, _decoded_frame->data, _decoded_frame->linesize, 0, _decoded_frame->height, _scaled_frame->data, _scaled_frame->linesize);
+	::av_frame_unref(_decoded_frame);
+
+	// The JPEG encoder takes the quantizer of the frame when AV_CODEC_FLAG_QSCALE is set
+	_scaled_frame->quality = _encoder_context->global_quality;
+	_scaled_frame->pts = AV_NOPTS_VALUE;
+
+	if ((::avcodec_send_frame(_encoder_context, _scaled_frame) < 0) || (::avcodec_receive_packet(_encoder_context, _packet) < 0))
+	{
+		logte("[%s/%s(%u)] Could not encode the thumbnail", _stream_info.GetApplicationInfo().GetName().CStr(), _stream_info.GetName().CStr(), _stream_info.GetId());
+		return nullptr;
+	}
+
+	auto image = std::make_shared<ov::Data>(_packet->data, _packet->size);
+
+	::av_packet_unref(_packet);
+
+	return image;
+}
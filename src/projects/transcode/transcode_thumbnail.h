@@ -0,0 +1,76 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/info/stream.h>
+#include <base/media_route/media_buffer.h>
+#include <base/ovlibrary/ovlibrary.h>
+
+class TranscodeDecoder;
+
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwsContext;
+
+// Makes the thumbnails of a video track by decoding only its key frames (skip_frame = AVDISCARD_NONKEY)
+//
+// A key frame is decoded, scaled and encoded to JPEG/WebP once per interval, which is far cheaper than a full-rate rendition.
+// It has no thread, Process() is called by the thread that delivers the packets of the stream.
+class TranscodeThumbnail
+{
+public:
+	struct Options
+	{
+		int64_t interval_ms = 5000;
+		// The height keeps the aspect ratio (0: the width of the track)
+		int width = 320;
+		// jpeg or webp
+		ov::String format = "jpeg";
+		// 1 ~ 100
+		int quality = 75;
+	};
+
+	// Returns nullptr if the track cannot be decoded or the encoder of the format is not available
+	static std::shared_ptr<TranscodeThumbnail> Create(const info::Stream &stream_info, const std::shared_ptr<MediaTrack> &track, const Options &options);
+
+	TranscodeThumbnail(const info::Stream &stream_info, const Options &options);
+	~TranscodeThumbnail();
+
+	// Returns the encoded image if the packet completes a new thumbnail, otherwise nullptr
+	std::shared_ptr<ov::Data> Process(const std::shared_ptr<MediaPacket> &packet);
+
+	// jpg or webp
+	const char *GetFileExtension() const;
+	// image/jpeg or image/webp
+	const char *GetContentType() const;
+
+protected:
+	bool IsWebP() const;
+	// Opens the encoder again if the size of the thumbnail is changed
+	bool PrepareEncoder(int width, int height);
+	std::shared_ptr<ov::Data> Encode(const std::shared_ptr<MediaFrame> &frame);
+
+	info::Stream _stream_info;
+	Options _options;
+
+	std::shared_ptr<TranscodeDecoder> _decoder;
+
+	// The packets from a key frame are fed to the decoder until the frame comes out (the parser outputs a packet when the next one starts)
+	bool _is_capturing = false;
+	int _capturing_packet_count = 0;
+	bool _is_captured = false;
+	ov::StopWatch _capture_stop_watch;
+
+	AVCodecContext *_encoder_context = nullptr;
+	SwsContext *_sws_context = nullptr;
+	AVFrame *_decoded_frame = nullptr;
+	AVFrame *_scaled_frame = nullptr;
+	AVPacket *_packet = nullptr;
+};
@@ -0,0 +1,218 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#include "web_console_file_cache.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <mutex>
+
+#include "web_console_private.h"
+
+std::shared_ptr<const WebConsoleFileCache::File> WebConsoleFileCache::GetFile(const ov::String &path)
+{
+	struct stat file_stat;
+
+	if ((::stat(path, &file_stat) != 0) || (S_ISREG(file_stat.st_mode) == false))
+	{
+		std::lock_guard<std::shared_mutex> lock_guard(_file_map_mutex);
+		_file_map.erase(path);
+
+		return nullptr;
+	}
+
+	int64_t modified_time_ns = (static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL) + file_stat.st_mtim.tv_nsec;
+
+	{
+		std::shared_lock<std::shared_mutex> lock_guard(_file_map_mutex);
+
+		auto item = _file_map.find(path);
+
+		if (item != _file_map.end())
+		{
+			auto &file = item->second;
+
+			if ((file->inode == file_stat.st_ino) && (file->size == file_stat.st_size) && (file->modified_time_ns == modified_time_ns))
+			{
+				return file;
+			}
+		}
+	}
+
+	auto file = LoadFile(path, file_stat);
+
+	if (file == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (file_stat.st_size <= WEB_CONSOLE_FILE_CACHE_MAX_FILE_SIZE)
+	{
+		logtd("The file is cached: %s (%zu bytes, gzip: %zu bytes)", path.CStr(), file->data->GetLength(), (file->gzip_data != nullptr) ? file->gzip_data->GetLength() : 0);
+
+		std::lock_guard<std::shared_mutex> lock_guard(_file_map_mutex);
+		_file_map[path] = file;
+	}
+
+	return file;
+}
+
+std::shared_ptr<WebConsoleFileCache::File> WebConsoleFileCache::LoadFile(const ov::String &path, const struct stat &file_stat)
+{
+	int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+
+	auto data = std::make_shared<ov::Data>(file_stat.st_size);
+	data->SetLength(file_stat.st_size);
+
+	auto buffer = data->GetWritableDataAs<uint8_t>();
+	size_t read_bytes = 0;
+
+	while (read_bytes < data->GetLength())
+	{
+		auto result = ::read(fd, buffer + read_bytes, data->GetLength() - read_bytes);
+
+		if (result < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			::close(fd);
+			return nullptr;
+		}
+
+		if (result == 0)
+		{
+			// The file is truncated while reading
+			break;
+		}
+
+		read_bytes += result;
+	}
+
+	::close(fd);
+
+	data->SetLength(read_bytes);
+
+	auto file = std::make_shared<File>();
+	bool is_compressible = false;
+
+	file->data = data;
+	file->content_type = GetContentType(path, &is_compressible);
+	file->inode = file_stat.st_ino;
+	file->size = file_stat.st_size;
+	file->modified_time_ns = (static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000LL) + file_stat.st_mtim.tv_nsec;
+
+	// Changes whenever the file is replaced or modified
+	file->etag = ov::String::FormatString("\"%lx-%lx-%llx\"",
+										  static_cast<unsigned long>(file->inode), static_cast<unsigned long>(file->size),
+										  static_cast<unsigned long long>(file->modified_time_ns));
+
+	char last_modified[64];
+	struct tm modified_tm;
+	::gmtime_r(&file_stat.st_mtim.tv_sec, &modified_tm);
+	::strftime(last_modified, sizeof(last_modified), "%a, %d %b %Y %H:%M:%S GMT", &modified_tm);
+	file->last_modified = last_modified;
+
+	if (is_compressible && (read_bytes > 0))
+	{
+		auto gzip_data = CompressGzip(data);
+
+		if ((gzip_data != nullptr) && (gzip_data->GetLength() < data->GetLength()))
+		{
+			file->gzip_data = gzip_data;
+		}
+	}
+
+	return file;
+}
+
+std::shared_ptr<ov::Data> WebConsoleFileCache::CompressGzip(const std::shared_ptr<const ov::Data> &data)
+{
+	z_stream stream{};
+
+	// 15 + 16: gzip header/trailer instead of zlib
+	if (::deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+	{
+		return nullptr;
+	}
+
+	auto compressed = std::make_shared<ov::Data>(::deflateBound(&stream, data->GetLength()));
+	compressed->SetLength(compressed->GetCapacity());
+
+	stream.next_in = const_cast<Bytef *>(data->GetDataAs<Bytef>());
+	stream.avail_in = data->GetLength();
+	stream.next_out = compressed->GetWritableDataAs<Bytef>();
+	stream.avail_out = compressed->GetLength();
+
+	auto result = ::deflate(&stream, Z_FINISH);
+	auto total_out = stream.total_out;
+
+	::deflateEnd(&stream);
+
+	if (result != Z_STREAM_END)
+	{
+		return nullptr;
+	}
+
+	compressed->SetLength(total_out);
+
+	return compressed;
+}
+
+ov::String WebConsoleFileCache::GetContentType(const ov::String &path, bool *is_compressible)
+{
+	static const struct
+	{
+		const char *extension;
+		const char *content_type;
+		bool is_compressible;
+	} content_types[] = {
+		{".html", "text/html; charset=utf-8", true},
+		{".htm", "text/html; charset=utf-8", true},
+		{".css", "text/css; charset=utf-8", true},
+		{".js", "application/javascript; charset=utf-8", true},
+		{".json", "application/json; charset=utf-8", true},
+		{".map", "application/json; charset=utf-8", true},
+		{".txt", "text/plain; charset=utf-8", true},
+		{".xml", "application/xml; charset=utf-8", true},
+		{".svg", "image/svg+xml", true},
+		{".ico", "image/x-icon", true},
+		{".ttf", "font/ttf", true},
+		{".png", "image/png", false},
+		{".jpg", "image/jpeg", false},
+		{".jpeg", "image/jpeg", false},
+		{".gif", "image/gif", false},
+		{".webp", "image/webp", false},
+		{".woff", "font/woff", false},
+		{".woff2", "font/woff2", false},
+	};
+
+	auto lower_path = path.LowerCaseString();
+
+	for (const auto &item : content_types)
+	{
+		if (lower_path.HasSuffix(item.extension))
+		{
+			*is_compressible = item.is_compressible;
+			return item.content_type;
+		}
+	}
+
+	*is_compressible = false;
+	return "application/octet-stream";
+}
@@ -0,0 +1,53 @@
+//==============================================================================
+//
+//  OvenMediaEngine
+//
+//  Created by Hyunjun Jang
+//  Copyright (c) 2020 AirenSoft. All rights reserved.
+//
+//==============================================================================
+#pragma once
+
+#include <base/ovlibrary/ovlibrary.h>
+
+#include <map>
+#include <shared_mutex>
+
+// The files larger than this are read for each request instead of being cached
+#define WEB_CONSOLE_FILE_CACHE_MAX_FILE_SIZE (8 * 1024 * 1024)
+
+// Keeps the files of the DocumentRoot in memory with their gzip-compressed copies
+//
+// A file is validated with stat() for each request, and loaded again if it is changed (mtime/size/inode),
+// so the assets can be replaced while the server is running.
+class WebConsoleFileCache
+{
+public:
+	struct File
+	{
+		std::shared_ptr<const ov::Data> data;
+		// nullptr if the type is not compressible or the compressed one is not smaller
+		std::shared_ptr<const ov::Data> gzip_data;
+
+		ov::String content_type;
+		ov::String etag;
+		ov::String last_modified;
+
+		// To detect the changes
+		ino_t inode = 0;
+		off_t size = 0;
+		int64_t modified_time_ns = 0;
+	};
+
+	// Returns nullptr if the file does not exist or cannot be read
+	std::shared_ptr<const File> GetFile(const ov::String &path);
+
+protected:
+	static std::shared_ptr<File> LoadFile(const ov::String &path, const struct stat &file_stat);
+	static std::shared_ptr<ov::Data> CompressGzip(const std::shared_ptr<const ov::Data> &data);
+	static ov::String GetContentType(const ov::String &path, bool *is_compressible);
+
+	std::shared_mutex _file_map_mutex;
+	// key: canonical path
+	std::map<ov::String, std::shared_ptr<const File>> _file_map;
+};
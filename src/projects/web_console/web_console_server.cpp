@@ -143,7 +143,7 @@ bool WebConsoleServer::InitializeServer()
 			return HttpNextHandler::DoNotCall;
 		}
 
-		FILE *file = ::fopen(real_path, "rb");
+		auto file = _file_cache.GetFile(real_path);
 
 		if (file == nullptr)
 		{
@@ -153,31 +153,41 @@ bool WebConsoleServer::InitializeServer()
 			return HttpNextHandler::DoNotCall;
 		}
 
-		auto data = std::make_shared<ov::Data>();
-		ov::ByteStream stream(data.get());
-		char buffer[4096];
-
-		while (!feof(file))
+		if (response->GetStatusCode() == HttpStatusCode::OK)
 		{
-			auto read_bytes = ::fread(buffer, 1, OV_COUNTOF(buffer), file);
+			// The browsers revalidate the assets for each use, and receive 304 if they are not changed
+			response->SetHeader("Cache-Control", "no-cache");
+			response->SetHeader("ETag", file->etag);
+			response->SetHeader("Last-Modified", file->last_modified);
+
+			auto if_none_match = request->GetHeader("If-None-Match");
 
-			if (read_bytes == 0)
+			if ((if_none_match.IsEmpty() == false) && ((if_none_match == "*") || (if_none_match.IndexOf(file->etag.CStr()) >= 0)))
 			{
-				break;
+				response->SetStatusCode(HttpStatusCode::NotModified);
+				response->Response();
+
+				return HttpNextHandler::DoNotCall;
 			}
 
-			stream.Append(buffer, read_bytes);
-		}
+			auto data = file->data;
+
+			if (file->gzip_data != nullptr)
+			{
+				response->SetHeader("Vary", "Accept-Encoding");
+
+				if (request->GetHeader("Accept-Encoding").IndexOf("gzip") >= 0)
+				{
+					response->SetHeader("Content-Encoding", "gzip");
+					data = file->gzip_data;
+				}
+			}
 
-		if (response->GetStatusCode() == HttpStatusCode::OK)
-		{
 			response->SetHeader("Content-Length", ov::String::FormatString("%zu", data->GetLength()));
-			response->SetHeader("Content-Type", "text/html");
+			response->SetHeader("Content-Type", file->content_type);
 			response->AppendData(data);
 		}
 
-		::fclose(file);
-
 		response->Response();
 
 		return HttpNextHandler::DoNotCall;
@@ -18,6 +18,7 @@
 #include <http_server/interceptors/http_request_interceptors.h>
 #include <media_router/media_router_application.h>
 #include "../base/publisher/publisher.h"
+#include "web_console_file_cache.h"
 
 class WebConsoleServer : public ov::EnableSharedFromThis<WebConsoleServer>
 {
@@ -39,4 +40,6 @@ protected:
 	cfg::WebConsole _web_console;
 
 	std::shared_ptr<HttpServer> _http_server;
+
+	WebConsoleFileCache _file_cache;
 };